@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+Host stack benchmark driver
+
+Runs a matrix of builtin echo tests against one or two running vpp instances
+over their cli sockets, collects connects per second, throughput and test
+duration, writes them as json and optionally compares them with a baseline
+produced by an earlier run.
+
+Server and client can be the same instance, e.g., with a loopback interface,
+or two instances connected back to back, e.g., over memif.
+
+Example:
+  hs_bench.py --server-cli /run/vpp/srv.sock --client-cli /run/vpp/cli.sock \\
+      --ip 6.0.1.1 --output results.json --baseline last_release.json
+"""
+
+import sys
+import re
+import json
+import time
+import argparse
+import subprocess
+
+
+def bench(name, proto, nclients, nbytes, echo=False, fifo_size=None):
+    test = {"name": name, "proto": proto, "nclients": nclients, "bytes": nbytes}
+    if echo:
+        test["echo"] = True
+    if fifo_size:
+        test["fifo-size"] = fifo_size
+    return test
+
+
+DEFAULT_MATRIX = [
+    # connects per second, one small exchange per connection
+    bench("tcp-cps", "tcp", 1000, 64),
+    bench("tls-cps", "tls", 200, 64),
+    bench("quic-cps", "quic", 200, 64),
+    # request/response at various message sizes, echoed back by server
+    bench("tcp-rr-64", "tcp", 64, "4m", echo=True, fifo_size="64k"),
+    bench("tcp-rr-16k", "tcp", 16, "64m", echo=True),
+    bench("udp-rr-1k", "udp", 16, "16m", echo=True),
+    # bulk throughput
+    bench("tcp-bulk", "tcp", 1, "10g", fifo_size="4m"),
+    bench("tcp-bulk-x8", "tcp", 8, "4g", fifo_size="4m"),
+    bench("tls-bulk", "tls", 1, "2g", fifo_size="4m"),
+    bench("quic-bulk", "quic", 1, "1g", fifo_size="4m"),
+    bench("udp-bulk", "udp", 1, "2g", fifo_size="4m"),
+]
+
+# metric name, regex on client output, higher is better (None, not compared)
+METRICS = [
+    ("cps", r"three-way handshakes in [\d.]+ seconds ([\d.]+)/s", True),
+    ("bytes", r"(\d+) bytes \(\d+ mbytes, \d+ gbytes\) in", None),
+    ("duration", r"bytes\) in ([\d.]+) seconds", False),
+    ("gbps", r"([\d.]+) gbit/second", True),
+]
+
+
+class Vppctl:
+    "Run cli commands over a vpp cli socket"
+
+    def __init__(self, vppctl, sock):
+        self.vppctl = vppctl
+        self.sock = sock
+
+    def run(self, cmd, timeout=None):
+        args = [self.vppctl]
+        if self.sock:
+            args += ["-s", self.sock]
+        args.append(cmd)
+        res = subprocess.run(args, capture_output=True, text=True, timeout=timeout)
+        return res.stdout + res.stderr
+
+
+def test_uri(test, ip, port):
+    return "%s://%s/%d" % (test["proto"], ip, port)
+
+
+def server_cmd(test, uri):
+    cmd = "test echo server uri %s" % uri
+    if "fifo-size" in test:
+        cmd += " fifo-size %s" % test["fifo-size"]
+    return cmd
+
+
+def client_cmd(test, uri, args):
+    cmd = "test echo clients uri %s nclients %d bytes %s" % (
+        uri,
+        test["nclients"],
+        test["bytes"],
+    )
+    if test.get("echo"):
+        cmd += " echo-bytes"
+    if "fifo-size" in test:
+        cmd += " fifo-size %s" % test["fifo-size"]
+    cmd += " test-timeout %d syn-timeout %d" % (args.timeout, args.timeout)
+    return cmd
+
+
+def parse_metrics(output):
+    res = {}
+    for name, regex, _ in METRICS:
+        m = re.search(regex, output)
+        if m:
+            res[name] = float(m.group(1))
+    return res
+
+
+def run_test(test, srv, cli, args, port):
+    uri = test_uri(test, args.ip, port)
+    out = srv.run(server_cmd(test, uri))
+    if "failed" in out:
+        return {"error": out.strip()}
+
+    samples = []
+    for _ in range(args.repeat):
+        out = cli.run(client_cmd(test, uri, args), timeout=args.timeout * 3)
+        if args.verbose:
+            print(out)
+        if "test failed" in out or "Timeout" in out:
+            srv.run("test echo server stop")
+            return {"error": out.strip().splitlines()[-1]}
+        samples.append(parse_metrics(out))
+
+    srv.run("test echo server stop")
+
+    # report median of the samples for each metric
+    res = {}
+    for name, _, _ in METRICS:
+        vals = sorted(s[name] for s in samples if name in s)
+        if vals:
+            res[name] = vals[len(vals) // 2]
+    res["samples"] = len(samples)
+    return res
+
+
+def compare(results, baseline, tolerance):
+    "Return list of regressions beyond tolerance percent"
+    regressions = []
+    for name, res in results.items():
+        base = baseline.get(name)
+        if not base or "error" in res or "error" in base:
+            continue
+        for metric, _, higher_is_better in METRICS:
+            if higher_is_better is None or metric not in res or metric not in base:
+                continue
+            if not base[metric]:
+                continue
+            delta = (res[metric] - base[metric]) * 100.0 / base[metric]
+            if not higher_is_better:
+                delta = -delta
+            if delta < -tolerance:
+                regressions.append((name, metric, base[metric], res[metric], delta))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="vpp host stack benchmark driver")
+    parser.add_argument("--vppctl", default="vppctl", help="vppctl binary")
+    parser.add_argument("--server-cli", help="server vpp cli socket")
+    parser.add_argument("--client-cli", help="client vpp cli socket")
+    parser.add_argument("--ip", required=True, help="server ip address")
+    parser.add_argument("--port", type=int, default=1234, help="first port")
+    parser.add_argument("--matrix", help="json file with list of tests")
+    parser.add_argument("--filter", help="regex on test names to run")
+    parser.add_argument("--repeat", type=int, default=3, help="runs per test")
+    parser.add_argument("--timeout", type=int, default=60, help="per run, seconds")
+    parser.add_argument("--output", help="json file to write results to")
+    parser.add_argument("--baseline", help="json results to compare against")
+    parser.add_argument(
+        "--tolerance", type=float, default=5.0, help="allowed regression, percent"
+    )
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    matrix = DEFAULT_MATRIX
+    if args.matrix:
+        with open(args.matrix) as f:
+            matrix = json.load(f)
+    if args.filter:
+        matrix = [t for t in matrix if re.search(args.filter, t["name"])]
+
+    srv = Vppctl(args.vppctl, args.server_cli)
+    cli = Vppctl(args.vppctl, args.client_cli or args.server_cli)
+
+    results = {}
+    for i, test in enumerate(matrix):
+        print("%-16s ..." % test["name"], end=" ", flush=True)
+        res = run_test(test, srv, cli, args, args.port + i)
+        results[test["name"]] = res
+        if "error" in res:
+            print("error: %s" % res["error"])
+        else:
+            print(
+                " ".join(
+                    "%s %.2f" % (m, res[m]) for m, _, _ in METRICS if m in res
+                )
+            )
+
+    report = {
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "version": srv.run("show version").strip(),
+        "results": results,
+    }
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent=2)
+
+    if not args.baseline:
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)["results"]
+    regressions = compare(results, baseline, args.tolerance)
+    for name, metric, base, cur, delta in regressions:
+        print(
+            "REGRESSION %s %s: %.2f -> %.2f (%.1f%%)" % (name, metric, base, cur, delta)
+        )
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -241,6 +241,17 @@ elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64.*|AARCH64.*)")
     CACHE_PREFETCH_BYTES 64
     OFF
   )
+  add_vpp_march_variant(neoversev1
+    FLAGS -march=armv8.4-a+crypto+sve -mtune=neoverse-v1
+    N_PREFETCHES 6
+    CACHE_PREFETCH_BYTES 64
+  )
+  add_vpp_march_variant(neoversev2
+    FLAGS -march=armv9-a+crypto+sve2 -mtune=neoverse-v2
+    N_PREFETCHES 6
+    CACHE_PREFETCH_BYTES 64
+    OFF
+  )
 endif()
 
 macro(vpp_library_set_multiarch_sources lib)
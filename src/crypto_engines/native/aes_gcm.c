@@ -25,6 +25,59 @@
 #pragma GCC optimize("O3")
 #endif
 
+#if N_AES_LANES == 4
+/* Run the next ops, up to one per lane, together if they are short enough.
+   Returns the number of ops done, 0 if fewer than two of them qualify. */
+static_always_inline u32
+aes_ops_aes_gcm_mb (vnet_crypto_op_t *op, u32 n_left, aes_key_size_t ks,
+		    u32 fixed, u32 aad_len, aes_gcm_op_t gcm_op, u32 *n_fail)
+{
+  crypto_native_main_t *cm = &crypto_native_main;
+  aes_gcm_mb_op_t mb_ops[AES_GCM_MB_N_LANES];
+  u32 i, n, ok;
+
+  n = clib_min (n_left, AES_GCM_MB_N_LANES);
+  for (i = 0; i < n; i++)
+    {
+      vnet_crypto_op_t *o = op + i;
+      u32 aad_bytes = fixed ? aad_len : o->aad_len;
+
+      if (!o->len || o->len > AES_GCM_MB_MAX_DATA_BYTES ||
+	  aad_bytes > AES_GCM_MB_MAX_AAD_BYTES)
+	break;
+
+      mb_ops[i] = (aes_gcm_mb_op_t){
+	.src = o->src,
+	.dst = o->dst,
+	.aad = o->aad,
+	.iv = o->iv,
+	.tag = o->tag,
+	.kd = (aes_gcm_key_data_t *) cm->key_data[o->key_index],
+	.data_bytes = o->len,
+	.aad_bytes = aad_bytes,
+	.tag_len = fixed ? 16 : o->tag_len,
+      };
+    }
+
+  if (i < 2)
+    return 0;
+
+  n = i;
+  ok = aes_gcm_mb (mb_ops, n, AES_KEY_ROUNDS (ks), gcm_op);
+
+  for (i = 0; i < n; i++)
+    if (ok & (1 << i))
+      op[i].status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+    else
+      {
+	op[i].status = VNET_CRYPTO_OP_STATUS_FAIL_BAD_HMAC;
+	*n_fail += 1;
+      }
+
+  return n;
+}
+#endif
+
 static_always_inline u32
 aes_ops_enc_aes_gcm (vnet_crypto_op_t *ops[], u32 n_ops, aes_key_size_t ks,
 		     u32 fixed, u32 aad_len)
@@ -33,8 +86,24 @@ aes_ops_enc_aes_gcm (vnet_crypto_op_t *ops[], u32 n_ops, aes_key_size_t ks,
   vnet_crypto_op_t *op = ops[0];
   aes_gcm_key_data_t *kd;
   u32 n_left = n_ops;
+#if N_AES_LANES == 4
+  u32 n, n_fail = 0;
+#endif
 
 next:
+#if N_AES_LANES == 4
+  n = aes_ops_aes_gcm_mb (op, n_left, ks, fixed, aad_len, AES_GCM_OP_ENCRYPT,
+			  &n_fail);
+  if (n)
+    {
+      n_left -= n;
+      op += n;
+      if (n_left)
+	goto next;
+      return n_ops;
+    }
+#endif
+
   kd = (aes_gcm_key_data_t *) cm->key_data[op->key_index];
   aes_gcm (op->src, op->dst, op->aad, (u8 *) op->iv, op->tag, op->len,
 	   fixed ? aad_len : op->aad_len, fixed ? 16 : op->tag_len, kd,
@@ -59,8 +128,24 @@ aes_ops_dec_aes_gcm (vnet_crypto_op_t *ops[], u32 n_ops, aes_key_size_t ks,
   aes_gcm_key_data_t *kd;
   u32 n_left = n_ops;
   int rv;
+#if N_AES_LANES == 4
+  u32 n, n_fail = 0;
+#endif
 
 next:
+#if N_AES_LANES == 4
+  n = aes_ops_aes_gcm_mb (op, n_left, ks, fixed, aad_len, AES_GCM_OP_DECRYPT,
+			  &n_fail);
+  if (n)
+    {
+      n_left -= n;
+      op += n;
+      if (n_left)
+	goto next;
+      return n_ops - n_fail;
+    }
+#endif
+
   kd = (aes_gcm_key_data_t *) cm->key_data[op->key_index];
   rv = aes_gcm (op->src, op->dst, op->aad, (u8 *) op->iv, op->tag, op->len,
 		fixed ? aad_len : op->aad_len, fixed ? 16 : op->tag_len, kd,
@@ -82,6 +167,9 @@ next:
       goto next;
     }
 
+#if N_AES_LANES == 4
+  n_ops -= n_fail;
+#endif
   return n_ops;
 }
 
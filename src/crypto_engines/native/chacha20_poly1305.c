@@ -0,0 +1,195 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/plugin/plugin.h>
+#include <vnet/crypto/crypto.h>
+#include <native/crypto_native.h>
+#include <vppinfra/crypto/chacha20.h>
+
+#if __GNUC__ > 4 && !__clang__ && CLIB_DEBUG == 0
+#pragma GCC optimize("O3")
+#endif
+
+/* Run the next ops together if their keystreams fit in one pass. Returns
+   the number of ops done, 0 if fewer than two of them fit. */
+static_always_inline u32
+chacha20_poly1305_ops_mb (vnet_crypto_op_t *op, u32 n_left, u32 fixed,
+			  u32 aad_len, chacha20_poly1305_op_t cop, u32 *n_fail)
+{
+  crypto_native_main_t *cm = &crypto_native_main;
+  chacha20_poly1305_mb_op_t mb_ops[CHACHA20_MAX_BLOCKS / 2];
+  u32 i, n, n_blocks = 0, ok;
+
+  n = clib_min (n_left, ARRAY_LEN (mb_ops));
+  for (i = 0; i < n; i++)
+    {
+      vnet_crypto_op_t *o = op + i;
+
+      if (!o->len || (!fixed && o->tag_len != 16))
+	break;
+
+      n_blocks += chacha20_poly1305_n_blocks (o->len);
+      if (n_blocks > CHACHA20_MAX_BLOCKS)
+	break;
+
+      mb_ops[i] = (chacha20_poly1305_mb_op_t){
+	.key = cm->key_data[o->key_index],
+	.nonce = o->iv,
+	.aad = o->aad,
+	.src = o->src,
+	.dst = o->dst,
+	.tag = o->tag,
+	.data_bytes = o->len,
+	.aad_bytes = fixed ? aad_len : o->aad_len,
+      };
+    }
+
+  if (i < 2)
+    return 0;
+
+  n = i;
+  ok = chacha20_poly1305_mb (mb_ops, n, cop);
+
+  for (i = 0; i < n; i++)
+    if (ok & (1 << i))
+      op[i].status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+    else
+      {
+	op[i].status = VNET_CRYPTO_OP_STATUS_FAIL_BAD_HMAC;
+	*n_fail += 1;
+      }
+
+  return n;
+}
+
+static_always_inline u32
+chacha20_poly1305_ops (vnet_crypto_op_t *ops[], u32 n_ops, u32 fixed,
+		       u32 aad_len, chacha20_poly1305_op_t cop)
+{
+  crypto_native_main_t *cm = &crypto_native_main;
+  vnet_crypto_op_t *op = ops[0];
+  u32 n_left = n_ops, n_fail = 0, n;
+
+next:
+  n = chacha20_poly1305_ops_mb (op, n_left, fixed, aad_len, cop, &n_fail);
+  if (n)
+    {
+      n_left -= n;
+      op += n;
+      if (n_left)
+	goto next;
+      return n_ops - n_fail;
+    }
+
+  if (!fixed && op->tag_len != 16)
+    {
+      op->status = VNET_CRYPTO_OP_STATUS_FAIL_BAD_HMAC;
+      n_fail++;
+    }
+  else if (clib_chacha20_poly1305 (cm->key_data[op->key_index], op->iv,
+				   op->aad, fixed ? aad_len : op->aad_len,
+				   op->src, op->dst, op->len, op->tag, cop))
+    op->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+  else
+    {
+      op->status = VNET_CRYPTO_OP_STATUS_FAIL_BAD_HMAC;
+      n_fail++;
+    }
+
+  if (--n_left)
+    {
+      op += 1;
+      goto next;
+    }
+
+  return n_ops - n_fail;
+}
+
+static void *
+chacha20_poly1305_key_exp (vnet_crypto_key_t *key)
+{
+  u8 *kd;
+
+  kd = clib_mem_alloc_aligned (32, CLIB_CACHE_LINE_BYTES);
+  clib_memcpy_fast (kd, key->data, 32);
+
+  return kd;
+}
+
+#define foreach_chacha20_poly1305_handler_type                                \
+  _ (, 0, 0) _ (_tag16_aad0, 1, 0) _ (_tag16_aad8, 1, 8)                      \
+    _ (_tag16_aad12, 1, 12)
+
+#define _(s, f, a)                                                            \
+  static u32 chacha20_poly1305_ops_enc##s (vlib_main_t *vm,                   \
+					   vnet_crypto_op_t *ops[], u32 n_ops) \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, f, a,                           \
+				  CHACHA20_POLY1305_OP_ENCRYPT);              \
+  }                                                                           \
+  static u32 chacha20_poly1305_ops_dec##s (vlib_main_t *vm,                   \
+					   vnet_crypto_op_t *ops[], u32 n_ops) \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, f, a,                           \
+				  CHACHA20_POLY1305_OP_DECRYPT);              \
+  }
+
+foreach_chacha20_poly1305_handler_type;
+#undef _
+
+static int
+probe ()
+{
+#if defined(__AVX512BITALG__)
+  if (clib_cpu_supports_avx512_bitalg ())
+    return 50;
+#elif defined(__AVX512F__)
+  if (clib_cpu_supports_avx512f ())
+    return 30;
+#elif defined(__AVX2__)
+  if (clib_cpu_supports_avx2 ())
+    return 20;
+#elif __SSE4_2__
+  if (clib_cpu_supports_sse42 ())
+    return 10;
+#elif __aarch64__
+  return 10;
+#endif
+  return -1;
+}
+
+CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_enc) = {
+  .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_ENC,
+  .fn = chacha20_poly1305_ops_enc,
+  .probe = probe,
+};
+
+CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_dec) = {
+  .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_DEC,
+  .fn = chacha20_poly1305_ops_dec,
+  .probe = probe,
+};
+
+#define _(a)                                                                  \
+  CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_enc_tag16_aad##a) = {           \
+    .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_TAG16_AAD##a##_ENC,             \
+    .fn = chacha20_poly1305_ops_enc_tag16_aad##a,                             \
+    .probe = probe,                                                           \
+  };                                                                          \
+                                                                              \
+  CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_dec_tag16_aad##a) = {           \
+    .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_TAG16_AAD##a##_DEC,             \
+    .fn = chacha20_poly1305_ops_dec_tag16_aad##a,                             \
+    .probe = probe,                                                           \
+  };
+
+_ (0) _ (8) _ (12)
+#undef _
+
+CRYPTO_NATIVE_KEY_HANDLER (chacha20_poly1305) = {
+  .alg_id = VNET_CRYPTO_ALG_CHACHA20_POLY1305,
+  .key_fn = chacha20_poly1305_key_exp,
+  .probe = probe,
+};
@@ -497,123 +497,99 @@ abf_input_inline (vlib_main_t * vm,
 		  vlib_node_runtime_t * node,
 		  vlib_frame_t * frame, fib_protocol_t fproto)
 {
-  u32 n_left_from, *from, *to_next, next_index, matches, misses;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  fa_5tuple_opaque_t fa_5tuples[VLIB_FRAME_SIZE];
+  u32 lc_indices[VLIB_FRAME_SIZE], acl_pos[VLIB_FRAME_SIZE];
+  u32 acl_match[VLIB_FRAME_SIZE], rule_match[VLIB_FRAME_SIZE];
+  u8 matched[VLIB_FRAME_SIZE], actions[VLIB_FRAME_SIZE];
+  u16 nexts[VLIB_FRAME_SIZE];
+  u32 *from, n_pkts, matches = 0, i, n;
+  int is_ip6 = (FIB_PROTOCOL_IP6 == fproto);
 
   from = vlib_frame_vector_args (frame);
-  n_left_from = frame->n_vectors;
-  next_index = node->cached_next_index;
-  matches = misses = 0;
+  n_pkts = frame->n_vectors;
+  vlib_get_buffers (vm, from, bufs, n_pkts);
 
-  while (n_left_from > 0)
+  /*
+   * extract the 5-tuples of the whole frame, then match each run of
+   * packets that share a lookup context (i.e. an RX interface) in one go
+   */
+  for (i = 0; i < n_pkts; i++)
     {
-      u32 n_left_to_next;
+      u32 sw_if_index0;
 
-      vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
+      if (i + 4 < n_pkts)
+	{
+	  vlib_prefetch_buffer_header (bufs[i + 4], LOAD);
+	  vlib_prefetch_buffer_data (bufs[i + 2], LOAD);
+	}
+
+      sw_if_index0 = vnet_buffer (bufs[i])->sw_if_index[VLIB_RX];
+      ASSERT (vec_len (abf_alctx_per_itf[fproto]) > sw_if_index0);
+      lc_indices[i] = abf_alctx_per_itf[fproto][sw_if_index0];
+
+      acl_plugin_fill_5tuple_inline (acl_plugin.p_acl_main, lc_indices[i],
+				     bufs[i], is_ip6, 1, 0, &fa_5tuples[i]);
+    }
+
+  for (i = 0; i < n_pkts; i += n)
+    {
+      for (n = 1; i + n < n_pkts && lc_indices[i + n] == lc_indices[i]; n++)
+	;
+      acl_plugin_match_5tuple_batch_inline (
+	acl_plugin.p_acl_main, lc_indices[i], fa_5tuples + i, is_ip6, n,
+	matched + i, actions + i, acl_pos + i, acl_match + i, rule_match + i);
+    }
+
+  for (i = 0; i < n_pkts; i++)
+    {
+      vlib_buffer_t *b0 = bufs[i];
 
-      while (n_left_from > 0 && n_left_to_next > 0)
+      if (matched[i] && actions[i] > 0)
 	{
-	  const u32 *attachments0;
-	  const abf_itf_attach_t *aia0;
-	  abf_next_t next0 = ABF_NEXT_DROP;
-	  vlib_buffer_t *b0;
-	  u32 bi0, sw_if_index0;
-	  fa_5tuple_opaque_t fa_5tuple0;
-	  u32 match_acl_index = ~0;
-	  u32 match_acl_pos = ~0;
-	  u32 match_rule_index = ~0;
-	  u32 trace_bitmap = 0;
-	  u32 lc_index;
-	  u8 action;
-
-	  bi0 = from[0];
-	  to_next[0] = bi0;
-	  from += 1;
-	  to_next += 1;
-	  n_left_from -= 1;
-	  n_left_to_next -= 1;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-	  sw_if_index0 = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-
-	  ASSERT (vec_len (abf_per_itf[fproto]) > sw_if_index0);
-	  attachments0 = abf_per_itf[fproto][sw_if_index0];
-
-	  ASSERT (vec_len (abf_alctx_per_itf[fproto]) > sw_if_index0);
 	  /*
-	   * check if any of the policies attached to this interface matches.
+	   * match:
+	   *  follow the DPO chain
 	   */
-	  lc_index = abf_alctx_per_itf[fproto][sw_if_index0];
+	  const abf_itf_attach_t *aia0;
+	  const u32 *attachments0;
 
+	  attachments0 =
+	    abf_per_itf[fproto][vnet_buffer (b0)->sw_if_index[VLIB_RX]];
+	  aia0 = abf_itf_attach_get (attachments0[acl_pos[i]]);
+
+	  nexts[i] = aia0->aia_dpo.dpoi_next_node;
+	  vnet_buffer (b0)->ip.adj_index[VLIB_TX] = aia0->aia_dpo.dpoi_index;
+	  matches++;
+	}
+      else
+	{
 	  /*
-	     A non-inline version looks like this:
-
-	     acl_plugin.fill_5tuple (lc_index, b0, (FIB_PROTOCOL_IP6 == fproto),
-	     1, 0, &fa_5tuple0);
-	     if (acl_plugin.match_5tuple
-	     (lc_index, &fa_5tuple0, (FIB_PROTOCOL_IP6 == fproto), &action,
-	     &match_acl_pos, &match_acl_index, &match_rule_index,
-	     &trace_bitmap))
-	     . . .
+	   * miss:
+	   *  move on down the feature arc
 	   */
-	  acl_plugin_fill_5tuple_inline (acl_plugin.p_acl_main, lc_index, b0,
-					 (FIB_PROTOCOL_IP6 == fproto), 1, 0,
-					 &fa_5tuple0);
-
-	  if (acl_plugin_match_5tuple_inline (
-		acl_plugin.p_acl_main, lc_index, &fa_5tuple0,
-		(FIB_PROTOCOL_IP6 == fproto), &action, &match_acl_pos,
-		&match_acl_index, &match_rule_index, &trace_bitmap) &&
-	      action > 0)
-	    {
-	      /*
-	       * match:
-	       *  follow the DPO chain
-	       */
-	      aia0 = abf_itf_attach_get (attachments0[match_acl_pos]);
-
-	      next0 = aia0->aia_dpo.dpoi_next_node;
-	      vnet_buffer (b0)->ip.adj_index[VLIB_TX] =
-		aia0->aia_dpo.dpoi_index;
-	      matches++;
-	    }
-	  else
-	    {
-	      /*
-	       * miss:
-	       *  move on down the feature arc
-	       */
-	      vnet_feature_next (&next0, b0);
-	      misses++;
-	    }
-
-	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
-	    {
-	      abf_input_trace_t *tr;
-
-	      tr = vlib_add_trace (vm, node, b0, sizeof (*tr));
-	      tr->next = next0;
-	      tr->index = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
-	    }
-
-	  /* verify speculative enqueue, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-					   to_next, n_left_to_next, bi0,
-					   next0);
+	  u32 next0;
+
+	  vnet_feature_next (&next0, b0);
+	  nexts[i] = next0;
 	}
 
-      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+      if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	{
+	  abf_input_trace_t *tr;
+
+	  tr = vlib_add_trace (vm, node, b0, sizeof (*tr));
+	  tr->next = nexts[i];
+	  tr->index = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
+	}
     }
 
-  vlib_node_increment_counter (vm,
-			       (fproto = FIB_PROTOCOL_IP6 ?
-				abf_ip4_node.index :
-				abf_ip6_node.index),
-			       ABF_ERROR_MATCHED, matches);
-  vlib_node_increment_counter (vm,
-			       (fproto = FIB_PROTOCOL_IP6 ?
-				abf_ip4_node.index :
-				abf_ip6_node.index),
-			       ABF_ERROR_MISSED, misses);
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, n_pkts);
+
+  vlib_node_increment_counter (vm, node->node_index, ABF_ERROR_MATCHED,
+			       matches);
+  vlib_node_increment_counter (vm, node->node_index, ABF_ERROR_MISSED,
+			       n_pkts - matches);
 
   return frame->n_vectors;
 }
@@ -39,6 +39,7 @@
 
 #include "fa_node.h"
 #include "public_inlines.h"
+#include "bv_lookup.h"
 
 acl_main_t acl_main;
 
@@ -2545,6 +2546,7 @@ acl_set_aclplugin_fn (vlib_main_t * vm,
   u32 val = 0;
   u32 eh_val = 0;
   uword memory_size = 0;
+  acl_lookup_engine_t engine;
   acl_main_t *am = &acl_main;
 
   if (unformat (input, "skip-ipv6-extension-header %u %u", &eh_val, &val))
@@ -2555,6 +2557,19 @@ acl_set_aclplugin_fn (vlib_main_t * vm,
 	}
       goto done;
     }
+  if (unformat (input, "lookup-engine %U", unformat_acl_lookup_engine,
+		&engine))
+    {
+      if (unformat (input, "lookup-context %u", &val))
+	{
+	  if (acl_bv_lookup_context_set_engine (am, val, engine))
+	    error = clib_error_return (0, "lookup context %u does not exist",
+				       val);
+	}
+      else
+	am->default_lookup_engine = engine;
+      goto done;
+    }
   if (unformat (input, "use-hash-acl-matching %u", &val))
     {
       am->use_hash_acl_matching = (val != 0);
@@ -3915,6 +3930,8 @@ acl_plugin_config (vlib_main_t * vm, unformat_input_t * input)
       else if (unformat (input, "reclassify sessions %d",
 			 &reclassify_sessions))
 	am->reclassify_sessions = reclassify_sessions;
+      else if (unformat (input, "per-worker sessions"))
+	am->fa_per_worker_sessions = 1;
 
       else
 	return clib_error_return (0, "unknown input '%U'",
@@ -32,6 +32,7 @@
 #include "types.h"
 #include "fa_node.h"
 #include "hash_lookup_types.h"
+#include "bv_lookup_types.h"
 #include "lookup_context.h"
 
 #define  ACL_PLUGIN_VERSION_MAJOR 1
@@ -179,6 +180,12 @@ typedef struct {
   /* Do we use the TupleMerge for hash ACLs or not */
   int use_tuple_merge;
 
+  /* Lookup engine for newly created lookup contexts */
+  acl_lookup_engine_t default_lookup_engine;
+
+  /* compiled bit-vector classifiers, NULL unless lc uses the BV engine */
+  acl_bv_lookup_t **bv_lookup_by_lc_index;
+
   /* Max collision vector length before splitting the tuple */
 #define TM_SPLIT_THRESHOLD 39
   int tuple_merge_split_threshold;
@@ -222,8 +229,15 @@ typedef struct {
   int fa_sessions_hash_is_initialized;
   clib_bihash_40_8_t fa_ip6_sessions_hash;
   clib_bihash_16_8_t fa_ip4_sessions_hash;
+  /*
+   * Each worker keeps its sessions in its own tables and expires them
+   * by itself. Needs flow-symmetric RSS or handoff, set at startup only.
+   */
+  int fa_per_worker_sessions;
   /* The process node which orchestrates the cleanup */
   u32 fa_cleaner_node_index;
+  /* per-worker idle session timer node, used with per-worker sessions */
+  u32 fa_worker_session_timer_node_index;
   /* FA session timeouts, in seconds */
   u32 session_timeout_sec[ACL_N_TIMEOUTS];
   /* total session adds/dels */
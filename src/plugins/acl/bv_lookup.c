@@ -0,0 +1,580 @@
+/*
+ *------------------------------------------------------------------
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------
+ */
+
+#include <vlib/vlib.h>
+#include <vppinfra/random.h>
+
+#include <plugins/acl/acl.h>
+#include <plugins/acl/public_inlines.h>
+#include "bv_lookup.h"
+
+/*
+ * Bit-vector classifier compiler. Each dimension is cut into elementary
+ * intervals at every rule boundary, each interval gets a bitmap of the
+ * rules covering it, bit position being the rule priority across all the
+ * ACLs of the lookup context. The lookup is a binary search per dimension
+ * followed by AND of the resulting rows, so its cost does not depend on how
+ * much the port ranges of the rules overlap.
+ */
+
+static char *acl_bv_dim_names[] = {
+#define _(n, s) s,
+  foreach_acl_bv_dim
+#undef _
+};
+
+static void
+acl_bv_prefix_range (ip46_address_t *a, u8 plen, int is_ip6, u64 *lo,
+		     u64 *hi)
+{
+  u64 max = is_ip6 ? ~0ULL : 0xffffffffULL;
+  int max_plen = is_ip6 ? 64 : 32;
+  u64 v, mask;
+
+  v = is_ip6 ? clib_net_to_host_u64 (a->ip6.as_u64[0]) :
+	       clib_net_to_host_u32 (a->ip4.as_u32);
+
+  if (plen >= max_plen)
+    {
+      /* longer IPv6 prefixes are narrowed down by the candidate check */
+      *lo = *hi = v;
+      return;
+    }
+
+  mask = plen ? (max << (max_plen - plen)) & max : 0;
+  *lo = v & mask;
+  *hi = *lo | (max & ~mask);
+}
+
+static void
+acl_bv_rule_range (acl_rule_t *r, int d, u64 *lo, u64 *hi)
+{
+  switch (d)
+    {
+    case ACL_BV_DIM_SRC_ADDR:
+      acl_bv_prefix_range (&r->src, r->src_prefixlen, r->is_ipv6, lo, hi);
+      break;
+    case ACL_BV_DIM_DST_ADDR:
+      acl_bv_prefix_range (&r->dst, r->dst_prefixlen, r->is_ipv6, lo, hi);
+      break;
+    case ACL_BV_DIM_PROTO:
+      *lo = r->proto ? r->proto : 0;
+      *hi = r->proto ? r->proto : 0xff;
+      break;
+    case ACL_BV_DIM_SRC_PORT:
+      /* ports are only matched for the rules with the protocol set */
+      *lo = r->proto ? r->src_port_or_type_first : 0;
+      *hi = r->proto ? r->src_port_or_type_last : 0xffff;
+      break;
+    case ACL_BV_DIM_DST_PORT:
+      *lo = r->proto ? r->dst_port_or_code_first : 0;
+      *hi = r->proto ? r->dst_port_or_code_last : 0xffff;
+      break;
+    default:
+      ASSERT (0);
+    }
+}
+
+static int
+acl_bv_u64_cmp (void *a1, void *a2)
+{
+  u64 *v1 = a1, *v2 = a2;
+  return (*v1 > *v2) - (*v1 < *v2);
+}
+
+static void
+acl_bv_dim_build (acl_bv_table_t *t, int d)
+{
+  acl_bv_dim_t *dim = &t->dims[d];
+  u64 *lo = 0, *hi = 0, *points = 0;
+  u32 r, i, w, n_intervals;
+
+  vec_add1 (points, 0);
+  vec_validate (lo, vec_len (t->rules));
+  vec_validate (hi, vec_len (t->rules));
+  vec_foreach_index (r, t->rules)
+    {
+      acl_bv_rule_range (&t->rules[r].rule, d, lo + r, hi + r);
+      if (lo[r] > hi[r])
+	continue;
+      vec_add1 (points, lo[r]);
+      if (hi[r] != ~0ULL)
+	vec_add1 (points, hi[r] + 1);
+    }
+
+  vec_sort_with_function (points, acl_bv_u64_cmp);
+  vec_foreach_index (i, points)
+    if (i == 0 || points[i] != dim->bounds[vec_len (dim->bounds) - 1])
+      vec_add1 (dim->bounds, points[i]);
+  vec_free (points);
+
+  n_intervals = vec_len (dim->bounds);
+  if (t->n_words)
+    {
+      vec_validate_aligned (dim->bits, n_intervals * t->n_words - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (dim->agg, n_intervals * t->n_agg - 1,
+			    CLIB_CACHE_LINE_BYTES);
+    }
+
+  vec_foreach_index (r, t->rules)
+    {
+      u32 i0, i1;
+      if (lo[r] > hi[r])
+	continue;
+      i0 = acl_bv_interval_find (dim->bounds, lo[r]);
+      i1 = acl_bv_interval_find (dim->bounds, hi[r]);
+      for (i = i0; i <= i1; i++)
+	dim->bits[i * t->n_words + r / 64] |= 1ULL << (r % 64);
+    }
+
+  for (i = 0; i < n_intervals; i++)
+    for (w = 0; w < t->n_words; w++)
+      if (dim->bits[i * t->n_words + w])
+	dim->agg[i * t->n_agg + w / 64] |= 1ULL << (w % 64);
+
+  vec_free (lo);
+  vec_free (hi);
+}
+
+static void
+acl_bv_lookup_free (acl_bv_lookup_t *bvl)
+{
+  int is_ip6, d;
+
+  for (is_ip6 = 0; is_ip6 < 2; is_ip6++)
+    {
+      acl_bv_table_t *t = &bvl->tables[is_ip6];
+      for (d = 0; d < ACL_BV_N_DIMS; d++)
+	{
+	  vec_free (t->dims[d].bounds);
+	  vec_free (t->dims[d].bits);
+	  vec_free (t->dims[d].agg);
+	}
+      vec_free (t->rules);
+    }
+  clib_mem_free (bvl);
+}
+
+static acl_bv_lookup_t *
+acl_bv_lookup_build (acl_main_t *am, u32 *acl_indices)
+{
+  acl_bv_lookup_t *bvl;
+  int is_ip6, d;
+  u32 pos, j;
+
+  bvl = clib_mem_alloc (sizeof (*bvl));
+  clib_memset (bvl, 0, sizeof (*bvl));
+
+  vec_foreach_index (pos, acl_indices)
+    {
+      acl_list_t *a;
+
+      /* ACLs missing from the pool do not match, same as the linear path */
+      if (pool_is_free_index (am->acls, acl_indices[pos]))
+	continue;
+      a = pool_elt_at_index (am->acls, acl_indices[pos]);
+      vec_foreach_index (j, a->rules)
+	{
+	  acl_rule_t *r = vec_elt_at_index (a->rules, j);
+	  acl_bv_table_t *t = &bvl->tables[r->is_ipv6 != 0];
+	  acl_bv_rule_t *br;
+
+	  vec_add2 (t->rules, br, 1);
+	  br->rule = *r;
+	  br->acl_index = acl_indices[pos];
+	  br->ace_index = j;
+	  br->acl_position = pos;
+	  br->action = r->is_permit;
+	}
+    }
+
+  for (is_ip6 = 0; is_ip6 < 2; is_ip6++)
+    {
+      acl_bv_table_t *t = &bvl->tables[is_ip6];
+      t->n_words = round_pow2 (vec_len (t->rules), 64) / 64;
+      t->n_agg = round_pow2 (round_pow2 (t->n_words, 64) / 64,
+			     ACL_BV_AGG_WORDS_ALIGN);
+      for (d = 0; d < ACL_BV_N_DIMS; d++)
+	acl_bv_dim_build (t, d);
+    }
+
+  return bvl;
+}
+
+void
+acl_bv_lookup_context_free (acl_main_t *am, u32 lc_index)
+{
+  acl_bv_lookup_t *bvl;
+
+  if (!acl_bv_lookup_enabled (am, lc_index))
+    return;
+  bvl = am->bv_lookup_by_lc_index[lc_index];
+  am->bv_lookup_by_lc_index[lc_index] = 0;
+  acl_bv_lookup_free (bvl);
+}
+
+void
+acl_bv_lookup_context_update (acl_main_t *am, u32 lc_index)
+{
+  acl_lookup_context_t *acontext =
+    pool_elt_at_index (am->acl_lookup_contexts, lc_index);
+  acl_bv_lookup_t *old = 0;
+
+  if (acl_bv_lookup_enabled (am, lc_index))
+    old = am->bv_lookup_by_lc_index[lc_index];
+
+  if (acontext->lookup_engine == ACL_LOOKUP_ENGINE_BV)
+    {
+      vec_validate (am->bv_lookup_by_lc_index, lc_index);
+      am->bv_lookup_by_lc_index[lc_index] =
+	acl_bv_lookup_build (am, acontext->acl_indices);
+    }
+  else if (old)
+    am->bv_lookup_by_lc_index[lc_index] = 0;
+
+  if (old)
+    acl_bv_lookup_free (old);
+}
+
+void
+acl_bv_lookup_acl_change (acl_main_t *am, u32 acl_index)
+{
+  u32 *lc_index;
+
+  if (acl_index >= vec_len (am->lc_index_vec_by_acl))
+    return;
+
+  vec_foreach (lc_index, am->lc_index_vec_by_acl[acl_index])
+    if (acl_bv_lookup_enabled (am, *lc_index))
+      acl_bv_lookup_context_update (am, *lc_index);
+}
+
+int
+acl_bv_lookup_context_set_engine (acl_main_t *am, u32 lc_index,
+				  acl_lookup_engine_t engine)
+{
+  acl_lookup_context_t *acontext;
+
+  if (pool_is_free_index (am->acl_lookup_contexts, lc_index))
+    return VNET_API_ERROR_NO_SUCH_ENTRY;
+
+  acontext = pool_elt_at_index (am->acl_lookup_contexts, lc_index);
+  acontext->lookup_engine = engine;
+  acl_bv_lookup_context_update (am, lc_index);
+  return 0;
+}
+
+u8 *
+format_acl_lookup_engine (u8 *s, va_list *args)
+{
+  acl_lookup_engine_t engine = va_arg (*args, int);
+
+  return format (s, "%s", engine == ACL_LOOKUP_ENGINE_BV ? "bv" : "hash");
+}
+
+uword
+unformat_acl_lookup_engine (unformat_input_t *input, va_list *args)
+{
+  acl_lookup_engine_t *engine = va_arg (*args, acl_lookup_engine_t *);
+
+  if (unformat (input, "bv"))
+    *engine = ACL_LOOKUP_ENGINE_BV;
+  else if (unformat (input, "hash"))
+    *engine = ACL_LOOKUP_ENGINE_HASH;
+  else
+    return 0;
+  return 1;
+}
+
+u8 *
+format_acl_bv_lookup (u8 *s, va_list *args)
+{
+  acl_main_t *am = va_arg (*args, acl_main_t *);
+  u32 lc_index = va_arg (*args, u32);
+  u32 indent = format_get_indent (s);
+  acl_bv_lookup_t *bvl;
+  int is_ip6, d;
+
+  if (!acl_bv_lookup_enabled (am, lc_index))
+    return format (s, "not compiled");
+
+  bvl = am->bv_lookup_by_lc_index[lc_index];
+  for (is_ip6 = 0; is_ip6 < 2; is_ip6++)
+    {
+      acl_bv_table_t *t = &bvl->tables[is_ip6];
+      uword bytes = vec_mem_size (t->rules);
+
+      if (is_ip6)
+	s = format (s, "\n%U", format_white_space, indent);
+      s = format (s, "%s: %u rules, intervals", is_ip6 ? "ip6" : "ip4",
+		  vec_len (t->rules));
+      for (d = 0; d < ACL_BV_N_DIMS; d++)
+	{
+	  s = format (s, " %s %u", acl_bv_dim_names[d],
+		      vec_len (t->dims[d].bounds));
+	  bytes += vec_mem_size (t->dims[d].bounds) +
+		   vec_mem_size (t->dims[d].bits) +
+		   vec_mem_size (t->dims[d].agg);
+	}
+      s = format (s, ", memory %U", format_memory_size, bytes);
+    }
+  return s;
+}
+
+static u64
+acl_bv_random_u64 (u32 *seed)
+{
+  return ((u64) random_u32 (seed) << 32) | random_u32 (seed);
+}
+
+static u16
+acl_bv_random_port (u32 *seed, u16 first, u16 last)
+{
+  if (first > last)
+    return first;
+  return first + random_u32 (seed) % ((u32) last - first + 1);
+}
+
+/* random address within the prefix */
+static void
+acl_bv_random_addr (u8 *addr, u8 *prefix, int n_bytes, int plen, u32 *seed)
+{
+  int i;
+
+  for (i = 0; i < n_bytes; i++)
+    {
+      int n_bits = clib_max (0, clib_min (8, plen - i * 8));
+      u8 mask = n_bits ? 0xff << (8 - n_bits) : 0;
+      addr[i] = (prefix[i] & mask) | (acl_bv_random_u64 (seed) & ~mask);
+    }
+}
+
+/*
+ * ClassBench style trace: every header is generated from a randomly picked
+ * rule, by picking random values in each of the rule dimensions.
+ */
+static void
+acl_bv_bench_sample (acl_bv_rule_t *br, u32 lc_index, u32 *seed,
+		     fa_5tuple_t *pkt)
+{
+  acl_rule_t *r = &br->rule;
+  static u8 protos[] = { IP_PROTOCOL_TCP, IP_PROTOCOL_UDP, IP_PROTOCOL_ICMP };
+
+  clib_memset (pkt, 0, sizeof (*pkt));
+  if (r->is_ipv6)
+    {
+      acl_bv_random_addr (pkt->ip6_addr[0].as_u8, r->src.ip6.as_u8, 16,
+			  r->src_prefixlen, seed);
+      acl_bv_random_addr (pkt->ip6_addr[1].as_u8, r->dst.ip6.as_u8, 16,
+			  r->dst_prefixlen, seed);
+    }
+  else
+    {
+      acl_bv_random_addr (pkt->ip4_addr[0].as_u8, r->src.ip4.as_u8, 4,
+			  r->src_prefixlen, seed);
+      acl_bv_random_addr (pkt->ip4_addr[1].as_u8, r->dst.ip4.as_u8, 4,
+			  r->dst_prefixlen, seed);
+    }
+
+  if (r->proto)
+    {
+      pkt->l4.proto = r->proto;
+      pkt->l4.port[0] = acl_bv_random_port (seed, r->src_port_or_type_first,
+					    r->src_port_or_type_last);
+      pkt->l4.port[1] = acl_bv_random_port (seed, r->dst_port_or_code_first,
+					    r->dst_port_or_code_last);
+    }
+  else
+    {
+      pkt->l4.proto = protos[random_u32 (seed) % ARRAY_LEN (protos)];
+      pkt->l4.port[0] = random_u32 (seed);
+      pkt->l4.port[1] = random_u32 (seed);
+    }
+
+  pkt->pkt.lc_index = lc_index;
+  pkt->pkt.is_ip6 = r->is_ipv6;
+  pkt->pkt.l4_valid = 1;
+}
+
+static clib_error_t *
+acl_bv_lookup_bench_fn (vlib_main_t *vm, unformat_input_t *input,
+			vlib_cli_command_t *cmd)
+{
+  acl_main_t *am = &acl_main;
+  u32 lc_index = ~0, n_pkts = 1024, n_iter = 100;
+  u32 seed = clib_cpu_time_now ();
+  u32 i, iter, n_hash_miss = 0, n_bv_miss = 0, n_batch_miss = 0;
+  int is_ip6 = 0;
+  acl_lookup_context_t *acontext;
+  acl_bv_lookup_t *bvl;
+  acl_bv_table_t *t;
+  fa_5tuple_t *pkts = 0, **pkt_ptrs = 0;
+  u8 *matched = 0, *actions = 0;
+  u32 *acl_pos = 0, *acl_match = 0, *rule_match = 0;
+  u64 t0, hash_clocks, bv_clocks, batch_clocks;
+  f64 total;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "lookup-context %u", &lc_index))
+	;
+      else if (unformat (input, "ip6"))
+	is_ip6 = 1;
+      else if (unformat (input, "packets %u", &n_pkts))
+	;
+      else if (unformat (input, "iterations %u", &n_iter))
+	;
+      else if (unformat (input, "seed %u", &seed))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (pool_is_free_index (am->acl_lookup_contexts, lc_index))
+    return clib_error_return (0, "lookup context %u does not exist",
+			      lc_index);
+  if (n_pkts == 0 || n_iter == 0)
+    return clib_error_return (0, "packets and iterations must be non-zero");
+
+  acontext = pool_elt_at_index (am->acl_lookup_contexts, lc_index);
+  t0 = clib_cpu_time_now ();
+  bvl = acl_bv_lookup_build (am, acontext->acl_indices);
+  vlib_cli_output (vm, "compiled in %.2f ms",
+		   (clib_cpu_time_now () - t0) * vm->clib_time.seconds_per_clock *
+		     1e3);
+  t = &bvl->tables[is_ip6];
+  if (vec_len (t->rules) == 0)
+    {
+      acl_bv_lookup_free (bvl);
+      return clib_error_return (0, "no %s rules in lookup context %u",
+				is_ip6 ? "ip6" : "ip4", lc_index);
+    }
+
+  vec_validate_aligned (pkts, n_pkts - 1, CLIB_CACHE_LINE_BYTES);
+  vec_validate (pkt_ptrs, n_pkts - 1);
+  vec_validate (matched, n_pkts - 1);
+  vec_validate (actions, n_pkts - 1);
+  vec_validate (acl_pos, n_pkts - 1);
+  vec_validate (acl_match, n_pkts - 1);
+  vec_validate (rule_match, n_pkts - 1);
+  for (i = 0; i < n_pkts; i++)
+    {
+      acl_bv_rule_t *br = t->rules + random_u32 (&seed) % vec_len (t->rules);
+      acl_bv_bench_sample (br, lc_index, &seed, pkts + i);
+      pkt_ptrs[i] = pkts + i;
+    }
+
+  /* the linear match is the reference for both engines */
+  for (i = 0; i < n_pkts; i++)
+    {
+      u8 action, l_action;
+      u32 pos = ~0, acl = ~0, rule = ~0, trace = 0;
+      u32 l_pos = ~0, l_acl = ~0, l_rule = ~0;
+      acl_bv_rows_t rows;
+      int l_match, match;
+
+      l_match = linear_multi_acl_match_5tuple (am, lc_index, pkts + i, is_ip6,
+					       &l_action, &l_pos, &l_acl,
+					       &l_rule, &trace);
+      match = hash_multi_acl_match_5tuple (am, lc_index, pkts + i, is_ip6,
+					   &action, &pos, &acl, &rule, &trace);
+      if (match != l_match || (match && (acl != l_acl || rule != l_rule)))
+	n_hash_miss++;
+      acl_bv_get_rows (t, pkts + i, is_ip6, &rows);
+      match = acl_bv_match_rows (t, &rows, pkts + i, is_ip6, &action, &pos,
+				 &acl, &rule);
+      if (match != l_match || (match && (acl != l_acl || rule != l_rule)))
+	n_bv_miss++;
+      acl_bv_table_match_5tuple_batch (t, pkt_ptrs + i, is_ip6, 1, matched,
+				       actions, acl_pos, acl_match,
+				       rule_match);
+      if (matched[0] != l_match ||
+	  (l_match && (acl_match[0] != l_acl || rule_match[0] != l_rule)))
+	n_batch_miss++;
+    }
+
+  t0 = clib_cpu_time_now ();
+  for (iter = 0; iter < n_iter; iter++)
+    for (i = 0; i < n_pkts; i++)
+      {
+	u32 trace = 0;
+	matched[i] = hash_multi_acl_match_5tuple (
+	  am, lc_index, pkts + i, is_ip6, actions + i, acl_pos + i,
+	  acl_match + i, rule_match + i, &trace);
+      }
+  hash_clocks = clib_cpu_time_now () - t0;
+
+  t0 = clib_cpu_time_now ();
+  for (iter = 0; iter < n_iter; iter++)
+    for (i = 0; i < n_pkts; i++)
+      {
+	acl_bv_rows_t rows;
+	acl_bv_get_rows (t, pkts + i, is_ip6, &rows);
+	matched[i] =
+	  acl_bv_match_rows (t, &rows, pkts + i, is_ip6, actions + i,
+			     acl_pos + i, acl_match + i, rule_match + i);
+      }
+  bv_clocks = clib_cpu_time_now () - t0;
+
+  t0 = clib_cpu_time_now ();
+  for (iter = 0; iter < n_iter; iter++)
+    for (i = 0; i < n_pkts; i += VLIB_FRAME_SIZE)
+      acl_bv_table_match_5tuple_batch (
+	t, pkt_ptrs + i, is_ip6, clib_min (VLIB_FRAME_SIZE, n_pkts - i),
+	matched + i, actions + i, acl_pos + i, acl_match + i, rule_match + i);
+  batch_clocks = clib_cpu_time_now () - t0;
+
+  total = (f64) n_pkts * n_iter;
+  vlib_cli_output (vm, "%u %s rules, %u packets, %u iterations",
+		   vec_len (t->rules), is_ip6 ? "ip6" : "ip4", n_pkts, n_iter);
+  vlib_cli_output (vm, "%-10s %8.2f clocks/lookup, %u mismatches", "hash",
+		   hash_clocks / total, n_hash_miss);
+  vlib_cli_output (vm, "%-10s %8.2f clocks/lookup, %u mismatches", "bv",
+		   bv_clocks / total, n_bv_miss);
+  vlib_cli_output (vm, "%-10s %8.2f clocks/lookup, %u mismatches",
+		   "bv-batch", batch_clocks / total, n_batch_miss);
+
+  acl_bv_lookup_free (bvl);
+  vec_free (pkts);
+  vec_free (pkt_ptrs);
+  vec_free (matched);
+  vec_free (actions);
+  vec_free (acl_pos);
+  vec_free (acl_match);
+  vec_free (rule_match);
+  return 0;
+}
+
+/*?
+ * Compare the lookup cost of the hash and bit-vector engines on the ACLs
+ * of an existing lookup context. Headers are generated ClassBench style
+ * from the rules themselves, results of both engines are checked against
+ * the linear match. Load a ClassBench rule set with the usual ACL API or
+ * CLI and apply it to an interface to get a lookup context.
+ *
+ * @cliexpar
+ * @cliexstart{test acl-plugin lookup-bench lookup-context 0 packets 4096}
+ * @cliexend
+?*/
+VLIB_CLI_COMMAND (acl_bv_lookup_bench_command, static) = {
+  .path = "test acl-plugin lookup-bench",
+  .short_help = "test acl-plugin lookup-bench lookup-context <n> [ip6] "
+		"[packets <n>] [iterations <n>] [seed <n>]",
+  .function = acl_bv_lookup_bench_fn,
+};
@@ -0,0 +1,44 @@
+/*
+ *------------------------------------------------------------------
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------
+ */
+
+#ifndef _ACL_BV_LOOKUP_H_
+#define _ACL_BV_LOOKUP_H_
+
+#include "lookup_context.h"
+#include "acl.h"
+
+/*
+ * (Re)compile the bit-vector classifier of the lookup context from its
+ * current ACL vector, or release it if the context uses the hash engine.
+ */
+void acl_bv_lookup_context_update (acl_main_t *am, u32 lc_index);
+
+/* Release the compiled classifier of the lookup context */
+void acl_bv_lookup_context_free (acl_main_t *am, u32 lc_index);
+
+/* Recompile the classifiers of all lookup contexts using the ACL */
+void acl_bv_lookup_acl_change (acl_main_t *am, u32 acl_index);
+
+/* Select the lookup engine of an existing lookup context */
+int acl_bv_lookup_context_set_engine (acl_main_t *am, u32 lc_index,
+				      acl_lookup_engine_t engine);
+
+format_function_t format_acl_lookup_engine;
+format_function_t format_acl_bv_lookup;
+unformat_function_t unformat_acl_lookup_engine;
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ *------------------------------------------------------------------
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------
+ */
+
+#ifndef _ACL_BV_LOOKUP_TYPES_H_
+#define _ACL_BV_LOOKUP_TYPES_H_
+
+#include "types.h"
+
+/* Lookup engine used for a given lookup context */
+typedef enum
+{
+  ACL_LOOKUP_ENGINE_HASH = 0,
+  ACL_LOOKUP_ENGINE_BV,
+} acl_lookup_engine_t;
+
+/*
+ * Bit-vector lookup dimensions. IPv6 addresses are classified on their
+ * upper 64 bits only, candidates are always verified against the full rule.
+ */
+#define foreach_acl_bv_dim                                                    \
+  _ (SRC_ADDR, "src")                                                         \
+  _ (DST_ADDR, "dst")                                                         \
+  _ (PROTO, "proto")                                                          \
+  _ (SRC_PORT, "sport")                                                       \
+  _ (DST_PORT, "dport")
+
+typedef enum
+{
+#define _(n, s) ACL_BV_DIM_##n,
+  foreach_acl_bv_dim
+#undef _
+    ACL_BV_N_DIMS,
+} acl_bv_dim_type_t;
+
+/* aggregate bit vector words are processed this many at a time */
+#define ACL_BV_AGG_WORDS_ALIGN 4
+
+typedef struct
+{
+  /* sorted lower bounds of elementary intervals, bounds[0] is always 0 */
+  u64 *bounds;
+  /* n_intervals rows of n_words bits, bit N set if rule N covers interval */
+  u64 *bits;
+  /* n_intervals rows of n_agg bits, bit N set if word N of the row is not 0 */
+  u64 *agg;
+} acl_bv_dim_t;
+
+typedef struct
+{
+  /* copy of the rule, used to verify candidates */
+  acl_rule_t rule;
+  u32 acl_index;
+  u32 ace_index;
+  u32 acl_position;
+  u8 action;
+} acl_bv_rule_t;
+
+typedef struct
+{
+  acl_bv_dim_t dims[ACL_BV_N_DIMS];
+  /* rules in global priority order across all ACLs of the context */
+  acl_bv_rule_t *rules;
+  u32 n_words;
+  u32 n_agg;
+} acl_bv_table_t;
+
+/* Compiled bit-vector classifier of a lookup context */
+typedef struct
+{
+  /* indexed by is_ip6 */
+  acl_bv_table_t tables[2];
+} acl_bv_lookup_t;
+
+#endif
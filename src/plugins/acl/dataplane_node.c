@@ -341,6 +341,11 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
   u32 *sw_if_index;
   fa_5tuple_t *fa_5tuple;
   u64 *hash;
+  u64 *session_id;
+  /* with per-worker sessions the lookups are batched for the whole frame */
+  int batched_lookup = with_stateful_datapath && am->fa_per_worker_sessions;
+  /* sessions were added or deleted since the batched lookup */
+  int sessions_changed = 0;
   /* for the delayed counters */
   u32 saved_matched_acl_index = 0;
   u32 saved_matched_ace_index = 0;
@@ -356,6 +361,7 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
   sw_if_index = pw->sw_if_indices;
   fa_5tuple = pw->fa_5tuples;
   hash = pw->hashes;
+  session_id = pw->session_ids;
 
   /*
    * Now the "hard" work of session lookups and ACL lookups for new sessions.
@@ -368,8 +374,11 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
 
   fa_full_session_id_t f_sess_id_next = {.as_u64 = ~0ULL };
 
+  if (batched_lookup)
+    acl_fa_find_sessions_x8 (am, is_ip6, fa_5tuple, hash, session_id,
+			     frame->n_vectors);
   /* find the "next" session so we can kickstart the pipeline */
-  if (with_stateful_datapath)
+  else if (with_stateful_datapath)
     acl_fa_find_session_with_hash (am, is_ip6, sw_if_index[0], hash[0],
 				   &fa_5tuple[0], &f_sess_id_next.as_u64);
 
@@ -390,7 +399,23 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
       if (with_stateful_datapath)
 	{
 	  fa_full_session_id_t f_sess_id = f_sess_id_next;
-	  switch (n_left)
+	  if (batched_lookup)
+	    {
+	      f_sess_id.as_u64 = session_id[0];
+	      /* the batched result is stale if the frame changed the table */
+	      if (PREDICT_FALSE (sessions_changed))
+		acl_fa_find_session_with_hash (am, is_ip6, sw_if_index[0],
+					       hash[0], &fa_5tuple[0],
+					       &f_sess_id.as_u64);
+	      if (n_left > 2 && session_id[2] != ~0ULL)
+		{
+		  fa_full_session_id_t f_sess_id_ahead = {
+		    .as_u64 = session_id[2] };
+		  prefetch_session_entry (am, f_sess_id_ahead);
+		}
+	    }
+	  /* the batched lookup has done all the prefetching already */
+	  switch (batched_lookup ? 1 : n_left)
 	    {
 	    default:
 	      acl_fa_prefetch_session_bucket_for_hash (am, is_ip6, hash[5]);
@@ -443,6 +468,7 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
 			    f_sess_id)))
 			{
 			  acl_check_needed = 1;
+			  sessions_changed = 1;
 			  if (node_trace_on)
 			    {
 			      trace_bitmap |= 0x40000000;
@@ -505,6 +531,7 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
 
 	      if (2 == action)
 		{
+		  sessions_changed = 1;
 		  if (!acl_fa_can_add_session (am, is_input, sw_if_index[0]))
 		    acl_fa_try_recycle_session (am, is_input,
 						thread_index,
@@ -572,6 +599,7 @@ acl_fa_inner_node_fn (vlib_main_t * vm,
 	  fa_5tuple++;
 	  sw_if_index++;
 	  hash++;
+	  session_id++;
 	  n_left -= 1;
 	}
     }
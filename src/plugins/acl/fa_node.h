@@ -24,6 +24,11 @@
 #define ACL_FA_CONN_TABLE_DEFAULT_HASH_MEMORY_SIZE (1ULL<<30)
 #define ACL_FA_CONN_TABLE_DEFAULT_MAX_ENTRIES 500000
 
+/* per-worker session timer interval when the worker has no expired sessions, seconds */
+#define ACL_FA_WORKER_SESSION_TIMER_INTERVAL 0.5
+/* ... and when it had, to keep up with the expirations */
+#define ACL_FA_WORKER_SESSION_TIMER_BUSY_INTERVAL 0.001
+
 typedef union {
   u64 as_u64;
   struct {
@@ -168,6 +173,9 @@ CT_ASSERT_EQUAL(fa_5tuple_opaque_t_must_match_5tuple, sizeof(fa_5tuple_opaque_t)
 typedef struct {
   /* The pool of sessions managed by this worker */
   fa_session_t *fa_sessions_pool;
+  /* session tables of this worker, if per-worker sessions are enabled */
+  clib_bihash_40_8_t fa_ip6_sessions_hash;
+  clib_bihash_16_8_t fa_ip4_sessions_hash;
   /* incoming session change requests from other workers */
   clib_spinlock_t pending_session_change_request_lock;
   u64 *pending_session_change_requests;
@@ -230,6 +238,7 @@ typedef struct {
   u32 sw_if_indices[VLIB_FRAME_SIZE];
   fa_5tuple_t fa_5tuples[VLIB_FRAME_SIZE];
   u64 hashes[VLIB_FRAME_SIZE];
+  u64 session_ids[VLIB_FRAME_SIZE];
   u16 nexts[VLIB_FRAME_SIZE];
 
 } acl_fa_per_worker_data_t;
@@ -18,6 +18,7 @@
 #include <vlib/unix/plugin.h>
 #include <plugins/acl/public_inlines.h>
 #include "hash_lookup.h"
+#include "bv_lookup.h"
 #include "elog_acl_trace.h"
 
 /* check if a given ACL exists */
@@ -114,6 +115,7 @@ static int acl_plugin_get_lookup_context_index (u32 acl_user_id, u32 val1, u32 v
   acontext->context_user_id = acl_user_id;
   acontext->user_val1 = val1;
   acontext->user_val2 = val2;
+  acontext->lookup_engine = am->default_lookup_engine;
 
   u32 new_context_id = acontext - am->acl_lookup_contexts;
   vec_add1(am->acl_users[acl_user_id].lookup_contexts, new_context_id);
@@ -205,6 +207,7 @@ static void acl_plugin_put_lookup_context_index (u32 lc_index)
   vec_del1(am->acl_users[acontext->context_user_id].lookup_contexts, index);
   unapply_acl_vec(lc_index, acontext->acl_indices);
   unlock_acl_vec(lc_index, acontext->acl_indices);
+  acl_bv_lookup_context_free(am, lc_index);
   vec_free(acontext->acl_indices);
   pool_put(am->acl_lookup_contexts, acontext);
 }
@@ -258,6 +261,7 @@ static int acl_plugin_set_acl_vec_for_context (u32 lc_index, u32 *acl_list)
   unlock_acl_vec(lc_index, old_acl_vector);
   lock_acl_vec(lc_index, acontext->acl_indices);
   apply_acl_vec(lc_index, acontext->acl_indices);
+  acl_bv_lookup_context_update(am, lc_index);
 
   vec_free(old_acl_vector);
 
@@ -280,6 +284,7 @@ void acl_plugin_lookup_context_notify_acl_change(u32 acl_num)
     /* this is a deletion notification */
     hash_acl_delete(am, acl_num);
   }
+  acl_bv_lookup_acl_change(am, acl_num);
 }
 
 
@@ -349,6 +354,10 @@ acl_plugin_show_lookup_context (u32 lc_index)
                        acontext->user_val1, acontext->user_val2,
                        format_vec32, acontext->acl_indices, "%d");
       }
+      vlib_cli_output (vm, "  engine: %U", format_acl_lookup_engine,
+                       acontext->lookup_engine);
+      if (acl_bv_lookup_enabled (am, curr_lc_index))
+        vlib_cli_output (vm, "    %U", format_acl_bv_lookup, am, curr_lc_index);
     }
   }
 }
@@ -647,6 +647,196 @@ hash_multi_acl_match_5tuple (void *p_acl_main, u32 lc_index, fa_5tuple_t * pkt_5
   return 0;
 }
 
+/*
+ * Bit-vector lookup: find the elementary interval the packet falls into in
+ * each dimension, AND the per-interval rule bitmaps and verify the surviving
+ * candidates in priority order. The aggregate bitmaps allow to skip a run of
+ * 64 rules with a single AND as soon as one of the dimensions excludes it.
+ */
+
+#define ACL_BV_BATCH_SIZE 16
+
+typedef struct {
+  u64 *bits[ACL_BV_N_DIMS];
+  u64 *agg[ACL_BV_N_DIMS];
+} acl_bv_rows_t;
+
+always_inline int
+acl_bv_lookup_enabled (acl_main_t * am, u32 lc_index)
+{
+  return (lc_index < vec_len (am->bv_lookup_by_lc_index)) &&
+    (am->bv_lookup_by_lc_index[lc_index] != 0);
+}
+
+always_inline u32
+acl_bv_interval_find (u64 * bounds, u64 key)
+{
+  u32 lo = 0, hi = vec_len (bounds) - 1;
+
+  /* last interval with the lower bound <= key, bounds[0] is always 0 */
+  while (lo < hi)
+    {
+      u32 mid = (lo + hi + 1) >> 1;
+      if (bounds[mid] <= key)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+  return lo;
+}
+
+always_inline void
+acl_bv_5tuple_to_keys (fa_5tuple_t * pkt_5tuple, int is_ip6, u64 * key)
+{
+  if (is_ip6)
+    {
+      key[ACL_BV_DIM_SRC_ADDR] =
+        clib_net_to_host_u64 (pkt_5tuple->ip6_addr[0].as_u64[0]);
+      key[ACL_BV_DIM_DST_ADDR] =
+        clib_net_to_host_u64 (pkt_5tuple->ip6_addr[1].as_u64[0]);
+    }
+  else
+    {
+      key[ACL_BV_DIM_SRC_ADDR] =
+        clib_net_to_host_u32 (pkt_5tuple->ip4_addr[0].as_u32);
+      key[ACL_BV_DIM_DST_ADDR] =
+        clib_net_to_host_u32 (pkt_5tuple->ip4_addr[1].as_u32);
+    }
+  key[ACL_BV_DIM_PROTO] = pkt_5tuple->l4.proto;
+  key[ACL_BV_DIM_SRC_PORT] = pkt_5tuple->l4.port[0];
+  key[ACL_BV_DIM_DST_PORT] = pkt_5tuple->l4.port[1];
+}
+
+always_inline void
+acl_bv_get_rows (acl_bv_table_t * t, fa_5tuple_t * pkt_5tuple, int is_ip6,
+                 acl_bv_rows_t * rows)
+{
+  u64 key[ACL_BV_N_DIMS];
+  int d;
+
+  acl_bv_5tuple_to_keys (pkt_5tuple, is_ip6, key);
+  for (d = 0; d < ACL_BV_N_DIMS; d++)
+    {
+      acl_bv_dim_t *dim = &t->dims[d];
+      uword i = acl_bv_interval_find (dim->bounds, key[d]);
+      rows->bits[d] = dim->bits + i * t->n_words;
+      rows->agg[d] = dim->agg + i * t->n_agg;
+    }
+}
+
+always_inline int
+acl_bv_match_rows (acl_bv_table_t * t, acl_bv_rows_t * rows,
+                   fa_5tuple_t * pkt_5tuple, int is_ip6, u8 * action,
+                   u32 * acl_pos_p, u32 * acl_match_p, u32 * rule_match_p)
+{
+  u64 **b = rows->bits, **g = rows->agg;
+  u64 agg[ACL_BV_AGG_WORDS_ALIGN];
+  u32 a, i;
+
+  STATIC_ASSERT (ACL_BV_N_DIMS == 5, "dimension count changed");
+
+  for (a = 0; a < t->n_agg; a += ACL_BV_AGG_WORDS_ALIGN)
+    {
+#ifdef CLIB_HAVE_VEC256
+      u64x4 v = u64x4_load_unaligned (g[0] + a);
+      v &= u64x4_load_unaligned (g[1] + a);
+      v &= u64x4_load_unaligned (g[2] + a);
+      v &= u64x4_load_unaligned (g[3] + a);
+      v &= u64x4_load_unaligned (g[4] + a);
+      if (u64x4_is_all_zero (v))
+        continue;
+      u64x4_store_unaligned (v, agg);
+#else
+      for (i = 0; i < ACL_BV_AGG_WORDS_ALIGN; i++)
+        agg[i] = g[0][a + i] & g[1][a + i] & g[2][a + i] & g[3][a + i] &
+          g[4][a + i];
+#endif
+      for (i = 0; i < ACL_BV_AGG_WORDS_ALIGN; i++)
+        while (agg[i])
+          {
+            uword w = (a + i) * 64 + count_trailing_zeros (agg[i]);
+            u64 m = b[0][w] & b[1][w] & b[2][w] & b[3][w] & b[4][w];
+
+            agg[i] = clear_lowest_set_bit (agg[i]);
+            while (m)
+              {
+                acl_bv_rule_t *br = t->rules + w * 64 + count_trailing_zeros (m);
+
+                m = clear_lowest_set_bit (m);
+                if (single_rule_match_5tuple (&br->rule, is_ip6, pkt_5tuple))
+                  {
+                    *acl_pos_p = br->acl_position;
+                    *acl_match_p = br->acl_index;
+                    *rule_match_p = br->ace_index;
+                    *action = br->action;
+                    return 1;
+                  }
+              }
+          }
+    }
+  return 0;
+}
+
+always_inline int
+bv_multi_acl_match_5tuple (void *p_acl_main, u32 lc_index, fa_5tuple_t * pkt_5tuple,
+                       int is_ip6, u8 *action, u32 *acl_pos_p, u32 * acl_match_p,
+                       u32 * rule_match_p, u32 * trace_bitmap)
+{
+  acl_main_t *am = p_acl_main;
+  acl_bv_table_t *t = &am->bv_lookup_by_lc_index[lc_index]->tables[is_ip6];
+  acl_bv_rows_t rows;
+
+  acl_bv_get_rows (t, pkt_5tuple, is_ip6, &rows);
+  return acl_bv_match_rows (t, &rows, pkt_5tuple, is_ip6, action, acl_pos_p,
+                            acl_match_p, rule_match_p);
+}
+
+/*
+ * Batched variant: resolve the intervals of a group of packets first and
+ * prefetch their aggregate rows, so the row loads of the whole group are
+ * in flight before the first AND. matched[i] is set to the match result.
+ */
+always_inline void
+acl_bv_table_match_5tuple_batch (acl_bv_table_t * t, fa_5tuple_t ** pkt_5tuple,
+                                 int is_ip6, u32 n_pkts, u8 * matched,
+                                 u8 * action, u32 * acl_pos, u32 * acl_match,
+                                 u32 * rule_match)
+{
+  acl_bv_rows_t rows[ACL_BV_BATCH_SIZE];
+  u32 i, j, n;
+
+  for (i = 0; i < n_pkts; i += n)
+    {
+      n = clib_min (n_pkts - i, ACL_BV_BATCH_SIZE);
+      for (j = 0; j < n; j++)
+        {
+          int d;
+          acl_bv_get_rows (t, pkt_5tuple[i + j], is_ip6, &rows[j]);
+          for (d = 0; d < ACL_BV_N_DIMS; d++)
+            clib_prefetch_load (rows[j].agg[d]);
+        }
+      for (j = 0; j < n; j++)
+        matched[i + j] =
+          acl_bv_match_rows (t, &rows[j], pkt_5tuple[i + j], is_ip6,
+                             action + i + j, acl_pos + i + j,
+                             acl_match + i + j, rule_match + i + j);
+    }
+}
+
+always_inline void
+bv_multi_acl_match_5tuple_batch (void *p_acl_main, u32 lc_index,
+                                 fa_5tuple_t ** pkt_5tuple, int is_ip6,
+                                 u32 n_pkts, u8 * matched, u8 * action,
+                                 u32 * acl_pos, u32 * acl_match,
+                                 u32 * rule_match)
+{
+  acl_main_t *am = p_acl_main;
+  acl_bv_table_t *t = &am->bv_lookup_by_lc_index[lc_index]->tables[is_ip6];
+
+  acl_bv_table_match_5tuple_batch (t, pkt_5tuple, is_ip6, n_pkts, matched,
+                                   action, acl_pos, acl_match, rule_match);
+}
+
 
 
 always_inline int
@@ -671,6 +861,9 @@ acl_plugin_match_5tuple_inline (void *p_acl_main, u32 lc_index,
        */
       return linear_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
                                  r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
+    } else if (acl_bv_lookup_enabled(am, lc_index)) {
+      return bv_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
+                                 r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
     } else {
       return hash_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
                                  r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
@@ -706,6 +899,9 @@ acl_plugin_match_5tuple_inline_and_count (void *p_acl_main, u32 lc_index,
        */
       ret = linear_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
                                  r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
+    } else if (acl_bv_lookup_enabled(am, lc_index)) {
+      ret = bv_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
+                                 r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
     } else {
       ret = hash_multi_acl_match_5tuple(p_acl_main, lc_index, pkt_5tuple_internal, is_ip6, r_action,
                                  r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
@@ -723,6 +919,76 @@ acl_plugin_match_5tuple_inline_and_count (void *p_acl_main, u32 lc_index,
   return ret;
 }
 
+/*
+ * Match a group of packets against the same lookup context. With the
+ * bit-vector engine the non-fragment packets go through the batched
+ * lookup, so their row loads overlap; otherwise, and for non-first
+ * fragments, each packet takes the per-packet path. matched[i] is set to
+ * the match result of pkt_5tuple[i].
+ */
+always_inline void
+acl_plugin_match_5tuple_batch_inline (void *p_acl_main, u32 lc_index,
+                                      fa_5tuple_opaque_t * pkt_5tuple,
+                                      int is_ip6, u32 n_pkts, u8 * matched,
+                                      u8 * action, u32 * acl_pos,
+                                      u32 * acl_match, u32 * rule_match)
+{
+  acl_main_t *am = p_acl_main;
+  fa_5tuple_t *pkts = (fa_5tuple_t *) pkt_5tuple;
+  fa_5tuple_t *bv_pkts[VLIB_FRAME_SIZE];
+  u32 bv_index[VLIB_FRAME_SIZE];
+  u8 bv_matched[VLIB_FRAME_SIZE], bv_action[VLIB_FRAME_SIZE];
+  u32 bv_acl_pos[VLIB_FRAME_SIZE], bv_acl_match[VLIB_FRAME_SIZE];
+  u32 bv_rule_match[VLIB_FRAME_SIZE];
+  u32 i, j, n_bv = 0, trace_bitmap = 0;
+
+  ASSERT (n_pkts <= VLIB_FRAME_SIZE);
+
+  if (!am->use_hash_acl_matching || !acl_bv_lookup_enabled (am, lc_index))
+    {
+      for (i = 0; i < n_pkts; i++)
+        matched[i] = acl_plugin_match_5tuple_inline (
+          p_acl_main, lc_index, pkt_5tuple + i, is_ip6, action + i,
+          acl_pos + i, acl_match + i, rule_match + i, &trace_bitmap);
+      return;
+    }
+
+  for (i = 0; i < n_pkts; i++)
+    {
+      pkts[i].pkt.lc_index = lc_index;
+      if (PREDICT_FALSE (pkts[i].pkt.is_nonfirst_fragment))
+        matched[i] = linear_multi_acl_match_5tuple (
+          p_acl_main, lc_index, pkts + i, is_ip6, action + i, acl_pos + i,
+          acl_match + i, rule_match + i, &trace_bitmap);
+      else
+        {
+          bv_index[n_bv] = i;
+          bv_pkts[n_bv++] = pkts + i;
+        }
+    }
+
+  if (PREDICT_TRUE (n_bv == n_pkts))
+    {
+      bv_multi_acl_match_5tuple_batch (p_acl_main, lc_index, bv_pkts, is_ip6,
+                                       n_pkts, matched, action, acl_pos,
+                                       acl_match, rule_match);
+      return;
+    }
+
+  bv_multi_acl_match_5tuple_batch (p_acl_main, lc_index, bv_pkts, is_ip6,
+                                   n_bv, bv_matched, bv_action, bv_acl_pos,
+                                   bv_acl_match, bv_rule_match);
+  for (j = 0; j < n_bv; j++)
+    {
+      i = bv_index[j];
+      matched[i] = bv_matched[j];
+      action[i] = bv_action[j];
+      acl_pos[i] = bv_acl_pos[j];
+      acl_match[i] = bv_acl_match[j];
+      rule_match[i] = bv_rule_match[j];
+    }
+}
+
 
 
 
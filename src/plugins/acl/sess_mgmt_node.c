@@ -80,6 +80,7 @@ format_ip4_session_bihash_kv (u8 * s, va_list * args)
   return format_ip46_session_bihash_kv (s, args, 0);
 }
 
+static vlib_node_registration_t acl_fa_worker_session_timer_node;
 
 static void
 acl_fa_verify_init_sessions (acl_main_t * am)
@@ -101,20 +102,50 @@ acl_fa_verify_init_sessions (acl_main_t * am)
 			   am->fa_conn_table_max_entries);
 	}
 
-      /* ... and the interface session hash table */
-      clib_bihash_init_40_8 (&am->fa_ip6_sessions_hash,
-			     "ACL plugin FA IPv6 session bihash",
-			     am->fa_conn_table_hash_num_buckets,
-			     am->fa_conn_table_hash_memory_size);
-      clib_bihash_set_kvp_format_fn_40_8 (&am->fa_ip6_sessions_hash,
-					  format_ip6_session_bihash_kv);
-
-      clib_bihash_init_16_8 (&am->fa_ip4_sessions_hash,
-			     "ACL plugin FA IPv4 session bihash",
-			     am->fa_conn_table_hash_num_buckets,
-			     am->fa_conn_table_hash_memory_size);
-      clib_bihash_set_kvp_format_fn_16_8 (&am->fa_ip4_sessions_hash,
-					  format_ip4_session_bihash_kv);
+      if (am->fa_per_worker_sessions)
+	{
+	  /* ... and the session hash tables of each worker */
+	  u32 n_workers = vec_len (am->per_worker_data);
+	  u32 n_buckets =
+	    clib_max (am->fa_conn_table_hash_num_buckets / n_workers, 1024);
+	  uword memory_size =
+	    clib_max (am->fa_conn_table_hash_memory_size / n_workers,
+		      64 << 20);
+
+	  for (wk = 0; wk < n_workers; wk++)
+	    {
+	      acl_fa_per_worker_data_t *pw = &am->per_worker_data[wk];
+	      clib_bihash_init_40_8 (&pw->fa_ip6_sessions_hash,
+				     "ACL plugin FA IPv6 worker session bihash",
+				     n_buckets, memory_size);
+	      clib_bihash_set_kvp_format_fn_40_8 (&pw->fa_ip6_sessions_hash,
+						  format_ip6_session_bihash_kv);
+	      clib_bihash_init_16_8 (&pw->fa_ip4_sessions_hash,
+				     "ACL plugin FA IPv4 worker session bihash",
+				     n_buckets, memory_size);
+	      clib_bihash_set_kvp_format_fn_16_8 (&pw->fa_ip4_sessions_hash,
+						  format_ip4_session_bihash_kv);
+	    }
+	  am->fa_worker_session_timer_node_index =
+	    acl_fa_worker_session_timer_node.index;
+	}
+      else
+	{
+	  /* ... and the interface session hash table */
+	  clib_bihash_init_40_8 (&am->fa_ip6_sessions_hash,
+				 "ACL plugin FA IPv6 session bihash",
+				 am->fa_conn_table_hash_num_buckets,
+				 am->fa_conn_table_hash_memory_size);
+	  clib_bihash_set_kvp_format_fn_40_8 (&am->fa_ip6_sessions_hash,
+					      format_ip6_session_bihash_kv);
+
+	  clib_bihash_init_16_8 (&am->fa_ip4_sessions_hash,
+				 "ACL plugin FA IPv4 session bihash",
+				 am->fa_conn_table_hash_num_buckets,
+				 am->fa_conn_table_hash_memory_size);
+	  clib_bihash_set_kvp_format_fn_16_8 (&am->fa_ip4_sessions_hash,
+					      format_ip4_session_bihash_kv);
+	}
 
       am->fa_sessions_hash_is_initialized = 1;
     }
@@ -556,6 +587,36 @@ acl_fa_worker_conn_cleaner_process (vlib_main_t * vm,
   return 0;
 }
 
+/*
+ * Per-worker timer driven cleaner, used with per-worker sessions instead of
+ * the interrupts from the main thread. It keeps rescheduling itself while
+ * the worker has sessions and is restarted by the next session added.
+ */
+static uword
+acl_fa_worker_session_timer (vlib_main_t * vm, vlib_node_runtime_t * rt,
+			     vlib_frame_t * f)
+{
+  acl_main_t *am = &acl_main;
+  clib_thread_index_t thread_index = vm->thread_index;
+  acl_fa_per_worker_data_t *pw = &am->per_worker_data[thread_index];
+  u64 now = clib_cpu_time_now ();
+  int num_expired, has_sessions = 0;
+  u8 tt;
+
+  num_expired = acl_fa_check_idle_sessions (am, thread_index, now);
+  for (tt = 0; tt < vec_len (pw->fa_conn_list_head); tt++)
+    if (FA_SESSION_BOGUS_INDEX != pw->fa_conn_list_head[tt])
+      has_sessions = 1;
+
+  if (num_expired > 0 || purgatory_has_connections (vm, am, thread_index))
+    vlib_node_schedule (vm, rt->node_index,
+			ACL_FA_WORKER_SESSION_TIMER_BUSY_INTERVAL);
+  else if (has_sessions)
+    vlib_node_schedule (vm, rt->node_index,
+			ACL_FA_WORKER_SESSION_TIMER_INTERVAL);
+  return 0;
+}
+
 static void
 send_interrupts_to_workers (vlib_main_t * vm, acl_main_t * am)
 {
@@ -629,8 +690,12 @@ acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	    }
 	}
 
-      /* If no pending connections and no ACL applied then no point in timing out */
-      if (!has_pending_conns && (0 == am->fa_total_enabled_count))
+      /*
+       * If no pending connections and no ACL applied then no point in timing out,
+       * neither if the workers run their own session timers.
+       */
+      if ((!has_pending_conns && (0 == am->fa_total_enabled_count))
+	  || am->fa_per_worker_sessions)
 	{
 	  am->fa_cleaner_cnt_wait_without_timeout++;
 	  elog_acl_maybe_trace_X1 (am,
@@ -786,6 +851,14 @@ acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	  break;
 	}
 
+      /* with per-worker sessions the workers expire them on their own */
+      if (am->fa_per_worker_sessions)
+	{
+	  if (event_data)
+	    vec_set_len (event_data, 0);
+	  continue;
+	}
+
       send_interrupts_to_workers (vm, am);
 
       if (event_data)
@@ -910,7 +983,22 @@ void
 show_fa_sessions_hash (vlib_main_t * vm, u32 verbose)
 {
   acl_main_t *am = &acl_main;
-  if (am->fa_sessions_hash_is_initialized)
+  if (am->fa_sessions_hash_is_initialized && am->fa_per_worker_sessions)
+    {
+      acl_fa_per_worker_data_t *pw;
+      vec_foreach (pw, am->per_worker_data)
+      {
+	vlib_cli_output (vm,
+			 "\nThread %u IPv6 Session lookup hash table:\n%U\n\n",
+			 pw - am->per_worker_data, format_bihash_40_8,
+			 &pw->fa_ip6_sessions_hash, verbose);
+	vlib_cli_output (vm,
+			 "\nThread %u IPv4 Session lookup hash table:\n%U\n\n",
+			 pw - am->per_worker_data, format_bihash_16_8,
+			 &pw->fa_ip4_sessions_hash, verbose);
+      }
+    }
+  else if (am->fa_sessions_hash_is_initialized)
     {
       vlib_cli_output (vm, "\nIPv6 Session lookup hash table:\n%U\n\n",
 		       format_bihash_40_8, &am->fa_ip6_sessions_hash,
@@ -936,6 +1024,12 @@ VLIB_REGISTER_NODE (acl_fa_worker_session_cleaner_process_node, static) = {
   .state = VLIB_NODE_STATE_INTERRUPT,
 };
 
+VLIB_REGISTER_NODE (acl_fa_worker_session_timer_node, static) = {
+  .function = acl_fa_worker_session_timer,
+  .name = "acl-plugin-fa-worker-session-timer",
+  .type = VLIB_NODE_TYPE_SCHED,
+};
+
 VLIB_REGISTER_NODE (acl_fa_session_cleaner_process_node, static) = {
   .function = acl_fa_session_cleaner_process,
   .type = VLIB_NODE_TYPE_PROCESS,
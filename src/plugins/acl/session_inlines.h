@@ -53,6 +53,26 @@ acl_fa_ifc_has_sessions (acl_main_t * am, int sw_if_index0)
   return am->fa_sessions_hash_is_initialized;
 }
 
+/*
+ * Session tables to use on the current thread. With per-worker sessions
+ * a worker only ever sees its own tables, so they have a single writer.
+ */
+always_inline clib_bihash_40_8_t *
+acl_fa_ip6_sessions_hash (acl_main_t * am)
+{
+  if (am->fa_per_worker_sessions)
+    return &am->per_worker_data[os_get_thread_index ()].fa_ip6_sessions_hash;
+  return &am->fa_ip6_sessions_hash;
+}
+
+always_inline clib_bihash_16_8_t *
+acl_fa_ip4_sessions_hash (acl_main_t * am)
+{
+  if (am->fa_per_worker_sessions)
+    return &am->per_worker_data[os_get_thread_index ()].fa_ip4_sessions_hash;
+  return &am->fa_ip4_sessions_hash;
+}
+
 always_inline int
 acl_fa_ifc_has_in_acl (acl_main_t * am, int sw_if_index0)
 {
@@ -370,12 +390,12 @@ reverse_session_add_del_ip6 (acl_main_t * am,
   if (PREDICT_FALSE (is_session_l4_key_u64_slowpath (pkv->key[4])))
     {
       if (reverse_l4_u64_slowpath_valid (pkv->key[4], 1, &kv2.key[4]))
-	clib_bihash_add_del_40_8 (&am->fa_ip6_sessions_hash, &kv2, is_add);
+	clib_bihash_add_del_40_8 (acl_fa_ip6_sessions_hash (am), &kv2, is_add);
     }
   else
     {
       kv2.key[4] = reverse_l4_u64_fastpath (pkv->key[4], 1);
-      clib_bihash_add_del_40_8 (&am->fa_ip6_sessions_hash, &kv2, is_add);
+      clib_bihash_add_del_40_8 (acl_fa_ip6_sessions_hash (am), &kv2, is_add);
     }
 }
 
@@ -391,12 +411,12 @@ reverse_session_add_del_ip4 (acl_main_t * am,
   if (PREDICT_FALSE (is_session_l4_key_u64_slowpath (pkv->key[1])))
     {
       if (reverse_l4_u64_slowpath_valid (pkv->key[1], 0, &kv2.key[1]))
-	clib_bihash_add_del_16_8 (&am->fa_ip4_sessions_hash, &kv2, is_add);
+	clib_bihash_add_del_16_8 (acl_fa_ip4_sessions_hash (am), &kv2, is_add);
     }
   else
     {
       kv2.key[1] = reverse_l4_u64_fastpath (pkv->key[1], 0);
-      clib_bihash_add_del_16_8 (&am->fa_ip4_sessions_hash, &kv2, is_add);
+      clib_bihash_add_del_16_8 (acl_fa_ip4_sessions_hash (am), &kv2, is_add);
     }
 }
 
@@ -409,13 +429,13 @@ acl_fa_deactivate_session (acl_main_t * am, u32 sw_if_index,
   ASSERT (sess->thread_index == os_get_thread_index ());
   if (sess->is_ip6)
     {
-      clib_bihash_add_del_40_8 (&am->fa_ip6_sessions_hash,
+      clib_bihash_add_del_40_8 (acl_fa_ip6_sessions_hash (am),
 				&sess->info.kv_40_8, 0);
       reverse_session_add_del_ip6 (am, &sess->info.kv_40_8, 0);
     }
   else
     {
-      clib_bihash_add_del_16_8 (&am->fa_ip4_sessions_hash,
+      clib_bihash_add_del_16_8 (acl_fa_ip4_sessions_hash (am),
 				&sess->info.kv_16_8, 0);
       reverse_session_add_del_ip4 (am, &sess->info.kv_16_8, 0);
     }
@@ -561,17 +581,26 @@ acl_fa_add_session (acl_main_t * am, int is_input, int is_ip6,
 
   acl_fa_conn_list_add_session (am, f_sess_id, now);
 
+  /* the worker expires its own sessions, make sure its timer is running */
+  if (am->fa_per_worker_sessions)
+    {
+      vlib_main_t *vm = vlib_get_main ();
+      if (!vlib_node_is_scheduled (vm, am->fa_worker_session_timer_node_index))
+	vlib_node_schedule (vm, am->fa_worker_session_timer_node_index,
+			    ACL_FA_WORKER_SESSION_TIMER_INTERVAL);
+    }
+
   ASSERT (am->fa_sessions_hash_is_initialized == 1);
   if (is_ip6)
     {
       reverse_session_add_del_ip6 (am, &sess->info.kv_40_8, 1);
-      clib_bihash_add_del_40_8 (&am->fa_ip6_sessions_hash,
+      clib_bihash_add_del_40_8 (acl_fa_ip6_sessions_hash (am),
 				&sess->info.kv_40_8, 1);
     }
   else
     {
       reverse_session_add_del_ip4 (am, &sess->info.kv_16_8, 1);
-      clib_bihash_add_del_16_8 (&am->fa_ip4_sessions_hash,
+      clib_bihash_add_del_16_8 (acl_fa_ip4_sessions_hash (am),
 				&sess->info.kv_16_8, 1);
     }
 
@@ -590,14 +619,14 @@ acl_fa_find_session (acl_main_t * am, int is_ip6, u32 sw_if_index0,
     {
       clib_bihash_kv_40_8_t kv_result;
       res = (clib_bihash_search_inline_2_40_8
-	     (&am->fa_ip6_sessions_hash, &p5tuple->kv_40_8, &kv_result) == 0);
+	     (acl_fa_ip6_sessions_hash (am), &p5tuple->kv_40_8, &kv_result) == 0);
       *pvalue_sess = kv_result.value;
     }
   else
     {
       clib_bihash_kv_16_8_t kv_result;
       res = (clib_bihash_search_inline_2_16_8
-	     (&am->fa_ip4_sessions_hash, &p5tuple->kv_16_8, &kv_result) == 0);
+	     (acl_fa_ip4_sessions_hash (am), &p5tuple->kv_16_8, &kv_result) == 0);
       *pvalue_sess = kv_result.value;
     }
   return res;
@@ -618,18 +647,18 @@ acl_fa_prefetch_session_bucket_for_hash (acl_main_t * am, int is_ip6,
 					 u64 hash)
 {
   if (is_ip6)
-    clib_bihash_prefetch_bucket_40_8 (&am->fa_ip6_sessions_hash, hash);
+    clib_bihash_prefetch_bucket_40_8 (acl_fa_ip6_sessions_hash (am), hash);
   else
-    clib_bihash_prefetch_bucket_16_8 (&am->fa_ip4_sessions_hash, hash);
+    clib_bihash_prefetch_bucket_16_8 (acl_fa_ip4_sessions_hash (am), hash);
 }
 
 always_inline void
 acl_fa_prefetch_session_data_for_hash (acl_main_t * am, int is_ip6, u64 hash)
 {
   if (is_ip6)
-    clib_bihash_prefetch_data_40_8 (&am->fa_ip6_sessions_hash, hash);
+    clib_bihash_prefetch_data_40_8 (acl_fa_ip6_sessions_hash (am), hash);
   else
-    clib_bihash_prefetch_data_16_8 (&am->fa_ip4_sessions_hash, hash);
+    clib_bihash_prefetch_data_16_8 (acl_fa_ip4_sessions_hash (am), hash);
 }
 
 always_inline int
@@ -643,7 +672,7 @@ acl_fa_find_session_with_hash (acl_main_t * am, int is_ip6, u32 sw_if_index0,
       clib_bihash_kv_40_8_t kv_result;
       kv_result.value = ~0ULL;
       res = (clib_bihash_search_inline_2_with_hash_40_8
-	     (&am->fa_ip6_sessions_hash, hash, &p5tuple->kv_40_8,
+	     (acl_fa_ip6_sessions_hash (am), hash, &p5tuple->kv_40_8,
 	      &kv_result) == 0);
       *pvalue_sess = kv_result.value;
     }
@@ -652,13 +681,42 @@ acl_fa_find_session_with_hash (acl_main_t * am, int is_ip6, u32 sw_if_index0,
       clib_bihash_kv_16_8_t kv_result;
       kv_result.value = ~0ULL;
       res = (clib_bihash_search_inline_2_with_hash_16_8
-	     (&am->fa_ip4_sessions_hash, hash, &p5tuple->kv_16_8,
+	     (acl_fa_ip4_sessions_hash (am), hash, &p5tuple->kv_16_8,
 	      &kv_result) == 0);
       *pvalue_sess = kv_result.value;
     }
   return res;
 }
 
+/*
+ * Look up the sessions of a whole frame in groups of 8. Bucket prefetches
+ * run two groups and data prefetches one group ahead of the lookups, so
+ * the bihash memory latency overlaps across the group. Only used with the
+ * per-worker tables, which can not change under us during the frame
+ * other than by this thread.
+ */
+always_inline void
+acl_fa_find_sessions_x8 (acl_main_t * am, int is_ip6, fa_5tuple_t * p5tuple,
+			 u64 * hash, u64 * sess_ids, u32 n)
+{
+  u32 i, j;
+
+  for (i = 0; i < clib_min (n, 16); i++)
+    acl_fa_prefetch_session_bucket_for_hash (am, is_ip6, hash[i]);
+  for (i = 0; i < clib_min (n, 8); i++)
+    acl_fa_prefetch_session_data_for_hash (am, is_ip6, hash[i]);
+
+  for (i = 0; i < n; i += 8)
+    for (j = i; j < clib_min (n, i + 8); j++)
+      {
+	if (j + 16 < n)
+	  acl_fa_prefetch_session_bucket_for_hash (am, is_ip6, hash[j + 16]);
+	if (j + 8 < n)
+	  acl_fa_prefetch_session_data_for_hash (am, is_ip6, hash[j + 8]);
+	acl_fa_find_session_with_hash (am, is_ip6, ~0, hash[j], p5tuple + j,
+				       sess_ids + j);
+      }
+}
 
 /*
  * fd.io coding-style-patch-verification: ON
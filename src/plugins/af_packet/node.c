@@ -138,7 +138,8 @@ buffer_add_to_chain (vlib_buffer_t *b, vlib_buffer_t *first_b,
 		     vlib_buffer_t *prev_b, u32 bi)
 {
   /* update first buffer */
-  first_b->total_length_not_including_first_buffer += b->current_length;
+  vlib_buffer_cold (first_b)->total_length_not_including_first_buffer +=
+    b->current_length;
 
   /* update previous buffer */
   prev_b->next_buffer = bi;
@@ -264,7 +265,7 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
   u32 n_rx_bytes = 0;
   u32 timedout_blk = 0;
   u32 total = 0;
-  u32 *to_next = 0;
+  u32 *to_next = 0, *free_bufs;
   u32 block = rx_queue->next_rx_block;
   u32 block_nr = rx_queue->rx_req->req3.tp_block_nr;
   u8 *block_start = 0;
@@ -316,6 +317,9 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    vm, &apm->rx_buffers[thread_index][n_free_bufs], n_required);
 	  vec_set_len (apm->rx_buffers[thread_index], n_free_bufs);
 	}
+      /* free buffers are popped from the per-thread cache through this
+       * pointer, the vector length is synced back once per block */
+      free_bufs = apm->rx_buffers[thread_index];
 
       while (num_pkts && (n_free_bufs >= min_bufs))
 	{
@@ -332,6 +336,11 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 		CLIB_PREFETCH (block_start + rx_frame_offset +
 				 tph->tp_next_offset,
 			       2 * CLIB_CACHE_LINE_BYTES, LOAD);
+	      /* buffer used by next packet */
+	      if (n_free_bufs > 1)
+		vlib_prefetch_buffer_with_index (vm,
+						 free_bufs[n_free_bufs - 2],
+						 STORE);
 
 	      vlib_buffer_t *b0 = 0, *first_b0 = 0, *prev_b0 = 0;
 	      vnet_virtio_net_hdr_t *vnet_hdr = 0;
@@ -347,24 +356,20 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	      // save current state and return
 	      if (PREDICT_FALSE (((data_len / n_buffer_bytes) + 1) >
-				 vec_len (apm->rx_buffers[thread_index])))
+				 n_free_bufs))
 		{
 		  rx_queue->rx_frame_offset = rx_frame_offset;
 		  rx_queue->num_rx_pkts = num_pkts;
 		  rx_queue->is_rx_pending = 1;
 		  vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+		  vec_set_len (apm->rx_buffers[thread_index], n_free_bufs);
 		  goto done;
 		}
 
 	      while (data_len)
 		{
 		  /* grab free buffer */
-		  u32 last_empty_buffer =
-		    vec_len (apm->rx_buffers[thread_index]) - 1;
-		  bi0 = apm->rx_buffers[thread_index][last_empty_buffer];
-		  vec_set_len (apm->rx_buffers[thread_index],
-			       last_empty_buffer);
-		  n_free_bufs--;
+		  bi0 = free_bufs[--n_free_bufs];
 
 		  /* copy data */
 		  u32 bytes_to_copy =
@@ -407,7 +412,8 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 		  if (offset == 0)
 		    {
-		      b0->total_length_not_including_first_buffer = 0;
+		      vlib_buffer_cold (b0)
+			->total_length_not_including_first_buffer = 0;
 		      b0->flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
 		      vnet_buffer (b0)->sw_if_index[VLIB_RX] = sw_if_index;
 		      vnet_buffer (b0)->sw_if_index[VLIB_TX] = (u32) ~0;
@@ -510,6 +516,7 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	  vlib_put_next_frame (vm, node, next_index, n_left_to_next);
 	}
+      vec_set_len (apm->rx_buffers[thread_index], n_free_bufs);
 
       if (PREDICT_TRUE (num_pkts == 0))
 	{
@@ -660,7 +667,8 @@ af_packet_v2_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	      if (offset == 0)
 		{
-		  b0->total_length_not_including_first_buffer = 0;
+		  vlib_buffer_cold (b0)
+		    ->total_length_not_including_first_buffer = 0;
 		  b0->flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
 		  vnet_buffer (b0)->sw_if_index[VLIB_RX] = sw_if_index;
 		  vnet_buffer (b0)->sw_if_index[VLIB_TX] = (u32) ~0;
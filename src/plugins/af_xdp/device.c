@@ -38,6 +38,14 @@
 #define XDP_UMEM_MIN_CHUNK_SIZE 2048
 #endif
 
+/* busy-polling socket options were added in Linux 5.11 */
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
+
 af_xdp_main_t af_xdp_main;
 
 typedef struct
@@ -184,7 +192,6 @@ af_xdp_delete_if (vlib_main_t * vm, af_xdp_device_t * ad)
   vnet_main_t *vnm = vnet_get_main ();
   af_xdp_main_t *axm = &af_xdp_main;
   struct xsk_socket **xsk;
-  struct xsk_umem **umem;
   int i;
 
   if (ad->hw_if_index)
@@ -199,8 +206,9 @@ af_xdp_delete_if (vlib_main_t * vm, af_xdp_device_t * ad)
   vec_foreach (xsk, ad->xsk)
     xsk_socket__delete (*xsk);
 
-  vec_foreach (umem, ad->umem)
-    xsk_umem__delete (*umem);
+  /* umem can only be released once all sockets sharing it are gone */
+  if (ad->umem)
+    xsk_umem__delete (ad->umem);
 
   for (i = 0; i < ad->rxq_num; i++)
     clib_file_del_by_index (&file_main, vec_elt (ad->rxqs, i).file_index);
@@ -209,7 +217,6 @@ af_xdp_delete_if (vlib_main_t * vm, af_xdp_device_t * ad)
     af_xdp_log (VLIB_LOG_LEVEL_ERR, ad, "Error while removing XDP program.\n");
 
   vec_free (ad->xsk);
-  vec_free (ad->umem);
   vec_free (ad->buffer_template);
   vec_free (ad->rxqs);
   vec_free (ad->txqs);
@@ -246,6 +253,11 @@ af_xdp_load_program (af_xdp_create_if_args_t * args, af_xdp_device_t * ad)
     goto err1;
 
   bpf_program__set_type (bpf_prog, BPF_PROG_TYPE_XDP);
+#ifdef BPF_F_XDP_HAS_FRAGS
+  if (args->flags & AF_XDP_CREATE_FLAGS_MULTI_BUFFER)
+    bpf_program__set_flags (bpf_prog, bpf_program__flags (bpf_prog) |
+					BPF_F_XDP_HAS_FRAGS);
+#endif
 
   if (bpf_object__load (ad->bpf_obj))
     goto err1;
@@ -271,35 +283,16 @@ err0:
 }
 
 static int
-af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
-		     af_xdp_device_t *ad, int qid)
+af_xdp_create_umem (vlib_main_t *vm, af_xdp_create_if_args_t *args,
+		    af_xdp_device_t *ad)
 {
-  struct xsk_umem **umem;
-  struct xsk_socket **xsk;
-  af_xdp_rxq_t *rxq;
-  af_xdp_txq_t *txq;
   struct xsk_umem_config umem_config;
-  struct xsk_socket_config sock_config;
-  struct xdp_options opt;
-  socklen_t optlen;
-  const int is_rx = qid < ad->rxq_num;
-  const int is_tx = qid < ad->txq_num;
-
-  umem = vec_elt_at_index (ad->umem, qid);
-  xsk = vec_elt_at_index (ad->xsk, qid);
-  rxq = vec_elt_at_index (ad->rxqs, qid);
-  txq = vec_elt_at_index (ad->txqs, qid);
 
   /*
-   * fq and cq must always be allocated even if unused
-   * whereas rx and tx indicates whether we want rxq, txq, or both
+   * a single umem covering all buffer memory is registered once and shared
+   * by the sockets of all queues: each queue still gets its own fill and
+   * completion rings, the rings passed here are the ones of queue 0
    */
-  struct xsk_ring_cons *rx = is_rx ? &rxq->rx : 0;
-  struct xsk_ring_prod *fq = &rxq->fq;
-  struct xsk_ring_prod *tx = is_tx ? &txq->tx : 0;
-  struct xsk_ring_cons *cq = &txq->cq;
-  int fd;
-
   memset (&umem_config, 0, sizeof (umem_config));
   umem_config.fill_size = args->rxq_size;
   umem_config.comp_size = args->txq_size;
@@ -307,9 +300,11 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
     sizeof (vlib_buffer_t) + vlib_buffer_get_default_data_size (vm);
   umem_config.frame_headroom = sizeof (vlib_buffer_t);
   umem_config.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG;
-  if (xsk_umem__create
-      (umem, uword_to_pointer (vm->buffer_main->buffer_mem_start, void *),
-       vm->buffer_main->buffer_mem_size, fq, cq, &umem_config))
+  if (xsk_umem__create (
+	&ad->umem,
+	uword_to_pointer (vm->buffer_main->buffer_mem_start, void *),
+	vm->buffer_main->buffer_mem_size, &vec_elt (ad->rxqs, 0).fq,
+	&vec_elt (ad->txqs, 0).cq, &umem_config))
     {
       uword sys_page_size = clib_mem_get_page_size ();
       args->rv = VNET_API_ERROR_SYSCALL_ERROR_1;
@@ -323,13 +318,67 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
 	  "(unsupported data-size? (should be between %d and %d))",
 	  XDP_UMEM_MIN_CHUNK_SIZE - sizeof (vlib_buffer_t),
 	  sys_page_size - sizeof (vlib_buffer_t));
-      goto err0;
+      ad->umem = 0;
+      return -1;
+    }
+
+  return 0;
+}
+
+static int
+af_xdp_set_busy_poll (af_xdp_create_if_args_t *args, int fd)
+{
+  int prefer = 1, usecs = AF_XDP_BUSY_POLL_USECS, budget = VLIB_FRAME_SIZE;
+
+  if (setsockopt (fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer,
+		  sizeof (prefer)) ||
+      setsockopt (fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof (usecs)) ||
+      setsockopt (fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget,
+		  sizeof (budget)))
+    {
+      args->rv = VNET_API_ERROR_SYSCALL_ERROR_4;
+      args->error =
+	clib_error_return_unix (0, "setsockopt(SO_PREFER_BUSY_POLL) failed");
+      return -1;
     }
 
+  return 0;
+}
+
+static int
+af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
+		     af_xdp_device_t *ad, int qid)
+{
+  struct xsk_socket **xsk;
+  af_xdp_rxq_t *rxq;
+  af_xdp_txq_t *txq;
+  struct xsk_socket_config sock_config;
+  struct xdp_options opt;
+  socklen_t optlen;
+  const int is_rx = qid < ad->rxq_num;
+  const int is_tx = qid < ad->txq_num;
+
+  xsk = vec_elt_at_index (ad->xsk, qid);
+  rxq = vec_elt_at_index (ad->rxqs, qid);
+  txq = vec_elt_at_index (ad->txqs, qid);
+
+  /*
+   * fq and cq must always be allocated even if unused
+   * whereas rx and tx indicates whether we want rxq, txq, or both
+   */
+  struct xsk_ring_cons *rx = is_rx ? &rxq->rx : 0;
+  struct xsk_ring_prod *fq = &rxq->fq;
+  struct xsk_ring_prod *tx = is_tx ? &txq->tx : 0;
+  struct xsk_ring_cons *cq = &txq->cq;
+  int fd;
+
   memset (&sock_config, 0, sizeof (sock_config));
   sock_config.rx_size = args->rxq_size;
   sock_config.tx_size = args->txq_size;
   sock_config.bind_flags = XDP_USE_NEED_WAKEUP;
+  /* sockets sharing the umem inherit the bind flags of the first one */
+  if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+    sock_config.bind_flags |= XDP_USE_SG;
   switch (args->mode)
     {
     case AF_XDP_MODE_AUTO:
@@ -343,18 +392,22 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
     }
   if (args->prog)
     sock_config.libbpf_flags = XSK_LIBBPF_FLAGS__INHIBIT_PROG_LOAD;
-  if (xsk_socket__create
-      (xsk, ad->linux_ifname, qid, *umem, rx, tx, &sock_config))
+  if (xsk_socket__create_shared (xsk, ad->linux_ifname, qid, ad->umem, rx,
+				 tx, fq, cq, &sock_config))
     {
       args->rv = VNET_API_ERROR_SYSCALL_ERROR_2;
       args->error =
 	clib_error_return_unix (0,
 				"xsk_socket__create() failed (is linux netdev %s up?)",
 				ad->linux_ifname);
-      goto err1;
+      goto err0;
     }
 
   fd = xsk_socket__fd (*xsk);
+  if ((ad->flags & AF_XDP_DEVICE_F_BUSY_POLL) &&
+      af_xdp_set_busy_poll (args, fd))
+    goto err1;
+
   if (args->prog)
     {
       struct bpf_map *map =
@@ -366,7 +419,7 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
 	  args->error = clib_error_return_unix (
 	    0, "xsk_socket__update_xskmap %s qid %d return %d",
 	    ad->linux_ifname, qid, ret);
-	  goto err2;
+	  goto err1;
 	}
     }
   optlen = sizeof (opt);
@@ -378,7 +431,7 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
       args->rv = VNET_API_ERROR_SYSCALL_ERROR_4;
       args->error =
 	clib_error_return_unix (0, "getsockopt(XDP_OPTIONS) failed");
-      goto err2;
+      goto err1;
     }
   if (opt.flags & XDP_OPTIONS_ZEROCOPY)
     ad->flags |= AF_XDP_DEVICE_F_ZEROCOPY;
@@ -413,12 +466,9 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
 
   return 0;
 
-err2:
-  xsk_socket__delete (*xsk);
 err1:
-  xsk_umem__delete (*umem);
+  xsk_socket__delete (*xsk);
 err0:
-  *umem = 0;
   *xsk = 0;
   return -1;
 }
@@ -633,6 +683,10 @@ af_xdp_create_if (vlib_main_t * vm, af_xdp_create_if_args_t * args)
   if (tm->n_vlib_mains > 1 &&
       0 == (args->flags & AF_XDP_CREATE_FLAGS_NO_SYSCALL_LOCK))
     ad->flags |= AF_XDP_DEVICE_F_SYSCALL_LOCK;
+  if (args->flags & AF_XDP_CREATE_FLAGS_MULTI_BUFFER)
+    ad->flags |= AF_XDP_DEVICE_F_MULTI_BUFFER;
+  if (args->flags & AF_XDP_CREATE_FLAGS_BUSY_POLL)
+    ad->flags |= AF_XDP_DEVICE_F_BUSY_POLL;
 
   ad->linux_ifname = (char *) format (0, "%s", args->linux_ifname);
   vec_validate (ad->linux_ifname, IFNAMSIZ - 1);	/* libbpf expects ifname to be at least IFNAMSIZ */
@@ -658,11 +712,16 @@ af_xdp_create_if (vlib_main_t * vm, af_xdp_create_if_args_t * args)
   ad->rxq_num = rxq_num;
   ad->txq_num = txq_num;
 
-  vec_validate_aligned (ad->umem, q_num - 1, CLIB_CACHE_LINE_BYTES);
   vec_validate_aligned (ad->xsk, q_num - 1, CLIB_CACHE_LINE_BYTES);
   vec_validate_aligned (ad->rxqs, q_num - 1, CLIB_CACHE_LINE_BYTES);
   vec_validate_aligned (ad->txqs, q_num - 1, CLIB_CACHE_LINE_BYTES);
 
+  if (af_xdp_create_umem (vm, args, ad))
+    {
+      ad->rxq_num = ad->txq_num = 0;
+      goto err2;
+    }
+
   for (i = 0; i < q_num; i++)
     {
       if (af_xdp_create_queue (vm, args, ad, i))
@@ -678,7 +737,6 @@ af_xdp_create_if (vlib_main_t * vm, af_xdp_create_if_args_t * args)
 		      "create interface failed to create queue qid=%d", i);
 
 	  /* fixup vectors length */
-	  vec_set_len (ad->umem, i);
 	  vec_set_len (ad->xsk, i);
 	  vec_set_len (ad->rxqs, i);
 	  vec_set_len (ad->txqs, i);
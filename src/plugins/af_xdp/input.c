@@ -70,6 +70,25 @@ af_xdp_device_input_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
   vlib_set_trace_count (vm, node, n_trace);
 }
 
+static_always_inline void
+af_xdp_device_input_kick (vlib_main_t *vm, const vlib_node_runtime_t *node,
+			  af_xdp_device_t *ad, af_xdp_rxq_t *rxq)
+{
+  if (clib_spinlock_trylock_if_init (&rxq->syscall_lock))
+    {
+      int ret = recvmsg (rxq->xsk_fd, 0, MSG_DONTWAIT);
+      clib_spinlock_unlock_if_init (&rxq->syscall_lock);
+      if (PREDICT_FALSE (ret < 0))
+	{
+	  /* something bad is happening */
+	  if (node)
+	    vlib_error_count (vm, node->node_index,
+			      AF_XDP_INPUT_ERROR_SYSCALL_FAILURES, 1);
+	  af_xdp_device_error (ad, "rx poll() failed");
+	}
+    }
+}
+
 static_always_inline void
 af_xdp_device_input_refill_db (vlib_main_t * vm,
 			       const vlib_node_runtime_t * node,
@@ -78,7 +97,9 @@ af_xdp_device_input_refill_db (vlib_main_t * vm,
 {
   xsk_ring_prod__submit (&rxq->fq, n_alloc);
 
+  /* when busy-polling, the kernel is kicked on every poll instead */
   if (AF_XDP_RXQ_MODE_INTERRUPT == rxq->mode ||
+      (ad->flags & AF_XDP_DEVICE_F_BUSY_POLL) ||
       !xsk_ring_prod__needs_wakeup (&rxq->fq))
     return;
 
@@ -86,19 +107,7 @@ af_xdp_device_input_refill_db (vlib_main_t * vm,
     vlib_error_count (vm, node->node_index,
 		      AF_XDP_INPUT_ERROR_SYSCALL_REQUIRED, 1);
 
-  if (clib_spinlock_trylock_if_init (&rxq->syscall_lock))
-    {
-      int ret = recvmsg (rxq->xsk_fd, 0, MSG_DONTWAIT);
-      clib_spinlock_unlock_if_init (&rxq->syscall_lock);
-      if (PREDICT_FALSE (ret < 0))
-	{
-	  /* something bad is happening */
-	  if (node)
-	    vlib_error_count (vm, node->node_index,
-			      AF_XDP_INPUT_ERROR_SYSCALL_FAILURES, 1);
-	  af_xdp_device_error (ad, "rx poll() failed");
-	}
-    }
+  af_xdp_device_input_kick (vm, node, ad, rxq);
 }
 
 static_always_inline void
@@ -277,6 +286,68 @@ af_xdp_device_input_bufs (vlib_main_t *vm, const af_xdp_device_t *ad,
   return bytes;
 }
 
+static_always_inline u32
+af_xdp_device_input_bufs_mb (vlib_main_t *vm, af_xdp_rxq_t *rxq, u32 *bis,
+			     u32 *n_rx_packets, const u32 n_desc,
+			     vlib_buffer_t *bt, u32 idx)
+{
+  vlib_buffer_t *hb = 0, *pb = 0;
+  const u32 mask = rxq->rx.mask;
+  u32 n_pkts = 0, n_done = 0, bytes = 0, pkt_bytes = 0, i;
+
+  /* a packet can span several descriptors, each one but the last flagged
+   * with XDP_PKT_CONTD: fragments are chained behind the head buffer */
+  for (i = 0; i < n_desc; i++)
+    {
+      const struct xdp_desc *desc = xsk_ring_cons__rx_desc (&rxq->rx, idx);
+      const u64 addr = desc->addr;
+      const u32 bi = addr2bi (xsk_umem__extract_addr (addr));
+      vlib_buffer_t *b = vlib_get_buffer (vm, bi);
+
+      ASSERT (vlib_buffer_is_known (vm, bi) == VLIB_BUFFER_KNOWN_ALLOCATED);
+      vlib_buffer_copy_template (b, bt);
+      b->current_data = xsk_umem__extract_offset (addr) - sizeof (*b);
+      b->current_length = desc->len;
+      pkt_bytes += desc->len;
+
+      if (hb)
+	{
+	  pb->next_buffer = bi;
+	  pb->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	  hb->total_length_not_including_first_buffer += desc->len;
+	}
+      else
+	{
+	  hb = b;
+	  bis[n_pkts++] = bi;
+	}
+      pb = b;
+
+      if (!(desc->options & XDP_PKT_CONTD))
+	{
+	  /* end of packet */
+	  hb = 0;
+	  n_done = i + 1;
+	  bytes += pkt_bytes;
+	  pkt_bytes = 0;
+	}
+
+      idx = (idx + 1) & mask;
+    }
+
+  if (hb)
+    {
+      /* last packet is not complete yet: leave its fragments in the ring
+       * for the next poll */
+      n_pkts--;
+      xsk_ring_cons__cancel (&rxq->rx, n_desc - n_done);
+    }
+
+  xsk_ring_cons__release (&rxq->rx, n_done);
+  *n_rx_packets = n_pkts;
+  return bytes;
+}
+
 static_always_inline uword
 af_xdp_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 			    vlib_frame_t *frame, af_xdp_device_t *ad, u16 qid)
@@ -288,6 +359,12 @@ af_xdp_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u32 n_rx_packets, n_rx_bytes;
   u32 idx;
 
+  /* with preferred busy-polling the kernel only processes the queue when
+   * we ask for it: do it on every poll */
+  if ((ad->flags & AF_XDP_DEVICE_F_BUSY_POLL) &&
+      AF_XDP_RXQ_MODE_POLLING == rxq->mode)
+    af_xdp_device_input_kick (vm, node, ad, rxq);
+
   n_rx_packets = xsk_ring_cons__peek (&rxq->rx, VLIB_FRAME_SIZE, &idx);
 
   if (PREDICT_FALSE (0 == n_rx_packets))
@@ -300,8 +377,19 @@ af_xdp_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   vlib_get_new_next_frame (vm, node, next_index, to_next, n_left_to_next);
 
-  n_rx_bytes =
-    af_xdp_device_input_bufs (vm, ad, rxq, to_next, n_rx_packets, &bt, idx);
+  if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+    {
+      n_rx_bytes = af_xdp_device_input_bufs_mb (
+	vm, rxq, to_next, &n_rx_packets, n_rx_packets, &bt, idx);
+      if (PREDICT_FALSE (0 == n_rx_packets))
+	{
+	  vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+	  goto refill;
+	}
+    }
+  else
+    n_rx_bytes = af_xdp_device_input_bufs (vm, ad, rxq, to_next,
+					   n_rx_packets, &bt, idx);
   af_xdp_device_input_ethernet (vm, node, next_index, ad->sw_if_index,
 				ad->hw_if_index);
 
@@ -90,16 +90,21 @@ af_xdp_device_output_tx_db (vlib_main_t * vm,
 			    af_xdp_device_t * ad,
 			    af_xdp_txq_t * txq, const u32 n_tx)
 {
+  const int busy_poll = ad->flags & AF_XDP_DEVICE_F_BUSY_POLL;
+
   xsk_ring_prod__submit (&txq->tx, n_tx);
 
-  if (!xsk_ring_prod__needs_wakeup (&txq->tx))
+  /* when busy-polling, the kernel only transmits when we ask for it */
+  if (!busy_poll && !xsk_ring_prod__needs_wakeup (&txq->tx))
     return;
 
-  vlib_error_count (vm, node->node_index, AF_XDP_TX_ERROR_SYSCALL_REQUIRED, 1);
+  if (!busy_poll)
+    vlib_error_count (vm, node->node_index, AF_XDP_TX_ERROR_SYSCALL_REQUIRED,
+		      1);
 
   clib_spinlock_lock_if_init (&txq->syscall_lock);
 
-  if (xsk_ring_prod__needs_wakeup (&txq->tx))
+  if (busy_poll || xsk_ring_prod__needs_wakeup (&txq->tx))
     {
       const struct msghdr msg = {};
       int ret;
@@ -235,6 +240,63 @@ wrap_around:
   return n_tx;
 }
 
+static_always_inline u32
+af_xdp_device_output_tx_try_mb (vlib_main_t *vm, af_xdp_txq_t *txq,
+				u32 n_tx, u32 *bi, u32 *n_desc)
+{
+  const uword start = vm->buffer_main->buffer_mem_start;
+  u32 n_free, n_segs = 0, n = 0, idx, i;
+
+  *n_desc = 0;
+
+  /* a chained packet is sent as one descriptor per buffer, each one but the
+   * last flagged with XDP_PKT_CONTD: count how many packets fit */
+  n_free = xsk_prod_nb_free (&txq->tx, n_tx);
+  while (n < n_tx)
+    {
+      u32 n_pkt_segs = 1;
+      vlib_buffer_t *b = vlib_get_buffer (vm, bi[n]);
+      while (b->flags & VLIB_BUFFER_NEXT_PRESENT)
+	{
+	  b = vlib_get_buffer (vm, b->next_buffer);
+	  n_pkt_segs++;
+	}
+      if (n_segs + n_pkt_segs > n_free)
+	break;
+      n_segs += n_pkt_segs;
+      n++;
+    }
+
+  if (PREDICT_FALSE (0 == n_segs ||
+		     xsk_ring_prod__reserve (&txq->tx, n_segs, &idx) != n_segs))
+    return 0;
+
+  for (i = 0; i < n; i++)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, bi[i]);
+      while (1)
+	{
+	  struct xdp_desc *desc = xsk_ring_prod__tx_desc (&txq->tx, idx++);
+	  const u64 offset = (sizeof (vlib_buffer_t) + b->current_data)
+			     << XSK_UNALIGNED_BUF_OFFSET_SHIFT;
+	  desc->addr = offset | (pointer_to_uword (b) - start);
+	  desc->len = b->current_length;
+	  desc->options = 0;
+
+	  if (!(b->flags & VLIB_BUFFER_NEXT_PRESENT))
+	    break;
+
+	  /* each buffer is completed, and freed, on its own */
+	  desc->options = XDP_PKT_CONTD;
+	  b->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+	  b = vlib_get_buffer (vm, b->next_buffer);
+	}
+    }
+
+  *n_desc = n_segs;
+  return n;
+}
+
 VNET_DEVICE_CLASS_TX_FN (af_xdp_device_class) (vlib_main_t * vm,
 					       vlib_node_runtime_t * node,
 					       vlib_frame_t * frame)
@@ -246,7 +308,7 @@ VNET_DEVICE_CLASS_TX_FN (af_xdp_device_class) (vlib_main_t * vm,
   const int shared_queue = tf->shared_queue;
   af_xdp_txq_t *txq = vec_elt_at_index (ad->txqs, tf->queue_id);
   u32 *from;
-  u32 n, n_tx;
+  u32 n, n_tx, n_desc = 0;
   int i;
 
   from = vlib_frame_vector_args (frame);
@@ -258,13 +320,19 @@ VNET_DEVICE_CLASS_TX_FN (af_xdp_device_class) (vlib_main_t * vm,
   for (i = 0, n = 0; i < AF_XDP_TX_RETRIES && n < n_tx; i++)
     {
       u32 n_enq;
+      u32 n_enq_desc;
       af_xdp_device_output_free (vm, node, txq);
-      n_enq =
-	af_xdp_device_output_tx_try (vm, node, ad, txq, n_tx - n, from + n);
+      if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+	n_enq = af_xdp_device_output_tx_try_mb (vm, txq, n_tx - n, from + n,
+						&n_enq_desc);
+      else
+	n_enq_desc = n_enq = af_xdp_device_output_tx_try (vm, node, ad, txq,
+							   n_tx - n, from + n);
       n += n_enq;
+      n_desc += n_enq_desc;
     }
 
-  af_xdp_device_output_tx_db (vm, node, ad, txq, n);
+  af_xdp_device_output_tx_db (vm, node, ad, txq, n_desc);
 
   if (shared_queue)
     clib_spinlock_unlock (&txq->lock);
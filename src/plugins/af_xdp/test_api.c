@@ -84,6 +84,10 @@ api_af_xdp_create_v3 (vat_main_t *vam)
   mp->mode = api_af_xdp_mode (args.mode);
   if (args.flags & AF_XDP_CREATE_FLAGS_NO_SYSCALL_LOCK)
     mp->flags |= AF_XDP_API_FLAGS_NO_SYSCALL_LOCK;
+  if (args.flags & AF_XDP_CREATE_FLAGS_MULTI_BUFFER)
+    mp->flags |= AF_XDP_API_FLAGS_MULTI_BUFFER;
+  if (args.flags & AF_XDP_CREATE_FLAGS_BUSY_POLL)
+    mp->flags |= AF_XDP_API_FLAGS_BUSY_POLL;
   snprintf ((char *) mp->prog, sizeof (mp->prog), "%s", args.prog ?: "");
 
   S (mp);
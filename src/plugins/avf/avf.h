@@ -183,6 +183,19 @@ typedef struct
   u64 total_packets;
 } avf_rxq_t;
 
+#define AVF_TX_STAGE_SIZE 1024
+
+/* per-thread staging ring in front of a shared tx queue, single producer
+ * (the owning thread) and single consumer (the lock holder) */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  u32 head;
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  u32 tail;
+  u32 bufs[AVF_TX_STAGE_SIZE];
+} avf_tx_stage_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -191,6 +204,7 @@ typedef struct
   u16 size;
   u32 *ph_bufs;
   clib_spinlock_t lock;
+  avf_tx_stage_t *stages;
   avf_tx_desc_t *descs;
   u32 *bufs;
   u16 n_enqueued;
@@ -307,6 +307,8 @@ avf_txq_init (vlib_main_t * vm, avf_device_t * ad, u16 qid, u16 txq_size)
   txq->size = txq_size;
   txq->next = 0;
   clib_spinlock_init (&txq->lock);
+  vec_validate_aligned (txq->stages, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
 
   /* Prepare a placeholder buffer(s) to maintain a 1-1 relationship between
    * bufs and descs when a context descriptor is added in descs. Worst case
@@ -1549,6 +1551,7 @@ avf_delete_if (vlib_main_t * vm, avf_device_t * ad, int with_barrier)
       vec_free (txq->tmp_bufs);
       vec_free (txq->tmp_descs);
       clib_spinlock_free (&txq->lock);
+      vec_free (txq->stages);
     }
   vec_free (ad->txqs);
   vec_free (ad->name);
@@ -418,26 +418,17 @@ avf_tx_prepare (vlib_main_t *vm, vlib_node_runtime_t *node, avf_txq_t *txq,
   return n_packets - n_packets_left;
 }
 
-VNET_DEVICE_CLASS_TX_FN (avf_device_class) (vlib_main_t * vm,
-					    vlib_node_runtime_t * node,
-					    vlib_frame_t * frame)
+/* enqueue buffers on the descriptor ring, returns number of buffers
+ * dropped for lack of free descriptors */
+static_always_inline u16
+avf_tx_burst (vlib_main_t *vm, vlib_node_runtime_t *node, avf_device_t *ad,
+	      avf_txq_t *txq, u32 *buffers, u16 n_left)
 {
-  vnet_interface_output_runtime_t *rd = (void *) node->runtime_data;
-  avf_device_t *ad = avf_get_device (rd->dev_instance);
-  vnet_hw_if_tx_frame_t *tf = vlib_frame_scalar_args (frame);
-  u8 qid = tf->queue_id;
-  avf_txq_t *txq = vec_elt_at_index (ad->txqs, qid);
   u16 next;
   u16 mask = txq->size - 1;
-  u32 *buffers = vlib_frame_vector_args (frame);
-  u16 n_enq, n_left, n_desc, *slot;
+  u16 n_enq, n_desc, *slot;
   u16 n_retry = 2;
 
-  if (tf->shared_queue)
-    clib_spinlock_lock (&txq->lock);
-
-  n_left = frame->n_vectors;
-
 retry:
   next = txq->next;
   /* release consumed bufs */
@@ -467,8 +458,8 @@ retry:
 	  n_free = (complete_slot + 1 - first) & mask;
 
 	  txq->n_enqueued -= n_free;
-	  vlib_buffer_free_from_ring_no_next (vm, txq->bufs, first, txq->size,
-					      n_free);
+	  vlib_buffer_free_from_ring_no_next_deferred (vm, txq->bufs, first,
+						       txq->size, n_free);
 	}
     }
 
@@ -526,10 +517,117 @@ retry:
       txq->no_free_tx_count += n_left;
     }
 
-  if (tf->shared_queue)
-    clib_spinlock_unlock (&txq->lock);
+  return n_left;
+}
+
+static_always_inline u16
+avf_tx_stage (avf_tx_stage_t *st, u32 *buffers, u16 n_left)
+{
+  u32 head = st->head;
+  u32 n_free, n, offset;
+
+  n_free = AVF_TX_STAGE_SIZE - (head - clib_atomic_load_acq_n (&st->tail));
+  n = clib_min (n_free, n_left);
+  offset = head & (AVF_TX_STAGE_SIZE - 1);
+
+  if (offset + n <= AVF_TX_STAGE_SIZE)
+    vlib_buffer_copy_indices (st->bufs + offset, buffers, n);
+  else
+    {
+      u32 n_not_wrap = AVF_TX_STAGE_SIZE - offset;
+      vlib_buffer_copy_indices (st->bufs + offset, buffers, n_not_wrap);
+      vlib_buffer_copy_indices (st->bufs, buffers + n_not_wrap,
+				n - n_not_wrap);
+    }
+
+  clib_atomic_store_rel_n (&st->head, head + n);
+  return n;
+}
+
+/* flush every thread's staged buffers, caller holds the queue lock */
+static_always_inline void
+avf_tx_stages_flush (vlib_main_t *vm, vlib_node_runtime_t *node,
+		     avf_device_t *ad, avf_txq_t *txq)
+{
+  avf_tx_stage_t *st;
+
+  vec_foreach (st, txq->stages)
+    {
+      u32 tail = st->tail;
+      u32 head = clib_atomic_load_acq_n (&st->head);
+      u32 offset, n;
+
+      while (head != tail)
+	{
+	  offset = tail & (AVF_TX_STAGE_SIZE - 1);
+	  n = clib_min (head - tail, AVF_TX_STAGE_SIZE - offset);
+	  avf_tx_burst (vm, node, ad, txq, st->bufs + offset, n);
+	  tail += n;
+	}
+
+      clib_atomic_store_rel_n (&st->tail, tail);
+    }
+}
+
+static_always_inline int
+avf_tx_stages_pending (avf_txq_t *txq)
+{
+  avf_tx_stage_t *st;
+
+  vec_foreach (st, txq->stages)
+    if (clib_atomic_load_acq_n (&st->head) != st->tail)
+      return 1;
+  return 0;
+}
+
+VNET_DEVICE_CLASS_TX_FN (avf_device_class) (vlib_main_t * vm,
+					    vlib_node_runtime_t * node,
+					    vlib_frame_t * frame)
+{
+  vnet_interface_output_runtime_t *rd = (void *) node->runtime_data;
+  avf_device_t *ad = avf_get_device (rd->dev_instance);
+  vnet_hw_if_tx_frame_t *tf = vlib_frame_scalar_args (frame);
+  u8 qid = tf->queue_id;
+  avf_txq_t *txq = vec_elt_at_index (ad->txqs, qid);
+  u32 *buffers = vlib_frame_vector_args (frame);
+  avf_tx_stage_t *st;
+  u16 n_left = frame->n_vectors;
+  u16 n_staged;
+
+  if (!tf->shared_queue)
+    return n_left - avf_tx_burst (vm, node, ad, txq, buffers, n_left);
+
+  /*
+   * Shared queue: stage the frame on this thread's ring and let whoever
+   * holds the queue lock flush all rings onto the descriptor ring. A
+   * thread failing the trylock leaves its buffers to the holder, which
+   * rechecks the rings after dropping the lock.
+   */
+  st = vec_elt_at_index (txq->stages, vm->thread_index);
+  n_staged = avf_tx_stage (st, buffers, n_left);
+
+  if (PREDICT_FALSE (n_staged < n_left))
+    {
+      u16 n_drop;
+
+      /* staging ring full, wait for the queue */
+      clib_spinlock_lock (&txq->lock);
+      avf_tx_stages_flush (vm, node, ad, txq);
+      n_drop = avf_tx_burst (vm, node, ad, txq, buffers + n_staged,
+			     n_left - n_staged);
+      clib_spinlock_unlock (&txq->lock);
+      return n_left - n_drop;
+    }
+
+  while (clib_spinlock_trylock (&txq->lock))
+    {
+      avf_tx_stages_flush (vm, node, ad, txq);
+      clib_spinlock_unlock (&txq->lock);
+      if (!avf_tx_stages_pending (txq))
+	break;
+    }
 
-  return frame->n_vectors - n_left;
+  return n_left;
 }
 
 /*
@@ -50,7 +50,7 @@ cnat_timestamp_get_if_valid (u32 index)
 }
 
 always_inline index_t
-cnat_timestamp_alloc ()
+cnat_timestamp_alloc (u32 lifetime)
 {
   cnat_timestamp_t *ts;
   u32 index, pool_sz;
@@ -67,31 +67,44 @@ cnat_timestamp_alloc ()
   pool_get (cnat_timestamps.ts_pools[pidx], ts);
   if (pool_elts (cnat_timestamps.ts_pools[pidx]) == pool_sz)
     clib_bitmap_set (cnat_timestamps.ts_free, pidx, 0);
-  clib_spinlock_unlock (&cnat_timestamps.ts_lock);
 
   index = (u32) pidx << (32 - CNAT_TS_MPOOL_BITS);
-  return index | (ts - cnat_timestamps.ts_pools[pidx]);
+  index |= ts - cnat_timestamps.ts_pools[pidx];
+  ts->timer_handle = tw_timer_start_1t_3w_1024sl_ov (
+    &cnat_timestamps.ts_wheel, index, 0, clib_max (lifetime, 1));
+  clib_spinlock_unlock (&cnat_timestamps.ts_lock);
+
+  return index;
 }
 
 always_inline void
 cnat_timestamp_destroy (u32 index)
 {
   u32 pidx = index >> (32 - CNAT_TS_MPOOL_BITS);
+  cnat_timestamp_t *ts = cnat_timestamp_get (index);
   index = index & (0xffffffff >> CNAT_TS_MPOOL_BITS);
   clib_spinlock_lock (&cnat_timestamps.ts_lock);
+  if (ts->timer_handle != ~0)
+    tw_timer_stop_1t_3w_1024sl_ov (&cnat_timestamps.ts_wheel,
+				   ts->timer_handle);
   pool_put_index (cnat_timestamps.ts_pools[pidx], index);
   clib_bitmap_set (cnat_timestamps.ts_free, pidx, 1);
   clib_spinlock_unlock (&cnat_timestamps.ts_lock);
 }
 
+/*
+ * key is the forward session key, it is used to find the sessions when the
+ * expiry timer fires
+ */
 always_inline u32
-cnat_timestamp_new (f64 t)
+cnat_timestamp_new (f64 t, const u64 *key)
 {
-  index_t index = cnat_timestamp_alloc ();
+  index_t index = cnat_timestamp_alloc (cnat_main.session_max_age);
   cnat_timestamp_t *ts = cnat_timestamp_get (index);
   ts->last_seen = t;
   ts->lifetime = cnat_main.session_max_age;
   ts->refcnt = CNAT_TIMESTAMP_INIT_REFCNT;
+  clib_memcpy_fast (ts->session_key, key, sizeof (ts->session_key));
   return index;
 }
 
@@ -113,6 +126,17 @@ always_inline void
 cnat_timestamp_set_lifetime (u32 index, u16 lifetime)
 {
   cnat_timestamp_t *ts = cnat_timestamp_get (index);
+
+  /* a longer lifetime is handled when the timer expires, a shorter one
+   * needs the timer to be moved earlier */
+  if (PREDICT_FALSE (lifetime < ts->lifetime))
+    {
+      clib_spinlock_lock (&cnat_timestamps.ts_lock);
+      if (ts->timer_handle != ~0)
+	tw_timer_update_1t_3w_1024sl_ov (&cnat_timestamps.ts_wheel,
+					 ts->timer_handle, clib_max (lifetime, 1));
+      clib_spinlock_unlock (&cnat_timestamps.ts_lock);
+    }
   ts->lifetime = lifetime;
 }
 
@@ -403,6 +403,49 @@ cnat_translation_icmp4_error (ip4_header_t *outer_ip4, icmp46_header_t *icmp,
   icmp->checksum = ip_csum_fold (sum);
 }
 
+/*
+ * TCP and UDP packets hitting a session carry the session key, the
+ * checksums are then updated with the deltas precomputed in the session
+ */
+static_always_inline int
+cnat_translation_ip4_fast (const cnat_session_t *session, ip4_header_t *ip4,
+			   udp_header_t *udp, u32 oflags)
+{
+  tcp_header_t *tcp = (tcp_header_t *) udp;
+  u16 *l4_csum;
+
+  if (ip4->protocol == IP_PROTOCOL_TCP)
+    l4_csum = &tcp->checksum;
+  else if (ip4->protocol == IP_PROTOCOL_UDP)
+    l4_csum = &udp->checksum;
+  else
+    return 0;
+
+  if (PREDICT_FALSE (oflags & (VNET_BUFFER_OFFLOAD_F_TCP_CKSUM |
+			       VNET_BUFFER_OFFLOAD_F_UDP_CKSUM)))
+    return 0;
+
+  if (PREDICT_FALSE (
+	(ip4->src_address.as_u32 ^ session->key.cs_ip[VLIB_RX].ip4.as_u32) |
+	(ip4->dst_address.as_u32 ^ session->key.cs_ip[VLIB_TX].ip4.as_u32) |
+	(*(u32u *) &udp->src_port ^ *(u32u *) session->key.cs_port)))
+    return 0;
+
+  ip4->src_address = session->value.cs_ip[VLIB_RX].ip4;
+  ip4->dst_address = session->value.cs_ip[VLIB_TX].ip4;
+  *(u32u *) &udp->src_port = *(u32u *) session->value.cs_port;
+
+  ip4->checksum = ip_csum_fold (
+    ip_csum_with_carry (ip4->checksum, session->value.cs_l3_csum_delta));
+  *l4_csum = ip_csum_fold (
+    ip_csum_with_carry (*l4_csum, session->value.cs_l4_csum_delta));
+
+  if (ip4->protocol == IP_PROTOCOL_TCP)
+    cnat_tcp_update_session_lifetime (tcp, session->value.cs_ts_index);
+
+  return 1;
+}
+
 static_always_inline void
 cnat_translation_ip4 (const cnat_session_t *session, ip4_header_t *ip4,
 		      udp_header_t *udp, u32 oflags)
@@ -411,6 +454,9 @@ cnat_translation_ip4 (const cnat_session_t *session, ip4_header_t *ip4,
   ip4_address_t new_addr[VLIB_N_DIR];
   u16 new_port[VLIB_N_DIR];
 
+  if (cnat_translation_ip4_fast (session, ip4, udp, oflags))
+    return;
+
   new_addr[VLIB_TX] = session->value.cs_ip[VLIB_TX].ip4;
   new_addr[VLIB_RX] = session->value.cs_ip[VLIB_RX].ip4;
   new_port[VLIB_TX] = session->value.cs_port[VLIB_TX];
@@ -687,6 +733,49 @@ cnat_translation_icmp6_error (ip6_header_t * outer_ip6,
   icmp->checksum = ip_csum_fold (sum);
 }
 
+static_always_inline int
+cnat_translation_ip6_fast (const cnat_session_t *session, ip6_header_t *ip6,
+			   udp_header_t *udp, u32 oflags)
+{
+  tcp_header_t *tcp = (tcp_header_t *) udp;
+  u16 *l4_csum;
+
+  if (ip6->protocol == IP_PROTOCOL_TCP)
+    l4_csum = &tcp->checksum;
+  else if (ip6->protocol == IP_PROTOCOL_UDP)
+    l4_csum = &udp->checksum;
+  else
+    return 0;
+
+  if (PREDICT_FALSE (oflags & (VNET_BUFFER_OFFLOAD_F_TCP_CKSUM |
+			       VNET_BUFFER_OFFLOAD_F_UDP_CKSUM)))
+    return 0;
+
+  if (PREDICT_FALSE (
+	(ip6->src_address.as_u64[0] ^
+	 session->key.cs_ip[VLIB_RX].ip6.as_u64[0]) |
+	(ip6->src_address.as_u64[1] ^
+	 session->key.cs_ip[VLIB_RX].ip6.as_u64[1]) |
+	(ip6->dst_address.as_u64[0] ^
+	 session->key.cs_ip[VLIB_TX].ip6.as_u64[0]) |
+	(ip6->dst_address.as_u64[1] ^
+	 session->key.cs_ip[VLIB_TX].ip6.as_u64[1]) |
+	(*(u32u *) &udp->src_port ^ *(u32u *) session->key.cs_port)))
+    return 0;
+
+  ip6_address_copy (&ip6->src_address, &session->value.cs_ip[VLIB_RX].ip6);
+  ip6_address_copy (&ip6->dst_address, &session->value.cs_ip[VLIB_TX].ip6);
+  *(u32u *) &udp->src_port = *(u32u *) session->value.cs_port;
+
+  *l4_csum = ip_csum_fold (
+    ip_csum_with_carry (*l4_csum, session->value.cs_l4_csum_delta));
+
+  if (ip6->protocol == IP_PROTOCOL_TCP)
+    cnat_tcp_update_session_lifetime (tcp, session->value.cs_ts_index);
+
+  return 1;
+}
+
 static_always_inline void
 cnat_translation_ip6 (const cnat_session_t *session, ip6_header_t *ip6,
 		      udp_header_t *udp, u32 oflags)
@@ -695,6 +784,9 @@ cnat_translation_ip6 (const cnat_session_t *session, ip6_header_t *ip6,
   ip6_address_t new_addr[VLIB_N_DIR];
   u16 new_port[VLIB_N_DIR];
 
+  if (cnat_translation_ip6_fast (session, ip6, udp, oflags))
+    return;
+
   ip6_address_copy (&new_addr[VLIB_TX], &session->value.cs_ip[VLIB_TX].ip6);
   ip6_address_copy (&new_addr[VLIB_RX], &session->value.cs_ip[VLIB_RX].ip6);
   new_port[VLIB_TX] = session->value.cs_port[VLIB_TX];
@@ -941,12 +1033,46 @@ cnat_load_balance (const cnat_translation_t *ct, ip_address_family_t af,
  * matched at
  */
 
+/**
+ * Precompute the checksum deltas of the key to value rewrite
+ */
+static_always_inline void
+cnat_session_update_csum_delta (cnat_session_t *session)
+{
+  ip_csum_t sum = 0;
+  int i;
+
+  if (AF_IP4 == session->key.cs_af)
+    for (i = 0; i < VLIB_N_DIR; i++)
+      {
+	sum = ip_csum_sub_even (sum, session->key.cs_ip[i].ip4.as_u32);
+	sum = ip_csum_add_even (sum, session->value.cs_ip[i].ip4.as_u32);
+      }
+  else
+    for (i = 0; i < VLIB_N_DIR; i++)
+      {
+	sum = ip_csum_sub_even (sum, session->key.cs_ip[i].ip6.as_u64[0]);
+	sum = ip_csum_sub_even (sum, session->key.cs_ip[i].ip6.as_u64[1]);
+	sum = ip_csum_add_even (sum, session->value.cs_ip[i].ip6.as_u64[0]);
+	sum = ip_csum_add_even (sum, session->value.cs_ip[i].ip6.as_u64[1]);
+      }
+  session->value.cs_l3_csum_delta = ip_csum_fold (sum);
+
+  for (i = 0; i < VLIB_N_DIR; i++)
+    {
+      sum = ip_csum_sub_even (sum, session->key.cs_port[i]);
+      sum = ip_csum_add_even (sum, session->value.cs_port[i]);
+    }
+  session->value.cs_l4_csum_delta = ip_csum_fold (sum);
+}
+
 static_always_inline void
 cnat_session_create (cnat_session_t *session, cnat_node_ctx_t *ctx)
 {
   cnat_bihash_kv_t *bkey = (cnat_bihash_kv_t *) session;
 
-  session->value.cs_ts_index = cnat_timestamp_new (ctx->now);
+  cnat_session_update_csum_delta (session);
+  session->value.cs_ts_index = cnat_timestamp_new (ctx->now, bkey->key);
   cnat_bihash_add_del (&cnat_session_db, bkey, 1);
 }
 
@@ -987,6 +1113,7 @@ cnat_rsession_create (cnat_session_t *session, cnat_node_ctx_t *ctx,
   rsession->value.cs_port[VLIB_RX] = session->key.cs_port[VLIB_TX];
 
 retry_add_ression:
+  cnat_session_update_csum_delta (rsession);
   rv = cnat_bihash_add_del (&cnat_session_db, &rkey,
 			    2 /* add but don't overwrite */);
   if (rv)
@@ -994,6 +1121,10 @@ retry_add_ression:
       if (!(rsession_flags & CNAT_SESSION_RETRY_SNAT))
 	return;
 
+      /* the forward session added first is not reachable from the
+       * timestamp anymore, leave it to a full table sweep */
+      cnat_main.session_sweep_pending = 1;
+
       /* return session add failed pick an new random src port */
       rsession->value.cs_port[VLIB_TX] = session->key.cs_port[VLIB_RX] =
 	random_u32 (&sport_seed);
@@ -1007,6 +1138,7 @@ retry_add_ression:
 	}
     }
 
+  cnat_session_update_csum_delta (session);
   cnat_bihash_add_del (&cnat_session_db, bkey, 1 /* add */);
 
   if (!(rsession_flags & CNAT_SESSION_FLAG_NO_CLIENT))
@@ -25,11 +25,14 @@ cnat_scanner_process (vlib_main_t * vm,
   cnat_main_t *cm = &cnat_main;
   f64 start_time;
   int enabled = 0, i = 0;
+  u32 n_left = 0;
 
   while (1)
     {
+      /* come back soon when expired sessions are left over */
       if (enabled)
-	vlib_process_wait_for_event_or_clock (vm, cm->scanner_timeout);
+	vlib_process_wait_for_event_or_clock (
+	  vm, n_left ? 10e-5 : cm->scanner_timeout);
       else
 	vlib_process_wait_for_event (vm);
 
@@ -54,7 +57,16 @@ cnat_scanner_process (vlib_main_t * vm,
 	}
 
       cnat_client_throttle_pool_process ();
-      i = cnat_session_scan (vm, start_time, i);
+      n_left = cnat_session_expire (vm, start_time);
+
+      /* the full table walk is only needed for sessions that can not be
+       * reached from their timestamp */
+      if (i || cm->session_sweep_pending)
+	{
+	  if (i == 0)
+	    cm->session_sweep_pending = 0;
+	  i = cnat_session_scan (vm, vlib_time_now (vm), i);
+	}
     }
   return 0;
 }
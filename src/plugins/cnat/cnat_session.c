@@ -23,6 +23,9 @@
 cnat_bihash_t cnat_session_db;
 void (*cnat_free_port_cb) (u16 port, ip_protocol_t iproto);
 
+/* timestamps whose timer expired, not processed yet */
+static u32 *cnat_expired_ts;
+
 typedef struct cnat_session_walk_ctx_t_
 {
   cnat_session_walk_cb_t cb;
@@ -271,6 +274,87 @@ cnat_session_scan (vlib_main_t * vm, f64 start_time, int i)
   return (0);
 }
 
+static_always_inline void
+cnat_session_expire_one (u32 ts_index)
+{
+  cnat_timestamp_t *ts = cnat_timestamp_get (ts_index);
+  cnat_bihash_kv_t bkey, bvalue;
+  cnat_session_t *session = (cnat_session_t *) &bvalue;
+
+  clib_memcpy_fast (bkey.key, ts->session_key, sizeof (bkey.key));
+  if (cnat_bihash_search_i2 (&cnat_session_db, &bkey, &bvalue) ||
+      session->value.cs_ts_index != ts_index)
+    {
+      /* the forward session is gone or was replaced, whatever still
+       * references this timestamp can only be found by walking the table */
+      cnat_main.session_sweep_pending = 1;
+      return;
+    }
+
+  cnat_reverse_session_free (session);
+  cnat_session_free (session);
+}
+
+u32
+cnat_session_expire (vlib_main_t *vm, f64 start_time)
+{
+  cnat_timestamp_t *ts;
+  u32 *ti, *rearm = 0, n_left;
+  f64 exp;
+  int i;
+
+  clib_spinlock_lock (&cnat_timestamps.ts_lock);
+  i = vec_len (cnat_expired_ts);
+  cnat_expired_ts = tw_timer_expire_timers_vec_1t_3w_1024sl_ov (
+    &cnat_timestamps.ts_wheel, start_time, cnat_expired_ts);
+  /* only the main thread destroys timestamps, these are still valid */
+  for (; i < vec_len (cnat_expired_ts); i++)
+    cnat_timestamp_get (cnat_expired_ts[i])->timer_handle = ~0;
+  clib_spinlock_unlock (&cnat_timestamps.ts_lock);
+
+  for (i = 0; i < vec_len (cnat_expired_ts); i++)
+    {
+      /* allow no more than 100us without a pause */
+      if ((i & 31) == 31 && (vlib_time_now (vm) - start_time) > 10e-5)
+	break;
+
+      /* freed or reused since it was left over by a previous call */
+      ts = cnat_timestamp_get_if_valid (cnat_expired_ts[i]);
+      if (NULL == ts || ts->timer_handle != ~0)
+	continue;
+
+      exp = ts->last_seen + (f64) ts->lifetime;
+      if (start_time > exp)
+	cnat_session_expire_one (cnat_expired_ts[i]);
+      else
+	vec_add1 (rearm, cnat_expired_ts[i]);
+    }
+
+  vec_delete (cnat_expired_ts, i, 0);
+  n_left = vec_len (cnat_expired_ts);
+
+  if (vec_len (rearm) == 0)
+    return n_left;
+
+  /* sessions seen since the timer was started, arm again for the time
+   * they have left */
+  clib_spinlock_lock (&cnat_timestamps.ts_lock);
+  vec_foreach (ti, rearm)
+    {
+      ts = cnat_timestamp_get (*ti);
+      if (ts->timer_handle != ~0)
+	continue;
+      exp = ts->last_seen + (f64) ts->lifetime;
+      ts->timer_handle = tw_timer_start_1t_3w_1024sl_ov (
+	&cnat_timestamps.ts_wheel, *ti, 0,
+	clib_max ((u64) (exp - start_time) + 1, 1));
+    }
+  clib_spinlock_unlock (&cnat_timestamps.ts_lock);
+  vec_free (rearm);
+
+  return n_left;
+}
+
 static clib_error_t *
 cnat_session_init (vlib_main_t * vm)
 {
@@ -285,6 +369,8 @@ cnat_session_init (vlib_main_t * vm)
   clib_bitmap_set_region (cnat_timestamps.ts_free, 0, 1,
 			  1 << CNAT_TS_MPOOL_BITS);
   clib_spinlock_init (&cnat_timestamps.ts_lock);
+  tw_timer_wheel_init_1t_3w_1024sl_ov (&cnat_timestamps.ts_wheel, NULL,
+				       1.0 /* timer interval */, ~0);
 
   return (NULL);
 }
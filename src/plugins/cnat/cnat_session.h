@@ -103,7 +103,12 @@ typedef struct cnat_session_t_
      */
     u32 flags;
 
-    u32 __pad;
+    /**
+     * Checksum deltas from the key to the translated addresses (l3) and
+     * addresses and ports (l4), precomputed for TCP and UDP
+     */
+    u16 cs_l3_csum_delta;
+    u16 cs_l4_csum_delta;
   } value;
 } cnat_session_t;
 
@@ -178,6 +183,12 @@ extern void cnat_session_walk (cnat_session_walk_cb_t cb, void *ctx);
  */
 extern u64 cnat_session_scan (vlib_main_t * vm, f64 start_time, int i);
 
+/**
+ * Free the sessions whose expiry timer fired, returns the number of
+ * expired timestamps left for the next call
+ */
+extern u32 cnat_session_expire (vlib_main_t *vm, f64 start_time);
+
 /**
  * Purge all the sessions
  */
@@ -17,6 +17,7 @@
 #define __CNAT_TYPES_H__
 
 #include <vppinfra/bihash_24_8.h>
+#include <vppinfra/tw_timer_1t_3w_1024sl_ov.h>
 #include <vnet/fib/fib_node.h>
 #include <vnet/fib/fib_source.h>
 #include <vnet/ip/ip_types.h>
@@ -157,6 +158,10 @@ typedef struct cnat_main_
   /* Enable or Disable the scanner on startup */
   u8 default_scanner_state;
 
+  /* Sessions not reachable from their timestamp exist, walk the whole
+   * session table on the next scans */
+  u8 session_sweep_pending;
+
   /* Number of buckets for maglev, should be a
    * prime >= 100 * max num bakends */
   u32 maglev_len;
@@ -170,6 +175,10 @@ typedef struct cnat_timestamp_t_
   u16 lifetime;
   /* Users refcount, initially 3 (session, rsession, dpo) */
   u16 refcnt;
+  /* expiry timer, ~0 when not running */
+  u32 timer_handle;
+  /* key of the forward session, looked up when the timer expires */
+  u64 session_key[5];
 } cnat_timestamp_t;
 
 /* Create the first pool with 1 << CNAT_TS_BASE_SIZE elts */
@@ -185,8 +194,10 @@ typedef struct cnat_timestamp_mpool_t_
   uword *ts_free;
   /* Index of next pool to init */
   u8 next_empty_pool_idx;
-  /* ts creation lock */
+  /* ts creation lock, also protects the wheel */
   clib_spinlock_t ts_lock;
+  /* Expiry timers, one second ticks, advanced by the scanner */
+  tw_timer_wheel_1t_3w_1024sl_ov_t ts_wheel;
 } cnat_timestamp_mpool_t;
 
 typedef struct cnat_node_ctx_
@@ -40,11 +40,25 @@ typedef struct
   vnet_crypto_async_frame_t **jobs;
 } crypto_sw_scheduler_queue_t;
 
+typedef struct
+{
+  /* frames processed, and those of them enqueued by other threads */
+  u64 n_frames;
+  u64 n_stolen;
+  u64 n_stolen_remote_numa;
+  u64 n_elts;
+  /* cpu clocks spent processing frames */
+  u64 crypto_clocks;
+  /* dispatches that ran out of crypto budget */
+  u64 n_budget_exhausted;
+  /* deepest queue seen when looking for a frame to steal */
+  u32 max_steal_depth;
+} crypto_sw_scheduler_stats_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   crypto_sw_scheduler_queue_t queue[CRYPTO_SW_SCHED_QUEUE_N_TYPES];
-  u32 last_serve_lcore_id;
   u8 last_serve_encrypt;
   u8 last_return_queue;
   vnet_crypto_op_t *crypto_ops;
@@ -53,6 +67,12 @@ typedef struct
   vnet_crypto_op_t *chained_integ_ops;
   vnet_crypto_op_chunk_t *chunks;
   u8 self_crypto_enabled;
+  /* crypto clocks spent in the current dispatch */
+  u32 budget_main_loop;
+  u64 budget_clocks_used;
+  /* peers' queues to steal from, in the order to try them */
+  u64 *steal_candidates;
+  crypto_sw_scheduler_stats_t stats;
 } crypto_sw_scheduler_per_thread_data_t;
 
 typedef struct
@@ -61,12 +81,16 @@ typedef struct
   crypto_sw_scheduler_per_thread_data_t *per_thread_data;
   vnet_crypto_key_t *keys;
   u32 crypto_sw_scheduler_queue_mask;
+  /* cpu clocks a worker may spend on crypto per dispatch, 0 for no limit */
+  u64 crypto_budget_clocks;
 } crypto_sw_scheduler_main_t;
 
 extern crypto_sw_scheduler_main_t crypto_sw_scheduler_main;
 
 extern int crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled);
 
+extern void crypto_sw_scheduler_set_crypto_budget (u64 clocks);
+
 extern clib_error_t *crypto_sw_scheduler_api_init (vlib_main_t * vm);
 
 #endif // __crypto_native_h__
@@ -50,6 +50,14 @@ crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled)
   return 0;
 }
 
+void
+crypto_sw_scheduler_set_crypto_budget (u64 clocks)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+
+  cm->crypto_budget_clocks = clocks;
+}
+
 static void
 crypto_sw_scheduler_key_handler (vnet_crypto_key_op_t kop,
 				 vnet_crypto_key_index_t idx)
@@ -444,89 +452,183 @@ convert_async_crypto_id (vnet_crypto_op_id_t async_op_id, u32 *crypto_op,
   return -1;
 }
 
+static int
+crypto_sw_scheduler_cmp (void *a1, void *a2)
+{
+  u64 *v1 = a1, *v2 = a2;
+
+  return (*v1 > *v2) - (*v1 < *v2);
+}
+
+/* claim the oldest pending frame of a queue */
 static_always_inline vnet_crypto_async_frame_t *
-crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
-			     clib_thread_index_t *enqueue_thread_idx)
+crypto_sw_scheduler_claim_frame (crypto_sw_scheduler_queue_t *q, u32 mask)
+{
+  vnet_crypto_async_frame_t *f;
+  u32 tail = q->tail, head = q->head, j;
+
+  /* Skip this queue unless tail < head or head has overflowed
+   * and tail has not. At the point where tail overflows (== 0),
+   * the largest possible value of head is (queue size - 1).
+   * Prior to that, the largest possible value of head is
+   * (queue size - 2).
+   */
+  if ((tail > head) && (head >= mask))
+    return 0;
+
+  for (j = tail; j != head; j++)
+    {
+      f = q->jobs[j & mask];
+
+      if (f && clib_atomic_bool_cmp_and_swap (
+		 &f->state, VNET_CRYPTO_FRAME_STATE_PENDING,
+		 VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS))
+	return f;
+    }
+
+  return 0;
+}
+
+/* Claim a frame from a peer's queue. Peers on our numa node go first, then
+ * the others, each by decreasing queue depth. */
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_steal_frame (vlib_main_t *vm,
+				 crypto_sw_scheduler_per_thread_data_t *ptd,
+				 crypto_sw_scheduler_queue_type_t qt)
 {
   crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
-  crypto_sw_scheduler_per_thread_data_t *ptd =
-    cm->per_thread_data + vm->thread_index;
-  vnet_crypto_async_frame_t *f = 0;
-  crypto_sw_scheduler_queue_t *current_queue = 0;
-  u32 tail, head;
-  u8 found = 0;
-  u8 recheck_queues = 1;
+  u32 numa_node = vm->numa_node, i, depth;
+  vnet_crypto_async_frame_t *f;
+  u64 *c;
 
-run_next_queues:
-  /* get a pending frame to process */
-  if (ptd->self_crypto_enabled)
+  vec_reset_length (ptd->steal_candidates);
+  vec_foreach_index (i, cm->per_thread_data)
     {
-      u32 i = ptd->last_serve_lcore_id + 1;
+      crypto_sw_scheduler_queue_t *q = &cm->per_thread_data[i].queue[qt];
 
-      while (1)
-	{
-	  crypto_sw_scheduler_per_thread_data_t *st;
-	  u32 j;
+      if (i == vm->thread_index)
+	continue;
 
-	  if (i >= vec_len (cm->per_thread_data))
-	    i = 0;
+      depth = q->head - q->tail;
+      if (depth == 0 || depth > cm->crypto_sw_scheduler_queue_mask + 1)
+	continue;
 
-	  st = cm->per_thread_data + i;
+      ptd->stats.max_steal_depth =
+	clib_max (ptd->stats.max_steal_depth, depth);
 
-	  if (ptd->last_serve_encrypt)
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
-	  else
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT];
+      /* sorts remote numa last, then deepest first */
+      vec_add1 (ptd->steal_candidates,
+		(u64) (vlib_get_main_by_index (i)->numa_node != numa_node)
+		    << 63 |
+		  (u64) (cm->crypto_sw_scheduler_queue_mask + 1 - depth)
+		    << 32 |
+		  i);
+    }
 
-	  tail = current_queue->tail;
-	  head = current_queue->head;
+  if (vec_len (ptd->steal_candidates) > 1)
+    vec_sort_with_function (ptd->steal_candidates, crypto_sw_scheduler_cmp);
 
-	  /* Skip this queue unless tail < head or head has overflowed
-	   * and tail has not. At the point where tail overflows (== 0),
-	   * the largest possible value of head is (queue size - 1).
-	   * Prior to that, the largest possible value of head is
-	   * (queue size - 2).
-	   */
-	  if ((tail > head) && (head >= cm->crypto_sw_scheduler_queue_mask))
-	    goto skip_queue;
+  vec_foreach (c, ptd->steal_candidates)
+    {
+      i = (u32) c[0];
+      f = crypto_sw_scheduler_claim_frame (&cm->per_thread_data[i].queue[qt],
+					   cm->crypto_sw_scheduler_queue_mask);
+      if (f)
+	{
+	  ptd->stats.n_stolen++;
+	  ptd->stats.n_stolen_remote_numa += c[0] >> 63;
+	  return f;
+	}
+    }
 
-	  for (j = tail; j != head; j++)
-	    {
+  return 0;
+}
 
-	      f = current_queue->jobs[j & cm->crypto_sw_scheduler_queue_mask];
+/* own queues first, then steal, alternating between encrypt and decrypt */
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_get_frame (vlib_main_t *vm,
+			       crypto_sw_scheduler_per_thread_data_t *ptd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_queue_type_t qt[2];
+  vnet_crypto_async_frame_t *f;
+  u32 i;
 
-	      if (!f)
-		continue;
+  qt[0] = ptd->last_serve_encrypt ? CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT :
+				    CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT;
+  qt[1] = !qt[0];
+  ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
 
-	      if (clib_atomic_bool_cmp_and_swap (
-		    &f->state, VNET_CRYPTO_FRAME_STATE_PENDING,
-		    VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS))
-		{
-		  found = 1;
-		  break;
-		}
-	    }
+  for (i = 0; i < 2; i++)
+    {
+      f = crypto_sw_scheduler_claim_frame (&ptd->queue[qt[i]],
+					   cm->crypto_sw_scheduler_queue_mask);
+      if (f)
+	return f;
+    }
 
-	skip_queue:
-	  if (found || i == ptd->last_serve_lcore_id)
-	    {
-	      CLIB_MEMORY_STORE_BARRIER ();
-	      ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
-	      break;
-	    }
+  for (i = 0; i < 2; i++)
+    {
+      f = crypto_sw_scheduler_steal_frame (vm, ptd, qt[i]);
+      if (f)
+	return f;
+    }
 
-	  i++;
-	}
+  return 0;
+}
+
+/* is there crypto budget left in this dispatch */
+static_always_inline int
+crypto_sw_scheduler_has_budget (vlib_main_t *vm,
+				crypto_sw_scheduler_per_thread_data_t *ptd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+
+  if (!cm->crypto_budget_clocks)
+    return 1;
 
-      ptd->last_serve_lcore_id = i;
+  if (ptd->budget_main_loop != vm->main_loop_count)
+    {
+      ptd->budget_main_loop = vm->main_loop_count;
+      ptd->budget_clocks_used = 0;
+    }
+
+  if (ptd->budget_clocks_used < cm->crypto_budget_clocks)
+    return 1;
+
+  /* count a dispatch once */
+  if (ptd->budget_clocks_used != ~0ULL)
+    {
+      ptd->budget_clocks_used = ~0ULL;
+      ptd->stats.n_budget_exhausted++;
     }
+  return 0;
+}
+
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
+			     clib_thread_index_t *enqueue_thread_idx)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd =
+    cm->per_thread_data + vm->thread_index;
+  vnet_crypto_async_frame_t *f = 0;
+  crypto_sw_scheduler_queue_t *current_queue = 0;
+  u32 tail;
+  u8 recheck_queues = 1;
 
-  if (found)
+run_next_queues:
+  /* get a pending frame to process */
+  if (ptd->self_crypto_enabled && crypto_sw_scheduler_has_budget (vm, ptd))
+    f = crypto_sw_scheduler_get_frame (vm, ptd);
+
+  if (f)
     {
       u32 crypto_op, auth_op_or_aad_len;
       u16 digest_len;
       u8 is_enc;
       int ret;
+      u64 t0 = clib_cpu_time_now (), dt;
 
       ret = convert_async_crypto_id (f->op, &crypto_op, &auth_op_or_aad_len,
 				     &digest_len, &is_enc);
@@ -538,10 +640,20 @@ run_next_queues:
 	crypto_sw_scheduler_process_link (
 	  vm, cm, ptd, f, crypto_op, auth_op_or_aad_len, digest_len, is_enc);
 
+      dt = clib_cpu_time_now () - t0;
+      ptd->stats.n_frames++;
+      ptd->stats.crypto_clocks += dt;
+      if (cm->crypto_budget_clocks)
+	ptd->budget_clocks_used += dt;
+
       *enqueue_thread_idx = f->enqueue_thread_index;
       *nb_elts_processed = f->n_elts;
+      ptd->stats.n_elts += f->n_elts;
     }
 
+  /* frames are retired in queue order, whoever processed them, so the
+   * frames of an SA, which all come from the thread that owns it, complete
+   * in order */
   if (ptd->last_return_queue)
     {
       current_queue = &ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
@@ -567,7 +679,7 @@ run_next_queues:
       return f;
     }
 
-  if (!found && recheck_queues)
+  if (!f && recheck_queues)
     {
       recheck_queues = 0;
       goto run_next_queues;
@@ -580,8 +692,9 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 				vlib_cli_command_t * cmd)
 {
   unformat_input_t _line_input, *line_input = &_line_input;
-  u32 worker_index;
-  u8 crypto_enable;
+  u32 worker_index = ~0;
+  u8 crypto_enable = 0;
+  u64 budget;
   int rv;
 
   /* Get a line of input. */
@@ -590,7 +703,9 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 
   while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
     {
-      if (unformat (line_input, "worker %u", &worker_index))
+      if (unformat (line_input, "crypto-budget %lu", &budget))
+	crypto_sw_scheduler_set_crypto_budget (budget);
+      else if (unformat (line_input, "worker %u", &worker_index))
 	{
 	  if (unformat (line_input, "crypto"))
 	    {
@@ -612,6 +727,9 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 				   format_unformat_error, line_input));
     }
 
+  if (worker_index == ~0)
+    return 0;
+
   rv = crypto_sw_scheduler_set_worker_crypto (worker_index, crypto_enable);
   if (rv == VNET_API_ERROR_INVALID_VALUE)
     {
@@ -625,16 +743,21 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 }
 
 /*?
- * This command sets if worker will do crypto processing.
+ * This command sets if worker will do crypto processing, and how many cpu
+ * clocks a worker may spend on crypto per dispatch (0 for no limit).
  *
  * @cliexpar
  * Example of how to set worker crypto processing off:
  * @cliexstart{set sw_scheduler worker 0 crypto off}
  * @cliexend
+ * Example of how to limit the crypto done per dispatch:
+ * @cliexstart{set sw_scheduler crypto-budget 200000}
+ * @cliexend
  ?*/
 VLIB_CLI_COMMAND (cmd_set_sw_scheduler_worker_crypto, static) = {
   .path = "set sw_scheduler",
-  .short_help = "set sw_scheduler worker <idx> crypto <on|off>",
+  .short_help = "set sw_scheduler [worker <idx> crypto <on|off>] "
+		"[crypto-budget <clocks>]",
   .function = sw_scheduler_set_worker_crypto,
   .is_mp_safe = 1,
 };
@@ -673,6 +796,79 @@ VLIB_CLI_COMMAND (cmd_show_sw_scheduler_workers, static) = {
   .is_mp_safe = 1,
 };
 
+static clib_error_t *
+sw_scheduler_show_stats (vlib_main_t *vm, unformat_input_t *input,
+			 vlib_cli_command_t *cmd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd;
+  crypto_sw_scheduler_stats_t *st;
+  u32 i;
+
+  if (cm->crypto_budget_clocks)
+    vlib_cli_output (vm, "crypto budget: %lu clocks per dispatch",
+		     cm->crypto_budget_clocks);
+  else
+    vlib_cli_output (vm, "crypto budget: unlimited");
+
+  vlib_cli_output (vm, "%-7s%-10s%-10s%-10s%-10s%-12s%-10s%-8s%-8s%-8s",
+		   "Thread", "Frames", "Elts", "Stolen", "Remote", "Clk/Elt",
+		   "OverBudg", "EncQ", "DecQ", "MaxStl");
+  for (i = 0; i < vlib_thread_main.n_vlib_mains; i++)
+    {
+      ptd = cm->per_thread_data + i;
+      st = &ptd->stats;
+      vlib_cli_output (
+	vm, "%-7d%-10lu%-10lu%-10lu%-10lu%-12.1f%-10lu%-8u%-8u%-8u", i,
+	st->n_frames, st->n_elts, st->n_stolen, st->n_stolen_remote_numa,
+	st->n_elts ? (f64) st->crypto_clocks / st->n_elts : 0,
+	st->n_budget_exhausted,
+	ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT].head -
+	  ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT].tail,
+	ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT].head -
+	  ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT].tail,
+	st->max_steal_depth);
+    }
+
+  return 0;
+}
+
+/*?
+ * This command displays per thread sw_scheduler statistics: frames and
+ * elements processed, frames stolen from other threads' queues (and from
+ * other numa nodes), crypto clocks per element, dispatches that ran out of
+ * crypto budget, current queue depths and the deepest queue stolen from.
+ *
+ * @cliexpar
+ * @cliexstart{show sw_scheduler stats}
+ * @cliexend
+ ?*/
+VLIB_CLI_COMMAND (cmd_show_sw_scheduler_stats, static) = {
+  .path = "show sw_scheduler stats",
+  .short_help = "show sw_scheduler stats",
+  .function = sw_scheduler_show_stats,
+  .is_mp_safe = 1,
+};
+
+static clib_error_t *
+sw_scheduler_clear_stats (vlib_main_t *vm, unformat_input_t *input,
+			  vlib_cli_command_t *cmd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd;
+
+  vec_foreach (ptd, cm->per_thread_data)
+    clib_memset (&ptd->stats, 0, sizeof (ptd->stats));
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (cmd_clear_sw_scheduler_stats, static) = {
+  .path = "clear sw_scheduler stats",
+  .short_help = "clear sw_scheduler stats",
+  .function = sw_scheduler_clear_stats,
+};
+
 clib_error_t *
 sw_scheduler_cli_init (vlib_main_t * vm)
 {
@@ -737,6 +933,7 @@ crypto_sw_scheduler_config (vlib_main_t *vm, unformat_input_t *input)
 {
   crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
   u32 crypto_sw_scheduler_queue_size = CRYPTO_SW_SCHEDULER_QUEUE_SIZE;
+  u64 budget;
   clib_error_t *error = 0;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
   crypto_sw_scheduler_per_thread_data_t *ptd;
@@ -754,6 +951,8 @@ crypto_sw_scheduler_config (vlib_main_t *vm, unformat_input_t *input)
 					crypto_sw_scheduler_queue_size);
 	    }
 	}
+      else if (unformat (input, "crypto-budget-clocks %lu", &budget))
+	crypto_sw_scheduler_set_crypto_budget (budget);
       else
 	{
 	  cm->crypto_sw_scheduler_queue_mask =
@@ -357,7 +357,8 @@ ena_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    {
 	      if (hb)
 		{
-		  hb->total_length_not_including_first_buffer = total_len;
+		  vlib_buffer_cold (hb)
+		    ->total_length_not_including_first_buffer = total_len;
 		  /* tail descriptor contains protocol info so we need to
 		   * combine head and tail buffer flags */
 		  hb->flags = head_flags | tail_flags;
@@ -370,7 +371,8 @@ ena_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  tail_flags = flags[i];
 	}
 
-      hb->total_length_not_including_first_buffer = total_len;
+      vlib_buffer_cold (hb)->total_length_not_including_first_buffer =
+	total_len;
       hb->flags = head_flags | tail_flags;
     }
   else
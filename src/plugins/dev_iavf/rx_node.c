@@ -4,6 +4,7 @@
 
 #include <vlib/vlib.h>
 #include <vnet/dev/dev.h>
+#include <vnet/dev/rxtx_funcs.h>
 #include <vnet/ethernet/ethernet.h>
 #include <dev_iavf/iavf.h>
 
@@ -44,9 +45,8 @@ iavf_rxq_refill (vlib_main_t *vm, vlib_node_runtime_t *node,
 {
   u16 n_refill, mask, n_alloc, slot, size;
   iavf_rxq_t *arq = vnet_dev_get_rx_queue_data (rxq);
-  vlib_buffer_t *b[8];
   iavf_rx_desc_t *d, *first_d;
-  void *p[8];
+  u64 addr[8];
 
   size = rxq->size;
   mask = size - 1;
@@ -80,31 +80,16 @@ iavf_rxq_refill (vlib_main_t *vm, vlib_node_runtime_t *node,
     {
       d = first_d + slot;
 
-      if (use_va_dma)
-	{
-	  vlib_get_buffers_with_offset (vm, arq->buffer_indices + slot, p, 8,
-					sizeof (vlib_buffer_t));
-	  iavf_rx_desc_write (d + 0, pointer_to_uword (p[0]));
-	  iavf_rx_desc_write (d + 1, pointer_to_uword (p[1]));
-	  iavf_rx_desc_write (d + 2, pointer_to_uword (p[2]));
-	  iavf_rx_desc_write (d + 3, pointer_to_uword (p[3]));
-	  iavf_rx_desc_write (d + 4, pointer_to_uword (p[4]));
-	  iavf_rx_desc_write (d + 5, pointer_to_uword (p[5]));
-	  iavf_rx_desc_write (d + 6, pointer_to_uword (p[6]));
-	  iavf_rx_desc_write (d + 7, pointer_to_uword (p[7]));
-	}
-      else
-	{
-	  vlib_get_buffers (vm, arq->buffer_indices + slot, b, 8);
-	  iavf_rx_desc_write (d + 0, vlib_buffer_get_pa (vm, b[0]));
-	  iavf_rx_desc_write (d + 1, vlib_buffer_get_pa (vm, b[1]));
-	  iavf_rx_desc_write (d + 2, vlib_buffer_get_pa (vm, b[2]));
-	  iavf_rx_desc_write (d + 3, vlib_buffer_get_pa (vm, b[3]));
-	  iavf_rx_desc_write (d + 4, vlib_buffer_get_pa (vm, b[4]));
-	  iavf_rx_desc_write (d + 5, vlib_buffer_get_pa (vm, b[5]));
-	  iavf_rx_desc_write (d + 6, vlib_buffer_get_pa (vm, b[6]));
-	  iavf_rx_desc_write (d + 7, vlib_buffer_get_pa (vm, b[7]));
-	}
+      vnet_dev_buffer_indices_to_dma_addr (vm, arq->buffer_indices + slot,
+					   addr, 8, 0, use_va_dma);
+      iavf_rx_desc_write (d + 0, addr[0]);
+      iavf_rx_desc_write (d + 1, addr[1]);
+      iavf_rx_desc_write (d + 2, addr[2]);
+      iavf_rx_desc_write (d + 3, addr[3]);
+      iavf_rx_desc_write (d + 4, addr[4]);
+      iavf_rx_desc_write (d + 5, addr[5]);
+      iavf_rx_desc_write (d + 6, addr[6]);
+      iavf_rx_desc_write (d + 7, addr[7]);
 
       /* next */
       slot = (slot + 8) & mask;
@@ -135,12 +120,12 @@ iavf_rx_attach_tail (vlib_main_t *vm, vlib_buffer_template_t *bt,
       b->next_buffer = t->buffers[i];
       b->flags |= VLIB_BUFFER_NEXT_PRESENT;
       b = vlib_get_buffer (vm, b->next_buffer);
-      b->template = *bt;
+      vnet_dev_buffer_template_store (b, bt);
       tlnifb += b->current_length = ((iavf_rx_desc_qw1_t) qw1).length;
       i++;
     }
 
-  hb->total_length_not_including_first_buffer = tlnifb;
+  vlib_buffer_cold (hb)->total_length_not_including_first_buffer = tlnifb;
   hb->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
   return tlnifb;
 }
@@ -192,10 +177,10 @@ iavf_process_rx_burst (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  vlib_prefetch_buffer_header (b[11], LOAD);
 	}
 
-      b[0]->template = *bt;
-      b[1]->template = *bt;
-      b[2]->template = *bt;
-      b[3]->template = *bt;
+      vnet_dev_buffer_template_store (b[0], bt);
+      vnet_dev_buffer_template_store (b[1], bt);
+      vnet_dev_buffer_template_store (b[2], bt);
+      vnet_dev_buffer_template_store (b[3], bt);
 
       n_rx_bytes += b[0]->current_length =
 	((iavf_rx_desc_qw1_t) qw1[0]).length;
@@ -223,7 +208,7 @@ iavf_process_rx_burst (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   while (n_left)
     {
-      b[0]->template = *bt;
+      vnet_dev_buffer_template_store (b[0], bt);
 
       n_rx_bytes += b[0]->current_length =
 	((iavf_rx_desc_qw1_t) qw1[0]).length;
@@ -513,10 +498,13 @@ VNET_DEV_NODE_FN (iavf_rx_node)
     {
       vnet_dev_port_t *port = rxq->port;
       iavf_port_t *ap = vnet_dev_get_port_data (port);
+      u32 n;
       if (PREDICT_FALSE (ap->flow_offload))
-	n_rx += iavf_device_input_inline (vm, node, frame, port, rxq, 1);
+	n = iavf_device_input_inline (vm, node, frame, port, rxq, 1);
       else
-	n_rx += iavf_device_input_inline (vm, node, frame, port, rxq, 0);
+	n = iavf_device_input_inline (vm, node, frame, port, rxq, 0);
+      n_rx += n;
+      vnet_dev_rx_queue_adaptive_update (vm, node, rxq, n);
 
       /* refill rx ring */
       if (rxq->port->dev->va_dma)
@@ -452,8 +452,8 @@ retry:
 	  n_free = (complete_slot + 1 - first) & mask;
 
 	  atq->n_enqueued -= n_free;
-	  vlib_buffer_free_from_ring_no_next (vm, atq->buffer_indices, first,
-					      txq->size, n_free);
+	  vlib_buffer_free_from_ring_no_next_deferred (
+	    vm, atq->buffer_indices, first, txq->size, n_free);
 	}
     }
 
@@ -92,7 +92,7 @@ oct_rx_attach_tail (vlib_main_t *vm, oct_rx_node_ctx_t *ctx, vlib_buffer_t *h,
 
 done:
   b->flags = 0;
-  h->total_length_not_including_first_buffer = tail_sz;
+  vlib_buffer_cold (h)->total_length_not_including_first_buffer = tail_sz;
   h->flags |= VLIB_BUFFER_NEXT_PRESENT | VLIB_BUFFER_TOTAL_LENGTH_VALID;
   ctx->n_rx_bytes += tail_sz;
   ctx->n_segs += n_tail_segs;
@@ -50,7 +50,8 @@ format_buffer_metadata (u8 *s, va_list *args)
 	      (u32) (b->error), (u32) (b->ref_count),
 	      (u32) (b->buffer_pool_index));
   s = format (s, "trace_handle: 0x%x, len_not_first_buf: %d\n",
-	      b->trace_handle, b->total_length_not_including_first_buffer);
+	      vlib_buffer_cold (b)->trace_handle,
+	      vlib_buffer_cold (b)->total_length_not_including_first_buffer);
   return s;
 }
 
@@ -71,6 +71,7 @@ dns_cache_clear (dns_main_t * dm)
   hash_free (dm->cache_entry_by_name);
   dm->cache_entry_by_name = hash_create_string (0, sizeof (uword));
   vec_free (dm->unresolved_entries);
+  dm->cache_epoch++;
   dns_cache_unlock (dm);
   return 0;
 }
@@ -109,10 +110,16 @@ dns_enable_disable (vlib_main_t * vm, dns_main_t * dm, int is_enable)
 
       if (dm->cache_entry_by_name == 0)
 	{
+	  int i;
+
 	  if (n_vlib_mains > 1)
 	    clib_spinlock_init (&dm->cache_lock);
 
 	  dm->cache_entry_by_name = hash_create_string (0, sizeof (uword));
+
+	  vec_validate (dm->thread_caches, n_vlib_mains - 1);
+	  for (i = 0; i < n_vlib_mains; i++)
+	    vec_validate (dm->thread_caches[i], DNS_THREAD_CACHE_SIZE - 1);
 	}
 
       dm->is_enabled = 1;
@@ -251,7 +258,7 @@ vnet_dns_send_dns4_request (vlib_main_t * vm, dns_main_t * dm,
   b = vlib_get_buffer (vm, bi);
   b->current_length = sizeof (ip4_header_t) + sizeof (udp_header_t) +
     vec_len (ep->dns_request);
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = 0;
   b->flags =
     VLIB_BUFFER_TOTAL_LENGTH_VALID | VNET_BUFFER_F_LOCALLY_ORIGINATED;
   vnet_buffer (b)->sw_if_index[VLIB_RX] = 0;	/* "local0" */
@@ -320,7 +327,7 @@ vnet_dns_send_dns6_request (vlib_main_t * vm, dns_main_t * dm,
   b = vlib_get_buffer (vm, bi);
   b->current_length = sizeof (ip6_header_t) + sizeof (udp_header_t) +
     vec_len (ep->dns_request);
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = 0;
   b->flags =
     VLIB_BUFFER_TOTAL_LENGTH_VALID | VNET_BUFFER_F_LOCALLY_ORIGINATED;
 
@@ -603,6 +610,7 @@ vnet_dns_delete_entry_by_index_nolock (dns_main_t * dm, u32 index)
     }
 
 found:
+  dm->cache_epoch++;
   hash_unset_mem (dm->cache_entry_by_name, ep->name);
   vec_free (ep->name);
   vec_free (ep->pending_requests);
@@ -1351,12 +1359,102 @@ vnet_dns_response_to_name (u8 * response,
   return 0;
 }
 
+static_always_inline dns_thread_cache_entry_t *
+dns_thread_cache_entry (dns_main_t *dm, u8 *name, uword len)
+{
+  clib_thread_index_t thread_index = vlib_get_thread_index ();
+  u32 slot;
+
+  if (thread_index >= vec_len (dm->thread_caches))
+    return 0;
+
+  slot = hash_memory (name, len, 0) & (DNS_THREAD_CACHE_SIZE - 1);
+  return &dm->thread_caches[thread_index][slot];
+}
+
+static void
+dns_thread_cache_add (dns_main_t *dm, u8 *name, dns_resolve_name_t *rn,
+		      dns_cache_entry_t *ep, u32 epoch)
+{
+  uword len = strlen ((char *) name);
+  dns_thread_cache_entry_t *e;
+
+  if (!(e = dns_thread_cache_entry (dm, name, len)))
+    return;
+
+  vec_reset_length (e->name);
+  vec_add (e->name, name, len);
+  e->address = rn->address;
+  e->expiration_time = (ep->flags & DNS_CACHE_ENTRY_FLAG_STATIC) ?
+			 CLIB_F64_MAX :
+			 ep->expiration_time;
+  e->epoch = epoch;
+}
+
+/**
+ * Look up a resolved name without triggering a resolution
+ *
+ * Safe to call from workers. Hits in the calling thread's cache take no
+ * lock, misses fall back to the shared cache under the cache lock.
+ */
+__clib_export int
+dns_cache_lookup_name (u8 *name, dns_resolve_name_t *rn)
+{
+  dns_main_t *dm = &dns_main;
+  f64 now = vlib_time_now (vlib_get_main ());
+  uword len = strlen ((char *) name);
+  dns_thread_cache_entry_t *e;
+  dns_cache_entry_t *ep;
+  u32 epoch, n_cnames = 0;
+  int rv = VNET_API_ERROR_NO_SUCH_ENTRY;
+  u8 *lookup_name = name;
+  uword *p;
+
+  if (dm->is_enabled == 0)
+    return VNET_API_ERROR_NAME_RESOLUTION_NOT_ENABLED;
+
+  epoch = dm->cache_epoch;
+  e = dns_thread_cache_entry (dm, name, len);
+  if (e && e->epoch == epoch && now < e->expiration_time &&
+      vec_len (e->name) == len && !memcmp (e->name, name, len))
+    {
+      rn->address = e->address;
+      return 0;
+    }
+
+  dns_cache_lock (dm, 8);
+  while ((p = hash_get_mem (dm->cache_entry_by_name, lookup_name)))
+    {
+      ep = pool_elt_at_index (dm->entries, p[0]);
+      if (!(ep->flags & DNS_CACHE_ENTRY_FLAG_VALID))
+	break;
+      if (!(ep->flags & DNS_CACHE_ENTRY_FLAG_STATIC) &&
+	  now > ep->expiration_time)
+	break;
+      if (ep->flags & DNS_CACHE_ENTRY_FLAG_CNAME)
+	{
+	  if (++n_cnames > 8)
+	    break;
+	  lookup_name = ep->cname;
+	  continue;
+	}
+      rv = vnet_dns_response_to_reply (ep->dns_response, rn, 0 /* ttl */);
+      if (!rv)
+	dns_thread_cache_add (dm, name, rn, ep, epoch);
+      break;
+    }
+  dns_cache_unlock (dm);
+
+  return rv;
+}
+
 __clib_export int
 dns_resolve_name (u8 *name, dns_cache_entry_t **ep, dns_pending_request_t *t0,
 		  dns_resolve_name_t *rn)
 {
   dns_main_t *dm = &dns_main;
   vlib_main_t *vm = vlib_get_main ();
+  u32 epoch = dm->cache_epoch;
 
   int rv = vnet_dns_resolve_name (vm, dm, name, t0, ep);
 
@@ -1368,7 +1466,11 @@ dns_resolve_name (u8 *name, dns_cache_entry_t **ep, dns_pending_request_t *t0,
   if (ep[0] == 0)
     return 0;
 
-  return vnet_dns_response_to_reply (ep[0]->dns_response, rn, 0 /* ttl-ptr */);
+  rv = vnet_dns_response_to_reply (ep[0]->dns_response, rn, 0 /* ttl-ptr */);
+  if (!rv)
+    dns_thread_cache_add (dm, name, rn, ep[0], epoch);
+
+  return rv;
 }
 
 static void
@@ -44,6 +44,17 @@ typedef struct
   ip_address_t address;
 } dns_resolve_name_t;
 
+/** Per-thread resolved name cache entry */
+typedef struct
+{
+  u8 *name;
+  ip_address_t address;
+  f64 expiration_time;
+  u32 epoch;
+} dns_thread_cache_entry_t;
+
+#define DNS_THREAD_CACHE_SIZE 64
+
 typedef enum
 {
   DNS_API_PENDING_NAME_TO_IP = 1,
@@ -106,6 +117,11 @@ typedef struct
   clib_spinlock_t cache_lock;
   int cache_lock_tag;
 
+  /** Per-thread direct mapped caches of resolved names, read without
+   *  taking the cache lock. Entries are valid for the current epoch */
+  dns_thread_cache_entry_t **thread_caches;
+  volatile u32 cache_epoch;
+
   /** enable / disable flag */
   int is_enabled;
 
@@ -231,6 +247,7 @@ dns_cache_unlock (dns_main_t * dm)
 extern int dns_resolve_name (u8 *name, dns_cache_entry_t **ep,
 			     dns_pending_request_t *t0,
 			     dns_resolve_name_t *rn);
+extern int dns_cache_lookup_name (u8 *name, dns_resolve_name_t *rn);
 #endif /* included_dns_h */
 
 /*
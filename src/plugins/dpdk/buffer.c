@@ -29,7 +29,6 @@
 STATIC_ASSERT (VLIB_BUFFER_PRE_DATA_SIZE == RTE_PKTMBUF_HEADROOM,
 	       "VLIB_BUFFER_PRE_DATA_SIZE must be equal to RTE_PKTMBUF_HEADROOM");
 
-extern struct rte_mbuf *dpdk_mbuf_template_by_pool_index;
 #ifndef CLIB_MARCH_VARIANT
 struct rte_mempool **dpdk_mempool_by_buffer_pool_index = 0;
 struct rte_mempool **dpdk_no_cache_mempool_by_buffer_pool_index = 0;
@@ -137,6 +136,7 @@ dpdk_buffer_pool_init (vlib_main_t * vm, vlib_buffer_pool_t * bp)
       b = vlib_buffer_ptr_from_index (buffer_mem_start, bp->buffers[i], 0);
       b->template = bp->buffer_template;
     }
+  bp->n_unformatted = 0;
 
   /* map DMA pages if at least one physical device exists */
   if (rte_eth_dev_count_avail () || rte_cryptodev_count ())
@@ -314,37 +314,6 @@ CLIB_MULTIARCH_FN (dpdk_ops_vpp_enqueue_no_cache) (struct rte_mempool * cmp,
 
 CLIB_MARCH_FN_REGISTRATION (dpdk_ops_vpp_enqueue_no_cache);
 
-static_always_inline void
-dpdk_mbuf_init_from_template (struct rte_mbuf **mba, struct rte_mbuf *mt,
-			      int count)
-{
-  /* Assumptions about rte_mbuf layout */
-  STATIC_ASSERT_OFFSET_OF (struct rte_mbuf, buf_addr, 0);
-  STATIC_ASSERT_OFFSET_OF (struct rte_mbuf, buf_iova, 8);
-  STATIC_ASSERT_SIZEOF_ELT (struct rte_mbuf, buf_iova, 8);
-  STATIC_ASSERT_SIZEOF_ELT (struct rte_mbuf, buf_iova, 8);
-  STATIC_ASSERT_SIZEOF (struct rte_mbuf, 128);
-
-  while (count--)
-    {
-      struct rte_mbuf *mb = mba[0];
-      int i;
-      /* bytes 0 .. 15 hold buf_addr and buf_iova which we need to preserve */
-      /* copy bytes 16 .. 31 */
-      *((u8x16 *) mb + 1) = *((u8x16 *) mt + 1);
-
-      /* copy bytes 32 .. 127 */
-#ifdef CLIB_HAVE_VEC256
-      for (i = 1; i < 4; i++)
-	*((u8x32 *) mb + i) = *((u8x32 *) mt + i);
-#else
-      for (i = 2; i < 8; i++)
-	*((u8x16 *) mb + i) = *((u8x16 *) mt + i);
-#endif
-      mba++;
-    }
-}
-
 int
 CLIB_MULTIARCH_FN (dpdk_ops_vpp_dequeue) (struct rte_mempool * mp,
 					  void **obj_table, unsigned n)
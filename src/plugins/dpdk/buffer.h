@@ -16,11 +16,58 @@
 #ifndef include_dpdk_buffer_h
 #define include_dpdk_buffer_h
 
+#include <rte_config.h>
+#include <rte_mbuf.h>
+
 #define rte_mbuf_from_vlib_buffer(x) (((struct rte_mbuf *)x) - 1)
 #define vlib_buffer_from_rte_mbuf(x) ((vlib_buffer_t *)(x+1))
 
 extern struct rte_mempool **dpdk_mempool_by_buffer_pool_index;
 extern struct rte_mempool **dpdk_no_cache_mempool_by_buffer_pool_index;
+extern struct rte_mbuf *dpdk_mbuf_template_by_pool_index;
+
+static_always_inline void
+dpdk_mbuf_init_from_template (struct rte_mbuf **mba, struct rte_mbuf *mt,
+			      int count)
+{
+  /* Assumptions about rte_mbuf layout */
+  STATIC_ASSERT_OFFSET_OF (struct rte_mbuf, buf_addr, 0);
+  STATIC_ASSERT_OFFSET_OF (struct rte_mbuf, buf_iova, 8);
+  STATIC_ASSERT_SIZEOF_ELT (struct rte_mbuf, buf_iova, 8);
+  STATIC_ASSERT_SIZEOF_ELT (struct rte_mbuf, buf_iova, 8);
+  STATIC_ASSERT_SIZEOF (struct rte_mbuf, 128);
+
+  while (count--)
+    {
+      struct rte_mbuf *mb = mba[0];
+      int i;
+      /* bytes 0 .. 15 hold buf_addr and buf_iova which we need to preserve */
+      /* copy bytes 16 .. 31 */
+      *((u8x16 *) mb + 1) = *((u8x16 *) mt + 1);
+
+      /* copy bytes 32 .. 127 */
+#ifdef CLIB_HAVE_VEC256
+      for (i = 1; i < 4; i++)
+	*((u8x32 *) mb + i) = *((u8x32 *) mt + i);
+#else
+      for (i = 2; i < 8; i++)
+	*((u8x16 *) mb + i) = *((u8x16 *) mt + i);
+#endif
+      mba++;
+    }
+}
+
+/* Reinitialize rte_mbuf header of the buffer which was not received by
+ * dpdk (VLIB_BUFFER_EXT_HDR_VALID not set). Same result as
+ * rte_pktmbuf_reset () but done with few wide stores from the per-pool
+ * template instead of field by field. */
+static_always_inline void
+dpdk_mbuf_reset (vlib_buffer_t *b)
+{
+  struct rte_mbuf *mb = rte_mbuf_from_vlib_buffer (b);
+  dpdk_mbuf_init_from_template (
+    &mb, dpdk_mbuf_template_by_pool_index + b->buffer_pool_index, 1);
+}
 
 clib_error_t *dpdk_buffer_pools_create (vlib_main_t * vm);
 
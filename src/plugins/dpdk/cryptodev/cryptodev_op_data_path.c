@@ -108,7 +108,7 @@ cryptodev_validate_mbuf_chain (vlib_main_t *vm, struct rte_mbuf *mb,
       b = vlib_get_buffer (vm, b->next_buffer);
       mb = rte_mbuf_from_vlib_buffer (b);
       if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_EXT_HDR_VALID) == 0))
-	rte_pktmbuf_reset (mb);
+	dpdk_mbuf_reset (b);
       last_mb->next = mb;
       last_mb = mb;
       mb->data_len = b->current_length;
@@ -120,7 +120,7 @@ dpdk_validate_rte_mbuf (vlib_main_t * vm, vlib_buffer_t * b,
   /* buffer is coming from non-dpdk source so we need to init
      rte_mbuf header */
   if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_EXT_HDR_VALID) == 0))
-    rte_pktmbuf_reset (mb);
+    dpdk_mbuf_reset (b);
 
   first_mb->nb_segs = 1;
   mb->data_len = b->current_length;
@@ -133,7 +133,7 @@ dpdk_validate_rte_mbuf (vlib_main_t * vm, vlib_buffer_t * b,
       b = vlib_get_buffer (vm, b->next_buffer);
       mb = rte_mbuf_from_vlib_buffer (b);
       if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_EXT_HDR_VALID) == 0))
-	rte_pktmbuf_reset (mb);
+	dpdk_mbuf_reset (b);
       last_mb->next = mb;
       last_mb = mb;
       mb->data_len = b->current_length;
@@ -710,6 +710,102 @@ done:
   return err;
 }
 
+static clib_error_t *
+dpdk_interface_get_rss_reta (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+			     u16 **reta)
+{
+  dpdk_main_t *xm = &dpdk_main;
+  dpdk_device_t *xd = vec_elt_at_index (xm->devices, hi->dev_instance);
+  struct rte_eth_rss_reta_entry64 *reta_conf = 0;
+  struct rte_eth_dev_info dev_info;
+  clib_error_t *err = 0;
+  u32 i, n_groups;
+  int rv;
+
+  rv = rte_eth_dev_info_get (xd->port_id, &dev_info);
+  if (rv)
+    return clib_error_return (0, "rte_eth_dev_info_get err %d", rv);
+
+  if (dev_info.reta_size == 0)
+    return clib_error_return (0, "rss redirection table not supported");
+
+  n_groups = round_pow2 (dev_info.reta_size, RTE_ETH_RETA_GROUP_SIZE) /
+	     RTE_ETH_RETA_GROUP_SIZE;
+  vec_validate (reta_conf, n_groups - 1);
+  for (i = 0; i < n_groups; i++)
+    reta_conf[i].mask = UINT64_MAX;
+
+  rv = rte_eth_dev_rss_reta_query (xd->port_id, reta_conf, dev_info.reta_size);
+  if (rv)
+    {
+      err = clib_error_return (0, "rte_eth_dev_rss_reta_query err %d", rv);
+      goto done;
+    }
+
+  vec_validate (*reta, dev_info.reta_size - 1);
+  for (i = 0; i < dev_info.reta_size; i++)
+    (*reta)[i] = reta_conf[i / RTE_ETH_RETA_GROUP_SIZE]
+		   .reta[i % RTE_ETH_RETA_GROUP_SIZE];
+
+done:
+  vec_free (reta_conf);
+  return err;
+}
+
+static clib_error_t *
+dpdk_interface_set_rss_reta (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+			     u16 *reta)
+{
+  dpdk_main_t *xm = &dpdk_main;
+  dpdk_device_t *xd = vec_elt_at_index (xm->devices, hi->dev_instance);
+  struct rte_eth_rss_reta_entry64 *reta_conf = 0;
+  struct rte_eth_dev_info dev_info;
+  clib_error_t *err = 0;
+  u32 i, n_groups;
+  int rv;
+
+  rv = rte_eth_dev_info_get (xd->port_id, &dev_info);
+  if (rv)
+    return clib_error_return (0, "rte_eth_dev_info_get err %d", rv);
+
+  if (vec_len (reta) != dev_info.reta_size)
+    return clib_error_return (0, "rss redirection table size must be %u",
+			      dev_info.reta_size);
+
+  n_groups = round_pow2 (dev_info.reta_size, RTE_ETH_RETA_GROUP_SIZE) /
+	     RTE_ETH_RETA_GROUP_SIZE;
+  vec_validate (reta_conf, n_groups - 1);
+
+  /* only entries which are changing are marked in the update mask, so
+   * buckets not being moved keep steering to their queue without a gap */
+  for (i = 0; i < dev_info.reta_size; i++)
+    {
+      u32 reta_id = i / RTE_ETH_RETA_GROUP_SIZE;
+      u32 reta_pos = i % RTE_ETH_RETA_GROUP_SIZE;
+
+      if (reta[i] == VNET_RSS_RETA_ENTRY_UNCHANGED)
+	continue;
+
+      if (reta[i] >= dev_info.nb_rx_queues)
+	{
+	  err = clib_error_return (0, "illegal queue number %u", reta[i]);
+	  goto done;
+	}
+
+      reta_conf[reta_id].mask |= 1ULL << reta_pos;
+      reta_conf[reta_id].reta[reta_pos] = reta[i];
+    }
+
+  rv =
+    rte_eth_dev_rss_reta_update (xd->port_id, reta_conf, dev_info.reta_size);
+  if (rv)
+    err = clib_error_return (0, "rte_eth_dev_rss_reta_update err %d", rv);
+
+done:
+  vec_free (reta_conf);
+  return err;
+}
+
 static clib_error_t *
 dpdk_interface_rx_mode_change (vnet_main_t *vnm, u32 hw_if_index, u32 qid,
 			       vnet_hw_if_rx_mode mode)
@@ -761,6 +857,8 @@ VNET_DEVICE_CLASS (dpdk_device_class) = {
   .format_flow = format_dpdk_flow,
   .flow_ops_function = dpdk_flow_ops_fn,
   .set_rss_queues_function = dpdk_interface_set_rss_queues,
+  .get_rss_reta_function = dpdk_interface_get_rss_reta,
+  .set_rss_reta_function = dpdk_interface_set_rss_reta,
   .rx_mode_change_function = dpdk_interface_rx_mode_change,
 };
 
@@ -163,6 +163,22 @@ typedef union
 
 STATIC_ASSERT_SIZEOF (dpdk_port_conf_t, 24);
 
+typedef struct
+{
+  /* per rx queue vector of packet counts for each rss reta bucket,
+   * updated by the rx node and never reset */
+  u32 **bucket_hits;
+  /* sum of bucket_hits at the time of the last rebalance run */
+  u32 *last_hits;
+  u16 reta_mask;
+  u16 max_moves;
+  u32 threshold_pct;
+  f64 interval;
+  f64 last_run;
+  u64 n_runs;
+  u64 n_moves;
+} dpdk_rss_balance_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -186,6 +202,9 @@ typedef struct
   dpdk_portid_t port_id;
   i8 cpu_socket;
 
+  /* rss bucket load tracking, set when rss-balance is enabled */
+  dpdk_rss_balance_t *rss_balance;
+
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
 
   u64 enabled_tx_off;
@@ -58,7 +58,7 @@ dpdk_process_subseq_segs (vlib_main_t * vm, vlib_buffer_t * b,
     return 0;
 
   b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = 0;
 
   while (nb_seg < mb->nb_segs)
     {
@@ -75,7 +75,8 @@ dpdk_process_subseq_segs (vlib_main_t * vm, vlib_buffer_t * b,
 	(mb_seg->buf_addr + mb_seg->data_off) - (void *) b_seg->data;
 
       b_seg->current_length = mb_seg->data_len;
-      b->total_length_not_including_first_buffer += mb_seg->data_len;
+      vlib_buffer_cold (b)->total_length_not_including_first_buffer +=
+	mb_seg->data_len;
 
       b_chain->flags |= VLIB_BUFFER_NEXT_PRESENT;
       b_chain->next_buffer = vlib_get_buffer_index (vm, b_seg);
@@ -84,7 +85,7 @@ dpdk_process_subseq_segs (vlib_main_t * vm, vlib_buffer_t * b,
       mb_seg = mb_seg->next;
       nb_seg++;
     }
-  return b->total_length_not_including_first_buffer;
+  return vlib_buffer_cold (b)->total_length_not_including_first_buffer;
 }
 
 static_always_inline void
@@ -339,6 +340,22 @@ dpdk_process_lro_offload (dpdk_device_t *xd, dpdk_per_thread_data_t *ptd,
     }
 }
 
+static_always_inline void
+dpdk_process_rss_balance (dpdk_rss_balance_t *rb, dpdk_per_thread_data_t *ptd,
+			  u16 queue_id, uword n_rx_packets)
+{
+  u32 *hits;
+  uword n;
+
+  if (queue_id >= vec_len (rb->bucket_hits))
+    return;
+
+  hits = rb->bucket_hits[queue_id];
+  for (n = 0; n < n_rx_packets; n++)
+    if (ptd->flags[n] & RTE_MBUF_F_RX_RSS_HASH)
+      hits[ptd->mbufs[n]->hash.rss & rb->reta_mask]++;
+}
+
 static_always_inline u32
 dpdk_device_input (vlib_main_t *vm, dpdk_main_t *dm, dpdk_device_t *xd,
 		   vlib_node_runtime_t *node, clib_thread_index_t thread_index,
@@ -407,6 +424,10 @@ dpdk_device_input (vlib_main_t *vm, dpdk_main_t *dm, dpdk_device_t *xd,
   if (PREDICT_FALSE ((or_flags & RTE_MBUF_F_RX_LRO)))
     dpdk_process_lro_offload (xd, ptd, n_rx_packets);
 
+  if (PREDICT_FALSE (xd->rss_balance != 0) &&
+      (or_flags & RTE_MBUF_F_RX_RSS_HASH))
+    dpdk_process_rss_balance (xd->rss_balance, ptd, queue_id, n_rx_packets);
+
   if (PREDICT_FALSE ((or_flags & RTE_MBUF_F_RX_L4_CKSUM_BAD) &&
 		     (xd->buffer_flags & VNET_BUFFER_F_L4_CHECKSUM_CORRECT)))
     {
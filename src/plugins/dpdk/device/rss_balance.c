@@ -0,0 +1,410 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+/*
+ * RSS bucket rebalancing.
+ *
+ * When enabled on an interface, rx node counts packets per rss redirection
+ * table bucket (low bits of rss hash). Periodically this process sums the
+ * per-bucket load of each worker and, if the busiest worker is more than
+ * 'threshold' percent above the mean, moves the heaviest buckets which still
+ * narrow the gap from the busiest to the least loaded worker by rewriting
+ * only those redirection table entries. Number of moves per run is limited
+ * so flows are not bounced between workers on short bursts.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/interface/rx_queue_funcs.h>
+#include <dpdk/buffer.h>
+#include <dpdk/device/dpdk.h>
+#include <dpdk/device/dpdk_priv.h>
+
+#define DPDK_RSS_BALANCE_DEFAULT_INTERVAL  5.0
+#define DPDK_RSS_BALANCE_DEFAULT_THRESHOLD 20
+#define DPDK_RSS_BALANCE_DEFAULT_MAX_MOVES 8
+#define DPDK_RSS_BALANCE_MIN_INTERVAL	   0.1
+
+static u32 dpdk_rss_balance_n_enabled;
+
+static void
+dpdk_rss_balance_find_min_max (u64 *thread_load, u16 *thread_queue,
+			       u32 *min_ti, u32 *max_ti)
+{
+  u32 ti;
+
+  *min_ti = *max_ti = ~0;
+  vec_foreach_index (ti, thread_load)
+    {
+      if (thread_queue[ti] == (u16) ~0)
+	continue;
+      if (*max_ti == ~0 || thread_load[ti] > thread_load[*max_ti])
+	*max_ti = ti;
+      if (*min_ti == ~0 || thread_load[ti] < thread_load[*min_ti])
+	*min_ti = ti;
+    }
+}
+
+static void
+dpdk_rss_balance_one (vlib_main_t *vm, dpdk_device_t *xd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hi = vnet_get_hw_interface (vnm, xd->hw_if_index);
+  dpdk_rss_balance_t *rb = xd->rss_balance;
+  u32 n_buckets = rb->reta_mask + 1;
+  u32 n_queues =
+    clib_min (vec_len (rb->bucket_hits), vec_len (xd->rx_queues));
+  u16 *reta = 0, *update = 0, *thread_queue = 0;
+  u64 *bucket_load = 0, *thread_load = 0;
+  u32 *queue_thread = 0;
+  u32 b, q, min_ti, max_ti, n_active = 0, n_moves = 0;
+  u64 total = 0, limit;
+  clib_error_t *err;
+
+  rb->n_runs++;
+
+  /* packets per bucket since last run */
+  vec_validate (bucket_load, n_buckets - 1);
+  for (b = 0; b < n_buckets; b++)
+    {
+      u32 sum = 0;
+      for (q = 0; q < vec_len (rb->bucket_hits); q++)
+	sum += rb->bucket_hits[q][b];
+      bucket_load[b] = (u32) (sum - rb->last_hits[b]);
+      rb->last_hits[b] = sum;
+    }
+
+  if ((err = vnet_hw_interface_get_rss_reta (vnm, hi, &reta)))
+    {
+      clib_error_free (err);
+      goto done;
+    }
+
+  if (vec_len (reta) != n_buckets)
+    goto done;
+
+  /* map queues to the workers polling them, remembering one queue per
+   * worker as destination for buckets moved to that worker */
+  vec_validate (thread_load, vlib_get_n_threads () - 1);
+  vec_validate_init_empty (thread_queue, vlib_get_n_threads () - 1,
+			   (u16) ~0);
+  vec_validate (queue_thread, n_queues - 1);
+  for (q = 0; q < n_queues; q++)
+    {
+      u32 qi = vec_elt (xd->rx_queues, q).queue_index;
+      u32 ti = vnet_hw_if_get_rx_queue (vnm, qi)->thread_index;
+      queue_thread[q] = ti;
+      if (thread_queue[ti] == (u16) ~0)
+	{
+	  thread_queue[ti] = q;
+	  n_active++;
+	}
+    }
+
+  if (n_active < 2)
+    goto done;
+
+  for (b = 0; b < n_buckets; b++)
+    if (reta[b] < n_queues)
+      {
+	thread_load[queue_thread[reta[b]]] += bucket_load[b];
+	total += bucket_load[b];
+      }
+
+  if (total == 0)
+    goto done;
+
+  limit = total * (100 + rb->threshold_pct) / (100 * n_active);
+  dpdk_rss_balance_find_min_max (thread_load, thread_queue, &min_ti, &max_ti);
+
+  if (thread_load[max_ti] <= limit)
+    goto done;
+
+  vec_validate_init_empty (update, n_buckets - 1,
+			   VNET_RSS_RETA_ENTRY_UNCHANGED);
+
+  while (n_moves < rb->max_moves && thread_load[max_ti] > limit)
+    {
+      u64 gap = thread_load[max_ti] - thread_load[min_ti];
+      u32 best = ~0;
+
+      /* heaviest bucket of the busiest worker whose move still narrows the
+       * gap, single elephant flow bigger than the gap stays where it is */
+      for (b = 0; b < n_buckets; b++)
+	{
+	  if (update[b] != VNET_RSS_RETA_ENTRY_UNCHANGED)
+	    continue;
+	  if (reta[b] >= n_queues || queue_thread[reta[b]] != max_ti)
+	    continue;
+	  if (bucket_load[b] == 0 || bucket_load[b] >= gap)
+	    continue;
+	  if (best == ~0 || bucket_load[b] > bucket_load[best])
+	    best = b;
+	}
+
+      if (best == ~0)
+	break;
+
+      update[best] = thread_queue[min_ti];
+      thread_load[max_ti] -= bucket_load[best];
+      thread_load[min_ti] += bucket_load[best];
+      n_moves++;
+      dpdk_rss_balance_find_min_max (thread_load, thread_queue, &min_ti,
+				     &max_ti);
+    }
+
+  if (n_moves == 0)
+    goto done;
+
+  if ((err = vnet_hw_interface_set_rss_reta (vnm, hi, update)))
+    {
+      dpdk_log_err ("[%u] rss balance: %U", xd->port_id, format_clib_error,
+		    err);
+      clib_error_free (err);
+      goto done;
+    }
+
+  rb->n_moves += n_moves;
+  dpdk_log_debug ("[%u] rss balance: moved %u buckets", xd->port_id, n_moves);
+
+done:
+  vec_free (reta);
+  vec_free (update);
+  vec_free (thread_queue);
+  vec_free (bucket_load);
+  vec_free (thread_load);
+  vec_free (queue_thread);
+}
+
+static uword
+dpdk_rss_balance_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			  vlib_frame_t *f)
+{
+  dpdk_main_t *dm = &dpdk_main;
+  dpdk_device_t *xd;
+  f64 now, timeout = DPDK_RSS_BALANCE_DEFAULT_INTERVAL;
+
+  while (1)
+    {
+      if (dpdk_rss_balance_n_enabled == 0)
+	vlib_process_wait_for_event (vm);
+      else
+	vlib_process_wait_for_event_or_clock (vm, timeout);
+
+      vlib_process_get_events (vm, 0);
+
+      now = vlib_time_now (vm);
+      timeout = DPDK_RSS_BALANCE_DEFAULT_INTERVAL;
+
+      vec_foreach (xd, dm->devices)
+	{
+	  dpdk_rss_balance_t *rb = xd->rss_balance;
+
+	  if (rb == 0)
+	    continue;
+
+	  if (now - rb->last_run >= rb->interval)
+	    {
+	      if (xd->flags & DPDK_DEVICE_FLAG_ADMIN_UP)
+		dpdk_rss_balance_one (vm, xd);
+	      rb->last_run = now;
+	    }
+
+	  timeout = clib_min (timeout, rb->last_run + rb->interval - now);
+	}
+
+      timeout = clib_max (timeout, DPDK_RSS_BALANCE_MIN_INTERVAL);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (dpdk_rss_balance_process_node) = {
+  .function = dpdk_rss_balance_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "dpdk-rss-balance-process",
+};
+
+static void
+dpdk_rss_balance_free (dpdk_rss_balance_t *rb)
+{
+  u32 **hits;
+
+  vec_foreach (hits, rb->bucket_hits)
+    vec_free (hits[0]);
+  vec_free (rb->bucket_hits);
+  vec_free (rb->last_hits);
+  clib_mem_free (rb);
+}
+
+static clib_error_t *
+set_dpdk_rss_balance (vlib_main_t *vm, unformat_input_t *input,
+		      vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_main_t *vnm = vnet_get_main ();
+  dpdk_main_t *dm = &dpdk_main;
+  u32 hw_if_index = ~0, threshold = DPDK_RSS_BALANCE_DEFAULT_THRESHOLD;
+  u32 max_moves = DPDK_RSS_BALANCE_DEFAULT_MAX_MOVES;
+  f64 interval = DPDK_RSS_BALANCE_DEFAULT_INTERVAL;
+  dpdk_rss_balance_t *rb, *old;
+  vnet_hw_interface_t *hi;
+  clib_error_t *err = 0;
+  dpdk_device_t *xd;
+  u16 *reta = 0;
+  int disable = 0;
+  u32 q;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%U", unformat_vnet_hw_interface, vnm,
+		    &hw_if_index))
+	;
+      else if (unformat (line_input, "disable"))
+	disable = 1;
+      else if (unformat (line_input, "interval %f", &interval))
+	;
+      else if (unformat (line_input, "threshold %u", &threshold))
+	;
+      else if (unformat (line_input, "max-moves %u", &max_moves))
+	;
+      else
+	{
+	  err = clib_error_return (0, "unknown input `%U'",
+				   format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (hw_if_index == ~0)
+    {
+      err = clib_error_return (0, "please specify interface name");
+      goto done;
+    }
+
+  hi = vnet_get_hw_interface (vnm, hw_if_index);
+  if (hi->dev_class_index != dpdk_device_class.index)
+    {
+      err = clib_error_return (0, "not a dpdk interface");
+      goto done;
+    }
+
+  if (interval < DPDK_RSS_BALANCE_MIN_INTERVAL || max_moves == 0 ||
+      max_moves > 0xffff)
+    {
+      err = clib_error_return (0, "invalid interval or max-moves");
+      goto done;
+    }
+
+  xd = vec_elt_at_index (dm->devices, hi->dev_instance);
+  old = xd->rss_balance;
+
+  if (disable)
+    {
+      if (old == 0)
+	goto done;
+      vlib_worker_thread_barrier_sync (vm);
+      xd->rss_balance = 0;
+      vlib_worker_thread_barrier_release (vm);
+      dpdk_rss_balance_free (old);
+      dpdk_rss_balance_n_enabled--;
+      goto done;
+    }
+
+  if (old)
+    {
+      old->interval = interval;
+      old->threshold_pct = threshold;
+      old->max_moves = max_moves;
+      goto done;
+    }
+
+  if ((err = vnet_hw_interface_get_rss_reta (vnm, hi, &reta)))
+    goto done;
+
+  if (!is_pow2 (vec_len (reta)))
+    {
+      err = clib_error_return (
+	0, "rss redirection table size %u is not power of 2", vec_len (reta));
+      goto done;
+    }
+
+  rb = clib_mem_alloc (sizeof (*rb));
+  clib_memset (rb, 0, sizeof (*rb));
+  rb->reta_mask = vec_len (reta) - 1;
+  rb->interval = interval;
+  rb->threshold_pct = threshold;
+  rb->max_moves = max_moves;
+  rb->last_run = vlib_time_now (vm);
+  vec_validate (rb->last_hits, rb->reta_mask);
+  vec_validate (rb->bucket_hits, vec_len (xd->rx_queues) - 1);
+  for (q = 0; q < vec_len (xd->rx_queues); q++)
+    vec_validate_aligned (rb->bucket_hits[q], rb->reta_mask,
+			  CLIB_CACHE_LINE_BYTES);
+
+  vlib_worker_thread_barrier_sync (vm);
+  xd->rss_balance = rb;
+  vlib_worker_thread_barrier_release (vm);
+
+  dpdk_rss_balance_n_enabled++;
+  vlib_process_signal_event (vm, dpdk_rss_balance_process_node.index, 0, 0);
+
+done:
+  vec_free (reta);
+  unformat_free (line_input);
+  return err;
+}
+
+/*?
+ * Enable periodic rebalancing of rss redirection table buckets between
+ * workers polling rx queues of the interface. Interval is in seconds,
+ * threshold is percentage of busiest worker load above mean load which
+ * triggers rebalance and max-moves limits number of buckets moved in single
+ * run.
+ *
+ * @cliexpar
+ * @cliexcmd{set dpdk interface rss-balance TenGigabitEthernet2/0/0 interval 2
+ * threshold 25}
+?*/
+VLIB_CLI_COMMAND (cmd_set_dpdk_rss_balance, static) = {
+  .path = "set dpdk interface rss-balance",
+  .short_help = "set dpdk interface rss-balance <interface> [disable] "
+		"[interval <sec>] [threshold <pct>] [max-moves <n>]",
+  .function = set_dpdk_rss_balance,
+};
+
+static clib_error_t *
+show_dpdk_rss_balance (vlib_main_t *vm, unformat_input_t *input,
+		       vlib_cli_command_t *cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  dpdk_main_t *dm = &dpdk_main;
+  dpdk_device_t *xd;
+
+  vec_foreach (xd, dm->devices)
+    {
+      dpdk_rss_balance_t *rb = xd->rss_balance;
+
+      if (rb == 0)
+	continue;
+
+      vlib_cli_output (vm,
+		       "%U: buckets %u interval %.2fs threshold %u%% "
+		       "max-moves %u runs %lu moved %lu",
+		       format_vnet_hw_if_index_name, vnm, xd->hw_if_index,
+		       rb->reta_mask + 1, rb->interval, rb->threshold_pct,
+		       rb->max_moves, rb->n_runs, rb->n_moves);
+    }
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (cmd_show_dpdk_rss_balance, static) = {
+  .path = "show dpdk interface rss-balance",
+  .short_help = "show dpdk interface rss-balance",
+  .function = show_dpdk_rss_balance,
+};
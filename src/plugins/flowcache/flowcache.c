@@ -0,0 +1,208 @@
+/*
+ * flowcache.c - IPv4 flow cache
+ *
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/plugin/plugin.h>
+#include <vpp/app/version.h>
+#include <vnet/fib/fib_entry.h>
+#include <flowcache/flowcache.h>
+
+flowcache_main_t flowcache_main;
+
+static void
+flowcache_tables_init (flowcache_main_t *fcm)
+{
+  clib_bihash_16_8_t *h;
+
+  if (!fcm->table_buckets)
+    fcm->table_buckets = FLOWCACHE_DEFAULT_BUCKETS;
+  if (!fcm->table_memory)
+    fcm->table_memory = FLOWCACHE_DEFAULT_MEMORY;
+
+  vec_validate (fcm->tables, vlib_get_n_threads () - 1);
+  vec_foreach (h, fcm->tables)
+    clib_bihash_init_16_8 (h, "flowcache", fcm->table_buckets,
+			   fcm->table_memory);
+}
+
+static void
+flowcache_tables_free (flowcache_main_t *fcm)
+{
+  clib_bihash_16_8_t *h;
+
+  vec_foreach (h, fcm->tables)
+    clib_bihash_free_16_8 (h);
+  vec_free (fcm->tables);
+}
+
+int
+flowcache_enable_disable (u32 sw_if_index, int enable)
+{
+  flowcache_main_t *fcm = &flowcache_main;
+  vnet_main_t *vnm = vnet_get_main ();
+
+  if (pool_is_free_index (vnm->interface_main.sw_interfaces, sw_if_index))
+    return VNET_API_ERROR_INVALID_SW_IF_INDEX;
+
+  vec_validate (fcm->enabled_by_sw_if_index, sw_if_index);
+  if (fcm->enabled_by_sw_if_index[sw_if_index] == enable)
+    return 0;
+
+  if (enable && fcm->n_enabled++ == 0 && !fcm->tables)
+    flowcache_tables_init (fcm);
+  else if (!enable)
+    fcm->n_enabled--;
+
+  fcm->enabled_by_sw_if_index[sw_if_index] = enable;
+  vnet_feature_enable_disable ("ip4-unicast", "ip4-flowcache", sw_if_index,
+			       enable, 0, 0);
+  return 0;
+}
+
+void
+flowcache_clear (void)
+{
+  flowcache_main_t *fcm = &flowcache_main;
+
+  if (!fcm->tables)
+    return;
+
+  flowcache_tables_free (fcm);
+  flowcache_tables_init (fcm);
+}
+
+static clib_error_t *
+flowcache_enable_disable_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				     vlib_cli_command_t *cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 sw_if_index = ~0;
+  int enable = 1;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "disable"))
+	enable = 0;
+      else if (unformat (input, "%U", unformat_vnet_sw_interface, vnm,
+			 &sw_if_index))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (sw_if_index == ~0)
+    return clib_error_return (0, "Please specify an interface...");
+
+  rv = flowcache_enable_disable (sw_if_index, enable);
+  if (rv)
+    return clib_error_return (0, "flowcache_enable_disable returned %d", rv);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (flowcache_enable_disable_command, static) = {
+  .path = "set interface flowcache",
+  .short_help = "set interface flowcache <interface-name> [disable]",
+  .function = flowcache_enable_disable_command_fn,
+};
+
+static clib_error_t *
+flowcache_clear_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  flowcache_clear ();
+  return 0;
+}
+
+VLIB_CLI_COMMAND (flowcache_clear_command, static) = {
+  .path = "clear flowcache",
+  .short_help = "clear flowcache",
+  .function = flowcache_clear_command_fn,
+};
+
+static clib_error_t *
+flowcache_show_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			   vlib_cli_command_t *cmd)
+{
+  flowcache_main_t *fcm = &flowcache_main;
+  int verbose = 0;
+  u32 i;
+
+  if (unformat (input, "verbose"))
+    verbose = 1;
+
+  vlib_cli_output (vm, "fib forwarding generation %u",
+		   fib_entry_fwd_generation);
+
+  vec_foreach_index (i, fcm->tables)
+    {
+      vlib_cli_output (vm, "thread %u:", i);
+      vlib_cli_output (vm, "%U", format_bihash_16_8, &fcm->tables[i],
+		       verbose);
+    }
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (flowcache_show_command, static) = {
+  .path = "show flowcache",
+  .short_help = "show flowcache [verbose]",
+  .function = flowcache_show_command_fn,
+};
+
+static clib_error_t *
+flowcache_config (vlib_main_t *vm, unformat_input_t *input)
+{
+  flowcache_main_t *fcm = &flowcache_main;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "buckets %u", &fcm->table_buckets))
+	;
+      else if (unformat (input, "memory %U", unformat_memory_size,
+			 &fcm->table_memory))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  return 0;
+}
+
+VLIB_CONFIG_FUNCTION (flowcache_config, "flowcache");
+
+VNET_FEATURE_INIT (flowcache_ip4, static) = {
+  .arc_name = "ip4-unicast",
+  .node_name = "ip4-flowcache",
+  .runs_before = VNET_FEATURES ("ip4-lookup"),
+};
+
+VLIB_PLUGIN_REGISTER () = {
+  .version = VPP_BUILD_VER,
+  .description = "IPv4 flow cache",
+};
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,74 @@
+/*
+ * flowcache.h - IPv4 flow cache
+ *
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __included_flowcache_h__
+#define __included_flowcache_h__
+
+#include <vnet/vnet.h>
+#include <vnet/ip/ip.h>
+#include <vppinfra/bihash_16_8.h>
+
+/*
+ * The cache key is the 5-tuple plus the lookup FIB index, the value the
+ * adjacency chosen by the lookup and the FIB forwarding generation at
+ * the time it was learnt.
+ */
+#define FLOWCACHE_MK_KEY(_kv, _ip, _ports, _fib_index)                      \
+  do                                                                          \
+    {                                                                         \
+      (_kv)->key[0] = ((u64) (_ip)->src_address.as_u32 << 32) |              \
+		      (_ip)->dst_address.as_u32;                              \
+      (_kv)->key[1] = ((u64) (_fib_index) << 40) |                            \
+		      ((u64) (_ip)->protocol << 32) | (_ports);               \
+    }                                                                         \
+  while (0)
+
+#define FLOWCACHE_MK_VALUE(_adj_index, _gen)                                  \
+  (((u64) (_gen) << 32) | (_adj_index))
+
+#define FLOWCACHE_DEFAULT_BUCKETS (64 << 10)
+#define FLOWCACHE_DEFAULT_MEMORY  (64 << 20)
+
+typedef struct
+{
+  /* per-thread flow tables, written only by their own thread */
+  clib_bihash_16_8_t *tables;
+
+  /* interfaces the feature is enabled on */
+  u32 n_enabled;
+  u8 *enabled_by_sw_if_index;
+
+  /* table sizing */
+  u32 table_buckets;
+  uword table_memory;
+} flowcache_main_t;
+
+extern flowcache_main_t flowcache_main;
+
+extern vlib_node_registration_t flowcache_ip4_node;
+
+int flowcache_enable_disable (u32 sw_if_index, int enable);
+void flowcache_clear (void);
+
+#endif /* __included_flowcache_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,217 @@
+/*
+ * flowcache_node.c - IPv4 flow cache node
+ *
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/feature/feature.h>
+#include <vnet/ip/ip4.h>
+#include <vnet/ip/ip4_inlines.h>
+#include <vnet/fib/ip4_fib.h>
+#include <vnet/fib/fib_entry.h>
+#include <vnet/dpo/load_balance_map.h>
+#include <flowcache/flowcache.h>
+
+typedef struct flowcache_trace_t_
+{
+  u32 adj_index;
+  u8 hit;
+} flowcache_trace_t;
+
+static u8 *
+format_flowcache_trace (u8 *s, va_list *args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  flowcache_trace_t *t = va_arg (*args, flowcache_trace_t *);
+
+  if (t->adj_index == ~0)
+    s = format (s, "flowcache: not cacheable");
+  else
+    s = format (s, "flowcache: %s adj-index %d", t->hit ? "hit" : "learn",
+		t->adj_index);
+  return s;
+}
+
+#define foreach_flowcache_error                                               \
+  _ (HIT, "flow cache hits")                                                  \
+  _ (LEARN, "flow cache entries learnt")                                      \
+  _ (BYPASS, "packets not cacheable")
+
+typedef enum
+{
+#define _(sym, str) FLOWCACHE_ERROR_##sym,
+  foreach_flowcache_error
+#undef _
+    FLOWCACHE_N_ERROR,
+} flowcache_error_t;
+
+static char *flowcache_error_strings[] = {
+#define _(sym, string) string,
+  foreach_flowcache_error
+#undef _
+};
+
+typedef enum
+{
+  FLOWCACHE_NEXT_REWRITE,
+  FLOWCACHE_N_NEXT,
+} flowcache_next_t;
+
+/*
+ * Resolve the adjacency for a packet the way ip4-lookup does. Returns ~0
+ * if the result is anything other than a complete rewrite adjacency,
+ * which is all the cache can replay.
+ */
+static_always_inline u32
+flowcache_resolve (vlib_buffer_t *b, ip4_header_t *ip)
+{
+  const load_balance_t *lb;
+  const dpo_id_t *dpo;
+  u32 lbi;
+
+  lbi = ip4_fib_forwarding_lookup (vnet_buffer (b)->ip.fib_index,
+				   &ip->dst_address);
+  lb = load_balance_get (lbi);
+
+  vnet_buffer (b)->ip.flow_hash = 0;
+  if (PREDICT_FALSE (lb->lb_n_buckets > 1))
+    {
+      vnet_buffer (b)->ip.flow_hash =
+	ip4_compute_flow_hash (ip, lb->lb_hash_config);
+      dpo = load_balance_get_fwd_bucket (
+	lb, vnet_buffer (b)->ip.flow_hash & lb->lb_n_buckets_minus_1);
+    }
+  else
+    dpo = load_balance_get_bucket_i (lb, 0);
+
+  if (dpo->dpoi_type != DPO_ADJACENCY)
+    return ~0;
+
+  return dpo->dpoi_index;
+}
+
+VLIB_NODE_FN (flowcache_ip4_node)
+(vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  flowcache_main_t *fcm = &flowcache_main;
+  ip4_main_t *im = &ip4_main;
+  clib_bihash_16_8_t *h = vec_elt_at_index (fcm->tables, vm->thread_index);
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u16 nexts[VLIB_FRAME_SIZE], *next;
+  u32 n_left, *from, gen;
+  u32 n_hit = 0, n_learn = 0, n_bypass = 0;
+
+  from = vlib_frame_vector_args (frame);
+  n_left = frame->n_vectors;
+  vlib_get_buffers (vm, from, bufs, n_left);
+  b = bufs;
+  next = nexts;
+  gen = fib_entry_fwd_generation;
+
+  while (n_left > 0)
+    {
+      clib_bihash_kv_16_8_t kv;
+      ip4_header_t *ip0;
+      u32 adj0 = ~0;
+      u8 hit0 = 0;
+
+      if (n_left > 2)
+	vlib_prefetch_buffer_data (b[2], LOAD);
+
+      ip0 = vlib_buffer_get_current (b[0]);
+
+      /* only unfragmented TCP and UDP carry a 5-tuple */
+      if ((ip0->protocol == IP_PROTOCOL_TCP ||
+	   ip0->protocol == IP_PROTOCOL_UDP) &&
+	  !ip4_get_fragment_more (ip0) && !ip4_get_fragment_offset (ip0))
+	{
+	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, b[0]);
+	  FLOWCACHE_MK_KEY (&kv, ip0, *(u32 *) ip4_next_header (ip0),
+			    vnet_buffer (b[0])->ip.fib_index);
+
+	  if (!clib_bihash_search_inline_16_8 (h, &kv) &&
+	      (kv.value >> 32) == gen)
+	    {
+	      adj0 = (u32) kv.value;
+	      hit0 = 1;
+	      n_hit++;
+	    }
+	  else if ((adj0 = flowcache_resolve (b[0], ip0)) != ~0)
+	    {
+	      kv.value = FLOWCACHE_MK_VALUE (adj0, gen);
+	      clib_bihash_add_del_16_8 (h, &kv, 1 /* is_add */);
+	      n_learn++;
+	    }
+	}
+
+      if (adj0 != ~0)
+	{
+	  vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = adj0;
+	  next[0] = FLOWCACHE_NEXT_REWRITE;
+	}
+      else
+	{
+	  u32 next32;
+	  vnet_feature_next (&next32, b[0]);
+	  next[0] = next32;
+	  n_bypass++;
+	}
+
+      if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
+			 (b[0]->flags & VLIB_BUFFER_IS_TRACED)))
+	{
+	  flowcache_trace_t *t = vlib_add_trace (vm, node, b[0], sizeof (*t));
+	  t->adj_index = adj0;
+	  t->hit = hit0;
+	}
+
+      b += 1;
+      next += 1;
+      n_left -= 1;
+    }
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+
+  vlib_node_increment_counter (vm, node->node_index, FLOWCACHE_ERROR_HIT,
+			       n_hit);
+  vlib_node_increment_counter (vm, node->node_index, FLOWCACHE_ERROR_LEARN,
+			       n_learn);
+  vlib_node_increment_counter (vm, node->node_index, FLOWCACHE_ERROR_BYPASS,
+			       n_bypass);
+
+  return frame->n_vectors;
+}
+
+VLIB_REGISTER_NODE (flowcache_ip4_node) = {
+  .name = "ip4-flowcache",
+  .vector_size = sizeof (u32),
+  .format_trace = format_flowcache_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+  .n_errors = ARRAY_LEN (flowcache_error_strings),
+  .error_strings = flowcache_error_strings,
+  .n_next_nodes = FLOWCACHE_N_NEXT,
+  .next_nodes = {
+    [FLOWCACHE_NEXT_REWRITE] = "ip4-rewrite",
+  },
+};
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
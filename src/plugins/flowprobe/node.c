@@ -316,14 +316,11 @@ flowprobe_hash (flowprobe_key_t * k)
 }
 
 flowprobe_entry_t *
-flowprobe_lookup (u32 my_cpu_number, flowprobe_key_t * k, u32 * poolindex,
-		  bool * collision)
+flowprobe_lookup (u32 my_cpu_number, flowprobe_key_t *k, u32 h,
+		  u32 *poolindex, bool *collision)
 {
   flowprobe_main_t *fm = &flowprobe_main;
   flowprobe_entry_t *e;
-  u32 h;
-
-  h = (fm->active_timer) ? flowprobe_hash (k) : 0;
 
   /* Lookup in the flow state pool */
   *poolindex = fm->hash_per_worker[my_cpu_number][h];
@@ -343,16 +340,13 @@ flowprobe_lookup (u32 my_cpu_number, flowprobe_key_t * k, u32 * poolindex,
 }
 
 flowprobe_entry_t *
-flowprobe_create (u32 my_cpu_number, flowprobe_key_t * k, u32 * poolindex)
+flowprobe_create (u32 my_cpu_number, flowprobe_key_t *k, u32 h,
+		  u32 *poolindex)
 {
   flowprobe_main_t *fm = &flowprobe_main;
-  u32 h;
 
   flowprobe_entry_t *e;
 
-  /* Get my index */
-  h = (fm->active_timer) ? flowprobe_hash (k) : 0;
-
   pool_get (fm->pool_per_worker[my_cpu_number], e);
   *poolindex = e - fm->pool_per_worker[my_cpu_number];
   fm->hash_per_worker[my_cpu_number][h] = *poolindex;
@@ -369,19 +363,13 @@ flowprobe_create (u32 my_cpu_number, flowprobe_key_t * k, u32 * poolindex)
 }
 
 static inline void
-add_to_flow_record_state (vlib_main_t *vm, vlib_node_runtime_t *node,
-			  flowprobe_main_t *fm, vlib_buffer_t *b,
-			  timestamp_nsec_t timestamp, u16 length,
-			  flowprobe_variant_t which,
-			  flowprobe_direction_t direction,
-			  flowprobe_trace_t *t)
+flowprobe_extract_key (flowprobe_main_t *fm, vlib_buffer_t *b,
+		       flowprobe_variant_t which,
+		       flowprobe_direction_t direction, flowprobe_key_t *kp,
+		       u16 *octets_p, u8 *tcp_flags_p)
 {
-  if (fm->disabled)
-    return;
-
   ASSERT (direction == FLOW_DIRECTION_RX || direction == FLOW_DIRECTION_TX);
 
-  u32 my_cpu_number = vm->thread_index;
   u16 octets = 0;
 
   flowprobe_record_t flags = fm->context[which].flags;
@@ -478,42 +466,55 @@ add_to_flow_record_state (vlib_main_t *vm, vlib_node_runtime_t *node,
       tcp_flags = tcp->flags;
     }
 
-  if (t)
-    {
-      t->rx_sw_if_index = k.rx_sw_if_index;
-      t->tx_sw_if_index = k.tx_sw_if_index;
-      clib_memcpy_fast (t->src_mac, k.src_mac, 6);
-      clib_memcpy_fast (t->dst_mac, k.dst_mac, 6);
-      t->ethertype = k.ethertype;
-      t->src_address.ip4.as_u32 = k.src_address.ip4.as_u32;
-      t->dst_address.ip4.as_u32 = k.dst_address.ip4.as_u32;
-      t->protocol = k.protocol;
-      t->src_port = k.src_port;
-      t->dst_port = k.dst_port;
-      t->which = k.which;
-    }
+  *kp = k;
+  *octets_p = octets;
+  *tcp_flags_p = tcp_flags;
+}
+
+static inline void
+flowprobe_trace_key (flowprobe_trace_t *t, flowprobe_key_t *k)
+{
+  t->rx_sw_if_index = k->rx_sw_if_index;
+  t->tx_sw_if_index = k->tx_sw_if_index;
+  clib_memcpy_fast (t->src_mac, k->src_mac, 6);
+  clib_memcpy_fast (t->dst_mac, k->dst_mac, 6);
+  t->ethertype = k->ethertype;
+  t->src_address.ip4.as_u32 = k->src_address.ip4.as_u32;
+  t->dst_address.ip4.as_u32 = k->dst_address.ip4.as_u32;
+  t->protocol = k->protocol;
+  t->src_port = k->src_port;
+  t->dst_port = k->dst_port;
+  t->which = k->which;
+}
 
+static inline void
+add_to_flow_record_state (vlib_main_t *vm, vlib_node_runtime_t *node,
+			  flowprobe_main_t *fm, flowprobe_key_t *k, u32 h,
+			  u16 octets, u8 tcp_flags, timestamp_nsec_t timestamp,
+			  f64 now)
+{
+  u32 my_cpu_number = vm->thread_index;
   flowprobe_entry_t *e = 0;
-  f64 now = vlib_time_now (vm);
+
   if (fm->active_timer > 0)
     {
       u32 poolindex = ~0;
       bool collision = false;
 
-      e = flowprobe_lookup (my_cpu_number, &k, &poolindex, &collision);
+      e = flowprobe_lookup (my_cpu_number, k, h, &poolindex, &collision);
       if (collision)
 	{
 	  /* Flush data and clean up entry for reuse. */
 	  if (e->packetcount)
 	    flowprobe_export_entry (vm, e);
-	  e->key = k;
+	  e->key = *k;
 	  e->flow_start = timestamp;
 	  vlib_node_increment_counter (vm, node->node_index,
 				       FLOWPROBE_ERROR_COLLISION, 1);
 	}
       if (!e)			/* Create new entry */
 	{
-	  e = flowprobe_create (my_cpu_number, &k, &poolindex);
+	  e = flowprobe_create (my_cpu_number, k, h, &poolindex);
 	  e->last_exported = now;
 	  e->flow_start = timestamp;
 	}
@@ -521,7 +522,7 @@ add_to_flow_record_state (vlib_main_t *vm, vlib_node_runtime_t *node,
   else
     {
       e = &fm->stateless_entry[my_cpu_number];
-      e->key = k;
+      e->key = *k;
     }
 
   if (e)
@@ -545,6 +546,28 @@ flowprobe_get_headersize (void)
     sizeof (ipfix_message_header_t) + sizeof (ipfix_set_header_t);
 }
 
+static void
+flowprobe_export_put_frame (vlib_main_t *vm, flowprobe_variant_t which)
+{
+  flowprobe_main_t *fm = &flowprobe_main;
+  vlib_frame_t **f = &fm->context[which].frames_per_worker[vm->thread_index];
+
+  if (*f == 0)
+    return;
+
+  vlib_put_frame_to_node (vm, ip4_lookup_node.index, *f);
+  *f = 0;
+}
+
+static void
+flowprobe_export_put_frames (vlib_main_t *vm)
+{
+  flowprobe_variant_t which;
+
+  for (which = 0; which < FLOW_N_VARIANTS; which++)
+    flowprobe_export_put_frame (vm, which);
+}
+
 static void
 flowprobe_export_send (vlib_main_t * vm, vlib_buffer_t * b0,
 		       flowprobe_variant_t which)
@@ -560,6 +583,7 @@ flowprobe_export_send (vlib_main_t * vm, vlib_buffer_t * b0,
   udp_header_t *udp;
   flowprobe_record_t flags = fm->context[which].flags;
   u32 my_cpu_number = vm->thread_index;
+  u32 *to_next;
 
   /* Fill in header */
   flow_report_stream_t *stream;
@@ -605,8 +629,8 @@ flowprobe_export_send (vlib_main_t * vm, vlib_buffer_t * b0,
   h->export_time = clib_host_to_net_u32 (h->export_time);
   h->domain_id = clib_host_to_net_u32 (stream->domain_id);
 
-  /* FIXUP: message header sequence_number */
-  h->sequence_number = stream->sequence_number++;
+  /* FIXUP: message header sequence_number, the stream is shared by workers */
+  h->sequence_number = clib_atomic_fetch_add (&stream->sequence_number, 1);
   h->sequence_number = clib_host_to_net_u32 (h->sequence_number);
 
   s->set_id_length = ipfix_set_id_length (fm->template_reports[flags],
@@ -631,26 +655,26 @@ flowprobe_export_send (vlib_main_t * vm, vlib_buffer_t * b0,
 
   ASSERT (ip4_header_checksum_is_valid (ip));
 
-  /* Find or allocate a frame */
+  /*
+   * Find or allocate a frame. Export packets built during this dispatch
+   * share it, it is put when full or by flowprobe_export_put_frames ()
+   */
   f = fm->context[which].frames_per_worker[my_cpu_number];
   if (PREDICT_FALSE (f == 0))
     {
-      u32 *to_next;
       f = vlib_get_frame_to_node (vm, ip4_lookup_node.index);
       fm->context[which].frames_per_worker[my_cpu_number] = f;
-      u32 bi0 = vlib_get_buffer_index (vm, b0);
-
-      /* Enqueue the buffer */
-      to_next = vlib_frame_vector_args (f);
-      to_next[0] = bi0;
-      f->n_vectors = 1;
     }
 
-  vlib_put_frame_to_node (vm, ip4_lookup_node.index, f);
+  /* Enqueue the buffer */
+  to_next = vlib_frame_vector_args (f);
+  to_next[f->n_vectors++] = vlib_get_buffer_index (vm, b0);
+  if (f->n_vectors == VLIB_FRAME_SIZE)
+    flowprobe_export_put_frame (vm, which);
+
   vlib_node_increment_counter (vm, flowprobe_output_l2_node.index,
 			       FLOWPROBE_ERROR_EXPORTED_PACKETS, 1);
 
-  fm->context[which].frames_per_worker[my_cpu_number] = 0;
   fm->context[which].buffers_per_worker[my_cpu_number] = 0;
   fm->context[which].next_record_offset_per_worker[my_cpu_number] =
     flowprobe_get_headersize ();
@@ -752,137 +776,92 @@ flowprobe_export_entry (vlib_main_t * vm, flowprobe_entry_t * e)
     flowprobe_export_send (vm, b0, which);
 }
 
+/*
+ * The frame is processed in two passes. The first one extracts the keys,
+ * hashes them and prefetches the hash table slots, the second one
+ * prefetches the flow entries a few packets ahead and updates them.
+ */
 uword
 flowprobe_node_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 		   vlib_frame_t *frame, flowprobe_variant_t which,
 		   flowprobe_direction_t direction)
 {
-  u32 n_left_from, *from, *to_next;
-  flowprobe_next_t next_index;
   flowprobe_main_t *fm = &flowprobe_main;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  flowprobe_key_t keys[VLIB_FRAME_SIZE];
+  u32 hashes[VLIB_FRAME_SIZE];
+  u16 octets[VLIB_FRAME_SIZE];
+  u16 nexts[VLIB_FRAME_SIZE];
+  u8 tcp_flags[VLIB_FRAME_SIZE];
+  u32 *from, n_left, n_flows = 0, i;
+  u32 my_cpu_number = vm->thread_index;
+  u32 *ht = 0;
   timestamp_nsec_t timestamp;
+  f64 now;
 
   unix_time_now_nsec_fraction (&timestamp.sec, &timestamp.nsec);
+  now = vlib_time_now (vm);
 
   from = vlib_frame_vector_args (frame);
-  n_left_from = frame->n_vectors;
-  next_index = node->cached_next_index;
+  n_left = frame->n_vectors;
+  vlib_get_buffers (vm, from, bufs, n_left);
+  vnet_feature_next_n (bufs, nexts, n_left);
 
-  while (n_left_from > 0)
+  if (fm->active_timer > 0)
+    ht = fm->hash_per_worker[my_cpu_number];
+
+  for (i = 0, b = bufs; i < n_left; i++, b++)
     {
-      u32 n_left_to_next;
+      if (i + 4 < n_left)
+	{
+	  vlib_prefetch_buffer_header (b[4], LOAD);
+	  clib_prefetch_load (b[4]->data);
+	}
+
+      if (PREDICT_FALSE (fm->disabled ||
+			 (b[0]->flags & VNET_BUFFER_F_FLOW_REPORT)))
+	continue;
+
+      ethernet_header_t *eh0 = vlib_buffer_get_current (b[0]);
+      u16 ethertype0 = clib_net_to_host_u16 (eh0->type);
+      flowprobe_key_t *k = keys + n_flows;
 
-      vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
+      flowprobe_extract_key (
+	fm, b[0],
+	flowprobe_get_variant (which, fm->context[which].flags, ethertype0),
+	direction, k, octets + n_flows, tcp_flags + n_flows);
 
-      while (n_left_from >= 4 && n_left_to_next >= 2)
+      if (ht)
 	{
-	  u32 next0 = FLOWPROBE_NEXT_DROP;
-	  u32 next1 = FLOWPROBE_NEXT_DROP;
-	  u16 len0, len1;
-	  u32 bi0, bi1;
-	  vlib_buffer_t *b0, *b1;
-
-	  /* Prefetch next iteration. */
-	  {
-	    vlib_buffer_t *p2, *p3;
-
-	    p2 = vlib_get_buffer (vm, from[2]);
-	    p3 = vlib_get_buffer (vm, from[3]);
-
-	    vlib_prefetch_buffer_header (p2, LOAD);
-	    vlib_prefetch_buffer_header (p3, LOAD);
-
-	    clib_prefetch_store (p2->data);
-	    clib_prefetch_store (p3->data);
-	  }
-
-	  /* speculatively enqueue b0 and b1 to the current next frame */
-	  to_next[0] = bi0 = from[0];
-	  to_next[1] = bi1 = from[1];
-	  from += 2;
-	  to_next += 2;
-	  n_left_from -= 2;
-	  n_left_to_next -= 2;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-	  b1 = vlib_get_buffer (vm, bi1);
-
-	  vnet_feature_next (&next0, b0);
-	  vnet_feature_next (&next1, b1);
-
-	  len0 = vlib_buffer_length_in_chain (vm, b0);
-	  ethernet_header_t *eh0 = vlib_buffer_get_current (b0);
-	  u16 ethertype0 = clib_net_to_host_u16 (eh0->type);
-
-	  if (PREDICT_TRUE ((b0->flags & VNET_BUFFER_F_FLOW_REPORT) == 0))
-	    add_to_flow_record_state (
-	      vm, node, fm, b0, timestamp, len0,
-	      flowprobe_get_variant (which, fm->context[which].flags,
-				     ethertype0),
-	      direction, 0);
-
-	  len1 = vlib_buffer_length_in_chain (vm, b1);
-	  ethernet_header_t *eh1 = vlib_buffer_get_current (b1);
-	  u16 ethertype1 = clib_net_to_host_u16 (eh1->type);
-
-	  if (PREDICT_TRUE ((b1->flags & VNET_BUFFER_F_FLOW_REPORT) == 0))
-	    add_to_flow_record_state (
-	      vm, node, fm, b1, timestamp, len1,
-	      flowprobe_get_variant (which, fm->context[which].flags,
-				     ethertype1),
-	      direction, 0);
-
-	  /* verify speculative enqueues, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x2 (vm, node, next_index,
-					   to_next, n_left_to_next,
-					   bi0, bi1, next0, next1);
+	  hashes[n_flows] = flowprobe_hash (k);
+	  clib_prefetch_load (ht + hashes[n_flows]);
 	}
+      else
+	hashes[n_flows] = 0;
 
-      while (n_left_from > 0 && n_left_to_next > 0)
+      if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
+			 (b[0]->flags & VLIB_BUFFER_IS_TRACED)))
 	{
-	  u32 bi0;
-	  vlib_buffer_t *b0;
-	  u32 next0 = FLOWPROBE_NEXT_DROP;
-	  u16 len0;
-
-	  /* speculatively enqueue b0 to the current next frame */
-	  bi0 = from[0];
-	  to_next[0] = bi0;
-	  from += 1;
-	  to_next += 1;
-	  n_left_from -= 1;
-	  n_left_to_next -= 1;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-
-	  vnet_feature_next (&next0, b0);
-
-	  len0 = vlib_buffer_length_in_chain (vm, b0);
-	  ethernet_header_t *eh0 = vlib_buffer_get_current (b0);
-	  u16 ethertype0 = clib_net_to_host_u16 (eh0->type);
-
-	  if (PREDICT_TRUE ((b0->flags & VNET_BUFFER_F_FLOW_REPORT) == 0))
-	    {
-	      flowprobe_trace_t *t = 0;
-	      if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE)
-				 && (b0->flags & VLIB_BUFFER_IS_TRACED)))
-		t = vlib_add_trace (vm, node, b0, sizeof (*t));
-
-	      add_to_flow_record_state (
-		vm, node, fm, b0, timestamp, len0,
-		flowprobe_get_variant (which, fm->context[which].flags,
-				       ethertype0),
-		direction, t);
-	    }
-
-	  /* verify speculative enqueue, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-					   to_next, n_left_to_next,
-					   bi0, next0);
+	  flowprobe_trace_t *t = vlib_add_trace (vm, node, b[0], sizeof (*t));
+	  flowprobe_trace_key (t, k);
 	}
 
-      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+      n_flows++;
     }
+
+  for (i = 0; i < n_flows; i++)
+    {
+      if (ht && i + 4 < n_flows && ht[hashes[i + 4]] != ~0)
+	clib_prefetch_store (fm->pool_per_worker[my_cpu_number] +
+			     ht[hashes[i + 4]]);
+
+      add_to_flow_record_state (vm, node, fm, keys + i, hashes[i], octets[i],
+				tcp_flags[i], timestamp, now);
+    }
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+  flowprobe_export_put_frames (vm);
+
   return frame->n_vectors;
 }
 
@@ -941,6 +920,7 @@ flush_record (flowprobe_variant_t which)
   vlib_buffer_t *b = flowprobe_get_buffer (vm, which);
   if (b)
     flowprobe_export_send (vm, b, which);
+  flowprobe_export_put_frame (vm, which);
 }
 
 void
@@ -1099,6 +1079,8 @@ flowprobe_walker_process (vlib_main_t * vm,
   vec_foreach (i, to_be_removed) flowprobe_delete_by_index (cpu_index, *i);
   vec_free (to_be_removed);
 
+  flowprobe_export_put_frames (vm);
+
   return 0;
 }
 
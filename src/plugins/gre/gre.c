@@ -818,10 +818,12 @@ gre_init (vlib_main_t *vm)
 
   gm->protocol_info_by_name = hash_create_string (0, sizeof (uword));
   gm->protocol_info_by_protocol = hash_create (0, sizeof (uword));
-  gm->tunnel_by_key4 =
-    hash_create_mem (0, sizeof (gre_tunnel_key4_t), sizeof (uword));
-  gm->tunnel_by_key6 =
-    hash_create_mem (0, sizeof (gre_tunnel_key6_t), sizeof (uword));
+  clib_bihash_init_16_8 (&gm->tunnel_by_key4, "gre ip4 tunnels",
+			 GRE_TUNNEL_DB_BUCKETS, GRE_TUNNEL_DB_MEMORY);
+  clib_bihash_init_40_8 (&gm->tunnel_by_key6, "gre ip6 tunnels",
+			 GRE_TUNNEL_DB_BUCKETS, GRE_TUNNEL_DB_MEMORY);
+  vec_validate_aligned (gm->input_caches, vlib_num_workers (),
+			CLIB_CACHE_LINE_BYTES);
   gm->seq_num_by_key =
     hash_create_mem (0, sizeof (gre_sn_key_t), sizeof (uword));
 
@@ -25,6 +25,8 @@
 #include <vnet/adj/adj_types.h>
 #include <vnet/tunnel/tunnel.h>
 #include <vnet/teib/teib.h>
+#include <vppinfra/bihash_16_8.h>
+#include <vppinfra/bihash_40_8.h>
 
 extern vnet_hw_interface_class_t gre_hw_interface_class;
 extern vnet_hw_interface_class_t mgre_hw_interface_class;
@@ -236,6 +238,46 @@ typedef struct
   u8 tunnel_type;
 } next_info_t;
 
+/**
+ * Sizing of the tunnel endpoint tables
+ */
+#define GRE_TUNNEL_DB_BUCKETS (16 << 10)
+#define GRE_TUNNEL_DB_MEMORY  (64 << 20)
+
+/**
+ * The endpoint table value; the tunnel's sw_if_index, which is all the
+ * data-plane needs, and its index in the tunnel pool
+ */
+#define GRE_TUNNEL_DB_VALUE(_t)                                               \
+  (((u64) (_t)->sw_if_index << 32) | (_t)->dev_instance)
+#define GRE_TUNNEL_DB_VALUE_SW_IF_INDEX(_v) ((u32) ((_v) >> 32))
+#define GRE_TUNNEL_DB_VALUE_INDEX(_v)	    ((u32) (_v))
+
+/**
+ * Number of recently used tunnels each worker remembers per address family
+ */
+#define GRE_INPUT_CACHE_SIZE 4
+
+/**
+ * @brief Per-worker cache of the tunnels recently seen by gre-input.
+ * It is flushed whenever the tunnel DB epoch moves on.
+ */
+typedef struct gre_input_cache_t_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /** the tunnel DB epoch the entries are valid for */
+  u32 epoch;
+
+  /** per address family; valid entries and the next one to replace */
+  u8 n_valid[2];
+  u8 next_slot[2];
+
+  u32 sw_if_index[2][GRE_INPUT_CACHE_SIZE];
+  gre_tunnel_key4_t key4[GRE_INPUT_CACHE_SIZE];
+  gre_tunnel_key6_t key6[GRE_INPUT_CACHE_SIZE];
+} gre_input_cache_t;
+
 /**
  * @brief GRE related global data
  */
@@ -257,14 +299,25 @@ typedef struct
   uword *protocol_info_by_name, *protocol_info_by_protocol;
 
   /**
-   * Hash mapping to tunnels with ipv4 src/dst addr
+   * Bihash mapping to tunnels with ipv4 src/dst addr
+   */
+  clib_bihash_16_8_t tunnel_by_key4;
+
+  /**
+   * Bihash mapping to tunnels with ipv6 src/dst addr
+   */
+  clib_bihash_40_8_t tunnel_by_key6;
+
+  /**
+   * Bumped each time the tunnel DB changes, invalidating the workers'
+   * input caches
    */
-  uword *tunnel_by_key4;
+  volatile u32 tunnel_db_epoch;
 
   /**
-   * Hash mapping to tunnels with ipv6 src/dst addr
+   * Per-thread gre-input tunnel caches
    */
-  uword *tunnel_by_key6;
+  gre_input_cache_t *input_caches;
 
   /**
    * Hash mapping tunnel src/dst addr and fib-idx to sequence number
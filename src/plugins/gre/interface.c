@@ -25,6 +25,13 @@
 #include <vnet/l2/l2_input.h>
 #include <vnet/teib/teib.h>
 
+/*
+ * The IPv6 tunnel endpoint table; vnet does not instantiate the 40_8 bihash
+ */
+#include <vppinfra/bihash_40_8.h>
+#include <vppinfra/bihash_template.h>
+#include <vppinfra/bihash_template.c>
+
 u8 *
 format_gre_tunnel_type (u8 *s, va_list *args)
 {
@@ -71,55 +78,70 @@ gre_tunnel_db_find (const vnet_gre_tunnel_add_del_args_t *a,
 		    u32 outer_fib_index, gre_tunnel_key_t *key)
 {
   gre_main_t *gm = &gre_main;
-  uword *p;
+  u64 value;
 
   if (!a->is_ipv6)
     {
+      clib_bihash_kv_16_8_t kv;
+
       gre_mk_key4 (a->src.ip4, a->dst.ip4, outer_fib_index, a->type, a->mode,
 		   a->session_id, &key->gtk_v4);
-      p = hash_get_mem (gm->tunnel_by_key4, &key->gtk_v4);
+      clib_memcpy_fast (kv.key, &key->gtk_v4, sizeof (kv.key));
+      if (clib_bihash_search_16_8 (&gm->tunnel_by_key4, &kv, &kv))
+	return (NULL);
+      value = kv.value;
     }
   else
     {
+      clib_bihash_kv_40_8_t kv;
+
       gre_mk_key6 (&a->src.ip6, &a->dst.ip6, outer_fib_index, a->type, a->mode,
 		   a->session_id, &key->gtk_v6);
-      p = hash_get_mem (gm->tunnel_by_key6, &key->gtk_v6);
+      clib_memcpy_fast (kv.key, &key->gtk_v6, sizeof (kv.key));
+      if (clib_bihash_search_40_8 (&gm->tunnel_by_key6, &kv, &kv))
+	return (NULL);
+      value = kv.value;
     }
 
-  if (NULL == p)
-    return (NULL);
-
-  return (pool_elt_at_index (gm->tunnels, p[0]));
+  return (pool_elt_at_index (gm->tunnels, GRE_TUNNEL_DB_VALUE_INDEX (value)));
 }
 
 static void
-gre_tunnel_db_add (gre_tunnel_t *t, gre_tunnel_key_t *key)
+gre_tunnel_db_add_del (gre_tunnel_t *t, gre_tunnel_key_t *key, int is_add)
 {
   gre_main_t *gm = &gre_main;
 
   if (t->tunnel_dst.fp_proto == FIB_PROTOCOL_IP6)
     {
-      hash_set_mem_alloc (&gm->tunnel_by_key6, &key->gtk_v6, t->dev_instance);
+      clib_bihash_kv_40_8_t kv;
+
+      clib_memcpy_fast (kv.key, &key->gtk_v6, sizeof (kv.key));
+      kv.value = GRE_TUNNEL_DB_VALUE (t);
+      clib_bihash_add_del_40_8 (&gm->tunnel_by_key6, &kv, is_add);
     }
   else
     {
-      hash_set_mem_alloc (&gm->tunnel_by_key4, &key->gtk_v4, t->dev_instance);
+      clib_bihash_kv_16_8_t kv;
+
+      clib_memcpy_fast (kv.key, &key->gtk_v4, sizeof (kv.key));
+      kv.value = GRE_TUNNEL_DB_VALUE (t);
+      clib_bihash_add_del_16_8 (&gm->tunnel_by_key4, &kv, is_add);
     }
+
+  /* the workers' gre-input caches may hold the old mapping */
+  gm->tunnel_db_epoch++;
 }
 
 static void
-gre_tunnel_db_remove (gre_tunnel_t *t, gre_tunnel_key_t *key)
+gre_tunnel_db_add (gre_tunnel_t *t, gre_tunnel_key_t *key)
 {
-  gre_main_t *gm = &gre_main;
+  gre_tunnel_db_add_del (t, key, 1 /* is_add */);
+}
 
-  if (t->tunnel_dst.fp_proto == FIB_PROTOCOL_IP6)
-    {
-      hash_unset_mem_free (&gm->tunnel_by_key6, &key->gtk_v6);
-    }
-  else
-    {
-      hash_unset_mem_free (&gm->tunnel_by_key4, &key->gtk_v4);
-    }
+static void
+gre_tunnel_db_remove (gre_tunnel_t *t, gre_tunnel_key_t *key)
+{
+  gre_tunnel_db_add_del (t, key, 0 /* is_add */);
 }
 
 /**
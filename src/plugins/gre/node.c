@@ -71,13 +71,14 @@ typedef struct
 
 always_inline void
 gre_trace (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_buffer_t *b,
-	   u32 tun_sw_if_index, const ip6_header_t *ip6,
-	   const ip4_header_t *ip4, int is_ipv6)
+	   u32 tun_sw_if_index, int is_ipv6)
 {
   gre_rx_trace_t *tr = vlib_add_trace (vm, node, b, sizeof (*tr));
   tr->tunnel_id = tun_sw_if_index;
   if (is_ipv6)
     {
+      const ip6_header_t *ip6 = vlib_buffer_get_current (b) -
+				sizeof (gre_header_t) - sizeof (*ip6);
       tr->length = ip6->payload_length;
       tr->src.ip6.as_u64[0] = ip6->src_address.as_u64[0];
       tr->src.ip6.as_u64[1] = ip6->src_address.as_u64[1];
@@ -86,6 +87,8 @@ gre_trace (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_buffer_t *b,
     }
   else
     {
+      const ip4_header_t *ip4 = vlib_buffer_get_current (b) -
+				sizeof (gre_header_t) - sizeof (*ip4);
       tr->length = ip4->length;
       tr->src.as_u64[0] = tr->src.as_u64[1] = 0;
       tr->dst.as_u64[0] = tr->dst.as_u64[1] = 0;
@@ -94,31 +97,39 @@ gre_trace (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_buffer_t *b,
     }
 }
 
+/*
+ * The worker's cache of recently used tunnels; a few entries are enough
+ * to absorb the bursts of packets from the same tunnel within a frame.
+ */
+always_inline u32
+gre_input_cache_find (const gre_input_cache_t *gc, const void *key,
+		      int is_ipv6)
+{
+  u32 i;
+
+  for (i = 0; i < gc->n_valid[is_ipv6]; i++)
+    if (is_ipv6 ? gre_match_key6 (&gc->key6[i], key) :
+			gre_match_key4 (&gc->key4[i], key))
+      return gc->sw_if_index[is_ipv6][i];
+
+  return ~0;
+}
+
 always_inline void
-gre_tunnel_get (const gre_main_t *gm, vlib_node_runtime_t *node,
-		vlib_buffer_t *b, u16 *next, const gre_tunnel_key_t *key,
-		gre_tunnel_key_t *cached_key, u32 *tun_sw_if_index,
-		u32 *cached_tun_sw_if_index, int is_ipv6)
+gre_input_cache_add (gre_input_cache_t *gc, const void *key, u32 sw_if_index,
+		     int is_ipv6)
 {
-  const uword *p;
-  p = is_ipv6 ? hash_get_mem (gm->tunnel_by_key6, &key->gtk_v6) :
-		      hash_get_mem (gm->tunnel_by_key4, &key->gtk_v4);
-  if (PREDICT_FALSE (!p))
-    {
-      *next = GRE_INPUT_NEXT_DROP;
-      b->error = node->errors[GRE_ERROR_NO_SUCH_TUNNEL];
-      *tun_sw_if_index = ~0;
-    }
+  u8 slot = gc->next_slot[is_ipv6];
+
+  if (is_ipv6)
+    clib_memcpy_fast (&gc->key6[slot], key, sizeof (gc->key6[slot]));
   else
-    {
-      const gre_tunnel_t *tun;
-      tun = pool_elt_at_index (gm->tunnels, *p);
-      *cached_tun_sw_if_index = *tun_sw_if_index = tun->sw_if_index;
-      if (is_ipv6)
-	cached_key->gtk_v6 = key->gtk_v6;
-      else
-	cached_key->gtk_v4 = key->gtk_v4;
-    }
+    clib_memcpy_fast (&gc->key4[slot], key, sizeof (gc->key4[slot]));
+  gc->sw_if_index[is_ipv6][slot] = sw_if_index;
+
+  gc->next_slot[is_ipv6] = (slot + 1) % GRE_INPUT_CACHE_SIZE;
+  if (gc->n_valid[is_ipv6] < GRE_INPUT_CACHE_SIZE)
+    gc->n_valid[is_ipv6]++;
 }
 
 always_inline uword
@@ -126,292 +137,223 @@ gre_input (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame,
 	   const int is_ipv6)
 {
   gre_main_t *gm = &gre_main;
-  u32 *from, n_left_from;
+  gre_input_cache_t *gc;
+  vlib_combined_counter_acc_t rx_acc;
+  u32 *from, n_left_from, n_miss = 0, n_decap = 0, i;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
   u16 nexts[VLIB_FRAME_SIZE], *next = nexts;
+  u32 tun_sw_if_indices[VLIB_FRAME_SIZE], *tun_sw_if_index;
+  u16 miss_indices[VLIB_FRAME_SIZE];
+  u64 hashes[VLIB_FRAME_SIZE];
+  u64 found_bmp[VLIB_FRAME_SIZE / 64];
+  union
+  {
+    clib_bihash_kv_16_8_t kv4[VLIB_FRAME_SIZE];
+    clib_bihash_kv_40_8_t kv6[VLIB_FRAME_SIZE];
+  } miss_kvs;
   u16 cached_protocol = ~0;
   u32 cached_next_index = SPARSE_VEC_INVALID_INDEX;
-  u32 cached_tun_sw_if_index = ~0;
-  gre_tunnel_key_t cached_key;
 
   from = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
   vlib_get_buffers (vm, from, bufs, n_left_from);
+  tun_sw_if_index = tun_sw_if_indices;
 
-  if (is_ipv6)
-    clib_memset (&cached_key.gtk_v6, 0xff, sizeof (cached_key.gtk_v6));
-  else
-    clib_memset (&cached_key.gtk_v4, 0xff, sizeof (cached_key.gtk_v4));
+  gc = vec_elt_at_index (gm->input_caches, vm->thread_index);
+  if (PREDICT_FALSE (gc->epoch != gm->tunnel_db_epoch))
+    {
+      gc->epoch = gm->tunnel_db_epoch;
+      gc->n_valid[0] = gc->n_valid[1] = 0;
+      gc->next_slot[0] = gc->next_slot[1] = 0;
+    }
 
-  while (n_left_from >= 2)
+  /*
+   * First pass; parse the headers, build the tunnel keys and resolve
+   * those that hit in the worker's cache. The misses are collected so
+   * their table lookups can be pipelined.
+   */
+  while (n_left_from > 0)
     {
-      const ip6_header_t *ip6[2];
-      const ip4_header_t *ip4[2];
-      const gre_header_t *gre[2];
-      u32 nidx[2];
-      next_info_t ni[2];
-      u8 type[2];
-      u16 version[2];
-      u32 len[2];
-      gre_tunnel_key_t key[2];
-      u8 matched[2];
-      u32 tun_sw_if_index[2];
-
-      if (PREDICT_TRUE (n_left_from >= 6))
+      const ip6_header_t *ip6;
+      const ip4_header_t *ip4;
+      const gre_header_t *gre;
+      next_info_t ni;
+      u32 nidx;
+      void *key;
+
+      if (PREDICT_TRUE (n_left_from >= 5))
 	{
 	  vlib_prefetch_buffer_data (b[2], LOAD);
-	  vlib_prefetch_buffer_data (b[3], LOAD);
 	  vlib_prefetch_buffer_header (b[4], STORE);
-	  vlib_prefetch_buffer_header (b[5], STORE);
 	}
 
       if (is_ipv6)
 	{
 	  /* ip6_local hands us the ip header, not the gre header */
-	  ip6[0] = vlib_buffer_get_current (b[0]);
-	  ip6[1] = vlib_buffer_get_current (b[1]);
-	  gre[0] = (void *) (ip6[0] + 1);
-	  gre[1] = (void *) (ip6[1] + 1);
-	  vlib_buffer_advance (b[0], sizeof (*ip6[0]) + sizeof (*gre[0]));
-	  vlib_buffer_advance (b[1], sizeof (*ip6[0]) + sizeof (*gre[0]));
+	  ip6 = vlib_buffer_get_current (b[0]);
+	  gre = (void *) (ip6 + 1);
+	  vlib_buffer_advance (b[0], sizeof (*ip6) + sizeof (*gre));
 	}
       else
 	{
 	  /* ip4_local hands us the ip header, not the gre header */
-	  ip4[0] = vlib_buffer_get_current (b[0]);
-	  ip4[1] = vlib_buffer_get_current (b[1]);
-	  gre[0] = (void *) (ip4[0] + 1);
-	  gre[1] = (void *) (ip4[1] + 1);
-	  vlib_buffer_advance (b[0], sizeof (*ip4[0]) + sizeof (*gre[0]));
-	  vlib_buffer_advance (b[1], sizeof (*ip4[0]) + sizeof (*gre[0]));
+	  ip4 = vlib_buffer_get_current (b[0]);
+	  gre = (void *) (ip4 + 1);
+	  vlib_buffer_advance (b[0], sizeof (*ip4) + sizeof (*gre));
 	}
 
-      if (PREDICT_TRUE (cached_protocol == gre[0]->protocol))
-	{
-	  nidx[0] = cached_next_index;
-	}
-      else
-	{
-	  cached_next_index = nidx[0] =
-	    sparse_vec_index (gm->next_by_protocol, gre[0]->protocol);
-	  cached_protocol = gre[0]->protocol;
-	}
-      if (PREDICT_TRUE (cached_protocol == gre[1]->protocol))
+      if (PREDICT_TRUE (cached_protocol == gre->protocol))
 	{
-	  nidx[1] = cached_next_index;
+	  nidx = cached_next_index;
 	}
       else
 	{
-	  cached_next_index = nidx[1] =
-	    sparse_vec_index (gm->next_by_protocol, gre[1]->protocol);
-	  cached_protocol = gre[1]->protocol;
+	  cached_next_index = nidx =
+	    sparse_vec_index (gm->next_by_protocol, gre->protocol);
+	  cached_protocol = gre->protocol;
 	}
 
-      ni[0] = vec_elt (gm->next_by_protocol, nidx[0]);
-      ni[1] = vec_elt (gm->next_by_protocol, nidx[1]);
-      next[0] = ni[0].next_index;
-      next[1] = ni[1].next_index;
-      type[0] = ni[0].tunnel_type;
-      type[1] = ni[1].tunnel_type;
+      ni = vec_elt (gm->next_by_protocol, nidx);
+      next[0] = ni.next_index;
+      tun_sw_if_index[0] = ~0;
 
-      b[0]->error = nidx[0] == SPARSE_VEC_INVALID_INDEX ?
+      b[0]->error = nidx == SPARSE_VEC_INVALID_INDEX ?
 			    node->errors[GRE_ERROR_UNKNOWN_PROTOCOL] :
 			    node->errors[GRE_ERROR_NONE];
-      b[1]->error = nidx[1] == SPARSE_VEC_INVALID_INDEX ?
-			    node->errors[GRE_ERROR_UNKNOWN_PROTOCOL] :
-			    node->errors[GRE_ERROR_NONE];
-
-      version[0] = clib_net_to_host_u16 (gre[0]->flags_and_version);
-      version[1] = clib_net_to_host_u16 (gre[1]->flags_and_version);
-      version[0] &= GRE_VERSION_MASK;
-      version[1] &= GRE_VERSION_MASK;
 
-      b[0]->error =
-	version[0] ? node->errors[GRE_ERROR_UNSUPPORTED_VERSION] : b[0]->error;
-      next[0] = version[0] ? GRE_INPUT_NEXT_DROP : next[0];
-      b[1]->error =
-	version[1] ? node->errors[GRE_ERROR_UNSUPPORTED_VERSION] : b[1]->error;
-      next[1] = version[1] ? GRE_INPUT_NEXT_DROP : next[1];
-
-      len[0] = vlib_buffer_length_in_chain (vm, b[0]);
-      len[1] = vlib_buffer_length_in_chain (vm, b[1]);
+      if (PREDICT_FALSE (clib_net_to_host_u16 (gre->flags_and_version) &
+			 GRE_VERSION_MASK))
+	{
+	  b[0]->error = node->errors[GRE_ERROR_UNSUPPORTED_VERSION];
+	  next[0] = GRE_INPUT_NEXT_DROP;
+	  goto next;
+	}
 
       /* always search for P2P types in the DP */
       if (is_ipv6)
 	{
-	  gre_mk_key6 (&ip6[0]->dst_address, &ip6[0]->src_address,
-		       vnet_buffer (b[0])->ip.fib_index, type[0],
-		       TUNNEL_MODE_P2P, 0, &key[0].gtk_v6);
-	  gre_mk_key6 (&ip6[1]->dst_address, &ip6[1]->src_address,
-		       vnet_buffer (b[1])->ip.fib_index, type[1],
-		       TUNNEL_MODE_P2P, 0, &key[1].gtk_v6);
-	  matched[0] = gre_match_key6 (&cached_key.gtk_v6, &key[0].gtk_v6);
-	  matched[1] = gre_match_key6 (&cached_key.gtk_v6, &key[1].gtk_v6);
+	  key = miss_kvs.kv6[n_miss].key;
+	  gre_mk_key6 (&ip6->dst_address, &ip6->src_address,
+		       vnet_buffer (b[0])->ip.fib_index, ni.tunnel_type,
+		       TUNNEL_MODE_P2P, 0, key);
 	}
       else
 	{
-	  gre_mk_key4 (ip4[0]->dst_address, ip4[0]->src_address,
-		       vnet_buffer (b[0])->ip.fib_index, type[0],
-		       TUNNEL_MODE_P2P, 0, &key[0].gtk_v4);
-	  gre_mk_key4 (ip4[1]->dst_address, ip4[1]->src_address,
-		       vnet_buffer (b[1])->ip.fib_index, type[1],
-		       TUNNEL_MODE_P2P, 0, &key[1].gtk_v4);
-	  matched[0] = gre_match_key4 (&cached_key.gtk_v4, &key[0].gtk_v4);
-	  matched[1] = gre_match_key4 (&cached_key.gtk_v4, &key[1].gtk_v4);
-	}
-
-      tun_sw_if_index[0] = cached_tun_sw_if_index;
-      tun_sw_if_index[1] = cached_tun_sw_if_index;
-      if (PREDICT_FALSE (!matched[0]))
-	gre_tunnel_get (gm, node, b[0], &next[0], &key[0], &cached_key,
-			&tun_sw_if_index[0], &cached_tun_sw_if_index, is_ipv6);
-      if (PREDICT_FALSE (!matched[1]))
-	gre_tunnel_get (gm, node, b[1], &next[1], &key[1], &cached_key,
-			&tun_sw_if_index[1], &cached_tun_sw_if_index, is_ipv6);
-
-      if (PREDICT_TRUE (next[0] > GRE_INPUT_NEXT_DROP))
-	{
-	  vlib_increment_combined_counter (
-	    &gm->vnet_main->interface_main
-	       .combined_sw_if_counters[VNET_INTERFACE_COUNTER_RX],
-	    vm->thread_index, tun_sw_if_index[0], 1 /* packets */,
-	    len[0] /* bytes */);
-	  vnet_buffer (b[0])->sw_if_index[VLIB_RX] = tun_sw_if_index[0];
-	}
-      if (PREDICT_TRUE (next[1] > GRE_INPUT_NEXT_DROP))
-	{
-	  vlib_increment_combined_counter (
-	    &gm->vnet_main->interface_main
-	       .combined_sw_if_counters[VNET_INTERFACE_COUNTER_RX],
-	    vm->thread_index, tun_sw_if_index[1], 1 /* packets */,
-	    len[1] /* bytes */);
-	  vnet_buffer (b[1])->sw_if_index[VLIB_RX] = tun_sw_if_index[1];
+	  key = miss_kvs.kv4[n_miss].key;
+	  gre_mk_key4 (ip4->dst_address, ip4->src_address,
+		       vnet_buffer (b[0])->ip.fib_index, ni.tunnel_type,
+		       TUNNEL_MODE_P2P, 0, key);
 	}
 
-      vnet_buffer (b[0])->sw_if_index[VLIB_TX] = (u32) ~0;
-      vnet_buffer (b[1])->sw_if_index[VLIB_TX] = (u32) ~0;
+      tun_sw_if_index[0] = gre_input_cache_find (gc, key, is_ipv6);
+      if (PREDICT_FALSE (tun_sw_if_index[0] == ~0))
+	miss_indices[n_miss++] = b - bufs;
 
-      if (PREDICT_FALSE (b[0]->flags & VLIB_BUFFER_IS_TRACED))
-	gre_trace (vm, node, b[0], tun_sw_if_index[0], ip6[0], ip4[0],
-		   is_ipv6);
-      if (PREDICT_FALSE (b[1]->flags & VLIB_BUFFER_IS_TRACED))
-	gre_trace (vm, node, b[1], tun_sw_if_index[1], ip6[1], ip4[1],
-		   is_ipv6);
-
-      b += 2;
-      next += 2;
-      n_left_from -= 2;
+    next:
+      b += 1;
+      next += 1;
+      tun_sw_if_index += 1;
+      n_left_from -= 1;
     }
 
-  while (n_left_from >= 1)
+  /*
+   * Second pass; batched, prefetching table lookups for the cache misses
+   */
+  if (n_miss)
     {
-      const ip6_header_t *ip6[1];
-      const ip4_header_t *ip4[1];
-      const gre_header_t *gre[1];
-      u32 nidx[1];
-      next_info_t ni[1];
-      u8 type[1];
-      u16 version[1];
-      u32 len[1];
-      gre_tunnel_key_t key[1];
-      u8 matched[1];
-      u32 tun_sw_if_index[1];
-
-      if (PREDICT_TRUE (n_left_from >= 3))
-	{
-	  vlib_prefetch_buffer_data (b[1], LOAD);
-	  vlib_prefetch_buffer_header (b[2], STORE);
-	}
-
       if (is_ipv6)
 	{
-	  /* ip6_local hands us the ip header, not the gre header */
-	  ip6[0] = vlib_buffer_get_current (b[0]);
-	  gre[0] = (void *) (ip6[0] + 1);
-	  vlib_buffer_advance (b[0], sizeof (*ip6[0]) + sizeof (*gre[0]));
-	}
-      else
-	{
-	  /* ip4_local hands us the ip header, not the gre header */
-	  ip4[0] = vlib_buffer_get_current (b[0]);
-	  gre[0] = (void *) (ip4[0] + 1);
-	  vlib_buffer_advance (b[0], sizeof (*ip4[0]) + sizeof (*gre[0]));
-	}
-
-      if (PREDICT_TRUE (cached_protocol == gre[0]->protocol))
-	{
-	  nidx[0] = cached_next_index;
+	  for (i = 0; i < n_miss; i++)
+	    hashes[i] = clib_bihash_hash_40_8 (&miss_kvs.kv6[i]);
+	  clib_bihash_search_batch_with_hash_40_8 (
+	    &gm->tunnel_by_key6, hashes, miss_kvs.kv6, miss_kvs.kv6, found_bmp,
+	    n_miss);
 	}
       else
 	{
-	  cached_next_index = nidx[0] =
-	    sparse_vec_index (gm->next_by_protocol, gre[0]->protocol);
-	  cached_protocol = gre[0]->protocol;
+	  for (i = 0; i < n_miss; i++)
+	    hashes[i] = clib_bihash_hash_16_8 (&miss_kvs.kv4[i]);
+	  clib_bihash_search_batch_with_hash_16_8 (
+	    &gm->tunnel_by_key4, hashes, miss_kvs.kv4, miss_kvs.kv4, found_bmp,
+	    n_miss);
 	}
 
-      ni[0] = vec_elt (gm->next_by_protocol, nidx[0]);
-      next[0] = ni[0].next_index;
-      type[0] = ni[0].tunnel_type;
-
-      b[0]->error = nidx[0] == SPARSE_VEC_INVALID_INDEX ?
-			    node->errors[GRE_ERROR_UNKNOWN_PROTOCOL] :
-			    node->errors[GRE_ERROR_NONE];
-
-      version[0] = clib_net_to_host_u16 (gre[0]->flags_and_version);
-      version[0] &= GRE_VERSION_MASK;
-
-      b[0]->error =
-	version[0] ? node->errors[GRE_ERROR_UNSUPPORTED_VERSION] : b[0]->error;
-      next[0] = version[0] ? GRE_INPUT_NEXT_DROP : next[0];
-
-      len[0] = vlib_buffer_length_in_chain (vm, b[0]);
-
-      if (is_ipv6)
-	{
-	  gre_mk_key6 (&ip6[0]->dst_address, &ip6[0]->src_address,
-		       vnet_buffer (b[0])->ip.fib_index, type[0],
-		       TUNNEL_MODE_P2P, 0, &key[0].gtk_v6);
-	  matched[0] = gre_match_key6 (&cached_key.gtk_v6, &key[0].gtk_v6);
-	}
-      else
+      for (i = 0; i < n_miss; i++)
 	{
-	  gre_mk_key4 (ip4[0]->dst_address, ip4[0]->src_address,
-		       vnet_buffer (b[0])->ip.fib_index, type[0],
-		       TUNNEL_MODE_P2P, 0, &key[0].gtk_v4);
-	  matched[0] = gre_match_key4 (&cached_key.gtk_v4, &key[0].gtk_v4);
+	  u32 bi = miss_indices[i];
+	  void *key;
+	  u64 value;
+
+	  if (PREDICT_FALSE (!(found_bmp[i / 64] & (1ULL << (i % 64)))))
+	    {
+	      nexts[bi] = GRE_INPUT_NEXT_DROP;
+	      bufs[bi]->error = node->errors[GRE_ERROR_NO_SUCH_TUNNEL];
+	      continue;
+	    }
+
+	  if (is_ipv6)
+	    {
+	      key = miss_kvs.kv6[i].key;
+	      value = miss_kvs.kv6[i].value;
+	    }
+	  else
+	    {
+	      key = miss_kvs.kv4[i].key;
+	      value = miss_kvs.kv4[i].value;
+	    }
+
+	  tun_sw_if_indices[bi] = GRE_TUNNEL_DB_VALUE_SW_IF_INDEX (value);
+
+	  /* a frame's misses are often for the same new tunnel */
+	  if (gre_input_cache_find (gc, key, is_ipv6) == ~0)
+	    gre_input_cache_add (gc, key, tun_sw_if_indices[bi], is_ipv6);
 	}
+    }
 
-      tun_sw_if_index[0] = cached_tun_sw_if_index;
-      if (PREDICT_FALSE (!matched[0]))
-	gre_tunnel_get (gm, node, b[0], &next[0], &key[0], &cached_key,
-			&tun_sw_if_index[0], &cached_tun_sw_if_index, is_ipv6);
+  /*
+   * Third pass; hand the packets to their tunnel interface. Consecutive
+   * packets of the same tunnel update its counters once.
+   */
+  vlib_combined_counter_acc_init (
+    &rx_acc,
+    &gm->vnet_main->interface_main
+       .combined_sw_if_counters[VNET_INTERFACE_COUNTER_RX],
+    vm->thread_index);
+
+  b = bufs;
+  next = nexts;
+  tun_sw_if_index = tun_sw_if_indices;
+  n_left_from = frame->n_vectors;
 
+  while (n_left_from > 0)
+    {
       if (PREDICT_TRUE (next[0] > GRE_INPUT_NEXT_DROP))
 	{
-	  vlib_increment_combined_counter (
-	    &gm->vnet_main->interface_main
-	       .combined_sw_if_counters[VNET_INTERFACE_COUNTER_RX],
-	    vm->thread_index, tun_sw_if_index[0], 1 /* packets */,
-	    len[0] /* bytes */);
+	  vlib_combined_counter_acc_add (
+	    &rx_acc, tun_sw_if_index[0], 1 /* packets */,
+	    vlib_buffer_length_in_chain (vm, b[0]) /* bytes */);
 	  vnet_buffer (b[0])->sw_if_index[VLIB_RX] = tun_sw_if_index[0];
+	  n_decap++;
 	}
 
       vnet_buffer (b[0])->sw_if_index[VLIB_TX] = (u32) ~0;
 
       if (PREDICT_FALSE (b[0]->flags & VLIB_BUFFER_IS_TRACED))
-	gre_trace (vm, node, b[0], tun_sw_if_index[0], ip6[0], ip4[0],
-		   is_ipv6);
+	gre_trace (vm, node, b[0], tun_sw_if_index[0], is_ipv6);
 
       b += 1;
       next += 1;
+      tun_sw_if_index += 1;
       n_left_from -= 1;
     }
 
+  vlib_combined_counter_acc_flush (&rx_acc);
+
   vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
 
   vlib_node_increment_counter (
     vm, is_ipv6 ? gre6_input_node.index : gre4_input_node.index,
-    GRE_ERROR_PKTS_DECAP, n_left_from);
+    GRE_ERROR_PKTS_DECAP, n_decap);
 
   return frame->n_vectors;
 }
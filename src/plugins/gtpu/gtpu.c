@@ -527,6 +527,32 @@ vnet_gtpu_add_del_forwarding (vnet_gtpu_add_mod_del_tunnel_args_t *a,
   return 0;
 }
 
+static void
+gtpu_teid_table_add (gtpu_main_t *gtm, u32 teid, u32 tunnel_index)
+{
+  uword *p;
+
+  if (teid >= vec_len (gtm->tunnel_index_by_teid))
+    return;
+
+  p = vec_elt_at_index (gtm->tunnel_index_by_teid, teid);
+  p[0] = p[0] == ~0 ? tunnel_index : GTPU_TEID_TABLE_SHARED;
+}
+
+static void
+gtpu_teid_table_del (gtpu_main_t *gtm, u32 teid, u32 tunnel_index)
+{
+  uword *p;
+
+  if (teid >= vec_len (gtm->tunnel_index_by_teid))
+    return;
+
+  /* a shared teid stays on the hash, which has all the keys anyway */
+  p = vec_elt_at_index (gtm->tunnel_index_by_teid, teid);
+  if (p[0] == tunnel_index)
+    p[0] = ~0;
+}
+
 int vnet_gtpu_add_mod_del_tunnel
   (vnet_gtpu_add_mod_del_tunnel_args_t * a, u32 * sw_if_indexp)
 {
@@ -590,6 +616,7 @@ int vnet_gtpu_add_mod_del_tunnel
 			    t - gtm->tunnels);
       else
 	hash_set (gtm->gtpu4_tunnel_by_key, key4.as_u64, t - gtm->tunnels);
+      gtpu_teid_table_add (gtm, t->teid, t - gtm->tunnels);
 
       vnet_hw_interface_t *hi;
       if (vec_len (gtm->free_gtpu_tunnel_hw_if_indices) > 0)
@@ -776,6 +803,7 @@ int vnet_gtpu_add_mod_del_tunnel
 	hash_unset (gtm->gtpu4_tunnel_by_key, key4.as_u64);
       else
 	hash_unset_mem_free (&gtm->gtpu6_tunnel_by_key, &key6);
+      gtpu_teid_table_del (gtm, t->teid, t - gtm->tunnels);
 
       if (!ip46_address_is_multicast (&t->dst))
 	{
@@ -1606,6 +1634,31 @@ gtpu_init (vlib_main_t * vm)
 
 VLIB_INIT_FUNCTION (gtpu_init);
 
+static clib_error_t *
+gtpu_config (vlib_main_t *vm, unformat_input_t *input)
+{
+  gtpu_main_t *gtm = &gtpu_main;
+  u32 teid_table_size = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "teid-table-size %u", &teid_table_size))
+	;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+
+  /* tunnels with a local teid below this are found without hashing */
+  if (teid_table_size)
+    vec_validate_init_empty (gtm->tunnel_index_by_teid, teid_table_size - 1,
+			     ~0);
+
+  return 0;
+}
+
+VLIB_CONFIG_FUNCTION (gtpu_config, "gtpu");
+
 VLIB_PLUGIN_REGISTER () = {
     .version = VPP_BUILD_VER,
     .description = "GPRS Tunnelling Protocol, User Data (GTPv1-U)",
@@ -277,6 +277,10 @@ typedef struct
   uword *gtpu4_tunnel_by_key;	/* keyed on ipv4.dst + teid */
   uword *gtpu6_tunnel_by_key;	/* keyed on ipv6.dst + teid */
 
+  /* optional direct indexed tunnel lookup by local teid (host order),
+   * sized by the teid-table-size startup option */
+  uword *tunnel_index_by_teid;
+
   /* local VTEP IPs ref count used by gtpu-bypass node to check if
      received gtpu packet DIP matches any local VTEP address */
   vtep_table_t vtep_table;
@@ -322,6 +326,60 @@ typedef struct
 
 extern gtpu_main_t gtpu_main;
 
+/* teid table entry of a teid used by more than one tunnel */
+#define GTPU_TEID_TABLE_SHARED ((uword) ~0 - 1)
+
+/*
+ * Tunnel lookup by decap key. Teids covered by the direct table are
+ * resolved there, only teids shared between tunnels go to the hash.
+ */
+static_always_inline uword *
+gtpu4_tunnel_get (gtpu_main_t *gtm, gtpu4_tunnel_key_t *key)
+{
+  u32 teid = clib_net_to_host_u32 (key->teid);
+
+  if (teid < vec_len (gtm->tunnel_index_by_teid))
+    {
+      uword *p = vec_elt_at_index (gtm->tunnel_index_by_teid, teid);
+      gtpu_tunnel_t *t;
+
+      if (p[0] == ~0)
+	return 0;
+      if (p[0] != GTPU_TEID_TABLE_SHARED)
+	{
+	  t = pool_elt_at_index (gtm->tunnels, p[0]);
+	  if (ip46_address_is_ip4 (&t->dst) && t->dst.ip4.as_u32 == key->src)
+	    return p;
+	  return 0;
+	}
+    }
+  return hash_get (gtm->gtpu4_tunnel_by_key, key->as_u64);
+}
+
+static_always_inline uword *
+gtpu6_tunnel_get (gtpu_main_t *gtm, gtpu6_tunnel_key_t *key)
+{
+  u32 teid = clib_net_to_host_u32 (key->teid);
+
+  if (teid < vec_len (gtm->tunnel_index_by_teid))
+    {
+      uword *p = vec_elt_at_index (gtm->tunnel_index_by_teid, teid);
+      gtpu_tunnel_t *t;
+
+      if (p[0] == ~0)
+	return 0;
+      if (p[0] != GTPU_TEID_TABLE_SHARED)
+	{
+	  t = pool_elt_at_index (gtm->tunnels, p[0]);
+	  if (!ip46_address_is_ip4 (&t->dst) &&
+	      ip6_address_is_equal (&t->dst.ip6, &key->src))
+	    return p;
+	  return 0;
+	}
+    }
+  return hash_get_mem (gtm->gtpu6_tunnel_by_key, key);
+}
+
 extern vlib_node_registration_t gtpu4_input_node;
 extern vlib_node_registration_t gtpu6_input_node;
 extern vlib_node_registration_t gtpu4_encap_node;
@@ -339,7 +339,7 @@ gtpu_input (vlib_main_t * vm,
 	     * in a given GTPU path */
 	    if (PREDICT_FALSE (key4_0.as_u64 != last_key4.as_u64))
 	      {
-		p0 = hash_get (gtm->gtpu4_tunnel_by_key, key4_0.as_u64);
+		p0 = gtpu4_tunnel_get (gtm, &key4_0);
 		if (PREDICT_FALSE (p0 == NULL))
 		  {
 		    error0 = GTPU_ERROR_NO_SUCH_TUNNEL;
@@ -380,7 +380,7 @@ gtpu_input (vlib_main_t * vm,
 		key4_0.src = ip4_0->dst_address.as_u32;
 		key4_0.teid = gtpu0->teid;
 		/* Make sure mcast GTPU tunnel exist by packet DIP and teid */
-		p0 = hash_get (gtm->gtpu4_tunnel_by_key, key4_0.as_u64);
+		p0 = gtpu4_tunnel_get (gtm, &key4_0);
 		if (PREDICT_TRUE (p0 != NULL))
 		  {
 		    mt0 = pool_elt_at_index (gtm->tunnels, p0[0]);
@@ -403,7 +403,7 @@ gtpu_input (vlib_main_t * vm,
  	     * SIP identify a GTPU path, and teid identify a tunnel in a given GTPU path */
             if (PREDICT_FALSE (memcmp(&key6_0, &last_key6, sizeof(last_key6)) != 0))
               {
-                p0 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_0);
+                p0 = gtpu6_tunnel_get (gtm, &key6_0);
                 if (PREDICT_FALSE (p0 == NULL))
                   {
                     error0 = GTPU_ERROR_NO_SUCH_TUNNEL;
@@ -443,7 +443,7 @@ gtpu_input (vlib_main_t * vm,
 		key6_0.src.as_u64[0] = ip6_0->dst_address.as_u64[0];
 		key6_0.src.as_u64[1] = ip6_0->dst_address.as_u64[1];
 		key6_0.teid = gtpu0->teid;
-		p0 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_0);
+		p0 = gtpu6_tunnel_get (gtm, &key6_0);
 		if (PREDICT_TRUE (p0 != NULL))
 		  {
 		    mt0 = pool_elt_at_index (gtm->tunnels, p0[0]);
@@ -626,7 +626,7 @@ gtpu_input (vlib_main_t * vm,
  	     * SIP identify a GTPU path, and teid identify a tunnel in a given GTPU path */
 	    if (PREDICT_FALSE (key4_1.as_u64 != last_key4.as_u64))
               {
-                p1 = hash_get (gtm->gtpu4_tunnel_by_key, key4_1.as_u64);
+                p1 = gtpu4_tunnel_get (gtm, &key4_1);
                 if (PREDICT_FALSE (p1 == NULL))
                   {
                     error1 = GTPU_ERROR_NO_SUCH_TUNNEL;
@@ -663,7 +663,7 @@ gtpu_input (vlib_main_t * vm,
 		key4_1.src = ip4_1->dst_address.as_u32;
 		key4_1.teid = gtpu1->teid;
 		/* Make sure mcast GTPU tunnel exist by packet DIP and teid */
-		p1 = hash_get (gtm->gtpu4_tunnel_by_key, key4_1.as_u64);
+		p1 = gtpu4_tunnel_get (gtm, &key4_1);
 		if (PREDICT_TRUE (p1 != NULL))
 		  {
 		    mt1 = pool_elt_at_index (gtm->tunnels, p1[0]);
@@ -686,7 +686,7 @@ gtpu_input (vlib_main_t * vm,
  	     * SIP identify a GTPU path, and teid identify a tunnel in a given GTPU path */
             if (PREDICT_FALSE (memcmp(&key6_1, &last_key6, sizeof(last_key6)) != 0))
               {
-                p1 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_1);
+                p1 = gtpu6_tunnel_get (gtm, &key6_1);
 
                 if (PREDICT_FALSE (p1 == NULL))
                   {
@@ -726,7 +726,7 @@ gtpu_input (vlib_main_t * vm,
 		key6_1.src.as_u64[0] = ip6_1->dst_address.as_u64[0];
 		key6_1.src.as_u64[1] = ip6_1->dst_address.as_u64[1];
 		key6_1.teid = gtpu1->teid;
-		p1 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_1);
+		p1 = gtpu6_tunnel_get (gtm, &key6_1);
 		if (PREDICT_TRUE (p1 != NULL))
 		  {
 		    mt1 = pool_elt_at_index (gtm->tunnels, p1[0]);
@@ -983,7 +983,7 @@ gtpu_input (vlib_main_t * vm,
 	      if (PREDICT_FALSE (key4_0.as_u64 != last_key4.as_u64))
 		{
 		  // Cache miss, so try normal lookup now.
-		  p0 = hash_get (gtm->gtpu4_tunnel_by_key, key4_0.as_u64);
+		  p0 = gtpu4_tunnel_get (gtm, &key4_0);
 		  if (PREDICT_FALSE (p0 == NULL))
 		    {
 		      error0 = GTPU_ERROR_NO_SUCH_TUNNEL;
@@ -1027,7 +1027,7 @@ gtpu_input (vlib_main_t * vm,
 		  key4_0.teid = gtpu0->teid;
 		  /* Make sure mcast GTPU tunnel exist by packet DIP and teid
 		   */
-		  p0 = hash_get (gtm->gtpu4_tunnel_by_key, key4_0.as_u64);
+		  p0 = gtpu4_tunnel_get (gtm, &key4_0);
 		  if (PREDICT_TRUE (p0 != NULL))
 		    {
 		      mt0 = pool_elt_at_index (gtm->tunnels, p0[0]);
@@ -1053,7 +1053,7 @@ gtpu_input (vlib_main_t * vm,
 	      if (PREDICT_FALSE (
 		    memcmp (&key6_0, &last_key6, sizeof (last_key6)) != 0))
 		{
-		  p0 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_0);
+		  p0 = gtpu6_tunnel_get (gtm, &key6_0);
 		  if (PREDICT_FALSE (p0 == NULL))
 		    {
 		      error0 = GTPU_ERROR_NO_SUCH_TUNNEL;
@@ -1091,7 +1091,7 @@ gtpu_input (vlib_main_t * vm,
 		key6_0.src.as_u64[0] = ip6_0->dst_address.as_u64[0];
 		key6_0.src.as_u64[1] = ip6_0->dst_address.as_u64[1];
 		key6_0.teid = gtpu0->teid;
-		p0 = hash_get_mem (gtm->gtpu6_tunnel_by_key, &key6_0);
+		p0 = gtpu6_tunnel_get (gtm, &key6_0);
 		if (PREDICT_TRUE (p0 != NULL))
 		  {
 		    mt0 = pool_elt_at_index (gtm->tunnels, p0[0]);
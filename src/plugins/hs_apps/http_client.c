@@ -18,13 +18,23 @@ typedef struct
   f64 elapsed_time;
 } hc_stats_t;
 
+#define HC_POOL_DEFAULT_IDLE_TIMEOUT 30
+#define HC_POOL_DEFAULT_MAX_IDLE     64
+#define HC_POOL_SWEEP_INTERVAL	     1.0
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   u32 session_index;
   clib_thread_index_t thread_index;
+  session_handle_t vpp_session_handle;
   u64 to_recv;
   u8 is_closed;
+  /* session is serving requests for the current run */
+  u8 in_run;
+  /* index of the connection pool the idle session is parked in, or ~0 */
+  u32 pool_index;
+  f64 idle_since;
   hc_stats_t stats;
   u64 data_offset;
   u8 *resp_headers;
@@ -32,9 +42,20 @@ typedef struct
   u8 *response_status;
 } hc_session_t;
 
+/* idle connections to one authority, most recently used last */
+typedef struct
+{
+  u8 *authority;
+  u32 *idle_sessions;
+} hc_pool_t;
+
 typedef struct
 {
   hc_session_t *sessions;
+  hc_pool_t *pools;
+  uword *pool_by_authority;
+  u32 n_idle;
+  u32 *reuse_sessions;
   clib_thread_index_t thread_index;
   vlib_main_t *vlib_main;
   u8 *headers_buf;
@@ -55,7 +76,9 @@ typedef struct
   u32 app_index;
   u32 cli_node_index;
   u8 attached;
+  u8 running;
   u8 *uri;
+  u8 *authority;
   session_endpoint_cfg_t connect_sep;
   u8 *target;
   u8 *data;
@@ -83,8 +106,18 @@ typedef struct
   clib_spinlock_t lock;
   bool was_transport_closed;
   u32 ckpair_index;
+  bool keep_alive;
+  f64 idle_timeout;
+  u32 max_idle;
+  u8 pool_process_started;
 } hc_main_t;
 
+typedef struct
+{
+  vnet_connect_args_t connect_args;
+  u32 n_sessions;
+} hc_connect_rpc_args_t;
+
 typedef enum
 {
   HC_CONNECT_FAILED = 1,
@@ -97,6 +130,9 @@ typedef enum
 static hc_main_t hc_main;
 static hc_stats_t hc_stats;
 
+static vlib_node_registration_t hc_pool_process_node;
+static void hc_connect (u32 n_sessions);
+
 static inline hc_worker_t *
 hc_worker_get (clib_thread_index_t thread_index)
 {
@@ -119,10 +155,120 @@ hc_session_alloc (hc_worker_t *wrk)
   pool_get_zero (wrk->sessions, s);
   s->session_index = s - wrk->sessions;
   s->thread_index = wrk->thread_index;
+  s->pool_index = ~0;
 
   return s;
 }
 
+static void
+hc_session_free (hc_worker_t *wrk, hc_session_t *hc_session)
+{
+  vec_free (hc_session->resp_headers);
+  vec_free (hc_session->http_response);
+  vec_free (hc_session->response_status);
+  pool_put (wrk->sessions, hc_session);
+}
+
+/*
+ * Park a session whose requests are done in its worker's connection pool
+ * for the run's authority. Returns 0 if that pool is full.
+ */
+static int
+hc_pool_put (hc_worker_t *wrk, hc_session_t *hc_session)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_pool_t *pool;
+  uword *p;
+
+  p = hash_get_mem (wrk->pool_by_authority, hcm->authority);
+  if (p)
+    pool = pool_elt_at_index (wrk->pools, p[0]);
+  else
+    {
+      pool_get_zero (wrk->pools, pool);
+      pool->authority = vec_dup (hcm->authority);
+      hash_set_mem (wrk->pool_by_authority, pool->authority,
+		    pool - wrk->pools);
+    }
+
+  if (vec_len (pool->idle_sessions) >= hcm->max_idle)
+    return 0;
+
+  vec_add1 (pool->idle_sessions, hc_session->session_index);
+  hc_session->pool_index = pool - wrk->pools;
+  hc_session->idle_since =
+    vlib_time_now (vlib_get_main_by_index (wrk->thread_index));
+  hc_session->in_run = 0;
+  wrk->n_idle++;
+
+  return 1;
+}
+
+static void
+hc_pool_remove (hc_worker_t *wrk, hc_session_t *hc_session)
+{
+  hc_pool_t *pool;
+  u32 i;
+
+  if (hc_session->pool_index == ~0)
+    return;
+
+  pool = pool_elt_at_index (wrk->pools, hc_session->pool_index);
+  i = vec_search (pool->idle_sessions, hc_session->session_index);
+  ASSERT (i != ~0);
+  vec_delete (pool->idle_sessions, 1, i);
+  hc_session->pool_index = ~0;
+  wrk->n_idle--;
+}
+
+/*
+ * Take up to n_sessions idle sessions to the run's authority out of the
+ * worker's pool, most recently used first. Called with the workers
+ * stopped.
+ */
+static u32
+hc_pool_take (hc_worker_t *wrk, u32 n_sessions)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_session_t *hc_session;
+  hc_pool_t *pool;
+  uword *p;
+  u32 n_taken = 0;
+
+  vec_reset_length (wrk->reuse_sessions);
+
+  p = hash_get_mem (wrk->pool_by_authority, hcm->authority);
+  if (!p)
+    return 0;
+
+  pool = pool_elt_at_index (wrk->pools, p[0]);
+  while (n_taken < n_sessions && vec_len (pool->idle_sessions))
+    {
+      hc_session =
+	pool_elt_at_index (wrk->sessions, vec_pop (pool->idle_sessions));
+      hc_session->pool_index = ~0;
+      hc_session->in_run = 1;
+      wrk->n_idle--;
+      vec_add1 (wrk->reuse_sessions, hc_session->session_index);
+      n_taken++;
+    }
+
+  return n_taken;
+}
+
+static u32
+hc_pool_n_idle (void)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_worker_t *wrk;
+  u32 n_idle = 0;
+
+  vec_foreach (wrk, hcm->wrk)
+    n_idle += wrk->n_idle;
+
+  return n_idle;
+}
+
 static int
 hc_request (session_t *s, hc_worker_t *wrk, hc_session_t *hc_session,
 	    session_error_t err)
@@ -188,32 +334,20 @@ done:
   return 0;
 }
 
+/*
+ * Start the run's requests on a new or a pooled session
+ */
 static int
-hc_session_connected_callback (u32 app_index, u32 hc_session_index,
-			       session_t *s, session_error_t err)
+hc_session_start (session_t *s, hc_worker_t *wrk, hc_session_t *hc_session)
 {
   hc_main_t *hcm = &hc_main;
-  hc_worker_t *wrk;
-  hc_session_t *hc_session;
   hc_http_header_t *header;
 
-  if (err)
-    {
-      clib_warning ("hc_session_index[%d] connected error: %U",
-		    hc_session_index, format_session_error, err);
-      vlib_process_signal_event_mt (vlib_get_main (), hcm->cli_node_index,
-				    HC_CONNECT_FAILED, 0);
-      return -1;
-    }
-
-  wrk = hc_worker_get (s->thread_index);
-  hc_session = hc_session_alloc (wrk);
   clib_spinlock_lock_if_init (&hcm->lock);
   hcm->connected_counter++;
   clib_spinlock_unlock_if_init (&hcm->lock);
 
-  hc_session->thread_index = s->thread_index;
-  s->opaque = hc_session->session_index;
+  hc_session->in_run = 1;
   wrk->session_index = hc_session->session_index;
 
   if (hcm->multi_session)
@@ -288,11 +422,68 @@ hc_session_connected_callback (u32 app_index, u32 hc_session_index,
   hc_session->stats.start =
     vlib_time_now (vlib_get_main_by_index (s->thread_index));
 
-  return hc_request (s, wrk, hc_session, err);
+  return hc_request (s, wrk, hc_session, 0);
+}
+
+static int
+hc_session_connected_callback (u32 app_index, u32 hc_session_index,
+			       session_t *s, session_error_t err)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_worker_t *wrk;
+  hc_session_t *hc_session;
+
+  if (err)
+    {
+      clib_warning ("hc_session_index[%d] connected error: %U",
+		    hc_session_index, format_session_error, err);
+      vlib_process_signal_event_mt (vlib_get_main (), hcm->cli_node_index,
+				    HC_CONNECT_FAILED, 0);
+      return -1;
+    }
+
+  wrk = hc_worker_get (s->thread_index);
+  hc_session = hc_session_alloc (wrk);
+  hc_session->thread_index = s->thread_index;
+  hc_session->vpp_session_handle = session_handle (s);
+  s->opaque = hc_session->session_index;
+
+  return hc_session_start (s, wrk, hc_session);
+}
+
+/*
+ * Restart a pooled session on its own thread. If the connection went
+ * away in the meantime a new one is opened in its place.
+ */
+static int
+hc_session_reuse_rpc (void *rpc_args)
+{
+  u32 hc_session_index = pointer_to_uword (rpc_args);
+  hc_worker_t *wrk = hc_worker_get (vlib_get_thread_index ());
+  hc_session_t *hc_session;
+  session_t *s;
+
+  hc_session = hc_session_get (hc_session_index, wrk->thread_index);
+  s = session_get_from_handle_if_valid (hc_session->vpp_session_handle);
+  if (!s || hc_session->is_closed)
+    {
+      hc_session->in_run = 0;
+      hc_connect (1);
+      return 0;
+    }
+
+  hc_session->to_recv = 0;
+  hc_session->data_offset = 0;
+  clib_memset (&hc_session->stats, 0, sizeof (hc_session->stats));
+  vec_reset_length (hc_session->resp_headers);
+  vec_reset_length (hc_session->http_response);
+  vec_free (hc_session->response_status);
+
+  return hc_session_start (s, wrk, hc_session);
 }
 
 static void
-hc_session_disconnect_callback (session_t *s)
+hc_session_disconnect (session_t *s)
 {
   hc_main_t *hcm = &hc_main;
   HTTP_DBG (1, "disconnecting");
@@ -303,16 +494,73 @@ hc_session_disconnect_callback (session_t *s)
   if ((rv = vnet_disconnect_session (a)))
     clib_warning ("warning: disconnect returned: %U", format_session_error,
 		  rv);
+}
+
+static void
+hc_session_disconnect_callback (session_t *s)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_session_t *hc_session = hc_session_get (s->opaque, s->thread_index);
+
+  hc_session_disconnect (s);
+
+  /* idle pooled sessions are not part of the run */
+  if (!hc_session->in_run || hcm->keep_alive)
+    return;
+
   clib_spinlock_lock_if_init (&hcm->lock);
   hcm->done_count++;
   clib_spinlock_unlock_if_init (&hcm->lock);
 }
 
+/*
+ * The session's requests are done; either return it to the pool or close it
+ */
+static void
+hc_session_done (session_t *s, hc_worker_t *wrk, hc_session_t *hc_session)
+{
+  hc_main_t *hcm = &hc_main;
+
+  if (!hcm->keep_alive)
+    {
+      hc_session_disconnect_callback (s);
+      return;
+    }
+
+  if (!hc_pool_put (wrk, hc_session))
+    {
+      hc_session->in_run = 0;
+      hc_session_disconnect (s);
+    }
+
+  clib_spinlock_lock_if_init (&hcm->lock);
+  if (++hcm->done_count >= hcm->max_sessions && hcm->repeat)
+    vlib_process_signal_event_mt (wrk->vlib_main, hcm->cli_node_index,
+				  HC_REPEAT_DONE, 0);
+  clib_spinlock_unlock_if_init (&hcm->lock);
+}
+
 static void
 hc_session_transport_closed_callback (session_t *s)
 {
   hc_main_t *hcm = &hc_main;
   hc_worker_t *wrk = hc_worker_get (s->thread_index);
+  hc_session_t *hc_session = hc_session_get (s->opaque, s->thread_index);
+
+  hc_session->is_closed = 1;
+  if (!hc_session->in_run)
+    {
+      hc_pool_remove (wrk, hc_session);
+      return;
+    }
+
+  /* with keep-alive, sessions only close mid-run if the peer closes them */
+  if (hcm->keep_alive)
+    {
+      vlib_process_signal_event_mt (wrk->vlib_main, hcm->cli_node_index,
+				    HC_TRANSPORT_CLOSED, 0);
+      return;
+    }
 
   clib_spinlock_lock_if_init (&hcm->lock);
   if (s->session_state == SESSION_STATE_TRANSPORT_CLOSED)
@@ -347,6 +595,8 @@ hc_session_reset_callback (session_t *s)
 
   hc_session = hc_session_get (s->opaque, s->thread_index);
   hc_session->is_closed = 1;
+  if (!hc_session->in_run)
+    hc_pool_remove (hc_worker_get (s->thread_index), hc_session);
 
   a->handle = session_handle (s);
   a->app_index = hcm->app_index;
@@ -373,6 +623,13 @@ hc_rx_callback (session_t *s)
       return -1;
     }
 
+  /* nothing is expected on idle pooled sessions */
+  if (PREDICT_FALSE (!hc_session->in_run))
+    {
+      svm_fifo_dequeue_drop_all (s->rx_fifo);
+      return 0;
+    }
+
   max_deq = svm_fifo_max_dequeue_cons (s->rx_fifo);
   if (PREDICT_FALSE (max_deq == 0))
     goto done;
@@ -461,7 +718,7 @@ done:
 	  if (hc_session->stats.elapsed_time >= hcm->duration &&
 	      hc_session->stats.request_count >= hc_session->stats.req_per_wrk)
 	    {
-	      hc_session_disconnect_callback (s);
+	      hc_session_done (s, wrk, hc_session);
 	    }
 	  else
 	    {
@@ -472,9 +729,10 @@ done:
 	}
       else
 	{
+	  /* park the session before the cli decides the pool's fate */
+	  hc_session_done (s, wrk, hc_session);
 	  vlib_process_signal_event_mt (wrk->vlib_main, hcm->cli_node_index,
 					HC_REPLY_RECEIVED, 0);
-	  hc_session_disconnect_callback (s);
 	}
     }
   return 0;
@@ -576,11 +834,11 @@ hc_attach ()
 static int
 hc_connect_rpc (void *rpc_args)
 {
-  vnet_connect_args_t *a = rpc_args;
+  hc_connect_rpc_args_t *args = rpc_args;
+  vnet_connect_args_t *a = &args->connect_args;
   int rv = ~0;
-  hc_main_t *hcm = &hc_main;
 
-  for (u32 i = 0; i < hcm->max_sessions; i++)
+  for (u32 i = 0; i < args->n_sessions; i++)
     {
       rv = vnet_connect (a);
       if (rv > 0)
@@ -588,20 +846,24 @@ hc_connect_rpc (void *rpc_args)
     }
 
   session_endpoint_free_ext_cfgs (&a->sep_ext);
-  vec_free (a);
+  clib_mem_free (args);
 
   return rv;
 }
 
 static void
-hc_connect ()
+hc_connect (u32 n_sessions)
 {
   hc_main_t *hcm = &hc_main;
-  vnet_connect_args_t *a = 0;
+  hc_connect_rpc_args_t *args;
+  vnet_connect_args_t *a;
   transport_endpt_ext_cfg_t *ext_cfg;
   transport_endpt_cfg_http_t http_cfg = { (u32) hcm->timeout, 0 };
-  vec_validate (a, 0);
-  clib_memset (a, 0, sizeof (a[0]));
+
+  args = clib_mem_alloc (sizeof (*args));
+  clib_memset (args, 0, sizeof (*args));
+  args->n_sessions = n_sessions;
+  a = &args->connect_args;
   clib_memcpy (&a->sep_ext, &hcm->connect_sep, sizeof (hcm->connect_sep));
   a->app_index = hcm->app_index;
 
@@ -618,7 +880,7 @@ hc_connect ()
     }
 
   session_send_rpc_evt_to_thread_force (transport_cl_thread (), hc_connect_rpc,
-					a);
+					args);
 }
 
 static void
@@ -632,15 +894,13 @@ hc_get_repeat_stats (vlib_main_t *vm)
       hc_session_t *hc_session;
       vec_foreach (wrk, hcm->wrk)
 	{
-	  vec_foreach (hc_session, wrk->sessions)
+	  pool_foreach (hc_session, wrk->sessions)
 	    {
 	      hc_stats.request_count += hc_session->stats.request_count;
 	      hc_session->stats.request_count = 0;
 	      if (hc_stats.elapsed_time < hc_session->stats.elapsed_time)
-		{
-		  hc_stats.elapsed_time = hc_session->stats.elapsed_time;
-		  hc_session->stats.elapsed_time = 0;
-		}
+		hc_stats.elapsed_time = hc_session->stats.elapsed_time;
+	      hc_session->stats.elapsed_time = 0;
 	    }
 	}
 
@@ -739,33 +999,116 @@ static clib_error_t *
 hc_run (vlib_main_t *vm)
 {
   hc_main_t *hcm = &hc_main;
-  u32 num_threads;
+  hc_session_t *hc_session;
+  u32 num_threads, *session_index, n_reused = 0;
+  u32 *closed_sessions = 0;
   hc_worker_t *wrk;
   clib_error_t *err;
 
-  num_threads = 1 /* main thread */ + vlib_num_workers ();
-  if (vlib_num_workers ())
-    clib_spinlock_init (&hcm->lock);
-  vec_validate (hcm->wrk, num_threads - 1);
+  /* workers, their sessions and the app outlive a run while the
+   * connection pool holds sessions */
+  if (!hcm->wrk)
+    {
+      num_threads = 1 /* main thread */ + vlib_num_workers ();
+      if (vlib_num_workers ())
+	clib_spinlock_init (&hcm->lock);
+      vec_validate (hcm->wrk, num_threads - 1);
+      vec_foreach (wrk, hcm->wrk)
+	{
+	  wrk->thread_index = wrk - hcm->wrk;
+	  wrk->pool_by_authority = hash_create_vec (0, sizeof (u8),
+						    sizeof (uword));
+	  /* 4k for headers should be enough */
+	  vec_validate (wrk->headers_buf, 4095);
+	}
+    }
+
+  if (!hcm->attached && (err = hc_attach ()))
+    return clib_error_return (0, "http client attach: %U", format_clib_error,
+			      err);
+
+  vlib_worker_thread_barrier_sync (vm);
   vec_foreach (wrk, hcm->wrk)
     {
       wrk->has_common_headers = false;
-      wrk->thread_index = wrk - hcm->wrk;
-      /* 4k for headers should be enough */
-      vec_validate (wrk->headers_buf, 4095);
       http_init_headers_ctx (&wrk->req_headers, wrk->headers_buf,
 			     vec_len (wrk->headers_buf));
+
+      /* drop what is left of the previous runs' closed sessions */
+      vec_reset_length (closed_sessions);
+      pool_foreach (hc_session, wrk->sessions)
+	{
+	  if (hc_session->is_closed && hc_session->pool_index == ~0)
+	    vec_add1 (closed_sessions, hc_session->session_index);
+	  else
+	    clib_memset (&hc_session->stats, 0, sizeof (hc_session->stats));
+	}
+      vec_foreach (session_index, closed_sessions)
+	hc_session_free (wrk, pool_elt_at_index (wrk->sessions,
+						 session_index[0]));
+
+      n_reused += hc_pool_take (wrk, hcm->max_sessions - n_reused);
     }
+  vlib_worker_thread_barrier_release (vm);
+  vec_free (closed_sessions);
 
-  if ((err = hc_attach ()))
-    return clib_error_return (0, "http client attach: %U", format_clib_error,
-			      err);
+  vec_foreach (wrk, hcm->wrk)
+    vec_foreach (session_index, wrk->reuse_sessions)
+      session_send_rpc_evt_to_thread_force (
+	wrk->thread_index, hc_session_reuse_rpc,
+	uword_to_pointer (session_index[0], void *));
+
+  if (hcm->verbose && n_reused)
+    vlib_cli_output (vm, "* reusing %u pooled connection(s)", n_reused);
 
-  hc_connect ();
+  if (n_reused < hcm->max_sessions)
+    hc_connect (hcm->max_sessions - n_reused);
 
   return hc_get_event (vm);
 }
 
+/*
+ * Close the sessions that have sat in the pool for longer than the idle
+ * timeout. Runs on the sessions' thread.
+ */
+static int
+hc_pool_sweep_rpc (void *rpc_args)
+{
+  hc_main_t *hcm = &hc_main;
+  clib_thread_index_t thread_index = vlib_get_thread_index ();
+  hc_session_t *hc_session;
+  hc_worker_t *wrk;
+  hc_pool_t *pool;
+  session_t *s;
+  f64 now;
+  u32 i;
+
+  if (thread_index >= vec_len (hcm->wrk))
+    return 0;
+
+  wrk = hc_worker_get (thread_index);
+  now = vlib_time_now (vlib_get_main_by_index (thread_index));
+
+  pool_foreach (pool, wrk->pools)
+    {
+      /* oldest first */
+      for (i = 0; i < vec_len (pool->idle_sessions);)
+	{
+	  hc_session =
+	    pool_elt_at_index (wrk->sessions, pool->idle_sessions[i]);
+	  if (now - hc_session->idle_since < hcm->idle_timeout)
+	    break;
+
+	  hc_pool_remove (wrk, hc_session);
+	  s = session_get_from_handle_if_valid (hc_session->vpp_session_handle);
+	  if (s)
+	    hc_session_disconnect (s);
+	}
+    }
+
+  return 0;
+}
+
 static int
 hc_detach ()
 {
@@ -789,16 +1132,25 @@ static void
 hc_worker_cleanup (hc_worker_t *wrk)
 {
   hc_session_t *hc_session;
+  hc_pool_t *pool;
   HTTP_DBG (1, "worker and worker sessions cleanup");
 
   vec_free (wrk->headers_buf);
-  vec_foreach (hc_session, wrk->sessions)
+  vec_free (wrk->reuse_sessions);
+  pool_foreach (hc_session, wrk->sessions)
     {
       vec_free (hc_session->resp_headers);
       vec_free (hc_session->http_response);
       vec_free (hc_session->response_status);
     }
   pool_free (wrk->sessions);
+  pool_foreach (pool, wrk->pools)
+    {
+      vec_free (pool->authority);
+      vec_free (pool->idle_sessions);
+    }
+  pool_free (wrk->pools);
+  hash_free (wrk->pool_by_authority);
 }
 
 static void
@@ -806,16 +1158,12 @@ hc_cleanup ()
 {
   HTTP_DBG (1, "cleanup");
   hc_main_t *hcm = &hc_main;
-  hc_worker_t *wrk;
   hc_http_header_t *header;
 
-  vec_foreach (wrk, hcm->wrk)
-    hc_worker_cleanup (wrk);
-
   vec_free (hcm->uri);
+  vec_free (hcm->authority);
   vec_free (hcm->target);
   vec_free (hcm->data);
-  vec_free (hcm->wrk);
   vec_free (hcm->filename);
   vec_free (hcm->appns_id);
   vec_foreach (header, hcm->custom_header)
@@ -826,6 +1174,69 @@ hc_cleanup ()
   vec_free (hcm->custom_header);
 }
 
+/*
+ * Close all pooled connections and release the app and worker state
+ */
+static int
+hc_pool_teardown (vlib_main_t *vm)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_worker_t *wrk;
+  int rv;
+
+  rv = hc_detach ();
+
+  vlib_worker_thread_barrier_sync (vm);
+  vec_foreach (wrk, hcm->wrk)
+    hc_worker_cleanup (wrk);
+  vec_free (hcm->wrk);
+  clib_spinlock_free (&hcm->lock);
+  vlib_worker_thread_barrier_release (vm);
+
+  return rv;
+}
+
+static uword
+hc_pool_process (vlib_main_t *vm, vlib_node_runtime_t *rt, vlib_frame_t *f)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_worker_t *wrk;
+
+  while (1)
+    {
+      if (hc_pool_n_idle ())
+	vlib_process_wait_for_event_or_clock (vm, HC_POOL_SWEEP_INTERVAL);
+      else
+	vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, 0);
+
+      if (hcm->running)
+	continue;
+
+      /* once the pool drains the app is released until the next run */
+      if (!hc_pool_n_idle ())
+	{
+	  if (hcm->attached)
+	    hc_pool_teardown (vm);
+	  continue;
+	}
+
+      vec_foreach (wrk, hcm->wrk)
+	if (wrk->n_idle)
+	  session_send_rpc_evt_to_thread_force (wrk->thread_index,
+						hc_pool_sweep_rpc, 0);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (hc_pool_process_node, static) = {
+  .function = hc_pool_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "http-client-pool-process",
+  .state = VLIB_NODE_STATE_DISABLED,
+};
+
 static clib_error_t *
 hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	       vlib_cli_command_t *cmd)
@@ -841,6 +1252,10 @@ hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
   u8 *name;
   u8 *value;
   int rv;
+
+  if (hcm->running)
+    return clib_error_return (0, "failed: already running!");
+
   hcm->timeout = 10;
   hcm->repeat_count = 0;
   hcm->duration = 0;
@@ -853,12 +1268,12 @@ hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
   hcm->private_segment_size = 0;
   hcm->fifo_size = 0;
   hcm->was_transport_closed = false;
+  hcm->keep_alive = false;
+  hcm->idle_timeout = HC_POOL_DEFAULT_IDLE_TIMEOUT;
+  hcm->max_idle = HC_POOL_DEFAULT_MAX_IDLE;
   hc_stats.request_count = 0;
   hc_stats.elapsed_time = 0;
 
-  if (hcm->attached)
-    return clib_error_return (0, "failed: already running!");
-
   /* Get a line of input. */
   if (!unformat_user (input, unformat_line_input, line_input))
     return clib_error_return (0, "expected required arguments");
@@ -927,6 +1342,12 @@ hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	;
       else if (unformat (line_input, "secret %lu", &hcm->appns_secret))
 	;
+      else if (unformat (line_input, "keep-alive"))
+	hcm->keep_alive = true;
+      else if (unformat (line_input, "idle-timeout %f", &hcm->idle_timeout))
+	;
+      else if (unformat (line_input, "max-idle %u", &hcm->max_idle))
+	;
 
       else
 	{
@@ -992,6 +1413,15 @@ hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
     }
   hcm->appns_id = appns_id;
 
+  /* pooled connections are keyed by the authority they were opened to */
+  hcm->authority =
+    format (0, "%U %U:%u%s", format_transport_proto_short,
+	    hcm->connect_sep.transport_proto, format_ip46_address,
+	    &hcm->connect_sep.ip, hcm->connect_sep.is_ip4,
+	    clib_net_to_host_u16 (hcm->connect_sep.port),
+	    (hcm->connect_sep.flags & SESSION_ENDPT_CFG_F_SECURE) ? " secure" :
+								     "");
+
   if (hcm->repeat)
     vlib_cli_output (vm, "* Running, please wait...");
 
@@ -1003,9 +1433,24 @@ hc_command_fn (vlib_main_t *vm, unformat_input_t *input,
   vlib_worker_thread_barrier_release (vm);
 
   hcm->cli_node_index = vlib_get_current_process (vm)->node_runtime.node_index;
+  hcm->running = 1;
   err = hc_run (vm);
+  hcm->running = 0;
 
-  if ((rv = hc_detach ()))
+  /* keep the app and the workers around while connections are pooled */
+  if (!err && hc_pool_n_idle ())
+    {
+      if (!hcm->pool_process_started)
+	{
+	  vlib_node_t *n = vlib_get_node (vm, hc_pool_process_node.index);
+	  vlib_node_set_state (vm, hc_pool_process_node.index,
+			       VLIB_NODE_STATE_POLLING);
+	  vlib_start_process (vm, n->runtime_index);
+	  hcm->pool_process_started = 1;
+	}
+      vlib_process_signal_event (vm, hc_pool_process_node.index, 0, 0);
+    }
+  else if ((rv = hc_pool_teardown (vm)))
     {
       /* don't override last error */
       if (!err)
@@ -1031,11 +1476,83 @@ VLIB_CLI_COMMAND (hc_command, static) = {
     "[save-to <filename>] [header <Key:Value>] [verbose] "
     "[timeout <seconds> (default = 10)] [repeat <count> | duration <seconds>] "
     "[sessions <# of sessions>] [appns <app-ns> secret <appns-secret>] "
-    "[fifo-size <nM|G>] [private-segment-size <nM|G>] [prealloc-fifos <n>]",
+    "[fifo-size <nM|G>] [private-segment-size <nM|G>] [prealloc-fifos <n>] "
+    "[keep-alive [idle-timeout <seconds> (default = 30)] "
+    "[max-idle <n> (default = 64)]]",
   .function = hc_command_fn,
   .is_mp_safe = 1,
 };
 
+static clib_error_t *
+hc_pool_show_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			 vlib_cli_command_t *cmd)
+{
+  hc_main_t *hcm = &hc_main;
+  hc_session_t *hc_session;
+  hc_worker_t *wrk;
+  hc_pool_t *pool;
+  f64 now = vlib_time_now (vm);
+  u32 *session_index;
+
+  if (!hc_pool_n_idle ())
+    {
+      vlib_cli_output (vm, "no pooled connections");
+      return 0;
+    }
+
+  vlib_worker_thread_barrier_sync (vm);
+  vec_foreach (wrk, hcm->wrk)
+    pool_foreach (pool, wrk->pools)
+      {
+	if (!vec_len (pool->idle_sessions))
+	  continue;
+	vlib_cli_output (vm, "[%u] %v: %u idle", wrk->thread_index,
+			 pool->authority, vec_len (pool->idle_sessions));
+	vec_foreach (session_index, pool->idle_sessions)
+	  {
+	    hc_session = pool_elt_at_index (wrk->sessions, session_index[0]);
+	    vlib_cli_output (vm, "  session 0x%lx idle %.1fs",
+			     hc_session->vpp_session_handle,
+			     now - hc_session->idle_since);
+	  }
+      }
+  vlib_worker_thread_barrier_release (vm);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (hc_pool_show_command, static) = {
+  .path = "show http client pool",
+  .short_help = "show http client pool",
+  .function = hc_pool_show_command_fn,
+};
+
+static clib_error_t *
+hc_pool_clear_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			  vlib_cli_command_t *cmd)
+{
+  hc_main_t *hcm = &hc_main;
+  int rv;
+
+  if (hcm->running)
+    return clib_error_return (0, "failed: http client is running");
+
+  if (!hcm->attached)
+    return 0;
+
+  if ((rv = hc_pool_teardown (vm)))
+    return clib_error_return (0, "detach returned: %U", format_session_error,
+			      rv);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (hc_pool_clear_command, static) = {
+  .path = "clear http client pool",
+  .short_help = "clear http client pool",
+  .function = hc_pool_clear_command_fn,
+};
+
 static clib_error_t *
 hc_main_init ()
 {
@@ -0,0 +1,326 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+/*
+ * Throughput over a local tcp connection, with the transfer driven either
+ * by vppcom submission/completion rings (default) or by one nonblocking
+ * read/write call per op (-S), for comparison.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <time.h>
+#include <string.h>
+#include <vcl/vppcom.h>
+#include <hs_apps/vcl/vcl_test.h>
+
+#define VT_RING_OP_SHIFT 32
+
+typedef struct vt_ring_main_
+{
+  uint64_t n_bytes;
+  uint32_t buf_len;
+  uint32_t queue_depth;
+  uint16_t port;
+  uint8_t sync;
+  int listener;
+  int client;
+  int server;
+  char *tx_buf;
+  char **rx_bufs;
+} vt_ring_main_t;
+
+static vt_ring_main_t vt_ring_main;
+
+static double
+vt_ring_time_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void
+vt_ring_parse_args (vt_ring_main_t *vrm, int argc, char **argv)
+{
+  int c;
+
+  memset (vrm, 0, sizeof (*vrm));
+  vrm->n_bytes = 1 << 30;
+  vrm->buf_len = 8192;
+  vrm->queue_depth = 32;
+  vrm->port = VCL_TEST_SERVER_PORT;
+
+  opterr = 0;
+  while ((c = getopt (argc, argv, "b:l:q:p:S")) != -1)
+    switch (c)
+      {
+      case 'b':
+	vrm->n_bytes = strtoull (optarg, 0, 0);
+	break;
+      case 'l':
+	vrm->buf_len = strtoul (optarg, 0, 0);
+	break;
+      case 'q':
+	vrm->queue_depth = strtoul (optarg, 0, 0);
+	break;
+      case 'p':
+	vrm->port = strtoul (optarg, 0, 0);
+	break;
+      case 'S':
+	vrm->sync = 1;
+	break;
+      default:
+	vtwrn ("usage: %s [-b bytes] [-l buf-len] [-q queue-depth] "
+	       "[-p port] [-S]",
+	       argv[0]);
+	exit (1);
+      }
+
+  if (!vrm->buf_len || !vrm->queue_depth || !vrm->n_bytes)
+    {
+      vtwrn ("bytes, buf-len and queue-depth must be non-zero");
+      exit (1);
+    }
+}
+
+/* Connect to ourselves over a local listener */
+static void
+vt_ring_connect (vt_ring_main_t *vrm)
+{
+  struct in_addr addr;
+  uint32_t flags, flen;
+  vppcom_endpt_t ep;
+  int rv;
+
+  inet_pton (AF_INET, VCL_TEST_LOCALHOST_IPADDR, &addr);
+  memset (&ep, 0, sizeof (ep));
+  ep.is_ip4 = 1;
+  ep.ip = (uint8_t *) &addr;
+  ep.port = htons (vrm->port);
+
+  vrm->listener = vppcom_session_create (VPPCOM_PROTO_TCP, 0);
+  if (vrm->listener < 0)
+    vtfail ("vppcom_session_create()", vrm->listener);
+  rv = vppcom_session_bind (vrm->listener, &ep);
+  if (rv < 0)
+    vtfail ("vppcom_session_bind()", rv);
+  rv = vppcom_session_listen (vrm->listener, 10);
+  if (rv < 0)
+    vtfail ("vppcom_session_listen()", rv);
+
+  vrm->client = vppcom_session_create (VPPCOM_PROTO_TCP, 0);
+  if (vrm->client < 0)
+    vtfail ("vppcom_session_create()", vrm->client);
+  rv = vppcom_session_connect (vrm->client, &ep);
+  if (rv < 0)
+    vtfail ("vppcom_session_connect()", rv);
+
+  vrm->server = vppcom_session_accept (vrm->listener, 0, O_NONBLOCK);
+  if (vrm->server < 0)
+    vtfail ("vppcom_session_accept()", vrm->server);
+
+  flags = O_NONBLOCK;
+  flen = sizeof (flags);
+  rv = vppcom_session_attr (vrm->client, VPPCOM_ATTR_SET_FLAGS, &flags,
+			    &flen);
+  if (rv < 0)
+    vtfail ("vppcom_session_attr()", rv);
+}
+
+static void
+vt_ring_run_sync (vt_ring_main_t *vrm)
+{
+  uint64_t n_sent = 0, n_rcvd = 0;
+  struct epoll_event ev, evts[2];
+  int vep, rv, wrv;
+  uint32_t len;
+
+  /* Only used to drain the mq when neither side can make progress */
+  vep = vppcom_epoll_create ();
+  if (vep < 0)
+    vtfail ("vppcom_epoll_create()", vep);
+  memset (&ev, 0, sizeof (ev));
+  ev.events = EPOLLIN;
+  rv = vppcom_epoll_ctl (vep, EPOLL_CTL_ADD, vrm->server, &ev);
+  if (rv < 0)
+    vtfail ("vppcom_epoll_ctl()", rv);
+
+  while (n_rcvd < vrm->n_bytes)
+    {
+      wrv = VPPCOM_EAGAIN;
+      if (n_sent < vrm->n_bytes)
+	{
+	  len = clib_min (vrm->buf_len, vrm->n_bytes - n_sent);
+	  wrv = vppcom_session_write (vrm->client, vrm->tx_buf, len);
+	  if (wrv > 0)
+	    n_sent += wrv;
+	  else if (wrv != VPPCOM_EAGAIN)
+	    vtfail ("vppcom_session_write()", wrv);
+	}
+
+      rv = vppcom_session_read (vrm->server, vrm->rx_bufs[0], vrm->buf_len);
+      if (rv > 0)
+	n_rcvd += rv;
+      else if (rv != VPPCOM_EAGAIN)
+	vtfail ("vppcom_session_read()", rv ? rv : VPPCOM_ECONNRESET);
+
+      if (rv == VPPCOM_EAGAIN && wrv == VPPCOM_EAGAIN)
+	vppcom_epoll_wait (vep, evts, 2, 0);
+    }
+
+  vppcom_session_close (vep);
+}
+
+static vppcom_ring_sqe_t *
+vt_ring_get_sqe (vppcom_ring_t *r)
+{
+  vppcom_ring_sqe_t *sqe = vppcom_ring_get_sqe (r);
+
+  if (!sqe)
+    {
+      vtwrn ("ring full");
+      exit (1);
+    }
+  return sqe;
+}
+
+static void
+vt_ring_post_write (vt_ring_main_t *vrm, vppcom_ring_t *r, uint32_t len)
+{
+  vppcom_ring_sqe_t *sqe = vt_ring_get_sqe (r);
+
+  sqe->op = VPPCOM_RING_OP_WRITE;
+  sqe->session_handle = vrm->client;
+  sqe->buf = vrm->tx_buf;
+  sqe->len = len;
+  sqe->user_data = (uint64_t) VPPCOM_RING_OP_WRITE << VT_RING_OP_SHIFT | len;
+}
+
+static void
+vt_ring_post_read (vt_ring_main_t *vrm, vppcom_ring_t *r, uint32_t slot)
+{
+  vppcom_ring_sqe_t *sqe = vt_ring_get_sqe (r);
+
+  sqe->op = VPPCOM_RING_OP_READ;
+  sqe->session_handle = vrm->server;
+  sqe->buf = vrm->rx_bufs[slot];
+  sqe->len = vrm->buf_len;
+  sqe->user_data = (uint64_t) VPPCOM_RING_OP_READ << VT_RING_OP_SHIFT | slot;
+}
+
+static void
+vt_ring_run_rings (vt_ring_main_t *vrm)
+{
+  uint64_t n_queued = 0, n_rcvd = 0;
+  vppcom_ring_cqe_t *cqes;
+  uint32_t i, len, arg;
+  vppcom_ring_t *r;
+  int n_cqes;
+
+  /* Room for a full queue of reads and of writes */
+  r = vppcom_ring_create (2 * vrm->queue_depth);
+  if (!r)
+    vtfail ("vppcom_ring_create()", VPPCOM_ENOMEM);
+  cqes = calloc (2 * vrm->queue_depth, sizeof (*cqes));
+
+  for (i = 0; i < vrm->queue_depth; i++)
+    {
+      vt_ring_post_read (vrm, r, i);
+      if (n_queued < vrm->n_bytes)
+	{
+	  len = clib_min (vrm->buf_len, vrm->n_bytes - n_queued);
+	  vt_ring_post_write (vrm, r, len);
+	  n_queued += len;
+	}
+    }
+
+  while (n_rcvd < vrm->n_bytes)
+    {
+      n_cqes = vppcom_ring_wait (r, 1, 1.0);
+      if (n_cqes < 0)
+	vtfail ("vppcom_ring_wait()", n_cqes);
+      if (!n_cqes)
+	{
+	  vtwrn ("timed out waiting for completions");
+	  exit (1);
+	}
+
+      n_cqes = vppcom_ring_reap (r, cqes, 2 * vrm->queue_depth);
+      for (i = 0; i < n_cqes; i++)
+	{
+	  arg = (uint32_t) cqes[i].user_data;
+	  if (cqes[i].result <= 0)
+	    vtfail ("ring op", cqes[i].result ? cqes[i].result :
+						VPPCOM_ECONNRESET);
+
+	  if (cqes[i].user_data >> VT_RING_OP_SHIFT == VPPCOM_RING_OP_READ)
+	    {
+	      n_rcvd += cqes[i].result;
+	      vt_ring_post_read (vrm, r, arg);
+	      continue;
+	    }
+
+	  /* Short write, queue the rest again */
+	  n_queued -= arg - cqes[i].result;
+	  if (n_queued < vrm->n_bytes)
+	    {
+	      len = clib_min (vrm->buf_len, vrm->n_bytes - n_queued);
+	      vt_ring_post_write (vrm, r, len);
+	      n_queued += len;
+	    }
+	}
+    }
+
+  free (cqes);
+  vppcom_ring_free (r);
+}
+
+int
+main (int argc, char **argv)
+{
+  vt_ring_main_t *vrm = &vt_ring_main;
+  double start, duration;
+  uint32_t i;
+  int rv;
+
+  vt_ring_parse_args (vrm, argc, argv);
+
+  rv = vppcom_app_create ("vcl_test_ring");
+  if (rv)
+    vtfail ("vppcom_app_create()", rv);
+
+  vrm->tx_buf = calloc (1, vrm->buf_len);
+  vrm->rx_bufs = calloc (vrm->queue_depth, sizeof (char *));
+  for (i = 0; i < vrm->queue_depth; i++)
+    vrm->rx_bufs[i] = malloc (vrm->buf_len);
+
+  vt_ring_connect (vrm);
+
+  start = vt_ring_time_now ();
+  if (vrm->sync)
+    vt_ring_run_sync (vrm);
+  else
+    vt_ring_run_rings (vrm);
+  duration = vt_ring_time_now () - start;
+
+  vtinf ("%s: %llu bytes in %.3f s, %.2f Gbps",
+	 vrm->sync ? "sync" : "rings", (unsigned long long) vrm->n_bytes,
+	 duration,
+	 vrm->n_bytes * 8 / duration / 1e9);
+
+  vppcom_session_close (vrm->client);
+  vppcom_session_close (vrm->server);
+  vppcom_session_close (vrm->listener);
+  for (i = 0; i < vrm->queue_depth; i++)
+    free (vrm->rx_bufs[i]);
+  free (vrm->rx_bufs);
+  free (vrm->tx_buf);
+  vppcom_app_destroy ();
+
+  return 0;
+}
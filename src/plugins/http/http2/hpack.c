@@ -142,6 +142,57 @@ hpack_decode_int (u8 **src, u8 *end, u8 prefix_len)
   return HPACK_INVALID_INT;
 }
 
+/* multi-symbol decode table, indexed by next 12 bits of input, every entry
+ * holds up to two symbols with codes fitting in the window */
+#define HPACK_HUFFMAN_MULTI_BITS 12
+
+typedef struct
+{
+  u8 symbols[2];
+  u8 n_symbols;
+  u8 code_len;
+} hpack_huffman_multi_code_t;
+
+static hpack_huffman_multi_code_t
+  huff_code_table_multi[1 << HPACK_HUFFMAN_MULTI_BITS];
+
+static void __clib_constructor
+hpack_huffman_multi_table_init (void)
+{
+  hpack_huffman_multi_code_t *e;
+  u32 s1, s2, l1, l2, prefix1, prefix2, i;
+
+  for (s1 = 0; s1 < 256; s1++)
+    {
+      l1 = huff_sym_table[s1].code_len;
+      if (l1 > HPACK_HUFFMAN_MULTI_BITS)
+	continue;
+      prefix1 = huff_sym_table[s1].code << (HPACK_HUFFMAN_MULTI_BITS - l1);
+      for (i = 0; i < 1 << (HPACK_HUFFMAN_MULTI_BITS - l1); i++)
+	{
+	  e = &huff_code_table_multi[prefix1 + i];
+	  e->symbols[0] = s1;
+	  e->n_symbols = 1;
+	  e->code_len = l1;
+	}
+      for (s2 = 0; s2 < 256; s2++)
+	{
+	  l2 = huff_sym_table[s2].code_len;
+	  if (l1 + l2 > HPACK_HUFFMAN_MULTI_BITS)
+	    continue;
+	  prefix2 = prefix1 | huff_sym_table[s2].code
+				<< (HPACK_HUFFMAN_MULTI_BITS - l1 - l2);
+	  for (i = 0; i < 1 << (HPACK_HUFFMAN_MULTI_BITS - l1 - l2); i++)
+	    {
+	      e = &huff_code_table_multi[prefix2 + i];
+	      e->symbols[1] = s2;
+	      e->n_symbols = 2;
+	      e->code_len = l1 + l2;
+	    }
+	}
+    }
+}
+
 http2_error_t
 hpack_decode_huffman (u8 **src, u8 *end, u8 **buf, uword *buf_len)
 {
@@ -149,6 +200,7 @@ hpack_decode_huffman (u8 **src, u8 *end, u8 **buf, uword *buf_len)
   u8 accumulator_len = 0;
   u8 *p;
   hpack_huffman_code_t *code;
+  hpack_huffman_multi_code_t *multi;
 
   p = *src;
   while (1)
@@ -163,6 +215,25 @@ hpack_decode_huffman (u8 **src, u8 *end, u8 **buf, uword *buf_len)
 	  accumulator_len += 8;
 	  accumulator |= (u64) *p++;
 	}
+      /* try to decode up to two symbols (codes up to 12 bits) at once, EOS
+       * padding is all ones and can't be mistaken for a code this short */
+      if (PREDICT_TRUE (accumulator_len >= HPACK_HUFFMAN_MULTI_BITS &&
+			*buf_len >= 2))
+	{
+	  multi = &huff_code_table_multi[(accumulator >>
+					  (accumulator_len -
+					   HPACK_HUFFMAN_MULTI_BITS)) &
+					 ((1 << HPACK_HUFFMAN_MULTI_BITS) - 1)];
+	  if (PREDICT_TRUE (multi->n_symbols))
+	    {
+	      (*buf)[0] = multi->symbols[0];
+	      (*buf)[1] = multi->symbols[1];
+	      *buf += multi->n_symbols;
+	      *buf_len -= multi->n_symbols;
+	      accumulator_len -= multi->code_len;
+	      goto check_done;
+	    }
+	}
       /* first try short codes (5 - 8 bits) */
       code =
 	&huff_code_table_fast[(u8) (accumulator >> (accumulator_len - 8))];
@@ -200,6 +271,7 @@ hpack_decode_huffman (u8 **src, u8 *end, u8 **buf, uword *buf_len)
 	  (*buf_len)--;
 	  accumulator_len -= hg->code_len;
 	}
+    check_done:
       /* all done */
       if (p == end && accumulator_len < 8)
 	{
@@ -543,7 +615,7 @@ hpack_decode_header (u8 **src, u8 *end, u8 **buf, uword *buf_len,
   u8 *p;
   u8 value_is_indexed = 0, add_new_entry = 0;
   uword old_len, new_max, index = 0;
-  http_token_t name, value;
+  http_token_t name = {}, value = {};
   http2_error_t rv;
 
   ASSERT (*src < end);
@@ -17,6 +17,10 @@
 /* connection-level flow control window kind of mirrors TCP flow control */
 /* TODO: configurable? */
 #define HTTP2_CONNECTION_WINDOW_SIZE (10 << 20)
+/* default percentage of window consumed before WINDOW_UPDATE is sent */
+#define HTTP2_WINDOW_UPDATE_THRESHOLD 50
+/* TODO: configurable buf size with bigger default value */
+#define HTTP2_HEADERS_BUF_SIZE 1024
 
 #define foreach_http2_stream_state                                            \
   _ (IDLE, "IDLE")                                                            \
@@ -99,6 +103,8 @@ typedef struct http2_main_
   http2_conn_ctx_t **conn_pool;
   http2_req_t **req_pool;
   http2_conn_settings_t settings;
+  u8 **headers_buf; /* per-thread scratch buffer for decoded headers */
+  u8 window_update_threshold;
 } http2_main_t;
 
 static http2_main_t http2_main;
@@ -395,16 +401,18 @@ http2_req_state_wait_transport_method (http_conn_t *hc, http2_req_t *req,
 {
   http2_conn_ctx_t *h2c;
   hpack_request_control_data_t control_data;
-  u8 *buf = 0;
+  u8 *buf;
   http_msg_t msg;
   int rv;
   http_req_state_t new_state = HTTP_REQ_STATE_WAIT_APP_REPLY;
 
   h2c = http2_conn_ctx_get_w_thread (hc);
 
-  /* TODO: configurable buf size with bigger default value */
-  vec_validate_init_empty (buf, 1023, 0);
-  *error = hpack_parse_request (req->payload, req->payload_len, buf, 1023,
+  /* headers are decoded into per-thread buffer, it's copied into app's rx
+   * fifo at the end so nothing refers to it afterwards */
+  buf = http2_main.headers_buf[hc->c_thread_index];
+  *error = hpack_parse_request (req->payload, req->payload_len, buf,
+				vec_len (buf),
 				&control_data, &req->base.headers,
 				&h2c->decoder_dynamic_table);
   if (*error != HTTP2_ERROR_NO_ERROR)
@@ -1326,7 +1334,7 @@ http2_app_rx_evt_callback (http_conn_t *hc, u32 req_index,
   /* TODO: continue tunnel RX */
   http2_req_t *req;
   u8 *response;
-  u32 increment;
+  u32 increment, max_write;
 
   req = http2_req_get (req_index, thread_index);
   if (!req)
@@ -1340,8 +1348,17 @@ http2_app_rx_evt_callback (http_conn_t *hc, u32 req_index,
   if (req->stream_state == HTTP2_STREAM_STATE_OPEN)
     {
       http_io_as_reset_has_read_ntf (&req->base);
+      max_write = http_io_as_max_write (&req->base);
+      increment = max_write - req->our_window;
+      /* coalesce small updates, we are notified again once app empties rx
+       * fifo so peer can't stall on closed window */
+      if (!increment || (u64) increment * 100 <
+			  (u64) max_write * http2_main.window_update_threshold)
+	{
+	  HTTP_DBG (1, "stream window increment %u postponed", increment);
+	  return;
+	}
       response = http_get_tx_buf (hc);
-      increment = http_io_as_max_write (&req->base) - req->our_window;
       HTTP_DBG (1, "stream window increment %u", increment);
       req->our_window += increment;
       http2_frame_write_window_update (increment, req->stream_id, &response);
@@ -1522,8 +1539,11 @@ http2_transport_rx_callback (http_conn_t *hc)
 	}
     }
 
-  /* send connection window update if more than half consumed */
-  if (h2c->our_window < HTTP2_CONNECTION_WINDOW_SIZE / 2)
+  /* send connection window update if enough consumed */
+  if (h2c->our_window < HTTP2_CONNECTION_WINDOW_SIZE &&
+      (u64) (HTTP2_CONNECTION_WINDOW_SIZE - h2c->our_window) * 100 >=
+	(u64) HTTP2_CONNECTION_WINDOW_SIZE *
+	  http2_main.window_update_threshold)
     {
       HTTP_DBG (1, "connection window increment %u",
 		HTTP2_CONNECTION_WINDOW_SIZE - h2c->our_window);
@@ -1664,12 +1684,15 @@ http2_enable_callback (void)
 {
   http2_main_t *h2m = &http2_main;
   vlib_thread_main_t *vtm = vlib_get_thread_main ();
-  u32 num_threads;
+  u32 num_threads, i;
 
   num_threads = 1 /* main thread */ + vtm->n_threads;
 
   vec_validate (h2m->conn_pool, num_threads - 1);
   vec_validate (h2m->req_pool, num_threads - 1);
+  vec_validate (h2m->headers_buf, num_threads - 1);
+  for (i = 0; i < num_threads; i++)
+    vec_validate (h2m->headers_buf[i], HTTP2_HEADERS_BUF_SIZE - 1);
 }
 
 static int
@@ -1724,6 +1747,12 @@ http2_unformat_config_callback (unformat_input_t *input)
 	  if (http2_update_settings (HTTP2_SETTINGS_HEADER_TABLE_SIZE, value))
 	    return 0;
 	}
+      else if (unformat (input, "window-update-threshold %u", &value))
+	{
+	  if (value > 100)
+	    return 0;
+	  http2_main.window_update_threshold = value;
+	}
       else
 	return 0;
     }
@@ -1759,6 +1788,7 @@ http2_init (vlib_main_t *vm)
   clib_warning ("http/2 enabled");
   h2m->settings = http2_default_conn_settings;
   h2m->settings.max_concurrent_streams = 100; /* by default unlimited */
+  h2m->window_update_threshold = HTTP2_WINDOW_UPDATE_THRESHOLD;
   http_register_engine (&http2_engine, HTTP_VERSION_2);
 
   return 0;
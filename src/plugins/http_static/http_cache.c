@@ -18,6 +18,8 @@
 #include <vppinfra/unix.h>
 #include <vlib/vlib.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <vppinfra/time_range.h>
 
 static void
@@ -163,7 +165,7 @@ hss_cache_attach_entry (hss_cache_t *hc, u32 ce_index, u8 **data,
   ce = pool_elt_at_index (hc->cache_pool, ce_index);
   ce->inuse++;
   *data = ce->data;
-  *data_len = vec_len (ce->data);
+  *data_len = ce->data_len;
   *last_modified = ce->last_modified;
 
   /* Update the cache entry, mark it in-use */
@@ -227,6 +229,55 @@ hss_cache_lookup_and_attach (hss_cache_t *hc, u8 *path, u8 **data,
   return ce_index;
 }
 
+static void
+hss_cache_entry_free_data (hss_cache_entry_t *ce)
+{
+  if (ce->is_mmap)
+    munmap (ce->data, ce->data_len);
+  else
+    vec_free (ce->data);
+  ce->data = 0;
+}
+
+/** \brief Map file read-only, pages are shared with page cache so only the
+ *  copy into transport fifo is left on tx path
+ */
+static clib_error_t *
+hss_cache_file_map (char *path, u8 **data, u64 *data_len)
+{
+  struct stat st;
+  void *addr;
+  int fd;
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return clib_error_return_unix (0, "open `%s'", path);
+
+  if (fstat (fd, &st) < 0)
+    {
+      close (fd);
+      return clib_error_return_unix (0, "fstat `%s'", path);
+    }
+
+  /* nothing to map */
+  if (st.st_size == 0)
+    {
+      close (fd);
+      *data = 0;
+      *data_len = 0;
+      return 0;
+    }
+
+  addr = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED)
+    return clib_error_return_unix (0, "mmap `%s'", path);
+
+  *data = addr;
+  *data_len = st.st_size;
+  return 0;
+}
+
 static void
 hss_cache_do_evictions (hss_cache_t *hc)
 {
@@ -240,13 +291,15 @@ hss_cache_do_evictions (hss_cache_t *hc)
     {
       /* pick the LRU */
       ce = pool_elt_at_index (hc->cache_pool, free_index);
+      free_index = ce->prev_index;
       /* Which could be in use... */
       if (ce->inuse)
 	{
 	  if (hc->debug_level > 1)
-	    clib_warning ("index %d in use refcnt %d", free_index, ce->inuse);
+	    clib_warning ("index %d in use refcnt %d", ce - hc->cache_pool,
+			  ce->inuse);
+	  continue;
 	}
-      free_index = ce->prev_index;
       kv.key = (u64) (ce->filename);
       kv.value = ~0ULL;
       if (BV (clib_bihash_add_del) (&hc->name_to_data, &kv, 0 /* is_add */) <
@@ -258,10 +311,10 @@ hss_cache_do_evictions (hss_cache_t *hc)
 	clib_warning ("LRU delete '%s' ok", ce->filename);
 
       lru_remove (hc, ce);
-      hc->cache_size -= vec_len (ce->data);
+      hc->cache_size -= ce->data_len;
       hc->cache_evictions++;
       vec_free (ce->filename);
-      vec_free (ce->data);
+      hss_cache_entry_free_data (ce);
       vec_free (ce->last_modified);
 
       if (hc->debug_level > 1)
@@ -281,6 +334,7 @@ hss_cache_add_and_attach (hss_cache_t *hc, u8 *path, u8 **data, u64 *data_len,
   hss_cache_entry_t *ce;
   clib_error_t *error;
   u8 *file_data;
+  u64 file_data_len = 0;
   u32 ce_index;
   struct stat dm;
 
@@ -290,12 +344,19 @@ hss_cache_add_and_attach (hss_cache_t *hc, u8 *path, u8 **data, u64 *data_len,
   if (hc->cache_size > hc->cache_limit)
     hss_cache_do_evictions (hc);
 
-  /* Read the file */
-  error = clib_file_contents ((char *) path, &file_data);
+  /* Read or map the file */
+  if (hc->use_mmap)
+    error = hss_cache_file_map ((char *) path, &file_data, &file_data_len);
+  else
+    {
+      error = clib_file_contents ((char *) path, &file_data);
+      file_data_len = vec_len (file_data);
+    }
   if (error)
     {
       clib_warning ("Error reading '%s'", path);
       clib_error_report (error);
+      hss_cache_unlock (hc);
       return ~0;
     }
 
@@ -303,6 +364,8 @@ hss_cache_add_and_attach (hss_cache_t *hc, u8 *path, u8 **data, u64 *data_len,
   pool_get_zero (hc->cache_pool, ce);
   ce->filename = vec_dup (path);
   ce->data = file_data;
+  ce->data_len = file_data_len;
+  ce->is_mmap = hc->use_mmap && file_data != 0;
   if (stat ((char *) path, &dm) == 0)
     {
       ce->last_modified =
@@ -312,11 +375,11 @@ hss_cache_add_and_attach (hss_cache_t *hc, u8 *path, u8 **data, u64 *data_len,
   /* Attach cache entry without additional lock */
   ce->inuse++;
   *data = file_data;
-  *data_len = vec_len (file_data);
+  *data_len = file_data_len;
   *last_modified = ce->last_modified;
   lru_add (hc, ce, vlib_time_now (vlib_get_main ()));
 
-  hc->cache_size += vec_len (ce->data);
+  hc->cache_size += ce->data_len;
   ce_index = ce - hc->cache_pool;
 
   if (hc->debug_level > 1)
@@ -371,10 +434,10 @@ hss_cache_clear (hss_cache_t *hc)
 	}
 
       lru_remove (hc, ce);
-      hc->cache_size -= vec_len (ce->data);
+      hc->cache_size -= ce->data_len;
       hc->cache_evictions++;
       vec_free (ce->filename);
-      vec_free (ce->data);
+      hss_cache_entry_free_data (ce);
       vec_free (ce->last_modified);
       if (hc->debug_level > 1)
 	clib_warning ("pool put index %d", ce - hc->cache_pool);
@@ -422,8 +485,8 @@ format_hss_cache_entry (u8 *s, va_list *args)
       s = format (s, "%40s%12s%20s", "File", "Size", "Age");
       return s;
     }
-  s = format (s, "%40s%12lld%20.2f", ep->filename, vec_len (ep->data),
-	      now - ep->last_used);
+  s = format (s, "%40s%12lld%20.2f%s", ep->filename, ep->data_len,
+	      now - ep->last_used, ep->is_mmap ? " mmap" : "");
   return s;
 }
 
@@ -25,8 +25,12 @@ typedef struct hss_cache_entry_
   /** Last modified date, format:
    *  <day-name>, <day> <month> <year> <hour>:<minute>:<second> GMT  */
   u8 *last_modified;
-  /** Contents of the file, as a u8 * vector */
+  /** Contents of the file, u8 * vector or mapped file pages */
   u8 *data;
+  /** Length of the file contents */
+  u64 data_len;
+  /** Contents are mmapped, not a vector */
+  u8 is_mmap;
   /** Last time the cache entry was used */
   f64 last_used;
   /** Cache LRU links */
@@ -58,6 +62,8 @@ typedef struct hss_cache_
   u32 last_index;
 
   u8 debug_level;
+  /** Map files read-only instead of reading them into heap */
+  u8 use_mmap;
 } hss_cache_t;
 
 u32 hss_cache_lookup_and_attach (hss_cache_t *hc, u8 *path, u8 **data,
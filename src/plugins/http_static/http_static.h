@@ -28,6 +28,14 @@
 #define HSS_DEFAULT_RX_BUFFER_THRESH  1 << 20
 #define HSS_DEFAULT_KEEPALIVE_TIMEOUT 60
 
+/** \brief Precompressed content codings served by file handler
+ */
+typedef enum hss_content_coding_
+{
+  HSS_CONTENT_CODING_BR = 1 << 0,
+  HSS_CONTENT_CODING_GZIP = 1 << 1,
+} hss_content_coding_t;
+
 /** @file http_static.h
  * Static http server definitions
  */
@@ -73,6 +81,10 @@ typedef struct hss_session_
   /** threshold for switching to pointers */
   u64 use_ptr_thresh;
   int (*read_body_handler) (struct hss_session_ *hs, session_t *ts);
+  /** Request headers */
+  http_header_table_t req_headers;
+  /** Content codings accepted by client, see hss_content_coding_t */
+  u8 accept_encoding;
 } hss_session_t;
 
 typedef struct hss_session_handle_
@@ -152,6 +164,10 @@ typedef struct hss_listener_
   u8 *max_age_formatted;
   /** Enable the use of builtinurls */
   u8 enable_url_handlers;
+  /** Map cached files instead of reading them into heap */
+  u8 cache_mmap;
+  /** Serve precompressed .br/.gz variants of files if client accepts */
+  u8 enable_precompressed;
   /** Index in listener pool */
   u32 l_index;
   /** Listener session handle */
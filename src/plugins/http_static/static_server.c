@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include <http/http_content_types.h>
+#include <http/http_header_names.h>
 #include <http/http_status_codes.h>
 
 /** @file static_server.c
@@ -497,6 +498,108 @@ try_index_file (hss_listener_t *l, hss_session_t *hs, u8 *path)
   return HTTP_STATUS_MOVED;
 }
 
+/** \brief Check whether coding parameters carry zero weight, "q=0" (or
+ *  "q=0.0" etc.) means client refuses the coding
+ */
+static int
+hss_coding_is_refused (const char *p, const char *end)
+{
+  while (p < end && *p != 'q' && *p != 'Q')
+    p++;
+  if (end - p < 3 || p[1] != '=' || p[2] != '0')
+    return 0;
+  p += 3;
+  if (p < end && *p == '.')
+    {
+      p++;
+      while (p < end && *p == '0')
+	p++;
+    }
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  return p == end;
+}
+
+/** \brief Parse Accept-Encoding header value
+ *  @return hss_content_coding_t bitmap of accepted codings we can serve
+ */
+static u8
+hss_parse_accept_encoding (const char *p, uword len)
+{
+  const char *end = p + len, *token;
+  uword token_len;
+  u8 rv = 0, coding;
+
+  while (p < end)
+    {
+      while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+	p++;
+      token = p;
+      while (p < end && *p != ',' && *p != ';' && *p != ' ' && *p != '\t')
+	p++;
+      token_len = p - token;
+      if (http_token_is_case (token, token_len, http_token_lit ("br")))
+	coding = HSS_CONTENT_CODING_BR;
+      else if (http_token_is_case (token, token_len, http_token_lit ("gzip")))
+	coding = HSS_CONTENT_CODING_GZIP;
+      else if (http_token_is (token, token_len, http_token_lit ("*")))
+	coding = HSS_CONTENT_CODING_BR | HSS_CONTENT_CODING_GZIP;
+      else
+	coding = 0;
+      token = p;
+      while (p < end && *p != ',')
+	p++;
+      if (coding && !hss_coding_is_refused (token, p))
+	rv |= coding;
+    }
+
+  return rv;
+}
+
+/** \brief Look for precompressed variant of the file client accepts
+ *  @return cache entry index or ~0 if none found, on success path is
+ *  replaced with the variant path
+ */
+static u32
+try_precompressed_file (hss_listener_t *l, hss_session_t *hs, u8 **path,
+			u8 **last_modified, const char **content_encoding)
+{
+  static const struct
+  {
+    hss_content_coding_t coding;
+    const char *suffix;
+    const char *token;
+  } variants[] = {
+    { HSS_CONTENT_CODING_BR, ".br", "br" },
+    { HSS_CONTENT_CODING_GZIP, ".gz", "gzip" },
+  };
+  u8 *variant_path;
+  u32 ce_index;
+  int i;
+
+  for (i = 0; i < ARRAY_LEN (variants); i++)
+    {
+      if (!(hs->accept_encoding & variants[i].coding))
+	continue;
+      variant_path = format (0, "%s%s%c", *path, variants[i].suffix, 0);
+      ce_index = hss_cache_lookup_and_attach (
+	&l->cache, variant_path, &hs->data, &hs->data_len, last_modified);
+      if (ce_index == ~0 && file_path_is_valid (variant_path))
+	ce_index = hss_cache_add_and_attach (
+	  &l->cache, variant_path, &hs->data, &hs->data_len, last_modified);
+      if (ce_index != ~0)
+	{
+	  vec_free (*path);
+	  *path = variant_path;
+	  *content_encoding = variants[i].token;
+	  return ce_index;
+	}
+      vec_free (variant_path);
+    }
+
+  return ~0;
+}
+
 static int
 try_file_handler (hss_session_t *hs)
 {
@@ -505,6 +608,7 @@ try_file_handler (hss_session_t *hs)
   u8 *path, *sanitized_path;
   u32 ce_index, max_dequeue;
   http_content_type_t type;
+  const char *content_encoding = 0;
   u8 *last_modified;
   hss_listener_t *l;
   session_t *ts;
@@ -552,8 +656,13 @@ try_file_handler (hss_session_t *hs)
 
   hs->data_offset = 0;
 
-  ce_index = hss_cache_lookup_and_attach (&l->cache, path, &hs->data,
-					  &hs->data_len, &last_modified);
+  ce_index = ~0;
+  if (l->enable_precompressed && hs->accept_encoding)
+    ce_index = try_precompressed_file (l, hs, &path, &last_modified,
+				       &content_encoding);
+  if (ce_index == ~0)
+    ce_index = hss_cache_lookup_and_attach (&l->cache, path, &hs->data,
+					    &hs->data_len, &last_modified);
   if (ce_index == ~0)
     {
       if (!file_path_is_valid (path))
@@ -600,6 +709,16 @@ try_file_handler (hss_session_t *hs)
     {
       sc = HTTP_STATUS_INTERNAL_ERROR;
     }
+  /* Representation depends on Accept-Encoding if we have variants */
+  if (l->enable_precompressed &&
+      (hss_add_header (hs, HTTP_HEADER_VARY,
+		       http_token_lit ("Accept-Encoding")) ||
+       (content_encoding &&
+	hss_add_header (hs, HTTP_HEADER_CONTENT_ENCODING, content_encoding,
+			strlen (content_encoding)))))
+    {
+      sc = HTTP_STATUS_INTERNAL_ERROR;
+    }
 
 done:
   vec_free (sanitized_path);
@@ -672,7 +791,9 @@ url_handler_read_body (hss_session_t *hs, session_t *ts)
 static int
 hss_ts_rx_callback (session_t *ts)
 {
+  const http_token_t *accept_encoding;
   hss_session_t *hs;
+  hss_listener_t *l;
   http_msg_t msg;
   int rv;
 
@@ -725,6 +846,25 @@ hss_ts_rx_callback (session_t *ts)
       vec_add1 (hs->target_path, 0);
     }
 
+  /* Content codings accepted by client, only needed to pick precompressed
+   * variants of files */
+  hs->accept_encoding = 0;
+  l = hss_listener_get (hs->listener_index);
+  if (l->enable_precompressed && msg.data.headers_len)
+    {
+      http_reset_header_table (&hs->req_headers);
+      http_init_header_table_buf (&hs->req_headers, msg);
+      rv = svm_fifo_peek (ts->rx_fifo, msg.data.headers_offset,
+			  msg.data.headers_len, hs->req_headers.buf);
+      ASSERT (rv == msg.data.headers_len);
+      http_build_header_table (&hs->req_headers, msg);
+      accept_encoding = http_get_header (
+	&hs->req_headers, http_header_name_token (HTTP_HEADER_ACCEPT_ENCODING));
+      if (accept_encoding)
+	hs->accept_encoding = hss_parse_accept_encoding (
+	  accept_encoding->base, accept_encoding->len);
+    }
+
   /* Read target query */
   if (msg.data.target_query_len)
     {
@@ -892,6 +1032,7 @@ hss_ts_cleanup (session_t *s, session_cleanup_ntf_t ntf)
   vec_free (hs->path);
   vec_free (hs->target_path);
   vec_free (hs->target_query);
+  http_free_header_table (&hs->req_headers);
 
   hss_session_free (hs);
 }
@@ -1037,7 +1178,10 @@ hss_listener_add (hss_listener_t *l_cfg)
   ls->opaque = l->l_index;
 
   if (l->www_root)
-    hss_cache_init (&l->cache, l->cache_size, hsm->debug_level);
+    {
+      hss_cache_init (&l->cache, l->cache_size, hsm->debug_level);
+      l->cache.use_mmap = l->cache_mmap;
+    }
   if (l->enable_url_handlers)
     hss_url_handlers_init (hsm);
 
@@ -1160,6 +1304,10 @@ hss_create_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	;
       else if (unformat (line_input, "url-handlers"))
 	l->enable_url_handlers = 1;
+      else if (unformat (line_input, "cache-mmap"))
+	l->cache_mmap = 1;
+      else if (unformat (line_input, "precompressed"))
+	l->enable_precompressed = 1;
       else if (unformat (line_input, "cache-size %U", unformat_memory_size,
 			 &l->cache_size))
 	;
@@ -1245,7 +1393,8 @@ VLIB_CLI_COMMAND (hss_create_command, static) = {
     "http static server [www-root <path>] [url-handlers]\n"
     "[private-segment-size <nnMG>] [fifo-size <nbytes>] [max-age <nseconds>]\n"
     "[uri <uri>] [ptr-thresh <nn>] [prealloc-fifos <nn>] [debug [nn]]\n"
-    "[keepalive-timeout <nn>] [max-body-size <nn>]\n",
+    "[keepalive-timeout <nn>] [max-body-size <nn>] [cache-mmap]\n"
+    "[precompressed]\n",
   .function = hss_create_command_fn,
 };
 
@@ -1284,6 +1433,10 @@ hss_add_del_listener_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	;
       else if (unformat (line_input, "url-handlers"))
 	l->enable_url_handlers = 1;
+      else if (unformat (line_input, "cache-mmap"))
+	l->cache_mmap = 1;
+      else if (unformat (line_input, "precompressed"))
+	l->enable_precompressed = 1;
       else if (unformat (line_input, "cache-size %U", unformat_memory_size,
 			 &l->cache_size))
 	;
@@ -1355,7 +1508,7 @@ done:
 VLIB_CLI_COMMAND (hss_add_del_listener_command, static) = {
   .path = "http static listener",
   .short_help = "http static listener [add|del] uri <uri>\n"
-		"[www-root <path>] [url-handlers] \n",
+		"[www-root <path>] [url-handlers] [cache-mmap] [precompressed]\n",
   .function = hss_add_del_listener_command_fn,
 };
 
@@ -1382,6 +1535,9 @@ format_hss_listener (u8 *s, va_list *args)
     l->l_index, format_ip46_address, &l->sep.ip, l->sep.is_ip4,
     clib_net_to_host_u16 (l->sep.port), l->www_root, format_memory_size,
     l->cache_size, l->enable_url_handlers);
+  if (l->cache_mmap || l->enable_precompressed)
+    s = format (s, "%s%s", l->cache_mmap ? " cache-mmap" : "",
+		l->enable_precompressed ? " precompressed" : "");
   return s;
 }
 
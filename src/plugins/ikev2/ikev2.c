@@ -316,6 +316,7 @@ ikev2_sa_free_all_vec (ikev2_sa_t * sa)
 {
   vec_free (sa->i_nonce);
   vec_free (sa->r_nonce);
+  vec_free (sa->cookie);
 
   vec_free (sa->dh_shared_key);
   vec_free (sa->dh_private_key);
@@ -693,6 +694,72 @@ ikev2_compute_nat_sha1 (u64 ispi, u64 rspi, ip_address_t *ia, u16 port)
   return res;
 }
 
+/*
+ * RFC 7296 2.6: Cookie = Hash(Ni | IPi | SPIi | <secret>)
+ */
+static u8 *
+ikev2_compute_cookie (ikev2_sa_t *sa)
+{
+  ikev2_main_t *km = &ikev2_main;
+  u8 *buf = 0, *res = vec_new (u8, SHA_DIGEST_LENGTH);
+  u64 ispi = clib_host_to_net_u64 (sa->ispi);
+
+  vec_add (buf, sa->i_nonce, vec_len (sa->i_nonce));
+  vec_add (buf, ip_addr_bytes (&sa->iaddr), ip_address_size (&sa->iaddr));
+  vec_add (buf, (u8 *) &ispi, sizeof (ispi));
+  vec_add (buf, km->cookie_secret, sizeof (km->cookie_secret));
+  SHA1 (buf, vec_len (buf), res);
+  vec_free (buf);
+  return res;
+}
+
+/*
+ * Require a COOKIE when the IKE_SA_INIT request rate on this thread is
+ * above the configured threshold, so that a flood of requests costs us
+ * a hash per request rather than a DH key generation
+ */
+static int
+ikev2_sa_init_cookie_required (vlib_main_t *vm,
+			       ikev2_main_per_thread_data_t *ptd)
+{
+  ikev2_main_t *km = &ikev2_main;
+  f64 now;
+
+  if (!km->cookie_threshold)
+    return 0;
+
+  now = vlib_time_now (vm);
+  if (now - ptd->sa_init_window_start >= 1.0)
+    {
+      ptd->sa_init_window_start = now;
+      ptd->n_sa_init_in_window = 0;
+    }
+
+  return ++ptd->n_sa_init_in_window > km->cookie_threshold;
+}
+
+/*
+ * Check the COOKIE received with the request. If it is missing or
+ * stale, keep the expected one to be sent back to the initiator
+ */
+static int
+ikev2_sa_init_cookie_check (ikev2_sa_t *sa)
+{
+  u8 *cookie = ikev2_compute_cookie (sa);
+
+  if (vec_len (sa->cookie) == vec_len (cookie) &&
+      !clib_memcmp (sa->cookie, cookie, vec_len (cookie)))
+    {
+      vec_free (cookie);
+      return 1;
+    }
+
+  vec_free (sa->cookie);
+  sa->cookie = cookie;
+  sa->send_cookie = 1;
+  return 0;
+}
+
 static int
 ikev2_parse_ke_payload (const void *p, u32 rlen, ikev2_sa_t * sa,
 			u8 ** ke_data)
@@ -835,6 +902,12 @@ ikev2_process_sa_init_req (vlib_main_t *vm, ikev2_sa_t *sa, ike_header_t *ike,
 		}
 	      vec_free (dst_sha);
 	    }
+	  else if (n->msg_type == IKEV2_NOTIFY_MSG_COOKIE)
+	    {
+	      vec_free (sa->cookie);
+	      sa->cookie = n->data;
+	      n->data = 0;
+	    }
 	  vec_free (n);
 	}
       else if (payload == IKEV2_PAYLOAD_VENDOR)
@@ -2614,7 +2687,12 @@ ikev2_generate_message (vlib_buffer_t *b, ikev2_sa_t *sa, ike_header_t *ike,
 
   if (ike->exchange == IKEV2_EXCHANGE_SA_INIT)
     {
-      if (sa->r_proposals == 0)
+      if (sa->send_cookie)
+	{
+	  ikev2_payload_add_notify (chain, IKEV2_NOTIFY_MSG_COOKIE,
+				    sa->cookie);
+	}
+      else if (sa->r_proposals == 0)
 	{
 	  ikev2_payload_add_notify (chain,
 				    IKEV2_NOTIFY_MSG_NO_PROPOSAL_CHOSEN, 0);
@@ -3323,6 +3401,16 @@ ikev2_node_internal (vlib_main_t *vm, vlib_node_runtime_t *node,
 						 IKEV2_ERROR_MALFORMED_PACKET,
 						 1);
 
+		  if (sa0->state == IKEV2_STATE_SA_INIT &&
+		      ikev2_sa_init_cookie_required (vm, ptd) &&
+		      !ikev2_sa_init_cookie_check (sa0))
+		    {
+		      vlib_node_increment_counter (
+			vm, node->node_index, IKEV2_ERROR_IKE_SA_INIT_COOKIE,
+			1);
+		      ikev2_set_state (sa0, IKEV2_STATE_NOTIFY_AND_DELETE);
+		    }
+
 		  if (sa0->state == IKEV2_STATE_SA_INIT)
 		    {
 		      ikev2_sa_free_proposal_vector (&sa0->r_proposals);
@@ -5305,6 +5393,15 @@ ikev2_set_liveness_params (u32 period, u32 max_retries)
   return 0;
 }
 
+clib_error_t *
+ikev2_set_cookie_threshold (u32 threshold)
+{
+  ikev2_main_t *km = &ikev2_main;
+
+  km->cookie_threshold = threshold;
+  return 0;
+}
+
 clib_error_t *
 ikev2_set_sleep_interval (f64 interval)
 {
@@ -5660,6 +5757,8 @@ ikev2_lazy_init (ikev2_main_t *km)
 
   ikev2_crypto_init (km);
 
+  RAND_bytes (km->cookie_secret, sizeof (km->cookie_secret));
+
   mhash_init_vec_string (&km->profile_index_by_name, sizeof (uword));
 
   vec_validate_aligned (km->per_thread_data, tm->n_vlib_mains - 1,
@@ -445,6 +445,7 @@ uword unformat_ikev2_transform_esn_type (unformat_input_t * input,
 clib_error_t *ikev2_set_liveness_params (u32 period, u32 max_retries);
 
 clib_error_t *ikev2_set_sleep_interval (f64 interval);
+clib_error_t *ikev2_set_cookie_threshold (u32 threshold);
 
 f64 ikev2_get_sleep_interval ();
 
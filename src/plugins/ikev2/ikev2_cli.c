@@ -715,6 +715,42 @@ VLIB_CLI_COMMAND (set_ikev2_liveness_command, static) = {
   .function = set_ikev2_liveness_period_fn,
 };
 
+static clib_error_t *
+set_ikev2_cookie_threshold_fn (vlib_main_t *vm, unformat_input_t *input,
+			       vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  clib_error_t *r = 0;
+  u32 threshold = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%u", &threshold))
+	{
+	  r = ikev2_set_cookie_threshold (threshold);
+	  goto done;
+	}
+      else
+	break;
+    }
+
+  r = clib_error_return (0, "parse error: '%U'", format_unformat_error,
+			 line_input);
+
+done:
+  unformat_free (line_input);
+  return r;
+}
+
+VLIB_CLI_COMMAND (set_ikev2_cookie_threshold_command, static) = {
+  .path = "ikev2 set cookie-threshold",
+  .short_help = "ikev2 set cookie-threshold <requests-per-sec>",
+  .function = set_ikev2_cookie_threshold_fn,
+};
+
 static clib_error_t *
 set_ikev2_sleep_interval_fn (vlib_main_t *vm, unformat_input_t *input,
 			     vlib_cli_command_t *cmd)
@@ -492,6 +492,10 @@ typedef struct
   ikev2_stats_t stats;
 
   f64 auth_timestamp;
+
+  /* COOKIE received in IKE_SA_INIT request, or the one to send back */
+  u8 *cookie;
+  u8 send_cookie;
 } ikev2_sa_t;
 
 
@@ -507,6 +511,10 @@ typedef struct
 
   EVP_CIPHER_CTX *evp_ctx;
   HMAC_CTX *hmac_ctx;
+
+  /* IKE_SA_INIT request rate, for COOKIE challenges */
+  f64 sa_init_window_start;
+  u32 n_sa_init_in_window;
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
   HMAC_CTX _hmac_ctx;
   EVP_CIPHER_CTX _evp_ctx;
@@ -562,6 +570,13 @@ typedef struct
   /* dead peer detection */
   u8 dpd_disabled;
 
+  /* IKE_SA_INIT requests per second per thread above which requests
+   * without a valid COOKIE are challenged, 0 to disable */
+  u32 cookie_threshold;
+
+  /* secret used to compute COOKIEs */
+  u8 cookie_secret[32];
+
   /* pointer to name resolver function in dns plugin */
   void *dns_resolve_name_ptr;
 
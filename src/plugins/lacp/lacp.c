@@ -75,7 +75,7 @@ lacp_send_ethernet_lacp_pdu (vlib_main_t * vm, member_if_t * mif)
   b0 = vlib_get_buffer (vm, bi0);
   b0->current_length = sizeof (ethernet_lacp_pdu_t);
   b0->current_data = 0;
-  b0->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b0)->total_length_not_including_first_buffer = 0;
 
   /* And the outbound interface */
   vnet_buffer (b0)->sw_if_index[VLIB_TX] = hw->sw_if_index;
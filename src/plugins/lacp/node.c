@@ -232,6 +232,8 @@ lacp_create_periodic_process (void)
   lm->lacp_process_node_index =
     vlib_process_create (lm->vlib_main, "lacp-process", lacp_process,
 			 16 /* log2_n_stack_bytes */ );
+  vlib_process_set_priority (lm->vlib_main, lm->lacp_process_node_index,
+			     VLIB_PROCESS_PRIORITY_HIGH);
 }
 
 /*
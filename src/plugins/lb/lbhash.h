@@ -181,6 +181,47 @@ void lb_hash_put(lb_hash_t *h, u32 hash, u32 value, u32 vip,
   bucket->vip[available_index] = vip;
 }
 
+/*
+ * Move the live entries of src into dst, which may have another size.
+ * Entries not fitting in their new bucket, and expired ones, are left in
+ * src. Their slots are set to the value 0 and their previous value is
+ * added to dropped, so the caller can release the references they hold.
+ */
+static_always_inline
+void lb_hash_move(lb_hash_t *dst, lb_hash_t *src, u32 time_now,
+		  u32 **dropped)
+{
+  lb_hash_bucket_t *b, *db;
+  u32 i, j;
+
+  lb_hash_foreach_entry(src, b, i) {
+    if (b->value[i] == 0)
+      continue;
+
+    if (clib_u32_loop_gt(time_now, b->timeout[i]))
+      goto drop;
+
+    db = &dst->buckets[b->hash[i] & dst->buckets_mask];
+    for (j = 0; j < LBHASH_ENTRY_PER_BUCKET; j++)
+      if (clib_u32_loop_gt(time_now, db->timeout[j]))
+	break;
+
+    if (j == LBHASH_ENTRY_PER_BUCKET)
+      goto drop;
+
+    db->hash[j] = b->hash[i];
+    db->vip[j] = b->vip[i];
+    db->value[j] = b->value[i];
+    db->timeout[j] = b->timeout[i];
+    b->value[i] = 0;
+    continue;
+
+  drop:
+    vec_add1(*dropped, b->value[i]);
+    b->value[i] = 0;
+  }
+}
+
 static_always_inline
 u32 lb_hash_elts(lb_hash_t *h, u32 time_now)
 {
@@ -132,17 +132,26 @@ lb_get_sticky_table (clib_thread_index_t thread_index)
   if (PREDICT_FALSE(
       sticky_ht && (lbm->per_cpu_sticky_buckets != lb_hash_nbuckets(sticky_ht))))
     {
-      //Dereference everything in there
-      lb_hash_bucket_t *b;
-      u32 i;
-      lb_hash_foreach_entry(sticky_ht, b, i)
+      //Resize online, live flows keep their AS and their references
+      lb_hash_t *new_ht = lb_hash_alloc (lbm->per_cpu_sticky_buckets,
+                                         lbm->flow_timeout);
+      u32 *dropped = 0, *value;
+
+      lb_hash_move (new_ht, sticky_ht,
+                    lb_hash_time_now (vlib_get_main_by_index (thread_index)),
+                    &dropped);
+
+      //Dereference what did not make it
+      vec_foreach (value, dropped)
         {
-          vlib_refcount_add (&lbm->as_refcount, thread_index, b->value[i], -1);
+          vlib_refcount_add (&lbm->as_refcount, thread_index, *value, -1);
           vlib_refcount_add (&lbm->as_refcount, thread_index, 0, 1);
         }
+      vec_free (dropped);
 
       lb_hash_free (sticky_ht);
-      sticky_ht = NULL;
+      lbm->per_cpu[thread_index].sticky_ht = sticky_ht = new_ht;
+      clib_warning("Resized sticky table %p", sticky_ht);
     }
 
   //Create if necessary
@@ -68,6 +68,25 @@ typedef enum nl_event_type_t_
   NL_EVENT_ERR,
 } nl_event_type_t;
 
+/* identity of a route, as far as deduplication is concerned */
+typedef struct nl_route_key_t_
+{
+  u32 table;
+  u32 priority;
+  u8 family;
+  u8 dst_len;
+  u8 tos;
+  u8 protocol;
+  u8 dst[16];
+} nl_route_key_t;
+
+typedef struct nl_route_stage_t_
+{
+  nl_route_key_t key;
+  u32 index;
+  u8 is_replace;
+} nl_route_stage_t;
+
 typedef struct nl_main
 {
 
@@ -90,12 +109,23 @@ typedef struct nl_main
   u32 sync_batch_delay_ms;
   u32 sync_attempt_delay_ms;
 
+  /* barrier held across consecutive non mp-safe callbacks of a batch */
+  u32 batch_barrier_max_us;
+  u8 batch_active;
+  u8 barrier_held;
+  f64 barrier_start;
+
+  /* per batch route staging, used to drop superseded route messages */
+  nl_route_stage_t *route_stage;
+  uword *route_skip;
+
 } nl_main_t;
 
 #define NL_RX_BUF_SIZE_DEF    (1 << 27) /* 128 MB */
 #define NL_TX_BUF_SIZE_DEF    (1 << 18) /* 256 kB */
 #define NL_BATCH_SIZE_DEF     (1 << 11) /* 2048 */
 #define NL_BATCH_DELAY_MS_DEF 50	/* 50 ms, max 20 batch/s */
+#define NL_BATCH_BARRIER_MAX_US_DEF 1000 /* 1 ms */
 
 #define NL_SYNC_BATCH_LIMIT_DEF	     (1 << 10) /* 1024 */
 #define NL_SYNC_BATCH_DELAY_MS_DEF   20	       /* 20ms, max 50 batch/s */
@@ -106,6 +136,7 @@ static nl_main_t nl_main = {
   .tx_buf_size = NL_TX_BUF_SIZE_DEF,
   .batch_size = NL_BATCH_SIZE_DEF,
   .batch_delay_ms = NL_BATCH_DELAY_MS_DEF,
+  .batch_barrier_max_us = NL_BATCH_BARRIER_MAX_US_DEF,
   .sync_batch_limit = NL_SYNC_BATCH_LIMIT_DEF,
   .sync_batch_delay_ms = NL_SYNC_BATCH_DELAY_MS_DEF,
   .sync_attempt_delay_ms = NL_SYNC_ATTEMPT_DELAY_MS_DEF,
@@ -122,6 +153,53 @@ static nl_main_t nl_main = {
 /* #undef _ */
 /* } nl_nft_proto_t; */
 
+/* Take the worker barrier for a callback. While a batch of notifications is
+ * processed, the barrier is kept across consecutive callbacks that need it,
+ * but for no longer than batch_barrier_max_us */
+static void
+nl_barrier_sync (void)
+{
+  nl_main_t *nm = &nl_main;
+  vlib_main_t *vm = vlib_get_main ();
+
+  if (nm->barrier_held)
+    {
+      if (vlib_time_now (vm) - nm->barrier_start <
+	  nm->batch_barrier_max_us * 1e-6)
+	return;
+      vlib_worker_thread_barrier_release (vm);
+      nm->barrier_held = 0;
+    }
+
+  vlib_worker_thread_barrier_sync (vm);
+  if (nm->batch_active)
+    {
+      nm->barrier_held = 1;
+      nm->barrier_start = vlib_time_now (vm);
+    }
+}
+
+static void
+nl_barrier_release_held (void)
+{
+  nl_main_t *nm = &nl_main;
+
+  if (!nm->barrier_held)
+    return;
+
+  vlib_worker_thread_barrier_release (vlib_get_main ());
+  nm->barrier_held = 0;
+}
+
+static void
+nl_barrier_release (void)
+{
+  nl_main_t *nm = &nl_main;
+
+  if (!nm->barrier_held)
+    vlib_worker_thread_barrier_release (vlib_get_main ());
+}
+
 #define FOREACH_VFT(__func, __arg)                                            \
   {                                                                           \
     nl_main_t *nm = &nl_main;                                                 \
@@ -132,12 +210,14 @@ static nl_main_t nl_main = {
 	  continue;                                                           \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_sync (vlib_get_main ());                 \
+	  nl_barrier_sync ();                                                 \
+	else                                                                  \
+	  nl_barrier_release_held ();                                         \
                                                                               \
 	__nv->__func.cb (__arg);                                              \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_release (vlib_get_main ());              \
+	  nl_barrier_release ();                                              \
       }                                                                       \
   }
 
@@ -151,12 +231,14 @@ static nl_main_t nl_main = {
 	  continue;                                                           \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_sync (vlib_get_main ());                 \
+	  nl_barrier_sync ();                                                 \
+	else                                                                  \
+	  nl_barrier_release_held ();                                         \
                                                                               \
 	__nv->__func.cb ();                                                   \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_release (vlib_get_main ());              \
+	  nl_barrier_release ();                                              \
       }                                                                       \
   }
 
@@ -170,12 +252,14 @@ static nl_main_t nl_main = {
 	  continue;                                                           \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_sync (vlib_get_main ());                 \
+	  nl_barrier_sync ();                                                 \
+	else                                                                  \
+	  nl_barrier_release_held ();                                         \
                                                                               \
 	__nv->__func.cb (__arg, __ctx);                                       \
                                                                               \
 	if (!__nv->__func.is_mp_safe)                                         \
-	  vlib_worker_thread_barrier_release (vlib_get_main ());              \
+	  nl_barrier_release ();                                              \
       }                                                                       \
   }
 
@@ -341,31 +425,145 @@ nl_route_dispatch (struct nl_object *obj, void *arg)
     }
 }
 
+static int
+nl_route_key_cmp (void *a1, void *a2)
+{
+  nl_route_stage_t *s1 = a1, *s2 = a2;
+  int cmp;
+
+  cmp = memcmp (&s1->key, &s2->key, sizeof (s1->key));
+  if (cmp)
+    return cmp;
+  return (int) s1->index - (int) s2->index;
+}
+
+static int
+nl_route_mk_key (struct nl_msg *msg, nl_route_key_t *key, u8 *is_replace)
+{
+  struct nlmsghdr *nlh = nlmsg_hdr (msg);
+  struct nlattr *nla;
+  struct rtmsg *rtm;
+
+  if (nlh->nlmsg_type != RTM_NEWROUTE && nlh->nlmsg_type != RTM_DELROUTE)
+    return -1;
+  if (!nlmsg_valid_hdr (nlh, sizeof (*rtm)))
+    return -1;
+
+  rtm = nlmsg_data (nlh);
+  /* multicast routes are always merged into mfib entries */
+  if (rtm->rtm_type == RTN_MULTICAST)
+    return -1;
+
+  clib_memset (key, 0, sizeof (*key));
+  key->family = rtm->rtm_family;
+  key->dst_len = rtm->rtm_dst_len;
+  key->tos = rtm->rtm_tos;
+  key->protocol = rtm->rtm_protocol;
+  key->table = rtm->rtm_table;
+
+  if ((nla = nlmsg_find_attr (nlh, sizeof (*rtm), RTA_TABLE)))
+    key->table = nla_get_u32 (nla);
+  if ((nla = nlmsg_find_attr (nlh, sizeof (*rtm), RTA_PRIORITY)))
+    key->priority = nla_get_u32 (nla);
+  if ((nla = nlmsg_find_attr (nlh, sizeof (*rtm), RTA_DST)))
+    clib_memcpy (key->dst, nla_data (nla),
+		 clib_min (nla_len (nla), sizeof (key->dst)));
+
+  *is_replace =
+    nlh->nlmsg_type == RTM_NEWROUTE && (nlh->nlmsg_flags & NLM_F_REPLACE);
+
+  return 0;
+}
+
+/* A route replace overwrites all the paths added before by the same source,
+ * so earlier notifications for the same route in the batch have no effect
+ * on the final state and can be skipped. Returns number of skipped msgs */
+static u32
+nl_route_coalesce_msgs (u32 n_msgs)
+{
+  nl_main_t *nm = &nl_main;
+  nl_route_stage_t *rs, *prev;
+  u32 i, n_skipped = 0;
+  int j;
+  u8 superseded = 0;
+
+  vec_reset_length (nm->route_stage);
+  clib_bitmap_zero (nm->route_skip);
+
+  for (i = 0; i < n_msgs; i++)
+    {
+      vec_add2 (nm->route_stage, rs, 1);
+      if (nl_route_mk_key (nm->nl_msg_queue[i].msg, &rs->key,
+			   &rs->is_replace))
+	{
+	  vec_dec_len (nm->route_stage, 1);
+	  continue;
+	}
+      rs->index = i;
+    }
+
+  if (vec_len (nm->route_stage) < 2)
+    return 0;
+
+  vec_sort_with_function (nm->route_stage, nl_route_key_cmp);
+
+  /* walk each group of equal keys backwards, from the latest message */
+  prev = 0;
+  vec_foreach_index_backwards (j, nm->route_stage)
+    {
+      rs = vec_elt_at_index (nm->route_stage, j);
+      if (!prev || memcmp (&prev->key, &rs->key, sizeof (rs->key)))
+	superseded = 0;
+      else if (superseded)
+	{
+	  nm->route_skip = clib_bitmap_set (nm->route_skip, rs->index, 1);
+	  n_skipped++;
+	}
+      if (rs->is_replace)
+	superseded = 1;
+      prev = rs;
+    }
+
+  return n_skipped;
+}
+
 static int
 nl_route_process_msgs (void)
 {
   nl_main_t *nm = &nl_main;
   nl_msg_info_t *msg_info;
   int err, n_msgs = 0;
+  u32 n_batch, n_skipped;
 
   lcp_set_netlink_processing_active (1);
 
+  n_batch = clib_min (vec_len (nm->nl_msg_queue), nm->batch_size);
+  n_skipped = nl_route_coalesce_msgs (n_batch);
+
+  nm->batch_active = 1;
+
   /* process a batch of messages. break if we hit our limit */
   vec_foreach (msg_info, nm->nl_msg_queue)
     {
-      if ((err = nl_msg_parse (msg_info->msg, nl_route_dispatch, msg_info)) <
-	  0)
+      if (n_skipped && clib_bitmap_get (nm->route_skip, n_msgs))
+	;
+      else if ((err = nl_msg_parse (msg_info->msg, nl_route_dispatch,
+				    msg_info)) < 0)
 	NL_ERROR ("Unable to parse object: %s", nl_geterror (err));
       nlmsg_free (msg_info->msg);
-      if (++n_msgs >= nm->batch_size)
+      if (++n_msgs >= n_batch)
 	break;
     }
 
+  nm->batch_active = 0;
+  nl_barrier_release_held ();
+
   /* remove the messages we processed from the head of the queue */
   if (n_msgs)
     vec_delete (nm->nl_msg_queue, n_msgs, 0);
 
-  NL_DBG ("Processed %u messages", n_msgs);
+  NL_DBG ("Processed %u messages, %u superseded routes skipped", n_msgs,
+	  n_skipped);
 
   lcp_set_netlink_processing_active (0);
 
@@ -825,7 +1023,7 @@ lcp_nl_set_batch_delay (u32 batch_delay_ms)
 static clib_error_t *
 lcp_itf_pair_config (vlib_main_t *vm, unformat_input_t *input)
 {
-  u32 buf_size, batch_size, batch_delay_ms;
+  u32 buf_size, batch_size, batch_delay_ms, barrier_max_us;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -835,6 +1033,8 @@ lcp_itf_pair_config (vlib_main_t *vm, unformat_input_t *input)
 	lcp_nl_set_batch_size (batch_size);
       else if (unformat (input, "nl-batch-delay-ms %u", &batch_delay_ms))
 	lcp_nl_set_batch_delay (batch_delay_ms);
+      else if (unformat (input, "nl-batch-barrier-us %u", &barrier_max_us))
+	nl_main.batch_barrier_max_us = barrier_max_us;
       else
 	return clib_error_return (0, "invalid netlink option: %U",
 				  format_unformat_error, input);
@@ -37,6 +37,17 @@ masked_address64 (uint64_t addr, uint8_t len)
   return len == 64 ? addr : addr & ((1ull << (len)) - 1);
 }
 
+static void
+lpm_32_update_prefix_lengths (lpm_t *lpm)
+{
+  i32 len;
+
+  lpm->n_ip4_prefix_lengths = 0;
+  for (len = 32; len >= 0; len--)
+    if (lpm->prefix_length_refcount[len])
+      lpm->ip4_prefix_lengths[lpm->n_ip4_prefix_lengths++] = len;
+}
+
 static void
 lpm_32_add (lpm_t *lpm, void *addr_v, u8 pfxlen,
 	    u32 value)
@@ -60,6 +71,9 @@ lpm_32_add (lpm_t *lpm, void *addr_v, u8 pfxlen,
   }
   hash = hash_set(hash, key, value);
   lpm->hash[pfxlen] = hash;
+
+  if (!result && lpm->prefix_length_refcount[pfxlen]++ == 0)
+    lpm_32_update_prefix_lengths (lpm);
 }
 
 static void
@@ -72,25 +86,30 @@ lpm_32_delete (lpm_t *lpm, void *addr_v, u8 pfxlen)
   hash = lpm->hash[pfxlen];
   result = hash_get (hash, key);
   if (result)
-    hash_unset(hash, key);
+    {
+      hash_unset(hash, key);
+      ASSERT (lpm->prefix_length_refcount[pfxlen] > 0);
+      if (--lpm->prefix_length_refcount[pfxlen] == 0)
+	lpm_32_update_prefix_lengths (lpm);
+    }
   lpm->hash[pfxlen] = hash;
 }
 
 static u32
 lpm_32_lookup (lpm_t *lpm, void *addr_v, u8 pfxlen)
 {
-  uword * hash, * result;
-  i32 mask_len;
+  uword * result;
+  u32 i, mask_len;
   u32 key;
   ip4_address_t *addr = addr_v;
-  for (mask_len = pfxlen; mask_len >= 0; mask_len--) {
-    hash = lpm->hash[mask_len];
-    if (hash) {
-      key = masked_address32(addr->data_u32, mask_len);
-      result = hash_get (hash, key);
-      if (result != NULL) {
-	return (result[0]);
-      }
+  for (i = 0; i < lpm->n_ip4_prefix_lengths; i++) {
+    mask_len = lpm->ip4_prefix_lengths[i];
+    if (mask_len > pfxlen)
+      continue;
+    key = masked_address32(addr->data_u32, mask_len);
+    result = hash_get (lpm->hash[mask_len], key);
+    if (result != NULL) {
+      return (result[0]);
     }
   }
   return (~0);
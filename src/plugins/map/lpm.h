@@ -28,6 +28,9 @@ typedef struct lpm_ {
 
   /* IPv4 LPM */
   uword *hash[33];
+  /* prefix lengths in use, longest first, so lookups skip empty ones */
+  u8 ip4_prefix_lengths[33];
+  u8 n_ip4_prefix_lengths;
 
   /* IPv6 LPM */
   BVT (clib_bihash) bihash;
@@ -263,10 +263,11 @@ no_free_slots:
   co = ptd->copy_ops;
   while (n_copy_op >= 8)
     {
-      clib_prefetch_load (co[4].data);
-      clib_prefetch_load (co[5].data);
-      clib_prefetch_load (co[6].data);
-      clib_prefetch_load (co[7].data);
+      /* destination is the peer's shared memory, only written here */
+      clib_prefetch_store (co[4].data);
+      clib_prefetch_store (co[5].data);
+      clib_prefetch_store (co[6].data);
+      clib_prefetch_store (co[7].data);
 
       b0 = vlib_get_buffer (vm, ptd->buffers[co[0].buffer_vec_index]);
       b1 = vlib_get_buffer (vm, ptd->buffers[co[1].buffer_vec_index]);
@@ -330,9 +331,8 @@ retry:
   n_free = tail - mq->last_tail;
   if (n_free >= 16)
     {
-      vlib_buffer_free_from_ring_no_next (vm, mq->buffers,
-					  mq->last_tail & mask,
-					  ring_size, n_free);
+      vlib_buffer_free_from_ring_no_next_deferred (
+	vm, mq->buffers, mq->last_tail & mask, ring_size, n_free);
       mq->last_tail += n_free;
     }
 
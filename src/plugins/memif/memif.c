@@ -383,7 +383,6 @@ memif_connect (memif_if_t * mif)
 
 	      clib_memset (bt, 0, sizeof (*bt));
 	      bt->flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
-	      bt->total_length_not_including_first_buffer = 0;
 	      vnet_buffer (bt)->sw_if_index[VLIB_TX] = (u32) ~0;
 	      vec_validate_aligned (dma_info->data.desc_data,
 				    pow2_mask (max_log2_ring_sz),
@@ -1038,7 +1037,6 @@ memif_create_if (vlib_main_t *vm, memif_create_if_args_t *args)
 	  vlib_buffer_t *bt = &ptd->buffer_template;
 	  clib_memset (bt, 0, sizeof (vlib_buffer_t));
 	  bt->flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
-	  bt->total_length_not_including_first_buffer = 0;
 	  vnet_buffer (bt)->sw_if_index[VLIB_TX] = (u32) ~ 0;
 
 	  vec_validate_aligned (ptd->copy_ops, 0, CLIB_CACHE_LINE_BYTES);
@@ -128,7 +128,7 @@ memif_add_to_chain (vlib_main_t * vm, vlib_buffer_t * b, u32 * buffers,
     return;
 
   b->current_length -= bytes_left;
-  b->total_length_not_including_first_buffer = bytes_left;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = bytes_left;
 
   while (bytes_left)
     {
@@ -814,7 +814,7 @@ memif_device_input_zc_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       if (PREDICT_FALSE ((d0->flags & MEMIF_DESC_FLAG_NEXT) && n_slots))
 	{
 	  hb->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-	  hb->total_length_not_including_first_buffer = 0;
+	  vlib_buffer_cold (hb)->total_length_not_including_first_buffer = 0;
 	next_slot:
 	  s0 = cur_slot & mask;
 	  d0 = &ring->desc[s0];
@@ -828,7 +828,8 @@ memif_device_input_zc_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  b0 = vlib_get_buffer (vm, bi0);
 	  b0->current_data = start_offset;
 	  b0->current_length = d0->length;
-	  hb->total_length_not_including_first_buffer += d0->length;
+	  vlib_buffer_cold (hb)->total_length_not_including_first_buffer +=
+	    d0->length;
 	  n_rx_bytes += d0->length;
 
 	  cur_slot++;
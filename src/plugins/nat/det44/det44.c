@@ -140,10 +140,13 @@ snat_det_add_map (ip4_address_t * in_addr, u8 in_plen,
       vec_validate_init_empty (mp->sessions,
 			       DET44_SES_PER_USER * (1 << (32 - in_plen)) -
 			       1, empty_snat_det_session);
+      vec_validate (mp->ses_bitmap,
+		    DET44_SES_BITMAP_WORDS * (1 << (32 - in_plen)) - 1);
     }
   else
     {
       vec_free (mp->sessions);
+      vec_free (mp->ses_bitmap);
       vec_del1 (dm->det_maps, mp - dm->det_maps);
     }
 
@@ -313,6 +316,7 @@ det44_expire_walk_fn (vlib_main_t * vm, vlib_node_runtime_t * rt,
   det44_main_t *dm = &det44_main;
   snat_det_session_t *ses;
   snat_det_map_t *mp;
+  u32 w;
 
   while (1)
     {
@@ -327,12 +331,18 @@ det44_expire_walk_fn (vlib_main_t * vm, vlib_node_runtime_t * rt,
 
       pool_foreach (mp, dm->det_maps)
 	{
-	  vec_foreach (ses, mp->sessions)
+	  /* only occupied slots are visited */
+	  vec_foreach_index (w, mp->ses_bitmap)
 	    {
-	      // close expired sessions
-	      if (ses->in_port && (ses->expire < now))
+	      u32 i, base = w / DET44_SES_BITMAP_WORDS * DET44_SES_PER_USER +
+			    w % DET44_SES_BITMAP_WORDS * uword_bits;
+
+	      foreach_set_bit_index (i, mp->ses_bitmap[w])
 		{
-		  snat_det_ses_close (mp, ses);
+		  ses = mp->sessions + base + i;
+		  // close expired sessions
+		  if (ses->in_port && (ses->expire < now))
+		    snat_det_ses_close (mp, ses);
 		}
 	    }
 	}
@@ -434,6 +444,7 @@ det44_plugin_disable ()
   pool_foreach (mp, dm->det_maps)
    {
     vec_free (mp->sessions);
+    vec_free (mp->ses_bitmap);
   }
 
   det44_reset_timeouts ();
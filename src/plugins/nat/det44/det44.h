@@ -63,6 +63,10 @@ typedef enum
 
 #define DET44_SES_PER_USER 1000
 
+/* uwords of the per-user session slot bitmap */
+#define DET44_SES_BITMAP_WORDS                                                \
+  ((DET44_SES_PER_USER + uword_bits - 1) / uword_bits)
+
 typedef struct
 {
   u16 identifier;
@@ -123,6 +127,8 @@ typedef struct
   u32 ses_num;
   /* vector of sessions */
   snat_det_session_t *sessions;
+  /* used session slots, DET44_SES_BITMAP_WORDS per user */
+  uword *ses_bitmap;
 } snat_det_map_t;
 
 typedef struct
@@ -336,18 +342,32 @@ snat_det_user_ses_offset (ip4_address_t * addr, u8 plen)
     DET44_SES_PER_USER;
 }
 
+static_always_inline uword *
+snat_det_user_ses_bitmap (snat_det_map_t *dm, ip4_address_t *addr)
+{
+  return dm->ses_bitmap +
+	 snat_det_user_ses_offset (addr, dm->in_plen) / DET44_SES_PER_USER *
+	   DET44_SES_BITMAP_WORDS;
+}
+
+/* walk only the occupied session slots of a user */
+#define foreach_det44_user_session(ses, dm, in_addr)                         \
+  for (uword _w = 0, *_bmp = snat_det_user_ses_bitmap (dm, in_addr),        \
+	     _off = snat_det_user_ses_offset (in_addr, (dm)->in_plen), _i;    \
+       _w < DET44_SES_BITMAP_WORDS; _w++)                                     \
+    foreach_set_bit_index (_i, _bmp[_w])                                      \
+      if ((ses = (dm)->sessions + _off + _w * uword_bits + _i), 1)
+
 static_always_inline snat_det_session_t *
 snat_det_get_ses_by_out (snat_det_map_t * dm, ip4_address_t * in_addr,
 			 u64 out_key)
 {
-  u32 user_offset;
-  u16 i;
+  snat_det_session_t *ses;
 
-  user_offset = snat_det_user_ses_offset (in_addr, dm->in_plen);
-  for (i = 0; i < DET44_SES_PER_USER; i++)
+  foreach_det44_user_session (ses, dm, in_addr)
     {
-      if (dm->sessions[i + user_offset].out.as_u64 == out_key)
-	return &dm->sessions[i + user_offset];
+      if (ses->out.as_u64 == out_key)
+	return ses;
     }
 
   return 0;
@@ -358,17 +378,13 @@ snat_det_find_ses_by_in (snat_det_map_t * dm, ip4_address_t * in_addr,
 			 u16 in_port, snat_det_out_key_t out_key)
 {
   snat_det_session_t *ses;
-  u32 user_offset;
-  u16 i;
 
-  user_offset = snat_det_user_ses_offset (in_addr, dm->in_plen);
-  for (i = 0; i < DET44_SES_PER_USER; i++)
+  foreach_det44_user_session (ses, dm, in_addr)
     {
-      ses = &dm->sessions[i + user_offset];
       if (ses->in_port == in_port &&
 	  ses->out.ext_host_addr.as_u32 == out_key.ext_host_addr.as_u32 &&
 	  ses->out.ext_host_port == out_key.ext_host_port)
-	return &dm->sessions[i + user_offset];
+	return ses;
     }
 
   return 0;
@@ -379,23 +395,31 @@ snat_det_ses_create (u32 thread_index, snat_det_map_t * dm,
 		     ip4_address_t * in_addr, u16 in_port,
 		     snat_det_out_key_t * out)
 {
+  snat_det_session_t *ses;
+  uword *bmp;
   u32 user_offset;
-  u16 i;
+  uword avail, i;
 
   user_offset = snat_det_user_ses_offset (in_addr, dm->in_plen);
+  bmp = snat_det_user_ses_bitmap (dm, in_addr);
 
-  for (i = 0; i < DET44_SES_PER_USER; i++)
+  for (u32 w = 0; w < DET44_SES_BITMAP_WORDS; w++)
     {
-      if (!dm->sessions[i + user_offset].in_port)
+      avail = ~bmp[w];
+      if (w == DET44_SES_BITMAP_WORDS - 1 && DET44_SES_PER_USER % uword_bits)
+	avail &= pow2_mask (DET44_SES_PER_USER % uword_bits);
+
+      foreach_set_bit_index (i, avail)
 	{
-	  if (clib_atomic_bool_cmp_and_swap
-	      (&dm->sessions[i + user_offset].in_port, 0, in_port))
+	  ses = &dm->sessions[user_offset + w * uword_bits + i];
+	  if (clib_atomic_bool_cmp_and_swap (&ses->in_port, 0, in_port))
 	    {
-	      dm->sessions[i + user_offset].out.as_u64 = out->as_u64;
-	      dm->sessions[i + user_offset].state = DET44_SESSION_UNKNOWN;
-	      dm->sessions[i + user_offset].expire = 0;
+	      ses->out.as_u64 = out->as_u64;
+	      ses->state = DET44_SESSION_UNKNOWN;
+	      ses->expire = 0;
+	      clib_atomic_fetch_or (&bmp[w], (uword) 1 << i);
 	      clib_atomic_add_fetch (&dm->ses_num, 1);
-	      return &dm->sessions[i + user_offset];
+	      return ses;
 	    }
 	}
     }
@@ -409,9 +433,16 @@ snat_det_ses_create (u32 thread_index, snat_det_map_t * dm,
 static_always_inline void
 snat_det_ses_close (snat_det_map_t * dm, snat_det_session_t * ses)
 {
+  u32 index = ses - dm->sessions;
+  u32 slot = index % DET44_SES_PER_USER;
+  uword *bmp = dm->ses_bitmap + index / DET44_SES_PER_USER *
+				  DET44_SES_BITMAP_WORDS +
+	       slot / uword_bits;
+
   if (clib_atomic_bool_cmp_and_swap (&ses->in_port, ses->in_port, 0))
     {
       ses->out.as_u64 = 0;
+      clib_atomic_fetch_and (bmp, ~((uword) 1 << (slot % uword_bits)));
       clib_atomic_add_fetch (&dm->ses_num, -1);
     }
 }
@@ -35,6 +35,7 @@ nat_ipfix_logging_main_t nat_ipfix_logging_main;
 #define MAX_FRAGMENTS_IP6_LEN 33
 #define NAT64_BIB_LEN 38
 #define NAT64_SES_LEN 62
+#define NAT44_PORT_BLOCK_LEN 29
 
 #define NAT44_SESSION_CREATE_FIELD_COUNT 8
 #define NAT_ADDRESSES_EXHAUTED_FIELD_COUNT 3
@@ -44,6 +45,7 @@ nat_ipfix_logging_main_t nat_ipfix_logging_main;
 #define MAX_FRAGMENTS_FIELD_COUNT 5
 #define NAT64_BIB_FIELD_COUNT 8
 #define NAT64_SES_FIELD_COUNT 12
+#define NAT44_PORT_BLOCK_FIELD_COUNT 9
 
 typedef struct
 {
@@ -194,6 +196,13 @@ nat_template_rewrite (ipfix_exporter_t *exp, flow_report_t *fr,
       update_template_id(&silm->nat64_ses_template_id,
                          fr->template_id);
     }
+  else if (event == NAT_PORT_BLOCK_ALLOC)
+    {
+      field_count = NAT44_PORT_BLOCK_FIELD_COUNT;
+
+      update_template_id (&silm->nat44_port_block_template_id,
+			  fr->template_id);
+    }
   else if (event == QUOTA_EXCEEDED)
     {
       if (quota_event == MAX_ENTRIES_PER_USER)
@@ -322,6 +331,27 @@ nat_template_rewrite (ipfix_exporter_t *exp, flow_report_t *fr,
       f->e_id_length = ipfix_e_id_length (0, ingressVRFID, 4);
       f++;
     }
+  else if (event == NAT_PORT_BLOCK_ALLOC)
+    {
+      f->e_id_length = ipfix_e_id_length (0, observationTimeMilliseconds, 8);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, natEvent, 1);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, sourceIPv4Address, 4);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, postNATSourceIPv4Address, 4);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, portRangeStart, 2);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, portRangeEnd, 2);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, portRangeStepSize, 2);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, portRangeNumPorts, 2);
+      f++;
+      f->e_id_length = ipfix_e_id_length (0, ingressVRFID, 4);
+      f++;
+    }
   else if (event == QUOTA_EXCEEDED)
     {
       if (quota_event == MAX_ENTRIES_PER_USER)
@@ -454,6 +484,16 @@ nat_template_rewrite_nat64_session (ipfix_exporter_t *exp, flow_report_t *fr,
 			       0);
 }
 
+u8 *
+nat_template_rewrite_nat44_port_block (ipfix_exporter_t *exp,
+				       flow_report_t *fr, u16 collector_port,
+				       ipfix_report_element_t *elts,
+				       u32 n_elts, u32 *stream_index)
+{
+  return nat_template_rewrite (exp, fr, collector_port, NAT_PORT_BLOCK_ALLOC,
+			       0);
+}
+
 static inline void
 nat_ipfix_header_create (flow_report_main_t * frm,
 			  vlib_buffer_t * b0, u32 * offset)
@@ -651,6 +691,114 @@ nat_ipfix_logging_nat44_ses (u32 thread_index, u8 nat_event, u32 src_ip,
   sitd->nat44_session_next_record_offset = offset;
 }
 
+static void
+nat_ipfix_logging_nat44_pb (u32 thread_index, u8 nat_event, u32 src_ip,
+			    u32 nat_src_ip, u16 start_port, u16 end_port,
+			    u32 fib_index, int do_flush)
+{
+  nat_ipfix_logging_main_t *silm = &nat_ipfix_logging_main;
+  nat_ipfix_per_thread_data_t *sitd = &silm->per_thread_data[thread_index];
+  flow_report_main_t *frm = &flow_report_main;
+  vlib_frame_t *f;
+  vlib_buffer_t *b0 = 0;
+  u32 bi0 = ~0;
+  u32 offset;
+  vlib_main_t *vm = vlib_get_main ();
+  u64 now;
+  u16 template_id;
+  u16 port;
+  u32 vrf_id;
+  ipfix_exporter_t *exp = pool_elt_at_index (frm->exporters, 0);
+
+  now = (u64) ((vlib_time_now (vm) - silm->vlib_time_0) * 1e3);
+  now += silm->milisecond_time_0;
+
+  b0 = sitd->nat44_port_block_buffer;
+
+  if (PREDICT_FALSE (b0 == 0))
+    {
+      if (do_flush)
+	return;
+
+      if (vlib_buffer_alloc (vm, &bi0, 1) != 1)
+	return;
+
+      b0 = sitd->nat44_port_block_buffer = vlib_get_buffer (vm, bi0);
+      offset = 0;
+    }
+  else
+    {
+      bi0 = vlib_get_buffer_index (vm, b0);
+      offset = sitd->nat44_port_block_next_record_offset;
+    }
+
+  f = sitd->nat44_port_block_frame;
+  if (PREDICT_FALSE (f == 0))
+    {
+      u32 *to_next;
+      f = vlib_get_frame_to_node (vm, ip4_lookup_node.index);
+      sitd->nat44_port_block_frame = f;
+      to_next = vlib_frame_vector_args (f);
+      to_next[0] = bi0;
+      f->n_vectors = 1;
+    }
+
+  if (PREDICT_FALSE (offset == 0))
+    nat_ipfix_header_create (frm, b0, &offset);
+
+  if (PREDICT_TRUE (do_flush == 0))
+    {
+      u64 time_stamp = clib_host_to_net_u64 (now);
+      clib_memcpy_fast (b0->data + offset, &time_stamp, sizeof (time_stamp));
+      offset += sizeof (time_stamp);
+
+      clib_memcpy_fast (b0->data + offset, &nat_event, sizeof (nat_event));
+      offset += sizeof (nat_event);
+
+      clib_memcpy_fast (b0->data + offset, &src_ip, sizeof (src_ip));
+      offset += sizeof (src_ip);
+
+      clib_memcpy_fast (b0->data + offset, &nat_src_ip, sizeof (nat_src_ip));
+      offset += sizeof (nat_src_ip);
+
+      port = clib_host_to_net_u16 (start_port);
+      clib_memcpy_fast (b0->data + offset, &port, sizeof (port));
+      offset += sizeof (port);
+
+      port = clib_host_to_net_u16 (end_port);
+      clib_memcpy_fast (b0->data + offset, &port, sizeof (port));
+      offset += sizeof (port);
+
+      /* step size */
+      port = clib_host_to_net_u16 (1);
+      clib_memcpy_fast (b0->data + offset, &port, sizeof (port));
+      offset += sizeof (port);
+
+      port = clib_host_to_net_u16 (end_port - start_port + 1);
+      clib_memcpy_fast (b0->data + offset, &port, sizeof (port));
+      offset += sizeof (port);
+
+      vrf_id = fib_table_get_table_id (fib_index, FIB_PROTOCOL_IP4);
+      vrf_id = clib_host_to_net_u32 (vrf_id);
+      clib_memcpy_fast (b0->data + offset, &vrf_id, sizeof (vrf_id));
+      offset += sizeof (vrf_id);
+
+      b0->current_length += NAT44_PORT_BLOCK_LEN;
+    }
+
+  if (PREDICT_FALSE (do_flush ||
+		     (offset + NAT44_PORT_BLOCK_LEN) > exp->path_mtu))
+    {
+      template_id =
+	clib_atomic_fetch_or (&silm->nat44_port_block_template_id, 0);
+      nat_ipfix_send (frm, f, b0, template_id);
+      sitd->nat44_port_block_frame = 0;
+      sitd->nat44_port_block_buffer = 0;
+      offset = 0;
+    }
+  sitd->nat44_port_block_next_record_offset = offset;
+}
+
 static void
 nat_ipfix_logging_addr_exhausted (u32 thread_index, u32 pool_id, int do_flush)
 {
@@ -1235,6 +1383,7 @@ nat_ipfix_flush (u32 thread_index)
                                 0, 0, 0, 0, 0, 0, 0, do_flush);
   nat_ipfix_logging_nat64_ses (thread_index,
                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, do_flush);
+  nat_ipfix_logging_nat44_pb (thread_index, 0, 0, 0, 0, 0, 0, do_flush);
 }
 
 int
@@ -1309,6 +1458,31 @@ nat_ipfix_logging_nat44_ses_delete (u32 thread_index, u32 src_ip,
 			       fib_index, 0);
 }
 
+/**
+ * @brief Generate NAT44 port block allocate and release events
+ *
+ * @param thread_index thread index
+ * @param src_ip       inside IPv4 address of the subscriber
+ * @param nat_src_ip   outside IPv4 address the block belongs to
+ * @param start_port   first port of the block
+ * @param end_port     last port of the block
+ * @param fib_index    inside FIB index
+ * @param is_alloc     non-zero value if allocate event otherwise release
+ */
+void
+nat_ipfix_logging_nat44_port_block (u32 thread_index, u32 src_ip,
+				    u32 nat_src_ip, u16 start_port,
+				    u16 end_port, u32 fib_index, u8 is_alloc)
+{
+  skip_if_disabled ();
+
+  nat_ipfix_logging_nat44_pb (thread_index,
+			      is_alloc ? NAT_PORT_BLOCK_ALLOC :
+					 NAT_PORT_BLOCK_DEALLOC,
+			      src_ip, nat_src_ip, start_port, end_port,
+			      fib_index, 0);
+}
+
 /**
  * @brief Generate NAT addresses exhausted event
  *
@@ -1579,6 +1753,11 @@ nat_ipfix_logging_enable_disable (int enable, u32 domain_id, u16 src_port)
       return -1;
     }
 
+  a.rewrite_callback = nat_template_rewrite_nat44_port_block;
+  rv = vnet_flow_report_add_del (exp, &a, NULL);
+  if (rv)
+    return -1;
+
   // if endpoint dependent per user max entries is also required
   /*
   a.rewrite_callback = nat_template_rewrite_max_entries_per_usr;
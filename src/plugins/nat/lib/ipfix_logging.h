@@ -32,6 +32,8 @@ typedef enum {
   NAT64_BIB_DELETE = 11,
   NAT_PORTS_EXHAUSTED = 12,
   QUOTA_EXCEEDED = 13,
+  NAT_PORT_BLOCK_ALLOC = 14,
+  NAT_PORT_BLOCK_DEALLOC = 15,
 } nat_event_t;
 
 typedef enum {
@@ -52,6 +54,7 @@ typedef struct {
   vlib_buffer_t *max_frags_ip6_buffer;
   vlib_buffer_t *nat64_bib_buffer;
   vlib_buffer_t *nat64_ses_buffer;
+  vlib_buffer_t *nat44_port_block_buffer;
 
   /** frames containing ipfix buffers */
   vlib_frame_t *nat44_session_frame;
@@ -63,6 +66,7 @@ typedef struct {
   vlib_frame_t *max_frags_ip6_frame;
   vlib_frame_t *nat64_bib_frame;
   vlib_frame_t *nat64_ses_frame;
+  vlib_frame_t *nat44_port_block_frame;
 
   /** next record offset */
   u32 nat44_session_next_record_offset;
@@ -74,6 +78,7 @@ typedef struct {
   u32 max_frags_ip6_next_record_offset;
   u32 nat64_bib_next_record_offset;
   u32 nat64_ses_next_record_offset;
+  u32 nat44_port_block_next_record_offset;
 
 } nat_ipfix_per_thread_data_t;
 
@@ -98,6 +103,7 @@ typedef struct {
   u16 max_frags_ip6_template_id;
   u16 nat64_bib_template_id;
   u16 nat64_ses_template_id;
+  u16 nat44_port_block_template_id;
 
   /** stream index */
   u32 stream_index;
@@ -128,6 +134,10 @@ void nat_ipfix_logging_nat44_ses_delete (u32 thread_index, u32 src_ip,
 					 u32 nat_src_ip, ip_protocol_t proto,
 					 u16 src_port, u16 nat_src_port,
 					 u32 fib_index);
+void nat_ipfix_logging_nat44_port_block (u32 thread_index, u32 src_ip,
+					 u32 nat_src_ip, u16 start_port,
+					 u16 end_port, u32 fib_index,
+					 u8 is_alloc);
 void nat_ipfix_logging_addresses_exhausted(u32 thread_index, u32 pool_id);
 void nat_ipfix_logging_max_entries_per_user(u32 thread_index,
                                              u32 limit, u32 src_ip);
@@ -150,6 +150,7 @@ VLIB_PLUGIN_REGISTER () = {
 static void nat44_ed_db_init ();
 static void nat44_ed_db_free ();
 static void nat44_ed_worker_db_free (snat_main_per_thread_data_t *tsm);
+static vlib_node_registration_t nat44_ed_expire_walk_process_node;
 
 static int nat44_ed_add_static_mapping_internal (
   ip4_address_t l_addr, ip4_address_t e_addr, u16 l_port, u16 e_port,
@@ -224,20 +225,20 @@ nat44_ed_free_session_data (snat_main_t *sm, snat_session_t *s,
     nat_affinity_unlock (s->ext_host_addr, s->out2in.addr, s->proto,
 			 s->out2in.port);
 
-  if (!is_ha)
-    nat_syslog_nat44_sdel (0, s->in2out.fib_index, &s->in2out.addr,
-			   s->in2out.port, &s->ext_host_nat_addr,
-			   s->ext_host_nat_port, &s->out2in.addr,
-			   s->out2in.port, &s->ext_host_addr, s->ext_host_port,
-			   s->proto, nat44_ed_is_twice_nat_session (s));
+  /* port block allocation logs blocks, not sessions */
+  if (is_ha || (s->flags & SNAT_SESSION_FLAG_PORT_BLOCK))
+    return;
 
-  if (!is_ha)
-    {
-      /* log NAT event */
-      nat_ipfix_logging_nat44_ses_delete (
-	thread_index, s->in2out.addr.as_u32, s->out2in.addr.as_u32, s->proto,
-	s->in2out.port, s->out2in.port, s->in2out.fib_index);
-    }
+  nat_syslog_nat44_sdel (0, s->in2out.fib_index, &s->in2out.addr,
+			 s->in2out.port, &s->ext_host_nat_addr,
+			 s->ext_host_nat_port, &s->out2in.addr, s->out2in.port,
+			 &s->ext_host_addr, s->ext_host_port, s->proto,
+			 nat44_ed_is_twice_nat_session (s));
+
+  /* log NAT event */
+  nat_ipfix_logging_nat44_ses_delete (
+    thread_index, s->in2out.addr.as_u32, s->out2in.addr.as_u32, s->proto,
+    s->in2out.port, s->out2in.port, s->in2out.fib_index);
 }
 
 static ip_interface_address_t *
@@ -501,6 +502,48 @@ nat44_ed_add_del_sm_fib_reg_entries (u32 sw_if_index, u8 is_add)
     }
 }
 
+static void
+nat44_ed_port_maps_alloc (snat_main_t *sm, snat_address_t *ap)
+{
+  u32 n_threads = clib_max (1, vec_len (sm->workers));
+  u32 n_words = round_pow2 (sm->port_per_thread, uword_bits) / uword_bits;
+  nat44_ed_port_map_t *pm;
+  u32 i;
+
+  vec_validate (ap->port_maps, n_threads * NAT44_ED_PORT_MAP_N_PROTO - 1);
+  vec_foreach (pm, ap->port_maps)
+    {
+      vec_validate (pm->used, n_words - 1);
+      /* ports past the end of the thread range are never free */
+      for (i = sm->port_per_thread; i < n_words * uword_bits; i++)
+	pm->used = clib_bitmap_set (pm->used, i, 1);
+      for (i = 0; i < n_words; i++)
+	if (pm->used[i] != ~0ULL)
+	  pm->avail = clib_bitmap_set (pm->avail, i, 1);
+      pm->n_free = sm->port_per_thread;
+    }
+
+  hash_set (sm->port_maps_by_addr, ap->addr.as_u32,
+	    pointer_to_uword (ap->port_maps));
+}
+
+static void
+nat44_ed_port_maps_free (snat_main_t *sm, snat_address_t *ap)
+{
+  nat44_ed_port_map_t *pm;
+
+  if (!ap->port_maps)
+    return;
+
+  hash_unset (sm->port_maps_by_addr, ap->addr.as_u32);
+  vec_foreach (pm, ap->port_maps)
+    {
+      vec_free (pm->used);
+      clib_bitmap_free (pm->avail);
+    }
+  vec_free (ap->port_maps);
+}
+
 int
 nat44_ed_add_address (ip4_address_t *addr, u32 vrf_id, u8 twice_nat)
 {
@@ -536,6 +579,7 @@ nat44_ed_add_address (ip4_address_t *addr, u32 vrf_id, u8 twice_nat)
   ap->addr_len = ~0;
   ap->fib_index = ~0;
   ap->addr = *addr;
+  ap->port_maps = 0;
 
   if (vrf_id != ~0)
     {
@@ -545,6 +589,7 @@ nat44_ed_add_address (ip4_address_t *addr, u32 vrf_id, u8 twice_nat)
 
   if (!twice_nat)
     {
+      nat44_ed_port_maps_alloc (sm, ap);
       // if we don't have enabled interface we don't add address
       // to fib
       nat44_ed_add_del_interface_fib_reg_entries (*addr, 1);
@@ -613,6 +658,8 @@ nat44_ed_del_address (ip4_address_t addr, u8 twice_nat)
       fib_table_unlock (a->fib_index, FIB_PROTOCOL_IP4, sm->fib_src_low);
     }
 
+  nat44_ed_port_maps_free (sm, a);
+
   if (!twice_nat)
     {
       vec_del1 (sm->addresses, j);
@@ -2432,8 +2479,15 @@ nat44_plugin_enable (nat44_config_t c)
 
   fail_if_enabled ();
 
+  if (c.port_block_size > sm->port_per_thread)
+    {
+      nat_log_err ("port block size exceeds ports per thread");
+      return VNET_API_ERROR_INVALID_VALUE;
+    }
+
   sm->forwarding_enabled = 0;
   sm->mss_clamping = 0;
+  sm->port_block_size = c.port_block_size;
 
   if (!c.sessions)
     c.sessions = 63 * 1024;
@@ -2493,6 +2547,8 @@ nat44_plugin_enable (nat44_config_t c)
     }
 
   sm->enabled = 1;
+  vlib_process_signal_event (vlib_get_main (),
+			     nat44_ed_expire_walk_process_node.index, 0, 0);
   sm->rconfig = c;
 
   return 0;
@@ -2702,6 +2758,7 @@ nat44_plugin_disable ()
   nat_affinity_disable ();
 
   sm->forwarding_enabled = 0;
+  sm->port_block_size = 0;
   sm->enabled = 0;
 
   return error;
@@ -3297,6 +3354,11 @@ nat44_ed_worker_db_init (snat_main_per_thread_data_t *tsm, u32 translations)
   pool_get (tsm->lru_pool, head);
   tsm->unk_proto_lru_head_index = head - tsm->lru_pool;
   clib_dlist_init (tsm->lru_pool, tsm->unk_proto_lru_head_index);
+
+  tsm->timer_wheel = clib_mem_alloc (sizeof (*tsm->timer_wheel));
+  tw_timer_wheel_init_1t_3w_1024sl_ov (tsm->timer_wheel, 0, 1.0,
+				       NAT44_ED_EXPIRE_WALK_BATCH);
+  vec_reset_length (tsm->expired_sessions);
 }
 
 static void
@@ -3327,11 +3389,138 @@ nat44_ed_db_init ()
 static void
 nat44_ed_worker_db_free (snat_main_per_thread_data_t *tsm)
 {
+  uword key, value;
+
   pool_free (tsm->lru_pool);
   pool_free (tsm->sessions);
   pool_free (tsm->per_vrf_sessions_pool);
+
+  if (tsm->timer_wheel)
+    {
+      tw_timer_wheel_free_1t_3w_1024sl_ov (tsm->timer_wheel);
+      clib_mem_free (tsm->timer_wheel);
+      tsm->timer_wheel = 0;
+    }
+  vec_free (tsm->expired_sessions);
+
+  hash_foreach (key, value, tsm->pba_blocks_by_addr,
+    ({
+      uword *blocks = uword_to_pointer (value, uword *);
+      clib_bitmap_free (blocks);
+    }));
+  hash_free (tsm->pba_blocks_by_addr);
+  hash_free (tsm->pba_user_by_key);
+  pool_free (tsm->pba_users);
+}
+
+/* Expire sessions whose timers fired, at most NAT44_ED_EXPIRE_WALK_BATCH of
+ * them per call. Timer only marks a candidate, session which has seen traffic
+ * since the timer was armed gets its timer re-armed for the remaining time.
+ * Returns number of sessions left for next call. */
+static u32
+nat44_ed_expire_sessions (snat_main_t *sm, u32 thread_index, f64 now)
+{
+  snat_main_per_thread_data_t *tsm =
+    vec_elt_at_index (sm->per_thread_data, thread_index);
+  u32 n_left = NAT44_ED_EXPIRE_WALK_BATCH;
+  snat_session_t *s;
+  u32 *si, timeout;
+  f64 expire;
+
+  if (vec_len (tsm->expired_sessions) == 0)
+    {
+      tsm->expired_sessions = tw_timer_expire_timers_vec_1t_3w_1024sl_ov (
+	tsm->timer_wheel, now, tsm->expired_sessions);
+
+      /* timers are gone, sessions reused or re-armed before they are
+       * processed are recognized by valid timer handle */
+      vec_foreach (si, tsm->expired_sessions)
+	pool_elt_at_index (tsm->sessions, si[0])->timer_handle = ~0;
+    }
+
+  while (n_left && vec_len (tsm->expired_sessions))
+    {
+      u32 session_index = vec_pop (tsm->expired_sessions);
+
+      if (pool_is_free_index (tsm->sessions, session_index))
+	continue;
+
+      s = pool_elt_at_index (tsm->sessions, session_index);
+      if (s->timer_handle != ~0)
+	continue;
+
+      n_left--;
+      timeout = nat44_session_get_timeout (sm, s);
+      expire = s->last_heard + (f64) timeout;
+      if (expire > now)
+	{
+	  nat_ed_session_timer_start (tsm, s, (u32) (expire - now) + 1);
+	  continue;
+	}
+
+      nat44_ed_free_session_data (sm, s, thread_index, 0);
+      nat_ed_session_delete (sm, s, thread_index, 1);
+    }
+
+  return vec_len (tsm->expired_sessions);
+}
+
+static uword
+nat44_ed_expire_walk_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
+			 vlib_frame_t *f)
+{
+  snat_main_t *sm = &snat_main;
+  u32 thread_index = vm->thread_index;
+
+  if (!sm->enabled || thread_index >= vec_len (sm->per_thread_data))
+    return 0;
+
+  /* backlog left, continue on next loop instead of waiting for next tick */
+  if (nat44_ed_expire_sessions (sm, thread_index, vlib_time_now (vm)))
+    vlib_node_set_interrupt_pending (vm, node->node_index);
+
+  return 0;
 }
 
+VLIB_REGISTER_NODE (nat44_ed_expire_walk_node) = {
+  .function = nat44_ed_expire_walk_fn,
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+  .name = "nat44-ed-expire-walk",
+};
+
+static uword
+nat44_ed_expire_walk_process_fn (vlib_main_t *vm, vlib_node_runtime_t *rt,
+				 vlib_frame_t *f)
+{
+  snat_main_t *sm = &snat_main;
+  u32 ti;
+
+  while (1)
+    {
+      if (sm->enabled)
+	vlib_process_wait_for_event_or_clock (vm, 1.0);
+      else
+	vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, 0);
+
+      if (!sm->enabled)
+	continue;
+
+      for (ti = 0; ti < vec_len (sm->per_thread_data); ti++)
+	vlib_node_set_interrupt_pending (vlib_get_main_by_index (ti),
+					 nat44_ed_expire_walk_node.index);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (nat44_ed_expire_walk_process_node, static) = {
+  .function = nat44_ed_expire_walk_process_fn,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "nat44-ed-expire-walk-process",
+};
+
 static void
 nat44_ed_flow_hash_free ()
 {
@@ -3358,10 +3547,20 @@ void
 nat44_ed_sessions_clear ()
 {
   snat_main_t *sm = &snat_main;
+  snat_address_t *a;
 
   nat44_ed_db_free ();
   nat44_ed_db_init ();
   vlib_zero_simple_counter (&sm->total_sessions, 0);
+
+  /* sessions are gone without releasing their ports */
+  vec_foreach (a, sm->addresses)
+    {
+      if (!a->port_maps)
+	continue;
+      nat44_ed_port_maps_free (sm, a);
+      nat44_ed_port_maps_alloc (sm, a);
+    }
 }
 
 static void
@@ -27,6 +27,7 @@
 #include <vppinfra/bihash_16_8.h>
 #include <vppinfra/hash.h>
 #include <vppinfra/dlist.h>
+#include <vppinfra/tw_timer_1t_3w_1024sl_ov.h>
 #include <vppinfra/error.h>
 #include <vlibapi/api.h>
 
@@ -40,6 +41,10 @@
  * as if there were no free ports available to conserve resources */
 #define ED_PORT_ALLOC_ATTEMPTS (10)
 
+/* max number of sessions expired by one run of the expire walk node, the
+ * rest is left for the next run */
+#define NAT44_ED_EXPIRE_WALK_BATCH 1024
+
 /* system ports range is 0-1023, first user port is 1024 per
  * https://www.rfc-editor.org/rfc/rfc6335#section-6
  */
@@ -67,6 +72,9 @@ typedef struct
   u32 inside_vrf;
   u32 outside_vrf;
   u32 sessions;
+  /* ports per block handed out to inside address, 0 disables port block
+   * allocation */
+  u16 port_block_size;
 } nat44_config_t;
 
 typedef enum
@@ -168,6 +176,8 @@ format_function_t format_nat44_ed_tcp_state;
 #define SNAT_SESSION_FLAG_AFFINITY	     (1 << 6)
 #define SNAT_SESSION_FLAG_EXACT_ADDRESS	     (1 << 7)
 #define SNAT_SESSION_FLAG_HAIRPINNING	     (1 << 8)
+#define SNAT_SESSION_FLAG_PORT_MAP	     (1 << 9)
+#define SNAT_SESSION_FLAG_PORT_BLOCK	     (1 << 10)
 
 /* NAT interface flags */
 #define NAT_INTERFACE_FLAG_IS_INSIDE 1
@@ -335,9 +345,32 @@ typedef CLIB_PACKED(struct
   /* per vrf sessions index */
   u32 per_vrf_sessions_index;
 
+  /* expiry timer handle, ~0 if not running */
+  u32 timer_handle;
+
   u32 thread_index;
 }) snat_session_t;
 
+/* Map of outside address ports handed out to dynamic sessions, one per
+ * address, thread and protocol. Each thread owns disjoint port range of the
+ * address, so maps are updated without locking. */
+typedef struct
+{
+  /* bit set for each port of the thread range in use */
+  uword *used;
+  /* bit set for each word of 'used' with at least one free port */
+  uword *avail;
+  u32 n_free;
+} nat44_ed_port_map_t;
+
+typedef enum
+{
+  NAT44_ED_PORT_MAP_TCP,
+  NAT44_ED_PORT_MAP_UDP,
+  NAT44_ED_PORT_MAP_ICMP,
+  NAT44_ED_PORT_MAP_N_PROTO,
+} nat44_ed_port_map_proto_t;
+
 typedef struct
 {
   ip4_address_t addr;
@@ -345,6 +378,9 @@ typedef struct
   u32 sw_if_index;
   u32 fib_index;
   u32 addr_len;
+  /* port maps indexed by snat_thread_index * NAT44_ED_PORT_MAP_N_PROTO +
+   * protocol, only for non twice-nat addresses */
+  nat44_ed_port_map_t *port_maps;
 } snat_address_t;
 
 typedef struct
@@ -446,6 +482,18 @@ typedef struct
   ip4_address_t addr;
 } snat_fib_entry_reg_t;
 
+/* Inside address which got a port block for its dynamic sessions */
+typedef struct
+{
+  ip4_address_t addr;
+  u32 fib_index;
+  /* outside address and block index within thread port range */
+  ip4_address_t out_addr;
+  u32 block;
+  /* number of sessions using ports of the block */
+  u32 n_sessions;
+} nat44_ed_pba_user_t;
+
 typedef struct
 {
   /* Session pool */
@@ -462,6 +510,18 @@ typedef struct
   u32 icmp_lru_head_index;
   u32 unk_proto_lru_head_index;
 
+  /* Session expiry timer wheel, 1 second ticks, and sessions whose timers
+   * fired but were not processed yet */
+  tw_timer_wheel_1t_3w_1024sl_ov_t *timer_wheel;
+  u32 *expired_sessions;
+
+  /* Port block allocation: inside addresses holding a block, keyed by
+   * fib index and address, and bitmap of blocks in use per outside
+   * address */
+  nat44_ed_pba_user_t *pba_users;
+  uword *pba_user_by_key;
+  uword *pba_blocks_by_addr;
+
   /* NAT thread index */
   u32 snat_thread_index;
 
@@ -519,6 +579,12 @@ typedef struct snat_main_s
   /* Endpoint dependent lookup table */
   clib_bihash_16_8_t flow_hash;
 
+  /* outside address -> port_maps of the address, used on session delete */
+  uword *port_maps_by_addr;
+
+  /* size of port blocks, 0 if port block allocation is disabled */
+  u16 port_block_size;
+
   // vector of fibs
   nat_fib_t *fibs;
 
@@ -676,6 +742,7 @@ extern vlib_node_registration_t nat_pre_out2in_node;
 extern vlib_node_registration_t nat44_ed_in2out_node;
 extern vlib_node_registration_t nat44_ed_in2out_output_node;
 extern vlib_node_registration_t nat44_ed_out2in_node;
+extern vlib_node_registration_t nat44_ed_expire_walk_node;
 
 extern vlib_node_registration_t snat_in2out_worker_handoff_node;
 extern vlib_node_registration_t snat_in2out_output_worker_handoff_node;
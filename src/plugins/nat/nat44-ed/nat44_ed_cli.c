@@ -39,6 +39,7 @@ nat44_ed_enable_disable_command_fn (vlib_main_t *vm, unformat_input_t *input,
 
   nat44_config_t c = { 0 };
   u8 enable_set = 0, enable = 0;
+  u32 port_block_size;
 
   if (!unformat_user (input, unformat_line_input, line_input))
     return clib_error_return (0, NAT44_ED_EXPECTED_ARGUMENT);
@@ -49,6 +50,15 @@ nat44_ed_enable_disable_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	;
       else if (unformat (line_input, "outside-vrf %u", &c.outside_vrf));
       else if (unformat (line_input, "sessions %u", &c.sessions));
+      else if (unformat (line_input, "port-block-size %u", &port_block_size))
+	{
+	  if (port_block_size == 0 || port_block_size > 0xffff)
+	    {
+	      error = clib_error_return (0, "invalid port block size");
+	      goto done;
+	    }
+	  c.port_block_size = port_block_size;
+	}
       else if (!enable_set)
 	{
 	  enable_set = 1;
@@ -487,6 +497,15 @@ nat44_show_summary_command_fn (vlib_main_t * vm, unformat_input_t * input,
     vlib_cli_output (vm, "max translations per thread: %u fib %u",
 		     sm->max_translations_per_fib[fib], fib);
 
+  if (sm->port_block_size)
+    {
+      vec_foreach (tsm, sm->per_thread_data)
+	count += pool_elts (tsm->pba_users);
+      vlib_cli_output (vm, "port block size: %u blocks in use: %u",
+		       sm->port_block_size, count);
+      count = 0;
+    }
+
   if (sm->num_workers > 1)
     {
       vec_foreach (tsm, sm->per_thread_data)
@@ -1874,6 +1893,9 @@ VLIB_CLI_COMMAND (nat44_ed_clear_sessions_command, static) = {
  *  vpp# nat44 plugin disable
  * To set inside-vrf outside-vrf, use:
  *  vpp# nat44 plugin enable inside-vrf <id> outside-vrf <id>
+ * To give each inside address a block of 256 ports for its dynamic sessions
+ * and log only port block allocation and release, use:
+ *  vpp# nat44 plugin enable port-block-size 256
  * @cliexend
 ?*/
 VLIB_CLI_COMMAND (nat44_ed_enable_disable_command, static) = {
@@ -1881,7 +1903,7 @@ VLIB_CLI_COMMAND (nat44_ed_enable_disable_command, static) = {
   .function = nat44_ed_enable_disable_command_fn,
   .short_help =
     "nat44 plugin <enable [sessions <max-number>] [inside-vrf <vrf-id>] "
-    "[outside-vrf <vrf-id>]>|disable",
+    "[outside-vrf <vrf-id>] [port-block-size <n>]>|disable",
 };
 
 /*?
@@ -112,15 +112,59 @@ nat_ed_alloc_addr_and_port_with_snat_address (
   /* first try port suggested by caller */
   u16 port = clib_net_to_host_u16 (*outside_port);
   u16 port_offset = port - port_thread_offset;
-  if (port < port_thread_offset ||
-      port >= port_thread_offset + port_per_thread)
+  u16 attempts = ED_PORT_ALLOC_ATTEMPTS;
+  nat44_ed_port_map_t *pm =
+    nat44_ed_port_map_get (a->port_maps, snat_thread_index, proto);
+  int in_range = port >= port_thread_offset &&
+		 port < port_thread_offset + port_per_thread;
+
+  /* take a port nobody else on this address uses, so flow hash add is
+   * expected to succeed at first try even when port range is almost
+   * exhausted, colliding ports (static mappings, sessions sharing port
+   * towards different destinations) are skipped */
+  if (pm)
+    {
+      u32 offset = in_range ? port_offset : ~0;
+
+      while (attempts > 0)
+	{
+	  if (offset == ~0 || nat44_ed_port_map_take (pm, offset))
+	    {
+	      offset =
+		nat44_ed_port_map_find (pm, random_u32 (&sm->random_seed));
+	      if (offset == ~0)
+		break;
+	      nat44_ed_port_map_take (pm, offset);
+	    }
+
+	  port = port_thread_offset + offset;
+	  if (IP_PROTOCOL_ICMP == proto)
+	    s->o2i.match.sport = clib_host_to_net_u16 (port);
+	  s->o2i.match.dport = clib_host_to_net_u16 (port);
+	  if (0 == nat_ed_ses_o2i_flow_hash_add_del (sm, thread_index, s, 2))
+	    {
+	      s->flags |= SNAT_SESSION_FLAG_PORT_MAP;
+	      *outside_addr = a->addr;
+	      *outside_port = clib_host_to_net_u16 (port);
+	      return 0;
+	    }
+	  nat44_ed_port_map_put (pm, offset);
+	  offset = ~0;
+	  --attempts;
+	}
+
+      /* range exhausted, fall back to sharing ports between sessions
+       * towards different destinations */
+      attempts = ED_PORT_ALLOC_ATTEMPTS;
+    }
+
+  if (!in_range)
     {
       /* need to pick a different port, suggested port doesn't fit in
        * this thread's port range */
       port_offset = snat_random_port (0, port_per_thread - 1);
       port = port_thread_offset + port_offset;
     }
-  u16 attempts = ED_PORT_ALLOC_ATTEMPTS;
   do
     {
       if (IP_PROTOCOL_ICMP == proto)
@@ -145,6 +189,139 @@ nat_ed_alloc_addr_and_port_with_snat_address (
   return 1;
 }
 
+/* find outside address with free port block for new user, addresses of the
+ * receiving fib are preferred over addresses not bound to any fib */
+static snat_address_t *
+nat44_ed_pba_block_alloc (snat_main_t *sm, snat_main_per_thread_data_t *tsm,
+			  u32 rx_fib_index, ip4_address_t s_addr, u32 *block)
+{
+  u32 n_blocks = sm->port_per_thread / sm->port_block_size;
+  u32 n_addresses = vec_len (sm->addresses);
+  snat_address_t *a, *found = 0;
+  u32 i, b, s_addr_offset;
+  uword *p, *blocks;
+
+  if (n_addresses == 0 || n_blocks == 0)
+    return 0;
+
+  s_addr_offset = (s_addr.as_u32 + (s_addr.as_u32 >> 8) +
+		   (s_addr.as_u32 >> 16) + (s_addr.as_u32 >> 24)) %
+		  n_addresses;
+
+  for (i = 0; i < n_addresses; i++)
+    {
+      a = sm->addresses + (s_addr_offset + i) % n_addresses;
+      if (a->fib_index != rx_fib_index && (a->fib_index != ~0 || found))
+	continue;
+
+      p = hash_get (tsm->pba_blocks_by_addr, a->addr.as_u32);
+      b = clib_bitmap_first_clear (p ? (uword *) p[0] : 0);
+      if (b >= n_blocks)
+	continue;
+
+      found = a;
+      *block = b;
+      if (a->fib_index == rx_fib_index)
+	break;
+    }
+
+  if (!found)
+    return 0;
+
+  p = hash_get (tsm->pba_blocks_by_addr, found->addr.as_u32);
+  blocks = clib_bitmap_set (p ? (uword *) p[0] : 0, *block, 1);
+  hash_set (tsm->pba_blocks_by_addr, found->addr.as_u32,
+	    pointer_to_uword (blocks));
+  return found;
+}
+
+/* Port block allocation. All dynamic sessions of an inside address get
+ * ports from the single block of consecutive ports handed out to it on its
+ * first session, only block allocation and release is logged */
+static int
+nat44_ed_pba_alloc_addr_and_port (snat_main_t *sm, u32 rx_fib_index, u8 proto,
+				  u32 thread_index, ip4_address_t s_addr,
+				  u32 snat_thread_index, snat_session_t *s,
+				  ip4_address_t *outside_addr,
+				  u16 *outside_port)
+{
+  snat_main_per_thread_data_t *tsm =
+    vec_elt_at_index (sm->per_thread_data, thread_index);
+  const nat_6t_t match = s->o2i.match;
+  u32 size = sm->port_block_size;
+  nat44_ed_pba_user_t *u;
+  nat44_ed_port_map_t *pm = 0;
+  snat_address_t *a;
+  u32 block, offset, i, r;
+  uword *p;
+  u16 port;
+
+  u = nat44_ed_pba_user_find (tsm, s_addr, rx_fib_index);
+  if (!u)
+    {
+      a = nat44_ed_pba_block_alloc (sm, tsm, rx_fib_index, s_addr, &block);
+      if (!a)
+	{
+	  nat_ipfix_logging_addresses_exhausted (thread_index, 0);
+	  return 1;
+	}
+
+      pool_get_zero (tsm->pba_users, u);
+      u->addr = s_addr;
+      u->fib_index = rx_fib_index;
+      u->out_addr = a->addr;
+      u->block = block;
+      hash_set (tsm->pba_user_by_key,
+		nat44_ed_pba_user_key (s_addr, rx_fib_index),
+		u - tsm->pba_users);
+
+      port = nat44_ed_pba_block_start (sm, block, snat_thread_index);
+      nat_ipfix_logging_nat44_port_block (thread_index, s_addr.as_u32,
+					  a->addr.as_u32, port,
+					  port + size - 1, rx_fib_index, 1);
+    }
+
+  p = hash_get (sm->port_maps_by_addr, u->out_addr.as_u32);
+  if (p)
+    pm = nat44_ed_port_map_get ((nat44_ed_port_map_t *) p[0],
+				snat_thread_index, proto);
+
+  if (pm)
+    {
+      s->o2i.match.daddr = u->out_addr;
+      r = random_u32 (&sm->random_seed) % size;
+
+      for (i = 0; i < size; i++)
+	{
+	  offset = u->block * size + (r + i) % size;
+	  if (nat44_ed_port_map_take (pm, offset))
+	    continue;
+
+	  port = ED_USER_PORT_OFFSET + sm->port_per_thread * snat_thread_index +
+		 offset;
+	  if (IP_PROTOCOL_ICMP == proto)
+	    s->o2i.match.sport = clib_host_to_net_u16 (port);
+	  s->o2i.match.dport = clib_host_to_net_u16 (port);
+	  if (0 == nat_ed_ses_o2i_flow_hash_add_del (sm, thread_index, s, 2))
+	    {
+	      s->flags |=
+		SNAT_SESSION_FLAG_PORT_MAP | SNAT_SESSION_FLAG_PORT_BLOCK;
+	      u->n_sessions++;
+	      *outside_addr = u->out_addr;
+	      *outside_port = clib_host_to_net_u16 (port);
+	      return 0;
+	    }
+	  nat44_ed_port_map_put (pm, offset);
+	}
+    }
+
+  /* block exhausted */
+  s->o2i.match = match;
+  if (u->n_sessions == 0)
+    nat44_ed_pba_user_free (sm, tsm, u, thread_index);
+  return 1;
+}
+
 static int
 nat_ed_alloc_addr_and_port (snat_main_t *sm, u32 rx_fib_index,
 			    u32 tx_sw_if_index, u32 nat_proto,
@@ -153,6 +330,11 @@ nat_ed_alloc_addr_and_port (snat_main_t *sm, u32 rx_fib_index,
 			    snat_session_t *s, ip4_address_t *outside_addr,
 			    u16 *outside_port)
 {
+  if (sm->port_block_size)
+    return nat44_ed_pba_alloc_addr_and_port (
+      sm, rx_fib_index, nat_proto, thread_index, s_addr, snat_thread_index, s,
+      outside_addr, outside_port);
+
   if (vec_len (sm->addresses) > 0)
     {
       u32 s_addr_offset = (s_addr.as_u32 + (s_addr.as_u32 >> 8) +
@@ -603,15 +785,19 @@ slow_path_ed (vlib_main_t *vm, snat_main_t *sm, vlib_buffer_t *b,
       goto error;
     }
 
-  /* log NAT event */
-  nat_ipfix_logging_nat44_ses_create (
-    thread_index, s->in2out.addr.as_u32, s->out2in.addr.as_u32, s->proto,
-    s->in2out.port, s->out2in.port, s->in2out.fib_index);
-
-  nat_syslog_nat44_sadd (0, s->in2out.fib_index, &s->in2out.addr,
-			 s->in2out.port, &s->ext_host_nat_addr,
-			 s->ext_host_nat_port, &s->out2in.addr, s->out2in.port,
-			 &s->ext_host_addr, s->ext_host_port, s->proto, 0);
+  /* log NAT event, sessions from port blocks are covered by block log */
+  if (!(s->flags & SNAT_SESSION_FLAG_PORT_BLOCK))
+    {
+      nat_ipfix_logging_nat44_ses_create (
+	thread_index, s->in2out.addr.as_u32, s->out2in.addr.as_u32, s->proto,
+	s->in2out.port, s->out2in.port, s->in2out.fib_index);
+
+      nat_syslog_nat44_sadd (0, s->in2out.fib_index, &s->in2out.addr,
+			     s->in2out.port, &s->ext_host_nat_addr,
+			     s->ext_host_nat_port, &s->out2in.addr,
+			     s->out2in.port, &s->ext_host_addr,
+			     s->ext_host_port, s->proto, 0);
+    }
 
   per_vrf_sessions_register_session (s, thread_index);
 
@@ -310,6 +310,197 @@ nat_ed_ses_o2i_flow_hash_add_del (snat_main_t *sm, u32 thread_idx,
   return clib_bihash_add_del_16_8 (&sm->flow_hash, &kv, is_add);
 }
 
+static_always_inline nat44_ed_port_map_t *
+nat44_ed_port_map_get (nat44_ed_port_map_t *port_maps, u32 snat_thread_index,
+		       ip_protocol_t proto)
+{
+  nat44_ed_port_map_proto_t p;
+
+  switch (proto)
+    {
+    case IP_PROTOCOL_TCP:
+      p = NAT44_ED_PORT_MAP_TCP;
+      break;
+    case IP_PROTOCOL_UDP:
+      p = NAT44_ED_PORT_MAP_UDP;
+      break;
+    case IP_PROTOCOL_ICMP:
+      p = NAT44_ED_PORT_MAP_ICMP;
+      break;
+    default:
+      return 0;
+    }
+
+  if (port_maps == 0)
+    return 0;
+
+  return port_maps + snat_thread_index * NAT44_ED_PORT_MAP_N_PROTO + p;
+}
+
+/* mark port offset within thread range as used, fails if it already is */
+static_always_inline int
+nat44_ed_port_map_take (nat44_ed_port_map_t *pm, u32 offset)
+{
+  uword wi = offset / uword_bits;
+  uword bit = 1ULL << (offset % uword_bits);
+
+  if (pm->used[wi] & bit)
+    return -1;
+
+  pm->used[wi] |= bit;
+  if (pm->used[wi] == ~0ULL)
+    pm->avail[wi / uword_bits] &= ~(1ULL << (wi % uword_bits));
+  pm->n_free--;
+  return 0;
+}
+
+static_always_inline void
+nat44_ed_port_map_put (nat44_ed_port_map_t *pm, u32 offset)
+{
+  uword wi = offset / uword_bits;
+  uword bit = 1ULL << (offset % uword_bits);
+
+  ASSERT (pm->used[wi] & bit);
+  pm->used[wi] &= ~bit;
+  pm->avail[wi / uword_bits] |= 1ULL << (wi % uword_bits);
+  pm->n_free++;
+}
+
+/* find free port offset, search starts at random word and bit so ports are
+ * not handed out in predictable order, returns ~0 if range is exhausted */
+static_always_inline u32
+nat44_ed_port_map_find (nat44_ed_port_map_t *pm, u32 rnd)
+{
+  uword wi, free, rot;
+  u32 r;
+
+  if (pm->n_free == 0)
+    return ~0;
+
+  wi = clib_bitmap_next_set (pm->avail, (rnd & 0xffff) % vec_len (pm->used));
+  if (wi == ~0)
+    wi = clib_bitmap_first_set (pm->avail);
+
+  free = ~pm->used[wi];
+  r = (rnd >> 16) % uword_bits;
+  rot = r ? (free >> r) | (free << (uword_bits - r)) : free;
+  return wi * uword_bits + (count_trailing_zeros (rot) + r) % uword_bits;
+}
+
+/* return outside port of session allocated from port map */
+static_always_inline void
+nat44_ed_port_map_release (snat_main_t *sm, snat_session_t *s,
+			   u32 snat_thread_index)
+{
+  uword *p = hash_get (sm->port_maps_by_addr, s->out2in.addr.as_u32);
+  nat44_ed_port_map_t *pm;
+  u32 offset;
+
+  if (!p)
+    return;
+
+  pm = nat44_ed_port_map_get ((nat44_ed_port_map_t *) p[0], snat_thread_index,
+			      s->proto);
+  offset = clib_net_to_host_u16 (s->out2in.port) - ED_USER_PORT_OFFSET -
+	   sm->port_per_thread * snat_thread_index;
+  if (pm && offset < sm->port_per_thread)
+    nat44_ed_port_map_put (pm, offset);
+}
+
+static_always_inline u64
+nat44_ed_pba_user_key (ip4_address_t addr, u32 fib_index)
+{
+  return (u64) fib_index << 32 | addr.as_u32;
+}
+
+static_always_inline nat44_ed_pba_user_t *
+nat44_ed_pba_user_find (snat_main_per_thread_data_t *tsm, ip4_address_t addr,
+			u32 fib_index)
+{
+  uword *p =
+    hash_get (tsm->pba_user_by_key, nat44_ed_pba_user_key (addr, fib_index));
+  return p ? pool_elt_at_index (tsm->pba_users, p[0]) : 0;
+}
+
+/* first outside port of port block */
+static_always_inline u16
+nat44_ed_pba_block_start (snat_main_t *sm, u32 block, u32 snat_thread_index)
+{
+  return ED_USER_PORT_OFFSET + sm->port_per_thread * snat_thread_index +
+	 block * sm->port_block_size;
+}
+
+/* free port block of the user and log it, called once its last session is
+ * gone */
+static_always_inline void
+nat44_ed_pba_user_free (snat_main_t *sm, snat_main_per_thread_data_t *tsm,
+			nat44_ed_pba_user_t *u, u32 thread_index)
+{
+  u16 start = nat44_ed_pba_block_start (sm, u->block, tsm->snat_thread_index);
+  uword *p, *blocks;
+
+  nat_ipfix_logging_nat44_port_block (
+    thread_index, u->addr.as_u32, u->out_addr.as_u32, start,
+    start + sm->port_block_size - 1, u->fib_index, 0);
+
+  p = hash_get (tsm->pba_blocks_by_addr, u->out_addr.as_u32);
+  if (p)
+    {
+      blocks = clib_bitmap_set ((uword *) p[0], u->block, 0);
+      hash_set (tsm->pba_blocks_by_addr, u->out_addr.as_u32,
+		pointer_to_uword (blocks));
+    }
+
+  hash_unset (tsm->pba_user_by_key,
+	      nat44_ed_pba_user_key (u->addr, u->fib_index));
+  pool_put (tsm->pba_users, u);
+}
+
+static_always_inline void
+nat44_ed_pba_session_release (snat_main_t *sm,
+			      snat_main_per_thread_data_t *tsm,
+			      snat_session_t *s, u32 thread_index)
+{
+  nat44_ed_pba_user_t *u;
+
+  u = nat44_ed_pba_user_find (tsm, s->in2out.addr, s->in2out.fib_index);
+  if (!u)
+    return;
+
+  ASSERT (u->n_sessions);
+  if (--u->n_sessions == 0)
+    nat44_ed_pba_user_free (sm, tsm, u, thread_index);
+}
+
+static_always_inline void
+nat_ed_session_timer_start (snat_main_per_thread_data_t *tsm,
+			    snat_session_t *s, u32 timeout)
+{
+  s->timer_handle = tw_timer_start_1t_3w_1024sl_ov (
+    tsm->timer_wheel, s - tsm->sessions, 0, clib_max (timeout, 1));
+}
+
+static_always_inline void
+nat_ed_session_timer_update (snat_main_per_thread_data_t *tsm,
+			     snat_session_t *s, u32 timeout)
+{
+  if (s->timer_handle == ~0)
+    nat_ed_session_timer_start (tsm, s, timeout);
+  else
+    tw_timer_update_1t_3w_1024sl_ov (tsm->timer_wheel, s->timer_handle,
+				     clib_max (timeout, 1));
+}
+
+static_always_inline void
+nat_ed_session_timer_stop (snat_main_per_thread_data_t *tsm,
+			   snat_session_t *s)
+{
+  if (s->timer_handle == ~0)
+    return;
+  tw_timer_stop_1t_3w_1024sl_ov (tsm->timer_wheel, s->timer_handle);
+  s->timer_handle = ~0;
+}
+
 always_inline void
 nat_ed_session_delete (snat_main_t *sm, snat_session_t *ses, u32 thread_index,
 		       int lru_delete
@@ -318,6 +509,14 @@ nat_ed_session_delete (snat_main_t *sm, snat_session_t *ses, u32 thread_index,
   snat_main_per_thread_data_t *tsm =
     vec_elt_at_index (sm->per_thread_data, thread_index);
 
+  if (ses->flags & SNAT_SESSION_FLAG_PORT_MAP)
+    nat44_ed_port_map_release (sm, ses, tsm->snat_thread_index);
+
+  if (ses->flags & SNAT_SESSION_FLAG_PORT_BLOCK)
+    nat44_ed_pba_session_release (sm, tsm, ses, thread_index);
+
+  nat_ed_session_timer_stop (tsm, ses);
+
   if (lru_delete)
     {
       clib_dlist_remove (tsm->lru_pool, ses->lru_index);
@@ -388,14 +587,29 @@ nat_ed_session_alloc (snat_main_t *sm, u32 thread_index, f64 now, u8 proto)
 {
   snat_session_t *s;
   snat_main_per_thread_data_t *tsm = &sm->per_thread_data[thread_index];
-
-  nat_lru_free_one (sm, thread_index, now);
+  u32 timeout;
 
   pool_get (tsm->sessions, s);
   clib_memset (s, 0, sizeof (*s));
 
   nat_ed_lru_insert (tsm, s, now, proto);
 
+  /* timer is armed with the shortest timeout for the protocol, longer
+   * timeouts (established TCP) are handled by re-arming on expiry */
+  switch (proto)
+    {
+    case IP_PROTOCOL_TCP:
+      timeout = sm->timeouts.tcp.transitory;
+      break;
+    case IP_PROTOCOL_ICMP:
+      timeout = sm->timeouts.icmp;
+      break;
+    default:
+      timeout = sm->timeouts.udp;
+      break;
+    }
+  nat_ed_session_timer_start (tsm, s, timeout);
+
   s->ha_last_refreshed = now;
   vlib_set_simple_counter (&sm->total_sessions, thread_index, 0,
 			   pool_elts (tsm->sessions));
@@ -703,6 +917,9 @@ is_interface_addr (snat_main_t *sm, vlib_node_runtime_t *node,
 always_inline void
 nat44_ed_session_reopen (u32 thread_index, snat_session_t *s)
 {
+  if (s->flags & SNAT_SESSION_FLAG_PORT_BLOCK)
+    goto done;
+
   nat_syslog_nat44_sdel (0, s->in2out.fib_index, &s->in2out.addr,
 			 s->in2out.port, &s->ext_host_nat_addr,
 			 s->ext_host_nat_port, &s->out2in.addr, s->out2in.port,
@@ -720,6 +937,7 @@ nat44_ed_session_reopen (u32 thread_index, snat_session_t *s)
 			 s->in2out.port, &s->ext_host_nat_addr,
 			 s->ext_host_nat_port, &s->out2in.addr, s->out2in.port,
 			 &s->ext_host_addr, s->ext_host_port, s->proto, 0);
+done:
   s->total_pkts = 0;
   s->total_bytes = 0;
 }
@@ -774,6 +992,7 @@ nat44_set_tcp_session_state (snat_main_t *sm, f64 now, snat_session_t *ses,
 	  // transitory timeout
 	  ses->last_heard = now;
 	  ses->lru_head_index = tsm->tcp_trans_lru_head_index;
+	  nat_ed_session_timer_update (tsm, ses, sm->timeouts.tcp.transitory);
 	}
       break;
     case NAT44_ED_TCP_STATE_CLOSING:
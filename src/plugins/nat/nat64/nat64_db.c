@@ -547,7 +547,6 @@ nat64_db_st_entry_find (nat64_db_t * db, ip46_address_t * l_addr,
 {
   nat64_db_st_entry_t *ste = 0;
   nat64_db_st_entry_t *st;
-  nat64_db_st_entry_key_t ste_key;
   clib_bihash_kv_48_8_t kv, value;
 
   switch (ip_proto_to_nat_proto (proto))
@@ -563,21 +562,8 @@ nat64_db_st_entry_find (nat64_db_t * db, ip46_address_t * l_addr,
       break;
     }
 
-  clib_memset (&ste_key, 0, sizeof (ste_key));
-  ste_key.l_addr.as_u64[0] = l_addr->as_u64[0];
-  ste_key.l_addr.as_u64[1] = l_addr->as_u64[1];
-  ste_key.r_addr.as_u64[0] = r_addr->as_u64[0];
-  ste_key.r_addr.as_u64[1] = r_addr->as_u64[1];
-  ste_key.fib_index = fib_index;
-  ste_key.l_port = l_port;
-  ste_key.r_port = r_port;
-  ste_key.proto = proto;
-  kv.key[0] = ste_key.as_u64[0];
-  kv.key[1] = ste_key.as_u64[1];
-  kv.key[2] = ste_key.as_u64[2];
-  kv.key[3] = ste_key.as_u64[3];
-  kv.key[4] = ste_key.as_u64[4];
-  kv.key[5] = ste_key.as_u64[5];
+  nat64_db_st_entry_key_make (&kv, l_addr, r_addr, l_port, r_port, proto,
+			      fib_index);
 
   if (!clib_bihash_search_48_8
       (is_ip6 ? &db->st.in2out : &db->st.out2in, &kv, &value))
@@ -279,6 +279,46 @@ nat64_db_st_entry_t *nat64_db_st_entry_create (u32 thread_index,
 void nat64_db_st_entry_free (u32 thread_index, nat64_db_t * db,
 			     nat64_db_st_entry_t * ste);
 
+/**
+ * @brief Build NAT64 session table lookup key.
+ */
+static_always_inline void
+nat64_db_st_entry_key_make (clib_bihash_kv_48_8_t *kv, ip46_address_t *l_addr,
+			    ip46_address_t *r_addr, u16 l_port, u16 r_port,
+			    u8 proto, u32 fib_index)
+{
+  nat64_db_st_entry_key_t *ste_key = (nat64_db_st_entry_key_t *) kv->key;
+
+  ste_key->l_addr.as_u64[0] = l_addr->as_u64[0];
+  ste_key->l_addr.as_u64[1] = l_addr->as_u64[1];
+  ste_key->r_addr.as_u64[0] = r_addr->as_u64[0];
+  ste_key->r_addr.as_u64[1] = r_addr->as_u64[1];
+  ste_key->as_u64[4] = 0;
+  ste_key->as_u64[5] = 0;
+  ste_key->fib_index = fib_index;
+  ste_key->l_port = l_port;
+  ste_key->r_port = r_port;
+  ste_key->proto = proto;
+}
+
+/**
+ * @brief Prefetch the NAT64 session table bucket for a lookup, so that a
+ * following nat64_db_st_entry_find with the same arguments does not stall
+ * on it. Used by the nodes to pipeline lookups across a frame.
+ */
+static_always_inline void
+nat64_db_st_entry_prefetch (nat64_db_t *db, ip46_address_t *l_addr,
+			    ip46_address_t *r_addr, u16 l_port, u16 r_port,
+			    u8 proto, u32 fib_index, u8 is_ip6)
+{
+  clib_bihash_48_8_t *h = is_ip6 ? &db->st.in2out : &db->st.out2in;
+  clib_bihash_kv_48_8_t kv;
+
+  nat64_db_st_entry_key_make (&kv, l_addr, r_addr, l_port, r_port, proto,
+			      fib_index);
+  clib_bihash_prefetch_bucket_48_8 (h, clib_bihash_hash_48_8 (&kv));
+}
+
 /**
  * @brief Find NAT64 session table entry.
  *
@@ -1017,6 +1017,26 @@ nat64_in2out_unk_proto_hairpinning (vlib_main_t * vm, vlib_buffer_t * b,
   return 0;
 }
 
+/* warm the session table bucket for a TCP/UDP packet ahead of time */
+static_always_inline void
+nat64_in2out_prefetch_session (nat64_db_t *db, vlib_buffer_t *b)
+{
+  ip6_header_t *ip6 = vlib_buffer_get_current (b);
+  u8 proto = vnet_buffer (b)->ip.reass.ip_proto;
+  u32 fib_index;
+
+  if (proto != IP_PROTOCOL_TCP && proto != IP_PROTOCOL_UDP)
+    return;
+
+  fib_index = fib_table_get_index_for_sw_if_index (
+    FIB_PROTOCOL_IP6, vnet_buffer (b)->sw_if_index[VLIB_RX]);
+  nat64_db_st_entry_prefetch (db, (ip46_address_t *) &ip6->src_address,
+			      (ip46_address_t *) &ip6->dst_address,
+			      vnet_buffer (b)->ip.reass.l4_src_port,
+			      vnet_buffer (b)->ip.reass.l4_dst_port, proto,
+			      fib_index, 1);
+}
+
 static inline uword
 nat64_in2out_node_fn_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 			     vlib_frame_t * frame, u8 is_slow_path)
@@ -1025,11 +1045,15 @@ nat64_in2out_node_fn_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   nat64_in2out_next_t next_index;
   u32 thread_index = vm->thread_index;
   nat64_main_t *nm = &nat64_main;
+  nat64_db_t *db = &nm->db[thread_index];
 
   from = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
   next_index = node->cached_next_index;
 
+  if (!is_slow_path && n_left_from > 1)
+    nat64_in2out_prefetch_session (db, vlib_get_buffer (vm, from[1]));
+
   while (n_left_from > 0)
     {
       u32 n_left_to_next;
@@ -1048,6 +1072,16 @@ nat64_in2out_node_fn_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  nat64_in2out_set_ctx_t ctx0;
 	  u32 sw_if_index0;
 
+	  /* buffer data three ahead, session bucket two ahead */
+	  if (PREDICT_TRUE (n_left_from > 3))
+	    {
+	      vlib_buffer_t *p3 = vlib_get_buffer (vm, from[3]);
+	      vlib_prefetch_buffer_header (p3, LOAD);
+	      clib_prefetch_load (p3->data);
+	    }
+	  if (!is_slow_path && PREDICT_TRUE (n_left_from > 2))
+	    nat64_in2out_prefetch_session (db, vlib_get_buffer (vm, from[2]));
+
 	  /* speculatively enqueue b0 to the current next frame */
 	  bi0 = from[0];
 	  to_next[0] = bi0;
@@ -512,6 +512,28 @@ nat64_out2in_unk_proto (vlib_main_t * vm, vlib_buffer_t * p,
   return 0;
 }
 
+/* warm the session table bucket for a TCP/UDP packet ahead of time */
+static_always_inline void
+nat64_out2in_prefetch_session (nat64_db_t *db, vlib_buffer_t *b)
+{
+  ip4_header_t *ip4 = vlib_buffer_get_current (b);
+  ip46_address_t saddr, daddr;
+  u8 proto = ip4->protocol;
+  u32 fib_index;
+
+  if (proto != IP_PROTOCOL_TCP && proto != IP_PROTOCOL_UDP)
+    return;
+
+  ip46_address_set_ip4 (&saddr, &ip4->src_address);
+  ip46_address_set_ip4 (&daddr, &ip4->dst_address);
+  fib_index = ip4_fib_table_get_index_for_sw_if_index (
+    vnet_buffer (b)->sw_if_index[VLIB_RX]);
+  nat64_db_st_entry_prefetch (db, &daddr, &saddr,
+			      vnet_buffer (b)->ip.reass.l4_dst_port,
+			      vnet_buffer (b)->ip.reass.l4_src_port, proto,
+			      fib_index, 0);
+}
+
 VLIB_NODE_FN (nat64_out2in_node) (vlib_main_t * vm,
 				  vlib_node_runtime_t * node,
 				  vlib_frame_t * frame)
@@ -520,10 +542,15 @@ VLIB_NODE_FN (nat64_out2in_node) (vlib_main_t * vm,
   nat64_out2in_next_t next_index;
   nat64_main_t *nm = &nat64_main;
   u32 thread_index = vm->thread_index;
+  nat64_db_t *db = &nm->db[thread_index];
 
   from = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
   next_index = node->cached_next_index;
+
+  if (n_left_from > 1)
+    nat64_out2in_prefetch_session (db, vlib_get_buffer (vm, from[1]));
+
   while (n_left_from > 0)
     {
       u32 n_left_to_next;
@@ -541,6 +568,16 @@ VLIB_NODE_FN (nat64_out2in_node) (vlib_main_t * vm,
 	  udp_header_t *udp0;
 	  u32 sw_if_index0;
 
+	  /* buffer data three ahead, session bucket two ahead */
+	  if (PREDICT_TRUE (n_left_from > 3))
+	    {
+	      vlib_buffer_t *p3 = vlib_get_buffer (vm, from[3]);
+	      vlib_prefetch_buffer_header (p3, LOAD);
+	      clib_prefetch_load (p3->data);
+	    }
+	  if (PREDICT_TRUE (n_left_from > 2))
+	    nat64_out2in_prefetch_session (db, vlib_get_buffer (vm, from[2]));
+
 	  /* speculatively enqueue b0 to the current next frame */
 	  bi0 = from[0];
 	  to_next[0] = bi0;
@@ -75,7 +75,8 @@ buffer_add_to_chain (vlib_main_t * vm, u32 bi, u32 first_bi, u32 prev_bi)
   vlib_buffer_t *prev_b = vlib_get_buffer (vm, prev_bi);
 
   /* update first buffer */
-  first_b->total_length_not_including_first_buffer += b->current_length;
+  vlib_buffer_cold (first_b)->total_length_not_including_first_buffer +=
+    b->current_length;
 
   /* update previous buffer */
   prev_b->next_buffer = bi;
@@ -183,7 +184,8 @@ netmap_device_input_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 
 		  if (offset == 0)
 		    {
-		      b0->total_length_not_including_first_buffer = 0;
+		      vlib_buffer_cold (b0)
+			->total_length_not_including_first_buffer = 0;
 		      b0->flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
 		      vnet_buffer (b0)->sw_if_index[VLIB_RX] =
 			nif->sw_if_index;
@@ -172,12 +172,23 @@ nsim_dispatch_buffer (vlib_main_t * vm, vlib_node_runtime_t * node,
 	}
 
       nsim_wheel_entry_t *ep = wp->entries + wp->tail;
+      f64 tx_time = ctx->expires;
       wp->tail++;
       if (wp->tail == wp->wheel_size)
 	wp->tail = 0;
       wp->cursize++;
 
-      ep->tx_time = ctx->expires;
+      if (PREDICT_FALSE (nsm->jitter > 0.0))
+	tx_time += nsm->jitter * random_f64 (&wp->seed);
+      if (PREDICT_FALSE (nsm->shape))
+	tx_time = clib_max (tx_time, wp->last_tx_time +
+				       vlib_buffer_length_in_chain (vm, b) *
+					 8.0 / nsm->bandwidth);
+      /* The wheel is drained in order, so departures must not overtake */
+      tx_time = clib_max (tx_time, wp->last_tx_time);
+      wp->last_tx_time = tx_time;
+
+      ep->tx_time = tx_time;
       ep->rx_sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
       ep->tx_sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_TX];
       nsim_buffer_fwd_lookup (nsm, b, &ep->output_next_index,
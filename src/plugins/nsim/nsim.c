@@ -142,6 +142,8 @@ nsim_wheel_alloc (nsim_main_t *nsm)
   wp->cursize = 0;
   wp->head = 0;
   wp->tail = 0;
+  wp->seed = (u32) clib_cpu_time_now ();
+  wp->last_tx_time = 0.0;
   wp->entries = (void *) (wp + 1);
 
   return wp;
@@ -655,6 +657,10 @@ format_nsim_config (u8 * s, va_list * args)
   s = format (s, " packet size: %u\n", nsm->packet_size);
   s = format (s, " worker wheel size: %u\n", nsm->wheel_slots_per_wrk);
   s = format (s, " throughput: %U\n", format_bandwidth, nsm->bandwidth);
+  if (nsm->jitter)
+    s = format (s, " jitter: %U\n", format_delay, nsm->jitter);
+  if (nsm->shape)
+    s = format (s, " shaped to throughput\n");
 
   if (verbose)
     {
@@ -699,12 +705,18 @@ set_nsim_command_fn (vlib_main_t * vm,
   f64 drop_fraction = 0.0, reorder_fraction = 0.0, delay, bandwidth;
   u32 packets_per_drop, packets_per_reorder, packet_size = 1500;
   nsim_main_t *nsm = &nsim_main;
+  f64 jitter = 0.0;
+  u8 shape = 0;
   int rv;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
       if (unformat (input, "delay %U", unformat_delay, &delay))
 	;
+      else if (unformat (input, "jitter %U", unformat_delay, &jitter))
+	;
+      else if (unformat (input, "shape"))
+	shape = 1;
       else if (unformat (input, "bandwidth %U", unformat_bandwidth,
 			 &bandwidth))
 	;
@@ -739,6 +751,9 @@ set_nsim_command_fn (vlib_main_t * vm,
 	break;
     }
 
+  nsm->jitter = jitter;
+  nsm->shape = shape;
+
   rv = nsim_configure (nsm, bandwidth, delay, packet_size, drop_fraction,
 		       reorder_fraction);
 
@@ -782,6 +797,10 @@ set_nsim_command_fn (vlib_main_t * vm,
  * @clistart
  * set nsim delay 10.0 ms bandwidth 5.5 gbit packet-size 128
  *
+ * Add up to 50us of random delay per packet and pace departures at the
+ * configured bandwidth. Departures never overtake each other:
+ * @clistart
+ * set nsim delay 1.0 ms jitter 50.0 us bandwidth 10 gbit shape
  * @cliend
  * @cliexcmd{set nsim delay <nn> bandwidth <bb> packet-size <nn>}
 ?*/
@@ -789,7 +808,8 @@ VLIB_CLI_COMMAND (set_nsim_command, static) =
 {
   .path = "set nsim",
   .short_help = "set nsim delay <time> bandwidth <bps> packet-size <nbytes>\n"
-  "    [packets-per-drop <nn>][drop-fraction <f64: 0.0 - 1.0>]",
+  "    [packets-per-drop <nn>][drop-fraction <f64: 0.0 - 1.0>]\n"
+  "    [jitter <time>][shape]",
   .function = set_nsim_command_fn,
 };
 
@@ -24,6 +24,7 @@
 
 #include <vppinfra/hash.h>
 #include <vppinfra/error.h>
+#include <vppinfra/random.h>
 
 #define NSIM_MAX_TX_BURST 32	/**< max packets in a tx burst */
 
@@ -43,6 +44,8 @@ typedef struct
   u32 cursize;
   u32 head;
   u32 tail;
+  u32 seed;
+  f64 last_tx_time;
   nsim_wheel_entry_t *entries;
     CLIB_CACHE_LINE_ALIGN_MARK (pad);
 } nsim_wheel_t;
@@ -110,6 +113,12 @@ typedef struct
   u32 wheel_slots_per_wrk;
   u32 poll_main_thread;
 
+  /* Per-packet delay variation, in seconds */
+  f64 jitter;
+
+  /* Pace departures at the configured bandwidth */
+  u8 shape;
+
   u64 mmap_size;
 
   /* Wheels are configured */
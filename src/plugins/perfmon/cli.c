@@ -534,6 +534,9 @@ perfmon_start_command_fn (vlib_main_t *vm, unformat_input_t *input,
   if (pm->is_running)
     return clib_error_return (0, "please stop first");
 
+  if (pm->continuous_bundles)
+    return clib_error_return (0, "please turn continuous sampling off first");
+
   if (unformat_user (input, unformat_line_input, line_input) == 0)
     return clib_error_return (0, "please specify bundle name");
 
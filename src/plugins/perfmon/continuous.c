@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vnet/vnet.h>
+#include <vlib/stats/stats.h>
+#include <perfmon/perfmon.h>
+
+/*
+ * Continuous sampling.
+ *
+ * Node bundles are run one at a time, for a window of each period, in
+ * turn. The dispatch wrapper only costs anything while a window is open,
+ * so window / period bounds the overhead. At the end of each window the
+ * per node counts are added to counter vectors in the stats segment,
+ * indexed by thread and node index like /sys/node:
+ *
+ *   /perfmon/<bundle>/calls
+ *   /perfmon/<bundle>/packets
+ *   /perfmon/<bundle>/<event>
+ *
+ * Ratios like instructions per cycle or misses per packet are rates of
+ * two counters of the same bundle, which only move within the same
+ * windows. Events which are read as raw samples rather than deltas
+ * (preserve_samples, e.g. the topdown metrics) are not published.
+ */
+
+VLIB_REGISTER_LOG_CLASS (perfmon_continuous_log, static) = {
+  .class_name = "perfmon",
+  .subclass_name = "continuous",
+};
+
+static void
+perfmon_continuous_publish (vlib_main_t *vm, perfmon_bundle_t *b)
+{
+  perfmon_main_t *pm = &perfmon_main;
+  u32 n_threads = vec_len (pm->thread_runtimes);
+  u32 n_nodes = vec_len (vm->node_main.nodes);
+
+  if (b->stats_indexes == 0)
+    {
+      perfmon_source_t *s = b->src;
+
+      vec_add1 (b->stats_indexes,
+		vlib_stats_add_counter_vector ("/perfmon/%s/calls", b->name));
+      vec_add1 (b->stats_indexes,
+		vlib_stats_add_counter_vector ("/perfmon/%s/packets", b->name));
+      for (int i = 0; i < b->n_events; i++)
+	vec_add1 (b->stats_indexes,
+		  vlib_stats_add_counter_vector (
+		    "/perfmon/%s/%s", b->name, s->events[b->events[i]].name));
+    }
+
+  for (int i = 0; i < vec_len (b->stats_indexes); i++)
+    vlib_stats_validate (b->stats_indexes[i], n_threads - 1, n_nodes - 1);
+
+  for (u32 ti = 0; ti < n_threads; ti++)
+    {
+      perfmon_thread_runtime_t *tr = vec_elt_at_index (pm->thread_runtimes, ti);
+
+      for (u32 ni = 0; ni < tr->n_nodes; ni++)
+	{
+	  perfmon_node_stats_t *ns = tr->node_stats + ni;
+	  counter_t **c;
+
+	  if (ns->n_calls == 0)
+	    continue;
+
+	  c = vlib_stats_get_entry_data_pointer (b->stats_indexes[0]);
+	  c[ti][ni] += ns->n_calls;
+	  c = vlib_stats_get_entry_data_pointer (b->stats_indexes[1]);
+	  c[ti][ni] += ns->n_packets;
+
+	  /* opened events are packed, skip the ones not implemented */
+	  for (int i = 0, k = 0; i < b->n_events; i++)
+	    {
+	      if (clib_bitmap_get (b->event_disabled, i))
+		continue;
+	      if (!(b->preserve_samples & 1 << k))
+		{
+		  c = vlib_stats_get_entry_data_pointer (b->stats_indexes[2 + i]);
+		  c[ti][ni] += ns->value[k];
+		}
+	      k++;
+	    }
+	}
+    }
+}
+
+static uword
+perfmon_continuous_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			    vlib_frame_t *f)
+{
+  perfmon_main_t *pm = &perfmon_main;
+  perfmon_bundle_t *b;
+  clib_error_t *err;
+
+  while (1)
+    {
+      if (vec_len (pm->continuous_bundles) == 0)
+	vlib_process_wait_for_event (vm);
+      else
+	vlib_process_wait_for_event_or_clock (
+	  vm, pm->continuous_period - pm->continuous_window);
+      vlib_process_get_events (vm, 0);
+
+      /* turned off, or someone else is using the counters */
+      if (vec_len (pm->continuous_bundles) == 0 || pm->is_running)
+	continue;
+
+      pm->continuous_next %= vec_len (pm->continuous_bundles);
+      b = pm->continuous_bundles[pm->continuous_next++];
+      b->active_type = PERFMON_BUNDLE_TYPE_NODE;
+
+      if ((err = perfmon_start (vm, b)))
+	{
+	  vlib_log_warn (perfmon_continuous_log.class, "bundle '%s': %U",
+			 b->name, format_clib_error, err);
+	  clib_error_free (err);
+	  continue;
+	}
+
+      vlib_process_suspend (vm, pm->continuous_window);
+
+      /* stopped or reset by hand while the window was open */
+      if (pm->active_bundle != b || !pm->is_running)
+	continue;
+
+      if ((err = perfmon_stop (vm)))
+	{
+	  clib_error_free (err);
+	  continue;
+	}
+
+      perfmon_continuous_publish (vm, b);
+      perfmon_reset (vm);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (perfmon_continuous_node) = {
+  .function = perfmon_continuous_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "perfmon-continuous-process",
+};
+
+static clib_error_t *
+perfmon_continuous_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			       vlib_cli_command_t *cmd)
+{
+  perfmon_main_t *pm = &perfmon_main;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  perfmon_bundle_t *b = 0, **vb = 0;
+  f64 window = 1, period = 10;
+  int off = 0;
+
+  if (unformat_user (input, unformat_line_input, line_input) == 0)
+    return clib_error_return (0, "please specify bundle names or off");
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "off"))
+	off = 1;
+      else if (unformat (line_input, "window %f", &window))
+	;
+      else if (unformat (line_input, "period %f", &period))
+	;
+      else if (unformat (line_input, "%U", unformat_perfmon_bundle_name, &b))
+	{
+	  if ((b->type_flags & PERFMON_BUNDLE_TYPE_NODE_FLAG) == 0)
+	    {
+	      vec_free (vb);
+	      unformat_free (line_input);
+	      return clib_error_return (0, "bundle '%s' is not a node bundle",
+					b->name);
+	    }
+	  vec_add1 (vb, b);
+	}
+      else
+	{
+	  vec_free (vb);
+	  return clib_error_return (0, "unknown input '%U'",
+				    format_unformat_error, line_input);
+	}
+    }
+  unformat_free (line_input);
+
+  vec_free (pm->continuous_bundles);
+
+  if (off)
+    {
+      vec_free (vb);
+      return 0;
+    }
+
+  if (vb == 0)
+    return clib_error_return (0, "please specify bundle names");
+
+  if (window <= 0 || period < window)
+    {
+      vec_free (vb);
+      return clib_error_return (0, "window must be positive and no longer "
+				   "than the period");
+    }
+
+  pm->continuous_bundles = vb;
+  pm->continuous_next = 0;
+  pm->continuous_window = window;
+  pm->continuous_period = period;
+  vlib_process_signal_event (vm, perfmon_continuous_node.index, 0, 0);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (perfmon_continuous_command, static) = {
+  .path = "perfmon continuous",
+  .short_help = "perfmon continuous <bundle-name> [<bundle-name> ...] "
+		"[window <sec>] [period <sec>] | off",
+  .function = perfmon_continuous_command_fn,
+};
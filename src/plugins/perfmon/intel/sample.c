@@ -0,0 +1,566 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+
+#include <vnet/vnet.h>
+#include <perfmon/perfmon.h>
+#include <perfmon/intel/core.h>
+#include <vppinfra/format_table.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+/*
+ * PEBS load latency sampling.
+ *
+ * Every period-th load slower than the latency threshold is sampled by
+ * the cpu with its instruction and data address, and its latency. The
+ * samples are read from per thread perf rings by a process node and
+ * counted by function and by the memory they hit:
+ *
+ * - the function is the node function the instruction belongs to, or
+ *   the closest exported symbol. Node functions are static, so they are
+ *   found by their registered addresses rather than by dladdr(). Code
+ *   inlined into a node function counts for the node.
+ * - buffer memory is split into buffer headers and buffer data, other
+ *   memory is named after the clib_mem mapping holding it (main heap,
+ *   stats segment, bihash and other named heaps) as in "show memory map".
+ */
+
+#define PERFMON_SAMPLE_RING_PAGES 64
+
+/* MEM_TRANS_RETIRED.LOAD_LATENCY, with the threshold in config1 */
+#define PERFMON_SAMPLE_LOAD_LATENCY PERF_INTEL_CODE (0xcd, 0x01, 0, 0, 0, 0)
+
+enum
+{
+  PERFMON_SAMPLE_REGION_UNKNOWN,
+  PERFMON_SAMPLE_REGION_BUFFER_HEADER,
+  PERFMON_SAMPLE_REGION_BUFFER_DATA,
+  PERFMON_SAMPLE_N_FIXED_REGIONS,
+};
+
+typedef struct
+{
+  uword start, end;
+  u8 *name;
+} perfmon_sample_region_t;
+
+typedef struct
+{
+  uword addr;
+  u32 node_index;
+  u8 *name;
+} perfmon_sample_function_t;
+
+typedef struct
+{
+  uword addr;
+  u32 node_index;
+} perfmon_sample_node_fn_t;
+
+typedef struct
+{
+  u32 function;
+  u32 region;
+  u64 n_samples;
+  u64 latency;
+} perfmon_sample_stat_t;
+
+typedef struct
+{
+  int *fds;
+  struct perf_event_mmap_page **pages;
+
+  /* snapshot of the memory maps, taken at start */
+  perfmon_sample_region_t *regions;
+
+  /* node function addresses, sorted */
+  perfmon_sample_node_fn_t *node_fns;
+
+  perfmon_sample_function_t *functions;
+  uword *function_by_addr;
+  uword *function_by_ip;
+
+  perfmon_sample_stat_t *stats;
+  uword *stat_by_key;
+
+  /* copy of a record which wraps around the end of its ring */
+  u8 *record;
+
+  u64 n_samples;
+  u64 n_lost;
+  u32 latency;
+  u32 period;
+  int is_running;
+} perfmon_sample_main_t;
+
+static perfmon_sample_main_t perfmon_sample_main;
+
+static void
+perfmon_sample_close (perfmon_sample_main_t *sm)
+{
+  uword size = (PERFMON_SAMPLE_RING_PAGES + 1) * clib_mem_get_page_size ();
+
+  for (int i = 0; i < vec_len (sm->fds); i++)
+    {
+      if (sm->pages[i])
+	munmap (sm->pages[i], size);
+      close (sm->fds[i]);
+    }
+  vec_free (sm->fds);
+  vec_free (sm->pages);
+  sm->is_running = 0;
+}
+
+static void
+perfmon_sample_clear (perfmon_sample_main_t *sm)
+{
+  perfmon_sample_region_t *r;
+  perfmon_sample_function_t *f;
+
+  vec_foreach (r, sm->regions)
+    vec_free (r->name);
+  vec_foreach (f, sm->functions)
+    vec_free (f->name);
+  vec_free (sm->regions);
+  vec_free (sm->functions);
+  vec_free (sm->node_fns);
+  vec_free (sm->stats);
+  hash_free (sm->function_by_addr);
+  hash_free (sm->function_by_ip);
+  hash_free (sm->stat_by_key);
+  sm->n_samples = sm->n_lost = 0;
+}
+
+static int
+perfmon_sample_node_fn_cmp (void *a1, void *a2)
+{
+  perfmon_sample_node_fn_t *f1 = a1, *f2 = a2;
+  return f1->addr < f2->addr ? -1 : f1->addr > f2->addr;
+}
+
+static void
+perfmon_sample_snapshot (vlib_main_t *vm, perfmon_sample_main_t *sm)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  clib_mem_vm_map_hdr_t *hdr = 0;
+  perfmon_sample_region_t *r;
+  perfmon_sample_node_fn_t *nf;
+
+  vec_validate (sm->regions, PERFMON_SAMPLE_N_FIXED_REGIONS - 1);
+  sm->regions[PERFMON_SAMPLE_REGION_UNKNOWN].name = format (0, "unknown");
+  sm->regions[PERFMON_SAMPLE_REGION_BUFFER_HEADER].name =
+    format (0, "buffer header");
+  sm->regions[PERFMON_SAMPLE_REGION_BUFFER_DATA].name =
+    format (0, "buffer data");
+
+  while ((hdr = clib_mem_vm_get_next_map_hdr (hdr)))
+    {
+      vec_add2 (sm->regions, r, 1);
+      r->start = hdr->base_addr;
+      r->end = hdr->base_addr + (hdr->num_pages << hdr->log2_page_sz);
+      r->name = format (0, "%s", hdr->name);
+    }
+
+  /* every march variant of every node function */
+  for (u32 i = 0; i < vec_len (nm->nodes); i++)
+    {
+      vlib_node_t *n = nm->nodes[i];
+      vlib_node_fn_registration_t *fnr;
+
+      if (n->function)
+	{
+	  vec_add2 (sm->node_fns, nf, 1);
+	  nf->addr = pointer_to_uword (n->function);
+	  nf->node_index = i;
+	}
+      for (fnr = n->node_fn_registrations; fnr; fnr = fnr->next_registration)
+	{
+	  vec_add2 (sm->node_fns, nf, 1);
+	  nf->addr = pointer_to_uword (fnr->function);
+	  nf->node_index = i;
+	}
+    }
+
+  vec_sort_with_function (sm->node_fns, perfmon_sample_node_fn_cmp);
+}
+
+static u32
+perfmon_sample_region (perfmon_sample_main_t *sm, uword addr)
+{
+  vlib_buffer_main_t *bm = vlib_get_main ()->buffer_main;
+  perfmon_sample_region_t *r;
+  vlib_buffer_pool_t *bp;
+
+  if (addr - bm->buffer_mem_start < bm->buffer_mem_size)
+    vec_foreach (bp, bm->buffer_pools)
+      if (addr - bp->start < bp->size)
+	return (addr - bp->start) % bp->alloc_size <
+		   bm->ext_hdr_size + sizeof (vlib_buffer_t) ?
+		 PERFMON_SAMPLE_REGION_BUFFER_HEADER :
+		 PERFMON_SAMPLE_REGION_BUFFER_DATA;
+
+  vec_foreach (r, sm->regions)
+    if (addr - r->start < r->end - r->start)
+      return r - sm->regions;
+
+  return PERFMON_SAMPLE_REGION_UNKNOWN;
+}
+
+static u32
+perfmon_sample_function (vlib_main_t *vm, perfmon_sample_main_t *sm,
+			 uword ip)
+{
+  perfmon_sample_function_t *f;
+  uword addr = 0, *p;
+  u32 node_index = ~0;
+  Dl_info info = {};
+  int lo = 0, hi = vec_len (sm->node_fns) - 1;
+
+  if ((p = hash_get (sm->function_by_ip, ip)))
+    return p[0];
+
+  if (dladdr (uword_to_pointer (ip, void *), &info) && info.dli_saddr)
+    addr = pointer_to_uword (info.dli_saddr);
+
+  /* closest node function at or before ip */
+  while (lo <= hi)
+    {
+      int mid = (lo + hi) / 2;
+      if (sm->node_fns[mid].addr <= ip)
+	lo = mid + 1;
+      else
+	hi = mid - 1;
+    }
+
+  if (hi >= 0 && sm->node_fns[hi].addr >= addr &&
+      sm->node_fns[hi].addr >= pointer_to_uword (info.dli_fbase))
+    {
+      addr = sm->node_fns[hi].addr;
+      node_index = sm->node_fns[hi].node_index;
+    }
+
+  if ((p = hash_get (sm->function_by_addr, addr)))
+    {
+      hash_set (sm->function_by_ip, ip, p[0]);
+      return p[0];
+    }
+
+  vec_add2 (sm->functions, f, 1);
+  f->addr = addr;
+  f->node_index = node_index;
+  if (node_index != ~0)
+    f->name = format (0, "%U", format_vlib_node_name, vm, node_index);
+  else if (addr && info.dli_sname)
+    f->name = format (0, "%s", info.dli_sname);
+  else
+    f->name = format (0, "unknown");
+
+  hash_set (sm->function_by_addr, addr, f - sm->functions);
+  hash_set (sm->function_by_ip, ip, f - sm->functions);
+  return f - sm->functions;
+}
+
+static void
+perfmon_sample_add (vlib_main_t *vm, perfmon_sample_main_t *sm, u64 ip,
+		    u64 addr, u64 latency)
+{
+  perfmon_sample_stat_t *st;
+  u32 function, region;
+  uword key, *p;
+
+  function = perfmon_sample_function (vm, sm, ip);
+  region = perfmon_sample_region (sm, addr);
+  key = (uword) function << 32 | region;
+
+  if ((p = hash_get (sm->stat_by_key, key)))
+    st = vec_elt_at_index (sm->stats, p[0]);
+  else
+    {
+      vec_add2 (sm->stats, st, 1);
+      st->function = function;
+      st->region = region;
+      hash_set (sm->stat_by_key, key, st - sm->stats);
+    }
+
+  st->n_samples++;
+  st->latency += latency;
+  sm->n_samples++;
+}
+
+static void
+perfmon_sample_drain (vlib_main_t *vm, perfmon_sample_main_t *sm,
+		      struct perf_event_mmap_page *pg)
+{
+  uword page_size = clib_mem_get_page_size ();
+  u64 size = pg->data_size ? pg->data_size :
+			     PERFMON_SAMPLE_RING_PAGES * page_size;
+  u8 *data = (u8 *) pg + (pg->data_offset ? pg->data_offset : page_size);
+  u64 head = __atomic_load_n (&pg->data_head, __ATOMIC_ACQUIRE);
+  u64 tail = pg->data_tail;
+
+  while (tail < head)
+    {
+      u64 off = tail & (size - 1);
+      struct perf_event_header *h = (void *) (data + off);
+      u16 len = h->size;
+      u64 *v;
+
+      /* headers are 8 byte aligned and never wrap, the data may */
+      if (off + len > size)
+	{
+	  vec_validate (sm->record, len - 1);
+	  clib_memcpy_fast (sm->record, data + off, size - off);
+	  clib_memcpy_fast (sm->record + size - off, data,
+			    len - (size - off));
+	  h = (void *) sm->record;
+	}
+
+      v = (u64 *) (h + 1);
+      if (h->type == PERF_RECORD_SAMPLE)
+	/* PERF_SAMPLE_IP, PERF_SAMPLE_ADDR, PERF_SAMPLE_WEIGHT */
+	perfmon_sample_add (vm, sm, v[0], v[1], v[2]);
+      else if (h->type == PERF_RECORD_LOST)
+	sm->n_lost += v[1];
+
+      tail += len;
+    }
+
+  __atomic_store_n (&pg->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+static uword
+perfmon_sample_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			vlib_frame_t *f)
+{
+  perfmon_sample_main_t *sm = &perfmon_sample_main;
+
+  while (1)
+    {
+      if (sm->is_running)
+	vlib_process_wait_for_event_or_clock (vm, 0.1);
+      else
+	vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, 0);
+
+      for (int i = 0; i < vec_len (sm->pages); i++)
+	perfmon_sample_drain (vm, sm, sm->pages[i]);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (perfmon_sample_node) = {
+  .function = perfmon_sample_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "perfmon-sample-process",
+};
+
+static clib_error_t *
+perfmon_sample_start (vlib_main_t *vm, perfmon_sample_main_t *sm)
+{
+  uword size = (PERFMON_SAMPLE_RING_PAGES + 1) * clib_mem_get_page_size ();
+  clib_error_t *err = 0;
+
+  perfmon_sample_clear (sm);
+  perfmon_sample_snapshot (vm, sm);
+
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_worker_thread_t *w = vlib_worker_threads + i;
+      struct perf_event_attr pe = {
+	.size = sizeof (struct perf_event_attr),
+	.type = PERF_TYPE_RAW,
+	.config = PERFMON_SAMPLE_LOAD_LATENCY,
+	.config1 = sm->latency,
+	.sample_period = sm->period,
+	.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_ADDR | PERF_SAMPLE_WEIGHT,
+	.precise_ip = 2,
+	.exclude_kernel = 1,
+	.exclude_hv = 1,
+	.disabled = 1,
+      };
+      void *pg;
+      int fd;
+
+      fd = syscall (__NR_perf_event_open, &pe, w->lwp, -1, -1, 0);
+      if (fd == -1)
+	{
+	  err = clib_error_return_unix (0, "perf_event_open");
+	  goto error;
+	}
+
+      pg = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      vec_add1 (sm->fds, fd);
+      vec_add1 (sm->pages, pg == MAP_FAILED ? 0 : pg);
+      if (pg == MAP_FAILED)
+	{
+	  err = clib_error_return_unix (0, "mmap");
+	  goto error;
+	}
+    }
+
+  for (int i = 0; i < vec_len (sm->fds); i++)
+    if (ioctl (sm->fds[i], PERF_EVENT_IOC_ENABLE, 0) == -1)
+      {
+	err = clib_error_return_unix (0, "ioctl(PERF_EVENT_IOC_ENABLE)");
+	goto error;
+      }
+
+  sm->is_running = 1;
+  vlib_process_signal_event (vm, perfmon_sample_node.index, 0, 0);
+  return 0;
+
+error:
+  perfmon_sample_close (sm);
+  return err;
+}
+
+static clib_error_t *
+perfmon_sample_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			   vlib_cli_command_t *cmd)
+{
+  perfmon_sample_main_t *sm = &perfmon_sample_main;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 latency = 64, period = 1000;
+  int start = 0, stop = 0;
+
+  if (unformat_user (input, unformat_line_input, line_input) == 0)
+    return clib_error_return (0, "please specify start or stop");
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "start"))
+	start = 1;
+      else if (unformat (line_input, "stop"))
+	stop = 1;
+      else if (unformat (line_input, "latency %u", &latency))
+	;
+      else if (unformat (line_input, "period %u", &period))
+	;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, line_input);
+    }
+  unformat_free (line_input);
+
+  if (stop)
+    {
+      if (!sm->is_running)
+	return clib_error_return (0, "not running");
+      for (int i = 0; i < vec_len (sm->pages); i++)
+	perfmon_sample_drain (vm, sm, sm->pages[i]);
+      perfmon_sample_close (sm);
+      return 0;
+    }
+
+  if (!start)
+    return clib_error_return (0, "please specify start or stop");
+
+  if (sm->is_running)
+    return clib_error_return (0, "please stop first");
+
+  if (latency < 3 || period == 0)
+    return clib_error_return (0, "latency must be 3 cycles or more and "
+				 "period at least 1");
+
+  sm->latency = latency;
+  sm->period = period;
+  return perfmon_sample_start (vm, sm);
+}
+
+VLIB_CLI_COMMAND (perfmon_sample_command, static) = {
+  .path = "perfmon sample",
+  .short_help = "perfmon sample start [latency <cycles>] [period <n>] | stop",
+  .function = perfmon_sample_command_fn,
+};
+
+static int
+perfmon_sample_stat_cmp (void *a1, void *a2)
+{
+  perfmon_sample_stat_t *s1 = a1, *s2 = a2;
+  return s1->n_samples > s2->n_samples ? -1 : s1->n_samples < s2->n_samples;
+}
+
+static clib_error_t *
+show_perfmon_sample_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				vlib_cli_command_t *cmd)
+{
+  perfmon_sample_main_t *sm = &perfmon_sample_main;
+  table_t table = {}, *t = &table;
+  perfmon_sample_stat_t *stats, *st;
+  u32 max = 50, row = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "max %u", &max))
+	;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+
+  for (int i = 0; i < vec_len (sm->pages); i++)
+    perfmon_sample_drain (vm, sm, sm->pages[i]);
+
+  vlib_cli_output (vm,
+		   "%s, loads slower than %u cycles, 1 in %u sampled\n"
+		   "%lu samples, %lu lost\n",
+		   sm->is_running ? "running" : "stopped", sm->latency,
+		   sm->period, sm->n_samples, sm->n_lost);
+
+  if (vec_len (sm->stats) == 0)
+    return 0;
+
+  stats = vec_dup (sm->stats);
+  vec_sort_with_function (stats, perfmon_sample_stat_cmp);
+
+  table_add_header_row (t, 0);
+  table_format_cell (t, 0, -1, "Function");
+  table_format_cell (t, 1, -1, "Memory");
+  table_format_cell (t, 2, -1, "Samples");
+  table_format_cell (t, 3, -1, "%%");
+  table_format_cell (t, 4, -1, "Avg latency");
+
+  vec_foreach (st, stats)
+    {
+      if (row == max)
+	break;
+      table_format_cell (t, 0, row, "%v", sm->functions[st->function].name);
+      table_format_cell (t, 1, row, "%v", sm->regions[st->region].name);
+      table_format_cell (t, 2, row, "%lu", st->n_samples);
+      table_format_cell (t, 3, row, "%.2f",
+			 100.0 * st->n_samples / sm->n_samples);
+      table_format_cell (t, 4, row, "%.1f",
+			 (f64) st->latency / st->n_samples);
+      table_set_cell_align (t, 0, row, TTAA_LEFT);
+      table_set_cell_align (t, 1, row, TTAA_LEFT);
+      row++;
+    }
+
+  vlib_cli_output (vm, "%U", format_table, t);
+  table_free (t);
+  vec_free (stats);
+  return 0;
+}
+
+VLIB_CLI_COMMAND (show_perfmon_sample_command, static) = {
+  .path = "show perfmon sample",
+  .short_help = "show perfmon sample [max <n>]",
+  .function = show_perfmon_sample_command_fn,
+};
@@ -160,6 +160,9 @@ typedef struct perfmon_bundle
   /* do not set manually */
   perfmon_source_t *src;
   struct perfmon_bundle *next;
+
+  /* continuous sampling counters: calls, packets, then one per event */
+  u32 *stats_indexes;
 } perfmon_bundle_t;
 
 typedef struct
@@ -210,6 +213,12 @@ typedef struct
   int *fds_to_close;
   perfmon_instance_type_t *default_instance_type;
   perfmon_instance_type_t *active_instance_type;
+
+  /* continuous sampling, bundles run in turn for window every period */
+  perfmon_bundle_t **continuous_bundles;
+  u32 continuous_next;
+  f64 continuous_window;
+  f64 continuous_period;
 } perfmon_main_t;
 
 extern perfmon_main_t perfmon_main;
@@ -271,6 +280,8 @@ perfmon_cpu_update_bundle_type (perfmon_bundle_t *b)
   }                                                                           \
   perfmon_bundle_t __perfmon_bundle_##x
 
+unformat_function_t unformat_perfmon_bundle_name;
+
 void perfmon_reset (vlib_main_t *vm);
 clib_error_t *perfmon_start (vlib_main_t *vm, perfmon_bundle_t *);
 clib_error_t *perfmon_stop (vlib_main_t *vm);
@@ -767,7 +767,8 @@ init_icmp46_echo_request (vlib_main_t * vm, vlib_buffer_t * b0,
     }
   hb->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
   hb->current_length = l34_len + first_buf_data_len;
-  hb->total_length_not_including_first_buffer = data_len - first_buf_data_len;
+  vlib_buffer_cold (hb)->total_length_not_including_first_buffer =
+    data_len - first_buf_data_len;
 
   icmp46_echo->time_sent = now;
   icmp46_echo->seq = clib_host_to_net_u16 (seq_host);
@@ -97,6 +97,49 @@ dump_counter_vector_combined (stat_segment_data_t *res, u8 *s, u8 used_only)
   return s;
 }
 
+static u8 *
+dump_histogram_log2 (stat_segment_data_t *res, u8 *s, u8 used_only)
+{
+  u8 need_header = 1;
+  u64 total;
+  int j, k;
+  u8 *name;
+
+  name = make_stat_name (res->name);
+
+  for (k = 0; k < vec_len (res->histogram_vec); k++)
+    {
+      counter_t *h = res->histogram_vec[k];
+
+      for (j = 0, total = 0; j < vec_len (h); j++)
+	total += h[j];
+
+      if (used_only && !total)
+	continue;
+      if (need_header)
+	{
+	  s = format (s, "# TYPE %v histogram\n", name);
+	  need_header = 0;
+	}
+
+      /* cumulative counts, only at the upper bound of used buckets */
+      for (j = 0, total = 0; j < vec_len (h); j++)
+	{
+	  if (!h[j])
+	    continue;
+	  total += h[j];
+	  if (j + 1 < vec_len (h))
+	    s = format (s, "%v_bucket{thread=\"%d\",le=\"%llu\"} %lld\n", name,
+			k, stat_histogram_bucket_min (j + 1), total);
+	}
+      s = format (s, "%v_bucket{thread=\"%d\",le=\"+Inf\"} %lld\n", name, k,
+		  total);
+      s = format (s, "%v_count{thread=\"%d\"} %lld\n", name, k, total);
+    }
+
+  return s;
+}
+
 static u8 *
 dump_scalar_index (stat_segment_data_t *res, u8 *s, u8 used_only)
 {
@@ -129,55 +172,94 @@ dump_name_vector (stat_segment_data_t *res, u8 *s, u8 used_only)
   return s;
 }
 
+static u8 *
+dump_entry (stat_segment_data_t *res, u8 *s, u8 used_only)
+{
+  switch (res->type)
+    {
+    case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+      s = dump_counter_vector_simple (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+      s = dump_counter_vector_combined (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_SCALAR_INDEX:
+      s = dump_scalar_index (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+      s = dump_histogram_log2 (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_NAME_VECTOR:
+      s = dump_name_vector (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_EMPTY:
+      break;
+
+    default:
+      clib_warning ("Unknown value %d\n", res->type);
+      ;
+    }
+  return s;
+}
+
+/*
+ * Forget the values and text of the last scrape, the next one renders
+ * every entry again.
+ */
+static void
+prom_scrape_cache_reset (void)
+{
+  prom_main_t *pm = &prom_main;
+  u8 **text;
+
+  stat_segment_data_free (pm->snapshot);
+  pm->snapshot = 0;
+  vec_foreach (text, pm->entry_text)
+    vec_free (*text);
+  vec_free (pm->entry_text);
+  vec_free (pm->stat_indexes);
+}
+
+/*
+ * The text of each entry is kept between scrapes and only the entries
+ * whose values changed since the last scrape are formatted again.
+ */
 static u8 *
 scrape_stats_segment (u8 *s, u8 **patterns, u8 used_only)
 {
-  stat_segment_data_t *res;
-  static u32 *stats = 0;
-  int i;
+  prom_main_t *pm = &prom_main;
+  u32 *changed, *i;
+  u8 **text;
 
-  stats = stat_segment_ls (patterns);
+  if (!pm->stat_indexes)
+    pm->stat_indexes = stat_segment_ls (patterns);
 
 retry:
-  res = stat_segment_dump (stats);
-  if (res == 0)
+  changed = stat_segment_dump_delta (pm->stat_indexes, &pm->snapshot);
+  if (changed == 0)
     { /* Memory layout has changed */
-      if (stats)
-	vec_free (stats);
-      stats = stat_segment_ls (patterns);
+      prom_scrape_cache_reset ();
+      pm->stat_indexes = stat_segment_ls (patterns);
       goto retry;
     }
 
-  for (i = 0; i < vec_len (res); i++)
+  if (vec_len (pm->stat_indexes))
+    vec_validate (pm->entry_text, vec_len (pm->stat_indexes) - 1);
+  vec_foreach (i, changed)
     {
-      switch (res[i].type)
-	{
-	case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
-	  s = dump_counter_vector_simple (&res[i], s, used_only);
-	  break;
-
-	case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
-	  s = dump_counter_vector_combined (&res[i], s, used_only);
-	  break;
-
-	case STAT_DIR_TYPE_SCALAR_INDEX:
-	  s = dump_scalar_index (&res[i], s, used_only);
-	  break;
-
-	case STAT_DIR_TYPE_NAME_VECTOR:
-	  s = dump_name_vector (&res[i], s, used_only);
-	  break;
-
-	case STAT_DIR_TYPE_EMPTY:
-	  break;
-
-	default:
-	  clib_warning ("Unknown value %d\n", res[i].type);
-	  ;
-	}
+      vec_reset_length (pm->entry_text[*i]);
+      pm->entry_text[*i] =
+	dump_entry (&pm->snapshot[*i], pm->entry_text[*i], used_only);
     }
-  stat_segment_data_free (res);
-  vec_free (stats);
+  vec_free (changed);
+
+  vec_foreach (text, pm->entry_text)
+    vec_append (s, *text);
 
   return s;
 }
@@ -325,6 +407,7 @@ prom_stat_patterns_add (u8 **patterns)
       if (!found)
 	vec_add1 (pm->stats_patterns, *pattern);
     }
+  prom_scrape_cache_reset ();
 }
 
 void
@@ -333,6 +416,7 @@ prom_stat_patterns_free (void)
   prom_main_t *pm = &prom_main;
   u8 **pattern;
 
+  prom_scrape_cache_reset ();
   vec_foreach (pattern, pm->stats_patterns)
     vec_free (*pattern);
   vec_free (pm->stats_patterns);
@@ -356,6 +440,7 @@ prom_stat_name_prefix_set (u8 *prefix)
 {
   prom_main_t *pm = &prom_main;
 
+  prom_scrape_cache_reset ();
   vec_free (pm->stat_name_prefix);
   pm->stat_name_prefix = prefix;
 }
@@ -365,6 +450,7 @@ prom_report_used_only (u8 used_only)
 {
   prom_main_t *pm = &prom_main;
 
+  prom_scrape_cache_reset ();
   pm->used_only = used_only;
 }
 
@@ -18,6 +18,7 @@
 
 #include <vnet/session/session.h>
 #include <http_static/http_static.h>
+#include <vpp-api/client/stat_client.h>
 
 typedef struct prom_main_
 {
@@ -28,6 +29,11 @@ typedef struct prom_main_
   u32 scraper_node_index;
   u8 is_enabled;
   u8 *name_scratch_pad;
+
+  /* entries scraped, their values and text at the last scrape */
+  u32 *stat_indexes;
+  stat_segment_data_t *snapshot;
+  u8 **entry_text;
   vlib_main_t *vm;
 
   /*
@@ -647,9 +647,15 @@ quic_connection_closed (quic_ctx_t * ctx)
     }
 }
 
+/**
+ * Enqueue packet to udp session. If @a gso_size is set, the packet is a
+ * train of packets of gso_size bytes, but the last which can be shorter,
+ * that session layer segments into separate dgrams.
+ */
 static int
 quic_send_datagram (session_t *udp_session, struct iovec *packet,
-		    quicly_address_t *dest, quicly_address_t *src)
+		    u16 gso_size, quicly_address_t *dest,
+		    quicly_address_t *src)
 {
   u32 max_enqueue, len;
   session_dgram_hdr_t hdr;
@@ -674,7 +680,7 @@ quic_send_datagram (session_t *udp_session, struct iovec *packet,
   hdr.is_ip4 = tc->is_ip4;
   clib_memcpy (&hdr.lcl_ip, &tc->lcl_ip, sizeof (ip46_address_t));
   hdr.lcl_port = tc->lcl_port;
-  hdr.gso_size = 0;
+  hdr.gso_size = gso_size;
 
   /*  Read dest address from quicly-provided sockaddr */
   if (hdr.is_ip4)
@@ -702,11 +708,44 @@ quic_send_datagram (session_t *udp_session, struct iovec *packet,
       return QUIC_ERROR_FULL_FIFO;
     }
 
-  quic_increment_counter (QUIC_ERROR_TX_PACKETS, 1);
+  if (gso_size)
+    {
+      quic_increment_counter (QUIC_ERROR_TX_PACKETS,
+			      (len + gso_size - 1) / gso_size);
+      quic_increment_counter (QUIC_ERROR_TX_GSO_DGRAMS, 1);
+    }
+  else
+    quic_increment_counter (QUIC_ERROR_TX_PACKETS, 1);
 
   return 0;
 }
 
+/**
+ * Number of packets, starting with the first, that can be sent as one gso
+ * train. They must be contiguous in quicly's buffer, have the same size,
+ * but the last which can be shorter, and fit in one udp segment.
+ */
+static u32
+quic_gso_packet_count (struct iovec *packets, u32 n_packets, u32 snd_mss)
+{
+  u32 i, seg_len = packets[0].iov_len;
+
+  if (seg_len > snd_mss)
+    return 1;
+
+  for (i = 1; i < n_packets; i++)
+    {
+      if ((u8 *) packets[i - 1].iov_base + seg_len != packets[i].iov_base ||
+	  packets[i].iov_len > seg_len)
+	break;
+      /* Shorter packet closes the train */
+      if (packets[i].iov_len < seg_len)
+	return i + 1;
+    }
+
+  return i;
+}
+
 static int
 quic_send_packets (quic_ctx_t * ctx)
 {
@@ -714,10 +753,12 @@ quic_send_packets (quic_ctx_t * ctx)
   uint8_t
     buf[QUIC_SEND_PACKET_VEC_SIZE * quic_get_quicly_ctx_from_ctx (ctx)
 				      ->transport_params.max_udp_payload_size];
+  transport_send_params_t sp = {};
   session_t *udp_session;
   quicly_conn_t *conn;
   size_t num_packets, i, max_packets;
-  u32 n_sent = 0;
+  u32 n_sent = 0, n_gso;
+  struct iovec train;
   int err = 0;
 
   /* We have sctx, get qctx */
@@ -734,6 +775,10 @@ quic_send_packets (quic_ctx_t * ctx)
   if (!conn)
     return 0;
 
+  if (quic_main.udp_gso)
+    transport_connection_snd_params (session_get_transport (udp_session),
+				     &sp);
+
   do
     {
       /* TODO : quicly can assert it can send min_packets up to 2 */
@@ -746,12 +791,28 @@ quic_send_packets (quic_ctx_t * ctx)
 			      &num_packets, buf, sizeof (buf))))
 	goto quicly_error;
 
-      for (i = 0; i != num_packets; ++i)
+      for (i = 0; i != num_packets; i += n_gso)
 	{
+	  n_gso = 1;
+	  if (sp.snd_mss)
+	    n_gso =
+	      quic_gso_packet_count (&packets[i], num_packets - i, sp.snd_mss);
 
-	  if ((err = quic_send_datagram (udp_session, &packets[i],
-					 &ctx->rmt_ip, &ctx->lcl_ip)))
-	  goto quicly_error;
+	  if (n_gso > 1)
+	    {
+	      train.iov_base = packets[i].iov_base;
+	      train.iov_len = (u8 *) packets[i + n_gso - 1].iov_base +
+			      packets[i + n_gso - 1].iov_len -
+			      (u8 *) train.iov_base;
+	      err = quic_send_datagram (udp_session, &train,
+					packets[i].iov_len, &ctx->rmt_ip,
+					&ctx->lcl_ip);
+	    }
+	  else
+	    err = quic_send_datagram (udp_session, &packets[i], 0,
+				      &ctx->rmt_ip, &ctx->lcl_ip);
+	  if (err)
+	    goto quicly_error;
 	}
       n_sent += num_packets;
     }
@@ -2189,7 +2250,8 @@ quic_reset_connection (u64 udp_session_handle, quic_rx_packet_ctx_t * pctx)
   packet.iov_base = payload;
 
   udp_session = session_get_from_handle (udp_session_handle);
-  rv = quic_send_datagram (udp_session, &packet, &qctx->rmt_ip, &qctx->lcl_ip);
+  rv = quic_send_datagram (udp_session, &packet, 0, &qctx->rmt_ip,
+			   &qctx->lcl_ip);
   quic_set_udp_tx_evt (udp_session);
   return rv;
 }
@@ -2240,6 +2302,7 @@ quic_process_one_rx_packet (u64 udp_session_handle, svm_fifo_t * f,
     {
       return 1;
     }
+  pctx->next_off = off;
 
   rv = quic_find_packet_ctx (pctx, thread_index);
   if (rv == QUIC_PACKET_TYPE_RECEIVE)
@@ -2273,12 +2336,54 @@ quic_process_one_rx_packet (u64 udp_session_handle, svm_fifo_t * f,
   return 1;
 }
 
+/**
+ * Feed to quicly the packets coalesced after the first one in a dgram,
+ * typically handshake packets of different packet number spaces
+ */
+static void
+quic_receive_coalesced_packets (quic_ctx_t *ctx, quic_rx_packet_ctx_t *pctx)
+{
+  quicly_context_t *quicly_ctx;
+  size_t plen;
+  int i, rv;
+
+  if (!ctx->conn || pctx->next_off >= pctx->ph.data_length)
+    return;
+
+  quicly_ctx = quic_get_quicly_ctx_from_ctx (ctx);
+  for (i = 1; i < QUIC_MAX_COALESCED_PACKET; i++)
+    {
+      if (pctx->next_off >= pctx->ph.data_length)
+	break;
+      plen = quicly_decode_packet (quicly_ctx, &pctx->packet, pctx->data,
+				   pctx->ph.data_length, &pctx->next_off);
+      if (plen == SIZE_MAX)
+	break;
+      /* All packets in a dgram must be for the same connection */
+      if (!quicly_is_destination (ctx->conn, NULL, &pctx->sa, &pctx->packet))
+	break;
+
+      if (quic_main.vnet_crypto_enabled &&
+	  quic_main.default_crypto_engine == CRYPTO_ENGINE_VPP)
+	quic_crypto_decrypt_packet (ctx, pctx);
+
+      quic_increment_counter (QUIC_ERROR_RX_COALESCED_PACKETS, 1);
+      rv = quicly_receive (ctx->conn, NULL, &pctx->sa, &pctx->packet);
+      if (rv && rv != QUICLY_ERROR_PACKET_IGNORED)
+	{
+	  QUIC_ERR ("quicly_receive return error %U", quic_format_err, rv);
+	  break;
+	}
+    }
+}
+
 static int
 quic_udp_session_rx_callback (session_t * udp_session)
 {
   /*  Read data from UDP rx_fifo and pass it to the quicly conn. */
-  quic_ctx_t *ctx = NULL, *prev_ctx = NULL;
+  u32 to_send[QUIC_RCV_MAX_PACKETS], n_to_send, j;
   svm_fifo_t *f = udp_session->rx_fifo;
+  quic_ctx_t *ctx = NULL;
   u32 max_deq;
   u64 udp_session_handle = session_handle (udp_session);
   int rv = 0;
@@ -2347,20 +2452,27 @@ rx_start:
 	    {
 	      QUIC_ERR ("quicly_receive return error %U",
 			quic_format_err, rv);
+	      break;
 	    }
+	  quic_receive_coalesced_packets (ctx, &packets_ctx[i]);
 	  break;
 	case QUIC_PACKET_TYPE_ACCEPT:
 	  quic_accept_connection (&packets_ctx[i]);
+	  ctx = quic_ctx_get_if_valid (packets_ctx[i].ctx_index,
+				       packets_ctx[i].thread_index);
+	  if (ctx && ctx->conn_state == QUIC_CONN_STATE_READY)
+	    quic_receive_coalesced_packets (ctx, &packets_ctx[i]);
 	  break;
 	case QUIC_PACKET_TYPE_RESET:
 	  quic_reset_connection (udp_session_handle, &packets_ctx[i]);
 	  break;
 	}
     }
-  ctx = prev_ctx = NULL;
+  /* Flush each connection only once per batch, after all its packets were
+   * received, so acks and data are generated in as few trains as possible */
+  n_to_send = 0;
   for (i = 0; i < max_packets; i++)
     {
-      prev_ctx = ctx;
       switch (packets_ctx[i].ptype)
 	{
 	case QUIC_PACKET_TYPE_RECEIVE:
@@ -2378,7 +2490,17 @@ rx_start:
 	  continue;		/* this exits the for loop since other packet types are
 				   necessarily the last in the batch */
 	}
-      if (ctx != prev_ctx)
+      for (j = 0; j < n_to_send; j++)
+	if (to_send[j] == packets_ctx[i].ctx_index)
+	  break;
+      if (j == n_to_send)
+	to_send[n_to_send++] = packets_ctx[i].ctx_index;
+    }
+
+  for (j = 0; j < n_to_send; j++)
+    {
+      ctx = quic_ctx_get_if_valid (to_send[j], thread_index);
+      if (ctx)
 	quic_send_packets (ctx);
     }
 
@@ -2966,6 +3088,7 @@ quic_config_fn (vlib_main_t * vm, unformat_input_t * input)
   qm->udp_fifo_size = QUIC_DEFAULT_FIFO_SIZE;
   qm->udp_fifo_prealloc = 0;
   qm->connection_timeout = QUIC_DEFAULT_CONN_TIMEOUT;
+  qm->udp_gso = 1;
 
   if (!unformat_user (input, unformat_line_input, line_input))
     return 0;
@@ -2987,6 +3110,8 @@ quic_config_fn (vlib_main_t * vm, unformat_input_t * input)
 	qm->connection_timeout = i;
       else if (unformat (line_input, "fifo-prealloc %u", &i))
 	qm->udp_fifo_prealloc = i;
+      else if (unformat (line_input, "no-udp-gso"))
+	qm->udp_gso = 0;
       else
 	{
 	  error = clib_error_return (0, "unknown input '%U'",
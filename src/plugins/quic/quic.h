@@ -241,6 +241,7 @@ typedef struct quic_rx_packet_ctx_
   socklen_t salen;
   u8 ptype;
   session_dgram_hdr_t ph;
+  size_t next_off; /**< offset of next coalesced packet in data */
 } quic_rx_packet_ctx_t;
 
 typedef struct quic_main_
@@ -265,6 +266,7 @@ typedef struct quic_main_
   u32 connection_timeout;
 
   u8 vnet_crypto_enabled;
+  u8 udp_gso;				/**< Send packet trains as gso dgrams */
   u32 *per_thread_crypto_key_indices;
 } quic_main_t;
 
@@ -810,7 +810,8 @@ wrap_around:
 	  u8 current_chain_sz = 0;
 	  current_buf->current_length = buf_sz;
 	  total_length -= buf_sz;
-	  current_buf->total_length_not_including_first_buffer = total_length;
+	  vlib_buffer_cold (current_buf)
+	    ->total_length_not_including_first_buffer = total_length;
 	  current_buf->flags |= VLIB_BUFFER_NEXT_PRESENT;
 	  current_buf->next_buffer = second[0];
 	  do
@@ -893,7 +894,8 @@ rdma_device_mlx5dv_striding_rq_input (vlib_main_t * vm,
 		  pkt_head = pkt[0];
 		  pkt_head_idx = ptd->current_segs[pkt - bufs];
 		  n_bytes_remaining = bc[0] & CQE_BC_BYTE_COUNT_MASK;
-		  pkt_head->total_length_not_including_first_buffer =
+		  vlib_buffer_cold (pkt_head)
+		    ->total_length_not_including_first_buffer =
 		    n_segs_remaining >
 		    1 ? n_bytes_remaining - pkt[0]->current_length : 0;
 		}
@@ -917,7 +919,8 @@ rdma_device_mlx5dv_striding_rq_input (vlib_main_t * vm,
 		      (next_in_frame++)[0] = pkt_head_idx;
 		      n_rx_bytes +=
 			pkt_head->current_length +
-			pkt_head->total_length_not_including_first_buffer;
+			vlib_buffer_cold (pkt_head)
+			  ->total_length_not_including_first_buffer;
 		    }
 		  /*Go to next CQE */
 		  bc++;
@@ -72,8 +72,9 @@ typedef enum
 VLIB_NODE_FN (sflow_node)
 (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
 {
-  u32 n_left_from, *from, *to_next;
-  sflow_next_t next_index;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  u16 nexts[VLIB_FRAME_SIZE];
+  u32 n_left_from, *from;
 
   sflow_main_t *smp = &sflow_main;
   from = vlib_frame_vector_args (frame);
@@ -95,56 +96,53 @@ VLIB_NODE_FN (sflow_node)
     }
   else
     {
+      u32 *fromN = from;
       while (pkts >= sfwk->skip)
 	{
 	  /* reach in to get the one we want. */
-	  vlib_buffer_t *bN = vlib_get_buffer (vm, from[sfwk->skip - 1]);
+	  fromN += sfwk->skip;
+	  vlib_buffer_t *bN = vlib_get_buffer (vm, fromN[-1]);
 
-	  /* Sample this packet header. */
-	  u32 hdr = bN->current_length;
-	  if (hdr > smp->headerB)
-	    hdr = smp->headerB;
-
-	  ethernet_header_t *en = vlib_buffer_get_current (bN);
-	  u32 if_index = vnet_buffer (bN)->sw_if_index[VLIB_RX];
-	  vnet_hw_interface_t *hw =
-	    vnet_get_sup_hw_interface (smp->vnet_main, if_index);
-	  if (hw)
-	    if_index = hw->hw_if_index;
+	  /* Sample this packet header, straight into the FIFO slot. */
+	  sflow_sample_t *sample = sflow_fifo_reserve (&sfwk->fifo);
+	  sfwk->smpl++;
+	  if (PREDICT_FALSE (!sample))
+	    sfwk->drop++;
 	  else
 	    {
-	      // TODO: can we get interfaces that have no hw interface?
-	      // If so,  should we ignore the sample?
+	      u32 hdr = bN->current_length;
+	      if (hdr > smp->headerB)
+		hdr = smp->headerB;
+
+	      ethernet_header_t *en = vlib_buffer_get_current (bN);
+	      u32 if_index = vnet_buffer (bN)->sw_if_index[VLIB_RX];
+	      vnet_hw_interface_t *hw =
+		vnet_get_sup_hw_interface (smp->vnet_main, if_index);
+	      if (hw)
+		if_index = hw->hw_if_index;
+	      else
+		{
+		  // TODO: can we get interfaces that have no hw interface?
+		  // If so,  should we ignore the sample?
+		}
+
+	      // TODO: what bit in the buffer can we set right here to
+	      // indicate that this packet was sampled (and perhaps another
+	      // bit to say if it was dropped or sucessfully enqueued)? That
+	      // way we can check it below if the packet is traced, and
+	      // indicate that in the trace output.
+	      sample->samplingN = sfwk->smpN;
+	      sample->input_if_index = if_index;
+	      sample->output_if_index = 0;
+	      sample->header_protocol = 0;
+	      sample->sampled_packet_size =
+		bN->current_length +
+		vlib_buffer_cold (bN)->total_length_not_including_first_buffer;
+	      sample->header_bytes = hdr;
+	      clib_memcpy_fast (sample->header, en, hdr);
+	      sflow_fifo_produce (&sfwk->fifo);
 	    }
 
-	  sflow_sample_t sample = {
-	    .samplingN = sfwk->smpN,
-	    .input_if_index = if_index,
-	    .sampled_packet_size =
-	      bN->current_length + bN->total_length_not_including_first_buffer,
-	    .header_bytes = hdr
-	  };
-
-	  // TODO: what bit in the buffer can we set right here to indicate
-	  // that this packet was sampled (and perhaps another bit to say if it
-	  // was dropped or sucessfully enqueued)? That way we can check it
-	  // below if the packet is traced, and indicate that in the trace
-	  // output.
-
-	  // TODO: we end up copying the header twice here. Consider allowing
-	  // the enqueue to be just a little more complex.  Like this:
-	  // if(!sflow_fifo_enqueue(&sfwk->fifo, &sample, en, hdr).
-	  // With headerB==128 that would be memcpy(,,24) plus memcpy(,,128)
-	  // instead of the memcpy(,,128) plus memcpy(,,24+256) that we do
-	  // here. (We also know that it could be done as a multiple of 8
-	  // (aligned) bytes because the sflow_sample_t fields are (6xu32) and
-	  // the headerB setting is quantized to the nearest 32 bytes, so there
-	  // may be ways to make it even easier for the compiler.)
-	  sfwk->smpl++;
-	  memcpy (sample.header, en, hdr);
-	  if (PREDICT_FALSE (!sflow_fifo_enqueue (&sfwk->fifo, &sample)))
-	    sfwk->drop++;
-
 	  pkts -= sfwk->skip;
 	  sfwk->pool += sfwk->skip;
 	  sfwk->skip = sflow_next_random_skip (sfwk);
@@ -155,179 +153,30 @@ VLIB_NODE_FN (sflow_node)
       sfwk->pool += pkts;
     }
 
-  /* the rest of this is boilerplate code just to make sure
-   * that packets are passed on the same way as they would
-   * have been if this node were not enabled.
-   * TODO: If there is ever a way to do this in one step
-   * (i.e. pass on the whole frame-vector unchanged) then it
-   * might help performance.
-   */
+  /* pass every packet on to the next node on the feature arc */
+  vlib_get_buffers (vm, from, bufs, n_left_from);
+  vnet_feature_next_n (bufs, nexts, n_left_from);
 
-  next_index = node->cached_next_index;
-
-  while (n_left_from > 0)
+  if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_TRACE))
     {
-      u32 n_left_to_next;
-
-      vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
-
-      while (n_left_from >= 8 && n_left_to_next >= 4)
+      for (u32 i = 0; i < frame->n_vectors; i++)
 	{
-	  u32 next0 = SFLOW_NEXT_ETHERNET_INPUT;
-	  u32 next1 = SFLOW_NEXT_ETHERNET_INPUT;
-	  u32 next2 = SFLOW_NEXT_ETHERNET_INPUT;
-	  u32 next3 = SFLOW_NEXT_ETHERNET_INPUT;
-	  ethernet_header_t *en0, *en1, *en2, *en3;
-	  u32 bi0, bi1, bi2, bi3;
-	  vlib_buffer_t *b0, *b1, *b2, *b3;
-
-	  /* Prefetch next iteration. */
-	  {
-	    vlib_buffer_t *p4, *p5, *p6, *p7;
-
-	    p4 = vlib_get_buffer (vm, from[4]);
-	    p5 = vlib_get_buffer (vm, from[5]);
-	    p6 = vlib_get_buffer (vm, from[6]);
-	    p7 = vlib_get_buffer (vm, from[7]);
-
-	    vlib_prefetch_buffer_header (p4, LOAD);
-	    vlib_prefetch_buffer_header (p5, LOAD);
-	    vlib_prefetch_buffer_header (p6, LOAD);
-	    vlib_prefetch_buffer_header (p7, LOAD);
-
-	    CLIB_PREFETCH (p4->data, CLIB_CACHE_LINE_BYTES, STORE);
-	    CLIB_PREFETCH (p5->data, CLIB_CACHE_LINE_BYTES, STORE);
-	    CLIB_PREFETCH (p6->data, CLIB_CACHE_LINE_BYTES, STORE);
-	    CLIB_PREFETCH (p7->data, CLIB_CACHE_LINE_BYTES, STORE);
-	  }
-
-	  /* speculatively enqueue b0-b3 to the current next frame */
-	  to_next[0] = bi0 = from[0];
-	  to_next[1] = bi1 = from[1];
-	  to_next[2] = bi2 = from[2];
-	  to_next[3] = bi3 = from[3];
-	  from += 4;
-	  to_next += 4;
-	  n_left_from -= 4;
-	  n_left_to_next -= 4;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-	  b1 = vlib_get_buffer (vm, bi1);
-	  b2 = vlib_get_buffer (vm, bi2);
-	  b3 = vlib_get_buffer (vm, bi3);
-
-	  /* do this to always pass on to the next node on feature arc */
-	  vnet_feature_next (&next0, b0);
-	  vnet_feature_next (&next1, b1);
-	  vnet_feature_next (&next2, b2);
-	  vnet_feature_next (&next3, b3);
-
-	  ASSERT (b0->current_data == 0);
-	  ASSERT (b1->current_data == 0);
-	  ASSERT (b2->current_data == 0);
-	  ASSERT (b3->current_data == 0);
-
-	  en0 = vlib_buffer_get_current (b0);
-	  en1 = vlib_buffer_get_current (b1);
-	  en2 = vlib_buffer_get_current (b2);
-	  en3 = vlib_buffer_get_current (b3);
-
-	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	  vlib_buffer_t *b0 = bufs[i];
+	  if (b0->flags & VLIB_BUFFER_IS_TRACED)
 	    {
+	      ethernet_header_t *en0 = vlib_buffer_get_current (b0);
 	      sflow_trace_t *t = vlib_add_trace (vm, node, b0, sizeof (*t));
 	      t->sw_if_index = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-	      t->next_index = next0;
+	      t->next_index = nexts[i];
 	      clib_memcpy (t->new_src_mac, en0->src_address,
 			   sizeof (t->new_src_mac));
 	      clib_memcpy (t->new_dst_mac, en0->dst_address,
 			   sizeof (t->new_dst_mac));
 	    }
-
-	  if (PREDICT_FALSE (b1->flags & VLIB_BUFFER_IS_TRACED))
-	    {
-	      sflow_trace_t *t = vlib_add_trace (vm, node, b1, sizeof (*t));
-	      t->sw_if_index = vnet_buffer (b1)->sw_if_index[VLIB_RX];
-	      t->next_index = next1;
-	      clib_memcpy (t->new_src_mac, en1->src_address,
-			   sizeof (t->new_src_mac));
-	      clib_memcpy (t->new_dst_mac, en1->dst_address,
-			   sizeof (t->new_dst_mac));
-	    }
-
-	  if (PREDICT_FALSE (b2->flags & VLIB_BUFFER_IS_TRACED))
-	    {
-	      sflow_trace_t *t = vlib_add_trace (vm, node, b2, sizeof (*t));
-	      t->sw_if_index = vnet_buffer (b2)->sw_if_index[VLIB_RX];
-	      t->next_index = next2;
-	      clib_memcpy (t->new_src_mac, en2->src_address,
-			   sizeof (t->new_src_mac));
-	      clib_memcpy (t->new_dst_mac, en2->dst_address,
-			   sizeof (t->new_dst_mac));
-	    }
-
-	  if (PREDICT_FALSE (b3->flags & VLIB_BUFFER_IS_TRACED))
-	    {
-	      sflow_trace_t *t = vlib_add_trace (vm, node, b3, sizeof (*t));
-	      t->sw_if_index = vnet_buffer (b3)->sw_if_index[VLIB_RX];
-	      t->next_index = next3;
-	      clib_memcpy (t->new_src_mac, en3->src_address,
-			   sizeof (t->new_src_mac));
-	      clib_memcpy (t->new_dst_mac, en3->dst_address,
-			   sizeof (t->new_dst_mac));
-	    }
-
-	  /* verify speculative enqueues, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x4 (vm, node, next_index, to_next,
-					   n_left_to_next, bi0, bi1, bi2, bi3,
-					   next0, next1, next2, next3);
-	}
-
-      while (n_left_from > 0 && n_left_to_next > 0)
-	{
-	  u32 bi0;
-	  vlib_buffer_t *b0;
-	  u32 next0 = SFLOW_NEXT_ETHERNET_INPUT;
-	  ethernet_header_t *en0;
-
-	  /* speculatively enqueue b0 to the current next frame */
-	  bi0 = from[0];
-	  to_next[0] = bi0;
-	  from += 1;
-	  to_next += 1;
-	  n_left_from -= 1;
-	  n_left_to_next -= 1;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-
-	  /* do this to always pass on to the next node on feature arc */
-	  vnet_feature_next (&next0, b0);
-
-	  /*
-	   * Direct from the driver, we should be at offset 0
-	   * aka at &b0->data[0]
-	   */
-	  ASSERT (b0->current_data == 0);
-
-	  en0 = vlib_buffer_get_current (b0);
-
-	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
-	    {
-	      sflow_trace_t *t = vlib_add_trace (vm, node, b0, sizeof (*t));
-	      t->sw_if_index = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-	      t->next_index = next0;
-	      clib_memcpy (t->new_src_mac, en0->src_address,
-			   sizeof (t->new_src_mac));
-	      clib_memcpy (t->new_dst_mac, en0->dst_address,
-			   sizeof (t->new_dst_mac));
-	    }
-
-	  /* verify speculative enqueue, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x1 (vm, node, next_index, to_next,
-					   n_left_to_next, bi0, next0);
 	}
-
-      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
     }
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
   return frame->n_vectors;
 }
 
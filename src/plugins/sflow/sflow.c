@@ -295,7 +295,8 @@ static u32
 read_worker_fifos (sflow_main_t *smp)
 {
   // Our maximum samples/sec is approximately:
-  // (SFLOW_READ_BATCH * smp->total_threads) / SFLOW_POLL_WAIT_S
+  // (SFLOW_READ_BATCH * SFLOW_READ_BURST * smp->total_threads) /
+  // SFLOW_POLL_WAIT_S
   // but it may also be affected by SFLOW_FIFO_DEPTH
   // and whether vlib_process_wait_for_event_or_clock() really waits for
   // SFLOW_POLL_WAIT_S every time.
@@ -306,7 +307,7 @@ read_worker_fifos (sflow_main_t *smp)
   // encoder, the UDP stack, the network path, the collector, or a faraway
   // application. Any kind of "clipping" will result in systematic bias so we
   // try to make this fair even when it's running hot. For example, we'll
-  // round-robin the thread FIFO dequeues here to make sure we give them equal
+  // round-robin the thread FIFO dequeues (a short burst each) here to make sure we give them equal
   // access to the PSAMPLE channel. Another factor in sizing SFLOW_FIFO_DEPTH
   // is to ensure that we can absorb a short-term line-rate burst without
   // dropping samples. This implies a deeper FIFO. In fact it looks like this
@@ -327,10 +328,13 @@ read_worker_fifos (sflow_main_t *smp)
 	{
 	  sflow_per_thread_data_t *sfwk =
 	    vec_elt_at_index (smp->per_thread_data, thread_index);
-	  sflow_sample_t sample;
-	  if (sflow_fifo_dequeue (&sfwk->fifo, &sample))
+	  u32 slot, n_samples;
+	  n_samples = sflow_fifo_peek (&sfwk->fifo, &slot, SFLOW_READ_BURST);
+	  for (u32 i = 0; i < n_samples; i++)
 	    {
-	      if (sample.header_bytes > smp->headerB)
+	      sflow_sample_t *sample = &sfwk->fifo.samples[slot];
+	      slot = SFLOW_FIFO_NEXT (slot);
+	      if (sample->header_bytes > smp->headerB)
 		{
 		  // We get here if header-bytes setting is reduced dynamically
 		  // and a sample that was in the FIFO appears with a larger
@@ -345,23 +349,26 @@ read_worker_fifos (sflow_main_t *smp)
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_SAMPLE_GROUP,
 				      ps_group);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_IIFINDEX,
-				      sample.input_if_index);
+				      sample->input_if_index);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_OIFINDEX,
-				      sample.output_if_index);
+				      sample->output_if_index);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_ORIGSIZE,
-				      sample.sampled_packet_size);
+				      sample->sampled_packet_size);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_GROUP_SEQ,
 				      seqNo);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_SAMPLE_RATE,
-				      sample.samplingN);
+				      sample->samplingN);
 	      SFLOWPSSpec_setAttr (&spec, SFLOWPS_PSAMPLE_ATTR_DATA,
-				   sample.header, sample.header_bytes);
+				   sample->header, sample->header_bytes);
 	      SFLOWPSSpec_setAttrInt (&spec, SFLOWPS_PSAMPLE_ATTR_PROTO,
 				      header_protocol);
 	      psample_send++;
 	      if (SFLOWPSSpec_send (&smp->sflow_psample, &spec) < 0)
 		psample_send_fail++;
 	    }
+	  // hand the whole burst back to the worker at once
+	  if (n_samples)
+	    sflow_fifo_release (&sfwk->fifo, n_samples);
 	}
       if (psample_send == 0)
 	{
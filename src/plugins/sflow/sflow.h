@@ -35,6 +35,7 @@
 #define SFLOW_FIFO_DEPTH  2048 // must be power of 2
 #define SFLOW_POLL_WAIT_S 0.001
 #define SFLOW_READ_BATCH  100
+#define SFLOW_READ_BURST  8 // samples taken from one FIFO per round
 
 // use PSAMPLE group number to distinguish VPP samples from others
 // (so that hsflowd will know to remap the ifIndex numbers if necessary)
@@ -84,30 +85,42 @@ typedef struct
 } sflow_fifo_t;
 
 #define SFLOW_FIFO_NEXT(slot) ((slot + 1) & (SFLOW_FIFO_DEPTH - 1))
-static inline int
-sflow_fifo_enqueue (sflow_fifo_t *fifo, sflow_sample_t *sample)
+
+// Producer side: the sample is written in place in the slot returned by
+// sflow_fifo_reserve() and made visible by sflow_fifo_produce().
+static inline sflow_sample_t *
+sflow_fifo_reserve (sflow_fifo_t *fifo)
 {
   u32 curr_rx = clib_atomic_load_acq_n (&fifo->rx);
-  u32 curr_tx = fifo->tx; // clib_atomic_load_acq_n(&fifo->tx);
-  u32 next_tx = SFLOW_FIFO_NEXT (curr_tx);
-  if (next_tx == curr_rx)
-    return false; // full
-  memcpy (&fifo->samples[next_tx], sample, sizeof (*sample));
-  clib_atomic_store_rel_n (&fifo->tx, next_tx);
-  return true;
+  u32 curr_tx = fifo->tx;
+  if (SFLOW_FIFO_NEXT (curr_tx) == curr_rx)
+    return NULL; // full
+  return &fifo->samples[curr_tx];
+}
+
+static inline void
+sflow_fifo_produce (sflow_fifo_t *fifo)
+{
+  clib_atomic_store_rel_n (&fifo->tx, SFLOW_FIFO_NEXT (fifo->tx));
 }
 
-static inline int
-sflow_fifo_dequeue (sflow_fifo_t *fifo, sflow_sample_t *sample)
+// Consumer side: up to max samples are read in place starting at *slot,
+// then handed back with a single sflow_fifo_release().
+static inline u32
+sflow_fifo_peek (sflow_fifo_t *fifo, u32 *slot, u32 max)
 {
-  u32 curr_rx = fifo->rx; // clib_atomic_load_acq_n(&fifo->rx);
+  u32 curr_rx = fifo->rx;
   u32 curr_tx = clib_atomic_load_acq_n (&fifo->tx);
-  if (curr_rx == curr_tx)
-    return false; // empty
-  memcpy (sample, &fifo->samples[curr_rx], sizeof (*sample));
-  u32 next_rx = SFLOW_FIFO_NEXT (curr_rx);
-  clib_atomic_store_rel_n (&fifo->rx, next_rx);
-  return true;
+  u32 n = (curr_tx - curr_rx) & (SFLOW_FIFO_DEPTH - 1);
+  *slot = curr_rx;
+  return clib_min (n, max);
+}
+
+static inline void
+sflow_fifo_release (sflow_fifo_t *fifo, u32 n)
+{
+  clib_atomic_store_rel_n (&fifo->rx,
+			   (fifo->rx + n) & (SFLOW_FIFO_DEPTH - 1));
 }
 
 /* private to worker */
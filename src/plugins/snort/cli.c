@@ -594,6 +594,28 @@ VLIB_CLI_COMMAND (snort_mode_interrupt_command, static) = {
   .function = snort_mode_interrupt_command_fn,
 };
 
+static clib_error_t *
+snort_flow_cache_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			     vlib_cli_command_t *cmd)
+{
+  f64 timeout;
+
+  if (unformat (input, "timeout %f", &timeout) && timeout > 0)
+    snort_flow_cache_set_timeout (timeout);
+  else if (unformat (input, "disable"))
+    snort_flow_cache_set_timeout (0);
+  else
+    return clib_error_return (0, "unknown input '%U'", format_unformat_error,
+			      input);
+  return 0;
+}
+
+VLIB_CLI_COMMAND (snort_flow_cache_command, static) = {
+  .path = "snort flow-cache",
+  .short_help = "snort flow-cache timeout <seconds>|disable",
+  .function = snort_flow_cache_command_fn,
+};
+
 static clib_error_t *
 snort_show_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
 			    vlib_cli_command_t *cmd)
@@ -602,6 +624,10 @@ snort_show_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
   char *mode =
     sm->input_mode == VLIB_NODE_STATE_POLLING ? "polling" : "interrupt";
   vlib_cli_output (vm, "input mode: %s", mode);
+  if (sm->flow_cache_timeout)
+    vlib_cli_output (vm, "flow cache timeout: %.1fs", sm->flow_cache_timeout);
+  else
+    vlib_cli_output (vm, "flow cache: disabled");
   return 0;
 }
 
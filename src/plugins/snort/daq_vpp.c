@@ -22,6 +22,9 @@
 
 #define DAQ_VPP_VERSION 1
 
+/* max verdicts held back before deq_head is published to vpp */
+#define DAQ_VPP_VERDICT_BATCH 32
+
 #if __x86_64__
 #define VPP_DAQ_PAUSE() __builtin_ia32_pause ()
 #elif defined(__aarch64__) || defined(__arm__)
@@ -73,6 +76,9 @@ typedef struct _vpp_qpair
   int deq_fd;
   VPPDescData *desc_data;
   volatile int lock;
+  /* verdicts written to deq_ring but not yet published to vpp */
+  uint32_t deq_next;
+  uint32_t n_deq_pending;
 } VPPQueuePair;
 
 typedef enum
@@ -419,6 +425,8 @@ vpp_daq_instantiate (const DAQ_ModuleConfig_h modcfg,
       qp->deq_ring = (uint32_t *) (base + msg.qpair.deq_ring_offset);
       qp->enq_head = (uint32_t *) (base + msg.qpair.enq_head_offset);
       qp->deq_head = (uint32_t *) (base + msg.qpair.deq_head_offset);
+      qp->deq_next = *qp->deq_head;
+      qp->n_deq_pending = 0;
       qp->enq_fd = fds[0];
       qp->deq_fd = fds[1];
       ev.data.u32 = i;
@@ -516,6 +524,26 @@ vpp_daq_get_datalink_type (void *handle)
   return DLT_IPV4;
 }
 
+/* called with qpair lock held */
+static inline int
+vpp_daq_qpair_flush_verdicts (VPP_Context_t *vc, VPPQueuePair *qp)
+{
+  uint64_t counter_increment = 1;
+
+  if (qp->n_deq_pending == 0)
+    return DAQ_SUCCESS;
+
+  __atomic_store_n (qp->deq_head, qp->deq_next, __ATOMIC_RELEASE);
+  qp->n_deq_pending = 0;
+
+  if (vc->input_mode == DAQ_VPP_INPUT_MODE_INTERRUPT &&
+      write (qp->deq_fd, &counter_increment, sizeof (counter_increment)) !=
+	sizeof (counter_increment))
+    return DAQ_ERROR;
+
+  return DAQ_SUCCESS;
+}
+
 static inline uint32_t
 vpp_daq_msg_receive_one (VPP_Context_t *vc, VPPQueuePair *qp,
 			 const DAQ_Msg_t *msgs[], unsigned max_recv)
@@ -524,10 +552,8 @@ vpp_daq_msg_receive_one (VPP_Context_t *vc, VPPQueuePair *qp,
   uint32_t head, next, mask = qp->queue_size - 1;
   struct timeval tv;
 
-  if (max_recv == 0)
-    return 0;
-
   vpp_daq_qpair_lock (qp);
+  vpp_daq_qpair_flush_verdicts (vc, qp);
   next = qp->next_desc;
   head = __atomic_load_n (qp->enq_head, __ATOMIC_ACQUIRE);
   n_recv = n_left = head - next;
@@ -537,6 +563,12 @@ vpp_daq_msg_receive_one (VPP_Context_t *vc, VPPQueuePair *qp,
       n_left = n_recv = max_recv;
     }
 
+  if (n_left == 0)
+    {
+      vpp_daq_qpair_unlock (qp);
+      return 0;
+    }
+
   gettimeofday (&tv, NULL);
   while (n_left--)
     {
@@ -647,31 +679,36 @@ vpp_daq_msg_finalize (void *handle, const DAQ_Msg_t *msg, DAQ_Verdict verdict)
   VPPDescData *dd = msg->priv;
   VPPQueuePair *qp = vc->qpairs + dd->qpair_index;
   daq_vpp_desc_t *d;
-  uint32_t mask, head;
-  uint64_t counter_increment = 1;
-  int rv, retv = DAQ_SUCCESS;
+  uint32_t mask;
+  int retv = DAQ_SUCCESS;
 
   vpp_daq_qpair_lock (qp);
   mask = qp->queue_size - 1;
-  head = *qp->deq_head;
   d = qp->descs + dd->index;
-  if (verdict == DAQ_VERDICT_PASS)
-    d->action = DAQ_VPP_ACTION_FORWARD;
-  else
-    d->action = DAQ_VPP_ACTION_DROP;
-
-  qp->deq_ring[head & mask] = dd->index;
-  head = head + 1;
-  __atomic_store_n (qp->deq_head, head, __ATOMIC_RELEASE);
-
-  if (vc->input_mode == DAQ_VPP_INPUT_MODE_INTERRUPT)
+  switch (verdict)
     {
-      rv = write (qp->deq_fd, &counter_increment, sizeof (counter_increment));
-
-      if (rv != sizeof (counter_increment))
-	retv = DAQ_ERROR;
+    case DAQ_VERDICT_PASS:
+    case DAQ_VERDICT_REPLACE:
+      d->action = DAQ_VPP_ACTION_FORWARD;
+      break;
+    case DAQ_VERDICT_WHITELIST:
+    case DAQ_VERDICT_IGNORE:
+      d->action = DAQ_VPP_ACTION_WHITELIST;
+      break;
+    default:
+      d->action = DAQ_VPP_ACTION_DROP;
     }
 
+  qp->deq_ring[qp->deq_next & mask] = dd->index;
+  qp->deq_next++;
+  qp->n_deq_pending++;
+
+  /* verdicts are published in batches, either when the batch is full or
+   * when snort comes back for more packets */
+  if (qp->n_deq_pending >= DAQ_VPP_VERDICT_BATCH ||
+      qp->deq_next == qp->next_desc)
+    retv = vpp_daq_qpair_flush_verdicts (vc, qp);
+
   vpp_daq_qpair_unlock (qp);
   return retv;
 }
@@ -63,6 +63,8 @@ typedef enum
 {
   DAQ_VPP_ACTION_DROP,
   DAQ_VPP_ACTION_FORWARD,
+  /* forward, remaining packets of the flow may bypass inspection */
+  DAQ_VPP_ACTION_WHITELIST,
 } daq_vpp_action_t;
 
 typedef struct
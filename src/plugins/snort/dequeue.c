@@ -43,36 +43,47 @@ static char *snort_deq_error_strings[] = {
 #undef _
 };
 
-static_always_inline uword
-snort_deq_instance (vlib_main_t *vm, u32 instance_index, snort_qpair_t *qp,
-		    u32 *buffer_indices, u16 *nexts, u32 max_recv)
+static_always_inline void
+snort_flow_cache_add (vlib_main_t *vm, snort_per_thread_data_t *ptd,
+		      u32 bi, u32 l3_offset, f64 timeout)
+{
+  vlib_buffer_t *b = vlib_get_buffer (vm, bi);
+  snort_flow_cache_entry_t *e;
+  u64 key[2];
+
+  if (!snort_flow_key_ip4 (vlib_buffer_get_current (b) + l3_offset, key))
+    return;
+
+  e = snort_flow_cache_slot (ptd, key);
+  e->key[0] = key[0];
+  e->key[1] = key[1];
+  e->expires = vlib_time_now (vm) + timeout;
+}
+
+static_always_inline u32
+snort_deq_ring (vlib_main_t *vm, snort_qpair_t *qp, u32 *buffer_indices,
+		u16 *nexts, u32 n_left)
 {
   snort_main_t *sm = &snort_main;
   snort_per_thread_data_t *ptd =
     vec_elt_at_index (sm->per_thread_data, vm->thread_index);
   u32 mask = pow2_mask (qp->log2_queue_size);
-  u32 head, next, n_recv = 0, n_left;
+  u32 next = qp->next_desc, n_recv = 0;
+  int use_flow_cache = sm->flow_cache_timeout != 0 && ptd->flow_cache;
 
-  head = __atomic_load_n (qp->deq_head, __ATOMIC_ACQUIRE);
-  next = qp->next_desc;
-
-  n_left = head - next;
-
-  if (n_left == 0)
-    return 0;
-
-  if (n_left > max_recv)
-    {
-      n_left = max_recv;
-      clib_interrupt_set (ptd->interrupts, instance_index);
-      vlib_node_set_interrupt_pending (vm, snort_deq_node.index);
-    }
+  if (use_flow_cache && ptd->flow_cache_epoch != sm->flow_cache_epoch)
+    use_flow_cache = 0;
 
   while (n_left)
     {
       u32 desc_index, bi;
       daq_vpp_desc_t *d;
 
+      /* verdicts are written by snort just before deq_head moves, so
+       * descriptors few slots ahead are likely not in our cache yet */
+      if (n_left > 4)
+	clib_prefetch_load (qp->descriptors + qp->deq_ring[(next + 4) & mask]);
+
       /* check if descriptor index taken from dequqe ring is valid */
       if ((desc_index = qp->deq_ring[next & mask]) & ~mask)
 	{
@@ -96,6 +107,13 @@ snort_deq_instance (vlib_main_t *vm, u32 instance_index, snort_qpair_t *qp,
       buffer_indices++[0] = bi;
       if (d->action == DAQ_VPP_ACTION_FORWARD)
 	nexts[0] = qp->next_indices[desc_index];
+      else if (d->action == DAQ_VPP_ACTION_WHITELIST)
+	{
+	  nexts[0] = qp->next_indices[desc_index];
+	  if (use_flow_cache)
+	    snort_flow_cache_add (vm, ptd, bi, qp->l3_offsets[desc_index],
+				  sm->flow_cache_timeout);
+	}
       else
 	nexts[0] = SNORT_ENQ_NEXT_DROP;
       qp->buffer_indices[desc_index] = ~0;
@@ -113,6 +131,31 @@ snort_deq_instance (vlib_main_t *vm, u32 instance_index, snort_qpair_t *qp,
   return n_recv;
 }
 
+static_always_inline uword
+snort_deq_instance (vlib_main_t *vm, u32 instance_index, snort_qpair_t *qp,
+		    u32 *buffer_indices, u16 *nexts, u32 max_recv)
+{
+  snort_main_t *sm = &snort_main;
+  snort_per_thread_data_t *ptd =
+    vec_elt_at_index (sm->per_thread_data, vm->thread_index);
+  u32 head, n_left;
+
+  head = __atomic_load_n (qp->deq_head, __ATOMIC_ACQUIRE);
+  n_left = head - qp->next_desc;
+
+  if (n_left == 0)
+    return 0;
+
+  if (n_left > max_recv)
+    {
+      n_left = max_recv;
+      clib_interrupt_set (ptd->interrupts, instance_index);
+      vlib_node_set_interrupt_pending (vm, snort_deq_node.index);
+    }
+
+  return snort_deq_ring (vm, qp, buffer_indices, nexts, n_left);
+}
+
 static_always_inline u32
 snort_process_all_buffer_indices (snort_qpair_t *qp, u32 *b, u16 *nexts,
 				  u32 max_recv, u8 drop_on_disconnect)
@@ -220,13 +263,10 @@ static_always_inline uword
 snort_deq_instance_poll (vlib_main_t *vm, snort_qpair_t *qp,
 			 u32 *buffer_indices, u16 *nexts, u32 max_recv)
 {
-  u32 mask = pow2_mask (qp->log2_queue_size);
-  u32 head, next, n_recv = 0, n_left;
+  u32 head, n_left;
 
   head = __atomic_load_n (qp->deq_head, __ATOMIC_ACQUIRE);
-  next = qp->next_desc;
-
-  n_left = head - next;
+  n_left = head - qp->next_desc;
 
   if (n_left == 0)
     return 0;
@@ -234,49 +274,7 @@ snort_deq_instance_poll (vlib_main_t *vm, snort_qpair_t *qp,
   if (n_left > max_recv)
     n_left = max_recv;
 
-  while (n_left)
-    {
-      u32 desc_index, bi;
-      daq_vpp_desc_t *d;
-
-      /* check if descriptor index taken from dequqe ring is valid */
-      if ((desc_index = qp->deq_ring[next & mask]) & ~mask)
-	{
-	  vlib_node_increment_counter (vm, snort_deq_node.index,
-				       SNORT_DEQ_ERROR_BAD_DESC_INDEX, 1);
-	  goto next;
-	}
-
-      /* check if descriptor index taken from dequeue ring points to enqueued
-       * buffer */
-      if ((bi = qp->buffer_indices[desc_index]) == ~0)
-	{
-	  vlib_node_increment_counter (vm, snort_deq_node.index,
-				       SNORT_DEQ_ERROR_BAD_DESC, 1);
-	  goto next;
-	}
-
-      /* put descriptor back to freelist */
-      vec_add1 (qp->freelist, desc_index);
-      d = qp->descriptors + desc_index;
-      buffer_indices++[0] = bi;
-      if (d->action == DAQ_VPP_ACTION_FORWARD)
-	nexts[0] = qp->next_indices[desc_index];
-      else
-	nexts[0] = SNORT_ENQ_NEXT_DROP;
-      qp->buffer_indices[desc_index] = ~0;
-      nexts++;
-      n_recv++;
-
-      /* next */
-    next:
-      next = next + 1;
-      n_left--;
-    }
-
-  qp->next_desc = next;
-
-  return n_recv;
+  return snort_deq_ring (vm, qp, buffer_indices, nexts, n_left);
 }
 
 static_always_inline uword
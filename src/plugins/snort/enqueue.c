@@ -43,7 +43,8 @@ format_snort_enq_trace (u8 *s, va_list *args)
 #define foreach_snort_enq_error                                               \
   _ (SOCKET_ERROR, "write socket error")                                      \
   _ (NO_INSTANCE, "no snort instance")                                        \
-  _ (NO_ENQ_SLOTS, "no enqueue slots (packet dropped)")
+  _ (NO_ENQ_SLOTS, "no enqueue slots (packet dropped)")                      \
+  _ (FLOW_BYPASS, "trusted flow, inspection bypassed")
 
 typedef enum
 {
@@ -86,6 +87,24 @@ get_snort_instance (snort_main_t *sm, vlib_buffer_t *b, u32 fa_data)
   return snort_get_instance_by_index (instance_index);
 }
 
+static_always_inline int
+snort_flow_cache_hit (snort_per_thread_data_t *ptd, vlib_buffer_t *b,
+		      u32 l3_offset, f64 now, f64 timeout)
+{
+  snort_flow_cache_entry_t *e;
+  u64 key[2];
+
+  if (!snort_flow_key_ip4 (vlib_buffer_get_current (b) + l3_offset, key))
+    return 0;
+
+  e = snort_flow_cache_slot (ptd, key);
+  if (e->key[0] != key[0] || e->key[1] != key[1] || e->expires < now)
+    return 0;
+
+  e->expires = now + timeout;
+  return 1;
+}
+
 static_always_inline uword
 snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 		       vlib_frame_t *frame, int with_trace)
@@ -94,16 +113,31 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   snort_instance_t *si = 0;
   snort_qpair_t *qp = 0;
   clib_thread_index_t thread_index = vm->thread_index;
+  snort_per_thread_data_t *ptd =
+    vec_elt_at_index (sm->per_thread_data, thread_index);
   u32 n_left = frame->n_vectors;
   u32 n_trace = 0;
-  u32 total_enq = 0, n_unprocessed = 0;
+  u32 total_enq = 0, n_unprocessed = 0, n_bypass = 0;
   u32 *from = vlib_frame_vector_args (frame);
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
   u16 nexts[VLIB_FRAME_SIZE], *next = nexts;
   u32 unprocessed_bufs[VLIB_FRAME_SIZE];
+  f64 timeout = sm->flow_cache_timeout, now = 0;
+  int use_flow_cache = timeout != 0 && ptd->flow_cache;
 
   vlib_get_buffers (vm, from, bufs, n_left);
 
+  if (use_flow_cache)
+    {
+      if (PREDICT_FALSE (ptd->flow_cache_epoch != sm->flow_cache_epoch))
+	{
+	  clib_memset (ptd->flow_cache, 0,
+		       vec_len (ptd->flow_cache) * sizeof (ptd->flow_cache[0]));
+	  ptd->flow_cache_epoch = sm->flow_cache_epoch;
+	}
+      now = vlib_time_now (vm);
+    }
+
   while (n_left)
     {
       u32 next_index, n;
@@ -113,6 +147,22 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       u32 l3_offset = (fa_data == SNORT_INPUT) ?
 			0 :
 			vnet_buffer (b[0])->ip.save_rewrite_length;
+
+      if (n_left > 2)
+	vlib_prefetch_buffer_data (b[2], LOAD);
+
+      /* flows snort has whitelisted skip the rings altogether */
+      if (use_flow_cache &&
+	  snort_flow_cache_hit (ptd, b[0], l3_offset, now, timeout))
+	{
+	  next[0] = next_index;
+	  next++;
+	  unprocessed_bufs[n_unprocessed] = from[0];
+	  n_unprocessed++;
+	  n_bypass++;
+	  goto next;
+	}
+
       si = get_snort_instance (sm, b[0], fa_data);
 
       /* if client isn't connected skip enqueue and take default action */
@@ -134,6 +184,7 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	  qp->pending_nexts[n] = next_index;
 	  qp->pending_buffers[n] = from[0];
+	  qp->pending_l3_offsets[n] = l3_offset;
 
 	  vlib_buffer_chain_linearize (vm, b[0]);
 
@@ -149,6 +200,7 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  d->address_space_id = vnet_buffer (b[0])->sw_if_index[VLIB_RX];
 	}
 
+    next:
       n_left--;
       from++;
       b++;
@@ -156,8 +208,13 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   if (n_unprocessed)
     {
-      vlib_node_increment_counter (vm, snort_enq_node.index,
-				   SNORT_ENQ_ERROR_NO_INSTANCE, n_unprocessed);
+      if (n_bypass)
+	vlib_node_increment_counter (vm, snort_enq_node.index,
+				     SNORT_ENQ_ERROR_FLOW_BYPASS, n_bypass);
+      if (n_unprocessed > n_bypass)
+	vlib_node_increment_counter (vm, snort_enq_node.index,
+				     SNORT_ENQ_ERROR_NO_INSTANCE,
+				     n_unprocessed - n_bypass);
       vlib_buffer_enqueue_to_next (vm, node, unprocessed_bufs, nexts,
 				   n_unprocessed);
     }
@@ -198,6 +255,7 @@ snort_enq_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	{
 	  u32 desc_index = qp->freelist[--freelist_len];
 	  qp->next_indices[desc_index] = qp->pending_nexts[i];
+	  qp->l3_offsets[desc_index] = qp->pending_l3_offsets[i];
 	  ASSERT (qp->buffer_indices[desc_index] == ~0);
 	  qp->buffer_indices[desc_index] = qp->pending_buffers[i];
 	  clib_memcpy_fast (qp->descriptors + desc_index,
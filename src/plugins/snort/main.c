@@ -57,6 +57,8 @@ snort_client_disconnect (clib_file_t *uf)
 	__atomic_store_n (&qp->ready, 1, __ATOMIC_RELEASE);
 
       si->client_index = ~0;
+      /* whitelist verdicts of the old client no longer apply */
+      sm->flow_cache_epoch++;
       clib_interrupt_set (ptd->interrupts, uf->private_data);
       vlib_node_set_interrupt_pending (vm, snort_deq_node.index);
     }
@@ -482,6 +484,7 @@ snort_instance_create (vlib_main_t *vm, char *name, u8 log2_queue_sz,
       vec_validate_aligned (qp->buffer_indices, qsz - 1,
 			    CLIB_CACHE_LINE_BYTES);
       vec_validate_aligned (qp->next_indices, qsz - 1, CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (qp->l3_offsets, qsz - 1, CLIB_CACHE_LINE_BYTES);
       clib_memset_u32 (qp->buffer_indices, ~0, qsz);
 
       /* pre-populate freelist */
@@ -498,6 +501,10 @@ snort_instance_create (vlib_main_t *vm, char *name, u8 log2_queue_sz,
       qp->ready = 1;
       clib_file_set_polling_thread (&file_main, qp->deq_fd_file_index, i);
       clib_interrupt_resize (&ptd->interrupts, vec_len (sm->instances));
+      if (!ptd->flow_cache)
+	vec_validate_aligned (ptd->flow_cache,
+			      pow2_mask (SNORT_FLOW_CACHE_LOG2_SIZE),
+			      CLIB_CACHE_LINE_BYTES);
     }
 
   for (i = 0; i < vlib_get_n_threads (); i++)
@@ -679,6 +686,7 @@ snort_interface_enable_disable (vlib_main_t *vm, char *instance_name,
 	  vec_del1 (*instance_indices, index);
 	}
     }
+  sm->flow_cache_epoch++;
 done:
   return rv;
 }
@@ -800,6 +808,14 @@ snort_instance_delete (vlib_main_t *vm, u32 instance_index)
   return rv;
 }
 
+void
+snort_flow_cache_set_timeout (f64 timeout)
+{
+  snort_main_t *sm = &snort_main;
+  sm->flow_cache_timeout = timeout;
+  sm->flow_cache_epoch++;
+}
+
 int
 snort_set_node_mode (vlib_main_t *vm, u32 mode)
 {
@@ -830,6 +846,7 @@ snort_init (vlib_main_t *vm)
 {
   snort_main_t *sm = &snort_main;
   sm->input_mode = VLIB_NODE_STATE_INTERRUPT;
+  sm->flow_cache_timeout = SNORT_FLOW_CACHE_DEFAULT_TIMEOUT;
   sm->instance_by_name = hash_create_string (0, sizeof (uword));
   vlib_buffer_pool_t *bp;
 
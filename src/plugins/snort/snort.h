@@ -9,9 +9,14 @@
 #include <vppinfra/error.h>
 #include <vppinfra/socket.h>
 #include <vppinfra/file.h>
+#include <vppinfra/xxhash.h>
 #include <vlib/vlib.h>
+#include <vnet/ip/ip4_packet.h>
 #include <snort/daq_vpp.h>
 
+#define SNORT_FLOW_CACHE_LOG2_SIZE 12
+#define SNORT_FLOW_CACHE_DEFAULT_TIMEOUT 30.0
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -26,6 +31,7 @@ typedef struct
   u32 deq_fd_file_index;
   u32 *buffer_indices;
   u16 *next_indices;
+  u8 *l3_offsets;
   u32 *freelist;
   u32 ready;
 
@@ -33,6 +39,7 @@ typedef struct
   u32 n_pending;
   u16 pending_nexts[VLIB_FRAME_SIZE];
   u32 pending_buffers[VLIB_FRAME_SIZE];
+  u8 pending_l3_offsets[VLIB_FRAME_SIZE];
   daq_vpp_desc_t pending_descs[VLIB_FRAME_SIZE];
 } snort_qpair_t;
 
@@ -63,10 +70,21 @@ typedef struct
   snort_client_msg_queue_elt *msg_queue;
 } snort_client_t;
 
+/* direction agnostic ip4 5-tuple of a flow snort asked not to inspect */
+typedef struct
+{
+  u64 key[2];
+  f64 expires;
+} snort_flow_cache_entry_t;
+
 typedef struct
 {
   /* per-instance dequeue interrupts */
   void *interrupts;
+
+  /* direct mapped cache of trusted flows */
+  snort_flow_cache_entry_t *flow_cache;
+  u32 flow_cache_epoch;
 } snort_per_thread_data_t;
 
 /* Holds snort plugin related information for an interface */
@@ -87,6 +105,10 @@ typedef struct
   snort_per_thread_data_t *per_thread_data;
   u32 input_mode;
   u8 *socket_name;
+  /* trusted flow idle timeout, 0 disables the cache */
+  f64 flow_cache_timeout;
+  /* bumped to invalidate all per-thread flow caches */
+  u32 flow_cache_epoch;
   /* API message ID base */
   u16 msg_id_base;
 } snort_main_t;
@@ -133,6 +155,7 @@ int snort_interface_disable_all (vlib_main_t *vm, u32 sw_if_index);
 int snort_set_node_mode (vlib_main_t *vm, u32 mode);
 int snort_instance_delete (vlib_main_t *vm, u32 instance_index);
 int snort_instance_disconnect (vlib_main_t *vm, u32 instance_index);
+void snort_flow_cache_set_timeout (f64 timeout);
 
 always_inline void
 snort_freelist_init (u32 *fl)
@@ -141,4 +164,43 @@ snort_freelist_init (u32 *fl)
     fl[j] = j;
 }
 
+static_always_inline int
+snort_flow_key_ip4 (ip4_header_t *ip, u64 *key)
+{
+  u32 a = ip->src_address.as_u32, b = ip->dst_address.as_u32;
+  u16 pa = 0, pb = 0;
+
+  if (ip4_is_fragment (ip))
+    return 0;
+
+  if (ip->protocol == IP_PROTOCOL_TCP || ip->protocol == IP_PROTOCOL_UDP)
+    {
+      u16 *ports = (u16 *) ip4_next_header (ip);
+      pa = ports[0];
+      pb = ports[1];
+    }
+
+  /* same key for both directions */
+  if (a > b || (a == b && pa > pb))
+    {
+      u32 t = a;
+      u16 tp = pa;
+      a = b;
+      b = t;
+      pa = pb;
+      pb = tp;
+    }
+
+  key[0] = (u64) a << 32 | b;
+  key[1] = (u64) ip->protocol << 32 | (u32) pa << 16 | pb;
+  return 1;
+}
+
+static_always_inline snort_flow_cache_entry_t *
+snort_flow_cache_slot (snort_per_thread_data_t *ptd, u64 *key)
+{
+  u64 h = clib_xxhash (key[0] ^ clib_xxhash (key[1]));
+  return ptd->flow_cache + (h & pow2_mask (SNORT_FLOW_CACHE_LOG2_SIZE));
+}
+
 #endif /* __snort_snort_h__ */
@@ -0,0 +1,619 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+/*
+ * TLS 1.3 record offload
+ *
+ * OpenSSL does the handshake. Traffic secrets are captured with the keylog
+ * callback and, once the handshake is done, application data records are
+ * protected with vnet crypto, in batches of up to TLSO_OFL_MAX_RECS records
+ * per read/write, instead of going through SSL_read/SSL_write.
+ *
+ * Only server side TLS 1.3 sessions with AES-GCM or ChaCha20-Poly1305 are
+ * offloaded. Session tickets are disabled on such sessions so OpenSSL does
+ * not protect any record with the application traffic keys and the only
+ * post-handshake message expected from the peer is KeyUpdate.
+ */
+
+#include <openssl/kdf.h>
+#include <vnet/session/application_interface.h>
+#include <vnet/tls/tls_record.h>
+#include <tlsopenssl/tls_openssl.h>
+
+#define TLSO_OFL_HDR_LEN   sizeof (tls_record_header_t)
+#define TLSO_OFL_REC_SPACE (TLSO_OFL_HDR_LEN + TLS13_FRAGMENT_MAX_ENC_LEN)
+
+extern openssl_main_t openssl_main;
+
+static void
+openssl_ofl_keylog_cb (const SSL *ssl, const char *line)
+{
+  openssl_ofl_ctx_t *ofl = SSL_get_app_data (ssl);
+  u8 *random = 0, *secret = 0;
+  openssl_ofl_dir_t *dir = 0;
+  unformat_input_t input;
+
+  if (!ofl)
+    return;
+
+  unformat_init_string (&input, line, strlen (line));
+  /* server receives with client secret and sends with server secret */
+  if (unformat (&input, "CLIENT_TRAFFIC_SECRET_0 %U %U", unformat_hex_string,
+		&random, unformat_hex_string, &secret))
+    {
+      dir = &ofl->rx;
+      ofl->flags |= OPENSSL_OFL_F_RX_SECRET;
+    }
+  else if (unformat (&input, "SERVER_TRAFFIC_SECRET_0 %U %U",
+		     unformat_hex_string, &random, unformat_hex_string,
+		     &secret))
+    {
+      dir = &ofl->tx;
+      ofl->flags |= OPENSSL_OFL_F_TX_SECRET;
+    }
+  unformat_free (&input);
+
+  if (dir)
+    {
+      if (vec_len (secret) > TLSO_OFL_SECRET_MAX_LEN ||
+	  (ofl->secret_len && ofl->secret_len != vec_len (secret)))
+	ofl->flags &= ~(OPENSSL_OFL_F_RX_SECRET | OPENSSL_OFL_F_TX_SECRET);
+      else
+	{
+	  clib_memcpy (dir->secret, secret, vec_len (secret));
+	  ofl->secret_len = vec_len (secret);
+	}
+    }
+
+  vec_free (random);
+  if (secret)
+    clib_memset (secret, 0, vec_len (secret));
+  vec_free (secret);
+}
+
+void
+openssl_ofl_ssl_ctx_init (SSL_CTX *ssl_ctx)
+{
+  SSL_CTX_set_keylog_callback (ssl_ctx, openssl_ofl_keylog_cb);
+}
+
+void
+openssl_ofl_ctx_init (openssl_ctx_t *oc)
+{
+  openssl_ofl_ctx_t *ofl;
+
+  ofl = clib_mem_alloc (sizeof (*ofl));
+  clib_memset (ofl, 0, sizeof (*ofl));
+  ofl->rx.key_index = ~0;
+  ofl->tx.key_index = ~0;
+  oc->ofl = ofl;
+
+  SSL_set_app_data (oc->ssl, ofl);
+  /* tickets would be protected by openssl with application keys */
+  SSL_set_num_tickets (oc->ssl, 0);
+}
+
+static void
+openssl_ofl_key_del (u32 *key_index)
+{
+  openssl_main_t *om = &openssl_main;
+
+  if (*key_index == ~0)
+    return;
+
+  clib_rwlock_writer_lock (&om->crypto_keys_rw_lock);
+  vnet_crypto_key_del (vlib_get_main (), *key_index);
+  clib_rwlock_writer_unlock (&om->crypto_keys_rw_lock);
+  *key_index = ~0;
+}
+
+void
+openssl_ofl_ctx_free (openssl_ctx_t *oc)
+{
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+
+  if (!ofl)
+    return;
+
+  openssl_ofl_key_del (&ofl->rx.key_index);
+  openssl_ofl_key_del (&ofl->tx.key_index);
+  SSL_set_app_data (oc->ssl, 0);
+  clib_memset (ofl, 0, sizeof (*ofl));
+  clib_mem_free (ofl);
+  oc->ofl = 0;
+}
+
+/**
+ * HKDF-Expand-Label as per rfc8446#section-7.1, with empty context
+ */
+static int
+openssl_ofl_hkdf_expand_label (const EVP_MD *md, u8 *secret, u32 secret_len,
+			       const char *label, u8 *out, u32 out_len)
+{
+  u32 label_len = strlen (label);
+  u8 info[4 + 6 + 255], *p = info;
+  size_t len = out_len;
+  EVP_PKEY_CTX *pctx;
+  int rv = -1;
+
+  *p++ = out_len >> 8;
+  *p++ = out_len & 0xff;
+  *p++ = 6 + label_len;
+  clib_memcpy (p, "tls13 ", 6);
+  p += 6;
+  clib_memcpy (p, label, label_len);
+  p += label_len;
+  *p++ = 0;
+
+  pctx = EVP_PKEY_CTX_new_id (EVP_PKEY_HKDF, 0);
+  if (!pctx)
+    return -1;
+
+  if (EVP_PKEY_derive_init (pctx) <= 0 ||
+      EVP_PKEY_CTX_hkdf_mode (pctx, EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) <= 0 ||
+      EVP_PKEY_CTX_set_hkdf_md (pctx, md) <= 0 ||
+      EVP_PKEY_CTX_set1_hkdf_key (pctx, secret, secret_len) <= 0 ||
+      EVP_PKEY_CTX_add1_hkdf_info (pctx, info, p - info) <= 0 ||
+      EVP_PKEY_derive (pctx, out, &len) <= 0 || len != out_len)
+    goto done;
+
+  rv = 0;
+
+done:
+  EVP_PKEY_CTX_free (pctx);
+  return rv;
+}
+
+/**
+ * Derive traffic key and iv from secret and register key with vnet crypto
+ */
+static int
+openssl_ofl_dir_set_keys (openssl_ofl_ctx_t *ofl, openssl_ofl_dir_t *dir)
+{
+  openssl_main_t *om = &openssl_main;
+  u8 key[32];
+  int rv = -1;
+
+  if (openssl_ofl_hkdf_expand_label (ofl->md, dir->secret, ofl->secret_len,
+				     "key", key, ofl->key_len) ||
+      openssl_ofl_hkdf_expand_label (ofl->md, dir->secret, ofl->secret_len,
+				     "iv", dir->iv, TLSO_OFL_IV_LEN))
+    goto done;
+
+  openssl_ofl_key_del (&dir->key_index);
+
+  clib_rwlock_writer_lock (&om->crypto_keys_rw_lock);
+  dir->key_index =
+    vnet_crypto_key_add (vlib_get_main (), ofl->alg, key, ofl->key_len);
+  clib_rwlock_writer_unlock (&om->crypto_keys_rw_lock);
+
+  dir->seq = 0;
+  rv = dir->key_index == ~0 ? -1 : 0;
+
+done:
+  clib_memset (key, 0, sizeof (key));
+  return rv;
+}
+
+/**
+ * Move to next generation of traffic secret, rfc8446#section-7.2
+ */
+static int
+openssl_ofl_dir_update_keys (openssl_ofl_ctx_t *ofl, openssl_ofl_dir_t *dir)
+{
+  u8 secret[TLSO_OFL_SECRET_MAX_LEN];
+  int rv;
+
+  if (openssl_ofl_hkdf_expand_label (ofl->md, dir->secret, ofl->secret_len,
+				     "traffic upd", secret, ofl->secret_len))
+    return -1;
+
+  clib_memcpy (dir->secret, secret, ofl->secret_len);
+  clib_memset (secret, 0, sizeof (secret));
+  rv = openssl_ofl_dir_set_keys (ofl, dir);
+
+  return rv;
+}
+
+int
+openssl_ofl_try_enable (openssl_ctx_t *oc)
+{
+  u8 secrets = OPENSSL_OFL_F_RX_SECRET | OPENSSL_OFL_F_TX_SECRET;
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+  const SSL_CIPHER *cipher;
+
+  if (!ofl)
+    return -1;
+
+  /* records already buffered by openssl can't be handed over */
+  if (SSL_version (oc->ssl) != TLS1_3_VERSION ||
+      (ofl->flags & secrets) != secrets || SSL_has_pending (oc->ssl))
+    goto disable;
+
+  cipher = SSL_get_current_cipher (oc->ssl);
+  if (!cipher)
+    goto disable;
+
+  switch (SSL_CIPHER_get_protocol_id (cipher))
+    {
+    case 0x1301: /* TLS_AES_128_GCM_SHA256 */
+      ofl->alg = VNET_CRYPTO_ALG_AES_128_GCM;
+      ofl->enc_op_id = VNET_CRYPTO_OP_AES_128_GCM_ENC;
+      ofl->dec_op_id = VNET_CRYPTO_OP_AES_128_GCM_DEC;
+      ofl->md = EVP_sha256 ();
+      ofl->key_len = 16;
+      break;
+    case 0x1302: /* TLS_AES_256_GCM_SHA384 */
+      ofl->alg = VNET_CRYPTO_ALG_AES_256_GCM;
+      ofl->enc_op_id = VNET_CRYPTO_OP_AES_256_GCM_ENC;
+      ofl->dec_op_id = VNET_CRYPTO_OP_AES_256_GCM_DEC;
+      ofl->md = EVP_sha384 ();
+      ofl->key_len = 32;
+      break;
+    case 0x1303: /* TLS_CHACHA20_POLY1305_SHA256 */
+      ofl->alg = VNET_CRYPTO_ALG_CHACHA20_POLY1305;
+      ofl->enc_op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_ENC;
+      ofl->dec_op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_DEC;
+      ofl->md = EVP_sha256 ();
+      ofl->key_len = 32;
+      break;
+    default:
+      goto disable;
+    }
+
+  if (ofl->secret_len != EVP_MD_size (ofl->md) ||
+      !vnet_crypto_is_set_handler (ofl->alg))
+    goto disable;
+
+  if (openssl_ofl_dir_set_keys (ofl, &ofl->rx) ||
+      openssl_ofl_dir_set_keys (ofl, &ofl->tx))
+    goto disable;
+
+  /* openssl must not write alerts with its own record state anymore */
+  SSL_set_quiet_shutdown (oc->ssl, 1);
+  ofl->flags |= OPENSSL_OFL_F_ACTIVE;
+
+  TLS_DBG (1, "record offload enabled for %u cipher %s",
+	   oc->openssl_ctx_index, SSL_CIPHER_get_name (cipher));
+
+  return 0;
+
+disable:
+
+  openssl_ofl_ctx_free (oc);
+  return -1;
+}
+
+static inline void
+openssl_ofl_build_nonce (u8 *nonce, openssl_ofl_dir_t *dir, u64 seq)
+{
+  u64 seq_be = clib_host_to_net_u64 (seq);
+  int i;
+
+  clib_memcpy (nonce, dir->iv, TLSO_OFL_IV_LEN);
+  for (i = 0; i < 8; i++)
+    nonce[TLSO_OFL_IV_LEN - 8 + i] ^= ((u8 *) &seq_be)[i];
+}
+
+static inline u32
+openssl_ofl_build_record (openssl_ofl_ctx_t *ofl, vnet_crypto_op_t *op,
+			  u8 *nonce, u64 seq, u8 *rec, u32 plain_len,
+			  tls_record_type_t type)
+{
+  u16 enc_len = plain_len + 1 + TLSO_OFL_TAG_LEN;
+
+  rec[0] = TLS_REC_APPLICATION_DATA;
+  rec[1] = TLS_MAJOR_VERSION;
+  rec[2] = 3; /* legacy record version 1.2 */
+  rec[3] = enc_len >> 8;
+  rec[4] = enc_len & 0xff;
+  /* inner content type, no padding */
+  rec[TLSO_OFL_HDR_LEN + plain_len] = type;
+
+  openssl_ofl_build_nonce (nonce, &ofl->tx, seq);
+  vnet_crypto_op_init (op, ofl->enc_op_id);
+  op->key_index = ofl->tx.key_index;
+  op->iv = nonce;
+  op->aad = rec;
+  op->aad_len = TLSO_OFL_HDR_LEN;
+  op->src = op->dst = rec + TLSO_OFL_HDR_LEN;
+  op->len = plain_len + 1;
+  op->tag = op->src + op->len;
+  op->tag_len = TLSO_OFL_TAG_LEN;
+
+  return TLSO_OFL_HDR_LEN + enc_len;
+}
+
+/**
+ * Protect and send one record outside of the data path, e.g., alerts
+ */
+static int
+openssl_ofl_write_record (tls_ctx_t *ctx, tls_record_type_t type, u8 *data,
+			  u32 len)
+{
+  openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+  u8 rec[TLSO_OFL_HDR_LEN + 8 + TLSO_OFL_TAG_LEN + 1];
+  u8 nonce[TLSO_OFL_IV_LEN];
+  vnet_crypto_op_t _op, *op = &_op;
+  svm_msg_q_t *mq;
+  session_t *ts;
+  u32 rec_len;
+  int rv;
+
+  ASSERT (len <= 8);
+  clib_memcpy (rec + TLSO_OFL_HDR_LEN, data, len);
+  rec_len =
+    openssl_ofl_build_record (ofl, op, nonce, ofl->tx.seq, rec, len, type);
+  vnet_crypto_process_ops (vlib_get_main (), op, 1);
+  if (op->status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+    return -1;
+  ofl->tx.seq++;
+
+  ts = session_get_from_handle (ctx->tls_session_handle);
+  mq = session_main_get_vpp_event_queue (ts->thread_index);
+  rv = app_send_stream_raw (ts->tx_fifo, mq, rec, rec_len, SESSION_IO_EVT_TX,
+			    1 /* do_evt */, 0 /* noblock */);
+
+  return rv == rec_len ? 0 : -1;
+}
+
+void
+openssl_ofl_send_close_notify (tls_ctx_t *ctx)
+{
+  /* level warning, description close_notify */
+  u8 alert[2] = { 1, 0 };
+
+  openssl_ofl_write_record (ctx, TLS_REC_ALERT, alert, sizeof (alert));
+}
+
+static int
+openssl_ofl_handle_handshake_msg (tls_ctx_t *ctx, u8 *msg, u32 len)
+{
+  openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+  u8 key_update[5] = { TLS_HS_KEY_UPDATE, 0, 0, 1, 0 };
+
+  /* only single, unfragmented, KeyUpdate is expected */
+  if (len != 5 || msg[0] != TLS_HS_KEY_UPDATE || msg[1] || msg[2] ||
+      msg[3] != 1 || msg[4] > 1)
+    return -1;
+
+  if (openssl_ofl_dir_update_keys (ofl, &ofl->rx))
+    return -1;
+
+  /* update_requested, answer with our own update before switching keys */
+  if (msg[4] == 1)
+    {
+      if (openssl_ofl_write_record (ctx, TLS_REC_HANDSHAKE, key_update,
+				    sizeof (key_update)) ||
+	  openssl_ofl_dir_update_keys (ofl, &ofl->tx))
+	return -1;
+    }
+
+  return 0;
+}
+
+static inline int
+openssl_ofl_rec_len (tls_record_header_t *hdr)
+{
+  u16 rec_len = clib_net_to_host_u16 (hdr->length);
+
+  if (hdr->type != TLS_REC_APPLICATION_DATA ||
+      hdr->version.major != TLS_MAJOR_VERSION ||
+      rec_len < 1 + TLSO_OFL_TAG_LEN || rec_len > TLS13_FRAGMENT_MAX_ENC_LEN)
+    return -1;
+
+  return rec_len;
+}
+
+int
+openssl_ofl_rx_has_record (session_t *ts)
+{
+  tls_record_header_t hdr;
+  u32 max_deq;
+  int rec_len;
+
+  max_deq = svm_fifo_max_dequeue_cons (ts->rx_fifo);
+  if (max_deq < TLSO_OFL_HDR_LEN)
+    return 0;
+
+  svm_fifo_peek (ts->rx_fifo, 0, TLSO_OFL_HDR_LEN, (u8 *) &hdr);
+  rec_len = openssl_ofl_rec_len (&hdr);
+
+  /* let read fail on bogus header */
+  return rec_len < 0 || max_deq >= TLSO_OFL_HDR_LEN + rec_len;
+}
+
+int
+openssl_ofl_read (tls_ctx_t *ctx, session_t *ts, session_t *as, u32 max_len)
+{
+  openssl_main_t *om = &openssl_main;
+  openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+  openssl_ofl_per_thread_t *wrk;
+  u32 max_deq, offset = 0, n_ops = 0, consumed = 0, plain_len, est = 0;
+  int rec_len, read = 0, i;
+  tls_record_header_t hdr;
+  vnet_crypto_op_t *op;
+  u8 *p, *rec;
+
+  max_deq = svm_fifo_max_dequeue_cons (ts->rx_fifo);
+
+  /* nothing expected after close_notify */
+  if (ofl->flags & OPENSSL_OFL_F_PEER_CLOSED)
+    {
+      svm_fifo_dequeue_drop (ts->rx_fifo, max_deq);
+      return 0;
+    }
+
+  max_len = clib_min (max_len, svm_fifo_max_enqueue_prod (as->rx_fifo));
+
+  wrk = &om->ofl_wrk[ctx->c_thread_index];
+  if (PREDICT_FALSE (!wrk->rx_buf))
+    vec_validate (wrk->rx_buf, TLSO_OFL_MAX_RECS * TLSO_OFL_REC_SPACE - 1);
+  rec = wrk->rx_buf;
+
+  /* collect complete records that fit into app's fifo */
+  while (n_ops < TLSO_OFL_MAX_RECS && offset + TLSO_OFL_HDR_LEN <= max_deq)
+    {
+      svm_fifo_peek (ts->rx_fifo, offset, TLSO_OFL_HDR_LEN, (u8 *) &hdr);
+      rec_len = openssl_ofl_rec_len (&hdr);
+      if (rec_len < 0)
+	{
+	  TLS_DBG (1, "invalid record header");
+	  return -1;
+	}
+      if (offset + TLSO_OFL_HDR_LEN + rec_len > max_deq ||
+	  est + rec_len - 1 - TLSO_OFL_TAG_LEN > max_len)
+	break;
+
+      svm_fifo_peek (ts->rx_fifo, offset, TLSO_OFL_HDR_LEN + rec_len, rec);
+
+      op = &wrk->ops[n_ops];
+      openssl_ofl_build_nonce (wrk->ivs[n_ops], &ofl->rx,
+			       ofl->rx.seq + n_ops);
+      vnet_crypto_op_init (op, ofl->dec_op_id);
+      op->key_index = ofl->rx.key_index;
+      op->iv = wrk->ivs[n_ops];
+      op->aad = rec;
+      op->aad_len = TLSO_OFL_HDR_LEN;
+      op->src = op->dst = rec + TLSO_OFL_HDR_LEN;
+      op->len = rec_len - TLSO_OFL_TAG_LEN;
+      op->tag = op->src + op->len;
+      op->tag_len = TLSO_OFL_TAG_LEN;
+
+      est += rec_len - 1 - TLSO_OFL_TAG_LEN;
+      offset += TLSO_OFL_HDR_LEN + rec_len;
+      rec += TLSO_OFL_HDR_LEN + rec_len;
+      n_ops++;
+    }
+
+  if (!n_ops)
+    return 0;
+
+  vnet_crypto_process_ops (vlib_get_main (), wrk->ops, n_ops);
+
+  for (i = 0; i < n_ops; i++)
+    {
+      op = &wrk->ops[i];
+      if (op->status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+	{
+	  TLS_DBG (1, "record decrypt failed: %U", format_vnet_crypto_op_status,
+		   op->status);
+	  return -1;
+	}
+      ofl->rx.seq++;
+      consumed += TLSO_OFL_HDR_LEN + op->len + TLSO_OFL_TAG_LEN;
+
+      /* strip padding to find inner content type */
+      p = op->dst + op->len - 1;
+      while (p > op->dst && !*p)
+	p--;
+      plain_len = p - op->dst;
+
+      switch (*p)
+	{
+	case TLS_REC_APPLICATION_DATA:
+	  if (plain_len)
+	    {
+	      svm_fifo_enqueue (as->rx_fifo, plain_len, op->dst);
+	      read += plain_len;
+	    }
+	  break;
+	case TLS_REC_ALERT:
+	  /* anything but close_notify is fatal */
+	  if (plain_len != 2 || op->dst[1] != 0)
+	    return -1;
+	  ofl->flags |= OPENSSL_OFL_F_PEER_CLOSED;
+	  goto done;
+	case TLS_REC_HANDSHAKE:
+	  if (openssl_ofl_handle_handshake_msg (ctx, op->dst, plain_len))
+	    return -1;
+	  /* rest of batch used old keys, retry with new ones */
+	  goto done;
+	default:
+	  return -1;
+	}
+    }
+
+done:
+
+  svm_fifo_dequeue_drop (ts->rx_fifo, consumed);
+
+  if (svm_fifo_needs_deq_ntf (ts->rx_fifo, consumed))
+    {
+      svm_fifo_clear_deq_ntf (ts->rx_fifo);
+      session_program_transport_io_evt (ts->handle, SESSION_IO_EVT_RX);
+    }
+
+  if (svm_fifo_is_empty_cons (ts->rx_fifo))
+    svm_fifo_unset_event (ts->rx_fifo);
+
+  return read;
+}
+
+int
+openssl_ofl_write (tls_ctx_t *ctx, svm_fifo_t *f, session_t *ts, u32 max_len)
+{
+  openssl_main_t *om = &openssl_main;
+  openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
+  openssl_ofl_ctx_t *ofl = oc->ofl;
+  u32 rec_size, plain_len, offset = 0, buf_len = 0, n_ops = 0, i;
+  openssl_ofl_per_thread_t *wrk;
+  svm_msg_q_t *mq;
+  u8 *rec;
+  int rv;
+
+  wrk = &om->ofl_wrk[ctx->c_thread_index];
+  if (PREDICT_FALSE (!wrk->tx_buf))
+    vec_validate (wrk->tx_buf, TLSO_OFL_MAX_RECS * TLSO_OFL_REC_SPACE - 1);
+
+  rec_size = TLS_FRAGMENT_MAX_LEN;
+  if (om->record_size)
+    rec_size = clib_min (om->record_size, TLS_FRAGMENT_MAX_LEN);
+  max_len = clib_min (max_len, svm_fifo_max_dequeue_cons (f));
+
+  while (offset < max_len && n_ops < TLSO_OFL_MAX_RECS)
+    {
+      plain_len = clib_min (rec_size, max_len - offset);
+      rec = wrk->tx_buf + buf_len;
+      svm_fifo_peek (f, offset, plain_len, rec + TLSO_OFL_HDR_LEN);
+      buf_len += openssl_ofl_build_record (ofl, &wrk->ops[n_ops],
+					   wrk->ivs[n_ops], ofl->tx.seq + n_ops,
+					   rec, plain_len,
+					   TLS_REC_APPLICATION_DATA);
+      offset += plain_len;
+      n_ops++;
+    }
+
+  if (!n_ops)
+    return 0;
+
+  vnet_crypto_process_ops (vlib_get_main (), wrk->ops, n_ops);
+
+  for (i = 0; i < n_ops; i++)
+    if (wrk->ops[i].status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+      return -1;
+  ofl->tx.seq += n_ops;
+
+  /* caller made sure tls fifo can take records with their overhead */
+  mq = session_main_get_vpp_event_queue (ts->thread_index);
+  rv = app_send_stream_raw (ts->tx_fifo, mq, wrk->tx_buf, buf_len,
+			    SESSION_IO_EVT_TX, 1 /* do_evt */, 0 /* noblock */);
+  if (rv != buf_len)
+    return -1;
+
+  svm_fifo_dequeue_drop (f, offset);
+
+  return offset;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -71,6 +71,7 @@ openssl_ctx_free (tls_ctx_t * ctx)
 	  !(ctx->flags & TLS_CONN_F_PASSIVE_CLOSE))
 	SSL_shutdown (oc->ssl);
 
+      openssl_ofl_ctx_free (oc);
       SSL_free (oc->ssl);
       vec_free (ctx->srv_hostname);
       SSL_CTX_free (oc->client_ssl_ctx);
@@ -300,12 +301,125 @@ openssl_handle_handshake_failure (tls_ctx_t *ctx)
     }
 }
 
+static vlib_node_registration_t openssl_hs_throttle_node;
+
+static void
+openssl_hs_refill (openssl_hs_wrk_t *hw, f64 now)
+{
+  openssl_main_t *om = &openssl_main;
+  f64 burst = clib_max (1.0, om->hs_rate * TLSO_HS_BURST_INTERVAL);
+
+  hw->tokens += (now - hw->last_refill) * om->hs_rate;
+  hw->tokens = clib_min (hw->tokens, burst);
+  hw->last_refill = now;
+}
+
+static void
+openssl_hs_throttle_schedule (vlib_main_t *vm, openssl_hs_wrk_t *hw)
+{
+  openssl_main_t *om = &openssl_main;
+  f64 dt;
+
+  if (vlib_node_is_scheduled (vm, openssl_hs_throttle_node.index))
+    return;
+
+  dt = (1.0 - hw->tokens) / om->hs_rate;
+  vlib_node_schedule (vm, openssl_hs_throttle_node.index, clib_max (dt, 1e-4));
+}
+
+/**
+ * Admit new server handshake if worker's budget of private key operations
+ * allows it, otherwise defer it until the budget has been refilled.
+ */
+static int
+openssl_hs_admit (tls_ctx_t *ctx)
+{
+  openssl_main_t *om = &openssl_main;
+  openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
+  vlib_main_t *vm = vlib_get_main ();
+  openssl_hs_wrk_t *hw;
+
+  if (oc->hs_deferred)
+    return 0;
+
+  hw = &om->hs_wrk[ctx->c_thread_index];
+  openssl_hs_refill (hw, vlib_time_now (vm));
+
+  /* Older deferred handshakes go first */
+  if (hw->tokens >= 1.0 && !clib_fifo_elts (hw->pending_ctxs))
+    {
+      hw->tokens -= 1.0;
+      oc->hs_admitted = 1;
+      return 1;
+    }
+
+  oc->hs_deferred = 1;
+  hw->n_deferred += 1;
+  clib_fifo_add1 (hw->pending_ctxs, oc->openssl_ctx_index);
+  openssl_hs_throttle_schedule (vm, hw);
+
+  return 0;
+}
+
+static uword
+openssl_hs_throttle_node_fn (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			     vlib_frame_t *f)
+{
+  clib_thread_index_t thread_index = vm->thread_index;
+  openssl_main_t *om = &openssl_main;
+  openssl_hs_wrk_t *hw;
+  openssl_ctx_t *oc;
+  session_t *ts;
+  u32 ctx_index;
+
+  hw = &om->hs_wrk[thread_index];
+  openssl_hs_refill (hw, vlib_time_now (vm));
+
+  while (clib_fifo_elts (hw->pending_ctxs) &&
+	 (hw->tokens >= 1.0 || !om->hs_rate))
+    {
+      clib_fifo_sub1 (hw->pending_ctxs, ctx_index);
+
+      /* Ctx might have been freed or reused while waiting */
+      if (pool_is_free_index (om->ctx_pool[thread_index], ctx_index))
+	continue;
+      oc = *pool_elt_at_index (om->ctx_pool[thread_index], ctx_index);
+      if (!oc->hs_deferred)
+	continue;
+
+      oc->hs_deferred = 0;
+      oc->hs_admitted = 1;
+      hw->tokens -= 1.0;
+
+      ts = session_get_from_handle_if_valid (oc->ctx.tls_session_handle);
+      if (ts)
+	tls_add_vpp_q_builtin_rx_evt (ts);
+    }
+
+  if (clib_fifo_elts (hw->pending_ctxs))
+    openssl_hs_throttle_schedule (vm, hw);
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (openssl_hs_throttle_node, static) = {
+  .function = openssl_hs_throttle_node_fn,
+  .name = "tls-openssl-hs-throttle",
+  .type = VLIB_NODE_TYPE_SCHED,
+};
+
 int
 openssl_ctx_handshake_rx (tls_ctx_t *ctx, session_t *tls_session)
 {
   openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
   int rv = 0, err;
 
+  /* Rate limit handshakes that have not started yet, to protect the
+   * worker from bursts of private key operations */
+  if (openssl_main.hs_rate && !oc->hs_admitted && SSL_is_server (oc->ssl) &&
+      !openssl_hs_admit (ctx))
+    return -1;
+
   while (SSL_in_init (oc->ssl))
     {
       if (ctx->flags & TLS_CONN_F_RESUME)
@@ -391,6 +505,10 @@ openssl_ctx_handshake_rx (tls_ctx_t *ctx, session_t *tls_session)
 	  tls_disconnect_transport (ctx);
 	  return -1;
 	}
+
+      /* Falls back to openssl record layer if offload not possible */
+      if (oc->ofl)
+	openssl_ofl_try_enable (oc);
     }
   ctx->flags |= TLS_CONN_F_HS_DONE;
   TLS_DBG (1, "Handshake for %u complete. TLS cipher is %s",
@@ -402,7 +520,10 @@ void
 openssl_confirm_app_close (tls_ctx_t *ctx)
 {
   openssl_ctx_t *oc = (openssl_ctx_t *) ctx;
-  SSL_shutdown (oc->ssl);
+  if (openssl_ofl_is_active (oc))
+    openssl_ofl_send_close_notify (ctx);
+  else
+    SSL_shutdown (oc->ssl);
   tls_disconnect_transport (ctx);
   session_transport_closed_notify (&ctx->connection);
 }
@@ -438,7 +559,10 @@ openssl_ctx_write_tls (tls_ctx_t *ctx, session_t *app_session,
   if (svm_fifo_provision_chunks (ts->tx_fifo, 0, 0, deq_max + TLSO_CTRL_BYTES))
     goto check_tls_fifo;
 
-  wrote = openssl_write_from_fifo_into_ssl (f, ctx, sp, deq_max);
+  if (openssl_ofl_is_active (oc))
+    wrote = openssl_ofl_write (ctx, f, ts, deq_max);
+  else
+    wrote = openssl_write_from_fifo_into_ssl (f, ctx, sp, deq_max);
 
   /* Unrecoverable protocol error. Reset connection */
   if (PREDICT_FALSE (wrote < 0))
@@ -569,7 +693,10 @@ openssl_ctx_read_tls (tls_ctx_t *ctx, session_t *tls_session)
   app_session = session_get_from_handle (ctx->app_session_handle);
   f = app_session->rx_fifo;
 
-  read = openssl_read_from_ssl_into_fifo (f, ctx, max_len);
+  if (openssl_ofl_is_active (oc))
+    read = openssl_ofl_read (ctx, tls_session, app_session, max_len);
+  else
+    read = openssl_read_from_ssl_into_fifo (f, ctx, max_len);
 
   /* Unrecoverable protocol error. Reset connection */
   if (PREDICT_FALSE (read < 0))
@@ -581,7 +708,13 @@ openssl_ctx_read_tls (tls_ctx_t *ctx, session_t *tls_session)
   if (read)
     tls_notify_app_enqueue (ctx, app_session);
 
-  if ((SSL_pending (oc->ssl) > 0) ||
+  if (openssl_ofl_is_active (oc))
+    {
+      /* Only reschedule if a complete record is waiting */
+      if (openssl_ofl_rx_has_record (tls_session))
+	tls_add_vpp_q_builtin_rx_evt (tls_session);
+    }
+  else if ((SSL_pending (oc->ssl) > 0) ||
       svm_fifo_max_dequeue_cons (tls_session->rx_fifo))
     tls_add_vpp_q_builtin_rx_evt (tls_session);
 
@@ -924,6 +1057,11 @@ openssl_start_listen (tls_ctx_t * lctx)
 	}
     }
 
+  /* Capture traffic secrets for record offload */
+  if (om->record_offload && !om->async &&
+      lctx->tls_type == TRANSPORT_PROTO_TLS)
+    openssl_ofl_ssl_ctx_init (ssl_ctx);
+
   /* Set TLS Record Split size */
   if (om->record_split_size)
     {
@@ -1060,6 +1198,9 @@ openssl_ctx_init_server (tls_ctx_t * ctx)
   SSL_set_bio (oc->ssl, oc->wbio, oc->rbio);
   SSL_set_accept_state (oc->ssl);
 
+  if (SSL_CTX_get_keylog_callback (olc->ssl_ctx))
+    openssl_ofl_ctx_init (oc);
+
   TLS_DBG (1, "Initiating handshake for [%u]%u", ctx->c_thread_index,
 	   oc->openssl_ctx_index);
 
@@ -1245,6 +1386,9 @@ tls_openssl_init (vlib_main_t * vm)
   vec_validate (om->ctx_pool, num_threads - 1);
   vec_validate (om->rx_bufs, num_threads - 1);
   vec_validate (om->tx_bufs, num_threads - 1);
+  vec_validate_aligned (om->ofl_wrk, num_threads - 1, CLIB_CACHE_LINE_BYTES);
+  vec_validate_aligned (om->hs_wrk, num_threads - 1, CLIB_CACHE_LINE_BYTES);
+  clib_rwlock_init (&om->crypto_keys_rw_lock);
   for (i = 0; i < num_threads; i++)
     {
       vec_validate (om->rx_bufs[i], DTLSO_MAX_DGRAM);
@@ -1373,6 +1517,16 @@ tls_openssl_set_tls_fn (vlib_main_t *vm, unformat_input_t *input,
 	{
 	  clib_warning ("Using TLS max-pipelines of %d", om->max_pipelines);
 	}
+      else if (unformat (input, "handshake-rate %u", &om->hs_rate))
+	{
+	  clib_warning ("Using per worker handshake rate of %u/s",
+			om->hs_rate);
+	}
+      else if (unformat (input, "record-offload"))
+	{
+	  om->record_offload = 1;
+	  clib_warning ("Using TLS 1.3 record offload, if possible");
+	}
       else
 	return clib_error_return (0, "failed: unknown input `%U'",
 				  format_unformat_error, input);
@@ -1384,10 +1538,37 @@ tls_openssl_set_tls_fn (vlib_main_t *vm, unformat_input_t *input,
 VLIB_CLI_COMMAND (tls_openssl_set_tls, static) = {
   .path = "tls openssl set-tls",
   .short_help = "tls openssl set-tls [record-size <size>] [record-split-size "
-		"<size>] [max-pipelines <size>]",
+		"<size>] [max-pipelines <size>] [record-offload] "
+		"[handshake-rate <per-sec>]",
   .function = tls_openssl_set_tls_fn,
 };
 
+static clib_error_t *
+tls_openssl_show_hs_throttle_fn (vlib_main_t *vm, unformat_input_t *input,
+				 vlib_cli_command_t *cmd)
+{
+  openssl_main_t *om = &openssl_main;
+  openssl_hs_wrk_t *hw;
+  u32 i;
+
+  vlib_cli_output (vm, "handshake rate: %u/s per worker", om->hs_rate);
+  vec_foreach_index (i, om->hs_wrk)
+    {
+      hw = &om->hs_wrk[i];
+      vlib_cli_output (vm, "[%u] pending %u deferred total %lu tokens %.2f",
+		       i, clib_fifo_elts (hw->pending_ctxs), hw->n_deferred,
+		       hw->tokens);
+    }
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (tls_openssl_show_hs_throttle, static) = {
+  .path = "show tls openssl handshake-throttle",
+  .short_help = "show tls openssl handshake-throttle",
+  .function = tls_openssl_show_hs_throttle_fn,
+};
+
 VLIB_PLUGIN_REGISTER () = {
     .version = VPP_BUILD_VER,
     .description = "Transport Layer Security (TLS) Engine, OpenSSL Based",
@@ -23,12 +23,74 @@
 #include <vnet/plugin/plugin.h>
 #include <vpp/app/version.h>
 #include <vnet/tls/tls.h>
+#include <vnet/crypto/crypto.h>
 
 #define TLSO_CTRL_BYTES 1000
 #define TLSO_MIN_ENQ_SPACE (1 << 16)
 
 #define DTLSO_MAX_DGRAM 2000
 
+/* Handshake admission, burst allowed as fraction of per second rate */
+#define TLSO_HS_BURST_INTERVAL 0.1
+
+/* TLS 1.3 record offload, max records processed per batch */
+#define TLSO_OFL_MAX_RECS	8
+#define TLSO_OFL_IV_LEN		12
+#define TLSO_OFL_TAG_LEN	16
+#define TLSO_OFL_SECRET_MAX_LEN 48
+
+#define foreach_openssl_ofl_flags                                             \
+  _ (RX_SECRET, "rx-secret")                                                  \
+  _ (TX_SECRET, "tx-secret")                                                  \
+  _ (ACTIVE, "active")                                                        \
+  _ (PEER_CLOSED, "peer-closed")
+
+typedef enum openssl_ofl_flags_bit_
+{
+#define _(sym, str) OPENSSL_OFL_F_BIT_##sym,
+  foreach_openssl_ofl_flags
+#undef _
+} openssl_ofl_flags_bit_t;
+
+typedef enum openssl_ofl_flags_
+{
+#define _(sym, str) OPENSSL_OFL_F_##sym = 1 << OPENSSL_OFL_F_BIT_##sym,
+  foreach_openssl_ofl_flags
+#undef _
+} __clib_packed openssl_ofl_flags_t;
+
+/** Traffic protection state for one direction */
+typedef struct openssl_ofl_dir_
+{
+  u8 secret[TLSO_OFL_SECRET_MAX_LEN];
+  u8 iv[TLSO_OFL_IV_LEN];
+  u32 key_index;
+  u64 seq;
+} openssl_ofl_dir_t;
+
+/** Record protection done with vnet crypto after handshake */
+typedef struct openssl_ofl_ctx_
+{
+  openssl_ofl_dir_t rx;
+  openssl_ofl_dir_t tx;
+  const EVP_MD *md;
+  vnet_crypto_alg_t alg;
+  vnet_crypto_op_id_t enc_op_id;
+  vnet_crypto_op_id_t dec_op_id;
+  u8 secret_len;
+  u8 key_len;
+  openssl_ofl_flags_t flags;
+} openssl_ofl_ctx_t;
+
+typedef struct openssl_ofl_per_thread_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  vnet_crypto_op_t ops[TLSO_OFL_MAX_RECS];
+  u8 ivs[TLSO_OFL_MAX_RECS][TLSO_OFL_IV_LEN];
+  u8 *rx_buf;
+  u8 *tx_buf;
+} openssl_ofl_per_thread_t;
+
 #define ossl_check_err_is_fatal(_ssl, _rv)                                    \
   if (PREDICT_FALSE (_rv < 0 && SSL_get_error (_ssl, _rv) == SSL_ERROR_SSL))  \
     return -1;
@@ -44,6 +106,9 @@ typedef struct tls_ctx_openssl_
   u32 total_async_write;
   BIO *rbio;
   BIO *wbio;
+  openssl_ofl_ctx_t *ofl;
+  u8 hs_admitted;
+  u8 hs_deferred;
 } openssl_ctx_t;
 
 typedef struct tls_listen_ctx_opensl_
@@ -55,6 +120,16 @@ typedef struct tls_listen_ctx_opensl_
   EVP_PKEY *pkey;
 } openssl_listen_ctx_t;
 
+/** Per worker rate limiter for server handshakes */
+typedef struct openssl_hs_wrk_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  f64 tokens;
+  f64 last_refill;
+  u32 *pending_ctxs; /**< fifo of deferred ctx indices */
+  u64 n_deferred;
+} openssl_hs_wrk_t;
+
 typedef struct openssl_main_
 {
   openssl_ctx_t ***ctx_pool;
@@ -73,6 +148,12 @@ typedef struct openssl_main_
   u32 record_size;
   u32 record_split_size;
   u32 max_pipelines;
+  u8 record_offload;
+  u32 hs_rate;
+  openssl_hs_wrk_t *hs_wrk;
+
+  openssl_ofl_per_thread_t *ofl_wrk;
+  clib_rwlock_t crypto_keys_rw_lock;
 } openssl_main_t;
 
 typedef int openssl_resume_handler (void *event, void *session);
@@ -96,6 +177,23 @@ int openssl_read_from_ssl_into_fifo (svm_fifo_t *f, tls_ctx_t *ctx,
 void openssl_handle_handshake_failure (tls_ctx_t *ctx);
 void openssl_confirm_app_close (tls_ctx_t *ctx);
 
+void openssl_ofl_ssl_ctx_init (SSL_CTX *ssl_ctx);
+void openssl_ofl_ctx_init (openssl_ctx_t *oc);
+int openssl_ofl_try_enable (openssl_ctx_t *oc);
+void openssl_ofl_ctx_free (openssl_ctx_t *oc);
+int openssl_ofl_read (tls_ctx_t *ctx, session_t *ts, session_t *as,
+		      u32 max_len);
+int openssl_ofl_rx_has_record (session_t *ts);
+int openssl_ofl_write (tls_ctx_t *ctx, svm_fifo_t *f, session_t *ts,
+		       u32 max_len);
+void openssl_ofl_send_close_notify (tls_ctx_t *ctx);
+
+static inline u8
+openssl_ofl_is_active (openssl_ctx_t *oc)
+{
+  return oc->ofl && (oc->ofl->flags & OPENSSL_OFL_F_ACTIVE);
+}
+
 int tls_async_write_event_handler (void *event, void *session);
 int tls_async_read_event_handler (void *event, void *session);
 int tls_async_handshake_event_handler (void *event, void *session);
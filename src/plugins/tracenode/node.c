@@ -57,8 +57,7 @@ tracenode_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
       if (is_pcap && vnet_is_packet_pcaped (pp, b[0], ~0))
 	{
-	  pcap_add_buffer (&pp->pcap_main, vm, from0[0],
-			   pp->max_bytes_per_pkt);
+	  vnet_pcap_add_buffer (pp, vm, from0[0]);
 	}
       else if (!is_pcap && !(b[0]->flags & VLIB_BUFFER_IS_TRACED) &&
 	       vlib_trace_buffer (vm, node, next[0], b[0],
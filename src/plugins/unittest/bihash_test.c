@@ -24,6 +24,7 @@
 #include <vppinfra/bihash_template.h>
 
 #include <vppinfra/bihash_template.c>
+#include <vppinfra/bihash_sharded_template.h>
 
 typedef struct
 {
@@ -37,6 +38,7 @@ typedef struct
   u64 linear;
   u64 resplit;
   u64 working_copy_lost;
+  u64 compact;
   u64 *splits;
 } bihash_stats_t;
 
@@ -54,6 +56,7 @@ typedef struct
   int careful_delete_tests;
   int verbose;
   int non_random_keys;
+  int deferred_free;
   u32 nthreads;
   uword *key_hash;
   u64 *keys;
@@ -113,6 +116,23 @@ inc_stats_callback (BVT (clib_bihash) * h, int stat_id, u64 count)
 }
 
 
+static void
+test_bihash_init (bihash_test_main_t *tm)
+{
+  BVT (clib_bihash_init2_args) _a, *a = &_a;
+
+  clib_memset (a, 0, sizeof (*a));
+  a->h = &tm->hash;
+  a->name = "test";
+  a->nbuckets = tm->nbuckets;
+  a->memory_size = tm->hash_memory_size;
+  a->deferred_free = tm->deferred_free;
+  a->instantiate_immediately = 1;
+
+  BV (clib_bihash_init2) (a);
+  BV (clib_bihash_set_stats_callback) (a->h, inc_stats_callback, &tm->stats);
+}
+
 static clib_error_t *
 test_bihash_vec64 (bihash_test_main_t * tm)
 {
@@ -175,6 +195,15 @@ test_bihash_thread_fn (void *arg)
 				     __ATOMIC_ACQUIRE);
 	  BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ );
 	}
+      /* other threads keep splitting buckets under us */
+      for (j = 0; j < tm->nitems; j++)
+	{
+	  kv.key = ((u64) my_thread_index << 32) | (u64) j;
+	  if (BV (clib_bihash_search) (h, &kv, &kv) < 0 ||
+	      kv.value != (((u64) my_thread_index << 32) | (u64) j))
+	    clib_warning ("thread %d search for key %lld failed",
+			  my_thread_index, kv.key);
+	}
       for (j = 0; j < tm->nitems; j++)
 	{
 	  kv.key = ((u64) my_thread_index << 32) | (u64) j;
@@ -201,8 +230,7 @@ test_bihash_threads (bihash_test_main_t * tm)
 
   h = &tm->hash;
 
-  BV (clib_bihash_init) (h, "test", tm->nbuckets, tm->hash_memory_size);
-  BV (clib_bihash_set_stats_callback) (h, inc_stats_callback, &tm->stats);
+  test_bihash_init (tm);
 
   tm->thread_barrier = 1;
 
@@ -227,6 +255,11 @@ test_bihash_threads (bihash_test_main_t * tm)
   while (tm->threads_running > 0)
     CLIB_PAUSE ();
 
+  /* all readers are gone, everything retired so far can be reclaimed */
+  if (tm->deferred_free)
+    BV (clib_bihash_reclaim_deferred) (
+      h, BV (clib_bihash_grace_period_start) (h));
+
   after = vlib_time_now (tm->vlib_main);
   delta = after - before;
 
@@ -241,6 +274,61 @@ test_bihash_threads (bihash_test_main_t * tm)
   return 0;
 }
 
+static clib_error_t *
+test_bihash_sharded (bihash_test_main_t *tm)
+{
+  BVT (clib_bihash_sharded) _sh, *sh = &_sh;
+  BVT (clib_bihash_kv) kv, value;
+  u32 n_shards = clib_max (tm->nthreads, 2);
+  u32 i, shard_index;
+  int rv;
+
+  clib_memset (sh, 0, sizeof (*sh));
+  BV (clib_bihash_sharded_init) (sh, "test", n_shards, tm->nbuckets,
+				 tm->hash_memory_size, 16);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      kv.value = i + 1;
+      BV (clib_bihash_sharded_add_del) (sh, i % n_shards, &kv, 1 /* add */);
+    }
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      rv = BV (clib_bihash_sharded_search) (sh, i % n_shards, &kv, &value);
+      if (rv < 0 || value.value != i + 1)
+	return clib_error_return (0, "owner search for key %d failed", i);
+
+      /* from every other shard */
+      if (BV (clib_bihash_sharded_search) (sh, (i + 1) % n_shards, &kv,
+					   &value) == 0)
+	return clib_error_return (0, "key %d found in the wrong shard", i);
+
+      if (BV (clib_bihash_sharded_search_any) (sh, (i + 1) % n_shards, &kv,
+					       &value, &shard_index) < 0 ||
+	  value.value != i + 1 || shard_index != i % n_shards)
+	return clib_error_return (0, "cross-shard search for key %d failed",
+				  i);
+    }
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      if (BV (clib_bihash_sharded_add_del) (sh, i % n_shards, &kv,
+					    0 /* is_add */))
+	return clib_error_return (0, "delete key %d failed", i);
+      if (BV (clib_bihash_sharded_search_any) (sh, 0, &kv, &value,
+					       &shard_index) == 0)
+	return clib_error_return (0, "deleted key %d still found", i);
+    }
+
+  fformat (stdout, "%U", BV (format_bihash_sharded), sh, 0 /* verbose */);
+  BV (clib_bihash_sharded_free) (sh);
+  return 0;
+}
+
 /*
  * Callback to blow up spectacularly if anything remains in the table
  */
@@ -265,8 +353,7 @@ test_bihash (bihash_test_main_t * tm)
 
   h = &tm->hash;
 
-  BV (clib_bihash_init) (h, "test", tm->nbuckets, tm->hash_memory_size);
-  BV (clib_bihash_set_stats_callback) (h, inc_stats_callback, &tm->stats);
+  test_bihash_init (tm);
 
   for (acycle = 0; acycle < tm->ncycles; acycle++)
     {
@@ -365,6 +452,50 @@ test_bihash (bihash_test_main_t * tm)
 	  fformat (stdout, "%lld searches in %.6f seconds\n", total_searches,
 		   delta);
 
+	  fformat (stdout, "Batch search for items %d times...\n",
+		   tm->search_iter);
+	}
+
+      before = clib_time_now (&tm->clib_time);
+
+      for (j = 0; j < tm->search_iter; j++)
+	{
+	  BVT (clib_bihash_kv) keys[BIHASH_SEARCH_BATCH_MAX_KEYS];
+	  BVT (clib_bihash_kv) values[BIHASH_SEARCH_BATCH_MAX_KEYS];
+	  u64 found[BIHASH_SEARCH_BATCH_MAX_KEYS / 64];
+	  u32 n_keys, n_found, k;
+
+	  for (i = 0; i < tm->nitems; i += n_keys)
+	    {
+	      n_keys = clib_min (tm->nitems - i, BIHASH_SEARCH_BATCH_MAX_KEYS);
+	      for (k = 0; k < n_keys; k++)
+		keys[k].key = tm->keys[i + k];
+
+	      n_found =
+		BV (clib_bihash_search_batch) (h, keys, values, found, n_keys);
+	      if (n_found != n_keys)
+		return clib_error_return (
+		  0, "batch search at %d found %d of %d keys\n", i, n_found,
+		  n_keys);
+
+	      for (k = 0; k < n_keys; k++)
+		if ((found[k / 64] & (1ULL << (k % 64))) == 0 ||
+		    values[k].value != (u64) (i + k + 1))
+		  return clib_error_return (
+		    0, "[%d] batch search for key %lld returned %lld\n",
+		    i + k, tm->keys[i + k], values[k].value);
+	    }
+	}
+
+      if ((acycle % tm->report_every_n) == 0)
+	{
+	  delta = clib_time_now (&tm->clib_time) - before;
+	  total_searches = (uword) tm->search_iter * (uword) tm->nitems;
+
+	  if (delta > 0)
+	    fformat (stdout, "%.f batch searches per second\n",
+		     ((f64) total_searches) / delta);
+
 	  fformat (stdout, "Standard E-hash search for items %d times...\n",
 		   tm->search_iter);
 	}
@@ -437,6 +568,11 @@ test_bihash (bihash_test_main_t * tm)
 	  fformat (stdout, "%U\n", BV (format_bihash), h, 0 /* verbose */ );
 	}
 
+      /* Single threaded, nobody can be looking at retired pages */
+      if (tm->deferred_free)
+	BV (clib_bihash_reclaim_deferred) (
+	  h, BV (clib_bihash_grace_period_start) (h));
+
       /* Clean up side-bet hash table and random key vector */
       hash_free (tm->key_hash);
       vec_reset_length (tm->keys);
@@ -478,6 +614,7 @@ test_bihash_command_fn (vlib_main_t * vm,
   tm->seed = 0x1badf00d;
   tm->search_iter = 1;
 
+  tm->deferred_free = 0;
   memset (&tm->stats, 0, sizeof (tm->stats));
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
@@ -489,6 +626,8 @@ test_bihash_command_fn (vlib_main_t * vm,
 	;
       else if (unformat (input, "non-random-keys"))
 	tm->non_random_keys = 1;
+      else if (unformat (input, "deferred-free"))
+	tm->deferred_free = 1;
       else if (unformat (input, "nitems %d", &tm->nitems))
 	;
       else if (unformat (input, "ncycles %d", &tm->ncycles))
@@ -508,6 +647,8 @@ test_bihash_command_fn (vlib_main_t * vm,
 	which = 1;
       else if (unformat (input, "threads %u", &tm->nthreads))
 	which = 2;
+      else if (unformat (input, "sharded"))
+	which = 3;
       else if (unformat (input, "verbose"))
 	tm->verbose = 1;
       else
@@ -534,6 +675,10 @@ test_bihash_command_fn (vlib_main_t * vm,
       error = test_bihash_threads (tm);
       break;
 
+    case 3:
+      error = test_bihash_sharded (tm);
+      break;
+
     default:
       return clib_error_return (0, "no such test?");
     }
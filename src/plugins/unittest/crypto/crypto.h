@@ -54,6 +54,14 @@ typedef struct
   u32 rounds;
   u32 buffer_size;
   u32 n_buffers;
+  u32 aad_len;
+  u32 n_keys;
+  u32 batch_size;
+  u8 imix;
+  u8 chained;
+  u8 all_engines;
+  u8 set_best;
+  u8 *engine;
 
   unittest_crypto_test_registration_t *test_registrations;
 } crypto_test_main_t;
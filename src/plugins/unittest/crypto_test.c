@@ -809,20 +809,73 @@ done:
   return err;
 }
 
+/* simple imix, 7:4:1 of 64, 570 and 1518 byte packets */
+static u32
+test_crypto_perf_imix_size (u32 i)
+{
+  i %= 12;
+  return i < 7 ? 64 : i < 11 ? 570 : 1518;
+}
+
+/*
+ * Run rounds passes over ops in batches of batch_size, either through the
+ * active handlers (engine_index ~0) or straight through the given engine's
+ * handler, and return the ticks taken.
+ */
+static u64
+test_crypto_perf_run (vlib_main_t *vm, u32 engine_index,
+		      vnet_crypto_op_t *ops, vnet_crypto_op_t **op_ptrs,
+		      vnet_crypto_op_chunk_t *chunks, u32 n_ops, u32 batch_size,
+		      u32 rounds)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  void *fn = 0;
+  u32 i, n, r;
+  u64 t0;
+
+  if (engine_index != ~0)
+    fn = cm->engines[engine_index]
+	   .ops[ops[0].op]
+	   .handlers[chunks ? VNET_CRYPTO_HANDLER_TYPE_CHAINED :
+			      VNET_CRYPTO_HANDLER_TYPE_SIMPLE];
+
+  t0 = clib_cpu_time_now ();
+  for (r = 0; r < rounds; r++)
+    for (i = 0; i < n_ops; i += n)
+      {
+	n = clib_min (batch_size, n_ops - i);
+	if (fn && chunks)
+	  ((vnet_crypto_chained_op_fn_t *) fn) (vm, op_ptrs + i, chunks, n);
+	else if (fn)
+	  ((vnet_crypto_simple_op_fn_t *) fn) (vm, op_ptrs + i, n);
+	else if (chunks)
+	  vnet_crypto_process_chained_ops (vm, ops + i, chunks, n);
+	else
+	  vnet_crypto_process_ops (vm, ops + i, n);
+      }
+  return clib_cpu_time_now () - t0;
+}
+
 static clib_error_t *
 test_crypto_perf (vlib_main_t * vm, crypto_test_main_t * tm)
 {
   vnet_crypto_main_t *cm = &crypto_main;
   clib_error_t *err = 0;
-  u32 n_buffers, n_alloc = 0, warmup_rounds, rounds;
-  u32 *buffer_indices = 0;
+  u32 n_buffers, n_alloc = 0, warmup_rounds, rounds, n_keys, batch_size;
+  u32 *buffer_indices = 0, *engines = 0, *ei;
   vnet_crypto_op_t *ops1 = 0, *ops2 = 0, *op1, *op2;
+  vnet_crypto_op_t **op1_ptrs = 0, **op2_ptrs = 0;
+  vnet_crypto_op_chunk_t *chunks = 0, *ch;
   vnet_crypto_alg_data_t *ad = cm->algs + tm->alg;
-  vnet_crypto_key_index_t key_index = ~0;
+  vnet_crypto_key_index_t *key_indices = 0, *ki;
+  vnet_crypto_handler_type_t ht;
   u8 key[64];
   int buffer_size = vlib_buffer_get_default_data_size (vm);
   u64 seed = clib_cpu_time_now ();
-  u64 t0[5], t1[5], t2[5], n_bytes = 0;
+  u64 t1[5], t2[5], n_bytes = 0;
+  f64 best_tpb = 0, clocks_per_second = vm->clib_time.clocks_per_second;
+  u32 best_engine = ~0;
+  u32 len;
   int i, j;
 
   if (tm->buffer_size > buffer_size)
@@ -832,52 +885,101 @@ test_crypto_perf (vlib_main_t * vm, crypto_test_main_t * tm)
   n_buffers = tm->n_buffers ? tm->n_buffers : 256;
   buffer_size = tm->buffer_size ? tm->buffer_size : 2048;
   warmup_rounds = tm->warmup_rounds ? tm->warmup_rounds : 100;
+  n_keys = tm->n_keys ? tm->n_keys : 1;
+  batch_size = tm->batch_size ? tm->batch_size : VLIB_FRAME_SIZE;
 
   if (buffer_size > vlib_buffer_get_default_data_size (vm))
     return clib_error_return (0, "buffer size too big");
 
+  if (tm->aad_len > VLIB_BUFFER_PRE_DATA_SIZE - 64)
+    return clib_error_return (0, "aad length must be <= %u",
+			      VLIB_BUFFER_PRE_DATA_SIZE - 64);
+
+  if (batch_size > VLIB_FRAME_SIZE)
+    return clib_error_return (0, "batch size must be <= %u", VLIB_FRAME_SIZE);
+
+  vnet_crypto_op_type_t ot = 0;
+
+  for (i = 0; i < VNET_CRYPTO_OP_N_TYPES; i++)
+    {
+      vnet_crypto_op_id_t id = ad->op_by_type[i];
+      if (id == 0)
+	continue;
+      ot = i;
+      break;
+    }
+
+  /* engines to compare, ~0 stands for the active handlers */
+  ht = tm->chained ? VNET_CRYPTO_HANDLER_TYPE_CHAINED :
+		     VNET_CRYPTO_HANDLER_TYPE_SIMPLE;
+  if (tm->all_engines)
+    {
+      vec_foreach_index (i, cm->engines)
+	if (cm->engines[i].ops[ad->op_by_type[ot]].handlers[ht])
+	  vec_add1 (engines, i);
+    }
+  else if (tm->engine)
+    {
+      uword *p = hash_get_mem (cm->engine_index_by_name, tm->engine);
+      if (!p)
+	return clib_error_return (0, "unknown engine '%s'", tm->engine);
+      if (!cm->engines[p[0]].ops[ad->op_by_type[ot]].handlers[ht])
+	return clib_error_return (0, "engine '%s' doesn't support %U%s",
+				  tm->engine, format_vnet_crypto_alg, tm->alg,
+				  tm->chained ? " chained" : "");
+      vec_add1 (engines, p[0]);
+    }
+  else
+    vec_add1 (engines, ~0);
+
+  if (vec_len (engines) == 0)
+    return clib_error_return (0, "no engine supports %U%s",
+			      format_vnet_crypto_alg, tm->alg,
+			      tm->chained ? " chained" : "");
+
   vec_validate_aligned (buffer_indices, n_buffers - 1, CLIB_CACHE_LINE_BYTES);
   vec_validate_aligned (ops1, n_buffers - 1, CLIB_CACHE_LINE_BYTES);
   vec_validate_aligned (ops2, n_buffers - 1, CLIB_CACHE_LINE_BYTES);
+  vec_validate (op1_ptrs, n_buffers - 1);
+  vec_validate (op2_ptrs, n_buffers - 1);
 
   n_alloc = vlib_buffer_alloc (vm, buffer_indices, n_buffers);
   if (n_alloc != n_buffers)
     {
       if (n_alloc)
 	vlib_buffer_free (vm, buffer_indices, n_alloc);
+      n_alloc = 0;
       err = clib_error_return (0, "buffer alloc failure");
       goto done;
     }
 
-  vlib_cli_output (vm, "%U: n_buffers %u buffer-size %u rounds %u "
+  vlib_cli_output (vm, "%U: n_buffers %u buffer-size %u%s rounds %u "
 		   "warmup-rounds %u",
 		   format_vnet_crypto_alg, tm->alg, n_buffers, buffer_size,
-		   rounds, warmup_rounds);
-  vlib_cli_output (vm, "   cpu-freq %.2f GHz",
-		   (f64) vm->clib_time.clocks_per_second * 1e-9);
-
-  vnet_crypto_op_type_t ot = 0;
+		   tm->imix ? " (imix)" : "", rounds, warmup_rounds);
+  vlib_cli_output (vm, "   keys %u batch-size %u%s", n_keys, batch_size,
+		   tm->chained ? " chained" : "");
+  vlib_cli_output (vm, "   cpu-freq %.2f GHz", clocks_per_second * 1e-9);
 
   for (i = 0; i < sizeof (key); i++)
     key[i] = i;
 
-  key_index = vnet_crypto_key_add (vm, tm->alg, key,
-				   test_crypto_get_key_sz (tm->alg));
-
-  for (i = 0; i < VNET_CRYPTO_OP_N_TYPES; i++)
+  for (i = 0; i < n_keys; i++)
     {
-      vnet_crypto_op_id_t id = ad->op_by_type[i];
-      if (id == 0)
-	continue;
-      ot = i;
-      break;
+      key[0] = i;
+      vec_add1 (key_indices,
+		vnet_crypto_key_add (vm, tm->alg, key,
+				     test_crypto_get_key_sz (tm->alg)));
     }
 
   for (i = 0; i < n_buffers; i++)
     {
       vlib_buffer_t *b = vlib_get_buffer (vm, buffer_indices[i]);
-      op1 = ops1 + i;
-      op2 = ops2 + i;
+      op1 = op1_ptrs[i] = ops1 + i;
+      op2 = op2_ptrs[i] = ops2 + i;
+      len = buffer_size;
+      if (tm->imix)
+	len = clib_min (test_crypto_perf_imix_size (i), buffer_size);
 
       switch (ot)
 	{
@@ -888,89 +990,148 @@ test_crypto_perf (vlib_main_t * vm, crypto_test_main_t * tm)
 	  vnet_crypto_op_init (op2,
 			       ad->op_by_type[VNET_CRYPTO_OP_TYPE_DECRYPT]);
 	  op1->src = op2->src = op1->dst = op2->dst = b->data;
-	  op1->key_index = op2->key_index = key_index;
+	  op1->key_index = op2->key_index = key_indices[i % n_keys];
 	  op1->iv = op2->iv = b->data - 64;
 
 	  if (ad->is_aead)
 	    {
 	      op1->tag = op2->tag = b->data - 32;
 	      op1->aad = op2->aad = b->data - VLIB_BUFFER_PRE_DATA_SIZE;
-	      op1->aad_len = op2->aad_len = 64;
+	      op1->aad_len = op2->aad_len = tm->aad_len;
 	      op1->tag_len = op2->tag_len = 16;
 	    }
 
-	  n_bytes += op1->len = op2->len = buffer_size;
+	  n_bytes += op1->len = op2->len = len;
 	  break;
 	case VNET_CRYPTO_OP_TYPE_HMAC:
 	  vnet_crypto_op_init (op1, ad->op_by_type[VNET_CRYPTO_OP_TYPE_HMAC]);
 	  op1->src = b->data;
-	  op1->key_index = key_index;
+	  op1->key_index = key_indices[i % n_keys];
 	  op1->iv = 0;
 	  op1->digest = b->data - VLIB_BUFFER_PRE_DATA_SIZE;
 	  op1->digest_len = 0;
-	  n_bytes += op1->len = buffer_size;
+	  n_bytes += op1->len = len;
 	  break;
 	default:
-	  return 0;
+	  goto done;
+	}
+
+      /* split the data in two chunks, as if spread over two buffers */
+      if (tm->chained)
+	{
+	  u32 len0 = len / 2;
+
+	  op1->flags |= VNET_CRYPTO_OP_FLAG_CHAINED_BUFFERS;
+	  op2->flags |= VNET_CRYPTO_OP_FLAG_CHAINED_BUFFERS;
+	  op1->chunk_index = op2->chunk_index = vec_len (chunks);
+	  op1->n_chunks = op2->n_chunks = 2;
+
+	  vec_add2 (chunks, ch, 2);
+	  ch[0].src = ch[0].dst = b->data;
+	  ch[0].len = len0;
+	  ch[1].src = ch[1].dst = b->data + len0;
+	  ch[1].len = len - len0;
 	}
 
       for (j = -VLIB_BUFFER_PRE_DATA_SIZE; j < buffer_size; j += 8)
 	*(u64 *) (b->data + j) = 1 + random_u64 (&seed);
     }
 
-  for (i = 0; i < 5; i++)
+  vec_foreach (ei, engines)
     {
-      for (j = 0; j < warmup_rounds; j++)
+      f64 engine_tpb = 0;
+
+      if (ei[0] != ~0)
+	vlib_cli_output (vm, "engine %s:", cm->engines[ei[0]].name);
+
+      for (i = 0; i < 5; i++)
 	{
-	  vnet_crypto_process_ops (vm, ops1, n_buffers);
+	  test_crypto_perf_run (vm, ei[0], ops1, op1_ptrs, chunks, n_buffers,
+				batch_size, warmup_rounds);
 	  if (ot != VNET_CRYPTO_OP_TYPE_HMAC)
-	    vnet_crypto_process_ops (vm, ops2, n_buffers);
+	    test_crypto_perf_run (vm, ei[0], ops2, op2_ptrs, chunks, n_buffers,
+				  batch_size, warmup_rounds);
+
+	  t1[i] = test_crypto_perf_run (vm, ei[0], ops1, op1_ptrs, chunks,
+					n_buffers, batch_size, rounds);
+	  if (ot != VNET_CRYPTO_OP_TYPE_HMAC)
+	    t2[i] = test_crypto_perf_run (vm, ei[0], ops2, op2_ptrs, chunks,
+					  n_buffers, batch_size, rounds);
 	}
 
-      t0[i] = clib_cpu_time_now ();
-      for (j = 0; j < rounds; j++)
-	vnet_crypto_process_ops (vm, ops1, n_buffers);
-      t1[i] = clib_cpu_time_now ();
+      for (i = 0; i < 5; i++)
+	{
+	  f64 tpb1 = (f64) t1[i] / (n_bytes * rounds);
+	  f64 gbps1 = clocks_per_second * 1e-9 * 8 / tpb1;
+	  f64 mops1 = clocks_per_second * 1e-6 * n_buffers * rounds / t1[i];
+	  f64 tpb2, gbps2, mops2;
 
-      if (ot != VNET_CRYPTO_OP_TYPE_HMAC)
+	  if (ot != VNET_CRYPTO_OP_TYPE_HMAC)
+	    {
+	      tpb2 = (f64) t2[i] / (n_bytes * rounds);
+	      gbps2 = clocks_per_second * 1e-9 * 8 / tpb2;
+	      mops2 = clocks_per_second * 1e-6 * n_buffers * rounds / t2[i];
+	      vlib_cli_output (vm,
+			       "%-2u: encrypt %.03f ticks/byte, %.02f Gbps, "
+			       "%.02f Mops; decrypt %.03f ticks/byte, "
+			       "%.02f Gbps, %.02f Mops",
+			       i + 1, tpb1, gbps1, mops1, tpb2, gbps2, mops2);
+	      tpb1 += tpb2;
+	    }
+	  else
+	    {
+	      vlib_cli_output (vm,
+			       "%-2u: hash %.03f ticks/byte, %.02f Gbps, "
+			       "%.02f Mops",
+			       i + 1, tpb1, gbps1, mops1);
+	    }
+
+	  if (engine_tpb == 0 || tpb1 < engine_tpb)
+	    engine_tpb = tpb1;
+	}
+
+      if (best_engine == ~0 || engine_tpb < best_tpb)
 	{
-	  for (j = 0; j < rounds; j++)
-	    vnet_crypto_process_ops (vm, ops2, n_buffers);
-	  t2[i] = clib_cpu_time_now ();
+	  best_tpb = engine_tpb;
+	  best_engine = ei[0];
 	}
     }
 
-  for (i = 0; i < 5; i++)
-    {
-      f64 tpb1 = (f64) (t1[i] - t0[i]) / (n_bytes * rounds);
-      f64 gbps1 = vm->clib_time.clocks_per_second * 1e-9 * 8 / tpb1;
-      f64 tpb2, gbps2;
+  if (vec_len (engines) > 1)
+    vlib_cli_output (vm, "best engine: %s", cm->engines[best_engine].name);
 
-      if (ot != VNET_CRYPTO_OP_TYPE_HMAC)
-	{
-	  tpb2 = (f64) (t2[i] - t1[i]) / (n_bytes * rounds);
-	  gbps2 = vm->clib_time.clocks_per_second * 1e-9 * 8 / tpb2;
-	  vlib_cli_output (vm, "%-2u: encrypt %.03f ticks/byte, %.02f Gbps; "
-			   "decrypt %.03f ticks/byte, %.02f Gbps",
-			   i + 1, tpb1, gbps1, tpb2, gbps2);
-	}
+  if (tm->set_best && best_engine != ~0)
+    {
+      vnet_crypto_set_handlers_args_t args = {
+	.handler_name = ad->name,
+	.engine = cm->engines[best_engine].name,
+	.set_simple = !tm->chained,
+	.set_chained = tm->chained,
+      };
+
+      if (vnet_crypto_set_handlers (&args))
+	err = clib_error_return (0, "failed to set %s handlers for %s",
+				 args.engine, args.handler_name);
       else
-	{
-	  vlib_cli_output (vm, "%-2u: hash %.03f ticks/byte, %.02f Gbps\n",
-			   i + 1, tpb1, gbps1);
-	}
+	vlib_cli_output (vm, "%s handlers set to engine %s", args.handler_name,
+			 args.engine);
     }
 
 done:
   if (n_alloc)
     vlib_buffer_free (vm, buffer_indices, n_alloc);
 
-  if (key_index != ~0)
-    vnet_crypto_key_del (vm, key_index);
+  vec_foreach (ki, key_indices)
+    vnet_crypto_key_del (vm, ki[0]);
 
+  vec_free (key_indices);
+  vec_free (engines);
+  vec_free (chunks);
   vec_free (buffer_indices);
   vec_free (ops1);
   vec_free (ops2);
+  vec_free (op1_ptrs);
+  vec_free (op2_ptrs);
   return err;
 }
 
@@ -986,6 +1147,7 @@ test_crypto_command_fn (vlib_main_t * vm,
   memset (tm, 0, sizeof (crypto_test_main_t));
   tm->test_registrations = tr;
   tm->alg = ~0;
+  tm->aad_len = 64;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -1004,13 +1166,37 @@ test_crypto_command_fn (vlib_main_t * vm,
 	;
       else if (unformat (input, "buffer-size %u", &tm->buffer_size))
 	;
+      else if (unformat (input, "aad-len %u", &tm->aad_len))
+	;
+      else if (unformat (input, "imix"))
+	tm->imix = 1;
+      else if (unformat (input, "keys %u", &tm->n_keys))
+	;
+      else if (unformat (input, "batch-size %u", &tm->batch_size))
+	;
+      else if (unformat (input, "chained"))
+	tm->chained = 1;
+      else if (unformat (input, "engine all"))
+	tm->all_engines = 1;
+      else if (unformat (input, "engine %s", &tm->engine))
+	;
+      else if (unformat (input, "set-best"))
+	tm->set_best = 1;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, input);
     }
 
   if (is_perf)
-    return test_crypto_perf (vm, tm);
+    {
+      clib_error_t *err;
+      vec_add1 (tm->engine, 0);
+      if (vec_len (tm->engine) == 1)
+	vec_free (tm->engine);
+      err = test_crypto_perf (vm, tm);
+      vec_free (tm->engine);
+      return err;
+    }
   else
     return test_crypto (vm, tm);
 }
@@ -1018,7 +1204,10 @@ test_crypto_command_fn (vlib_main_t * vm,
 VLIB_CLI_COMMAND (test_crypto_command, static) =
 {
   .path = "test crypto",
-  .short_help = "test crypto",
+  .short_help = "test crypto [verbose|detail] [perf <alg> [buffers <n>] "
+		"[rounds <n>] [warmup-rounds <n>] [buffer-size <n>] "
+		"[aad-len <n>] [imix] [keys <n>] [batch-size <n>] [chained] "
+		"[engine <name>|all] [set-best]]",
   .function = test_crypto_command_fn,
 };
 
@@ -241,7 +241,7 @@ fill_buffers (vlib_main_t *vm, u32 *buffer_indices,
 	  vnet_buffer2 (b)->gso_size = gso_size;
 	  vnet_buffer2 (b)->gso_l4_hdr_sz = l4_hdr_len;
 	}
-      b->total_length_not_including_first_buffer = len;
+      vlib_buffer_cold (b)->total_length_not_including_first_buffer = len;
       b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
     }
   return i;
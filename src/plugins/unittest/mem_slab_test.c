@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vppinfra/mem.h>
+#include <vlib/vlib.h>
+
+#define MS_TEST_I(_cond, _comment, _args...)                                  \
+  ({                                                                          \
+    int _evald = (_cond);                                                     \
+    if (!(_evald))                                                            \
+      {                                                                       \
+	fformat (stderr, "FAIL:%d: " _comment "\n", __LINE__, ##_args);       \
+      }                                                                       \
+    else                                                                      \
+      {                                                                       \
+	fformat (stderr, "PASS:%d: " _comment "\n", __LINE__, ##_args);       \
+      }                                                                       \
+    _evald;                                                                   \
+  })
+
+#define MS_TEST(_cond, _comment, _args...)                                    \
+  {                                                                           \
+    if (!MS_TEST_I (_cond, _comment, ##_args))                                \
+      {                                                                       \
+	return 1;                                                             \
+      }                                                                       \
+  }
+
+static int
+mem_slab_test_basic (vlib_main_t *vm, unformat_input_t *input)
+{
+  int verbose = 0, i, n_iter = 10000;
+  u32 sizes[] = { 1, 16, 17, 100, 1000, 4096, 5000 };
+  clib_mem_slab_handle_t ms;
+  u8 **objs = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  ms = clib_mem_slab_create (64 << 20, CLIB_MEM_PAGE_SZ_DEFAULT,
+			     "slab unittest");
+  MS_TEST (ms != 0, "create");
+
+  for (int round = 0; round < 2; round++)
+    {
+      for (i = 0; i < n_iter; i++)
+	{
+	  u32 sz = sizes[i % ARRAY_LEN (sizes)];
+	  u8 *p = clib_mem_slab_alloc (ms, sz);
+
+	  MS_TEST (p != 0, "alloc %u bytes", sz);
+	  MS_TEST (((uword) p & 15) == 0, "alignment");
+	  clib_memset (p, i & 0xff, sz);
+	  vec_add1 (objs, p);
+	}
+
+      for (i = 0; i < n_iter; i++)
+	{
+	  u32 sz = sizes[i % ARRAY_LEN (sizes)];
+	  for (u32 j = 0; j < sz; j++)
+	    if (objs[i][j] != (i & 0xff))
+	      MS_TEST (0, "data corrupted");
+	}
+
+      /* free every other object first, then the rest */
+      for (i = 0; i < n_iter; i += 2)
+	clib_mem_slab_free (ms, objs[i]);
+      for (i = 1; i < n_iter; i += 2)
+	clib_mem_slab_free (ms, objs[i]);
+
+      vec_reset_length (objs);
+    }
+
+  if (verbose)
+    vlib_cli_output (vm, "%U", format_clib_mem_slab, ms, 1);
+
+  clib_mem_slab_destroy (ms);
+  vec_free (objs);
+
+  return 0;
+}
+
+static clib_error_t *
+mem_slab_test (vlib_main_t *vm, unformat_input_t *input,
+	       vlib_cli_command_t *cmd_arg)
+{
+  int res = 0;
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "basic"))
+	{
+	  res = mem_slab_test_basic (vm, input);
+	}
+      else if (unformat (input, "all"))
+	{
+	  if ((res = mem_slab_test_basic (vm, input)))
+	    goto done;
+	}
+      else
+	break;
+    }
+
+done:
+  if (res)
+    return clib_error_return (0, "mem slab unit test failed");
+  return 0;
+}
+
+VLIB_CLI_COMMAND (mem_slab_test_command, static) = {
+  .path = "test memslab",
+  .short_help = "internal memslab unit tests",
+  .function = mem_slab_test,
+};
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vnet/udp/udp_packet.h>
+
+/*
+ * Node function microbenchmark.
+ *
+ * The node function of each march variant is called directly, on the
+ * main thread, with a frame of buffers built from a packet template.
+ * Whatever the node enqueues to its next nodes is freed without being
+ * dispatched, so nothing but the node itself is measured. Buffers are
+ * rebuilt before every call, and with "cold" their headers and data are
+ * flushed from the cache first. The node's own state (tables, runtime
+ * data) stays warm either way.
+ *
+ * Nodes which hand packets off to other threads, or which keep buffers
+ * across calls, are not good candidates.
+ */
+
+typedef struct
+{
+  u32 node_index;
+  u32 *sizes;
+  u32 n_iterations;
+  u32 sw_if_index;
+  u8 *packet;
+  i16 current_data;
+  u8 cold;
+  clib_march_variant_type_t *variants;
+} node_bench_args_t;
+
+typedef struct
+{
+  u64 min;
+  u64 total;
+} node_bench_result_t;
+
+static_always_inline void
+node_bench_flush (void *p, uword n_bytes)
+{
+  for (uword o = 0; o < n_bytes; o += CLIB_CACHE_LINE_BYTES)
+    {
+#if defined(__x86_64__)
+      __builtin_ia32_clflush (p + o);
+#elif defined(__aarch64__)
+      asm volatile("dc civac, %0" : : "r"(p + o) : "memory");
+#endif
+    }
+}
+
+static u8 *
+node_bench_packet (int is_ip6, u16 n_bytes)
+{
+  u8 *packet = 0;
+  ethernet_header_t *e;
+  udp_header_t *udp;
+  u16 l3_len;
+
+  vec_validate (packet, n_bytes - 1);
+  e = (ethernet_header_t *) packet;
+  e->dst_address[0] = 0x02;
+  e->dst_address[5] = 0x01;
+  e->src_address[0] = 0x02;
+  e->src_address[5] = 0x02;
+  l3_len = n_bytes - sizeof (*e);
+
+  if (is_ip6)
+    {
+      ip6_header_t *ip6 = (ip6_header_t *) (e + 1);
+
+      e->type = clib_host_to_net_u16 (ETHERNET_TYPE_IP6);
+      ip6->ip_version_traffic_class_and_flow_label =
+	clib_host_to_net_u32 (0x6 << 28);
+      ip6->payload_length = clib_host_to_net_u16 (l3_len - sizeof (*ip6));
+      ip6->protocol = IP_PROTOCOL_UDP;
+      ip6->hop_limit = 64;
+      ip6->src_address.as_u16[0] = clib_host_to_net_u16 (0x2001);
+      ip6->src_address.as_u8[15] = 1;
+      ip6->dst_address.as_u16[0] = clib_host_to_net_u16 (0x2001);
+      ip6->dst_address.as_u8[15] = 2;
+      udp = (udp_header_t *) (ip6 + 1);
+      udp->length = ip6->payload_length;
+    }
+  else
+    {
+      ip4_header_t *ip4 = (ip4_header_t *) (e + 1);
+
+      e->type = clib_host_to_net_u16 (ETHERNET_TYPE_IP4);
+      ip4->ip_version_and_header_length = 0x45;
+      ip4->length = clib_host_to_net_u16 (l3_len);
+      ip4->ttl = 64;
+      ip4->protocol = IP_PROTOCOL_UDP;
+      ip4->src_address.as_u32 = clib_host_to_net_u32 (0x0a000001);
+      ip4->dst_address.as_u32 = clib_host_to_net_u32 (0x0a000002);
+      ip4->checksum = ip4_header_checksum (ip4);
+      udp = (udp_header_t *) (ip4 + 1);
+      udp->length = clib_host_to_net_u16 (l3_len - sizeof (*ip4));
+    }
+
+  udp->src_port = clib_host_to_net_u16 (1234);
+  udp->dst_port = clib_host_to_net_u16 (5678);
+  return packet;
+}
+
+static void
+node_bench_fill (vlib_main_t *vm, node_bench_args_t *a, u32 *buffers,
+		 u32 n_buffers)
+{
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
+
+  vlib_get_buffers (vm, buffers, bufs, n_buffers);
+
+  for (u32 i = 0; i < n_buffers; i++, b++)
+    {
+      b[0]->current_data = 0;
+      b[0]->current_length = vec_len (a->packet);
+      clib_memcpy_fast (b[0]->data, a->packet, vec_len (a->packet));
+      vnet_buffer (b[0])->l2_hdr_offset = 0;
+      vnet_buffer (b[0])->l3_hdr_offset = sizeof (ethernet_header_t);
+      vlib_buffer_advance (b[0], a->current_data);
+      vnet_buffer (b[0])->sw_if_index[VLIB_RX] = a->sw_if_index;
+      vnet_buffer (b[0])->sw_if_index[VLIB_TX] = ~0;
+
+      if (a->cold)
+	{
+	  node_bench_flush (b[0]->data, vec_len (a->packet));
+	  node_bench_flush (b[0], sizeof (vlib_buffer_t));
+	}
+    }
+}
+
+static clib_error_t *
+node_bench_run (vlib_main_t *vm, node_bench_args_t *a,
+		vlib_node_function_t *fn, u32 n_buffers,
+		node_bench_result_t *res)
+{
+  vlib_node_runtime_t *rt = vlib_node_get_runtime (vm, a->node_index);
+  u32 buffers[VLIB_FRAME_SIZE];
+
+  res->min = ~0ULL;
+  res->total = 0;
+
+  for (u32 i = 0; i < a->n_iterations; i++)
+    {
+      u32 first = vec_len (vm->node_main.pending_frames);
+      vlib_frame_t *f;
+      u64 t;
+
+      if (vlib_buffer_alloc (vm, buffers, n_buffers) != n_buffers)
+	return clib_error_return (0, "buffer allocation failure");
+
+      node_bench_fill (vm, a, buffers, n_buffers);
+
+      f = vlib_get_frame_to_node (vm, a->node_index);
+      clib_memcpy_fast (vlib_frame_vector_args (f), buffers,
+			n_buffers * sizeof (u32));
+      f->n_vectors = n_buffers;
+      if (a->cold)
+	node_bench_flush (vlib_frame_vector_args (f),
+			  n_buffers * sizeof (u32));
+
+      t = clib_cpu_time_now ();
+      fn (vm, rt, f);
+      t = clib_cpu_time_now () - t;
+
+      vlib_frame_free (vm, f);
+      vlib_discard_pending_frames (vm, first);
+
+      res->min = clib_min (res->min, t);
+      res->total += t;
+    }
+
+  return 0;
+}
+
+static clib_error_t *
+test_node_bench_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  node_bench_args_t _a = {}, *a = &_a;
+  clib_error_t *err = 0;
+  vlib_node_fn_registration_t *fnr;
+  vlib_node_t *n;
+  u32 size, length = 64;
+  int is_ip6 = 0, l3 = 0;
+  clib_march_variant_type_t variant;
+  u8 *variant_name = 0;
+
+  a->node_index = ~0;
+  a->n_iterations = 1000;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "size %u", &size))
+	{
+	  if (size == 0 || size > VLIB_FRAME_SIZE)
+	    {
+	      err = clib_error_return (0, "size must be between 1 and %u",
+				       VLIB_FRAME_SIZE);
+	      goto done;
+	    }
+	  vec_add1 (a->sizes, size);
+	}
+      else if (unformat (input, "iterations %u", &a->n_iterations))
+	;
+      else if (unformat (input, "length %u", &length))
+	;
+      else if (unformat (input, "sw-if-index %u", &a->sw_if_index))
+	;
+      else if (unformat (input, "variant %U", unformat_vlib_node_variant,
+			 &variant))
+	vec_add1 (a->variants, variant);
+      else if (unformat (input, "cold"))
+	a->cold = 1;
+      else if (unformat (input, "warm"))
+	a->cold = 0;
+      else if (unformat (input, "ip6"))
+	is_ip6 = 1;
+      else if (unformat (input, "ip4"))
+	is_ip6 = 0;
+      else if (unformat (input, "l3"))
+	l3 = 1;
+      else if (unformat (input, "%U", unformat_vlib_node, vm, &a->node_index))
+	;
+      else
+	{
+	  err = clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, input);
+	  goto done;
+	}
+    }
+
+  if (a->node_index == ~0)
+    {
+      err = clib_error_return (0, "please specify a node");
+      goto done;
+    }
+
+  n = vlib_get_node (vm, a->node_index);
+  if (n->type != VLIB_NODE_TYPE_INTERNAL)
+    {
+      err = clib_error_return (0, "'%v' is not an internal node", n->name);
+      goto done;
+    }
+
+  if (a->n_iterations == 0)
+    a->n_iterations = 1;
+
+  length = clib_max (length, sizeof (ethernet_header_t) +
+			       (is_ip6 ? sizeof (ip6_header_t) :
+					 sizeof (ip4_header_t)) +
+			       sizeof (udp_header_t));
+  if (length > vlib_buffer_get_default_data_size (vm))
+    {
+      err = clib_error_return (0, "length must not exceed %u",
+			       vlib_buffer_get_default_data_size (vm));
+      goto done;
+    }
+
+  a->packet = node_bench_packet (is_ip6, length);
+  a->current_data = l3 ? sizeof (ethernet_header_t) : 0;
+
+  if (a->sizes == 0)
+    {
+      u32 default_sizes[] = { 1, 4, 32, 64, 128, VLIB_FRAME_SIZE };
+      vec_add (a->sizes, default_sizes, ARRAY_LEN (default_sizes));
+    }
+
+  vlib_cli_output (vm, "%v: %u iterations, %u byte %s packets at %s, %s",
+		   n->name, a->n_iterations, length, is_ip6 ? "ip6" : "ip4",
+		   l3 ? "l3" : "l2", a->cold ? "cold" : "warm");
+  vlib_cli_output (vm, "%-16s%=8s%=16s%=16s", "Variant", "Size",
+		   "Min clk/pkt", "Avg clk/pkt");
+
+  /* nodes without VLIB_NODE_FN registrations have a single function */
+  fnr = n->node_fn_registrations;
+  do
+    {
+      vlib_node_function_t *fn = fnr ? fnr->function : n->function;
+
+      vec_reset_length (variant_name);
+      if (fnr)
+	{
+	  vlib_node_fn_variant_t *v =
+	    vec_elt_at_index (nm->variants, fnr->march_variant);
+
+	  if (a->variants && vec_search (a->variants, fnr->march_variant) == ~0)
+	    goto next;
+	  variant_name = format (variant_name, "%s", v->suffix);
+	}
+      else
+	variant_name = format (variant_name, "default");
+
+      vec_foreach_index (size, a->sizes)
+	{
+	  node_bench_result_t res;
+	  u32 n_buffers = a->sizes[size];
+
+	  if ((err = node_bench_run (vm, a, fn, n_buffers, &res)))
+	    goto done;
+
+	  vlib_cli_output (vm, "%-16v%=8u%=16.2f%=16.2f", variant_name,
+			   n_buffers, (f64) res.min / n_buffers,
+			   (f64) res.total / a->n_iterations / n_buffers);
+	}
+
+    next:
+      fnr = fnr ? fnr->next_registration : 0;
+    }
+  while (fnr);
+
+done:
+  vec_free (a->sizes);
+  vec_free (a->variants);
+  vec_free (a->packet);
+  vec_free (variant_name);
+  return err;
+}
+
+/*?
+ * Call the node function of each march variant of a node on a frame of
+ * synthetic packets, and report the clocks spent per packet for each
+ * vector size. Packets are ethernet + ip4 or ip6 + udp, presented at the
+ * ethernet header, or at the ip header with "l3". Packets sent to next
+ * nodes are freed, not dispatched.
+ *
+ * @cliexpar
+ * @cliexcmd{test node-bench ip4-lookup l3 size 256 cold}
+ * @cliexcmd{test node-bench ethernet-input variant avx512}
+?*/
+VLIB_CLI_COMMAND (test_node_bench_command, static) = {
+  .path = "test node-bench",
+  .short_help = "test node-bench <node> [size <n>]... [iterations <n>] "
+		"[variant <name>]... [cold|warm] [ip4|ip6] [l3] [length <n>] "
+		"[sw-if-index <n>]",
+  .function = test_node_bench_command_fn,
+};
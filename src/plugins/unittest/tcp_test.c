@@ -115,6 +115,9 @@ tcp_test_sack_rx (vlib_main_t * vm, unformat_input_t * input)
 
   TCP_TEST ((pool_elts (sb->holes) == 5),
 	    "scoreboard has %d elements", pool_elts (sb->holes));
+  TCP_TEST ((rb_tree_n_nodes (&sb->hole_lookup) == 5 + 1),
+	    "hole lookup has %d nodes", rb_tree_n_nodes (&sb->hole_lookup));
+  TCP_TEST ((sb->hole_bytes == 600), "hole bytes %u", sb->hole_bytes);
 
   /* First SACK block should be rejected */
   hole = scoreboard_first_hole (sb);
@@ -274,6 +277,9 @@ tcp_test_sack_rx (vlib_main_t * vm, unformat_input_t * input)
   TCP_TEST ((sb->rxt_sacked == 0), "last rxt sacked bytes %d",
 	    sb->rxt_sacked);
   TCP_TEST (pool_elts (sb->holes) == 0, "no holes left");
+  TCP_TEST ((rb_tree_n_nodes (&sb->hole_lookup) == 1),
+	    "hole lookup has %d nodes", rb_tree_n_nodes (&sb->hole_lookup));
+  TCP_TEST ((sb->hole_bytes == 0), "hole bytes %u", sb->hole_bytes);
 
   /*
    * Ack up to 970 no sack blocks
@@ -657,6 +663,7 @@ tcp_test_sack_rx (vlib_main_t * vm, unformat_input_t * input)
    * Clear
    */
   scoreboard_clear (sb);
+  scoreboard_free (sb);
   vec_reset_length (tc->rcv_opts.sacks);
 
   return 0;
@@ -899,6 +906,31 @@ tcp_test_lookup (vlib_main_t * vm, unformat_input_t * input)
   TCP_TEST ((tconn->lcl_port == tc1->lcl_port),
 	    "rmt port is identical %d", tconn->lcl_port == tc1->lcl_port);
 
+  /*
+   * Batched lookup should find the connection, first in the session table
+   * and then in the connection cache
+   */
+  session_lookup_key4_t keys[2] = {
+    { .lcl = tc1->lcl_ip.ip4,
+      .rmt = tc1->rmt_ip.ip4,
+      .lcl_port = tc1->lcl_port,
+      .rmt_port = tc1->rmt_port },
+    { .lcl = tc2->lcl_ip.ip4,
+      .rmt = tc2->rmt_ip.ip4,
+      .lcl_port = tc2->lcl_port,
+      .rmt_port = tc2->rmt_port },
+  };
+  transport_connection_t *tcs[2];
+  u8 results[2];
+
+  for (int i = 0; i < 2; i++)
+    {
+      session_lookup_connection_wt4_batch (keys, tc1->proto, 0, tcs, results,
+					   2);
+      TCP_TEST ((tcs[0] == tconn), "batched lookup %d finds connection", i);
+      TCP_TEST ((tcs[1] == 0), "batched lookup %d result should be null", i);
+    }
+
   /*
    * Non-existing connection lookup should not work
    */
@@ -918,6 +950,8 @@ tcp_test_lookup (vlib_main_t * vm, unformat_input_t * input)
 					 tc1->lcl_port, tc1->rmt_port,
 					 tc1->proto, 0, &is_filtered);
   TCP_TEST ((tconn == 0), "lookup result should be null");
+  session_lookup_connection_wt4_batch (keys, tc1->proto, 0, tcs, results, 1);
+  TCP_TEST ((tcs[0] == 0), "batched lookup result should be null");
   tconn = session_lookup_connection_wt4 (0, &tc2->lcl_ip.ip4,
 					 &tc2->rmt_ip.ip4,
 					 tc2->lcl_port, tc2->rmt_port,
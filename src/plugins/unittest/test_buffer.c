@@ -316,6 +316,148 @@ VLIB_CLI_COMMAND (test_linearize_speed_command, static) = {
   .function = test_linearize_speed_fn,
 };
 
+static int
+magazine_test (vlib_main_t *vm)
+{
+  u8 pool_index = vlib_buffer_pool_get_default_for_numa (vm, vm->numa_node);
+  vlib_buffer_pool_t *bp = vlib_get_buffer_pool (vm, pool_index);
+  vlib_buffer_pool_thread_t *bpt = bp->threads + vm->thread_index;
+  u32 n_buffers = 4 * VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ, i, n;
+  u32 n_avail, n_swaps;
+  u32 *bi = 0;
+  uword *seen = 0;
+  int ret = 0;
+
+  vec_validate (bi, n_buffers - 1);
+  n_avail = bp->n_avail + bp->n_full_magazines * VLIB_BUFFER_MAGAZINE_SZ +
+	    bpt->n_cached;
+
+  /* small allocs drain the cache, small frees spill full magazines */
+  for (i = 0; i < n_buffers; i += n)
+    {
+      n = vlib_buffer_alloc_from_pool (vm, bi + i, 64, pool_index);
+      TEST (n == 64, "alloc 64 buffers at %u", i);
+    }
+  for (i = 0; i < n_buffers; i += 64)
+    vlib_buffer_free (vm, bi + i, 64);
+
+  TEST (bp->n_full_magazines > 0, "%u full magazines after free",
+	bp->n_full_magazines);
+
+  /* and the next allocs take them back */
+  n_swaps = bpt->n_magazine_swaps;
+  for (i = 0; i < n_buffers; i += n)
+    {
+      n = vlib_buffer_alloc_from_pool (vm, bi + i, 64, pool_index);
+      TEST (n == 64, "realloc 64 buffers at %u", i);
+    }
+  TEST (bpt->n_magazine_swaps > n_swaps, "%lu magazine swaps on realloc",
+	bpt->n_magazine_swaps - n_swaps);
+
+  for (i = 0; i < n_buffers; i++)
+    {
+      TEST (clib_bitmap_get (seen, bi[i]) == 0, "buffer %u handed out once",
+	    bi[i]);
+      seen = clib_bitmap_set (seen, bi[i], 1);
+    }
+  vlib_buffer_free (vm, bi, n_buffers);
+
+  TEST (bp->n_avail + bp->n_full_magazines * VLIB_BUFFER_MAGAZINE_SZ +
+	    bpt->n_cached ==
+	  n_avail,
+	"all buffers returned");
+
+  ret = 1;
+err:
+  vec_free (bi);
+  clib_bitmap_free (seen);
+  return ret;
+}
+
+static clib_error_t *
+test_magazine_fn (vlib_main_t *vm, unformat_input_t *input,
+		  vlib_cli_command_t *cmd)
+{
+  if (!magazine_test (vm))
+    return clib_error_return (0, "buffer magazine test failed");
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (test_magazine_command, static) = {
+  .path = "test buffer-magazines",
+  .short_help = "test buffer-magazines",
+  .function = test_magazine_fn,
+};
+
+static int
+chain_builder_test (vlib_main_t *vm)
+{
+  u32 data_size = vlib_buffer_get_default_data_size (vm);
+  vlib_buffer_chain_builder_t cb;
+  vlib_buffer_t *b[3], *head;
+  u32 bi[3], len, n_segs;
+  u8 *p;
+  int ret = 0;
+
+  TEST (vlib_buffer_alloc (vm, bi, 3) == 3, "alloc 3 buffers");
+  vlib_get_buffers (vm, bi, b, 3);
+  head = b[0];
+
+  head->current_length = 10;
+  vlib_buffer_chain_builder_init (&cb, head);
+  p = vlib_buffer_chain_builder_push_header (&cb, 14);
+  TEST (p == vlib_buffer_get_current (head) && head->current_length == 24,
+	"header pushed");
+
+  p = vlib_buffer_chain_builder_add_segment (vm, &cb, bi[1]);
+  clib_memset (p, 0xa5, 100);
+  vlib_buffer_chain_builder_increase_length (&cb, 100);
+  TEST (vlib_buffer_chain_builder_put (vm, &cb, 16) == p + 100,
+	"trailer in last segment");
+  TEST (vlib_buffer_chain_builder_put (vm, &cb, data_size - 10) != 0,
+	"trailer in new segment");
+  len = 24 + 100 + 16 + data_size - 10;
+  TEST (vlib_buffer_chain_builder_length (&cb) == len, "length %u",
+	vlib_buffer_chain_builder_length (&cb));
+
+  b[2]->current_length = 50;
+  vlib_buffer_chain_builder_append_shared (vm, &cb, bi[2]);
+  len += 50;
+  TEST (b[2]->ref_count == 2 && cb.last == b[2], "shared tail appended");
+  TEST (vlib_buffer_length_in_chain (vm, head) == len, "chain length %u",
+	vlib_buffer_length_in_chain (vm, head));
+
+  for (n_segs = 1; head->flags & VLIB_BUFFER_NEXT_PRESENT; n_segs++)
+    head = vlib_get_buffer (vm, head->next_buffer);
+  TEST (n_segs == 4, "%u segments", n_segs);
+
+  /* freeing the chain drops the reference it holds on the shared tail */
+  vlib_buffer_free_one (vm, bi[0]);
+  TEST (b[2]->ref_count == 1, "shared tail still referenced");
+  vlib_buffer_free_one (vm, bi[2]);
+
+  ret = 1;
+err:
+  return ret;
+}
+
+static clib_error_t *
+test_chain_builder_fn (vlib_main_t *vm, unformat_input_t *input,
+		       vlib_cli_command_t *cmd)
+{
+  if (!chain_builder_test (vm))
+    return clib_error_return (0, "buffer chain builder test failed");
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (test_chain_builder_command, static) = {
+  .path = "test chained-buffer-builder",
+  .short_help = "test chained-buffer-builder",
+  .function = test_chain_builder_fn,
+};
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
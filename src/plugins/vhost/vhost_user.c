@@ -1403,6 +1403,12 @@ vhost_user_term_if (vhost_user_intf_t * vui)
   for (q = 0; q < vec_len (vui->vrings); q++)
     clib_spinlock_free (&vui->vrings[q].vring_lock);
 
+  if (vui->dma_tx_config >= 0)
+    {
+      vlib_dma_config_del (vlib_get_main (), vui->dma_tx_config);
+      vui->dma_tx_config = -1;
+    }
+
   if (vui->unix_server_index != ~0)
     {
       //Close server socket
@@ -1611,6 +1617,22 @@ vhost_user_vui_init (vnet_main_t * vnm, vhost_user_intf_t * vui,
   vui->enable_gso = args->enable_gso;
   vui->enable_event_idx = args->enable_event_idx;
   vui->enable_packed = args->enable_packed;
+  vui->use_dma = args->use_dma;
+  vui->dma_tx_config = -1;
+  if (vui->use_dma)
+    {
+      vlib_dma_config_t dma_args = {
+	.max_batches = 256,
+	.max_transfers = VHOST_USER_DMA_MAX_TRANSFERS,
+	.max_transfer_size = 65535,
+	.barrier_before_last = 1,
+	.sw_fallback = 1,
+	.callback_fn = vhost_user_tx_dma_completion_cb,
+      };
+      vui->dma_tx_config = vlib_dma_config_add (vlib_get_main (), &dma_args);
+      if (vui->dma_tx_config < 0)
+	vu_log_warn (vui, "dma config failed, guest copies stay on cpu");
+    }
   /*
    * enable_gso takes precedence over configurable feature mask if there
    * is a clash.
@@ -1784,6 +1806,8 @@ vhost_user_connect_command_fn (vlib_main_t * vm,
 	args.enable_packed = 1;
       else if (unformat (line_input, "event-idx"))
 	args.enable_event_idx = 1;
+      else if (unformat (line_input, "use-dma"))
+	args.use_dma = 1;
       else if (unformat (line_input, "feature-mask 0x%llx",
 			 &args.feature_mask))
 	;
@@ -2198,6 +2222,8 @@ show_vhost_user_command_fn (vlib_main_t * vm,
 	vlib_cli_output (vm, "  Packed ring enable");
       if (vui->enable_event_idx)
 	vlib_cli_output (vm, "  Event index enable");
+      if (vui->dma_tx_config >= 0)
+	vlib_cli_output (vm, "  DMA enable (tx config %d)", vui->dma_tx_config);
 
       vlib_cli_output (vm, "virtio_net_hdr_sz %d\n"
 		       " features mask (0x%llx): \n"
@@ -2380,7 +2406,7 @@ VLIB_CLI_COMMAND (vhost_user_connect_command, static) = {
     .path = "create vhost-user",
     .short_help = "create vhost-user socket <socket-filename> [server] "
     "[feature-mask <hex>] [hwaddr <mac-addr>] [renumber <dev_instance>] [gso] "
-    "[packed] [event-idx]",
+    "[packed] [event-idx] [use-dma]",
     .function = vhost_user_connect_command_fn,
     .is_mp_safe = 1,
 };
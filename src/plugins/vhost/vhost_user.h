@@ -17,6 +17,7 @@
 
 #include <vhost/virtio_std.h>
 #include <vhost/vhost_std.h>
+#include <vlib/dma/dma.h>
 
 /* vhost-user data structures */
 
@@ -112,6 +113,7 @@ typedef struct
   u8 enable_packed;
   u8 enable_event_idx;
   u8 use_custom_mac;
+  u8 use_dma;
 
   /* return */
   u32 sw_if_index;
@@ -208,6 +210,10 @@ typedef struct
   u8 log_used;
   clib_spinlock_t vring_lock;
 
+  /* dma batches submitted and used idx to publish once they complete */
+  u16 n_dma_pending;
+  u16 dma_used_idx;
+
   //Put non-runtime in a different cache line
     CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
   int errfd;
@@ -285,6 +291,10 @@ typedef struct
   u8 enable_packed;
 
   u8 enable_event_idx;
+
+  /* Offload large guest copies to dma, -1 if disabled */
+  u8 use_dma;
+  int dma_tx_config;
 } vhost_user_intf_t;
 
 #define FOR_ALL_VHOST_TXQ(qid, vui) for (qid = 1; qid < vui->num_qid; qid += 2)
@@ -312,6 +322,19 @@ typedef struct
 #define VHOST_USER_RX_BUFFERS_N (2 * VLIB_FRAME_SIZE + 2)
 #define VHOST_USER_COPY_ARRAY_N (4 * VLIB_FRAME_SIZE)
 
+/* Copies shorter than this are cheaper to do on the cpu */
+#define VHOST_USER_DMA_MIN_COPY_LEN  1024
+#define VHOST_USER_DMA_MAX_TRANSFERS VHOST_USER_COPY_ARRAY_N
+
+/* State kept between dma batch submit and its completion callback */
+typedef struct
+{
+  u32 *buffers;
+  u32 dev_instance;
+  u16 qid;
+  u16 used_idx;
+} vhost_user_dma_info_t;
+
 typedef struct
 {
   u32 rx_buffers_len;
@@ -327,6 +350,9 @@ typedef struct
   u32 *to_next_list;
   vlib_buffer_t **rx_buffers_pdesc;
   u32 polling_q_count;
+
+  /* pool of in-flight tx dma batches */
+  vhost_user_dma_info_t *dma_infos;
 } vhost_cpu_t;
 
 typedef struct
@@ -369,6 +395,7 @@ typedef struct
 
 int vhost_user_dump_ifs (vnet_main_t * vnm, vlib_main_t * vm,
 			 vhost_user_intf_details_t ** out_vuids);
+void vhost_user_tx_dma_completion_cb (vlib_main_t *vm, vlib_dma_batch_t *b);
 void vhost_user_set_operation_mode (vhost_user_intf_t *vui,
 				    vhost_user_vring_t *txvq);
 
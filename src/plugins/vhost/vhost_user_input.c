@@ -546,7 +546,7 @@ vhost_user_if_input (vlib_main_t *vm, vhost_user_main_t *vum,
       vhost_user_log_dirty_ring (vui, txvq, ring[last_used_idx & mask]);
 
       /* The buffer should already be initialized */
-      b_head->total_length_not_including_first_buffer = 0;
+      vlib_buffer_cold (b_head)->total_length_not_including_first_buffer = 0;
       b_head->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
 
       if (PREDICT_FALSE
@@ -675,15 +675,17 @@ vhost_user_if_input (vlib_main_t *vm, vhost_user_main_t *vum,
 	  desc_data_offset += cpy->len;
 
 	  b_current->current_length += cpy->len;
-	  b_head->total_length_not_including_first_buffer += cpy->len;
+	  vlib_buffer_cold (b_head)->total_length_not_including_first_buffer +=
+	    cpy->len;
 	}
 
     out:
 
-      n_rx_bytes += b_head->total_length_not_including_first_buffer;
+      n_rx_bytes +=
+	vlib_buffer_cold (b_head)->total_length_not_including_first_buffer;
       n_rx_packets++;
 
-      b_head->total_length_not_including_first_buffer -=
+      vlib_buffer_cold (b_head)->total_length_not_including_first_buffer -=
 	b_head->current_length;
 
       /* consume the descriptor and return it as used */
@@ -1080,7 +1082,8 @@ vhost_user_assemble_packet (vnet_virtio_vring_packed_desc_t *desc_table,
       *desc_data_offset += cpy->len;
 
       (*b_current)->current_length += cpy->len;
-      b_head->total_length_not_including_first_buffer += cpy->len;
+      vlib_buffer_cold (b_head)->total_length_not_including_first_buffer +=
+	cpy->len;
     }
   *desc_idx = (*desc_idx + 1) & mask;;
   *desc_data_offset = 0;
@@ -1239,7 +1242,7 @@ vhost_user_if_input_packed (vlib_main_t *vm, vhost_user_main_t *vum,
       n_left_to_next--;
 
       /* The buffer should already be initialized */
-      b_head->total_length_not_including_first_buffer = 0;
+      vlib_buffer_cold (b_head)->total_length_not_including_first_buffer = 0;
       b_head->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
       desc_data_offset = vui->virtio_net_hdr_sz;
       n_descs_to_process = 1;
@@ -1314,10 +1317,11 @@ vhost_user_if_input_packed (vlib_main_t *vm, vhost_user_main_t *vum,
 				      buffer_data_size, mask);
 	}
 
-      n_rx_bytes += b_head->total_length_not_including_first_buffer;
+      n_rx_bytes +=
+	vlib_buffer_cold (b_head)->total_length_not_including_first_buffer;
       n_rx_packets++;
 
-      b_head->total_length_not_including_first_buffer -=
+      vlib_buffer_cold (b_head)->total_length_not_including_first_buffer -=
 	b_head->current_length;
 
       vnet_buffer (b_head)->sw_if_index[VLIB_RX] = vui->sw_if_index;
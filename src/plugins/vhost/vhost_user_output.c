@@ -201,6 +201,100 @@ vhost_user_tx_copy (vhost_user_intf_t * vui, vhost_copy_t * cpy,
   return 0;
 }
 
+/*
+ * Same as vhost_user_tx_copy, but copies long enough to pay off are queued
+ * to the dma batch instead of being done by the cpu. Guest header copies
+ * are always short, so their per-cpu source array can safely be reused by
+ * the next frame before the batch completes.
+ */
+static_always_inline u32
+vhost_user_tx_copy_dma (vlib_main_t *vm, vhost_user_intf_t *vui,
+			vlib_dma_batch_t *b, vhost_copy_t *cpy, u16 copy_len,
+			u32 *map_hint)
+{
+  void *dst;
+
+  if (b == 0)
+    return vhost_user_tx_copy (vui, cpy, copy_len, map_hint);
+
+  while (copy_len)
+    {
+      if (PREDICT_FALSE (!(dst = map_guest_mem (vui, cpy->dst, map_hint))))
+	return 1;
+      if (cpy->len >= VHOST_USER_DMA_MIN_COPY_LEN &&
+	  b->n_enq < VHOST_USER_DMA_MAX_TRANSFERS)
+	vlib_dma_batch_add (vm, b, dst, (void *) cpy->src, cpy->len);
+      else
+	clib_memcpy_fast (dst, (void *) cpy->src, cpy->len);
+      vhost_user_log_dirty_pages_2 (vui, cpy->dst, cpy->len, 1);
+      copy_len -= 1;
+      cpy += 1;
+    }
+  return 0;
+}
+
+/*
+ * Give buffers back to driver. While dma copies into the guest are still
+ * in flight, the used index is only recorded and published by the dma
+ * completion callback, so the guest never sees a descriptor before its
+ * data has landed.
+ */
+static_always_inline void
+vhost_user_tx_update_used_idx (vhost_user_intf_t *vui,
+			       vhost_user_vring_t *rxvq, vlib_dma_batch_t *b)
+{
+  if (PREDICT_FALSE (rxvq->n_dma_pending || (b && b->n_enq)))
+    {
+      rxvq->dma_used_idx = rxvq->last_used_idx;
+      return;
+    }
+
+  CLIB_MEMORY_BARRIER ();
+  rxvq->used->idx = rxvq->last_used_idx;
+  vhost_user_log_dirty_ring (vui, rxvq, idx);
+}
+
+#ifndef CLIB_MARCH_VARIANT
+void
+vhost_user_tx_dma_completion_cb (vlib_main_t *vm, vlib_dma_batch_t *b)
+{
+  vhost_user_main_t *vum = &vhost_user_main;
+  vhost_cpu_t *cpu = &vum->cpus[vm->thread_index];
+  vhost_user_dma_info_t *info;
+  vhost_user_intf_t *vui;
+  vhost_user_vring_t *rxvq;
+
+  info = pool_elt_at_index (cpu->dma_infos, vlib_dma_batch_get_cookie (vm, b));
+
+  /* interface deleted or vring reset while the batch was in flight */
+  if (pool_is_free_index (vum->vhost_user_interfaces, info->dev_instance))
+    goto done;
+  vui = pool_elt_at_index (vum->vhost_user_interfaces, info->dev_instance);
+  if (info->qid >= vec_len (vui->vrings))
+    goto done;
+  rxvq = &vui->vrings[info->qid];
+  if (rxvq->n_dma_pending == 0 || rxvq->used == 0)
+    goto done;
+
+  rxvq->n_dma_pending--;
+  CLIB_MEMORY_BARRIER ();
+  rxvq->used->idx = rxvq->n_dma_pending ? info->used_idx : rxvq->dma_used_idx;
+  vhost_user_log_dirty_ring (vui, rxvq, idx);
+
+  /* interrupt (call) handling, deferred from the tx node */
+  if ((rxvq->callfd_idx != ~0) &&
+      !(rxvq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT) &&
+      rxvq->n_dma_pending == 0 &&
+      rxvq->n_since_last_int > vum->coalesce_frames)
+    vhost_user_send_call (vm, vui, rxvq);
+
+done:
+  vlib_buffer_free (vm, info->buffers, vec_len (info->buffers));
+  vec_reset_length (info->buffers);
+  pool_put (cpu->dma_infos, info);
+}
+#endif
+
 static_always_inline void
 vhost_user_handle_tx_offload (vhost_user_intf_t *vui, vlib_buffer_t *b,
 			      vnet_virtio_net_hdr_t *hdr)
@@ -706,6 +800,8 @@ VNET_DEVICE_CLASS_TX_FN (vhost_user_device_class) (vlib_main_t * vm,
   u16 tx_headers_len;
   u32 or_flags;
   vnet_hw_if_tx_frame_t *tf = vlib_frame_scalar_args (frame);
+  vlib_dma_batch_t *dma_b = 0;
+  u8 dma_submitted = 0;
 
   if (PREDICT_FALSE (!vui->admin_up))
     {
@@ -734,6 +830,9 @@ VNET_DEVICE_CLASS_TX_FN (vhost_user_device_class) (vlib_main_t * vm,
   if (vhost_user_is_packed_ring_supported (vui))
     return (vhost_user_device_class_packed (vm, node, frame, vui, rxvq));
 
+  if (vui->dma_tx_config >= 0 && !tf->shared_queue)
+    dma_b = vlib_dma_batch_new (vm, vui->dma_tx_config);
+
 retry:
   error = VHOST_USER_TX_FUNC_ERROR_NONE;
   tx_headers_len = 0;
@@ -954,8 +1053,9 @@ retry:
        */
       if (PREDICT_FALSE (copy_len >= VHOST_USER_TX_COPY_THRESHOLD))
 	{
-	  if (PREDICT_FALSE (vhost_user_tx_copy (vui, cpu->copy, copy_len,
-						 &map_hint)))
+	  if (PREDICT_FALSE (vhost_user_tx_copy_dma (vm, vui, dma_b,
+						     cpu->copy, copy_len,
+						     &map_hint)))
 	    {
 	      vlib_error_count (vm, node->node_index,
 				VHOST_USER_TX_FUNC_ERROR_MMAP_FAIL, 1);
@@ -963,25 +1063,21 @@ retry:
 	  copy_len = 0;
 
 	  /* give buffers back to driver */
-	  CLIB_MEMORY_BARRIER ();
-	  rxvq->used->idx = rxvq->last_used_idx;
-	  vhost_user_log_dirty_ring (vui, rxvq, idx);
+	  vhost_user_tx_update_used_idx (vui, rxvq, dma_b);
 	}
       buffers++;
     }
 
 done:
   //Do the memory copies
-  if (PREDICT_FALSE (vhost_user_tx_copy (vui, cpu->copy, copy_len,
-					 &map_hint)))
+  if (PREDICT_FALSE (vhost_user_tx_copy_dma (vm, vui, dma_b, cpu->copy,
+					     copy_len, &map_hint)))
     {
       vlib_error_count (vm, node->node_index,
 			VHOST_USER_TX_FUNC_ERROR_MMAP_FAIL, 1);
     }
 
-  CLIB_MEMORY_BARRIER ();
-  rxvq->used->idx = rxvq->last_used_idx;
-  vhost_user_log_dirty_ring (vui, rxvq, idx);
+  vhost_user_tx_update_used_idx (vui, rxvq, dma_b);
 
   /*
    * When n_left is set, error is always set to something too.
@@ -1001,13 +1097,37 @@ done:
       goto retry;
     }
 
+  /*
+   * Hand the batch to the dma engine. Packet data is still being read
+   * from the vlib buffers, so they are freed by the completion callback.
+   */
+  if (dma_b)
+    {
+      if (dma_b->n_enq)
+	{
+	  vhost_user_dma_info_t *info;
+
+	  pool_get (cpu->dma_infos, info);
+	  vec_add (info->buffers, vlib_frame_vector_args (frame),
+		   frame->n_vectors);
+	  info->dev_instance = vui - vum->vhost_user_interfaces;
+	  info->qid = qid;
+	  info->used_idx = rxvq->last_used_idx;
+	  vlib_dma_batch_set_cookie (vm, dma_b, info - cpu->dma_infos);
+	  rxvq->n_dma_pending++;
+	  dma_submitted = 1;
+	}
+      vlib_dma_batch_submit (vm, dma_b);
+    }
+
   /* interrupt (call) handling */
   if ((rxvq->callfd_idx != ~0) &&
       !(rxvq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT))
     {
       rxvq->n_since_last_int += frame->n_vectors - n_left;
 
-      if (rxvq->n_since_last_int > vum->coalesce_frames)
+      if (rxvq->n_since_last_int > vum->coalesce_frames &&
+	  rxvq->n_dma_pending == 0)
 	vhost_user_send_call (vm, vui, rxvq);
     }
 
@@ -1023,6 +1143,9 @@ done3:
 	 thread_index, vui->sw_if_index, n_left);
     }
 
+  if (dma_submitted)
+    return frame->n_vectors;
+
   vlib_buffer_free (vm, vlib_frame_vector_args (frame), frame->n_vectors);
   return frame->n_vectors;
 }
@@ -260,7 +260,7 @@ vmxnet3_device_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       vnet_buffer (b0)->feature_arc_index = 0;
       b0->current_length = rx_comp->len & VMXNET3_RXCL_LEN_MASK;
       b0->current_data = 0;
-      b0->total_length_not_including_first_buffer = 0;
+      vlib_buffer_cold (b0)->total_length_not_including_first_buffer = 0;
       b0->next_buffer = 0;
       b0->flags = 0;
       b0->error = 0;
@@ -318,7 +318,8 @@ vmxnet3_device_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		{
 		  prev_b0->flags |= VLIB_BUFFER_NEXT_PRESENT;
 		  prev_b0->next_buffer = bi0;
-		  hb->total_length_not_including_first_buffer +=
+		  vlib_buffer_cold (hb)
+		    ->total_length_not_including_first_buffer +=
 		    b0->current_length;
 		}
 	      else
@@ -349,7 +350,8 @@ vmxnet3_device_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  prev_b0->flags |= VLIB_BUFFER_NEXT_PRESENT;
 	  prev_b0->next_buffer = bi0;
 	  prev_b0 = b0;
-	  hb->total_length_not_including_first_buffer += b0->current_length;
+	  vlib_buffer_cold (hb)->total_length_not_including_first_buffer +=
+	    b0->current_length;
 	}
       else
 	{
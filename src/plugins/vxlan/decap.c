@@ -60,24 +60,31 @@ static const vxlan_decap_info_t decap_bad_flags = {
   .error = VXLAN_ERROR_BAD_FLAGS
 };
 
+always_inline void
+vxlan4_tunnel_key_init (vxlan4_tunnel_key_t *key4, u32 fib_index,
+			ip4_header_t *ip4_0, vxlan_header_t *vxlan0)
+{
+  /* Make sure VXLAN tunnel exist according to packet S/D IP, UDP port, VRF,
+   * and VNI */
+  udp_header_t *udp = ip4_next_header (ip4_0);
+  key4->key[0] = ((u64) ip4_0->dst_address.as_u32 << 32) |
+		 ip4_0->src_address.as_u32;
+  key4->key[1] = ((u64) udp->dst_port << 48) | ((u64) fib_index << 32) |
+		 vxlan0->vni_reserved;
+}
+
 always_inline vxlan_decap_info_t
-vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
-		    u32 fib_index, ip4_header_t * ip4_0,
-		    vxlan_header_t * vxlan0, u32 * stats_sw_if_index)
+vxlan4_find_tunnel_with_hash (vxlan_main_t *vxm, last_tunnel_cache4 *cache,
+			      u32 fib_index, u64 hash, ip4_header_t *ip4_0,
+			      vxlan_header_t *vxlan0, u32 *stats_sw_if_index)
 {
   if (PREDICT_FALSE (vxlan0->flags != VXLAN_FLAGS_I))
     return decap_bad_flags;
 
-  /* Make sure VXLAN tunnel exist according to packet S/D IP, UDP port, VRF,
-   * and VNI */
   u32 dst = ip4_0->dst_address.as_u32;
   u32 src = ip4_0->src_address.as_u32;
-  udp_header_t *udp = ip4_next_header (ip4_0);
-  vxlan4_tunnel_key_t key4 = {
-    .key[0] = ((u64) dst << 32) | src,
-    .key[1] = ((u64) udp->dst_port << 48) | ((u64) fib_index << 32) |
-	      vxlan0->vni_reserved,
-  };
+  vxlan4_tunnel_key_t key4;
+  vxlan4_tunnel_key_init (&key4, fib_index, ip4_0, vxlan0);
 
   if (PREDICT_TRUE
       (key4.key[0] == cache->key[0] && key4.key[1] == cache->key[1]))
@@ -88,7 +95,8 @@ vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
       return di;
     }
 
-  int rv = clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, &key4);
+  int rv = clib_bihash_search_inline_with_hash_16_8 (
+    &vxm->vxlan4_tunnel_by_key, hash, &key4);
   if (PREDICT_TRUE (rv == 0))
     {
       *cache = key4;
@@ -120,31 +128,49 @@ vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
   return di;
 }
 
-typedef vxlan6_tunnel_key_t last_tunnel_cache6;
-
 always_inline vxlan_decap_info_t
-vxlan6_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache6 * cache,
-		    u32 fib_index, ip6_header_t * ip6_0,
+vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
+		    u32 fib_index, ip4_header_t * ip4_0,
 		    vxlan_header_t * vxlan0, u32 * stats_sw_if_index)
 {
-  if (PREDICT_FALSE (vxlan0->flags != VXLAN_FLAGS_I))
-    return decap_bad_flags;
+  vxlan4_tunnel_key_t key4;
+  vxlan4_tunnel_key_init (&key4, fib_index, ip4_0, vxlan0);
+  return vxlan4_find_tunnel_with_hash (vxm, cache, fib_index,
+				       clib_bihash_hash_16_8 (&key4), ip4_0,
+				       vxlan0, stats_sw_if_index);
+}
 
+typedef vxlan6_tunnel_key_t last_tunnel_cache6;
+
+always_inline void
+vxlan6_tunnel_key_init (vxlan6_tunnel_key_t *key6, u32 fib_index,
+			ip6_header_t *ip6_0, vxlan_header_t *vxlan0)
+{
   /* Make sure VXLAN tunnel exist according to packet SIP, UDP port, VRF, and
    * VNI */
   udp_header_t *udp = ip6_next_header (ip6_0);
-  vxlan6_tunnel_key_t key6 = {
-    .key[0] = ip6_0->src_address.as_u64[0],
-    .key[1] = ip6_0->src_address.as_u64[1],
-    .key[2] = ((u64) udp->dst_port << 48) | ((u64) fib_index << 32) |
-	      vxlan0->vni_reserved,
-  };
+  key6->key[0] = ip6_0->src_address.as_u64[0];
+  key6->key[1] = ip6_0->src_address.as_u64[1];
+  key6->key[2] = ((u64) udp->dst_port << 48) | ((u64) fib_index << 32) |
+		 vxlan0->vni_reserved;
+}
+
+always_inline vxlan_decap_info_t
+vxlan6_find_tunnel_with_hash (vxlan_main_t *vxm, last_tunnel_cache6 *cache,
+			      u32 fib_index, u64 hash, ip6_header_t *ip6_0,
+			      vxlan_header_t *vxlan0, u32 *stats_sw_if_index)
+{
+  if (PREDICT_FALSE (vxlan0->flags != VXLAN_FLAGS_I))
+    return decap_bad_flags;
+
+  vxlan6_tunnel_key_t key6;
+  vxlan6_tunnel_key_init (&key6, fib_index, ip6_0, vxlan0);
 
   if (PREDICT_FALSE
       (clib_bihash_key_compare_24_8 (key6.key, cache->key) == 0))
     {
-      int rv =
-	clib_bihash_search_inline_24_8 (&vxm->vxlan6_tunnel_by_key, &key6);
+      int rv = clib_bihash_search_inline_with_hash_24_8 (
+	&vxm->vxlan6_tunnel_by_key, hash, &key6);
       if (PREDICT_FALSE (rv != 0))
 	return decap_not_found;
 
@@ -180,6 +206,95 @@ vxlan6_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache6 * cache,
   return di;
 }
 
+always_inline vxlan_decap_info_t
+vxlan6_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache6 * cache,
+		    u32 fib_index, ip6_header_t * ip6_0,
+		    vxlan_header_t * vxlan0, u32 * stats_sw_if_index)
+{
+  vxlan6_tunnel_key_t key6;
+  vxlan6_tunnel_key_init (&key6, fib_index, ip6_0, vxlan0);
+  return vxlan6_find_tunnel_with_hash (vxm, cache, fib_index,
+				       clib_bihash_hash_24_8 (&key6), ip6_0,
+				       vxlan0, stats_sw_if_index);
+}
+
+typedef struct
+{
+  u32 sw_if_index;
+  u32 n_packets;
+  u64 n_bytes;
+} vxlan_rx_stats_t;
+
+/* rx counters are updated once per run of packets of the same tunnel */
+always_inline void
+vxlan_rx_stats_add (vlib_combined_counter_main_t *rx_counter,
+		    clib_thread_index_t thread_index, vxlan_rx_stats_t *st,
+		    u32 sw_if_index, u32 len)
+{
+  if (PREDICT_FALSE (sw_if_index != st->sw_if_index))
+    {
+      if (st->n_packets)
+	vlib_increment_combined_counter (rx_counter, thread_index,
+					 st->sw_if_index, st->n_packets,
+					 st->n_bytes);
+      st->sw_if_index = sw_if_index;
+      st->n_packets = 0;
+      st->n_bytes = 0;
+    }
+  st->n_packets += 1;
+  st->n_bytes += len;
+}
+
+/*
+ * Compute the tunnel key hashes of the whole frame up front and prefetch
+ * the bihash buckets, which are almost always cache misses with many
+ * tunnels. Consecutive packets of the same tunnel share the hash.
+ */
+always_inline void
+vxlan_prefetch_tunnel_buckets (vxlan_main_t *vxm, vlib_buffer_t **b,
+			       u64 *hashes, u32 n_left, u32 is_ip4)
+{
+  vxlan4_tunnel_key_t key4, last_key4 = { .key = { ~0ULL, ~0ULL } };
+  vxlan6_tunnel_key_t key6, last_key6 = { .key = { ~0ULL, ~0ULL, ~0ULL } };
+  u64 hash = 0;
+
+  for (u32 i = 0; i < n_left; i++)
+    {
+      /* udp leaves current_data pointing at the vxlan header */
+      vxlan_header_t *vxlan0 = vlib_buffer_get_current (b[i]);
+      u32 fi0 = vlib_buffer_get_ip_fib_index (b[i], is_ip4);
+
+      if (is_ip4)
+	{
+	  ip4_header_t *ip4_0 = (void *) vxlan0 - sizeof (udp_header_t) -
+				sizeof (ip4_header_t);
+	  vxlan4_tunnel_key_init (&key4, fi0, ip4_0, vxlan0);
+	  if (key4.key[0] != last_key4.key[0] ||
+	      key4.key[1] != last_key4.key[1])
+	    {
+	      hash = clib_bihash_hash_16_8 (&key4);
+	      clib_bihash_prefetch_bucket_16_8 (&vxm->vxlan4_tunnel_by_key,
+						hash);
+	      last_key4 = key4;
+	    }
+	}
+      else
+	{
+	  ip6_header_t *ip6_0 = (void *) vxlan0 - sizeof (udp_header_t) -
+				sizeof (ip6_header_t);
+	  vxlan6_tunnel_key_init (&key6, fi0, ip6_0, vxlan0);
+	  if (clib_bihash_key_compare_24_8 (key6.key, last_key6.key) == 0)
+	    {
+	      hash = clib_bihash_hash_24_8 (&key6);
+	      clib_bihash_prefetch_bucket_24_8 (&vxm->vxlan6_tunnel_by_key,
+						hash);
+	      last_key6 = key6;
+	    }
+	}
+      hashes[i] = hash;
+    }
+}
+
 always_inline uword
 vxlan_input (vlib_main_t * vm,
 	     vlib_node_runtime_t * node,
@@ -206,6 +321,10 @@ vxlan_input (vlib_main_t * vm,
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
   vlib_get_buffers (vm, from, bufs, n_left_from);
 
+  u64 hashes[VLIB_FRAME_SIZE], *hash = hashes;
+  vxlan_prefetch_tunnel_buckets (vxm, bufs, hashes, n_left_from, is_ip4);
+
+  vxlan_rx_stats_t rx_stats = { .sw_if_index = ~0 };
   u32 stats_if0 = ~0, stats_if1 = ~0;
   u16 nexts[VLIB_FRAME_SIZE], *next = nexts;
   while (n_left_from >= 4)
@@ -241,12 +360,16 @@ vxlan_input (vlib_main_t * vm,
       u32 fi0 = vlib_buffer_get_ip_fib_index (b[0], is_ip4);
       u32 fi1 = vlib_buffer_get_ip_fib_index (b[1], is_ip4);
 
-      vxlan_decap_info_t di0 = is_ip4 ?
-	vxlan4_find_tunnel (vxm, &last4, fi0, ip4_0, vxlan0, &stats_if0) :
-	vxlan6_find_tunnel (vxm, &last6, fi0, ip6_0, vxlan0, &stats_if0);
-      vxlan_decap_info_t di1 = is_ip4 ?
-	vxlan4_find_tunnel (vxm, &last4, fi1, ip4_1, vxlan1, &stats_if1) :
-	vxlan6_find_tunnel (vxm, &last6, fi1, ip6_1, vxlan1, &stats_if1);
+      vxlan_decap_info_t di0 =
+	is_ip4 ? vxlan4_find_tunnel_with_hash (vxm, &last4, fi0, hash[0],
+					       ip4_0, vxlan0, &stats_if0) :
+		 vxlan6_find_tunnel_with_hash (vxm, &last6, fi0, hash[0],
+					       ip6_0, vxlan0, &stats_if0);
+      vxlan_decap_info_t di1 =
+	is_ip4 ? vxlan4_find_tunnel_with_hash (vxm, &last4, fi1, hash[1],
+					       ip4_1, vxlan1, &stats_if1) :
+		 vxlan6_find_tunnel_with_hash (vxm, &last6, fi1, hash[1],
+					       ip6_1, vxlan1, &stats_if1);
 
       /* Prefetch next iteration. */
       clib_prefetch_load (b[2]->data);
@@ -267,10 +390,10 @@ vxlan_input (vlib_main_t * vm,
 	  /* Set packet input sw_if_index to unicast VXLAN tunnel for learning */
 	  vnet_buffer (b[0])->sw_if_index[VLIB_RX] = di0.sw_if_index;
 	  vnet_buffer (b[1])->sw_if_index[VLIB_RX] = di1.sw_if_index;
-	  vlib_increment_combined_counter (rx_counter, thread_index,
-					   stats_if0, 1, len0);
-	  vlib_increment_combined_counter (rx_counter, thread_index,
-					   stats_if1, 1, len1);
+	  vxlan_rx_stats_add (rx_counter, thread_index, &rx_stats, stats_if0,
+			      len0);
+	  vxlan_rx_stats_add (rx_counter, thread_index, &rx_stats, stats_if1,
+			      len1);
 	}
       else
 	{
@@ -278,8 +401,8 @@ vxlan_input (vlib_main_t * vm,
 	    {
 	      vnet_update_l2_len (b[0]);
 	      vnet_buffer (b[0])->sw_if_index[VLIB_RX] = di0.sw_if_index;
-	      vlib_increment_combined_counter (rx_counter, thread_index,
-					       stats_if0, 1, len0);
+	      vxlan_rx_stats_add (rx_counter, thread_index, &rx_stats,
+				  stats_if0, len0);
 	    }
 	  else
 	    {
@@ -291,8 +414,8 @@ vxlan_input (vlib_main_t * vm,
 	    {
 	      vnet_update_l2_len (b[1]);
 	      vnet_buffer (b[1])->sw_if_index[VLIB_RX] = di1.sw_if_index;
-	      vlib_increment_combined_counter (rx_counter, thread_index,
-					       stats_if1, 1, len1);
+	      vxlan_rx_stats_add (rx_counter, thread_index, &rx_stats,
+				  stats_if1, len1);
 	    }
 	  else
 	    {
@@ -323,6 +446,7 @@ vxlan_input (vlib_main_t * vm,
 	}
       b += 2;
       next += 2;
+      hash += 2;
       n_left_from -= 2;
     }
 
@@ -343,9 +467,11 @@ vxlan_input (vlib_main_t * vm,
 
       u32 fi0 = vlib_buffer_get_ip_fib_index (b[0], is_ip4);
 
-      vxlan_decap_info_t di0 = is_ip4 ?
-	vxlan4_find_tunnel (vxm, &last4, fi0, ip4_0, vxlan0, &stats_if0) :
-	vxlan6_find_tunnel (vxm, &last6, fi0, ip6_0, vxlan0, &stats_if0);
+      vxlan_decap_info_t di0 =
+	is_ip4 ? vxlan4_find_tunnel_with_hash (vxm, &last4, fi0, hash[0],
+					       ip4_0, vxlan0, &stats_if0) :
+		 vxlan6_find_tunnel_with_hash (vxm, &last6, fi0, hash[0],
+					       ip6_0, vxlan0, &stats_if0);
 
       uword len0 = vlib_buffer_length_in_chain (vm, b[0]);
 
@@ -360,8 +486,8 @@ vxlan_input (vlib_main_t * vm,
 	  /* Set packet input sw_if_index to unicast VXLAN tunnel for learning */
 	  vnet_buffer (b[0])->sw_if_index[VLIB_RX] = di0.sw_if_index;
 
-	  vlib_increment_combined_counter (rx_counter, thread_index,
-					   stats_if0, 1, len0);
+	  vxlan_rx_stats_add (rx_counter, thread_index, &rx_stats, stats_if0,
+			      len0);
 	}
       else
 	{
@@ -381,8 +507,15 @@ vxlan_input (vlib_main_t * vm,
 	}
       b += 1;
       next += 1;
+      hash += 1;
       n_left_from -= 1;
     }
+
+  if (rx_stats.n_packets)
+    vlib_increment_combined_counter (rx_counter, thread_index,
+				     rx_stats.sw_if_index, rx_stats.n_packets,
+				     rx_stats.n_bytes);
+
   vlib_buffer_enqueue_to_next (vm, node, from, nexts, from_frame->n_vectors);
   /* Do we still need this now that tunnel tx stats is kept? */
   u32 node_idx = is_ip4 ? vxlan4_input_node.index : vxlan6_input_node.index;
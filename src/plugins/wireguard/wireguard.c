@@ -36,6 +36,15 @@ wg_set_async_mode (u32 is_enabled)
     wg_op_mode_unset_ASYNC ();
 }
 
+void
+wg_set_multi_worker_mode (u32 is_enabled)
+{
+  if (is_enabled)
+    wg_op_mode_set_MULTI_WORKER ();
+  else
+    wg_op_mode_unset_MULTI_WORKER ();
+}
+
 static void
 wireguard_register_post_node (vlib_main_t *vm)
 
@@ -79,6 +88,12 @@ wg_init (vlib_main_t * vm)
     vlib_frame_queue_main_init (wg6_output_tun_node.index, 0);
 
   vlib_thread_main_t *tm = vlib_get_thread_main ();
+  u32 hs_nelts = clib_max (WG_HANDSHAKE_FQ_NELTS, 8 + tm->n_vlib_mains);
+
+  wmp->hs4_fq_index =
+    vlib_frame_queue_main_init (wg4_input_node.index, hs_nelts);
+  wmp->hs6_fq_index =
+    vlib_frame_queue_main_init (wg6_input_node.index, hs_nelts);
 
   vec_validate_aligned (wmp->per_thread_data, tm->n_vlib_mains,
 			CLIB_CACHE_LINE_BYTES);
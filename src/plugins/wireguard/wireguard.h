@@ -21,6 +21,7 @@
 #include <vnet/buffer.h>
 
 #define WG_DEFAULT_DATA_SIZE 2048
+#define WG_HANDSHAKE_FQ_NELTS 16
 
 extern vlib_node_registration_t wg4_input_node;
 extern vlib_node_registration_t wg6_input_node;
@@ -50,6 +51,10 @@ typedef struct
   u32 in6_fq_index;
   u32 out4_fq_index;
   u32 out6_fq_index;
+  /* handshakes get their own, shorter, queues to the main thread so a
+   * flood of them is dropped at handoff rather than stalling data */
+  u32 hs4_fq_index;
+  u32 hs6_fq_index;
 
   wg_per_thread_data_t *per_thread_data;
   u8 feature_init;
@@ -74,7 +79,9 @@ extern wg_main_t wg_main;
 /**
  * Wireguard operation mode
  **/
-#define foreach_wg_op_mode_flags _ (0, ASYNC, "async")
+#define foreach_wg_op_mode_flags                                              \
+  _ (0, ASYNC, "async")                                                       \
+  _ (1, MULTI_WORKER, "multi-worker")
 
 /**
  * Helper function to set/unset and check op modes
@@ -119,6 +126,7 @@ STATIC_ASSERT (sizeof (wg_post_data_t) <=
 #define WG_START_EVENT	1
 void wg_feature_init (wg_main_t * wmp);
 void wg_set_async_mode (u32 is_enabled);
+void wg_set_multi_worker_mode (u32 is_enabled);
 
 void wg_secure_zero_memory (void *v, size_t n);
 
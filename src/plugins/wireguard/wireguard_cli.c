@@ -385,6 +385,44 @@ VLIB_CLI_COMMAND (wg_set_async_mode_command, static) = {
   .function = wg_set_async_mode_command_fn,
 };
 
+static clib_error_t *
+wg_set_multi_worker_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				     vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  int mw_enable = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "on"))
+	mw_enable = 1;
+      else if (unformat (line_input, "off"))
+	mw_enable = 0;
+      else
+	return (clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, line_input));
+    }
+
+  wg_set_multi_worker_mode (mw_enable);
+
+  unformat_free (line_input);
+  return (NULL);
+}
+
+/*?
+ * Let any worker encrypt and decrypt for a peer instead of handing the
+ * peer's packets off to the threads that first used it. Nonces are then
+ * reserved and the replay window updated with atomic operations.
+ ?*/
+VLIB_CLI_COMMAND (wg_set_multi_worker_mode_command, static) = {
+  .path = "set wireguard multi-worker mode",
+  .short_help = "set wireguard multi-worker mode on|off",
+  .function = wg_set_multi_worker_mode_command_fn,
+};
+
 static clib_error_t *
 wg_show_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
 			 vlib_cli_command_t *cmd)
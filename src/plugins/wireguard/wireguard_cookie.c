@@ -141,6 +141,20 @@ cookie_maker_mac (cookie_maker_t * cp, message_macs_t * cm, void *buf,
     clib_memset (cm->mac2, 0, COOKIE_MAC_SIZE);
 }
 
+/* MAC1 only depends on the interface's public key, so it can be checked
+ * on any thread before the message is handed to the main thread */
+bool
+cookie_checker_validate_mac1 (cookie_checker_t *cc, message_macs_t *cm,
+			      void *buf, size_t len)
+{
+  message_macs_t our_cm;
+
+  len = len - sizeof (message_macs_t);
+  cookie_macs_mac1 (&our_cm, buf, len, cc->cc_mac1_key);
+
+  return clib_memcmp (our_cm.mac1, cm->mac1, COOKIE_MAC_SIZE) == 0;
+}
+
 enum cookie_mac_state
 cookie_checker_validate_macs (vlib_main_t *vm, cookie_checker_t *cc,
 			      message_macs_t *cm, void *buf, size_t len,
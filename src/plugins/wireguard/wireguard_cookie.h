@@ -108,6 +108,8 @@ bool cookie_maker_consume_payload (vlib_main_t *vm, cookie_maker_t *cp,
 				   uint8_t nonce[COOKIE_NONCE_SIZE],
 				   uint8_t ecookie[COOKIE_ENCRYPTED_SIZE]);
 void cookie_maker_mac (cookie_maker_t *, message_macs_t *, void *, size_t);
+bool cookie_checker_validate_mac1 (cookie_checker_t *, message_macs_t *,
+				    void *, size_t);
 enum cookie_mac_state
 cookie_checker_validate_macs (vlib_main_t *vm, cookie_checker_t *,
 			      message_macs_t *, void *, size_t, bool,
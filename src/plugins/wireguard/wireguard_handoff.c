@@ -134,7 +134,7 @@ VLIB_NODE_FN (wg4_handshake_handoff)
 {
   wg_main_t *wmp = &wg_main;
 
-  return wg_handoff (vm, node, from_frame, wmp->in4_fq_index,
+  return wg_handoff (vm, node, from_frame, wmp->hs4_fq_index,
 		     WG_HANDOFF_HANDSHAKE);
 }
 
@@ -143,7 +143,7 @@ VLIB_NODE_FN (wg6_handshake_handoff)
 {
   wg_main_t *wmp = &wg_main;
 
-  return wg_handoff (vm, node, from_frame, wmp->in6_fq_index,
+  return wg_handoff (vm, node, from_frame, wmp->hs6_fq_index,
 		     WG_HANDOFF_HANDSHAKE);
 }
 
@@ -131,6 +131,46 @@ is_ip4_header (u8 *data)
   return (data[0] >> 4) == 0x4;
 }
 
+/*
+ * Check the MAC1 of a handshake message against the interfaces listening
+ * on its port. Workers run this before handing a handshake off, so a
+ * flood of forged messages is spread over the workers and never reaches
+ * the main thread's DH processing.
+ */
+static bool
+wg_handshake_mac1_valid (vlib_buffer_t *b)
+{
+  message_header_t *header = vlib_buffer_get_current (b);
+  udp_header_t *uhd = (udp_header_t *) header - 1;
+  message_macs_t *macs;
+  index_t *wg_ifs, *ii;
+  wg_if_t *wg_if;
+  u32 len;
+
+  if (header->type == MESSAGE_HANDSHAKE_INITIATION)
+    len = sizeof (message_handshake_initiation_t);
+  else if (header->type == MESSAGE_HANDSHAKE_RESPONSE)
+    len = sizeof (message_handshake_response_t);
+  else
+    return true;
+
+  if (PREDICT_FALSE (b->current_length < len))
+    return false;
+
+  wg_ifs = wg_if_indexes_get_by_port (clib_net_to_host_u16 (uhd->dst_port));
+  macs = (message_macs_t *) ((u8 *) header + len - sizeof (*macs));
+
+  vec_foreach (ii, wg_ifs)
+    {
+      wg_if = wg_if_get (*ii);
+      if (wg_if && cookie_checker_validate_mac1 (&wg_if->cookie_checker,
+						 macs, header, len))
+	return true;
+    }
+
+  return false;
+}
+
 static wg_input_error_t
 wg_handshake_process (vlib_main_t *vm, wg_main_t *wmp, vlib_buffer_t *b,
 		      u32 node_idx, u8 is_ip4)
@@ -346,7 +386,8 @@ wg_input_post_process (vlib_main_t *vm, vlib_buffer_t *b, u16 *next,
       NULL)
     return -1;
 
-  if (!noise_counter_recv (&kp->kp_ctr, data->counter))
+  if (!noise_counter_recv (&kp->kp_ctr, data->counter,
+			   wg_op_mode_is_set_MULTI_WORKER ()))
     {
       return -1;
     }
@@ -565,6 +606,36 @@ wg_input_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   f->next_node_index[index] = next_node;
 }
 
+typedef struct wg_keypair_free_args_t_
+{
+  u32 local_idx;
+  noise_keypair_t *kp;
+} wg_keypair_free_args_t;
+
+static void
+wg_keypair_free_thread_fn (wg_keypair_free_args_t *args)
+{
+  vlib_main_t *vm = vlib_get_main ();
+
+  /* other workers may still be using the keypair */
+  vlib_worker_thread_barrier_sync (vm);
+  noise_keypair_free (vm, args->local_idx, &args->kp);
+  vlib_worker_thread_barrier_release (vm);
+}
+
+static void
+wg_keypair_free_from_mt (noise_remote_t *r, noise_keypair_t *kp)
+{
+  wg_keypair_free_args_t args = {
+    .local_idx = r->r_local_idx,
+    .kp = kp,
+  };
+
+  if (kp)
+    vlib_rpc_call_main_thread (wg_keypair_free_thread_fn, (u8 *) &args,
+			       sizeof (args));
+}
+
 static_always_inline enum noise_state_crypt
 wg_input_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
 		  vnet_crypto_op_t **crypto_ops,
@@ -636,7 +707,10 @@ wg_input_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       clib_rwlock_writer_lock (&r->r_keypair_lock);
       if (kp == r->r_next && kp->kp_local_index == r_idx)
 	{
-	  noise_remote_keypair_free (vm, r, &r->r_previous);
+	  if (wg_op_mode_is_set_MULTI_WORKER ())
+	    wg_keypair_free_from_mt (r, r->r_previous);
+	  else
+	    noise_remote_keypair_free (vm, r, &r->r_previous);
 	  r->r_previous = r->r_current;
 	  r->r_current = r->r_next;
 	  r->r_next = NULL;
@@ -780,7 +854,11 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      goto out;
 	    }
 
-	  if (PREDICT_FALSE (~0 == peer->input_thread_index))
+	  /* the replay window of a peer's keypair is updated atomically in
+	   * multi-worker mode, so any worker can decrypt for it */
+	  if (wg_op_mode_is_set_MULTI_WORKER ())
+	    ;
+	  else if (PREDICT_FALSE (~0 == peer->input_thread_index))
 	    {
 	      /* this is the first packet to use this peer, claim the peer
 	       * for this thread.
@@ -789,7 +867,8 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 					wg_peer_assign_thread (thread_index));
 	    }
 
-	  if (PREDICT_TRUE (thread_index != peer->input_thread_index))
+	  if (PREDICT_TRUE (thread_index != peer->input_thread_index &&
+			    !wg_op_mode_is_set_MULTI_WORKER ()))
 	    {
 	      other_next[n_other] = WG_INPUT_NEXT_HANDOFF_DATA;
 	      other_bi[n_other] = buf_idx;
@@ -893,7 +972,13 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  /* Handshake packets should be processed in main thread */
 	  if (thread_index != 0)
 	    {
-	      other_next[n_other] = WG_INPUT_NEXT_HANDOFF_HANDSHAKE;
+	      if (PREDICT_FALSE (!wg_handshake_mac1_valid (b[0])))
+		{
+		  other_next[n_other] = WG_INPUT_NEXT_ERROR;
+		  b[0]->error = node->errors[WG_INPUT_ERROR_HANDSHAKE_MAC];
+		}
+	      else
+		other_next[n_other] = WG_INPUT_NEXT_HANDOFF_HANDSHAKE;
 	      other_bi[n_other] = from[b - bufs];
 	      n_other += 1;
 	      goto next;
@@ -38,8 +38,7 @@ static uint32_t noise_remote_handshake_index_get (vlib_main_t *vm,
 static void noise_remote_handshake_index_drop (vlib_main_t *vm,
 					       noise_remote_t *);
 
-static uint64_t noise_counter_send (noise_counter_t *);
-bool noise_counter_recv (noise_counter_t *, uint64_t);
+static uint64_t noise_counter_send (noise_counter_t *, bool);
 
 static void noise_kdf (uint8_t *, uint8_t *, uint8_t *, const uint8_t *,
 		       size_t, size_t, size_t, size_t,
@@ -522,7 +521,9 @@ noise_remote_encrypt (vlib_main_t * vm, noise_remote_t * r, uint32_t * r_idx,
   if (!kp->kp_valid ||
       wg_birthdate_has_expired (kp->kp_birthdate, REJECT_AFTER_TIME) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = noise_counter_send (&kp->kp_ctr,
+				    wg_op_mode_is_set_MULTI_WORKER ())) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -33,11 +33,15 @@
 #define NOISE_HANDSHAKE_NAME	"Noise_IKpsk2_25519_ChaChaPoly_BLAKE2s"
 #define NOISE_IDENTIFIER_NAME	"WireGuard v1 zx2c4 Jason@zx2c4.com"
 
-/* Constants for the counter */
+/* Constants for the counter.
+ * Each backtrack word holds a block of COUNTER_BITS counters: the block
+ * number in the upper half and the bits of the counters seen in the lower
+ * half, so that a single CAS tests and sets a bit and recycles the word
+ * for a newer block. Workers can then share the window without a lock. */
 #define COUNTER_BITS_TOTAL	8192
-#define COUNTER_BITS		(sizeof(unsigned long) * 8)
+#define COUNTER_BITS		32
 #define COUNTER_NUM		(COUNTER_BITS_TOTAL / COUNTER_BITS)
-#define COUNTER_WINDOW_SIZE	(COUNTER_BITS_TOTAL - COUNTER_BITS)
+#define COUNTER_WINDOW_SIZE	(COUNTER_BITS_TOTAL - 2 * COUNTER_BITS)
 
 /* Constants for the keypair */
 #define REKEY_AFTER_MESSAGES	(1ull << 60)
@@ -80,7 +84,7 @@ typedef struct noise_counter
 {
   uint64_t c_send;
   uint64_t c_recv;
-  unsigned long c_backtrack[COUNTER_NUM];
+  u64 c_backtrack[COUNTER_NUM];
 } noise_counter_t;
 
 typedef struct noise_keypair
@@ -137,10 +141,13 @@ noise_local_get (uint32_t locali)
 }
 
 static_always_inline uint64_t
-noise_counter_send (noise_counter_t *ctr)
+noise_counter_send (noise_counter_t *ctr, bool is_mt)
 {
   uint64_t ret;
-  ret = ctr->c_send++;
+  if (is_mt)
+    ret = clib_atomic_fetch_add_relax (&ctr->c_send, 1);
+  else
+    ret = ctr->c_send++;
   return ret;
 }
 
@@ -217,52 +224,63 @@ wg_get_active_keypair (noise_remote_t *r, uint32_t r_idx)
     }
 }
 
-inline bool
-noise_counter_recv (noise_counter_t *ctr, uint64_t recv)
+/* is_mt is set when other workers may validate counters of the same
+ * keypair at the same time */
+static_always_inline bool
+noise_counter_recv (noise_counter_t *ctr, uint64_t recv, bool is_mt)
 {
-  uint64_t i, top, index_recv, index_ctr;
-  unsigned long bit;
-  bool ret = false;
+  uint64_t top, index_recv, old, new;
+  u64 *word;
+  u64 bit;
+  i32 age;
+
+  top = clib_atomic_load_relax_n (&ctr->c_recv);
 
   /* Check that the recv counter is valid */
-  if (ctr->c_recv >= REJECT_AFTER_MESSAGES || recv >= REJECT_AFTER_MESSAGES)
-    goto error;
+  if (top >= REJECT_AFTER_MESSAGES || recv >= REJECT_AFTER_MESSAGES)
+    return false;
 
   /* If the packet is out of the window, invalid */
-  if (recv + COUNTER_WINDOW_SIZE < ctr->c_recv)
-    goto error;
+  if (recv + COUNTER_WINDOW_SIZE < top)
+    return false;
 
-  /* If the new counter is ahead of the current counter, we'll need to
-   * zero out the bitmap that has previously been used */
   index_recv = recv / COUNTER_BITS;
-  index_ctr = ctr->c_recv / COUNTER_BITS;
+  bit = 1ull << (recv % COUNTER_BITS);
+  word = &ctr->c_backtrack[index_recv % COUNTER_NUM];
 
-  if (recv > ctr->c_recv)
+  old = clib_atomic_load_relax_n (word);
+  do
     {
-      top = clib_min (index_recv - index_ctr, COUNTER_NUM);
-      for (i = 1; i <= top; i++)
-	ctr->c_backtrack[(i + index_ctr) & (COUNTER_NUM - 1)] = 0;
-      ctr->c_recv = recv;
+      /* A word holding a newer block means the packet is out of the
+       * window, one holding an older block is cleared for this one */
+      age = (u32) (old >> 32) - (u32) index_recv;
+      if (age > 0 || (age == 0 && (old & bit)))
+	return false;
+
+      new = (age == 0 ? old : (u64) (u32) index_recv << 32) | bit;
+
+      if (!is_mt)
+	{
+	  *word = new;
+	  break;
+	}
     }
+  while (!clib_atomic_cmp_and_swap_acq_relax_n (word, &old, new, 0));
 
-  index_recv %= COUNTER_NUM;
-  bit = 1ul << (recv % COUNTER_BITS);
-
-  if (ctr->c_backtrack[index_recv] & bit)
-    goto error;
-
-  ctr->c_backtrack[index_recv] |= bit;
+  if (!is_mt)
+    ctr->c_recv = clib_max (top, recv);
+  else
+    while (recv > top &&
+	   !clib_atomic_cmp_and_swap_acq_relax_n (&ctr->c_recv, &top, recv, 0))
+      ;
 
-  ret = true;
-error:
-  return ret;
+  return true;
 }
 
 static_always_inline void
-noise_remote_keypair_free (vlib_main_t *vm, noise_remote_t *r,
-			   noise_keypair_t **kp)
+noise_keypair_free (vlib_main_t *vm, uint32_t local_idx, noise_keypair_t **kp)
 {
-  noise_local_t *local = noise_local_get (r->r_local_idx);
+  noise_local_t *local = noise_local_get (local_idx);
   struct noise_upcall *u = &local->l_upcall;
   if (*kp)
     {
@@ -273,6 +291,13 @@ noise_remote_keypair_free (vlib_main_t *vm, noise_remote_t *r,
     }
 }
 
+static_always_inline void
+noise_remote_keypair_free (vlib_main_t *vm, noise_remote_t *r,
+			   noise_keypair_t **kp)
+{
+  noise_keypair_free (vm, r->r_local_idx, kp);
+}
+
 #endif /* __included_wg_noise_h__ */
 
 /*
@@ -292,7 +292,9 @@ wg_output_tun_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = noise_counter_send (&kp->kp_ctr,
+				    wg_op_mode_is_set_MULTI_WORKER ())) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -352,7 +354,9 @@ wg_add_to_async_frame (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = noise_counter_send (&kp->kp_ctr,
+				    wg_op_mode_is_set_MULTI_WORKER ())) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -502,7 +506,11 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  b[0]->error = node->errors[WG_OUTPUT_ERROR_PEER];
 	  goto out;
 	}
-      if (PREDICT_FALSE (~0 == peer->output_thread_index))
+      /* nonces of a peer's keypair are reserved atomically in
+       * multi-worker mode, so any worker can encrypt for it */
+      if (wg_op_mode_is_set_MULTI_WORKER ())
+	;
+      else if (PREDICT_FALSE (~0 == peer->output_thread_index))
 	{
 	  /* this is the first packet to use this peer, claim the peer
 	   * for this thread.
@@ -511,7 +519,8 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    wg_peer_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != peer->output_thread_index))
+      if (PREDICT_FALSE (thread_index != peer->output_thread_index &&
+			 !wg_op_mode_is_set_MULTI_WORKER ()))
 	{
 	  noop_next[0] = WG_OUTPUT_NEXT_HANDOFF;
 	  err = WG_OUTPUT_NEXT_HANDOFF;
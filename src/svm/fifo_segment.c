@@ -655,6 +655,41 @@ fsh_try_alloc_fifo_hdr (fifo_segment_header_t *fsh, fifo_segment_slice_t *fss)
   return sf;
 }
 
+/**
+ * Try to grab a chunk from another slice's freelist
+ *
+ * Used as last resort when the segment is exhausted and the slice has no
+ * cached chunks of its own. Chunk freelists are lock-free stacks so popping
+ * from a slice owned by another worker is safe. The chunk is returned to
+ * the freelist of the slice of the fifo it ends up in.
+ */
+static svm_fifo_chunk_t *
+fsh_try_steal_chunk (fifo_segment_header_t *fsh, fifo_segment_slice_t *fss,
+		     u32 fl_index)
+{
+  fifo_segment_slice_t *vss;
+  svm_fifo_chunk_t *c;
+  u32 chunk_size;
+  int i;
+
+  chunk_size = fs_freelist_index_to_size (fl_index);
+  for (i = 0; i < fsh->n_slices; i++)
+    {
+      vss = fsh_slice_get (fsh, i);
+      if (vss == fss || fss_fl_chunk_bytes (vss) < chunk_size)
+	continue;
+      c = fss_chunk_free_list_pop (fsh, vss, fl_index);
+      if (c)
+	{
+	  c->next = 0;
+	  fss_fl_chunk_bytes_sub (vss, chunk_size);
+	  fsh_cached_bytes_sub (fsh, chunk_size);
+	  return c;
+	}
+    }
+  return 0;
+}
+
 static svm_fifo_chunk_t *
 fsh_try_alloc_chunk (fifo_segment_header_t * fsh,
 		     fifo_segment_slice_t * fss, u32 data_bytes)
@@ -712,6 +747,9 @@ free_list:
 
 done:
 
+  if (!c && fsh->n_slices > 1)
+    c = fsh_try_steal_chunk (fsh, fss, fl_index);
+
   return c;
 }
 
@@ -150,6 +150,8 @@ svm_msg_q_attach (svm_msg_q_t *mq, void *smq_base)
   smq = (svm_msg_q_shared_t *) smq_base;
   mq->q.shr = smq->q;
   mq->q.evtfd = -1;
+  mq->q.n_burst = 0;
+  mq->in_burst = 0;
   n_rings = smq->n_rings;
   vec_validate (mq->rings, n_rings - 1);
   q_sz = sizeof (svm_msg_q_shared_queue_t) +
@@ -160,6 +162,7 @@ svm_msg_q_attach (svm_msg_q_t *mq, void *smq_base)
       mq->rings[i].nitems = ring->nitems;
       mq->rings[i].elsize = ring->elsize;
       mq->rings[i].shr = ring;
+      mq->rings[i].n_burst = 0;
       offset = sizeof (*ring) + ring->nitems * ring->elsize;
       ring = (void *) ((u8 *) ring + offset);
     }
@@ -211,6 +214,16 @@ svm_msg_q_send_signal (svm_msg_q_t *mq, u8 is_consumer)
       if (mq->q.evtfd < 0)
 	return;
 
+      /* a polling consumer finds the message without a wakeup. Order the
+	 size update before the check, paired with the consumer's
+	 svm_msg_q_set_consumer_polling */
+      if (!is_consumer)
+	{
+	  CLIB_MEMORY_BARRIER ();
+	  if (clib_atomic_load_relax_n (&mq->q.shr->consumer_polling))
+	    return;
+	}
+
       rv = write (mq->q.evtfd, &data, sizeof (data));
       if (PREDICT_FALSE (rv < 0))
 	clib_unix_warning ("signal write on %d returned %d", mq->q.evtfd, rv);
@@ -227,11 +240,14 @@ svm_msg_q_alloc_msg_w_ring (svm_msg_q_t * mq, u32 ring_index)
   ring = svm_msg_q_ring_inline (mq, ring_index);
   sr = ring->shr;
 
-  ASSERT (sr->cursize < ring->nitems);
+  ASSERT (sr->cursize + ring->n_burst < ring->nitems);
   msg.ring_index = ring - mq->rings;
   msg.elt_index = sr->tail;
   sr->tail = (sr->tail + 1) % ring->nitems;
-  clib_atomic_fetch_add_rel (&sr->cursize, 1);
+  if (PREDICT_FALSE (mq->in_burst))
+    ring->n_burst++;
+  else
+    clib_atomic_fetch_add_rel (&sr->cursize, 1);
   return msg;
 }
 
@@ -270,12 +286,15 @@ svm_msg_q_alloc_msg (svm_msg_q_t * mq, u32 nbytes)
   vec_foreach (ring, mq->rings)
   {
     sr = ring->shr;
-    if (ring->elsize < nbytes || sr->cursize == ring->nitems)
+    if (ring->elsize < nbytes || sr->cursize + ring->n_burst == ring->nitems)
       continue;
     msg.ring_index = ring - mq->rings;
     msg.elt_index = sr->tail;
     sr->tail = (sr->tail + 1) % ring->nitems;
-    clib_atomic_fetch_add_relax (&sr->cursize, 1);
+    if (PREDICT_FALSE (mq->in_burst))
+      ring->n_burst++;
+    else
+      clib_atomic_fetch_add_relax (&sr->cursize, 1);
     break;
   }
   return msg;
@@ -352,11 +371,51 @@ svm_msg_q_add_raw (svm_msg_q_t *mq, svm_msg_q_msg_t *msg)
 
   sq->tail = (sq->tail + 1) % sq->maxsize;
 
+  if (PREDICT_FALSE (mq->in_burst))
+    {
+      mq->q.n_burst++;
+      return;
+    }
+
   sz = clib_atomic_fetch_add_rel (&sq->cursize, 1);
   if (!sz)
     svm_msg_q_send_signal (mq, 0 /* is consumer */);
 }
 
+void
+svm_msg_q_burst_start (svm_msg_q_t *mq)
+{
+  ASSERT (!mq->in_burst);
+  mq->in_burst = 1;
+}
+
+void
+svm_msg_q_burst_end (svm_msg_q_t *mq)
+{
+  svm_msg_q_ring_t *ring;
+  u32 sz;
+
+  mq->in_burst = 0;
+
+  /* rings first, the consumer frees messages only after seeing them in
+     the queue */
+  vec_foreach (ring, mq->rings)
+    {
+      if (!ring->n_burst)
+	continue;
+      clib_atomic_fetch_add_rel (&ring->shr->cursize, ring->n_burst);
+      ring->n_burst = 0;
+    }
+
+  if (!mq->q.n_burst)
+    return;
+
+  sz = clib_atomic_fetch_add_rel (&mq->q.shr->cursize, mq->q.n_burst);
+  mq->q.n_burst = 0;
+  if (!sz)
+    svm_msg_q_send_signal (mq, 0 /* is consumer */);
+}
+
 int
 svm_msg_q_add (svm_msg_q_t * mq, svm_msg_q_msg_t * msg, int nowait)
 {
@@ -34,7 +34,7 @@ typedef struct svm_msg_q_shr_queue_
   volatile u32 cursize;
   u32 maxsize;
   u32 elsize;
-  u32 pad;
+  volatile u32 consumer_polling; /* consumer busy polls, no need to signal */
   u8 data[0];
 } svm_msg_q_shared_queue_t;
 
@@ -43,6 +43,7 @@ typedef struct svm_msg_q_queue_
   svm_msg_q_shared_queue_t *shr; /**< pointer to shared queue */
   int evtfd;			 /**< producer/consumer eventfd */
   clib_spinlock_t lock;		 /**< private lock for multi-producer */
+  u32 n_burst;			 /**< msgs added but not yet published */
 } svm_msg_q_queue_t;
 
 typedef struct svm_msg_q_ring_shared_
@@ -60,6 +61,7 @@ typedef struct svm_msg_q_ring_
   u32 nitems;			/**< max size of the ring */
   u32 elsize;			/**< size of an element */
   svm_msg_q_ring_shared_t *shr; /**< ring in shared memory */
+  u32 n_burst;			/**< msgs allocated but not yet published */
 } __clib_packed svm_msg_q_ring_t;
 
 typedef struct svm_msg_q_shared_
@@ -73,6 +75,7 @@ typedef struct svm_msg_q_
 {
   svm_msg_q_queue_t q;			/**< queue for exchanging messages */
   svm_msg_q_ring_t *rings;		/**< rings with message data*/
+  u8 in_burst;				/**< msgs published at burst end */
 } __clib_packed svm_msg_q_t;
 
 typedef struct svm_msg_q_ring_cfg_
@@ -201,6 +204,26 @@ void svm_msg_q_free_msg (svm_msg_q_t * mq, svm_msg_q_msg_t * msg);
  */
 void svm_msg_q_add_raw (svm_msg_q_t *mq, svm_msg_q_msg_t *msg);
 
+/**
+ * Start a burst of messages
+ *
+ * Messages allocated and added until @ref svm_msg_q_burst_end are written
+ * to the queue, but only made visible to the consumer at the end of the
+ * burst, with one update of the queue and of each ring's size. Must be
+ * called with mq locked, and the producer must not wait for room in the
+ * queue until the burst ends.
+ *
+ * @param mq		message queue
+ */
+void svm_msg_q_burst_start (svm_msg_q_t *mq);
+
+/**
+ * Publish the messages added since @ref svm_msg_q_burst_start
+ *
+ * @param mq		message queue
+ */
+void svm_msg_q_burst_end (svm_msg_q_t *mq);
+
 /**
  * Producer enqueue one message to queue
  *
@@ -309,6 +332,24 @@ void svm_msg_q_set_eventfd (svm_msg_q_t *mq, int fd);
  */
 int svm_msg_q_alloc_eventfd (svm_msg_q_t *mq);
 
+/**
+ * Advertise that the consumer is, or stops, busy polling the queue
+ *
+ * While the consumer polls, producers do not signal the eventfd. After
+ * it stops, the consumer must check the queue again before waiting on the
+ * eventfd, as messages added in between were not signaled.
+ *
+ * @param mq		message queue
+ * @param is_polling	1 if the consumer starts polling, 0 if it stops
+ */
+static inline void
+svm_msg_q_set_consumer_polling (svm_msg_q_t *mq, u8 is_polling)
+{
+  clib_atomic_store_seq_cst (&mq->q.shr->consumer_polling, is_polling);
+  /* order against the next check of the queue's size */
+  CLIB_MEMORY_BARRIER ();
+}
+
 /**
  * Format message queue, shows msg count for each ring
  */
@@ -329,14 +370,15 @@ svm_msg_q_size (svm_msg_q_t *mq)
 static inline u8
 svm_msg_q_is_full (svm_msg_q_t * mq)
 {
-  return (svm_msg_q_size (mq) == mq->q.shr->maxsize);
+  return (svm_msg_q_size (mq) + mq->q.n_burst >= mq->q.shr->maxsize);
 }
 
 static inline u8
 svm_msg_q_ring_is_full (svm_msg_q_t * mq, u32 ring_index)
 {
   svm_msg_q_ring_t *ring = vec_elt_at_index (mq->rings, ring_index);
-  return (clib_atomic_load_relax_n (&ring->shr->cursize) >= ring->nitems);
+  return (clib_atomic_load_relax_n (&ring->shr->cursize) + ring->n_burst >=
+	  ring->nitems);
 }
 
 static inline u8
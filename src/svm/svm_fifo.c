@@ -37,12 +37,12 @@ CLIB_MARCH_FN (svm_fifo_copy_to_chunk, void, svm_fifo_t *f,
   if (n_chunk <= len)
     {
       u32 to_copy = len;
-      clib_memcpy_fast (&c->data[tail_idx], src, n_chunk);
+      clib_memcpy_large (&c->data[tail_idx], src, n_chunk);
       c = f_cptr (f, c->next);
       while ((to_copy -= n_chunk))
 	{
 	  n_chunk = clib_min (c->length, to_copy);
-	  clib_memcpy_fast (&c->data[0], src + (len - to_copy), n_chunk);
+	  clib_memcpy_large (&c->data[0], src + (len - to_copy), n_chunk);
 	  c = c->length <= to_copy ? f_cptr (f, c->next) : c;
 	}
       if (*last)
@@ -50,7 +50,7 @@ CLIB_MARCH_FN (svm_fifo_copy_to_chunk, void, svm_fifo_t *f,
     }
   else
     {
-      clib_memcpy_fast (&c->data[tail_idx], src, len);
+      clib_memcpy_large (&c->data[tail_idx], src, len);
     }
 }
 
@@ -68,14 +68,14 @@ CLIB_MARCH_FN (svm_fifo_copy_from_chunk, void, svm_fifo_t *f,
   if (n_chunk <= len)
     {
       u32 to_copy = len;
-      clib_memcpy_fast (dst, &c->data[head_idx], n_chunk);
+      clib_memcpy_large (dst, &c->data[head_idx], n_chunk);
       c = f_cptr (f, c->next);
       while ((to_copy -= n_chunk))
 	{
 	  clib_mem_unpoison (c, sizeof (*c));
 	  clib_mem_unpoison (c->data, c->length);
 	  n_chunk = clib_min (c->length, to_copy);
-	  clib_memcpy_fast (dst + (len - to_copy), &c->data[0], n_chunk);
+	  clib_memcpy_large (dst + (len - to_copy), &c->data[0], n_chunk);
 	  c = c->length <= to_copy ? f_cptr (f, c->next) : c;
 	}
       if (*last)
@@ -83,7 +83,7 @@ CLIB_MARCH_FN (svm_fifo_copy_from_chunk, void, svm_fifo_t *f,
     }
   else
     {
-      clib_memcpy_fast (dst, &c->data[head_idx], len);
+      clib_memcpy_large (dst, &c->data[head_idx], len);
     }
 }
 
@@ -225,7 +225,7 @@ vppcom_cfg_read_file (char *conf_fname)
   unformat_input_t _line_input, *line_input = &_line_input;
   u8 vc_cfg_input = 0;
   struct stat s;
-  u32 uid, gid;
+  u32 uid, gid, poll_us;
 
   fd = open (conf_fname, O_RDONLY);
   if (fd < 0)
@@ -452,6 +452,12 @@ vppcom_cfg_read_file (char *conf_fname)
 	      VCFG_DBG (0, "VCL<%d>: configured with mq with eventfd",
 			getpid ());
 	    }
+	  else if (unformat (line_input, "mq-poll-time %u", &poll_us))
+	    {
+	      vcl_cfg->mq_poll_time = (f64) poll_us / 1e6;
+	      VCFG_DBG (0, "VCL<%d>: configured mq-poll-time %u us",
+			getpid (), poll_us);
+	    }
 	  else if (unformat (line_input, "tls-engine %u",
 			     &vcl_cfg->tls_engine))
 	    {
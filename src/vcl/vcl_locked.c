@@ -127,7 +127,7 @@ typedef struct vls_worker_
 {
   clib_rwlock_t sh_to_vlsh_table_lock; /**< ht rwlock with mt workers */
   vcl_locked_session_t *vls_pool;      /**< pool of vls session */
-  uword *sh_to_vlsh_table;	       /**< map from vcl sh to vls sh */
+  u32 **sh_to_vlsh_table;	       /**< vls sh by vcl wrk and session */
   u32 *pending_vcl_wrk_cleanup;	       /**< child vcl wrks to cleanup */
   u32 vcl_wrk_index;		       /**< if 1:1 map vls to vcl wrk */
 } vls_worker_t;
@@ -435,7 +435,11 @@ vls_worker_alloc (void)
 static void
 vls_worker_free (vls_worker_t * wrk)
 {
-  hash_free (wrk->sh_to_vlsh_table);
+  u32 i;
+
+  for (i = 0; i < vec_len (wrk->sh_to_vlsh_table); i++)
+    vec_free (wrk->sh_to_vlsh_table[i]);
+  vec_free (wrk->sh_to_vlsh_table);
   if (vls_mt_wrk_supported ())
     clib_rwlock_free (&wrk->sh_to_vlsh_table_lock);
   pool_free (wrk->vls_pool);
@@ -453,9 +457,15 @@ vls_worker_get (u32 wrk_index)
 static void
 vls_sh_to_vlsh_table_add (vls_worker_t *wrk, vcl_session_handle_t sh, u32 vlsh)
 {
+  u32 wrk_index, session_index;
+
+  vcl_session_handle_parse (sh, &wrk_index, &session_index);
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_lock (&wrk->sh_to_vlsh_table_lock);
-  hash_set (wrk->sh_to_vlsh_table, sh, vlsh);
+  vec_validate (wrk->sh_to_vlsh_table, wrk_index);
+  vec_validate_init_empty (wrk->sh_to_vlsh_table[wrk_index], session_index,
+			   VLS_INVALID_HANDLE);
+  wrk->sh_to_vlsh_table[wrk_index][session_index] = vlsh;
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_unlock (&wrk->sh_to_vlsh_table_lock);
 }
@@ -463,22 +473,33 @@ vls_sh_to_vlsh_table_add (vls_worker_t *wrk, vcl_session_handle_t sh, u32 vlsh)
 static void
 vls_sh_to_vlsh_table_del (vls_worker_t *wrk, vcl_session_handle_t sh)
 {
+  u32 wrk_index, session_index;
+
+  vcl_session_handle_parse (sh, &wrk_index, &session_index);
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_lock (&wrk->sh_to_vlsh_table_lock);
-  hash_unset (wrk->sh_to_vlsh_table, sh);
+  if (wrk_index < vec_len (wrk->sh_to_vlsh_table) &&
+      session_index < vec_len (wrk->sh_to_vlsh_table[wrk_index]))
+    wrk->sh_to_vlsh_table[wrk_index][session_index] = VLS_INVALID_HANDLE;
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_unlock (&wrk->sh_to_vlsh_table_lock);
 }
 
-static uword *
+static vls_handle_t
 vls_sh_to_vlsh_table_get (vls_worker_t *wrk, vcl_session_handle_t sh)
 {
+  vls_handle_t vlsh = VLS_INVALID_HANDLE;
+  u32 wrk_index, session_index;
+
+  vcl_session_handle_parse (sh, &wrk_index, &session_index);
   if (vls_mt_wrk_supported ())
     clib_rwlock_reader_lock (&wrk->sh_to_vlsh_table_lock);
-  uword *vlshp = hash_get (wrk->sh_to_vlsh_table, sh);
+  if (wrk_index < vec_len (wrk->sh_to_vlsh_table) &&
+      session_index < vec_len (wrk->sh_to_vlsh_table[wrk_index]))
+    vlsh = wrk->sh_to_vlsh_table[wrk_index][session_index];
   if (vls_mt_wrk_supported ())
     clib_rwlock_reader_unlock (&wrk->sh_to_vlsh_table_lock);
-  return vlshp;
+  return vlsh;
 }
 
 static vls_handle_t
@@ -620,11 +641,9 @@ vls_handle_t
 vls_si_wi_to_vlsh (u32 session_index, u32 vcl_wrk_index)
 {
   vls_worker_t *wrk = vls_worker_get_current ();
-  uword *vlshp = vls_sh_to_vlsh_table_get (
+  return vls_sh_to_vlsh_table_get (
     wrk,
     vcl_session_handle_from_wrk_session_index (session_index, vcl_wrk_index));
-
-  return vlshp ? *vlshp : VLS_INVALID_HANDLE;
 }
 
 vls_handle_t
@@ -981,20 +1000,25 @@ vls_worker_copy_on_fork (vcl_worker_t * parent_wrk)
    */
   vcl_wrk->sessions = pool_dup (parent_wrk->sessions);
   vcl_wrk->session_index_by_vpp_handles =
-    hash_dup (parent_wrk->session_index_by_vpp_handles);
+    vcl_session_table_dup (parent_wrk->session_index_by_vpp_handles);
 
   /*
    * init vls worker
    */
   vls_parent_wrk = vls_worker_get (parent_wrk->wrk_index);
 
-  /* clang-format off */
-  hash_foreach (sh, vls_index, vls_parent_wrk->sh_to_vlsh_table, ({
-    vcl_session_handle_parse (sh, &wrk_index, &session_index);
-    hash_set (vls_wrk->sh_to_vlsh_table,
-              vcl_session_handle_from_index (session_index), vls_index);
-  }));
-  /* clang-format on */
+  vec_foreach_index (wrk_index, vls_parent_wrk->sh_to_vlsh_table)
+    {
+      u32 *vlshs = vls_parent_wrk->sh_to_vlsh_table[wrk_index];
+      vec_foreach_index (session_index, vlshs)
+	{
+	  vls_index = vlshs[session_index];
+	  if (vls_index == VLS_INVALID_HANDLE)
+	    continue;
+	  sh = vcl_session_handle_from_index (session_index);
+	  vls_sh_to_vlsh_table_add (vls_wrk, sh, vls_index);
+	}
+    }
   vls_wrk->vls_pool = pool_dup (vls_parent_wrk->vls_pool);
 
   /*
@@ -2093,7 +2117,7 @@ vls_mt_mq_wait_lock (vcl_session_handle_t vcl_sh)
 {
   vcl_locked_session_t *vls;
   vls_worker_t *wrk;
-  uword *vlshp;
+  vls_handle_t vlsh;
 
   /* If mt wrk supported or single threaded just return */
   if (vls_mt_wrk_supported () || (vlsl->vls_mt_n_threads <= 1))
@@ -2103,10 +2127,10 @@ vls_mt_mq_wait_lock (vcl_session_handle_t vcl_sh)
   /* Expect current thread to have dropped lock before calling vcl */
   vls_mt_pool_rlock ();
 
-  vlshp = vls_sh_to_vlsh_table_get (wrk, vcl_sh);
-  if (vlshp)
+  vlsh = vls_sh_to_vlsh_table_get (wrk, vcl_sh);
+  if (vlsh != VLS_INVALID_HANDLE)
     {
-      vls = vls_get (*vlshp);
+      vls = vls_get (vlsh);
       /* Handle case here other threads might've closed the session */
       if (vls->flags & VLS_F_APP_CLOSED)
 	{
@@ -160,7 +160,7 @@ vcl_worker_cleanup (vcl_worker_t * wrk, u8 notify_vpp)
     close (wrk->mqs_epfd);
   pool_free (wrk->sessions);
   pool_free (wrk->mq_evt_conns);
-  hash_free (wrk->session_index_by_vpp_handles);
+  vcl_session_table_free (wrk);
   vec_free (wrk->mq_events);
   vec_free (wrk->mq_msg_vector);
   vec_free (wrk->unhandled_evts_vector);
@@ -343,7 +343,6 @@ vcl_worker_alloc_and_init ()
     }
 
   wrk->ep_lt_current = VCL_INVALID_SESSION_INDEX;
-  wrk->session_index_by_vpp_handles = hash_create (0, sizeof (uword));
   clib_time_init (&wrk->clib_time);
   vec_validate (wrk->mq_events, 64);
   vec_validate (wrk->mq_msg_vector, 128);
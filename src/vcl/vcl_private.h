@@ -211,6 +211,7 @@ typedef struct vppcom_cfg_t_
   u8 *namespace_id;
   u64 namespace_secret;
   u8 use_mq_eventfd;
+  f64 mq_poll_time;	/**< busy poll mqs before waiting on eventfds */
   f64 app_timeout;
   f64 session_timeout;
   char *event_log_path;
@@ -277,8 +278,9 @@ typedef struct vcl_worker_
   /** Next session to be lt polled */
   u32 ep_lt_current;
 
-  /** Hash table for disconnect processing */
-  uword *session_index_by_vpp_handles;
+  /** Session index by vpp handle, indexed by vpp thread and vpp session
+   *  index. Avoids hashing on the control event path */
+  u32 **session_index_by_vpp_handles;
 
   /** Select bitmaps */
   clib_bitmap_t *rd_bitmap;
@@ -473,53 +475,86 @@ vcl_session_get_w_handle (vcl_worker_t * wrk, u32 session_handle)
   return vcl_session_get (wrk, session_index);
 }
 
-static inline vcl_session_t *
-vcl_session_get_w_vpp_handle (vcl_worker_t * wrk, u64 vpp_handle)
+static inline u32
+vcl_session_index_from_vpp_handle (vcl_worker_t * wrk, u64 vpp_handle)
 {
-  uword *p;
-  if ((p = hash_get (wrk->session_index_by_vpp_handles, vpp_handle)))
-    return vcl_session_get (wrk, (u32) p[0]);
-  return 0;
+  u32 thread_index = vpp_handle >> 32, session_index = (u32) vpp_handle;
+  u32 *indices;
+
+  if (thread_index >= vec_len (wrk->session_index_by_vpp_handles))
+    return VCL_INVALID_SESSION_INDEX;
+  indices = wrk->session_index_by_vpp_handles[thread_index];
+  if (session_index >= vec_len (indices))
+    return VCL_INVALID_SESSION_INDEX;
+  return indices[session_index];
 }
 
-static inline u32
-vcl_session_index_from_vpp_handle (vcl_worker_t * wrk, u64 vpp_handle)
+static inline vcl_session_t *
+vcl_session_get_w_vpp_handle (vcl_worker_t * wrk, u64 vpp_handle)
 {
-  uword *p;
-  if ((p = hash_get (wrk->session_index_by_vpp_handles, vpp_handle)))
-    return p[0];
-  return VCL_INVALID_SESSION_INDEX;
+  u32 session_index = vcl_session_index_from_vpp_handle (wrk, vpp_handle);
+  if (session_index == VCL_INVALID_SESSION_INDEX)
+    return 0;
+  return vcl_session_get (wrk, session_index);
 }
 
 static inline void
 vcl_session_table_add_vpp_handle (vcl_worker_t * wrk, u64 handle, u32 value)
 {
-  hash_set (wrk->session_index_by_vpp_handles, handle, value);
+  u32 thread_index = handle >> 32, session_index = (u32) handle;
+
+  vec_validate (wrk->session_index_by_vpp_handles, thread_index);
+  vec_validate_init_empty (wrk->session_index_by_vpp_handles[thread_index],
+			   session_index, VCL_INVALID_SESSION_INDEX);
+  wrk->session_index_by_vpp_handles[thread_index][session_index] = value;
 }
 
 static inline void
 vcl_session_table_del_vpp_handle (vcl_worker_t * wrk, u64 vpp_handle)
 {
-  hash_unset (wrk->session_index_by_vpp_handles, vpp_handle);
-}
+  u32 thread_index = vpp_handle >> 32, session_index = (u32) vpp_handle;
 
-static inline uword *
-vcl_session_table_lookup_vpp_handle (vcl_worker_t * wrk, u64 handle)
-{
-  return hash_get (wrk->session_index_by_vpp_handles, handle);
+  if (thread_index >= vec_len (wrk->session_index_by_vpp_handles))
+    return;
+  if (session_index >=
+      vec_len (wrk->session_index_by_vpp_handles[thread_index]))
+    return;
+  wrk->session_index_by_vpp_handles[thread_index][session_index] =
+    VCL_INVALID_SESSION_INDEX;
 }
 
 static inline void
 vcl_session_table_add_listener (vcl_worker_t * wrk, u64 listener_handle,
 				u32 value)
 {
-  hash_set (wrk->session_index_by_vpp_handles, listener_handle, value);
+  vcl_session_table_add_vpp_handle (wrk, listener_handle, value);
 }
 
 static inline void
 vcl_session_table_del_listener (vcl_worker_t * wrk, u64 listener_handle)
 {
-  hash_unset (wrk->session_index_by_vpp_handles, listener_handle);
+  vcl_session_table_del_vpp_handle (wrk, listener_handle);
+}
+
+static inline u32 **
+vcl_session_table_dup (u32 **table)
+{
+  u32 **dup = vec_dup (table);
+  u32 i;
+
+  for (i = 0; i < vec_len (dup); i++)
+    dup[i] = vec_dup (table[i]);
+  return dup;
+}
+
+static inline void
+vcl_session_table_free (vcl_worker_t * wrk)
+{
+  u32 i;
+
+  for (i = 0; i < vec_len (wrk->session_index_by_vpp_handles); i++)
+    vec_free (wrk->session_index_by_vpp_handles[i]);
+  vec_free (wrk->session_index_by_vpp_handles);
 }
 
 static inline int
@@ -545,20 +580,20 @@ vcl_session_is_connectable_listener (vcl_worker_t * wrk,
 static inline vcl_session_t *
 vcl_session_table_lookup_listener (vcl_worker_t * wrk, u64 handle)
 {
-  uword *p;
   vcl_session_t *s;
+  u32 session_index;
 
-  p = hash_get (wrk->session_index_by_vpp_handles, handle);
-  if (!p)
+  session_index = vcl_session_index_from_vpp_handle (wrk, handle);
+  if (session_index == VCL_INVALID_SESSION_INDEX)
     {
       VDBG (0, "could not find listen session: unknown vpp listener handle"
 	    " %llx", handle);
       return 0;
     }
-  s = vcl_session_get (wrk, p[0]);
+  s = vcl_session_get (wrk, session_index);
   if (!s)
     {
-      VDBG (1, "invalid listen session index (%u)", p[0]);
+      VDBG (1, "invalid listen session index (%u)", session_index);
       return 0;
     }
 
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Submission/completion rings for session ops
+ *
+ * The app fills submission entries and vcl runs them against the session
+ * fifos it already shares with vpp, retrying the ones that would block on
+ * every following submit/wait. Neither ring is shared with other threads,
+ * so the indices are plain counters that wrap.
+ */
+
+#include <vcl/vcl_private.h>
+
+struct vppcom_ring_
+{
+  /** Worker that owns the ring */
+  u32 wrk_index;
+
+  /** Ring size - 1 */
+  u32 mask;
+
+  /** Submission ring, app produces at tail, vcl consumes at head */
+  u32 sq_head;
+  u32 sq_tail;
+  vppcom_ring_sqe_t *sqes;
+
+  /** Completion ring, vcl produces at tail, app consumes at head */
+  u32 cq_head;
+  u32 cq_tail;
+  vppcom_ring_cqe_t *cqes;
+
+  /** Consumed ops that would have blocked, in submission order */
+  vppcom_ring_sqe_t *pending;
+
+  /** Sessions with an op still pending in the current pass */
+  uword *blocked_sessions;
+};
+
+vppcom_ring_t *
+vppcom_ring_create (uint32_t n_entries)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vppcom_ring_t *r;
+
+  if (!n_entries || n_entries > (1 << 16))
+    return 0;
+
+  n_entries = max_pow2 (n_entries);
+  r = clib_mem_alloc (sizeof (*r));
+  clib_memset (r, 0, sizeof (*r));
+  r->wrk_index = wrk->wrk_index;
+  r->mask = n_entries - 1;
+  vec_validate (r->sqes, r->mask);
+  vec_validate (r->cqes, r->mask);
+
+  return r;
+}
+
+void
+vppcom_ring_free (vppcom_ring_t *r)
+{
+  if (!r)
+    return;
+
+  vec_free (r->sqes);
+  vec_free (r->cqes);
+  vec_free (r->pending);
+  clib_bitmap_free (r->blocked_sessions);
+  clib_mem_free (r);
+}
+
+vppcom_ring_sqe_t *
+vppcom_ring_get_sqe (vppcom_ring_t *r)
+{
+  vppcom_ring_sqe_t *sqe;
+
+  /* Every sqe becomes a cqe, so bounding the ops not yet reaped also
+   * keeps the completion ring from overflowing */
+  if (r->sq_tail - r->cq_head > r->mask)
+    return 0;
+
+  sqe = &r->sqes[r->sq_tail & r->mask];
+  r->sq_tail += 1;
+
+  return sqe;
+}
+
+static inline void
+vcl_ring_complete (vppcom_ring_t *r, vppcom_ring_sqe_t *sqe, int result)
+{
+  vppcom_ring_cqe_t *cqe;
+
+  cqe = &r->cqes[r->cq_tail & r->mask];
+  cqe->user_data = sqe->user_data;
+  cqe->result = result;
+  r->cq_tail += 1;
+}
+
+/**
+ * Run an op if it can complete without blocking. Returns 1 and the op's
+ * result if it completed, 0 if it must be retried.
+ */
+static int
+vcl_ring_try_op (vcl_worker_t *wrk, vppcom_ring_sqe_t *sqe, int *result)
+{
+  vcl_session_t *s;
+  int rv;
+
+  s = vcl_session_get_w_handle (wrk, sqe->session_handle);
+  if (PREDICT_FALSE (!s))
+    {
+      *result = VPPCOM_EBADFD;
+      return 1;
+    }
+
+  switch (sqe->op)
+    {
+    case VPPCOM_RING_OP_READ:
+      rv = vcl_session_read_ready (s);
+      if (rv < 0)
+	break;
+      /* Closing sessions return what's left, and then 0 */
+      if (!rv && !vcl_session_is_closing (s))
+	return 0;
+      rv = vppcom_session_read (sqe->session_handle, sqe->buf, sqe->len);
+      if (rv == VPPCOM_EAGAIN)
+	return 0;
+      break;
+    case VPPCOM_RING_OP_WRITE:
+      rv = vcl_session_write_ready (s);
+      if (rv < 0)
+	break;
+      if (!rv)
+	{
+	  vcl_session_add_want_deq_ntf (s, SVM_FIFO_WANT_DEQ_NOTIF);
+	  return 0;
+	}
+      rv = vppcom_session_write (sqe->session_handle, sqe->buf, sqe->len);
+      if (rv == VPPCOM_EAGAIN)
+	return 0;
+      break;
+    case VPPCOM_RING_OP_ACCEPT:
+      if (s->session_state == VCL_STATE_LISTEN &&
+	  !clib_fifo_elts (s->accept_evts_fifo))
+	return 0;
+      rv = vppcom_session_accept (sqe->session_handle, sqe->buf, 0);
+      if (rv == VPPCOM_EAGAIN)
+	return 0;
+      break;
+    default:
+      rv = VPPCOM_EINVAL;
+      break;
+    }
+
+  *result = rv;
+  return 1;
+}
+
+/**
+ * Try an op unless an earlier op on its session is still pending. Returns
+ * 1 if the op completed.
+ */
+static inline int
+vcl_ring_run_op (vppcom_ring_t *r, vcl_worker_t *wrk, vppcom_ring_sqe_t *sqe)
+{
+  u32 si = vppcom_session_index (sqe->session_handle);
+  int result;
+
+  if (clib_bitmap_get (r->blocked_sessions, si))
+    return 0;
+
+  if (vcl_ring_try_op (wrk, sqe, &result))
+    {
+      vcl_ring_complete (r, sqe, result);
+      return 1;
+    }
+
+  r->blocked_sessions = clib_bitmap_set (r->blocked_sessions, si, 1);
+  return 0;
+}
+
+static int
+vcl_ring_run (vppcom_ring_t *r)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vppcom_ring_sqe_t *sqe;
+  u32 i, n_left;
+
+  if (PREDICT_FALSE (r->wrk_index != wrk->wrk_index))
+    return VPPCOM_EINVAL;
+
+  if (!svm_msg_q_is_empty (wrk->app_event_queue))
+    vcl_flush_mq_events ();
+
+  /* Retry pending ops first, they were submitted earlier */
+  n_left = 0;
+  for (i = 0; i < vec_len (r->pending); i++)
+    {
+      sqe = vec_elt_at_index (r->pending, i);
+      if (!vcl_ring_run_op (r, wrk, sqe))
+	r->pending[n_left++] = *sqe;
+    }
+  vec_set_len (r->pending, n_left);
+
+  while (r->sq_head != r->sq_tail)
+    {
+      sqe = &r->sqes[r->sq_head & r->mask];
+      if (!vcl_ring_run_op (r, wrk, sqe))
+	vec_add1 (r->pending, *sqe);
+      r->sq_head += 1;
+    }
+
+  clib_bitmap_zero (r->blocked_sessions);
+
+  return r->cq_tail - r->cq_head;
+}
+
+int
+vppcom_ring_submit (vppcom_ring_t *r)
+{
+  return vcl_ring_run (r);
+}
+
+int
+vppcom_ring_wait (vppcom_ring_t *r, uint32_t min_complete,
+		  double wait_for_time)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  f64 timeout = 0;
+  int n_cqes;
+
+  /* Can't wait for more ops than were submitted */
+  min_complete = clib_min (min_complete, r->sq_tail - r->cq_head);
+
+  if (wait_for_time > 0)
+    timeout = clib_time_now (&wrk->clib_time) + wait_for_time;
+
+  while (1)
+    {
+      n_cqes = vcl_ring_run (r);
+      if (n_cqes < 0 || n_cqes >= min_complete)
+	return n_cqes;
+      if (wait_for_time == 0 ||
+	  (wait_for_time > 0 && clib_time_now (&wrk->clib_time) >= timeout))
+	return n_cqes;
+      /* Short sleeps, ops that wait for tx space are also retried without
+       * a notification */
+      if (svm_msg_q_is_empty (wrk->app_event_queue))
+	svm_msg_q_timedwait (wrk->app_event_queue, 1e-3);
+    }
+
+  return n_cqes;
+}
+
+int
+vppcom_ring_reap (vppcom_ring_t *r, vppcom_ring_cqe_t *cqes,
+		  uint32_t max_cqes)
+{
+  u32 i, n_cqes;
+
+  n_cqes = clib_min (r->cq_tail - r->cq_head, max_cqes);
+  for (i = 0; i < n_cqes; i++)
+    cqes[i] = r->cqes[(r->cq_head + i) & r->mask];
+  r->cq_head += n_cqes;
+
+  return n_cqes;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
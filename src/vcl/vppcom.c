@@ -3567,6 +3567,67 @@ vppcom_epoll_wait_condvar (vcl_worker_t *wrk, struct epoll_event *events,
   return 0;
 }
 
+static void
+vcl_mqs_set_consumer_polling (vcl_worker_t *wrk, u8 is_polling)
+{
+  vcl_mq_evt_conn_t *mqc;
+
+  pool_foreach (mqc, wrk->mq_evt_conns)
+    {
+      if (mqc->mq)
+	svm_msg_q_set_consumer_polling (mqc->mq, is_polling);
+    }
+}
+
+static void
+vcl_mqs_poll (vcl_worker_t *wrk, struct epoll_event *events, int maxevents,
+	      u32 *n_evts)
+{
+  vcl_mq_evt_conn_t *mqc;
+  u32 i;
+
+  /* handling events may add mqs and move the pool */
+  for (i = 0; i < vec_len (wrk->mq_evt_conns); i++)
+    {
+      if (pool_is_free_index (wrk->mq_evt_conns, i))
+	continue;
+      mqc = pool_elt_at_index (wrk->mq_evt_conns, i);
+      if (mqc->mq && !svm_msg_q_is_empty (mqc->mq))
+	vcl_epoll_wait_handle_mq (wrk, mqc->mq, events, maxevents, 0, n_evts);
+    }
+}
+
+/* Busy poll the worker's mqs, for at most the configured mq-poll-time,
+ * before waiting on their eventfds. Vpp does not write the eventfds of
+ * mqs whose consumer is polling, which saves a syscall on either side
+ * per wakeup. */
+static u32
+vcl_epoll_wait_poll_mqs (vcl_worker_t *wrk, struct epoll_event *events,
+			 int maxevents, u32 n_evts, double timeout_ms)
+{
+  f64 end, poll_time = vcm->cfg.mq_poll_time;
+
+  if (timeout_ms > 0)
+    poll_time = clib_min (poll_time, timeout_ms / 1e3);
+  end = clib_time_now (&wrk->clib_time) + poll_time;
+
+  vcl_mqs_set_consumer_polling (wrk, 1);
+  do
+    {
+      vcl_mqs_poll (wrk, events, maxevents, &n_evts);
+      if (n_evts)
+	break;
+      CLIB_PAUSE ();
+    }
+  while (clib_time_now (&wrk->clib_time) < end);
+  vcl_mqs_set_consumer_polling (wrk, 0);
+
+  /* messages added before polling stopped were not signaled */
+  vcl_mqs_poll (wrk, events, maxevents, &n_evts);
+
+  return n_evts;
+}
+
 static int
 vppcom_epoll_wait_eventfd (vcl_worker_t *wrk, struct epoll_event *events,
 			   int maxevents, u32 n_evts, double timeout_ms)
@@ -3588,6 +3649,13 @@ vppcom_epoll_wait_eventfd (vcl_worker_t *wrk, struct epoll_event *events,
     {
       if (timeout_ms > 0)
 	end = clib_time_now (&wrk->clib_time) + (timeout_ms / 1e3);
+      if (timeout_ms && vcm->cfg.mq_poll_time > 0)
+	{
+	  n_evts = vcl_epoll_wait_poll_mqs (wrk, events, maxevents, n_evts,
+					    timeout_ms);
+	  if (n_evts)
+	    return n_evts;
+	}
     }
 
   do
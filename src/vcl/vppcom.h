@@ -207,6 +207,32 @@ typedef vppcom_data_segment_t vppcom_data_segments_t[2];
 
 typedef unsigned long vcl_si_set;
 
+typedef enum vppcom_ring_op_
+{
+  VPPCOM_RING_OP_READ,
+  VPPCOM_RING_OP_WRITE,
+  VPPCOM_RING_OP_ACCEPT,
+} vppcom_ring_op_t;
+
+/** Submission queue entry */
+typedef struct vppcom_ring_sqe_
+{
+  uint8_t op;			/**< vppcom_ring_op_t */
+  uint32_t session_handle;	/**< session, or listener for accepts */
+  void *buf;			/**< data, or vppcom_endpt_t for accepts */
+  uint32_t len;			/**< length of buf */
+  uint64_t user_data;		/**< returned in the completion */
+} vppcom_ring_sqe_t;
+
+/** Completion queue entry */
+typedef struct vppcom_ring_cqe_
+{
+  uint64_t user_data;		/**< user_data of the sqe */
+  int32_t result;		/**< as returned by the synchronous call */
+} vppcom_ring_cqe_t;
+
+typedef struct vppcom_ring_ vppcom_ring_t;
+
 /*
  * VPPCOM Public API Functions
  */
@@ -322,6 +348,51 @@ extern int vppcom_session_get_error (uint32_t session_handle);
  */
 extern int vppcom_worker_is_detached (void);
 
+/**
+ * Submission/completion rings
+ *
+ * Reads, writes and accepts are posted to the submission ring in batches
+ * and their results harvested from the completion ring, without a call per
+ * operation. Ops on the same session complete in submission order. A ring
+ * belongs to the worker that created it and takes no locks, so it must not
+ * be shared between threads.
+ */
+
+/**
+ * Create a ring pair with room for n_entries ops, rounded up to a power
+ * of 2. Returns 0 on failure.
+ */
+extern vppcom_ring_t *vppcom_ring_create (uint32_t n_entries);
+extern void vppcom_ring_free (vppcom_ring_t *r);
+
+/**
+ * Returns the next free submission entry, or 0 if the submission ring is
+ * full or completions for all entries are outstanding.
+ */
+extern vppcom_ring_sqe_t *vppcom_ring_get_sqe (vppcom_ring_t *r);
+
+/**
+ * Runs the submitted ops that can complete without blocking. Ops that
+ * cannot are retried on later calls. Returns the number of completions
+ * available.
+ */
+extern int vppcom_ring_submit (vppcom_ring_t *r);
+
+/**
+ * Like vppcom_ring_submit but waits, up to wait_for_time seconds, until
+ * at least min_complete completions are available. A negative
+ * wait_for_time waits forever.
+ */
+extern int vppcom_ring_wait (vppcom_ring_t *r, uint32_t min_complete,
+			     double wait_for_time);
+
+/**
+ * Copies up to max_cqes completions into cqes and releases them. Returns
+ * the number copied.
+ */
+extern int vppcom_ring_reap (vppcom_ring_t *r, vppcom_ring_cqe_t *cqes,
+			     uint32_t max_cqes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,10 @@ STATIC_ASSERT_FITS_IN (vlib_buffer_t, buffer_pool_index, 16);
 
 u16 __vlib_buffer_external_hdr_size = 0;
 
+#if VLIB_BUFFER_COLD_METADATA > 0
+vlib_buffer_cold_pool_t vlib_buffer_cold_pools[256];
+#endif
+
 uword
 vlib_buffer_length_in_chain_slow_path (vlib_main_t * vm,
 				       vlib_buffer_t * b_first)
@@ -73,7 +77,7 @@ vlib_buffer_length_in_chain_slow_path (vlib_main_t * vm,
       b = vlib_get_buffer (vm, b->next_buffer);
       l += b->current_length;
     }
-  b_first->total_length_not_including_first_buffer = l;
+  vlib_buffer_cold (b_first)->total_length_not_including_first_buffer = l;
   b_first->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
   return l + l_first;
 }
@@ -96,10 +100,11 @@ format_vlib_buffer_no_chain (u8 * s, va_list * args)
 
   if (b->flags & VLIB_BUFFER_NEXT_PRESENT)
     s = format (s, ", totlen-nifb %d",
-		b->total_length_not_including_first_buffer);
+		vlib_buffer_cold (b)->total_length_not_including_first_buffer);
 
   if (b->flags & VLIB_BUFFER_IS_TRACED)
-    s = format (s, ", trace handle 0x%x", b->trace_handle);
+    s =
+      format (s, ", trace handle 0x%x", vlib_buffer_cold (b)->trace_handle);
 
   if (a)
     s = format (s, "\n%U%v", format_white_space, indent, a);
@@ -545,6 +550,22 @@ vlib_buffer_pool_create (vlib_main_t *vm, u32 data_size, u32 physmem_map_index,
   alloc_size = vlib_buffer_alloc_size (bm->ext_hdr_size, data_size);
   bp->alloc_size = alloc_size;
 
+#if VLIB_BUFFER_COLD_METADATA > 0
+  {
+    vlib_buffer_cold_pool_t *cp = vlib_buffer_cold_pools + bp->index;
+    uword n_cold;
+
+    /* buffers are alloc_size apart, any smaller power of 2 stride gives
+     * each one its own slot */
+    cp->start = start;
+    cp->log2_stride = min_log2 (alloc_size);
+    n_cold = (size >> cp->log2_stride) + 1;
+    cp->cold = clib_mem_alloc_aligned (n_cold * sizeof (vlib_buffer_cold_t),
+				       CLIB_CACHE_LINE_BYTES);
+    clib_memset (cp->cold, 0, n_cold * sizeof (vlib_buffer_cold_t));
+  }
+#endif
+
   /* preallocate buffer indices memory */
   bp->buffers = clib_mem_alloc_aligned (
     round_pow2 ((size / alloc_size) * sizeof (u32), CLIB_CACHE_LINE_BYTES),
@@ -575,7 +596,8 @@ vlib_buffer_pool_create (vlib_main_t *vm, u32 data_size, u32 physmem_map_index,
 	continue;
 
       b = (vlib_buffer_t *) (p + bm->ext_hdr_size);
-      b->template = bp->buffer_template;
+      if (!bm->lazy_init)
+	b->template = bp->buffer_template;
       bi = vlib_get_buffer_index (vm, b);
       bp->buffers[bp->n_avail++] = bi;
       vlib_get_buffer (vm, bi);
@@ -583,31 +605,59 @@ vlib_buffer_pool_create (vlib_main_t *vm, u32 data_size, u32 physmem_map_index,
 
   bp->n_buffers = bp->n_avail;
 
+  /* with lazy-init the headers are written by the threads which first
+     take the buffers from the pool, see vlib_buffer_pool_get */
+  if (bm->lazy_init)
+    bp->n_unformatted = bp->n_avail;
+
+  /* enough magazines to hold every buffer, all empty to begin with */
+  vec_validate_aligned (bp->magazines,
+			bp->n_buffers / VLIB_BUFFER_MAGAZINE_SZ,
+			CLIB_CACHE_LINE_BYTES);
+  for (u32 i = 0; i < vec_len (bp->magazines); i++)
+    bp->magazines[i].next = i + 1 < vec_len (bp->magazines) ? i + 1 : ~0;
+  bp->empty_magazines.index = 0;
+  bp->full_magazines.index = ~0;
+
   return bp->index;
 }
 
+static u32
+vlib_buffer_pool_n_avail (vlib_buffer_pool_t *bp)
+{
+  return bp->n_avail + bp->n_full_magazines * VLIB_BUFFER_MAGAZINE_SZ;
+}
+
 static u8 *
 format_vlib_buffer_pool (u8 * s, va_list * va)
 {
   vlib_main_t *vm = va_arg (*va, vlib_main_t *);
   vlib_buffer_pool_t *bp = va_arg (*va, vlib_buffer_pool_t *);
   vlib_buffer_pool_thread_t *bpt;
-  u32 cached = 0;
+  u32 cached = 0, n_avail;
+  u64 swaps = 0, locks = 0, cross_numa = 0;
 
   if (!bp)
-    return format (s, "%-20s%=6s%=6s%=6s%=11s%=6s%=8s%=8s%=8s",
-		   "Pool Name", "Index", "NUMA", "Size", "Data Size",
-		   "Total", "Avail", "Cached", "Used");
+    return format (s, "%-20s%=6s%=6s%=6s%=11s%=6s%=8s%=8s%=12s%=12s%=12s%=8s",
+		   "Pool Name", "Index", "NUMA", "Size", "Data Size", "Total",
+		   "Avail", "Cached", "Mag Swaps", "Locks", "X-NUMA Free",
+		   "Used");
 
   vec_foreach (bpt, bp->threads)
-    cached += bpt->n_cached;
+    {
+      cached += bpt->n_cached;
+      swaps += bpt->n_magazine_swaps;
+      locks += bpt->n_lock_acquisitions;
+      cross_numa += bpt->n_cross_numa_frees;
+    }
 
-  s = format (s, "%-20v%=6d%=6d%=6u%=11u%=6u%=8u%=8u%=8u", bp->name, bp->index,
-	      bp->numa_node,
+  n_avail = vlib_buffer_pool_n_avail (bp);
+  s = format (s, "%-20v%=6d%=6d%=6u%=11u%=6u%=8u%=8u%=12lu%=12lu%=12lu%=8u",
+	      bp->name, bp->index, bp->numa_node,
 	      bp->data_size + sizeof (vlib_buffer_t) +
 		vm->buffer_main->ext_hdr_size,
-	      bp->data_size, bp->n_buffers, bp->n_avail, cached,
-	      bp->n_buffers - bp->n_avail - cached);
+	      bp->data_size, bp->n_buffers, n_avail, cached, swaps, locks,
+	      cross_numa, bp->n_buffers - n_avail - cached);
 
   return s;
 }
@@ -641,6 +691,98 @@ VLIB_CLI_COMMAND (show_buffers_command, static) = {
   .function = show_buffers,
 };
 
+static clib_error_t *
+test_buffer_layout (vlib_main_t *vm, unformat_input_t *input,
+		    vlib_cli_command_t *cmd)
+{
+  u32 n_buffers = 8192, n_rounds = 16, n_alloc, round, i;
+  u64 t[5], clocks[4] = {};
+  u64 n_total = 0;
+  vlib_buffer_t **bufs = 0;
+  u32 *bi = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "buffers %u", &n_buffers))
+	;
+      else if (unformat (input, "rounds %u", &n_rounds))
+	;
+      else
+	return clib_error_return (0, "parse error: '%U'",
+				  format_unformat_error, input);
+    }
+
+  if (n_buffers == 0 || n_rounds == 0)
+    return clib_error_return (0, "expecting non-zero buffers and rounds");
+
+  vec_validate_aligned (bi, n_buffers - 1, CLIB_CACHE_LINE_BYTES);
+  vec_validate_aligned (bufs, n_buffers - 1, CLIB_CACHE_LINE_BYTES);
+
+  for (round = 0; round < n_rounds; round++)
+    {
+      t[0] = clib_cpu_time_now ();
+      n_alloc = vlib_buffer_alloc (vm, bi, n_buffers);
+      t[1] = clib_cpu_time_now ();
+      if (n_alloc == 0)
+	break;
+
+      /* what a forwarding node touches: the first cache line */
+      vlib_get_buffers (vm, bi, bufs, n_alloc);
+      for (i = 0; i < n_alloc; i++)
+	{
+	  vlib_buffer_t *b = bufs[i];
+	  b->current_data += b->flags & VLIB_BUFFER_NEXT_PRESENT ? 0 : 14;
+	  b->current_length = 64;
+	  b->opaque[0] = i;
+	}
+      t[2] = clib_cpu_time_now ();
+
+      /* what traced, chained or offloaded packets touch on top */
+      for (i = 0; i < n_alloc; i++)
+	{
+	  vlib_buffer_cold_t *bc = vlib_buffer_cold (bufs[i]);
+	  bc->total_length_not_including_first_buffer = 0;
+	  bc->opaque2[0] = i;
+	}
+      t[3] = clib_cpu_time_now ();
+
+      vlib_buffer_free (vm, bi, n_alloc);
+      t[4] = clib_cpu_time_now ();
+
+      for (i = 0; i < 4; i++)
+	clocks[i] += t[i + 1] - t[i];
+      n_total += n_alloc;
+    }
+
+  vec_free (bi);
+  vec_free (bufs);
+
+  if (n_total == 0)
+    return clib_error_return (0, "buffer allocation failed");
+
+  vlib_cli_output (vm, "buffer header %u bytes, %u cache lines, "
+		   "cold metadata %s",
+		   VLIB_BUFFER_HDR_SIZE,
+		   VLIB_BUFFER_HDR_SIZE / CLIB_CACHE_LINE_BYTES,
+		   VLIB_BUFFER_COLD_METADATA ? "in pool array" : "in header");
+  vlib_cli_output (vm, "%u buffers, %u rounds, clocks per buffer:",
+		   n_total / round, round);
+  vlib_cli_output (vm, "  %-16s%.2f", "alloc", (f64) clocks[0] / n_total);
+  vlib_cli_output (vm, "  %-16s%.2f", "hot metadata",
+		   (f64) clocks[1] / n_total);
+  vlib_cli_output (vm, "  %-16s%.2f", "cold metadata",
+		   (f64) clocks[2] / n_total);
+  vlib_cli_output (vm, "  %-16s%.2f", "free", (f64) clocks[3] / n_total);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (test_buffer_layout_command, static) = {
+  .path = "test buffer layout",
+  .short_help = "test buffer layout [buffers <n>] [rounds <n>]",
+  .function = test_buffer_layout,
+};
+
 clib_error_t *
 vlib_buffer_num_workers_change (vlib_main_t *vm)
 {
@@ -795,7 +937,8 @@ buffer_gauges_collect_used_fn (vlib_stats_collector_data_t *d)
   if (!bp)
     return;
 
-  d->entry->value = bp->n_buffers - bp->n_avail - buffer_get_cached (bp);
+  d->entry->value =
+    bp->n_buffers - vlib_buffer_pool_n_avail (bp) - buffer_get_cached (bp);
 }
 
 static void
@@ -807,7 +950,7 @@ buffer_gauges_collect_available_fn (vlib_stats_collector_data_t *d)
   if (!bp)
     return;
 
-  d->entry->value = bp->n_avail;
+  d->entry->value = vlib_buffer_pool_n_avail (bp);
 }
 
 static void
@@ -964,6 +1107,8 @@ vlib_buffers_configure (vlib_main_t * vm, unformat_input_t * input)
       else if (unformat (input, "default data-size %u",
 			 &bm->default_data_size))
 	;
+      else if (unformat (input, "lazy-init"))
+	bm->lazy_init = 1;
       else if (unformat (input, "numa %u %U", &numa_node,
 			 unformat_vlib_cli_sub_input, &sub_input))
 	{
@@ -983,6 +1128,14 @@ vlib_buffers_configure (vlib_main_t * vm, unformat_input_t * input)
 
 VLIB_EARLY_CONFIG_FUNCTION (vlib_buffers_configure, "buffers");
 
+__clib_export void
+vlib_buffer_pool_format (vlib_main_t *vm, vlib_buffer_pool_t *bp,
+			 u32 *buffers, u32 n_buffers)
+{
+  for (u32 i = 0; i < n_buffers; i++)
+    vlib_get_buffer (vm, buffers[i])->template = bp->buffer_template;
+}
+
 #if VLIB_BUFFER_ALLOC_FAULT_INJECTOR > 0
 u32
 vlib_buffer_alloc_may_fail (vlib_main_t * vm, u32 n_buffers)
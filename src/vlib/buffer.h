@@ -161,6 +161,36 @@ typedef struct
 
 STATIC_ASSERT_SIZEOF (vlib_buffer_template_t, 64);
 
+/** Buffer metadata which the forwarding path rarely touches. It is the
+ * second cache line of the buffer header, or, with
+ * VLIB_BUFFER_COLD_METADATA, an element of the buffer pool's cold array.
+ * Use vlib_buffer_cold() to get at it. */
+#define vlib_buffer_cold_fields                                               \
+  /** Specifies trace buffer handle if VLIB_PACKET_IS_TRACED flag is          \
+   * set. */                                                                  \
+  u32 trace_handle;                                                           \
+                                                                              \
+  /** Only valid for first buffer in chain. Current length plus total length  \
+   * given here give total number of bytes in buffer chain. */                \
+  u32 total_length_not_including_first_buffer;                                \
+                                                                              \
+  /**< More opaque data, see ../vnet/vnet/buffer.h */                         \
+  u32 opaque2[14];
+
+typedef struct
+{
+  CLIB_ALIGN_MARK (align_mark, 64);
+  vlib_buffer_cold_fields
+} vlib_buffer_cold_t;
+
+STATIC_ASSERT_SIZEOF (vlib_buffer_cold_t, 64);
+
+#if VLIB_BUFFER_COLD_METADATA > 0
+#define VLIB_BUFFER_COLD_SZ 0
+#else
+#define VLIB_BUFFER_COLD_SZ 64
+#endif
+
 /** VLIB buffer representation. */
 typedef union
 {
@@ -179,19 +209,19 @@ typedef union
     /* Data above is initialized or zeroed on alloc, data bellow is not
      * and it is app responsibility to ensure data is valid */
 
+#if VLIB_BUFFER_COLD_METADATA == 0
     /** start of 2nd half (2nd cacheline on systems where cacheline size is 64) */
       CLIB_ALIGN_MARK (second_half, 64);
 
-    /** Specifies trace buffer handle if VLIB_PACKET_IS_TRACED flag is
-      * set. */
-    u32 trace_handle;
-
-    /** Only valid for first buffer in chain. Current length plus total length
-      * given here give total number of bytes in buffer chain. */
-    u32 total_length_not_including_first_buffer;
-
-    /**< More opaque data, see ../vnet/vnet/buffer.h */
-    u32 opaque2[14];
+    union
+    {
+      struct
+      {
+	vlib_buffer_cold_fields
+      };
+      vlib_buffer_cold_t cold;
+    };
+#endif
 
 #if VLIB_BUFFER_TRACE_TRAJECTORY > 0
     /** trace trajectory data - we use a specific cacheline for that in the
@@ -229,7 +259,8 @@ typedef union
 #endif
 } vlib_buffer_t;
 
-STATIC_ASSERT_SIZEOF (vlib_buffer_t, 128 + VLIB_BUFFER_TRACE_TRAJECTORY_SZ +
+STATIC_ASSERT_SIZEOF (vlib_buffer_t, 64 + VLIB_BUFFER_COLD_SZ +
+				       VLIB_BUFFER_TRACE_TRAJECTORY_SZ +
 				       VLIB_BUFFER_PRE_DATA_SIZE);
 STATIC_ASSERT (VLIB_BUFFER_PRE_DATA_SIZE % CLIB_CACHE_LINE_BYTES == 0,
 	       "VLIB_BUFFER_PRE_DATA_SIZE must be divisible by cache line size");
@@ -335,6 +366,37 @@ vlib_get_buffer_opaque (vlib_buffer_t * b)
   return (void *) b->opaque;
 }
 
+#if VLIB_BUFFER_COLD_METADATA > 0
+/** Cold metadata array of a buffer pool. Buffers are at least
+    1 << log2_stride bytes apart, so the offset of a buffer in the pool
+    shifted right by log2_stride is a unique index into the array. */
+typedef struct
+{
+  uword start;
+  vlib_buffer_cold_t *cold;
+  u8 log2_stride;
+} vlib_buffer_cold_pool_t;
+
+/* indexed by buffer pool index */
+extern vlib_buffer_cold_pool_t vlib_buffer_cold_pools[256];
+#endif
+
+/** \brief Get pointer to buffer's cold metadata
+
+    @param b - (vlib_buffer_t *) pointer to the buffer
+    @return - (vlib_buffer_cold_t *) trace handle, chain length and opaque2
+*/
+always_inline vlib_buffer_cold_t *
+vlib_buffer_cold (vlib_buffer_t *b)
+{
+#if VLIB_BUFFER_COLD_METADATA > 0
+  vlib_buffer_cold_pool_t *cp = vlib_buffer_cold_pools + b->buffer_pool_index;
+  return cp->cold + (((uword) b - cp->start) >> cp->log2_stride);
+#else
+  return &b->cold;
+#endif
+}
+
 /** \brief Get pointer to buffer's opaque2 data array
 
     @param b - (vlib_buffer_t *) pointer to the buffer
@@ -343,7 +405,7 @@ vlib_get_buffer_opaque (vlib_buffer_t * b)
 always_inline void *
 vlib_get_buffer_opaque2 (vlib_buffer_t * b)
 {
-  return (void *) b->opaque2;
+  return (void *) vlib_buffer_cold (b)->opaque2;
 }
 
 /** \brief Get pointer to the end of buffer's data
@@ -419,7 +481,7 @@ vlib_buffer_make_trace_handle (u32 thread, u32 pool_index)
 always_inline u32
 vlib_buffer_get_trace_thread (vlib_buffer_t * b)
 {
-  u32 trace_handle = b->trace_handle;
+  u32 trace_handle = vlib_buffer_cold (b)->trace_handle;
 
   return trace_handle >> 24;
 }
@@ -431,7 +493,7 @@ vlib_buffer_get_trace_thread (vlib_buffer_t * b)
 always_inline u32
 vlib_buffer_get_trace_index (vlib_buffer_t * b)
 {
-  u32 trace_handle = b->trace_handle;
+  u32 trace_handle = vlib_buffer_cold (b)->trace_handle;
   return trace_handle & 0x00FFFFFF;
 }
 
@@ -455,14 +517,41 @@ vlib_buffer_pull (vlib_buffer_t * b, u8 size)
 struct vlib_main_t;
 
 #define VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ 512
+#define VLIB_BUFFER_MAGAZINE_SZ		     256
 
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   u32 cached_buffers[VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ];
   u32 n_cached;
+
+  /* counters */
+  u64 n_magazine_swaps;
+  u64 n_lock_acquisitions;
+  u64 n_cross_numa_frees;
 } vlib_buffer_pool_thread_t;
 
+/* A batch of free buffers, handed between the per-thread caches of a pool
+   without taking the pool lock */
+typedef struct
+{
+  u32 buffers[VLIB_BUFFER_MAGAZINE_SZ];
+  u32 next;
+} vlib_buffer_magazine_t;
+
+/* Head of a lock-free stack of magazines. The tag is bumped by every
+   update, so a head which was popped and pushed back in between is not
+   mistaken for an unchanged one */
+typedef union
+{
+  struct
+  {
+    u32 index;
+    u32 tag;
+  };
+  u64 as_u64;
+} vlib_buffer_magazine_stack_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -476,6 +565,9 @@ typedef struct
   u32 alloc_size;
   u32 n_buffers;
   u32 n_avail;
+  /* buffers[0, n_unformatted) have never had the template written, see
+     'buffers { lazy-init }' */
+  u32 n_unformatted;
   u32 *buffers;
   u8 *name;
   clib_spinlock_t lock;
@@ -485,6 +577,14 @@ typedef struct
 
   /* buffer metadata template */
   vlib_buffer_template_t buffer_template;
+
+  /* magazines, and the stacks of full and empty ones, kept away from the
+     read-mostly data above */
+  vlib_buffer_magazine_t *magazines;
+  CLIB_CACHE_LINE_ALIGN_MARK (magazine_stacks);
+  vlib_buffer_magazine_stack_t full_magazines;
+  vlib_buffer_magazine_stack_t empty_magazines;
+  u32 n_full_magazines;
 } vlib_buffer_pool_t;
 
 #define VLIB_BUFFER_MAX_NUMA_NODES 32
@@ -513,6 +613,7 @@ typedef struct
   u16 ext_hdr_size;
   u32 default_data_size;
   clib_mem_page_sz_t log2_page_size;
+  u8 lazy_init;
 
   /* Hash table mapping buffer index into number
      0 => allocated but free, 1 => allocated and not-free.
@@ -6,6 +6,7 @@
 #include <vlib/vlib.h>
 #include <vppinfra/vector/mask_compare.h>
 #include <vppinfra/vector/compress.h>
+#include <vppinfra/math.h>
 
 static_always_inline u32
 enqueue_one (vlib_main_t *vm, vlib_node_runtime_t *node,
@@ -254,6 +255,18 @@ CLIB_MULTIARCH_FN (vlib_buffer_enqueue_to_single_next_with_aux_fn)
 }
 CLIB_MARCH_FN_REGISTRATION (vlib_buffer_enqueue_to_single_next_with_aux_fn);
 
+/* Wake up a neighbour of a congested thread, to steal from it */
+static_always_inline void
+vlib_frame_queue_steal_kick (vlib_frame_queue_main_t *fqm, u32 index,
+			     u64 n_in_use)
+{
+  u32 n_threads = vec_len (fqm->vlib_frame_queues);
+  u32 thief = index + 1 < n_threads ? index + 1 : 1;
+
+  if (n_in_use >= fqm->steal_threshold && thief != index)
+    vlib_get_main_by_index (thief)->check_frame_queues = 1;
+}
+
 static inline vlib_frame_queue_elt_t *
 vlib_get_frame_queue_elt (vlib_frame_queue_main_t *fqm, u32 index,
 			  int dont_wait)
@@ -269,6 +282,9 @@ retry:
   tail = __atomic_load_n (&fq->tail, __ATOMIC_ACQUIRE);
   new_tail = tail + 1;
 
+  if (PREDICT_FALSE (fqm->steal_threshold))
+    vlib_frame_queue_steal_kick (fqm, index, new_tail - fq->head);
+
   if (new_tail >= fq->head + nelts)
     {
       if (dont_wait)
@@ -286,6 +302,32 @@ retry:
   return fq->elts + (new_tail & (nelts - 1));
 }
 
+/* Get the next element of the calling thread's lane. Only the producer
+   writes the lane's tail, so the head is read only when the ring looks
+   full. */
+static_always_inline vlib_frame_queue_elt_t *
+vlib_get_frame_queue_lane_elt (vlib_frame_queue_lane_t *lane, int dont_wait)
+{
+  u64 tail = lane->tail;
+
+  if (PREDICT_FALSE (tail - lane->cached_head >= lane->nelts))
+    {
+      lane->cached_head = __atomic_load_n (&lane->head, __ATOMIC_ACQUIRE);
+
+      while (tail - lane->cached_head >= lane->nelts)
+	{
+	  if (dont_wait)
+	    return 0;
+
+	  /* Wait until a ring slot is available */
+	  vlib_worker_thread_barrier_check ();
+	  lane->cached_head = __atomic_load_n (&lane->head, __ATOMIC_ACQUIRE);
+	}
+    }
+
+  return lane->elts + (tail & (lane->nelts - 1));
+}
+
 static_always_inline u32
 vlib_buffer_enqueue_to_thread_inline (vlib_main_t *vm,
 				      vlib_node_runtime_t *node,
@@ -297,6 +339,8 @@ vlib_buffer_enqueue_to_thread_inline (vlib_main_t *vm,
   u32 drop_list[VLIB_FRAME_SIZE], n_drop = 0;
   vlib_frame_bitmap_t mask, used_elts = {};
   vlib_frame_queue_elt_t *hf = 0;
+  vlib_frame_queue_lane_t *lane = 0;
+  vlib_frame_queue_t *fq;
   clib_thread_index_t thread_index;
   u32 n_comp, off = 0, n_left = n_packets;
 
@@ -304,7 +348,16 @@ vlib_buffer_enqueue_to_thread_inline (vlib_main_t *vm,
 
 more:
   clib_mask_compare_u16 (thread_index, thread_indices, mask, n_packets);
-  hf = vlib_get_frame_queue_elt (fqm, thread_index, drop_on_congestion);
+  fq = vec_elt (fqm->vlib_frame_queues,
+		thread_index & ~VLIB_FRAME_QUEUE_PINNED);
+  if (PREDICT_FALSE (fq->lanes != 0))
+    {
+      lane = vec_elt_at_index (fq->lanes, vm->thread_index);
+      hf = vlib_get_frame_queue_lane_elt (lane, drop_on_congestion);
+    }
+  else
+    hf = vlib_get_frame_queue_elt (
+      fqm, thread_index & ~VLIB_FRAME_QUEUE_PINNED, drop_on_congestion);
 
   n_comp = clib_compress_u32 (hf ? hf->buffer_index : drop_list + n_drop,
 			      buffer_indices, mask, n_packets);
@@ -316,8 +369,18 @@ more:
     {
       if (node->flags & VLIB_NODE_FLAG_TRACE)
 	hf->maybe_trace = 1;
+      if (thread_index & VLIB_FRAME_QUEUE_PINNED)
+	{
+	  hf->pinned = 1;
+	  thread_index &= ~VLIB_FRAME_QUEUE_PINNED;
+	}
       hf->n_vectors = n_comp;
-      __atomic_store_n (&hf->valid, 1, __ATOMIC_RELEASE);
+      if (PREDICT_FALSE (fqm->codel_target))
+	hf->enq_time = clib_cpu_time_now ();
+      if (lane)
+	__atomic_store_n (&lane->tail, lane->tail + 1, __ATOMIC_RELEASE);
+      else
+	__atomic_store_n (&hf->valid, 1, __ATOMIC_RELEASE);
       vlib_get_main_by_index (thread_index)->check_frame_queues = 1;
     }
   else
@@ -413,27 +476,66 @@ CLIB_MULTIARCH_FN (vlib_buffer_enqueue_to_thread_with_aux_fn)
 CLIB_MARCH_FN_REGISTRATION (vlib_buffer_enqueue_to_thread_fn);
 CLIB_MARCH_FN_REGISTRATION (vlib_buffer_enqueue_to_thread_with_aux_fn);
 
+/* CoDel (RFC 8289) on the sojourn time of a frame queue element.
+   Returns 1 if the element should be dropped. */
+static_always_inline int
+vlib_frame_queue_codel_drop (vlib_frame_queue_main_t *fqm,
+			     vlib_frame_queue_t *fq, u64 enq_time, u64 now)
+{
+  int ok_to_drop = 0;
+
+  if (now - enq_time < fqm->codel_target)
+    fq->codel_first_above_time = 0;
+  else if (fq->codel_first_above_time == 0)
+    fq->codel_first_above_time = now + fqm->codel_interval;
+  else if (now >= fq->codel_first_above_time)
+    ok_to_drop = 1;
+
+  if (fq->codel_dropping)
+    {
+      if (!ok_to_drop)
+	{
+	  fq->codel_dropping = 0;
+	  return 0;
+	}
+      if (now < fq->codel_drop_next)
+	return 0;
+      fq->codel_count++;
+    }
+  else
+    {
+      if (!ok_to_drop)
+	return 0;
+      fq->codel_dropping = 1;
+      /* resume close to the previous drop rate if we were dropping
+	 recently */
+      if (fq->codel_count > 2 &&
+	  now - fq->codel_drop_next < 16 * fqm->codel_interval)
+	fq->codel_count -= 2;
+      else
+	fq->codel_count = 1;
+      fq->codel_drop_next = now;
+    }
+
+  fq->codel_drop_next += fqm->codel_interval / sqrt (fq->codel_count);
+  return 1;
+}
+
 static_always_inline u32
-vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
-				 u8 with_aux)
+vlib_frame_queue_dequeue_one (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
+			      vlib_frame_queue_t *fq, u8 with_aux, u8 is_steal)
 {
   u32 thread_id = vm->thread_index;
-  vlib_frame_queue_t *fq = fqm->vlib_frame_queues[thread_id];
   u32 mask = fq->nelts - 1;
   vlib_frame_queue_elt_t *elt;
   u32 n_free, n_copy, *from, *from_aux, *to = 0, *to_aux = 0, processed = 0,
 					vectors = 0;
   vlib_frame_t *f = 0;
 
-  ASSERT (fq);
-  ASSERT (vm == vlib_global_main.vlib_mains[thread_id]);
-
-  if (PREDICT_FALSE (fqm->node_index == ~0))
-    return 0;
   /*
    * Gather trace data for frame queues
    */
-  if (PREDICT_FALSE (fq->trace))
+  if (PREDICT_FALSE (fq->trace) && !is_steal)
     {
       frame_queue_trace_t *fqt;
       frame_queue_nelt_counter_t *fqh;
@@ -478,11 +580,28 @@ vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
       if (!__atomic_load_n (&elt->valid, __ATOMIC_ACQUIRE))
 	break;
 
+      /* a thief stops at the first element which must stay in order */
+      if (is_steal && elt->pinned)
+	break;
+
       from = elt->buffer_index + elt->offset;
       if (with_aux)
 	from_aux = elt->aux_data + elt->offset;
       ASSERT (elt->offset + elt->n_vectors <= VLIB_FRAME_SIZE);
 
+      if (PREDICT_FALSE (fqm->codel_target) && elt->offset == 0 &&
+	  vlib_frame_queue_codel_drop (fqm, fq, elt->enq_time,
+				       clib_cpu_time_now ()))
+	{
+	  u32 sz = STRUCT_OFFSET_OF (vlib_frame_queue_elt_t, end_of_reset);
+	  vlib_buffer_free (vm, from, elt->n_vectors);
+	  fq->n_codel_drops += elt->n_vectors;
+	  clib_memset (elt, 0, sz);
+	  __atomic_store_n (&fq->head, fq->head + 1, __ATOMIC_RELEASE);
+	  processed++;
+	  continue;
+	}
+
       if (f == 0)
 	{
 	  f = vlib_get_frame_to_node (vm, fqm->node_index);
@@ -508,6 +627,9 @@ vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
       n_free -= n_copy;
       vectors += n_copy;
 
+      if (is_steal)
+	fq->n_vectors_stolen += n_copy;
+
       if (n_free == 0)
 	{
 	  f->n_vectors = VLIB_FRAME_SIZE;
@@ -528,6 +650,9 @@ vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
 	  clib_memset (elt, 0, sz);
 	  __atomic_store_n (&fq->head, fq->head + 1, __ATOMIC_RELEASE);
 	  processed++;
+
+	  if (is_steal)
+	    fq->n_elts_stolen++;
 	}
 
       /* Limit the number of packets pushed into the graph */
@@ -544,6 +669,197 @@ vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
   return processed;
 }
 
+/* Dequeue from each producer's lane in turn. One acquire load of a
+   lane's tail covers all the elements published so far, and the head is
+   written back once per lane. */
+static_always_inline u32
+vlib_frame_queue_dequeue_lanes (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
+				vlib_frame_queue_t *fq, u8 with_aux)
+{
+  u32 n_lanes = vec_len (fq->lanes), i, lane_index = fq->next_lane;
+  u32 n_free = 0, n_copy, *from, *from_aux, *to = 0, *to_aux = 0;
+  u32 processed = 0, vectors = 0;
+  vlib_frame_queue_lane_t *lane;
+  vlib_frame_queue_elt_t *elt;
+  vlib_frame_t *f = 0;
+  u64 head, tail;
+
+  for (i = 0; i < n_lanes && vectors < fq->vector_threshold; i++)
+    {
+      lane = fq->lanes + lane_index;
+      lane_index = lane_index + 1 < n_lanes ? lane_index + 1 : 0;
+
+      tail = __atomic_load_n (&lane->tail, __ATOMIC_ACQUIRE);
+      head = lane->head;
+
+      while (head != tail && vectors < fq->vector_threshold)
+	{
+	  elt = lane->elts + (head & (lane->nelts - 1));
+	  from = elt->buffer_index + elt->offset;
+	  if (with_aux)
+	    from_aux = elt->aux_data + elt->offset;
+	  ASSERT (elt->offset + elt->n_vectors <= VLIB_FRAME_SIZE);
+
+	  if (PREDICT_FALSE (fqm->codel_target) && elt->offset == 0 &&
+	      vlib_frame_queue_codel_drop (fqm, fq, elt->enq_time,
+					   clib_cpu_time_now ()))
+	    {
+	      u32 sz = STRUCT_OFFSET_OF (vlib_frame_queue_elt_t, end_of_reset);
+	      vlib_buffer_free (vm, from, elt->n_vectors);
+	      fq->n_codel_drops += elt->n_vectors;
+	      clib_memset (elt, 0, sz);
+	      head++;
+	      processed++;
+	      continue;
+	    }
+
+	  if (f == 0)
+	    {
+	      f = vlib_get_frame_to_node (vm, fqm->node_index);
+	      to = vlib_frame_vector_args (f);
+	      if (with_aux)
+		to_aux = vlib_frame_aux_args (f);
+	      n_free = VLIB_FRAME_SIZE;
+	    }
+
+	  if (elt->maybe_trace)
+	    f->frame_flags |= VLIB_NODE_FLAG_TRACE;
+
+	  n_copy = clib_min (n_free, elt->n_vectors);
+
+	  vlib_buffer_copy_indices (to, from, n_copy);
+	  to += n_copy;
+	  if (with_aux)
+	    {
+	      vlib_buffer_copy_indices (to_aux, from_aux, n_copy);
+	      to_aux += n_copy;
+	    }
+
+	  n_free -= n_copy;
+	  vectors += n_copy;
+
+	  if (n_free == 0)
+	    {
+	      f->n_vectors = VLIB_FRAME_SIZE;
+	      vlib_put_frame_to_node (vm, fqm->node_index, f);
+	      f = 0;
+	    }
+
+	  if (n_copy < elt->n_vectors)
+	    {
+	      /* not empty - leave it on the ring */
+	      elt->n_vectors -= n_copy;
+	      elt->offset += n_copy;
+	    }
+	  else
+	    {
+	      u32 sz = STRUCT_OFFSET_OF (vlib_frame_queue_elt_t, end_of_reset);
+	      clib_memset (elt, 0, sz);
+	      head++;
+	      processed++;
+	    }
+	}
+
+      if (head != lane->head)
+	__atomic_store_n (&lane->head, head, __ATOMIC_RELEASE);
+    }
+
+  fq->next_lane = lane_index;
+
+  if (f)
+    {
+      f->n_vectors = VLIB_FRAME_SIZE - n_free;
+      vlib_put_frame_to_node (vm, fqm->node_index, f);
+    }
+
+  return processed;
+}
+
+static_always_inline int
+vlib_frame_queue_consumer_trylock (vlib_frame_queue_t *fq)
+{
+  return !__atomic_exchange_n (&fq->consumer_lock, 1, __ATOMIC_ACQUIRE);
+}
+
+static_always_inline void
+vlib_frame_queue_consumer_unlock (vlib_frame_queue_t *fq)
+{
+  __atomic_store_n (&fq->consumer_lock, 0, __ATOMIC_RELEASE);
+}
+
+/* Dequeue from our own queue and, if that is empty, from the queue of a
+   congested thread. Consumers take the queue's lock, so that each queue
+   still has a single consumer at a time. */
+static_always_inline u32
+vlib_frame_queue_dequeue_steal (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
+				u8 with_aux)
+{
+  u32 thread_id = vm->thread_index;
+  u32 i, victim, processed = 0, n_threads = vec_len (fqm->vlib_frame_queues);
+  vlib_frame_queue_t *fq = fqm->vlib_frame_queues[thread_id], *vfq;
+  u64 n_in_use;
+
+  /* a thief is draining our queue */
+  if (!vlib_frame_queue_consumer_trylock (fq))
+    return 0;
+
+  n_in_use = fq->tail - fq->head;
+  if (n_in_use > fq->max_in_use)
+    fq->max_in_use = n_in_use;
+
+  processed = vlib_frame_queue_dequeue_one (vm, fqm, fq, with_aux, 0);
+  vlib_frame_queue_consumer_unlock (fq);
+
+  /* only idle workers steal */
+  if (processed || thread_id == 0)
+    return processed;
+
+  for (i = 1; i < n_threads; i++)
+    {
+      victim = (thread_id + i) % n_threads;
+      vfq = fqm->vlib_frame_queues[victim];
+
+      if (victim == 0 || vfq->tail - vfq->head < fqm->steal_threshold)
+	continue;
+
+      if (!vlib_frame_queue_consumer_trylock (vfq))
+	continue;
+
+      processed = vlib_frame_queue_dequeue_one (vm, fqm, vfq, with_aux, 1);
+      vlib_frame_queue_consumer_unlock (vfq);
+
+      if (processed)
+	{
+	  fq->n_steals++;
+	  break;
+	}
+    }
+
+  return processed;
+}
+
+static_always_inline u32
+vlib_frame_queue_dequeue_inline (vlib_main_t *vm, vlib_frame_queue_main_t *fqm,
+				 u8 with_aux)
+{
+  u32 thread_id = vm->thread_index;
+  vlib_frame_queue_t *fq = fqm->vlib_frame_queues[thread_id];
+
+  ASSERT (fq);
+  ASSERT (vm == vlib_global_main.vlib_mains[thread_id]);
+
+  if (PREDICT_FALSE (fqm->node_index == ~0))
+    return 0;
+
+  if (PREDICT_FALSE (fq->lanes != 0))
+    return vlib_frame_queue_dequeue_lanes (vm, fqm, fq, with_aux);
+
+  if (PREDICT_FALSE (fqm->steal_threshold))
+    return vlib_frame_queue_dequeue_steal (vm, fqm, with_aux);
+
+  return vlib_frame_queue_dequeue_one (vm, fqm, fq, with_aux, 0);
+}
+
 u32 __clib_section (".vlib_frame_queue_dequeue_fn")
 CLIB_MULTIARCH_FN (vlib_frame_queue_dequeue_fn)
 (vlib_main_t *vm, vlib_frame_queue_main_t *fqm)
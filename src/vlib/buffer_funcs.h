@@ -388,7 +388,8 @@ vlib_buffer_length_in_chain (vlib_main_t * vm, vlib_buffer_t * b)
     return len;
 
   if (PREDICT_TRUE (b->flags & VLIB_BUFFER_TOTAL_LENGTH_VALID))
-    return len + b->total_length_not_including_first_buffer;
+    return len +
+	   vlib_buffer_cold (b)->total_length_not_including_first_buffer;
 
   return vlib_buffer_length_in_chain_slow_path (vm, b);
 }
@@ -498,6 +499,11 @@ u8 *vlib_validate_buffers (vlib_main_t * vm,
 			   vlib_buffer_known_state_t known_state,
 			   uword follow_buffer_next);
 
+/* Writes the pool's metadata template into buffers which have never been
+   formatted, see 'buffers { lazy-init }' */
+void vlib_buffer_pool_format (vlib_main_t *vm, vlib_buffer_pool_t *bp,
+			      u32 *buffers, u32 n_buffers);
+
 static_always_inline vlib_buffer_pool_t *
 vlib_get_buffer_pool (vlib_main_t * vm, u8 buffer_pool_index)
 {
@@ -505,15 +511,96 @@ vlib_get_buffer_pool (vlib_main_t * vm, u8 buffer_pool_index)
   return vec_elt_at_index (bm->buffer_pools, buffer_pool_index);
 }
 
+static_always_inline u32
+vlib_buffer_magazine_pop (vlib_buffer_pool_t *bp,
+			  vlib_buffer_magazine_stack_t *stack)
+{
+  vlib_buffer_magazine_stack_t old, new;
+
+  old.as_u64 = clib_atomic_load_acq_n (&stack->as_u64);
+  do
+    {
+      if (old.index == ~0)
+	return ~0;
+      /* may be stale if old.index was popped meanwhile, the tag catches it */
+      new.index = clib_atomic_load_relax_n (&bp->magazines[old.index].next);
+      new.tag = old.tag + 1;
+    }
+  while (!clib_atomic_cmp_and_swap_acq_rel_n (&stack->as_u64, &old.as_u64,
+					      new.as_u64, 1 /* weak */));
+
+  return old.index;
+}
+
+static_always_inline void
+vlib_buffer_magazine_push (vlib_buffer_pool_t *bp,
+			   vlib_buffer_magazine_stack_t *stack, u32 index)
+{
+  vlib_buffer_magazine_stack_t old, new;
+
+  old.as_u64 = clib_atomic_load_relax_n (&stack->as_u64);
+  new.index = index;
+  do
+    {
+      clib_atomic_store_relax_n (&bp->magazines[index].next, old.index);
+      new.tag = old.tag + 1;
+    }
+  while (!clib_atomic_cmp_and_swap_acq_rel_n (&stack->as_u64, &old.as_u64,
+					      new.as_u64, 1 /* weak */));
+}
+
+/* Move a full magazine into the empty per-thread cache */
+static_always_inline u32
+vlib_buffer_magazine_get (vlib_buffer_pool_t *bp,
+			  vlib_buffer_pool_thread_t *bpt)
+{
+  u32 index = vlib_buffer_magazine_pop (bp, &bp->full_magazines);
+
+  if (index == ~0)
+    return 0;
+
+  vlib_buffer_copy_indices (bpt->cached_buffers + bpt->n_cached,
+			    bp->magazines[index].buffers,
+			    VLIB_BUFFER_MAGAZINE_SZ);
+  bpt->n_cached += VLIB_BUFFER_MAGAZINE_SZ;
+  clib_atomic_fetch_sub_relax (&bp->n_full_magazines, 1);
+  vlib_buffer_magazine_push (bp, &bp->empty_magazines, index);
+  bpt->n_magazine_swaps++;
+
+  return VLIB_BUFFER_MAGAZINE_SZ;
+}
+
+/* Move the top of the full per-thread cache into a magazine */
+static_always_inline u32
+vlib_buffer_magazine_put (vlib_buffer_pool_t *bp,
+			  vlib_buffer_pool_thread_t *bpt)
+{
+  u32 index = vlib_buffer_magazine_pop (bp, &bp->empty_magazines);
+
+  if (index == ~0)
+    return 0;
+
+  bpt->n_cached -= VLIB_BUFFER_MAGAZINE_SZ;
+  vlib_buffer_copy_indices (bp->magazines[index].buffers,
+			    bpt->cached_buffers + bpt->n_cached,
+			    VLIB_BUFFER_MAGAZINE_SZ);
+  clib_atomic_fetch_add_relax (&bp->n_full_magazines, 1);
+  vlib_buffer_magazine_push (bp, &bp->full_magazines, index);
+  bpt->n_magazine_swaps++;
+
+  return VLIB_BUFFER_MAGAZINE_SZ;
+}
+
 static_always_inline __clib_warn_unused_result uword
 vlib_buffer_pool_get (vlib_main_t * vm, u8 buffer_pool_index, u32 * buffers,
 		      u32 n_buffers)
 {
   vlib_buffer_pool_t *bp = vlib_get_buffer_pool (vm, buffer_pool_index);
-  u32 len;
+  u32 len, n_unformatted = 0;
 
   ASSERT (bp->buffers);
 
+  bp->threads[vm->thread_index].n_lock_acquisitions++;
   clib_spinlock_lock (&bp->lock);
   len = bp->n_avail;
   if (PREDICT_TRUE (n_buffers < len))
@@ -521,16 +608,29 @@ vlib_buffer_pool_get (vlib_main_t * vm, u8 buffer_pool_index, u32 * buffers,
       len -= n_buffers;
       vlib_buffer_copy_indices (buffers, bp->buffers + len, n_buffers);
       bp->n_avail = len;
+      /* never formatted buffers sit at the bottom of the stack, so the
+	 ones taken, if any, are at the start of the array */
+      if (PREDICT_FALSE (bp->n_unformatted > len))
+	{
+	  n_unformatted = bp->n_unformatted - len;
+	  bp->n_unformatted = len;
+	}
       clib_spinlock_unlock (&bp->lock);
-      return n_buffers;
     }
   else
     {
       vlib_buffer_copy_indices (buffers, bp->buffers, len);
       bp->n_avail = 0;
+      n_unformatted = bp->n_unformatted;
+      bp->n_unformatted = 0;
       clib_spinlock_unlock (&bp->lock);
-      return len;
+      n_buffers = len;
     }
+
+  if (PREDICT_FALSE (n_unformatted))
+    vlib_buffer_pool_format (vm, bp, buffers, n_unformatted);
+
+  return n_buffers;
 }
 
 
@@ -596,9 +696,15 @@ vlib_buffer_alloc_from_pool (vlib_main_t * vm, u32 * buffers, u32 n_buffers,
       n_left -= len;
     }
 
-  len = round_pow2 (n_left, 32);
-  len = vlib_buffer_pool_get (vm, buffer_pool_index, bpt->cached_buffers,
-			      len);
+  /* refill with full magazines, or in magazine sized bulk from the pool */
+  len = 0;
+  while (len < n_left && vlib_buffer_magazine_get (bp, bpt))
+    len += VLIB_BUFFER_MAGAZINE_SZ;
+
+  if (len < n_left)
+    len += vlib_buffer_pool_get (
+      vm, buffer_pool_index, bpt->cached_buffers + len,
+      round_pow2 (n_left - len, VLIB_BUFFER_MAGAZINE_SZ));
   bpt->n_cached = len;
 
   if (len)
@@ -732,24 +838,37 @@ vlib_buffer_pool_put (vlib_main_t * vm, u8 buffer_pool_index,
   if (PREDICT_FALSE (bm->free_callback_fn != 0))
     bm->free_callback_fn (vm, buffer_pool_index, buffers, n_buffers);
 
+  if (PREDICT_FALSE (bp->numa_node != vm->numa_node))
+    bpt->n_cross_numa_frees += n_buffers;
+
   n_cached = bpt->n_cached;
   n_empty = VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ - n_cached;
-  if (n_buffers <= n_empty)
+
+  while (n_buffers > n_empty)
     {
+      /* fill the cache up and hand its top over as a full magazine */
+      n_buffers -= n_empty;
       vlib_buffer_copy_indices (bpt->cached_buffers + n_cached,
-				buffers, n_buffers);
-      bpt->n_cached = n_cached + n_buffers;
-      return;
+				buffers + n_buffers, n_empty);
+      bpt->n_cached = VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ;
+
+      if (vlib_buffer_magazine_put (bp, bpt) == 0)
+	goto pool_put;
+
+      n_cached = bpt->n_cached;
+      n_empty = VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ - n_cached;
     }
 
-  vlib_buffer_copy_indices (bpt->cached_buffers + n_cached,
-			    buffers + n_buffers - n_empty, n_empty);
-  bpt->n_cached = VLIB_BUFFER_POOL_PER_THREAD_CACHE_SZ;
+  vlib_buffer_copy_indices (bpt->cached_buffers + n_cached, buffers,
+			    n_buffers);
+  bpt->n_cached = n_cached + n_buffers;
+  return;
 
+pool_put:
+  bpt->n_lock_acquisitions++;
   clib_spinlock_lock (&bp->lock);
-  vlib_buffer_copy_indices (bp->buffers + bp->n_avail, buffers,
-			    n_buffers - n_empty);
-  bp->n_avail += n_buffers - n_empty;
+  vlib_buffer_copy_indices (bp->buffers + bp->n_avail, buffers, n_buffers);
+  bp->n_avail += n_buffers;
   clib_spinlock_unlock (&bp->lock);
 }
 
@@ -1099,6 +1218,89 @@ vlib_buffer_free_from_ring_no_next (vlib_main_t * vm, u32 * ring, u32 start,
     }
 }
 
+/* Upper bound of buffers held on per-thread deferred free list, reaching it
+   frees the list immediately. */
+#define VLIB_BUFFER_DEFERRED_FREE_MAX 2048
+
+/** \brief Free buffers queued by vlib_buffer_free_no_next_deferred
+
+    Called once per main loop iteration.
+
+    @param vm - (vlib_main_t *) vlib main data structure pointer
+*/
+always_inline void
+vlib_buffer_free_deferred_flush (vlib_main_t *vm)
+{
+  u32 n_buffers = vec_len (vm->deferred_free_buffers);
+
+  if (n_buffers == 0)
+    return;
+
+  vlib_buffer_free_no_next (vm, vm->deferred_free_buffers, n_buffers);
+  vec_set_len (vm->deferred_free_buffers, 0);
+}
+
+/** \brief Free buffers at the end of the current main loop iteration,
+    does not free the buffer chain for each buffer
+
+    Intended for tx completion. Completed buffers of all interfaces served
+    by the thread are collected and returned to the buffer pool in a single
+    call, right before next rx refill which then reuses them first.
+
+    @param vm - (vlib_main_t *) vlib main data structure pointer
+    @param buffers - (u32 * ) buffer index array
+    @param n_buffers - (u32) number of buffers
+*/
+always_inline void
+vlib_buffer_free_no_next_deferred (vlib_main_t *vm, u32 *buffers,
+				   u32 n_buffers)
+{
+  u32 n = vec_len (vm->deferred_free_buffers);
+
+  if (PREDICT_FALSE (n + n_buffers > VLIB_BUFFER_DEFERRED_FREE_MAX))
+    {
+      vlib_buffer_free_deferred_flush (vm);
+      if (n_buffers > VLIB_BUFFER_DEFERRED_FREE_MAX)
+	{
+	  vlib_buffer_free_no_next (vm, buffers, n_buffers);
+	  return;
+	}
+      n = 0;
+    }
+
+  vec_validate (vm->deferred_free_buffers, n + n_buffers - 1);
+  vlib_buffer_copy_indices (vm->deferred_free_buffers + n, buffers,
+			    n_buffers);
+}
+
+/** \brief Free buffers from ring at the end of the current main loop
+    iteration, does not free the buffer chain for each buffer
+
+    @param vm - (vlib_main_t *) vlib main data structure pointer
+    @param ring - (u32 * ) buffer index ring
+    @param start - (u32) first slot in the ring
+    @param ring_size - (u32) ring size
+    @param n_buffers - (u32) number of buffers
+*/
+always_inline void
+vlib_buffer_free_from_ring_no_next_deferred (vlib_main_t *vm, u32 *ring,
+					     u32 start, u32 ring_size,
+					     u32 n_buffers)
+{
+  ASSERT (n_buffers <= ring_size);
+
+  if (PREDICT_TRUE (start + n_buffers <= ring_size))
+    {
+      vlib_buffer_free_no_next_deferred (vm, ring + start, n_buffers);
+    }
+  else
+    {
+      vlib_buffer_free_no_next_deferred (vm, ring + start, ring_size - start);
+      vlib_buffer_free_no_next_deferred (vm, ring,
+					 n_buffers - (ring_size - start));
+    }
+}
+
 /* Append given data to end of buffer, possibly allocating new buffers. */
 int vlib_buffer_add_data (vlib_main_t * vm, u32 * buffer_index, void *data,
 			  u32 n_data_bytes);
@@ -1141,13 +1343,10 @@ vlib_buffer_copy (vlib_main_t * vm, vlib_buffer_t * b)
   d->current_data = s->current_data;
   d->current_length = s->current_length;
   d->flags = s->flags & flag_mask;
-  d->trace_handle = s->trace_handle;
-  d->total_length_not_including_first_buffer =
-    s->total_length_not_including_first_buffer;
   clib_memcpy_fast (d->opaque, s->opaque, sizeof (s->opaque));
-  clib_memcpy_fast (d->opaque2, s->opaque2, sizeof (s->opaque2));
-  clib_memcpy_fast (vlib_buffer_get_current (d),
-		    vlib_buffer_get_current (s), s->current_length);
+  *vlib_buffer_cold (d) = *vlib_buffer_cold (s);
+  clib_memcpy_large (vlib_buffer_get_current (d),
+		     vlib_buffer_get_current (s), s->current_length);
 
   /* next segments */
   for (i = 1; i < n_buffers; i++)
@@ -1159,8 +1358,8 @@ vlib_buffer_copy (vlib_main_t * vm, vlib_buffer_t * b)
       d = vlib_get_buffer (vm, new_buffers[i]);
       d->current_data = s->current_data;
       d->current_length = s->current_length;
-      clib_memcpy_fast (vlib_buffer_get_current (d),
-			vlib_buffer_get_current (s), s->current_length);
+      clib_memcpy_large (vlib_buffer_get_current (d),
+			 vlib_buffer_get_current (s), s->current_length);
       d->flags = s->flags & flag_mask;
     }
 
@@ -1181,9 +1380,11 @@ vlib_buffer_copy_no_chain (vlib_main_t * vm, vlib_buffer_t * b, u32 * di)
   d->current_data = b->current_data;
   d->current_length = b->current_length;
   clib_memcpy_fast (d->opaque, b->opaque, sizeof (b->opaque));
-  clib_memcpy_fast (d->opaque2, b->opaque2, sizeof (b->opaque2));
-  clib_memcpy_fast (vlib_buffer_get_current (d),
-		    vlib_buffer_get_current (b), b->current_length);
+  clib_memcpy_fast (vlib_buffer_cold (d)->opaque2,
+		    vlib_buffer_cold (b)->opaque2,
+		    STRUCT_SIZE_OF (vlib_buffer_cold_t, opaque2));
+  clib_memcpy_large (vlib_buffer_get_current (d),
+		     vlib_buffer_get_current (b), b->current_length);
 
   return d;
 }
@@ -1247,6 +1448,26 @@ vlib_buffer_clone_256 (vlib_main_t * vm, u32 src_buffer, u32 * buffers,
       if (offset)
 	vlib_buffer_move (vm, s, offset);
 
+      /* single segment, allocate all the copies in one go */
+      if (PREDICT_TRUE ((s->flags & VLIB_BUFFER_NEXT_PRESENT) == 0))
+	{
+	  n_buffers = 1 + vlib_buffer_alloc_from_pool (vm, buffers + 1,
+						       n_buffers - 1,
+						       s->buffer_pool_index);
+	  for (i = 1; i < n_buffers; i++)
+	    {
+	      vlib_buffer_t *d = vlib_get_buffer (vm, buffers[i]);
+	      d->current_data = s->current_data;
+	      d->current_length = s->current_length;
+	      d->flags = s->flags & VLIB_BUFFER_COPY_CLONE_FLAGS_MASK;
+	      clib_memcpy_fast (d->opaque, s->opaque, sizeof (s->opaque));
+	      *vlib_buffer_cold (d) = *vlib_buffer_cold (s);
+	      clib_memcpy_fast (vlib_buffer_get_current (d),
+				vlib_buffer_get_current (s), s->current_length);
+	    }
+	  return n_buffers;
+	}
+
       for (i = 1; i < n_buffers; i++)
 	{
 	  vlib_buffer_t *d;
@@ -1279,18 +1500,21 @@ vlib_buffer_clone_256 (vlib_main_t * vm, u32 src_buffer, u32 * buffers,
       d->current_length = head_end_offset;
       ASSERT (d->buffer_pool_index == s->buffer_pool_index);
 
-      d->total_length_not_including_first_buffer = s->current_length -
+      vlib_buffer_cold_t *dc = vlib_buffer_cold (d);
+      vlib_buffer_cold_t *sc = vlib_buffer_cold (s);
+
+      dc->total_length_not_including_first_buffer = s->current_length -
 	head_end_offset;
       if (PREDICT_FALSE (s->flags & VLIB_BUFFER_NEXT_PRESENT))
 	{
-	  d->total_length_not_including_first_buffer +=
-	    s->total_length_not_including_first_buffer;
+	  dc->total_length_not_including_first_buffer +=
+	    sc->total_length_not_including_first_buffer;
 	}
       d->flags = (s->flags & VLIB_BUFFER_COPY_CLONE_FLAGS_MASK) |
 	VLIB_BUFFER_NEXT_PRESENT;
-      d->trace_handle = s->trace_handle;
+      dc->trace_handle = sc->trace_handle;
       clib_memcpy_fast (d->opaque, s->opaque, sizeof (s->opaque));
-      clib_memcpy_fast (d->opaque2, s->opaque2, sizeof (s->opaque2));
+      clib_memcpy_fast (dc->opaque2, sc->opaque2, sizeof (sc->opaque2));
       clib_memcpy_fast (vlib_buffer_get_current (d),
 			vlib_buffer_get_current (s), head_end_offset);
       d->next_buffer = src_buffer;
@@ -1383,8 +1607,9 @@ vlib_buffer_attach_clone (vlib_main_t * vm, vlib_buffer_t * head,
   head->flags &= ~VLIB_BUFFER_EXT_HDR_VALID;
   head->flags |= (tail->flags & VLIB_BUFFER_TOTAL_LENGTH_VALID);
   head->next_buffer = vlib_get_buffer_index (vm, tail);
-  head->total_length_not_including_first_buffer = tail->current_length +
-    tail->total_length_not_including_first_buffer;
+  vlib_buffer_cold (head)->total_length_not_including_first_buffer =
+    tail->current_length +
+    vlib_buffer_cold (tail)->total_length_not_including_first_buffer;
 
 next_segment:
   clib_atomic_add_fetch (&tail->ref_count, 1);
@@ -1400,7 +1625,7 @@ next_segment:
 always_inline void
 vlib_buffer_chain_init (vlib_buffer_t * first)
 {
-  first->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (first)->total_length_not_including_first_buffer = 0;
   first->current_length = 0;
   first->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
   first->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
@@ -1428,7 +1653,7 @@ vlib_buffer_chain_increase_length (vlib_buffer_t * first,
 {
   last->current_length += len;
   if (first != last)
-    first->total_length_not_including_first_buffer += len;
+    vlib_buffer_cold (first)->total_length_not_including_first_buffer += len;
 }
 
 /* Copy data to the end of the packet and increases its length.
@@ -1462,6 +1687,142 @@ vlib_buffer_chain_append_data_with_alloc (vlib_main_t * vm,
 					  u16 data_len);
 void vlib_buffer_chain_validate (vlib_main_t * vm, vlib_buffer_t * first);
 
+/* Chain builder: keeps the head and tail of a chain under construction,
+ * and the head's total length, up to date on every append so callers
+ * do not link buffers by hand. */
+typedef struct
+{
+  vlib_buffer_t *first;
+  vlib_buffer_t *last;
+  /* last segment is shared with other chains, nothing may follow it */
+  u8 last_is_shared;
+} vlib_buffer_chain_builder_t;
+
+/* Starts a chain with the data already in the first buffer. */
+always_inline void
+vlib_buffer_chain_builder_init (vlib_buffer_chain_builder_t *cb,
+				vlib_buffer_t *first)
+{
+  vlib_buffer_cold (first)->total_length_not_including_first_buffer = 0;
+  first->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+  first->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+  cb->first = cb->last = first;
+  cb->last_is_shared = 0;
+}
+
+always_inline u32
+vlib_buffer_chain_builder_length (vlib_buffer_chain_builder_t *cb)
+{
+  return cb->first->current_length +
+	 vlib_buffer_cold (cb->first)->total_length_not_including_first_buffer;
+}
+
+/* Reserves len bytes of header in front of the chain, from the first
+ * buffer's headroom. Returns the start of the header. */
+always_inline void *
+vlib_buffer_chain_builder_push_header (vlib_buffer_chain_builder_t *cb,
+				       u8 len)
+{
+  return vlib_buffer_push_uninit (cb->first, len);
+}
+
+/* Adds len bytes, written by the caller, at the end of the last segment. */
+always_inline void
+vlib_buffer_chain_builder_increase_length (vlib_buffer_chain_builder_t *cb,
+					   i32 len)
+{
+  ASSERT (!cb->last_is_shared);
+  vlib_buffer_chain_increase_length (cb->first, cb->last, len);
+}
+
+/* Appends the empty buffer bi as a new segment. Returns where its data
+ * goes, the length is added with vlib_buffer_chain_builder_increase_length.
+ */
+always_inline u8 *
+vlib_buffer_chain_builder_add_segment (vlib_main_t *vm,
+				       vlib_buffer_chain_builder_t *cb, u32 bi)
+{
+  ASSERT (!cb->last_is_shared);
+  cb->last = vlib_buffer_chain_buffer (vm, cb->last, bi);
+  cb->last->current_data = 0;
+  return vlib_buffer_get_current (cb->last);
+}
+
+always_inline void
+vlib_buffer_chain_builder_link (vlib_main_t *vm,
+				vlib_buffer_chain_builder_t *cb, u32 bi,
+				int is_shared)
+{
+  vlib_buffer_t *b = vlib_get_buffer (vm, bi);
+
+  ASSERT (!cb->last_is_shared);
+  cb->last->next_buffer = bi;
+  cb->last->flags |= VLIB_BUFFER_NEXT_PRESENT;
+  vlib_buffer_cold (cb->first)->total_length_not_including_first_buffer +=
+    vlib_buffer_length_in_chain (vm, b);
+
+  while (1)
+    {
+      if (is_shared)
+	clib_atomic_add_fetch (&b->ref_count, 1);
+      if (!(b->flags & VLIB_BUFFER_NEXT_PRESENT))
+	break;
+      b = vlib_get_buffer (vm, b->next_buffer);
+    }
+
+  cb->last = b;
+  cb->last_is_shared = is_shared;
+}
+
+/* Appends buffer bi, and the buffers chained to it, without copying.
+ * The chain takes over the caller's reference. */
+always_inline void
+vlib_buffer_chain_builder_append (vlib_main_t *vm,
+				  vlib_buffer_chain_builder_t *cb, u32 bi)
+{
+  vlib_buffer_chain_builder_link (vm, cb, bi, /* is_shared */ 0);
+}
+
+/* Appends buffer bi, and the buffers chained to it, by reference. Each
+ * segment's ref_count is incremented, so the caller keeps its reference
+ * and the data must not be modified. As a shared tail can not be linked
+ * onwards, this must be the last append. */
+always_inline void
+vlib_buffer_chain_builder_append_shared (vlib_main_t *vm,
+					 vlib_buffer_chain_builder_t *cb,
+					 u32 bi)
+{
+  vlib_buffer_chain_builder_link (vm, cb, bi, /* is_shared */ 1);
+}
+
+/* Reserves len contiguous bytes at the end of the chain, e.g. for a
+ * trailer. Allocates a new segment if the last one has no room left.
+ * Returns the start of the reserved space, or 0 if out of buffers. */
+always_inline void *
+vlib_buffer_chain_builder_put (vlib_main_t *vm,
+			       vlib_buffer_chain_builder_t *cb, u16 len)
+{
+  u32 n_buffer_bytes = vlib_buffer_get_default_data_size (vm);
+  vlib_buffer_t *l = cb->last;
+  void *p;
+  u32 bi;
+
+  ASSERT (!cb->last_is_shared && len <= n_buffer_bytes);
+
+  if (l->current_data + l->current_length + len > n_buffer_bytes)
+    {
+      if (vlib_buffer_alloc_from_pool (vm, &bi, 1,
+				       cb->first->buffer_pool_index) != 1)
+	return 0;
+      vlib_buffer_chain_builder_add_segment (vm, cb, bi);
+      l = cb->last;
+    }
+
+  p = vlib_buffer_get_tail (l);
+  vlib_buffer_chain_increase_length (cb->first, l, len);
+  return p;
+}
+
 format_function_t format_vlib_buffer, format_vlib_buffer_and_data,
   format_vlib_buffer_contents, format_vlib_buffer_no_chain;
 
@@ -1524,7 +1885,7 @@ vlib_buffer_chain_linearize (vlib_main_t * vm, vlib_buffer_t * b)
   dst = vlib_buffer_get_tail (dst_b);
   dst_len = vlib_buffer_space_left_at_end (vm, dst_b);
 
-  b->total_length_not_including_first_buffer -= dst_len;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer -= dst_len;
 
   while (rem_len > 0)
     {
@@ -1624,7 +1985,7 @@ vlib_buffer_chain_linearize (vlib_main_t * vm, vlib_buffer_t * b)
 
   /* in case of a malformed chain buffer, we'll exit early from the loop. */
   ASSERT (0 == rem_len);
-  b->total_length_not_including_first_buffer -= rem_len;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer -= rem_len;
 
   if (to_free)
     vlib_buffer_free_one (vm, to_free);
@@ -1638,7 +1999,8 @@ vlib_buffer_chain_linearize (vlib_main_t * vm, vlib_buffer_t * b)
 	{
 	  /* no longer a chained buffer */
 	  dst_b->flags &= ~VLIB_BUFFER_TOTAL_LENGTH_VALID;
-	  dst_b->total_length_not_including_first_buffer = 0;
+	  vlib_buffer_cold (dst_b)->total_length_not_including_first_buffer =
+	    0;
 	}
     }
 
@@ -807,7 +807,7 @@ show_memory_usage (vlib_main_t * vm,
   clib_mem_main_t *mm = &clib_mem_main;
   int verbose __attribute__ ((unused)) = 0;
   int api_segment = 0, stats_segment = 0, main_heap = 0, numa_heaps = 0;
-  int map = 0;
+  int map = 0, slab = 0;
   clib_error_t *error;
   u32 index = 0;
   int i;
@@ -829,6 +829,8 @@ show_memory_usage (vlib_main_t * vm,
 	numa_heaps = 1;
       else if (unformat (input, "map"))
 	map = 1;
+      else if (unformat (input, "slab"))
+	slab = 1;
       else
 	{
 	  error = clib_error_return (0, "unknown input `%U'",
@@ -837,10 +839,10 @@ show_memory_usage (vlib_main_t * vm,
 	}
     }
 
-  if ((api_segment + stats_segment + main_heap + numa_heaps + map) == 0)
-    return clib_error_return
-      (0, "Need one of api-segment, stats-segment, main-heap, numa-heaps "
-       "or map");
+  if ((api_segment + stats_segment + main_heap + numa_heaps + map + slab) ==
+      0)
+    return clib_error_return (0, "Need one of api-segment, stats-segment, "
+				 "main-heap, numa-heaps, map or slab");
 
   if (api_segment)
     {
@@ -961,6 +963,13 @@ show_memory_usage (vlib_main_t * vm,
 	  }
 	vec_free (s);
       }
+    if (slab)
+      {
+	clib_mem_slab_handle_t h = 0;
+
+	while ((h = clib_mem_slab_get_next (h)))
+	  vlib_cli_output (vm, "%U\n", format_clib_mem_slab, h, verbose);
+      }
   }
   return 0;
 }
@@ -968,7 +977,7 @@ show_memory_usage (vlib_main_t * vm,
 VLIB_CLI_COMMAND (show_memory_usage_command, static) = {
   .path = "show memory",
   .short_help = "show memory [api-segment][stats-segment][verbose]\n"
-		"            [numa-heaps][map][main-heap]",
+		"            [numa-heaps][map][main-heap][slab]",
   .function = show_memory_usage,
 };
 
@@ -276,6 +276,71 @@ vlib_prefetch_combined_counter (const vlib_combined_counter_main_t *cm,
   clib_prefetch_store (cpu_counters + index);
 }
 
+/** A combined counter accumulator for one node dispatch.
+    Consecutive increments of the same counter index are summed in the
+    accumulator and only written to the counter when the index changes or
+    the accumulator is flushed, so a frame whose packets mostly hit the
+    same adjacency or interface does one counter update instead of one per
+    packet. The caller must flush before the dispatch returns.
+*/
+typedef struct
+{
+  vlib_counter_t *counters; /**< this thread's counters */
+  u32 index;		    /**< counter index being accumulated */
+  u32 n_packets;	    /**< packets accumulated for index */
+  u64 n_bytes;		    /**< bytes accumulated for index */
+} vlib_combined_counter_acc_t;
+
+/** Start accumulating increments for a combined counter collection
+    @param acc - (vlib_combined_counter_acc_t *) accumulator
+    @param cm - (vlib_combined_counter_main_t *) combined counter main pointer
+    @param thread_index - (u32) the current cpu index
+*/
+always_inline void
+vlib_combined_counter_acc_init (vlib_combined_counter_acc_t *acc,
+				vlib_combined_counter_main_t *cm,
+				clib_thread_index_t thread_index)
+{
+  acc->counters = cm->counters[thread_index];
+  acc->index = ~0;
+  acc->n_packets = 0;
+  acc->n_bytes = 0;
+}
+
+/** Write the pending increments back to the counter
+    @param acc - (vlib_combined_counter_acc_t *) accumulator
+*/
+always_inline void
+vlib_combined_counter_acc_flush (vlib_combined_counter_acc_t *acc)
+{
+  if (acc->n_packets)
+    {
+      acc->counters[acc->index].packets += acc->n_packets;
+      acc->counters[acc->index].bytes += acc->n_bytes;
+      acc->n_packets = 0;
+      acc->n_bytes = 0;
+    }
+}
+
+/** Accumulate an increment of a combined counter
+    @param acc - (vlib_combined_counter_acc_t *) accumulator
+    @param index - (u32) index of the counter to increment
+    @param n_packets - (u32) number of packets to add to the counter
+    @param n_bytes - (u64) number of bytes to add to the counter
+*/
+always_inline void
+vlib_combined_counter_acc_add (vlib_combined_counter_acc_t *acc, u32 index,
+			       u32 n_packets, u64 n_bytes)
+{
+  if (PREDICT_FALSE (index != acc->index))
+    {
+      vlib_combined_counter_acc_flush (acc);
+      acc->index = index;
+    }
+  acc->n_packets += n_packets;
+  acc->n_bytes += n_bytes;
+}
+
 
 /** Get the value of a combined counter, never called in the speed path
     Scrapes the entire set of per-thread counters. Innacurate unless
@@ -141,6 +141,10 @@ vlib_file_poll (vlib_main_t *vm)
   if (is_main && vm->api_queue_nonempty)
     goto skip_loops;
 
+  /* frames held back for coalescing are due within microseconds */
+  if (vec_len (nm->held_frames))
+    goto epoll;
+
   if (is_main == 0)
     {
       if (*vlib_worker_threads->wait_at_barrier)
@@ -38,6 +38,7 @@
  */
 
 #include <math.h>
+#include <fcntl.h>
 #include <vppinfra/format.h>
 #include <vlib/vlib.h>
 #include <vlib/threads.h>
@@ -213,6 +214,39 @@ vlib_frame_free (vlib_main_t *vm, vlib_frame_t *f)
   fs->n_alloc_frames -= 1;
 }
 
+void
+vlib_discard_pending_frames (vlib_main_t *vm, u32 first)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  vlib_pending_frame_t *p;
+
+  ASSERT (first <= vec_len (nm->pending_frames));
+
+  vec_foreach (p, nm->pending_frames + first)
+    {
+      vlib_frame_t *f = p->frame;
+      vlib_next_frame_t *nf = 0;
+
+      if (p->next_frame_index != VLIB_PENDING_FRAME_NO_NEXT_FRAME)
+	nf = vec_elt_at_index (nm->next_frames, p->next_frame_index);
+
+      vlib_buffer_free (vm, vlib_frame_vector_args (f), f->n_vectors);
+      f->frame_flags &= ~(VLIB_FRAME_PENDING | VLIB_FRAME_NO_APPEND);
+
+      /* keep the next frame, but empty, as if it had been dispatched */
+      if (nf && nf->frame == f)
+	{
+	  nf->flags &= ~VLIB_FRAME_TRACE;
+	  f->n_vectors = 0;
+	  f->flags = 0;
+	}
+      else if (f->frame_flags & VLIB_FRAME_FREE_AFTER_DISPATCH)
+	vlib_frame_free (vm, f);
+    }
+
+  vec_set_len (nm->pending_frames, first);
+}
+
 static clib_error_t *
 show_frame_stats (vlib_main_t * vm,
 		  unformat_input_t * input, vlib_cli_command_t * cmd)
@@ -286,6 +320,7 @@ vlib_next_frame_change_ownership (vlib_main_t * vm,
       if (next_frame->flags & VLIB_FRAME_PENDING)
 	{
 	  vlib_pending_frame_t *p;
+	  vlib_held_frame_t *h;
 	  if (next_frame->frame != NULL)
 	    {
 	      vec_foreach (p, nm->pending_frames)
@@ -296,6 +331,12 @@ vlib_next_frame_change_ownership (vlib_main_t * vm,
 		      next_frame - vm->node_main.next_frames;
 		  }
 	      }
+	      vec_foreach (h, nm->held_frames)
+		{
+		  if (h->pending.frame == next_frame->frame)
+		    h->pending.next_frame_index =
+		      next_frame - vm->node_main.next_frames;
+		}
 	    }
 	}
     }
@@ -313,6 +354,24 @@ vlib_next_frame_change_ownership (vlib_main_t * vm,
   ASSERT (next_frame->flags & VLIB_FRAME_OWNER);
 }
 
+/* Move a held frame back to the pending vector. */
+static void
+vlib_held_frame_release (vlib_main_t *vm, vlib_frame_t *f)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  u32 i;
+
+  vec_foreach_index (i, nm->held_frames)
+    {
+      if (nm->held_frames[i].pending.frame == f)
+	{
+	  vec_add1 (nm->pending_frames, nm->held_frames[i].pending);
+	  vec_delete (nm->held_frames, 1, i);
+	  break;
+	}
+    }
+}
+
 /* Make sure that magic number is still there.
    Otherwise, it is likely that caller has overrun frame arguments. */
 always_inline void
@@ -372,6 +431,10 @@ vlib_get_next_frame_internal (vlib_main_t * vm,
 	  f_old->frame_flags |= VLIB_FRAME_FREE_AFTER_DISPATCH;
 	}
 
+      /* A held frame must still be dispatched ahead of its replacement. */
+      if (PREDICT_FALSE (f->frame_flags & VLIB_FRAME_HELD))
+	vlib_held_frame_release (vm, f);
+
       /* Allocate new frame to replace full one. */
       f = nf->frame = vlib_frame_alloc (vm, node, next_index);
       n_used = f->n_vectors;
@@ -636,6 +699,132 @@ VLIB_CLI_COMMAND (elog_clear_cli, static) = {
 };
 
 #ifdef CLIB_UNIX
+static u8 *
+format_chrome_trace_string (u8 *s, va_list *args)
+{
+  u8 *v = va_arg (*args, u8 *);
+  u8 *c;
+
+  vec_foreach (c, v)
+    {
+      if (*c == 0)
+	break;
+      if (*c == '"' || *c == '\\')
+	s = format (s, "\\%c", *c);
+      else if (*c < 0x20)
+	s = format (s, "\\u%04x", *c);
+      else
+	vec_add1 (s, *c);
+    }
+  return s;
+}
+
+/*
+ * Events in the Chrome trace event JSON format, which Perfetto and
+ * chrome://tracing load. Graph dispatch events become duration events
+ * named after the node, on one timeline per thread, the vector count
+ * as argument. All other events are instant events on their track.
+ */
+static u8 *
+format_elog_chrome_trace (u8 *s, va_list *args)
+{
+  vlib_main_t *vm = va_arg (*args, vlib_main_t *);
+  elog_main_t *em = va_arg (*args, elog_main_t *);
+  elog_event_t *es = va_arg (*args, elog_event_t *);
+  elog_event_type_t *et;
+  elog_event_t *e;
+  elog_track_t *t;
+  u32 *node_by_type = 0;
+  u8 *text = 0;
+  char *sep = "";
+
+  /* event type to node index, low bit set for returns */
+  vec_validate_init_empty (node_by_type, vec_len (em->event_types), ~0);
+  for (u32 i = 0; i < vec_len (vm->node_call_elog_event_types); i++)
+    {
+      et = vm->node_call_elog_event_types + i;
+      if (et->type_index_plus_one)
+	node_by_type[et->type_index_plus_one - 1] = i << 1;
+      et = vm->node_return_elog_event_types + i;
+      if (et->type_index_plus_one)
+	node_by_type[et->type_index_plus_one - 1] = i << 1 | 1;
+    }
+
+  s = format (s, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+  vec_foreach (t, em->tracks)
+    {
+      s = format (s,
+		  "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,"
+		  "\"tid\":%u,\"args\":{\"name\":\"%U\"}}",
+		  sep, t - em->tracks, format_chrome_trace_string, t->name);
+      sep = ",";
+    }
+
+  vec_foreach (e, es)
+    {
+      u32 nt = node_by_type[e->event_type];
+
+      if (nt != ~0)
+	{
+	  vlib_node_t *n = vlib_get_node (vm, nt >> 1);
+	  s = format (s,
+		      "%s\n{\"ph\":\"%c\",\"name\":\"%U\",\"pid\":0,"
+		      "\"tid\":%u,\"ts\":%.3f,\"args\":{\"vectors\":%u}}",
+		      sep, nt & 1 ? 'E' : 'B', format_chrome_trace_string,
+		      n->name, e->track, e->time * 1e6,
+		      clib_mem_unaligned (e->data, u32));
+	}
+      else
+	{
+	  vec_reset_length (text);
+	  text = format (text, "%U", format_elog_event, em, e);
+	  s = format (s,
+		      "%s\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%U\","
+		      "\"pid\":0,\"tid\":%u,\"ts\":%.3f}",
+		      sep, format_chrome_trace_string, text, e->track,
+		      e->time * 1e6);
+	}
+      sep = ",";
+    }
+
+  s = format (s, "\n]}\n");
+  vec_free (node_by_type);
+  vec_free (text);
+  return s;
+}
+
+static clib_error_t *
+elog_save_chrome_trace (vlib_main_t *vm, elog_main_t *em, char *file)
+{
+  clib_error_t *error = 0;
+  elog_event_t *es;
+  u8 *s;
+  int fd;
+
+  /* copy the ring with the workers stopped, format it with them running */
+  vlib_worker_thread_barrier_sync (vm);
+  es = elog_peek_events (em);
+  vlib_worker_thread_barrier_release (vm);
+
+  s = format (0, "%U", format_elog_chrome_trace, vlib_get_first_main (), em,
+	      es);
+  vec_free (es);
+
+  fd = open (file, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0)
+    error = clib_error_return_unix (0, "open `%s'", file);
+  else
+    {
+      if (write (fd, s, vec_len (s)) != vec_len (s))
+	error = clib_error_return_unix (0, "write `%s'", file);
+      close (fd);
+    }
+
+  vec_free (s);
+  return error;
+}
+
 static clib_error_t *
 elog_save_buffer (vlib_main_t * vm,
 		  unformat_input_t * input, vlib_cli_command_t * cmd)
@@ -643,6 +832,7 @@ elog_save_buffer (vlib_main_t * vm,
   elog_main_t *em = &vlib_global_main.elog_main;
   char *file, *chroot_file;
   clib_error_t *error = 0;
+  int chrome = 0;
 
   if (!unformat (input, "%s", &file))
     {
@@ -651,6 +841,9 @@ elog_save_buffer (vlib_main_t * vm,
       return 0;
     }
 
+  if (unformat (input, "chrome"))
+    chrome = 1;
+
   /* It's fairly hard to get "../oopsie" through unformat; just in case */
   if (strstr (file, "..") || strchr (file, '/'))
     {
@@ -666,9 +859,14 @@ elog_save_buffer (vlib_main_t * vm,
 		   elog_n_events_in_buffer (em),
 		   elog_buffer_capacity (em), chroot_file);
 
-  vlib_worker_thread_barrier_sync (vm);
-  error = elog_write_file (em, chroot_file, 1 /* flush ring */ );
-  vlib_worker_thread_barrier_release (vm);
+  if (chrome)
+    error = elog_save_chrome_trace (vm, em, chroot_file);
+  else
+    {
+      vlib_worker_thread_barrier_sync (vm);
+      error = elog_write_file (em, chroot_file, 1 /* flush ring */);
+      vlib_worker_thread_barrier_release (vm);
+    }
   vec_free (chroot_file);
   return error;
 }
@@ -684,7 +882,8 @@ vlib_post_mortem_dump (void)
 
 VLIB_CLI_COMMAND (elog_save_cli, static) = {
   .path = "event-logger save",
-  .short_help = "event-logger save <filename> (saves log in /tmp/<filename>)",
+  .short_help = "event-logger save <filename> [chrome] (saves log in "
+		"/tmp/<filename>, chrome for chrome trace event json)",
   .function = elog_save_buffer,
 };
 
@@ -949,6 +1148,21 @@ dispatch_node (vlib_main_t *vm, vlib_node_runtime_t *node,
   vm->main_loop_vectors_processed += n;
   vm->main_loop_nodes_processed += n > 0;
 
+  if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_CLOCKS_HISTOGRAM))
+    vlib_stats_histogram_add (
+      vlib_get_node (vm, node->node_index)->clocks_histogram_index,
+      vm->thread_index, t - last_time_stamp);
+
+  if (type == VLIB_NODE_TYPE_INPUT &&
+      PREDICT_FALSE (vm->dispatch_sample_interval_end != 0))
+    {
+      vm->dispatch_sample_polls++;
+      vm->dispatch_sample_zero_polls += n == 0;
+      vm->dispatch_sample_vectors += n;
+      vm->dispatch_sample_max_vectors =
+	clib_max (vm->dispatch_sample_max_vectors, n);
+    }
+
   v = vlib_node_runtime_update_stats (vm, node,
 				      /* n_calls */ 1,
 				      /* n_vectors */ n,
@@ -1040,9 +1254,42 @@ dispatch_node (vlib_main_t *vm, vlib_node_runtime_t *node,
   return t;
 }
 
+/* Hold a small pending frame to a coalescing node back, so that the
+   node's upstream can add to it in the next main loop iterations. */
+static int
+vlib_pending_frame_hold (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			 vlib_pending_frame_t *p, vlib_frame_t *f, u64 now,
+			 int may_hold)
+{
+  vlib_node_t *n = vlib_get_node (vm, rt->node_index);
+  vlib_held_frame_t *h;
+
+  if (!(f->frame_flags & VLIB_FRAME_HELD))
+    {
+      n->coalesce_stats.frames_in++;
+      n->coalesce_stats.vectors_in += f->n_vectors;
+
+      if (may_hold && f->n_vectors < n->coalesce_threshold &&
+	  p->next_frame_index != VLIB_PENDING_FRAME_NO_NEXT_FRAME)
+	{
+	  vec_add2 (vm->node_main.held_frames, h, 1);
+	  h->pending = p[0];
+	  h->deadline = now + n->coalesce_hold_clocks;
+	  h->n_vectors = f->n_vectors;
+	  f->frame_flags |= VLIB_FRAME_HELD;
+	  return 1;
+	}
+    }
+
+  f->frame_flags &= ~VLIB_FRAME_HELD;
+  n->coalesce_stats.frames_out++;
+  n->coalesce_stats.vectors_out += f->n_vectors;
+  return 0;
+}
+
 static u64
 dispatch_pending_node (vlib_main_t * vm, uword pending_frame_index,
-		       u64 last_time_stamp)
+		       u64 last_time_stamp, int may_hold)
 {
   vlib_node_main_t *nm = &vm->node_main;
   vlib_frame_t *f;
@@ -1058,6 +1305,11 @@ dispatch_pending_node (vlib_main_t * vm, uword pending_frame_index,
 			p->node_runtime_index);
 
   f = vlib_get_frame (vm, p->frame);
+
+  if (PREDICT_FALSE (n->flags & VLIB_NODE_FLAG_COALESCE) &&
+      vlib_pending_frame_hold (vm, n, p, f, last_time_stamp, may_hold))
+    return last_time_stamp;
+
   if (p->next_frame_index == VLIB_PENDING_FRAME_NO_NEXT_FRAME)
     {
       /* No next frame: so use placeholder on stack. */
@@ -1436,6 +1688,48 @@ dispatch_suspended_process (vlib_main_t *vm, vlib_process_restore_t *r,
   return t;
 }
 
+static_always_inline vlib_process_priority_t
+process_restore_priority (vlib_node_main_t *nm, vlib_process_restore_t *r)
+{
+  /* timed events only queue event data, treat them as normal */
+  if (r->reason == VLIB_PROCESS_RESTORE_REASON_TIMED_EVENT)
+    return VLIB_PROCESS_PRIORITY_NORMAL;
+  return nm->processes[r->runtime_index]->priority;
+}
+
+/* Order ready processes high priority first, low priority last, keeping
+   the arrival order within each class. */
+static void
+process_restore_sort_by_priority (vlib_node_main_t *nm)
+{
+  vlib_process_restore_t *res;
+  vlib_process_priority_t prio;
+  u32 n_high = 0, n_low = 0;
+  static const vlib_process_priority_t order[] = {
+    VLIB_PROCESS_PRIORITY_HIGH,
+    VLIB_PROCESS_PRIORITY_NORMAL,
+    VLIB_PROCESS_PRIORITY_LOW,
+  };
+
+  vec_foreach (res, nm->process_restore_current)
+    {
+      prio = process_restore_priority (nm, res);
+      n_high += prio == VLIB_PROCESS_PRIORITY_HIGH;
+      n_low += prio == VLIB_PROCESS_PRIORITY_LOW;
+    }
+
+  if (n_high + n_low == 0)
+    return;
+
+  vec_reset_length (nm->process_restore_sorted);
+  for (int i = 0; i < ARRAY_LEN (order); i++)
+    vec_foreach (res, nm->process_restore_current)
+      if (process_restore_priority (nm, res) == order[i])
+	vec_add1 (nm->process_restore_sorted, *res);
+
+  CLIB_SWAP (nm->process_restore_current, nm->process_restore_sorted);
+}
+
 static __clib_warn_unused_result u32 *
 process_expired_timers (u32 *v)
 {
@@ -1474,6 +1768,47 @@ process_expired_timers (u32 *v)
   return v;
 }
 
+/* Dispatch the held frames which have filled up or whose deadline has
+   passed, or all of them if flushing. */
+static u64
+dispatch_held_frames (vlib_main_t *vm, u64 now, int flush)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  vlib_held_frame_t *h;
+  u32 i, n_held = 0;
+
+  vec_foreach (h, nm->held_frames)
+    {
+      vlib_node_runtime_t *rt =
+	vec_elt_at_index (nm->nodes_by_type[VLIB_NODE_TYPE_INTERNAL],
+			  h->pending.node_runtime_index);
+      vlib_node_t *n = vlib_get_node (vm, rt->node_index);
+      vlib_frame_t *f = h->pending.frame;
+
+      /* Vectors added while held would have been dispatched as a frame */
+      if (f->n_vectors > h->n_vectors)
+	{
+	  n->coalesce_stats.frames_in++;
+	  n->coalesce_stats.vectors_in += f->n_vectors - h->n_vectors;
+	  h->n_vectors = f->n_vectors;
+	}
+
+      if (flush || now >= h->deadline ||
+	  f->n_vectors >= n->coalesce_threshold ||
+	  !(rt->flags & VLIB_NODE_FLAG_COALESCE))
+	vec_add1 (nm->pending_frames, h->pending);
+      else
+	nm->held_frames[n_held++] = h[0];
+    }
+  vec_set_len (nm->held_frames, n_held);
+
+  for (i = 0; i < _vec_len (nm->pending_frames); i++)
+    now = dispatch_pending_node (vm, i, now, !flush);
+  vec_set_len (nm->pending_frames, 0);
+
+  return now;
+}
+
 static_always_inline void
 vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 {
@@ -1539,8 +1874,13 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 	    vlib_worker_flush_pending_rpc_requests (vm);
 	}
 
-      if (!is_main)
-	vlib_worker_thread_barrier_check ();
+      if (!is_main && PREDICT_FALSE (*vlib_worker_threads->wait_at_barrier))
+	{
+	  /* A node refork under the barrier frees the held frames */
+	  if (vec_len (nm->held_frames))
+	    cpu_time_now = dispatch_held_frames (vm, cpu_time_now, 1);
+	  vlib_worker_thread_barrier_check ();
+	}
 
       if (PREDICT_FALSE (vm->check_frame_queues + frame_queue_check_counter))
 	{
@@ -1632,10 +1972,18 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
          Process pending vector until there is nothing left.
          All pending vectors will be processed from input -> output. */
       for (i = 0; i < _vec_len (nm->pending_frames); i++)
-	cpu_time_now = dispatch_pending_node (vm, i, cpu_time_now);
+	cpu_time_now = dispatch_pending_node (vm, i, cpu_time_now, 1);
       /* Reset pending vector for next iteration. */
       vec_set_len (nm->pending_frames, 0);
 
+      /* Dispatch the held frames which are due. */
+      if (PREDICT_FALSE (vec_len (nm->held_frames)))
+	cpu_time_now = dispatch_held_frames (vm, cpu_time_now, 0);
+
+      /* Return buffers completed by tx during this loop to the buffer pool
+	 at once, so rx refill in the next loop gets them while still hot */
+      vlib_buffer_free_deferred_flush (vm);
+
       if (is_main)
 	{
           ELOG_TYPE_DECLARE (es) =
@@ -1672,8 +2020,11 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 
 	  if (PREDICT_FALSE (_vec_len (nm->process_restore_current) > 0))
 	    {
+	      u64 process_start_time = clib_cpu_time_now ();
 	      uword i;
 
+	      process_restore_sort_by_priority (nm);
+
 	      for (i = 0; i < _vec_len (nm->process_restore_current); i++)
 		{
 		  vlib_process_restore_t *res =
@@ -1707,6 +2058,17 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 		  else
 		    {
 		      cpu_time_now = clib_cpu_time_now ();
+		      if (PREDICT_FALSE (
+			    nm->process_low_priority_budget_clocks &&
+			    nm->processes[res->runtime_index]->priority ==
+			      VLIB_PROCESS_PRIORITY_LOW &&
+			    cpu_time_now - process_start_time >
+			      nm->process_low_priority_budget_clocks))
+			{
+			  /* out of budget, run it next time around */
+			  vec_add1 (nm->process_restore_next, *res);
+			  continue;
+			}
 		      cpu_time_now =
 			dispatch_suspended_process (vm, res, cpu_time_now);
 		    }
@@ -1752,6 +2114,10 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 	  vm->loop_interval_end = now + 2e-4;
 	  vm->loops_this_reporting_interval = 0;
 	}
+
+      if (PREDICT_FALSE (vm->dispatch_sample_interval_end != 0 &&
+			 now >= vm->dispatch_sample_interval_end))
+	vlib_stats_dispatch_sample_push (vm, now);
     }
 }
 
@@ -158,6 +158,10 @@ typedef struct vlib_main_t
   /* buffer main structure. */
   vlib_buffer_main_t *buffer_main;
 
+  /* buffers freed by vlib_buffer_free_no_next_deferred (), returned to the
+     buffer pool once per main loop iteration */
+  u32 *deferred_free_buffers;
+
   /* physical memory main structure. */
   vlib_physmem_main_t physmem_main;
 
@@ -240,6 +244,13 @@ typedef struct vlib_main_t
   f64 seconds_per_loop;
   f64 damping_constant;
 
+  /* Input dispatches of the current sample interval, 0 end if disabled */
+  f64 dispatch_sample_interval_end;
+  u32 dispatch_sample_polls;
+  u32 dispatch_sample_zero_polls;
+  u32 dispatch_sample_max_vectors;
+  u64 dispatch_sample_vectors;
+
   /*
    * Barrier epoch - Set to current time, each time barrier_sync or
    * barrier_release is called with zero recursion.
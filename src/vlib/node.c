@@ -39,6 +39,7 @@
 
 #include <vlib/vlib.h>
 #include <vlib/threads.h>
+#include <vlib/stats/stats.h>
 
 /* Query node given name. */
 vlib_node_t *
@@ -100,6 +101,7 @@ vlib_node_runtime_update (vlib_main_t * vm, u32 node_index, u32 next_index)
   vlib_node_t *node, *next_node;
   vlib_next_frame_t *nf;
   vlib_pending_frame_t *pf;
+  vlib_held_frame_t *h;
   i32 i, j, n_insert;
 
   node = vec_elt (nm->nodes, node_index);
@@ -130,6 +132,12 @@ vlib_node_runtime_update (vlib_main_t * vm, u32 node_index, u32 next_index)
 	    && pf->next_frame_index >= i)
 	  pf->next_frame_index += n_insert;
       }
+      vec_foreach (h, nm->held_frames)
+	{
+	  if (h->pending.next_frame_index != VLIB_PENDING_FRAME_NO_NEXT_FRAME &&
+	      h->pending.next_frame_index >= i)
+	    h->pending.next_frame_index += n_insert;
+	}
       pool_foreach (pf, nm->suspended_process_frames)  {
 	  if (pf->next_frame_index != ~0 && pf->next_frame_index >= i)
 	    pf->next_frame_index += n_insert;
@@ -397,6 +405,7 @@ vlib_register_node (vlib_main_t *vm, vlib_node_registration_t *r, char *fmt,
   n->index = vec_len (nm->nodes);
   n->node_fn_registrations = r->node_fn_registrations;
   n->protocol_hint = r->protocol_hint;
+  n->clocks_histogram_index = ~0;
 
   vec_add1 (nm->nodes, n);
 
@@ -531,6 +540,7 @@ vlib_register_node (vlib_main_t *vm, vlib_node_registration_t *r, char *fmt,
 	p = clib_mem_alloc_aligned (sizeof (p[0]), CLIB_CACHE_LINE_BYTES);
 	clib_memset (p, 0, sizeof (p[0]));
 	p->log2_n_stack_bytes = log2_n_stack_bytes;
+	p->priority = r->process_priority;
 
 	p->stack = clib_mem_vm_map_stack (1ULL << log2_n_stack_bytes,
 					  CLIB_MEM_PAGE_SZ_DEFAULT,
@@ -933,6 +943,64 @@ vlib_node_set_march_variant (vlib_main_t *vm, u32 node_index,
   return -1;
 }
 
+void
+vlib_node_set_coalesce (vlib_main_t *vm, u32 node_index, u16 threshold,
+			u32 hold_usec)
+{
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *tvm = vlib_get_main_by_index (i);
+      vlib_node_t *n = vlib_get_node (tvm, node_index);
+      vlib_node_runtime_t *nrt = vlib_node_get_runtime (tvm, node_index);
+
+      ASSERT (n->type == VLIB_NODE_TYPE_INTERNAL);
+
+      n->coalesce_threshold = threshold;
+      n->coalesce_hold_usec = hold_usec;
+      n->coalesce_hold_clocks =
+	hold_usec * 1e-6 * tvm->clib_time.clocks_per_second;
+
+      if (threshold && hold_usec)
+	{
+	  n->flags |= VLIB_NODE_FLAG_COALESCE;
+	  nrt->flags |= VLIB_NODE_FLAG_COALESCE;
+	}
+      else
+	{
+	  n->flags &= ~VLIB_NODE_FLAG_COALESCE;
+	  nrt->flags &= ~VLIB_NODE_FLAG_COALESCE;
+	}
+    }
+}
+
+void
+vlib_node_set_clocks_histogram (vlib_main_t *vm, u32 node_index, int enable)
+{
+  vlib_node_t *n = vlib_get_node (vm, node_index);
+  u32 entry_index = n->clocks_histogram_index;
+
+  if (enable && entry_index == ~0)
+    entry_index = vlib_stats_add_histogram (
+      "/nodes/%U/clocks-histogram", format_vlib_stats_symlink, n->name);
+  else if (!enable && entry_index != ~0)
+    {
+      vlib_stats_remove_entry (entry_index);
+      entry_index = ~0;
+    }
+
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *tvm = vlib_get_main_by_index (i);
+      vlib_node_runtime_t *nrt = vlib_node_get_runtime (tvm, node_index);
+
+      vlib_get_node (tvm, node_index)->clocks_histogram_index = entry_index;
+      if (entry_index != ~0)
+	nrt->flags |= VLIB_NODE_FLAG_CLOCKS_HISTOGRAM;
+      else
+	nrt->flags &= ~VLIB_NODE_FLAG_CLOCKS_HISTOGRAM;
+    }
+}
+
 clib_error_t *
 vlib_node_main_lazy_next_update (vlib_main_t *vm)
 {
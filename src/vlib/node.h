@@ -130,6 +130,16 @@ typedef struct _vlib_node_fn_registration
   struct _vlib_node_fn_registration *next_registration;
 } vlib_node_fn_registration_t;
 
+/* Order in which ready processes are resumed within a main loop
+   iteration; low priority ones may be deferred, see
+   vlib_node_main_t.process_low_priority_budget_clocks */
+typedef enum
+{
+  VLIB_PROCESS_PRIORITY_NORMAL = 0,
+  VLIB_PROCESS_PRIORITY_HIGH,
+  VLIB_PROCESS_PRIORITY_LOW,
+} __clib_packed vlib_process_priority_t;
+
 typedef struct _vlib_node_registration
 {
   /* Vector processing function for this node. */
@@ -173,6 +183,9 @@ typedef struct _vlib_node_registration
   /* Process stack size. */
   u16 process_log2_n_stack_bytes;
 
+  /* Process scheduling priority. */
+  vlib_process_priority_t process_priority;
+
   /* Number of bytes of per-node run time data. */
   u8 runtime_data_bytes;
 
@@ -237,9 +250,18 @@ static __clib_unused vlib_node_registration_t __clib_unused_##x
 #define CLIB_MARCH_VARIANT_STR _CLIB_MARCH_VARIANT_STR(CLIB_MARCH_VARIANT)
 #endif
 
+/* Optionally group all node functions in .text.hot, which the default
+   linker scripts place contiguously at the start of .text, so the
+   dataplane stays within fewer i-cache lines and iTLB pages */
+#ifdef VLIB_NODE_FN_HOT_SECTION
+#define __vlib_node_fn_section __attribute__ ((hot, section (".text.hot")))
+#else
+#define __vlib_node_fn_section
+#endif
+
 #define VLIB_NODE_FN(node)                                                    \
   uword CLIB_MARCH_SFX (node##_fn) (vlib_main_t *, vlib_node_runtime_t *,     \
-				    vlib_frame_t *);                          \
+				    vlib_frame_t *) __vlib_node_fn_section;   \
   static vlib_node_fn_registration_t CLIB_MARCH_SFX (                         \
     node##_fn_registration) = {                                               \
     .function = &CLIB_MARCH_SFX (node##_fn),                                  \
@@ -267,6 +289,13 @@ typedef struct
   u64 max_clock_n;
 } vlib_node_stats_t;
 
+typedef struct
+{
+  /* Frames and vectors enqueued to, and dispatched by, a coalescing node. */
+  u64 frames_in, vectors_in;
+  u64 frames_out, vectors_out;
+} vlib_node_coalesce_stats_t;
+
 #define foreach_vlib_node_state					\
   /* Input node is called each iteration of main loop.		\
      This is the default (zero). */				\
@@ -355,6 +384,12 @@ typedef struct vlib_node_t
 #define VLIB_NODE_FLAG_ADAPTIVE_MODE			     (1 << 9)
 #define VLIB_NODE_FLAG_ALLOW_LAZY_NEXT_NODES		     (1 << 10)
 
+  /* Small pending frames to this node are held back for coalescing. */
+#define VLIB_NODE_FLAG_COALESCE				     (1 << 11)
+
+  /* Dispatch clocks are recorded in a stats segment histogram. */
+#define VLIB_NODE_FLAG_CLOCKS_HISTOGRAM			     (1 << 12)
+
   /* State for input nodes. */
   u8 state;
 
@@ -421,6 +456,21 @@ typedef struct vlib_node_t
 
   /* Node function candidate registration with priority */
   vlib_node_fn_registration_t *node_fn_registrations;
+
+  /* Measured clocks per vector by march variant, see
+     'set node function autotune'. Zero if not measured. */
+  f64 *autotune_clocks_per_vector;
+
+  /* Pending frames with fewer vectors than the threshold are held back
+     for up to coalesce_hold_clocks, see vlib_node_set_coalesce. */
+  u16 coalesce_threshold;
+  u32 coalesce_hold_usec;
+  u64 coalesce_hold_clocks;
+  vlib_node_coalesce_stats_t coalesce_stats;
+
+  /* Stats segment histogram of clocks per dispatch, see
+     vlib_node_set_clocks_histogram. */
+  u32 clocks_histogram_index;
 } vlib_node_t;
 
 #define VLIB_INVALID_NODE_INDEX ((u32) ~0)
@@ -488,6 +538,9 @@ typedef struct
   /* Set when frame has traced packets. */
 #define VLIB_FRAME_TRACE VLIB_NODE_FLAG_TRACE
 
+  /* Set when frame has been held back for coalescing. */
+#define VLIB_FRAME_HELD (1 << 13)
+
   /* Number of vectors enqueue to this next since last overflow. */
   u32 vectors_since_last_overflow;
 } vlib_next_frame_t;
@@ -515,6 +568,18 @@ typedef struct
 #define VLIB_PENDING_FRAME_NO_NEXT_FRAME ((u32) ~0)
 } vlib_pending_frame_t;
 
+/* A pending frame held back for coalescing. */
+typedef struct
+{
+  vlib_pending_frame_t pending;
+
+  /* CPU time after which the frame is dispatched, whatever its size. */
+  u64 deadline;
+
+  /* Number of vectors in the frame when last checked. */
+  u16 n_vectors;
+} vlib_held_frame_t;
+
 typedef struct vlib_node_runtime_t
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);	/**< cacheline mark */
@@ -667,6 +732,9 @@ typedef struct
   /* Process is added to resume list due to pending event  */
   u8 event_resume_pending : 1;
 
+  /* Scheduling priority, see vlib_process_priority_t. */
+  vlib_process_priority_t priority;
+
   /* Size of process stack. */
   u16 log2_n_stack_bytes;
 
@@ -779,6 +847,9 @@ typedef struct
   /* Vector of internal node's frames waiting to be called. */
   vlib_pending_frame_t *pending_frames;
 
+  /* Vector of pending frames held back for coalescing. */
+  vlib_held_frame_t *held_frames;
+
   vlib_signal_timed_event_data_t *signal_timed_event_data_pool;
 
   /* Vector of process nodes waiting for restore */
@@ -791,6 +862,13 @@ typedef struct
    */
   vlib_process_restore_t *process_restore_next;
 
+  /* Scratch vector for ordering process_restore_current by priority. */
+  vlib_process_restore_t *process_restore_sorted;
+
+  /* Once processes have run this long in one main loop iteration, low
+     priority ones are deferred to the next. Zero for no limit. */
+  u64 process_low_priority_budget_clocks;
+
   /* CPU time of next process to be ready on timing wheel. */
   f64 time_next_process_ready;
 
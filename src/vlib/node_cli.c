@@ -652,6 +652,8 @@ clear_node_runtime (vlib_main_t * vm,
 
 	  r = vlib_node_get_runtime (stat_vm, n->index);
 	  r->max_clock = 0;
+
+	  clib_memset (&n->coalesce_stats, 0, sizeof (n->coalesce_stats));
 	}
       /* Note: input/output rates computed using vlib_global_main */
       nm->time_last_runtime_stats_clear = vlib_time_now (vm);
@@ -757,10 +759,17 @@ show_node (vlib_main_t * vm, unformat_input_t * input,
 	{
 	  v = vec_elt_at_index (vm->node_main.variants, fnr->march_variant);
 	  if (vec_len (s) == 0)
-	    s = format (s, "\n    %-15s  %=8s  %6s  %s", "Name", "Priority",
-			"Active", "Description");
-	  s = format (s, "\n    %-15s  %8d  %=6s  %s", v->suffix, v->priority,
-		      fnr->function == n->function ? "yes" : "", v->desc);
+	    s = format (s, "\n    %-15s  %=8s  %6s  %10s  %s", "Name",
+			"Priority", "Active", "Clk/Vec", "Description");
+	  s = format (s, "\n    %-15s  %8d  %=6s  ", v->suffix, v->priority,
+		      fnr->function == n->function ? "yes" : "");
+	  if (fnr->march_variant < vec_len (n->autotune_clocks_per_vector) &&
+	      n->autotune_clocks_per_vector[fnr->march_variant] > 0)
+	    s = format (s, "%10.2f",
+			n->autotune_clocks_per_vector[fnr->march_variant]);
+	  else
+	    s = format (s, "%10s", "-");
+	  s = format (s, "  %s", v->desc);
 	  fnr = fnr->next_registration;
 	}
     }
@@ -893,6 +902,345 @@ VLIB_CLI_COMMAND (set_node_fn_command, static) = {
   .function = set_node_fn,
 };
 
+typedef struct
+{
+  u32 node_index;
+  f64 interval;
+} node_autotune_request_t;
+
+static node_autotune_request_t *node_autotune_requests;
+
+/* Sum clocks and vectors of a node over all threads */
+static void
+node_autotune_sample (vlib_main_t *vm, u32 node_index, u64 *clocks,
+		      u64 *vectors)
+{
+  *clocks = *vectors = 0;
+
+  vlib_worker_thread_barrier_sync (vm);
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *tvm = vlib_get_main_by_index (i);
+      vlib_node_t *n = vlib_get_node (tvm, node_index);
+      vlib_node_sync_stats (tvm, n);
+      *clocks += n->stats_total.clocks;
+      *vectors += n->stats_total.vectors;
+    }
+  vlib_worker_thread_barrier_release (vm);
+}
+
+static void
+node_autotune_one (vlib_main_t *vm, u32 node_index, f64 interval)
+{
+  vlib_node_t *n = vlib_get_node (vm, node_index);
+  vlib_node_fn_registration_t *fnr;
+  vlib_node_fn_variant_t *v;
+  u32 best_variant = ~0;
+  f64 best = 0;
+
+  vec_reset_length (n->autotune_clocks_per_vector);
+
+  for (fnr = n->node_fn_registrations; fnr; fnr = fnr->next_registration)
+    {
+      u64 clocks0, vectors0, clocks1, vectors1;
+      f64 cpv;
+
+      v = vec_elt_at_index (vm->node_main.variants, fnr->march_variant);
+      if (v->priority < 0)
+	continue;
+
+      vlib_worker_thread_barrier_sync (vm);
+      vlib_node_set_march_variant (vm, node_index, fnr->march_variant);
+      vlib_worker_thread_barrier_release (vm);
+
+      node_autotune_sample (vm, node_index, &clocks0, &vectors0);
+      vlib_process_suspend (vm, interval);
+      node_autotune_sample (vm, node_index, &clocks1, &vectors1);
+
+      if (vectors1 == vectors0)
+	continue;
+
+      cpv = (f64) (clocks1 - clocks0) / (f64) (vectors1 - vectors0);
+      vec_validate (n->autotune_clocks_per_vector, fnr->march_variant);
+      n->autotune_clocks_per_vector[fnr->march_variant] = cpv;
+
+      if (best_variant == ~0 || cpv < best)
+	{
+	  best = cpv;
+	  best_variant = fnr->march_variant;
+	}
+    }
+
+  vlib_worker_thread_barrier_sync (vm);
+  if (best_variant != ~0)
+    vlib_node_set_march_variant (vm, node_index, best_variant);
+  else
+    {
+      /* no traffic seen, fall back to the static choice */
+      vlib_node_function_t *fn;
+      fn = vlib_node_get_preferred_node_fn_variant (
+	vm, n->node_fn_registrations);
+      for (fnr = n->node_fn_registrations; fnr; fnr = fnr->next_registration)
+	if (fnr->function == fn)
+	  vlib_node_set_march_variant (vm, node_index, fnr->march_variant);
+    }
+  vlib_worker_thread_barrier_release (vm);
+}
+
+static uword
+node_autotune_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+		       vlib_frame_t *f)
+{
+  while (1)
+    {
+      vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, 0);
+
+      while (vec_len (node_autotune_requests))
+	{
+	  node_autotune_request_t r = node_autotune_requests[0];
+	  vec_delete (node_autotune_requests, 1, 0);
+	  node_autotune_one (vm, r.node_index, r.interval);
+	}
+    }
+  return 0;
+}
+
+VLIB_REGISTER_NODE (node_autotune_process_node) = {
+  .function = node_autotune_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "node-autotune-process",
+};
+
+static clib_error_t *
+set_node_fn_autotune (vlib_main_t *vm, unformat_input_t *input,
+		      vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  node_autotune_request_t r = { .node_index = ~0, .interval = 1.0 };
+  clib_error_t *err = 0;
+  vlib_node_t *n;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "interval %f", &r.interval))
+	;
+      else if (r.node_index == ~0 &&
+	       unformat (line_input, "%U", unformat_vlib_node, vm,
+			 &r.node_index))
+	;
+      else
+	{
+	  err = clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (r.node_index == ~0)
+    {
+      err = clib_error_return (0, "please specify valid node name");
+      goto done;
+    }
+
+  n = vlib_get_node (vm, r.node_index);
+
+  if (n->node_fn_registrations == 0)
+    {
+      err = clib_error_return (0, "node doesn't have function variants");
+      goto done;
+    }
+
+  if (r.interval <= 0)
+    {
+      err = clib_error_return (0, "interval must be positive");
+      goto done;
+    }
+
+  vec_add1 (node_autotune_requests, r);
+  vlib_process_signal_event (vm, node_autotune_process_node.index, 0, 0);
+
+done:
+  unformat_free (line_input);
+  return err;
+}
+
+/*?
+ * Time each function variant of a node supported by this CPU on live
+ * traffic for <interval> seconds (default 1), then keep the one with
+ * the fewest clocks per vector. Results are shown by 'show node'.
+?*/
+VLIB_CLI_COMMAND (set_node_fn_autotune_command, static) = {
+  .path = "set node function autotune",
+  .short_help = "set node function autotune <node-name> [interval <sec>]",
+  .function = set_node_fn_autotune,
+};
+
+static clib_error_t *
+set_node_coalesce (vlib_main_t *vm, unformat_input_t *input,
+		   vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 node_index = ~0, threshold = VLIB_FRAME_SIZE / 4, hold_usec = 10;
+  clib_error_t *err = 0;
+  vlib_node_t *n;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "threshold %u", &threshold))
+	;
+      else if (unformat (line_input, "hold %u", &hold_usec))
+	;
+      else if (unformat (line_input, "disable"))
+	threshold = hold_usec = 0;
+      else if (node_index == ~0 &&
+	       unformat (line_input, "%U", unformat_vlib_node, vm,
+			 &node_index))
+	;
+      else
+	{
+	  err = clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (node_index == ~0)
+    {
+      err = clib_error_return (0, "please specify valid node name");
+      goto done;
+    }
+
+  n = vlib_get_node (vm, node_index);
+
+  if (n->type != VLIB_NODE_TYPE_INTERNAL)
+    {
+      err = clib_error_return (0, "only internal nodes can coalesce frames");
+      goto done;
+    }
+
+  if (threshold > VLIB_FRAME_SIZE)
+    {
+      err = clib_error_return (0, "threshold must be at most %u",
+			       VLIB_FRAME_SIZE);
+      goto done;
+    }
+
+  vlib_node_set_coalesce (vm, node_index, threshold, hold_usec);
+
+done:
+  unformat_free (line_input);
+  return err;
+}
+
+VLIB_CLI_COMMAND (set_node_coalesce_command, static) = {
+  .path = "set node coalesce",
+  .short_help = "set node coalesce <node-name> [threshold <n>] "
+		"[hold <usec>] [disable]",
+  .function = set_node_coalesce,
+};
+
+static clib_error_t *
+show_node_coalesce (vlib_main_t *vm, unformat_input_t *input,
+		    vlib_cli_command_t *cmd)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  vlib_node_coalesce_stats_t cs;
+  vlib_node_t *n;
+  u32 i, j;
+
+  vlib_cli_output (vm, "%-30s%=10s%=10s%=14s%=10s%=14s%=10s", "Name",
+		   "Threshold", "Hold(us)", "Frames-in", "Avg-in",
+		   "Frames-out", "Avg-out");
+
+  for (i = 0; i < vec_len (nm->nodes); i++)
+    {
+      clib_memset (&cs, 0, sizeof (cs));
+
+      for (j = 0; j < vlib_get_n_threads (); j++)
+	{
+	  vlib_main_t *tvm = vlib_get_main_by_index (j);
+	  n = vlib_get_node (tvm, i);
+	  cs.frames_in += n->coalesce_stats.frames_in;
+	  cs.vectors_in += n->coalesce_stats.vectors_in;
+	  cs.frames_out += n->coalesce_stats.frames_out;
+	  cs.vectors_out += n->coalesce_stats.vectors_out;
+	}
+
+      n = nm->nodes[i];
+      if (!(n->flags & VLIB_NODE_FLAG_COALESCE) && cs.frames_in == 0)
+	continue;
+
+      vlib_cli_output (
+	vm, "%-30v%=10u%=10u%=14lu%=10.2f%=14lu%=10.2f", n->name,
+	n->coalesce_threshold, n->coalesce_hold_usec, cs.frames_in,
+	cs.frames_in ? (f64) cs.vectors_in / cs.frames_in : 0.0,
+	cs.frames_out,
+	cs.frames_out ? (f64) cs.vectors_out / cs.frames_out : 0.0);
+    }
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (show_node_coalesce_command, static) = {
+  .path = "show node coalesce",
+  .short_help = "show node coalesce",
+  .function = show_node_coalesce,
+};
+
+static clib_error_t *
+set_node_clocks_histogram (vlib_main_t *vm, unformat_input_t *input,
+			   vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 node_index = ~0;
+  clib_error_t *err = 0;
+  int enable = 1;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "disable"))
+	enable = 0;
+      else if (node_index == ~0 &&
+	       unformat (line_input, "%U", unformat_vlib_node, vm,
+			 &node_index))
+	;
+      else
+	{
+	  err = clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (node_index == ~0)
+    {
+      err = clib_error_return (0, "please specify valid node name");
+      goto done;
+    }
+
+  vlib_node_set_clocks_histogram (vm, node_index, enable);
+
+done:
+  unformat_free (line_input);
+  return err;
+}
+
+VLIB_CLI_COMMAND (set_node_clocks_histogram_command, static) = {
+  .path = "set node clocks-histogram",
+  .short_help = "set node clocks-histogram <node-name> [disable]",
+  .function = set_node_clocks_histogram,
+};
+
 /* Dummy function to get us linked in. */
 void
 vlib_node_cli_reference (void)
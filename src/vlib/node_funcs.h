@@ -1328,6 +1328,10 @@ vlib_node_vectors_per_main_loop_as_integer (vlib_main_t * vm, u32 node_index)
 
 void vlib_frame_free (vlib_main_t *vm, vlib_frame_t *f);
 
+/* Free the buffers of the frames made pending since pending frame index
+   FIRST, and drop the frames without dispatching them. */
+void vlib_discard_pending_frames (vlib_main_t *vm, u32 first);
+
 /* Return the edge index if present, ~0 otherwise */
 uword vlib_node_get_next (vlib_main_t * vm, uword node, uword next_node);
 
@@ -1429,6 +1433,20 @@ vlib_node_increment_counter (vlib_main_t * vm, u32 node_index,
 u32 vlib_process_create (vlib_main_t * vm, char *name,
 			 vlib_node_function_t * f, u32 log2_n_stack_bytes);
 
+/** @brief Set the scheduling priority of a process node
+ *  @param vm &vlib_global_main
+ *  @param node_index process node index
+ *  @param priority one of vlib_process_priority_t
+ */
+always_inline void
+vlib_process_set_priority (vlib_main_t *vm, u32 node_index,
+			   vlib_process_priority_t priority)
+{
+  vlib_node_t *n = vlib_get_node (vm, node_index);
+  vlib_process_t *p = vlib_get_process_from_node (vm, n);
+  p->priority = priority;
+}
+
 always_inline int
 vlib_node_set_dispatch_wrapper (vlib_main_t *vm, vlib_node_function_t *fn)
 {
@@ -1441,6 +1459,28 @@ vlib_node_set_dispatch_wrapper (vlib_main_t *vm, vlib_node_function_t *fn)
 int vlib_node_set_march_variant (vlib_main_t *vm, u32 node_index,
 				 clib_march_variant_type_t march_variant);
 
+/** \brief Hold back small pending frames to an internal node.
+ Frames with fewer than threshold vectors are dispatched once enough
+ vectors have been added to them, or after hold_usec. Applies to all
+ threads, so the caller must hold the worker barrier.
+ @param vm vlib_main_t pointer
+ @param node_index index of the node
+ @param threshold vector count, 0 to disable coalescing
+ @param hold_usec longest time a frame is held, 0 to disable coalescing
+*/
+void vlib_node_set_coalesce (vlib_main_t *vm, u32 node_index, u16 threshold,
+			     u32 hold_usec);
+
+/** \brief Record a node's clocks per dispatch, per thread, in the stats
+ segment histogram /nodes/<node>/clocks-histogram. Applies to all threads,
+ so the caller must hold the worker barrier.
+ @param vm vlib_main_t pointer
+ @param node_index index of the node
+ @param enable 0 to stop recording and remove the histogram
+*/
+void vlib_node_set_clocks_histogram (vlib_main_t *vm, u32 node_index,
+				     int enable);
+
 vlib_node_function_t *
 vlib_node_get_preferred_node_fn_variant (vlib_main_t *vm,
 					 vlib_node_fn_registration_t *regs);
@@ -49,6 +49,7 @@ vlib_node_config (vlib_main_t *vm, unformat_input_t *input)
   u32 *march_variant_by_node = 0;
   clib_march_variant_type_t march_variant;
   u32 node_index;
+  f64 budget;
   int i;
 
   /* specify prioritization defaults for all graph nodes */
@@ -72,6 +73,9 @@ vlib_node_config (vlib_main_t *vm, unformat_input_t *input)
 	      unformat_free (&sub_input);
 	    }
 	}
+      else if (unformat (input, "process-low-priority-budget %f", &budget))
+	vm->node_main.process_low_priority_budget_clocks =
+	  budget * 1e-6 * vm->clib_time.clocks_per_second;
       else /* specify prioritization for an individual graph node */
 	if (unformat (input, "%U", unformat_vlib_node, vm, &node_index))
 	{
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vlib/rcu.h>
+
+/*
+ * Callbacks are run in batches. A grace period starts by saving the main
+ * loop count of each worker and ends once all of them moved, the main
+ * loop count being the quiescent state counter. Callbacks queued during
+ * a grace period wait for the next one.
+ */
+
+typedef struct
+{
+  vlib_rcu_fn_t *fn;
+  void *data;
+} vlib_rcu_callback_t;
+
+typedef struct
+{
+  /* queued, waiting for the next grace period */
+  vlib_rcu_callback_t *pending;
+  /* waiting for the grace period in progress */
+  vlib_rcu_callback_t *waiting;
+  /* main loop count of each thread when the grace period started */
+  u32 *loop_counts;
+  u32 process_node_index;
+} vlib_rcu_main_t;
+
+static vlib_rcu_main_t vlib_rcu_main;
+
+static void
+vlib_rcu_grace_period_start (vlib_rcu_main_t *rm)
+{
+  vlib_global_main_t *vgm = vlib_get_global_main ();
+  u32 i;
+
+  vec_validate (rm->loop_counts, vec_len (vgm->vlib_mains) - 1);
+  vec_foreach_index (i, vgm->vlib_mains)
+    rm->loop_counts[i] = vgm->vlib_mains[i]->main_loop_count;
+}
+
+static int
+vlib_rcu_grace_period_done (vlib_rcu_main_t *rm)
+{
+  vlib_global_main_t *vgm = vlib_get_global_main ();
+  u32 i;
+
+  /* the callbacks run on the main thread, skip it */
+  for (i = 1; i < vec_len (vgm->vlib_mains); i++)
+    if (rm->loop_counts[i] == vgm->vlib_mains[i]->main_loop_count)
+      return 0;
+  return 1;
+}
+
+void
+vlib_rcu_call (vlib_rcu_fn_t *fn, void *data)
+{
+  vlib_rcu_main_t *rm = &vlib_rcu_main;
+  vlib_rcu_callback_t cb = { .fn = fn, .data = data };
+
+  ASSERT (vlib_get_thread_index () == 0);
+
+  vec_add1 (rm->pending, cb);
+  if (vec_len (rm->pending) == 1)
+    vlib_process_signal_event (vlib_get_main (), rm->process_node_index, 0,
+			       0);
+}
+
+static uword
+vlib_rcu_process (vlib_main_t *vm, vlib_node_runtime_t *rt, vlib_frame_t *f)
+{
+  vlib_rcu_main_t *rm = &vlib_rcu_main;
+  vlib_rcu_callback_t *cb, *tmp;
+
+  while (1)
+    {
+      if (vec_len (rm->pending) == 0)
+	{
+	  vlib_process_wait_for_event (vm);
+	  vlib_process_get_events (vm, 0);
+	  continue;
+	}
+
+      tmp = rm->waiting;
+      rm->waiting = rm->pending;
+      rm->pending = tmp;
+      vlib_rcu_grace_period_start (rm);
+
+      while (!vlib_rcu_grace_period_done (rm))
+	vlib_process_suspend (vm, 1e-5);
+
+      vec_foreach (cb, rm->waiting)
+	cb->fn (cb->data);
+      vec_reset_length (rm->waiting);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (vlib_rcu_process_node, static) = {
+  .function = vlib_rcu_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "rcu-process",
+};
+
+static clib_error_t *
+vlib_rcu_init (vlib_main_t *vm)
+{
+  vlib_rcu_main.process_node_index = vlib_rcu_process_node.index;
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (vlib_rcu_init);
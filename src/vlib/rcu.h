@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#ifndef included_vlib_rcu_h
+#define included_vlib_rcu_h
+
+/*
+ * Deferred reclamation for data read by the workers without the barrier.
+ *
+ * The main thread publishes the new version of the data, e.g. with
+ * clib_atomic_store_rel_n on the pointer the workers read, and passes the
+ * old version to vlib_rcu_call. The callback runs on the main thread once
+ * every worker has gone at least once around its main loop, so no worker
+ * can still hold a reference taken before the update. Workers must not
+ * keep such references across main loop iterations.
+ */
+typedef void (vlib_rcu_fn_t) (void *data);
+
+void vlib_rcu_call (vlib_rcu_fn_t *fn, void *data);
+
+#endif /* included_vlib_rcu_h */
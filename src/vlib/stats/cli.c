@@ -46,6 +46,10 @@ format_stat_dir_entry (u8 *s, va_list *args)
       type_name = "Symlink";
       break;
 
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+      type_name = "Histogram";
+      break;
+
     default:
       type_name = "illegal!";
       break;
@@ -128,12 +128,124 @@ update_node_counters (vlib_stats_segment_t *sm)
   vec_free (stat_vms);
 }
 
+static_always_inline void
+sum_thread_counters (u64 *dst, u64 **src, u32 n_threads, u32 n)
+{
+  u32 i = 0, t;
+
+#if defined(CLIB_HAVE_VEC512)
+  for (; i + 8 <= n; i += 8)
+    {
+      u64x8 sum = u64x8_load_unaligned (src[0] + i);
+      for (t = 1; t < n_threads; t++)
+	sum += u64x8_load_unaligned (src[t] + i);
+      u64x8_store_unaligned (sum, dst + i);
+    }
+#elif defined(CLIB_HAVE_VEC256)
+  for (; i + 4 <= n; i += 4)
+    {
+      u64x4 sum = u64x4_load_unaligned (src[0] + i);
+      for (t = 1; t < n_threads; t++)
+	sum += u64x4_load_unaligned (src[t] + i);
+      u64x4_store_unaligned (sum, dst + i);
+    }
+#elif defined(CLIB_HAVE_VEC128)
+  for (; i + 2 <= n; i += 2)
+    {
+      u64x2 sum = u64x2_load_unaligned (src[0] + i);
+      for (t = 1; t < n_threads; t++)
+	sum += u64x2_load_unaligned (src[t] + i);
+      u64x2_store_unaligned (sum, dst + i);
+    }
+#endif
+
+  for (; i < n; i++)
+    {
+      u64 sum = src[0][i];
+      for (t = 1; t < n_threads; t++)
+	sum += src[t][i];
+      dst[i] = sum;
+    }
+}
+
+/*
+ * Publish the sum over all threads of each counter vector as a single
+ * thread vector named /totals/<name>, so readers do not have to walk
+ * every thread's copy. Combined counters are summed as pairs of u64.
+ */
+static void
+update_totals (vlib_stats_segment_t *sm)
+{
+  u64 **src = 0;
+
+  for (u32 i = 0; i < vec_len (sm->directory_vector); i++)
+    {
+      vlib_stats_entry_t *e = sm->directory_vector + i;
+      u32 n_threads, n_elts = ~0, elt_size, totals_index;
+      u64 **dst;
+
+      if (e->type != STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE &&
+	  e->type != STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED)
+	continue;
+      /* per thread rings have no meaningful sum */
+      if (strncmp (e->name, "/totals/", 8) == 0 ||
+	  strncmp (e->name, "/sys/dispatch_samples", 21) == 0)
+	continue;
+
+      n_threads = vec_len ((void **) e->data);
+      if (n_threads == 0)
+	continue;
+
+      vec_validate_init_empty (sm->totals_by_entry_index, i, ~0);
+      totals_index = sm->totals_by_entry_index[i];
+
+      if (totals_index == ~0)
+	{
+	  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE)
+	    totals_index = vlib_stats_add_counter_vector ("/totals%s", e->name);
+	  else
+	    totals_index =
+	      vlib_stats_add_counter_pair_vector ("/totals%s", e->name);
+	  if (totals_index == ~0)
+	    continue;
+	  sm->totals_by_entry_index[i] = totals_index;
+	  /* adding the entry may have moved the directory */
+	  e = sm->directory_vector + i;
+	}
+
+      elt_size = e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ?
+		   sizeof (counter_t) :
+		   sizeof (vlib_counter_t);
+
+      vec_reset_length (src);
+      for (u32 t = 0; t < n_threads; t++)
+	{
+	  void *v = ((void **) e->data)[t];
+	  vec_add1 (src, v);
+	  n_elts = clib_min (n_elts, vec_len (v));
+	}
+
+      if (n_elts == 0)
+	continue;
+
+      vlib_stats_validate (totals_index, 0, n_elts - 1);
+      dst = vlib_stats_get_entry_data_pointer (totals_index);
+      sum_thread_counters (dst[0], src, n_threads,
+			   n_elts * (elt_size / sizeof (u64)));
+    }
+
+  vec_free (src);
+}
+
 static void
 do_stat_segment_updates (vlib_main_t *vm, vlib_stats_segment_t *sm)
 {
   if (sm->node_counters_enabled)
     update_node_counters (sm);
 
+  if (sm->totals_enabled)
+    update_totals (sm);
+
   vlib_stats_collector_t *c;
   pool_foreach (c, sm->collectors)
     {
@@ -183,4 +295,5 @@ VLIB_REGISTER_NODE (stat_segment_collector, static) = {
   .function = stat_segment_collector_process,
   .name = "statseg-collector-process",
   .type = VLIB_NODE_TYPE_PROCESS,
+  .process_priority = VLIB_PROCESS_PRIORITY_LOW,
 };
@@ -139,6 +139,7 @@ statseg_config (vlib_main_t *vm, unformat_input_t *input)
 {
   vlib_stats_segment_t *sm = vlib_stats_get_segment ();
   sm->update_interval = 10.0;
+  sm->dispatch_sample_interval = 1e-3;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -157,6 +158,16 @@ statseg_config (vlib_main_t *vm, unformat_input_t *input)
 	sm->node_counters_enabled = 1;
       else if (unformat (input, "per-node-counters off"))
 	sm->node_counters_enabled = 0;
+      else if (unformat (input, "totals on"))
+	sm->totals_enabled = 1;
+      else if (unformat (input, "totals off"))
+	sm->totals_enabled = 0;
+      else if (unformat (input, "dispatch-samples %u",
+			 &sm->dispatch_samples_ring_size))
+	;
+      else if (unformat (input, "dispatch-sample-interval %f",
+			 &sm->dispatch_sample_interval))
+	;
       else if (unformat (input, "update-interval %f", &sm->update_interval))
 	;
       else
@@ -171,6 +182,10 @@ statseg_config (vlib_main_t *vm, unformat_input_t *input)
   if (vec_len (sm->socket_name))
     vec_terminate_c_string (sm->socket_name);
 
+  if (sm->dispatch_samples_ring_size)
+    sm->dispatch_samples_ring_size =
+      max_pow2 (sm->dispatch_samples_ring_size);
+
   return 0;
 }
 
@@ -242,6 +257,71 @@ stats_segment_socket_exit (vlib_main_t *vm)
 
 VLIB_MAIN_LOOP_EXIT_FUNCTION (stats_segment_socket_exit);
 
+/*
+ * Called from the main loop of each thread at the end of its sample
+ * interval. The record is written before the head is moved, so a reader
+ * which sees the head unchanged after copying a record has a complete one.
+ */
+void
+vlib_stats_dispatch_sample_push (vlib_main_t *vm, f64 now)
+{
+  vlib_stats_segment_t *sm = vlib_stats_get_segment ();
+  counter_t **ring =
+    vlib_stats_get_entry_data_pointer (sm->dispatch_samples_index);
+  counter_t **head =
+    vlib_stats_get_entry_data_pointer (sm->dispatch_samples_head_index);
+  clib_thread_index_t ti = vm->thread_index;
+  u64 n = head[0][ti];
+  counter_t *s;
+
+  s = ring[ti] + (n & (sm->dispatch_samples_ring_size - 1)) *
+		   STAT_DISPATCH_SAMPLE_N_FIELDS;
+  s[STAT_DISPATCH_SAMPLE_TIME] = unix_time_now_nsec ();
+  s[STAT_DISPATCH_SAMPLE_POLLS] = vm->dispatch_sample_polls;
+  s[STAT_DISPATCH_SAMPLE_ZERO_POLLS] = vm->dispatch_sample_zero_polls;
+  s[STAT_DISPATCH_SAMPLE_VECTORS] = vm->dispatch_sample_vectors;
+  s[STAT_DISPATCH_SAMPLE_MAX_VECTORS] = vm->dispatch_sample_max_vectors;
+  clib_atomic_store_rel_n (&head[0][ti], n + 1);
+
+  vm->dispatch_sample_polls = 0;
+  vm->dispatch_sample_zero_polls = 0;
+  vm->dispatch_sample_vectors = 0;
+  vm->dispatch_sample_max_vectors = 0;
+  vm->dispatch_sample_interval_end = now + sm->dispatch_sample_interval;
+}
+
+static clib_error_t *
+stats_dispatch_samples_init (vlib_main_t *vm)
+{
+  vlib_stats_segment_t *sm = vlib_stats_get_segment ();
+  u32 n_threads = vlib_get_n_threads ();
+
+  if (sm->dispatch_samples_ring_size == 0)
+    return 0;
+
+  sm->dispatch_samples_index =
+    vlib_stats_add_counter_vector ("/sys/dispatch_samples");
+  sm->dispatch_samples_head_index =
+    vlib_stats_add_counter_vector ("/sys/dispatch_samples_head");
+  if (sm->dispatch_samples_index == ~0 ||
+      sm->dispatch_samples_head_index == ~0)
+    return clib_error_return (0, "failed to add dispatch samples");
+
+  vlib_stats_validate (sm->dispatch_samples_index, n_threads - 1,
+		       sm->dispatch_samples_ring_size *
+			   STAT_DISPATCH_SAMPLE_N_FIELDS -
+			 1);
+  vlib_stats_validate (sm->dispatch_samples_head_index, 0, n_threads - 1);
+
+  /* the first interval of each thread ends on its next main loop */
+  foreach_vlib_main ()
+    this_vlib_main->dispatch_sample_interval_end = vlib_time_now (vm);
+
+  return 0;
+}
+
+VLIB_MAIN_LOOP_ENTER_FUNCTION (stats_dispatch_samples_init);
+
 static clib_error_t *
 statseg_init (vlib_main_t *vm)
 {
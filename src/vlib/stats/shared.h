@@ -14,11 +14,92 @@ typedef enum
   STAT_DIR_TYPE_NAME_VECTOR,
   STAT_DIR_TYPE_EMPTY,
   STAT_DIR_TYPE_SYMLINK,
+  STAT_DIR_TYPE_HISTOGRAM_LOG2,
 } stat_directory_type_t;
 
+/*
+ * Log2 histograms hold, per thread, STAT_HISTOGRAM_N_BUCKETS counters.
+ * Values below 4 have a bucket each, above that each power of two is
+ * split into 4 buckets, so a bucket's width is at most a quarter of its
+ * lower bound.
+ */
+#define STAT_HISTOGRAM_SUB_BUCKET_BITS 2
+#define STAT_HISTOGRAM_N_BUCKETS (63 << STAT_HISTOGRAM_SUB_BUCKET_BITS)
+
+static inline uint32_t
+stat_histogram_bucket (uint64_t v)
+{
+  uint32_t msb;
+
+  if (v < (1 << STAT_HISTOGRAM_SUB_BUCKET_BITS))
+    return v;
+
+  msb = 63 - __builtin_clzll (v);
+  return ((msb - STAT_HISTOGRAM_SUB_BUCKET_BITS + 1)
+	  << STAT_HISTOGRAM_SUB_BUCKET_BITS) +
+	 ((v >> (msb - STAT_HISTOGRAM_SUB_BUCKET_BITS)) &
+	  ((1 << STAT_HISTOGRAM_SUB_BUCKET_BITS) - 1));
+}
+
+/* Smallest value counted in a bucket */
+static inline uint64_t
+stat_histogram_bucket_min (uint32_t bucket)
+{
+  uint32_t n_sub = 1 << STAT_HISTOGRAM_SUB_BUCKET_BITS;
+  uint32_t msb = (bucket >> STAT_HISTOGRAM_SUB_BUCKET_BITS) +
+		 STAT_HISTOGRAM_SUB_BUCKET_BITS - 1;
+
+  if (bucket < n_sub)
+    return bucket;
+
+  return (uint64_t) (n_sub + (bucket & (n_sub - 1)))
+	 << (msb - STAT_HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+/* Lower bound of the bucket holding quantile q (0 < q <= 1) of the
+   values counted in n_buckets buckets */
+static inline uint64_t
+stat_histogram_quantile (const uint64_t *buckets, uint32_t n_buckets,
+			 double q)
+{
+  uint64_t total = 0, sum = 0;
+  uint32_t i;
+
+  for (i = 0; i < n_buckets; i++)
+    total += buckets[i];
+
+  for (i = 0; i < n_buckets; i++)
+    {
+      sum += buckets[i];
+      if (sum && sum >= q * total)
+	return stat_histogram_bucket_min (i);
+    }
+
+  return 0;
+}
+
+/*
+ * /sys/dispatch_samples holds, per thread, a ring of records of
+ * STAT_DISPATCH_SAMPLE_N_FIELDS counters describing the input node
+ * dispatches of one sample interval. /sys/dispatch_samples_head[0][thread]
+ * counts the records written to the thread's ring.
+ */
+typedef enum
+{
+  STAT_DISPATCH_SAMPLE_TIME,	    /* end of the interval, unix ns */
+  STAT_DISPATCH_SAMPLE_POLLS,	    /* input node dispatches */
+  STAT_DISPATCH_SAMPLE_ZERO_POLLS,  /* of which returned no vectors */
+  STAT_DISPATCH_SAMPLE_VECTORS,	    /* vectors returned */
+  STAT_DISPATCH_SAMPLE_MAX_VECTORS, /* largest dispatch */
+  STAT_DISPATCH_SAMPLE_N_FIELDS,
+} stat_dispatch_sample_field_t;
+
 typedef struct
 {
   stat_directory_type_t type;
+  /* bumped whenever the entry is created, removed or has its counter
+     vectors reallocated; occupies what used to be alignment padding */
+  uint32_t generation;
   union
   {
     struct
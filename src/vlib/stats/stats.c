@@ -105,7 +105,7 @@ u32
 vlib_stats_create_counter (vlib_stats_entry_t *e)
 {
   vlib_stats_segment_t *sm = vlib_stats_get_segment ();
-  u32 index;
+  u32 index, generation;
 
   if (sm->dir_vector_first_free_elt != CLIB_U32_MAX)
     {
@@ -118,7 +118,9 @@ vlib_stats_create_counter (vlib_stats_entry_t *e)
       vec_validate (sm->directory_vector, index);
     }
 
+  generation = sm->directory_vector[index].generation;
   sm->directory_vector[index] = *e;
+  sm->directory_vector[index].generation = generation + 1;
 
   hash_set_str_key_alloc (&sm->directory_vector_by_name, e->name, index);
 
@@ -149,6 +151,7 @@ vlib_stats_remove_entry (u32 entry_index)
       break;
 
     case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
       c = e->data;
       e->data = 0;
       oldheap = clib_mem_set_heap (sm->heap);
@@ -179,11 +182,22 @@ vlib_stats_remove_entry (u32 entry_index)
 
   hash_unset_str_key_free (&sm->directory_vector_by_name, e->name);
 
+  i = e->generation;
   memset (e, 0, sizeof (*e));
   e->type = STAT_DIR_TYPE_EMPTY;
+  e->generation = i + 1;
 
   e->value = sm->dir_vector_first_free_elt;
   sm->dir_vector_first_free_elt = entry_index;
+
+  /* totals are maintained by the collector, drop them with their source */
+  if (entry_index < vec_len (sm->totals_by_entry_index) &&
+      sm->totals_by_entry_index[entry_index] != ~0)
+    {
+      u32 totals_index = sm->totals_by_entry_index[entry_index];
+      sm->totals_by_entry_index[entry_index] = ~0;
+      vlib_stats_remove_entry (totals_index);
+    }
 }
 
 static void
@@ -381,6 +395,24 @@ vlib_stats_add_counter_pair_vector (char *fmt, ...)
 					name);
 }
 
+u32
+vlib_stats_add_histogram (char *fmt, ...)
+{
+  va_list va;
+  u8 *name;
+  u32 index;
+
+  va_start (va, fmt);
+  name = va_format (0, fmt, &va);
+  va_end (va);
+
+  index = vlib_stats_new_entry_internal (STAT_DIR_TYPE_HISTOGRAM_LOG2, name);
+  if (index != CLIB_U32_MAX)
+    vlib_stats_validate (index, vlib_get_n_threads () - 1,
+			 STAT_HISTOGRAM_N_BUCKETS - 1);
+  return index;
+}
+
 static int
 vlib_stats_validate_will_expand_internal (u32 entry_index, va_list *va)
 {
@@ -390,7 +422,8 @@ vlib_stats_validate_will_expand_internal (u32 entry_index, va_list *va)
   int rv = 1;
 
   oldheap = clib_mem_set_heap (sm->heap);
-  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE)
+  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ||
+      e->type == STAT_DIR_TYPE_HISTOGRAM_LOG2)
     {
       u32 idx0 = va_arg (*va, u32);
       u32 idx1 = va_arg (*va, u32);
@@ -459,7 +492,8 @@ vlib_stats_validate (u32 entry_index, ...)
 
   va_start (va, entry_index);
 
-  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE)
+  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ||
+      e->type == STAT_DIR_TYPE_HISTOGRAM_LOG2)
     {
       u32 idx0 = va_arg (va, u32);
       u32 idx1 = va_arg (va, u32);
@@ -491,7 +525,10 @@ vlib_stats_validate (u32 entry_index, ...)
   clib_mem_set_heap (oldheap);
 
   if (will_expand)
-    vlib_stats_segment_unlock ();
+    {
+      e->generation++;
+      vlib_stats_segment_unlock ();
+    }
 }
 
 u32
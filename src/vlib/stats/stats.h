@@ -60,6 +60,8 @@ typedef struct
 {
   /* internal, does not point to shared memory */
   vlib_stats_collector_t *collectors;
+  /* totals entry of each counter vector entry, ~0 if none */
+  u32 *totals_by_entry_index;
 
   /* statistics segment */
   uword *directory_vector_by_name;
@@ -77,6 +79,11 @@ typedef struct
   ssize_t memory_size;
   clib_mem_page_sz_t log2_page_sz;
   u8 node_counters_enabled;
+  u32 dispatch_samples_ring_size;
+  f64 dispatch_sample_interval;
+  u32 dispatch_samples_index;
+  u32 dispatch_samples_head_index;
+  u8 totals_enabled;
   void *heap;
   vlib_stats_shared_header_t
     *shared_header; /* pointer to shared memory segment */
@@ -141,6 +148,16 @@ u32 vlib_stats_add_counter_vector (char *fmt, ...);
 /* counter pair vector */
 u32 vlib_stats_add_counter_pair_vector (char *fmt, ...);
 
+/* log2 histogram, per thread */
+u32 vlib_stats_add_histogram (char *fmt, ...);
+
+static_always_inline void
+vlib_stats_histogram_add (u32 entry_index, u32 thread_index, u64 value)
+{
+  u64 **data = vlib_stats_get_entry_data_pointer (entry_index);
+  data[thread_index][stat_histogram_bucket (value)]++;
+}
+
 /* string vector */
 typedef u8 **vlib_stats_string_vector_t;
 vlib_stats_string_vector_t vlib_stats_add_string_vector (char *fmt, ...);
@@ -161,4 +178,7 @@ void vlib_stats_register_collector_fn (vlib_stats_collector_reg_t *r);
 
 format_function_t format_vlib_stats_symlink;
 
+/* input dispatch samples */
+void vlib_stats_dispatch_sample_push (vlib_main_t *vm, f64 now);
+
 #endif
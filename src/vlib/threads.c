@@ -139,6 +139,54 @@ barrier_trace_release (f64 t_entry, f64 t_closed_total, f64 t_update_main)
   vlib_worker_threads[0].barrier_context = NULL;
 }
 
+/*
+ * Account the time the barrier was closed to the outermost caller of
+ * vlib_worker_thread_barrier_sync.
+ */
+static void
+barrier_profile_release (f64 t_closed_total)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  const char *caller = tm->barrier_profile_caller;
+  vlib_barrier_profile_t *bp;
+  uword *p;
+
+  if (!caller)
+    return;
+
+  p = hash_get (tm->barrier_profile_by_caller, caller);
+  if (p)
+    bp = vec_elt_at_index (tm->barrier_profiles, p[0]);
+  else
+    {
+      if (!tm->barrier_profile_by_caller)
+	tm->barrier_profile_by_caller = hash_create (0, sizeof (uword));
+      hash_set (tm->barrier_profile_by_caller, caller,
+		vec_len (tm->barrier_profiles));
+      vec_add2 (tm->barrier_profiles, bp, 1);
+      bp->caller = caller;
+      bp->histogram_index = vlib_stats_add_histogram ("/sys/barrier/%s",
+						      caller);
+    }
+
+  bp->count++;
+  bp->total += t_closed_total;
+  bp->max = clib_max (bp->max, t_closed_total);
+
+  if (bp->histogram_index != CLIB_U32_MAX)
+    vlib_stats_histogram_add (bp->histogram_index, 0,
+			      (u64) (t_closed_total * 1e6));
+
+  if (tm->barrier_budget != 0 && t_closed_total > tm->barrier_budget)
+    {
+      if (bp->n_over_budget++ == 0)
+	clib_warning ("%s held the barrier for %.1fus, budget %.1fus", caller,
+		      t_closed_total * 1e6, tm->barrier_budget * 1e6);
+    }
+
+  tm->barrier_profile_caller = 0;
+}
+
 uword
 os_get_nthreads (void)
 {
@@ -405,6 +453,24 @@ vlib_frame_queue_alloc (int nelts)
   return (fq);
 }
 
+/* Give each producer thread its own ring, splitting the queue's elements
+   between them */
+static void
+vlib_frame_queue_alloc_lanes (vlib_frame_queue_t *fq, u32 n_lanes)
+{
+  vlib_frame_queue_lane_t *lane;
+  u32 nelts = clib_max (8, fq->nelts / n_lanes);
+
+  nelts = 1 << max_log2 (nelts);
+  vec_validate_aligned (fq->lanes, n_lanes - 1, CLIB_CACHE_LINE_BYTES);
+
+  vec_foreach (lane, fq->lanes)
+    {
+      lane->nelts = nelts;
+      vec_validate_aligned (lane->elts, nelts - 1, CLIB_CACHE_LINE_BYTES);
+    }
+}
+
 void vl_msg_api_handler_no_free (void *) __attribute__ ((weak));
 void
 vl_msg_api_handler_no_free (void *v)
@@ -692,6 +758,7 @@ start_workers (vlib_main_t * vm)
 
 	      vm_clone->thread_index = worker_thread_index;
 	      vm_clone->pending_rpc_requests = 0;
+	      vm_clone->deferred_free_buffers = 0;
 	      vec_validate (vm_clone->pending_rpc_requests, 0);
 	      vec_set_len (vm_clone->pending_rpc_requests, 0);
 	      clib_memset (&vm_clone->random_buffer, 0,
@@ -724,6 +791,7 @@ start_workers (vlib_main_t * vm)
 	      nm_clone->pending_frames = 0;
 	      vec_validate (nm_clone->pending_frames, 10);
 	      vec_set_len (nm_clone->pending_frames, 0);
+	      nm_clone->held_frames = 0;
 
 	      /* fork nodes */
 	      nm_clone->nodes = 0;
@@ -739,6 +807,8 @@ start_workers (vlib_main_t * vm)
 		  clib_memset (&n->stats_total, 0, sizeof (n->stats_total));
 		  clib_memset (&n->stats_last_clear, 0,
 			       sizeof (n->stats_last_clear));
+		  clib_memset (&n->coalesce_stats, 0,
+			       sizeof (n->coalesce_stats));
 		  vec_add1 (nm_clone->nodes, n);
 		  n++;
 		}
@@ -1006,6 +1076,8 @@ vlib_worker_thread_node_refork (void)
 		       sizeof (new_n_clone->stats_total));
 	  clib_memset (&new_n_clone->stats_last_clear, 0,
 		       sizeof (new_n_clone->stats_last_clear));
+	  clib_memset (&new_n_clone->coalesce_stats, 0,
+		       sizeof (new_n_clone->coalesce_stats));
 	}
       else
 	{
@@ -1017,6 +1089,9 @@ vlib_worker_thread_node_refork (void)
 	  clib_memcpy_fast (&new_n_clone->stats_last_clear,
 			    &old_n_clone->stats_last_clear,
 			    sizeof (new_n_clone->stats_last_clear));
+	  clib_memcpy_fast (&new_n_clone->coalesce_stats,
+			    &old_n_clone->coalesce_stats,
+			    sizeof (new_n_clone->coalesce_stats));
 
 	  /* keep previous node state */
 	  new_n_clone->state = old_n_clone->state;
@@ -1145,6 +1220,8 @@ cpu_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "relative"))
 	tm->cpu_translate = 1;
+      else if (unformat (input, "handoff-lanes"))
+	tm->handoff_lanes = 1;
       else if (unformat (input, "numa-heap-size %U",
 			 unformat_memory_size, &tm->numa_heap_size))
 	;
@@ -1179,6 +1256,8 @@ cpu_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "scheduler-priority %u", &tm->sched_priority))
 	;
+      else if (unformat (input, "barrier-budget %f", &tm->barrier_budget))
+	tm->barrier_budget *= 1e-6;
       else if (unformat (input, "%s %u", &name, &count))
 	{
 	  p = hash_get_mem (tm->thread_registrations_by_name, name);
@@ -1358,6 +1437,8 @@ vlib_worker_thread_barrier_sync_int (vlib_main_t * vm, const char *func_name)
       return;
     }
 
+  vlib_get_thread_main ()->barrier_profile_caller = func_name;
+
   if (PREDICT_FALSE (vec_len (vm->barrier_perf_callbacks) != 0))
     clib_call_callbacks (vm->barrier_perf_callbacks, vm,
 			 vm->clib_time.last_cpu_time, 0 /* enter */ );
@@ -1530,6 +1611,7 @@ vlib_worker_thread_barrier_release (vlib_main_t * vm)
   vm->barrier_epoch = now;
 
   barrier_trace_release (t_entry, t_closed_total, t_update_main);
+  barrier_profile_release (t_closed_total);
 
   if (PREDICT_FALSE (vec_len (vm->barrier_perf_callbacks) != 0))
     clib_call_callbacks (vm->barrier_perf_callbacks, vm,
@@ -1680,12 +1762,45 @@ vlib_frame_queue_main_init (u32 node_index, u32 frame_queue_nelts)
   for (i = 0; i < tm->n_vlib_mains; i++)
     {
       fq = vlib_frame_queue_alloc (frame_queue_nelts);
+      if (tm->handoff_lanes)
+	vlib_frame_queue_alloc_lanes (fq, tm->n_vlib_mains);
       vec_add1 (fqm->vlib_frame_queues, fq);
     }
 
   return (fqm - tm->frame_queue_mains);
 }
 
+void
+vlib_frame_queue_main_set_steal (u32 frame_queue_index, u32 steal_threshold)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_frame_queue_main_t *fqm;
+
+  fqm = vec_elt_at_index (tm->frame_queue_mains, frame_queue_index);
+  fqm->steal_threshold = clib_min (steal_threshold, fqm->frame_queue_nelts);
+}
+
+void
+vlib_frame_queue_main_set_codel (u32 frame_queue_index, f64 target,
+				 f64 interval)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  f64 cps = vlib_get_main ()->clib_time.clocks_per_second;
+  vlib_frame_queue_main_t *fqm;
+  vlib_frame_queue_t **fq;
+
+  fqm = vec_elt_at_index (tm->frame_queue_mains, frame_queue_index);
+  fqm->codel_target = target * cps;
+  fqm->codel_interval = interval * cps;
+
+  vec_foreach (fq, fqm->vlib_frame_queues)
+    {
+      fq[0]->codel_first_above_time = 0;
+      fq[0]->codel_dropping = 0;
+      fq[0]->codel_count = 0;
+    }
+}
+
 void
 vlib_process_signal_event_mt_helper (vlib_process_signal_event_mt_args_t *
 				     args)
@@ -57,8 +57,10 @@ typedef struct
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   volatile u32 valid;
   u32 maybe_trace : 1;
+  u32 pinned : 1;
   u32 n_vectors;
   u32 offset;
+  u64 enq_time;
   STRUCT_MARK (end_of_reset);
 
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
@@ -103,6 +105,24 @@ typedef struct
 
 extern vlib_worker_thread_t *vlib_worker_threads;
 
+/* A single producer ring, one per producer thread of a frame queue */
+typedef struct
+{
+  /* static data */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  vlib_frame_queue_elt_t *elts;
+  u32 nelts;
+
+  /* modified by the producer */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  volatile u64 tail;
+  u64 cached_head;
+
+  /* modified by the consumer */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline2);
+  volatile u64 head;
+} vlib_frame_queue_lane_t;
+
 typedef struct
 {
   /* static data */
@@ -112,6 +132,9 @@ typedef struct
   u64 trace;
   u32 nelts;
 
+  /* per producer thread rings, replacing elts if handoff-lanes is set */
+  vlib_frame_queue_lane_t *lanes;
+
   /* modified by enqueue side  */
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
   volatile u64 tail;
@@ -119,9 +142,35 @@ typedef struct
   /* modified by dequeue side  */
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline2);
   volatile u64 head;
+
+  /* lane the consumer starts from, rotated for fairness */
+  u32 next_lane;
+
+  /* held by the dequeuing thread, owner or thief, when stealing is on */
+  volatile u32 consumer_lock;
+  u32 max_in_use;
+
+  /* elements and vectors stolen from this queue */
+  u64 n_elts_stolen;
+  u64 n_vectors_stolen;
+
+  /* successful steals by this queue's thread from other queues */
+  u64 n_steals;
+
+  /* CoDel state, owned by the consumer */
+  u64 codel_first_above_time;
+  u64 codel_drop_next;
+  u32 codel_count;
+  u8 codel_dropping;
+  u64 n_codel_drops;
 }
 vlib_frame_queue_t;
 
+/* Set in a thread index passed to vlib_buffer_enqueue_to_thread to keep
+   the packet on that thread when work stealing is enabled, e.g. because
+   its flow needs ordering. */
+#define VLIB_FRAME_QUEUE_PINNED (1 << 15)
+
 struct vlib_frame_queue_main_t_;
 typedef u32 (vlib_frame_queue_dequeue_fn_t) (
   vlib_main_t *vm, struct vlib_frame_queue_main_t_ *fqm);
@@ -136,6 +185,15 @@ typedef struct vlib_frame_queue_main_t_
   frame_queue_trace_t *frame_queue_traces;
   frame_queue_nelt_counter_t *frame_queue_histogram;
   vlib_frame_queue_dequeue_fn_t *frame_queue_dequeue_fn;
+
+  /* Number of elements in use from which an idle thread steals from a
+     queue, 0 if work stealing is disabled */
+  u32 steal_threshold;
+
+  /* CoDel target sojourn time and interval in cpu clocks, 0 if AQM is
+     disabled */
+  u64 codel_target;
+  u64 codel_interval;
 } vlib_frame_queue_main_t;
 
 typedef struct
@@ -155,6 +213,23 @@ void vlib_create_worker_threads (vlib_main_t * vm, int n,
 
 void vlib_worker_thread_init (vlib_worker_thread_t * w);
 u32 vlib_frame_queue_main_init (u32 node_index, u32 frame_queue_nelts);
+/**
+ * Let a thread whose queue is empty steal frames from another thread's
+ * queue once that has at least steal_threshold elements in use, 0 to
+ * disable. Only for handoffs to stateless nodes; packets which need
+ * ordering must be pinned with VLIB_FRAME_QUEUE_PINNED.
+ * Called with the worker barrier held.
+ */
+void vlib_frame_queue_main_set_steal (u32 frame_queue_index,
+				      u32 steal_threshold);
+/**
+ * Enable CoDel active queue management on a frame queue: elements which
+ * waited longer than target for a whole interval are dropped by the
+ * consumer at the CoDel control law rate. A target of 0 disables it.
+ * Called with the worker barrier held.
+ */
+void vlib_frame_queue_main_set_codel (u32 frame_queue_index, f64 target,
+				      f64 interval);
 
 /* Check for a barrier sync request every 30ms */
 #define BARRIER_SYNC_DELAY (0.030000)
@@ -246,6 +321,18 @@ typedef enum
     SCHED_POLICY_N,
 } sched_policy_t;
 
+/* Barrier hold times of one caller of vlib_worker_thread_barrier_sync */
+typedef struct
+{
+  const char *caller;
+  /* /sys/barrier/<caller>, in microseconds */
+  u32 histogram_index;
+  u64 count;
+  u64 n_over_budget;
+  f64 total;
+  f64 max;
+} vlib_barrier_profile_t;
+
 typedef struct
 {
   /* Link list of registrations, built by constructors */
@@ -305,6 +392,16 @@ typedef struct
   /* NUMA-bound heap size */
   uword numa_heap_size;
 
+  /* Handoff frame queues use a ring per producer thread */
+  u8 handoff_lanes;
+
+  /* Barrier hold times by outermost caller */
+  vlib_barrier_profile_t *barrier_profiles;
+  uword *barrier_profile_by_caller;
+  const char *barrier_profile_caller;
+  /* hold time above which a caller is reported, 0 if none */
+  f64 barrier_budget;
+
 } vlib_thread_main_t;
 
 extern vlib_thread_main_t vlib_thread_main;
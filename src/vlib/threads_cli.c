@@ -103,6 +103,46 @@ VLIB_CLI_COMMAND (show_threads_command, static) = {
   .function = show_threads_fn,
 };
 
+static int
+barrier_profile_cmp (void *a1, void *a2)
+{
+  vlib_barrier_profile_t *bp1 = a1, *bp2 = a2;
+
+  return bp1->max < bp2->max ? 1 : bp1->max > bp2->max ? -1 : 0;
+}
+
+static clib_error_t *
+show_threads_barrier_fn (vlib_main_t *vm, unformat_input_t *input,
+			 vlib_cli_command_t *cmd)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_barrier_profile_t *bp, *sorted;
+
+  if (tm->barrier_budget != 0)
+    vlib_cli_output (vm, "budget %.1fus", tm->barrier_budget * 1e6);
+
+  vlib_cli_output (vm, "%-50s%12s%12s%12s%12s", "Caller", "Count",
+		   "Avg (us)", "Max (us)", "Over budget");
+
+  /* longest first */
+  sorted = vec_dup (tm->barrier_profiles);
+  vec_sort_with_function (sorted, barrier_profile_cmp);
+
+  vec_foreach (bp, sorted)
+    vlib_cli_output (vm, "%-50s%12llu%12.1f%12.1f%12llu", bp->caller,
+		     bp->count, bp->total * 1e6 / bp->count, bp->max * 1e6,
+		     bp->n_over_budget);
+
+  vec_free (sorted);
+  return 0;
+}
+
+VLIB_CLI_COMMAND (show_threads_barrier_command, static) = {
+  .path = "show threads barrier",
+  .short_help = "show threads barrier",
+  .function = show_threads_barrier_fn,
+};
+
 /*
  * Trigger threads to grab frame queue trace data
  */
@@ -533,6 +573,153 @@ VLIB_CLI_COMMAND (cmd_test_frame_queue_threshold,static) = {
     .function = test_frame_queue_threshold,
 };
 
+/*
+ * Enable work stealing between the threads' queues
+ */
+static clib_error_t *
+set_frame_queue_steal (vlib_main_t *vm, unformat_input_t *input,
+		       vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  clib_error_t *error = NULL;
+  u32 threshold = 8;
+  u32 index = ~(u32) 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "threshold %u", &threshold))
+	;
+      else if (unformat (line_input, "index %u", &index))
+	;
+      else if (unformat (line_input, "disable"))
+	threshold = 0;
+      else
+	{
+	  error = clib_error_return (0, "parse error: '%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (index > vec_len (tm->frame_queue_mains) - 1)
+    {
+      error = clib_error_return (0,
+				 "expecting valid worker handoff queue index");
+      goto done;
+    }
+
+  vlib_frame_queue_main_set_steal (index, threshold);
+
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+VLIB_CLI_COMMAND (cmd_set_frame_queue_steal, static) = {
+  .path = "set frame-queue steal",
+  .short_help = "set frame-queue steal index <n> [threshold <elts>] "
+		"[disable]",
+  .function = set_frame_queue_steal,
+};
+
+static clib_error_t *
+set_frame_queue_codel (vlib_main_t *vm, unformat_input_t *input,
+		       vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  clib_error_t *error = NULL;
+  f64 target = 5e-3, interval = 100e-3;
+  u32 index = ~(u32) 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "target %f", &target))
+	;
+      else if (unformat (line_input, "interval %f", &interval))
+	;
+      else if (unformat (line_input, "index %u", &index))
+	;
+      else if (unformat (line_input, "disable"))
+	target = 0;
+      else
+	{
+	  error = clib_error_return (0, "parse error: '%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (index > vec_len (tm->frame_queue_mains) - 1)
+    {
+      error = clib_error_return (0,
+				 "expecting valid worker handoff queue index");
+      goto done;
+    }
+
+  vlib_frame_queue_main_set_codel (index, target, interval);
+
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+VLIB_CLI_COMMAND (cmd_set_frame_queue_codel, static) = {
+  .path = "set frame-queue codel",
+  .short_help = "set frame-queue codel index <n> [target <sec>] "
+		"[interval <sec>] [disable]",
+  .function = set_frame_queue_codel,
+};
+
+static clib_error_t *
+show_frame_queue_steal (vlib_main_t *vm, unformat_input_t *input,
+			vlib_cli_command_t *cmd)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_frame_queue_main_t *fqm;
+  vlib_frame_queue_t *fq;
+  u32 fqix;
+
+  vec_foreach (fqm, tm->frame_queue_mains)
+    {
+      vlib_cli_output (vm,
+		       "Worker handoff queue index %u (next node '%U'), "
+		       "steal threshold %u:",
+		       fqm - tm->frame_queue_mains, format_vlib_node_name, vm,
+		       fqm->node_index, fqm->steal_threshold);
+      vlib_cli_output (vm, "  %-24s%=8s%=10s%=14s%=14s%=10s%=12s", "Thread",
+		       "In-use", "Max-in-use", "Elts-stolen",
+		       "Vecs-stolen", "Steals", "AQM-drops");
+
+      for (fqix = 0; fqix < vec_len (fqm->vlib_frame_queues); fqix++)
+	{
+	  fq = fqm->vlib_frame_queues[fqix];
+	  vlib_cli_output (vm, "  %-24v%=8lu%=10u%=14lu%=14lu%=10lu%=12lu",
+			   vlib_worker_threads[fqix].name,
+			   fq->tail - fq->head, fq->max_in_use,
+			   fq->n_elts_stolen, fq->n_vectors_stolen,
+			   fq->n_steals, fq->n_codel_drops);
+	}
+    }
+  return 0;
+}
+
+VLIB_CLI_COMMAND (cmd_show_frame_queue_steal, static) = {
+  .path = "show frame-queue steal",
+  .short_help = "show frame-queue steal",
+  .function = show_frame_queue_steal,
+  .is_mp_safe = 1,
+};
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
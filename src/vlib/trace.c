@@ -122,7 +122,9 @@ clear_trace_buffer (void)
       tm = &this_vlib_main->trace_main;
 
       tm->trace_enable = 0;
+      tm->sample_interval = 0;
       vec_free (tm->nodes);
+      vec_free (tm->ring);
     }
 
   foreach_vlib_main ()
@@ -411,14 +413,64 @@ trace_update_capture_options (u32 add, u32 node_index, u32 filter, u8 verbose)
   vlib_enable_disable_pkt_trace_filter (! !filter);
 }
 
+/*
+ * Sampled and ring tracing, for a trace that can be left running.
+ *
+ * With a sample interval of N only one in N of the packets an input node
+ * offers for tracing is traced. All the others cost the input node a
+ * counter decrement, and nothing at all in the nodes after it, which only
+ * look at the buffer trace flag.
+ *
+ * With a ring, each thread keeps tracing and recycles its oldest trace
+ * once ring_size traces are held. The trace memory of the recycled entry
+ * is reused, so a running ring doesn't allocate. The trace data stays in
+ * its binary form until "show trace" formats it.
+ */
+void
+trace_update_sample_options (u32 sample_interval, u32 ring_size)
+{
+  foreach_vlib_main ()
+    {
+      vlib_trace_main_t *tm = &this_vlib_main->trace_main;
+
+      tm->sample_interval = sample_interval;
+      tm->sample_countdown = sample_interval;
+
+      if (ring_size)
+	vec_validate_init_empty (tm->ring, ring_size - 1, ~0);
+    }
+}
+
+vlib_trace_header_t **
+vlib_trace_ring_get (vlib_trace_main_t *tm)
+{
+  vlib_trace_header_t **h;
+  u32 *slot = vec_elt_at_index (tm->ring, tm->ring_head);
+
+  /* recycle the oldest trace before allocating, so it can be reused */
+  if (*slot != ~0 && !pool_is_free_index (tm->trace_buffer_pool, *slot))
+    {
+      vec_set_len (tm->trace_buffer_pool[*slot], 0);
+      pool_put_index (tm->trace_buffer_pool, *slot);
+    }
+
+  pool_get (tm->trace_buffer_pool, h);
+  *slot = h - tm->trace_buffer_pool;
+
+  if (++tm->ring_head == vec_len (tm->ring))
+    tm->ring_head = 0;
+
+  return h;
+}
+
 static clib_error_t *
 cli_add_trace_buffer (vlib_main_t * vm,
 		      unformat_input_t * input, vlib_cli_command_t * cmd)
 {
   unformat_input_t _line_input, *line_input = &_line_input;
   vlib_node_t *node;
-  u32 node_index, add;
-  u8 verbose = 0;
+  u32 node_index, add, sample_interval = 0;
+  u8 verbose = 0, ring = 0;
   int filter = 0;
   clib_error_t *error = 0;
 
@@ -438,6 +490,10 @@ cli_add_trace_buffer (vlib_main_t * vm,
 	verbose = 1;
       else if (unformat (line_input, "filter"))
 	filter = 1;
+      else if (unformat (line_input, "sample %u", &sample_interval))
+	;
+      else if (unformat (line_input, "ring"))
+	ring = 1;
       else
 	{
 	  error = clib_error_create ("expected NODE COUNT, got `%U'",
@@ -457,6 +513,13 @@ cli_add_trace_buffer (vlib_main_t * vm,
       goto done;
     }
 
+  if (ring && (add == 0 || add == ~0))
+    {
+      error = clib_error_create ("ring needs a trace count");
+      goto done;
+    }
+
+  trace_update_sample_options (sample_interval, ring ? add : 0);
   trace_update_capture_options (add, node_index, filter, verbose);
 
 done:
@@ -467,7 +530,8 @@ done:
 
 VLIB_CLI_COMMAND (add_trace_cli,static) = {
   .path = "trace add",
-  .short_help = "trace add <input-graph-node> <add'l-pkts-for-node-> [filter] [verbose]",
+  .short_help = "trace add <input-graph-node> <add'l-pkts-for-node-> "
+		"[sample <n>] [ring] [filter] [verbose]",
   .function = cli_add_trace_buffer,
 };
 
@@ -111,6 +111,18 @@ typedef struct
   /* Per node trace counts. */
   vlib_trace_node_t *nodes;
 
+  /* trace one in sample_interval packets, 0 to trace every packet */
+  u32 sample_interval;
+  u32 sample_countdown;
+
+  /*
+   * When set, keep tracing and recycle the oldest trace once this many
+   * are held, instead of stopping when the node trace counts run out.
+   * Trace indices in allocation order, ~0 for an unused slot.
+   */
+  u32 *ring;
+  u32 ring_head;
+
   /* verbosity */
   int verbose;
 
@@ -153,6 +165,8 @@ void vlib_trace_stop_and_clear (void);
 int vlib_enable_disable_pkt_trace_filter (int enable) __attribute__ ((weak));
 void trace_update_capture_options (u32 add, u32 node_index,
 				   u32 filter, u8 verbose);
+void trace_update_sample_options (u32 sample_interval, u32 ring_size);
+vlib_trace_header_t **vlib_trace_ring_get (vlib_trace_main_t *tm);
 void trace_filter_set (u32 node_index, u32 flag, u32 count);
 void clear_trace_buffer (void);
 void vlib_set_trace_filter_function (vlib_is_packet_traced_fn_t *x);
@@ -157,6 +157,14 @@ vlib_trace_buffer (vlib_main_t * vm,
   if (PREDICT_FALSE (tm->trace_enable == 0))
     return 0;
 
+  /* Sampled trace, skip all but one in sample_interval packets */
+  if (PREDICT_FALSE (tm->sample_interval != 0))
+    {
+      if (--tm->sample_countdown)
+	return 0;
+      tm->sample_countdown = tm->sample_interval;
+    }
+
   /* Classifier filter in use? */
   if (PREDICT_FALSE (vlib_global_main.trace_filter.trace_filter_enable))
     {
@@ -183,12 +191,15 @@ vlib_trace_buffer (vlib_main_t * vm,
 
   vlib_trace_next_frame (vm, r, next_index);
 
-  pool_get (tm->trace_buffer_pool, h);
+  if (PREDICT_FALSE (tm->ring != 0))
+    h = vlib_trace_ring_get (tm);
+  else
+    pool_get (tm->trace_buffer_pool, h);
 
   do
     {
       b->flags |= VLIB_BUFFER_IS_TRACED;
-      b->trace_handle = vlib_buffer_make_trace_handle
+      vlib_buffer_cold (b)->trace_handle = vlib_buffer_make_trace_handle
 	(vm->thread_index, h - tm->trace_buffer_pool);
     }
   while (follow_chain && (b = vlib_get_next_buffer (vm, b)));
@@ -202,7 +213,8 @@ vlib_buffer_copy_trace_flag (vlib_main_t * vm, vlib_buffer_t * b,
 {
   vlib_buffer_t *b_target = vlib_get_buffer (vm, bi_target);
   b_target->flags |= b->flags & VLIB_BUFFER_IS_TRACED;
-  b_target->trace_handle = b->trace_handle;
+  vlib_buffer_cold (b_target)->trace_handle =
+    vlib_buffer_cold (b)->trace_handle;
 }
 
 always_inline u32
@@ -226,6 +238,11 @@ vlib_set_trace_count (vlib_main_t * vm, vlib_node_runtime_t * rt, u32 count)
   vlib_trace_node_t *tn = vec_elt_at_index (tm->nodes, rt->node_index);
 
   ASSERT (count <= tn->limit);
+
+  /* the ring recycles old traces, so the node never runs out */
+  if (PREDICT_FALSE (tm->ring != 0))
+    return;
+
   tn->count = tn->limit - count;
 }
 
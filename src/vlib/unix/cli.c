@@ -133,6 +133,11 @@ static unix_cli_banner_t unix_cli_banner_color[] = {
 
 #undef _
 
+/** Pending output above which a CLI command producing output is
+ * paused until the client has read it back below the low mark. */
+#define UNIX_CLI_OUTPUT_HIGH_WATER (1 << 20)
+#define UNIX_CLI_OUTPUT_LOW_WATER (1 << 18)
+
 /** Pager line index */
 typedef struct
 {
@@ -1093,6 +1098,40 @@ unix_cli_pager_reindex (unix_cli_file_t * cf)
  * @param buffer         String of printabe bytes to be output.
  * @param buffer_bytes   The number of bytes in @c buffer to be output.
  */
+/** @brief Pause the calling CLI process until the client drains its output.
+ *
+ * A large show command otherwise buffers its entire output in the
+ * session's output vector when the client reads slower than the command
+ * formats. This is only done outside of the worker barrier, where the
+ * suspension doesn't hold up the workers, and gives up if the client
+ * disconnects.
+ *
+ * @param cli_file_index Index of the Unix CLI session.
+ */
+static void
+unix_cli_output_throttle (uword cli_file_index)
+{
+  unix_main_t *um = &unix_main;
+  unix_cli_main_t *cm = &unix_cli_main;
+  vlib_main_t *vm = um->vlib_main;
+  unix_cli_file_t *cf;
+
+  cf = pool_elt_at_index (cm->cli_file_pool, cli_file_index);
+  if (vec_len (cf->output_vector) < UNIX_CLI_OUTPUT_HIGH_WATER)
+    return;
+
+  if (!vlib_in_process_context (vm) || vlib_worker_thread_barrier_held ())
+    return;
+
+  while (!cf->has_epipe &&
+	 vec_len (cf->output_vector) > UNIX_CLI_OUTPUT_LOW_WATER)
+    {
+      vlib_process_suspend (vm, 1e-3);
+      /* The session pool may have grown while we were suspended */
+      cf = pool_elt_at_index (cm->cli_file_pool, cli_file_index);
+    }
+}
+
 static void
 unix_vlib_cli_output (uword cli_file_index, u8 * buffer, uword buffer_bytes)
 {
@@ -1166,6 +1205,8 @@ unix_vlib_cli_output (uword cli_file_index, u8 * buffer, uword buffer_bytes)
 	  unix_cli_pager_reset (cf);
 	}
     }
+
+  unix_cli_output_throttle (cli_file_index);
 }
 
 /** Identify whether a terminal type is ANSI capable.
@@ -150,6 +150,39 @@ r2_to_reg (elf_main_t *em, vlib_plugin_r2_t *r2,
 }
 
 
+/*
+ * Plugins disabled from the startup config, explicitly or through
+ * "plugin default { disable }", can be rejected before their ELF image
+ * is read and parsed, which dominates load time for unused plugins.
+ */
+static int
+plugin_disabled_by_config (plugin_main_t * pm, plugin_info_t * pi)
+{
+  plugin_config_t *pc;
+  uword *p;
+
+  p = hash_get_mem (pm->config_index_by_name, pi->name);
+  if (p)
+    {
+      pc = vec_elt_at_index (pm->configs, p[0]);
+      if (pc->is_disabled)
+	{
+	  PLUGIN_LOG_NOTICE ("Plugin disabled: %s", pi->name);
+	  return 1;
+	}
+      if (pc->is_enabled)
+	return 0;
+    }
+
+  if (pm->plugins_default_disable)
+    {
+      PLUGIN_LOG_NOTICE ("Plugin disabled (default): %s", pi->name);
+      return 1;
+    }
+
+  return 0;
+}
+
 static int
 load_one_plugin (plugin_main_t * pm, plugin_info_t * pi, int from_early_init)
 {
@@ -165,6 +198,9 @@ load_one_plugin (plugin_main_t * pm, plugin_info_t * pi, int from_early_init)
   plugin_config_t *pc = 0;
   uword *p;
 
+  if (plugin_disabled_by_config (pm, pi))
+    return -1;
+
   if (elf_read_file (&em, (char *) pi->filename))
     return -1;
 
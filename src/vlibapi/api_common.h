@@ -382,6 +382,18 @@ typedef struct api_main_t
   elog_main_t *elog_main;
   int elog_trace_api_messages;
 
+  /* Barrier held across messages, see vl_msg_api_barrier_batch_begin */
+  f64 barrier_batch_max_hold;
+  f64 barrier_batch_held_since;
+  u8 barrier_batch;
+  u8 barrier_batch_held;
+
+  /* Time api-rx-from-ring may spend per wakeup, when the main thread is
+     also forwarding and when it only does control plane work. Zero
+     selects the defaults. */
+  f64 rx_time_budget;
+  f64 rx_control_time_budget;
+
   /** performance counter callback **/
   void (**perf_counter_cbs)
     (struct api_main_t *, u32 id, int before_or_after);
@@ -390,6 +402,11 @@ typedef struct api_main_t
 
 } api_main_t;
 
+void vl_msg_api_barrier_batch_begin (api_main_t *am);
+void vl_msg_api_barrier_batch_end (api_main_t *am);
+void vl_msg_api_barrier_batch_sync (api_main_t *am);
+void vl_msg_api_barrier_batch_release (api_main_t *am);
+
 extern __thread api_main_t *my_api_main;
 
 always_inline api_main_t *
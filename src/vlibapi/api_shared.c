@@ -492,6 +492,59 @@ vl_msg_api_barrier_release (void)
 {
 }
 
+/*
+ * Between vl_msg_api_barrier_batch_begin and vl_msg_api_barrier_batch_end,
+ * the barrier taken for a message which is not mp-safe is kept for the
+ * following messages, for up to barrier_batch_max_hold seconds, so a burst
+ * of e.g. route adds costs one barrier rather than one per message.
+ */
+void
+vl_msg_api_barrier_batch_begin (api_main_t *am)
+{
+  am->barrier_batch = am->barrier_batch_max_hold != 0;
+}
+
+void
+vl_msg_api_barrier_batch_end (api_main_t *am)
+{
+  if (am->barrier_batch_held)
+    vl_msg_api_barrier_release ();
+  am->barrier_batch_held = 0;
+  am->barrier_batch = 0;
+}
+
+void
+vl_msg_api_barrier_batch_sync (api_main_t *am)
+{
+  f64 now;
+
+  if (!am->barrier_batch)
+    {
+      vl_msg_api_barrier_sync ();
+      return;
+    }
+
+  now = unix_time_now ();
+  if (am->barrier_batch_held)
+    {
+      if (now < am->barrier_batch_held_since + am->barrier_batch_max_hold)
+	return;
+      /* held long enough, let the workers run */
+      vl_msg_api_barrier_release ();
+    }
+
+  vl_msg_api_barrier_sync ();
+  am->barrier_batch_held = 1;
+  am->barrier_batch_held_since = now;
+}
+
+void
+vl_msg_api_barrier_batch_release (api_main_t *am)
+{
+  if (!am->barrier_batch)
+    vl_msg_api_barrier_release ();
+}
+
 always_inline void
 msg_handler_internal (api_main_t *am, void *the_msg, uword msg_len,
 		      int trace_it, int do_it, int free_it)
@@ -557,7 +610,7 @@ msg_handler_internal (api_main_t *am, void *the_msg, uword msg_len,
 	  if (!m->is_mp_safe)
 	    {
 	      vl_msg_api_barrier_trace_context (am->msg_names[id]);
-	      vl_msg_api_barrier_sync ();
+	      vl_msg_api_barrier_batch_sync (am);
 	    }
 
 	  if (m->is_autoendian)
@@ -574,7 +627,7 @@ msg_handler_internal (api_main_t *am, void *the_msg, uword msg_len,
 				 1 /* after */ );
 
 	  if (!m->is_mp_safe)
-	    vl_msg_api_barrier_release ();
+	    vl_msg_api_barrier_batch_release (am);
 	}
     }
   else
@@ -41,6 +41,10 @@
 
 #define TRACE_VLIB_MEMORY_QUEUE 0
 
+/* Default api-rx-from-ring time budgets per wakeup, see "api-queue" */
+#define VL_API_RX_TIME_BUDGET	      10e-6
+#define VL_API_RX_CONTROL_TIME_BUDGET 500e-6
+
 #include <vlibmemory/vl_memory_msg_enum.h> /* enumerate all vlib messages */
 
 #define vl_typedefs /* define message structures */
@@ -325,7 +329,7 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
   clib_error_t *e;
   api_main_t *am = vlibapi_get_main ();
   f64 dead_client_scan_time;
-  f64 sleep_time, start_time;
+  f64 sleep_time, start_time, time_budget;
   f64 vector_rate;
   clib_error_t *error;
   uword event_type;
@@ -391,6 +395,18 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
        */
       vector_rate = (f64) vlib_last_vectors_per_main_loop (vm);
       start_time = vlib_time_now (vm);
+
+      /* With workers present and no traffic on the main thread, it is
+	 a pure control thread and can drain the queue for longer */
+      if (vlib_num_workers () && vector_rate < 1.0)
+	time_budget = am->rx_control_time_budget ?
+			am->rx_control_time_budget :
+			VL_API_RX_CONTROL_TIME_BUDGET;
+      else
+	time_budget =
+	  am->rx_time_budget ? am->rx_time_budget : VL_API_RX_TIME_BUDGET;
+
+      vl_msg_api_barrier_batch_begin (am);
       while (1)
 	{
 	  if (vl_mem_api_handle_rpc (vm, node) ||
@@ -402,8 +418,8 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      break;
 	    }
 
-	  /* Allow no more than 10us without a pause */
-	  if (vlib_time_now (vm) > start_time + 10e-6)
+	  /* Allow no more than time_budget without a pause */
+	  if (vlib_time_now (vm) > start_time + time_budget)
 	    {
 	      int index = SLEEP_400_US;
 	      if (vector_rate > 40.0)
@@ -427,6 +443,7 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      break;
 	    }
 	}
+      vl_msg_api_barrier_batch_end (am);
 
       /*
        * see if we have any private api shared-memory segments
@@ -453,6 +470,7 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	  break;
 	case SOCKET_READ_EVENT:
+	  vl_msg_api_barrier_batch_begin (am);
 	  for (i = 0; i < vec_len (event_data); i++)
 	    {
 	      vl_api_registration_t *regp;
@@ -468,6 +486,7 @@ vl_api_clnt_process (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      vec_free (a->data);
 	      pool_put (socket_main.process_args, a);
 	    }
+	  vl_msg_api_barrier_batch_end (am);
 	  break;
 
 	  /* Timeout... */
@@ -808,7 +808,7 @@ vl_mem_api_handler_with_vm_node (api_main_t *am, svm_region_t *vlib_rp,
       if (!is_mp_safe)
 	{
 	  vl_msg_api_barrier_trace_context (am->msg_data[id].name);
-	  vl_msg_api_barrier_sync ();
+	  vl_msg_api_barrier_batch_sync (am);
 	}
       if (is_private)
 	{
@@ -840,7 +840,7 @@ vl_mem_api_handler_with_vm_node (api_main_t *am, svm_region_t *vlib_rp,
 	  am->shmem_hdr = save_shmem_hdr;
 	}
       if (!is_mp_safe)
-	vl_msg_api_barrier_release ();
+	vl_msg_api_barrier_batch_release (am);
     }
   else
     {
@@ -1195,6 +1195,14 @@ api_queue_config_fn (vlib_main_t * vm, unformat_input_t * input)
 	    clib_warning ("vlib input queue length %d too small, ignored",
 			  nitems);
 	}
+      else if (unformat (input, "barrier-batch %f",
+			 &am->barrier_batch_max_hold))
+	am->barrier_batch_max_hold *= 1e-6;
+      else if (unformat (input, "rx-budget %f", &am->rx_time_budget))
+	am->rx_time_budget *= 1e-6;
+      else if (unformat (input, "control-rx-budget %f",
+			 &am->rx_control_time_budget))
+	am->rx_control_time_budget *= 1e-6;
       else
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
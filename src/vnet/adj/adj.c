@@ -31,7 +31,7 @@ vlib_combined_counter_main_t adjacency_counters = {
 /*
  * the single adj pool
  */
-ip_adjacency_t *adj_pool;
+clib_segpool_t adj_pool;
 
 /**
  * The adjacency logger
@@ -69,31 +69,32 @@ ip_adjacency_t *
 adj_alloc (fib_protocol_t proto)
 {
     ip_adjacency_t *adj;
-    u8 need_barrier_sync = pool_get_will_expand (adj_pool);
+    adj_index_t ai;
+    u8 need_barrier_sync;
     vlib_main_t *vm;
     vm = vlib_get_main();
 
     ASSERT (vm->thread_index == 0);
 
-    /* If the adj_pool will expand, stop the parade. */
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_sync (vm);
+    if (PREDICT_FALSE(adj_pool.elts.dir == NULL))
+        clib_segpool_init(&adj_pool, sizeof(ip_adjacency_t),
+                          8 /* log2 chunk elts */, CLIB_CACHE_LINE_BYTES);
 
-    pool_get_aligned(adj_pool, adj, CLIB_CACHE_LINE_BYTES);
+    /*
+     * adjs are allocated in chunks which never move, so the pool can
+     * grow under the workers' feet.
+     */
+    adj = clib_segpool_get(&adj_pool, &ai);
 
     adj_poison(adj);
+    adj->ia_index = ai;
 
-    /* Validate adjacency counters. */
-    if (need_barrier_sync == 0)
-    {
-        /* If the adj counter pool will expand, stop the parade */
-        need_barrier_sync = vlib_validate_combined_counter_will_expand
-            (&adjacency_counters, adj_get_index (adj));
-        if (need_barrier_sync)
-            vlib_worker_thread_barrier_sync (vm);
-    }
-    vlib_validate_combined_counter(&adjacency_counters,
-                                   adj_get_index(adj));
+    /* If the adj counter vector will expand, stop the parade */
+    need_barrier_sync = vlib_validate_combined_counter_will_expand
+        (&adjacency_counters, ai);
+    if (need_barrier_sync)
+        vlib_worker_thread_barrier_sync (vm);
+    vlib_validate_combined_counter(&adjacency_counters, ai);
 
     /* Make sure certain fields are always initialized. */
     vlib_zero_combined_counter(&adjacency_counters,
@@ -316,7 +317,7 @@ adj_last_lock_gone (ip_adjacency_t *adj)
     fib_node_deinit(&adj->ia_node);
     ASSERT(0 == vec_len(adj->ia_delegates));
     vec_free(adj->ia_delegates);
-    pool_put(adj_pool, adj);
+    clib_segpool_put_index(&adj_pool, adj_get_index(adj));
     vlib_worker_thread_barrier_release(vm);
 }
 
@@ -681,7 +682,8 @@ adj_show (vlib_main_t * vm,
 
     if (summary)
     {
-        vlib_cli_output (vm, "Number of adjacencies: %d", pool_elts(adj_pool));
+        vlib_cli_output (vm, "Number of adjacencies: %d",
+                         clib_segpool_elts(&adj_pool));
         vlib_cli_output (vm, "Per-adjacency counters: %s",
                          (adj_are_counters_enabled() ?
                           "enabled":
@@ -691,7 +693,7 @@ adj_show (vlib_main_t * vm,
     {
         if (ADJ_INDEX_INVALID != ai)
         {
-            if (pool_is_free_index(adj_pool, ai))
+            if (clib_segpool_is_free_index(&adj_pool, ai))
             {
                 vlib_cli_output (vm, "adjacency %d invalid", ai);
                 return 0;
@@ -704,7 +706,7 @@ adj_show (vlib_main_t * vm,
         }
         else
         {
-            pool_foreach_index (ai, adj_pool)
+            clib_segpool_foreach_index (ai, &adj_pool)
              {
                 if (~0 != sw_if_index &&
                     sw_if_index != adj_get_sw_if_index(ai))
@@ -45,6 +45,7 @@
 #include <vnet/adj/adj_nbr.h>
 #include <vnet/adj/adj_glean.h>
 #include <vnet/adj/rewrite.h>
+#include <vppinfra/segvec.h>
 
 /** @brief Common (IP4/IP6) next index stored in adjacency. */
 typedef enum
@@ -345,10 +346,15 @@ typedef struct ip_adjacency_t_
    */
   adj_flags_t ia_flags;
 
+  /**
+   * Index of this adj in the adj pool
+   */
+  adj_index_t ia_index;
+
   /**
    * Free space on the fourth cacheline (not used in the DP)
    */
-  u8 __ia_pad[48];
+  u8 __ia_pad[44];
 } ip_adjacency_t;
 
 STATIC_ASSERT ((STRUCT_OFFSET_OF (ip_adjacency_t, cacheline0) == 0),
@@ -436,9 +442,11 @@ extern int adj_recursive_loop_detect (adj_index_t ai,
 
 /**
  * @brief
- * The global adjacency pool. Exposed for fast/inline data-plane access
+ * The global adjacency pool. Exposed for fast/inline data-plane access.
+ * Adjacencies never move as the pool grows, so workers need not be
+ * stopped to allocate one.
  */
-extern ip_adjacency_t *adj_pool;
+extern clib_segpool_t adj_pool;
 
 /**
  * @brief 
@@ -459,13 +467,13 @@ extern int adj_per_adj_counters;
 static inline ip_adjacency_t *
 adj_get (adj_index_t adj_index)
 {
-    return (pool_elt_at_index(adj_pool, adj_index));
+    return (clib_segpool_elt_at_index(&adj_pool, adj_index));
 }
 
 static inline int
 adj_is_valid(adj_index_t adj_index)
 {
-  return !(pool_is_free_index(adj_pool, adj_index));
+  return !(clib_segpool_is_free_index(&adj_pool, adj_index));
 }
 
 /**
@@ -35,7 +35,7 @@ extern vlib_log_class_t adj_logger;
 #define ADJ_DBG(_adj, _fmt, _args...)		        \
 {                                                       \
     vlib_log_debug(adj_logger, "adj:[%d:%p]:" _fmt,     \
-                   _adj - adj_pool, _adj,		\
+                   adj_get_index(_adj), _adj,		\
                    ##_args);                            \
 }
 
@@ -104,7 +104,7 @@ adj_proto_to_46 (fib_protocol_t proto)
 static inline adj_index_t
 adj_get_index (const ip_adjacency_t *adj)
 {
-    return (adj - adj_pool);
+    return (adj->ia_index);
 }
 
 extern void adj_nbr_update_rewrite_internal(ip_adjacency_t *adj,
@@ -654,7 +654,7 @@ adj_nbr_walk (u32 sw_if_index,
     vec_foreach(aip, ais)
     {
         /* An adj may be deleted during the walk so check first */
-        if (!pool_is_free_index(adj_pool, *aip))
+        if (!clib_segpool_is_free_index(&adj_pool, *aip))
             cb(*aip, ctx);
     }
     vec_free(ais);
@@ -1147,8 +1147,8 @@ static void
 adj_mem_show (void)
 {
     fib_show_memory_usage("Adjacency",
-			  pool_elts(adj_pool),
-			  pool_len(adj_pool),
+			  clib_segpool_elts(&adj_pool),
+			  clib_segpool_len(&adj_pool),
 			  sizeof(ip_adjacency_t));
 }
 
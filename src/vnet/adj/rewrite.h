@@ -171,6 +171,35 @@ vnet_rewrite_get_data_internal (vnet_rewrite_header_t * rw, int max_size)
 #define vnet_rewrite_get_data(rw) \
   vnet_rewrite_get_data_internal (&((rw).rewrite_header), sizeof ((rw).rewrite_data))
 
+/*
+ * Copy a rewrite of any length in front of packet0. Rewrites of up to 64
+ * bytes, which covers tunnel encaps, MPLS label stacks and SRv6 headers
+ * as well as the L2 ones, are copied with one masked or blended 64 byte
+ * store and no branches on the length.
+ */
+always_inline void
+vnet_rewrite_copy_header (const vnet_rewrite_header_t *h0, void *packet0)
+{
+  u8 *dst = (u8 *) packet0 - h0->data_bytes;
+  u8 *src = (u8 *) h0->data;
+
+#if defined(CLIB_HAVE_VEC512)
+  if (PREDICT_TRUE (h0->data_bytes <= 64))
+    {
+      u8x64_store_partial (u8x64_load_partial (src, h0->data_bytes), dst,
+			   h0->data_bytes);
+      return;
+    }
+#elif defined(CLIB_HAVE_VEC128)
+  if (PREDICT_TRUE (h0->data_bytes <= 64))
+    {
+      clib_memcpy_le64 (dst, src, h0->data_bytes);
+      return;
+    }
+#endif
+  clib_memcpy_fast (dst, src, h0->data_bytes);
+}
+
 always_inline void
 _vnet_rewrite_one_header (const vnet_rewrite_header_t * h0,
 			  void *packet0, int most_likely_size)
@@ -184,8 +213,7 @@ _vnet_rewrite_one_header (const vnet_rewrite_header_t * h0,
     }
   else
     {
-      clib_memcpy_fast ((u8 *) packet0 - h0->data_bytes,
-			h0->data, h0->data_bytes);
+      vnet_rewrite_copy_header (h0, packet0);
     }
 }
 
@@ -208,10 +236,8 @@ _vnet_rewrite_two_headers (const vnet_rewrite_header_t * h0,
     }
   else
     {
-      clib_memcpy_fast ((u8 *) packet0 - h0->data_bytes,
-			h0->data, h0->data_bytes);
-      clib_memcpy_fast ((u8 *) packet1 - h1->data_bytes,
-			h1->data, h1->data_bytes);
+      vnet_rewrite_copy_header (h0, packet0);
+      vnet_rewrite_copy_header (h1, packet1);
     }
 }
 
@@ -1186,6 +1186,22 @@ bfd_on_timeout (vlib_main_t *vm, vlib_node_runtime_t *rt, bfd_main_t *bm,
     }
 }
 
+void
+bfd_tx_flush (vlib_main_t *vm, vlib_node_runtime_t *rt, bfd_main_t *bm)
+{
+  vlib_node_t *from_node = vlib_get_node (vm, rt->node_index);
+  u32 next;
+
+  for (next = 0; next < BFD_TX_N_NEXT; next++)
+    {
+      if (!bm->tx_frames[next])
+	continue;
+      vlib_put_frame_to_node (vm, from_node->next_nodes[next],
+			      bm->tx_frames[next]);
+      bm->tx_frames[next] = 0;
+    }
+}
+
 u8 *
 format_bfd_process_trace (u8 *s, va_list *args)
 {
@@ -1335,6 +1351,8 @@ bfd_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
 	  }
       }
       bfd_unlock (bm);
+      /* all packets sent during this wakeup go out in one frame per next */
+      bfd_tx_flush (vm, rt, bm);
       if (expired)
 	{
 	  vec_set_len (expired, 0);
@@ -1356,6 +1374,7 @@ VLIB_REGISTER_NODE (bfd_process_node, static) =
 {
   .function = bfd_process,
   .type = VLIB_NODE_TYPE_PROCESS,
+  .process_priority = VLIB_PROCESS_PRIORITY_HIGH,
   .name = "bfd-process",
   .flags = (VLIB_NODE_FLAG_TRACE_SUPPORTED),
   .format_trace = format_bfd_process_trace,
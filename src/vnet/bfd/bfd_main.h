@@ -262,6 +262,19 @@ typedef enum
  */
 typedef void (*bfd_notify_fn_t) (bfd_listen_event_e, const bfd_session_t *);
 
+typedef enum
+{
+  BFD_TX_IP4_ARP,
+  BFD_TX_IP6_NDP,
+  BFD_TX_IP4_REWRITE,
+  BFD_TX_IP6_REWRITE,
+  BFD_TX_IP4_MIDCHAIN,
+  BFD_TX_IP6_MIDCHAIN,
+  BFD_TX_IP4_LOOKUP,
+  BFD_TX_IP6_LOOKUP,
+  BFD_TX_N_NEXT,
+} bfd_tx_next_t;
+
 typedef struct
 {
   /** lock to protect data structures */
@@ -333,6 +346,9 @@ typedef struct
   vlib_combined_counter_main_t rx_echo_counter;
   vlib_combined_counter_main_t tx_counter;
   vlib_combined_counter_main_t tx_echo_counter;
+
+  /** frames being filled by the bfd process, flushed once per wakeup */
+  vlib_frame_t *tx_frames[BFD_TX_N_NEXT];
 } bfd_main_t;
 
 extern bfd_main_t bfd_main;
@@ -481,18 +497,10 @@ const char *bfd_hop_type_string (bfd_hop_type_e state);
  */
 void bfd_register_listener (bfd_notify_fn_t fn);
 
-typedef enum
-{
-  BFD_TX_IP4_ARP,
-  BFD_TX_IP6_NDP,
-  BFD_TX_IP4_REWRITE,
-  BFD_TX_IP6_REWRITE,
-  BFD_TX_IP4_MIDCHAIN,
-  BFD_TX_IP6_MIDCHAIN,
-  BFD_TX_IP4_LOOKUP,
-  BFD_TX_IP6_LOOKUP,
-  BFD_TX_N_NEXT,
-} bfd_tx_next_t;
+/**
+ * Hand the frames built while sending packets to their next nodes.
+ */
+void bfd_tx_flush (vlib_main_t *vm, vlib_node_runtime_t *rt, bfd_main_t *bm);
 
 #endif /* __included_bfd_main_h__ */
 
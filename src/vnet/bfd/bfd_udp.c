@@ -402,19 +402,25 @@ bfd_create_frame_to_next_node (vlib_main_t *vm, vlib_node_runtime_t *rt,
 			       u32 bi, const bfd_session_t *bs, u32 next,
 			       vlib_combined_counter_main_t *tx_counter)
 {
+  bfd_main_t *bm = bfd_udp_main.bfd_main;
   vlib_buffer_t *b = vlib_get_buffer (vm, bi);
   vlib_node_t *from_node = vlib_get_node (vm, rt->node_index);
   ASSERT (next < vec_len (from_node->next_nodes));
   u32 to_node_index = from_node->next_nodes[next];
-  vlib_frame_t *f = vlib_get_frame_to_node (vm, to_node_index);
+  vlib_frame_t *f = bm->tx_frames[next];
+  if (f && f->n_vectors == VLIB_FRAME_SIZE)
+    {
+      vlib_put_frame_to_node (vm, to_node_index, f);
+      f = 0;
+    }
+  if (!f)
+    f = bm->tx_frames[next] = vlib_get_frame_to_node (vm, to_node_index);
   u32 *to_next = vlib_frame_vector_args (f);
-  to_next[0] = bi;
-  f->n_vectors = 1;
+  to_next[f->n_vectors++] = bi;
   if (b->flags & VLIB_BUFFER_IS_TRACED)
     {
       f->frame_flags |= VLIB_NODE_FLAG_TRACE;
     }
-  vlib_put_frame_to_node (vm, to_node_index, f);
   vlib_increment_combined_counter (tx_counter, vm->thread_index, bs->bs_idx, 1,
 				   vlib_buffer_length_in_chain (vm, b));
 }
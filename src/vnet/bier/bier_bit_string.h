@@ -18,6 +18,7 @@
 
 #include <vppinfra/byte_order.h>
 #include <vppinfra/format.h>
+#include <vppinfra/vector.h>
 
 #include <vnet/bier/bier_types.h>
 
@@ -50,49 +51,99 @@ extern u8 *format_bier_bit_string(u8 * s, va_list * args);
 #define BIER_BBS_NUM_INT_BUCKETS(_bbs) \
     (BIER_BBS_LEN_TO_BUCKETS(_bbs->bbs_len) / sizeof(int))
 
+/*
+ * The whole-string operations below run on the widest vectors the target
+ * offers and finish with 64 bit words. A bit-string is always a multiple
+ * of 8 bytes long, from 64 up to 4096 bits.
+ */
 always_inline int
 bier_bit_string_is_zero (const bier_bit_string_t *src)
 {
-    u16 index;
+    u8 *s = src->bbs_buckets;
+    u16 n_left = src->bbs_len;
 
-    for (index = 0;
-         index < BIER_BBS_NUM_INT_BUCKETS(src);
-         index++) {
-        if (((int*)src->bbs_buckets)[index] != 0) {
+#if defined(CLIB_HAVE_VEC512)
+    for (; n_left >= 64; n_left -= 64, s += 64)
+        if (!u8x64_is_all_zero(u8x64_load_unaligned(s)))
+            return (0);
+#endif
+#if defined(CLIB_HAVE_VEC256)
+    for (; n_left >= 32; n_left -= 32, s += 32)
+        if (!u8x32_is_all_zero(u8x32_load_unaligned(s)))
+            return (0);
+#endif
+#if defined(CLIB_HAVE_VEC128)
+    for (; n_left >= 16; n_left -= 16, s += 16)
+        if (!u8x16_is_all_zero(u8x16_load_unaligned(s)))
+            return (0);
+#endif
+    for (; n_left >= 8; n_left -= 8, s += 8)
+        if (clib_mem_unaligned(s, u64))
             return (0);
-        }
-    }
+
     return (1);
 }
 
+/*
+ * dest &= ~src
+ */
 always_inline void
 bier_bit_string_clear_string (const bier_bit_string_t *src,
                               bier_bit_string_t *dest)
 {
-    u16 index;
+    u8 *s = src->bbs_buckets, *d = dest->bbs_buckets;
+    u16 n_left = src->bbs_len;
 
     ASSERT(src->bbs_len == dest->bbs_len);
 
-    for (index = 0;
-         index < BIER_BBS_NUM_INT_BUCKETS(src);
-         index++) {
-        ((int*)dest->bbs_buckets)[index] &= ~(((int*)src->bbs_buckets)[index]);
-    }
+#if defined(CLIB_HAVE_VEC512)
+    for (; n_left >= 64; n_left -= 64, s += 64, d += 64)
+        u8x64_store_unaligned(u8x64_load_unaligned(d) &
+                              ~u8x64_load_unaligned(s), d);
+#endif
+#if defined(CLIB_HAVE_VEC256)
+    for (; n_left >= 32; n_left -= 32, s += 32, d += 32)
+        u8x32_store_unaligned(u8x32_load_unaligned(d) &
+                              ~u8x32_load_unaligned(s), d);
+#endif
+#if defined(CLIB_HAVE_VEC128)
+    for (; n_left >= 16; n_left -= 16, s += 16, d += 16)
+        u8x16_store_unaligned(u8x16_load_unaligned(d) &
+                              ~u8x16_load_unaligned(s), d);
+#endif
+    for (; n_left >= 8; n_left -= 8, s += 8, d += 8)
+        clib_mem_unaligned(d, u64) &= ~clib_mem_unaligned(s, u64);
 }
 
+/*
+ * dest &= src
+ */
 always_inline void
 bier_bit_string_logical_and_string (const bier_bit_string_t *src,
                                     bier_bit_string_t *dest)
 {
-    u16 index;
+    u8 *s = src->bbs_buckets, *d = dest->bbs_buckets;
+    u16 n_left = src->bbs_len;
 
     ASSERT(src->bbs_len == dest->bbs_len);
 
-    for (index = 0;
-         index < BIER_BBS_NUM_INT_BUCKETS(src);
-         index++) {
-        ((int*)dest->bbs_buckets)[index] &= ((int*)src->bbs_buckets)[index];
-    }
+#if defined(CLIB_HAVE_VEC512)
+    for (; n_left >= 64; n_left -= 64, s += 64, d += 64)
+        u8x64_store_unaligned(u8x64_load_unaligned(d) &
+                              u8x64_load_unaligned(s), d);
+#endif
+#if defined(CLIB_HAVE_VEC256)
+    for (; n_left >= 32; n_left -= 32, s += 32, d += 32)
+        u8x32_store_unaligned(u8x32_load_unaligned(d) &
+                              u8x32_load_unaligned(s), d);
+#endif
+#if defined(CLIB_HAVE_VEC128)
+    for (; n_left >= 16; n_left -= 16, s += 16, d += 16)
+        u8x16_store_unaligned(u8x16_load_unaligned(d) &
+                              u8x16_load_unaligned(s), d);
+#endif
+    for (; n_left >= 8; n_left -= 8, s += 8, d += 8)
+        clib_mem_unaligned(d, u64) &= clib_mem_unaligned(s, u64);
 }
 
 always_inline void
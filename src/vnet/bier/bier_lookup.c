@@ -84,7 +84,9 @@ bier_lookup (vlib_main_t * vm,
     u32 n_left_from, next_index, * from, * to_next;
     bier_lookup_main_t *blm = &bier_lookup_main;
     clib_thread_index_t thread_index = vlib_get_thread_index ();
-    bier_bit_mask_bucket_t buckets_copy[BIER_HDR_BUCKETS_4096];
+    bier_bit_mask_bucket_t buckets_copy[BIER_HDR_BUCKETS_4096]
+        __clib_aligned(CLIB_CACHE_LINE_BYTES);
+    u32 n_unres = 0;
 
     from = vlib_frame_vector_args (from_frame);
     n_left_from = from_frame->n_vectors;
@@ -102,12 +104,13 @@ bier_lookup (vlib_main_t * vm,
             u32 next0, bi0, n_bytes, bti0, bfmi0;
             const bier_fmask_t *bfm0;
             const bier_table_t *bt0;
-            u16 index, num_buckets;
+            u16 index, num_words;
             const bier_hdr_t *bh0;
             bier_bit_string_t bbs;
             vlib_buffer_t *b0;
             bier_bp_t fbs;
-            int bucket;
+            u64 *words;
+            u32 bit;
 
             bi0 = from[0];
             from += 1;
@@ -140,7 +143,7 @@ bier_lookup (vlib_main_t * vm,
             n_bytes = bier_hdr_len_id_to_num_buckets(bt0->bt_id.bti_hdr_len);
             vnet_buffer(b0)->mpls.bier.n_bytes = n_bytes;
             vnet_buffer(b0)->sw_if_index[VLIB_TX] = ~0;
-            num_buckets = n_bytes / sizeof(int);
+            num_words = n_bytes / sizeof(u64);
             bier_bit_string_init(&bbs,
                                  bt0->bt_id.bti_hdr_len,
                                  buckets_copy);
@@ -152,18 +155,19 @@ bier_lookup (vlib_main_t * vm,
             vec_reset_length (blm->blm_fmasks[thread_index]);
 
             /*
-             * Loop through the buckets in the header
+             * Loop through the header a 64 bit word at a time, so the
+             * empty stretches of large strings are skipped quickly
              */
-            for (index = 0; index < num_buckets; index++) {
+            words = (u64 *) bbs.bbs_buckets;
+
+            for (index = 0; index < num_words; index++) {
                 /*
-                 * loop through each bit in the bucket
+                 * loop through each bit in the word
                  */
-                bucket = ((int*)bbs.bbs_buckets)[index];
-
-                while (bucket) {
-                    fbs  = bier_find_first_bit_string_set(bucket);
-                    fbs += (((num_buckets - 1) - index) *
-                            BIER_BIT_MASK_BITS_PER_INT);
+                while (words[index]) {
+                    bit = count_trailing_zeros(
+                        clib_net_to_host_u64(words[index]));
+                    fbs = bit + 1 + (((num_words - 1) - index) * 64);
 
                     bfmi0 = bier_table_fwd_lookup(bt0, fbs);
 
@@ -172,7 +176,7 @@ bier_lookup (vlib_main_t * vm,
                      * MUST be cleared from the packet
                      * otherwise we could be in this loop a while ...
                      */
-                    bier_bit_string_clear_bit(&bbs, fbs);
+                    words[index] &= ~clib_host_to_net_u64(1ULL << bit);
 
                     if (PREDICT_TRUE(INDEX_INVALID != bfmi0))
                     {
@@ -185,7 +189,6 @@ bier_lookup (vlib_main_t * vm,
                         bier_bit_string_clear_string(
                             &bfm0->bfm_bits.bfmb_input_reset_string,
                             &bbs);
-                        bucket = ((int*)bbs.bbs_buckets)[index];
 
                         /*
                          * the fmask is resolved so replicate a
@@ -198,11 +201,7 @@ bier_lookup (vlib_main_t * vm,
                         /*
                          * go to the next bit-position set
                          */
-                        vlib_node_increment_counter(
-                            vm, node->node_index,
-                            BIER_LOOKUP_ERROR_FMASK_UNRES, 1);
-                        bucket = ((int*)bbs.bbs_buckets)[index];
-                        continue;
+                        n_unres++;
                     }
                 }
             }
@@ -306,6 +305,9 @@ bier_lookup (vlib_main_t * vm,
         vlib_put_next_frame(vm, node, next_index, n_left_to_next);
     }
 
+    vlib_node_increment_counter(vm, bier_lookup_node.index,
+                                BIER_LOOKUP_ERROR_FMASK_UNRES,
+                                n_unres);
     vlib_node_increment_counter(vm, bier_lookup_node.index,
                                 BIER_LOOKUP_ERROR_NONE,
                                 from_frame->n_vectors);
@@ -22,6 +22,67 @@
 #include <vnet/bonding/node.h>
 #include <vlib/stats/stats.h>
 
+/*
+ * Rebuild the lb bucket table after the active member set has changed.
+ * Buckets stay with their member unless that member is gone or holds more
+ * than its fair share; only the remaining buckets are handed out to the
+ * least loaded members. Called with the bond lock held.
+ */
+static void
+bond_lb_buckets_update (bond_if_t * bif)
+{
+  u32 i, b, n_members, max_per_member, *load = 0;
+
+  n_members = vec_len (bif->active_members);
+  if (bif->n_numa_members >= 1)
+    n_members = bif->n_numa_members;
+
+  if (n_members == 0)
+    {
+      vec_reset_length (bif->lb_buckets);
+      vec_reset_length (bif->lb_bucket_members);
+      return;
+    }
+
+  vec_validate_init_empty (bif->lb_bucket_members, BOND_LB_N_BUCKETS - 1, ~0);
+  vec_validate (bif->lb_buckets, BOND_LB_N_BUCKETS - 1);
+  vec_validate (load, n_members - 1);
+  max_per_member = (BOND_LB_N_BUCKETS + n_members - 1) / n_members;
+
+  /* keep what can be kept */
+  for (b = 0; b < BOND_LB_N_BUCKETS; b++)
+    {
+      bif->lb_buckets[b] = (u16) ~0;
+      for (i = 0; i < n_members; i++)
+	if (bif->active_members[i] == bif->lb_bucket_members[b])
+	  {
+	    if (load[i] < max_per_member)
+	      {
+		bif->lb_buckets[b] = i;
+		load[i]++;
+	      }
+	    break;
+	  }
+    }
+
+  /* hand out the rest */
+  for (b = 0; b < BOND_LB_N_BUCKETS; b++)
+    {
+      u32 min = 0;
+
+      if (bif->lb_buckets[b] != (u16) ~0)
+	continue;
+      for (i = 1; i < n_members; i++)
+	if (load[i] < load[min])
+	  min = i;
+      bif->lb_buckets[b] = min;
+      bif->lb_bucket_members[b] = bif->active_members[min];
+      load[min]++;
+    }
+
+  vec_free (load);
+}
+
 void
 bond_disable_collecting_distributing (vlib_main_t * vm, member_if_t * mif)
 {
@@ -58,6 +119,8 @@ bond_disable_collecting_distributing (vlib_main_t * vm, member_if_t * mif)
       }
   }
 
+  bond_lb_buckets_update (bif);
+
   /* We get a new member just becoming active */
   if (switching_active)
     vlib_process_signal_event (bm->vlib_main, bond_process_node.index,
@@ -169,6 +232,8 @@ bond_enable_collecting_distributing (vlib_main_t * vm, member_if_t * mif)
 	bond_sort_members (bif);
     }
 
+  bond_lb_buckets_update (bif);
+
 done:
   clib_spinlock_unlock_if_init (&bif->lockp);
 }
@@ -366,6 +431,8 @@ bond_delete_if (vlib_main_t * vm, u32 sw_if_index)
   ethernet_delete_interface (vnm, bif->hw_if_index);
 
   clib_bitmap_free (bif->port_number_bitmap);
+  vec_free (bif->lb_buckets);
+  vec_free (bif->lb_bucket_members);
   hash_unset (bm->bond_by_sw_if_index, bif->sw_if_index);
   hash_unset (bm->id_used, bif->id);
   clib_memset (bif, 0, sizeof (*bif));
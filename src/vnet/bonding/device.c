@@ -350,6 +350,28 @@ bond_hash_to_port (u32 * h, u32 n_left, u32 n_members,
     }
 }
 
+static_always_inline void
+bond_hash_to_bucket (u32 *h, u16 *buckets, u32 n_left)
+{
+  u32 mask = BOND_LB_N_BUCKETS - 1;
+
+  while (n_left >= 4)
+    {
+      h[0] = buckets[h[0] & mask];
+      h[1] = buckets[h[1] & mask];
+      h[2] = buckets[h[2] & mask];
+      h[3] = buckets[h[3] & mask];
+      n_left -= 4;
+      h += 4;
+    }
+  while (n_left)
+    {
+      h[0] = buckets[h[0] & mask];
+      n_left -= 1;
+      h += 1;
+    }
+}
+
 static_always_inline void
 bond_update_sw_if_index (bond_per_thread_data_t *ptd, bond_if_t *bif, u32 *bi,
 			 vlib_buffer_t **b, u32 *data, u32 n_left,
@@ -505,6 +527,11 @@ VNET_DEVICE_CLASS_TX_FN (bond_dev_class) (vlib_main_t * vm,
    */
   vec_validate (ptd->active_members, vec_len (bif->active_members) - 1);
   vec_copy (ptd->active_members, bif->active_members);
+  if (vec_len (bif->lb_buckets))
+    {
+      vec_validate (ptd->lb_buckets, BOND_LB_N_BUCKETS - 1);
+      vec_copy (ptd->lb_buckets, bif->lb_buckets);
+    }
   n_numa_members = bif->n_numa_members;
   clib_spinlock_unlock_if_init (&bif->lockp);
 
@@ -539,17 +566,21 @@ VNET_DEVICE_CLASS_TX_FN (bond_dev_class) (vlib_main_t * vm,
   if (bif->n_numa_members >= 1)
     n_members = n_numa_members;
 
-  if (bif->lb == BOND_LB_RR)
-    bond_tx_no_hash (vm, bif, bufs, hashes, n_left, n_members, BOND_LB_RR);
-  else
-    bond_tx_hash (vm, ptd, bif, bufs, hashes, n_left);
-
-  /* calculate port out of hash */
   h = hashes;
-  if (BOND_MODULO_SHORTCUT (n_members))
-    bond_hash_to_port (h, frame->n_vectors, n_members, 1);
+  if (bif->lb == BOND_LB_RR)
+    {
+      bond_tx_no_hash (vm, bif, bufs, hashes, n_left, n_members, BOND_LB_RR);
+      if (BOND_MODULO_SHORTCUT (n_members))
+	bond_hash_to_port (h, frame->n_vectors, n_members, 1);
+      else
+	bond_hash_to_port (h, frame->n_vectors, n_members, 0);
+    }
   else
-    bond_hash_to_port (h, frame->n_vectors, n_members, 0);
+    {
+      bond_tx_hash (vm, ptd, bif, bufs, hashes, n_left);
+      /* calculate port out of hash through the bucket table */
+      bond_hash_to_bucket (h, ptd->lb_buckets, frame->n_vectors);
+    }
 
   bond_tx_trace (vm, node, ptd, bufs, frame->n_vectors, h);
 
@@ -35,6 +35,9 @@
 #define BOND_MODULO_SHORTCUT(a) \
   (is_pow2 (a))
 
+/* hash buckets of the l2/l34/l23 load-balance indirection table */
+#define BOND_LB_N_BUCKETS 256
+
 #define foreach_bond_mode	    \
   _ (1, ROUND_ROBIN, "round-robin") \
   _ (2, ACTIVE_BACKUP, "active-backup") \
@@ -166,6 +169,7 @@ typedef struct
   bond_per_port_queue_t *per_port_queue;
   void **data;
   u32 *active_members;
+  u16 *lb_buckets;
 } bond_per_thread_data_t;
 
 typedef struct
@@ -192,6 +196,14 @@ typedef struct
   /* Members that are in DISTRIBUTING state */
   u32 *active_members;
 
+  /*
+   * Hash bucket -> index in active_members, for the hashing lb algos.
+   * lb_bucket_members holds the sw_if_index each bucket was assigned to,
+   * so a member set change only moves the buckets it has to.
+   */
+  u16 *lb_buckets;
+  u32 *lb_bucket_members;
+
   lacp_port_info_t partner;
   lacp_port_info_t actor;
   u8 individual_aggregator;
@@ -65,15 +65,15 @@
   _ (16, IS_DVR, "dvr", 1)                                                    \
   _ (17, QOS_DATA_VALID, "qos-data-valid", 0)                                 \
   _ (18, GSO, "gso", 0)                                                       \
-  _ (19, AVAIL1, "avail1", 1)                                                 \
-  _ (20, AVAIL2, "avail2", 1)                                                 \
-  _ (21, AVAIL3, "avail3", 1)                                                 \
-  _ (22, AVAIL4, "avail4", 1)                                                 \
-  _ (23, AVAIL5, "avail5", 1)                                                 \
-  _ (24, AVAIL6, "avail6", 1)                                                 \
-  _ (25, AVAIL7, "avail7", 1)                                                 \
-  _ (26, AVAIL8, "avail8", 1)                                                 \
-  _ (27, AVAIL9, "avail9", 1)
+  _ (19, IPSEC_INLINE_DONE, "ipsec-inline-done", 1)                          \
+  _ (20, AVAIL1, "avail1", 1)                                                 \
+  _ (21, AVAIL2, "avail2", 1)                                                 \
+  _ (22, AVAIL3, "avail3", 1)                                                 \
+  _ (23, AVAIL4, "avail4", 1)                                                 \
+  _ (24, AVAIL5, "avail5", 1)                                                 \
+  _ (25, AVAIL6, "avail6", 1)                                                 \
+  _ (26, AVAIL7, "avail7", 1)                                                 \
+  _ (27, AVAIL8, "avail8", 1)
 
 /*
  * Please allocate the FIRST available bit, redefine
@@ -84,7 +84,7 @@
 #define VNET_BUFFER_FLAGS_ALL_AVAIL                                           \
   (VNET_BUFFER_F_AVAIL1 | VNET_BUFFER_F_AVAIL2 | VNET_BUFFER_F_AVAIL3 |       \
    VNET_BUFFER_F_AVAIL4 | VNET_BUFFER_F_AVAIL5 | VNET_BUFFER_F_AVAIL6 |       \
-   VNET_BUFFER_F_AVAIL7 | VNET_BUFFER_F_AVAIL8 | VNET_BUFFER_F_AVAIL9)
+   VNET_BUFFER_F_AVAIL7 | VNET_BUFFER_F_AVAIL8)
 
 #define VNET_BUFFER_FLAGS_VLAN_BITS \
   (VNET_BUFFER_F_VLAN_1_DEEP | VNET_BUFFER_F_VLAN_2_DEEP)
@@ -114,7 +114,8 @@ STATIC_ASSERT (((VNET_BUFFER_FLAGS_ALL_AVAIL & VLIB_BUFFER_FLAGS_ALL) == 0),
   _ (3, OUTER_IP_CKSUM, "offload-outer-ip-cksum", 1)                          \
   _ (4, OUTER_UDP_CKSUM, "offload-outer-udp-cksum", 1)                        \
   _ (5, TNL_VXLAN, "offload-vxlan-tunnel", 1)                                 \
-  _ (6, TNL_IPIP, "offload-ipip-tunnel", 1)
+  _ (6, TNL_IPIP, "offload-ipip-tunnel", 1)                                   \
+  _ (7, IPSEC_ENCRYPT, "offload-ipsec-encrypt", 1)
 
 typedef enum
 {
@@ -511,14 +512,15 @@ typedef struct
   u32 unused[5];
 } vnet_buffer_opaque2_t;
 
-#define vnet_buffer2(b) ((vnet_buffer_opaque2_t *) (b)->opaque2)
+#define vnet_buffer2(b)                                                       \
+  ((vnet_buffer_opaque2_t *) vlib_get_buffer_opaque2 (b))
 
 /*
- * The opaque2 field of the vlib_buffer_t is interpreted as a
+ * The opaque2 field of the buffer's cold metadata is interpreted as a
  * vnet_buffer_opaque2_t. Hence it should be big enough to accommodate one.
  */
 STATIC_ASSERT (sizeof (vnet_buffer_opaque2_t) ==
-		 STRUCT_SIZE_OF (vlib_buffer_t, opaque2),
+		 STRUCT_SIZE_OF (vlib_buffer_cold_t, opaque2),
 	       "VNET buffer opaque2 meta-data too large for vlib_buffer");
 
 #define gso_mtu_sz(b) (vnet_buffer2(b)->gso_size + \
@@ -69,6 +69,10 @@ ip_classify_inline (vlib_main_t * vm,
   u32 misses = 0;
   u32 chain_hits = 0;
   u32 n_next;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  u32 table_indices[VLIB_FRAME_SIZE], hashes[VLIB_FRAME_SIZE];
+  u8 *h[VLIB_FRAME_SIZE];
+  u32 i;
 
   if (is_ip4)
     {
@@ -84,91 +88,33 @@ ip_classify_inline (vlib_main_t * vm,
 
   /* First pass: compute hashes */
 
-  while (n_left_from > 2)
-    {
-      vlib_buffer_t *b0, *b1;
-      u32 bi0, bi1;
-      u8 *h0, *h1;
-      u32 cd_index0, cd_index1;
-      classify_dpo_t *cd0, *cd1;
-      u32 table_index0, table_index1;
-      vnet_classify_table_t *t0, *t1;
-
-      /* prefetch next iteration */
-      {
-	vlib_buffer_t *p1, *p2;
-
-	p1 = vlib_get_buffer (vm, from[1]);
-	p2 = vlib_get_buffer (vm, from[2]);
-
-	vlib_prefetch_buffer_header (p1, STORE);
-	clib_prefetch_store (p1->data);
-	vlib_prefetch_buffer_header (p2, STORE);
-	clib_prefetch_store (p2->data);
-      }
-
-      bi0 = from[0];
-      b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0) - ethernet_buffer_header_size (b0);
-
-      bi1 = from[1];
-      b1 = vlib_get_buffer (vm, bi1);
-      h1 = vlib_buffer_get_current (b1) - ethernet_buffer_header_size (b1);
-
-      cd_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
-      cd0 = classify_dpo_get (cd_index0);
-      table_index0 = cd0->cd_table_index;
-
-      cd_index1 = vnet_buffer (b1)->ip.adj_index[VLIB_TX];
-      cd1 = classify_dpo_get (cd_index1);
-      table_index1 = cd1->cd_table_index;
-
-      t0 = pool_elt_at_index (vcm->tables, table_index0);
-
-      t1 = pool_elt_at_index (vcm->tables, table_index1);
-
-      vnet_buffer (b0)->l2_classify.hash = vnet_classify_hash_packet (t0, h0);
-
-      vnet_classify_prefetch_bucket (t0, vnet_buffer (b0)->l2_classify.hash);
+  vlib_get_buffers (vm, from, bufs, n_left_from);
 
-      vnet_buffer (b1)->l2_classify.hash = vnet_classify_hash_packet (t1, h1);
-
-      vnet_classify_prefetch_bucket (t1, vnet_buffer (b1)->l2_classify.hash);
-
-      vnet_buffer (b0)->l2_classify.table_index = table_index0;
-
-      vnet_buffer (b1)->l2_classify.table_index = table_index1;
-
-      from += 2;
-      n_left_from -= 2;
-    }
-
-  while (n_left_from > 0)
+  for (i = 0; i < n_left_from; i++)
     {
-      vlib_buffer_t *b0;
-      u32 bi0;
-      u8 *h0;
-      u32 cd_index0;
+      vlib_buffer_t *b0 = bufs[i];
       classify_dpo_t *cd0;
-      u32 table_index0;
-      vnet_classify_table_t *t0;
 
-      bi0 = from[0];
-      b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0) - ethernet_buffer_header_size (b0);
+      /* prefetch next iteration */
+      if (i + 2 < n_left_from)
+	{
+	  vlib_prefetch_buffer_header (bufs[i + 2], STORE);
+	  clib_prefetch_store (bufs[i + 2]->data);
+	}
 
-      cd_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
-      cd0 = classify_dpo_get (cd_index0);
-      table_index0 = cd0->cd_table_index;
+      h[i] = vlib_buffer_get_current (b0) - ethernet_buffer_header_size (b0);
 
-      t0 = pool_elt_at_index (vcm->tables, table_index0);
-      vnet_buffer (b0)->l2_classify.hash = vnet_classify_hash_packet (t0, h0);
+      cd0 = classify_dpo_get (vnet_buffer (b0)->ip.adj_index[VLIB_TX]);
+      table_indices[i] = cd0->cd_table_index;
+    }
 
-      vnet_buffer (b0)->l2_classify.table_index = table_index0;
-      vnet_classify_prefetch_bucket (t0, vnet_buffer (b0)->l2_classify.hash);
+  vnet_classify_hash_packets_inline (vcm, table_indices, h, hashes,
+				     n_left_from);
 
-      from++;
-      n_left_from--;
+  for (i = 0; i < n_left_from; i++)
+    {
+      vnet_buffer (bufs[i])->l2_classify.hash = hashes[i];
+      vnet_buffer (bufs[i])->l2_classify.table_index = table_indices[i];
     }
 
   next_index = node->cached_next_index;
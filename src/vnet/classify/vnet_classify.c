@@ -179,6 +179,42 @@ vnet_classify_delete_table_index (vnet_classify_main_t * cm,
   vec_free (t->buckets);
   clib_mem_destroy_heap (t->mheap);
   pool_put (cm->tables, t);
+
+  vnet_classify_compile_chains (cm);
+}
+
+/*
+ * Rebuild the compiled chain of every table. Called whenever a table is
+ * added, deleted or relinked so the data plane never sees a stale chain.
+ */
+void
+vnet_classify_compile_chains (vnet_classify_main_t *cm)
+{
+  vnet_classify_table_t *t;
+  vnet_classify_chain_t *c;
+  u32 next;
+
+  vec_reset_length (cm->chains);
+
+  pool_foreach (t, cm->tables)
+    {
+      vec_validate (cm->chains, t - cm->tables);
+      c = vec_elt_at_index (cm->chains, t - cm->tables);
+      c->n_tables = 0;
+
+      for (next = t->next_table_index;
+	   next != ~0 && !pool_is_free_index (cm->tables, next);
+	   next = pool_elt_at_index (cm->tables, next)->next_table_index)
+	{
+	  /* too long (or looped), leave it to the table by table walk */
+	  if (c->n_tables == VNET_CLASSIFY_CHAIN_MAX_TABLES)
+	    {
+	      c->n_tables = 0;
+	      break;
+	    }
+	  c->table_indices[c->n_tables++] = next;
+	}
+    }
 }
 
 static vnet_classify_entry_t *
@@ -771,6 +807,7 @@ vnet_classify_add_del_table (vnet_classify_main_t *cm, const u8 *mask,
 	  t->current_data_flag = current_data_flag;
 	  t->current_data_offset = current_data_offset;
 	  *table_index = t - cm->tables;
+	  vnet_classify_compile_chains (cm);
 	}
       else			/* update */
 	{
@@ -780,6 +817,7 @@ vnet_classify_add_del_table (vnet_classify_main_t *cm, const u8 *mask,
 
 	  t = pool_elt_at_index (cm->tables, *table_index);
 	  t->next_table_index = next_table_index;
+	  vnet_classify_compile_chains (cm);
 	}
       return 0;
     }
@@ -1728,6 +1766,8 @@ classify_sort_table_chain (vnet_classify_main_t * cm, u32 table_index)
   table_index = tables[0];
   vec_free (tables);
 
+  vnet_classify_compile_chains (cm);
+
   return table_index;
 }
 
@@ -23,6 +23,7 @@
 #include <vppinfra/cache.h>
 #include <vppinfra/crc32.h>
 #include <vppinfra/xxhash.h>
+#include <vppinfra/vector/mask_compare.h>
 
 extern vlib_node_registration_t ip4_classify_node;
 extern vlib_node_registration_t ip6_classify_node;
@@ -219,11 +220,24 @@ STATIC_ASSERT_OFFSET_OF (vnet_classify_table_t, cacheline1,
 #define VNET_CLASSIFY_VECTOR_SIZE                                             \
   sizeof (((vnet_classify_table_t *) 0)->mask[0])
 
+/* Max chain length evaluated as a compiled chain, longer chains are walked */
+#define VNET_CLASSIFY_CHAIN_MAX_TABLES 8
+
+/* Tables following a head table via next_table_index, in chain order */
+typedef struct
+{
+  u32 table_indices[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+  u32 n_tables;
+} vnet_classify_chain_t;
+
 struct _vnet_classify_main
 {
   /* Table pool */
   vnet_classify_table_t *tables;
 
+  /* Compiled chains, indexed by head table index */
+  vnet_classify_chain_t *chains;
+
   /* Registered next-index, opaque unformat fcns */
   unformat_function_t **unformat_l2_next_index_fns;
   unformat_function_t **unformat_ip_next_index_fns;
@@ -362,6 +376,57 @@ vnet_classify_prefetch_bucket (vnet_classify_table_t * t, u64 hash)
   clib_prefetch_load (&t->buckets[bucket_index]);
 }
 
+/**
+ * Hash a batch of packets against their tables and prefetch the buckets.
+ * Packets using the same table, the common case of one table per
+ * interface, are found 64 at a time with clib_mask_compare_u32 and hashed
+ * back to back so the table mask and load mask stay in registers.
+ * Packets with table index ~0 are skipped, their hash is left untouched.
+ */
+static_always_inline void
+vnet_classify_hash_packets_inline (vnet_classify_main_t *cm,
+				   u32 *table_indices, u8 **h, u32 *hash,
+				   u32 n_packets)
+{
+  vnet_classify_table_t *t;
+  u64 todo, bmp;
+  u32 i, n;
+
+  while (n_packets)
+    {
+      n = clib_min (n_packets, 64);
+      todo = n == 64 ? ~0ULL : pow2_mask (n);
+
+      while (todo)
+	{
+	  i = table_indices[count_trailing_zeros (todo)];
+	  if (n == 64)
+	    bmp = clib_mask_compare_u32_x64 (i, table_indices);
+	  else
+	    bmp = clib_mask_compare_u32_x64_n (i, table_indices, n);
+	  bmp &= todo;
+	  todo ^= bmp;
+
+	  if (i == ~0)
+	    continue;
+
+	  t = pool_elt_at_index (cm->tables, i);
+	  while (bmp)
+	    {
+	      i = count_trailing_zeros (bmp);
+	      hash[i] = vnet_classify_hash_packet_inline (t, h[i]);
+	      vnet_classify_prefetch_bucket (t, hash[i]);
+	      bmp = clear_lowest_set_bit (bmp);
+	    }
+	}
+
+      table_indices += n;
+      h += n;
+      hash += n;
+      n_packets -= n;
+    }
+}
+
 static inline vnet_classify_entry_t *
 vnet_classify_get_entry (const vnet_classify_table_t *t, uword offset)
 {
@@ -581,6 +646,45 @@ vnet_classify_find_entry_inline (const vnet_classify_table_t *t, const u8 *h,
   return 0;
 }
 
+/**
+ * Hash the packet against every table which follows @a table_index in its
+ * compiled chain and prefetch all their buckets, then all their entries,
+ * so a miss in the head table walks the rest of the chain in cache.
+ * @a current may be 0 if the caller ignores the current data flag.
+ * Returns the number of hashes stored in @a hash, 0 if not compiled.
+ */
+static_always_inline u32
+vnet_classify_chain_prefetch (vnet_classify_main_t *cm, u32 table_index,
+			      const u8 *data, const u8 *current, u32 *hash)
+{
+  vnet_classify_chain_t *c;
+  vnet_classify_table_t *t;
+  const u8 *h;
+  u32 i;
+
+  if (PREDICT_FALSE (table_index >= vec_len (cm->chains)))
+    return 0;
+
+  c = vec_elt_at_index (cm->chains, table_index);
+
+  for (i = 0; i < c->n_tables; i++)
+    {
+      t = pool_elt_at_index (cm->tables, c->table_indices[i]);
+      if (current && t->current_data_flag == CLASSIFY_FLAG_USE_CURR_DATA)
+	h = current + t->current_data_offset;
+      else
+	h = data;
+      hash[i] = vnet_classify_hash_packet_inline (t, h);
+      vnet_classify_prefetch_bucket (t, hash[i]);
+    }
+
+  for (i = 0; i < c->n_tables; i++)
+    vnet_classify_prefetch_entry (
+      pool_elt_at_index (cm->tables, c->table_indices[i]), hash[i]);
+
+  return c->n_tables;
+}
+
 vnet_classify_table_t *vnet_classify_new_table (vnet_classify_main_t *cm,
 						const u8 *mask, u32 nbuckets,
 						u32 memory_size,
@@ -600,6 +704,7 @@ int vnet_classify_add_del_table (vnet_classify_main_t *cm, const u8 *mask,
 				 int is_add, int del_chain);
 void vnet_classify_delete_table_index (vnet_classify_main_t *cm,
 				       u32 table_index, int del_chain);
+void vnet_classify_compile_chains (vnet_classify_main_t *cm);
 
 unformat_function_t unformat_ip4_mask;
 unformat_function_t unformat_ip6_mask;
@@ -209,6 +209,21 @@ show_crypto_async_status_command_fn (vlib_main_t * vm,
       if (state == VLIB_NODE_STATE_DISABLED)
 	vlib_cli_output (vm, "threadId: %-6d DISABLED", i);
     }
+
+  if (cm->adaptive.enabled)
+    {
+      vlib_cli_output (vm,
+		       "adaptive offload: async-vector-rate %u "
+		       "sync-vector-rate %u clocks-per-packet %u hysteresis %u",
+		       cm->adaptive.async_vector_rate,
+		       cm->adaptive.sync_vector_rate,
+		       cm->adaptive.async_clocks_per_pkt,
+		       cm->adaptive.hysteresis);
+      for (i = 0; i < tm->n_vlib_mains; i++)
+	vlib_cli_output (vm, "threadId: %-6d %U", i,
+			 format_vnet_crypto_adaptive,
+			 &cm->threads[i].adaptive);
+    }
   return 0;
 }
 
@@ -257,3 +272,63 @@ VLIB_CLI_COMMAND (set_crypto_async_dispatch_mode_command, static) = {
   .short_help = "set crypto async dispatch mode <polling|interrupt|adaptive>",
   .function = set_crypto_async_dispatch_command_fn,
 };
+
+static clib_error_t *
+set_crypto_async_adaptive_offload_command_fn (vlib_main_t *vm,
+					      unformat_input_t *input,
+					      vlib_cli_command_t *cmd)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_crypto_adaptive_config_t config = cm->adaptive;
+  clib_error_t *error = 0;
+  u32 tmp;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "on"))
+	config.enabled = 1;
+      else if (unformat (line_input, "off"))
+	config.enabled = 0;
+      else if (unformat (line_input, "async-vector-rate %u", &tmp))
+	config.async_vector_rate = tmp;
+      else if (unformat (line_input, "sync-vector-rate %u", &tmp))
+	config.sync_vector_rate = tmp;
+      else if (unformat (line_input, "clocks-per-packet %u",
+			 &config.async_clocks_per_pkt))
+	;
+      else if (unformat (line_input, "hysteresis %u", &config.hysteresis))
+	;
+      else
+	{
+	  error = clib_error_return (0, "unknown input '%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (config.sync_vector_rate >= config.async_vector_rate ||
+      config.async_vector_rate > VLIB_FRAME_SIZE)
+    {
+      error = clib_error_return (
+	0, "need sync-vector-rate < async-vector-rate <= %u", VLIB_FRAME_SIZE);
+      goto done;
+    }
+
+  vnet_crypto_set_adaptive_offload (&config);
+
+done:
+  unformat_free (line_input);
+  return error;
+}
+
+VLIB_CLI_COMMAND (set_crypto_async_adaptive_offload_command, static) = {
+  .path = "set crypto async adaptive-offload",
+  .short_help = "set crypto async adaptive-offload <on|off> "
+		"[async-vector-rate <n>] [sync-vector-rate <n>] "
+		"[clocks-per-packet <n>] [hysteresis <n>]",
+  .function = set_crypto_async_adaptive_offload_command_fn,
+};
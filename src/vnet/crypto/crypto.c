@@ -562,6 +562,22 @@ vnet_crypto_set_async_dispatch (u8 mode, u8 adaptive)
     }
 }
 
+void
+vnet_crypto_set_adaptive_offload (const vnet_crypto_adaptive_config_t *config)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_thread_t *ct;
+
+  cm->adaptive = *config;
+
+  /* start over in sync mode with the default frame size */
+  vec_foreach (ct, cm->threads)
+    {
+      clib_memset (&ct->adaptive, 0, sizeof (ct->adaptive));
+      ct->adaptive.frame_size = VNET_CRYPTO_FRAME_SIZE;
+    }
+}
+
 static void
 vnet_crypto_load_engines (vlib_main_t *vm)
 {
@@ -715,7 +731,17 @@ vnet_crypto_init (vlib_main_t * vm)
   cm->alg_index_by_name = hash_create_string (0, sizeof (uword));
   vec_validate_aligned (cm->threads, tm->n_vlib_mains, CLIB_CACHE_LINE_BYTES);
   vec_foreach (ct, cm->threads)
-    pool_init_fixed (ct->frame_pool, VNET_CRYPTO_FRAME_POOL_SIZE);
+    {
+      pool_init_fixed (ct->frame_pool, VNET_CRYPTO_FRAME_POOL_SIZE);
+      ct->adaptive.frame_size = VNET_CRYPTO_FRAME_SIZE;
+    }
+
+  cm->adaptive = (vnet_crypto_adaptive_config_t){
+    .async_vector_rate = 64,
+    .sync_vector_rate = 16,
+    .async_clocks_per_pkt = 1000,
+    .hysteresis = 32,
+  };
 
   FOREACH_ARRAY_ELT (e, cm->algs)
     if (e->name)
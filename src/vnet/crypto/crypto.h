@@ -19,6 +19,7 @@
 #include <vlib/vlib.h>
 
 #define VNET_CRYPTO_FRAME_SIZE 64
+#define VNET_CRYPTO_FRAME_SIZE_MIN 16
 #define VNET_CRYPTO_FRAME_POOL_SIZE 1024
 
 /* CRYPTO_ID, PRETTY_NAME, ARGS*/
@@ -323,18 +324,47 @@ typedef struct
   vnet_crypto_async_frame_state_t state;
   vnet_crypto_op_id_t op : 8;
   u16 n_elts;
+  u16 max_elts;
   vnet_crypto_async_frame_elt_t elts[VNET_CRYPTO_FRAME_SIZE];
   u32 buffer_indices[VNET_CRYPTO_FRAME_SIZE];
   u16 next_node_index[VNET_CRYPTO_FRAME_SIZE];
   clib_thread_index_t enqueue_thread_index;
 } vnet_crypto_async_frame_t;
 
+/* per thread state of the adaptive sync/async offload */
+typedef struct
+{
+  /* moving averages of the packets per call and of the cpu clocks a
+   * packet's sync crypto costs */
+  f32 vector_rate;
+  f32 sync_clocks_per_pkt;
+  /* consecutive calls that asked for the other mode */
+  u32 n_switch_votes;
+  u32 n_switches;
+  u16 frame_size;
+  u8 use_async;
+} vnet_crypto_adaptive_t;
+
+typedef struct
+{
+  u8 enabled;
+  /* go async when the vector rate reaches async_vector_rate and sync crypto
+   * costs at least async_clocks_per_pkt, back to sync once the rate drops
+   * to sync_vector_rate */
+  u16 async_vector_rate;
+  u16 sync_vector_rate;
+  u32 async_clocks_per_pkt;
+  /* consecutive calls needed to switch */
+  u32 hysteresis;
+} vnet_crypto_adaptive_config_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   vnet_crypto_async_frame_t *frame_pool;
   u32 *buffer_indices;
   u16 *nexts;
+  vnet_crypto_adaptive_t adaptive;
 } vnet_crypto_thread_t;
 
 typedef u32 vnet_crypto_key_index_t;
@@ -441,6 +471,7 @@ typedef struct
   vnet_crypto_async_next_node_t *next_nodes;
   vnet_crypto_alg_data_t algs[VNET_CRYPTO_N_ALGS];
   vnet_crypto_op_data_t opt_data[VNET_CRYPTO_N_OP_IDS];
+  vnet_crypto_adaptive_config_t adaptive;
   u8 default_disabled;
 } vnet_crypto_main_t;
 
@@ -453,6 +484,8 @@ u32 vnet_crypto_process_ops (vlib_main_t * vm, vnet_crypto_op_t ops[],
 			     u32 n_ops);
 
 void vnet_crypto_set_async_dispatch (u8 mode, u8 adaptive);
+void vnet_crypto_set_adaptive_offload (
+  const vnet_crypto_adaptive_config_t *config);
 
 typedef struct
 {
@@ -487,6 +520,7 @@ format_function_t format_vnet_crypto_engine;
 format_function_t format_vnet_crypto_op;
 format_function_t format_vnet_crypto_op_type;
 format_function_t format_vnet_crypto_op_status;
+format_function_t format_vnet_crypto_adaptive;
 unformat_function_t unformat_vnet_crypto_alg;
 
 static_always_inline void
@@ -534,6 +568,7 @@ vnet_crypto_async_get_frame (vlib_main_t *vm, vnet_crypto_op_id_t opt)
       f->state = VNET_CRYPTO_FRAME_STATE_NOT_PROCESSED;
       f->op = opt;
       f->n_elts = 0;
+      f->max_elts = ct->adaptive.frame_size;
     }
 
   return f;
@@ -600,7 +635,7 @@ vnet_crypto_async_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   vnet_crypto_async_frame_elt_t *fe;
   u16 index;
 
-  ASSERT (f->n_elts < VNET_CRYPTO_FRAME_SIZE);
+  ASSERT (f->n_elts < f->max_elts);
 
   index = f->n_elts;
   fe = &f->elts[index];
@@ -622,21 +657,93 @@ static_always_inline void
 vnet_crypto_async_reset_frame (vnet_crypto_async_frame_t * f)
 {
   vnet_crypto_op_id_t opt;
+  u16 max_elts;
   ASSERT (f != 0);
   ASSERT ((f->state == VNET_CRYPTO_FRAME_STATE_NOT_PROCESSED
 	   || f->state == VNET_CRYPTO_FRAME_STATE_ELT_ERROR));
   opt = f->op;
+  max_elts = f->max_elts;
   if (CLIB_DEBUG > 0)
     clib_memset (f, 0xfe, sizeof (*f));
   f->state = VNET_CRYPTO_FRAME_STATE_NOT_PROCESSED;
   f->op = opt;
   f->n_elts = 0;
+  f->max_elts = max_elts;
 }
 
 static_always_inline u8
 vnet_crypto_async_frame_is_full (const vnet_crypto_async_frame_t *f)
 {
-  return (f->n_elts == VNET_CRYPTO_FRAME_SIZE);
+  return (f->n_elts >= f->max_elts);
+}
+
+static_always_inline int
+vnet_crypto_op_has_async_handler (vnet_crypto_op_id_t opt)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  return cm->opt_data[opt].handlers[VNET_CRYPTO_HANDLER_TYPE_ASYNC] != 0;
+}
+
+/**
+ * Adaptive offload: called once per vector by nodes that can run their
+ * crypto either inline or through async frames, with the number of packets
+ * in the vector. Returns 1 if the vector should go async.
+ */
+static_always_inline int
+vnet_crypto_adaptive_use_async (vlib_main_t *vm, u32 n_pkts)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_adaptive_config_t *cfg = &cm->adaptive;
+  vnet_crypto_adaptive_t *a = &cm->threads[vm->thread_index].adaptive;
+  u32 frame_size;
+  int want_async;
+
+  if (!cfg->enabled)
+    return 0;
+
+  a->vector_rate += ((f32) n_pkts - a->vector_rate) * (1.0f / 16);
+
+  if (a->use_async)
+    want_async = a->vector_rate > cfg->sync_vector_rate;
+  else
+    want_async = a->vector_rate >= cfg->async_vector_rate &&
+		 a->sync_clocks_per_pkt >= cfg->async_clocks_per_pkt;
+
+  if (want_async == a->use_async)
+    a->n_switch_votes = 0;
+  else if (++a->n_switch_votes >= cfg->hysteresis)
+    {
+      a->use_async = want_async;
+      a->n_switch_votes = 0;
+      a->n_switches++;
+    }
+
+  /* split a vector over at least two frames, so engines that hand frames to
+   * other workers can run them in parallel */
+  frame_size = max_pow2 ((u32) a->vector_rate / 2);
+  a->frame_size = clib_min (clib_max (frame_size, VNET_CRYPTO_FRAME_SIZE_MIN),
+			    VNET_CRYPTO_FRAME_SIZE);
+
+  return a->use_async;
+}
+
+/**
+ * Adaptive offload: account the inline crypto of n_pkts packets, started at
+ * cpu time start_clocks.
+ */
+static_always_inline void
+vnet_crypto_adaptive_sync_done (vlib_main_t *vm, u32 n_pkts, u64 start_clocks)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_adaptive_t *a = &cm->threads[vm->thread_index].adaptive;
+  f32 n_clocks;
+
+  if (!cm->adaptive.enabled)
+    return;
+
+  n_clocks = clib_cpu_time_now () - start_clocks;
+  a->sync_clocks_per_pkt +=
+    (n_clocks / n_pkts - a->sync_clocks_per_pkt) * (1.0f / 16);
 }
 
 #endif /* included_vnet_crypto_crypto_h */
@@ -105,6 +105,18 @@ format_vnet_crypto_engine (u8 * s, va_list * args)
   return format (s, "%s", e->name);
 }
 
+u8 *
+format_vnet_crypto_adaptive (u8 *s, va_list *args)
+{
+  vnet_crypto_adaptive_t *a = va_arg (*args, vnet_crypto_adaptive_t *);
+
+  return format (s,
+		 "%s vector-rate %.1f sync-clocks-per-packet %.0f "
+		 "frame-size %u switches %u",
+		 a->use_async ? "async" : "sync", a->vector_rate,
+		 a->sync_clocks_per_pkt, a->frame_size, a->n_switches);
+}
+
 #if 0
 u8 *
 format_vnet_crypto_async_op_type (u8 * s, va_list * args)
@@ -334,3 +334,33 @@ vnet_dev_api_port_del_sec_if (vlib_main_t *vm,
     vm, port, vnet_dev_port_del_sec_if,
     &(vnet_dev_port_del_sec_if_args_t){ .sw_if_index = args->sw_if_index });
 }
+
+vnet_dev_rv_t
+vnet_dev_api_port_ipsec_sa (vlib_main_t *vm,
+			    vnet_dev_api_port_ipsec_sa_args_t *args)
+{
+  vnet_dev_port_t *port;
+  vnet_dev_rv_t rv;
+
+  vnet_dev_port_cfg_change_req_t req = {
+    .type = args->is_add ? VNET_DEV_PORT_CFG_ADD_IPSEC_SA :
+			   VNET_DEV_PORT_CFG_DEL_IPSEC_SA,
+    .sa_index = args->sa_index,
+    .sa_is_inbound = args->is_inbound,
+  };
+
+  port = vnet_dev_get_port_from_sw_if_index (args->sw_if_index);
+  if (port == 0)
+    return VNET_DEV_ERR_UNKNOWN_INTERFACE;
+
+  log_debug (port->dev, "ipsec_sa: sw_if_index %u sa_index %u %s %s",
+	     args->sw_if_index, args->sa_index,
+	     args->is_inbound ? "inbound" : "outbound",
+	     args->is_add ? "add" : "del");
+
+  rv = vnet_dev_port_cfg_change_req_validate (vm, port, &req);
+  if (rv != VNET_DEV_OK)
+    return rv;
+
+  return vnet_dev_process_port_cfg_change_req (vm, port, &req);
+}
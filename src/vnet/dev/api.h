@@ -88,4 +88,16 @@ vnet_dev_rv_t
 vnet_dev_api_port_del_sec_if (vlib_main_t *,
 			      vnet_dev_api_port_del_sec_if_args_t *);
 
+typedef struct
+{
+  u32 sw_if_index;
+  u32 sa_index;
+  u8 is_inbound : 1;
+  u8 is_add : 1;
+} vnet_dev_api_port_ipsec_sa_args_t;
+
+vnet_dev_rv_t
+vnet_dev_api_port_ipsec_sa (vlib_main_t *,
+			    vnet_dev_api_port_ipsec_sa_args_t *);
+
 #endif /* _VNET_DEV_API_H_ */
@@ -123,6 +123,34 @@ vnet_dev_config_one_device (vlib_main_t *vm, unformat_input_t *input,
   return err;
 }
 
+static clib_error_t *
+vnet_dev_config_adaptive_mode (vlib_main_t *vm, unformat_input_t *input)
+{
+  vnet_dev_main_t *dm = &vnet_dev_main;
+  u32 n;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "poll-threshold %u", &n))
+	dm->adaptive_poll_threshold = n;
+      else if (unformat (input, "interrupt-threshold %u", &n))
+	dm->adaptive_intr_threshold = n;
+      else if (unformat (input, "sleep-budget %u", &n))
+	dm->adaptive_sleep_budget = n;
+      else if (unformat (input, "max-interrupt-rate %u", &n))
+	dm->adaptive_max_int_rate = n;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+
+  if (dm->adaptive_intr_threshold >= dm->adaptive_poll_threshold)
+    return clib_error_return (0, "adaptive mode interrupt-threshold must be "
+				 "lower than poll-threshold");
+
+  return 0;
+}
+
 uword
 dev_config_process_node_fn (vlib_main_t *vm, vlib_node_runtime_t *rt,
 			    vlib_frame_t *f)
@@ -156,6 +184,12 @@ dev_config_process_node_fn (vlib_main_t *vm, vlib_node_runtime_t *rt,
 	  err = vnet_dev_config_one_device (vm, &no_input, device_id);
 	  unformat_free (&no_input);
 	}
+      else if (unformat (&input, "adaptive-mode %U",
+			 unformat_vlib_cli_sub_input, &sub_input))
+	{
+	  err = vnet_dev_config_adaptive_mode (vm, &sub_input);
+	  unformat_free (&sub_input);
+	}
       else
 	err = clib_error_return (0, "unknown input '%U'",
 				 format_unformat_error, &input);
@@ -13,7 +13,13 @@ VLIB_REGISTER_LOG_CLASS (dev_log, static) = {
   .class_name = "dev",
 };
 
-vnet_dev_main_t vnet_dev_main = { .next_rx_queue_thread = 1 };
+vnet_dev_main_t vnet_dev_main = {
+  .next_rx_queue_thread = 1,
+  .adaptive_poll_threshold = 10,
+  .adaptive_intr_threshold = 5,
+  .adaptive_sleep_budget = 1024,
+  .adaptive_max_int_rate = 10000,
+};
 
 vnet_dev_bus_t *
 vnet_dev_find_device_bus (vlib_main_t *vm, vnet_dev_device_id_t id)
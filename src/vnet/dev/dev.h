@@ -32,12 +32,15 @@ typedef enum
   _ (mac_filter)                                                              \
   _ (secondary_interfaces)
 
-#define foreach_vnet_dev_port_rx_offloads _ (ip4_cksum)
+#define foreach_vnet_dev_port_rx_offloads                                     \
+  _ (ip4_cksum)                                                               \
+  _ (ipsec_decrypt)
 
 #define foreach_vnet_dev_port_tx_offloads                                     \
   _ (ip4_cksum)                                                               \
   _ (tcp_gso)                                                                 \
-  _ (udp_gso)
+  _ (udp_gso)                                                                 \
+  _ (ipsec_encrypt)
 
 typedef union
 {
@@ -156,7 +159,9 @@ typedef struct
   _ (ADD_RX_FLOW)                                                             \
   _ (DEL_RX_FLOW)                                                             \
   _ (GET_RX_FLOW_COUNTER)                                                     \
-  _ (RESET_RX_FLOW_COUNTER)
+  _ (RESET_RX_FLOW_COUNTER)                                                   \
+  _ (ADD_IPSEC_SA)                                                            \
+  _ (DEL_IPSEC_SA)
 
 typedef enum
 {
@@ -171,6 +176,7 @@ typedef struct vnet_dev_port_cfg_change_req
   vnet_dev_port_cfg_type_t type;
   u8 validated : 1;
   u8 all_queues : 1;
+  u8 adaptive : 1;
 
   union
   {
@@ -183,6 +189,11 @@ typedef struct vnet_dev_port_cfg_change_req
       u32 flow_index;
       uword *private_data;
     };
+    struct
+    {
+      u32 sa_index;
+      u8 sa_is_inbound : 1;
+    };
   };
 
 } vnet_dev_port_cfg_change_req_t;
@@ -291,11 +302,17 @@ typedef struct vnet_dev_rx_queue
   u8 enabled : 1;
   u8 started : 1;
   u8 suspended : 1;
+  u8 adaptive_mode : 1;
+  u8 adaptive_polling : 1;
   vnet_dev_rx_queue_rt_req_t runtime_request;
   vnet_dev_counter_main_t *counter_main;
   vnet_dev_rx_queue_t *next_on_thread;
   vnet_dev_queue_id_t queue_id;
+  u16 adaptive_ewma;
+  u16 adaptive_n_idle;
+  f32 adaptive_int_interval;
   vnet_dev_rx_queue_if_rt_data_t **sec_if_rt_data;
+  f64 adaptive_last_wakeup;
   CLIB_CACHE_LINE_ALIGN_MARK (runtime1);
   vnet_dev_rx_queue_if_rt_data_t if_rt_data;
   CLIB_CACHE_LINE_ALIGN_MARK (driver_data);
@@ -509,6 +526,12 @@ typedef struct
   u8 *startup_config;
   u16 next_rx_queue_thread;
   u8 eth_port_rx_feature_arc_index;
+
+  /* per rx queue adaptive mode tunables */
+  u16 adaptive_poll_threshold;
+  u16 adaptive_intr_threshold;
+  u16 adaptive_sleep_budget;
+  u32 adaptive_max_int_rate;
 } vnet_dev_main_t;
 
 extern vnet_dev_main_t vnet_dev_main;
@@ -750,6 +773,8 @@ unformat_function_t unformat_vnet_dev_port_flags;
 typedef struct
 {
   vnet_dev_rx_queue_t *first_rx_queue;
+  u16 n_polling_queues;
+  u16 n_adaptive_polling;
 } vnet_dev_rx_node_runtime_t;
 
 STATIC_ASSERT (sizeof (vnet_dev_rx_node_runtime_t) <=
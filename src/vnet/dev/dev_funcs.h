@@ -387,6 +387,73 @@ foreach_vnet_dev_rx_queue_runtime_helper (vlib_node_runtime_t *node,
 	 foreach_vnet_dev_rx_queue_runtime_helper (node, 0);                  \
        q; (q) = foreach_vnet_dev_rx_queue_runtime_helper (node, q))
 
+/*
+ * Per rx queue adaptive mode. Queue interrupts stay enabled and the rx node
+ * is kept in polling state on its thread while any adaptive queue is busy.
+ * A queue goes to polling once the EWMA of packets per poll or its
+ * interrupt rate crosses the upper threshold, and back to interrupt mode
+ * only after staying below the lower threshold for a whole sleep budget of
+ * consecutive polls. Drivers call this once per queue after each poll.
+ */
+static_always_inline void
+vnet_dev_rx_queue_adaptive_update (vlib_main_t *vm, vlib_node_runtime_t *node,
+				   vnet_dev_rx_queue_t *rxq, u32 n_rx)
+{
+  vnet_dev_main_t *dm = &vnet_dev_main;
+  vnet_dev_rx_node_runtime_t *rtd;
+  i32 ewma;
+
+  if (PREDICT_TRUE (rxq->adaptive_mode == 0))
+    return;
+
+  /* weight 1/8, 4 fractional bits */
+  ewma = rxq->adaptive_ewma;
+  ewma += ((i32) (clib_min (n_rx, 4095) << 4) - ewma) >> 3;
+  rxq->adaptive_ewma = ewma;
+  rtd = vnet_dev_get_rx_node_runtime (node);
+
+  if (rxq->adaptive_polling == 0)
+    {
+      int to_polling = ewma >= (dm->adaptive_poll_threshold << 4);
+
+      if (n_rx && node->state == VLIB_NODE_STATE_INTERRUPT)
+	{
+	  f64 now = vlib_time_now (vm);
+	  f32 interval = now - rxq->adaptive_last_wakeup;
+	  rxq->adaptive_last_wakeup = now;
+	  rxq->adaptive_int_interval +=
+	    (interval - rxq->adaptive_int_interval) / 8;
+	  if (rxq->adaptive_int_interval * dm->adaptive_max_int_rate < 1)
+	    to_polling = 1;
+	}
+
+      if (to_polling)
+	{
+	  rxq->adaptive_polling = 1;
+	  rxq->adaptive_n_idle = 0;
+	  if (rtd->n_adaptive_polling++ == 0 && rtd->n_polling_queues == 0)
+	    vlib_node_set_state (vm, node->node_index,
+				 VLIB_NODE_STATE_POLLING);
+	}
+      return;
+    }
+
+  if (ewma > (dm->adaptive_intr_threshold << 4))
+    {
+      rxq->adaptive_n_idle = 0;
+      return;
+    }
+
+  if (++rxq->adaptive_n_idle < dm->adaptive_sleep_budget)
+    return;
+
+  rxq->adaptive_polling = 0;
+  rxq->adaptive_int_interval = 1;
+  rxq->adaptive_last_wakeup = vlib_time_now (vm);
+  if (--rtd->n_adaptive_polling == 0 && rtd->n_polling_queues == 0)
+    vlib_node_set_state (vm, node->node_index, VLIB_NODE_STATE_INTERRUPT);
+}
+
 static_always_inline void *
 vnet_dev_get_rt_temp_space (vlib_main_t *vm)
 {
@@ -179,7 +179,13 @@ format_vnet_dev_rx_queue_info (u8 *s, va_list *args)
   s = format (s, "\n%UPolling thread is %u, %sabled, %sstarted, %s mode",
 	      format_white_space, indent, rxq->rx_thread_index,
 	      rxq->enabled ? "en" : "dis", rxq->started ? "" : "not-",
-	      rxq->interrupt_mode ? "interrupt" : "polling");
+	      rxq->adaptive_mode  ? "adaptive" :
+	      rxq->interrupt_mode ? "interrupt" :
+				    "polling");
+  if (rxq->adaptive_mode)
+    s = format (s, " (currently %s, %.1f packets per poll)",
+		rxq->adaptive_polling ? "polling" : "interrupt",
+		rxq->adaptive_ewma / 16.0);
   if (rxq->port->rx_queue_ops.format_info)
     s = format (s, "\n%U%U", format_white_space, indent,
 		rxq->port->rx_queue_ops.format_info, a, rxq);
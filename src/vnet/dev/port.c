@@ -356,6 +356,13 @@ vnet_dev_port_cfg_change_req_validate (vlib_main_t *vm, vnet_dev_port_t *port,
 	return VNET_DEV_ERR_NO_SUCH_ENTRY;
       break;
 
+    case VNET_DEV_PORT_CFG_ADD_IPSEC_SA:
+    case VNET_DEV_PORT_CFG_DEL_IPSEC_SA:
+      if (req->sa_is_inbound ? !port->attr.rx_offloads.ipsec_decrypt :
+				     !port->attr.tx_offloads.ipsec_encrypt)
+	return VNET_DEV_ERR_NOT_SUPPORTED;
+      break;
+
     default:
       break;
     }
@@ -428,6 +435,7 @@ vnet_dev_port_cfg_change (vlib_main_t *vm, vnet_dev_port_t *port,
 	  foreach_vnet_dev_port_rx_queue (q, port)
 	    {
 	      q->interrupt_mode = enable;
+	      q->adaptive_mode = enable && req->adaptive;
 	      bmp = clib_bitmap_set (bmp, q->rx_thread_index, 1);
 	    }
 
@@ -444,6 +452,7 @@ vnet_dev_port_cfg_change (vlib_main_t *vm, vnet_dev_port_t *port,
       else
 	{
 	  rxq->interrupt_mode = enable;
+	  rxq->adaptive_mode = enable && req->adaptive;
 	  vnet_dev_rt_exec_ops (vm, port->dev,
 				&(vnet_dev_rt_op_t){
 				  .port = port,
@@ -681,6 +690,12 @@ vnet_dev_port_if_create (vlib_main_t *vm, vnet_dev_port_t *port, void *ptr)
       caps |= port->attr.caps.mac_filter ? VNET_HW_IF_CAP_MAC_FILTER : 0;
       caps |= port->attr.tx_offloads.tcp_gso ? VNET_HW_IF_CAP_TCP_GSO : 0;
       caps |= port->attr.tx_offloads.ip4_cksum ? VNET_HW_IF_CAP_TX_CKSUM : 0;
+      caps |= port->attr.rx_offloads.ipsec_decrypt ?
+		VNET_HW_IF_CAP_RX_IPSEC_INLINE :
+		0;
+      caps |= port->attr.tx_offloads.ipsec_encrypt ?
+		VNET_HW_IF_CAP_TX_IPSEC_INLINE :
+		0;
 
       if (caps)
 	vnet_hw_if_set_caps (vnm, hw_if_index, caps);
@@ -912,6 +927,12 @@ vnet_dev_port_add_sec_if (vlib_main_t *vm, vnet_dev_port_t *port, void *ptr)
       caps |= port->attr.caps.mac_filter ? VNET_HW_IF_CAP_MAC_FILTER : 0;
       caps |= port->attr.tx_offloads.tcp_gso ? VNET_HW_IF_CAP_TCP_GSO : 0;
       caps |= port->attr.tx_offloads.ip4_cksum ? VNET_HW_IF_CAP_TX_CKSUM : 0;
+      caps |= port->attr.rx_offloads.ipsec_decrypt ?
+		VNET_HW_IF_CAP_RX_IPSEC_INLINE :
+		0;
+      caps |= port->attr.tx_offloads.ipsec_encrypt ?
+		VNET_HW_IF_CAP_TX_IPSEC_INLINE :
+		0;
 
       if (caps)
 	vnet_hw_if_set_caps (vnm, sif->hw_if_index, caps);
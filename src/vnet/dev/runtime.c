@@ -24,6 +24,7 @@ _vnet_dev_rt_exec_op (vlib_main_t *vm, vnet_dev_rt_op_t *op)
   vnet_dev_rx_node_runtime_t *rtd;
   vlib_node_state_t state = VLIB_NODE_STATE_DISABLED;
   u32 node_index = vnet_dev_get_port_rx_node_index (port);
+  u16 n_polling_queues = 0;
 
   rtd = vlib_node_get_runtime_data (vm, node_index);
 
@@ -33,10 +34,20 @@ _vnet_dev_rt_exec_op (vlib_main_t *vm, vnet_dev_rt_op_t *op)
 	continue;
 
       if (q->interrupt_mode == 0)
-	state = VLIB_NODE_STATE_POLLING;
+	{
+	  state = VLIB_NODE_STATE_POLLING;
+	  n_polling_queues++;
+	}
       else if (state != VLIB_NODE_STATE_POLLING)
 	state = VLIB_NODE_STATE_INTERRUPT;
 
+      /* adaptive queues start over in interrupt mode */
+      q->adaptive_polling = 0;
+      q->adaptive_ewma = 0;
+      q->adaptive_n_idle = 0;
+      q->adaptive_int_interval = 1;
+      q->adaptive_last_wakeup = 0;
+
       q->next_on_thread = 0;
       if (previous == 0)
 	first = q;
@@ -47,6 +58,8 @@ _vnet_dev_rt_exec_op (vlib_main_t *vm, vnet_dev_rt_op_t *op)
     }
 
   rtd->first_rx_queue = first;
+  rtd->n_polling_queues = n_polling_queues;
+  rtd->n_adaptive_polling = 0;
   vlib_node_set_state (vm, node_index, state);
   __atomic_store_n (&op->completed, 1, __ATOMIC_RELEASE);
 }
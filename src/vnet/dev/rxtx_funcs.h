@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef _VNET_DEV_RXTX_FUNCS_H_
+#define _VNET_DEV_RXTX_FUNCS_H_
+
+#include <vlib/vlib.h>
+#include <vnet/dev/dev.h>
+
+/*
+ * Descriptor independent helpers shared by vnet_dev driver RX and TX nodes.
+ * They are all inline and pick their SIMD path at compile time, so they end
+ * up in whichever march variant of the driver node calls them.
+ */
+
+/* Store 64-byte buffer template into buffer metadata */
+static_always_inline void
+vnet_dev_buffer_template_store (vlib_buffer_t *b, vlib_buffer_template_t *bt)
+{
+#if defined(CLIB_HAVE_VEC512)
+  u8x64_store_unaligned (u8x64_load_unaligned (bt), &b->template);
+#elif defined(CLIB_HAVE_VEC256)
+  u8x32_store_unaligned (u8x32_load_unaligned (bt), &b->template);
+  u8x32_store_unaligned (u8x32_load_unaligned ((u8 *) bt + 32),
+			 (u8 *) &b->template + 32);
+#else
+  b->template = *bt;
+#endif
+}
+
+/* Translate array of buffer indices into DMA addresses of the start of
+ * buffer data, offset by 'offset' bytes. If 'use_va_dma' is set, device
+ * uses virtual addresses and translation is done in vector registers,
+ * otherwise physical address is looked up for each buffer. */
+static_always_inline void
+vnet_dev_buffer_indices_to_dma_addr (vlib_main_t *vm, u32 *bi, u64 *addr,
+				     u32 n_buffers, i32 offset,
+				     int use_va_dma)
+{
+  vlib_buffer_t *b[4];
+
+  if (use_va_dma)
+    {
+      STATIC_ASSERT (sizeof (void *) == sizeof (u64), "64-bit only");
+      vlib_get_buffers_with_offset (vm, bi, (void **) addr, n_buffers,
+				    sizeof (vlib_buffer_t) + offset);
+      return;
+    }
+
+  while (n_buffers >= 4)
+    {
+      vlib_get_buffers (vm, bi, b, 4);
+      addr[0] = vlib_buffer_get_pa (vm, b[0]) + offset;
+      addr[1] = vlib_buffer_get_pa (vm, b[1]) + offset;
+      addr[2] = vlib_buffer_get_pa (vm, b[2]) + offset;
+      addr[3] = vlib_buffer_get_pa (vm, b[3]) + offset;
+
+      /* next */
+      addr += 4;
+      bi += 4;
+      n_buffers -= 4;
+    }
+
+  while (n_buffers)
+    {
+      b[0] = vlib_get_buffer (vm, bi[0]);
+      addr[0] = vlib_buffer_get_pa (vm, b[0]) + offset;
+
+      /* next */
+      addr += 1;
+      bi += 1;
+      n_buffers -= 1;
+    }
+}
+
+/* Initialize received buffers from template and set their current_length
+ * from array of lengths extracted from descriptors. Returns total number
+ * of bytes. */
+static_always_inline uword
+vnet_dev_rx_buffers_init (vlib_buffer_t **b, vlib_buffer_template_t *bt,
+			  u16 *len, u32 n_buffers)
+{
+  uword n_bytes = 0;
+
+  while (n_buffers >= 4)
+    {
+      if (n_buffers >= 12)
+	{
+	  vlib_prefetch_buffer_header (b[8], STORE);
+	  vlib_prefetch_buffer_header (b[9], STORE);
+	  vlib_prefetch_buffer_header (b[10], STORE);
+	  vlib_prefetch_buffer_header (b[11], STORE);
+	}
+
+      vnet_dev_buffer_template_store (b[0], bt);
+      vnet_dev_buffer_template_store (b[1], bt);
+      vnet_dev_buffer_template_store (b[2], bt);
+      vnet_dev_buffer_template_store (b[3], bt);
+
+      n_bytes += b[0]->current_length = len[0];
+      n_bytes += b[1]->current_length = len[1];
+      n_bytes += b[2]->current_length = len[2];
+      n_bytes += b[3]->current_length = len[3];
+
+      /* next */
+      b += 4;
+      len += 4;
+      n_buffers -= 4;
+    }
+
+  while (n_buffers)
+    {
+      vnet_dev_buffer_template_store (b[0], bt);
+      n_bytes += b[0]->current_length = len[0];
+
+      /* next */
+      b += 1;
+      len += 1;
+      n_buffers -= 1;
+    }
+
+  return n_bytes;
+}
+
+/* Collect DMA address of current data and length of each buffer, ready to
+ * be written into TX descriptors in a single pass. */
+static_always_inline void
+vnet_dev_tx_buffers_get_dma_addr_and_len (vlib_main_t *vm, vlib_buffer_t **b,
+					  u64 *addr, u16 *len, u32 n_buffers,
+					  int use_va_dma)
+{
+  while (n_buffers >= 4)
+    {
+      if (use_va_dma)
+	{
+	  addr[0] = pointer_to_uword (vlib_buffer_get_current (b[0]));
+	  addr[1] = pointer_to_uword (vlib_buffer_get_current (b[1]));
+	  addr[2] = pointer_to_uword (vlib_buffer_get_current (b[2]));
+	  addr[3] = pointer_to_uword (vlib_buffer_get_current (b[3]));
+	}
+      else
+	{
+	  addr[0] = vlib_buffer_get_current_pa (vm, b[0]);
+	  addr[1] = vlib_buffer_get_current_pa (vm, b[1]);
+	  addr[2] = vlib_buffer_get_current_pa (vm, b[2]);
+	  addr[3] = vlib_buffer_get_current_pa (vm, b[3]);
+	}
+
+      len[0] = b[0]->current_length;
+      len[1] = b[1]->current_length;
+      len[2] = b[2]->current_length;
+      len[3] = b[3]->current_length;
+
+      /* next */
+      b += 4;
+      addr += 4;
+      len += 4;
+      n_buffers -= 4;
+    }
+
+  while (n_buffers)
+    {
+      if (use_va_dma)
+	addr[0] = pointer_to_uword (vlib_buffer_get_current (b[0]));
+      else
+	addr[0] = vlib_buffer_get_current_pa (vm, b[0]);
+      len[0] = b[0]->current_length;
+
+      /* next */
+      b += 1;
+      addr += 1;
+      len += 1;
+      n_buffers -= 1;
+    }
+}
+
+#endif /* _VNET_DEV_RXTX_FUNCS_H_ */
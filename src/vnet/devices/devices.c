@@ -111,7 +111,6 @@ vnet_device_init (vlib_main_t * vm)
   if (tr && tr->count > 0)
     {
       vdm->first_worker_thread_index = tr->first_index;
-      vdm->next_worker_thread_index = tr->first_index;
       vdm->last_worker_thread_index = tr->first_index + tr->count - 1;
     }
 
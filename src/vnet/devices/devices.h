@@ -62,7 +62,6 @@ typedef struct
   vnet_device_per_worker_data_t *workers;
   uword first_worker_thread_index;
   uword last_worker_thread_index;
-  uword next_worker_thread_index;
 } vnet_device_main_t;
 
 extern vnet_device_main_t vnet_device_main;
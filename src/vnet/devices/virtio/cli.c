@@ -58,6 +58,8 @@ virtio_pci_create_command_fn (vlib_main_t * vm, unformat_input_t * input,
 	}
       else if (unformat (line_input, "packed"))
 	args.virtio_flags |= VIRTIO_FLAG_PACKED;
+      else if (unformat (line_input, "in-order"))
+	args.virtio_flags |= VIRTIO_FLAG_IN_ORDER;
       else if (unformat (line_input, "bind force"))
 	args.bind = VIRTIO_BIND_FORCE;
       else if (unformat (line_input, "bind"))
@@ -82,7 +84,8 @@ VLIB_CLI_COMMAND (virtio_pci_create_command, static) = {
   .short_help = "create interface virtio <pci-address> "
 		"[feature-mask <hex-mask>] [tx-queue-size <size>] "
 		"[gso-enabled] [csum-enabled] [rss-enabled] "
-		"[buffering [size <buffering-szie>]] [packed] [bind [force]]",
+		"[buffering [size <buffering-szie>]] [packed] [in-order] "
+		"[bind [force]]",
   .function = virtio_pci_create_command_fn,
 };
 
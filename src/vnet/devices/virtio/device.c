@@ -293,12 +293,50 @@ virtio_free_used_device_desc_packed (vlib_main_t *vm,
     }
 }
 
+/*
+ * With VIRTIO_F_IN_ORDER the device may write only the used element of the
+ * last buffer of a batch, so look at that one only: everything from the
+ * oldest descriptor in use up to the end of its chain has been consumed.
+ */
+static void
+virtio_free_used_device_desc_split_in_order (vlib_main_t *vm,
+					     vnet_virtio_vring_t *vring,
+					     uword node_index)
+{
+  u16 sz = vring->queue_size;
+  u16 mask = sz - 1;
+  u16 last = vring->last_used_idx;
+  u16 n_left = vring->used->idx - last;
+  u16 start, end, n_buffers;
+  vnet_virtio_vring_desc_t *d;
+
+  if (n_left == 0)
+    return;
+
+  start = (vring->desc_next - vring->desc_in_use) & mask;
+  end = vring->used->ring[(last + n_left - 1) & mask].id;
+  d = &vring->desc[end];
+  while (d->flags & VRING_DESC_F_NEXT)
+    {
+      end = (end + 1) & mask;
+      d = &vring->desc[end];
+    }
+  n_buffers = ((end - start) & mask) + 1;
+
+  vlib_buffer_free_from_ring (vm, vring->buffers, start, sz, n_buffers);
+  virtio_memset_ring_u32 (vring->buffers, start, sz, n_buffers);
+  vring->desc_in_use -= n_buffers;
+  vring->last_used_idx = last + n_left;
+}
+
 static void
 virtio_free_used_device_desc (vlib_main_t *vm, vnet_virtio_vring_t *vring,
-			      uword node_index, int packed)
+			      uword node_index, int packed, int in_order)
 {
   if (packed)
     virtio_free_used_device_desc_packed (vm, vring, node_index);
+  else if (in_order)
+    virtio_free_used_device_desc_split_in_order (vm, vring, node_index);
   else
     virtio_free_used_device_desc_split (vm, vring, node_index);
 
@@ -892,7 +930,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
 				      vnet_virtio_vring_t *vring, u32 *buffers,
 				      u16 n_left, int do_gso, int csum_offload)
 {
-  u16 used, next, avail, n_buffers = 0, n_buffers_left = 0;
+  u16 used, next, avail, old_avail, n_buffers = 0, n_buffers_left = 0;
   int is_pci = (type == VIRTIO_IF_TYPE_PCI);
   int is_tun = (type == VIRTIO_IF_TYPE_TUN);
   int is_indirect =
@@ -906,7 +944,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
 
   used = vring->desc_in_use;
   next = vring->desc_next;
-  avail = vring->avail->idx;
+  avail = old_avail = vring->avail->idx;
 
   u16 free_desc_count = 0;
 
@@ -987,8 +1025,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
       clib_atomic_store_seq_cst (&vring->avail->idx, avail);
       vring->desc_next = next;
       vring->desc_in_use = used;
-      if ((clib_atomic_load_seq_cst (&vring->used->flags) &
-	   VRING_USED_F_NO_NOTIFY) == 0)
+      if (virtio_vring_need_kick (vif, vring, old_avail, avail))
 	virtio_kick (vm, vring, vif);
     }
 
@@ -1069,7 +1106,9 @@ VNET_DEVICE_CLASS_TX_FN (virtio_device_class) (vlib_main_t * vm,
 
 retry:
   /* free consumed buffers */
-  virtio_free_used_device_desc (vm, vring, node->node_index, packed);
+  virtio_free_used_device_desc (
+    vm, vring, node->node_index, packed,
+    (vif->features & VIRTIO_FEATURE (VIRTIO_F_IN_ORDER)) != 0);
 
   if (vif->type == VIRTIO_IF_TYPE_TAP)
     n_left = virtio_interface_tx_inline (vm, node, vif, vring,
@@ -1144,7 +1183,11 @@ virtio_set_rx_interrupt (virtio_if_t *vif, vnet_virtio_vring_t *vring)
   if (vif->is_packed)
     vring->driver_event->flags &= ~VRING_EVENT_F_DISABLE;
   else
-    vring->avail->flags &= ~VRING_AVAIL_F_NO_INTERRUPT;
+    {
+      vring->avail->flags &= ~VRING_AVAIL_F_NO_INTERRUPT;
+      if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+	virtio_vring_set_used_event (vring, vring->last_used_idx);
+    }
 }
 
 static void
@@ -1153,7 +1196,12 @@ virtio_set_rx_polling (virtio_if_t *vif, vnet_virtio_vring_t *vring)
   if (vif->is_packed)
     vring->driver_event->flags |= VRING_EVENT_F_DISABLE;
   else
-    vring->avail->flags |= VRING_AVAIL_F_NO_INTERRUPT;
+    {
+      vring->avail->flags |= VRING_AVAIL_F_NO_INTERRUPT;
+      /* flag is ignored by the device once event index is negotiated */
+      if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+	virtio_vring_set_used_event (vring, vring->last_used_idx - 1);
+    }
 }
 
 static clib_error_t *
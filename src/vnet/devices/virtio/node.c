@@ -186,12 +186,20 @@ virtio_n_left_to_process (vnet_virtio_vring_t *vring, const int packed)
     return vring->used->idx - vring->last_used_idx;
 }
 
+/*
+ * With VIRTIO_F_IN_ORDER the device consumes split ring rx descriptors in
+ * the order they were made available, and refill makes them available in
+ * ring order, so the slot follows from the used index without touching
+ * the used ring element.
+ */
 static_always_inline u16
-virtio_get_slot_id (vnet_virtio_vring_t *vring, const int packed, u16 last,
-		    u16 mask)
+virtio_get_slot_id (vnet_virtio_vring_t *vring, const int packed,
+		    const int in_order, u16 last, u16 mask)
 {
   if (packed)
     return vring->packed_desc[last].id;
+  else if (in_order)
+    return last & mask;
   else
     return vring->used->ring[last & mask].id;
 }
@@ -273,6 +281,8 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 last = vring->last_used_idx;
   u16 n_left = virtio_n_left_to_process (vring, packed);
   vlib_buffer_t bt = {};
+  int in_order =
+    !packed && (vif->features & VIRTIO_FEATURE (VIRTIO_F_IN_ORDER));
 
   if (packed)
     {
@@ -331,7 +341,16 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  u8 l4_proto = 0, l4_hdr_sz = 0;
 	  u16 num_buffers = 1;
 	  vnet_virtio_net_hdr_v1_t *hdr;
-	  u16 slot = virtio_get_slot_id (vring, packed, last, mask);
+	  u16 slot = virtio_get_slot_id (vring, packed, in_order, last, mask);
+
+	  if (!packed && n_left > 4)
+	    {
+	      u16 pslot =
+		virtio_get_slot_id (vring, packed, in_order, last + 4, mask);
+	      vlib_prefetch_buffer_with_index (vm, vring->buffers[pslot],
+					       STORE);
+	    }
+
 	  u16 len = virtio_get_len (vring, packed, hdr_sz, last, mask);
 	  u32 bi0 = vring->buffers[slot];
 	  vlib_buffer_t *b0 = vlib_get_buffer (vm, bi0);
@@ -357,11 +376,13 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    {
 	      vlib_buffer_t *pb, *cb;
 	      pb = b0;
-	      b0->total_length_not_including_first_buffer = 0;
+	      vlib_buffer_cold (b0)->total_length_not_including_first_buffer =
+		0;
 	      while (num_buffers > 1)
 		{
 		  increment_last (last, packed, vring);
-		  u16 cslot = virtio_get_slot_id (vring, packed, last, mask);
+		  u16 cslot =
+		    virtio_get_slot_id (vring, packed, in_order, last, mask);
 		  /* hdr size is 0 after 1st packet in chain buffers */
 		  u16 clen = virtio_get_len (vring, packed, 0, last, mask);
 		  u32 cbi = vring->buffers[cslot];
@@ -375,14 +396,16 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 		  pb->flags |= VLIB_BUFFER_NEXT_PRESENT;
 
 		  /* first buffer */
-		  b0->total_length_not_including_first_buffer += clen;
+		  vlib_buffer_cold (b0)
+		    ->total_length_not_including_first_buffer += clen;
 
 		  pb = cb;
 		  vring->desc_in_use--;
 		  num_buffers--;
 		  n_left--;
 		}
-	      len += b0->total_length_not_including_first_buffer;
+	      len +=
+		vlib_buffer_cold (b0)->total_length_not_including_first_buffer;
 	    }
 
 	  if (type == VIRTIO_IF_TYPE_TUN)
@@ -447,6 +470,15 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
     }
   vring->last_used_idx = last;
 
+  /* re-arm the rx interrupt past what has just been consumed */
+  if (!packed && vring->mode != VNET_HW_IF_RX_MODE_POLLING &&
+      (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX)))
+    {
+      virtio_vring_set_used_event (vring, last);
+      if (clib_atomic_load_seq_cst (&vring->used->idx) != last)
+	vnet_hw_if_rx_queue_set_int_pending (vnm, vring->queue_index);
+    }
+
   vring->total_packets += n_rx_packets;
   vlib_increment_combined_counter (vnm->interface_main.combined_sw_if_counters
 				   + VNET_INTERFACE_COUNTER_RX, thread_index,
@@ -981,6 +981,12 @@ virtio_negotiate_features (vlib_main_t * vm, virtio_if_t * vif,
 	(VIRTIO_FEATURE (VIRTIO_F_RING_PACKED) |
 	 VIRTIO_FEATURE (VIRTIO_F_IN_ORDER));
     }
+  else
+    {
+      supported_features |= VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX);
+      if (vif->in_order)
+	supported_features |= VIRTIO_FEATURE (VIRTIO_F_IN_ORDER);
+    }
 
   if (req_features == 0)
     {
@@ -1420,6 +1426,8 @@ virtio_pci_create_if (vlib_main_t * vm, virtio_pci_create_if_args_t * args)
 
   if (args->virtio_flags & VIRTIO_FLAG_CONSISTENT_QP)
     vif->consistent_qp = 1;
+  if (args->virtio_flags & VIRTIO_FLAG_IN_ORDER)
+    vif->in_order = 1;
   if ((error = vlib_pci_device_open (vm, (vlib_pci_addr_t *) &vif->pci_addr,
 				     virtio_pci_device_ids, &h)))
     {
@@ -214,6 +214,7 @@ typedef struct
   const virtio_pci_func_t *virtio_pci_func;
   int is_packed;
   u8 consistent_qp : 1;
+  u8 in_order : 1;
 } virtio_if_t;
 
 typedef struct
@@ -278,6 +279,35 @@ virtio_kick (vlib_main_t *vm, vnet_virtio_vring_t *vring, virtio_if_t *vif)
     }
 }
 
+/*
+ * Decide whether the device must be notified after the driver moved the
+ * avail index from old_idx to new_idx. With VIRTIO_RING_F_EVENT_IDX the
+ * device publishes the avail index it wants to be woken up at, otherwise
+ * it can only suppress notifications altogether with a used ring flag.
+ */
+static_always_inline int
+virtio_vring_need_kick (virtio_if_t *vif, vnet_virtio_vring_t *vring,
+			u16 old_idx, u16 new_idx)
+{
+  if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+    {
+      u16 *avail_event = (u16 *) &vring->used->ring[vring->queue_size];
+      u16 event = clib_atomic_load_seq_cst (avail_event);
+      return (u16) (new_idx - event - 1) < (u16) (new_idx - old_idx);
+    }
+
+  return (clib_atomic_load_seq_cst (&vring->used->flags) &
+	  VRING_USED_F_NO_NOTIFY) == 0;
+}
+
+/* With VIRTIO_RING_F_EVENT_IDX the device interrupts once its used index
+ * moves past the used event index the driver stores in the avail ring. */
+static_always_inline void
+virtio_vring_set_used_event (vnet_virtio_vring_t *vring, u16 idx)
+{
+  clib_atomic_store_seq_cst (&vring->avail->ring[vring->queue_size], idx);
+}
+
 static_always_inline u8
 virtio_txq_is_scheduled (vnet_virtio_vring_t *vring)
 {
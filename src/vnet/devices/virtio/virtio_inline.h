@@ -33,65 +33,68 @@ virtio_refill_vring_split (vlib_main_t *vm, virtio_if_t *vif,
 			   virtio_if_type_t type, vnet_virtio_vring_t *vring,
 			   const int hdr_sz, u32 node_index)
 {
-  u16 used, next, avail, n_slots, n_refill;
+  u16 used, next, avail, old_avail, n_slots, n_refill;
   u16 sz = vring->queue_size;
   u16 mask = sz - 1;
 
-more:
   used = vring->desc_in_use;
+  next = vring->desc_next;
+  avail = old_avail = vring->avail->idx;
+
+  /*
+   * Deliver free buffers in chunks of 64, but publish the avail index and
+   * notify the device only once for the whole refill, as each notification
+   * is a vmexit when running as a guest.
+   */
+  while (sz - used >= sz / 8)
+    {
+      n_refill = clib_min (sz - used, 64);
+      n_slots = vlib_buffer_alloc_to_ring_from_pool (
+	vm, vring->buffers, next, sz, n_refill, vring->buffer_pool_index);
 
-  if (sz - used < sz / 8)
-    return;
-
-  /* deliver free buffers in chunks of 64 */
-  n_refill = clib_min (sz - used, 64);
+      if (PREDICT_FALSE (n_slots != n_refill))
+	{
+	  vlib_error_count (vm, node_index, VIRTIO_INPUT_ERROR_BUFFER_ALLOC,
+			    n_refill - n_slots);
+	  n_refill = 0;
+	}
 
-  next = vring->desc_next;
-  avail = vring->avail->idx;
-  n_slots = vlib_buffer_alloc_to_ring_from_pool (vm, vring->buffers, next,
-						 vring->queue_size, n_refill,
-						 vring->buffer_pool_index);
+      while (n_slots)
+	{
+	  vnet_virtio_vring_desc_t *d = &vring->desc[next];
+	  vlib_buffer_t *b = vlib_get_buffer (vm, vring->buffers[next]);
+	  /*
+	   * current_data may not be initialized with 0 and may contain
+	   * previous offset. Here we want to make sure, it should be 0
+	   * initialized.
+	   */
+	  b->current_data = -hdr_sz;
+	  clib_memset (vlib_buffer_get_current (b), 0, hdr_sz);
+	  d->addr = ((type == VIRTIO_IF_TYPE_PCI) ?
+		       vlib_buffer_get_current_pa (vm, b) :
+		       pointer_to_uword (vlib_buffer_get_current (b)));
+	  d->len = vlib_buffer_get_default_data_size (vm) + hdr_sz;
+	  d->flags = VRING_DESC_F_WRITE;
+	  vring->avail->ring[avail & mask] = next;
+	  avail++;
+	  next = (next + 1) & mask;
+	  n_slots--;
+	  used++;
+	}
 
-  if (PREDICT_FALSE (n_slots != n_refill))
-    {
-      vlib_error_count (vm, node_index, VIRTIO_INPUT_ERROR_BUFFER_ALLOC,
-			n_refill - n_slots);
-      if (n_slots == 0)
-	return;
+      /* buffer pool is running dry, don't keep trying */
+      if (PREDICT_FALSE (n_refill == 0))
+	break;
     }
 
-  while (n_slots)
-    {
-      vnet_virtio_vring_desc_t *d = &vring->desc[next];
-      ;
-      vlib_buffer_t *b = vlib_get_buffer (vm, vring->buffers[next]);
-      /*
-       * current_data may not be initialized with 0 and may contain
-       * previous offset. Here we want to make sure, it should be 0
-       * initialized.
-       */
-      b->current_data = -hdr_sz;
-      clib_memset (vlib_buffer_get_current (b), 0, hdr_sz);
-      d->addr = ((type == VIRTIO_IF_TYPE_PCI) ?
-		   vlib_buffer_get_current_pa (vm, b) :
-		   pointer_to_uword (vlib_buffer_get_current (b)));
-      d->len = vlib_buffer_get_default_data_size (vm) + hdr_sz;
-      d->flags = VRING_DESC_F_WRITE;
-      vring->avail->ring[avail & mask] = next;
-      avail++;
-      next = (next + 1) & mask;
-      n_slots--;
-      used++;
-    }
+  if (avail == old_avail)
+    return;
+
   clib_atomic_store_seq_cst (&vring->avail->idx, avail);
   vring->desc_next = next;
   vring->desc_in_use = used;
-  if ((clib_atomic_load_seq_cst (&vring->used->flags) &
-       VRING_USED_F_NO_NOTIFY) == 0)
-    {
-      virtio_kick (vm, vring, vif);
-    }
-  goto more;
+  if (virtio_vring_need_kick (vif, vring, old_avail, avail))
+    virtio_kick (vm, vring, vif);
 }
 
 static_always_inline void
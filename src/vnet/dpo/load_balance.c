@@ -32,6 +32,12 @@
  */
 const f64 multipath_next_hop_error_tolerance = 0.1;
 
+/*
+ * The number of buckets of a sticky load-balance with more than one path,
+ * 0 if sticky load-balances are not resilient. Set by the startup config.
+ */
+static u32 load_balance_sticky_n_buckets;
+
 static const char *load_balance_attr_names[] = LOAD_BALANCE_ATTR_NAMES;
 
 /**
@@ -620,6 +626,128 @@ load_balance_fill_buckets_sticky (load_balance_t *lb,
     vec_free(fwding_paths);
 }
 
+/*
+ * Resilient update of the buckets of a sticky load-balance, in place.
+ * Each forwarding path owns as many buckets as its normalised weight, the
+ * buckets of the paths that are drop are shared between the others. A
+ * bucket that is already on a forwarding path that has not used its share
+ * is kept, only the others are written. So flows on the paths that did not
+ * change are not moved.
+ */
+static void
+load_balance_fill_buckets_resilient (load_balance_t *lb,
+                                     load_balance_path_t *nhs,
+                                     dpo_id_t *buckets,
+                                     u32 n_buckets)
+{
+    load_balance_path_t *nh, *fwding_paths;
+    u32 *quota, *free_buckets, *bucket;
+    u32 ii, fpath, n_drop, n_fwding;
+
+    fwding_paths = NULL;
+    quota = free_buckets = NULL;
+    n_drop = 0;
+
+    vec_foreach (nh, nhs)
+    {
+        if (!dpo_is_drop(&nh->path_dpo))
+        {
+            vec_add1(fwding_paths, *nh);
+            vec_add1(quota, nh->path_weight);
+        }
+        else
+        {
+            n_drop += nh->path_weight;
+        }
+    }
+    if (vec_len(fwding_paths) == 0)
+    {
+        fwding_paths = vec_dup(nhs);
+        vec_foreach (nh, nhs)
+            vec_add1(quota, nh->path_weight);
+        n_drop = 0;
+    }
+    n_fwding = vec_len(fwding_paths);
+
+    for (fpath = 0; n_drop > 0; n_drop--)
+    {
+        quota[fpath]++;
+        fpath = (fpath + 1) % n_fwding;
+    }
+
+    fpath = 0;
+    for (ii = 0; ii < n_buckets; ii++)
+    {
+        /* runs of buckets on the same path are the common case */
+        if (dpo_cmp(&buckets[ii], &fwding_paths[fpath].path_dpo))
+        {
+            for (fpath = 0; fpath < n_fwding; fpath++)
+                if (!dpo_cmp(&buckets[ii], &fwding_paths[fpath].path_dpo))
+                    break;
+        }
+        if (fpath < n_fwding && quota[fpath] > 0)
+            quota[fpath]--;
+        else
+            vec_add1(free_buckets, ii);
+
+        if (fpath >= n_fwding)
+            fpath = 0;
+    }
+
+    /* the remaining shares add up to the number of free buckets */
+    fpath = 0;
+    vec_foreach (bucket, free_buckets)
+    {
+        while (0 == quota[fpath])
+            fpath++;
+        ASSERT(fpath < n_fwding);
+        quota[fpath]--;
+        load_balance_set_bucket_i(lb, *bucket, buckets,
+                                  &fwding_paths[fpath].path_dpo);
+    }
+
+    vec_free(free_buckets);
+    vec_free(quota);
+    vec_free(fwding_paths);
+}
+
+/*
+ * With sticky-buckets configured, the buckets of a sticky load-balance
+ * are updated in place when the number of buckets does not change. A map
+ * relies on the buckets of a path being contiguous, so with one the
+ * buckets are refilled in order.
+ */
+static inline int
+load_balance_is_resilient (load_balance_flags_t flags)
+{
+    return (load_balance_sticky_n_buckets &&
+            (flags & LOAD_BALANCE_FLAG_STICKY) &&
+            !(flags & LOAD_BALANCE_FLAG_USES_MAP));
+}
+
+/*
+ * Scale the normalised weights of a resilient load-balance up to
+ * load_balance_sticky_n_buckets. Both are powers of 2, so the weights
+ * are scaled exactly.
+ */
+static u32
+load_balance_resilient_n_buckets (load_balance_path_t *nhs,
+                                  u32 n_buckets)
+{
+    load_balance_path_t *nh;
+    u32 scale;
+
+    if (vec_len(nhs) < 2 || n_buckets >= load_balance_sticky_n_buckets)
+        return (n_buckets);
+
+    scale = load_balance_sticky_n_buckets / n_buckets;
+    vec_foreach (nh, nhs)
+    {
+        nh->path_weight *= scale;
+    }
+    return (load_balance_sticky_n_buckets);
+}
+
 static void
 load_balance_fill_buckets (load_balance_t *lb,
                            load_balance_path_t *nhs,
@@ -670,6 +798,8 @@ load_balance_multipath_update (const dpo_id_t *dpo,
                                          &nhs,
                                          &sum_of_weights,
                                          multipath_next_hop_error_tolerance);
+    if (load_balance_is_resilient(flags))
+        n_buckets = load_balance_resilient_n_buckets(nhs, n_buckets);
 
     /*
      * Save the old load-balance map used, and get a new one if required.
@@ -718,9 +848,14 @@ load_balance_multipath_update (const dpo_id_t *dpo,
              * no change in the number of buckets. we can simply fill what
              * is new over what is old.
              */
-            load_balance_fill_buckets(lb, nhs,
-                                      load_balance_get_buckets(lb),
-                                      n_buckets, flags);
+            if (load_balance_is_resilient(flags))
+                load_balance_fill_buckets_resilient(lb, nhs,
+                                                    load_balance_get_buckets(lb),
+                                                    n_buckets);
+            else
+                load_balance_fill_buckets(lb, nhs,
+                                          load_balance_get_buckets(lb),
+                                          n_buckets, flags);
             lb->lb_map = lbmi;
         }
         else if (n_buckets > lb->lb_n_buckets)
@@ -1045,6 +1180,44 @@ load_balance_pool_alloc (uword size)
   pool_alloc_aligned(load_balance_pool, size, CLIB_CACHE_LINE_BYTES);
 }
 
+int
+load_balance_pool_will_expand (uword n_lbs)
+{
+    u32 last = pool_len(load_balance_pool) + n_lbs - 1;
+
+    if (0 == n_lbs)
+        return (0);
+
+    return (pool_free_elts(load_balance_pool) < n_lbs ||
+            vlib_validate_combined_counter_will_expand
+                (&(load_balance_main.lbm_to_counters), last) ||
+            vlib_validate_combined_counter_will_expand
+                (&(load_balance_main.lbm_via_counters), last));
+}
+
+void
+load_balance_pool_reserve (uword n_lbs)
+{
+    uword n_free = pool_free_elts(load_balance_pool);
+    u32 last;
+
+    if (0 == n_lbs)
+        return;
+
+    if (n_free < n_lbs)
+        load_balance_pool_alloc(n_lbs - n_free);
+
+    /*
+     * the pool's free slots may be at the end, so the counters need
+     * to cover them all
+     */
+    last = pool_len(load_balance_pool) + n_lbs - 1;
+    vlib_validate_combined_counter(&(load_balance_main.lbm_to_counters),
+                                   last);
+    vlib_validate_combined_counter(&(load_balance_main.lbm_via_counters),
+                                   last);
+}
+
 static clib_error_t *
 load_balance_show (vlib_main_t * vm,
                    unformat_input_t * input,
@@ -1371,4 +1544,29 @@ VLIB_REGISTER_NODE (bier_load_balance_node) = {
   .sibling_of = "mpls-load-balance",
 };
 
+static clib_error_t *
+load_balance_config (vlib_main_t * vm,
+                     unformat_input_t * input)
+{
+    u32 n_buckets;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+        if (unformat (input, "sticky-buckets %u", &n_buckets))
+        {
+            if (!is_pow2(n_buckets) || n_buckets > LB_MAX_BUCKETS)
+                return clib_error_return(0, "sticky-buckets must be a power "
+                                         "of 2 no larger than %d",
+                                         LB_MAX_BUCKETS);
+            load_balance_sticky_n_buckets = n_buckets;
+        }
+        else
+            return clib_error_return (0, "unknown input '%U'",
+                                      format_unformat_error, input);
+    }
+    return (NULL);
+}
+
+VLIB_CONFIG_FUNCTION (load_balance_config, "load-balance");
+
 // clang-format on
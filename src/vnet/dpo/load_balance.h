@@ -262,4 +262,16 @@ load_balance_get_bucket_i (const load_balance_t *lb,
 extern void load_balance_module_init(void);
 extern void load_balance_pool_alloc (uword size);
 
+/**
+ * Would allocating n_lbs more load-balances expand the pool, or the
+ * counters, and so need the workers to be synced.
+ */
+extern int load_balance_pool_will_expand (uword n_lbs);
+
+/**
+ * Make room for n_lbs more load-balances and their counters. The caller
+ * holds the worker barrier if load_balance_pool_will_expand.
+ */
+extern void load_balance_pool_reserve (uword n_lbs);
+
 #endif
@@ -1044,70 +1044,88 @@ lookup_dpo_mpls_inline (vlib_main_t * vm,
                 fib_index0 = lkd0->lkd_fib_index;
             }
 
-            /* do lookup */
-            lbi0 = mpls_fib_table_forwarding_lookup (fib_index0, hdr0);
-            lb0  = load_balance_get(lbi0);
-            dpo0 = load_balance_get_bucket_i(lb0, 0);
-
-            next0 = dpo0->dpoi_next_node;
-            vnet_buffer(b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
-
-
-            if (MPLS_IS_REPLICATE & lbi0)
-            {
-                next0 = mpls_lookup_to_replicate_edge;
-                vnet_buffer (b0)->ip.adj_index[VLIB_TX] =
-                    (lbi0 & ~MPLS_IS_REPLICATE);
-            }
-            else
+            /*
+             * pop the label stack in this one visit for as long as the
+             * label resolves to another MPLS lookup in a given table,
+             * as the non-EOS labels of an SR-MPLS stack do.
+             */
+            while (1)
             {
-                lb0 = load_balance_get(lbi0);
-                ASSERT (lb0->lb_n_buckets > 0);
-                ASSERT (is_pow2 (lb0->lb_n_buckets));
+                /* do lookup */
+                lbi0 = mpls_fib_table_forwarding_lookup (fib_index0, hdr0);
 
-                if (PREDICT_FALSE(lb0->lb_n_buckets > 1))
+                if (MPLS_IS_REPLICATE & lbi0)
                 {
-                    hash0 = vnet_buffer (b0)->ip.flow_hash =
-                        mpls_compute_flow_hash(hdr0, lb0->lb_hash_config);
-                    dpo0 = load_balance_get_fwd_bucket
-                        (lb0,
-                         (hash0 & (lb0->lb_n_buckets_minus_1)));
+                    next0 = mpls_lookup_to_replicate_edge;
+                    dpo0 = NULL;
+                    vnet_buffer (b0)->ip.adj_index[VLIB_TX] =
+                        (lbi0 & ~MPLS_IS_REPLICATE);
                 }
                 else
                 {
-                    dpo0 = load_balance_get_bucket_i (lb0, 0);
+                    lb0 = load_balance_get(lbi0);
+                    ASSERT (lb0->lb_n_buckets > 0);
+                    ASSERT (is_pow2 (lb0->lb_n_buckets));
+
+                    if (PREDICT_FALSE(lb0->lb_n_buckets > 1))
+                    {
+                        hash0 = vnet_buffer (b0)->ip.flow_hash =
+                            mpls_compute_flow_hash(hdr0, lb0->lb_hash_config);
+                        dpo0 = load_balance_get_fwd_bucket
+                            (lb0,
+                             (hash0 & (lb0->lb_n_buckets_minus_1)));
+                    }
+                    else
+                    {
+                        dpo0 = load_balance_get_bucket_i (lb0, 0);
+                    }
+                    next0 = dpo0->dpoi_next_node;
+
+                    vnet_buffer (b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
+
+                    vlib_increment_combined_counter
+                        (cm, thread_index, lbi0, 1,
+                         vlib_buffer_length_in_chain (vm, b0));
                 }
-                next0 = dpo0->dpoi_next_node;
 
-                vnet_buffer (b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
+                vnet_buffer (b0)->mpls.ttl = ((char*)hdr0)[3];
+                vnet_buffer (b0)->mpls.exp = (((char*)hdr0)[2] & 0xe) >> 1;
+                vnet_buffer (b0)->mpls.first = 1;
+                vlib_buffer_advance(b0, sizeof(*hdr0));
 
-                vlib_increment_combined_counter
-                    (cm, thread_index, lbi0, 1,
-                     vlib_buffer_length_in_chain (vm, b0));
-            }
+                if (!(b0->flags & VNET_BUFFER_F_LOOP_COUNTER_VALID)) {
+                    vnet_buffer2(b0)->loop_counter = 0;
+                    b0->flags |= VNET_BUFFER_F_LOOP_COUNTER_VALID;
+                }
 
-            vnet_buffer (b0)->mpls.ttl = ((char*)hdr0)[3];
-            vnet_buffer (b0)->mpls.exp = (((char*)hdr0)[2] & 0xe) >> 1;
-            vnet_buffer (b0)->mpls.first = 1;
-            vlib_buffer_advance(b0, sizeof(*hdr0));
+                vnet_buffer2(b0)->loop_counter++;
 
-            if (!(b0->flags & VNET_BUFFER_F_LOOP_COUNTER_VALID)) {
-                vnet_buffer2(b0)->loop_counter = 0;
-                b0->flags |= VNET_BUFFER_F_LOOP_COUNTER_VALID;
-            }
+                if (PREDICT_FALSE(vnet_buffer2(b0)->loop_counter > MAX_LUKPS_PER_PACKET))
+                    next0 = MPLS_LOOKUP_NEXT_DROP;
 
-            vnet_buffer2(b0)->loop_counter++;
+                if (PREDICT_FALSE(b0->flags & VLIB_BUFFER_IS_TRACED))
+                {
+                    lookup_trace_t *tr = vlib_add_trace (vm, node,
+                                                         b0, sizeof (*tr));
+                    tr->fib_index = fib_index0;
+                    tr->lbi = lbi0;
+                    tr->hdr = *hdr0;
+                }
 
-            if (PREDICT_FALSE(vnet_buffer2(b0)->loop_counter > MAX_LUKPS_PER_PACKET))
-                next0 = MPLS_LOOKUP_NEXT_DROP;
+                if (MPLS_LOOKUP_NEXT_DROP == next0 ||
+                    NULL == dpo0 ||
+                    DPO_LOOKUP != dpo0->dpoi_type)
+                    break;
 
-	    if (PREDICT_FALSE(b0->flags & VLIB_BUFFER_IS_TRACED))
-            {
-                lookup_trace_t *tr = vlib_add_trace (vm, node,
-                                                     b0, sizeof (*tr));
-                tr->fib_index = fib_index0;
-                tr->lbi = lbi0;
-                tr->hdr = *hdr0;
+                lkd0 = lookup_dpo_get(dpo0->dpoi_index);
+                if (DPO_PROTO_MPLS != lkd0->lkd_proto ||
+                    LOOKUP_INPUT_DST_ADDR != lkd0->lkd_input ||
+                    LOOKUP_TABLE_FROM_CONFIG != lkd0->lkd_table ||
+                    LOOKUP_UNICAST != lkd0->lkd_cast)
+                    break;
+
+                fib_index0 = lkd0->lkd_fib_index;
+                hdr0 = vlib_buffer_get_current (b0);
             }
 
            vlib_validate_buffer_enqueue_x1(vm, node, next_index, to_next,
@@ -36,6 +36,9 @@ typedef struct replicate_main_t_
 
     /* per-cpu vector of cloned packets */
     u32 **clones;
+
+    /* per-cpu vector of the next nodes of the cloned packets */
+    u16 **nexts;
 } replicate_main_t;
 
 extern replicate_main_t replicate_main;
@@ -485,6 +485,10 @@ typedef struct
   u64 n_packets, n_bytes;
 } eth_input_tag_lookup_t;
 
+/* Per-frame cache of tag lookups, indexed by the low bits of the outer
+   VLAN id, so trunks with interleaved VLANs don't miss on every packet */
+#define ETH_INPUT_TAG_CACHE_SIZE 16
+
 static_always_inline void
 eth_input_update_if_counters (vlib_main_t * vm, vnet_main_t * vnm,
 			      eth_input_tag_lookup_t * l)
@@ -501,6 +505,13 @@ eth_input_update_if_counters (vlib_main_t * vm, vnet_main_t * vnm,
      l->n_packets, l->n_bytes);
 }
 
+static_always_inline u32
+eth_input_tag_cache_index (u64 tag)
+{
+  u16 *t = (u16 *) & tag;
+  return clib_net_to_host_u16 (t[0]) & (ETH_INPUT_TAG_CACHE_SIZE - 1);
+}
+
 static_always_inline void
 eth_input_tag_lookup (vlib_main_t * vm, vnet_main_t * vnm,
 		      vlib_node_runtime_t * node, vnet_hw_interface_t * hi,
@@ -510,7 +521,7 @@ eth_input_tag_lookup (vlib_main_t * vm, vnet_main_t * vnm,
 {
   ethernet_main_t *em = &ethernet_main;
 
-  if ((tag ^ l->tag) & l->mask)
+  if (((tag ^ l->tag) & l->mask) || l->n_tags == 0)
     {
       main_intf_t *mif = vec_elt_at_index (em->main_intfs, hi->hw_if_index);
       vlan_intf_t *vif;
@@ -1050,13 +1061,19 @@ eth_input_process_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
       u16 *si = slowpath_indices;
       u32 last_unknown_etype = ~0;
       u32 last_unknown_next = ~0;
-      eth_input_tag_lookup_t dot1ad_lookup, dot1q_lookup = {
-	.mask = -1LL,
-	.tag = tags[si[0]] ^ -1LL,
-	.sw_if_index = ~0
-      };
+      eth_input_tag_lookup_t dot1q_lookup[ETH_INPUT_TAG_CACHE_SIZE];
+      eth_input_tag_lookup_t dot1ad_lookup[ETH_INPUT_TAG_CACHE_SIZE];
+      eth_input_tag_lookup_t *l;
 
-      clib_memcpy_fast (&dot1ad_lookup, &dot1q_lookup, sizeof (dot1q_lookup));
+      for (l = dot1q_lookup; l < dot1q_lookup + ETH_INPUT_TAG_CACHE_SIZE;
+	   l++)
+	{
+	  l->n_tags = 0;
+	  l->sw_if_index = ~0;
+	  l->n_packets = 0;
+	  l->n_bytes = 0;
+	}
+      clib_memcpy_fast (dot1ad_lookup, dot1q_lookup, sizeof (dot1q_lookup));
 
       while (n_left)
 	{
@@ -1066,17 +1083,19 @@ eth_input_process_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  if (etype == et_vlan)
 	    {
 	      vlib_buffer_t *b = vlib_get_buffer (vm, buffer_indices[i]);
+	      l = dot1q_lookup + eth_input_tag_cache_index (tags[i]);
 	      eth_input_tag_lookup (vm, vnm, node, hi, tags[i], nexts + i, b,
-				    &dot1q_lookup, dmacs_bad[i], 0,
-				    main_is_l3, dmac_check);
+				    l, dmacs_bad[i], 0, main_is_l3,
+				    dmac_check);
 
 	    }
 	  else if (etype == et_dot1ad)
 	    {
 	      vlib_buffer_t *b = vlib_get_buffer (vm, buffer_indices[i]);
+	      l = dot1ad_lookup + eth_input_tag_cache_index (tags[i]);
 	      eth_input_tag_lookup (vm, vnm, node, hi, tags[i], nexts + i, b,
-				    &dot1ad_lookup, dmacs_bad[i], 1,
-				    main_is_l3, dmac_check);
+				    l, dmacs_bad[i], 1, main_is_l3,
+				    dmac_check);
 	    }
 	  else
 	    {
@@ -1102,8 +1121,11 @@ eth_input_process_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  si++;
 	}
 
-      eth_input_update_if_counters (vm, vnm, &dot1q_lookup);
-      eth_input_update_if_counters (vm, vnm, &dot1ad_lookup);
+      for (i = 0; i < ETH_INPUT_TAG_CACHE_SIZE; i++)
+	{
+	  eth_input_update_if_counters (vm, vnm, dot1q_lookup + i);
+	  eth_input_update_if_counters (vm, vnm, dot1ad_lookup + i);
+	}
     }
 
   vlib_buffer_enqueue_to_next (vm, node, buffer_indices, nexts, n_packets);
@@ -1202,7 +1224,7 @@ ethernet_input_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  n_left--;
 	  b0 = vlib_get_buffer (vm, bi0);
 	  if (vnet_is_packet_pcaped (pp, b0, ~0))
-	    pcap_add_buffer (&pp->pcap_main, vm, bi0, pp->max_bytes_per_pkt);
+	    vnet_pcap_add_buffer (pp, vm, bi0);
 	}
     }
 }
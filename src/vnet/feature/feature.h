@@ -336,6 +336,44 @@ vnet_feature_next_u16 (u16 * next0, vlib_buffer_t * b0)
   *next0 = next32;
 }
 
+/*
+ * Continue n buffers on their feature arcs, as vnet_feature_next_u16 does
+ * for each of them. Consecutive buffers on the same arc and config index,
+ * i.e. from the same interface, share the next node and the next config
+ * index, so the config string is only read when they change.
+ */
+static_always_inline void
+vnet_feature_next_n (vlib_buffer_t **b, u16 *nexts, u32 n_left)
+{
+  vnet_feature_main_t *fm = &feature_main;
+  u32 last_ci = ~0, next_ci = ~0, next = 0;
+  u8 last_arc = ~0;
+
+  while (n_left > 0)
+    {
+      u32 ci = b[0]->current_config_index;
+      u8 arc = vnet_buffer (b[0])->feature_arc_index;
+
+      if (n_left > 4)
+	vlib_prefetch_buffer_header (b[4], STORE);
+
+      if (PREDICT_FALSE (ci != last_ci || arc != last_arc))
+	{
+	  vnet_feature_config_main_t *cm = &fm->feature_config_mains[arc];
+	  last_ci = next_ci = ci;
+	  last_arc = arc;
+	  vnet_get_config_data (&cm->config_main, &next_ci, &next, 0);
+	}
+
+      b[0]->current_config_index = next_ci;
+      nexts[0] = next;
+
+      b += 1;
+      nexts += 1;
+      n_left -= 1;
+    }
+}
+
 static_always_inline int
 vnet_device_input_have_features (u32 sw_if_index)
 {
@@ -1834,6 +1834,16 @@ fib_entry_pool_size (void)
     return (pool_elts(fib_entry_pool));
 }
 
+fib_node_index_t
+fib_entry_pool_next (fib_node_index_t fib_entry_index)
+{
+    if (!pool_is_free_index(fib_entry_pool, fib_entry_index))
+        return (fib_entry_index);
+    if (fib_entry_index >= pool_len(fib_entry_pool))
+        return (FIB_NODE_INDEX_INVALID);
+    return (pool_next_index(fib_entry_pool, fib_entry_index));
+}
+
 void
 fib_table_assert_empty (const fib_table_t *fib_table)
 {
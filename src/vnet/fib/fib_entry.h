@@ -366,6 +366,13 @@ typedef struct fib_entry_t_ {
 #define FIB_ENTRY_FORMAT_DETAIL  (0x1)
 #define FIB_ENTRY_FORMAT_DETAIL2 (0x2)
 
+/**
+ * Bumped each time any entry's forwarding is installed, updated or
+ * removed. Data-plane caches of forwarding results compare against it
+ * to detect that their results may be stale.
+ */
+extern volatile u32 fib_entry_fwd_generation;
+
 extern u8 *format_fib_entry (u8 * s, va_list * args);
 extern u8 *format_fib_source (u8 * s, va_list * args);
 
@@ -495,4 +502,10 @@ extern fib_entry_t * fib_entry_get(fib_node_index_t fib_entry_index);
  */
 extern u32 fib_entry_pool_size(void);
 
+/*
+ * The first entry at or after the given index, FIB_NODE_INDEX_INVALID
+ * if there is none. For API walks that continue from a cursor.
+ */
+extern fib_node_index_t fib_entry_pool_next(fib_node_index_t fib_entry_index);
+
 #endif
@@ -30,6 +30,8 @@
  */
 static fib_entry_src_vft_t fib_entry_src_bh_vft[FIB_SOURCE_BH_MAX];
 
+volatile u32 fib_entry_fwd_generation;
+
 /**
  * Get the VFT for a given source. This is a combination of the source
  * enum and the interposer flags
@@ -713,6 +715,7 @@ fib_entry_src_action_install (fib_entry_t *fib_entry,
     insert = !dpo_id_is_valid(&fib_entry->fe_lb);
 
     fib_entry_src_mk_lb(fib_entry, source, fct, &fib_entry->fe_lb);
+    fib_entry_fwd_generation++;
 
     ASSERT(dpo_id_is_valid(&fib_entry->fe_lb));
     FIB_ENTRY_DBG(fib_entry, "install: %d", fib_entry->fe_lb);
@@ -757,6 +760,7 @@ fib_entry_src_action_uninstall (fib_entry_t *fib_entry)
 	    &fib_entry->fe_prefix,
 	    &fib_entry->fe_lb);
 
+	fib_entry_fwd_generation++;
 	vlib_worker_wait_one_loop();
 	dpo_reset(&fib_entry->fe_lb);
     }
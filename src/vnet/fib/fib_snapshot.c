@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Snapshot of the API and CLI sourced IP routes to a file, and bulk
+ * restore from it without going through per-route API dispatch.
+ * Interfaces are recorded by name and tables by table-id, since
+ * neither sw_if_index nor fib_index is stable across restarts.
+ */
+
+#include <vppinfra/serialize.h>
+#include <vnet/vnet.h>
+#include <vnet/fib/fib_table.h>
+#include <vnet/fib/fib_entry.h>
+#include <vnet/fib/ip4_fib.h>
+#include <vnet/fib/ip6_fib.h>
+
+#define FIB_SNAPSHOT_MAGIC "vpp-fib-snapshot-1"
+
+/**
+ * Paths using these flags reference objects, other than tables and
+ * interfaces, whose indices are not meaningful after a restart.
+ */
+#define FIB_SNAPSHOT_UNSUPPORTED_PATH_FLAGS     \
+    (FIB_ROUTE_PATH_INTF_RX |                   \
+     FIB_ROUTE_PATH_RPF_ID |                    \
+     FIB_ROUTE_PATH_UDP_ENCAP |                 \
+     FIB_ROUTE_PATH_BIER_FMASK |                \
+     FIB_ROUTE_PATH_BIER_TABLE |                \
+     FIB_ROUTE_PATH_BIER_IMP |                  \
+     FIB_ROUTE_PATH_CLASSIFY)
+
+typedef struct fib_snapshot_ctx_t_
+{
+    serialize_main_t *sm;
+    fib_node_index_t *entries;
+    u32 n_skipped;
+} fib_snapshot_ctx_t;
+
+static const fib_source_t fib_snapshot_sources[] = {
+    FIB_SOURCE_API,
+    FIB_SOURCE_CLI,
+};
+
+static int
+fib_snapshot_paths_supported (const fib_route_path_t *rpaths)
+{
+    const fib_route_path_t *rpath;
+
+    vec_foreach (rpath, rpaths)
+    {
+        if (rpath->frp_flags & FIB_SNAPSHOT_UNSUPPORTED_PATH_FLAGS)
+            return (0);
+        if (rpath->frp_proto != DPO_PROTO_IP4 &&
+            rpath->frp_proto != DPO_PROTO_IP6)
+            return (0);
+        if (vec_len (rpath->frp_label_stack))
+            return (0);
+    }
+    return (1);
+}
+
+static fib_table_walk_rc_t
+fib_snapshot_collect (fib_node_index_t fei, void *arg)
+{
+    fib_snapshot_ctx_t *ctx = arg;
+    u32 i;
+
+    for (i = 0; i < ARRAY_LEN (fib_snapshot_sources); i++)
+    {
+        if (fib_entry_is_sourced (fei, fib_snapshot_sources[i]))
+        {
+            vec_add1 (ctx->entries, fei);
+            break;
+        }
+    }
+    return (FIB_TABLE_WALK_CONTINUE);
+}
+
+static void
+fib_snapshot_serialize_entry (fib_snapshot_ctx_t *ctx,
+                              fib_node_index_t fei)
+{
+    vnet_main_t *vnm = vnet_get_main ();
+    serialize_main_t *sm = ctx->sm;
+    const fib_prefix_t *pfx;
+    fib_route_path_t *rpaths, *rpath;
+    fib_source_t source;
+    u8 *name;
+    u32 i;
+
+    rpaths = fib_entry_encode (fei);
+
+    if (!fib_snapshot_paths_supported (rpaths))
+    {
+        ctx->n_skipped++;
+        goto done;
+    }
+
+    source = FIB_SOURCE_API;
+    for (i = 0; i < ARRAY_LEN (fib_snapshot_sources); i++)
+        if (fib_entry_is_sourced (fei, fib_snapshot_sources[i]))
+        {
+            source = fib_snapshot_sources[i];
+            break;
+        }
+
+    pfx = fib_entry_get_prefix (fei);
+
+    serialize_integer (sm, 1, sizeof (u8));
+    serialize_integer (sm, source, sizeof (u8));
+    serialize_integer (sm, pfx->fp_len, sizeof (u8));
+    clib_memcpy_fast (serialize_get (sm, sizeof (pfx->fp_addr)),
+                      &pfx->fp_addr, sizeof (pfx->fp_addr));
+    serialize_likely_small_unsigned_integer (sm, vec_len (rpaths));
+
+    vec_foreach (rpath, rpaths)
+    {
+        serialize_integer (sm, rpath->frp_proto, sizeof (u8));
+        serialize_integer (sm, rpath->frp_flags, sizeof (u32));
+        serialize_integer (sm, rpath->frp_weight, sizeof (u8));
+        serialize_integer (sm, rpath->frp_preference, sizeof (u8));
+        clib_memcpy_fast (serialize_get (sm, sizeof (rpath->frp_addr)),
+                          &rpath->frp_addr, sizeof (rpath->frp_addr));
+
+        if (~0 != rpath->frp_sw_if_index)
+            name = format (0, "%U%c", format_vnet_sw_if_index_name, vnm,
+                           rpath->frp_sw_if_index, 0);
+        else
+            name = format (0, "%c", 0);
+        serialize_cstring (sm, (char *) name);
+        vec_free (name);
+
+        if (~0 != rpath->frp_fib_index)
+            serialize_integer (sm,
+                               fib_table_get_table_id (
+                                   rpath->frp_fib_index,
+                                   dpo_proto_to_fib (rpath->frp_proto)),
+                               sizeof (u32));
+        else
+            serialize_integer (sm, ~0, sizeof (u32));
+    }
+
+done:
+    vec_free (rpaths);
+}
+
+static void
+fib_snapshot_serialize (serialize_main_t *sm, va_list *va)
+{
+    fib_snapshot_ctx_t *ctx = va_arg (*va, fib_snapshot_ctx_t *);
+    fib_node_index_t *fei;
+    fib_table_t *fib_table;
+    fib_protocol_t proto;
+
+    serialize_cstring (sm, FIB_SNAPSHOT_MAGIC);
+
+    for (proto = FIB_PROTOCOL_IP4; proto <= FIB_PROTOCOL_IP6; proto++)
+    {
+        fib_table_t *fibs = (proto == FIB_PROTOCOL_IP4 ?
+                             ip4_main.fibs : ip6_main.fibs);
+
+        pool_foreach (fib_table, fibs)
+        {
+            vec_reset_length (ctx->entries);
+            fib_table_walk (fib_table->ft_index, proto,
+                            fib_snapshot_collect, ctx);
+
+            if (0 == vec_len (ctx->entries))
+                continue;
+
+            /* table header, then a 1 marker per entry, 0 to end */
+            serialize_integer (sm, 1, sizeof (u8));
+            serialize_integer (sm, proto, sizeof (u8));
+            serialize_integer (sm, fib_table->ft_table_id, sizeof (u32));
+
+            vec_foreach (fei, ctx->entries)
+                fib_snapshot_serialize_entry (ctx, *fei);
+
+            serialize_integer (sm, 0, sizeof (u8));
+        }
+    }
+    serialize_integer (sm, 0, sizeof (u8));
+}
+
+typedef struct fib_snapshot_restore_ctx_t_
+{
+    u32 n_routes;
+    u32 n_skipped;
+} fib_snapshot_restore_ctx_t;
+
+static void
+fib_snapshot_unserialize (serialize_main_t *sm, va_list *va)
+{
+    fib_snapshot_restore_ctx_t *ctx;
+    vnet_main_t *vnm = vnet_get_main ();
+    fib_route_path_t *rpaths = NULL, *rpath;
+    char *magic = NULL, *name = NULL;
+    u8 more, proto, source, len, u8v;
+    u32 table_id, fib_index, n_paths, i, u32v;
+    unformat_input_t input;
+    fib_prefix_t pfx;
+    int skip;
+
+    ctx = va_arg (*va, fib_snapshot_restore_ctx_t *);
+
+    unserialize_cstring (sm, &magic);
+    if (NULL == magic || strcmp (magic, FIB_SNAPSHOT_MAGIC))
+    {
+        vec_free (magic);
+        serialize_error (&sm->header,
+                         clib_error_return (0, "not a fib snapshot"));
+    }
+    vec_free (magic);
+
+    while (1)
+    {
+        unserialize_integer (sm, &more, sizeof (u8));
+        if (!more)
+            break;
+
+        unserialize_integer (sm, &proto, sizeof (u8));
+        unserialize_integer (sm, &table_id, sizeof (u32));
+
+        if (proto != FIB_PROTOCOL_IP4 && proto != FIB_PROTOCOL_IP6)
+            serialize_error (&sm->header,
+                             clib_error_return (0, "bad table protocol %d",
+                                                proto));
+
+        fib_index = fib_table_find (proto, table_id);
+        if (~0 == fib_index)
+            fib_index = fib_table_find_or_create_and_lock (proto, table_id,
+                                                           FIB_SOURCE_API);
+
+        while (1)
+        {
+            unserialize_integer (sm, &more, sizeof (u8));
+            if (!more)
+                break;
+
+            clib_memset (&pfx, 0, sizeof (pfx));
+            pfx.fp_proto = proto;
+            unserialize_integer (sm, &source, sizeof (u8));
+            unserialize_integer (sm, &len, sizeof (u8));
+            pfx.fp_len = len;
+            clib_memcpy_fast (&pfx.fp_addr,
+                              unserialize_get (sm, sizeof (pfx.fp_addr)),
+                              sizeof (pfx.fp_addr));
+            n_paths = unserialize_likely_small_unsigned_integer (sm);
+
+            skip = 0;
+            vec_reset_length (rpaths);
+
+            for (i = 0; i < n_paths; i++)
+            {
+                vec_add2 (rpaths, rpath, 1);
+
+                unserialize_integer (sm, &u8v, sizeof (u8));
+                rpath->frp_proto = u8v;
+                unserialize_integer (sm, &u32v, sizeof (u32));
+                rpath->frp_flags = u32v;
+                unserialize_integer (sm, &u8v, sizeof (u8));
+                rpath->frp_weight = u8v;
+                unserialize_integer (sm, &u8v, sizeof (u8));
+                rpath->frp_preference = u8v;
+                clib_memcpy_fast (&rpath->frp_addr,
+                                  unserialize_get (sm,
+                                                   sizeof (rpath->frp_addr)),
+                                  sizeof (rpath->frp_addr));
+
+                unserialize_cstring (sm, &name);
+                rpath->frp_sw_if_index = ~0;
+                if (NULL != name)
+                {
+                    unformat_init_string (&input, name, strlen (name));
+                    if (!unformat (&input, "%U", unformat_vnet_sw_interface,
+                                   vnm, &rpath->frp_sw_if_index))
+                        skip = 1;
+                    unformat_free (&input);
+                }
+                vec_free (name);
+
+                unserialize_integer (sm, &u32v, sizeof (u32));
+                rpath->frp_fib_index = ~0;
+                if (~0 != u32v)
+                {
+                    rpath->frp_fib_index =
+                        fib_table_find (dpo_proto_to_fib (rpath->frp_proto),
+                                        u32v);
+                    if (~0 == rpath->frp_fib_index)
+                        skip = 1;
+                }
+            }
+
+            if (skip ||
+                (source != FIB_SOURCE_API && source != FIB_SOURCE_CLI))
+            {
+                ctx->n_skipped++;
+                continue;
+            }
+
+            fib_table_entry_path_add2 (fib_index, &pfx, source,
+                                       FIB_ENTRY_FLAG_NONE, rpaths);
+            ctx->n_routes++;
+        }
+    }
+
+    vec_free (rpaths);
+}
+
+static u8 *
+fib_snapshot_filename (u8 *filename)
+{
+    if (strstr ((char *) filename, "..") ||
+        index ((char *) filename, '/'))
+        return (NULL);
+
+    return (format (0, "/tmp/%s%c", filename, 0));
+}
+
+static clib_error_t *
+fib_snapshot_save (vlib_main_t *vm,
+                   unformat_input_t *input,
+                   vlib_cli_command_t *cmd)
+{
+    fib_snapshot_ctx_t ctx = { 0 };
+    serialize_main_t _sm, *sm = &_sm;
+    u8 *filename = NULL, *path;
+    clib_error_t *error;
+
+    if (!unformat (input, "%s", &filename))
+        return (clib_error_return (0, "please specify a file name"));
+
+    path = fib_snapshot_filename (filename);
+    vec_free (filename);
+    if (NULL == path)
+        return (clib_error_return (0, "file name must not contain '/' "
+                                   "or '..'"));
+
+    error = serialize_open_clib_file (sm, (char *) path);
+    if (error)
+        goto done;
+
+    ctx.sm = sm;
+    error = serialize (sm, fib_snapshot_serialize, &ctx);
+    serialize_close (sm);
+
+    if (!error)
+        vlib_cli_output (vm, "FIB snapshot saved to %s (%d routes skipped)",
+                         path, ctx.n_skipped);
+
+done:
+    vec_free (ctx.entries);
+    vec_free (path);
+    return (error);
+}
+
+static clib_error_t *
+fib_snapshot_restore (vlib_main_t *vm,
+                      unformat_input_t *input,
+                      vlib_cli_command_t *cmd)
+{
+    fib_snapshot_restore_ctx_t ctx = { 0 };
+    serialize_main_t _sm, *sm = &_sm;
+    u8 *filename = NULL, *path;
+    clib_error_t *error;
+
+    if (!unformat (input, "%s", &filename))
+        return (clib_error_return (0, "please specify a file name"));
+
+    path = fib_snapshot_filename (filename);
+    vec_free (filename);
+    if (NULL == path)
+        return (clib_error_return (0, "file name must not contain '/' "
+                                   "or '..'"));
+
+    error = unserialize_open_clib_file (sm, (char *) path);
+    if (error)
+        goto done;
+
+    error = unserialize (sm, fib_snapshot_unserialize, &ctx);
+    unserialize_close (sm);
+
+    vlib_cli_output (vm, "FIB snapshot restored %d routes (%d skipped)",
+                     ctx.n_routes, ctx.n_skipped);
+
+done:
+    vec_free (path);
+    return (error);
+}
+
+/*?
+ * Save all API and CLI sourced IPv4 and IPv6 routes to /tmp/<file>.
+ * Routes whose paths reference UDP encaps, BIER or classifier objects,
+ * or carry MPLS labels, are skipped and counted.
+ *
+ * @cliexpar
+ * @cliexcmd{fib snapshot save routes.snap}
+ ?*/
+VLIB_CLI_COMMAND (fib_snapshot_save_command, static) = {
+    .path = "fib snapshot save",
+    .short_help = "fib snapshot save <file>",
+    .function = fib_snapshot_save,
+};
+
+/*?
+ * Restore routes from a snapshot in /tmp/<file>, creating any missing
+ * tables. Interfaces must already exist; routes through unknown
+ * interfaces or next-hop tables are skipped and counted.
+ *
+ * @cliexpar
+ * @cliexcmd{fib snapshot restore routes.snap}
+ ?*/
+VLIB_CLI_COMMAND (fib_snapshot_restore_command, static) = {
+    .path = "fib snapshot restore",
+    .short_help = "fib snapshot restore <file>",
+    .function = fib_snapshot_restore,
+};
@@ -22,6 +22,8 @@
 #include <vnet/fib/ip4_fib.h>
 #include <vnet/fib/ip6_fib.h>
 #include <vnet/fib/mpls_fib.h>
+#include <vnet/dpo/load_balance.h>
+#include <vlib/stats/stats.h>
 
 const static char * fib_table_flags_strings[] = FIB_TABLE_ATTRIBUTES;
 
@@ -1597,6 +1599,116 @@ fib_table_sweep (u32 fib_index,
     vec_free(ctx.ftf_entries);
 }
 
+/*
+ * The number of mtrie plies reserved per-update at the start of a batch.
+ * An IPv4 update adds at most two. An IPv6 update adds one per byte
+ * past the first two, so this is enough for a /48. Updates that need
+ * more still get them, at the cost of a barrier sync when the pool grows.
+ */
+#define FIB_TABLE_BATCH_IP4_PLIES_PER_UPDATE 2
+#define FIB_TABLE_BATCH_IP6_PLIES_PER_UPDATE 4
+
+/**
+ * Batch nesting depth and the barrier time accumulated by the outermost
+ */
+static u32 fib_table_batch_depth;
+static u64 fib_table_batch_barrier_ns;
+
+/**
+ * Stats segment gauges reporting on batches
+ */
+static u32 fib_table_batch_n_batches_si = ~0;
+static u32 fib_table_batch_last_barrier_si;
+static u32 fib_table_batch_total_barrier_si;
+static u64 fib_table_batch_n_batches;
+static u64 fib_table_batch_total_barrier_ns;
+
+void
+fib_table_batch_begin (fib_protocol_t proto,
+                       u32 n_updates)
+{
+    vlib_main_t *vm = vlib_get_main();
+    int need_barrier_sync;
+    u32 n_plies = 0;
+    f64 start;
+
+    ASSERT (vm->thread_index == 0);
+
+    switch (proto)
+    {
+    case FIB_PROTOCOL_IP4:
+        n_plies = n_updates * FIB_TABLE_BATCH_IP4_PLIES_PER_UPDATE;
+        need_barrier_sync = ip4_mtrie_pool_will_expand(n_plies);
+        break;
+    case FIB_PROTOCOL_IP6:
+        if (ip6_fib_fwding_table.use_mtrie)
+            n_plies = n_updates * FIB_TABLE_BATCH_IP6_PLIES_PER_UPDATE;
+        need_barrier_sync = ip6_mtrie_pool_will_expand(n_plies);
+        break;
+    default:
+        need_barrier_sync = 0;
+        break;
+    }
+    need_barrier_sync |= load_balance_pool_will_expand(n_updates);
+
+    /*
+     * grow all the pools the workers read in one go, rather than syncing
+     * each time one of them fills up during the batch
+     */
+    if (need_barrier_sync)
+    {
+        start = vlib_time_now(vm);
+        vlib_worker_thread_barrier_sync(vm);
+
+        load_balance_pool_reserve(n_updates);
+        if (FIB_PROTOCOL_IP4 == proto)
+            ip4_mtrie_pool_reserve(n_plies);
+        else if (FIB_PROTOCOL_IP6 == proto)
+            ip6_mtrie_pool_reserve(n_plies);
+
+        vlib_worker_thread_barrier_release(vm);
+        fib_table_batch_barrier_ns += (vlib_time_now(vm) - start) * 1e9;
+    }
+
+    ip4_mtrie_batch_begin();
+    ip6_mtrie_batch_begin();
+    fib_table_batch_depth++;
+}
+
+void
+fib_table_batch_end (void)
+{
+    ASSERT (fib_table_batch_depth > 0);
+
+    ip4_mtrie_batch_end();
+    ip6_mtrie_batch_end();
+
+    if (--fib_table_batch_depth)
+        return;
+
+    if (~0 == fib_table_batch_n_batches_si)
+    {
+        fib_table_batch_n_batches_si =
+            vlib_stats_add_gauge("/net/route/batch/batches");
+        fib_table_batch_last_barrier_si =
+            vlib_stats_add_gauge("/net/route/batch/barrier-ns");
+        fib_table_batch_total_barrier_si =
+            vlib_stats_add_gauge("/net/route/batch/barrier-ns-total");
+    }
+
+    fib_table_batch_n_batches++;
+    fib_table_batch_total_barrier_ns += fib_table_batch_barrier_ns;
+
+    vlib_stats_set_gauge(fib_table_batch_n_batches_si,
+                         fib_table_batch_n_batches);
+    vlib_stats_set_gauge(fib_table_batch_last_barrier_si,
+                         fib_table_batch_barrier_ns);
+    vlib_stats_set_gauge(fib_table_batch_total_barrier_si,
+                         fib_table_batch_total_barrier_ns);
+
+    fib_table_batch_barrier_ns = 0;
+}
+
 u8 *
 format_fib_table_memory (u8 *s, va_list *args)
 {
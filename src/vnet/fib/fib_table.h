@@ -972,6 +972,31 @@ extern void fib_table_sub_tree_walk(u32 fib_index,
                                     fib_table_walk_fn_t fn,
                                     void *ctx);
 
+/**
+ * @brief Start a batch of route updates, e.g. a burst of BGP routes.
+ *
+ * All the memory the workers read that the updates are expected to need,
+ * load-balances and mtrie plies, is allocated up front with a single
+ * worker barrier. During the batch the mtrie plies that are replaced are
+ * kept, so the workers forward on the old plies until the new ones are
+ * swapped in. Batches can nest; the replaced plies are freed when the
+ * outermost ends. Each batch's barrier hold time is reported in the stats
+ * segment under /net/route/batch.
+ *
+ * @param proto
+ *  The protocol of the tables being updated
+ *
+ * @param n_updates
+ *  The expected number of route additions
+ */
+extern void fib_table_batch_begin(fib_protocol_t proto,
+                                  u32 n_updates);
+
+/**
+ * @brief End a batch of route updates started with fib_table_batch_begin
+ */
+extern void fib_table_batch_end(void);
+
 /**
  * @brief format (display) the memory used by the FIB tables
  */
@@ -51,6 +51,23 @@ format_fib_urpf_list (u8 *s, va_list *args)
     return (s);
 }
 
+/**
+ * @brief Refresh the interface count and the in-line copy of the list
+ * used by the data-plane.
+ */
+static void
+fib_urpf_list_update_inline (fib_urpf_list_t *urpf)
+{
+    u32 i;
+
+    urpf->furpf_n_itfs = vec_len(urpf->furpf_itfs);
+
+    for (i = 0; i < FIB_URPF_LIST_N_INLINE; i++)
+        urpf->furpf_itfs_inline[i] = (i < urpf->furpf_n_itfs ?
+                                      urpf->furpf_itfs[i] :
+                                      ~0);
+}
+
 index_t
 fib_urpf_list_alloc_and_lock (void)
 {
@@ -68,6 +85,7 @@ fib_urpf_list_alloc_and_lock (void)
         vlib_worker_thread_barrier_release (vm);
 
     clib_memset(urpf, 0, sizeof(*urpf));
+    fib_urpf_list_update_inline(urpf);
 
     urpf->furpf_locks++;
 
@@ -115,6 +133,7 @@ fib_urpf_list_append (index_t ui,
     urpf = fib_urpf_list_get(ui);
 
     vec_add1(urpf->furpf_itfs, sw_if_index);
+    fib_urpf_list_update_inline(urpf);
 }
 
 /**
@@ -130,6 +149,7 @@ fib_urpf_list_combine (index_t ui1,
     urpf2 = fib_urpf_list_get(ui2);
 
     vec_append(urpf1->furpf_itfs, urpf2->furpf_itfs);
+    fib_urpf_list_update_inline(urpf1);
 }
 
 /**
@@ -176,6 +196,8 @@ fib_urpf_list_bake (index_t ui)
         vec_set_len (urpf->furpf_itfs, i+1);
       }
 
+    fib_urpf_list_update_inline(urpf);
+
     urpf->furpf_flags |= FIB_URPF_LIST_BAKED;
 }
 
@@ -55,6 +55,11 @@ typedef enum fib_urpf_list_flag_t_
     FIB_URPF_LIST_BAKED = (1 << 0),
 } fib_urpf_list_flag_t;
 
+/**
+ * @brief The number of interfaces stored in-line in the uRPF list object.
+ */
+#define FIB_URPF_LIST_N_INLINE 4
+
 typedef struct fib_urpf_list_t_
 {
     /**
@@ -62,6 +67,14 @@ typedef struct fib_urpf_list_t_
      */
     adj_index_t *furpf_itfs;
 
+    /**
+     * The number of interfaces in the list and, for small lists, a copy
+     * of them. Unused slots are ~0. This lets the data-plane check the
+     * common small lists without dereferencing the vector.
+     */
+    u32 furpf_n_itfs;
+    u32 furpf_itfs_inline[FIB_URPF_LIST_N_INLINE];
+
     /**
      * flags
      */
@@ -115,6 +128,16 @@ fib_urpf_check (index_t ui, u32 sw_if_index)
 
     urpf = fib_urpf_list_get(ui);
 
+    if (PREDICT_TRUE(urpf->furpf_n_itfs <= FIB_URPF_LIST_N_INLINE))
+    {
+        STATIC_ASSERT(FIB_URPF_LIST_N_INLINE == 4,
+                      "in-line uRPF check assumes 4 slots");
+        return ((urpf->furpf_itfs_inline[0] == sw_if_index) |
+                (urpf->furpf_itfs_inline[1] == sw_if_index) |
+                (urpf->furpf_itfs_inline[2] == sw_if_index) |
+                (urpf->furpf_itfs_inline[3] == sw_if_index));
+    }
+
     vec_foreach(swi, urpf->furpf_itfs)
     {
 	if (*swi == sw_if_index)
@@ -140,7 +163,7 @@ fib_urpf_check_size (index_t ui)
 
     urpf = fib_urpf_list_get(ui);
 
-    return (vec_len(urpf->furpf_itfs));
+    return (urpf->furpf_n_itfs);
 }
 
 #endif
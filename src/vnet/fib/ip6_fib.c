@@ -102,6 +102,14 @@ create_fib_with_table_id (u32 table_id,
 
     v6_fib->fib_entry_by_dst_address = hash_create_mem(2, sizeof(ip6_fib_hash_key_t), sizeof(fib_node_index_t));
 
+    /*
+     * the link-local tables are small and there's one per-interface,
+     * they stay with the hash lookup
+     */
+    if (ip6_fib_fwding_table.use_mtrie &&
+        !(flags & FIB_TABLE_FLAG_IP6_LL))
+        v6_fib->mtrie = ip6_mtrie_create ();
+
     /*
      * add the special entries into the new FIB
      */
@@ -186,6 +194,8 @@ ip6_fib_table_destroy (u32 fib_index)
     vec_free (fib_table->ft_locks);
     vec_free(fib_table->ft_src_route_counts);
     hash_free(pool_elt_at_index(ip6_main.v6_fibs, fib_index)->fib_entry_by_dst_address);
+    if (pool_elt_at_index(ip6_main.v6_fibs, fib_index)->mtrie)
+        ip6_mtrie_free(pool_elt_at_index(ip6_main.v6_fibs, fib_index)->mtrie);
     pool_put_index(ip6_main.v6_fibs, fib_table->ft_index);
     pool_put(ip6_main.fibs, fib_table);
 }
@@ -329,6 +339,10 @@ ip6_fib_table_fwding_dpo_update (u32 fib_index,
 
     clib_bihash_add_del_24_8(&table->ip6_hash, &kv, 1);
 
+    if (ip6_fib_get(fib_index)->mtrie)
+        ip6_mtrie_route_add(ip6_fib_get(fib_index)->mtrie,
+                            addr, len, dpo->dpoi_index);
+
     if (0 == table->dst_address_length_refcounts[len]++)
     {
         table->non_empty_dst_address_length_bitmap =
@@ -338,6 +352,50 @@ ip6_fib_table_fwding_dpo_update (u32 fib_index,
     }
 }
 
+/*
+ * Find the longest prefix, shorter than len, in the forwarding table that
+ * covers the address. There's always a default route.
+ */
+static void
+ip6_fib_table_fwding_get_cover (u32 fib_index,
+                                const ip6_address_t *addr,
+                                u32 len,
+                                u32 *cover_len,
+                                u32 *cover_lbi)
+{
+    ip6_fib_fwding_table_instance_t *table;
+    clib_bihash_kv_24_8_t kv, value;
+    ip6_address_t *mask;
+    u64 fib;
+    int i;
+
+    table = &ip6_fib_fwding_table;
+    fib = ((u64)((fib_index))<<32);
+
+    for (i = 0; i < vec_len (table->prefix_lengths_in_search_order); i++)
+    {
+        u16 dst_address_length = table->prefix_lengths_in_search_order[i];
+
+        if (dst_address_length >= len)
+            continue;
+
+        mask = &ip6_main.fib_masks[dst_address_length];
+        kv.key[0] = addr->as_u64[0] & mask->as_u64[0];
+        kv.key[1] = addr->as_u64[1] & mask->as_u64[1];
+        kv.key[2] = fib | dst_address_length;
+
+        if (!clib_bihash_search_inline_2_24_8(&table->ip6_hash, &kv, &value))
+        {
+            *cover_len = dst_address_length;
+            *cover_lbi = value.value;
+            return;
+        }
+    }
+
+    *cover_len = 0;
+    *cover_lbi = 0;
+}
+
 void
 ip6_fib_table_fwding_dpo_remove (u32 fib_index,
 				 const ip6_address_t *addr,
@@ -360,6 +418,17 @@ ip6_fib_table_fwding_dpo_remove (u32 fib_index,
 
     clib_bihash_add_del_24_8(&table->ip6_hash, &kv, 0);
 
+    if (ip6_fib_get(fib_index)->mtrie)
+    {
+        u32 cover_len, cover_lbi;
+
+        ip6_fib_table_fwding_get_cover(fib_index, addr, len,
+                                       &cover_len, &cover_lbi);
+        ip6_mtrie_route_del(ip6_fib_get(fib_index)->mtrie,
+                            addr, len, dpo->dpoi_index,
+                            cover_len, cover_lbi);
+    }
+
     /* refcount accounting */
     ASSERT (table->dst_address_length_refcounts[len] > 0);
     if (--table->dst_address_length_refcounts[len] == 0)
@@ -567,6 +636,7 @@ ip6_show_fib (vlib_main_t * vm,
     int table_id = -1, fib_index = ~0;
     int detail = 0;
     int hash = 0;
+    int mtrie = 0;
 
     verbose = 1;
     matching = 0;
@@ -587,6 +657,9 @@ ip6_show_fib (vlib_main_t * vm,
                  unformat (input, "memory"))
 	    hash = 1;
 
+	else if (unformat (input, "mtrie"))
+	    mtrie = 1;
+
 	else if (unformat (input, "%U/%d",
 			   unformat_ip6_address, &matching_address, &mask_len))
 	    matching = 1;
@@ -621,7 +694,14 @@ ip6_show_fib (vlib_main_t * vm,
         if (fib_table->ft_flags & FIB_TABLE_FLAG_IP6_LL)
             continue;
 
-	ip6_fib_table_show(vm, fib_table, !verbose);
+	ip6_fib_table_show(vm, fib_table, !verbose && !mtrie);
+
+	if (mtrie)
+	{
+	    if (fib->mtrie)
+		vlib_cli_output (vm, "%U", format_ip6_mtrie, fib->mtrie, verbose);
+	    continue;
+	}
 	if (!verbose)
 	  continue;
 
@@ -734,7 +814,7 @@ ip6_show_fib (vlib_main_t * vm,
  ?*/
 VLIB_CLI_COMMAND (ip6_show_fib_command, static) = {
     .path = "show ip6 fib",
-    .short_help = "show ip6 fib [summary] [table <table-id>] [index <fib-id>] [<ip6-addr>[/<width>]] [detail]",
+    .short_help = "show ip6 fib [summary] [table <table-id>] [index <fib-id>] [<ip6-addr>[/<width>]] [detail] [mtrie]",
     .function = ip6_show_fib,
 };
 
@@ -754,6 +834,8 @@ ip6_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "default-table-name %s", &default_name))
 	;
+      else if (unformat (input, "fib-mtrie"))
+	ip6_fib_fwding_table.use_mtrie = 1;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, input);
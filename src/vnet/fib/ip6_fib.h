@@ -43,6 +43,9 @@ typedef struct ip6_fib_fwding_table_instance_t_
   uword *non_empty_dst_address_length_bitmap;
   u8 *prefix_lengths_in_search_order;
   i32 dst_address_length_refcounts[129];
+
+  /* forwarding lookups use the per-table mtries */
+  u8 use_mtrie;
 } ip6_fib_fwding_table_instance_t;
 
 /**
@@ -90,16 +93,31 @@ extern void ip6_fib_table_walk(u32 fib_index,
                                fib_table_walk_fn_t fn,
                                void *ctx);
 
+always_inline const ip6_mtrie_t *
+ip6_fib_table_fwding_mtrie (u32 fib_index)
+{
+    if (PREDICT_TRUE (!ip6_fib_fwding_table.use_mtrie))
+	return (NULL);
+
+    /* the link-local tables do not have one */
+    return (pool_elt_at_index (ip6_main.v6_fibs, fib_index)->mtrie);
+}
+
 always_inline u32
 ip6_fib_table_fwding_lookup (u32 fib_index,
                              const ip6_address_t * dst)
 {
     ip6_fib_fwding_table_instance_t *table;
     clib_bihash_kv_24_8_t kv, value;
+    const ip6_mtrie_t *mtrie;
     int i, len;
     int rv;
     u64 fib;
 
+    mtrie = ip6_fib_table_fwding_mtrie (fib_index);
+    if (mtrie)
+	return (ip6_mtrie_lookup (mtrie, dst));
+
     table = &ip6_fib_fwding_table;
     len = vec_len (table->prefix_lengths_in_search_order);
 
@@ -133,6 +151,74 @@ ip6_fib_table_fwding_lookup (u32 fib_index,
  * N.B: This is NOT safe to deletes. If you need to delete walk the whole
  * table and store elements in a vector, then delete the elements
  */
+/**
+ * @brief Forwarding lookup of two addresses. When the mtries are in use
+ * the walks of both tries are interleaved.
+ */
+static_always_inline void
+ip6_fib_table_fwding_lookup_x2 (u32 fib_index0,
+                                u32 fib_index1,
+                                const ip6_address_t * dst0,
+                                const ip6_address_t * dst1,
+                                u32 *lbi0,
+                                u32 *lbi1)
+{
+    const ip6_mtrie_t *mtrie0, *mtrie1;
+
+    mtrie0 = ip6_fib_table_fwding_mtrie (fib_index0);
+    mtrie1 = ip6_fib_table_fwding_mtrie (fib_index1);
+
+    if (mtrie0 && mtrie1)
+    {
+	ip6_mtrie_lookup_x2 (mtrie0, mtrie1, dst0, dst1, lbi0, lbi1);
+    }
+    else
+    {
+	*lbi0 = ip6_fib_table_fwding_lookup (fib_index0, dst0);
+	*lbi1 = ip6_fib_table_fwding_lookup (fib_index1, dst1);
+    }
+}
+
+/**
+ * @brief Forwarding lookup of four addresses. When the mtries are in use
+ * the walks of the four tries are interleaved.
+ */
+static_always_inline void
+ip6_fib_table_fwding_lookup_x4 (u32 fib_index0,
+                                u32 fib_index1,
+                                u32 fib_index2,
+                                u32 fib_index3,
+                                const ip6_address_t * dst0,
+                                const ip6_address_t * dst1,
+                                const ip6_address_t * dst2,
+                                const ip6_address_t * dst3,
+                                u32 *lbi0,
+                                u32 *lbi1,
+                                u32 *lbi2,
+                                u32 *lbi3)
+{
+    const ip6_mtrie_t *mtrie0, *mtrie1, *mtrie2, *mtrie3;
+
+    mtrie0 = ip6_fib_table_fwding_mtrie (fib_index0);
+    mtrie1 = ip6_fib_table_fwding_mtrie (fib_index1);
+    mtrie2 = ip6_fib_table_fwding_mtrie (fib_index2);
+    mtrie3 = ip6_fib_table_fwding_mtrie (fib_index3);
+
+    if (mtrie0 && mtrie1 && mtrie2 && mtrie3)
+    {
+	ip6_mtrie_lookup_x4 (mtrie0, mtrie1, mtrie2, mtrie3,
+			     dst0, dst1, dst2, dst3,
+			     lbi0, lbi1, lbi2, lbi3);
+    }
+    else
+    {
+	*lbi0 = ip6_fib_table_fwding_lookup (fib_index0, dst0);
+	*lbi1 = ip6_fib_table_fwding_lookup (fib_index1, dst1);
+	*lbi2 = ip6_fib_table_fwding_lookup (fib_index2, dst2);
+	*lbi3 = ip6_fib_table_fwding_lookup (fib_index3, dst3);
+    }
+}
+
 extern void ip6_fib_table_sub_tree_walk(u32 fib_index,
                                         const fib_prefix_t *root,
                                         fib_table_walk_fn_t fn,
@@ -82,6 +82,57 @@ VLIB_CLI_COMMAND (set_interface_feature_gso_command, static) = {
   .function = set_interface_feature_gso_command_fn,
 };
 
+static clib_error_t *
+set_interface_feature_gro_command_fn (vlib_main_t *vm,
+				      unformat_input_t *input,
+				      vlib_cli_command_t *cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  unformat_input_t _line_input, *line_input = &_line_input;
+  clib_error_t *error = 0;
+
+  u32 sw_if_index = ~0;
+  u8 enable = 0;
+
+  /* Get a line of input. */
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%U", unformat_vnet_sw_interface, vnm,
+		    &sw_if_index))
+	;
+      else if (unformat (line_input, "enable"))
+	enable = 1;
+      else if (unformat (line_input, "disable"))
+	enable = 0;
+      else
+	{
+	  error = unformat_parse_error (line_input);
+	  goto done;
+	}
+    }
+
+  if (sw_if_index == ~0)
+    {
+      error = clib_error_return (0, "Interface not specified...");
+      goto done;
+    }
+
+  vnet_sw_interface_gro_enable_disable (sw_if_index, enable);
+
+done:
+  unformat_free (line_input);
+  return error;
+}
+
+VLIB_CLI_COMMAND (set_interface_feature_gro_command, static) = {
+  .path = "set interface feature gro",
+  .short_help = "set interface feature gro <intfc> [enable | disable]",
+  .function = set_interface_feature_gro_command_fn,
+};
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
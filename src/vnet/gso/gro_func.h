@@ -135,7 +135,7 @@ gro_merge_buffers (vlib_main_t * vm, vlib_buffer_t * b0,
   vlib_buffer_t *pb = b0;
 
   if (PREDICT_FALSE ((b0->flags & VLIB_BUFFER_NEXT_PRESENT) == 0))
-    b0->total_length_not_including_first_buffer = 0;
+    vlib_buffer_cold (b0)->total_length_not_including_first_buffer = 0;
 
   while (pb->flags & VLIB_BUFFER_NEXT_PRESENT)
     pb = vlib_get_buffer (vm, pb->next_buffer);
@@ -143,7 +143,8 @@ gro_merge_buffers (vlib_main_t * vm, vlib_buffer_t * b0,
   vlib_buffer_advance (b1, l234_sz1);
   pb->flags |= VLIB_BUFFER_NEXT_PRESENT;
   pb->next_buffer = bi1;
-  b0->total_length_not_including_first_buffer += payload_len1;
+  vlib_buffer_cold (b0)->total_length_not_including_first_buffer +=
+    payload_len1;
   b0->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
 }
 
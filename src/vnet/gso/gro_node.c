@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/feature/feature.h>
+#include <vnet/gso/gso.h>
+#include <vnet/gso/gro_func.h>
+
+/*
+ * Generic GRO feature on the ip4-unicast and ip6-unicast arcs.
+ *
+ * TCP segments of the same flow received on an interface are coalesced
+ * into a chained GSO buffer, using the same per-thread flow table as the
+ * virtio and tap drivers. A flow is held for at most GRO_FLOW_TIMEOUT, so
+ * segments spread over a few frames can be coalesced too. Features after
+ * gro see fewer, larger packets; egress needs GSO support or the gso
+ * feature.
+ *
+ * Stored packets are flushed by the gro-flush pre-input node on each
+ * thread. It sends them back to the gro node, which passes GSO packets
+ * through to the next feature.
+ */
+
+typedef struct
+{
+  /* per af, indexed by sw_if_index */
+  gro_flow_table_t **flow_tables[2];
+} gro_per_thread_data_t;
+
+typedef struct
+{
+  gro_per_thread_data_t *per_thread_data;
+  /* bit set for each interface with gro enabled */
+  uword *enabled_by_sw_if_index;
+  u32 n_enabled;
+} gro_main_t;
+
+static gro_main_t gro_main;
+
+typedef struct
+{
+  u32 sw_if_index;
+  u32 n_flows;
+} gro_trace_t;
+
+static u8 *
+format_gro_trace (u8 *s, va_list *args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  gro_trace_t *t = va_arg (*args, gro_trace_t *);
+
+  s = format (s, "gro: sw_if_index %u flows %u", t->sw_if_index, t->n_flows);
+  return s;
+}
+
+vlib_node_registration_t gro_ip4_node;
+vlib_node_registration_t gro_ip6_node;
+vlib_node_registration_t gro_flush_node;
+
+static_always_inline uword
+gro_node_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
+		 vlib_frame_t *frame, int is_ip6)
+{
+  gro_main_t *gm = &gro_main;
+  gro_per_thread_data_t *ptd =
+    vec_elt_at_index (gm->per_thread_data, vm->thread_index);
+  vlib_buffer_t *bufs[2 * VLIB_FRAME_SIZE];
+  u16 nexts[2 * VLIB_FRAME_SIZE];
+  /* every packet may also release one stored before it */
+  u32 to[2 * VLIB_FRAME_SIZE];
+  u32 *from = vlib_frame_vector_args (frame);
+  u32 n_left = frame->n_vectors, n_to = 0;
+
+  vlib_get_buffers (vm, from, bufs, n_left);
+
+  for (u32 i = 0; i < n_left; i++)
+    {
+      u32 sw_if_index = vnet_buffer (bufs[i])->sw_if_index[VLIB_RX];
+      gro_flow_table_t *ft = 0;
+
+      if (i + 4 < n_left)
+	vlib_prefetch_buffer_data (bufs[i + 4], LOAD);
+
+      if (sw_if_index < vec_len (ptd->flow_tables[is_ip6]))
+	ft = ptd->flow_tables[is_ip6][sw_if_index];
+
+      if (PREDICT_FALSE (bufs[i]->flags & VLIB_BUFFER_IS_TRACED))
+	{
+	  gro_trace_t *t = vlib_add_trace (vm, node, bufs[i], sizeof (*t));
+	  t->sw_if_index = sw_if_index;
+	  t->n_flows = ft ? ft->flow_table_size : 0;
+	}
+
+      /* no table means the packet passes through */
+      n_to += vnet_gro_flow_table_inline (vm, ft, from[i], to + n_to);
+    }
+
+  vlib_get_buffers (vm, to, bufs, n_to);
+  vnet_feature_next_n (bufs, nexts, n_to);
+
+  vlib_buffer_enqueue_to_next (vm, node, to, nexts, n_to);
+  return frame->n_vectors;
+}
+
+VLIB_NODE_FN (gro_ip4_node)
+(vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  return gro_node_inline (vm, node, frame, 0 /* is_ip6 */);
+}
+
+VLIB_NODE_FN (gro_ip6_node)
+(vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  return gro_node_inline (vm, node, frame, 1 /* is_ip6 */);
+}
+
+VLIB_REGISTER_NODE (gro_ip4_node) = {
+  .name = "gro-ip4",
+  .vector_size = sizeof (u32),
+  .format_trace = format_gro_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+};
+
+VLIB_REGISTER_NODE (gro_ip6_node) = {
+  .name = "gro-ip6",
+  .vector_size = sizeof (u32),
+  .format_trace = format_gro_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+};
+
+VNET_FEATURE_INIT (gro_ip4_node, static) = {
+  .arc_name = "ip4-unicast",
+  .node_name = "gro-ip4",
+};
+
+VNET_FEATURE_INIT (gro_ip6_node, static) = {
+  .arc_name = "ip6-unicast",
+  .node_name = "gro-ip6",
+};
+
+static_always_inline void
+gro_flush_flow_tables (vlib_main_t *vm, gro_flow_table_t **flow_tables,
+		       u32 node_index)
+{
+  vlib_frame_t *f = 0;
+  u32 *f_to = 0;
+  gro_flow_table_t **ft;
+
+  vec_foreach (ft, flow_tables)
+    {
+      if (!ft[0] || !gro_flow_table_is_timeout (vm, ft[0]))
+	continue;
+
+      if (ft[0]->flow_table_size)
+	{
+	  if (f && f->n_vectors + GRO_FLOW_TABLE_MAX_SIZE > VLIB_FRAME_SIZE)
+	    {
+	      vlib_put_frame_to_node (vm, node_index, f);
+	      f = 0;
+	    }
+	  if (!f)
+	    {
+	      f = vlib_get_frame_to_node (vm, node_index);
+	      f_to = vlib_frame_vector_args (f);
+	    }
+	  f->n_vectors +=
+	    vnet_gro_flow_table_flush (vm, ft[0], f_to + f->n_vectors);
+	}
+      gro_flow_table_set_timeout (vm, ft[0], GRO_FLOW_TABLE_FLUSH);
+    }
+
+  if (f && f->n_vectors)
+    vlib_put_frame_to_node (vm, node_index, f);
+  else if (f)
+    vlib_frame_free (vm, f);
+}
+
+static uword
+gro_flush (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  gro_main_t *gm = &gro_main;
+  gro_per_thread_data_t *ptd =
+    vec_elt_at_index (gm->per_thread_data, vm->thread_index);
+
+  gro_flush_flow_tables (vm, ptd->flow_tables[0], gro_ip4_node.index);
+  gro_flush_flow_tables (vm, ptd->flow_tables[1], gro_ip6_node.index);
+  return 0;
+}
+
+VLIB_REGISTER_NODE (gro_flush_node) = {
+  .function = gro_flush,
+  .type = VLIB_NODE_TYPE_PRE_INPUT,
+  .name = "gro-flush",
+  .state = VLIB_NODE_STATE_DISABLED,
+};
+
+static void
+gro_flow_table_drop (vlib_main_t *vm, gro_flow_table_t *ft)
+{
+  for (u32 i = 0; i < GRO_FLOW_TABLE_MAX_SIZE; i++)
+    if (ft->gro_flow[i].n_buffers)
+      vlib_buffer_free_one (vm, ft->gro_flow[i].buffer_index);
+  gro_flow_table_free (ft);
+}
+
+/*
+ * Called from the main thread with workers stopped at the barrier, as
+ * the per-thread flow tables are allocated and freed here.
+ */
+int
+vnet_sw_interface_gro_enable_disable (u32 sw_if_index, u8 enable)
+{
+  vlib_main_t *vm = vlib_get_main ();
+  gro_main_t *gm = &gro_main;
+  u32 node_index[2] = { gro_ip4_node.index, gro_ip6_node.index };
+
+  if (clib_bitmap_get (gm->enabled_by_sw_if_index, sw_if_index) == enable)
+    return 0;
+
+  vec_validate (gm->per_thread_data, vlib_num_workers ());
+
+  for (int is_ip6 = 0; is_ip6 < 2; is_ip6++)
+    {
+      gro_per_thread_data_t *ptd;
+      vec_foreach (ptd, gm->per_thread_data)
+	{
+	  gro_flow_table_t **ft;
+	  vec_validate (ptd->flow_tables[is_ip6], sw_if_index);
+	  ft = vec_elt_at_index (ptd->flow_tables[is_ip6], sw_if_index);
+	  if (enable)
+	    gro_flow_table_init (ft, 0 /* is_l2 */, node_index[is_ip6]);
+	  else if (ft[0])
+	    {
+	      gro_flow_table_drop (vm, ft[0]);
+	      ft[0] = 0;
+	    }
+	}
+    }
+  gm->enabled_by_sw_if_index =
+    clib_bitmap_set (gm->enabled_by_sw_if_index, sw_if_index, enable);
+
+  vnet_feature_enable_disable ("ip4-unicast", "gro-ip4", sw_if_index, enable,
+			       0, 0);
+  vnet_feature_enable_disable ("ip6-unicast", "gro-ip6", sw_if_index, enable,
+			       0, 0);
+
+  gm->n_enabled += enable ? 1 : -1;
+  if (gm->n_enabled == (enable ? 1 : 0))
+    foreach_vlib_main ()
+      vlib_node_set_state (this_vlib_main, gro_flush_node.index,
+			   enable ? VLIB_NODE_STATE_POLLING :
+				    VLIB_NODE_STATE_DISABLED);
+
+  return 0;
+}
+
+static clib_error_t *
+gro_init (vlib_main_t *vm)
+{
+  gro_main_t *gm = &gro_main;
+
+  vec_validate (gm->per_thread_data, vlib_num_workers ());
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (gro_init);
@@ -30,6 +30,7 @@ typedef struct
 extern gso_main_t gso_main;
 
 int vnet_sw_interface_gso_enable_disable (u32 sw_if_index, u8 enable);
+int vnet_sw_interface_gro_enable_disable (u32 sw_if_index, u8 enable);
 u32 gso_segment_buffer (vlib_main_t *vm, vnet_interface_per_thread_data_t *ptd,
 			u32 bi, vlib_buffer_t *b, generic_header_offset_t *gho,
 			u32 n_bytes_b, u8 is_l2, u8 is_ip6);
@@ -63,15 +64,12 @@ gso_init_bufs_from_template_base (vlib_buffer_t **bufs, vlib_buffer_t *b0,
       clib_memcpy_fast (&bufs[0]->opaque, &b0->opaque, sizeof (b0->opaque));
       clib_memcpy_fast (&bufs[1]->opaque, &b0->opaque, sizeof (b0->opaque));
 
-      /* copying objects from cacheline 1 */
-      bufs[0]->trace_handle = b0->trace_handle;
-      bufs[1]->trace_handle = b0->trace_handle;
+      /* copying the cold metadata */
+      *vlib_buffer_cold (bufs[0]) = *vlib_buffer_cold (b0);
+      *vlib_buffer_cold (bufs[1]) = *vlib_buffer_cold (b0);
 
-      bufs[0]->total_length_not_including_first_buffer = 0;
-      bufs[1]->total_length_not_including_first_buffer = 0;
-
-      clib_memcpy_fast (&bufs[0]->opaque2, &b0->opaque2, sizeof (b0->opaque2));
-      clib_memcpy_fast (&bufs[1]->opaque2, &b0->opaque2, sizeof (b0->opaque2));
+      vlib_buffer_cold (bufs[0])->total_length_not_including_first_buffer = 0;
+      vlib_buffer_cold (bufs[1])->total_length_not_including_first_buffer = 0;
 
       /* copying data */
       clib_memcpy_fast (bufs[0]->data, vlib_buffer_get_current (b0), hdr_sz);
@@ -105,10 +103,9 @@ gso_init_bufs_from_template_base (vlib_buffer_t **bufs, vlib_buffer_t *b0,
       bufs[0]->current_config_index = b0->current_config_index;
       clib_memcpy_fast (&bufs[0]->opaque, &b0->opaque, sizeof (b0->opaque));
 
-      /* copying objects from cacheline 1 */
-      bufs[0]->trace_handle = b0->trace_handle;
-      bufs[0]->total_length_not_including_first_buffer = 0;
-      clib_memcpy_fast (&bufs[0]->opaque2, &b0->opaque2, sizeof (b0->opaque2));
+      /* copying the cold metadata */
+      *vlib_buffer_cold (bufs[0]) = *vlib_buffer_cold (b0);
+      vlib_buffer_cold (bufs[0])->total_length_not_including_first_buffer = 0;
 
       /* copying data */
       clib_memcpy_fast (bufs[0]->data, vlib_buffer_get_current (b0), hdr_sz);
@@ -125,15 +122,128 @@ gso_init_bufs_from_template_base (vlib_buffer_t **bufs, vlib_buffer_t *b0,
     }
 }
 
+static_always_inline void
+gso_fixup_ipip_tunnel_headers (vlib_buffer_t *b0)
+{
+  i16 outer_l3_hdr_offset = vnet_buffer2 (b0)->outer_l3_hdr_offset;
+  i16 l3_hdr_offset = vnet_buffer (b0)->l3_hdr_offset;
+
+  ip4_header_t *ip4 = (ip4_header_t *) (b0->data + outer_l3_hdr_offset);
+  ip6_header_t *ip6 = (ip6_header_t *) (b0->data + outer_l3_hdr_offset);
+
+  if (vnet_buffer (b0)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM)
+    {
+      ip4->length = clib_host_to_net_u16 (
+	b0->current_length - (outer_l3_hdr_offset - b0->current_data));
+      ip4->checksum = ip4_header_checksum (ip4);
+      vnet_buffer_offload_flags_clear (b0,
+				       VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM |
+					 VNET_BUFFER_OFFLOAD_F_TNL_IPIP);
+    }
+  else
+    {
+      ip6->payload_length = clib_host_to_net_u16 (
+	b0->current_length - (l3_hdr_offset - b0->current_data));
+      vnet_buffer_offload_flags_clear (b0, VNET_BUFFER_OFFLOAD_F_TNL_IPIP);
+    }
+}
+
+static_always_inline void
+gso_fixup_vxlan_tunnel_headers (vlib_main_t *vm, vlib_buffer_t *b)
+{
+  i16 outer_l3_hdr_offset = vnet_buffer2 (b)->outer_l3_hdr_offset;
+  i16 outer_l4_hdr_offset = vnet_buffer2 (b)->outer_l4_hdr_offset;
+
+  ip4_header_t *ip4 = (ip4_header_t *) (b->data + outer_l3_hdr_offset);
+  ip6_header_t *ip6 = (ip6_header_t *) (b->data + outer_l3_hdr_offset);
+  udp_header_t *udp = (udp_header_t *) (b->data + outer_l4_hdr_offset);
+
+  if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM)
+    {
+      ip4->length = clib_host_to_net_u16 (
+	b->current_length - (outer_l3_hdr_offset - b->current_data));
+      ip4->checksum = ip4_header_checksum (ip4);
+      if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM)
+	{
+	  udp->length = clib_host_to_net_u16 (
+	    b->current_length - (outer_l4_hdr_offset - b->current_data));
+	  // udp checksum is 0, in udp tunnel
+	  udp->checksum = 0;
+	}
+      vnet_buffer_offload_flags_clear (
+	b, VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM |
+	     VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM |
+	     VNET_BUFFER_OFFLOAD_F_TNL_VXLAN);
+    }
+  else
+    {
+      ip6->payload_length = clib_host_to_net_u16 (
+	b->current_length - (outer_l4_hdr_offset - b->current_data));
+
+      if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM)
+	{
+	  int bogus;
+	  udp->length = ip6->payload_length;
+	  // udp checksum is 0, in udp tunnel
+	  udp->checksum = 0;
+	  udp->checksum =
+	    ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+	  vnet_buffer_offload_flags_clear (
+	    b, VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM |
+		 VNET_BUFFER_OFFLOAD_F_TNL_VXLAN);
+	}
+    }
+}
+
+/*
+ * Sum the per-packet invariant parts of the inner ip4 header and of the
+ * pseudo header once, with the length fields zeroed. Segments then only
+ * add their own lengths to these sums.
+ */
+static_always_inline void
+gso_template_csum_init (vlib_buffer_t *b0, u8 oflags, u64 *l3_sum,
+			u64 *psh_sum)
+{
+  i16 l3_hdr_offset = vnet_buffer (b0)->l3_hdr_offset;
+
+  ip4_header_t *ip4 = (ip4_header_t *) (b0->data + l3_hdr_offset);
+  ip6_header_t *ip6 = (ip6_header_t *) (b0->data + l3_hdr_offset);
+
+  if (oflags & VNET_BUFFER_OFFLOAD_F_IP_CKSUM)
+    {
+      clib_ip_csum_t c = { .sum = 0, .odd = 0 };
+      ip4->length = 0;
+      ip4->checksum = 0;
+      clib_ip_csum_chunk (&c, (u8 *) ip4, ip4_header_bytes (ip4));
+      *l3_sum = c.sum;
+      *psh_sum = (u64) clib_mem_unaligned (&ip4->src_address, u32) +
+		 clib_mem_unaligned (&ip4->dst_address, u32) +
+		 clib_host_to_net_u32 (ip4->protocol << 16);
+    }
+  else
+    {
+      ip6_psh_t psh = { 0 };
+      u32 *p = (u32 *) &psh;
+      psh.src = ip6->src_address;
+      psh.dst = ip6->dst_address;
+      psh.proto = clib_host_to_net_u32 ((u32) ip6->protocol);
+      *l3_sum = 0;
+      *psh_sum = 0;
+      for (int i = 0; i < 10; i++)
+	*psh_sum += p[i];
+    }
+}
+
 static_always_inline void
 gso_fixup_segmented_buf (vlib_main_t *vm, vlib_buffer_t *b0, u32 next_tcp_seq,
 			 int is_l2, u8 oflags, u16 hdr_sz, u16 l4_hdr_sz,
-			 clib_ip_csum_t *c, u8 tcp_flags, u8 is_prefetch,
-			 vlib_buffer_t *b1)
+			 clib_ip_csum_t *c, u64 l3_sum, u64 psh_sum,
+			 u8 tcp_flags, u8 is_prefetch, vlib_buffer_t *b1)
 {
 
   i16 l3_hdr_offset = vnet_buffer (b0)->l3_hdr_offset;
   i16 l4_hdr_offset = vnet_buffer (b0)->l4_hdr_offset;
+  u16 l4_len = b0->current_length - hdr_sz + l4_hdr_sz;
 
   ip4_header_t *ip4 = (ip4_header_t *) (b0->data + l3_hdr_offset);
   ip6_header_t *ip6 = (ip6_header_t *) (b0->data + l3_hdr_offset);
@@ -145,33 +255,20 @@ gso_fixup_segmented_buf (vlib_main_t *vm, vlib_buffer_t *b0, u32 next_tcp_seq,
 
   if (oflags & VNET_BUFFER_OFFLOAD_F_IP_CKSUM)
     {
+      clib_ip_csum_t ic;
       ip4->length =
-	clib_host_to_net_u16 (b0->current_length - hdr_sz +
-			      (l4_hdr_offset - l3_hdr_offset) + l4_hdr_sz);
-      ip4->checksum = 0;
-      ip4->checksum = ip4_header_checksum (ip4);
+	clib_host_to_net_u16 (l4_len + (l4_hdr_offset - l3_hdr_offset));
+      ic.sum = l3_sum + ip4->length;
+      ip4->checksum = clib_ip_csum_fold (&ic);
       vnet_buffer_offload_flags_clear (b0, (VNET_BUFFER_OFFLOAD_F_IP_CKSUM |
 					    VNET_BUFFER_OFFLOAD_F_TCP_CKSUM));
-      c->sum += clib_mem_unaligned (&ip4->src_address, u32);
-      c->sum += clib_mem_unaligned (&ip4->dst_address, u32);
-      c->sum += clib_host_to_net_u32 (
-	(clib_net_to_host_u16 (ip4->length) - ip4_header_bytes (ip4)) +
-	(ip4->protocol << 16));
     }
   else
     {
-      ip6->payload_length =
-	clib_host_to_net_u16 (b0->current_length - hdr_sz + l4_hdr_sz);
+      ip6->payload_length = clib_host_to_net_u16 (l4_len);
       vnet_buffer_offload_flags_clear (b0, VNET_BUFFER_OFFLOAD_F_TCP_CKSUM);
-      ip6_psh_t psh = { 0 };
-      u32 *p = (u32 *) &psh;
-      psh.src = ip6->src_address;
-      psh.dst = ip6->dst_address;
-      psh.l4len = ip6->payload_length;
-      psh.proto = clib_host_to_net_u32 ((u32) ip6->protocol);
-      for (int i = 0; i < 10; i++)
-	c->sum += p[i];
     }
+  c->sum += psh_sum + clib_host_to_net_u32 (l4_len);
 
   if (is_prefetch)
     CLIB_PREFETCH (vlib_buffer_get_current (b1) + hdr_sz,
@@ -180,6 +277,11 @@ gso_fixup_segmented_buf (vlib_main_t *vm, vlib_buffer_t *b0, u32 next_tcp_seq,
   clib_ip_csum_chunk (c, (u8 *) tcp, l4_hdr_sz);
   tcp->checksum = clib_ip_csum_fold (c);
 
+  if (PREDICT_FALSE (oflags & VNET_BUFFER_OFFLOAD_F_TNL_VXLAN))
+    gso_fixup_vxlan_tunnel_headers (vm, b0);
+  else if (PREDICT_FALSE (oflags & VNET_BUFFER_OFFLOAD_F_TNL_IPIP))
+    gso_fixup_ipip_tunnel_headers (b0);
+
   if (!is_l2 && ((oflags & VNET_BUFFER_OFFLOAD_F_TNL_MASK) == 0))
     {
       u32 adj_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
@@ -217,6 +319,7 @@ gso_segment_buffer_inline (vlib_main_t *vm,
     clib_min (gso_size, vlib_buffer_get_default_data_size (vm) - hdr_sz);
   u16 n_alloc = 0, n_bufs = ((data_size + size - 1) / size);
   clib_ip_csum_t c = { .sum = 0, .odd = 0 };
+  u64 l3_sum, psh_sum;
   u8 *src_ptr, *dst_ptr;
   u16 src_left, dst_left, bytes_to_copy;
   u32 i = 0;
@@ -241,6 +344,7 @@ gso_segment_buffer_inline (vlib_main_t *vm,
   tcp->checksum = 0;
 
   gso_init_bufs_from_template_base (bufs, b, default_bflags, n_bufs, hdr_sz);
+  gso_template_csum_init (bufs[0], oflags, &l3_sum, &psh_sum);
 
   src_ptr = vlib_buffer_get_current (b) + hdr_sz;
   src_left = b->current_length - hdr_sz;
@@ -281,8 +385,8 @@ gso_segment_buffer_inline (vlib_main_t *vm,
 
 	  n_tx_bytes += bufs[i]->current_length;
 	  gso_fixup_segmented_buf (vm, bufs[i], tcp_seq, is_l2, oflags, hdr_sz,
-				   l4_hdr_sz, &c, tcp_flags_no_fin_psh, 1,
-				   bufs[i + 1]);
+				   l4_hdr_sz, &c, l3_sum, psh_sum,
+				   tcp_flags_no_fin_psh, 1, bufs[i + 1]);
 	  i++;
 	  dst_left = size;
 	  dst_ptr = vlib_buffer_get_current (bufs[i]) + hdr_sz;
@@ -296,7 +400,7 @@ gso_segment_buffer_inline (vlib_main_t *vm,
   ASSERT ((i + 1) == n_alloc);
   n_tx_bytes += bufs[i]->current_length;
   gso_fixup_segmented_buf (vm, bufs[i], tcp_seq, is_l2, oflags, hdr_sz,
-			   l4_hdr_sz, &c, tcp_flags, 0, NULL);
+			   l4_hdr_sz, &c, l3_sum, psh_sum, tcp_flags, 0, NULL);
 
   vec_free (bufs);
   return n_tx_bytes;
@@ -80,110 +80,6 @@ format_gso_trace (u8 * s, va_list * args)
   return s;
 }
 
-static_always_inline void
-tso_segment_ipip_tunnel_fixup (vlib_main_t *vm,
-			       vnet_interface_per_thread_data_t *ptd,
-			       vlib_buffer_t *sb0)
-{
-  u16 n_tx_bufs = vec_len (ptd->split_buffers);
-  u16 i = 0;
-
-  while (i < n_tx_bufs)
-    {
-      vlib_buffer_t *b0 = vlib_get_buffer (vm, ptd->split_buffers[i]);
-      i16 outer_l3_hdr_offset = vnet_buffer2 (b0)->outer_l3_hdr_offset;
-      i16 l3_hdr_offset = vnet_buffer (b0)->l3_hdr_offset;
-
-      ip4_header_t *ip4 = (ip4_header_t *) (b0->data + outer_l3_hdr_offset);
-      ip6_header_t *ip6 = (ip6_header_t *) (b0->data + outer_l3_hdr_offset);
-
-      if (vnet_buffer (b0)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM)
-	{
-	  ip4->length = clib_host_to_net_u16 (
-	    b0->current_length - (outer_l3_hdr_offset - b0->current_data));
-	  ip4->checksum = ip4_header_checksum (ip4);
-	  vnet_buffer_offload_flags_clear (
-	    b0, VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM |
-		  VNET_BUFFER_OFFLOAD_F_TNL_IPIP);
-	}
-      else
-	{
-	  ip6->payload_length = clib_host_to_net_u16 (
-	    b0->current_length - (l3_hdr_offset - b0->current_data));
-	  vnet_buffer_offload_flags_clear (b0, VNET_BUFFER_OFFLOAD_F_TNL_IPIP);
-	}
-
-      i++;
-    }
-}
-
-static_always_inline void
-tso_segment_vxlan_tunnel_headers_fixup (vlib_main_t *vm, vlib_buffer_t *b)
-{
-  ip4_header_t *ip4 = 0;
-  ip6_header_t *ip6 = 0;
-  udp_header_t *udp = 0;
-  i16 outer_l3_hdr_offset = vnet_buffer2 (b)->outer_l3_hdr_offset;
-  i16 outer_l4_hdr_offset = vnet_buffer2 (b)->outer_l4_hdr_offset;
-
-  ip4 = (ip4_header_t *) (b->data + outer_l3_hdr_offset);
-  ip6 = (ip6_header_t *) (b->data + outer_l3_hdr_offset);
-  udp = (udp_header_t *) (b->data + outer_l4_hdr_offset);
-
-  if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM)
-    {
-      ip4->length = clib_host_to_net_u16 (
-	b->current_length - (outer_l3_hdr_offset - b->current_data));
-      ip4->checksum = ip4_header_checksum (ip4);
-      if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM)
-	{
-	  udp->length = clib_host_to_net_u16 (
-	    b->current_length - (outer_l4_hdr_offset - b->current_data));
-	  // udp checksum is 0, in udp tunnel
-	  udp->checksum = 0;
-	}
-      vnet_buffer_offload_flags_clear (
-	b, VNET_BUFFER_OFFLOAD_F_OUTER_IP_CKSUM |
-	     VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM |
-	     VNET_BUFFER_OFFLOAD_F_TNL_VXLAN);
-    }
-  else
-    {
-      ip6->payload_length = clib_host_to_net_u16 (
-	b->current_length - (outer_l4_hdr_offset - b->current_data));
-
-      if (vnet_buffer (b)->oflags & VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM)
-	{
-	  int bogus;
-	  udp->length = ip6->payload_length;
-	  // udp checksum is 0, in udp tunnel
-	  udp->checksum = 0;
-	  udp->checksum =
-	    ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
-	  vnet_buffer_offload_flags_clear (
-	    b, VNET_BUFFER_OFFLOAD_F_OUTER_UDP_CKSUM |
-		 VNET_BUFFER_OFFLOAD_F_TNL_VXLAN);
-	}
-    }
-}
-
-static_always_inline void
-tso_segment_vxlan_tunnel_fixup (vlib_main_t *vm,
-				vnet_interface_per_thread_data_t *ptd,
-				vlib_buffer_t *sb0)
-{
-  u16 n_tx_bufs = vec_len (ptd->split_buffers);
-  u16 i = 0;
-
-  while (i < n_tx_bufs)
-    {
-      vlib_buffer_t *b0 = vlib_get_buffer (vm, ptd->split_buffers[i]);
-
-      tso_segment_vxlan_tunnel_headers_fixup (vm, b0);
-      i++;
-    }
-}
-
 static_always_inline u16
 tso_alloc_tx_bufs (vlib_main_t * vm,
 		   vnet_interface_per_thread_data_t * ptd,
@@ -244,8 +140,8 @@ tso_init_buf_from_template_base (vlib_buffer_t * nb0, vlib_buffer_t * b0,
   clib_memcpy_fast (&nb0->opaque, &b0->opaque, sizeof (nb0->opaque));
 
   /* copying objects from cacheline 1 */
-  nb0->trace_handle = b0->trace_handle;
-  nb0->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (nb0)->trace_handle = vlib_buffer_cold (b0)->trace_handle;
+  vlib_buffer_cold (nb0)->total_length_not_including_first_buffer = 0;
 
   /* copying data */
   clib_memcpy_fast (vlib_buffer_get_current (nb0),
@@ -691,17 +587,6 @@ vnet_gso_node_inline (vlib_main_t * vm,
 		      continue;
 		    }
 
-		  if (PREDICT_FALSE (vnet_buffer (b[0])->oflags &
-				     VNET_BUFFER_OFFLOAD_F_TNL_VXLAN))
-		    {
-		      tso_segment_vxlan_tunnel_fixup (vm, ptd, b[0]);
-		    }
-		  else if (PREDICT_FALSE (vnet_buffer (b[0])->oflags &
-					  VNET_BUFFER_OFFLOAD_F_TNL_IPIP))
-		    {
-		      tso_segment_ipip_tunnel_fixup (vm, ptd, b[0]);
-		    }
-
 		  u16 n_tx_bufs = vec_len (ptd->split_buffers);
 		  u32 *from_seg = ptd->split_buffers;
 
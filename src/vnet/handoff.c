@@ -22,6 +22,9 @@
 typedef struct
 {
   vnet_hash_fn_t hash_fn;
+  /* applied to hash before selecting worker, emulates hw rss redirection
+   * table of given size with default round-robin queue assignment */
+  u32 hash_mask;
   uword *workers_bitmap;
   u32 *workers;
 } per_inteface_handoff_data_t;
@@ -135,6 +138,7 @@ VLIB_NODE_FN (worker_handoff_node) (vlib_main_t * vm,
       /* Compute ingress LB hash */
       data = vlib_buffer_get_current (b[0]);
       ihd0->hash_fn (&data, &hash, 1);
+      hash &= ihd0->hash_mask;
 
       /* if input node did not specify next index, then packet
          should go to ethernet-input */
@@ -185,6 +189,7 @@ VLIB_REGISTER_NODE (worker_handoff_node) = {
 int
 interface_handoff_enable_disable (vlib_main_t *vm, u32 sw_if_index,
 				  uword *bitmap, u8 is_sym, int is_l4,
+				  const char *hash_name, u32 reta_size,
 				  int enable_disable)
 {
   handoff_main_t *hm = &handoff_main;
@@ -203,6 +208,13 @@ interface_handoff_enable_disable (vlib_main_t *vm, u32 sw_if_index,
   if (clib_bitmap_last_set (bitmap) >= hm->num_workers)
     return VNET_API_ERROR_INVALID_WORKER;
 
+  if (reta_size && !is_pow2 (reta_size))
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  if (hash_name &&
+      !vnet_hash_function_from_name (hash_name, VNET_HASH_FN_TYPE_ETHERNET))
+    return VNET_API_ERROR_NO_SUCH_ENTRY;
+
   if (hm->frame_queue_index == ~0)
     {
       vlib_node_t *n = vlib_get_node_by_name (vm, (u8 *) "ethernet-input");
@@ -223,7 +235,12 @@ interface_handoff_enable_disable (vlib_main_t *vm, u32 sw_if_index,
 	  vec_add1(d->workers, i);
 	}
 
-      if (is_sym)
+      d->hash_mask = reta_size ? reta_size - 1 : ~0;
+
+      if (hash_name)
+	d->hash_fn = vnet_hash_function_from_name (hash_name,
+						   VNET_HASH_FN_TYPE_ETHERNET);
+      else if (is_sym)
 	{
 	  if (is_l4)
 	    return VNET_API_ERROR_UNIMPLEMENTED;
@@ -254,8 +271,9 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
 				  unformat_input_t * input,
 				  vlib_cli_command_t * cmd)
 {
-  u32 sw_if_index = ~0, is_sym = 0, is_l4 = 0;
+  u32 sw_if_index = ~0, is_sym = 0, is_l4 = 0, reta_size = 0;
   int enable_disable = 1;
+  u8 *hash_name = 0;
   uword *bitmap = 0;
   int rv = 0;
 
@@ -274,6 +292,10 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
 	is_sym = 0;
       else if (unformat (input, "l4"))
 	is_l4 = 1;
+      else if (unformat (input, "hash %s", &hash_name))
+	;
+      else if (unformat (input, "reta-size %u", &reta_size))
+	;
       else
 	break;
     }
@@ -285,7 +307,9 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
     return clib_error_return (0, "Please specify list of workers...");
 
   rv = interface_handoff_enable_disable (vm, sw_if_index, bitmap, is_sym,
-					 is_l4, enable_disable);
+					 is_l4, (char *) hash_name, reta_size,
+					 enable_disable);
+  vec_free (hash_name);
 
   switch (rv)
     {
@@ -300,6 +324,14 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
       return clib_error_return (0, "Invalid worker(s)");
       break;
 
+    case VNET_API_ERROR_INVALID_VALUE:
+      return clib_error_return (0, "reta-size must be power of 2");
+      break;
+
+    case VNET_API_ERROR_NO_SUCH_ENTRY:
+      return clib_error_return (0, "Unknown hash function");
+      break;
+
     case VNET_API_ERROR_UNIMPLEMENTED:
       return clib_error_return (0,
 				"Device driver doesn't support redirection");
@@ -315,7 +347,7 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
 VLIB_CLI_COMMAND (set_interface_handoff_command, static) = {
   .path = "set interface handoff",
   .short_help = "set interface handoff <interface-name> workers <workers-list>"
-		" [symmetrical|asymmetrical]",
+		" [symmetrical|asymmetrical] [hash <name>] [reta-size <n>]",
   .function = set_interface_handoff_command_fn,
 };
 
@@ -0,0 +1,200 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vnet/hash/hash.h>
+#include <vppinfra/vector/toeplitz.h>
+
+/*
+ * Software RSS hash. Input tuple is built the same way NICs do it
+ * (src addr, dst addr, src port, dst port, ports only for non-fragmented
+ * TCP/UDP/SCTP) so with the same key the result is bit-identical to
+ * hardware RSS hash. "toeplitz" uses the default (Microsoft) key,
+ * "toeplitz-sym" uses the 0x6d5a repeating key which produces the same
+ * hash for both directions of the flow.
+ */
+
+#define TOEPLITZ_MAX_TUPLE_SIZE 36
+
+static clib_toeplitz_hash_key_t *toeplitz_key, *toeplitz_sym_key;
+
+static_always_inline u32
+toeplitz_tuple_ip4 (ip4_header_t *ip4, u8 *t)
+{
+  u8 pr = ip4->protocol;
+
+  clib_memcpy_fast (t, &ip4->address_pair, 8);
+
+  if (ip4_is_fragment (ip4) ||
+      (pr != IP_PROTOCOL_TCP && pr != IP_PROTOCOL_UDP &&
+       pr != IP_PROTOCOL_SCTP))
+    return 8;
+
+  *(u32u *) (t + 8) = *(u32u *) ip4_next_header (ip4);
+  return 12;
+}
+
+static_always_inline u32
+toeplitz_tuple_ip6 (ip6_header_t *ip6, u8 *t)
+{
+  u8 pr = ip6->protocol;
+
+  clib_memcpy_fast (t, &ip6->src_address, 32);
+
+  if (pr != IP_PROTOCOL_TCP && pr != IP_PROTOCOL_UDP &&
+      pr != IP_PROTOCOL_SCTP)
+    return 32;
+
+  *(u32u *) (t + 32) = *(u32u *) ip6_next_header (ip6);
+  return 36;
+}
+
+static_always_inline u32
+toeplitz_tuple_ethernet (void *p, u8 *t)
+{
+  ethernet_header_t *eth = p;
+  ethernet_vlan_header_t *vlan;
+  u16 *ethertype_p = &eth->type;
+
+  if (ethernet_frame_is_tagged (clib_net_to_host_u16 (*ethertype_p)))
+    {
+      vlan = (void *) (eth + 1);
+      ethertype_p = &vlan->type;
+      if (*ethertype_p == clib_host_to_net_u16 (ETHERNET_TYPE_VLAN))
+	{
+	  vlan++;
+	  ethertype_p = &vlan->type;
+	}
+    }
+
+  if (*ethertype_p == clib_host_to_net_u16 (ETHERNET_TYPE_IP4))
+    return toeplitz_tuple_ip4 ((ip4_header_t *) (ethertype_p + 1), t);
+  if (*ethertype_p == clib_host_to_net_u16 (ETHERNET_TYPE_IP6))
+    return toeplitz_tuple_ip6 ((ip6_header_t *) (ethertype_p + 1), t);
+  return 0;
+}
+
+static_always_inline u32
+toeplitz_tuple_ip (void *p, u8 *t)
+{
+  if ((((u8 *) p)[0] & 0xf0) == 0x40)
+    return toeplitz_tuple_ip4 (p, t);
+  if ((((u8 *) p)[0] & 0xf0) == 0x60)
+    return toeplitz_tuple_ip6 (p, t);
+  return 0;
+}
+
+static_always_inline u32
+toeplitz_hash_one (clib_toeplitz_hash_key_t *k, u8 *t, u32 len)
+{
+  return len ? clib_toeplitz_hash (k, t, len) : 0;
+}
+
+static_always_inline void
+toeplitz_hash_inline (clib_toeplitz_hash_key_t *k, void **p, u32 *hash,
+		      u32 n_packets, int is_ip)
+{
+  u8 t[4][TOEPLITZ_MAX_TUPLE_SIZE];
+  u32 len[4];
+
+  while (n_packets >= 4)
+    {
+      if (n_packets >= 8)
+	{
+	  clib_prefetch_load (p[4]);
+	  clib_prefetch_load (p[5]);
+	  clib_prefetch_load (p[6]);
+	  clib_prefetch_load (p[7]);
+	}
+
+      for (int i = 0; i < 4; i++)
+	len[i] = is_ip ? toeplitz_tuple_ip (p[i], t[i]) :
+			 toeplitz_tuple_ethernet (p[i], t[i]);
+
+      /* common case of same flow type, hash all 4 tuples at once */
+      if (len[0] && len[0] == len[1] && len[0] == len[2] && len[0] == len[3])
+	clib_toeplitz_hash_x4 (k, t[0], t[1], t[2], t[3], hash, hash + 1,
+			       hash + 2, hash + 3, len[0]);
+      else
+	for (int i = 0; i < 4; i++)
+	  hash[i] = toeplitz_hash_one (k, t[i], len[i]);
+
+      hash += 4;
+      n_packets -= 4;
+      p += 4;
+    }
+
+  while (n_packets > 0)
+    {
+      len[0] = is_ip ? toeplitz_tuple_ip (p[0], t[0]) :
+		       toeplitz_tuple_ethernet (p[0], t[0]);
+      hash[0] = toeplitz_hash_one (k, t[0], len[0]);
+
+      hash += 1;
+      n_packets -= 1;
+      p += 1;
+    }
+}
+
+static void
+vnet_toeplitz_ethernet_func (void **p, u32 *hash, u32 n_packets)
+{
+  toeplitz_hash_inline (toeplitz_key, p, hash, n_packets, 0);
+}
+
+static void
+vnet_toeplitz_ip_func (void **p, u32 *hash, u32 n_packets)
+{
+  toeplitz_hash_inline (toeplitz_key, p, hash, n_packets, 1);
+}
+
+static void
+vnet_toeplitz_sym_ethernet_func (void **p, u32 *hash, u32 n_packets)
+{
+  toeplitz_hash_inline (toeplitz_sym_key, p, hash, n_packets, 0);
+}
+
+static void
+vnet_toeplitz_sym_ip_func (void **p, u32 *hash, u32 n_packets)
+{
+  toeplitz_hash_inline (toeplitz_sym_key, p, hash, n_packets, 1);
+}
+
+VNET_REGISTER_HASH_FUNCTION (toeplitz, static) = {
+  .name = "toeplitz",
+  .description = "RSS Toeplitz hash with default key",
+  .priority = 20,
+  .function[VNET_HASH_FN_TYPE_ETHERNET] = vnet_toeplitz_ethernet_func,
+  .function[VNET_HASH_FN_TYPE_IP] = vnet_toeplitz_ip_func,
+};
+
+VNET_REGISTER_HASH_FUNCTION (toeplitz_sym, static) = {
+  .name = "toeplitz-sym",
+  .description = "RSS Toeplitz hash with symmetric key",
+  .priority = 20,
+  .function[VNET_HASH_FN_TYPE_ETHERNET] = vnet_toeplitz_sym_ethernet_func,
+  .function[VNET_HASH_FN_TYPE_IP] = vnet_toeplitz_sym_ip_func,
+};
+
+static clib_error_t *
+vnet_hash_toeplitz_init (vlib_main_t *vm)
+{
+  u8 key[TOEPLITZ_MAX_TUPLE_SIZE + 4];
+
+  for (int i = 0; i < sizeof (key); i += 2)
+    {
+      key[i] = 0x6d;
+      key[i + 1] = 0x5a;
+    }
+
+  toeplitz_key = clib_toeplitz_hash_key_init (0, 0);
+  toeplitz_sym_key = clib_toeplitz_hash_key_init (key, sizeof (key));
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (vnet_hash_toeplitz_init);
@@ -1881,6 +1881,47 @@ done:
   return error;
 }
 
+clib_error_t *
+vnet_hw_interface_get_rss_reta (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+				u16 **reta)
+{
+  vnet_device_class_t *dev_class =
+    vnet_get_device_class (vnm, hi->dev_class_index);
+
+  if (dev_class->get_rss_reta_function == 0)
+    return clib_error_return (
+      0, "reading rss indirection table is not supported on this interface");
+
+  vec_reset_length (*reta);
+  return dev_class->get_rss_reta_function (vnm, hi, reta);
+}
+
+/*
+ * Rewrite rss indirection table. 'reta' holds one entry per hash bucket,
+ * entries set to VNET_RSS_RETA_ENTRY_UNCHANGED are not modified, so only
+ * buckets which move to another queue need to be given.
+ */
+clib_error_t *
+vnet_hw_interface_set_rss_reta (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+				u16 *reta)
+{
+  clib_error_t *error = 0;
+  vnet_device_class_t *dev_class =
+    vnet_get_device_class (vnm, hi->dev_class_index);
+
+  if (dev_class->set_rss_reta_function == 0)
+    error = clib_error_return (
+      0, "setting rss indirection table is not supported on this interface");
+  else if (vec_len (reta) == 0)
+    error = clib_error_return (0, "empty rss indirection table");
+  else
+    error = dev_class->set_rss_reta_function (vnm, hi, reta);
+
+  if (error)
+    log_err ("hw_set_rss_reta: %U", format_clib_error, error);
+  return error;
+}
+
 int collect_detailed_interface_stats_flag = 0;
 
 void
@@ -98,6 +98,17 @@ typedef clib_error_t *(vnet_interface_rss_queues_set_t)
   (struct vnet_main_t * vnm, struct vnet_hw_interface_t * hi,
    clib_bitmap_t * bitmap);
 
+/* RSS indirection table entry left untouched by set_rss_reta_function */
+#define VNET_RSS_RETA_ENTRY_UNCHANGED ((u16) ~0)
+
+/* Interface to read rss indirection table (queue per hash bucket) */
+typedef clib_error_t *(vnet_interface_rss_reta_get_t) (
+  struct vnet_main_t *vnm, struct vnet_hw_interface_t *hi, u16 **reta);
+
+/* Interface to rewrite rss indirection table entries at runtime */
+typedef clib_error_t *(vnet_interface_rss_reta_set_t) (
+  struct vnet_main_t *vnm, struct vnet_hw_interface_t *hi, u16 *reta);
+
 typedef enum
 {
   VNET_FLOW_DEV_OP_ADD_FLOW,
@@ -306,6 +317,10 @@ typedef struct _vnet_device_class
   /* Interface to set rss queues of the interface */
   vnet_interface_rss_queues_set_t *set_rss_queues_function;
 
+  /* Interface to read and rewrite rss indirection table */
+  vnet_interface_rss_reta_get_t *get_rss_reta_function;
+  vnet_interface_rss_reta_set_t *set_rss_reta_function;
+
 } vnet_device_class_t;
 
 u32 vnet_register_device_class (vlib_main_t *, vnet_device_class_t *);
@@ -565,6 +580,8 @@ typedef enum vnet_hw_interface_flags_t_
   _ (16, UDP_TNL_GSO, "udp-tnl-gso")                                          \
   _ (17, IP_TNL_GSO, "ip-tnl-gso")                                            \
   _ (18, TCP_LRO, "tcp-lro")                                                  \
+  _ (19, RX_IPSEC_INLINE, "ipsec-inline-rx")                                  \
+  _ (20, TX_IPSEC_INLINE, "ipsec-inline-tx")                                  \
   _ (30, INT_MODE, "int-mode")                                                \
   _ (31, MAC_FILTER, "mac-filter")
 
@@ -1114,6 +1131,8 @@ typedef struct
   u32 sw_if_index;
   int filter;
   vlib_error_t drop_err;
+  u8 per_worker;
+  u32 rotate_files;
 } vnet_pcap_dispatch_trace_args_t;
 
 int vnet_pcap_dispatch_trace_configure (vnet_pcap_dispatch_trace_args_t *);
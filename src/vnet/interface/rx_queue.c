@@ -26,22 +26,65 @@ VLIB_REGISTER_LOG_CLASS (if_rxq_log, static) = {
 #define log_debug(fmt, ...) vlib_log_debug (if_rxq_log.class, fmt, __VA_ARGS__)
 #define log_err(fmt, ...)   vlib_log_err (if_rxq_log.class, fmt, __VA_ARGS__)
 
+/*
+ * Pick a worker for a queue registered without one. Prefer workers on
+ * the interface's NUMA node, then the worker polling the fewest queues,
+ * then the one whose SMT siblings poll the fewest queues.
+ */
 static u32
-next_thread_index (vnet_main_t *vnm, clib_thread_index_t thread_index)
+next_thread_index (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+		   clib_thread_index_t thread_index)
 {
+  vnet_interface_main_t *im = &vnm->interface_main;
   vnet_device_main_t *vdm = &vnet_device_main;
+  vnet_hw_if_rx_queue_t *rxq;
+  vlib_worker_thread_t *w, *ow;
+  u32 *n_queues = 0, best = ~0, best_local = 0, best_n = 0, best_core_n = 0;
+  u32 ti, oti, n_core;
+  int local;
+
   if (vdm->first_worker_thread_index == 0)
     return 0;
 
-  if (thread_index != 0 && (thread_index < vdm->first_worker_thread_index ||
-			    thread_index > vdm->last_worker_thread_index))
+  if (thread_index == 0 || (thread_index >= vdm->first_worker_thread_index &&
+			    thread_index <= vdm->last_worker_thread_index))
+    return thread_index;
+
+  vec_validate (n_queues, vdm->last_worker_thread_index);
+  pool_foreach (rxq, im->hw_if_rx_queues)
+    if (rxq->thread_index <= vdm->last_worker_thread_index)
+      n_queues[rxq->thread_index]++;
+
+  for (ti = vdm->first_worker_thread_index;
+       ti <= vdm->last_worker_thread_index; ti++)
     {
-      thread_index = vdm->next_worker_thread_index++;
-      if (vdm->next_worker_thread_index > vdm->last_worker_thread_index)
-	vdm->next_worker_thread_index = vdm->first_worker_thread_index;
+      w = vlib_worker_threads + ti;
+      local = w->numa_id == hi->numa_node;
+
+      n_core = 0;
+      for (oti = vdm->first_worker_thread_index;
+	   oti <= vdm->last_worker_thread_index; oti++)
+	{
+	  ow = vlib_worker_threads + oti;
+	  if (oti != ti && ow->core_id == w->core_id &&
+	      ow->numa_id == w->numa_id)
+	    n_core += n_queues[oti];
+	}
+
+      if (best == ~0 || local > best_local ||
+	  (local == best_local &&
+	   (n_queues[ti] < best_n ||
+	    (n_queues[ti] == best_n && n_core < best_core_n))))
+	{
+	  best = ti;
+	  best_local = local;
+	  best_n = n_queues[ti];
+	  best_core_n = n_core;
+	}
     }
 
-  return thread_index;
+  vec_free (n_queues);
+  return best;
 }
 
 static u64
@@ -75,7 +118,7 @@ vnet_hw_if_register_rx_queue (vnet_main_t *vnm, u32 hw_if_index, u32 queue_id,
 		"interface %v\n",
 		queue_id, hi->name);
 
-  thread_index = next_thread_index (vnm, thread_index);
+  thread_index = next_thread_index (vnm, hi, thread_index);
 
   pool_get_zero (im->hw_if_rx_queues, rxq);
   queue_index = rxq - im->hw_if_rx_queues;
@@ -1649,6 +1649,8 @@ vl_api_pcap_trace_on_t_handler (vl_api_pcap_trace_on_t *mp)
   capture_args.filter = mp->filter;
   capture_args.max_bytes_per_pkt = ntohl (mp->max_bytes_per_packet);
   capture_args.drop_err = ~0;
+  capture_args.per_worker = 0;
+  capture_args.rotate_files = 0;
 
   unformat_init_cstring (&drop_err_name, (char *) mp->error);
   unformat_user (&drop_err_name, unformat_vlib_error, vlib_get_main (),
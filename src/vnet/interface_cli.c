@@ -1486,6 +1486,7 @@ set_hw_interface_change_rx_mode (vnet_main_t * vnm, u32 hw_if_index,
 			VNET_DEV_PORT_CFG_RXQ_INTR_MODE_ENABLE,
 	.queue_id = queue_id_valid ? queue_id : 0,
 	.all_queues = queue_id_valid ? 0 : 1,
+	.adaptive = mode == VNET_HW_IF_RX_MODE_ADAPTIVE,
       };
 
       if ((rv = vnet_dev_port_cfg_change_req_validate (vm, port, &req)))
@@ -2014,6 +2015,123 @@ VLIB_CLI_COMMAND (cmd_set_interface_rss_queues,static) = {
     .function = set_interface_rss_queues_fn,
 };
 
+static clib_error_t *
+set_interface_rss_reta_fn (vlib_main_t *vm, unformat_input_t *input,
+			   vlib_cli_command_t *cmd)
+{
+  clib_error_t *error = 0;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 hw_if_index = (u32) ~0;
+  u32 first = ~0, last = ~0, queue = ~0;
+  u16 *reta = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%U", unformat_vnet_hw_interface, vnm,
+		    &hw_if_index))
+	;
+      else if (unformat (line_input, "index %u-%u", &first, &last))
+	;
+      else if (unformat (line_input, "index %u", &first))
+	last = first;
+      else if (unformat (line_input, "queue %u", &queue))
+	;
+      else
+	{
+	  error = clib_error_return (0, "parse error: '%U'",
+				     format_unformat_error, line_input);
+	  unformat_free (line_input);
+	  goto done;
+	}
+    }
+
+  unformat_free (line_input);
+
+  if (hw_if_index == (u32) ~0)
+    {
+      error = clib_error_return (0, "please specify valid interface name");
+      goto done;
+    }
+
+  if (first == ~0 || last < first || queue == ~0)
+    {
+      error = clib_error_return (0, "please specify index range and queue");
+      goto done;
+    }
+
+  vec_validate_init_empty (reta, last, VNET_RSS_RETA_ENTRY_UNCHANGED);
+  for (u32 i = first; i <= last; i++)
+    reta[i] = queue;
+
+  error = vnet_hw_interface_set_rss_reta (
+    vnm, vnet_get_hw_interface (vnm, hw_if_index), reta);
+
+done:
+  vec_free (reta);
+  return error;
+}
+
+/*?
+ * This command is used to move rss hash buckets between rx queues by
+ * rewriting entries of the rss indirection table (RETA) of a given
+ * interface, without restarting it. Not all the interfaces support this
+ * operation. The current table can be displayed with
+ * '<em>show interface rss reta</em>'.
+ *
+ * @cliexpar
+ * Example of how to steer hash buckets 0 to 15 to rx queue 3:
+ * @cliexcmd{set interface rss reta VirtualFunctionEthernet18/1/0 index 0-15
+ * queue 3}
+?*/
+VLIB_CLI_COMMAND (cmd_set_interface_rss_reta, static) = {
+  .path = "set interface rss reta",
+  .short_help =
+    "set interface rss reta <interface> index <n>[-<m>] queue <queue-id>",
+  .function = set_interface_rss_reta_fn,
+};
+
+static clib_error_t *
+show_interface_rss_reta_fn (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 hw_if_index = (u32) ~0;
+  clib_error_t *error;
+  u16 *reta = 0;
+  u32 i;
+
+  if (!unformat (input, "%U", unformat_vnet_hw_interface, vnm, &hw_if_index))
+    return clib_error_return (0, "please specify valid interface name");
+
+  error = vnet_hw_interface_get_rss_reta (
+    vnm, vnet_get_hw_interface (vnm, hw_if_index), &reta);
+  if (error)
+    return error;
+
+  vlib_cli_output (vm, "%u entries", vec_len (reta));
+  for (i = 0; i < vec_len (reta); i += 16)
+    {
+      u8 *s = format (0, "%5u:", i);
+      for (u32 j = i; j < clib_min (i + 16, vec_len (reta)); j++)
+	s = format (s, " %3u", reta[j]);
+      vlib_cli_output (vm, "%v", s);
+      vec_free (s);
+    }
+
+  vec_free (reta);
+  return 0;
+}
+
+VLIB_CLI_COMMAND (cmd_show_interface_rss_reta, static) = {
+  .path = "show interface rss reta",
+  .short_help = "show interface rss reta <interface>",
+  .function = show_interface_rss_reta_fn,
+};
+
 static u8 *
 format_vnet_pcap (u8 * s, va_list * args)
 {
@@ -2055,6 +2173,97 @@ format_vnet_pcap (u8 * s, va_list * args)
 }
 
 
+static clib_error_t *
+vnet_pcap_worker_file_open (vnet_pcap_t *pp, u32 thread_index)
+{
+  mpcap_main_t *mp = vec_elt_at_index (pp->worker_mpcaps, thread_index);
+  u32 seq = pp->worker_file_seq[thread_index];
+
+  vec_free (mp->file_name);
+  if (pp->pcap_rotate_files > 1)
+    mp->file_name =
+      (char *) format (0, "%v-w%u-%u.pcap%c", pp->pcap_file_stem,
+		       thread_index, seq % pp->pcap_rotate_files, 0);
+  else
+    mp->file_name = (char *) format (0, "%v-w%u.pcap%c", pp->pcap_file_stem,
+				     thread_index, 0);
+
+  mp->packet_type = PCAP_PACKET_TYPE_ethernet;
+  mp->n_packets_to_capture = pp->pcap_main.n_packets_to_capture;
+  mp->max_file_size =
+    sizeof (mpcap_file_header_t) +
+    (u64) mp->n_packets_to_capture *
+      (sizeof (mpcap_packet_header_t) + pp->max_bytes_per_pkt);
+
+  return mpcap_init (mp);
+}
+
+/*
+ * Called by a worker when its current file is full: start the next file
+ * of the rotation or, without rotation, stop capturing on this worker.
+ * Only the calling worker's file is touched.
+ */
+void
+vnet_pcap_worker_file_next (vnet_pcap_t *pp, u32 thread_index)
+{
+  mpcap_main_t *mp = vec_elt_at_index (pp->worker_mpcaps, thread_index);
+  clib_error_t *error;
+
+  mpcap_close (mp);
+  if (pp->pcap_rotate_files <= 1)
+    return;
+
+  pp->worker_file_seq[thread_index]++;
+  if ((error = vnet_pcap_worker_file_open (pp, thread_index)))
+    clib_error_report (error);
+}
+
+static int
+vnet_pcap_worker_files_init (vnet_pcap_t *pp, u8 *filename, u32 rotate_files)
+{
+  u32 i, n_threads = vlib_get_n_threads ();
+  clib_error_t *error;
+  u32 len = strlen ((char *) filename);
+
+  /* /tmp/rx.pcap -> /tmp/rx-w<thread>[-<seq>].pcap */
+  if (len > 5 && !strcmp ((char *) filename + len - 5, ".pcap"))
+    len -= 5;
+  vec_reset_length (pp->pcap_file_stem);
+  vec_add (pp->pcap_file_stem, filename, len);
+
+  pp->pcap_rotate_files = rotate_files;
+  vec_validate (pp->worker_mpcaps, n_threads - 1);
+  vec_validate (pp->worker_file_seq, n_threads - 1);
+
+  for (i = 0; i < n_threads; i++)
+    {
+      pp->worker_file_seq[i] = 0;
+      if ((error = vnet_pcap_worker_file_open (pp, i)))
+	{
+	  clib_error_report (error);
+	  while (i--)
+	    mpcap_close (vec_elt_at_index (pp->worker_mpcaps, i));
+	  return VNET_API_ERROR_SYSCALL_ERROR_2;
+	}
+    }
+  return 0;
+}
+
+static u32
+vnet_pcap_worker_files_close (vnet_pcap_t *pp)
+{
+  mpcap_main_t *mp;
+  u32 n_captured = 0;
+
+  vec_foreach (mp, pp->worker_mpcaps)
+    {
+      n_captured += mp->n_packets_captured;
+      mpcap_close (mp);
+      vec_free (mp->file_name);
+    }
+  return n_captured;
+}
+
 int
 vnet_pcap_dispatch_trace_configure (vnet_pcap_dispatch_trace_args_t * a)
 {
@@ -2072,7 +2281,18 @@ vnet_pcap_dispatch_trace_configure (vnet_pcap_dispatch_trace_args_t * a)
 	    (vm, "pcap %U dispatch capture enabled: %d of %d pkts...",
 	     format_vnet_pcap, pp, 0 /* print type */ ,
 	     pm->n_packets_captured, pm->n_packets_to_capture);
-	  vlib_cli_output (vm, "capture to file %s", pm->file_name);
+	  if (pp->pcap_per_worker)
+	    {
+	      mpcap_main_t *mp;
+	      vec_foreach (mp, pp->worker_mpcaps)
+		vlib_cli_output (vm, "  %s: %u of %u pkts%s", mp->file_name,
+				 mp->n_packets_captured,
+				 mp->n_packets_to_capture,
+				 mp->flags & MPCAP_FLAG_INIT_DONE ? "" :
+								    " (full)");
+	    }
+	  else
+	    vlib_cli_output (vm, "capture to file %s", pm->file_name);
 	}
       else
 	vlib_cli_output (vm, "pcap dispatch capture disabled");
@@ -2160,10 +2380,19 @@ vnet_pcap_dispatch_trace_configure (vnet_pcap_dispatch_trace_args_t * a)
 	pp->filter_classify_table_index = ~0;
       pp->pcap_filter_enable = a->filter;
       pp->pcap_error_index = a->drop_err;
+      pp->max_bytes_per_pkt = a->max_bytes_per_pkt;
+      pp->pcap_per_worker = 0;
+      if (a->per_worker)
+	{
+	  int rv = vnet_pcap_worker_files_init (pp, a->filename,
+						a->rotate_files);
+	  if (rv)
+	    return rv;
+	  pp->pcap_per_worker = 1;
+	}
       pp->pcap_rx_enable = a->rx_enable;
       pp->pcap_tx_enable = a->tx_enable;
       pp->pcap_drop_enable = a->drop_enable;
-      pp->max_bytes_per_pkt = a->max_bytes_per_pkt;
     }
   else
     {
@@ -2173,6 +2402,15 @@ vnet_pcap_dispatch_trace_configure (vnet_pcap_dispatch_trace_args_t * a)
       pp->pcap_drop_enable = 0;
       pp->filter_classify_table_index = ~0;
       pp->pcap_error_index = ~0;
+      if (pp->pcap_per_worker)
+	{
+	  u32 n_captured = vnet_pcap_worker_files_close (pp);
+	  pp->pcap_per_worker = 0;
+	  vlib_cli_output (vm, "Wrote %u packets to %v-w*.pcap, stop capture...",
+			   n_captured, pp->pcap_file_stem);
+	  vec_free (pm->file_name);
+	  return 0;
+	}
       if (pm->n_packets_captured)
 	{
 	  clib_error_t *error;
@@ -2218,6 +2456,8 @@ pcap_trace_command_fn (vlib_main_t * vm,
   int status = 0;
   int filter = 0;
   int free_data = 0;
+  int per_worker = 0;
+  u32 rotate_files = 0;
   u32 sw_if_index = 0;		/* default: any interface */
   vlib_error_t drop_err = ~0;	/* default: any error */
 
@@ -2261,6 +2501,10 @@ pcap_trace_command_fn (vlib_main_t * vm,
 	;
       else if (unformat (line_input, "free-data %=", &free_data, 1))
 	;
+      else if (unformat (line_input, "per-worker"))
+	per_worker = 1;
+      else if (unformat (line_input, "rotate %u", &rotate_files))
+	per_worker = 1;
       else if (unformat (line_input, "intfc any")
 	       || unformat (line_input, "interface any"))
 	sw_if_index = 0;
@@ -2288,6 +2532,8 @@ pcap_trace_command_fn (vlib_main_t * vm,
   a->filter = filter;
   a->max_bytes_per_pkt = max_bytes_per_pkt;
   a->drop_err = drop_err;
+  a->per_worker = per_worker;
+  a->rotate_files = rotate_files;
 
   rv = vnet_pcap_dispatch_trace_configure (a);
 
@@ -2309,6 +2555,9 @@ pcap_trace_command_fn (vlib_main_t * vm,
     case VNET_API_ERROR_SYSCALL_ERROR_1:
       return clib_error_return (0, "I/O writing trace capture...");
 
+    case VNET_API_ERROR_SYSCALL_ERROR_2:
+      return clib_error_return (0, "failed to create per-worker files...");
+
     case VNET_API_ERROR_NO_SUCH_ENTRY:
       return clib_error_return (0, "No packets captured...");
 
@@ -2374,6 +2623,15 @@ pcap_trace_command_fn (vlib_main_t * vm,
  *   named "/tmp/rx.pcap", "/tmp/tx.pcap", "/tmp/rxandtx.pcap", etc.
  *   Can only be updated if packet capture is off.
  *
+ * - <b>per-worker</b> - Each thread writes its packets directly to its own
+ *   mmapped file, named after '<em>file</em>' as e.g. "/tmp/rx-w1.pcap",
+ *   without a shared buffer or lock. '<em>max</em>' applies per file and
+ *   nothing is written out when the capture is stopped.
+ *
+ * - <b>rotate <nn></b> - Implies per-worker. Once a thread's file is full
+ *   continue with the next of '<em>nn</em>' files, "/tmp/rx-w1-0.pcap",
+ *   "/tmp/rx-w1-1.pcap", ..., overwriting the oldest one.
+ *
  * - <b>status</b> - Displays the current status and configured attributes
  *   associated with a packet capture. If packet capture is in progress,
  *   '<em>status</em>' also will return the number of packets currently in
@@ -2407,7 +2665,7 @@ VLIB_CLI_COMMAND (pcap_tx_trace_command, static) = {
     .short_help =
     "pcap trace [rx] [tx] [drop] [off] [max <nn>] [intfc <interface>|any]\n"
     "           [file <name>] [status] [max-bytes-per-pkt <nnnn>][filter]\n"
-    "           [preallocate-data][free-data]",
+    "           [preallocate-data][free-data][per-worker][rotate <nn>]",
     .function = pcap_trace_command_fn,
 };
 
@@ -677,7 +677,7 @@ u8 *
 format_vnet_buffer_opaque2 (u8 * s, va_list * args)
 {
   vlib_buffer_t *b = va_arg (*args, vlib_buffer_t *);
-  vnet_buffer_opaque2_t *o = (vnet_buffer_opaque2_t *) b->opaque2;
+  vnet_buffer_opaque2_t *o = vlib_get_buffer_opaque2 (b);
   vnet_interface_main_t *im = &vnet_get_main ()->interface_main;
   vnet_buffer_opquae_formatter_t helper_fp;
 
@@ -685,8 +685,8 @@ format_vnet_buffer_opaque2 (u8 * s, va_list * args)
 
   s = format (s, "raw: ");
 
-  for (i = 0; i < ARRAY_LEN (b->opaque2); i++)
-    s = format (s, "%08x ", b->opaque2[i]);
+  for (i = 0; i < ARRAY_LEN (vlib_buffer_cold (b)->opaque2); i++)
+    s = format (s, "%08x ", vlib_buffer_cold (b)->opaque2[i]);
   vec_add1 (s, '\n');
 
   s = format (s, "qos.bits: %x, qos.source: %x",
@@ -458,6 +458,14 @@ clib_error_t *vnet_hw_interface_set_rss_queues (vnet_main_t * vnm,
 						vnet_hw_interface_t * hi,
 						clib_bitmap_t * bitmap);
 
+/* get and update interface rss indirection table */
+clib_error_t *vnet_hw_interface_get_rss_reta (vnet_main_t *vnm,
+					      vnet_hw_interface_t *hi,
+					      u16 **reta);
+clib_error_t *vnet_hw_interface_set_rss_reta (vnet_main_t *vnm,
+					      vnet_hw_interface_t *hi,
+					      u16 *reta);
+
 void vnet_hw_if_update_runtime_data (vnet_main_t *vnm, u32 hw_if_index);
 
 /* Formats sw/hw interface. */
@@ -567,6 +575,80 @@ pcap_add_buffer (pcap_main_t *pm, struct vlib_main_t *vm, u32 buffer_index,
     }
 }
 
+void vnet_pcap_worker_file_next (vnet_pcap_t *pp, u32 thread_index);
+
+/**
+ * @brief Add buffer to the dispatch pcap capture
+ *
+ * In per-worker mode the packet goes straight into the calling thread's
+ * mmapped file, truncated to max_bytes_per_pkt, without taking any lock.
+ *
+ * @param *pp - vnet_pcap_t
+ * @param *vm - vlib_main_t
+ * @param buffer_index - u32
+ *
+ */
+static inline void
+vnet_pcap_add_buffer (vnet_pcap_t *pp, struct vlib_main_t *vm,
+		      u32 buffer_index)
+{
+  mpcap_main_t *mp;
+  mpcap_packet_header_t *h;
+  vlib_buffer_t *b;
+  f64 time_now;
+  i32 n_left;
+  u32 n;
+  u8 *d;
+
+  if (PREDICT_TRUE (!pp->pcap_per_worker))
+    {
+      pcap_add_buffer (&pp->pcap_main, vm, buffer_index,
+		       pp->max_bytes_per_pkt);
+      return;
+    }
+
+  mp = vec_elt_at_index (pp->worker_mpcaps, vm->thread_index);
+  if (PREDICT_FALSE ((mp->flags & MPCAP_FLAG_INIT_DONE) == 0))
+    return;
+
+  b = vlib_get_buffer (vm, buffer_index);
+  n = vlib_buffer_length_in_chain (vm, b);
+  n_left = clib_min (pp->max_bytes_per_pkt, n);
+
+  if (PREDICT_FALSE (mp->current_va + sizeof (h[0]) + n_left >
+		     mp->file_baseva + mp->max_file_size))
+    {
+      vnet_pcap_worker_file_next (pp, vm->thread_index);
+      if ((mp->flags & MPCAP_FLAG_INIT_DONE) == 0)
+	return;
+    }
+
+  time_now = vlib_time_now (vm) + vm->clib_time.init_reference_time;
+  h = (mpcap_packet_header_t *) mp->current_va;
+  mp->current_va += sizeof (h[0]) + n_left;
+  h->time_in_sec = time_now;
+  h->time_in_usec = 1e6 * (time_now - h->time_in_sec);
+  h->n_packet_bytes_stored_in_file = n_left;
+  h->n_bytes_in_packet = n;
+  mp->n_packets_captured++;
+
+  d = h->data;
+  while (1)
+    {
+      u32 copy_length = clib_min ((u32) n_left, b->current_length);
+      clib_memcpy_fast (d, b->data + b->current_data, copy_length);
+      n_left -= b->current_length;
+      if (n_left <= 0)
+	break;
+      d += b->current_length;
+      ASSERT (b->flags & VLIB_BUFFER_NEXT_PRESENT);
+      b = vlib_get_buffer (vm, b->next_buffer);
+    }
+
+  if (PREDICT_FALSE (mp->n_packets_captured >= mp->n_packets_to_capture))
+    vnet_pcap_worker_file_next (pp, vm->thread_index);
+}
+
 typedef struct
 {
   vnet_hw_if_caps_t val;
@@ -185,7 +185,10 @@ vnet_interface_output_node_inline (vlib_main_t *vm, u32 sw_if_index,
 {
   u32 n_bytes = 0;
   u32 n_bytes0, n_bytes1, n_bytes2, n_bytes3;
-  u32 ti = vm->thread_index;
+  vlib_combined_counter_acc_t subif_acc;
+
+  if (processing_level >= 2)
+    vlib_combined_counter_acc_init (&subif_acc, ccm, vm->thread_index);
 
   while (n_left >= 8)
     {
@@ -231,16 +234,16 @@ vnet_interface_output_node_inline (vlib_main_t *vm, u32 sw_if_index,
 
 	  /* update vlan subif tx counts, if required */
 	  if (PREDICT_FALSE (tx_swif0 != sw_if_index))
-	    vlib_increment_combined_counter (ccm, ti, tx_swif0, 1, n_bytes0);
+	    vlib_combined_counter_acc_add (&subif_acc, tx_swif0, 1, n_bytes0);
 
 	  if (PREDICT_FALSE (tx_swif1 != sw_if_index))
-	    vlib_increment_combined_counter (ccm, ti, tx_swif1, 1, n_bytes1);
+	    vlib_combined_counter_acc_add (&subif_acc, tx_swif1, 1, n_bytes1);
 
 	  if (PREDICT_FALSE (tx_swif2 != sw_if_index))
-	    vlib_increment_combined_counter (ccm, ti, tx_swif2, 1, n_bytes2);
+	    vlib_combined_counter_acc_add (&subif_acc, tx_swif2, 1, n_bytes2);
 
 	  if (PREDICT_FALSE (tx_swif3 != sw_if_index))
-	    vlib_increment_combined_counter (ccm, ti, tx_swif3, 1, n_bytes3);
+	    vlib_combined_counter_acc_add (&subif_acc, tx_swif3, 1, n_bytes3);
 
 	  if (PREDICT_FALSE (config_index != ~0))
 	    {
@@ -292,7 +295,7 @@ vnet_interface_output_node_inline (vlib_main_t *vm, u32 sw_if_index,
 	    }
 
 	  if (PREDICT_FALSE (tx_swif0 != sw_if_index))
-	    vlib_increment_combined_counter (ccm, ti, tx_swif0, 1, n_bytes0);
+	    vlib_combined_counter_acc_add (&subif_acc, tx_swif0, 1, n_bytes0);
 	}
 
       if (processing_level >= 1)
@@ -302,6 +305,9 @@ vnet_interface_output_node_inline (vlib_main_t *vm, u32 sw_if_index,
       b += 1;
     }
 
+  if (processing_level >= 2)
+    vlib_combined_counter_acc_flush (&subif_acc);
+
   return n_bytes;
 }
 
@@ -358,7 +364,7 @@ vnet_interface_pcap_tx_trace (vlib_main_t *vm, vlib_node_runtime_t *node,
 	}
 
       if (vnet_is_packet_pcaped (pp, b0, sw_if_index))
-	pcap_add_buffer (&pp->pcap_main, vm, bi0, pp->max_bytes_per_pkt);
+	vnet_pcap_add_buffer (pp, vm, bi0);
     }
 }
 
@@ -1165,7 +1171,7 @@ pcap_drop_trace (vlib_main_t * vm,
 			      error_string_len);
 	    last->current_length += drop_string_len;
 	    b0->flags &= ~(VLIB_BUFFER_TOTAL_LENGTH_VALID);
-	    pcap_add_buffer (&pp->pcap_main, vm, bi0, pp->max_bytes_per_pkt);
+	    vnet_pcap_add_buffer (pp, vm, bi0);
 	    last->current_length -= drop_string_len;
 	    b0->current_data = save_current_data;
 	    b0->current_length = save_current_length;
@@ -1177,7 +1183,7 @@ pcap_drop_trace (vlib_main_t * vm,
        * Didn't have space in the last buffer, here's the dropped
        * packet as-is
        */
-      pcap_add_buffer (&pp->pcap_main, vm, bi0, pp->max_bytes_per_pkt);
+      vnet_pcap_add_buffer (pp, vm, bi0);
 
       b0->current_data = save_current_data;
       b0->current_length = save_current_length;
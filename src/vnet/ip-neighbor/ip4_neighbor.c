@@ -246,8 +246,9 @@ ip4_arp_inline (vlib_main_t * vm,
 	  if (PREDICT_TRUE (NULL != b0))
 	    {
 	      /* copy the persistent fields from the original */
-	      clib_memcpy_fast (b0->opaque2, p0->opaque2,
-				sizeof (p0->opaque2));
+	      clib_memcpy_fast (vlib_buffer_cold (b0)->opaque2,
+				vlib_buffer_cold (p0)->opaque2,
+				STRUCT_SIZE_OF (vlib_buffer_cold_t, opaque2));
 	      p0->error = node->errors[IP4_NEIGHBOR_ERROR_REQUEST_SENT];
 	    }
 	  else
@@ -232,10 +232,12 @@ ip6_discover_neighbor_inline (vlib_main_t * vm,
 
 	  if (PREDICT_TRUE (NULL != b0))
 	    {
-	      clib_memcpy_fast (b0->opaque2, p0->opaque2,
-				sizeof (p0->opaque2));
+	      clib_memcpy_fast (vlib_buffer_cold (b0)->opaque2,
+				vlib_buffer_cold (p0)->opaque2,
+				STRUCT_SIZE_OF (vlib_buffer_cold_t, opaque2));
 	      b0->flags |= p0->flags & VLIB_BUFFER_IS_TRACED;
-	      b0->trace_handle = p0->trace_handle;
+	      vlib_buffer_cold (b0)->trace_handle =
+		vlib_buffer_cold (p0)->trace_handle;
 	      p0->error = node->errors[IP6_NEIGHBOR_ERROR_REQUEST_SENT];
 	    }
 	  else
@@ -1720,11 +1720,13 @@ ip6_neighbor_age_process (vlib_main_t * vm,
 VLIB_REGISTER_NODE (ip4_neighbor_age_process_node,static) = {
   .function = ip4_neighbor_age_process,
   .type = VLIB_NODE_TYPE_PROCESS,
+  .process_priority = VLIB_PROCESS_PRIORITY_LOW,
   .name = "ip4-neighbor-age-process",
 };
 VLIB_REGISTER_NODE (ip6_neighbor_age_process_node,static) = {
   .function = ip6_neighbor_age_process,
   .type = VLIB_NODE_TYPE_PROCESS,
+  .process_priority = VLIB_PROCESS_PRIORITY_LOW,
   .name = "ip6-neighbor-age-process",
 };
 
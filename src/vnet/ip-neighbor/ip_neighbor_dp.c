@@ -16,10 +16,108 @@
  */
 
 #include <vlibmemory/api.h>
+#include <vppinfra/xxhash.h>
 
 #include <vnet/ip-neighbor/ip_neighbor_dp.h>
 #include <vnet/ip-neighbor/ip_neighbor.h>
 
+/**
+ * Neighbors learned again within this many seconds are not queued again
+ */
+#define IP_NEIGHBOR_LEARN_DEDUP_TIME 1.0
+
+/**
+ * Number of recent learns remembered by each worker, a power of 2
+ */
+#define IP_NEIGHBOR_LEARN_N_RECENT 1024
+
+/**
+ * Max learns taken off one queue before the barrier is released
+ */
+#define IP_NEIGHBOR_LEARN_DRAIN_BATCH 256
+
+typedef struct ip_neighbor_learn_recent_t_
+{
+  ip_neighbor_learn_t ipnlr_learn;
+  f64 ipnlr_time;
+} ip_neighbor_learn_recent_t;
+
+/**
+ * Single producer / single consumer ring of the neighbors learned by a
+ * worker
+ */
+typedef struct ip_neighbor_learn_queue_t_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /* producer (worker) side */
+  u32 ipnlq_head;
+  ip_neighbor_learn_t *ipnlq_learns;
+  ip_neighbor_learn_recent_t *ipnlq_recent;
+
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  /* consumer (main thread) side */
+  u32 ipnlq_tail;
+} ip_neighbor_learn_queue_t;
+
+/**
+ * per-worker learn queues, 0 if disabled
+ */
+static ip_neighbor_learn_queue_t *ip_neighbor_learn_queues;
+static u32 ip_neighbor_learn_queue_size;
+
+vlib_node_registration_t ip_neighbor_learn_queue_node;
+vlib_node_registration_t ip_neighbor_learn_process_node;
+
+static_always_inline ip_neighbor_learn_recent_t *
+ip_neighbor_learn_get_recent (ip_neighbor_learn_queue_t * q,
+			      const ip_neighbor_learn_t * l)
+{
+  u64 key;
+
+  if (AF_IP4 == ip_addr_version (&l->ip))
+    key = ip_addr_v4 (&l->ip).as_u32;
+  else
+    key = ip_addr_v6 (&l->ip).as_u64[0] ^ ip_addr_v6 (&l->ip).as_u64[1];
+  key ^= (u64) l->sw_if_index << 32;
+
+  return (&q->ipnlq_recent[clib_xxhash (key) &
+			   (IP_NEIGHBOR_LEARN_N_RECENT - 1)]);
+}
+
+/**
+ * Queue a neighbor learned by a worker, unless the same neighbor was
+ * queued moments ago. Returns false if the queue is full.
+ */
+static bool
+ip_neighbor_learn_enqueue (vlib_main_t * vm, ip_neighbor_learn_queue_t * q,
+			   const ip_neighbor_learn_t * l)
+{
+  ip_neighbor_learn_recent_t *r;
+  u32 head = q->ipnlq_head;
+  f64 now = vlib_time_now (vm);
+
+  r = ip_neighbor_learn_get_recent (q, l);
+  if (now - r->ipnlr_time < IP_NEIGHBOR_LEARN_DEDUP_TIME &&
+      r->ipnlr_learn.sw_if_index == l->sw_if_index &&
+      mac_address_equal (&r->ipnlr_learn.mac, &l->mac) &&
+      !ip_address_cmp (&r->ipnlr_learn.ip, &l->ip))
+    return (true);
+
+  if (head - clib_atomic_load_acq_n (&q->ipnlq_tail) >=
+      ip_neighbor_learn_queue_size)
+    return (false);
+
+  q->ipnlq_learns[head & (ip_neighbor_learn_queue_size - 1)] = *l;
+  clib_atomic_store_rel_n (&q->ipnlq_head, head + 1);
+
+  r->ipnlr_learn = *l;
+  r->ipnlr_time = now;
+
+  vlib_node_set_interrupt_pending (vlib_get_main_by_index (0),
+				   ip_neighbor_learn_queue_node.index);
+  return (true);
+}
+
 /**
  * APIs invoked by neighbor implementation (i.s. ARP and ND) that can be
  * called from the DP when the protocol has resolved a neighbor
@@ -27,9 +125,135 @@
 void
 ip_neighbor_learn_dp (const ip_neighbor_learn_t * l)
 {
+  vlib_main_t *vm = vlib_get_main ();
+
+  if (ip_neighbor_learn_queues && vm->thread_index &&
+      ip_neighbor_learn_enqueue (vm, vec_elt_at_index (ip_neighbor_learn_queues,
+						       vm->thread_index), l))
+    return;
+
   vl_api_rpc_call_main_thread (ip_neighbor_learn, (u8 *) l, sizeof (*l));
 }
 
+/**
+ * Main thread input node, interrupted by the workers after they queue a
+ * learn. The learns are added from a process, under the barrier.
+ */
+static uword
+ip_neighbor_learn_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
+				 vlib_frame_t * frame)
+{
+  vlib_process_signal_event (vm, ip_neighbor_learn_process_node.index, 0, 0);
+  return 0;
+}
+
+VLIB_REGISTER_NODE (ip_neighbor_learn_queue_node) = {
+  .function = ip_neighbor_learn_queue_node_fn,
+  .name = "ip-neighbor-learn-queue",
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+};
+
+/**
+ * Take a batch off each queue under one barrier, rather than syncing the
+ * workers for every learn as the RPCs do.
+ */
+static bool
+ip_neighbor_learn_drain (vlib_main_t * vm)
+{
+  u32 mask = ip_neighbor_learn_queue_size - 1;
+  ip_neighbor_learn_queue_t *q;
+  u32 head, tail, n_left;
+  bool more = false;
+
+  vlib_worker_thread_barrier_sync (vm);
+
+  vec_foreach (q, ip_neighbor_learn_queues)
+    {
+      head = clib_atomic_load_acq_n (&q->ipnlq_head);
+      tail = q->ipnlq_tail;
+      n_left = clib_min (head - tail, IP_NEIGHBOR_LEARN_DRAIN_BATCH);
+      more |= head - tail > n_left;
+
+      for (; n_left; n_left--, tail++)
+	ip_neighbor_learn (&q->ipnlq_learns[tail & mask]);
+
+      clib_atomic_store_rel_n (&q->ipnlq_tail, tail);
+    }
+
+  vlib_worker_thread_barrier_release (vm);
+
+  return (more);
+}
+
+static uword
+ip_neighbor_learn_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
+			   vlib_frame_t * f)
+{
+  uword *event_data = NULL;
+
+  while (1)
+    {
+      vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, &event_data);
+      vec_reset_length (event_data);
+
+      /* let the rest of the main thread run between batches */
+      while (ip_neighbor_learn_drain (vm))
+	vlib_process_suspend (vm, 1e-5);
+    }
+  return 0;
+}
+
+VLIB_REGISTER_NODE (ip_neighbor_learn_process_node) = {
+  .function = ip_neighbor_learn_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "ip-neighbor-learn-process",
+};
+
+static clib_error_t *
+ip_neighbor_learn_main_loop_enter (vlib_main_t * vm)
+{
+  ip_neighbor_learn_queue_t *q;
+
+  if (ip_neighbor_learn_queue_size == 0 || vlib_get_n_threads () < 2)
+    return 0;
+
+  vec_validate_aligned (ip_neighbor_learn_queues, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
+  vec_foreach (q, ip_neighbor_learn_queues)
+    {
+      vec_validate_aligned (q->ipnlq_learns, ip_neighbor_learn_queue_size - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (q->ipnlq_recent, IP_NEIGHBOR_LEARN_N_RECENT - 1,
+			    CLIB_CACHE_LINE_BYTES);
+    }
+  return 0;
+}
+
+VLIB_MAIN_LOOP_ENTER_FUNCTION (ip_neighbor_learn_main_loop_enter);
+
+static clib_error_t *
+ip_neighbor_learn_config (vlib_main_t * vm, unformat_input_t * input)
+{
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "learn-queue-size %u",
+		    &ip_neighbor_learn_queue_size))
+	{
+	  if (!is_pow2 (ip_neighbor_learn_queue_size))
+	    return clib_error_return (0,
+				      "learn-queue-size must be power of 2");
+	}
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+  return 0;
+}
+
+VLIB_CONFIG_FUNCTION (ip_neighbor_learn_config, "ip-neighbor");
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -111,6 +111,37 @@ VLIB_REGISTER_NODE (ip4_lookup_node) =
   .next_nodes = IP4_LOOKUP_NEXT_NODES,
 };
 
+/*
+ * Flow hash and forwarding bucket of a packet in a via load-balance.
+ * This node is for via FIBs so we can re-use the hash value from the
+ * to node if present. We don't want to use the same hash value at each
+ * level in the recursion graph as that would lead to polarisation.
+ */
+static_always_inline const dpo_id_t *
+ip4_load_balance_get_bucket (vlib_buffer_t *b)
+{
+  const load_balance_t *lb;
+  const ip4_header_t *ip;
+  u32 hc;
+
+  lb = load_balance_get (vnet_buffer (b)->ip.adj_index[VLIB_TX]);
+
+  if (PREDICT_TRUE (lb->lb_n_buckets == 1))
+    return load_balance_get_bucket_i (lb, 0);
+
+  if (PREDICT_TRUE (vnet_buffer (b)->ip.flow_hash))
+    {
+      hc = vnet_buffer (b)->ip.flow_hash = vnet_buffer (b)->ip.flow_hash >> 1;
+    }
+  else
+    {
+      ip = vlib_buffer_get_current (b);
+      hc = vnet_buffer (b)->ip.flow_hash =
+	ip4_compute_flow_hash (ip, lb->lb_hash_config);
+    }
+  return load_balance_get_fwd_bucket (lb, (hc & (lb->lb_n_buckets_minus_1)));
+}
+
 VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
 				      vlib_node_runtime_t * node,
 				      vlib_frame_t * frame)
@@ -119,6 +150,7 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
   u32 n_left, *from;
   clib_thread_index_t thread_index = vm->thread_index;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
+  const dpo_id_t *dpos[VLIB_FRAME_SIZE], **dpo = dpos;
   u16 nexts[VLIB_FRAME_SIZE], *next;
 
   from = vlib_frame_vector_args (frame);
@@ -127,82 +159,35 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
 
   vlib_get_buffers (vm, from, bufs, n_left);
 
-  while (n_left >= 4)
+  /*
+   * First pass: find the forwarding bucket of each packet and prefetch
+   * it. With large ECMP groups the bucket arrays span many cache lines,
+   * so the bucket loads of the whole frame are issued before any of them
+   * is used.
+   */
+  for (u32 i = 0; i < n_left; i++)
     {
-      const load_balance_t *lb0, *lb1;
-      const ip4_header_t *ip0, *ip1;
-      u32 lbi0, hc0, lbi1, hc1;
-      const dpo_id_t *dpo0, *dpo1;
-
-      /* Prefetch next iteration. */
-      {
-	vlib_prefetch_buffer_header (b[2], LOAD);
-	vlib_prefetch_buffer_header (b[3], LOAD);
+      if (i + 4 < n_left)
+	{
+	  vlib_prefetch_buffer_header (b[i + 4], LOAD);
+	  CLIB_PREFETCH (b[i + 4]->data, sizeof (ip4_header_t), LOAD);
+	}
+      dpos[i] = ip4_load_balance_get_bucket (b[i]);
+      clib_prefetch_load ((void *) dpos[i]);
+    }
 
-	CLIB_PREFETCH (b[2]->data, sizeof (ip0[0]), LOAD);
-	CLIB_PREFETCH (b[3]->data, sizeof (ip0[0]), LOAD);
-      }
+  while (n_left >= 2)
+    {
+      u32 lbi0, lbi1;
 
-      ip0 = vlib_buffer_get_current (b[0]);
-      ip1 = vlib_buffer_get_current (b[1]);
       lbi0 = vnet_buffer (b[0])->ip.adj_index[VLIB_TX];
       lbi1 = vnet_buffer (b[1])->ip.adj_index[VLIB_TX];
 
-      lb0 = load_balance_get (lbi0);
-      lb1 = load_balance_get (lbi1);
-
-      /*
-       * this node is for via FIBs we can re-use the hash value from the
-       * to node if present.
-       * We don't want to use the same hash value at each level in the recursion
-       * graph as that would lead to polarisation
-       */
-      hc0 = hc1 = 0;
-
-      if (PREDICT_FALSE (lb0->lb_n_buckets > 1))
-	{
-	  if (PREDICT_TRUE (vnet_buffer (b[0])->ip.flow_hash))
-	    {
-	      hc0 = vnet_buffer (b[0])->ip.flow_hash =
-		vnet_buffer (b[0])->ip.flow_hash >> 1;
-	    }
-	  else
-	    {
-	      hc0 = vnet_buffer (b[0])->ip.flow_hash =
-		ip4_compute_flow_hash (ip0, lb0->lb_hash_config);
-	    }
-	  dpo0 = load_balance_get_fwd_bucket
-	    (lb0, (hc0 & (lb0->lb_n_buckets_minus_1)));
-	}
-      else
-	{
-	  dpo0 = load_balance_get_bucket_i (lb0, 0);
-	}
-      if (PREDICT_FALSE (lb1->lb_n_buckets > 1))
-	{
-	  if (PREDICT_TRUE (vnet_buffer (b[1])->ip.flow_hash))
-	    {
-	      hc1 = vnet_buffer (b[1])->ip.flow_hash =
-		vnet_buffer (b[1])->ip.flow_hash >> 1;
-	    }
-	  else
-	    {
-	      hc1 = vnet_buffer (b[1])->ip.flow_hash =
-		ip4_compute_flow_hash (ip1, lb1->lb_hash_config);
-	    }
-	  dpo1 = load_balance_get_fwd_bucket
-	    (lb1, (hc1 & (lb1->lb_n_buckets_minus_1)));
-	}
-      else
-	{
-	  dpo1 = load_balance_get_bucket_i (lb1, 0);
-	}
-
-      next[0] = dpo0->dpoi_next_node;
-      next[1] = dpo1->dpoi_next_node;
+      next[0] = dpo[0]->dpoi_next_node;
+      next[1] = dpo[1]->dpoi_next_node;
 
-      vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
-      vnet_buffer (b[1])->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
+      vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo[0]->dpoi_index;
+      vnet_buffer (b[1])->ip.adj_index[VLIB_TX] = dpo[1]->dpoi_index;
 
       vlib_increment_combined_counter
 	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
@@ -210,50 +195,25 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
 	(cm, thread_index, lbi1, 1, vlib_buffer_length_in_chain (vm, b[1]));
 
       b += 2;
+      dpo += 2;
       next += 2;
       n_left -= 2;
     }
 
   while (n_left > 0)
     {
-      const load_balance_t *lb0;
-      const ip4_header_t *ip0;
-      const dpo_id_t *dpo0;
-      u32 lbi0, hc0;
+      u32 lbi0;
 
-      ip0 = vlib_buffer_get_current (b[0]);
       lbi0 = vnet_buffer (b[0])->ip.adj_index[VLIB_TX];
 
-      lb0 = load_balance_get (lbi0);
-
-      hc0 = 0;
-      if (PREDICT_FALSE (lb0->lb_n_buckets > 1))
-	{
-	  if (PREDICT_TRUE (vnet_buffer (b[0])->ip.flow_hash))
-	    {
-	      hc0 = vnet_buffer (b[0])->ip.flow_hash =
-		vnet_buffer (b[0])->ip.flow_hash >> 1;
-	    }
-	  else
-	    {
-	      hc0 = vnet_buffer (b[0])->ip.flow_hash =
-		ip4_compute_flow_hash (ip0, lb0->lb_hash_config);
-	    }
-	  dpo0 = load_balance_get_fwd_bucket
-	    (lb0, (hc0 & (lb0->lb_n_buckets_minus_1)));
-	}
-      else
-	{
-	  dpo0 = load_balance_get_bucket_i (lb0, 0);
-	}
-
-      next[0] = dpo0->dpoi_next_node;
-      vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
+      next[0] = dpo[0]->dpoi_next_node;
+      vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo[0]->dpoi_index;
 
       vlib_increment_combined_counter
 	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
 
       b += 1;
+      dpo += 1;
       next += 1;
       n_left -= 1;
     }
@@ -2114,9 +2074,13 @@ ip4_rewrite_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   n_left_from = frame->n_vectors;
   clib_thread_index_t thread_index = vm->thread_index;
+  vlib_combined_counter_acc_t adj_acc;
 
   vlib_get_buffers (vm, from, bufs, n_left_from);
   clib_memset_u16 (nexts, IP4_REWRITE_NEXT_DROP, n_left_from);
+  if (do_counters)
+    vlib_combined_counter_acc_init (&adj_acc, &adjacency_counters,
+				    thread_index);
 
 #if (CLIB_N_PREFETCHES >= 8)
   if (n_left_from >= 6)
@@ -2273,18 +2237,14 @@ ip4_rewrite_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       if (do_counters)
 	{
 	  if (error0 == IP4_ERROR_NONE)
-	    vlib_increment_combined_counter
-	      (&adjacency_counters,
-	       thread_index,
-	       adj_index0, 1,
-	       vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
+	    vlib_combined_counter_acc_add (
+	      &adj_acc, adj_index0, 1,
+	      vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
 
 	  if (error1 == IP4_ERROR_NONE)
-	    vlib_increment_combined_counter
-	      (&adjacency_counters,
-	       thread_index,
-	       adj_index1, 1,
-	       vlib_buffer_length_in_chain (vm, b[1]) + rw_len1);
+	    vlib_combined_counter_acc_add (
+	      &adj_acc, adj_index1, 1,
+	      vlib_buffer_length_in_chain (vm, b[1]) + rw_len1);
 	}
 
       if (is_midchain)
@@ -2414,11 +2374,9 @@ ip4_rewrite_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	   * Bump the per-adjacency counters
 	   */
 	  if (do_counters)
-	    vlib_increment_combined_counter
-	      (&adjacency_counters,
-	       thread_index,
-	       adj_index0, 1, vlib_buffer_length_in_chain (vm,
-							   b[0]) + rw_len0);
+	    vlib_combined_counter_acc_add (
+	      &adj_acc, adj_index0, 1,
+	      vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
 
 	  if (is_midchain)
 	    adj_midchain_fixup (vm, adj0, b[0], VNET_LINK_IP4);
@@ -2514,10 +2472,9 @@ ip4_rewrite_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				     sizeof (ethernet_header_t));
 
 	  if (do_counters)
-	    vlib_increment_combined_counter
-	      (&adjacency_counters,
-	       thread_index, adj_index0, 1,
-	       vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
+	    vlib_combined_counter_acc_add (
+	      &adj_acc, adj_index0, 1,
+	      vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
 
 	  if (is_midchain)
 	    adj_midchain_fixup (vm, adj0, b[0], VNET_LINK_IP4);
@@ -2541,6 +2498,8 @@ ip4_rewrite_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       n_left_from -= 1;
     }
 
+  if (do_counters)
+    vlib_combined_counter_acc_flush (&adj_acc);
 
   /* Need to do trace after rewrites to pick up new packet data. */
   if (node->flags & VLIB_NODE_FLAG_TRACE)
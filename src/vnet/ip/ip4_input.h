@@ -78,6 +78,31 @@ check_ver_opt_csum (ip4_header_t * ip, u8 * error, int verify_checksum)
     *error = IP4_ERROR_BAD_CHECKSUM;
 }
 
+/* Validate the checksums of four option-less headers side by side.
+   Returns a bitmap of the headers whose checksum is bad. */
+static_always_inline u32
+ip4_input_bad_csum_x4 (ip4_header_t ** ip)
+{
+  u64 sum[4];
+  u32 i, bad = 0;
+
+  for (i = 0; i < 4; i++)
+    sum[i] = (u64) ip[i]->checksum_data_32[0] + ip[i]->checksum_data_32[1] +
+	     ip[i]->checksum_data_32[2] + ip[i]->checksum_data_32[3] +
+	     ip[i]->checksum_data_32[4];
+
+  for (i = 0; i < 4; i++)
+    {
+      sum[i] = (sum[i] & 0xffffffff) + (sum[i] >> 32);
+      sum[i] = (sum[i] & 0xffff) + (sum[i] >> 16);
+      sum[i] = (sum[i] & 0xffff) + (sum[i] >> 16);
+      sum[i] = (sum[i] & 0xffff) + (sum[i] >> 16);
+      bad |= (sum[i] != 0xffff) << i;
+    }
+
+  return bad;
+}
+
 always_inline void
 ip4_input_check_x4 (vlib_main_t * vm,
 		    vlib_node_runtime_t * error_node,
@@ -93,10 +118,31 @@ ip4_input_check_x4 (vlib_main_t * vm,
 
   error0 = error1 = error2 = error3 = IP4_ERROR_NONE;
 
-  check_ver_opt_csum (ip[0], &error0, verify_checksum);
-  check_ver_opt_csum (ip[1], &error1, verify_checksum);
-  check_ver_opt_csum (ip[2], &error2, verify_checksum);
-  check_ver_opt_csum (ip[3], &error3, verify_checksum);
+  if (PREDICT_TRUE ((ip[0]->ip_version_and_header_length &
+		     ip[1]->ip_version_and_header_length &
+		     ip[2]->ip_version_and_header_length &
+		     ip[3]->ip_version_and_header_length) == 0x45 &&
+		    (ip[0]->ip_version_and_header_length |
+		     ip[1]->ip_version_and_header_length |
+		     ip[2]->ip_version_and_header_length |
+		     ip[3]->ip_version_and_header_length) == 0x45))
+    {
+      u32 bad = verify_checksum ? ip4_input_bad_csum_x4 (ip) : 0;
+      if (PREDICT_FALSE (bad))
+	{
+	  error0 = bad & 1 ? IP4_ERROR_BAD_CHECKSUM : error0;
+	  error1 = bad & 2 ? IP4_ERROR_BAD_CHECKSUM : error1;
+	  error2 = bad & 4 ? IP4_ERROR_BAD_CHECKSUM : error2;
+	  error3 = bad & 8 ? IP4_ERROR_BAD_CHECKSUM : error3;
+	}
+    }
+  else
+    {
+      check_ver_opt_csum (ip[0], &error0, verify_checksum);
+      check_ver_opt_csum (ip[1], &error1, verify_checksum);
+      check_ver_opt_csum (ip[2], &error2, verify_checksum);
+      check_ver_opt_csum (ip[3], &error3, verify_checksum);
+    }
 
   if (PREDICT_FALSE (ip[0]->ttl < 1))
     error0 = IP4_ERROR_TIME_EXPIRED;
@@ -144,6 +190,10 @@ ip4_input_check_x4 (vlib_main_t * vm,
   error2 = len_diff2 < 0 ? IP4_ERROR_BAD_LENGTH : error2;
   error3 = len_diff3 < 0 ? IP4_ERROR_BAD_LENGTH : error3;
 
+  /* One branch for the whole batch in the common all-valid case. */
+  if (PREDICT_TRUE ((error0 | error1 | error2 | error3) == IP4_ERROR_NONE))
+    return;
+
   if (PREDICT_FALSE (error0 != IP4_ERROR_NONE))
     {
       if (error0 == IP4_ERROR_TIME_EXPIRED)
@@ -247,6 +297,9 @@ ip4_input_check_x2 (vlib_main_t * vm,
   error0 = len_diff0 < 0 ? IP4_ERROR_BAD_LENGTH : error0;
   error1 = len_diff1 < 0 ? IP4_ERROR_BAD_LENGTH : error1;
 
+  if (PREDICT_TRUE ((error0 | error1) == IP4_ERROR_NONE))
+    return;
+
   if (PREDICT_FALSE (error0 != IP4_ERROR_NONE))
     {
       if (error0 == IP4_ERROR_TIME_EXPIRED)
@@ -667,6 +667,581 @@ ip4_mtrie_8_route_del (ip4_mtrie_8_t *m, const ip4_address_t *dst_address,
   unset_leaf (&a, root, 0);
 }
 
+/*
+ * Compressed plies.
+ *
+ * A published compressed ply is never modified. To update one it is
+ * expanded into an ip4_mtrie_8_ply_t on the stack, changed there following
+ * the same rules as the 8 bit plies above, and compressed into a new ply
+ * which is then swapped into its parent. The plies that have been replaced
+ * are returned to the pool once the update has reached the root.
+ */
+
+/**
+ * Global pool of IPv4 compressed 8bit PLYs
+ */
+ip4_mtrie_c_ply_t *ip4_c_ply_pool;
+
+/**
+ * The control plane's view of a compressed ply. Indexed as the pool.
+ */
+typedef struct ip4_mtrie_c_ply_ctl_t_
+{
+  /**
+   * Prefix length for the leaf of each run.
+   */
+  u8 *run_lens;
+
+  /**
+   * The length of the ply's covering prefix.
+   */
+  i32 dst_address_bits_base;
+} ip4_mtrie_c_ply_ctl_t;
+
+static ip4_mtrie_c_ply_ctl_t *ip4_c_ply_ctls;
+
+/**
+ * Plies replaced by the update in progress
+ */
+static u32 *ip4_c_plies_retired;
+
+/**
+ * Non-zero while a batch of updates is in progress. The replaced plies are
+ * then kept until the batch ends.
+ */
+static u32 ip4_mtrie_batch_depth;
+
+always_inline const ip4_mtrie_leaf_t *
+c_ply_leaves (const ip4_mtrie_c_ply_t *p)
+{
+  return (p->leaves ? p->leaves : p->inline_leaves);
+}
+
+static void
+c_ply_expand (u32 ply_index, ip4_mtrie_8_ply_t *e)
+{
+  const ip4_mtrie_c_ply_t *p = pool_elt_at_index (ip4_c_ply_pool, ply_index);
+  const ip4_mtrie_c_ply_ctl_t *ctl =
+    vec_elt_at_index (ip4_c_ply_ctls, ply_index);
+  const ip4_mtrie_leaf_t *leaves = c_ply_leaves (p);
+  i32 run = -1;
+  u32 i;
+
+  e->dst_address_bits_base = ctl->dst_address_bits_base;
+  e->n_non_empty_leafs = 0;
+
+  for (i = 0; i < ARRAY_LEN (e->leaves); i++)
+    {
+      run += (p->run_starts[i / 64] >> (i % 64)) & 1;
+      e->leaves[i] = leaves[run];
+      e->dst_address_bits_of_leaves[i] = ctl->run_lens[run];
+      e->n_non_empty_leafs += ip4_mtrie_leaf_is_non_empty (e, i);
+    }
+}
+
+static u32
+c_ply_create (const ip4_mtrie_8_ply_t *e)
+{
+  ip4_mtrie_leaf_t leaves[ARRAY_LEN (e->leaves)];
+  ip4_mtrie_c_ply_ctl_t *ctl;
+  ip4_mtrie_c_ply_t *p;
+  u32 i, ply_index, n_runs = 0;
+  u8 need_barrier_sync = pool_get_will_expand (ip4_c_ply_pool);
+  vlib_main_t *vm = vlib_get_main ();
+  ASSERT (vm->thread_index == 0);
+
+  /* the new ply is not visible until the caller links it in, only
+   * the move of the pool needs protecting */
+  if (need_barrier_sync)
+    vlib_worker_thread_barrier_sync (vm);
+
+  pool_get_aligned (ip4_c_ply_pool, p, CLIB_CACHE_LINE_BYTES);
+
+  if (need_barrier_sync)
+    vlib_worker_thread_barrier_release (vm);
+
+  ply_index = p - ip4_c_ply_pool;
+  vec_validate (ip4_c_ply_ctls, ply_index);
+  ctl = vec_elt_at_index (ip4_c_ply_ctls, ply_index);
+  vec_reset_length (ctl->run_lens);
+  clib_memset (p, 0, sizeof (*p));
+
+  for (i = 0; i < ARRAY_LEN (e->leaves); i++)
+    {
+      if (i == 0 || e->leaves[i] != e->leaves[i - 1] ||
+	  e->dst_address_bits_of_leaves[i] !=
+	    e->dst_address_bits_of_leaves[i - 1])
+	{
+	  p->run_starts[i / 64] |= 1ULL << (i % 64);
+	  leaves[n_runs++] = e->leaves[i];
+	  vec_add1 (ctl->run_lens, e->dst_address_bits_of_leaves[i]);
+	}
+    }
+
+  for (i = 1; i < ARRAY_LEN (p->n_runs_before); i++)
+    p->n_runs_before[i] =
+      p->n_runs_before[i - 1] + count_set_bits (p->run_starts[i - 1]);
+
+  p->n_runs = n_runs;
+  if (n_runs > ARRAY_LEN (p->inline_leaves))
+    {
+      p->leaves = clib_mem_alloc_aligned (n_runs * sizeof (leaves[0]),
+					  CLIB_CACHE_LINE_BYTES);
+      clib_memcpy (p->leaves, leaves, n_runs * sizeof (leaves[0]));
+    }
+  else
+    clib_memcpy (p->inline_leaves, leaves, n_runs * sizeof (leaves[0]));
+
+  ctl->dst_address_bits_base = e->dst_address_bits_base;
+
+  return (ply_index);
+}
+
+static u32
+c_ply_replace (u32 old_ply_index, const ip4_mtrie_8_ply_t *e)
+{
+  vec_add1 (ip4_c_plies_retired, old_ply_index);
+
+  return (c_ply_create (e));
+}
+
+static void
+c_plies_retired_free (void)
+{
+  ip4_mtrie_c_ply_t *p;
+  u32 *ply_index;
+
+  if (ip4_mtrie_batch_depth)
+    return;
+
+  vec_foreach (ply_index, ip4_c_plies_retired)
+    {
+      p = pool_elt_at_index (ip4_c_ply_pool, *ply_index);
+      if (p->leaves)
+	clib_mem_free (p->leaves);
+      pool_put (ip4_c_ply_pool, p);
+    }
+  vec_reset_length (ip4_c_plies_retired);
+}
+
+static u32
+c_set_ply_with_more_specific_leaf (u32 ply_index, ip4_mtrie_leaf_t new_leaf,
+				   uword new_leaf_dst_address_bits)
+{
+  ip4_mtrie_leaf_t old_leaf;
+  ip4_mtrie_8_ply_t ply;
+  uword i;
+
+  ASSERT (ip4_mtrie_leaf_is_terminal (new_leaf));
+
+  c_ply_expand (ply_index, &ply);
+
+  for (i = 0; i < ARRAY_LEN (ply.leaves); i++)
+    {
+      old_leaf = ply.leaves[i];
+
+      /* Recurse into sub plies. */
+      if (!ip4_mtrie_leaf_is_terminal (old_leaf))
+	ply.leaves[i] = ip4_mtrie_leaf_set_next_ply_index (
+	  c_set_ply_with_more_specific_leaf (
+	    ip4_mtrie_leaf_get_next_ply_index (old_leaf), new_leaf,
+	    new_leaf_dst_address_bits));
+
+      /* Replace less specific terminal leaves with new leaf. */
+      else if (new_leaf_dst_address_bits >= ply.dst_address_bits_of_leaves[i])
+	{
+	  ply.leaves[i] = new_leaf;
+	  ply.dst_address_bits_of_leaves[i] = new_leaf_dst_address_bits;
+	}
+    }
+
+  return (c_ply_replace (ply_index, &ply));
+}
+
+static u32 c_set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a,
+		       u32 old_ply_index, u32 dst_address_byte_index);
+
+/*
+ * Set the leaf in an expanded ply, returns the index of the compressed
+ * ply built from it.
+ */
+static u32
+c_set_leaf_in_ply (const ip4_mtrie_set_unset_leaf_args_t *a,
+		   ip4_mtrie_8_ply_t *ply, u32 dst_address_byte_index)
+{
+  ip4_mtrie_leaf_t old_leaf, new_leaf;
+  i32 n_dst_bits_next_plies;
+  u8 dst_byte;
+
+  ASSERT (a->dst_address_length <= 32);
+  ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
+
+  /* how many bits of the destination address are in the next PLY */
+  n_dst_bits_next_plies =
+    a->dst_address_length - BITS (u8) * (dst_address_byte_index + 1);
+
+  dst_byte = a->dst_address.as_u8[dst_address_byte_index];
+
+  /* Number of bits next plies <= 0 => insert leaves this ply. */
+  if (n_dst_bits_next_plies <= 0)
+    {
+      uword old_leaf_is_terminal;
+      u32 i, n_dst_bits_this_ply;
+
+      n_dst_bits_this_ply = clib_min (8, -n_dst_bits_next_plies);
+      ASSERT ((a->dst_address.as_u8[dst_address_byte_index] &
+	       pow2_mask (n_dst_bits_this_ply)) == 0);
+
+      for (i = dst_byte; i < dst_byte + (1 << n_dst_bits_this_ply); i++)
+	{
+	  old_leaf = ply->leaves[i];
+	  old_leaf_is_terminal = ip4_mtrie_leaf_is_terminal (old_leaf);
+
+	  if (a->dst_address_length >= ply->dst_address_bits_of_leaves[i])
+	    {
+	      new_leaf = ip4_mtrie_leaf_set_adj_index (a->adj_index);
+
+	      if (old_leaf_is_terminal)
+		{
+		  ply->dst_address_bits_of_leaves[i] = a->dst_address_length;
+		  ply->leaves[i] = new_leaf;
+		}
+	      else
+		ply->leaves[i] = ip4_mtrie_leaf_set_next_ply_index (
+		  c_set_ply_with_more_specific_leaf (
+		    ip4_mtrie_leaf_get_next_ply_index (old_leaf), new_leaf,
+		    a->dst_address_length));
+	    }
+	  else if (!old_leaf_is_terminal)
+	    ply->leaves[i] = ip4_mtrie_leaf_set_next_ply_index (
+	      c_set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf),
+			  dst_address_byte_index + 1));
+	}
+    }
+  else
+    {
+      /* The address to insert requires us to move down at a lower level of
+       * the trie - recurse on down */
+      ip4_mtrie_8_ply_t new_ply;
+      u32 new_ply_index;
+      u8 ply_base_len;
+
+      ply_base_len = 8 * (dst_address_byte_index + 1);
+
+      old_leaf = ply->leaves[dst_byte];
+
+      if (ip4_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  /* There is a leaf occupying the slot. Replace it with a new ply */
+	  ply_8_init (&new_ply, old_leaf,
+		      ply->dst_address_bits_of_leaves[dst_byte], ply_base_len);
+	  new_ply_index =
+	    c_set_leaf_in_ply (a, &new_ply, dst_address_byte_index + 1);
+	  ply->dst_address_bits_of_leaves[dst_byte] = ply_base_len;
+	}
+      else
+	new_ply_index =
+	  c_set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf),
+		      dst_address_byte_index + 1);
+
+      ply->leaves[dst_byte] = ip4_mtrie_leaf_set_next_ply_index (new_ply_index);
+    }
+
+  return (c_ply_create (ply));
+}
+
+static u32
+c_set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
+	    u32 dst_address_byte_index)
+{
+  ip4_mtrie_8_ply_t ply;
+
+  c_ply_expand (old_ply_index, &ply);
+  vec_add1 (ip4_c_plies_retired, old_ply_index);
+
+  return (c_set_leaf_in_ply (a, &ply, dst_address_byte_index));
+}
+
+static void
+c_set_root_leaf (ip4_mtrie_16c_t *m,
+		 const ip4_mtrie_set_unset_leaf_args_t *a)
+{
+  ip4_mtrie_leaf_t old_leaf, new_leaf;
+  ip4_mtrie_16_ply_t *old_ply;
+  i32 n_dst_bits_next_plies;
+  u32 new_ply_index;
+  u16 dst_byte;
+
+  old_ply = &m->root_ply;
+
+  ASSERT (a->dst_address_length <= 32);
+
+  /* how many bits of the destination address are in the next PLY */
+  n_dst_bits_next_plies = a->dst_address_length - BITS (u16);
+
+  dst_byte = a->dst_address.as_u16[0];
+
+  /* Number of bits next plies <= 0 => insert leaves this ply. */
+  if (n_dst_bits_next_plies <= 0)
+    {
+      uword old_leaf_is_terminal;
+      u32 i, n_dst_bits_this_ply;
+
+      n_dst_bits_this_ply = 16 - a->dst_address_length;
+      ASSERT ((clib_host_to_net_u16 (a->dst_address.as_u16[0]) &
+	       pow2_mask (n_dst_bits_this_ply)) == 0);
+
+      for (i = 0; i < (1 << n_dst_bits_this_ply); i++)
+	{
+	  u16 slot;
+
+	  slot = clib_net_to_host_u16 (dst_byte);
+	  slot += i;
+	  slot = clib_host_to_net_u16 (slot);
+
+	  old_leaf = old_ply->leaves[slot];
+	  old_leaf_is_terminal = ip4_mtrie_leaf_is_terminal (old_leaf);
+
+	  if (a->dst_address_length >=
+	      old_ply->dst_address_bits_of_leaves[slot])
+	    {
+	      new_leaf = ip4_mtrie_leaf_set_adj_index (a->adj_index);
+
+	      if (old_leaf_is_terminal)
+		{
+		  old_ply->dst_address_bits_of_leaves[slot] =
+		    a->dst_address_length;
+		  clib_atomic_store_rel_n (&old_ply->leaves[slot], new_leaf);
+		}
+	      else
+		{
+		  new_ply_index = c_set_ply_with_more_specific_leaf (
+		    ip4_mtrie_leaf_get_next_ply_index (old_leaf), new_leaf,
+		    a->dst_address_length);
+		  clib_atomic_store_rel_n (
+		    &old_ply->leaves[slot],
+		    ip4_mtrie_leaf_set_next_ply_index (new_ply_index));
+		}
+	    }
+	  else if (!old_leaf_is_terminal)
+	    {
+	      new_ply_index = c_set_leaf (
+		a, ip4_mtrie_leaf_get_next_ply_index (old_leaf), 2);
+	      clib_atomic_store_rel_n (
+		&old_ply->leaves[slot],
+		ip4_mtrie_leaf_set_next_ply_index (new_ply_index));
+	    }
+	}
+    }
+  else
+    {
+      ip4_mtrie_8_ply_t new_ply;
+
+      old_leaf = old_ply->leaves[dst_byte];
+
+      if (ip4_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  /* There is a leaf occupying the slot. Replace it with a new ply */
+	  ply_8_init (&new_ply, old_leaf,
+		      old_ply->dst_address_bits_of_leaves[dst_byte], 16);
+	  new_ply_index = c_set_leaf_in_ply (a, &new_ply, 2);
+	  old_ply->dst_address_bits_of_leaves[dst_byte] = 16;
+	}
+      else
+	new_ply_index =
+	  c_set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf), 2);
+
+      clib_atomic_store_rel_n (
+	&old_ply->leaves[dst_byte],
+	ip4_mtrie_leaf_set_next_ply_index (new_ply_index));
+    }
+}
+
+/*
+ * Returns 1 if the ply is now empty and was deleted, otherwise 0 and the
+ * index of its replacement.
+ */
+static uword
+c_unset_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 *ply_index,
+	      u32 dst_address_byte_index)
+{
+  ip4_mtrie_leaf_t old_leaf, del_leaf;
+  i32 n_dst_bits_next_plies;
+  i32 i, n_dst_bits_this_ply;
+  ip4_mtrie_8_ply_t ply;
+  u32 sub_ply_index;
+  u8 dst_byte;
+
+  ASSERT (a->dst_address_length <= 32);
+  ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
+
+  c_ply_expand (*ply_index, &ply);
+
+  n_dst_bits_next_plies =
+    a->dst_address_length - BITS (u8) * (dst_address_byte_index + 1);
+
+  dst_byte = a->dst_address.as_u8[dst_address_byte_index];
+  if (n_dst_bits_next_plies < 0)
+    dst_byte &= ~pow2_mask (-n_dst_bits_next_plies);
+
+  n_dst_bits_this_ply =
+    n_dst_bits_next_plies <= 0 ? -n_dst_bits_next_plies : 0;
+  n_dst_bits_this_ply = clib_min (8, n_dst_bits_this_ply);
+
+  del_leaf = ip4_mtrie_leaf_set_adj_index (a->adj_index);
+
+  for (i = dst_byte; i < dst_byte + (1 << n_dst_bits_this_ply); i++)
+    {
+      old_leaf = ply.leaves[i];
+
+      if (!ip4_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  sub_ply_index = ip4_mtrie_leaf_get_next_ply_index (old_leaf);
+	  if (!c_unset_leaf (a, &sub_ply_index, dst_address_byte_index + 1))
+	    {
+	      ply.leaves[i] = ip4_mtrie_leaf_set_next_ply_index (sub_ply_index);
+	      continue;
+	    }
+	}
+      else if (old_leaf != del_leaf)
+	continue;
+
+      ply.n_non_empty_leafs -= ip4_mtrie_leaf_is_non_empty (&ply, i);
+      ply.leaves[i] = ip4_mtrie_leaf_set_adj_index (a->cover_adj_index);
+      ply.dst_address_bits_of_leaves[i] = a->cover_address_length;
+      ply.n_non_empty_leafs += ip4_mtrie_leaf_is_non_empty (&ply, i);
+    }
+
+  ASSERT (ply.n_non_empty_leafs >= 0);
+  if (ply.n_non_empty_leafs == 0)
+    {
+      vec_add1 (ip4_c_plies_retired, *ply_index);
+      /* Old ply was deleted. */
+      return 1;
+    }
+
+  *ply_index = c_ply_replace (*ply_index, &ply);
+
+  /* Old ply was not deleted. */
+  return 0;
+}
+
+static void
+c_unset_root_leaf (ip4_mtrie_16c_t *m,
+		   const ip4_mtrie_set_unset_leaf_args_t *a)
+{
+  ip4_mtrie_leaf_t old_leaf, del_leaf;
+  i32 n_dst_bits_next_plies;
+  i32 i, n_dst_bits_this_ply;
+  ip4_mtrie_16_ply_t *old_ply;
+  u32 sub_ply_index;
+  u16 dst_byte;
+
+  ASSERT (a->dst_address_length <= 32);
+
+  old_ply = &m->root_ply;
+  n_dst_bits_next_plies = a->dst_address_length - BITS (u16);
+
+  dst_byte = a->dst_address.as_u16[0];
+
+  n_dst_bits_this_ply =
+    (n_dst_bits_next_plies <= 0 ? (16 - a->dst_address_length) : 0);
+
+  del_leaf = ip4_mtrie_leaf_set_adj_index (a->adj_index);
+
+  for (i = 0; i < (1 << n_dst_bits_this_ply); i++)
+    {
+      u16 slot;
+
+      slot = clib_net_to_host_u16 (dst_byte);
+      slot += i;
+      slot = clib_host_to_net_u16 (slot);
+
+      old_leaf = old_ply->leaves[slot];
+
+      if (!ip4_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  sub_ply_index = ip4_mtrie_leaf_get_next_ply_index (old_leaf);
+	  if (!c_unset_leaf (a, &sub_ply_index, 2))
+	    {
+	      clib_atomic_store_rel_n (
+		&old_ply->leaves[slot],
+		ip4_mtrie_leaf_set_next_ply_index (sub_ply_index));
+	      continue;
+	    }
+	}
+      else if (old_leaf != del_leaf)
+	continue;
+
+      clib_atomic_store_rel_n (
+	&old_ply->leaves[slot],
+	ip4_mtrie_leaf_set_adj_index (a->cover_adj_index));
+      old_ply->dst_address_bits_of_leaves[slot] = a->cover_address_length;
+    }
+}
+
+void
+ip4_mtrie_16c_route_add (ip4_mtrie_16c_t *m, const ip4_address_t *dst_address,
+			 u32 dst_address_length, u32 adj_index)
+{
+  ip4_main_t *im = &ip4_main;
+
+  /* Honor dst_address_length. Fib masks are in network byte order */
+  ip4_mtrie_set_unset_leaf_args_t a = {
+    .dst_address.as_u32 =
+      (dst_address->as_u32 & im->fib_masks[dst_address_length]),
+    .dst_address_length = dst_address_length,
+    .adj_index = adj_index,
+  };
+
+  c_set_root_leaf (m, &a);
+  c_plies_retired_free ();
+}
+
+void
+ip4_mtrie_16c_route_del (ip4_mtrie_16c_t *m, const ip4_address_t *dst_address,
+			 u32 dst_address_length, u32 adj_index,
+			 u32 cover_address_length, u32 cover_adj_index)
+{
+  ip4_main_t *im = &ip4_main;
+
+  /* Honor dst_address_length. Fib masks are in network byte order */
+  ip4_mtrie_set_unset_leaf_args_t a = {
+    .dst_address.as_u32 =
+      (dst_address->as_u32 & im->fib_masks[dst_address_length]),
+    .dst_address_length = dst_address_length,
+    .adj_index = adj_index,
+    .cover_adj_index = cover_adj_index,
+    .cover_address_length = cover_address_length,
+  };
+
+  /* the top level ply is never removed */
+  c_unset_root_leaf (m, &a);
+  c_plies_retired_free ();
+}
+
+void
+ip4_mtrie_16c_init (ip4_mtrie_16c_t *m)
+{
+  ply_16_init (&m->root_ply, IP4_MTRIE_LEAF_EMPTY, 0);
+}
+
+void
+ip4_mtrie_16c_free (ip4_mtrie_16c_t *m)
+{
+  /* the root ply is embedded so there is nothing to do,
+   * the assumption being that the IP4 FIB table has emptied the trie
+   * before deletion.
+   */
+#if CLIB_DEBUG > 0
+  int i;
+  for (i = 0; i < ARRAY_LEN (m->root_ply.leaves); i++)
+    {
+      ASSERT (!ip4_mtrie_leaf_is_next_ply (m->root_ply.leaves[i]));
+    }
+#endif
+}
+
 /* Returns number of bytes of memory used by mtrie. */
 static uword
 mtrie_ply_memory_usage (ip4_mtrie_8_ply_t *p)
@@ -717,6 +1292,67 @@ ip4_mtrie_8_memory_usage (ip4_mtrie_8_t *m)
   return bytes;
 }
 
+/* Returns number of bytes of memory used by a compressed ply and its
+ * children, or that they would use if they were not compressed. */
+static uword
+c_ply_memory_usage (ip4_mtrie_c_ply_t *p, int uncompressed)
+{
+  const ip4_mtrie_c_ply_ctl_t *ctl =
+    vec_elt_at_index (ip4_c_ply_ctls, p - ip4_c_ply_pool);
+  const ip4_mtrie_leaf_t *leaves = c_ply_leaves (p);
+  uword bytes, i;
+
+  if (uncompressed)
+    bytes = sizeof (ip4_mtrie_8_ply_t);
+  else
+    bytes = sizeof (p[0]) + vec_len (ctl->run_lens) +
+	    (p->leaves ? p->n_runs * sizeof (p->leaves[0]) : 0);
+
+  for (i = 0; i < p->n_runs; i++)
+    {
+      ip4_mtrie_leaf_t l = leaves[i];
+      if (ip4_mtrie_leaf_is_next_ply (l))
+	bytes += c_ply_memory_usage (
+	  pool_elt_at_index (ip4_c_ply_pool,
+			     ip4_mtrie_leaf_get_next_ply_index (l)),
+	  uncompressed);
+    }
+
+  return bytes;
+}
+
+static uword
+c_mtrie_memory_usage (ip4_mtrie_16c_t *m, int uncompressed)
+{
+  uword bytes, i;
+
+  bytes = sizeof (*m);
+  for (i = 0; i < ARRAY_LEN (m->root_ply.leaves); i++)
+    {
+      ip4_mtrie_leaf_t l = m->root_ply.leaves[i];
+      if (ip4_mtrie_leaf_is_next_ply (l))
+	bytes += c_ply_memory_usage (
+	  pool_elt_at_index (ip4_c_ply_pool,
+			     ip4_mtrie_leaf_get_next_ply_index (l)),
+	  uncompressed);
+    }
+
+  return bytes;
+}
+
+/* Returns number of bytes of memory used by mtrie. */
+uword
+ip4_mtrie_16c_memory_usage (ip4_mtrie_16c_t *m)
+{
+  return (c_mtrie_memory_usage (m, 0));
+}
+
+uword
+ip4_mtrie_16c_uncompressed_memory_usage (ip4_mtrie_16c_t *m)
+{
+  return (c_mtrie_memory_usage (m, 1));
+}
+
 static u8 *
 format_ip4_mtrie_leaf (u8 *s, va_list *va)
 {
@@ -840,6 +1476,94 @@ format_ip4_mtrie_8 (u8 *s, va_list *va)
   return s;
 }
 
+static u8 *
+format_ip4_mtrie_c_ply (u8 *s, va_list *va)
+{
+  u32 base_address = va_arg (*va, u32);
+  u32 indent = va_arg (*va, u32);
+  u32 ply_index = va_arg (*va, u32);
+  ip4_mtrie_8_ply_t p;
+  u32 a, ia_length;
+  ip4_address_t ia;
+  ip4_mtrie_leaf_t l;
+  int i;
+
+  c_ply_expand (ply_index, &p);
+  s = format (s, "%Uply index %d, %d runs, %d non-empty leaves",
+	      format_white_space, indent, ply_index,
+	      pool_elt_at_index (ip4_c_ply_pool, ply_index)->n_runs,
+	      p.n_non_empty_leafs);
+
+  for (i = 0; i < ARRAY_LEN (p.leaves); i++)
+    {
+      if (!ip4_mtrie_leaf_is_non_empty (&p, i))
+	continue;
+
+      l = p.leaves[i];
+      a = base_address + (i << (32 - (p.dst_address_bits_base + 8)));
+      ia.as_u32 = clib_host_to_net_u32 (a);
+      ia_length = p.dst_address_bits_of_leaves[i];
+      s = format (s, "\n%U%U %U", format_white_space, indent + 4,
+		  format_ip4_address_and_length, &ia, ia_length,
+		  format_ip4_mtrie_leaf, l);
+
+      if (ip4_mtrie_leaf_is_next_ply (l))
+	s = format (s, "\n%U", format_ip4_mtrie_c_ply, a, indent + 8,
+		    ip4_mtrie_leaf_get_next_ply_index (l));
+    }
+
+  return s;
+}
+
+u8 *
+format_ip4_mtrie_16c (u8 *s, va_list *va)
+{
+  ip4_mtrie_16c_t *m = va_arg (*va, ip4_mtrie_16c_t *);
+  int verbose = va_arg (*va, int);
+  ip4_mtrie_16_ply_t *p;
+  u32 a, ia_length;
+  ip4_address_t ia;
+  ip4_mtrie_leaf_t l;
+  int i;
+
+  s = format (s,
+	      "16-8-8 compressed: %d plies, memory usage %U, "
+	      "uncompressed %U\n",
+	      pool_elts (ip4_c_ply_pool), format_memory_size,
+	      ip4_mtrie_16c_memory_usage (m), format_memory_size,
+	      ip4_mtrie_16c_uncompressed_memory_usage (m));
+
+  if (verbose)
+    {
+      s = format (s, "root-ply");
+      p = &m->root_ply;
+
+      for (i = 0; i < ARRAY_LEN (p->leaves); i++)
+	{
+	  u16 slot;
+
+	  slot = clib_host_to_net_u16 (i);
+
+	  if (p->dst_address_bits_of_leaves[slot] == 0)
+	    continue;
+
+	  l = p->leaves[slot];
+	  a = i << 16;
+	  ia.as_u32 = clib_host_to_net_u32 (a);
+	  ia_length = p->dst_address_bits_of_leaves[slot];
+	  s = format (s, "\n%U%U %U", format_white_space, 4,
+		      format_ip4_address_and_length, &ia, ia_length,
+		      format_ip4_mtrie_leaf, l);
+
+	  if (ip4_mtrie_leaf_is_next_ply (l))
+	    s = format (s, "\n%U", format_ip4_mtrie_c_ply, a, 8,
+			ip4_mtrie_leaf_get_next_ply_index (l));
+	}
+    }
+
+  return s;
+}
+
 /** Default heap size for the IPv4 mtries */
 #define IP4_FIB_DEFAULT_MTRIE_HEAP_SIZE (32<<20)
 #ifndef MAP_HUGE_SHIFT
@@ -850,10 +1574,12 @@ static clib_error_t *
 ip4_mtrie_module_init (vlib_main_t * vm)
 {
   CLIB_UNUSED (ip4_mtrie_8_ply_t * p);
+  CLIB_UNUSED (ip4_mtrie_c_ply_t * cp);
   clib_error_t *error = NULL;
 
   /* Burn one ply so index 0 is taken */
   pool_get_aligned (ip4_ply_pool, p, CLIB_CACHE_LINE_BYTES);
+  pool_get_aligned (ip4_c_ply_pool, cp, CLIB_CACHE_LINE_BYTES);
 
   return (error);
 }
@@ -863,7 +1589,58 @@ VLIB_INIT_FUNCTION (ip4_mtrie_module_init);
 void
 ip4_mtrie_pool_alloc (uword size)
 {
+#ifdef VPP_IP_FIB_MTRIE_16_COMPRESSED
+  pool_alloc_aligned (ip4_c_ply_pool, size, CLIB_CACHE_LINE_BYTES);
+#else
   pool_alloc_aligned (ip4_ply_pool, size, CLIB_CACHE_LINE_BYTES);
+#endif
+}
+
+static uword
+ip4_mtrie_pool_free_elts (void)
+{
+#ifdef VPP_IP_FIB_MTRIE_16_COMPRESSED
+  return (pool_free_elts (ip4_c_ply_pool));
+#else
+  return (pool_free_elts (ip4_ply_pool));
+#endif
+}
+
+int
+ip4_mtrie_pool_will_expand (uword n_plies)
+{
+  return (ip4_mtrie_pool_free_elts () < n_plies);
+}
+
+void
+ip4_mtrie_pool_reserve (uword n_plies)
+{
+  uword n_free = ip4_mtrie_pool_free_elts ();
+
+  if (n_free < n_plies)
+    ip4_mtrie_pool_alloc (n_plies - n_free);
+}
+
+void
+ip4_mtrie_batch_begin (void)
+{
+  ip4_mtrie_batch_depth++;
+}
+
+void
+ip4_mtrie_batch_end (void)
+{
+  ASSERT (ip4_mtrie_batch_depth > 0);
+
+  if (--ip4_mtrie_batch_depth)
+    return;
+
+  if (vec_len (ip4_c_plies_retired))
+    {
+      /* let the workers finish any walk through the replaced plies */
+      vlib_worker_wait_one_loop ();
+      c_plies_retired_free ();
+    }
 }
 
 /*
@@ -105,6 +105,51 @@ typedef struct ip4_mtrie_8_ply_t_
 STATIC_ASSERT (0 == sizeof (ip4_mtrie_8_ply_t) % CLIB_CACHE_LINE_BYTES,
 	       "IP4 Mtrie ply cache line");
 
+/**
+ * @brief Number of leaves held in the compressed ply's own cache line
+ */
+#define IP4_MTRIE_C_PLY_N_INLINE_LEAVES 4
+
+/**
+ * @brief One compressed 8 bit ply.
+ * Slots with the same leaf and prefix length come in runs; each run's leaf
+ * is stored once and a bit set in the run_starts bitmap marks the slot at
+ * which each run begins. The leaf for a slot is found by counting the set
+ * bits up to and including the slot's. Plies with no more than
+ * IP4_MTRIE_C_PLY_N_INLINE_LEAVES runs (the common case for plies under a
+ * /16 holding a few /24s) fit entirely in one cache line.
+ * A published ply is never modified; updates build a replacement ply and
+ * swap the leaf that points to it.
+ */
+typedef struct ip4_mtrie_c_ply_t_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /**
+   * Bit N set if slot N starts a new run. Bit 0 is always set.
+   */
+  u64 run_starts[4];
+
+  /**
+   * Number of runs starting in the preceding bitmap words (at most 192).
+   */
+  u8 n_runs_before[4];
+
+  /**
+   * Number of runs, hence of leaves.
+   */
+  u32 n_runs;
+
+  /**
+   * Leaves, one per run, if they do not fit in inline_leaves.
+   */
+  ip4_mtrie_leaf_t *leaves;
+
+  ip4_mtrie_leaf_t inline_leaves[IP4_MTRIE_C_PLY_N_INLINE_LEAVES];
+} ip4_mtrie_c_ply_t;
+
+STATIC_ASSERT (sizeof (ip4_mtrie_c_ply_t) == CLIB_CACHE_LINE_BYTES,
+	       "IP4 Mtrie compressed ply cache line");
+
 /**
  * @brief The mutiway-TRIE with a 16-8-8 stride.
  * There is no data associated with the mtrie apart from the top PLY
@@ -129,17 +174,30 @@ typedef struct
   u32 root_ply;
 } ip4_mtrie_8_t;
 
+/**
+ * @brief The mutiway-TRIE with a 16-8-8 stride and compressed 8 bit plies.
+ * The root is the same flat 16 bit ply as ip4_mtrie_16_t, so the first
+ * step costs one cache line; each further step costs one line for plies
+ * with few runs and two otherwise.
+ */
+typedef struct
+{
+  ip4_mtrie_16_ply_t root_ply;
+} ip4_mtrie_16c_t;
+
 /**
  * @brief Initialise an mtrie
  */
 void ip4_mtrie_16_init (ip4_mtrie_16_t *m);
 void ip4_mtrie_8_init (ip4_mtrie_8_t *m);
+void ip4_mtrie_16c_init (ip4_mtrie_16c_t *m);
 
 /**
  * @brief Free an mtrie, It must be empty when free'd
  */
 void ip4_mtrie_16_free (ip4_mtrie_16_t *m);
 void ip4_mtrie_8_free (ip4_mtrie_8_t *m);
+void ip4_mtrie_16c_free (ip4_mtrie_16c_t *m);
 
 /**
  * @brief Add a route/entry to the mtrie
@@ -149,6 +207,9 @@ void ip4_mtrie_16_route_add (ip4_mtrie_16_t *m,
 			     u32 dst_address_length, u32 adj_index);
 void ip4_mtrie_8_route_add (ip4_mtrie_8_t *m, const ip4_address_t *dst_address,
 			    u32 dst_address_length, u32 adj_index);
+void ip4_mtrie_16c_route_add (ip4_mtrie_16c_t *m,
+			      const ip4_address_t *dst_address,
+			      u32 dst_address_length, u32 adj_index);
 
 /**
  * @brief remove a route/entry to the mtrie
@@ -160,29 +221,66 @@ void ip4_mtrie_16_route_del (ip4_mtrie_16_t *m,
 void ip4_mtrie_8_route_del (ip4_mtrie_8_t *m, const ip4_address_t *dst_address,
 			    u32 dst_address_length, u32 adj_index,
 			    u32 cover_address_length, u32 cover_adj_index);
+void ip4_mtrie_16c_route_del (ip4_mtrie_16c_t *m,
+			      const ip4_address_t *dst_address,
+			      u32 dst_address_length, u32 adj_index,
+			      u32 cover_address_length, u32 cover_adj_index);
 
 /**
  * @brief return the memory used by the table
  */
 uword ip4_mtrie_16_memory_usage (ip4_mtrie_16_t *m);
 uword ip4_mtrie_8_memory_usage (ip4_mtrie_8_t *m);
+uword ip4_mtrie_16c_memory_usage (ip4_mtrie_16c_t *m);
+
+/**
+ * @brief return the memory the compressed table would use uncompressed,
+ * i.e. as an ip4_mtrie_16_t
+ */
+uword ip4_mtrie_16c_uncompressed_memory_usage (ip4_mtrie_16c_t *m);
 
 /**
  * @brief Format/display the contents of the mtrie
  */
 format_function_t format_ip4_mtrie_16;
 format_function_t format_ip4_mtrie_8;
+format_function_t format_ip4_mtrie_16c;
 
 /**
  * @brief A global pool of 8bit stride plys
  */
 extern ip4_mtrie_8_ply_t *ip4_ply_pool;
 
+/**
+ * @brief A global pool of compressed 8bit stride plys
+ */
+extern ip4_mtrie_c_ply_t *ip4_c_ply_pool;
+
 /**
  * @brief Pre-allocate the pool of plys
  */
 extern void ip4_mtrie_pool_alloc (uword size);
 
+/**
+ * @brief Would adding n_plies plies expand, i.e. move, the pool of plys
+ */
+extern int ip4_mtrie_pool_will_expand (uword n_plies);
+
+/**
+ * @brief Make room in the pool for n_plies more plys, so that later
+ * updates do not need to sync the workers. Moves the pool, so the caller
+ * must hold the worker barrier if ip4_mtrie_pool_will_expand.
+ */
+extern void ip4_mtrie_pool_reserve (uword n_plies);
+
+/**
+ * @brief Start/end a batch of updates. The plies replaced during a batch
+ * are freed at its end, once the workers are no longer using them.
+ * Batches nest.
+ */
+extern void ip4_mtrie_batch_begin (void);
+extern void ip4_mtrie_batch_end (void);
+
 /**
  * Is the leaf terminal (i.e. an LB index) or non-terminal (i.e. a PLY index)
  */
@@ -268,6 +366,49 @@ ip4_mtrie_8_lookup_step_one (const ip4_mtrie_8_t *m,
   return next_leaf;
 }
 
+/**
+ * @brief Find the leaf for a slot of a compressed ply.
+ */
+always_inline ip4_mtrie_leaf_t
+ip4_mtrie_c_ply_get_leaf (const ip4_mtrie_c_ply_t *ply, u8 slot)
+{
+  const ip4_mtrie_leaf_t *leaves;
+  u64 run_starts;
+
+  /* the runs starting at or before the slot */
+  run_starts = ply->run_starts[slot >> 6] & (((u64) 2 << (slot & 63)) - 1);
+  leaves = ply->leaves ? ply->leaves : ply->inline_leaves;
+
+  return (leaves[ply->n_runs_before[slot >> 6] + count_set_bits (run_starts) -
+		 1]);
+}
+
+always_inline ip4_mtrie_leaf_t
+ip4_mtrie_16c_lookup_step (ip4_mtrie_leaf_t current_leaf,
+			   const ip4_address_t *dst_address,
+			   u32 dst_address_byte_index)
+{
+  ip4_mtrie_c_ply_t *ply;
+
+  uword current_is_terminal = ip4_mtrie_leaf_is_terminal (current_leaf);
+
+  if (!current_is_terminal)
+    {
+      ply = ip4_c_ply_pool + (current_leaf >> 1);
+      return (ip4_mtrie_c_ply_get_leaf (
+	ply, dst_address->as_u8[dst_address_byte_index]));
+    }
+
+  return current_leaf;
+}
+
+always_inline ip4_mtrie_leaf_t
+ip4_mtrie_16c_lookup_step_one (const ip4_mtrie_16c_t *m,
+			       const ip4_address_t *dst_address)
+{
+  return (m->root_ply.leaves[dst_address->as_u16[0]]);
+}
+
 #endif /* included_ip_ip4_fib_h */
 
 /*
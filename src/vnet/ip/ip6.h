@@ -45,6 +45,7 @@
 #include <vlib/buffer.h>
 
 #include <vnet/ip/ip6_packet.h>
+#include <vnet/ip/ip6_mtrie.h>
 #include <vnet/ip/ip46_address.h>
 #include <vnet/ip/ip6_hop_by_hop_packet.h>
 #include <vnet/ip/lookup.h>
@@ -73,6 +74,12 @@ typedef struct
    * The hash table DB
    */
   uword *fib_entry_by_dst_address;
+
+  /**
+   * Mtrie for forwarding lookups, if enabled. The forwarding hash table
+   * is maintained regardless.
+   */
+  ip6_mtrie_t *mtrie;
 } ip6_fib_t;
 
 typedef struct ip6_mfib_t
@@ -1782,6 +1782,11 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
   n_left_from = frame->n_vectors;
   next_index = node->cached_next_index;
   clib_thread_index_t thread_index = vm->thread_index;
+  vlib_combined_counter_acc_t adj_acc;
+
+  if (do_counters)
+    vlib_combined_counter_acc_init (&adj_acc, &adjacency_counters,
+				    thread_index);
 
   while (n_left_from > 0)
     {
@@ -1966,12 +1971,12 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
 	  if (do_counters)
 	    {
 	      if (error0 == IP6_ERROR_NONE)
-		vlib_increment_combined_counter (
-		  &adjacency_counters, thread_index, adj_index0, 1,
+		vlib_combined_counter_acc_add (
+		  &adj_acc, adj_index0, 1,
 		  vlib_buffer_length_in_chain (vm, p0) + rw_len0);
 	      if (error1 == IP6_ERROR_NONE)
-		vlib_increment_combined_counter (
-		  &adjacency_counters, thread_index, adj_index1, 1,
+		vlib_combined_counter_acc_add (
+		  &adj_acc, adj_index1, 1,
 		  vlib_buffer_length_in_chain (vm, p1) + rw_len1);
 	    }
 
@@ -2094,8 +2099,8 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
 
 	      if (do_counters)
 		{
-		  vlib_increment_combined_counter (
-		    &adjacency_counters, thread_index, adj_index0, 1,
+		  vlib_combined_counter_acc_add (
+		    &adj_acc, adj_index0, 1,
 		    vlib_buffer_length_in_chain (vm, p0) + rw_len0);
 		}
 
@@ -2124,6 +2129,9 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
       vlib_put_next_frame (vm, node, next_index, n_left_to_next);
     }
 
+  if (do_counters)
+    vlib_combined_counter_acc_flush (&adj_acc);
+
   /* Need to do trace after rewrites to pick up new packet data. */
   if (node->flags & VLIB_NODE_FLAG_TRACE)
     ip6_forward_next_trace (vm, node, frame, VLIB_TX);
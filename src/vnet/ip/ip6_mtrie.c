@@ -0,0 +1,926 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * ip/ip6_mtrie.c: ip6 multi-bit trie for forwarding lookups
+ *
+ * The update rules are those of the IPv4 mtrie (see ip4_mtrie.c). Since a
+ * published ply is never modified, each update expands the plies on its
+ * path into scratch space, changes them there, compresses them into new
+ * plies and swaps the new plies in bottom up. The plies replaced are
+ * returned to the pool once the update has reached the root.
+ */
+
+#include <vnet/ip/ip.h>
+#include <vnet/ip/ip6_mtrie.h>
+
+/**
+ * Global pool of IPv6 PLYs
+ */
+ip6_mtrie_ply_t *ip6_ply_pool;
+
+/**
+ * An uncompressed ply, the control plane's working copy
+ */
+typedef struct ip6_mtrie_expanded_ply_t_
+{
+  ip6_mtrie_leaf_t leaves[256];
+
+  /**
+   * Prefix length for leaves/ply.
+   */
+  u8 dst_address_bits_of_leaves[256];
+
+  /**
+   * Number of non-empty leafs (whether terminal or not).
+   */
+  i32 n_non_empty_leafs;
+
+  /**
+   * The length of the ply's covering prefix. If a leaf in a slot has a
+   * mask length longer than this then it is 'non-empty'. Otherwise it is
+   * the value of the cover.
+   */
+  i32 dst_address_bits_base;
+} ip6_mtrie_expanded_ply_t;
+
+/**
+ * The control plane's view of a ply. Indexed as the pool.
+ */
+typedef struct ip6_mtrie_ply_ctl_t_
+{
+  /**
+   * Prefix length for the leaf of each run.
+   */
+  u8 *run_lens;
+
+  /**
+   * The length of the ply's covering prefix.
+   */
+  i32 dst_address_bits_base;
+} ip6_mtrie_ply_ctl_t;
+
+static ip6_mtrie_ply_ctl_t *ip6_ply_ctls;
+
+/**
+ * Plies replaced by the update in progress
+ */
+static u32 *ip6_plies_retired;
+
+/**
+ * Non-zero while a batch of updates is in progress. The replaced plies are
+ * then kept until the batch ends.
+ */
+static u32 ip6_mtrie_batch_depth;
+
+/**
+ * Scratch plies, one per address byte. An update works on a single ply
+ * at each depth at a time, and the depth can reach 14, which is too much
+ * to keep on a process' stack.
+ */
+static ip6_mtrie_expanded_ply_t ip6_mtrie_scratch[16];
+
+typedef struct
+{
+  ip6_address_t dst_address;
+  u32 dst_address_length;
+  u32 adj_index;
+  u32 cover_address_length;
+  u32 cover_adj_index;
+} ip6_mtrie_set_unset_leaf_args_t;
+
+always_inline u32
+ip6_mtrie_leaf_is_non_empty (ip6_mtrie_expanded_ply_t *p, u8 dst_byte)
+{
+  /*
+   * It's 'non-empty' if the length of the leaf stored is greater than the
+   * length of a leaf in the covering ply. i.e. the leaf is more specific
+   * than it's would be cover in the covering ply
+   */
+  if (p->dst_address_bits_of_leaves[dst_byte] > p->dst_address_bits_base)
+    return (1);
+  return (0);
+}
+
+always_inline ip6_mtrie_leaf_t
+ip6_mtrie_leaf_set_adj_index (u32 adj_index)
+{
+  ip6_mtrie_leaf_t l;
+  l = 1 + 2 * adj_index;
+  ASSERT (ip6_mtrie_leaf_get_adj_index (l) == adj_index);
+  return l;
+}
+
+always_inline u32
+ip6_mtrie_leaf_is_next_ply (ip6_mtrie_leaf_t n)
+{
+  return (n & 1) == 0;
+}
+
+always_inline u32
+ip6_mtrie_leaf_get_next_ply_index (ip6_mtrie_leaf_t n)
+{
+  ASSERT (ip6_mtrie_leaf_is_next_ply (n));
+  return n >> 1;
+}
+
+always_inline ip6_mtrie_leaf_t
+ip6_mtrie_leaf_set_next_ply_index (u32 i)
+{
+  ip6_mtrie_leaf_t l;
+  l = 0 + 2 * i;
+  ASSERT (ip6_mtrie_leaf_get_next_ply_index (l) == i);
+  return l;
+}
+
+always_inline const ip6_mtrie_leaf_t *
+ply_leaves (const ip6_mtrie_ply_t *p)
+{
+  return (p->leaves ? p->leaves : p->inline_leaves);
+}
+
+static void
+ply_init (ip6_mtrie_expanded_ply_t *e, ip6_mtrie_leaf_t init,
+	  uword prefix_len, u32 ply_base_len)
+{
+  e->n_non_empty_leafs =
+    prefix_len > ply_base_len ? ARRAY_LEN (e->leaves) : 0;
+  clib_memset_u8 (e->dst_address_bits_of_leaves, prefix_len,
+		  sizeof (e->dst_address_bits_of_leaves));
+  e->dst_address_bits_base = ply_base_len;
+
+  clib_memset_u32 (e->leaves, init, ARRAY_LEN (e->leaves));
+}
+
+static void
+ply_expand (u32 ply_index, ip6_mtrie_expanded_ply_t *e)
+{
+  const ip6_mtrie_ply_t *p = pool_elt_at_index (ip6_ply_pool, ply_index);
+  const ip6_mtrie_ply_ctl_t *ctl = vec_elt_at_index (ip6_ply_ctls, ply_index);
+  const ip6_mtrie_leaf_t *leaves = ply_leaves (p);
+  i32 run = -1;
+  u32 i;
+
+  e->dst_address_bits_base = ctl->dst_address_bits_base;
+  e->n_non_empty_leafs = 0;
+
+  for (i = 0; i < ARRAY_LEN (e->leaves); i++)
+    {
+      run += (p->run_starts[i / 64] >> (i % 64)) & 1;
+      e->leaves[i] = leaves[run];
+      e->dst_address_bits_of_leaves[i] = ctl->run_lens[run];
+      e->n_non_empty_leafs += ip6_mtrie_leaf_is_non_empty (e, i);
+    }
+}
+
+static u32
+ply_create (const ip6_mtrie_expanded_ply_t *e)
+{
+  static ip6_mtrie_leaf_t leaves[ARRAY_LEN (e->leaves)];
+  ip6_mtrie_ply_ctl_t *ctl;
+  ip6_mtrie_ply_t *p;
+  u32 i, ply_index, n_runs = 0;
+  u8 need_barrier_sync = pool_get_will_expand (ip6_ply_pool);
+  vlib_main_t *vm = vlib_get_main ();
+  ASSERT (vm->thread_index == 0);
+
+  /* the new ply is not visible until the caller links it in, only
+   * the move of the pool needs protecting */
+  if (need_barrier_sync)
+    vlib_worker_thread_barrier_sync (vm);
+
+  pool_get_aligned (ip6_ply_pool, p, CLIB_CACHE_LINE_BYTES);
+
+  if (need_barrier_sync)
+    vlib_worker_thread_barrier_release (vm);
+
+  ply_index = p - ip6_ply_pool;
+  vec_validate (ip6_ply_ctls, ply_index);
+  ctl = vec_elt_at_index (ip6_ply_ctls, ply_index);
+  vec_reset_length (ctl->run_lens);
+  clib_memset (p, 0, sizeof (*p));
+
+  for (i = 0; i < ARRAY_LEN (e->leaves); i++)
+    {
+      if (i == 0 || e->leaves[i] != e->leaves[i - 1] ||
+	  e->dst_address_bits_of_leaves[i] !=
+	    e->dst_address_bits_of_leaves[i - 1])
+	{
+	  p->run_starts[i / 64] |= 1ULL << (i % 64);
+	  leaves[n_runs++] = e->leaves[i];
+	  vec_add1 (ctl->run_lens, e->dst_address_bits_of_leaves[i]);
+	}
+    }
+
+  for (i = 1; i < ARRAY_LEN (p->n_runs_before); i++)
+    p->n_runs_before[i] =
+      p->n_runs_before[i - 1] + count_set_bits (p->run_starts[i - 1]);
+
+  p->n_runs = n_runs;
+  if (n_runs > ARRAY_LEN (p->inline_leaves))
+    {
+      p->leaves = clib_mem_alloc_aligned (n_runs * sizeof (leaves[0]),
+					  CLIB_CACHE_LINE_BYTES);
+      clib_memcpy (p->leaves, leaves, n_runs * sizeof (leaves[0]));
+    }
+  else
+    clib_memcpy (p->inline_leaves, leaves, n_runs * sizeof (leaves[0]));
+
+  ctl->dst_address_bits_base = e->dst_address_bits_base;
+
+  return (ply_index);
+}
+
+static void
+ply_retire (u32 ply_index)
+{
+  vec_add1 (ip6_plies_retired, ply_index);
+}
+
+static void
+plies_retired_free (void)
+{
+  ip6_mtrie_ply_t *p;
+  u32 *ply_index;
+
+  if (ip6_mtrie_batch_depth)
+    return;
+
+  vec_foreach (ply_index, ip6_plies_retired)
+    {
+      p = pool_elt_at_index (ip6_ply_pool, *ply_index);
+      if (p->leaves)
+	clib_mem_free (p->leaves);
+      pool_put (ip6_ply_pool, p);
+    }
+  vec_reset_length (ip6_plies_retired);
+}
+
+static u32
+set_ply_with_more_specific_leaf (u32 ply_index, u32 dst_address_byte_index,
+				 ip6_mtrie_leaf_t new_leaf,
+				 uword new_leaf_dst_address_bits)
+{
+  ip6_mtrie_expanded_ply_t *ply;
+  ip6_mtrie_leaf_t old_leaf;
+  u32 new_ply_index;
+  uword i;
+
+  ASSERT (ip6_mtrie_leaf_is_terminal (new_leaf));
+
+  ply = &ip6_mtrie_scratch[dst_address_byte_index];
+  ply_expand (ply_index, ply);
+
+  for (i = 0; i < ARRAY_LEN (ply->leaves); i++)
+    {
+      old_leaf = ply->leaves[i];
+
+      /* Recurse into sub plies. */
+      if (!ip6_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  new_ply_index = set_ply_with_more_specific_leaf (
+	    ip6_mtrie_leaf_get_next_ply_index (old_leaf),
+	    dst_address_byte_index + 1, new_leaf, new_leaf_dst_address_bits);
+	  ply->leaves[i] = ip6_mtrie_leaf_set_next_ply_index (new_ply_index);
+	}
+
+      /* Replace less specific terminal leaves with new leaf. */
+      else if (new_leaf_dst_address_bits >=
+	       ply->dst_address_bits_of_leaves[i])
+	{
+	  ply->leaves[i] = new_leaf;
+	  ply->dst_address_bits_of_leaves[i] = new_leaf_dst_address_bits;
+	}
+    }
+
+  ply_retire (ply_index);
+
+  return (ply_create (ply));
+}
+
+static u32 set_leaf (const ip6_mtrie_set_unset_leaf_args_t *a,
+		     u32 old_ply_index, u32 dst_address_byte_index);
+
+/*
+ * Set the leaf in the expanded ply at the given depth, returns the index
+ * of the ply built from it.
+ */
+static u32
+set_leaf_in_ply (const ip6_mtrie_set_unset_leaf_args_t *a,
+		 u32 dst_address_byte_index)
+{
+  ip6_mtrie_expanded_ply_t *ply, *new_ply;
+  ip6_mtrie_leaf_t old_leaf, new_leaf;
+  i32 n_dst_bits_next_plies;
+  u32 new_ply_index;
+  u8 dst_byte;
+
+  ASSERT (a->dst_address_length <= 128);
+  ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
+
+  ply = &ip6_mtrie_scratch[dst_address_byte_index];
+
+  /* how many bits of the destination address are in the next PLY */
+  n_dst_bits_next_plies =
+    a->dst_address_length - BITS (u8) * (dst_address_byte_index + 1);
+
+  dst_byte = a->dst_address.as_u8[dst_address_byte_index];
+
+  /* Number of bits next plies <= 0 => insert leaves this ply. */
+  if (n_dst_bits_next_plies <= 0)
+    {
+      /* The mask length of the address to insert maps to this ply */
+      uword old_leaf_is_terminal;
+      u32 i, n_dst_bits_this_ply;
+
+      /* The number of bits, and hence slots/buckets, we will fill */
+      n_dst_bits_this_ply = clib_min (8, -n_dst_bits_next_plies);
+      ASSERT ((a->dst_address.as_u8[dst_address_byte_index] &
+	       pow2_mask (n_dst_bits_this_ply)) == 0);
+
+      for (i = dst_byte; i < dst_byte + (1 << n_dst_bits_this_ply); i++)
+	{
+	  old_leaf = ply->leaves[i];
+	  old_leaf_is_terminal = ip6_mtrie_leaf_is_terminal (old_leaf);
+
+	  if (a->dst_address_length >= ply->dst_address_bits_of_leaves[i])
+	    {
+	      /* The new leaf is more or equally specific than the one currently
+	       * occupying the slot */
+	      new_leaf = ip6_mtrie_leaf_set_adj_index (a->adj_index);
+
+	      if (old_leaf_is_terminal)
+		{
+		  ply->dst_address_bits_of_leaves[i] = a->dst_address_length;
+		  ply->leaves[i] = new_leaf;
+		}
+	      else
+		{
+		  /* Existing leaf points to another ply.  We need to place
+		   * new_leaf into all more specific slots. */
+		  new_ply_index = set_ply_with_more_specific_leaf (
+		    ip6_mtrie_leaf_get_next_ply_index (old_leaf),
+		    dst_address_byte_index + 1, new_leaf,
+		    a->dst_address_length);
+		  ply->leaves[i] =
+		    ip6_mtrie_leaf_set_next_ply_index (new_ply_index);
+		}
+	    }
+	  else if (!old_leaf_is_terminal)
+	    {
+	      /* The current leaf is less specific and not terminal (i.e. a
+	       * ply), recurse on down the trie */
+	      new_ply_index =
+		set_leaf (a, ip6_mtrie_leaf_get_next_ply_index (old_leaf),
+			  dst_address_byte_index + 1);
+	      ply->leaves[i] = ip6_mtrie_leaf_set_next_ply_index (new_ply_index);
+	    }
+	  /*
+	   * else
+	   *  the route we are adding is less specific than the leaf currently
+	   *  occupying this slot. leave it there
+	   */
+	}
+    }
+  else
+    {
+      /* The address to insert requires us to move down at a lower level of
+       * the trie - recurse on down */
+      u8 ply_base_len;
+
+      ply_base_len = 8 * (dst_address_byte_index + 1);
+
+      old_leaf = ply->leaves[dst_byte];
+
+      if (ip6_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  /* There is a leaf occupying the slot. Replace it with a new ply */
+	  new_ply = &ip6_mtrie_scratch[dst_address_byte_index + 1];
+	  ply_init (new_ply, old_leaf,
+		    ply->dst_address_bits_of_leaves[dst_byte], ply_base_len);
+	  new_ply_index = set_leaf_in_ply (a, dst_address_byte_index + 1);
+	  ply->dst_address_bits_of_leaves[dst_byte] = ply_base_len;
+	}
+      else
+	new_ply_index =
+	  set_leaf (a, ip6_mtrie_leaf_get_next_ply_index (old_leaf),
+		    dst_address_byte_index + 1);
+
+      ply->leaves[dst_byte] = ip6_mtrie_leaf_set_next_ply_index (new_ply_index);
+    }
+
+  return (ply_create (ply));
+}
+
+static u32
+set_leaf (const ip6_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
+	  u32 dst_address_byte_index)
+{
+  ply_expand (old_ply_index, &ip6_mtrie_scratch[dst_address_byte_index]);
+  ply_retire (old_ply_index);
+
+  return (set_leaf_in_ply (a, dst_address_byte_index));
+}
+
+static void
+set_root_leaf (ip6_mtrie_t *m, const ip6_mtrie_set_unset_leaf_args_t *a)
+{
+  ip6_mtrie_leaf_t old_leaf, new_leaf;
+  i32 n_dst_bits_next_plies;
+  u32 new_ply_index;
+  u16 dst_byte;
+
+  ASSERT (a->dst_address_length <= 128);
+
+  /* how many bits of the destination address are in the next PLY */
+  n_dst_bits_next_plies = a->dst_address_length - BITS (u16);
+
+  dst_byte = a->dst_address.as_u16[0];
+
+  /* Number of bits next plies <= 0 => insert leaves this ply. */
+  if (n_dst_bits_next_plies <= 0)
+    {
+      /* The mask length of the address to insert maps to this ply */
+      uword old_leaf_is_terminal;
+      u32 i, n_dst_bits_this_ply;
+
+      /* The number of bits, and hence slots/buckets, we will fill */
+      n_dst_bits_this_ply = 16 - a->dst_address_length;
+      ASSERT ((clib_host_to_net_u16 (a->dst_address.as_u16[0]) &
+	       pow2_mask (n_dst_bits_this_ply)) == 0);
+
+      /* Starting at the value of the byte at this section of the v6 address
+       * fill the buckets/slots of the ply */
+      for (i = 0; i < (1 << n_dst_bits_this_ply); i++)
+	{
+	  u16 slot;
+
+	  slot = clib_net_to_host_u16 (dst_byte);
+	  slot += i;
+	  slot = clib_host_to_net_u16 (slot);
+
+	  old_leaf = m->leaves[slot];
+	  old_leaf_is_terminal = ip6_mtrie_leaf_is_terminal (old_leaf);
+
+	  if (a->dst_address_length >= m->dst_address_bits_of_leaves[slot])
+	    {
+	      /* The new leaf is more or equally specific than the one currently
+	       * occupying the slot */
+	      new_leaf = ip6_mtrie_leaf_set_adj_index (a->adj_index);
+
+	      if (old_leaf_is_terminal)
+		{
+		  /* The current leaf is terminal, we can replace it with
+		   * the new one */
+		  m->dst_address_bits_of_leaves[slot] = a->dst_address_length;
+		  clib_atomic_store_rel_n (&m->leaves[slot], new_leaf);
+		}
+	      else
+		{
+		  /* Existing leaf points to another ply.  We need to place
+		   * new_leaf into all more specific slots. */
+		  new_ply_index = set_ply_with_more_specific_leaf (
+		    ip6_mtrie_leaf_get_next_ply_index (old_leaf), 2, new_leaf,
+		    a->dst_address_length);
+		  clib_atomic_store_rel_n (
+		    &m->leaves[slot],
+		    ip6_mtrie_leaf_set_next_ply_index (new_ply_index));
+		}
+	    }
+	  else if (!old_leaf_is_terminal)
+	    {
+	      /* The current leaf is less specific and not terminal (i.e. a
+	       * ply), recurse on down the trie */
+	      new_ply_index =
+		set_leaf (a, ip6_mtrie_leaf_get_next_ply_index (old_leaf), 2);
+	      clib_atomic_store_rel_n (
+		&m->leaves[slot],
+		ip6_mtrie_leaf_set_next_ply_index (new_ply_index));
+	    }
+	}
+    }
+  else
+    {
+      /* The address to insert requires us to move down at a lower level of
+       * the trie - recurse on down */
+      old_leaf = m->leaves[dst_byte];
+
+      if (ip6_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  /* There is a leaf occupying the slot. Replace it with a new ply */
+	  ply_init (&ip6_mtrie_scratch[2], old_leaf,
+		    m->dst_address_bits_of_leaves[dst_byte], 16);
+	  new_ply_index = set_leaf_in_ply (a, 2);
+	  m->dst_address_bits_of_leaves[dst_byte] = 16;
+	}
+      else
+	new_ply_index =
+	  set_leaf (a, ip6_mtrie_leaf_get_next_ply_index (old_leaf), 2);
+
+      clib_atomic_store_rel_n (
+	&m->leaves[dst_byte],
+	ip6_mtrie_leaf_set_next_ply_index (new_ply_index));
+    }
+}
+
+/*
+ * Returns 1 if the ply is now empty and was deleted, otherwise 0 and the
+ * index of its replacement.
+ */
+static uword
+unset_leaf (const ip6_mtrie_set_unset_leaf_args_t *a, u32 *ply_index,
+	    u32 dst_address_byte_index)
+{
+  ip6_mtrie_leaf_t old_leaf, del_leaf;
+  ip6_mtrie_expanded_ply_t *ply;
+  i32 n_dst_bits_next_plies;
+  i32 i, n_dst_bits_this_ply;
+  u32 sub_ply_index;
+  u8 dst_byte;
+
+  ASSERT (a->dst_address_length <= 128);
+  ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
+
+  ply = &ip6_mtrie_scratch[dst_address_byte_index];
+  ply_expand (*ply_index, ply);
+
+  n_dst_bits_next_plies =
+    a->dst_address_length - BITS (u8) * (dst_address_byte_index + 1);
+
+  dst_byte = a->dst_address.as_u8[dst_address_byte_index];
+  if (n_dst_bits_next_plies < 0)
+    dst_byte &= ~pow2_mask (-n_dst_bits_next_plies);
+
+  n_dst_bits_this_ply =
+    n_dst_bits_next_plies <= 0 ? -n_dst_bits_next_plies : 0;
+  n_dst_bits_this_ply = clib_min (8, n_dst_bits_this_ply);
+
+  del_leaf = ip6_mtrie_leaf_set_adj_index (a->adj_index);
+
+  for (i = dst_byte; i < dst_byte + (1 << n_dst_bits_this_ply); i++)
+    {
+      old_leaf = ply->leaves[i];
+
+      if (!ip6_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  sub_ply_index = ip6_mtrie_leaf_get_next_ply_index (old_leaf);
+	  if (!unset_leaf (a, &sub_ply_index, dst_address_byte_index + 1))
+	    {
+	      ply->leaves[i] = ip6_mtrie_leaf_set_next_ply_index (sub_ply_index);
+	      continue;
+	    }
+	}
+      else if (old_leaf != del_leaf)
+	continue;
+
+      ply->n_non_empty_leafs -= ip6_mtrie_leaf_is_non_empty (ply, i);
+      ply->leaves[i] = ip6_mtrie_leaf_set_adj_index (a->cover_adj_index);
+      ply->dst_address_bits_of_leaves[i] = a->cover_address_length;
+      ply->n_non_empty_leafs += ip6_mtrie_leaf_is_non_empty (ply, i);
+    }
+
+  ply_retire (*ply_index);
+
+  ASSERT (ply->n_non_empty_leafs >= 0);
+  if (ply->n_non_empty_leafs == 0)
+    /* Old ply was deleted. */
+    return 1;
+
+  *ply_index = ply_create (ply);
+
+  /* Old ply was not deleted. */
+  return 0;
+}
+
+static void
+unset_root_leaf (ip6_mtrie_t *m, const ip6_mtrie_set_unset_leaf_args_t *a)
+{
+  ip6_mtrie_leaf_t old_leaf, del_leaf;
+  i32 n_dst_bits_next_plies;
+  i32 i, n_dst_bits_this_ply;
+  u32 sub_ply_index;
+  u16 dst_byte;
+
+  ASSERT (a->dst_address_length <= 128);
+
+  n_dst_bits_next_plies = a->dst_address_length - BITS (u16);
+
+  dst_byte = a->dst_address.as_u16[0];
+
+  n_dst_bits_this_ply =
+    (n_dst_bits_next_plies <= 0 ? (16 - a->dst_address_length) : 0);
+
+  del_leaf = ip6_mtrie_leaf_set_adj_index (a->adj_index);
+
+  /* Starting at the value of the byte at this section of the v6 address
+   * fill the buckets/slots of the ply */
+  for (i = 0; i < (1 << n_dst_bits_this_ply); i++)
+    {
+      u16 slot;
+
+      slot = clib_net_to_host_u16 (dst_byte);
+      slot += i;
+      slot = clib_host_to_net_u16 (slot);
+
+      old_leaf = m->leaves[slot];
+
+      if (!ip6_mtrie_leaf_is_terminal (old_leaf))
+	{
+	  sub_ply_index = ip6_mtrie_leaf_get_next_ply_index (old_leaf);
+	  if (!unset_leaf (a, &sub_ply_index, 2))
+	    {
+	      clib_atomic_store_rel_n (
+		&m->leaves[slot],
+		ip6_mtrie_leaf_set_next_ply_index (sub_ply_index));
+	      continue;
+	    }
+	}
+      else if (old_leaf != del_leaf)
+	continue;
+
+      clib_atomic_store_rel_n (
+	&m->leaves[slot], ip6_mtrie_leaf_set_adj_index (a->cover_adj_index));
+      m->dst_address_bits_of_leaves[slot] = a->cover_address_length;
+    }
+}
+
+static void
+ip6_mtrie_mk_args (ip6_mtrie_set_unset_leaf_args_t *a,
+		   const ip6_address_t *dst_address, u32 dst_address_length)
+{
+  ip6_main_t *im = &ip6_main;
+
+  /* Honor dst_address_length. Fib masks are in network byte order */
+  a->dst_address.as_u64[0] =
+    dst_address->as_u64[0] & im->fib_masks[dst_address_length].as_u64[0];
+  a->dst_address.as_u64[1] =
+    dst_address->as_u64[1] & im->fib_masks[dst_address_length].as_u64[1];
+  a->dst_address_length = dst_address_length;
+}
+
+void
+ip6_mtrie_route_add (ip6_mtrie_t *m, const ip6_address_t *dst_address,
+		     u32 dst_address_length, u32 adj_index)
+{
+  ip6_mtrie_set_unset_leaf_args_t a = {
+    .adj_index = adj_index,
+  };
+
+  ip6_mtrie_mk_args (&a, dst_address, dst_address_length);
+
+  set_root_leaf (m, &a);
+  plies_retired_free ();
+}
+
+void
+ip6_mtrie_route_del (ip6_mtrie_t *m, const ip6_address_t *dst_address,
+		     u32 dst_address_length, u32 adj_index,
+		     u32 cover_address_length, u32 cover_adj_index)
+{
+  ip6_mtrie_set_unset_leaf_args_t a = {
+    .adj_index = adj_index,
+    .cover_adj_index = cover_adj_index,
+    .cover_address_length = cover_address_length,
+  };
+
+  ip6_mtrie_mk_args (&a, dst_address, dst_address_length);
+
+  /* the top level ply is never removed */
+  unset_root_leaf (m, &a);
+  plies_retired_free ();
+}
+
+ip6_mtrie_t *
+ip6_mtrie_create (void)
+{
+  ip6_mtrie_t *m;
+
+  m = clib_mem_alloc_aligned (sizeof (*m), CLIB_CACHE_LINE_BYTES);
+  clib_memset_u8 (m->dst_address_bits_of_leaves, 0,
+		  sizeof (m->dst_address_bits_of_leaves));
+  clib_memset_u32 (m->leaves, IP6_MTRIE_LEAF_EMPTY, ARRAY_LEN (m->leaves));
+
+  return (m);
+}
+
+void
+ip6_mtrie_free (ip6_mtrie_t *m)
+{
+  /* the assumption being that the IP6 FIB table has emptied the trie
+   * before deletion.
+   */
+#if CLIB_DEBUG > 0
+  int i;
+  for (i = 0; i < ARRAY_LEN (m->leaves); i++)
+    {
+      ASSERT (!ip6_mtrie_leaf_is_next_ply (m->leaves[i]));
+    }
+#endif
+  clib_mem_free (m);
+}
+
+/* Returns number of bytes of memory used by a ply and its children. */
+static uword
+ply_memory_usage (ip6_mtrie_ply_t *p)
+{
+  const ip6_mtrie_ply_ctl_t *ctl =
+    vec_elt_at_index (ip6_ply_ctls, p - ip6_ply_pool);
+  const ip6_mtrie_leaf_t *leaves = ply_leaves (p);
+  uword bytes, i;
+
+  bytes = sizeof (p[0]) + vec_len (ctl->run_lens) +
+	  (p->leaves ? p->n_runs * sizeof (p->leaves[0]) : 0);
+
+  for (i = 0; i < p->n_runs; i++)
+    {
+      ip6_mtrie_leaf_t l = leaves[i];
+      if (ip6_mtrie_leaf_is_next_ply (l))
+	bytes += ply_memory_usage (pool_elt_at_index (
+	  ip6_ply_pool, ip6_mtrie_leaf_get_next_ply_index (l)));
+    }
+
+  return bytes;
+}
+
+/* Returns number of bytes of memory used by mtrie. */
+uword
+ip6_mtrie_memory_usage (ip6_mtrie_t *m)
+{
+  uword bytes, i;
+
+  bytes = sizeof (*m);
+  for (i = 0; i < ARRAY_LEN (m->leaves); i++)
+    {
+      ip6_mtrie_leaf_t l = m->leaves[i];
+      if (ip6_mtrie_leaf_is_next_ply (l))
+	bytes += ply_memory_usage (pool_elt_at_index (
+	  ip6_ply_pool, ip6_mtrie_leaf_get_next_ply_index (l)));
+    }
+
+  return bytes;
+}
+
+static u8 *
+format_ip6_mtrie_leaf (u8 *s, va_list *va)
+{
+  ip6_mtrie_leaf_t l = va_arg (*va, ip6_mtrie_leaf_t);
+
+  if (ip6_mtrie_leaf_is_terminal (l))
+    s = format (s, "lb-index %d", ip6_mtrie_leaf_get_adj_index (l));
+  else
+    s = format (s, "next ply %d", ip6_mtrie_leaf_get_next_ply_index (l));
+  return s;
+}
+
+static u8 *
+format_ip6_mtrie_ply (u8 *s, va_list *va)
+{
+  ip6_address_t *base_address = va_arg (*va, ip6_address_t *);
+  u32 dst_address_byte_index = va_arg (*va, u32);
+  u32 indent = va_arg (*va, u32);
+  u32 ply_index = va_arg (*va, u32);
+  ip6_mtrie_expanded_ply_t *p;
+  ip6_address_t ia;
+  ip6_mtrie_leaf_t l;
+  int i;
+
+  p = &ip6_mtrie_scratch[dst_address_byte_index];
+  ply_expand (ply_index, p);
+  s = format (s, "%Uply index %d, %d runs, %d non-empty leaves",
+	      format_white_space, indent, ply_index,
+	      pool_elt_at_index (ip6_ply_pool, ply_index)->n_runs,
+	      p->n_non_empty_leafs);
+
+  for (i = 0; i < ARRAY_LEN (p->leaves); i++)
+    {
+      if (!ip6_mtrie_leaf_is_non_empty (p, i))
+	continue;
+
+      l = p->leaves[i];
+      ia = *base_address;
+      ia.as_u8[dst_address_byte_index] = i;
+      s = format (s, "\n%U%U/%d %U", format_white_space, indent + 4,
+		  format_ip6_address, &ia, p->dst_address_bits_of_leaves[i],
+		  format_ip6_mtrie_leaf, l);
+
+      if (ip6_mtrie_leaf_is_next_ply (l))
+	s = format (s, "\n%U", format_ip6_mtrie_ply, &ia,
+		    dst_address_byte_index + 1, indent + 8,
+		    ip6_mtrie_leaf_get_next_ply_index (l));
+    }
+
+  return s;
+}
+
+u8 *
+format_ip6_mtrie (u8 *s, va_list *va)
+{
+  ip6_mtrie_t *m = va_arg (*va, ip6_mtrie_t *);
+  int verbose = va_arg (*va, int);
+  ip6_address_t ia;
+  ip6_mtrie_leaf_t l;
+  int i;
+
+  s = format (s, "16-8-...-8: %d plies, memory usage %U\n",
+	      pool_elts (ip6_ply_pool), format_memory_size,
+	      ip6_mtrie_memory_usage (m));
+
+  if (verbose)
+    {
+      s = format (s, "root-ply");
+
+      for (i = 0; i < ARRAY_LEN (m->leaves); i++)
+	{
+	  u16 slot;
+
+	  slot = clib_host_to_net_u16 (i);
+
+	  if (m->dst_address_bits_of_leaves[slot] == 0)
+	    continue;
+
+	  l = m->leaves[slot];
+	  clib_memset (&ia, 0, sizeof (ia));
+	  ia.as_u16[0] = slot;
+	  s = format (s, "\n%U%U/%d %U", format_white_space, 4,
+		      format_ip6_address, &ia,
+		      m->dst_address_bits_of_leaves[slot],
+		      format_ip6_mtrie_leaf, l);
+
+	  if (ip6_mtrie_leaf_is_next_ply (l))
+	    s = format (s, "\n%U", format_ip6_mtrie_ply, &ia, 2, 8,
+			ip6_mtrie_leaf_get_next_ply_index (l));
+	}
+    }
+
+  return s;
+}
+
+int
+ip6_mtrie_pool_will_expand (uword n_plies)
+{
+  return (pool_free_elts (ip6_ply_pool) < n_plies);
+}
+
+void
+ip6_mtrie_pool_reserve (uword n_plies)
+{
+  uword n_free = pool_free_elts (ip6_ply_pool);
+
+  if (n_free < n_plies)
+    pool_alloc_aligned (ip6_ply_pool, n_plies - n_free,
+			CLIB_CACHE_LINE_BYTES);
+}
+
+void
+ip6_mtrie_batch_begin (void)
+{
+  ip6_mtrie_batch_depth++;
+}
+
+void
+ip6_mtrie_batch_end (void)
+{
+  ASSERT (ip6_mtrie_batch_depth > 0);
+
+  if (--ip6_mtrie_batch_depth)
+    return;
+
+  if (vec_len (ip6_plies_retired))
+    {
+      /* let the workers finish any walk through the replaced plies */
+      vlib_worker_wait_one_loop ();
+      plies_retired_free ();
+    }
+}
+
+static clib_error_t *
+ip6_mtrie_module_init (vlib_main_t *vm)
+{
+  CLIB_UNUSED (ip6_mtrie_ply_t * p);
+
+  /* Burn one ply so index 0 is taken */
+  pool_get_aligned (ip6_ply_pool, p, CLIB_CACHE_LINE_BYTES);
+
+  return (NULL);
+}
+
+VLIB_INIT_FUNCTION (ip6_mtrie_module_init);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
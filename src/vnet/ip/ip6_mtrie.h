@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * ip/ip6_mtrie.h: ip6 multi-bit trie for forwarding lookups
+ *
+ * A 16-8-8-...-8 stride trie. The leaf encoding follows the IPv4 mtrie:
+ *   1 + 2*adj_index for terminal leaves.
+ *   0 + 2*next_ply_index for non-terminals, i.e. PLYs
+ *
+ * The 8 bit plies are stored compressed, as the IPv4 mtrie's
+ * ip4_mtrie_c_ply_t: runs of slots with the same leaf are stored once and
+ * a bitmap marks where each run starts. An IPv6 table is sparse below
+ * the first 16 bits, so most plies have only a handful of runs and fit in
+ * a single cache line. A lookup costs one dependent load per ply, so
+ * a /48 needs five, against one hash probe per distinct prefix length
+ * in the bihash based table.
+ */
+
+#ifndef included_ip_ip6_mtrie_h
+#define included_ip_ip6_mtrie_h
+
+#include <vppinfra/cache.h>
+#include <vppinfra/vector.h>
+#include <vnet/ip/ip6_packet.h>	/* for ip6_address_t */
+
+typedef u32 ip6_mtrie_leaf_t;
+
+#define IP6_MTRIE_LEAF_EMPTY (1 + 2 * 0)
+
+/**
+ * @brief Number of leaves held in the ply's own cache line
+ */
+#define IP6_MTRIE_PLY_N_INLINE_LEAVES 4
+
+/**
+ * @brief One compressed 8 bit ply.
+ * Bit N of run_starts is set if slot N holds a different leaf, or prefix
+ * length, to slot N - 1. The leaf for a slot is found by counting the set
+ * bits up to and including the slot's. A published ply is never modified;
+ * updates build a replacement ply and swap the leaf that points to it.
+ */
+typedef struct ip6_mtrie_ply_t_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /**
+   * Bit N set if slot N starts a new run. Bit 0 is always set.
+   */
+  u64 run_starts[4];
+
+  /**
+   * Number of runs starting in the preceding bitmap words (at most 192).
+   */
+  u8 n_runs_before[4];
+
+  /**
+   * Number of runs, hence of leaves.
+   */
+  u32 n_runs;
+
+  /**
+   * Leaves, one per run, if they do not fit in inline_leaves.
+   */
+  ip6_mtrie_leaf_t *leaves;
+
+  ip6_mtrie_leaf_t inline_leaves[IP6_MTRIE_PLY_N_INLINE_LEAVES];
+} ip6_mtrie_ply_t;
+
+STATIC_ASSERT (sizeof (ip6_mtrie_ply_t) == CLIB_CACHE_LINE_BYTES,
+	       "IP6 Mtrie ply cache line");
+
+/**
+ * @brief the 16 way stride that is the top PLY of the mtrie
+ */
+#define IP6_MTRIE_PLY_16_SIZE (1 << 16)
+
+/**
+ * @brief The mutiway-TRIE with a 16-8-...-8 stride.
+ */
+typedef struct ip6_mtrie_t_
+{
+  /**
+   * The leaves/slots/buckets of the top ply
+   */
+  ip6_mtrie_leaf_t leaves[IP6_MTRIE_PLY_16_SIZE];
+
+  /**
+   * Prefix length for the top ply's leaves.
+   */
+  u8 dst_address_bits_of_leaves[IP6_MTRIE_PLY_16_SIZE];
+} ip6_mtrie_t;
+
+/**
+ * @brief Create an mtrie
+ */
+ip6_mtrie_t *ip6_mtrie_create (void);
+
+/**
+ * @brief Free an mtrie, It must be empty when free'd
+ */
+void ip6_mtrie_free (ip6_mtrie_t *m);
+
+/**
+ * @brief Add a route/entry to the mtrie
+ */
+void ip6_mtrie_route_add (ip6_mtrie_t *m, const ip6_address_t *dst_address,
+			  u32 dst_address_length, u32 adj_index);
+
+/**
+ * @brief remove a route/entry from the mtrie
+ */
+void ip6_mtrie_route_del (ip6_mtrie_t *m, const ip6_address_t *dst_address,
+			  u32 dst_address_length, u32 adj_index,
+			  u32 cover_address_length, u32 cover_adj_index);
+
+/**
+ * @brief return the memory used by the table
+ */
+uword ip6_mtrie_memory_usage (ip6_mtrie_t *m);
+
+/**
+ * @brief Format/display the contents of the mtrie
+ */
+format_function_t format_ip6_mtrie;
+
+/**
+ * @brief A global pool of compressed 8bit stride plys
+ */
+extern ip6_mtrie_ply_t *ip6_ply_pool;
+
+/**
+ * @brief Would adding n_plies plies expand, i.e. move, the pool of plys
+ */
+extern int ip6_mtrie_pool_will_expand (uword n_plies);
+
+/**
+ * @brief Make room in the pool for n_plies more plys, so that later
+ * updates do not need to sync the workers. Moves the pool, so the caller
+ * must hold the worker barrier if ip6_mtrie_pool_will_expand.
+ */
+extern void ip6_mtrie_pool_reserve (uword n_plies);
+
+/**
+ * @brief Start/end a batch of updates. The plies replaced during a batch
+ * are freed at its end, once the workers are no longer using them.
+ * Batches nest.
+ */
+extern void ip6_mtrie_batch_begin (void);
+extern void ip6_mtrie_batch_end (void);
+
+/**
+ * Is the leaf terminal (i.e. an LB index) or non-terminal (i.e. a PLY index)
+ */
+always_inline u32
+ip6_mtrie_leaf_is_terminal (ip6_mtrie_leaf_t n)
+{
+  return n & 1;
+}
+
+/**
+ * From the stored slot value extract the LB index value
+ */
+always_inline u32
+ip6_mtrie_leaf_get_adj_index (ip6_mtrie_leaf_t n)
+{
+  ASSERT (ip6_mtrie_leaf_is_terminal (n));
+  return n >> 1;
+}
+
+/**
+ * @brief Find the leaf for a slot of a ply.
+ */
+always_inline ip6_mtrie_leaf_t
+ip6_mtrie_ply_get_leaf (const ip6_mtrie_ply_t *ply, u8 slot)
+{
+  const ip6_mtrie_leaf_t *leaves;
+  u64 run_starts;
+
+  /* the runs starting at or before the slot */
+  run_starts = ply->run_starts[slot >> 6] & (((u64) 2 << (slot & 63)) - 1);
+  leaves = ply->leaves ? ply->leaves : ply->inline_leaves;
+
+  return (leaves[ply->n_runs_before[slot >> 6] + count_set_bits (run_starts) -
+		 1]);
+}
+
+/**
+ * @brief Lookup step.  Processes 1 byte of 16 byte ip6 address.
+ */
+always_inline ip6_mtrie_leaf_t
+ip6_mtrie_lookup_step (ip6_mtrie_leaf_t current_leaf,
+		       const ip6_address_t *dst_address,
+		       u32 dst_address_byte_index)
+{
+  if (!ip6_mtrie_leaf_is_terminal (current_leaf))
+    return (ip6_mtrie_ply_get_leaf (
+      ip6_ply_pool + (current_leaf >> 1),
+      dst_address->as_u8[dst_address_byte_index]));
+
+  return current_leaf;
+}
+
+/**
+ * @brief Lookup step number 1.  Processes 2 bytes of 16 byte ip6 address.
+ */
+always_inline ip6_mtrie_leaf_t
+ip6_mtrie_lookup_step_one (const ip6_mtrie_t *m,
+			   const ip6_address_t *dst_address)
+{
+  return (m->leaves[dst_address->as_u16[0]]);
+}
+
+/**
+ * @brief Longest prefix match, returns the LB index
+ */
+always_inline u32
+ip6_mtrie_lookup (const ip6_mtrie_t *m, const ip6_address_t *dst_address)
+{
+  ip6_mtrie_leaf_t leaf;
+  u32 i;
+
+  leaf = ip6_mtrie_lookup_step_one (m, dst_address);
+
+  for (i = 2; !ip6_mtrie_leaf_is_terminal (leaf); i++)
+    {
+      ASSERT (i < ARRAY_LEN (dst_address->as_u8));
+      leaf = ip6_mtrie_lookup_step (leaf, dst_address, i);
+    }
+
+  return (ip6_mtrie_leaf_get_adj_index (leaf));
+}
+
+/**
+ * @brief Longest prefix match of two addresses. The steps of the two
+ * walks are interleaved so their ply loads are in flight together.
+ */
+static_always_inline void
+ip6_mtrie_lookup_x2 (const ip6_mtrie_t *m0, const ip6_mtrie_t *m1,
+		     const ip6_address_t *a0, const ip6_address_t *a1,
+		     u32 *lb0, u32 *lb1)
+{
+  ip6_mtrie_leaf_t leaf[2];
+  u32 i;
+
+  leaf[0] = ip6_mtrie_lookup_step_one (m0, a0);
+  leaf[1] = ip6_mtrie_lookup_step_one (m1, a1);
+
+  for (i = 2; !(leaf[0] & leaf[1] & 1); i++)
+    {
+      ASSERT (i < ARRAY_LEN (a0->as_u8));
+      leaf[0] = ip6_mtrie_lookup_step (leaf[0], a0, i);
+      leaf[1] = ip6_mtrie_lookup_step (leaf[1], a1, i);
+    }
+
+  *lb0 = ip6_mtrie_leaf_get_adj_index (leaf[0]);
+  *lb1 = ip6_mtrie_leaf_get_adj_index (leaf[1]);
+}
+
+/**
+ * @brief Longest prefix match of four addresses. The steps of the four
+ * walks are interleaved so their ply loads are in flight together.
+ */
+static_always_inline void
+ip6_mtrie_lookup_x4 (const ip6_mtrie_t *m0, const ip6_mtrie_t *m1,
+		     const ip6_mtrie_t *m2, const ip6_mtrie_t *m3,
+		     const ip6_address_t *a0, const ip6_address_t *a1,
+		     const ip6_address_t *a2, const ip6_address_t *a3,
+		     u32 *lb0, u32 *lb1, u32 *lb2, u32 *lb3)
+{
+  ip6_mtrie_leaf_t leaf[4];
+  u32 i;
+
+  leaf[0] = ip6_mtrie_lookup_step_one (m0, a0);
+  leaf[1] = ip6_mtrie_lookup_step_one (m1, a1);
+  leaf[2] = ip6_mtrie_lookup_step_one (m2, a2);
+  leaf[3] = ip6_mtrie_lookup_step_one (m3, a3);
+
+  for (i = 2; !(leaf[0] & leaf[1] & leaf[2] & leaf[3] & 1); i++)
+    {
+      ASSERT (i < ARRAY_LEN (a0->as_u8));
+      leaf[0] = ip6_mtrie_lookup_step (leaf[0], a0, i);
+      leaf[1] = ip6_mtrie_lookup_step (leaf[1], a1, i);
+      leaf[2] = ip6_mtrie_lookup_step (leaf[2], a2, i);
+      leaf[3] = ip6_mtrie_lookup_step (leaf[3], a3, i);
+    }
+
+  *lb0 = ip6_mtrie_leaf_get_adj_index (leaf[0]);
+  *lb1 = ip6_mtrie_leaf_get_adj_index (leaf[1]);
+  *lb2 = ip6_mtrie_leaf_get_adj_index (leaf[2]);
+  *lb3 = ip6_mtrie_leaf_get_adj_index (leaf[3]);
+}
+
+#endif /* included_ip_ip6_mtrie_h */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -315,6 +315,76 @@ vl_api_ip_route_v2_dump_t_handler (vl_api_ip_route_v2_dump_t *mp)
   vec_free (ctx.feis);
 }
 
+/*
+ * Walks the entry pool from the cursor rather than the table, so a page
+ * can stop at any entry and the next one carries on without building
+ * the list of all the table's entries first. Routes added behind the
+ * cursor while paging are not returned.
+ */
+static void
+vl_api_ip_route_v2_get_t_handler (vl_api_ip_route_v2_get_t *mp)
+{
+  vpe_api_main_t *am = &vpe_api_main;
+  vl_api_ip_route_v2_get_reply_t *rmp;
+  vlib_main_t *vm = vlib_get_main ();
+  vl_api_registration_t *rp;
+  const fib_prefix_t *pfx;
+  fib_protocol_t fproto;
+  fib_prefix_t filter;
+  fib_source_t src;
+  u32 fib_index, cursor;
+  f64 start;
+  i32 rv = 0;
+
+  rp = vl_api_client_index_to_registration (mp->client_index);
+  if (!rp)
+    return;
+
+  fproto = (mp->table.is_ip6 ? FIB_PROTOCOL_IP6 : FIB_PROTOCOL_IP4);
+  fib_index = fib_table_find (fproto, ntohl (mp->table.table_id));
+  src = mp->src;
+  ip_prefix_decode (&mp->prefix, &filter);
+  cursor = ~0;
+
+  if (INDEX_INVALID == fib_index)
+    {
+      rv = VNET_API_ERROR_NO_SUCH_FIB;
+      goto done;
+    }
+  if (filter.fp_len && filter.fp_proto != fproto)
+    {
+      rv = VNET_API_ERROR_INVALID_ADDRESS_FAMILY;
+      goto done;
+    }
+
+  start = vlib_time_now (vm);
+  cursor = fib_entry_pool_next (ntohl (mp->cursor));
+
+  while (cursor != FIB_NODE_INDEX_INVALID)
+    {
+      pfx = fib_entry_get_prefix (cursor);
+
+      if (pfx->fp_proto == fproto &&
+	  fib_entry_get_fib_index (cursor) == fib_index &&
+	  (!src || fib_entry_is_sourced (cursor, src)) &&
+	  (!filter.fp_len || (pfx->fp_len >= filter.fp_len &&
+			      fib_prefix_is_cover (&filter, pfx))))
+	send_ip_route_v2_details (am, rp, mp->context, cursor);
+
+      cursor = fib_entry_pool_next (cursor + 1);
+      if (vl_api_process_may_suspend (vm, rp, start))
+	{
+	  if (cursor != FIB_NODE_INDEX_INVALID)
+	    rv = VNET_API_ERROR_EAGAIN;
+	  break;
+	}
+    }
+
+done:
+  REPLY_MACRO2 (VL_API_IP_ROUTE_V2_GET_REPLY,
+		({ rmp->cursor = clib_host_to_net_u32 (cursor); }));
+}
+
 static void
 send_ip_mtable_details (vl_api_registration_t * reg,
 			u32 context, const mfib_table_t * mfib_table)
@@ -845,6 +915,66 @@ vl_api_ip_route_add_del_v2_t_handler (vl_api_ip_route_add_del_v2_t *mp)
   /* clang-format on */
 }
 
+void
+vl_api_ip_route_add_del_batch_t_handler (vl_api_ip_route_add_del_batch_t *mp)
+{
+  vl_api_ip_route_add_del_batch_reply_t *rmp;
+  vl_api_ip_route_batch_entry_t *route;
+  fib_route_path_t *rpaths = NULL;
+  fib_entry_flag_t entry_flags;
+  fib_protocol_t fproto;
+  u32 fib_index, n_done = 0, n_routes;
+  fib_prefix_t pfx;
+  int rv = 0;
+
+  n_routes = ntohl (mp->n_routes);
+
+  if (0 == n_routes)
+    goto done;
+
+  /* the batch reserves for the protocol of the first route */
+  fproto = (ADDRESS_IP6 == mp->routes[0].prefix.address.af ?
+	      FIB_PROTOCOL_IP6 :
+	      FIB_PROTOCOL_IP4);
+  vec_validate (rpaths, 0);
+
+  fib_table_batch_begin (fproto, (mp->is_add ? n_routes : 0));
+
+  for (n_done = 0; n_done < n_routes; n_done++)
+    {
+      route = &mp->routes[n_done];
+      entry_flags = FIB_ENTRY_FLAG_NONE;
+      /* a path extension may have kept the last path's label stack */
+      clib_memset (rpaths, 0, sizeof (rpaths[0]));
+      ip_prefix_decode (&route->prefix, &pfx);
+
+      rv = fib_api_table_id_decode (pfx.fp_proto, ntohl (route->table_id),
+				    &fib_index);
+      if (0 != rv)
+	break;
+
+      rv = fib_api_path_decode (&route->path, &rpaths[0]);
+      if (0 != rv)
+	break;
+
+      if ((rpaths[0].frp_flags & FIB_ROUTE_PATH_LOCAL) &&
+	  (~0 == rpaths[0].frp_sw_if_index))
+	entry_flags |= (FIB_ENTRY_FLAG_CONNECTED | FIB_ENTRY_FLAG_LOCAL);
+
+      rv = fib_api_route_add_del (mp->is_add, mp->is_multipath, fib_index,
+				  &pfx, FIB_SOURCE_API, entry_flags, rpaths);
+      if (0 != rv)
+	break;
+    }
+
+  fib_table_batch_end ();
+  vec_free (rpaths);
+
+done:
+  REPLY_MACRO2 (VL_API_IP_ROUTE_ADD_DEL_BATCH_REPLY,
+		({ rmp->n_done = htonl (n_done); }));
+}
+
 void
 vl_api_ip_route_lookup_t_handler (vl_api_ip_route_lookup_t * mp)
 {
@@ -2183,9 +2313,20 @@ ip_api_hookup (vlib_main_t * vm)
     am, REPLY_MSG_ID_BASE + VL_API_IP_ROUTE_ADD_DEL_V2, 1);
   vl_api_set_msg_thread_safe (
     am, REPLY_MSG_ID_BASE + VL_API_IP_ROUTE_ADD_DEL_V2_REPLY, 1);
+  vl_api_set_msg_thread_safe (
+    am, REPLY_MSG_ID_BASE + VL_API_IP_ROUTE_ADD_DEL_BATCH, 1);
+  vl_api_set_msg_thread_safe (
+    am, REPLY_MSG_ID_BASE + VL_API_IP_ROUTE_ADD_DEL_BATCH_REPLY, 1);
   vl_api_set_msg_thread_safe (am, REPLY_MSG_ID_BASE + VL_API_IP_ADDRESS_DUMP,
 			      1);
 
+  /*
+   * Route pages are read on the main thread, the only writer of the FIB,
+   * so each page is sent without stopping the workers
+   */
+  vl_api_set_msg_thread_safe (am, REPLY_MSG_ID_BASE + VL_API_IP_ROUTE_V2_GET,
+			      1);
+
   return 0;
 }
 
@@ -88,10 +88,14 @@ frag_buffer_alloc (vlib_buffer_t * org_b, u32 * bi)
  * contained with in a single buffer and limited to the max buffer
  * size.
  * from_bi: current pointer must point to IPv4 header
+ * reuse: if the packet is in a single, unshared buffer, truncate it in
+ *   place to become the first fragment rather than copying that out.
+ *   The original buffer is then part of *buffer and must not be freed.
  */
-ip_frag_error_t
-ip4_frag_do_fragment (vlib_main_t * vm, u32 from_bi, u16 mtu,
-		      u16 l2unfragmentablesize, u32 ** buffer)
+static_always_inline ip_frag_error_t
+ip4_frag_do_fragment_inline (vlib_main_t *vm, u32 from_bi, u16 mtu,
+			     u16 l2unfragmentablesize, u32 **buffer,
+			     int reuse)
 {
   vlib_buffer_t *from_b;
   ip4_header_t *ip4;
@@ -144,6 +148,18 @@ ip4_frag_do_fragment (vlib_main_t * vm, u32 from_bi, u16 mtu,
   u16 fo = 0;
   u16 left_in_from_buffer = from_b->current_length - head_bytes;
   u16 ptr = 0;
+  u16 first_len = 0;
+  u32 first_index = vec_len (*buffer);
+
+  if (reuse && !(from_b->flags & VLIB_BUFFER_NEXT_PRESENT) &&
+      from_b->ref_count == 1)
+    {
+      /* The first fragment stays in the original buffer, copy the rest */
+      first_len = (rem > max ? max & ~0x7 : rem);
+      ptr = fo = first_len;
+      left_in_from_buffer -= first_len;
+      rem -= first_len;
+    }
 
   /* Do the actual fragmentation */
   while (rem)
@@ -228,9 +244,31 @@ ip4_frag_do_fragment (vlib_main_t * vm, u32 from_bi, u16 mtu,
       fo += len;
     }
 
+  if (first_len)
+    {
+      ip4->fragment_id = ip_frag_id;
+      ip4->flags_and_fragment_offset = clib_host_to_net_u16 (ip_frag_offset);
+      ip4->flags_and_fragment_offset |=
+	clib_host_to_net_u16 ((fo != first_len || more) << 13);
+      ip4->length = clib_host_to_net_u16 (first_len + sizeof (ip4_header_t));
+      ip4->checksum = ip4_header_checksum (ip4);
+      org_from_b->current_length = first_len + head_bytes;
+      vnet_buffer_offload_flags_clear (org_from_b,
+				       VNET_BUFFER_OFFLOAD_F_IP_CKSUM);
+      vec_insert_elts (*buffer, &from_bi, 1, first_index);
+    }
+
   return IP_FRAG_ERROR_NONE;
 }
 
+ip_frag_error_t
+ip4_frag_do_fragment (vlib_main_t * vm, u32 from_bi, u16 mtu,
+		      u16 l2unfragmentablesize, u32 ** buffer)
+{
+  return ip4_frag_do_fragment_inline (vm, from_bi, mtu, l2unfragmentablesize,
+				      buffer, 0 /* reuse */);
+}
+
 void
 ip_frag_set_vnet_buffer (vlib_buffer_t * b, u16 mtu, u8 next_index, u8 flags)
 {
@@ -273,17 +311,19 @@ frag_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
 	  p0 = vlib_get_buffer (vm, pi0);
 	  u16 mtu = vnet_buffer (p0)->ip_frag.mtu;
+	  u32 pkt_size = vlib_buffer_length_in_chain (vm, p0);
 	  if (is_ip6)
 	    error0 = ip6_frag_do_fragment (vm, pi0, mtu, 0, &buffer);
 	  else
-	    error0 = ip4_frag_do_fragment (vm, pi0, mtu, 0, &buffer);
+	    error0 = ip4_frag_do_fragment_inline (vm, pi0, mtu, 0, &buffer,
+						  1 /* reuse */);
 
 	  if (PREDICT_FALSE (p0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
 	      ip_frag_trace_t *tr =
 		vlib_add_trace (vm, node, p0, sizeof (*tr));
 	      tr->mtu = mtu;
-	      tr->pkt_size = vlib_buffer_length_in_chain (vm, p0);
+	      tr->pkt_size = pkt_size;
 	      tr->n_fragments = vec_len (buffer);
 	      tr->next = vnet_buffer (p0)->ip_frag.next_index;
 	    }
@@ -307,7 +347,9 @@ frag_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	      /* Free original buffer chain */
 	      frag_sent += vec_len (buffer);
 	      small_packets += (vec_len (buffer) == 1);
-	      vlib_buffer_free_one (vm, pi0);	/* Free original packet */
+	      /* Free original packet, unless it became the first fragment */
+	      if (buffer[0] != pi0)
+		vlib_buffer_free_one (vm, pi0);
 	    }
 	  else
 	    {
@@ -325,6 +325,13 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 l2_len = is_output ? vnet_buffer (b[0])->l2.l2_len : 0;
+	      u32 chain_hash[VNET_CLASSIFY_CHAIN_MAX_TABLES], n_chain, i = 0;
+
+	      n_chain = vnet_classify_chain_prefetch (
+		&vnet_classify_main, table_index[0], b[0]->data + l2_len,
+		vlib_buffer_get_current (b[0]) + l2_len, chain_hash);
+
 	      while (1)
 		{
 		  table_index[0] = t[0]->next_table_index;
@@ -354,8 +361,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h[0] += vnet_buffer (b[0])->l2.l2_len;
 
-		  hash[0] =
-		    vnet_classify_hash_packet_inline (t[0], (u8 *) h[0]);
+		  hash[0] = i < n_chain ? chain_hash[i++] :
+					  vnet_classify_hash_packet_inline (
+					    t[0], (u8 *) h[0]);
 		  e[0] =
 		    vnet_classify_find_entry_inline (t[0], (u8 *) h[0],
 						     hash[0], now);
@@ -433,6 +441,13 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 l2_len = is_output ? vnet_buffer (b[1])->l2.l2_len : 0;
+	      u32 chain_hash[VNET_CLASSIFY_CHAIN_MAX_TABLES], n_chain, i = 0;
+
+	      n_chain = vnet_classify_chain_prefetch (
+		&vnet_classify_main, table_index[1], b[1]->data + l2_len,
+		vlib_buffer_get_current (b[1]) + l2_len, chain_hash);
+
 	      while (1)
 		{
 		  table_index[1] = t[1]->next_table_index;
@@ -462,8 +477,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h[1] += vnet_buffer (b[1])->l2.l2_len;
 
-		  hash[1] =
-		    vnet_classify_hash_packet_inline (t[1], (u8 *) h[1]);
+		  hash[1] = i < n_chain ? chain_hash[i++] :
+					  vnet_classify_hash_packet_inline (
+					    t[1], (u8 *) h[1]);
 		  e[1] =
 		    vnet_classify_find_entry_inline (t[1], (u8 *) h[1],
 						     hash[1], now);
@@ -636,6 +652,13 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 l2_len = is_output ? vnet_buffer (b[0])->l2.l2_len : 0;
+	      u32 chain_hash[VNET_CLASSIFY_CHAIN_MAX_TABLES], n_chain, i = 0;
+
+	      n_chain = vnet_classify_chain_prefetch (
+		&vnet_classify_main, table_index0, b[0]->data + l2_len,
+		vlib_buffer_get_current (b[0]) + l2_len, chain_hash);
+
 	      while (1)
 		{
 		  table_index0 = t0->next_table_index;
@@ -665,7 +688,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h0 += vnet_buffer (b[0])->l2.l2_len;
 
-		  hash0 = vnet_classify_hash_packet_inline (t0, (u8 *) h0);
+		  hash0 = i < n_chain ? chain_hash[i++] :
+					vnet_classify_hash_packet_inline (
+					  t0, (u8 *) h0);
 		  e0 = vnet_classify_find_entry_inline
 		    (t0, (u8 *) h0, hash0, now);
 		  if (e0)
@@ -55,6 +55,12 @@ api_ip_route_add_del_v2 (vat_main_t *vam)
   return -1;
 }
 
+static int
+api_ip_route_add_del_batch (vat_main_t *vam)
+{
+  return -1;
+}
+
 static void
 set_ip4_address (vl_api_address_t *a, u32 v)
 {
@@ -598,6 +604,12 @@ vl_api_ip_route_add_del_v2_reply_t_handler (
 {
 }
 
+static void
+vl_api_ip_route_add_del_batch_reply_t_handler (
+  vl_api_ip_route_add_del_batch_reply_t *mp)
+{
+}
+
 static void
 vl_api_ip_route_details_t_handler (vl_api_ip_route_details_t *mp)
 {
@@ -1515,6 +1527,17 @@ api_ip_route_v2_dump (vat_main_t *vat)
   return -1;
 }
 
+static int
+api_ip_route_v2_get (vat_main_t *vat)
+{
+  return -1;
+}
+
+static void
+vl_api_ip_route_v2_get_reply_t_handler (vl_api_ip_route_v2_get_reply_t *mp)
+{
+}
+
 static void
 vl_api_ip_path_mtu_get_reply_t_handler (vl_api_ip_path_mtu_get_reply_t *mp)
 {
@@ -148,9 +148,14 @@ typedef struct punt_client_db_t_
   void *clients_by_ip_proto;
 } punt_client_db_t;
 
+struct mmsghdr;
+
 typedef struct punt_thread_data_t_
 {
   struct iovec *iovecs;
+  struct mmsghdr *msgs;
+  punt_packetdesc_t *packetdescs;
+  u32 *msg_lens;
 } punt_thread_data_t;
 
 typedef struct
@@ -22,6 +22,7 @@
  * to the local TCP/IP stack
  */
 
+#define _GNU_SOURCE
 #include <vnet/ip/ip.h>
 #include <vnet/ethernet/ethernet.h>
 #include <vlib/vlib.h>
@@ -250,19 +251,28 @@ punt_socket_inline2 (vlib_main_t *vm, vlib_node_runtime_t *node,
   clib_thread_index_t thread_index = vm->thread_index;
   uword n_packets = frame->n_vectors;
   punt_main_t *pm = &punt_main;
-  int i;
+  u32 n_msgs = 0, n_iovecs = 0, n_sent = 0, n_tx = 0;
+  struct mmsghdr *mh;
+  int i, rv;
 
   punt_thread_data_t *ptd = &pm->thread_data[thread_index];
   u32 node_index = (AF_IP4 == af ?
 		    udp4_punt_socket_node.index :
 		    udp6_punt_socket_node.index);
 
+  /* Messages and descriptors are sized up front so their addresses are
+   * stable, iovecs are linked to their messages once all are added */
+  vec_validate (ptd->msgs, n_packets - 1);
+  vec_validate (ptd->packetdescs, n_packets - 1);
+  vec_validate (ptd->msg_lens, n_packets - 1);
+  vec_reset_length (ptd->iovecs);
+
   for (i = 0; i < n_packets; i++)
     {
       struct iovec *iov;
       vlib_buffer_t *b;
       uword l;
-      punt_packetdesc_t packetdesc;
+      punt_packetdesc_t *packetdesc;
       punt_client_t *c;
       u16 port = 0;
       b = vlib_get_buffer (vm, buffers[i]);
@@ -330,20 +340,20 @@ punt_socket_inline2 (vlib_main_t *vm, vlib_node_runtime_t *node,
 	{
 	  vlib_node_increment_counter (vm, node_index,
 				       PUNT_ERROR_SOCKET_TX_ERROR, 1);
-	  goto error;
+	  continue;
 	}
 
       struct sockaddr_un *caddr = &c->caddr;
 
-      /* Re-set iovecs */
-      vec_reset_length (ptd->iovecs);
+      n_iovecs = vec_len (ptd->iovecs);
 
       /* Add packet descriptor */
-      packetdesc.sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
-      packetdesc.action = 0;
+      packetdesc = &ptd->packetdescs[n_msgs];
+      packetdesc->sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+      packetdesc->action = 0;
       vec_add2 (ptd->iovecs, iov, 1);
-      iov->iov_base = &packetdesc;
-      iov->iov_len = sizeof (packetdesc);
+      iov->iov_base = packetdesc;
+      iov->iov_len = sizeof (*packetdesc);
 
       /** VLIB buffer chain -> Unix iovec(s). */
       vlib_buffer_advance (b, -ethernet_buffer_header_size (b));
@@ -383,21 +393,40 @@ punt_socket_inline2 (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  while (b->flags & VLIB_BUFFER_NEXT_PRESENT);
 	}
 
-      struct msghdr msg = {
-	.msg_name = caddr,
-	.msg_namelen = sizeof (*caddr),
-	.msg_iov = ptd->iovecs,
-	.msg_iovlen = vec_len (ptd->iovecs),
-      };
+      mh = &ptd->msgs[n_msgs];
+      clib_memset (mh, 0, sizeof (*mh));
+      mh->msg_hdr.msg_name = caddr;
+      mh->msg_hdr.msg_namelen = sizeof (*caddr);
+      mh->msg_hdr.msg_iovlen = vec_len (ptd->iovecs) - n_iovecs;
+      ptd->msg_lens[n_msgs] = l;
+      n_msgs++;
+    }
 
-      if (sendmsg (pm->socket_fd, &msg, 0) < (ssize_t) l)
-	vlib_node_increment_counter (vm, node_index,
-				     PUNT_ERROR_SOCKET_TX_ERROR, 1);
-      else
-	vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX, 1);
+  /* Link messages to their iovecs now that the iovec vector is final */
+  n_iovecs = 0;
+  for (i = 0; i < n_msgs; i++)
+    {
+      mh = &ptd->msgs[i];
+      mh->msg_hdr.msg_iov = ptd->iovecs + n_iovecs;
+      n_iovecs += mh->msg_hdr.msg_iovlen;
     }
 
-error:
+  /* Hand the whole frame to the kernel in as few syscalls as possible */
+  while (n_sent < n_msgs)
+    {
+      rv = sendmmsg (pm->socket_fd, ptd->msgs + n_sent, n_msgs - n_sent, 0);
+      if (rv <= 0)
+	break;
+      for (i = n_sent; i < n_sent + rv; i++)
+	n_tx += ptd->msgs[i].msg_len >= ptd->msg_lens[i];
+      n_sent += rv;
+    }
+
+  vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX, n_tx);
+  if (n_msgs - n_tx)
+    vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX_ERROR,
+				 n_msgs - n_tx);
+
   vlib_buffer_free (vm, buffers, n_packets);
 
   return n_packets;
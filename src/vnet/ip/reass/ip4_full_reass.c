@@ -151,6 +151,9 @@ typedef struct
   // thread which received fragment with offset 0 and which sends out the
   // completed reassembly
   clib_thread_index_t sendout_thread_index;
+  // neighbours in the per-thread lru list
+  u32 lru_prev;
+  u32 lru_next;
 } ip4_full_reass_t;
 
 typedef struct
@@ -158,8 +161,9 @@ typedef struct
   ip4_full_reass_t *pool;
   u32 reass_n;
   u32 id_counter;
-  // for pacing the main thread timeouts
-  u32 last_id;
+  // contexts ordered by last_heard, oldest first
+  u32 lru_first;
+  u32 lru_last;
   clib_spinlock_t lock;
 } ip4_full_reass_per_thread_t;
 
@@ -402,10 +406,39 @@ ip4_full_reass_add_trace (vlib_main_t *vm, vlib_node_runtime_t *node,
 #endif
 }
 
+always_inline void
+ip4_full_reass_lru_remove (ip4_full_reass_per_thread_t *rt,
+			   ip4_full_reass_t *reass)
+{
+  if (~0 != reass->lru_prev)
+    rt->pool[reass->lru_prev].lru_next = reass->lru_next;
+  else
+    rt->lru_first = reass->lru_next;
+  if (~0 != reass->lru_next)
+    rt->pool[reass->lru_next].lru_prev = reass->lru_prev;
+  else
+    rt->lru_last = reass->lru_prev;
+}
+
+always_inline void
+ip4_full_reass_lru_append (ip4_full_reass_per_thread_t *rt,
+			   ip4_full_reass_t *reass)
+{
+  u32 index = reass - rt->pool;
+  reass->lru_prev = rt->lru_last;
+  reass->lru_next = ~0;
+  if (~0 != rt->lru_last)
+    rt->pool[rt->lru_last].lru_next = index;
+  else
+    rt->lru_first = index;
+  rt->lru_last = index;
+}
+
 always_inline void
 ip4_full_reass_free_ctx (ip4_full_reass_per_thread_t * rt,
 			 ip4_full_reass_t * reass)
 {
+  ip4_full_reass_lru_remove (rt, reass);
   pool_put (rt->pool, reass);
   --rt->reass_n;
 }
@@ -580,25 +613,39 @@ again:
   if (reass)
     {
       reass->last_heard = now;
+      if (reass - rt->pool != rt->lru_last)
+	{
+	  ip4_full_reass_lru_remove (rt, reass);
+	  ip4_full_reass_lru_append (rt, reass);
+	}
       return reass;
     }
 
   if (rt->reass_n >= rm->max_reass_n)
     {
-      reass = NULL;
-      return reass;
-    }
-  else
-    {
-      pool_get (rt->pool, reass);
-      clib_memset (reass, 0, sizeof (*reass));
-      reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
-      reass->memory_owner_thread_index = vm->thread_index;
-      ++rt->id_counter;
-      ip4_full_reass_init (reass);
-      ++rt->reass_n;
+      /* the oldest reassembly is the least likely to complete, make room
+       * by dropping it, expired or not */
+      if (~0 == rt->lru_first)
+	return NULL;
+      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+      vlib_node_increment_counter (vm, node->node_index,
+				   now > reass->last_heard + rm->timeout ?
+				     IP4_ERROR_REASS_TIMEOUT :
+				     IP4_ERROR_REASS_EVICTED,
+				   1);
+      ip4_full_reass_drop_all (vm, node, reass);
+      ip4_full_reass_free (rm, rt, reass);
     }
 
+  pool_get (rt->pool, reass);
+  clib_memset (reass, 0, sizeof (*reass));
+  reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
+  reass->memory_owner_thread_index = vm->thread_index;
+  ++rt->id_counter;
+  ip4_full_reass_init (reass);
+  ip4_full_reass_lru_append (rt, reass);
+  ++rt->reass_n;
+
   clib_memcpy_fast (&reass->key, &kv->kv.key, sizeof (reass->key));
   kv->v.reass_index = (reass - rt->pool);
   kv->v.memory_owner_thread_index = vm->thread_index;
@@ -761,7 +808,8 @@ ip4_full_reass_finalize (vlib_main_t * vm, vlib_node_runtime_t * node,
     }
   total_length -= first_b->current_length;
   first_b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-  first_b->total_length_not_including_first_buffer = total_length;
+  vlib_buffer_cold (first_b)->total_length_not_including_first_buffer =
+    total_length;
   ip4_header_t *ip = vlib_buffer_get_current (first_b);
   ip->flags_and_fragment_offset = 0;
   ip->length = clib_host_to_net_u16 (first_b->current_length + total_length);
@@ -1583,6 +1631,7 @@ ip4_full_reass_init_function (vlib_main_t * vm)
   {
     clib_spinlock_init (&rt->lock);
     pool_alloc (rt->pool, rm->max_reass_n);
+    rt->lru_first = rt->lru_last = ~0;
   }
 
   node = vlib_get_node_by_name (vm, (u8 *) "ip4-full-reassembly-expire-walk");
@@ -1644,10 +1693,9 @@ ip4_full_reass_walk_expired (vlib_main_t *vm, vlib_node_runtime_t *node,
       f64 now = vlib_time_now (vm);
 
       ip4_full_reass_t *reass;
-      int *pool_indexes_to_free = NULL;
+      u32 n_expired;
 
       uword thread_index = 0;
-      int index;
       const uword nthreads = vlib_num_workers () + 1;
 
       for (thread_index = 0; thread_index < nthreads; ++thread_index)
@@ -1656,52 +1704,26 @@ ip4_full_reass_walk_expired (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    &rm->per_thread_data[thread_index];
 	  clib_spinlock_lock (&rt->lock);
 
-	  vec_reset_length (pool_indexes_to_free);
-
-	  /* Pace the number of timeouts handled per thread,to avoid barrier
-	   * sync issues in real world scenarios */
-
-	  u32 beg = rt->last_id;
-	  /* to ensure we walk at least once per sec per context */
-	  u32 end =
-	    beg + (IP4_REASS_MAX_REASSEMBLIES_DEFAULT *
-		     IP4_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS / MSEC_PER_SEC +
-		   1);
-	  if (end > vec_len (rt->pool))
+	  /* contexts are kept in last_heard order, the expired ones are
+	   * all at the head of the lru list */
+	  n_expired = 0;
+	  while (~0 != rt->lru_first)
 	    {
-	      end = vec_len (rt->pool);
-	      rt->last_id = 0;
-	    }
-	  else
-	    {
-	      rt->last_id = end;
+	      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+	      if (now <= reass->last_heard + rm->timeout)
+		break;
+	      ip4_full_reass_drop_all (vm, node, reass);
+	      ip4_full_reass_free (rm, rt, reass);
+	      ++n_expired;
 	    }
 
-	  pool_foreach_stepping_index (index, beg, end, rt->pool)
-	  {
-	    reass = pool_elt_at_index (rt->pool, index);
-	    if (now > reass->last_heard + rm->timeout)
-	      {
-		vec_add1 (pool_indexes_to_free, index);
-	      }
-	  }
-
-	  if (vec_len (pool_indexes_to_free))
+	  if (n_expired)
 	    vlib_node_increment_counter (vm, node->node_index,
-					 IP4_ERROR_REASS_TIMEOUT,
-					 vec_len (pool_indexes_to_free));
-	  int *i;
-          vec_foreach (i, pool_indexes_to_free)
-          {
-            ip4_full_reass_t *reass = pool_elt_at_index (rt->pool, i[0]);
-	    ip4_full_reass_drop_all (vm, node, reass);
-	    ip4_full_reass_free (rm, rt, reass);
-	  }
+					 IP4_ERROR_REASS_TIMEOUT, n_expired);
 
 	  clib_spinlock_unlock (&rt->lock);
 	}
 
-      vec_free (pool_indexes_to_free);
       if (event_data)
 	{
 	  vec_set_len (event_data, 0);
@@ -371,14 +371,14 @@ always_inline ip4_sv_reass_t *
 ip4_sv_reass_find_or_create (vlib_main_t *vm, vlib_node_runtime_t *node,
 			     u32 bi, ip4_sv_reass_main_t *rm,
 			     ip4_sv_reass_per_thread_t *rt,
-			     ip4_sv_reass_kv_t *kv, u8 *do_handoff)
+			     ip4_sv_reass_kv_t *kv, u64 hash, u8 *do_handoff)
 {
   ip4_sv_reass_t *reass = NULL;
   f64 now = vlib_time_now (vm);
 
 again:
 
-  if (!clib_bihash_search_16_8 (&rm->hash, &kv->kv, &kv->kv))
+  if (!clib_bihash_search_inline_with_hash_16_8 (&rm->hash, hash, &kv->kv))
     {
       if (vm->thread_index != kv->v.thread_index)
 	{
@@ -432,7 +432,7 @@ again:
   kv->v.thread_index = vm->thread_index;
   reass->last_heard = now;
 
-  int rv = clib_bihash_add_del_16_8 (&rm->hash, &kv->kv, 2);
+  int rv = clib_bihash_add_del_with_hash_16_8 (&rm->hash, &kv->kv, hash, 2);
   if (rv)
     {
       ip4_sv_reass_free (vm, rm, rt, reass, false);
@@ -847,6 +847,36 @@ slow_path:
 
   from += b - bufs;
 
+  /* compute keys and hashes for the rest of the frame up front so the
+   * bihash buckets are already in cache when the fragments get there */
+  ip4_sv_reass_kv_t kvs[VLIB_FRAME_SIZE], *kv = kvs;
+  u64 hashes[VLIB_FRAME_SIZE], *hash = hashes;
+  for (u32 i = 0; i < n_left_from; i++)
+    {
+      ip4_header_t *ip = (ip4_header_t *) u8_ptr_add (
+	vlib_buffer_get_current (b[i]),
+	(ptrdiff_t) (a.is_output_feature ? 1 : 0) *
+	  vnet_buffer (b[i])->ip.save_rewrite_length);
+      if (!ip4_get_fragment_more (ip) && !ip4_get_fragment_offset (ip))
+	{
+	  hashes[i] = 0;
+	  continue;
+	}
+      if (a.with_custom_context)
+	kvs[i].k.as_u64[0] =
+	  (u64) context[i] | (u64) ip->src_address.as_u32 << 32;
+      else
+	kvs[i].k.as_u64[0] =
+	  (u64) vec_elt (ip4_main.fib_index_by_sw_if_index,
+			 vnet_buffer (b[i])->sw_if_index[VLIB_RX]) |
+	  (u64) ip->src_address.as_u32 << 32;
+      kvs[i].k.as_u64[1] = (u64) ip->dst_address.as_u32 |
+			   (u64) ip->fragment_id << 32 |
+			   (u64) ip->protocol << 48;
+      hashes[i] = clib_bihash_hash_16_8 (&kvs[i].kv);
+      clib_bihash_prefetch_bucket_16_8 (&rm->hash, hashes[i]);
+    }
+
   while (n_left_from > 0)
     {
       if (a.with_custom_context)
@@ -937,43 +967,33 @@ slow_path:
 	      b0->error = node->errors[error0];
 	      goto packet_enqueue;
 	    }
-	  ip4_sv_reass_kv_t kv;
 	  u8 do_handoff = 0;
 
-	  if (a.with_custom_context)
-	    kv.k.as_u64[0] = (u64) *context | (u64) ip0->src_address.as_u32
-						<< 32;
-	  else
-	    kv.k.as_u64[0] =
-	      (u64) vec_elt (ip4_main.fib_index_by_sw_if_index,
-			     vnet_buffer (b0)->sw_if_index[VLIB_RX]) |
-	      (u64) ip0->src_address.as_u32 << 32;
-	  kv.k.as_u64[1] = (u64) ip0->dst_address.as_u32 |
-			   (u64) ip0->fragment_id << 32 |
-			   (u64) ip0->protocol << 48;
+	  if (n_left_from > 4)
+	    clib_bihash_prefetch_data_16_8 (&rm->hash, hash[4]);
 
 	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
 	      ip4_sv_reass_trace_t *t =
 		vlib_add_trace (vm, node, b0, sizeof (t[0]));
 	      t->action = REASS_KEY;
-	      STATIC_ASSERT_SIZEOF (t->kv, sizeof (kv));
-	      clib_memcpy (&t->kv, &kv, sizeof (kv));
+	      STATIC_ASSERT_SIZEOF (t->kv, sizeof (kv[0]));
+	      clib_memcpy (&t->kv, kv, sizeof (kv[0]));
 	    }
 
 	  ip4_sv_reass_t *reass = ip4_sv_reass_find_or_create (
-	    vm, node, bi0, rm, rt, &kv, &do_handoff);
+	    vm, node, bi0, rm, rt, kv, hash[0], &do_handoff);
 
 	  if (PREDICT_FALSE (do_handoff))
 	    {
 	      if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
 		{
 		  ip4_sv_reass_add_trace (vm, node, reass, bi0, REASS_HANDOFF,
-					  ~0, ~0, ~0, 0, kv.v.thread_index);
+					  ~0, ~0, ~0, 0, kv->v.thread_index);
 		}
 	      next0 = IP4_SV_REASSEMBLY_NEXT_HANDOFF;
 	      vnet_buffer (b0)->ip.reass.owner_thread_index =
-		kv.v.thread_index;
+		kv->v.thread_index;
 	      if (a.with_custom_context)
 		forward_context = 1;
 	      goto packet_enqueue;
@@ -1128,6 +1148,8 @@ slow_path:
 
 	next_packet:
 	  from += 1;
+	  kv += 1;
+	  hash += 1;
 	  n_left_from -= 1;
 	  if (a.with_custom_context)
 	    context += 1;
@@ -131,6 +131,9 @@ typedef struct
   // thread which received fragment with offset 0 and which sends out the
   // completed reassembly
   u32 sendout_thread_index;
+  // neighbours in the per-thread lru list
+  u32 lru_prev;
+  u32 lru_next;
 } ip6_full_reass_t;
 
 typedef struct
@@ -138,8 +141,9 @@ typedef struct
   ip6_full_reass_t *pool;
   u32 reass_n;
   u32 id_counter;
-  // for pacing the main thread timeouts
-  u32 last_id;
+  // contexts ordered by last_heard, oldest first
+  u32 lru_first;
+  u32 lru_last;
   clib_spinlock_t lock;
 } ip6_full_reass_per_thread_t;
 
@@ -399,10 +403,39 @@ ip6_full_reass_add_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
 #endif
 }
 
+always_inline void
+ip6_full_reass_lru_remove (ip6_full_reass_per_thread_t *rt,
+			   ip6_full_reass_t *reass)
+{
+  if (~0 != reass->lru_prev)
+    rt->pool[reass->lru_prev].lru_next = reass->lru_next;
+  else
+    rt->lru_first = reass->lru_next;
+  if (~0 != reass->lru_next)
+    rt->pool[reass->lru_next].lru_prev = reass->lru_prev;
+  else
+    rt->lru_last = reass->lru_prev;
+}
+
+always_inline void
+ip6_full_reass_lru_append (ip6_full_reass_per_thread_t *rt,
+			   ip6_full_reass_t *reass)
+{
+  u32 index = reass - rt->pool;
+  reass->lru_prev = rt->lru_last;
+  reass->lru_next = ~0;
+  if (~0 != rt->lru_last)
+    rt->pool[rt->lru_last].lru_next = index;
+  else
+    rt->lru_first = index;
+  rt->lru_last = index;
+}
+
 always_inline void
 ip6_full_reass_free_ctx (ip6_full_reass_per_thread_t * rt,
 			 ip6_full_reass_t * reass)
 {
+  ip6_full_reass_lru_remove (rt, reass);
   pool_put (rt->pool, reass);
   --rt->reass_n;
 }
@@ -633,29 +666,43 @@ again:
   if (reass)
     {
       reass->last_heard = now;
+      if (reass - rt->pool != rt->lru_last)
+	{
+	  ip6_full_reass_lru_remove (rt, reass);
+	  ip6_full_reass_lru_append (rt, reass);
+	}
       return reass;
     }
 
   if (rt->reass_n >= rm->max_reass_n)
     {
-      reass = NULL;
-      return reass;
-    }
-  else
-    {
-      pool_get (rt->pool, reass);
-      clib_memset (reass, 0, sizeof (*reass));
-      reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
-      ++rt->id_counter;
-      reass->first_bi = ~0;
-      reass->last_packet_octet = ~0;
-      reass->data_len = 0;
-      reass->next_index = ~0;
-      reass->error_next_index = ~0;
-      reass->memory_owner_thread_index = vm->thread_index;
-      ++rt->reass_n;
+      /* the oldest reassembly is the least likely to complete, make room
+       * by dropping it, expired or not */
+      if (~0 == rt->lru_first)
+	return NULL;
+      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+      vlib_node_increment_counter (vm, node->node_index,
+				   now > reass->last_heard + rm->timeout ?
+				     IP6_ERROR_REASS_TIMEOUT :
+				     IP6_ERROR_REASS_EVICTED,
+				   1);
+      ip6_full_reass_drop_all (vm, node, reass, n_left_to_next, to_next);
+      ip6_full_reass_free (rm, rt, reass);
     }
 
+  pool_get (rt->pool, reass);
+  clib_memset (reass, 0, sizeof (*reass));
+  reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
+  ++rt->id_counter;
+  reass->first_bi = ~0;
+  reass->last_packet_octet = ~0;
+  reass->data_len = 0;
+  reass->next_index = ~0;
+  reass->error_next_index = ~0;
+  reass->memory_owner_thread_index = vm->thread_index;
+  ip6_full_reass_lru_append (rt, reass);
+  ++rt->reass_n;
+
   kv->v.reass_index = (reass - rt->pool);
   kv->v.memory_owner_thread_index = vm->thread_index;
   reass->last_heard = now;
@@ -832,7 +879,8 @@ ip6_full_reass_finalize (vlib_main_t * vm, vlib_node_runtime_t * node,
     }
   total_length -= first_b->current_length;
   first_b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-  first_b->total_length_not_including_first_buffer = total_length;
+  vlib_buffer_cold (first_b)->total_length_not_including_first_buffer =
+    total_length;
   // drop fragment header
   vnet_buffer_opaque_t *first_b_vnb = vnet_buffer (first_b);
   ip6_header_t *ip = vlib_buffer_get_current (first_b);
@@ -1674,6 +1722,7 @@ ip6_full_reass_init_function (vlib_main_t * vm)
   {
     clib_spinlock_init (&rt->lock);
     pool_alloc (rt->pool, rm->max_reass_n);
+    rt->lru_first = rt->lru_last = ~0;
   }
 
   node = vlib_get_node_by_name (vm, (u8 *) "ip6-full-reassembly-expire-walk");
@@ -1743,10 +1792,8 @@ ip6_full_reass_walk_expired (vlib_main_t *vm, vlib_node_runtime_t *node,
       f64 now = vlib_time_now (vm);
 
       ip6_full_reass_t *reass;
-      int *pool_indexes_to_free = NULL;
 
       uword thread_index = 0;
-      int index;
       const uword nthreads = vlib_num_workers () + 1;
       u32 *vec_icmp_bi = NULL;
       u32 n_left_to_next, *to_next;
@@ -1758,49 +1805,24 @@ ip6_full_reass_walk_expired (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  u32 reass_timeout_cnt = 0;
 	  clib_spinlock_lock (&rt->lock);
 
-	  vec_reset_length (pool_indexes_to_free);
-	  /* Pace the number of timeouts handled per thread,to avoid barrier
-	   * sync issues in real world scenarios */
-
-	  u32 beg = rt->last_id;
-	  /* to ensure we walk at least once per sec per context */
-	  u32 end = beg + (IP6_FULL_REASS_MAX_REASSEMBLIES_DEFAULT *
-			     IP6_FULL_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS /
-			     MSEC_PER_SEC +
-			   1);
-	  if (end > vec_len (rt->pool))
+	  /* contexts are kept in last_heard order, the expired ones are
+	   * all at the head of the lru list */
+	  while (~0 != rt->lru_first)
 	    {
-	      end = vec_len (rt->pool);
-	      rt->last_id = 0;
-	    }
-	  else
-	    {
-	      rt->last_id = end;
-	    }
+	      u32 icmp_bi = ~0;
 
-	  pool_foreach_stepping_index (index, beg, end, rt->pool)
-	  {
-	    reass = pool_elt_at_index (rt->pool, index);
-	    if (now > reass->last_heard + rm->timeout)
-	      {
-		vec_add1 (pool_indexes_to_free, index);
-	      }
-	  }
-
-	  int *i;
-          vec_foreach (i, pool_indexes_to_free)
-          {
-            ip6_full_reass_t *reass = pool_elt_at_index (rt->pool, i[0]);
-            u32 icmp_bi = ~0;
-
-	    reass_timeout_cnt += reass->fragments_n;
-	    ip6_full_reass_on_timeout (vm, node, reass, &icmp_bi,
-				       &n_left_to_next, &to_next);
-	    if (~0 != icmp_bi)
-	      vec_add1 (vec_icmp_bi, icmp_bi);
-
-	    ip6_full_reass_free (rm, rt, reass);
-	  }
+	      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+	      if (now <= reass->last_heard + rm->timeout)
+		break;
+
+	      reass_timeout_cnt += reass->fragments_n;
+	      ip6_full_reass_on_timeout (vm, node, reass, &icmp_bi,
+					 &n_left_to_next, &to_next);
+	      if (~0 != icmp_bi)
+		vec_add1 (vec_icmp_bi, icmp_bi);
+
+	      ip6_full_reass_free (rm, rt, reass);
+	    }
 
 	  clib_spinlock_unlock (&rt->lock);
 	  if (reass_timeout_cnt)
@@ -1831,7 +1853,6 @@ ip6_full_reass_walk_expired (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  vlib_put_frame_to_node (vm, rm->ip6_icmp_error_idx, f);
 	}
 
-      vec_free (pool_indexes_to_free);
       vec_free (vec_icmp_bi);
       if (event_data)
 	{
@@ -69,6 +69,12 @@ ipip_input (vlib_main_t * vm, vlib_node_runtime_t * node,
   clib_thread_index_t thread_index = vm->thread_index;
   u32 len;
   vnet_interface_main_t *im = &gm->vnet_main->interface_main;
+  vlib_combined_counter_acc_t rx_acc;
+
+  vlib_combined_counter_acc_init (&rx_acc,
+				  im->combined_sw_if_counters +
+				    VNET_INTERFACE_COUNTER_RX,
+				  thread_index);
 
   from = vlib_frame_vector_args (from_frame);
   n_left_from = from_frame->n_vectors;
@@ -201,11 +207,8 @@ ipip_input (vlib_main_t * vm, vlib_node_runtime_t * node,
 		}
 	    }
 
-	  vlib_increment_combined_counter (im->combined_sw_if_counters +
-					   VNET_INTERFACE_COUNTER_RX,
-					   thread_index, tunnel_sw_if_index,
-					   1 /* packets */ ,
-					   len /* bytes */ );
+	  vlib_combined_counter_acc_add (&rx_acc, tunnel_sw_if_index,
+					 1 /* packets */, len /* bytes */);
 
 	drop:
 	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
@@ -235,6 +238,7 @@ ipip_input (vlib_main_t * vm, vlib_node_runtime_t * node,
 
       vlib_put_next_frame (vm, node, next_index, n_left_to_next);
     }
+  vlib_combined_counter_acc_flush (&rx_acc);
   vlib_node_increment_counter (vm,
 			       !is_ipv6 ? ipip4_input_node.index :
 			       ipip6_input_node.index, IPIP_ERROR_DECAP_PKTS,
@@ -92,6 +92,29 @@ esp_seq_advance (ipsec_sa_outb_rt_t *ort)
   return 0;
 }
 
+/* Take the next sequence number of a multi-worker SA from this thread's
+ * block, reserving the next block from the SA once it is used up */
+always_inline int
+esp_seq_advance_multi_worker (ipsec_sa_outb_rt_t *ort,
+			      ipsec_sa_seq_block_t *sb, u64 *seq)
+{
+  u64 max = ort->use_esn ? CLIB_U64_MAX : CLIB_U32_MAX;
+  u64 base;
+
+  if (PREDICT_FALSE (sb->next >= sb->end))
+    {
+      base = clib_atomic_fetch_add_relax (&ort->seq64,
+					  IPSEC_SA_SEQ_BLOCK_SIZE);
+      if (base >= max)
+	return 1;
+      sb->next = base;
+      sb->end = clib_min (base + IPSEC_SA_SEQ_BLOCK_SIZE, max);
+    }
+
+  *seq = ++sb->next;
+  return 0;
+}
+
 always_inline u16
 esp_aad_fill (u8 *data, const esp_header_t *esp, int use_esn, u32 seq_hi)
 {
@@ -246,7 +269,7 @@ STATIC_ASSERT (sizeof (esp_decrypt_packet_data2_t) <=
 	       "Custom meta-data too large for vnet_buffer_opaque2_t");
 
 #define esp_post_data2(b) \
-    ((esp_decrypt_packet_data2_t *)((u8 *)((b)->opaque2) \
+    ((esp_decrypt_packet_data2_t *)((u8 *)vlib_get_buffer_opaque2 (b) \
         + STRUCT_OFFSET_OF (vnet_buffer_opaque2_t, unused)))
 
 typedef struct
@@ -161,7 +161,7 @@ esp_remove_tail (vlib_main_t * vm, vlib_buffer_t * b, vlib_buffer_t * last,
   vlib_buffer_t *before_last = b;
 
   if (b != last)
-    b->total_length_not_including_first_buffer -= tail;
+    vlib_buffer_cold (b)->total_length_not_including_first_buffer -= tail;
 
   if (last->current_length > tail)
     {
@@ -237,11 +237,12 @@ esp_move_icv (vlib_main_t * vm, vlib_buffer_t * first,
   if (before_last == first)
     pd->current_length -= first_sz;
   else
-    first->total_length_not_including_first_buffer -= first_sz;
+    vlib_buffer_cold (first)->total_length_not_including_first_buffer -=
+      first_sz;
   clib_memset (vlib_buffer_get_tail (before_last), 0, first_sz);
   if (dif)
     dif[0] = first_sz;
-  first->total_length_not_including_first_buffer -= last_sz;
+  vlib_buffer_cold (first)->total_length_not_including_first_buffer -= last_sz;
   pd2->lb = before_last;
   pd2->icv_removed = 1;
   pd2->free_buffer_index = before_last->next_buffer;
@@ -651,7 +652,7 @@ esp_decrypt_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
   esp_decrypt_packet_data_t *async_pd = &(esp_post_data (b))->decrypt_data;
   esp_decrypt_packet_data2_t *async_pd2 = esp_post_data2 (b);
   u8 *tag = payload + len, *iv = payload + esp_sz, *aad = 0;
-  const u32 key_index = irt->cipher_key_index;
+  const u32 key_index = irt->async_key_index;
   u32 crypto_len, integ_len = 0;
   i16 crypto_start_offset, integ_start_offset = 0;
   u8 flags = 0;
@@ -809,16 +810,31 @@ esp_decrypt_post_crypto (vlib_main_t *vm, vlib_node_runtime_t *node,
    * a sequence s, s+1, s+2, s+3, ... s+n and nothing will prevent any
    * implementation, sequential or batching, from decrypting these.
    */
-  if (ipsec_sa_anti_replay_and_sn_advance (irt, pd->seq, pd->seq_hi, true,
-					   NULL))
+  if (irt->is_multi_worker)
     {
-      esp_decrypt_set_next_index (b, node, vm->thread_index,
-				  ESP_DECRYPT_ERROR_REPLAY, 0, next,
-				  ESP_DECRYPT_NEXT_DROP, pd->sa_index);
-      return;
+      /* other workers update the window too, check and advance at once */
+      if (ipsec_sa_anti_replay_mw_advance (irt, pd->seq, pd->seq_hi,
+					   &n_lost))
+	{
+	  esp_decrypt_set_next_index (b, node, vm->thread_index,
+				      ESP_DECRYPT_ERROR_REPLAY, 0, next,
+				      ESP_DECRYPT_NEXT_DROP, pd->sa_index);
+	  return;
+	}
+    }
+  else
+    {
+      if (ipsec_sa_anti_replay_and_sn_advance (irt, pd->seq, pd->seq_hi,
+					       true, NULL))
+	{
+	  esp_decrypt_set_next_index (b, node, vm->thread_index,
+				      ESP_DECRYPT_ERROR_REPLAY, 0, next,
+				      ESP_DECRYPT_NEXT_DROP, pd->sa_index);
+	  return;
+	}
+      n_lost = ipsec_sa_anti_replay_advance (irt, vm->thread_index, pd->seq,
+					     pd->seq_hi);
     }
-  n_lost =
-    ipsec_sa_anti_replay_advance (irt, vm->thread_index, pd->seq, pd->seq_hi);
 
   vlib_prefetch_simple_counter (&ipsec_sa_err_counters[IPSEC_SA_ERROR_LOST],
 				vm->thread_index, pd->sa_index);
@@ -1086,7 +1102,8 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   const u8 esp_sz = sizeof (esp_header_t);
   ipsec_sa_inb_rt_t *irt = 0;
   bool anti_replay_result;
-  int is_async = 0;
+  bool inline_done;
+  int is_async = 0, use_async;
   vnet_crypto_op_id_t async_op = ~0;
   vnet_crypto_async_frame_t *async_frames[VNET_CRYPTO_N_OP_IDS];
   esp_decrypt_error_t err;
@@ -1100,12 +1117,14 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vec_reset_length (ptd->chunks);
   clib_memset (sync_nexts, -1, sizeof (sync_nexts));
   clib_memset (async_frames, 0, sizeof (async_frames));
+  use_async = vnet_crypto_adaptive_use_async (vm, from_frame->n_vectors);
 
   while (n_left > 0)
     {
       u8 *payload;
 
       err = ESP_DECRYPT_ERROR_RX_PKTS;
+      inline_done = false;
       if (n_left > 2)
 	{
 	  u8 *p;
@@ -1145,9 +1164,15 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  cpd.is_transport = irt->is_transport;
 	  cpd.sa_index = current_sa_index;
 	  is_async = irt->is_async;
+	  if (irt->is_adaptive && use_async)
+	    is_async = vnet_crypto_op_has_async_handler (irt->async_op_id);
 	}
 
-      if (PREDICT_FALSE ((u16) ~0 == irt->thread_index))
+      /* the window of a multi-worker SA is updated atomically, so any
+       * worker can decrypt for it */
+      if (irt->is_multi_worker)
+	;
+      else if (PREDICT_FALSE ((u16) ~0 == irt->thread_index))
 	{
 	  /* this is the first packet to use this SA, claim the SA
 	   * for this thread. this could happen simultaneously on
@@ -1156,7 +1181,8 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    ipsec_sa_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != irt->thread_index))
+      if (PREDICT_FALSE (thread_index != irt->thread_index &&
+			 !irt->is_multi_worker))
 	{
 	  vnet_buffer (b[0])->ipsec.thread_index = irt->thread_index;
 	  err = ESP_DECRYPT_ERROR_HANDOFF;
@@ -1213,7 +1239,16 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       current_sa_pkts += 1;
       current_sa_bytes += vlib_buffer_length_in_chain (vm, b[0]);
 
-      if (is_async)
+      /* the device already decrypted and authenticated the packet, only
+       * the post-crypto processing is left. The flag is consumed so an
+       * inner ESP packet is not mistaken for an offloaded one. */
+      inline_done = (b[0]->flags & VNET_BUFFER_F_IPSEC_INLINE_DONE) &&
+		    irt->is_inline_offload;
+      b[0]->flags &= ~VNET_BUFFER_F_IPSEC_INLINE_DONE;
+
+      if (inline_done)
+	;
+      else if (is_async)
 	{
 	  async_op = irt->async_op_id;
 
@@ -1266,7 +1301,7 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  noop_bi[n_noop] = from[b - bufs];
 	  n_noop++;
 	}
-      else if (!is_async)
+      else if (!is_async || inline_done)
 	{
 	  sync_bi[n_sync] = from[b - bufs];
 	  sync_bufs[n_sync] = b[0];
@@ -1309,6 +1344,8 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   if (n_sync)
     {
+      u64 t0 = clib_cpu_time_now ();
+
       esp_process_ops (vm, node, ptd->integ_ops, sync_bufs, sync_nexts,
 		       ESP_DECRYPT_ERROR_INTEG_ERROR);
       esp_process_chained_ops (vm, node, ptd->chained_integ_ops, sync_bufs,
@@ -1320,6 +1357,8 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       esp_process_chained_ops (vm, node, ptd->chained_crypto_ops, sync_bufs,
 			       sync_nexts, ptd->chunks,
 			       ESP_DECRYPT_ERROR_DECRYPTION_FAILED);
+
+      vnet_crypto_adaptive_sync_done (vm, n_sync, t0);
     }
 
   /* Post decryption ronud - adjust packet data start and length and next
@@ -19,6 +19,7 @@
 #include <vnet/api_errno.h>
 #include <vnet/ip/ip.h>
 #include <vnet/interface_output.h>
+#include <vnet/gso/gso.h>
 
 #include <vnet/crypto/crypto.h>
 
@@ -330,7 +331,7 @@ static_always_inline u32
 esp_encrypt_chain_integ (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 			 ipsec_sa_outb_rt_t *ort, vlib_buffer_t *b,
 			 vlib_buffer_t *lb, u8 icv_sz, u8 *start,
-			 u32 start_len, u8 *digest, u16 *n_ch)
+			 u32 start_len, u8 *digest, u16 *n_ch, u32 seq_hi)
 {
   vnet_crypto_op_chunk_t *ch;
   vlib_buffer_t *cb = b;
@@ -350,7 +351,7 @@ esp_encrypt_chain_integ (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  total_len += ch->len = cb->current_length - icv_sz;
 	  if (ort->use_esn)
 	    {
-	      *(u32u *) digest = clib_net_to_host_u32 (ort->seq64 >> 32);
+	      *(u32u *) digest = clib_net_to_host_u32 (seq_hi);
 	      ch->len += sizeof (u32);
 	      total_len += sizeof (u32);
 	    }
@@ -473,7 +474,7 @@ esp_prepare_sync_op (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  esp_encrypt_chain_integ (vm, ptd, ort, b[0], lb, icv_sz,
 				   payload - iv_sz - sizeof (esp_header_t),
 				   payload_len + iv_sz + sizeof (esp_header_t),
-				   op->digest, &op->n_chunks);
+				   op->digest, &op->n_chunks, seq_hi);
 	}
       else if (ort->use_esn)
 	{
@@ -490,12 +491,12 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 			 ipsec_sa_outb_rt_t *ort, vlib_buffer_t *b,
 			 esp_header_t *esp, u8 *payload, u32 payload_len,
 			 u8 iv_sz, u8 icv_sz, u32 bi, u16 next, u32 hdr_len,
-			 u16 async_next, vlib_buffer_t *lb)
+			 u16 async_next, vlib_buffer_t *lb, u32 seq_hi)
 {
   esp_post_data_t *post = esp_post_data (b);
   u8 *tag, *iv, *aad = 0;
   u8 flag = 0;
-  const u32 key_index = ort->cipher_key_index;
+  const u32 key_index = ort->async_key_index;
   i16 crypto_start_offset, integ_start_offset;
   u16 crypto_total_len, integ_total_len;
 
@@ -518,7 +519,7 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	{
 	  /* constuct aad in a scratch space in front of the nonce */
 	  aad = (u8 *) nonce - sizeof (esp_aead_t);
-	  esp_aad_fill (aad, esp, ort->use_esn, ort->seq64 >> 32);
+	  esp_aad_fill (aad, esp, ort->use_esn, seq_hi);
 	  if (PREDICT_FALSE (ort->is_null_gmac))
 	    {
 	      /* RFC-4543 ENCR_NULL_AUTH_AES_GMAC: IV is part of AAD */
@@ -565,11 +566,11 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  integ_total_len = esp_encrypt_chain_integ (
 	    vm, ptd, ort, b, lb, icv_sz,
 	    payload - iv_sz - sizeof (esp_header_t),
-	    payload_len + iv_sz + sizeof (esp_header_t), tag, 0);
+	    payload_len + iv_sz + sizeof (esp_header_t), tag, 0, seq_hi);
 	}
       else if (ort->use_esn)
 	{
-	  *(u32u *) tag = clib_net_to_host_u32 (ort->seq64 >> 32);
+	  *(u32u *) tag = clib_net_to_host_u32 (seq_hi);
 	  integ_total_len += sizeof (u32);
 	}
     }
@@ -597,15 +598,14 @@ set_ip6_udp_cksum_offload (vlib_buffer_t *b, i16 l3_hdr_offset,
 	       VNET_BUFFER_F_L4_HDR_OFFSET_VALID);
 }
 
-always_inline uword
-esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
-		    vlib_frame_t *frame, vnet_link_t lt, int is_tun,
-		    u16 async_next_node)
+static_always_inline u32
+esp_encrypt_buffers (vlib_main_t *vm, vlib_node_runtime_t *node, u32 *from,
+		     u32 n_vectors, vnet_link_t lt, int is_tun,
+		     u16 async_next_node)
 {
   ipsec_main_t *im = &ipsec_main;
   ipsec_per_thread_data_t *ptd = vec_elt_at_index (im->ptd, vm->thread_index);
-  u32 *from = vlib_frame_vector_args (frame);
-  u32 n_left = frame->n_vectors;
+  u32 n_left = n_vectors;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
   clib_thread_index_t thread_index = vm->thread_index;
   u16 buffer_data_size = vlib_buffer_get_default_data_size (vm);
@@ -617,7 +617,9 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vnet_crypto_op_t **crypto_ops = &ptd->crypto_ops;
   vnet_crypto_op_t **integ_ops = &ptd->integ_ops;
   vnet_crypto_async_frame_t *async_frames[VNET_CRYPTO_N_OP_IDS];
-  int is_async = 0;
+  ipsec_sa_seq_block_t *seq_block = 0;
+  u64 seq64 = 0;
+  int is_async = 0, use_async;
   vnet_crypto_op_id_t async_op = ~0;
   u16 drop_next =
     (lt == VNET_LINK_IP6 ? ESP_ENCRYPT_NEXT_DROP6 :
@@ -644,6 +646,7 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vec_reset_length (ptd->async_frames);
   vec_reset_length (ptd->chunks);
   clib_memset (async_frames, 0, sizeof (async_frames));
+  use_async = vnet_crypto_adaptive_use_async (vm, n_vectors);
 
   while (n_left > 0)
     {
@@ -710,6 +713,15 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  esp_align = ort->esp_block_align;
 	  iv_sz = ort->cipher_iv_size;
 	  is_async = ort->is_async;
+	  if (ort->is_adaptive && use_async)
+	    is_async = vnet_crypto_op_has_async_handler (ort->async_op_id);
+	  if (ort->is_inline_offload)
+	    is_async = 0;
+	  if (ort->is_multi_worker)
+	    {
+	      vec_validate (ptd->seq_blocks, sa_index0);
+	      seq_block = vec_elt_at_index (ptd->seq_blocks, sa_index0);
+	    }
 	}
 
       if (PREDICT_FALSE (ort->drop_no_crypto != 0))
@@ -720,7 +732,11 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  goto trace;
 	}
 
-      if (PREDICT_FALSE ((u16) ~0 == ort->thread_index))
+      /* workers take their own blocks of a multi-worker SA's sequence
+       * numbers, so any of them can encrypt for it */
+      if (ort->is_multi_worker)
+	;
+      else if (PREDICT_FALSE ((u16) ~0 == ort->thread_index))
 	{
 	  /* this is the first packet to use this SA, claim the SA
 	   * for this thread. this could happen simultaneously on
@@ -729,7 +745,8 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    ipsec_sa_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != ort->thread_index))
+      if (PREDICT_FALSE (thread_index != ort->thread_index &&
+			 !ort->is_multi_worker))
 	{
 	  vnet_buffer (b[0])->ipsec.thread_index = ort->thread_index;
 	  err = ESP_ENCRYPT_ERROR_HANDOFF;
@@ -756,13 +773,27 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    lb = vlib_get_buffer (vm, lb->next_buffer);
 	}
 
-      if (PREDICT_FALSE (esp_seq_advance (ort)))
+      if (ort->is_multi_worker)
+	{
+	  if (PREDICT_FALSE (
+		esp_seq_advance_multi_worker (ort, seq_block, &seq64)))
+	    {
+	      err = ESP_ENCRYPT_ERROR_SEQ_CYCLED;
+	      esp_encrypt_set_next_index (b[0], node, thread_index, err,
+					  n_noop, noop_nexts, drop_next,
+					  current_sa_index);
+	      goto trace;
+	    }
+	}
+      else if (PREDICT_FALSE (esp_seq_advance (ort)))
 	{
 	  err = ESP_ENCRYPT_ERROR_SEQ_CYCLED;
 	  esp_encrypt_set_next_index (b[0], node, thread_index, err, n_noop,
 				      noop_nexts, drop_next, current_sa_index);
 	  goto trace;
 	}
+      else
+	seq64 = ort->seq64;
 
       /* space for IV */
       hdr_len = iv_sz;
@@ -1016,9 +1047,18 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	}
 
       esp->spi = spi;
-      esp->seq = clib_net_to_host_u32 (ort->seq64);
+      esp->seq = clib_net_to_host_u32 (seq64);
 
-      if (is_async)
+      if (ort->is_inline_offload)
+	{
+	  /* the device encrypts and fills in the ICV on transmit, it finds
+	   * the SA from the buffer's sad_index */
+	  if (iv_sz)
+	    esp_generate_iv (ort, payload, iv_sz);
+	  vnet_buffer_offload_flags_set (b[0],
+					 VNET_BUFFER_OFFLOAD_F_IPSEC_ENCRYPT);
+	}
+      else if (is_async)
 	{
 	  async_op = ort->async_op_id;
 
@@ -1046,11 +1086,11 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  esp_prepare_async_frame (vm, ptd, async_frames[async_op], ort, b[0],
 				   esp, payload, payload_len, iv_sz, icv_sz,
 				   from[b - bufs], sync_next[0], hdr_len,
-				   async_next_node, lb);
+				   async_next_node, lb, seq64 >> 32);
 	}
       else
 	esp_prepare_sync_op (vm, ptd, crypto_ops, integ_ops, ort,
-			     ort->seq64 >> 32, payload, payload_len, iv_sz,
+			     seq64 >> 32, payload, payload_len, iv_sz,
 			     icv_sz, n_sync, b, lb, hdr_len, esp);
 
       vlib_buffer_advance (b[0], 0LL - hdr_len);
@@ -1070,7 +1110,7 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      ipsec_sa_t *sa = ipsec_sa_get (sa_index0);
 	      tr->sa_index = sa_index0;
 	      tr->spi = sa->spi;
-	      tr->seq = ort->seq64;
+	      tr->seq = ort->is_multi_worker ? seq64 : ort->seq64;
 	      tr->udp_encap = ort->udp_encap;
 	      tr->crypto_alg = sa->crypto_alg;
 	      tr->integ_alg = sa->integ_alg;
@@ -1104,6 +1144,8 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				     current_sa_bytes);
   if (n_sync)
     {
+      u64 t0 = clib_cpu_time_now ();
+
       esp_process_ops (vm, node, ptd->crypto_ops, sync_bufs, sync_nexts,
 		       drop_next);
       esp_process_chained_ops (vm, node, ptd->chained_crypto_ops, sync_bufs,
@@ -1114,6 +1156,8 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       esp_process_chained_ops (vm, node, ptd->chained_integ_ops, sync_bufs,
 			       sync_nexts, ptd->chunks, drop_next);
 
+      vnet_crypto_adaptive_sync_done (vm, n_sync, t0);
+
       vlib_buffer_enqueue_to_next (vm, node, sync_bi, sync_nexts, n_sync);
     }
   if (n_async)
@@ -1138,9 +1182,103 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
     vlib_buffer_enqueue_to_next (vm, node, noop_bi, noop_nexts, n_noop);
 
   vlib_node_increment_counter (vm, node->node_index, ESP_ENCRYPT_ERROR_RX_PKTS,
-			       frame->n_vectors);
+			       n_vectors);
 
-  return frame->n_vectors;
+  return n_vectors;
+}
+
+/*
+ * Segment the GSO packets of a tunnel frame in place of the gso feature,
+ * so a super-frame is segmented and encrypted in the one node visit and
+ * its segments share the crypto batch. Returns the number of GSO packets
+ * in the frame; when non-zero ptd->gso_bi holds the buffers to encrypt.
+ */
+static_always_inline u32
+esp_encrypt_gso_segment (vlib_main_t *vm, vlib_node_runtime_t *node,
+			 ipsec_per_thread_data_t *ptd, u32 *from, u32 n_left,
+			 u16 drop_next)
+{
+  vnet_interface_per_thread_data_t *iptd = vec_elt_at_index (
+    vnet_get_main ()->interface_main.per_thread_data, vm->thread_index);
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
+  u32 i, n_gso = 0;
+
+  vlib_get_buffers (vm, from, bufs, n_left);
+
+  for (i = 0; i < n_left; i++)
+    n_gso += (bufs[i]->flags & VNET_BUFFER_F_GSO) != 0;
+
+  if (PREDICT_TRUE (n_gso == 0))
+    return 0;
+
+  vec_reset_length (ptd->gso_bi);
+
+  for (i = 0; i < n_left; i++, b++)
+    {
+      if (!(b[0]->flags & VNET_BUFFER_F_GSO))
+	{
+	  vec_add1 (ptd->gso_bi, from[i]);
+	  continue;
+	}
+
+      vec_reset_length (iptd->split_buffers);
+      if (PREDICT_FALSE (!gso_segment_buffer_inline (vm, iptd, b[0], 0)))
+	{
+	  b[0]->error = node->errors[ESP_ENCRYPT_ERROR_NO_BUFFERS];
+	  vlib_buffer_enqueue_to_single_next (vm, node, from + i, drop_next,
+					      1);
+	  continue;
+	}
+
+      vec_append (ptd->gso_bi, iptd->split_buffers);
+      vec_reset_length (iptd->split_buffers);
+      vlib_buffer_free_one (vm, from[i]);
+    }
+
+  vlib_node_increment_counter (vm, node->node_index,
+			       ESP_ENCRYPT_ERROR_GSO_SEGMENTED, n_gso);
+
+  return n_gso;
+}
+
+always_inline uword
+esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
+		    vlib_frame_t *frame, vnet_link_t lt, int is_tun,
+		    u16 async_next_node)
+{
+  u32 *from = vlib_frame_vector_args (frame);
+  u32 n_left = frame->n_vectors;
+
+  /*
+   * on a tunnel's output arc a GSO packet reaches us unsegmented unless
+   * the gso feature is enabled on the tunnel, so segment it here and
+   * encrypt the segments in the same pass.
+   */
+  if (is_tun && VNET_LINK_MPLS != lt)
+    {
+      ipsec_per_thread_data_t *ptd =
+	vec_elt_at_index (ipsec_main.ptd, vm->thread_index);
+      u16 drop_next = (lt == VNET_LINK_IP6 ? ESP_ENCRYPT_NEXT_DROP6 :
+					     ESP_ENCRYPT_NEXT_DROP4);
+      u32 n_segs, n;
+
+      if (esp_encrypt_gso_segment (vm, node, ptd, from, n_left, drop_next))
+	{
+	  /* the crypto batch is frame sized, so encrypt a frame at a time */
+	  n_segs = vec_len (ptd->gso_bi);
+	  for (from = ptd->gso_bi; n_segs; from += n, n_segs -= n)
+	    {
+	      n = clib_min (n_segs, VLIB_FRAME_SIZE);
+	      esp_encrypt_buffers (vm, node, from, n, lt, is_tun,
+				   async_next_node);
+	    }
+	  vec_reset_length (ptd->gso_bi);
+	  return frame->n_vectors;
+	}
+    }
+
+  return esp_encrypt_buffers (vm, node, from, n_left, lt, is_tun,
+			      async_next_node);
 }
 
 always_inline uword
@@ -139,6 +139,10 @@ typedef struct
   vnet_crypto_op_t *chained_integ_ops;
   vnet_crypto_op_chunk_t *chunks;
   vnet_crypto_async_frame_t **async_frames;
+  /* per SA index, sequence numbers reserved from multi-worker SAs */
+  ipsec_sa_seq_block_t *seq_blocks;
+  /* buffer indices of a tunnel frame once its GSO packets are segmented */
+  u32 *gso_bi;
 } ipsec_per_thread_data_t;
 
 typedef struct
@@ -278,6 +278,162 @@ VLIB_CLI_COMMAND (ipsec_sa_bind_cmd, static) = {
   .function = ipsec_sa_bind_cli,
 };
 
+static clib_error_t *
+ipsec_sa_multi_worker_cli (vlib_main_t *vm, unformat_input_t *input,
+			   vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 id = ~0;
+  bool enable = 1;
+  int rv;
+  clib_error_t *error = NULL;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "disable"))
+	enable = 0;
+      else if (unformat (line_input, "%u", &id))
+	;
+      else
+	{
+	  error = clib_error_return (0, "parse error: '%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (id == ~0)
+    {
+      error = clib_error_return (0, "please specify SA ID");
+      goto done;
+    }
+
+  rv = ipsec_sa_set_multi_worker (id, enable);
+  switch (rv)
+    {
+    case VNET_API_ERROR_INVALID_VALUE:
+      error = clib_error_return (0, "please specify a valid SA ID");
+      break;
+    case VNET_API_ERROR_UNSUPPORTED:
+      error = clib_error_return (0, "not an ESP SA");
+      break;
+    }
+
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+/*?
+ * Let any worker encrypt or decrypt for an ESP SA instead of handing its
+ * packets off to the one thread the SA is bound to. For an outbound SA
+ * each worker reserves blocks of 256 sequence numbers, so packets leave
+ * out of sequence order and the peer's anti-replay window must be large
+ * enough to absorb that. For an inbound SA the workers update the
+ * anti-replay window with atomic operations; the window then covers half
+ * the configured size, so configure e.g. 8192 for a 4096 packet window.
+ *
+ * @cliexpar
+ * @cliexstart{ipsec sa multi-worker 10}
+ * @cliexend
+ ?*/
+VLIB_CLI_COMMAND (ipsec_sa_multi_worker_cmd, static) = {
+  .path = "ipsec sa multi-worker",
+  .short_help = "ipsec sa multi-worker <sa-id> [disable]",
+  .function = ipsec_sa_multi_worker_cli,
+};
+
+static clib_error_t *
+ipsec_sa_inline_offload_cli (vlib_main_t *vm, unformat_input_t *input,
+			     vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 id = ~0, sw_if_index = ~0;
+  clib_error_t *error = NULL;
+  bool enable = 1;
+  int rv;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "disable"))
+	enable = 0;
+      else if (unformat (line_input, "%U", unformat_vnet_sw_interface, vnm,
+			 &sw_if_index))
+	;
+      else if (unformat (line_input, "%u", &id))
+	;
+      else
+	{
+	  error = clib_error_return (0, "parse error: '%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (id == ~0)
+    {
+      error = clib_error_return (0, "please specify SA ID");
+      goto done;
+    }
+  if (sw_if_index == ~0)
+    {
+      error = clib_error_return (0, "please specify an interface");
+      goto done;
+    }
+
+  rv = ipsec_sa_set_inline_offload (id, sw_if_index, enable);
+  switch (rv)
+    {
+    case 0:
+      break;
+    case VNET_API_ERROR_INVALID_VALUE:
+      error = clib_error_return (0, "please specify a valid SA ID");
+      break;
+    case VNET_API_ERROR_VALUE_EXIST:
+      error = clib_error_return (0, "SA is already offloaded");
+      break;
+    case VNET_API_ERROR_NO_SUCH_ENTRY:
+      error = clib_error_return (0, "SA is not offloaded to the interface");
+      break;
+    case VNET_API_ERROR_UNSUPPORTED:
+      error = clib_error_return (0, "interface cannot offload the SA");
+      break;
+    default:
+      error = clib_error_return (0, "failed: %d", rv);
+      break;
+    }
+
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+/*?
+ * Let the device behind an interface do the crypto of an ESP SA inline,
+ * decrypting on receive for an inbound SA and encrypting on transmit for
+ * an outbound one. The interface has to advertise the ipsec-inline-rx or
+ * ipsec-inline-tx capability. Packets of an outbound SA must leave through
+ * that interface, as they are only encapsulated in software.
+ *
+ * @cliexpar
+ * @cliexstart{ipsec sa inline-offload 10 eth0}
+ * @cliexend
+ ?*/
+VLIB_CLI_COMMAND (ipsec_sa_inline_offload_cmd, static) = {
+  .path = "ipsec sa inline-offload",
+  .short_help = "ipsec sa inline-offload <sa-id> <interface> [disable]",
+  .function = ipsec_sa_inline_offload_cli,
+};
+
 static clib_error_t *
 ipsec_spd_add_del_command_fn (vlib_main_t * vm,
 			      unformat_input_t * input,
@@ -469,19 +469,28 @@ format_ipsec_sa (u8 * s, va_list * args)
 
   s = format (s, "\n   locks %d", sa->node.fn_locks);
   s = format (s, "\n   salt 0x%x", clib_net_to_host_u32 (sa->salt));
-  if (irt)
+  if (irt && irt->is_multi_worker)
+    s = format (s, "\n   inbound thread-index:any (multi-worker)");
+  else if (irt)
     s = format (s, "\n   inbound thread-index:%d", irt->thread_index);
-  if (ort)
+  if (ort && ort->is_multi_worker)
+    s = format (s, "\n   outbound thread-index:any (multi-worker)");
+  else if (ort)
     s = format (s, "\n   outbound thread-index:%d", ort->thread_index);
+  if (sa->inline_sw_if_index != ~0)
+    s = format (s, "\n   inline offload on %U", format_vnet_sw_if_index_name,
+		vnet_get_main (), sa->inline_sw_if_index);
   if (irt)
     s = format (s, "\n   inbound seq %lu", irt->seq64);
   if (ort)
     s = format (s, "\n   outbound seq %lu", ort->seq64);
   if (irt)
     {
-      s = format (s, "\n   window-size: %llu", irt->anti_replay_window_size);
-      s = format (s, "\n   window: Bl <- %U Tl", format_ipsec_replay_window,
-		  ipsec_sa_anti_replay_get_64b_window (irt));
+      s = format (s, "\n   window-size: %llu",
+		  ipsec_sa_anti_replay_window_size (irt));
+      if (!irt->is_multi_worker)
+	s = format (s, "\n   window: Bl <- %U Tl", format_ipsec_replay_window,
+		    ipsec_sa_anti_replay_get_64b_window (irt));
     }
   s =
     format (s, "\n   crypto alg %U", format_ipsec_crypto_alg, sa->crypto_alg);
@@ -21,6 +21,7 @@
 #include <vnet/fib/fib_entry_track.h>
 #include <vnet/ipsec/ipsec_tun.h>
 #include <vnet/ipsec/ipsec.api_enum.h>
+#include <vnet/dev/api.h>
 
 /**
  * @brief
@@ -96,16 +97,18 @@ ipsec_sa_stack (ipsec_sa_t * sa)
 void
 ipsec_sa_set_async_mode (ipsec_sa_t *sa, int is_enabled)
 {
-  u32 cipher_key_index, integ_key_index;
+  u32 cipher_key_index, integ_key_index, async_key_index;
   vnet_crypto_op_id_t inb_cipher_op_id, outb_cipher_op_id, integ_op_id;
   u32 is_async;
+
+  if (sa->linked_key_index != ~0)
+    async_key_index = sa->linked_key_index;
+  else
+    async_key_index = sa->crypto_sync_key_index;
+
   if (is_enabled)
     {
-      if (sa->linked_key_index != ~0)
-	cipher_key_index = sa->linked_key_index;
-      else
-	cipher_key_index = sa->crypto_sync_key_index;
-
+      cipher_key_index = async_key_index;
       outb_cipher_op_id = sa->crypto_async_enc_op_id;
       inb_cipher_op_id = sa->crypto_async_dec_op_id;
       integ_key_index = ~0;
@@ -129,7 +132,10 @@ ipsec_sa_set_async_mode (ipsec_sa_t *sa, int is_enabled)
       irt->integ_key_index = integ_key_index;
       irt->cipher_op_id = inb_cipher_op_id;
       irt->integ_op_id = integ_op_id;
+      irt->async_key_index = async_key_index;
       irt->is_async = is_async;
+      /* sync SAs with an async op can be switched per vector */
+      irt->is_adaptive = !is_async && sa->crypto_async_dec_op_id;
     }
 
   if (ipsec_sa_get_outb_rt (sa))
@@ -139,7 +145,9 @@ ipsec_sa_set_async_mode (ipsec_sa_t *sa, int is_enabled)
       ort->integ_key_index = integ_key_index;
       ort->cipher_op_id = outb_cipher_op_id;
       ort->integ_op_id = integ_op_id;
+      ort->async_key_index = async_key_index;
       ort->is_async = is_async;
+      ort->is_adaptive = !is_async && sa->crypto_async_enc_op_id;
     }
 }
 
@@ -348,6 +356,7 @@ ipsec_sa_update (u32 id, u16 src_port, u16 dst_port, const tunnel_t *tun,
 		}
 	    }
 	}
+      ipsec_tun_protect_cache_flush ();
       tunnel_unresolve (&sa->tunnel);
       tunnel_copy (tun, &sa->tunnel);
       if (!ipsec_sa_is_set_IS_INBOUND (sa))
@@ -410,6 +419,33 @@ ipsec_sa_update (u32 id, u16 src_port, u16 dst_port, const tunnel_t *tun,
   return (0);
 }
 
+/* every sequence number up to the SA's current one counts as seen */
+static void
+ipsec_sa_reset_replay_window (ipsec_sa_inb_rt_t *irt)
+{
+  u64 *words = (u64 *) irt->replay_window;
+  u32 n_words = irt->anti_replay_window_size / 64;
+  u64 top_blk = irt->seq64 >> IPSEC_SA_MW_BLOCK_LOG2;
+  u64 blk;
+
+  for (u32 i = 0; i < n_words; i++)
+    {
+      if (!irt->is_multi_worker)
+	{
+	  words[i] = ~0ULL;
+	  continue;
+	}
+      /* the latest block the word could hold */
+      blk = top_blk - ((top_blk - i) & (n_words - 1));
+      words[i] = (u64) (u32) blk << 32 | pow2_mask (IPSEC_SA_MW_BLOCK_BITS);
+    }
+
+  if (irt->is_multi_worker)
+    words[top_blk & (n_words - 1)] =
+      (u64) (u32) top_blk << 32 |
+      pow2_mask ((irt->seq64 & (IPSEC_SA_MW_BLOCK_BITS - 1)) + 1);
+}
+
 int
 ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
 		       ipsec_crypto_alg_t crypto_alg, const ipsec_key_t *ck,
@@ -487,6 +523,7 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
   sa->id = id;
   sa->spi = spi;
   sa->stat_index = sa_index;
+  sa->inline_sw_if_index = ~0;
   sa->protocol = proto;
   sa->salt = salt;
 
@@ -610,8 +647,7 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
 	ipsec_register_udp_port (dst_port, !ipsec_sa_is_set_IS_TUNNEL_V6 (sa));
     }
 
-  for (u32 i = 0; i < anti_replay_window_size / uword_bits; i++)
-    irt->replay_window[i] = ~0ULL;
+  ipsec_sa_reset_replay_window (irt);
 
   hash_set (im->sa_index_by_sa_id, sa->id, sa_index);
 
@@ -623,6 +659,56 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
   return (0);
 }
 
+/* add or remove an SA on the device doing its crypto inline */
+static int
+ipsec_sa_program_inline_offload (u32 sa_index, u32 sw_if_index, bool enable)
+{
+  vlib_main_t *vm = vlib_get_main ();
+  ipsec_sa_t *sa = ipsec_sa_get (sa_index);
+  ipsec_sa_inb_rt_t *irt = ipsec_sa_get_inb_rt (sa);
+  ipsec_sa_outb_rt_t *ort = ipsec_sa_get_outb_rt (sa);
+  vnet_dev_api_port_ipsec_sa_args_t args = {
+    .sw_if_index = sw_if_index,
+    .sa_index = sa_index,
+    .is_inbound = ipsec_sa_is_set_IS_INBOUND (sa),
+    .is_add = enable,
+  };
+
+  /* stop relying on the device before it forgets the SA */
+  if (!enable)
+    {
+      irt->is_inline_offload = 0;
+      ort->is_inline_offload = 0;
+      sa->inline_sw_if_index = ~0;
+    }
+
+  if (vnet_dev_api_port_ipsec_sa (vm, &args) != VNET_DEV_OK)
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  if (enable)
+    {
+      sa->inline_sw_if_index = sw_if_index;
+      if (args.is_inbound)
+	irt->is_inline_offload = 1;
+      else
+	ort->is_inline_offload = 1;
+    }
+
+  return 0;
+}
+
+/* forget the sequence numbers workers reserved from an SA */
+static void
+ipsec_sa_reset_seq_blocks (u32 sa_index)
+{
+  ipsec_main_t *im = &ipsec_main;
+  ipsec_per_thread_data_t *ptd;
+
+  vec_foreach (ptd, im->ptd)
+    if (sa_index < vec_len (ptd->seq_blocks))
+      clib_memset (ptd->seq_blocks + sa_index, 0, sizeof (ptd->seq_blocks[0]));
+}
+
 static void
 ipsec_sa_del (ipsec_sa_t * sa)
 {
@@ -639,6 +725,10 @@ ipsec_sa_del (ipsec_sa_t * sa)
   /* no recovery possible when deleting an SA */
   (void) ipsec_call_add_del_callbacks (im, sa, sa_index, 0);
 
+  if (sa->inline_sw_if_index != ~0)
+    (void) ipsec_sa_program_inline_offload (sa_index, sa->inline_sw_if_index,
+					    0);
+
   if (sa->linked_key_index != ~0)
     vnet_crypto_key_del (vm, sa->linked_key_index);
 
@@ -652,6 +742,7 @@ ipsec_sa_del (ipsec_sa_t * sa)
     vnet_crypto_key_del (vm, sa->crypto_sync_key_index);
   if (sa->integ_alg != IPSEC_INTEG_ALG_NONE)
     vnet_crypto_key_del (vm, sa->integ_sync_key_index);
+  ipsec_sa_reset_seq_blocks (sa_index);
   foreach_pointer (p, irt, ort)
     if (p)
       clib_mem_free (p);
@@ -698,6 +789,88 @@ done:
   return 0;
 }
 
+int
+ipsec_sa_set_multi_worker (u32 id, bool enable)
+{
+  ipsec_main_t *im = &ipsec_main;
+  ipsec_sa_inb_rt_t *irt;
+  ipsec_sa_outb_rt_t *ort;
+  ipsec_sa_t *sa;
+  uword *p;
+
+  p = hash_get (im->sa_index_by_sa_id, id);
+  if (!p)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  sa = ipsec_sa_get (p[0]);
+  irt = ipsec_sa_get_inb_rt (sa);
+  ort = ipsec_sa_get_outb_rt (sa);
+
+  /* only ESP has a multi-worker encrypt and decrypt path */
+  if (sa->protocol != IPSEC_PROTOCOL_ESP)
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  if (ipsec_sa_is_set_IS_INBOUND (sa))
+    {
+      if (!irt)
+	return VNET_API_ERROR_UNSUPPORTED;
+      irt->is_multi_worker = enable;
+      ipsec_sa_reset_replay_window (irt);
+      return 0;
+    }
+
+  if (!ort)
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  /* the numbers left in workers' blocks are skipped */
+  ipsec_sa_reset_seq_blocks (p[0]);
+  ort->is_multi_worker = enable;
+  return 0;
+}
+
+int
+ipsec_sa_set_inline_offload (u32 id, u32 sw_if_index, bool enable)
+{
+  ipsec_main_t *im = &ipsec_main;
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hi;
+  vnet_hw_if_caps_t cap;
+  ipsec_sa_t *sa;
+  uword *p;
+
+  p = hash_get (im->sa_index_by_sa_id, id);
+  if (!p)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  sa = ipsec_sa_get (p[0]);
+
+  if (!enable)
+    {
+      if (sa->inline_sw_if_index != sw_if_index)
+	return VNET_API_ERROR_NO_SUCH_ENTRY;
+      return ipsec_sa_program_inline_offload (p[0], sw_if_index, 0);
+    }
+
+  if (sa->inline_sw_if_index != ~0)
+    return VNET_API_ERROR_VALUE_EXIST;
+
+  /* the device builds on the ESP headers and trailers of esp-encrypt and
+   * esp-decrypt */
+  if (sa->protocol != IPSEC_PROTOCOL_ESP)
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  hi = vnet_get_sup_hw_interface_api_visible_or_null (vnm, sw_if_index);
+  if (!hi)
+    return VNET_API_ERROR_INVALID_SW_IF_INDEX;
+
+  cap = ipsec_sa_is_set_IS_INBOUND (sa) ? VNET_HW_IF_CAP_RX_IPSEC_INLINE :
+					    VNET_HW_IF_CAP_TX_IPSEC_INLINE;
+  if (!(hi->caps & cap))
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  return ipsec_sa_program_inline_offload (p[0], sw_if_index, 1);
+}
+
 void
 ipsec_sa_unlock (index_t sai)
 {
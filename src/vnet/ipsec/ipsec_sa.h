@@ -152,6 +152,9 @@ typedef struct
   u16 is_tunnel : 1;
   u16 is_transport : 1;
   u16 is_async : 1;
+  u16 is_adaptive : 1;
+  u16 is_multi_worker : 1;
+  u16 is_inline_offload : 1;
   u16 cipher_op_id;
   u16 integ_op_id;
   u8 cipher_iv_size;
@@ -163,6 +166,7 @@ typedef struct
   u16 async_op_id;
   vnet_crypto_key_index_t cipher_key_index;
   vnet_crypto_key_index_t integ_key_index;
+  vnet_crypto_key_index_t async_key_index;
   u32 anti_replay_window_size;
   uword replay_window[];
 } ipsec_sa_inb_rt_t;
@@ -180,6 +184,9 @@ typedef struct
   u16 use_anti_replay : 1;
   u16 drop_no_crypto : 1;
   u16 is_async : 1;
+  u16 is_adaptive : 1;
+  u16 is_multi_worker : 1;
+  u16 is_inline_offload : 1;
   u16 cipher_op_id;
   u16 integ_op_id;
   u8 cipher_iv_size;
@@ -196,6 +203,7 @@ typedef struct
   clib_pcg64i_random_t iv_prng;
   vnet_crypto_key_index_t cipher_key_index;
   vnet_crypto_key_index_t integ_key_index;
+  vnet_crypto_key_index_t async_key_index;
   union
   {
     ip4_header_t ip4_hdr;
@@ -204,6 +212,17 @@ typedef struct
   udp_header_t udp_hdr;
 } ipsec_sa_outb_rt_t;
 
+/* sequence numbers a multi-worker SA hands a worker at a time */
+#define IPSEC_SA_SEQ_BLOCK_SIZE 256
+
+/* A worker's block of sequence numbers of a multi-worker SA, it uses
+ * (next, end] */
+typedef struct
+{
+  u64 next;
+  u64 end;
+} ipsec_sa_seq_block_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -232,6 +251,8 @@ typedef struct
   u32 crypto_sync_key_index;
   u32 integ_sync_key_index;
   u32 linked_key_index;
+  /* interface the device doing inline crypto for the SA is on, or ~0 */
+  u32 inline_sw_if_index;
 
   /* elements with u16 size */
   u16 crypto_sync_enc_op_id;
@@ -300,6 +321,9 @@ extern int ipsec_sa_add_and_lock (
   ipsec_sa_flags_t flags, u32 salt, u16 src_port, u16 dst_port,
   u32 anti_replay_window_size, const tunnel_t *tun, u32 *sa_out_index);
 extern int ipsec_sa_bind (u32 id, u32 worker, bool bind);
+extern int ipsec_sa_set_multi_worker (u32 id, bool enable);
+extern int ipsec_sa_set_inline_offload (u32 id, u32 sw_if_index,
+					bool enable);
 extern index_t ipsec_sa_find_and_lock (u32 id);
 extern int ipsec_sa_unlock_id (u32 id);
 extern void ipsec_sa_unlock (index_t sai);
@@ -345,6 +369,41 @@ ipsec_sa_anti_replay_get_64b_window (const ipsec_sa_inb_rt_t *irt)
   return w;
 }
 
+/*
+ * Multi-worker anti-replay window.
+ * When any worker can decrypt for an SA, each 64 bit word of the window
+ * holds a block of 32 sequence numbers: the block number in the upper
+ * half and the bits of the numbers seen in the lower half. A single CAS
+ * on the word then both tests and sets a bit and recycles the word for a
+ * newer block, so no lock is needed. The same memory thus covers half as
+ * many sequence numbers.
+ */
+#define IPSEC_SA_MW_BLOCK_LOG2 5
+#define IPSEC_SA_MW_BLOCK_BITS (1 << IPSEC_SA_MW_BLOCK_LOG2)
+
+always_inline u32
+ipsec_sa_anti_replay_window_size (const ipsec_sa_inb_rt_t *irt)
+{
+  return irt->anti_replay_window_size >> irt->is_multi_worker;
+}
+
+always_inline int
+ipsec_sa_anti_replay_mw_check (const ipsec_sa_inb_rt_t *irt, u64 seq64)
+{
+  u64 *words = (u64 *) irt->replay_window;
+  u32 n_words = irt->anti_replay_window_size / 64;
+  u64 blk = seq64 >> IPSEC_SA_MW_BLOCK_LOG2;
+  u64 w = clib_atomic_load_relax_n (&words[blk & (n_words - 1)]);
+  i32 age = (u32) (w >> 32) - (u32) blk;
+
+  /* the word was recycled for a newer block */
+  if (age > 0)
+    return 1;
+  if (age < 0)
+    return 0;
+  return (w >> (seq64 & (IPSEC_SA_MW_BLOCK_BITS - 1))) & 1;
+}
+
 always_inline int
 ipsec_sa_anti_replay_check (const ipsec_sa_inb_rt_t *irt, u32 window_size,
 			    u32 seq)
@@ -353,6 +412,14 @@ ipsec_sa_anti_replay_check (const ipsec_sa_inb_rt_t *irt, u32 window_size,
    * if the packet falls left (sa->seq - seq >= window size),
    * the result is wrong */
 
+  if (irt->is_multi_worker)
+    {
+      /* in the window, so less than 2^32 behind the top */
+      u64 top = clib_atomic_load_relax_n (&irt->seq64);
+      return ipsec_sa_anti_replay_mw_check (irt,
+					    top - (u32) ((u32) top - seq));
+    }
+
   return uword_bitmap_is_bit_set ((uword *) irt->replay_window,
 				  seq & (window_size - 1));
 }
@@ -378,9 +445,10 @@ ipsec_sa_anti_replay_and_sn_advance (const ipsec_sa_inb_rt_t *irt, u32 seq,
 {
   ASSERT ((post_decrypt == false) == (hi_seq_req != 0));
 
-  u32 window_size = irt->anti_replay_window_size;
-  u32 exp_lo = irt->seq64;
-  u32 exp_hi = irt->seq64 >> 32;
+  u32 window_size = ipsec_sa_anti_replay_window_size (irt);
+  u64 seq64 = clib_atomic_load_relax_n (&irt->seq64);
+  u32 exp_lo = seq64;
+  u32 exp_hi = seq64 >> 32;
   u32 window_lower_bound = exp_lo - window_size + 1;
 
   if (!irt->use_esn)
@@ -732,6 +800,66 @@ ipsec_sa_anti_replay_advance (ipsec_sa_inb_rt_t *irt,
   return n_lost;
 }
 
+/*
+ * Multi-worker anti replay window advance
+ *  inputs need to be in host byte order.
+ * The check and the window update are one CAS on the window word, so
+ * post-decrypt this replaces both ipsec_sa_anti_replay_and_sn_advance
+ * and ipsec_sa_anti_replay_advance. The SN only ever moves forward.
+ * Returns non-zero if the packet is a replay or falls out of the window.
+ */
+always_inline int
+ipsec_sa_anti_replay_mw_advance (ipsec_sa_inb_rt_t *irt, u32 seq,
+				 u32 hi_seq, u64 *n_lost)
+{
+  u64 *words = (u64 *) irt->replay_window;
+  u32 n_words = irt->anti_replay_window_size / 64;
+  u64 seq64 = (u64) hi_seq << 32 | seq;
+  u64 blk = seq64 >> IPSEC_SA_MW_BLOCK_LOG2;
+  u64 bit = 1ULL << (seq64 & (IPSEC_SA_MW_BLOCK_BITS - 1));
+  u64 *word = &words[blk & (n_words - 1)];
+  u64 top, old, new;
+  i32 age;
+
+  *n_lost = 0;
+  top = clib_atomic_load_relax_n (&irt->seq64);
+
+  if (irt->use_anti_replay)
+    {
+      if (top >= seq64 + ipsec_sa_anti_replay_window_size (irt))
+	return 1;
+
+      old = clib_atomic_load_relax_n (word);
+      do
+	{
+	  age = (u32) (old >> 32) - (u32) blk;
+	  if (age > 0 || (age == 0 && (old & bit)))
+	    return 1;
+
+	  if (age == 0)
+	    {
+	      new = old | bit;
+	      *n_lost = 0;
+	    }
+	  else
+	    {
+	      /* holes in the block the word held and the blocks that
+	       * skipped it are lost packets */
+	      new = (u64) (u32) blk << 32 | bit;
+	      *n_lost = IPSEC_SA_MW_BLOCK_BITS - count_set_bits ((u32) old);
+	      *n_lost += (u64) ((u32) -age / n_words - 1) *
+			 IPSEC_SA_MW_BLOCK_BITS;
+	    }
+	}
+      while (!clib_atomic_cmp_and_swap_acq_relax_n (word, &old, new, 0));
+    }
+
+  while (seq64 > top &&
+	 !clib_atomic_cmp_and_swap_acq_relax_n (&irt->seq64, &top, seq64, 0))
+    ;
+
+  return 0;
+}
 
 /*
  * Makes choice for thread_id should be assigned.
@@ -209,202 +209,150 @@ single_rule_in_match_5tuple (ipsec_policy_t *policy, ipsec_fp_5tuple_t *match)
   return (1);
 }
 
+/* Take the first policy of a hash entry the packet matches, if it beats the
+ * packet's best match so far. Returns 1 if it's the packet's first match. */
+static_always_inline u32
+ipsec_fp_match_entry (ipsec_fp_lookup_value_t *val, ipsec_fp_5tuple_t *match,
+		      ipsec_policy_t **best, u32 *best_id, u32 *last_priority,
+		      int is_inbound)
+{
+  ipsec_main_t *im = &ipsec_main;
+  ipsec_policy_t *policy;
+  u32 *policy_id, is_first;
+
+  vec_foreach (policy_id, val->fp_policies_ids)
+    {
+      policy = im->policies + *policy_id;
+
+      if (is_inbound ? !single_rule_in_match_5tuple (policy, match) :
+		       !single_rule_out_match_5tuple (policy, match))
+	continue;
+
+      /* entries are sorted by priority, later ones can't do better */
+      if (*last_priority >= policy->priority)
+	return 0;
+
+      is_first = *best == 0;
+      *last_priority = policy->priority;
+      *best = policy;
+      if (best_id)
+	*best_id = *policy_id;
+      return is_first;
+    }
+
+  return 0;
+}
+
 static_always_inline u32
 ipsec_fp_in_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
 				ipsec_policy_t **policies, u32 n)
 {
   u32 last_priority[n];
-  u32 i = 0;
+  u64 hashes[n];
+  clib_bihash_kv_40_8_t keys[n];
+  u32 i;
   u32 counter = 0;
   ipsec_fp_mask_type_entry_t *mte;
   ipsec_fp_mask_id_t *mti;
-  ipsec_fp_5tuple_t *match = tuples;
-  ipsec_policy_t *policy;
-  u32 n_left = n;
-  clib_bihash_kv_40_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_40_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
+  u64 *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
-  ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[match->action];
+  ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[tuples->action];
   clib_bihash_40_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip6_lookup_hashes_pool, pspd_fp->ip6_in_lookup_hash_idx);
 
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
   clib_memset (last_priority, 0, n * sizeof (u32));
-  n_left = n;
-  while (n_left)
-    {
-      vec_foreach (mti, mask_type_ids)
-	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action == 0)
-	    continue;
-
-	  pmatch = (u64 *) match->kv_40_8.key;
-	  pmask = (u64 *) mte->mask.kv_40_8.key;
-	  pkey = (u64 *) kv.key;
 
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+  /* one pass over the burst per mask, hashing all the packets and
+   * prefetching their buckets before the lookups */
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      if (mte->mask.action == 0)
+	continue;
 
-	  if (res == 0)
-	    {
-	      /* There is a hit in the hash table. */
-	      /* Find the policy with highest priority. */
-	      /* Store the lookup results in a dedicated array. */
-
-	      if (vec_len (result_val->fp_policies_ids) > 1)
-		{
-		  u32 *policy_id;
-		  vec_foreach (policy_id, result_val->fp_policies_ids)
-		    {
-		      policy = im->policies + *policy_id;
-
-		      if (single_rule_in_match_5tuple (policy, match))
-			{
-			  if (last_priority[i] < policy->priority)
-			    {
-			      last_priority[i] = policy->priority;
-			      if (policies[i] == 0)
-				counter++;
-			      policies[i] = policy;
-			    }
-			  break;
-			}
-		    }
-		}
-	      else
-		{
-		  u32 *policy_id;
-		  ASSERT (vec_len (result_val->fp_policies_ids) == 1);
-		  policy_id = result_val->fp_policies_ids;
-		  policy = im->policies + *policy_id;
-		  if ((last_priority[i] < policy->priority) &&
-		      (single_rule_in_match_5tuple (policy, match)))
-		    {
-		      last_priority[i] = policy->priority;
-		      if (policies[i] == 0)
-			counter++;
-		      policies[i] = policy;
-		    }
-		}
-	    }
+      pmask = (u64 *) mte->mask.kv_40_8.key;
+      for (i = 0; i < n; i++)
+	{
+	  pmatch = (u64 *) tuples[i].kv_40_8.key;
+	  keys[i].key[0] = pmatch[0] & pmask[0];
+	  keys[i].key[1] = pmatch[1] & pmask[1];
+	  keys[i].key[2] = pmatch[2] & pmask[2];
+	  keys[i].key[3] = pmatch[3] & pmask[3];
+	  keys[i].key[4] = pmatch[4] & pmask[4];
+	  hashes[i] = clib_bihash_hash_40_8 (keys + i);
+	  clib_bihash_prefetch_bucket_40_8 (bihash_table, hashes[i]);
 	}
 
-      i++;
-      n_left--;
-      match++;
+      for (i = 0; i < n; i++)
+	if (!clib_bihash_search_inline_2_with_hash_40_8 (
+	      bihash_table, hashes[i], keys + i, &result))
+	  counter += ipsec_fp_match_entry (result_val, tuples + i,
+					   policies + i, 0, last_priority + i,
+					   1);
     }
+
   return counter;
 }
 
 static_always_inline u32
 ipsec_fp_in_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
 				ipsec_policy_t **policies, u32 n)
-
 {
   u32 last_priority[n];
-  u32 i = 0;
+  u64 hashes[n];
+  clib_bihash_kv_16_8_t keys[n];
+  u32 i;
   u32 counter = 0;
   ipsec_fp_mask_type_entry_t *mte;
   ipsec_fp_mask_id_t *mti;
-  ipsec_fp_5tuple_t *match = tuples;
-  ipsec_policy_t *policy;
-  u32 n_left = n;
-  clib_bihash_kv_16_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
+  u64 *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
-  ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[match->action];
+  ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[tuples->action];
   clib_bihash_16_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip4_lookup_hashes_pool, pspd_fp->ip4_in_lookup_hash_idx);
 
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
   clib_memset (last_priority, 0, n * sizeof (u32));
-  n_left = n;
-  while (n_left)
-    {
-      vec_foreach (mti, mask_type_ids)
-	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action == 0)
-	    continue;
-	  pmatch = (u64 *) match->kv_16_8.key;
-	  pmask = (u64 *) mte->mask.kv_16_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
 
-	  int res =
-	    clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+  /* one pass over the burst per mask, hashing all the packets and
+   * prefetching their buckets before the lookups */
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      if (mte->mask.action == 0)
+	continue;
 
-	  if (res == 0)
-	    {
-	      /* There is a hit in the hash table. */
-	      /* Find the policy with highest priority. */
-	      /* Store the lookup results in a dedicated array. */
-
-	      if (vec_len (result_val->fp_policies_ids) > 1)
-		{
-		  u32 *policy_id;
-		  vec_foreach (policy_id, result_val->fp_policies_ids)
-		    {
-		      policy = im->policies + *policy_id;
-
-		      if (single_rule_in_match_5tuple (policy, match))
-			{
-			  if (last_priority[i] < policy->priority)
-			    {
-			      last_priority[i] = policy->priority;
-			      if (policies[i] == 0)
-				counter++;
-			      policies[i] = policy;
-			    }
-			  break;
-			}
-		    }
-		}
-	      else
-		{
-		  u32 *policy_id;
-		  ASSERT (vec_len (result_val->fp_policies_ids) == 1);
-		  policy_id = result_val->fp_policies_ids;
-		  policy = im->policies + *policy_id;
-		  if ((last_priority[i] < policy->priority) &&
-		      (single_rule_in_match_5tuple (policy, match)))
-		    {
-		      last_priority[i] = policy->priority;
-		      if (policies[i] == 0)
-			counter++;
-		      policies[i] = policy;
-		    }
-		}
-	    }
+      pmask = (u64 *) mte->mask.kv_16_8.key;
+      for (i = 0; i < n; i++)
+	{
+	  pmatch = (u64 *) tuples[i].kv_16_8.key;
+	  keys[i].key[0] = pmatch[0] & pmask[0];
+	  keys[i].key[1] = pmatch[1] & pmask[1];
+	  hashes[i] = clib_bihash_hash_16_8 (keys + i);
+	  clib_bihash_prefetch_bucket_16_8 (bihash_table, hashes[i]);
 	}
 
-      i++;
-      n_left--;
-      match++;
+      for (i = 0; i < n; i++)
+	if (!clib_bihash_search_inline_2_with_hash_16_8 (
+	      bihash_table, hashes[i], keys + i, &result))
+	  counter += ipsec_fp_match_entry (result_val, tuples + i,
+					   policies + i, 0, last_priority + i,
+					   1);
     }
+
   return counter;
 }
 
@@ -427,23 +375,19 @@ ipsec_fp_in_policy_match_n (void *spd_fp, u8 is_ipv6,
 static_always_inline u32
 ipsec_fp_out_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
 				 ipsec_policy_t **policies, u32 *ids, u32 n)
-
 {
   u32 last_priority[n];
-  u32 i = 0;
+  u64 hashes[n];
+  clib_bihash_kv_40_8_t keys[n];
+  u32 i;
   u32 counter = 0;
   ipsec_fp_mask_type_entry_t *mte;
   ipsec_fp_mask_id_t *mti;
-  ipsec_fp_5tuple_t *match = tuples;
-  ipsec_policy_t *policy;
-
-  u32 n_left = n;
-  clib_bihash_kv_40_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_40_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
+  u64 *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids =
@@ -451,106 +395,58 @@ ipsec_fp_out_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   clib_bihash_40_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip6_lookup_hashes_pool, pspd_fp->ip6_out_lookup_hash_idx);
 
-  /*clear the list of matched policies pointers */
+  /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
   clib_memset (last_priority, 0, n * sizeof (u32));
-  n_left = n;
-  while (n_left)
-    {
-      vec_foreach (mti, mask_type_ids)
-	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action != 0)
-	    continue;
-
-	  pmatch = (u64 *) match->kv_40_8.key;
-	  pmask = (u64 *) mte->mask.kv_40_8.key;
-	  pkey = (u64 *) kv.key;
 
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+  /* one pass over the burst per mask, hashing all the packets and
+   * prefetching their buckets before the lookups */
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      if (mte->mask.action != 0)
+	continue;
 
-	  if (res == 0)
-	    {
-	      /* There is a hit in the hash table. */
-	      /* Find the policy with highest priority. */
-	      /* Store the lookup results in a dedicated array. */
-
-	      if (vec_len (result_val->fp_policies_ids) > 1)
-		{
-		  u32 *policy_id;
-		  vec_foreach (policy_id, result_val->fp_policies_ids)
-		    {
-		      policy = im->policies + *policy_id;
-
-		      if (single_rule_out_match_5tuple (policy, match))
-			{
-			  if (last_priority[i] < policy->priority)
-			    {
-			      last_priority[i] = policy->priority;
-			      if (policies[i] == 0)
-				counter++;
-			      policies[i] = policy;
-			      ids[i] = *policy_id;
-			    }
-			  break;
-			}
-		    }
-		}
-	      else
-		{
-		  u32 *policy_id;
-		  ASSERT (vec_len (result_val->fp_policies_ids) == 1);
-		  policy_id = result_val->fp_policies_ids;
-		  policy = im->policies + *policy_id;
-		  if (single_rule_out_match_5tuple (policy, match))
-		    {
-		      if (last_priority[i] < policy->priority)
-			{
-			  last_priority[i] = policy->priority;
-			  if (policies[i] == 0)
-			    counter++;
-			  policies[i] = policy;
-			  ids[i] = *policy_id;
-			}
-		    }
-		}
-	    }
+      pmask = (u64 *) mte->mask.kv_40_8.key;
+      for (i = 0; i < n; i++)
+	{
+	  pmatch = (u64 *) tuples[i].kv_40_8.key;
+	  keys[i].key[0] = pmatch[0] & pmask[0];
+	  keys[i].key[1] = pmatch[1] & pmask[1];
+	  keys[i].key[2] = pmatch[2] & pmask[2];
+	  keys[i].key[3] = pmatch[3] & pmask[3];
+	  keys[i].key[4] = pmatch[4] & pmask[4];
+	  hashes[i] = clib_bihash_hash_40_8 (keys + i);
+	  clib_bihash_prefetch_bucket_40_8 (bihash_table, hashes[i]);
 	}
-      n_left--;
-      match++;
-      i++;
+
+      for (i = 0; i < n; i++)
+	if (!clib_bihash_search_inline_2_with_hash_40_8 (
+	      bihash_table, hashes[i], keys + i, &result))
+	  counter += ipsec_fp_match_entry (result_val, tuples + i,
+					   policies + i, ids + i,
+					   last_priority + i, 0);
     }
+
   return counter;
 }
 
 static_always_inline u32
 ipsec_fp_out_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
 				 ipsec_policy_t **policies, u32 *ids, u32 n)
-
 {
   u32 last_priority[n];
-  u32 i = 0;
+  u64 hashes[n];
+  clib_bihash_kv_16_8_t keys[n];
+  u32 i;
   u32 counter = 0;
   ipsec_fp_mask_type_entry_t *mte;
   ipsec_fp_mask_id_t *mti;
-  ipsec_fp_5tuple_t *match = tuples;
-  ipsec_policy_t *policy;
-
-  u32 n_left = n;
-  clib_bihash_kv_16_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
+  u64 *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids =
@@ -561,76 +457,33 @@ ipsec_fp_out_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
   clib_memset (last_priority, 0, n * sizeof (u32));
-  n_left = n;
-  while (n_left)
-    {
-      vec_foreach (mti, mask_type_ids)
-	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action != 0)
-	    continue;
 
-	  pmatch = (u64 *) match->kv_16_8.key;
-	  pmask = (u64 *) mte->mask.kv_16_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+  /* one pass over the burst per mask, hashing all the packets and
+   * prefetching their buckets before the lookups */
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      if (mte->mask.action != 0)
+	continue;
 
-	  if (res == 0)
-	    {
-	      /* There is a hit in the hash table. */
-	      /* Find the policy with highest priority. */
-	      /* Store the lookup results in a dedicated array. */
-
-	      if (vec_len (result_val->fp_policies_ids) > 1)
-		{
-		  u32 *policy_id;
-		  vec_foreach (policy_id, result_val->fp_policies_ids)
-		    {
-		      policy = im->policies + *policy_id;
-
-		      if (single_rule_out_match_5tuple (policy, match))
-			{
-			  if (last_priority[i] < policy->priority)
-			    {
-			      last_priority[i] = policy->priority;
-			      if (policies[i] == 0)
-				counter++;
-			      policies[i] = policy;
-			      ids[i] = *policy_id;
-			    }
-			  break;
-			}
-		    }
-		}
-	      else
-		{
-		  u32 *policy_id;
-		  ASSERT (vec_len (result_val->fp_policies_ids) == 1);
-		  policy_id = result_val->fp_policies_ids;
-		  policy = im->policies + *policy_id;
-		  if ((last_priority[i] < policy->priority) &&
-		      (single_rule_out_match_5tuple (policy, match)))
-		    {
-		      last_priority[i] = policy->priority;
-		      if (policies[i] == 0)
-			counter++;
-		      policies[i] = policy;
-		      ids[i] = *policy_id;
-		    }
-		}
-	    }
+      pmask = (u64 *) mte->mask.kv_16_8.key;
+      for (i = 0; i < n; i++)
+	{
+	  pmatch = (u64 *) tuples[i].kv_16_8.key;
+	  keys[i].key[0] = pmatch[0] & pmask[0];
+	  keys[i].key[1] = pmatch[1] & pmask[1];
+	  hashes[i] = clib_bihash_hash_16_8 (keys + i);
+	  clib_bihash_prefetch_bucket_16_8 (bihash_table, hashes[i]);
 	}
 
-      i++;
-      n_left--;
-      match++;
+      for (i = 0; i < n; i++)
+	if (!clib_bihash_search_inline_2_with_hash_16_8 (
+	      bihash_table, hashes[i], keys + i, &result))
+	  counter += ipsec_fp_match_entry (result_val, tuples + i,
+					   policies + i, ids + i,
+					   last_priority + i, 0);
     }
+
   return counter;
 }
 
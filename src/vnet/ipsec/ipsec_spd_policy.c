@@ -559,51 +559,181 @@ ipsec_fp_mask_type_idx_cmp (ipsec_fp_mask_id_t *mask_id, u32 *idx)
   return mask_id->mask_type_idx == *idx;
 }
 
-int
-ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
-			 ipsec_policy_t *policy, u32 *stat_index)
+/* An aligned block of ports, those equal to value under mask */
+typedef struct
+{
+  u16 value;
+  u16 mask;
+} ipsec_fp_port_block_t;
+
+/* A 16 bit range splits into at most 30 aligned blocks */
+#define IPSEC_FP_MAX_RANGE_BLOCKS 30
+
+/* Most hash entries the port ranges of a policy are expanded to */
+#define IPSEC_FP_MAX_PORT_BLOCKS 64
+
+/* Split [start, stop] into the fewest aligned, power of 2 sized blocks */
+static_always_inline u32
+ipsec_fp_port_range_to_blocks (u16 start, u16 stop,
+			       ipsec_fp_port_block_t *blocks)
+{
+  u32 lo = start, size, n = 0;
+
+  while (lo <= stop)
+    {
+      size = lo ? lo & -lo : 1 << 16;
+      while (lo + size - 1 > stop)
+	size >>= 1;
+      blocks[n].value = lo;
+      blocks[n].mask = ~(size - 1);
+      lo += size;
+      n++;
+    }
+
+  return n;
+}
+
+/* A single block covering [start, stop], their common prefix */
+static_always_inline u32
+ipsec_fp_port_range_to_prefix (u16 start, u16 stop,
+			       ipsec_fp_port_block_t *block)
+{
+  block->mask = mask_out_highest_set_bit_u16 (start ^ stop);
+  block->value = start & block->mask;
+  return 1;
+}
+
+/*
+ * Port blocks an outbound policy is hashed with, one entry per pair of
+ * local and remote block. Splitting the ranges into aligned blocks means a
+ * packet only hits the entries of policies whose ranges it is in, instead
+ * of those of every policy sharing a prefix of its ports, which would all
+ * need to be checked one by one. The wider of the two ranges falls back to
+ * its common prefix if that would take too many entries.
+ */
+static_always_inline void
+ipsec_fp_get_policy_port_blocks (ipsec_policy_t *policy,
+				 ipsec_fp_port_block_t *lblocks,
+				 u32 *n_lblocks,
+				 ipsec_fp_port_block_t *rblocks,
+				 u32 *n_rblocks)
+{
+  if (!((policy->protocol == IP_PROTOCOL_TCP) ||
+	(policy->protocol == IP_PROTOCOL_UDP) ||
+	(policy->protocol == IP_PROTOCOL_SCTP)))
+    {
+      lblocks[0] = rblocks[0] = (ipsec_fp_port_block_t){ 0 };
+      *n_lblocks = *n_rblocks = 1;
+      return;
+    }
+
+  *n_lblocks = ipsec_fp_port_range_to_blocks (policy->lport.start,
+					      policy->lport.stop, lblocks);
+  *n_rblocks = ipsec_fp_port_range_to_blocks (policy->rport.start,
+					      policy->rport.stop, rblocks);
+
+  /* an empty range still gets an entry, as the prefix of its bounds */
+  if (!*n_lblocks)
+    *n_lblocks = ipsec_fp_port_range_to_prefix (policy->lport.start,
+						policy->lport.stop, lblocks);
+  if (!*n_rblocks)
+    *n_rblocks = ipsec_fp_port_range_to_prefix (policy->rport.start,
+						policy->rport.stop, rblocks);
+
+  if (*n_lblocks * *n_rblocks <= IPSEC_FP_MAX_PORT_BLOCKS)
+    return;
+
+  if (*n_lblocks > *n_rblocks)
+    *n_lblocks = ipsec_fp_port_range_to_prefix (policy->lport.start,
+						policy->lport.stop, lblocks);
+  else
+    *n_rblocks = ipsec_fp_port_range_to_prefix (policy->rport.start,
+						policy->rport.stop, rblocks);
+}
+
+static_always_inline void
+ipsec_fp_set_port_blocks (ipsec_fp_5tuple_t *tuple, ipsec_fp_5tuple_t *mask,
+			  ipsec_fp_port_block_t *lblock,
+			  ipsec_fp_port_block_t *rblock)
+{
+  tuple->lport = lblock->value;
+  tuple->rport = rblock->value;
+  mask->lport = lblock->mask;
+  mask->rport = rblock->mask;
+}
+
+/* Get the mask type for mask, a new one if no entry uses it yet */
+static_always_inline u32
+ipsec_fp_get_mask_type (ipsec_main_t *im, ipsec_fp_5tuple_t *mask)
 {
-  u32 mask_index, searched_idx;
-  ipsec_policy_t *vp;
   ipsec_fp_mask_type_entry_t *mte;
-  u32 policy_index;
-  clib_bihash_kv_16_8_t kv;
-  clib_bihash_kv_16_8_t result;
-  ipsec_fp_lookup_value_t *result_val =
-    (ipsec_fp_lookup_value_t *) &result.value;
-  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  u32 mask_index;
 
-  ipsec_fp_5tuple_t mask, policy_5tuple;
-  int res;
-  bool inbound = ipsec_is_policy_inbound (policy);
-  clib_bihash_16_8_t *bihash_table =
-    inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
-				 fp_spd->ip4_in_lookup_hash_idx) :
-		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
-				 fp_spd->ip4_out_lookup_hash_idx);
+  mask_index = find_mask_type_index (im, mask);
+  if (mask_index != ~0)
+    return mask_index;
 
-  ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
-  pool_get (im->policies, vp);
-  policy_index = vp - im->policies;
-  vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
-  vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
-  *stat_index = policy_index;
-  mask_index = find_mask_type_index (im, &mask);
+  pool_get (im->fp_mask_types, mte);
+  clib_memcpy (&mte->mask, mask, sizeof (*mask));
+  mte->refcount = 0;
 
-  if (mask_index == ~0)
+  return mte - im->fp_mask_types;
+}
+
+static_always_inline void
+ipsec_fp_spd_mask_type_ref (ipsec_spd_fp_t *fp_spd, u32 policy_type,
+			    u32 mask_index)
+{
+  u32 searched_idx;
+
+  searched_idx =
+    vec_search_with_function (fp_spd->fp_mask_ids[policy_type], &mask_index,
+			      ipsec_fp_mask_type_idx_cmp);
+  if (~0 == searched_idx)
     {
-      /* mask type not found, we need to create a new entry */
-      pool_get (im->fp_mask_types, mte);
-      mask_index = mte - im->fp_mask_types;
-      mte->refcount = 0;
+      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
+      vec_add1 (fp_spd->fp_mask_ids[policy_type], mask_id);
     }
   else
-    mte = im->fp_mask_types + mask_index;
+    (fp_spd->fp_mask_ids[policy_type] + searched_idx)->refcount++;
+}
 
-  policy->fp_mask_type_id = mask_index;
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+static_always_inline void
+ipsec_fp_spd_mask_type_unref (ipsec_spd_fp_t *fp_spd, u32 policy_type,
+			      u32 mask_index)
+{
+  u32 imt;
 
-  fill_ip4_hash_policy_kv (&policy_5tuple, &mask, &kv);
+  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy_type])
+    {
+      if ((fp_spd->fp_mask_ids[policy_type] + imt)->mask_type_idx ==
+	  mask_index)
+	{
+	  if ((fp_spd->fp_mask_ids[policy_type] + imt)->refcount-- == 1)
+	    vec_del1 (fp_spd->fp_mask_ids[policy_type], imt);
+	  break;
+	}
+    }
+}
+
+/* Add policy_index to the entry of tuple under mask, in priority order */
+static int
+ipsec_fp_ip4_add_key (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+		      clib_bihash_16_8_t *bihash_table, ipsec_policy_t *policy,
+		      u32 policy_index, ipsec_fp_5tuple_t *tuple,
+		      ipsec_fp_5tuple_t *mask, u32 *mask_index)
+{
+  clib_bihash_kv_16_8_t kv;
+  clib_bihash_kv_16_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  int res;
+
+  *mask_index = ipsec_fp_get_mask_type (im, mask);
+  pool_elt_at_index (im->fp_mask_types, *mask_index)->refcount++;
+
+  fill_ip4_hash_policy_kv (tuple, mask, &kv);
 
   res = clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
   if (res != 0)
@@ -613,7 +743,10 @@ ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
       res = clib_bihash_add_del_16_8 (bihash_table, &kv, 1);
 
       if (res != 0)
-	goto error;
+	{
+	  vec_free (key_val->fp_policies_ids);
+	  goto error;
+	}
     }
   else
     {
@@ -642,80 +775,131 @@ ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 	}
     }
 
-  if (mte->refcount == 0)
-    {
-      clib_memcpy (&mte->mask, &mask, sizeof (mask));
-      mte->refcount = 0;
-    }
+  ipsec_fp_spd_mask_type_ref (fp_spd, policy->type, *mask_index);
+  return 0;
 
-  searched_idx =
-    vec_search_with_function (fp_spd->fp_mask_ids[policy->type], &mask_index,
-			      ipsec_fp_mask_type_idx_cmp);
-  if (~0 == searched_idx)
+error:
+  ipsec_fp_release_mask_type (im, *mask_index);
+  return -1;
+}
+
+/* Remove policy_index from the entry of tuple under mask */
+static int
+ipsec_fp_ip4_del_key (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+		      clib_bihash_16_8_t *bihash_table, u32 policy_type,
+		      u32 policy_index, ipsec_fp_5tuple_t *tuple,
+		      ipsec_fp_5tuple_t *mask)
+{
+  clib_bihash_kv_16_8_t kv;
+  clib_bihash_kv_16_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  u32 ii, mask_index;
+
+  fill_ip4_hash_policy_kv (tuple, mask, &kv);
+  if (clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result))
+    return -1;
+
+  ii = vec_search (result_val->fp_policies_ids, policy_index);
+  if (ii == ~0)
+    return -1;
+
+  if (vec_len (result_val->fp_policies_ids) == 1)
     {
-      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
-      vec_add1 (fp_spd->fp_mask_ids[policy->type], mask_id);
+      vec_free (result_val->fp_policies_ids);
+      clib_bihash_add_del_16_8 (bihash_table, &result, 0);
     }
   else
-    (fp_spd->fp_mask_ids[policy->type] + searched_idx)->refcount++;
+    vec_delete (result_val->fp_policies_ids, 1, ii);
 
-  mte->refcount++;
-  clib_memcpy (vp, policy, sizeof (*vp));
+  mask_index = find_mask_type_index (im, mask);
+  ASSERT (mask_index != ~0);
+  ipsec_fp_spd_mask_type_unref (fp_spd, policy_type, mask_index);
+  ipsec_fp_release_mask_type (im, mask_index);
 
   return 0;
-
-error:
-  pool_put (im->policies, vp);
-  ipsec_fp_release_mask_type (im, mask_index);
-  return -1;
 }
 
 int
-ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy, u32 *stat_index)
 {
-
-  u32 mask_index, searched_idx;
+  ipsec_fp_port_block_t lblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  ipsec_fp_port_block_t rblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  u32 n_lblocks = 1, n_rblocks = 1, il, ir, n_added = 0, mask_index;
   ipsec_policy_t *vp;
-  ipsec_fp_mask_type_entry_t *mte;
   u32 policy_index;
-  clib_bihash_kv_40_8_t kv;
-  clib_bihash_kv_40_8_t result;
-  ipsec_fp_lookup_value_t *result_val =
-    (ipsec_fp_lookup_value_t *) &result.value;
-  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
-
   ipsec_fp_5tuple_t mask, policy_5tuple;
-  int res;
   bool inbound = ipsec_is_policy_inbound (policy);
+  clib_bihash_16_8_t *bihash_table =
+    inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
+				 fp_spd->ip4_in_lookup_hash_idx) :
+		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
+				 fp_spd->ip4_out_lookup_hash_idx);
+
+  ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
+  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  if (!inbound)
+    ipsec_fp_get_policy_port_blocks (policy, lblocks, &n_lblocks, rblocks,
+				     &n_rblocks);
 
-  ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
   pool_get (im->policies, vp);
   policy_index = vp - im->policies;
   vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
   vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
   *stat_index = policy_index;
-  mask_index = find_mask_type_index (im, &mask);
-  clib_bihash_40_8_t *bihash_table =
-    inbound ? pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
-				 fp_spd->ip6_in_lookup_hash_idx) :
-		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
-				 fp_spd->ip6_out_lookup_hash_idx);
 
-  if (mask_index == ~0)
-    {
-      /* mask type not found, we need to create a new entry */
-      pool_get (im->fp_mask_types, mte);
-      mask_index = mte - im->fp_mask_types;
-      mte->refcount = 0;
-    }
-  else
-    mte = im->fp_mask_types + mask_index;
+  for (il = 0; il < n_lblocks; il++)
+    for (ir = 0; ir < n_rblocks; ir++)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	if (ipsec_fp_ip4_add_key (im, fp_spd, bihash_table, policy,
+				  policy_index, &policy_5tuple, &mask,
+				  &mask_index))
+	  goto error;
+	if (n_added++ == 0)
+	  policy->fp_mask_type_id = mask_index;
+      }
 
-  policy->fp_mask_type_id = mask_index;
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  clib_memcpy (vp, policy, sizeof (*vp));
 
-  fill_ip6_hash_policy_kv (&policy_5tuple, &mask, &kv);
+  return 0;
+
+error:
+  /* remove the entries added so far */
+  for (il = 0; il < n_lblocks && n_added; il++)
+    for (ir = 0; ir < n_rblocks && n_added; ir++, n_added--)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	ipsec_fp_ip4_del_key (im, fp_spd, bihash_table, policy->type,
+			      policy_index, &policy_5tuple, &mask);
+      }
+  pool_put (im->policies, vp);
+  return -1;
+}
+
+/* Add policy_index to the entry of tuple under mask, in priority order */
+static int
+ipsec_fp_ip6_add_key (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+		      clib_bihash_40_8_t *bihash_table, ipsec_policy_t *policy,
+		      u32 policy_index, ipsec_fp_5tuple_t *tuple,
+		      ipsec_fp_5tuple_t *mask, u32 *mask_index)
+{
+  clib_bihash_kv_40_8_t kv;
+  clib_bihash_kv_40_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  int res;
+
+  *mask_index = ipsec_fp_get_mask_type (im, mask);
+  pool_elt_at_index (im->fp_mask_types, *mask_index)->refcount++;
+
+  fill_ip6_hash_policy_kv (tuple, mask, &kv);
 
   res = clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
   if (res != 0)
@@ -723,8 +907,12 @@ ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
       /* key was not found crate a new entry */
       vec_add1 (key_val->fp_policies_ids, policy_index);
       res = clib_bihash_add_del_40_8 (bihash_table, &kv, 1);
+
       if (res != 0)
-	goto error;
+	{
+	  vec_free (key_val->fp_policies_ids);
+	  goto error;
+	}
     }
   else
     {
@@ -753,31 +941,110 @@ ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 	}
     }
 
-  if (mte->refcount == 0)
-    {
-      clib_memcpy (&mte->mask, &mask, sizeof (mask));
-      mte->refcount = 0;
-    }
+  ipsec_fp_spd_mask_type_ref (fp_spd, policy->type, *mask_index);
+  return 0;
 
-  searched_idx =
-    vec_search_with_function (fp_spd->fp_mask_ids[policy->type], &mask_index,
-			      ipsec_fp_mask_type_idx_cmp);
-  if (~0 == searched_idx)
+error:
+  ipsec_fp_release_mask_type (im, *mask_index);
+  return -1;
+}
+
+/* Remove policy_index from the entry of tuple under mask */
+static int
+ipsec_fp_ip6_del_key (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+		      clib_bihash_40_8_t *bihash_table, u32 policy_type,
+		      u32 policy_index, ipsec_fp_5tuple_t *tuple,
+		      ipsec_fp_5tuple_t *mask)
+{
+  clib_bihash_kv_40_8_t kv;
+  clib_bihash_kv_40_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  u32 ii, mask_index;
+
+  fill_ip6_hash_policy_kv (tuple, mask, &kv);
+  if (clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result))
+    return -1;
+
+  ii = vec_search (result_val->fp_policies_ids, policy_index);
+  if (ii == ~0)
+    return -1;
+
+  if (vec_len (result_val->fp_policies_ids) == 1)
     {
-      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
-      vec_add1 (fp_spd->fp_mask_ids[policy->type], mask_id);
+      vec_free (result_val->fp_policies_ids);
+      clib_bihash_add_del_40_8 (bihash_table, &result, 0);
     }
   else
-    (fp_spd->fp_mask_ids[policy->type] + searched_idx)->refcount++;
+    vec_delete (result_val->fp_policies_ids, 1, ii);
+
+  mask_index = find_mask_type_index (im, mask);
+  ASSERT (mask_index != ~0);
+  ipsec_fp_spd_mask_type_unref (fp_spd, policy_type, mask_index);
+  ipsec_fp_release_mask_type (im, mask_index);
+
+  return 0;
+}
+
+int
+ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			 ipsec_policy_t *policy, u32 *stat_index)
+{
+  ipsec_fp_port_block_t lblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  ipsec_fp_port_block_t rblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  u32 n_lblocks = 1, n_rblocks = 1, il, ir, n_added = 0, mask_index;
+  ipsec_policy_t *vp;
+  u32 policy_index;
+  ipsec_fp_5tuple_t mask, policy_5tuple;
+  bool inbound = ipsec_is_policy_inbound (policy);
+  clib_bihash_40_8_t *bihash_table =
+    inbound ? pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
+				 fp_spd->ip6_in_lookup_hash_idx) :
+		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
+				 fp_spd->ip6_out_lookup_hash_idx);
+
+  ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
+  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  if (!inbound)
+    ipsec_fp_get_policy_port_blocks (policy, lblocks, &n_lblocks, rblocks,
+				     &n_rblocks);
+
+  pool_get (im->policies, vp);
+  policy_index = vp - im->policies;
+  vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
+  vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
+  *stat_index = policy_index;
+
+  for (il = 0; il < n_lblocks; il++)
+    for (ir = 0; ir < n_rblocks; ir++)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	if (ipsec_fp_ip6_add_key (im, fp_spd, bihash_table, policy,
+				  policy_index, &policy_5tuple, &mask,
+				  &mask_index))
+	  goto error;
+	if (n_added++ == 0)
+	  policy->fp_mask_type_id = mask_index;
+      }
 
-  mte->refcount++;
   clib_memcpy (vp, policy, sizeof (*vp));
 
   return 0;
 
 error:
+  /* remove the entries added so far */
+  for (il = 0; il < n_lblocks && n_added; il++)
+    for (ir = 0; ir < n_rblocks && n_added; ir++, n_added--)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	ipsec_fp_ip6_del_key (im, fp_spd, bihash_table, policy->type,
+			      policy_index, &policy_5tuple, &mask);
+      }
   pool_put (im->policies, vp);
-  ipsec_fp_release_mask_type (im, mask_index);
   return -1;
 }
 
@@ -785,7 +1052,9 @@ int
 ipsec_fp_ip6_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy)
 {
-  int res;
+  ipsec_fp_port_block_t lblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  ipsec_fp_port_block_t rblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  u32 n_lblocks = 1, n_rblocks = 1, il, ir, *policy_id, policy_index = ~0;
   ipsec_fp_5tuple_t mask = { 0 }, policy_5tuple;
   clib_bihash_kv_40_8_t kv;
   clib_bihash_kv_40_8_t result;
@@ -797,115 +1066,108 @@ ipsec_fp_ip6_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 				 fp_spd->ip6_in_lookup_hash_idx) :
 		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
 				 fp_spd->ip6_out_lookup_hash_idx);
-
   ipsec_policy_t *vp;
-  u32 ii, imt;
 
   ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
   ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  if (!inbound)
+    {
+      ipsec_fp_get_policy_port_blocks (policy, lblocks, &n_lblocks, rblocks,
+				       &n_rblocks);
+      ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks, rblocks);
+    }
+
+  /* the policy is in all its entries, find it in the first one */
   fill_ip6_hash_policy_kv (&policy_5tuple, &mask, &kv);
-  res = clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-  if (res != 0)
+  if (clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result))
     return -1;
 
-  vec_foreach_index (ii, result_val->fp_policies_ids)
-    {
-      vp =
-	pool_elt_at_index (im->policies, *(result_val->fp_policies_ids + ii));
-      if (ipsec_policy_is_equal (vp, policy))
-	{
-	  if (vec_len (result_val->fp_policies_ids) == 1)
-	    {
-	      vec_free (result_val->fp_policies_ids);
-	      clib_bihash_add_del_40_8 (bihash_table, &result, 0);
-	    }
-	  else
-	    vec_delete (result_val->fp_policies_ids, 1, ii);
-
-	  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy->type])
-	    {
-	      if ((fp_spd->fp_mask_ids[policy->type] + imt)->mask_type_idx ==
-		  vp->fp_mask_type_id)
-		{
+  vec_foreach (policy_id, result_val->fp_policies_ids)
+    if (ipsec_policy_is_equal (pool_elt_at_index (im->policies, *policy_id),
+			       policy))
+      {
+	policy_index = *policy_id;
+	break;
+      }
 
-		  if ((fp_spd->fp_mask_ids[policy->type] + imt)->refcount-- ==
-		      1)
-		    vec_del1 (fp_spd->fp_mask_ids[policy->type], imt);
+  if (policy_index == ~0)
+    return -1;
 
-		  break;
-		}
-	    }
+  for (il = 0; il < n_lblocks; il++)
+    for (ir = 0; ir < n_rblocks; ir++)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	ipsec_fp_ip6_del_key (im, fp_spd, bihash_table, policy->type,
+			      policy_index, &policy_5tuple, &mask);
+      }
 
-	  ipsec_fp_release_mask_type (im, vp->fp_mask_type_id);
-	  ipsec_sa_unlock (vp->sa_index);
-	  pool_put (im->policies, vp);
-	  return 0;
-	}
-    }
-  return -1;
+  vp = pool_elt_at_index (im->policies, policy_index);
+  ipsec_sa_unlock (vp->sa_index);
+  pool_put (im->policies, vp);
+  return 0;
 }
 
 int
 ipsec_fp_ip4_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy)
 {
-  int res;
+  ipsec_fp_port_block_t lblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  ipsec_fp_port_block_t rblocks[IPSEC_FP_MAX_RANGE_BLOCKS];
+  u32 n_lblocks = 1, n_rblocks = 1, il, ir, *policy_id, policy_index = ~0;
   ipsec_fp_5tuple_t mask = { 0 }, policy_5tuple;
   clib_bihash_kv_16_8_t kv;
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
   bool inbound = ipsec_is_policy_inbound (policy);
-  ipsec_policy_t *vp;
-  u32 ii, imt;
   clib_bihash_16_8_t *bihash_table =
     inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
 				 fp_spd->ip4_in_lookup_hash_idx) :
 		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
 				 fp_spd->ip4_out_lookup_hash_idx);
+  ipsec_policy_t *vp;
 
   ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
   ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
-  fill_ip4_hash_policy_kv (&policy_5tuple, &mask, &kv);
-  res = clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
+  if (!inbound)
+    {
+      ipsec_fp_get_policy_port_blocks (policy, lblocks, &n_lblocks, rblocks,
+				       &n_rblocks);
+      ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks, rblocks);
+    }
 
-  if (res != 0)
+  /* the policy is in all its entries, find it in the first one */
+  fill_ip4_hash_policy_kv (&policy_5tuple, &mask, &kv);
+  if (clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result))
     return -1;
 
-  vec_foreach_index (ii, result_val->fp_policies_ids)
-    {
-      vp =
-	pool_elt_at_index (im->policies, *(result_val->fp_policies_ids + ii));
-      if (ipsec_policy_is_equal (vp, policy))
-	{
-	  if (vec_len (result_val->fp_policies_ids) == 1)
-	    {
-	      vec_free (result_val->fp_policies_ids);
-	      clib_bihash_add_del_16_8 (bihash_table, &result, 0);
-	    }
-	  else
-	    vec_delete (result_val->fp_policies_ids, 1, ii);
+  vec_foreach (policy_id, result_val->fp_policies_ids)
+    if (ipsec_policy_is_equal (pool_elt_at_index (im->policies, *policy_id),
+			       policy))
+      {
+	policy_index = *policy_id;
+	break;
+      }
 
-	  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy->type])
-	    {
-	      if ((fp_spd->fp_mask_ids[policy->type] + imt)->mask_type_idx ==
-		  vp->fp_mask_type_id)
-		{
+  if (policy_index == ~0)
+    return -1;
 
-		  if ((fp_spd->fp_mask_ids[policy->type] + imt)->refcount-- ==
-		      1)
-		    vec_del1 (fp_spd->fp_mask_ids[policy->type], imt);
+  for (il = 0; il < n_lblocks; il++)
+    for (ir = 0; ir < n_rblocks; ir++)
+      {
+	if (!inbound)
+	  ipsec_fp_set_port_blocks (&policy_5tuple, &mask, lblocks + il,
+				    rblocks + ir);
+	ipsec_fp_ip4_del_key (im, fp_spd, bihash_table, policy->type,
+			      policy_index, &policy_5tuple, &mask);
+      }
 
-		  break;
-		}
-	    }
-	  ipsec_fp_release_mask_type (im, vp->fp_mask_type_id);
-	  ipsec_sa_unlock (vp->sa_index);
-	  pool_put (im->policies, vp);
-	  return 0;
-	}
-    }
-  return -1;
+  vp = pool_elt_at_index (im->policies, policy_index);
+  ipsec_sa_unlock (vp->sa_index);
+  pool_put (im->policies, vp);
+  return 0;
 }
 
 int
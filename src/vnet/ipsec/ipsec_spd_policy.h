@@ -166,7 +166,7 @@ typedef struct
   /** Required for pool_get_aligned */
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   ipsec_fp_5tuple_t mask;
-  u32 refcount; /* counts how many policies use this mask */
+  u32 refcount; /* counts how many hash entries use this mask */
 } ipsec_fp_mask_type_entry_t;
 
 /*
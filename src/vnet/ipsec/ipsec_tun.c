@@ -44,6 +44,12 @@ vlib_log_class_t ipsec_tun_protect_logger;
  */
 ipsec_tun_protect_t *ipsec_tun_protect_pool;
 
+/**
+ * Per-worker caches of the protect lookup tables and their generation
+ */
+ipsec_tun_protect_cache_t *ipsec_tun_protect_caches;
+volatile u32 ipsec_tun_protect_epoch;
+
 /**
  * Adj delegate registered type
  */
@@ -227,6 +233,15 @@ ipsec_tun_protect_find (u32 sw_if_index, const ip_address_t * nh)
   return (p[0]);
 }
 
+void
+ipsec_tun_protect_cache_flush (void)
+{
+  /* workers reset their cache when they see the epoch change */
+  vec_validate_aligned (ipsec_tun_protect_caches, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
+  ipsec_tun_protect_epoch++;
+}
+
 static void
 ipsec_tun_protect_rx_db_add (ipsec_main_t * im,
 			     const ipsec_tun_protect_t * itp)
@@ -291,6 +306,8 @@ ipsec_tun_protect_rx_db_add (ipsec_main_t * im,
 	  ipsec_tun_register_nodes (AF_IP6);
 	}
   }))
+
+  ipsec_tun_protect_cache_flush ();
 }
 
 static adj_walk_rc_t
@@ -403,6 +420,8 @@ ipsec_tun_protect_rx_db_remove (ipsec_main_t * im,
           }
       }
   }));
+
+  ipsec_tun_protect_cache_flush ();
 }
 
 static adj_walk_rc_t
@@ -96,6 +96,26 @@ STATIC_ASSERT_OFFSET_OF (ipsec6_tunnel_kv_t, value,
 extern u8 *format_ipsec4_tunnel_kv (u8 * s, va_list * args);
 extern u8 *format_ipsec6_tunnel_kv (u8 * s, va_list * args);
 
+/**
+ * Per-worker direct mapped cache of recent protect lookups, indexed by the
+ * bihash hash of the key. It is emptied whenever the lookup tables change,
+ * which the control plane signals by bumping ipsec_tun_protect_epoch.
+ */
+#define IPSEC_TUN_PROTECT_CACHE_SIZE 256
+
+typedef struct ipsec_tun_protect_cache_t_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  u32 epoch;
+  ipsec4_tunnel_kv_t kv4[IPSEC_TUN_PROTECT_CACHE_SIZE];
+  ipsec6_tunnel_kv_t kv6[IPSEC_TUN_PROTECT_CACHE_SIZE];
+} ipsec_tun_protect_cache_t;
+
+extern ipsec_tun_protect_cache_t *ipsec_tun_protect_caches;
+extern volatile u32 ipsec_tun_protect_epoch;
+
+extern void ipsec_tun_protect_cache_flush (void);
+
 typedef struct ipsec_ep_t_
 {
   ip46_address_t src;
@@ -105,6 +105,83 @@ ipsec_ip6_if_no_tunnel (vlib_node_runtime_t *node, vlib_buffer_t *b,
   return VNET_DEVICE_INPUT_NEXT_PUNT;
 }
 
+always_inline esp_header_t *
+ipsec_tun_protect_esp_header (vlib_buffer_t *b, int is_ip6)
+{
+  u8 *ip = b->data + vnet_buffer (b)->l3_hdr_offset;
+  u16 hdr_sz, proto;
+
+  if (is_ip6)
+    {
+      hdr_sz = sizeof (ip6_header_t);
+      proto = ((ip6_header_t *) ip)->protocol;
+    }
+  else
+    {
+      hdr_sz = ip4_header_bytes ((ip4_header_t *) ip);
+      proto = ((ip4_header_t *) ip)->protocol;
+    }
+
+  if (proto == IP_PROTOCOL_UDP)
+    hdr_sz += sizeof (udp_header_t);
+
+  return (esp_header_t *) (ip + hdr_sz);
+}
+
+/*
+ * Hash every packet's lookup key up front and prefetch the bihash buckets
+ * of those the per-worker cache cannot answer, so the lookups in the main
+ * loop find their buckets in cache.
+ */
+always_inline void
+ipsec_tun_protect_input_hash (vlib_buffer_t **b, u32 n_left, u64 *hashes,
+			      u64 *miss_bmp, ipsec_tun_protect_cache_t *cache,
+			      int is_ip6)
+{
+  ipsec_main_t *im = &ipsec_main;
+  u32 i, ci;
+
+  clib_memset_u64 (miss_bmp, 0, VLIB_FRAME_SIZE / 64);
+
+  for (i = 0; i < n_left; i++)
+    {
+      esp_header_t *esp = ipsec_tun_protect_esp_header (b[i], is_ip6);
+      u8 *ip = b[i]->data + vnet_buffer (b[i])->l3_hdr_offset;
+
+      if (is_ip6)
+	{
+	  ipsec6_tunnel_kv_t kv = {
+	    .key = {
+	      .remote_ip = ((ip6_header_t *) ip)->src_address,
+	      .spi = esp->spi,
+	    },
+	  };
+	  hashes[i] = clib_bihash_hash_24_16 ((clib_bihash_kv_24_16_t *) &kv);
+	  ci = hashes[i] & (IPSEC_TUN_PROTECT_CACHE_SIZE - 1);
+	  if (memcmp (&cache->kv6[ci].key, &kv.key, sizeof (kv.key)))
+	    {
+	      clib_bihash_prefetch_bucket_24_16 (&im->tun6_protect_by_key,
+						 hashes[i]);
+	      miss_bmp[i / 64] |= 1ULL << (i % 64);
+	    }
+	}
+      else
+	{
+	  ipsec4_tunnel_kv_t kv;
+	  ipsec4_tunnel_mk_key (&kv, &((ip4_header_t *) ip)->src_address,
+				esp->spi);
+	  hashes[i] = clib_bihash_hash_8_16 ((clib_bihash_kv_8_16_t *) &kv);
+	  ci = hashes[i] & (IPSEC_TUN_PROTECT_CACHE_SIZE - 1);
+	  if (cache->kv4[ci].key != kv.key)
+	    {
+	      clib_bihash_prefetch_bucket_8_16 (&im->tun4_protect_by_key,
+						hashes[i]);
+	      miss_bmp[i / 64] |= 1ULL << (i % 64);
+	    }
+	}
+    }
+}
+
 always_inline uword
 ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 				vlib_frame_t * from_frame, int is_ip6)
@@ -119,6 +196,8 @@ ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 n_left_from, *from;
   u16 nexts[VLIB_FRAME_SIZE], *next;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u64 hashes[VLIB_FRAME_SIZE], miss_bmp[VLIB_FRAME_SIZE / 64];
+  ipsec_tun_protect_cache_t *cache;
 
   from = vlib_frame_vector_args (from_frame);
   n_left_from = from_frame->n_vectors;
@@ -127,6 +206,17 @@ ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   b = bufs;
   next = nexts;
 
+  cache = vec_elt_at_index (ipsec_tun_protect_caches, thread_index);
+  if (PREDICT_FALSE (cache->epoch != ipsec_tun_protect_epoch))
+    {
+      clib_memset (cache->kv4, 0xff, sizeof (cache->kv4));
+      clib_memset (cache->kv6, 0xff, sizeof (cache->kv6));
+      cache->epoch = ipsec_tun_protect_epoch;
+    }
+
+  ipsec_tun_protect_input_hash (bufs, n_left_from, hashes, miss_bmp, cache,
+				is_ip6);
+
   clib_memset_u16 (
     nexts, is_ip6 ? im->esp6_decrypt_next_index : im->esp4_decrypt_next_index,
     n_left_from);
@@ -165,6 +255,23 @@ ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       esp_header_t *esp0;
       u16 buf_rewind0;
 
+      u32 i0, ci0, pf0;
+
+      i0 = b - bufs;
+      ci0 = hashes[i0] & (IPSEC_TUN_PROTECT_CACHE_SIZE - 1);
+
+      /* the bucket was prefetched in the hash pass, now fetch the kvp */
+      pf0 = i0 + 4;
+      if (n_left_from > 4 && (miss_bmp[pf0 / 64] >> (pf0 % 64) & 1))
+	{
+	  if (is_ip6)
+	    clib_bihash_prefetch_data_24_16 (&im->tun6_protect_by_key,
+					     hashes[i0 + 4]);
+	  else
+	    clib_bihash_prefetch_data_8_16 (&im->tun4_protect_by_key,
+					    hashes[i0 + 4]);
+	}
+
       ip40 =
 	(ip4_header_t *) (b[0]->data + vnet_buffer (b[0])->l3_hdr_offset);
 
@@ -263,17 +370,25 @@ ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	    {
 	      clib_memcpy_fast (&itr0, &last_result, sizeof (itr0));
 	    }
+	  else if (memcmp (&cache->kv6[ci0].key, &key60->key,
+			   sizeof (key60->key)) == 0)
+	    {
+	      clib_memcpy_fast (&itr0, &cache->kv6[ci0].value, sizeof (itr0));
+	      clib_memcpy_fast (&last_result, &itr0, sizeof (last_result));
+	      clib_memcpy_fast (&last_key6, key60, sizeof (last_key6));
+	    }
 	  else
 	    {
-	      int rv =
-		clib_bihash_search_inline_24_16 (&im->tun6_protect_by_key,
-						 &bkey60);
+	      int rv = clib_bihash_search_inline_with_hash_24_16 (
+		&im->tun6_protect_by_key, hashes[i0], &bkey60);
 	      if (!rv)
 		{
 		  clib_memcpy_fast (&itr0, &bkey60.value, sizeof (itr0));
 		  clib_memcpy_fast (&last_result, &bkey60.value,
 				    sizeof (last_result));
 		  clib_memcpy_fast (&last_key6, key60, sizeof (last_key6));
+		  clib_memcpy_fast (&cache->kv6[ci0], &bkey60,
+				    sizeof (cache->kv6[ci0]));
 		}
 	      else
 		{
@@ -292,17 +407,24 @@ ipsec_tun_protect_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	    {
 	      clib_memcpy_fast (&itr0, &last_result, sizeof (itr0));
 	    }
+	  else if (cache->kv4[ci0].key == key40->key)
+	    {
+	      clib_memcpy_fast (&itr0, &cache->kv4[ci0].value, sizeof (itr0));
+	      clib_memcpy_fast (&last_result, &itr0, sizeof (last_result));
+	      last_key4.key = key40->key;
+	    }
 	  else
 	    {
-	      int rv =
-		clib_bihash_search_inline_8_16 (&im->tun4_protect_by_key,
-						&bkey40);
+	      int rv = clib_bihash_search_inline_with_hash_8_16 (
+		&im->tun4_protect_by_key, hashes[i0], &bkey40);
 	      if (!rv)
 		{
 		  clib_memcpy_fast (&itr0, &bkey40.value, sizeof (itr0));
 		  clib_memcpy_fast (&last_result, &bkey40.value,
 				    sizeof (last_result));
 		  last_key4.key = key40->key;
+		  clib_memcpy_fast (&cache->kv4[ci0], &bkey40,
+				    sizeof (cache->kv4[ci0]));
 		}
 	      else
 		{
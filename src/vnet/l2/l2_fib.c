@@ -1063,8 +1063,16 @@ allocate_mac_evt_buf (u32 client, u32 client_index)
   return mp;
 }
 
+/* learn counts gathered by a scan, applied once all buckets were seen */
+typedef struct
+{
+  u32 learn_count;
+  u32 *bd_learn_counts;
+} l2fib_scan_counts_t;
+
 static_always_inline f64
-l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
+l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only,
+	    u32 first_bucket, u32 last_bucket, l2fib_scan_counts_t * counts)
 {
   l2fib_main_t *fm = &l2fib_main;
   l2learn_main_t *lm = &l2learn_main;
@@ -1075,20 +1083,23 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
   f64 accum_t = 0;
   f64 delta_t = 0;
   u32 evt_idx = 0;
-  u32 learn_count = 0;
   u32 client = lm->client_pid;
   u32 cl_idx = lm->client_index;
   vl_api_l2_macs_event_t *mp = 0;
   vl_api_registration_t *reg = 0;
   u32 bd_index;
-  static u32 *bd_learn_counts = 0;
 
   /* Don't scan the l2 fib if it hasn't been instantiated yet */
   if (alloc_arena (h) == 0)
     return 0.0;
 
-  vec_reset_length (bd_learn_counts);
-  vec_validate (bd_learn_counts, vec_len (l2input_main.bd_configs) - 1);
+  if (first_bucket == 0)
+    {
+      counts->learn_count = 0;
+      vec_reset_length (counts->bd_learn_counts);
+    }
+  vec_validate (counts->bd_learn_counts,
+		vec_len (l2input_main.bd_configs) - 1);
 
   if (client)
     {
@@ -1096,7 +1107,7 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
       reg = vl_api_client_index_to_registration (lm->client_index);
     }
 
-  for (i = 0; i < h->nbuckets; i++)
+  for (i = first_bucket; i < last_bucket; i++)
     {
       /* allow no more than 20us without a pause */
       delta_t = vlib_time_now (vm) - last_start;
@@ -1104,7 +1115,7 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	{
 	  vlib_process_suspend (vm, 100e-6);	/* suspend for 100 us */
 	  /* in case a new bd was created while sleeping */
-	  vec_validate (bd_learn_counts,
+	  vec_validate (counts->bd_learn_counts,
 			vec_len (l2input_main.bd_configs) - 1);
 	  last_start = vlib_time_now (vm);
 	  accum_t += delta_t;
@@ -1140,8 +1151,8 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 
 	      if (!l2fib_entry_result_is_set_AGE_NOT (&result))
 		{
-		  learn_count++;
-		  vec_elt (bd_learn_counts, key.fields.bd_index)++;
+		  counts->learn_count++;
+		  vec_elt (counts->bd_learn_counts, key.fields.bd_index)++;
 		}
 
 	      if (client)
@@ -1229,8 +1240,8 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	      BVT (clib_bihash_kv) kv;
 	      kv.key = key.raw;
 	      BV (clib_bihash_add_del) (&fm->mac_table, &kv, 0);
-	      learn_count--;
-	      vec_elt (bd_learn_counts, key.fields.bd_index)--;
+	      counts->learn_count--;
+	      vec_elt (counts->bd_learn_counts, key.fields.bd_index)--;
 	      /*
 	       * Note: we may have just freed the bucket's backing
 	       * storage, so check right here...
@@ -1245,11 +1256,14 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
     }
 
   /* keep learn count consistent */
-  l2learn_main.global_learn_count = learn_count;
-  vec_foreach_index (bd_index, l2input_main.bd_configs)
+  if (last_bucket == h->nbuckets)
     {
-      vec_elt (l2input_main.bd_configs, bd_index).learn_count =
-	vec_elt (bd_learn_counts, bd_index);
+      l2learn_main.global_learn_count = counts->learn_count;
+      vec_foreach_index (bd_index, l2input_main.bd_configs)
+	{
+	  vec_elt (l2input_main.bd_configs, bd_index).learn_count =
+	    vec_elt (counts->bd_learn_counts, bd_index);
+	}
     }
 
   if (mp)
@@ -1276,6 +1290,31 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
   return delta_t + accum_t;
 }
 
+/*
+ * Age the next slice of the mac table, or the whole table if full is set.
+ * With age-scan-slices configured the table is swept incrementally, one
+ * slice per L2FIB_AGE_SCAN_INTERVAL / slices, so a 1M MAC table is never
+ * walked in one go.
+ */
+static f64
+l2fib_age_scan (vlib_main_t * vm, f64 start_time, int full)
+{
+  l2fib_main_t *fm = &l2fib_main;
+  static l2fib_scan_counts_t counts;
+  u32 n_buckets = fm->mac_table.nbuckets;
+  u32 first = 0, last = n_buckets;
+
+  if (!full && fm->age_scan_slices > 1)
+    {
+      first = fm->age_scan_bucket;
+      last = first + clib_max (n_buckets / fm->age_scan_slices, 1);
+      last = clib_min (last, n_buckets);
+    }
+
+  fm->age_scan_bucket = last < n_buckets ? last : 0;
+  return l2fib_scan (vm, start_time, 0, first, last, &counts);
+}
+
 static uword
 l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 			       vlib_frame_t * f)
@@ -1285,6 +1324,7 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
   l2learn_main_t *lm = &l2learn_main;
   bool enabled = 0;
   f64 start_time, next_age_scan_time = CLIB_TIME_MAX;
+  static l2fib_scan_counts_t evt_counts;
 
   while (1)
     {
@@ -1329,11 +1369,14 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	}
 
       if (scan == SCAN_MAC_EVENT)
-	l2fib_main.evt_scan_duration = l2fib_scan (vm, start_time, 1);
+	l2fib_main.evt_scan_duration =
+	  l2fib_scan (vm, start_time, 1, 0, fm->mac_table.nbuckets,
+		      &evt_counts);
       else
 	{
 	  if (scan == SCAN_MAC_AGE)
-	    l2fib_main.age_scan_duration = l2fib_scan (vm, start_time, 0);
+	    l2fib_main.age_scan_duration = l2fib_age_scan (
+	      vm, start_time, event_type == L2_MAC_AGE_PROCESS_EVENT_ONE_PASS);
 	  if (scan == SCAN_DISABLE)
 	    {
 	      l2fib_main.age_scan_duration = 0;
@@ -1341,7 +1384,9 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	    }
 	  /* schedule next scan */
 	  if (enabled)
-	    next_age_scan_time = start_time + L2FIB_AGE_SCAN_INTERVAL;
+	    next_age_scan_time =
+	      start_time +
+	      L2FIB_AGE_SCAN_INTERVAL / clib_max (fm->age_scan_slices, 1);
 	  else
 	    next_age_scan_time = CLIB_TIME_MAX;
 	}
@@ -1397,6 +1442,8 @@ lfib_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "num-buckets %u", &n_buckets))
 	;
+      else if (unformat (input, "age-scan-slices %u", &lm->age_scan_slices))
+	;
       else
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
@@ -64,6 +64,12 @@ typedef struct
   /* max macs in event message, default to 100 entries */
   u32 max_macs_in_event;
 
+  /* ager scan is spread over this many slices of the table per interval */
+  u32 age_scan_slices;
+
+  /* first bucket of the next ager scan slice */
+  u32 age_scan_bucket;
+
   /* convenience variables */
   vlib_main_t *vlib_main;
   vnet_main_t *vnet_main;
@@ -247,10 +247,6 @@ VLIB_NODE_FN (l2flood_node) (vlib_main_t * vm,
 		  ci0 = msm->clones[thread_index][clone0];
 		  c0 = vlib_get_buffer (vm, ci0);
 
-		  to_next[0] = ci0;
-		  to_next += 1;
-		  n_left_to_next -= 1;
-
 		  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
 				     (b0->flags & VLIB_BUFFER_IS_TRACED)))
 		    {
@@ -268,10 +264,27 @@ VLIB_NODE_FN (l2flood_node) (vlib_main_t * vm,
 		  /* Do normal L2 forwarding */
 		  vnet_buffer (c0)->sw_if_index[VLIB_TX] =
 		    member->sw_if_index;
+		}
+
+	      /* and hand them all to l2-output in as few frames as possible */
+	      if (PREDICT_FALSE (next_index != L2FLOOD_NEXT_L2_OUTPUT))
+		{
+		  vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+		  next_index = L2FLOOD_NEXT_L2_OUTPUT;
+		  vlib_get_next_frame (vm, node, next_index, to_next,
+				       n_left_to_next);
+		}
+
+	      for (clone0 = 0; clone0 < n_cloned - 1;)
+		{
+		  u32 n_copy = clib_min (n_cloned - 1 - clone0, n_left_to_next);
+
+		  vlib_buffer_copy_indices (
+		    to_next, msm->clones[thread_index] + clone0, n_copy);
+		  to_next += n_copy;
+		  n_left_to_next -= n_copy;
+		  clone0 += n_copy;
 
-		  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-						   to_next, n_left_to_next,
-						   ci0, next0);
 		  if (PREDICT_FALSE (0 == n_left_to_next))
 		    {
 		      vlib_put_next_frame (vm, node, next_index,
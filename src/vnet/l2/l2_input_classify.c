@@ -159,6 +159,10 @@ VLIB_NODE_FN (l2_input_classify_node) (vlib_main_t * vm,
   u32 chain_hits = 0;
   f64 now;
   u32 n_next_nodes;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  u32 table_indices[VLIB_FRAME_SIZE], hashes[VLIB_FRAME_SIZE];
+  u8 *h[VLIB_FRAME_SIZE];
+  u32 i;
 
   n_next_nodes = node->n_next_nodes;
 
@@ -169,109 +173,27 @@ VLIB_NODE_FN (l2_input_classify_node) (vlib_main_t * vm,
 
   /* First pass: compute hash */
 
-  while (n_left_from >= 4)
-    {
-      vlib_buffer_t *b0, *b1;
-      u32 bi0, bi1;
-      ethernet_header_t *h0, *h1;
-      u32 sw_if_index0, sw_if_index1;
-      u16 type0, type1;
-      int type_index0, type_index1;
-      vnet_classify_table_t *t0, *t1;
-      u32 table_index0, table_index1;
-      u32 hash0, hash1;
-
-      /* prefetch next iteration */
-      {
-	vlib_buffer_t *p2, *p3;
-
-	p2 = vlib_get_buffer (vm, from[2]);
-	p3 = vlib_get_buffer (vm, from[3]);
-
-	vlib_prefetch_buffer_header (p2, STORE);
-	clib_prefetch_store (p2->data);
-	vlib_prefetch_buffer_header (p3, STORE);
-	clib_prefetch_store (p3->data);
-      }
-
-      bi0 = from[0];
-      b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0);
-
-      bi1 = from[1];
-      b1 = vlib_get_buffer (vm, bi1);
-      h1 = vlib_buffer_get_current (b1);
-
-      sw_if_index0 = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-      vnet_buffer (b0)->l2_classify.table_index = ~0;
-
-      sw_if_index1 = vnet_buffer (b1)->sw_if_index[VLIB_RX];
-      vnet_buffer (b1)->l2_classify.table_index = ~0;
-
-      /* Select classifier table based on ethertype */
-      type0 = clib_net_to_host_u16 (h0->type);
-      type1 = clib_net_to_host_u16 (h1->type);
-
-      type_index0 = (type0 == ETHERNET_TYPE_IP4)
-	? L2_INPUT_CLASSIFY_TABLE_IP4 : L2_INPUT_CLASSIFY_TABLE_OTHER;
-      type_index0 = (type0 == ETHERNET_TYPE_IP6)
-	? L2_INPUT_CLASSIFY_TABLE_IP6 : type_index0;
-
-      type_index1 = (type1 == ETHERNET_TYPE_IP4)
-	? L2_INPUT_CLASSIFY_TABLE_IP4 : L2_INPUT_CLASSIFY_TABLE_OTHER;
-      type_index1 = (type1 == ETHERNET_TYPE_IP6)
-	? L2_INPUT_CLASSIFY_TABLE_IP6 : type_index1;
-
-      vnet_buffer (b0)->l2_classify.table_index =
-	table_index0 =
-	rt->l2cm->classify_table_index_by_sw_if_index
-	[type_index0][sw_if_index0];
+  vlib_get_buffers (vm, from, bufs, n_left_from);
 
-      if (table_index0 != ~0)
-	{
-	  t0 = pool_elt_at_index (vcm->tables, table_index0);
-
-	  vnet_buffer (b0)->l2_classify.hash = hash0 =
-	    vnet_classify_hash_packet (t0, (u8 *) h0);
-	  vnet_classify_prefetch_bucket (t0, hash0);
-	}
-
-      vnet_buffer (b1)->l2_classify.table_index =
-	table_index1 =
-	rt->l2cm->classify_table_index_by_sw_if_index
-	[type_index1][sw_if_index1];
-
-      if (table_index1 != ~0)
-	{
-	  t1 = pool_elt_at_index (vcm->tables, table_index1);
-
-	  vnet_buffer (b1)->l2_classify.hash = hash1 =
-	    vnet_classify_hash_packet (t1, (u8 *) h1);
-	  vnet_classify_prefetch_bucket (t1, hash1);
-	}
-
-      from += 2;
-      n_left_from -= 2;
-    }
-
-  while (n_left_from > 0)
+  for (i = 0; i < n_left_from; i++)
     {
-      vlib_buffer_t *b0;
-      u32 bi0;
+      vlib_buffer_t *b0 = bufs[i];
       ethernet_header_t *h0;
       u32 sw_if_index0;
       u16 type0;
       u32 type_index0;
-      vnet_classify_table_t *t0;
-      u32 table_index0;
-      u32 hash0;
 
-      bi0 = from[0];
-      b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0);
+      /* prefetch next iteration */
+      if (i + 2 < n_left_from)
+	{
+	  vlib_prefetch_buffer_header (bufs[i + 2], STORE);
+	  clib_prefetch_store (bufs[i + 2]->data);
+	}
+
+      h[i] = vlib_buffer_get_current (b0);
+      h0 = (ethernet_header_t *) h[i];
 
       sw_if_index0 = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-      vnet_buffer (b0)->l2_classify.table_index = ~0;
 
       /* Select classifier table based on ethertype */
       type0 = clib_net_to_host_u16 (h0->type);
@@ -281,21 +203,17 @@ VLIB_NODE_FN (l2_input_classify_node) (vlib_main_t * vm,
       type_index0 = (type0 == ETHERNET_TYPE_IP6)
 	? L2_INPUT_CLASSIFY_TABLE_IP6 : type_index0;
 
-      vnet_buffer (b0)->l2_classify.table_index =
-	table_index0 = rt->l2cm->classify_table_index_by_sw_if_index
-	[type_index0][sw_if_index0];
+      vnet_buffer (b0)->l2_classify.table_index = table_indices[i] =
+	rt->l2cm->classify_table_index_by_sw_if_index[type_index0]
+						      [sw_if_index0];
+    }
 
-      if (table_index0 != ~0)
-	{
-	  t0 = pool_elt_at_index (vcm->tables, table_index0);
+  vnet_classify_hash_packets_inline (vcm, table_indices, h, hashes,
+				     n_left_from);
 
-	  vnet_buffer (b0)->l2_classify.hash = hash0 =
-	    vnet_classify_hash_packet (t0, (u8 *) h0);
-	  vnet_classify_prefetch_bucket (t0, hash0);
-	}
-      from++;
-      n_left_from--;
-    }
+  for (i = 0; i < n_left_from; i++)
+    if (table_indices[i] != ~0)
+      vnet_buffer (bufs[i])->l2_classify.hash = hashes[i];
 
   next_index = node->cached_next_index;
   from = vlib_frame_vector_args (frame);
@@ -82,7 +82,8 @@ _(MAC_MOVE,          "L2 mac moves")			\
 _(MAC_MOVE_VIOLATE,  "L2 mac move violations")		\
 _(LIMIT,             "L2 not learned due to limit")	\
 _(HIT_UPDATE,        "L2 learn hit updates")		\
-_(FILTER_DROP,       "L2 filter mac drops")
+_(FILTER_DROP,       "L2 filter mac drops")		\
+_(QUEUE_FULL,        "L2 not learned due to full learn queue")
 
 typedef enum
 {
@@ -106,11 +107,37 @@ typedef enum
 } l2learn_next_t;
 
 
-/** Perform learning on one packet based on the mac table lookup result. */
+/** Hand a learned MAC over to the main thread learner. */
+
+static_always_inline void
+l2learn_enqueue (l2learn_main_t * msm, l2learn_queue_t * q,
+		 BVT (clib_bihash_kv) * kv, u64 * counter_base)
+{
+  u32 head = q->head;
+
+  /* same MAC learned from back to back packets of a flow */
+  if (kv->key == q->last.key && kv->value == q->last.value)
+    return;
+
+  if (head - clib_atomic_load_acq_n (&q->tail) >= msm->learn_queue_size)
+    {
+      counter_base[L2LEARN_ERROR_QUEUE_FULL] += 1;
+      return;
+    }
+
+  q->kvs[head & (msm->learn_queue_size - 1)] = *kv;
+  q->last = *kv;
+  clib_atomic_store_rel_n (&q->head, head + 1);
+}
+
+/** Perform learning on one packet based on the mac table lookup result.
+ *  With a learn queue the mac table is updated, and the learn counts
+ *  maintained, by the learner instead. */
 
 static_always_inline void
 l2learn_process (vlib_node_runtime_t * node,
 		 l2learn_main_t * msm,
+		 l2learn_queue_t * q,
 		 u64 * counter_base,
 		 vlib_buffer_t * b0,
 		 u32 sw_if_index0,
@@ -177,8 +204,11 @@ l2learn_process (vlib_node_runtime_t * node,
       /* learn_count variable may have little inaccuracy because they are not
        * incremented/decremented with atomic operations */
       /* l2fib_scan is call every 2sec fixing potential inaccuracy */
-      msm->global_learn_count++;
-      bd_config->learn_count++;
+      if (!q)
+	{
+	  msm->global_learn_count++;
+	  bd_config->learn_count++;
+	}
       result0->raw = 0;		/* clear all fields */
       result0->fields.sw_if_index = sw_if_index0;
       if (msm->client_pid != 0)
@@ -220,8 +250,11 @@ l2learn_process (vlib_node_runtime_t * node,
 	  /* learn_count variable may have little inaccuracy because they are
 	   * not incremented/decremented with atomic operations */
 	  /* l2fib_scan is call every 2sec fixing potential inaccuracy */
-	  msm->global_learn_count++;
-	  bd_config->learn_count++;
+	  if (!q)
+	    {
+	      msm->global_learn_count++;
+	      bd_config->learn_count++;
+	    }
 
 	  l2fib_entry_result_clear_AGE_NOT (result0);
 	}
@@ -243,7 +276,10 @@ l2learn_process (vlib_node_runtime_t * node,
   BVT (clib_bihash_kv) kv;
   kv.key = key0->raw;
   kv.value = result0->raw;
-  BV (clib_bihash_add_del) (msm->mac_table, &kv, 1 /* is_add */ );
+  if (q)
+    l2learn_enqueue (msm, q, &kv, counter_base);
+  else
+    BV (clib_bihash_add_del) (msm->mac_table, &kv, 1 /* is_add */ );
 
   /* Invalidate the cache */
   cached_key->raw = ~0;
@@ -265,6 +301,15 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 count = 0;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
   u16 nexts[VLIB_FRAME_SIZE], *next;
+  l2learn_queue_t *q = 0;
+  u32 head = 0;
+
+  /* workers hand learned MACs to the main thread if queues are enabled */
+  if (msm->queues && vm->thread_index)
+    {
+      q = vec_elt_at_index (msm->queues, vm->thread_index);
+      head = q->head;
+    }
 
   from = vlib_frame_vector_args (frame);
   n_left = frame->n_vectors;	/* number of packets to process */
@@ -367,19 +412,19 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      &key0, &key1, &key2, &key3,
 		      &result0, &result1, &result2, &result3);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, q, &em->counters[node_counter_base_index],
 		       b[0], sw_if_index0, &key0, &cached_key,
 		       &count, &result0, next, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, q, &em->counters[node_counter_base_index],
 		       b[1], sw_if_index1, &key1, &cached_key,
 		       &count, &result1, next + 1, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, q, &em->counters[node_counter_base_index],
 		       b[2], sw_if_index2, &key2, &cached_key,
 		       &count, &result2, next + 2, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, q, &em->counters[node_counter_base_index],
 		       b[3], sw_if_index3, &key3, &cached_key,
 		       &count, &result3, next + 3, timestamp);
 
@@ -417,7 +462,7 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      h0->src_address, vnet_buffer (b[0])->l2.bd_index,
 		      &key0, &result0);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, q, &em->counters[node_counter_base_index],
 		       b[0], sw_if_index0, &key0, &cached_key,
 		       &count, &result0, next, timestamp);
 
@@ -426,6 +471,10 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       n_left -= 1;
     }
 
+  if (q && q->head != head)
+    vlib_node_set_interrupt_pending (vlib_get_main_by_index (0),
+				     msm->learn_queue_node_index);
+
   vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
 
   return frame->n_vectors;
@@ -492,6 +541,115 @@ l2learn_init (vlib_main_t * vm)
 
 VLIB_INIT_FUNCTION (l2learn_init);
 
+/** Add one MAC taken off a learn queue, keeping the learn counts. */
+static void
+l2learn_queue_learn (l2learn_main_t * msm, BVT (clib_bihash_kv) * kv)
+{
+  l2fib_entry_key_t key = {.raw = kv->key };
+  l2fib_entry_result_t result;
+  l2_bridge_domain_t *bd_config;
+  BVT (clib_bihash_kv) old;
+  int is_counted = 0;
+
+  /* bridge domain may be gone by now */
+  if (key.fields.bd_index >= vec_len (l2input_main.bd_configs))
+    return;
+  bd_config = vec_elt_at_index (l2input_main.bd_configs, key.fields.bd_index);
+
+  old.key = kv->key;
+  if (BV (clib_bihash_search) (msm->mac_table, &old, &old) == 0)
+    {
+      result.raw = old.value;
+      /* static MAC or filter added since the worker looked it up */
+      if (l2fib_entry_result_is_set_STATIC (&result) ||
+	  l2fib_entry_result_is_set_FILTER (&result))
+	return;
+      is_counted = !l2fib_entry_result_is_set_AGE_NOT (&result);
+    }
+
+  if (!is_counted)
+    {
+      if ((msm->global_learn_count >= msm->global_learn_limit) ||
+	  (bd_config->learn_count >= bd_config->learn_limit))
+	return;
+      msm->global_learn_count++;
+      bd_config->learn_count++;
+    }
+
+  BV (clib_bihash_add_del) (msm->mac_table, kv, 1 /* is_add */ );
+}
+
+/*
+ * Learner, main thread input node in interrupt mode. Workers signal it
+ * after queueing MACs, it is the only writer of the learned entries so
+ * learning storms on many workers no longer contend on the bihash
+ * writer lock.
+ */
+static uword
+l2learn_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
+		       vlib_frame_t * frame)
+{
+  l2learn_main_t *msm = &l2learn_main;
+  u32 mask = msm->learn_queue_size - 1;
+  l2learn_queue_t *q;
+  u32 head, tail, n_left;
+  int more = 0;
+
+  vec_foreach (q, msm->queues)
+    {
+      head = clib_atomic_load_acq_n (&q->head);
+      tail = q->tail;
+      n_left = clib_min (head - tail, L2LEARN_QUEUE_DRAIN_BATCH);
+      more |= head - tail > n_left;
+
+      for (; n_left; n_left--, tail++)
+	{
+	  if (n_left > 4)
+	    clib_prefetch_load (&q->kvs[(tail + 4) & mask]);
+	  l2learn_queue_learn (msm, &q->kvs[tail & mask]);
+	}
+
+      clib_atomic_store_rel_n (&q->tail, tail);
+    }
+
+  /* give other nodes a chance before taking the next batch */
+  if (more)
+    vlib_node_set_interrupt_pending (vm, node->node_index);
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (l2learn_queue_node, static) = {
+  .function = l2learn_queue_node_fn,
+  .name = "l2-learn-queue",
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+};
+
+static clib_error_t *
+l2learn_main_loop_enter (vlib_main_t * vm)
+{
+  l2learn_main_t *mp = &l2learn_main;
+  l2learn_queue_t *q;
+
+  mp->learn_queue_node_index = l2learn_queue_node.index;
+
+  if (mp->learn_queue_size == 0 || vlib_get_n_threads () < 2)
+    return 0;
+
+  vec_validate_aligned (mp->queues, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
+  vec_foreach (q, mp->queues)
+    {
+      vec_validate_aligned (q->kvs, mp->learn_queue_size - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      q->last.key = ~0ULL;
+    }
+  return 0;
+}
+
+VLIB_MAIN_LOOP_ENTER_FUNCTION (l2learn_main_loop_enter);
+
 
 /**
  * Set subinterface learn enable/disable.
@@ -555,6 +713,12 @@ l2learn_config (vlib_main_t * vm, unformat_input_t * input)
       if (unformat (input, "limit %d", &mp->global_learn_limit))
 	;
 
+      else if (unformat (input, "queue-size %u", &mp->learn_queue_size))
+	{
+	  if (!is_pow2 (mp->learn_queue_size))
+	    return clib_error_return (0, "queue-size must be power of 2");
+	}
+
       else
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
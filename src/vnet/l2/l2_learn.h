@@ -23,12 +23,31 @@
 #include <vnet/ethernet/ethernet.h>
 
 
+/* Single producer / single consumer ring of MACs learned by a worker */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /* producer (worker) side */
+  u32 head;
+  BVT (clib_bihash_kv) last;
+  BVT (clib_bihash_kv) * kvs;
+
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  /* consumer (learner) side */
+  u32 tail;
+} l2learn_queue_t;
+
 typedef struct
 {
 
   /* Hash table */
   BVT (clib_bihash) * mac_table;
 
+  /* per-worker learn queues, drained on the main thread, 0 if disabled */
+  l2learn_queue_t *queues;
+  u32 learn_queue_size;
+  u32 learn_queue_node_index;
+
   /* number of dynamically learned mac entries */
   u32 global_learn_count;
 
@@ -52,6 +71,9 @@ typedef struct
 
 #define L2LEARN_DEFAULT_LIMIT (L2FIB_NUM_BUCKETS * 64)
 
+/* Max MACs taken off one learn queue per learner node dispatch */
+#define L2LEARN_QUEUE_DRAIN_BATCH 256
+
 extern l2learn_main_t l2learn_main;
 
 extern vlib_node_registration_t l2fib_mac_age_scanner_process_node;
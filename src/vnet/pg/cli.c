@@ -198,6 +198,8 @@ format_pg_stream (u8 * s, va_list * va)
 	      t->packet_size_edit_type == PG_EDIT_RANDOM ? '+' : '-',
 	      t->max_packet_bytes);
   s = format (s, "buffer-size %d, ", t->buffer_bytes);
+  if (t->flags & PG_STREAM_FLAGS_REPLAY_ZERO_COPY)
+    s = format (s, "zero-copy, ");
   s = format (s, "worker %d, ", t->worker_index);
 
   if (verbose)
@@ -296,6 +298,9 @@ unformat_pg_stream_parameter (unformat_input_t * input, va_list * args)
   else if (unformat (input, "buffer-size %d", &s->buffer_bytes))
     ;
 
+  else if (unformat (input, "zero-copy"))
+    s->flags |= PG_STREAM_FLAGS_REPLAY_ZERO_COPY;
+
   else
     return 0;
 
@@ -317,6 +322,24 @@ validate_stream (pg_stream_t * s)
   if (s->rate_packets_per_second < 0)
     return clib_error_create ("negative rate");
 
+  if (s->flags & PG_STREAM_FLAGS_REPLAY_ZERO_COPY)
+    {
+      vnet_main_t *vnm = vnet_get_main ();
+      vnet_hw_interface_t *hi;
+
+      if (!s->replay_packet_templates)
+	return clib_error_create ("zero-copy requires pcap replay");
+      if (s->max_packet_bytes > vlib_buffer_get_default_data_size (
+				  vlib_get_main ()))
+	return clib_error_create ("zero-copy requires single buffer packets");
+      /* shared buffers must go straight to the device untouched */
+      if (s->sw_if_index[VLIB_TX] == ~0)
+	return clib_error_create ("zero-copy requires node <interface>");
+      hi = vnet_get_sup_hw_interface (vnm, s->sw_if_index[VLIB_TX]);
+      if (s->node_index != hi->output_node_index)
+	return clib_error_create ("zero-copy requires node <interface>");
+    }
+
   return 0;
 }
 
@@ -507,7 +530,9 @@ VLIB_CLI_COMMAND (new_stream_cli, static) = {
   "data STRING          specifies packet data\n"
   "pcap FILENAME        read packet data from pcap file\n"
   "rate PPS             rate to transfer packet data\n"
-  "maxframe NPKTS       maximum number of packets per frame\n",
+  "maxframe NPKTS       maximum number of packets per frame\n"
+  "zero-copy            replay pcap from prebuilt buffers by reference,\n"
+  "                     requires node <interface>\n",
 };
 
 static clib_error_t *
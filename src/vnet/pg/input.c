@@ -1194,6 +1194,91 @@ pg_stream_fill_helper (pg_main_t * pg,
   return n_alloc;
 }
 
+static int
+pg_stream_build_zero_copy_ring (vlib_main_t *vm, pg_stream_t *s)
+{
+  u32 n_templates = vec_len (s->replay_packet_templates);
+  u32 n_copies, n_bufs, n, i;
+  u32 *buffers = 0;
+
+  n_copies = (PG_REPLAY_ZERO_COPY_RING_SIZE + n_templates - 1) / n_templates;
+  n_bufs = n_copies * n_templates;
+
+  vec_validate_aligned (buffers, n_bufs - 1, CLIB_CACHE_LINE_BYTES);
+  n = vlib_buffer_alloc (vm, buffers, n_bufs);
+  if (n < n_bufs)
+    {
+      clib_warning ("alloc failure, got %d not %d", n, n_bufs);
+      vlib_buffer_free (vm, buffers, n);
+      vec_free (buffers);
+      return -1;
+    }
+
+  for (i = 0; i < n_bufs; i++)
+    {
+      u8 *d0 = vec_elt (s->replay_packet_templates, i % n_templates);
+      vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+
+      clib_memcpy_fast (b->data, d0, vec_len (d0));
+      b->current_data = 0;
+      b->current_length = vec_len (d0);
+    }
+
+  s->replay_zero_copy_buffers = buffers;
+  return 0;
+}
+
+/*
+ * Zero-copy replay: every ring entry is referenced once more per packet
+ * sent and released by whoever frees the buffer after tx. Only metadata is
+ * rewritten, so this requires that nothing between pg and the device
+ * modifies packet data, see the zero-copy check in the cli.
+ */
+static u32
+pg_stream_fill_replay_zero_copy (pg_main_t *pg, pg_stream_t *s, u32 n_alloc)
+{
+  vlib_main_t *vm = vlib_get_main ();
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_interface_main_t *im = &vnm->interface_main;
+  pg_buffer_index_t *bi = s->buffer_indices;
+  u32 i, n_ring, n_bytes = 0, n = 0, *buffers;
+
+  if (PREDICT_FALSE (!s->replay_zero_copy_buffers) &&
+      pg_stream_build_zero_copy_ring (vm, s))
+    return 0;
+
+  buffers = s->replay_zero_copy_buffers;
+  n_ring = vec_len (buffers);
+  i = s->current_replay_packet_index % n_ring;
+
+  while (n < n_alloc)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+
+      /* still referenced by the previous lap, tx is behind */
+      if (PREDICT_FALSE (b->ref_count == 255))
+	break;
+
+      clib_atomic_add_fetch (&b->ref_count, 1);
+      vnet_buffer (b)->sw_if_index[VLIB_RX] = s->sw_if_index[VLIB_RX];
+      vnet_buffer (b)->sw_if_index[VLIB_TX] = s->sw_if_index[VLIB_TX];
+      b->flags = s->buffer_flags;
+      b->current_data = 0;
+      n_bytes += b->current_length;
+
+      clib_fifo_add1 (bi->buffer_fifo, buffers[i]);
+      i = ((i + 1) == n_ring) ? 0 : i + 1;
+      n++;
+    }
+
+  vlib_increment_combined_counter (
+    im->combined_sw_if_counters + VNET_INTERFACE_COUNTER_RX,
+    vlib_get_thread_index (), s->sw_if_index[VLIB_RX], n, n_bytes);
+
+  s->current_replay_packet_index = i;
+  return n;
+}
+
 static u32
 pg_stream_fill_replay (pg_main_t * pg, pg_stream_t * s, u32 n_alloc)
 {
@@ -1342,7 +1427,11 @@ pg_stream_fill (pg_main_t * pg, pg_stream_t * s, u32 n_buffers)
    * Handle pcap replay directly
    */
   if (s->replay_packet_templates)
-    return pg_stream_fill_replay (pg, s, n_alloc);
+    {
+      if (s->flags & PG_STREAM_FLAGS_REPLAY_ZERO_COPY)
+	return n_in_fifo + pg_stream_fill_replay_zero_copy (pg, s, n_alloc);
+      return pg_stream_fill_replay (pg, s, n_alloc);
+    }
 
   /* All buffer fifos should have the same size. */
   if (CLIB_DEBUG > 0)
@@ -1789,7 +1878,7 @@ static uword
 pg_input_stream (vlib_node_runtime_t * node, pg_main_t * pg, pg_stream_t * s)
 {
   vlib_main_t *vm = vlib_get_main ();
-  uword n_packets;
+  uword n_packets, n_wanted;
   f64 time_now, dt;
 
   if (s->n_packets_limit > 0 && s->n_packets_generated >= s->n_packets_limit)
@@ -1825,9 +1914,17 @@ pg_input_stream (vlib_node_runtime_t * node, pg_main_t * pg, pg_stream_t * s)
   if (n_packets > s->n_max_frame)
     n_packets = s->n_max_frame;
 
+  n_wanted = n_packets;
   if (n_packets > 0)
     n_packets = pg_generate_packets (node, pg, s, n_packets);
 
+  /* Carry over what we owe but could not generate this time, e.g. on
+     buffer shortage, bounded to one frame so a stall doesn't turn into
+     a burst. Keeps the average rate exact at high rates. */
+  if (s->rate_packets_per_second > 0 && n_packets < n_wanted)
+    s->packet_accumulator =
+      clib_min (s->packet_accumulator + n_wanted - n_packets, s->n_max_frame);
+
   s->n_packets_generated += n_packets;
 
   return n_packets;
@@ -102,6 +102,8 @@ typedef struct pg_stream_t
 
   /* Stream is currently enabled. */
 #define PG_STREAM_FLAGS_IS_ENABLED (1 << 0)
+  /* Replay prebuilt pcap buffers by reference instead of copying. */
+#define PG_STREAM_FLAGS_REPLAY_ZERO_COPY (1 << 1)
 
   /* Edit groups are created by each protocol level (e.g. ethernet,
      ip4, tcp, ...). */
@@ -179,8 +181,16 @@ typedef struct pg_stream_t
   u8 **replay_packet_templates;
   u64 *replay_packet_timestamps;
   u32 current_replay_packet_index;
+
+  /* Ring of prebuilt replay buffers, each a multiple of the templates,
+     handed out with their reference count bumped. Zero-copy replay only. */
+  u32 *replay_zero_copy_buffers;
 } pg_stream_t;
 
+/* Minimum number of prebuilt buffers for zero-copy replay, so a buffer is
+   not referenced again while still queued for tx. */
+#define PG_REPLAY_ZERO_COPY_RING_SIZE 4096
+
 always_inline void
 pg_free_buffers (pg_buffer_index_t *bi)
 {
@@ -244,6 +254,13 @@ pg_stream_free (pg_stream_t * s)
   vec_free (s->replay_packet_templates);
   vec_free (s->replay_packet_timestamps);
 
+  if (s->replay_zero_copy_buffers)
+    {
+      vlib_buffer_free (vlib_get_main (), s->replay_zero_copy_buffers,
+			vec_len (s->replay_zero_copy_buffers));
+      vec_free (s->replay_zero_copy_buffers);
+    }
+
   if (s->buffer_indices)
     {
       pg_buffer_index_t *bi;
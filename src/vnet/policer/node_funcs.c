@@ -66,6 +66,28 @@ static char *vnet_policer_error_strings[] = {
 #undef _
 };
 
+static_always_inline u8
+vnet_policer_police_intf (vlib_main_t *vm, vlib_buffer_t *b, u32 pi,
+			  u32 sw_if_index, u64 time_in_policer_periods,
+			  vlib_dir_t dir)
+{
+  vnet_policer_main_t *pm = &vnet_policer_main;
+
+  if (dir == VLIB_TX)
+    {
+      u32 *tcs, tc;
+
+      tc = vnet_policer_traffic_class (b);
+      tcs = pm->tc_policer_index_by_sw_if_index[tc];
+      if (sw_if_index < vec_len (tcs) && tcs[sw_if_index] != ~0)
+	return vnet_policer_police_hier (vm, b, pi, tcs[sw_if_index],
+					 time_in_policer_periods);
+    }
+
+  return vnet_policer_police (vm, b, pi, time_in_policer_periods,
+			      POLICE_CONFORM /* no chaining */, true);
+}
+
 static inline uword
 vnet_policer_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 		     vlib_frame_t *frame, vlib_dir_t dir)
@@ -126,11 +148,11 @@ vnet_policer_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  pi0 = pm->policer_index_by_sw_if_index[dir][sw_if_index0];
 	  pi1 = pm->policer_index_by_sw_if_index[dir][sw_if_index1];
 
-	  act0 = vnet_policer_police (vm, b0, pi0, time_in_policer_periods,
-				      POLICE_CONFORM /* no chaining */, true);
+	  act0 = vnet_policer_police_intf (vm, b0, pi0, sw_if_index0,
+					   time_in_policer_periods, dir);
 
-	  act1 = vnet_policer_police (vm, b1, pi1, time_in_policer_periods,
-				      POLICE_CONFORM /* no chaining */, true);
+	  act1 = vnet_policer_police_intf (vm, b1, pi1, sw_if_index1,
+					   time_in_policer_periods, dir);
 
 	  if (PREDICT_FALSE (act0 == QOS_ACTION_HANDOFF))
 	    {
@@ -209,8 +231,8 @@ vnet_policer_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  sw_if_index0 = vnet_buffer (b0)->sw_if_index[dir];
 	  pi0 = pm->policer_index_by_sw_if_index[dir][sw_if_index0];
 
-	  act0 = vnet_policer_police (vm, b0, pi0, time_in_policer_periods,
-				      POLICE_CONFORM /* no chaining */, true);
+	  act0 = vnet_policer_police_intf (vm, b0, pi0, sw_if_index0,
+					   time_in_policer_periods, dir);
 
 	  if (PREDICT_FALSE (act0 == QOS_ACTION_HANDOFF))
 	    {
@@ -596,6 +618,11 @@ policer_classify_inline (vlib_main_t * vm,
 		}
 	      else
 		{
+		  u32 chain_hash[VNET_CLASSIFY_CHAIN_MAX_TABLES], n_chain, i = 0;
+
+		  n_chain = vnet_classify_chain_prefetch (vcm, table_index0, h0,
+							  0, chain_hash);
+
 		  while (1)
 		    {
 		      if (PREDICT_TRUE (t0->next_table_index != ~0))
@@ -611,7 +638,9 @@ policer_classify_inline (vlib_main_t * vm,
 			  break;
 			}
 
-		      hash0 = vnet_classify_hash_packet (t0, (u8 *) h0);
+		      hash0 = i < n_chain ?
+				chain_hash[i++] :
+				vnet_classify_hash_packet (t0, (u8 *) h0);
 		      e0 =
 			vnet_classify_find_entry (t0, (u8 *) h0, hash0, now);
 		      if (e0)
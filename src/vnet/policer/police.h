@@ -99,6 +99,22 @@ typedef struct
 
 STATIC_ASSERT_SIZEOF (policer_t, CLIB_CACHE_LINE_BYTES);
 
+// A distributed policer is shared by all threads without handoff. Each
+// thread polices against a local share of the tokens, and every
+// POLICER_SHARE_REBALANCE_PERIODS (or when its share runs dry) gives the
+// rest back and takes a new share from the global buckets with atomic
+// operations. The accuracy error is bounded by the tokens held in shares.
+
+#define POLICER_THREAD_INDEX_DISTRIBUTED ((clib_thread_index_t) ~1)
+#define POLICER_SHARE_REBALANCE_PERIODS	 4
+
+typedef struct
+{
+  // copy of the policer without refill, its buckets hold the local share
+  policer_t policer;
+  u64 last_rebalance_time;
+} policer_share_t;
+
 static inline policer_result_e
 vnet_police_packet (policer_t *policer, u32 packet_length,
 		    policer_result_e packet_color, u64 time)
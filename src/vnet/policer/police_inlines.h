@@ -16,8 +16,10 @@
 #define __POLICE_INLINES_H__
 
 #include <vnet/policer/police.h>
+#include <vnet/policer/policer.h>
 #include <vnet/vnet.h>
 #include <vnet/ip/ip.h>
+#include <vnet/qos/qos_types.h>
 
 #define IP4_NON_DSCP_BITS 0x03
 #define IP4_DSCP_SHIFT    2
@@ -71,6 +73,23 @@ vnet_policer_police (vlib_main_t *vm, vlib_buffer_t *b, u32 policer_index,
 				  vm->thread_index, policer_index);
 
   pol = &pm->policers[policer_index];
+  len = vlib_buffer_length_in_chain (vm, b);
+
+  if (PREDICT_FALSE (pol->thread_index == POLICER_THREAD_INDEX_DISTRIBUTED))
+    {
+      policer_share_t *share = vec_elt_at_index (
+	pm->shares_by_thread[vm->thread_index], policer_index);
+
+      if (time_in_policer_periods - share->last_rebalance_time >=
+	    POLICER_SHARE_REBALANCE_PERIODS ||
+	  (share->policer.current_bucket < (len << pol->scale) &&
+	   share->last_rebalance_time != time_in_policer_periods))
+	policer_share_rebalance (pol, share, time_in_policer_periods);
+
+      col = vnet_police_packet (&share->policer, len, packet_color,
+				time_in_policer_periods);
+      goto done;
+    }
 
   if (handoff)
     {
@@ -88,8 +107,9 @@ vnet_policer_police (vlib_main_t *vm, vlib_buffer_t *b, u32 policer_index,
 	return QOS_ACTION_HANDOFF;
     }
 
-  len = vlib_buffer_length_in_chain (vm, b);
   col = vnet_police_packet (pol, len, packet_color, time_in_policer_periods);
+
+done:
   act = pol->action[col];
   vlib_increment_combined_counter (&policer_counters[col], vm->thread_index,
 				   policer_index, 1, len);
@@ -99,6 +119,72 @@ vnet_policer_police (vlib_main_t *vm, vlib_buffer_t *b, u32 policer_index,
   return act;
 }
 
+/*
+ * Traffic class of a packet for hierarchical output policing. Derived
+ * from the QoS data recorded on ingress: IP precedence for IP sources,
+ * the 3 bit PCP/EXP otherwise. Unmarked packets use class 0.
+ */
+static_always_inline u8
+vnet_policer_traffic_class (vlib_buffer_t *b)
+{
+  if (!(b->flags & VNET_BUFFER_F_QOS_DATA_VALID))
+    return 0;
+  if (vnet_buffer2 (b)->qos.source == QOS_SOURCE_IP)
+    return vnet_buffer2 (b)->qos.bits >> 5;
+  return vnet_buffer2 (b)->qos.bits & (POLICER_N_TRAFFIC_CLASSES - 1);
+}
+
+/*
+ * Claim the policer for this thread if no thread owns it yet. Returns
+ * true if the packet must be handed off to the owning thread.
+ */
+static_always_inline bool
+vnet_policer_needs_handoff (vlib_main_t *vm, u32 policer_index)
+{
+  policer_t *pol = &vnet_policer_main.policers[policer_index];
+
+  if (pol->thread_index == POLICER_THREAD_INDEX_DISTRIBUTED)
+    return false;
+  if (PREDICT_FALSE (pol->thread_index == CLIB_INVALID_THREAD_INDEX))
+    clib_atomic_cmp_and_swap (&pol->thread_index, ~0, vm->thread_index);
+  return pol->thread_index != vm->thread_index;
+}
+
+/*
+ * Two level policing: the traffic class policer runs first and its
+ * color is fed, color-aware, to the interface policer. Class policers
+ * are only ever touched on the thread owning the interface policer, so
+ * a packet is handed off before either bucket is charged.
+ */
+static_always_inline u8
+vnet_policer_police_hier (vlib_main_t *vm, vlib_buffer_t *b,
+			  u32 policer_index, u32 tc_policer_index,
+			  u64 time_in_policer_periods)
+{
+  vnet_policer_main_t *pm = &vnet_policer_main;
+  qos_action_type_en act;
+  policer_t *pol;
+  u32 len, col;
+
+  if (PREDICT_FALSE (vnet_policer_needs_handoff (vm, policer_index)))
+    return QOS_ACTION_HANDOFF;
+
+  pol = &pm->policers[tc_policer_index];
+  len = vlib_buffer_length_in_chain (vm, b);
+  col = vnet_police_packet (pol, len, POLICE_CONFORM, time_in_policer_periods);
+  vlib_increment_combined_counter (&policer_counters[col], vm->thread_index,
+				   tc_policer_index, 1, len);
+
+  act = pol->action[col];
+  if (act == QOS_ACTION_DROP)
+    return act;
+  if (act == QOS_ACTION_MARK_AND_TRANSMIT)
+    vnet_policer_mark (b, pol->mark_dscp[col]);
+
+  return vnet_policer_police (vm, b, policer_index, time_in_policer_periods,
+			      col, true);
+}
+
 typedef enum
 {
   POLICER_HANDOFF_ERROR_CONGESTION_DROP,
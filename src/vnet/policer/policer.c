@@ -205,6 +205,9 @@ policer_bind_worker (u32 policer_index, u32 worker, bool bind)
 
   policer = &pm->policers[policer_index];
 
+  if (policer->thread_index == POLICER_THREAD_INDEX_DISTRIBUTED)
+    policer_distribute (policer_index, 0);
+
   if (bind)
     {
       if (worker >= vlib_num_workers ())
@@ -221,6 +224,137 @@ policer_bind_worker (u32 policer_index, u32 worker, bool bind)
   return 0;
 }
 
+static_always_inline void
+policer_bucket_add (u32 *bucket, u64 tokens, u32 limit)
+{
+  u32 old, new;
+
+  do
+    {
+      old = clib_atomic_load_relax_n (bucket);
+      new = clib_min ((u64) old + tokens, (u64) limit);
+    }
+  while (new != old && !clib_atomic_bool_cmp_and_swap (bucket, old, new));
+}
+
+static_always_inline u32
+policer_bucket_take (u32 *bucket, u32 tokens)
+{
+  u32 old, n;
+
+  do
+    {
+      old = clib_atomic_load_relax_n (bucket);
+      n = clib_min (old, tokens);
+    }
+  while (n && !clib_atomic_bool_cmp_and_swap (bucket, old, old - n));
+
+  return n;
+}
+
+/*
+ * Give the unused tokens of a thread's share back to the policer, and
+ * take a new share, enough for a few periods or a fair part of the burst.
+ * The thread moving last_update_time forward adds the tokens accrued
+ * since to the global buckets.
+ */
+void
+policer_share_rebalance (policer_t *pol, policer_share_t *share, u64 time)
+{
+  policer_t *lp = &share->policer;
+  u64 last = clib_atomic_load_relax_n (&pol->last_update_time);
+  u32 n_threads = vlib_get_n_threads ();
+  u32 ext_tokens_per_period;
+  u64 n_periods;
+
+  ext_tokens_per_period =
+    pol->single_rate ? pol->cir_tokens_per_period : pol->pir_tokens_per_period;
+
+  if (time > last &&
+      clib_atomic_bool_cmp_and_swap (&pol->last_update_time, last, time))
+    {
+      /* idle for long, the buckets are full anyway */
+      n_periods = clib_min (time - last, 1ULL << 32);
+      policer_bucket_add (&pol->current_bucket,
+			  n_periods * pol->cir_tokens_per_period,
+			  pol->current_limit);
+      policer_bucket_add (&pol->extended_bucket,
+			  n_periods * ext_tokens_per_period,
+			  pol->extended_limit);
+    }
+
+  policer_bucket_add (&pol->current_bucket, lp->current_bucket,
+		      pol->current_limit);
+  policer_bucket_add (&pol->extended_bucket, lp->extended_bucket,
+		      pol->extended_limit);
+
+  lp->current_bucket = policer_bucket_take (
+    &pol->current_bucket,
+    clib_max (pol->cir_tokens_per_period * POLICER_SHARE_REBALANCE_PERIODS,
+	      pol->current_limit / n_threads));
+  lp->extended_bucket = policer_bucket_take (
+    &pol->extended_bucket,
+    clib_max (ext_tokens_per_period * POLICER_SHARE_REBALANCE_PERIODS,
+	      pol->extended_limit / n_threads));
+
+  share->last_rebalance_time = time;
+}
+
+int
+policer_distribute (u32 policer_index, bool enable)
+{
+  vnet_policer_main_t *pm = &vnet_policer_main;
+  policer_share_t *share;
+  policer_t *policer;
+  u32 i;
+
+  if (pool_is_free_index (pm->policers, policer_index))
+    return VNET_API_ERROR_NO_SUCH_ENTRY;
+
+  policer = &pm->policers[policer_index];
+
+  if (!enable)
+    {
+      if (policer->thread_index != POLICER_THREAD_INDEX_DISTRIBUTED)
+	return 0;
+
+      /* hand the tokens held in shares back */
+      vec_foreach_index (i, pm->shares_by_thread)
+	{
+	  share = vec_elt_at_index (pm->shares_by_thread[i], policer_index);
+	  policer_bucket_add (&policer->current_bucket,
+			      share->policer.current_bucket,
+			      policer->current_limit);
+	  policer_bucket_add (&policer->extended_bucket,
+			      share->policer.extended_bucket,
+			      policer->extended_limit);
+	}
+      policer->thread_index = ~0;
+      return 0;
+    }
+
+  vec_validate (pm->shares_by_thread, vlib_get_n_threads () - 1);
+  vec_foreach_index (i, pm->shares_by_thread)
+    {
+      vec_validate_aligned (pm->shares_by_thread[i], policer_index,
+			    CLIB_CACHE_LINE_BYTES);
+      share = vec_elt_at_index (pm->shares_by_thread[i], policer_index);
+      share->policer = *policer;
+      share->policer.name = 0;
+      share->policer.thread_index = i;
+      share->policer.cir_tokens_per_period = 0;
+      share->policer.pir_tokens_per_period = 0;
+      share->policer.current_limit = ~0;
+      share->policer.extended_limit = ~0;
+      share->policer.current_bucket = 0;
+      share->policer.extended_bucket = 0;
+      share->last_rebalance_time = 0;
+    }
+
+  policer->thread_index = POLICER_THREAD_INDEX_DISTRIBUTED;
+  return 0;
+}
+
 int
 policer_input (u32 policer_index, u32 sw_if_index, vlib_dir_t dir, bool apply)
 {
@@ -254,6 +388,30 @@ policer_input (u32 policer_index, u32 sw_if_index, vlib_dir_t dir, bool apply)
   return 0;
 }
 
+int
+policer_output_tc (u32 policer_index, u32 sw_if_index, u8 tc, bool apply)
+{
+  vnet_policer_main_t *pm = &vnet_policer_main;
+
+  if (tc >= POLICER_N_TRAFFIC_CLASSES)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  if (apply)
+    {
+      if (pool_is_free_index (pm->policers, policer_index))
+	return VNET_API_ERROR_NO_SUCH_ENTRY;
+      vec_validate_init_empty (pm->tc_policer_index_by_sw_if_index[tc],
+			       sw_if_index, ~0);
+      pm->tc_policer_index_by_sw_if_index[tc][sw_if_index] = policer_index;
+    }
+  else if (sw_if_index < vec_len (pm->tc_policer_index_by_sw_if_index[tc]))
+    {
+      pm->tc_policer_index_by_sw_if_index[tc][sw_if_index] = ~0;
+    }
+
+  return 0;
+}
+
 u8 *
 format_policer_instance (u8 * s, va_list * va)
 {
@@ -278,6 +436,9 @@ format_policer_instance (u8 * s, va_list * va)
 	      i->current_limit,
 	      i->current_bucket, i->extended_limit, i->extended_bucket);
   s = format (s, "last update %llu\n", i->last_update_time);
+  if (i->thread_index == POLICER_THREAD_INDEX_DISTRIBUTED)
+    s = format (s, "distributed, tokens shared by %u threads\n",
+		vec_len (pm->shares_by_thread));
   s = format (s, "conform %llu packets, %llu bytes\n",
 	      counts[POLICE_CONFORM].packets, counts[POLICE_CONFORM].bytes);
   s = format (s, "exceed %llu packets, %llu bytes\n",
@@ -707,6 +868,7 @@ policer_bind_command_fn (vlib_main_t *vm, unformat_input_t *input,
   clib_error_t *error = NULL;
   vnet_policer_main_t *pm = &vnet_policer_main;
   u8 bind = 1;
+  u8 distributed = 0;
   u8 *name = 0;
   u32 worker = ~0;
   u32 policer_index = ~0;
@@ -725,6 +887,8 @@ policer_bind_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	;
       else if (unformat (line_input, "unbind"))
 	bind = 0;
+      else if (unformat (line_input, "distributed"))
+	distributed = 1;
       else if (unformat (line_input, "%d", &worker))
 	;
       else
@@ -735,7 +899,7 @@ policer_bind_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	}
     }
 
-  if (bind && ~0 == worker)
+  if (bind && !distributed && ~0 == worker)
     {
       error = clib_error_return (0, "specify worker to bind to: `%U'",
 				 format_unformat_error, line_input);
@@ -750,7 +914,9 @@ policer_bind_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	}
 
       rv = VNET_API_ERROR_NO_SUCH_ENTRY;
-      if (~0 != policer_index)
+      if (~0 != policer_index && distributed && bind)
+	rv = policer_distribute (policer_index, 1);
+      else if (~0 != policer_index)
 	rv = policer_bind_worker (policer_index, worker, bind);
 
       if (rv)
@@ -831,6 +997,71 @@ done:
   return error;
 }
 
+static clib_error_t *
+policer_output_tc_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			      vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  clib_error_t *error = NULL;
+  vnet_policer_main_t *pm = &vnet_policer_main;
+  u8 apply = 1;
+  u8 *name = 0;
+  u32 sw_if_index = ~0;
+  u32 policer_index = ~0;
+  u32 tc = ~0;
+  uword *p;
+  int rv;
+
+  /* Get a line of input. */
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "name %s", &name))
+	;
+      else if (unformat (line_input, "index %u", &policer_index))
+	;
+      else if (unformat (line_input, "tc %u", &tc))
+	;
+      else if (unformat (line_input, "unapply"))
+	apply = 0;
+      else if (unformat (line_input, "%U", unformat_vnet_sw_interface,
+			 vnet_get_main (), &sw_if_index))
+	;
+      else
+	{
+	  error = clib_error_return (0, "unknown input `%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (~0 == sw_if_index || tc >= POLICER_N_TRAFFIC_CLASSES)
+    {
+      error = clib_error_return (0, "specify interface and tc 0-%d",
+				 POLICER_N_TRAFFIC_CLASSES - 1);
+      goto done;
+    }
+
+  if (~0 == policer_index && 0 != name)
+    {
+      p = hash_get_mem (pm->policer_index_by_name, name);
+      if (p != NULL)
+	policer_index = p[0];
+    }
+
+  rv = policer_output_tc (policer_index, sw_if_index, tc, apply);
+  if (rv)
+    error = clib_error_return (0, "failed: `%d'", rv);
+
+done:
+  unformat_free (line_input);
+  vec_free (name);
+
+  return error;
+}
+
 static clib_error_t *
 policer_reset_command_fn (vlib_main_t *vm, unformat_input_t *input,
 			  vlib_cli_command_t *cmd)
@@ -919,7 +1150,8 @@ VLIB_CLI_COMMAND (policer_del_command, static) = {
 
 VLIB_CLI_COMMAND (policer_bind_command, static) = {
   .path = "policer bind",
-  .short_help = "policer bind [unbind] [name <name> | index <index>] <worker>",
+  .short_help = "policer bind [unbind] [name <name> | index <index>] "
+		"<worker> | distributed",
   .function = policer_bind_command_fn,
 };
 
@@ -939,6 +1171,13 @@ VLIB_CLI_COMMAND (policer_output_command, static) = {
   .function_arg = VLIB_TX,
 };
 
+VLIB_CLI_COMMAND (policer_output_tc_command, static) = {
+  .path = "policer output tc",
+  .short_help = "policer output tc <0-7> [unapply] [name <name> | "
+		"index <index>] <interface>",
+  .function = policer_output_tc_command_fn,
+};
+
 VLIB_CLI_COMMAND (policer_reset_command, static) = {
   .path = "policer reset",
   .short_help = "policer reset [name <name> | index <index>]",
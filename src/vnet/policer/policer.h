@@ -23,6 +23,9 @@
 #include <vnet/policer/xlate.h>
 #include <vnet/policer/police.h>
 
+/* Traffic classes policed beneath an output interface policer */
+#define POLICER_N_TRAFFIC_CLASSES 8
+
 typedef struct
 {
   /* policer pool, aligned */
@@ -41,6 +44,9 @@ typedef struct
   /* Policer by sw_if_index vector */
   u32 *policer_index_by_sw_if_index[VLIB_N_RX_TX];
 
+  /* Output traffic class policers by sw_if_index, indexed by class */
+  u32 *tc_policer_index_by_sw_if_index[POLICER_N_TRAFFIC_CLASSES];
+
   /* convenience */
   vlib_main_t *vlib_main;
   vnet_main_t *vnet_main;
@@ -50,6 +56,9 @@ typedef struct
   /* frame queue for thread handoff */
   u32 fq_index[VLIB_N_RX_TX];
 
+  /* per-thread shares of distributed policers, indexed by policer */
+  policer_share_t **shares_by_thread;
+
   u16 msg_id_base;
 } vnet_policer_main_t;
 
@@ -76,8 +85,13 @@ int policer_update (vlib_main_t *vm, u32 policer_index,
 int policer_del (vlib_main_t *vm, u32 policer_index);
 int policer_reset (vlib_main_t *vm, u32 policer_index);
 int policer_bind_worker (u32 policer_index, u32 worker, bool bind);
+int policer_distribute (u32 policer_index, bool enable);
+void policer_share_rebalance (policer_t *pol, policer_share_t *share,
+			      u64 time);
 int policer_input (u32 policer_index, u32 sw_if_index, vlib_dir_t dir,
 		   bool apply);
+int policer_output_tc (u32 policer_index, u32 sw_if_index, u8 tc,
+		       bool apply);
 
 #endif /* __included_policer_h__ */
 
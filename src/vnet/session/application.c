@@ -859,6 +859,10 @@ application_alloc_and_init (app_init_args_t *a)
   if (opts[APP_OPTIONS_FLAGS] & APP_OPTIONS_FLAGS_LOG_COLLECTOR)
     app->cb_fns.app_evt_callback = app_evt_collector_get_cb_fn ();
 
+  if ((opts[APP_OPTIONS_FLAGS] & APP_OPTIONS_FLAGS_ELASTIC_FIFOS) &&
+      !app->cb_fns.fifo_tuning_callback)
+    app->cb_fns.fifo_tuning_callback = segment_manager_fifo_elastic_tuning;
+
   /* Add app to lookup by api_client_index table */
   if (!application_is_builtin (app))
     application_api_table_add (app->app_index, a->api_client_index);
@@ -1095,7 +1099,7 @@ application_alloc_worker_and_init (application_t * app, app_worker_t ** wrk)
    * Setup app worker
    */
   app_wrk->connects_seg_manager = segment_manager_index (sm);
-  app_wrk->listeners_table = hash_create (0, sizeof (u64));
+  clib_oahash_init_8_8 (&app_wrk->listeners_table, "app listeners", 0);
   app_wrk->event_queue = segment_manager_event_queue (sm);
   app_wrk->app_is_builtin = application_is_builtin (app);
 
@@ -1525,6 +1529,7 @@ int
 application_change_listener_owner (session_t * s, app_worker_t * app_wrk)
 {
   app_worker_t *old_wrk = app_worker_get (s->app_wrk_index);
+  clib_oahash_kv_8_8_t kv;
   app_listener_t *app_listener;
   application_t *app;
   int rv;
@@ -1532,7 +1537,8 @@ application_change_listener_owner (session_t * s, app_worker_t * app_wrk)
   if (!old_wrk)
     return SESSION_E_INVALID_APPWRK;
 
-  hash_unset (old_wrk->listeners_table, listen_session_get_handle (s));
+  kv.key = listen_session_get_handle (s);
+  clib_oahash_add_del_8_8 (&old_wrk->listeners_table, &kv, 0 /* is_add */);
   if (session_transport_service_type (s) == TRANSPORT_SERVICE_CL
       && s->rx_fifo)
     segment_manager_dealloc_fifos (s->rx_fifo, s->tx_fifo);
@@ -1742,8 +1748,7 @@ application_format_listeners (application_t * app, int verbose)
   vlib_main_t *vm = vlib_get_main ();
   app_worker_map_t *wrk_map;
   app_worker_t *app_wrk;
-  u32 sm_index;
-  u64 handle;
+  clib_oahash_kv_8_8_t *kv;
 
   if (!app)
     {
@@ -1754,12 +1759,11 @@ application_format_listeners (application_t * app, int verbose)
 
   pool_foreach (wrk_map, app->worker_maps)  {
     app_wrk = app_worker_get (wrk_map->wrk_index);
-    if (hash_elts (app_wrk->listeners_table) == 0)
+    if (clib_oahash_elts_8_8 (&app_wrk->listeners_table) == 0)
       continue;
-    hash_foreach (handle, sm_index, app_wrk->listeners_table, ({
+    oahash_foreach_kv (kv, &app_wrk->listeners_table)
       vlib_cli_output (vm, "%U", format_app_worker_listener, app_wrk,
-                       handle, sm_index, verbose);
-    }));
+		       kv->key, (u32) kv->value, verbose);
   }
 }
 
@@ -1855,8 +1859,7 @@ format_application (u8 * s, va_list * args)
   app_worker_map_t *wrk_map;
   app_worker_t *app_wrk;
   segment_manager_t *sm;
-  u64 handle;
-  u32 sm_index;
+  clib_oahash_kv_8_8_t *kv;
 
   if (app == 0)
     {
@@ -1890,11 +1893,12 @@ format_application (u8 * s, va_list * args)
 	  sm = segment_manager_get (app_wrk->connects_seg_manager);
 	  s = format (s, "segment manager\n %U", format_segment_manager, sm,
 		      1 /* verbose */);
-	  hash_foreach (handle, sm_index, app_wrk->listeners_table, ({
-			  sm = segment_manager_get (sm_index);
-			  s = format (s, " %U\n", format_segment_manager, sm,
-				      1 /* verbose */);
-			}));
+	  oahash_foreach_kv (kv, &app_wrk->listeners_table)
+	    {
+	      sm = segment_manager_get (kv->value);
+	      s = format (s, " %U\n", format_segment_manager, sm,
+			  1 /* verbose */);
+	    }
 	}
   }
 
@@ -20,6 +20,7 @@
 #include <vnet/session/application_namespace.h>
 #include <vnet/session/session_types.h>
 #include <vnet/session/segment_manager.h>
+#include <vppinfra/oahash_8_8.h>
 
 #define APP_DEBUG 0
 
@@ -64,7 +65,7 @@ typedef struct app_worker_
   u32 connects_seg_manager;
 
   /** Lookup tables for listeners. Value is segment manager index */
-  uword *listeners_table;
+  clib_oahash_8_8_t listeners_table;
 
   /** API index for the worker. Needed for multi-process apps */
   u32 api_client_index;
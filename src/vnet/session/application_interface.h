@@ -246,7 +246,8 @@ typedef enum
   _ (MEMFD_FOR_BUILTIN, "Use memfd for builtin app segs")                     \
   _ (USE_HUGE_PAGE, "Use huge page for FIFO")                                 \
   _ (GET_ORIGINAL_DST, "Get original dst enabled")                            \
-  _ (LOG_COLLECTOR, "App requests log collector")
+  _ (LOG_COLLECTOR, "App requests log collector")                             \
+  _ (ELASTIC_FIFOS, "Grow and shrink fifos with usage")
 
 typedef enum _app_options
 {
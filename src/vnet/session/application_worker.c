@@ -58,12 +58,12 @@ void
 app_worker_free (app_worker_t * app_wrk)
 {
   application_t *app = application_get (app_wrk->app_index);
-  session_handle_t handle, *handles = 0, *sh;
+  session_handle_t *handles = 0, *sh;
   vnet_unlisten_args_t _a, *a = &_a;
+  clib_oahash_kv_8_8_t *kv;
   segment_manager_t *sm;
   u64 *sm_indices = 0;
   session_t *ls;
-  u32 sm_index;
   int i;
 
   /*
@@ -80,12 +80,12 @@ app_worker_free (app_worker_t * app_wrk)
    *  Listener cleanup
    */
 
-  hash_foreach (handle, sm_index, app_wrk->listeners_table, ({
-    ls = listen_session_get_from_handle (handle);
-    vec_add1 (handles, app_listen_session_handle (ls));
-    vec_add1 (sm_indices, sm_index);
-    sm = segment_manager_get (sm_index);
-  }));
+  oahash_foreach_kv (kv, &app_wrk->listeners_table)
+    {
+      ls = listen_session_get_from_handle (kv->key);
+      vec_add1 (handles, app_listen_session_handle (ls));
+      vec_add1 (sm_indices, kv->value);
+    }
 
   for (i = 0; i < vec_len (handles); i++)
     {
@@ -104,7 +104,7 @@ app_worker_free (app_worker_t * app_wrk)
     }
   vec_free (handles);
   vec_free (sm_indices);
-  hash_free (app_wrk->listeners_table);
+  clib_oahash_free_8_8 (&app_wrk->listeners_table);
 
   /*
    * Connects segment manager cleanup
@@ -242,6 +242,7 @@ app_worker_free_wrk_cl_session (app_worker_t *app_wrk, session_t *ls)
 int
 app_worker_init_listener (app_worker_t * app_wrk, session_t * ls)
 {
+  clib_oahash_kv_8_8_t kv;
   segment_manager_t *sm;
 
   /* Allocate segment manager. All sessions derived out of a listen session
@@ -255,8 +256,9 @@ app_worker_init_listener (app_worker_t * app_wrk, session_t * ls)
   sm->flags |= SEG_MANAGER_F_LISTENER;
 
   /* Keep track of the segment manager for the listener or this worker */
-  hash_set (app_wrk->listeners_table, listen_session_get_handle (ls),
-	    segment_manager_index (sm));
+  kv.key = listen_session_get_handle (ls);
+  kv.value = segment_manager_index (sm);
+  clib_oahash_add_del_8_8 (&app_wrk->listeners_table, &kv, 1 /* is_add */);
 
   if (ls->flags & SESSION_F_IS_CLESS)
     return app_worker_alloc_wrk_cl_session (app_wrk, ls);
@@ -319,21 +321,20 @@ app_worker_del_detached_sm (app_worker_t * app_wrk, u32 sm_index)
 static void
 app_worker_stop_listen_session (app_worker_t * app_wrk, session_t * ls)
 {
-  session_handle_t handle;
+  clib_oahash_kv_8_8_t kv;
   segment_manager_t *sm;
-  uword *sm_indexp;
   session_state_t *states = 0;
 
-  handle = listen_session_get_handle (ls);
-  sm_indexp = hash_get (app_wrk->listeners_table, handle);
-  if (PREDICT_FALSE (!sm_indexp))
+  kv.key = listen_session_get_handle (ls);
+  if (PREDICT_FALSE (
+	clib_oahash_search_inline_8_8 (&app_wrk->listeners_table, &kv)))
     return;
 
   if (ls->flags & SESSION_F_IS_CLESS)
     app_worker_free_wrk_cl_session (app_wrk, ls);
 
   /* Try to cleanup segment manager */
-  sm = segment_manager_get (*sm_indexp);
+  sm = segment_manager_get (kv.value);
   if (sm)
     {
       sm->first_is_protected = 0;
@@ -352,12 +353,12 @@ app_worker_stop_listen_session (app_worker_t * app_wrk, session_t * ls)
 
 	  /* Track segment manager in case app detaches and all the
 	   * outstanding sessions need to be closed */
-	  app_worker_add_detached_sm (app_wrk, *sm_indexp);
+	  app_worker_add_detached_sm (app_wrk, kv.value);
 	  sm->flags |= SEG_MANAGER_F_DETACHED_LISTENER;
 	}
     }
 
-  hash_unset (app_wrk->listeners_table, handle);
+  clib_oahash_add_del_8_8 (&app_wrk->listeners_table, &kv, 0 /* is_add */);
 }
 
 int
@@ -634,30 +635,33 @@ segment_manager_t *
 app_worker_get_listen_segment_manager (app_worker_t * app,
 				       session_t * listener)
 {
-  uword *smp;
-  smp = hash_get (app->listeners_table, listen_session_get_handle (listener));
-  ALWAYS_ASSERT (smp != 0);
-  return segment_manager_get (*smp);
+  clib_oahash_kv_8_8_t kv = {};
+  int rv;
+
+  kv.key = listen_session_get_handle (listener);
+  rv = clib_oahash_search_inline_8_8 (&app->listeners_table, &kv);
+  ALWAYS_ASSERT (rv == 0);
+  return segment_manager_get (kv.value);
 }
 
 session_t *
 app_worker_first_listener (app_worker_t * app_wrk, u8 fib_proto,
 			   u8 transport_proto)
 {
+  clib_oahash_kv_8_8_t *kv;
   session_t *listener;
-  u64 handle;
-  u32 sm_index;
   u8 sst;
 
   sst = session_type_from_proto_and_ip (transport_proto,
 					fib_proto == FIB_PROTOCOL_IP4);
 
-   hash_foreach (handle, sm_index, app_wrk->listeners_table, ({
-     listener = listen_session_get_from_handle (handle);
-     if (listener->session_type == sst
-	 && !(listener->flags & SESSION_F_PROXY))
-       return listener;
-   }));
+  oahash_foreach_kv (kv, &app_wrk->listeners_table)
+    {
+      listener = listen_session_get_from_handle (kv->key);
+      if (listener->session_type == sst &&
+	  !(listener->flags & SESSION_F_PROXY))
+	return listener;
+    }
 
   return 0;
 }
@@ -666,19 +670,19 @@ session_t *
 app_worker_proxy_listener (app_worker_t * app_wrk, u8 fib_proto,
 			   u8 transport_proto)
 {
+  clib_oahash_kv_8_8_t *kv;
   session_t *listener;
-  u64 handle;
-  u32 sm_index;
   u8 sst;
 
   sst = session_type_from_proto_and_ip (transport_proto,
 					fib_proto == FIB_PROTOCOL_IP4);
 
-   hash_foreach (handle, sm_index, app_wrk->listeners_table, ({
-     listener = listen_session_get_from_handle (handle);
-     if (listener->session_type == sst && (listener->flags & SESSION_F_PROXY))
-       return listener;
-   }));
+  oahash_foreach_kv (kv, &app_wrk->listeners_table)
+    {
+      listener = listen_session_get_from_handle (kv->key);
+      if (listener->session_type == sst && (listener->flags & SESSION_F_PROXY))
+	return listener;
+    }
 
   return 0;
 }
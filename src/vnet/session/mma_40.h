@@ -15,10 +15,14 @@
 
 #undef MMA_RT_TYPE
 #define MMA_RT_TYPE 40
+#undef MMA_RT_HASH_TYPE
+#define MMA_RT_HASH_TYPE _48_8
 
 #ifndef SRC_VNET_SESSION_MMA_TABLE_40_H_
 #define SRC_VNET_SESSION_MMA_TABLE_40_H_
 
+#include <vppinfra/bihash_48_8.h>
+
 #undef SRC_VNET_SESSION_MMA_TEMPLATE_H_
 #include <vnet/session/mma_template.h>
 
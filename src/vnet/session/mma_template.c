@@ -71,6 +71,10 @@ void RT (mma_rules_table_free) (RTT (mma_rules_table) * srt)
 
   pool_flush (rule, srt->rules, ({}));
   pool_free (srt->rules);
+  vec_free (srt->masks);
+  if (srt->hash_initialized)
+    RTH (clib_bihash_free) (&srt->hash);
+  srt->hash_initialized = 0;
 }
 
 RTT (mma_rule) *
@@ -89,14 +93,146 @@ RT (mma_rules_table_rule_index) (RTT (mma_rules_table) * srt,
   return (sr - srt->rules);
 }
 
+static_always_inline void
+RT (mma_rules_table_make_kv) (RTHT (clib_bihash_kv) * kv,
+			      RTT (mma_mask_or_match) * key,
+			      RTT (mma_mask_or_match) * mask, u32 mask_index)
+{
+  int i;
+
+  for (i = 0; i < ARRAY_LEN (key->as_u64); i++)
+    kv->key[i] = key->as_u64[i] & mask->as_u64[i];
+  kv->key[i] = mask_index;
+}
+
+static void
+RT (mma_rules_table_hash_add) (RTT (mma_rules_table) * srt, u32 rule_index)
+{
+  RTT (mma_rule) * rule = RT (mma_rules_table_get_rule) (srt, rule_index);
+  RTHT (clib_bihash_kv) kv;
+  RTT (mma_rule) * head;
+  u32 mi, free_mi = ~0;
+
+  if (!srt->hash_initialized)
+    {
+      RTH (clib_bihash_init) (&srt->hash, "session rules",
+			      MMA_TABLE_HASH_BUCKETS, MMA_TABLE_HASH_MEMORY);
+      srt->hash_initialized = 1;
+    }
+
+  for (mi = 0; mi < vec_len (srt->masks); mi++)
+    {
+      if (srt->masks[mi].n_rules == 0)
+	free_mi = clib_min (free_mi, mi);
+      else if (!memcmp (&srt->masks[mi].mask, &rule->mask,
+			sizeof (rule->mask)))
+	break;
+    }
+
+  if (mi == vec_len (srt->masks))
+    {
+      mi = free_mi != ~0 ? free_mi : mi;
+      vec_validate (srt->masks, mi);
+      srt->masks[mi].mask = rule->mask;
+    }
+
+  srt->masks[mi].n_rules++;
+  rule->next_dup_index = MMA_TABLE_INVALID_INDEX;
+  RT (mma_rules_table_make_kv) (&kv, &rule->match, &rule->mask, mi);
+
+  /* an identical rule is already hashed, chain this one after it */
+  if (!RTH (clib_bihash_search_inline) (&srt->hash, &kv))
+    {
+      head = RT (mma_rules_table_get_rule) (srt, kv.value);
+      rule->next_dup_index = head->next_dup_index;
+      head->next_dup_index = rule_index;
+      return;
+    }
+
+  kv.value = rule_index;
+  RTH (clib_bihash_add_del) (&srt->hash, &kv, 1 /* is_add */);
+}
+
+static void
+RT (mma_rules_table_hash_del) (RTT (mma_rules_table) * srt,
+			       RTT (mma_rule) * rule)
+{
+  u32 mi, rule_index = RT (mma_rules_table_rule_index) (srt, rule);
+  RTHT (clib_bihash_kv) kv;
+  RTT (mma_rule) * rp;
+
+  for (mi = 0; mi < vec_len (srt->masks); mi++)
+    {
+      if (srt->masks[mi].n_rules &&
+	  !memcmp (&srt->masks[mi].mask, &rule->mask, sizeof (rule->mask)))
+	break;
+    }
+
+  RT (mma_rules_table_make_kv) (&kv, &rule->match, &rule->mask, mi);
+  if (mi == vec_len (srt->masks) ||
+      RTH (clib_bihash_search_inline) (&srt->hash, &kv))
+    {
+      ASSERT (0);
+      return;
+    }
+
+  srt->masks[mi].n_rules--;
+
+  if (kv.value == rule_index)
+    {
+      kv.value = rule->next_dup_index;
+      RTH (clib_bihash_add_del) (&srt->hash, &kv,
+				 kv.value != MMA_TABLE_INVALID_INDEX);
+      return;
+    }
+
+  rp = RT (mma_rules_table_get_rule) (srt, kv.value);
+  while (rp->next_dup_index != rule_index)
+    rp = RT (mma_rules_table_get_rule) (srt, rp->next_dup_index);
+  rp->next_dup_index = rule->next_dup_index;
+}
+
+static u32
+RT (mma_rules_table_compile_rule) (RTT (mma_rules_table) * srt,
+				   u32 rule_index, u32 parent_index,
+				   u32 preorder)
+{
+  RTT (mma_rule) * rp = RT (mma_rules_table_get_rule) (srt, rule_index);
+  u32 first = preorder;
+  int i;
+
+  rp->parent_index = parent_index;
+  rp->preorder = preorder++;
+  for (i = 0; i < vec_len (rp->next_indices); i++)
+    preorder = RT (mma_rules_table_compile_rule) (srt, rp->next_indices[i],
+						  rule_index, preorder);
+  rp->n_descendants = preorder - first - 1;
+  return preorder;
+}
+
 /**
- * Lookup key in table
+ * Number the rules in rules tree preorder
+ *
+ * Called whenever the shape of the tree changes, so that the compiled
+ * lookup can tell which of the rules matching a key the tree walk picks.
+ */
+void RT (mma_rules_table_compile) (RTT (mma_rules_table) * srt)
+{
+  RT (mma_rules_table_compile_rule) (srt, srt->root_index,
+				     MMA_TABLE_INVALID_INDEX, 0);
+}
+
+/**
+ * Lookup key in table by walking the rules tree
  *
- * This should be optimized .. eventually
+ * At every level the walk descends into the first child, in rule_cmp_fn
+ * order, that matches the key. The action of the last rule reached is
+ * returned.
  */
 u32
-RT (mma_rules_table_lookup) (RTT (mma_rules_table) * srt,
-			     RTT (mma_mask_or_match) * key, u32 rule_index)
+RT (mma_rules_table_lookup_tree) (RTT (mma_rules_table) * srt,
+				  RTT (mma_mask_or_match) * key,
+				  u32 rule_index)
 {
   RTT (mma_rule) * rp;
   u32 rv;
@@ -110,13 +246,78 @@ RT (mma_rules_table_lookup) (RTT (mma_rules_table) * srt,
     return MMA_TABLE_INVALID_INDEX;
   for (i = 0; i < vec_len (rp->next_indices); i++)
     {
-      rv = RT (mma_rules_table_lookup) (srt, key, rp->next_indices[i]);
+      rv = RT (mma_rules_table_lookup_tree) (srt, key, rp->next_indices[i]);
       if (rv != MMA_TABLE_INVALID_INDEX)
 	return (rv);
     }
   return (rp->action_index);
 }
 
+/**
+ * Lookup key in table
+ *
+ * Same result as @ref mma_rules_table_lookup_tree from the root, but
+ * instead of scanning the children of every rule on the way, the rules
+ * matching the key are found with one hash search per distinct rule
+ * mask. Sorted in tree preorder, the rules the walk would reach are then
+ * the chain of matches, each a child of the previous one, that starts at
+ * the root. A match outside the subtree of the last rule of the chain
+ * ends it.
+ */
+u32
+RT (mma_rules_table_lookup) (RTT (mma_rules_table) * srt,
+			     RTT (mma_mask_or_match) * key, u32 rule_index)
+{
+  RTT (mma_rule) * matches[MMA_TABLE_LOOKUP_MAX_MATCHES], *rp, *cp;
+  RTHT (clib_bihash_kv) kv;
+  u32 n_matches = 0, i, j, ri;
+
+  ASSERT (rule_index == srt->root_index);
+  cp = RT (mma_rules_table_get_rule) (srt, rule_index);
+  ASSERT (cp);
+
+  if (!RT (rule_is_match_for_key) (key, cp))
+    return MMA_TABLE_INVALID_INDEX;
+
+  for (i = 0; i < vec_len (srt->masks); i++)
+    {
+      if (srt->masks[i].n_rules == 0)
+	continue;
+      RT (mma_rules_table_make_kv) (&kv, key, &srt->masks[i].mask, i);
+      if (RTH (clib_bihash_search_inline) (&srt->hash, &kv))
+	continue;
+
+      for (ri = kv.value; ri != MMA_TABLE_INVALID_INDEX;
+	   ri = rp->next_dup_index)
+	{
+	  if (PREDICT_FALSE (n_matches == MMA_TABLE_LOOKUP_MAX_MATCHES))
+	    return RT (mma_rules_table_lookup_tree) (srt, key, rule_index);
+
+	  rp = srt->rules + ri;
+	  for (j = n_matches++;
+	       j > 0 && matches[j - 1]->preorder > rp->preorder; j--)
+	    matches[j] = matches[j - 1];
+	  matches[j] = rp;
+	}
+    }
+
+  for (i = 0; i < n_matches; i++)
+    {
+      rp = matches[i];
+      if (rp->parent_index == cp - srt->rules)
+	cp = rp;
+      else if (rp->preorder > cp->preorder + cp->n_descendants)
+	break;
+    }
+
+  /* the walk would go on with the next siblings of a rule without action */
+  if (PREDICT_FALSE (cp->action_index == MMA_TABLE_INVALID_INDEX &&
+		     cp - srt->rules != rule_index))
+    return RT (mma_rules_table_lookup_tree) (srt, key, rule_index);
+
+  return (cp->action_index);
+}
+
 u32
 RT (mma_rules_table_lookup_rule) (RTT (mma_rules_table) * srt,
 				  RTT (mma_mask_or_match) * key,
@@ -178,9 +379,12 @@ RT (mma_rules_table_add_rule) (RTT (mma_rules_table) * srt,
       return -1;
     }
 
+  RT (mma_rules_table_hash_add) (srt, rule_index);
+
   if (vec_len (parent->next_indices) == 0)
     {
       vec_add1 (parent->next_indices, rule_index);
+      RT (mma_rules_table_compile) (srt);
       return 0;
     }
 
@@ -211,6 +415,7 @@ RT (mma_rules_table_add_rule) (RTT (mma_rules_table) * srt,
     vec_add1 (next_indices, rule_index);
   vec_free (parent->next_indices);
   parent->next_indices = next_indices;
+  RT (mma_rules_table_compile) (srt);
   return 0;
 }
 
@@ -257,9 +462,12 @@ RT (mma_rules_table_del_rule) (RTT (mma_rules_table) * srt,
 	      clib_memcpy_fast (new_elts, &rp->next_indices[i + 1],
 				left_to_add * sizeof (u32));
 	    }
+	  RT (mma_rules_table_hash_del) (srt, child);
+	  vec_free (child->next_indices);
 	  RT (mma_rule_free) (srt, child);
 	  vec_free (rp->next_indices);
 	  rp->next_indices = next_indices;
+	  RT (mma_rules_table_compile) (srt);
 	  return 0;
 	}
       else if (rv == 0)
@@ -30,8 +30,23 @@
 #define __rtt(a, b) _rtt(a,b)
 #define RTT(a) __rtt(a, MMA_RT_TYPE)
 
+/* bihash of the compiled lookup, its key is a masked key and mask index */
+#define _rth(a, b)  a##b
+#define __rth(a, b) _rth (a, b)
+#define RTH(a)	    __rth (a, MMA_RT_HASH_TYPE)
+
+#define _rtht(a, b)  a##b##_t
+#define __rtht(a, b) _rtht (a, b)
+#define RTHT(a)	     __rtht (a, MMA_RT_HASH_TYPE)
+
 #define MMA_TABLE_INVALID_INDEX ((u32)~0)
 
+/** Rules matching a key beyond which lookups walk the rules tree */
+#define MMA_TABLE_LOOKUP_MAX_MATCHES 32
+
+#define MMA_TABLE_HASH_BUCKETS 1024
+#define MMA_TABLE_HASH_MEMORY  (64 << 20)
+
 typedef struct
 {
   u64 as_u64[MMA_RT_TYPE / 8];
@@ -44,8 +59,22 @@ typedef struct
   RTT (mma_mask_or_match) mask;
   RTT (mma_mask_or_match) match;
   RTT (mma_mask_or_match) max_match;
+
+  /** Position in the rules tree, set when the table is compiled */
+  u32 parent_index;
+  u32 preorder;
+  u32 n_descendants;
+
+  /** Next rule with the same mask and match, elsewhere in the tree */
+  u32 next_dup_index;
 } RTT (mma_rule);
 
+typedef struct
+{
+  RTT (mma_mask_or_match) mask;
+  u32 n_rules;
+} RTT (mma_mask);
+
 typedef int (*RTT (rule_cmp_fn)) (RTT (mma_rule) * rule1,
 				  RTT (mma_rule) * rule2);
 typedef struct
@@ -57,6 +86,12 @@ typedef struct
     RTT (mma_rule) * rules;
 
     RTT (rule_cmp_fn) rule_cmp_fn;
+
+  /** Compiled lookup. Rules are hashed by match and index of their
+   *  mask, so a lookup costs one hash search per distinct rule mask */
+  RTT (mma_mask) * masks;
+  RTHT (clib_bihash) hash;
+  u8 hash_initialized;
 } RTT (mma_rules_table);
 
 u32
@@ -65,6 +100,10 @@ RT (mma_table_lookup) (RTT (mma_rules_table) * srt,
 u32
 RT (mma_table_lookup_rule) (RTT (mma_rules_table) * srt,
 			    RTT (mma_mask_or_match) * key, u32 rule_index);
+u32 RT (mma_rules_table_lookup_tree) (RTT (mma_rules_table) * srt,
+				      RTT (mma_mask_or_match) * key,
+				      u32 rule_index);
+void RT (mma_rules_table_compile) (RTT (mma_rules_table) * srt);
 int
 RT (mma_table_add_rule) (RTT (mma_rules_table) * srt, RTT (mma_rule) * rule);
 int
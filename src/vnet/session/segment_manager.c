@@ -1234,6 +1234,55 @@ segment_manager_set_watermarks (segment_manager_t * sm,
   sm->low_watermark = low_watermark;
 }
 
+/**
+ * Default fifo tuning for apps that request elastic fifos
+ *
+ * Grows fifos that are filling up, as long as the segment is not under
+ * memory pressure, and shrinks fifos that are mostly empty or when the
+ * segment is above its watermarks. Fifo size is virtual, chunks are only
+ * provisioned on enqueue and collected on dequeue, so shrinking idle fifos
+ * returns memory to the segment slice for other sessions to use.
+ */
+int
+segment_manager_fifo_elastic_tuning (session_t *s, svm_fifo_t *f,
+				     session_ft_action_t act, u32 bytes)
+{
+  segment_manager_t *sm = segment_manager_get (f->segment_manager);
+  fifo_segment_t *fs = segment_manager_get_segment (sm, f->segment_index);
+  u32 fifo_in_use, fifo_size, update_size = 0;
+  u8 seg_usage, fifo_usage;
+
+  seg_usage = fifo_segment_get_mem_usage (fs);
+  fifo_in_use = svm_fifo_max_dequeue_prod (f);
+  fifo_size = svm_fifo_size (f);
+  fifo_usage = (u64) fifo_in_use * 100 / fifo_size;
+
+  if (act == SESSION_FT_ACTION_ENQUEUED)
+    {
+      if (seg_usage < sm->low_watermark && fifo_usage > 50)
+	update_size = fifo_in_use;
+      else if (seg_usage < sm->high_watermark && fifo_usage > 80)
+	update_size = fifo_in_use / 2;
+
+      update_size = clib_min (update_size, sm->max_fifo_size - fifo_size);
+      if (update_size)
+	svm_fifo_set_size (f, fifo_size + update_size);
+    }
+  else
+    {
+      if (seg_usage > sm->high_watermark || fifo_usage < 20)
+	update_size = bytes;
+      else if (seg_usage > sm->low_watermark && fifo_usage < 50)
+	update_size = bytes / 2;
+
+      update_size = clib_min (update_size, fifo_size - 4096);
+      if (update_size)
+	svm_fifo_set_size (f, fifo_size - update_size);
+    }
+
+  return 0;
+}
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
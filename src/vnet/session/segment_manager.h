@@ -163,6 +163,8 @@ void segment_manager_attach_fifo (segment_manager_t *sm, svm_fifo_t **f,
 
 void segment_manager_set_watermarks (segment_manager_t * sm,
 				     u8 high_watermark, u8 low_watermark);
+int segment_manager_fifo_elastic_tuning (session_t *s, svm_fifo_t *f,
+					 session_ft_action_t act, u32 bytes);
 
 u8 segment_manager_has_fifos (segment_manager_t * sm);
 
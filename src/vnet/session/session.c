@@ -1907,6 +1907,8 @@ session_manager_main_enable (vlib_main_t *vm,
       wrk->last_vlib_time = vlib_time_now (vm);
       wrk->last_vlib_us_time = wrk->last_vlib_time * CLIB_US_TIME_FREQ;
       wrk->timerfd = -1;
+      tw_timer_wheel_init_1t_3w_1024sl_ov (&wrk->pacer_wheel, 0,
+					   SESSION_PACER_TICK, ~0);
       vec_validate (wrk->session_to_enqueue, smm->last_transport_proto_type);
 
       if (!smm->no_adaptive && smm->use_private_rx_mqs)
@@ -2027,6 +2029,7 @@ session_node_enable_dma (u8 is_en, int n_vlibs)
       vm = vlib_get_main_by_index (i);
       wrk = session_main_get_worker (vm->thread_index);
       wrk->config_index = config_index;
+      wrk->dma_min_copy_size = session_main.dma_min_copy_size;
       if (is_en)
 	{
 	  if (config_index >= 0)
@@ -2133,6 +2136,7 @@ session_main_init (vlib_main_t * vm)
   smm->poll_main = 0;
   smm->use_private_rx_mqs = 0;
   smm->no_adaptive = 0;
+  smm->dma_min_copy_size = SESSION_DMA_MIN_COPY_SIZE;
   smm->last_transport_proto_type = TRANSPORT_PROTO_HTTP;
   smm->port_allocator_min_src_port = 1024;
   smm->port_allocator_max_src_port = 65535;
@@ -2268,6 +2272,9 @@ session_config_fn (vlib_main_t * vm, unformat_input_t * input)
 	smm->no_adaptive = 1;
       else if (unformat (input, "use-dma"))
 	smm->dma_enabled = 1;
+      else if (unformat (input, "dma-min-copy-size %U",
+			 unformat_memory_size, &tmp))
+	smm->dma_min_copy_size = tmp;
       else if (unformat (input, "nat44-original-dst-enable"))
 	{
 	  smm->original_dst_lookup = vlib_get_plugin_symbol (
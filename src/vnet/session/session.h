@@ -16,6 +16,7 @@
 #define __included_session_h__
 
 #include <vppinfra/llist.h>
+#include <vppinfra/tw_timer_1t_3w_1024sl_ov.h>
 #include <vnet/session/session_types.h>
 #include <vnet/session/session_lookup.h>
 #include <vnet/session/session_debug.h>
@@ -26,6 +27,12 @@
 typedef struct session_wrk_stats_
 {
   u32 errors[SESSION_N_ERRORS];
+
+  /** tx fifo copies offloaded to dma, and those left to the cpu */
+  u64 n_dma_copies;
+  u64 n_dma_copy_bytes;
+  u64 n_cpu_copies;
+  u64 n_cpu_copy_bytes;
 } session_wrk_stats_t;
 
 typedef struct session_tx_context_
@@ -75,6 +82,10 @@ typedef enum session_wrk_flags_
 } __clib_packed session_wrk_flag_t;
 
 #define DMA_TRANS_SIZE 1024
+/* below this the cost of submitting a copy exceeds that of doing it */
+#define SESSION_DMA_MIN_COPY_SIZE 1024
+/* tick of the wheel paced sessions wait on for tx credit */
+#define SESSION_PACER_TICK 10e-6
 typedef struct
 {
   u32 *pending_tx_buffers;
@@ -130,6 +141,15 @@ typedef struct session_worker_
   /** Head of list of pending events */
   clib_llist_index_t old_head;
 
+  /** Wheel of io events of paced sessions waiting for tx credit */
+  tw_timer_wheel_1t_3w_1024sl_ov_t pacer_wheel;
+
+  /** Vector of io events whose pacer timer expired */
+  u32 *pacer_expired;
+
+  /** Number of io events parked on the pacer wheel */
+  u32 n_pacer_parked;
+
   /** Vector of buffers to be sent */
   u32 *pending_tx_buffers;
 
@@ -155,6 +175,8 @@ typedef struct session_worker_
 
   int config_index;
   u8 dma_enabled;
+  /** copies shorter than this are done by the cpu */
+  u32 dma_min_copy_size;
   session_dma_transfer *dma_trans;
   u16 trans_head;
   u16 trans_tail;
@@ -276,6 +298,9 @@ typedef struct session_main_
   /** Session enable dma*/
   u8 dma_enabled;
 
+  /** Smallest fifo copy offloaded to dma */
+  u32 dma_min_copy_size;
+
   /** Session table size parameters */
   u32 configured_v4_session_table_buckets;
   u32 configured_v4_session_table_memory;
@@ -669,7 +694,8 @@ session_enqueue_discard_chain_bytes (vlib_main_t *vm, vlib_buffer_t *b,
   *chain_b = next;
 
   if (to_drop == 0)
-    b->total_length_not_including_first_buffer -= n_bytes_to_drop;
+    vlib_buffer_cold (b)->total_length_not_including_first_buffer -=
+      n_bytes_to_drop;
 }
 
 /**
@@ -690,7 +716,8 @@ session_enqueue_chain_tail (session_t *s, vlib_buffer_t *b, u32 offset,
       if (offset)
 	{
 	  diff = offset - b->current_length;
-	  if (diff > b->total_length_not_including_first_buffer)
+	  if (diff >
+	      vlib_buffer_cold (b)->total_length_not_including_first_buffer)
 	    return 0;
 	  chain_b = b;
 	  session_enqueue_discard_chain_bytes (wrk->vm, b, &chain_b, diff);
@@ -755,6 +782,36 @@ session_enqueue_chain_tail (session_t *s, vlib_buffer_t *b, u32 offset,
     }
 }
 
+/**
+ * Enqueue in order buffer chain, including first buffer, with one fifo tail
+ * update. Out-of-order data is collected once the whole chain is written.
+ */
+always_inline int
+session_enqueue_chain (session_t *s, vlib_buffer_t *b)
+{
+  session_worker_t *wrk = session_main_get_worker (s->thread_index);
+  svm_fifo_seg_t *seg;
+  int written;
+
+  while (1)
+    {
+      vec_add2 (wrk->rx_segs, seg, 1);
+      seg->data = vlib_buffer_get_current (b);
+      seg->len = b->current_length;
+      if (!(b->flags & VLIB_BUFFER_NEXT_PRESENT))
+	break;
+      b = vlib_get_buffer (wrk->vm, b->next_buffer);
+    }
+
+  written = svm_fifo_enqueue_segments (s->rx_fifo, wrk->rx_segs,
+				       vec_len (wrk->rx_segs),
+				       1 /* allow partial*/);
+
+  vec_reset_length (wrk->rx_segs);
+
+  return written;
+}
+
 /*
  * Enqueue data for delivery to app. If requested, it queues app notification
  * event for later delivery.
@@ -774,22 +831,17 @@ session_enqueue_stream_connection (transport_connection_t *tc,
 				   u8 queue_event, u8 is_in_order)
 {
   session_t *s;
-  int enqueued = 0, rv, in_order_off;
+  int enqueued = 0, rv;
 
   s = session_get (tc->s_index, tc->thread_index);
 
   if (is_in_order)
     {
-      enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
-				   vlib_buffer_get_current (b));
-      if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_NEXT_PRESENT) &&
-			 enqueued >= 0))
-	{
-	  in_order_off = enqueued > b->current_length ? enqueued : 0;
-	  rv = session_enqueue_chain_tail (s, b, in_order_off, 1);
-	  if (rv > 0)
-	    enqueued += rv;
-	}
+      if (PREDICT_FALSE (b->flags & VLIB_BUFFER_NEXT_PRESENT))
+	enqueued = session_enqueue_chain (s, b);
+      else
+	enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
+				     vlib_buffer_get_current (b));
     }
   else
     {
@@ -1030,7 +1030,9 @@ show_session_stats_fn (vlib_main_t *vm, unformat_input_t *input,
 {
   session_main_t *smm = &session_main;
   session_worker_t *wrk;
+  session_wrk_stats_t *st;
   unsigned int *e;
+  u64 n_copies;
 
   if (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     return clib_error_return (0, "unknown input `%U'", format_unformat_error,
@@ -1045,6 +1047,21 @@ show_session_stats_fn (vlib_main_t *vm, unformat_input_t *input,
     vlib_cli_output (vm, " %lu %s", e[SESSION_EP_##name], str);
       foreach_session_error
 #undef _
+      if (wrk->n_pacer_parked)
+	vlib_cli_output (vm, " %u of %u io events parked waiting for tx credit",
+			 wrk->n_pacer_parked,
+			 /* less the list heads */
+			 (u32) clib_llist_elts (wrk->event_elts) - 5);
+      st = &wrk->stats;
+      n_copies = st->n_dma_copies + st->n_cpu_copies;
+      if (n_copies)
+	vlib_cli_output (
+	  vm, " %lu of %lu tx copies offloaded to dma (%.1f%%), %lu of %lu"
+	  " bytes (%.1f%%)", st->n_dma_copies, n_copies,
+	  100.0 * st->n_dma_copies / n_copies, st->n_dma_copy_bytes,
+	  st->n_dma_copy_bytes + st->n_cpu_copy_bytes,
+	  100.0 * st->n_dma_copy_bytes /
+	    (st->n_dma_copy_bytes + st->n_cpu_copy_bytes));
     }
   return 0;
 }
@@ -101,6 +101,8 @@ app_worker_flush_events_inline (app_worker_t *app_wrk,
 	  app_worker_set_mq_wrk_congested (app_wrk, thread_index);
 	  return 0;
 	}
+      /* publish all events to the app with one update of the mq */
+      svm_msg_q_burst_start (mq);
     }
 
   for (i = 0; i < n_evts; i++)
@@ -290,6 +292,7 @@ app_worker_flush_events_inline (app_worker_t *app_wrk,
 
   if (!is_builtin)
     {
+      svm_msg_q_burst_end (mq);
       svm_msg_q_unlock (mq);
       if (mq_is_cong && i == n_evts)
 	app_worker_unset_wrk_mq_congested (app_wrk, thread_index);
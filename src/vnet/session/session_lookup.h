@@ -31,10 +31,47 @@ typedef enum session_lookup_result_
   SESSION_LOOKUP_RESULT_FILTERED
 } session_lookup_result_t;
 
+/** Key of one ip4 connection lookup in a batch, in network byte order */
+typedef struct session_lookup_key4_
+{
+  ip4_address_t lcl;
+  ip4_address_t rmt;
+  u16 lcl_port;
+  u16 rmt_port;
+  u32 fib_index;
+} session_lookup_key4_t;
+
+#ifndef SESSION_LOOKUP_CACHE_LOG2_SIZE
+#define SESSION_LOOKUP_CACHE_LOG2_SIZE 10
+#endif
+#define SESSION_LOOKUP_CACHE_SIZE (1 << SESSION_LOOKUP_CACHE_LOG2_SIZE)
+
+/** Established ip4 connection remembered by a worker's lookup cache */
+typedef struct session_lookup_cache_entry_
+{
+  u64 key[2];
+  u64 handle;
+  u32 table_index; /**< ~0 if the entry is free */
+  u32 connection_index;
+} session_lookup_cache_entry_t;
+
+/** Direct mapped cache of the established connections owned by a worker,
+ *  checked by batched lookups before the session table */
+typedef struct session_lookup_cache_
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  session_lookup_cache_entry_t *entries;
+  u64 hits;
+  u64 misses;
+} session_lookup_cache_t;
+
 typedef struct session_lookup_main_
 {
   clib_spinlock_t st_alloc_lock;
   fib_source_t fib_src;
+
+  /** Per worker established connection caches */
+  session_lookup_cache_t *caches;
 } session_lookup_main_t;
 
 session_t *session_lookup_safe4 (u32 fib_index, ip4_address_t * lcl,
@@ -46,6 +83,11 @@ session_t *session_lookup_safe6 (u32 fib_index, ip6_address_t * lcl,
 transport_connection_t *session_lookup_connection_wt4 (
   u32 fib_index, ip4_address_t *lcl, ip4_address_t *rmt, u16 lcl_port,
   u16 rmt_port, u8 proto, clib_thread_index_t thread_index, u8 *is_filtered);
+void session_lookup_connection_wt4_batch (session_lookup_key4_t *keys,
+					  u8 proto,
+					  clib_thread_index_t thread_index,
+					  transport_connection_t **tcs,
+					  u8 *results, u32 n_keys);
 transport_connection_t *session_lookup_connection4 (u32 fib_index,
 						    ip4_address_t * lcl,
 						    ip4_address_t * rmt,
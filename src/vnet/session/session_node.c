@@ -980,8 +980,19 @@ session_tx_copy_data (session_worker_t *wrk, session_tx_context_t *ctx,
   if (PREDICT_TRUE (!wrk->dma_enabled))
     n_bytes_read =
       svm_fifo_peek (ctx->s->tx_fifo, ctx->sp.tx_offset, len_to_deq, data0);
+  else if (len_to_deq < wrk->dma_min_copy_size)
+    {
+      n_bytes_read = svm_fifo_peek (ctx->s->tx_fifo, ctx->sp.tx_offset,
+				    len_to_deq, data0);
+      wrk->stats.n_cpu_copies++;
+      wrk->stats.n_cpu_copy_bytes += n_bytes_read;
+    }
   else
-    n_bytes_read = session_tx_fill_dma_transfers (wrk, ctx, b);
+    {
+      n_bytes_read = session_tx_fill_dma_transfers (wrk, ctx, b);
+      wrk->stats.n_dma_copies++;
+      wrk->stats.n_dma_copy_bytes += n_bytes_read;
+    }
   return n_bytes_read;
 }
 
@@ -993,9 +1004,20 @@ session_tx_copy_data_tail (session_worker_t *wrk, session_tx_context_t *ctx,
   if (PREDICT_TRUE (!wrk->dma_enabled))
     n_bytes_read =
       svm_fifo_peek (ctx->s->tx_fifo, ctx->sp.tx_offset, len_to_deq, data);
+  else if (len_to_deq < wrk->dma_min_copy_size)
+    {
+      n_bytes_read = svm_fifo_peek (ctx->s->tx_fifo, ctx->sp.tx_offset,
+				    len_to_deq, data);
+      wrk->stats.n_cpu_copies++;
+      wrk->stats.n_cpu_copy_bytes += n_bytes_read;
+    }
   else
-    n_bytes_read =
-      session_tx_fill_dma_transfers_tail (wrk, ctx, b, len_to_deq, data);
+    {
+      n_bytes_read =
+	session_tx_fill_dma_transfers_tail (wrk, ctx, b, len_to_deq, data);
+      wrk->stats.n_dma_copies++;
+      wrk->stats.n_dma_copy_bytes += n_bytes_read;
+    }
   return n_bytes_read;
 }
 
@@ -1004,28 +1026,23 @@ session_tx_fifo_chain_tail (session_worker_t *wrk, session_tx_context_t *ctx,
 			    vlib_buffer_t *b, u16 *n_bufs, u8 peek_data)
 {
   vlib_main_t *vm = wrk->vm;
-  vlib_buffer_t *chain_b, *prev_b;
-  u32 chain_bi0, to_deq, left_from_seg;
+  vlib_buffer_chain_builder_t cb;
+  u32 to_deq, left_from_seg;
   int len_to_deq, n_bytes_read;
   u8 *data, j;
 
-  b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_chain_builder_init (&cb, b);
 
-  chain_b = b;
   left_from_seg = clib_min (ctx->sp.snd_mss - b->current_length,
 			    ctx->left_to_snd);
   to_deq = left_from_seg;
   for (j = 1; j < ctx->n_bufs_per_seg; j++)
     {
-      prev_b = chain_b;
       len_to_deq = clib_min (to_deq, ctx->deq_per_buf);
 
       *n_bufs -= 1;
-      chain_bi0 = ctx->tx_buffers[*n_bufs];
-      chain_b = vlib_get_buffer (vm, chain_bi0);
-      chain_b->current_data = 0;
-      data = vlib_buffer_get_current (chain_b);
+      data = vlib_buffer_chain_builder_add_segment (vm, &cb,
+						    ctx->tx_buffers[*n_bufs]);
       if (peek_data)
 	{
 	  n_bytes_read =
@@ -1066,22 +1083,15 @@ session_tx_fifo_chain_tail (session_worker_t *wrk, session_tx_context_t *ctx,
 					     len_to_deq, data);
 	}
       ASSERT (n_bytes_read == len_to_deq);
-      chain_b->current_length = n_bytes_read;
-      b->total_length_not_including_first_buffer += chain_b->current_length;
-
-      /* update previous buffer */
-      prev_b->next_buffer = chain_bi0;
-      prev_b->flags |= VLIB_BUFFER_NEXT_PRESENT;
-
-      /* update current buffer */
-      chain_b->next_buffer = 0;
+      vlib_buffer_chain_builder_increase_length (&cb, n_bytes_read);
 
       to_deq -= n_bytes_read;
       if (to_deq == 0)
 	break;
     }
-  ASSERT (to_deq == 0
-	  && b->total_length_not_including_first_buffer == left_from_seg);
+  ASSERT (to_deq == 0 &&
+	  vlib_buffer_cold (b)->total_length_not_including_first_buffer ==
+	    left_from_seg);
   ctx->left_to_snd -= left_from_seg;
 }
 
@@ -1379,6 +1389,34 @@ session_tx_maybe_reschedule (session_worker_t * wrk,
     }
 }
 
+/**
+ * Park the io event of a paced session that has no tx credit on the pacer
+ * wheel, until it can send again, instead of polling it every dispatch.
+ */
+static void
+session_tx_pacer_park (session_worker_t *wrk, session_tx_context_t *ctx,
+		       session_evt_elt_t *elt)
+{
+  clib_us_time_t wait_us;
+  u32 n_ticks;
+
+  wait_us = transport_connection_tx_pacer_time_to_burst (ctx->tc);
+  n_ticks = wait_us * CLIB_US_TIME_PERIOD / SESSION_PACER_TICK;
+  if (!n_ticks)
+    {
+      session_evt_add_head_old (wrk, elt);
+      return;
+    }
+
+  /* Wheel is not advanced while empty, so resync its time base */
+  if (!wrk->n_pacer_parked)
+    wrk->pacer_wheel.last_run_time = wrk->last_vlib_time;
+
+  tw_timer_start_1t_3w_1024sl_ov (&wrk->pacer_wheel, elt - wrk->event_elts,
+				  0, n_ticks);
+  wrk->n_pacer_parked += 1;
+}
+
 always_inline void
 session_tx_add_pending_buffer (session_worker_t *wrk, u32 bi, u32 next_index)
 {
@@ -1482,7 +1520,7 @@ session_tx_fifo_read_and_snd_i (session_worker_t * wrk,
       u32 snd_space = transport_connection_tx_pacer_burst (ctx->tc);
       if (snd_space < TRANSPORT_PACER_MIN_BURST)
 	{
-	  session_evt_add_head_old (wrk, elt);
+	  session_tx_pacer_park (wrk, ctx, elt);
 	  return SESSION_TX_NO_DATA;
 	}
       snd_space = clib_min (ctx->sp.snd_space, snd_space);
@@ -1950,6 +1988,28 @@ session_wrk_update_state (session_worker_t *wrk)
     }
 }
 
+/**
+ * Move the io events of paced sessions that got tx credit back to the head
+ * of the old events list.
+ */
+static void
+session_wrk_pacer_expire (session_worker_t *wrk)
+{
+  session_evt_elt_t *elt;
+  u32 *ei;
+
+  vec_reset_length (wrk->pacer_expired);
+  wrk->pacer_expired = tw_timer_expire_timers_vec_1t_3w_1024sl_ov (
+    &wrk->pacer_wheel, wrk->last_vlib_time, wrk->pacer_expired);
+
+  vec_foreach (ei, wrk->pacer_expired)
+    {
+      elt = clib_llist_elt (wrk->event_elts, *ei);
+      session_evt_add_head_old (wrk, elt);
+    }
+  wrk->n_pacer_parked -= vec_len (wrk->pacer_expired);
+}
+
 static uword
 session_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 		       vlib_frame_t * frame)
@@ -2007,6 +2067,9 @@ session_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 
   SESSION_EVT (SESSION_EVT_DSP_CNTRS, CTRL_EVTS, wrk);
 
+  if (wrk->n_pacer_parked)
+    session_wrk_pacer_expire (wrk);
+
   /*
    * Handle the new io events.
    */
@@ -856,6 +856,22 @@ spacer_max_burst (spacer_t * pacer, clib_us_time_t time_now)
   return pacer->bucket >= 0 ? pacer->max_burst : 0;
 }
 
+static inline clib_us_time_t
+spacer_time_to_burst (spacer_t *pacer, clib_us_time_t time_now)
+{
+  f64 n_periods;
+  u64 elapsed;
+
+  if (pacer->bucket >= 0 || pacer->tokens_per_period == 0)
+    return 0;
+
+  /* Periods needed to pay off the debt, less those not yet credited */
+  n_periods = (f64) -pacer->bucket / pacer->tokens_per_period;
+  elapsed = time_now - pacer->last_update;
+
+  return n_periods > elapsed ? (clib_us_time_t) n_periods - elapsed + 1 : 0;
+}
+
 static inline void
 spacer_update_bucket (spacer_t * pacer, u32 bytes)
 {
@@ -951,6 +967,13 @@ transport_connection_tx_pacer_rate (transport_connection_t * tc)
   return spacer_pace_rate (&tc->pacer);
 }
 
+clib_us_time_t
+transport_connection_tx_pacer_time_to_burst (transport_connection_t *tc)
+{
+  return spacer_time_to_burst (&tc->pacer,
+			       transport_us_time_now (tc->thread_index));
+}
+
 void
 transport_connection_update_tx_bytes (transport_connection_t * tc, u32 bytes)
 {
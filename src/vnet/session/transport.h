@@ -316,6 +316,15 @@ u32 transport_connection_tx_pacer_burst (transport_connection_t * tc);
  */
 u64 transport_connection_tx_pacer_rate (transport_connection_t * tc);
 
+/**
+ * Get time until the tx pacer allows a new burst
+ *
+ * @param tc		transport connection
+ * @return		wait time in us, 0 if a burst can be sent now
+ */
+clib_us_time_t
+transport_connection_tx_pacer_time_to_burst (transport_connection_t *tc);
+
 /**
  * Reset tx pacer bucket
  *
@@ -37,6 +37,8 @@ format_span_trace (u8 * s, va_list * args)
   s = format (s, "SPAN: mirrored %U -> %U",
 	      format_vnet_sw_if_index_name, vnm, t->src_sw_if_index,
 	      format_vnet_sw_if_index_name, vnm, t->mirror_sw_if_index);
+  if (t->truncate)
+    s = format (s, " truncated to %u", t->truncate);
 
   return s;
 }
@@ -58,6 +60,58 @@ static char *span_error_strings[] = {
 #undef _
 };
 
+static_always_inline u16
+span_dst_truncate (span_main_t * sm, u32 dst_sw_if_index, u32 len)
+{
+  u16 truncate = 0;
+
+  if (dst_sw_if_index < vec_len (sm->dst_truncate))
+    truncate = sm->dst_truncate[dst_sw_if_index];
+
+  /* no point in truncating what fits anyway */
+  return truncate < len ? truncate : 0;
+}
+
+/* copy only the first n_bytes of the packet into a single buffer */
+static_always_inline vlib_buffer_t *
+span_buffer_copy_truncated (vlib_main_t * vm, vlib_buffer_t * b, u32 n_bytes)
+{
+  vlib_buffer_t *d;
+  u32 di, n_left, n;
+  u8 *p;
+
+  if (vlib_buffer_alloc (vm, &di, 1) != 1)
+    return 0;
+
+  d = vlib_get_buffer (vm, di);
+  d->current_data = b->current_data;
+  n_left = clib_min (n_bytes, vlib_buffer_get_default_data_size (vm) -
+			      (i32) d->current_data);
+  d->current_length = n_left;
+  d->flags = b->flags & VLIB_BUFFER_COPY_CLONE_FLAGS_MASK &
+	     ~(VLIB_BUFFER_NEXT_PRESENT | VLIB_BUFFER_TOTAL_LENGTH_VALID |
+	       VNET_BUFFER_F_OFFLOAD | VNET_BUFFER_F_GSO);
+  clib_memcpy_fast (d->opaque, b->opaque, sizeof (b->opaque));
+  clib_memcpy_fast (vlib_buffer_cold (d)->opaque2,
+		    vlib_buffer_cold (b)->opaque2,
+		    STRUCT_SIZE_OF (vlib_buffer_cold_t, opaque2));
+
+  p = vlib_buffer_get_current (d);
+  while (1)
+    {
+      n = clib_min (n_left, b->current_length);
+      clib_memcpy_fast (p, vlib_buffer_get_current (b), n);
+      n_left -= n;
+      p += n;
+      if (n_left == 0 || (b->flags & VLIB_BUFFER_NEXT_PRESENT) == 0)
+	break;
+      b = vlib_get_buffer (vm, b->next_buffer);
+    }
+  d->current_length -= n_left;
+
+  return d;
+}
+
 static_always_inline void
 span_mirror (vlib_main_t * vm, vlib_node_runtime_t * node, u32 sw_if_index0,
 	     vlib_buffer_t * b0, vlib_frame_t ** mirror_frames,
@@ -67,7 +121,9 @@ span_mirror (vlib_main_t * vm, vlib_node_runtime_t * node, u32 sw_if_index0,
   span_main_t *sm = &span_main;
   vnet_main_t *vnm = vnet_get_main ();
   u32 *to_mirror_next = 0;
-  u32 i;
+  u32 i, len0, n_full = 0, n_cloned = 0, n_used = 0;
+  u32 **clones;
+  u16 truncate;
   span_interface_t *si0;
   span_mirror_t *sm0;
 
@@ -84,21 +140,57 @@ span_mirror (vlib_main_t * vm, vlib_node_runtime_t * node, u32 sw_if_index0,
   if (PREDICT_FALSE (b0->flags & VNET_BUFFER_F_SPAN_CLONE))
     return;
 
+  len0 = vlib_buffer_length_in_chain (vm, b0);
   clib_bitmap_foreach (i, sm0->mirror_ports)
+    if (span_dst_truncate (sm, i, len0) == 0)
+      n_full++;
+
+  /*
+   * Destinations that get the full packet share a single copy: each
+   * one gets its own head buffer and the payload is reference counted.
+   */
+  clones = vec_elt_at_index (sm->clones, vm->thread_index);
+  if (n_full)
     {
-      if (mirror_frames[i] == 0)
-        {
-          if (sf == SPAN_FEAT_L2)
-            mirror_frames[i] = vlib_get_frame_to_node (vm, l2output_node.index);
-          else
-            mirror_frames[i] = vnet_get_frame_to_sw_interface (vnm, i);
-	}
-      to_mirror_next = vlib_frame_vector_args (mirror_frames[i]);
-      to_mirror_next += mirror_frames[i]->n_vectors;
+      vec_validate (clones[0], n_full - 1);
       /* This can fail */
       c0 = vlib_buffer_copy (vm, b0);
+      if (PREDICT_TRUE (c0 != 0))
+	{
+	  clones[0][0] = vlib_get_buffer_index (vm, c0);
+	  if (n_full == 1)
+	    n_cloned = 1;
+	  else
+	    {
+	      n_cloned = vlib_buffer_clone (vm, clones[0][0], clones[0],
+					    n_full,
+					    VLIB_BUFFER_CLONE_HEAD_SIZE);
+	      if (n_cloned == 0)
+		vlib_buffer_free_one (vm, vlib_get_buffer_index (vm, c0));
+	    }
+	}
+    }
+
+  clib_bitmap_foreach (i, sm0->mirror_ports)
+    {
+      truncate = span_dst_truncate (sm, i, len0);
+      if (truncate)
+        c0 = span_buffer_copy_truncated (vm, b0, truncate);
+      else if (n_used < n_cloned)
+        c0 = vlib_get_buffer (vm, clones[0][n_used++]);
+      else
+        c0 = 0;
       if (PREDICT_TRUE(c0 != 0))
         {
+          if (mirror_frames[i] == 0)
+            {
+              if (sf == SPAN_FEAT_L2)
+                mirror_frames[i] = vlib_get_frame_to_node (vm, l2output_node.index);
+              else
+                mirror_frames[i] = vnet_get_frame_to_sw_interface (vnm, i);
+            }
+          to_mirror_next = vlib_frame_vector_args (mirror_frames[i]);
+          to_mirror_next += mirror_frames[i]->n_vectors;
           vnet_buffer (c0)->sw_if_index[VLIB_TX] = i;
           c0->flags |= VNET_BUFFER_F_SPAN_CLONE;
           if (sf == SPAN_FEAT_L2)
@@ -110,6 +202,7 @@ span_mirror (vlib_main_t * vm, vlib_node_runtime_t * node, u32 sw_if_index0,
               span_trace_t *t = vlib_add_trace (vm, node, b0, sizeof (*t));
               t->src_sw_if_index = sw_if_index0;
               t->mirror_sw_if_index = i;
+              t->truncate = truncate;
 #if 0
 	      /* Enable this path to allow packet trace of SPAN packets.
 	         Note that all SPAN packets will show up on the trace output
@@ -330,6 +423,8 @@ clib_error_t *span_init (vlib_main_t * vm)
   sm->vlib_main = vm;
   sm->vnet_main = vnet_get_main ();
 
+  vec_validate (sm->clones, vlib_num_workers ());
+
   /* Initialize the feature next-node indexes */
   feat_bitmap_init_next_nodes (vm,
 			       span_l2_input_node.index,
@@ -110,6 +110,20 @@ span_add_delete_entry (vlib_main_t * vm,
   return 0;
 }
 
+int
+span_set_truncate (u32 dst_sw_if_index, u16 truncate)
+{
+  span_main_t *sm = &span_main;
+
+  if (dst_sw_if_index == ~0)
+    return VNET_API_ERROR_INVALID_INTERFACE;
+
+  vec_validate (sm->dst_truncate, dst_sw_if_index);
+  sm->dst_truncate[dst_sw_if_index] = truncate;
+
+  return 0;
+}
+
 static uword
 unformat_span_state (unformat_input_t * input, va_list * args)
 {
@@ -138,6 +152,7 @@ set_interface_span_command_fn (vlib_main_t * vm,
   span_feat_t sf = SPAN_FEAT_DEVICE;
   span_state_t state = SPAN_BOTH;
   int state_set = 0;
+  u32 truncate = ~0;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -155,6 +170,11 @@ set_interface_span_command_fn (vlib_main_t * vm,
 	}
       else if (unformat (input, "l2"))
 	sf = SPAN_FEAT_L2;
+      else if (unformat (input, "truncate %u", &truncate))
+	{
+	  if (truncate > 0xffff)
+	    return clib_error_return (0, "truncate length too large");
+	}
       else
 	return clib_error_return (0, "Invalid input");
     }
@@ -163,12 +183,14 @@ set_interface_span_command_fn (vlib_main_t * vm,
     span_add_delete_entry (vm, src_sw_if_index, dst_sw_if_index, state, sf);
   if (rv == VNET_API_ERROR_INVALID_INTERFACE)
     return clib_error_return (0, "Invalid interface");
+  if (truncate != ~0 && state != SPAN_DISABLE)
+    span_set_truncate (dst_sw_if_index, truncate);
   return 0;
 }
 
 VLIB_CLI_COMMAND (set_interface_span_command, static) = {
   .path = "set interface span",
-  .short_help = "set interface span <if-name> [l2] {disable | destination <if-name> [both|rx|tx]}",
+  .short_help = "set interface span <if-name> [l2] {disable | destination <if-name> [both|rx|tx] [truncate <nn>]}",
   .function = set_interface_span_command_fn,
 };
 
@@ -219,9 +241,17 @@ show_interfaces_span_command_fn (vlib_main_t * vm,
 	    int l2 = (clib_bitmap_get (lrxm->mirror_ports, i) +
 		      clib_bitmap_get (ltxm->mirror_ports, i) * 2);
 
-	    vlib_cli_output (vm, "%-32v %-32U (%6s) (%6s)", s,
-			     format_vnet_sw_if_index_name, vnm, i,
-			     states[device], states[l2]);
+	    u16 truncate = i < vec_len (sm->dst_truncate) ?
+			     sm->dst_truncate[i] : 0;
+
+	    if (truncate)
+	      vlib_cli_output (vm, "%-32v %-32U (%6s) (%6s)  truncate %u", s,
+			       format_vnet_sw_if_index_name, vnm, i,
+			       states[device], states[l2], truncate);
+	    else
+	      vlib_cli_output (vm, "%-32v %-32U (%6s) (%6s)", s,
+			       format_vnet_sw_if_index_name, vnm, i,
+			       states[device], states[l2]);
 	    vec_reset_length (s);
 	  }
 	clib_bitmap_free (b);
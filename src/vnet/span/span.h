@@ -50,6 +50,12 @@ typedef struct
   /* biggest sw_if_index used so far */
   u32 max_sw_if_index;
 
+  /* per destination truncation length, 0 mirrors the full packet */
+  u16 *dst_truncate;
+
+  /* per-thread clone vectors */
+  u32 **clones;
+
   /* convenience */
   vlib_main_t *vlib_main;
   vnet_main_t *vnet_main;
@@ -63,6 +69,7 @@ typedef struct
 {
   u32 src_sw_if_index;		/* mirrored interface index */
   u32 mirror_sw_if_index;	/* output interface index */
+  u16 truncate;			/* mirrored bytes, 0 for the full packet */
 } span_trace_t;
 
 #endif /* __span_h__ */
@@ -70,6 +77,7 @@ typedef struct
 int
 span_add_delete_entry (vlib_main_t * vm, u32 src_sw_if_index,
 		       u32 dst_sw_if_index, u8 state, span_feat_t sf);
+int span_set_truncate (u32 dst_sw_if_index, u16 truncate);
 /*
  * fd.io coding-style-patch-verification: ON
  *
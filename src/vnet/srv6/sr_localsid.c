@@ -1100,6 +1100,66 @@ end_un_processing (vlib_node_runtime_t *node, vlib_buffer_t *b0,
   return;
 }
 
+/**
+ * @brief Last forwarding resolution of a shifted uSID destination.
+ *
+ * Only kept for one frame, FIB updates happen between frames.
+ */
+typedef struct
+{
+  ip6_address_t dst;
+  u32 fib_index;
+  u32 lbi;
+  u32 adj_index;
+} sr_un_fwd_cache_t;
+
+/**
+ * @brief Send a shifted uSID packet straight to ip6-rewrite
+ *
+ * When the new destination resolves to a single unicast adjacency the
+ * ip6-lookup visit is skipped. Packets of the frame with the same
+ * destination reuse the previous lookup.
+ */
+static_always_inline void
+end_un_fwd_lookup (vlib_main_t *vm, vlib_buffer_t *b0, ip6_header_t *ip0,
+		   sr_un_fwd_cache_t *c, u32 *next0)
+{
+  ip6_main_t *im = &ip6_main;
+  const load_balance_t *lb0;
+  const dpo_id_t *dpo0;
+
+  if (PREDICT_FALSE (ip0->protocol == IP_PROTOCOL_IP6_HOP_BY_HOP_OPTIONS))
+    return;
+
+  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, b0);
+
+  if (c->fib_index != vnet_buffer (b0)->ip.fib_index ||
+      !ip6_address_is_equal (&c->dst, &ip0->dst_address))
+    {
+      c->fib_index = vnet_buffer (b0)->ip.fib_index;
+      c->dst = ip0->dst_address;
+      c->lbi = ip6_fib_table_fwding_lookup (c->fib_index, &c->dst);
+      c->adj_index = ADJ_INDEX_INVALID;
+
+      lb0 = load_balance_get (c->lbi);
+      dpo0 = load_balance_get_bucket_i (lb0, 0);
+      if (lb0->lb_n_buckets == 1 && dpo0->dpoi_type == DPO_ADJACENCY &&
+	  adj_get (dpo0->dpoi_index)->lookup_next_index ==
+	    IP_LOOKUP_NEXT_REWRITE)
+	c->adj_index = dpo0->dpoi_index;
+    }
+
+  if (ADJ_INDEX_INVALID == c->adj_index)
+    return;
+
+  vnet_buffer (b0)->ip.flow_hash = 0;
+  vnet_buffer (b0)->ip.adj_index[VLIB_TX] = c->adj_index;
+  vlib_increment_combined_counter (&load_balance_main.lbm_to_counters,
+				   vm->thread_index, c->lbi, 1,
+				   vlib_buffer_length_in_chain (vm, b0));
+  *next0 = SR_LOCALSID_NEXT_IP6_REWRITE;
+}
+
 /*
  * @brief Function doing SRH processing for D* variants
  */
@@ -2117,6 +2177,7 @@ sr_localsid_un_perf_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
   n_left_from = from_frame->n_vectors;
   next_index = node->cached_next_index;
   clib_thread_index_t thread_index = vm->thread_index;
+  sr_un_fwd_cache_t fwd_cache = { .fib_index = ~0 };
 
   while (n_left_from > 0)
     {
@@ -2191,6 +2252,15 @@ sr_localsid_un_perf_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  end_un_processing (node, b2, ip2, ls2, &next2);
 	  end_un_processing (node, b3, ip3, ls3, &next3);
 
+	  if (next0 == SR_LOCALSID_NEXT_IP6_LOOKUP)
+	    end_un_fwd_lookup (vm, b0, ip0, &fwd_cache, &next0);
+	  if (next1 == SR_LOCALSID_NEXT_IP6_LOOKUP)
+	    end_un_fwd_lookup (vm, b1, ip1, &fwd_cache, &next1);
+	  if (next2 == SR_LOCALSID_NEXT_IP6_LOOKUP)
+	    end_un_fwd_lookup (vm, b2, ip2, &fwd_cache, &next2);
+	  if (next3 == SR_LOCALSID_NEXT_IP6_LOOKUP)
+	    end_un_fwd_lookup (vm, b3, ip3, &fwd_cache, &next3);
+
 	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
 	      sr_localsid_trace_t *tr =
@@ -2279,6 +2349,9 @@ sr_localsid_un_perf_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  /* SRH processing */
 	  end_un_processing (node, b0, ip0, ls0, &next0);
 
+	  if (next0 == SR_LOCALSID_NEXT_IP6_LOOKUP)
+	    end_un_fwd_lookup (vm, b0, ip0, &fwd_cache, &next0);
+
 	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
 	      sr_localsid_trace_t *tr =
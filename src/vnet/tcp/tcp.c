@@ -266,7 +266,7 @@ tcp_connection_cleanup (tcp_connection_t * tc)
       vec_free (tc->snd_sacks);
       vec_free (tc->snd_sacks_fl);
       vec_free (tc->rcv_opts.sacks);
-      pool_free (tc->sack_sb.holes);
+      scoreboard_free (&tc->sack_sb);
 
       if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
 	tcp_bt_cleanup (tc);
@@ -530,10 +530,20 @@ void
 tcp_connection_timers_reset (tcp_connection_t * tc)
 {
   tcp_worker_ctx_t *wrk = tcp_get_worker (tc->c_thread_index);
+  u32 handles[TCP_N_TIMERS], n_handles = 0;
   int i;
 
+  ASSERT (tcp_timer_thread_is_valid (tc));
+
   for (i = 0; i < TCP_N_TIMERS; i++)
-    tcp_timer_reset (&wrk->timer_wheel, tc, i);
+    if (tc->timers[i] != TCP_TIMER_HANDLE_INVALID)
+      {
+	handles[n_handles++] = tc->timers[i];
+	tc->timers[i] = TCP_TIMER_HANDLE_INVALID;
+      }
+  tc->pending_timers = 0;
+
+  tw_timer_stop_batch_tcp_twsl (&wrk->timer_wheel, handles, n_handles);
 }
 
 #if 0
@@ -752,6 +762,14 @@ tcp_connection_init_vars (tcp_connection_t * tc)
   if (tc->state == TCP_STATE_SYN_RCVD)
     tcp_init_snd_vars (tc);
 
+  /* Rack needs per segment tx times from the byte tracker */
+  if (tcp_cfg.enable_rack_tlp)
+    tc->cfg_flags |= TCP_CFG_F_RACK_TLP | TCP_CFG_F_RATE_SAMPLE;
+
+  /* Before cc init, algorithms may rely on or enable rate sampling */
+  if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
+    tcp_bt_init (tc);
+
   tcp_cc_init (tc);
 
   if (!tc->c_is_ip4 && ip6_address_is_link_local_unicast (&tc->c_rmt_ip6))
@@ -763,9 +781,6 @@ tcp_connection_init_vars (tcp_connection_t * tc)
       || tcp_cfg.enable_tx_pacing)
     tcp_enable_pacing (tc);
 
-  if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
-    tcp_bt_init (tc);
-
   if (!tcp_cfg.allow_tso)
     tc->cfg_flags |= TCP_CFG_F_NO_TSO;
 
@@ -1029,13 +1044,17 @@ tcp_session_attribute (u32 conn_index, clib_thread_index_t thread_index,
     return tcp_set_attribute (tc, attr);
 }
 
-static u16
+u16
 tcp_session_cal_goal_size (tcp_connection_t * tc)
 {
-  u16 goal_size = tc->snd_mss;
+  u32 goal_size;
 
-  goal_size = tcp_cfg.max_gso_size - tc->snd_mss % tcp_cfg.max_gso_size;
+  /* Largest multiple of mss that fits in a gso super-segment. Anything
+   * else leaves a runt segment at the end of every super-segment */
+  goal_size = clib_min (tcp_cfg.max_gso_size,
+			TCP_MAX_GSO_SZ - TRANSPORT_MAX_HDRS_LEN);
   goal_size = clib_min (goal_size, tc->snd_wnd / 2);
+  goal_size -= goal_size % tc->snd_mss;
 
   return goal_size > tc->snd_mss ? goal_size : tc->snd_mss;
 }
@@ -49,6 +49,7 @@ typedef struct _tcp_lookup_dispatch
 #define foreach_tcp_wrk_stat                                                  \
   _ (timer_expirations, u64, "timer expirations")                             \
   _ (rxt_segs, u64, "segments retransmitted")                                 \
+  _ (tlp_segs, u64, "tail loss probes")                                       \
   _ (tr_events, u32, "timer retransmit events")                               \
   _ (to_establish, u32, "timeout establish")                                  \
   _ (to_persist, u32, "timeout persist")                                      \
@@ -166,6 +167,9 @@ typedef struct tcp_configuration_
   /** Allow use of TSO whenever available */
   u8 allow_tso;
 
+  /** Use RACK-TLP loss detection for new sack connections */
+  u8 enable_rack_tlp;
+
   /** Set if csum offloading is enabled */
   u8 csum_offload;
 
@@ -340,6 +344,8 @@ void tcp_connection_timers_init (tcp_connection_t * tc);
 void tcp_connection_timers_reset (tcp_connection_t * tc);
 void tcp_init_snd_vars (tcp_connection_t * tc);
 void tcp_connection_init_vars (tcp_connection_t * tc);
+void tcp_enable_pacing (tcp_connection_t * tc);
+u16 tcp_session_cal_goal_size (tcp_connection_t *tc);
 void tcp_connection_tx_pacer_update (tcp_connection_t * tc);
 void tcp_connection_tx_pacer_reset (tcp_connection_t * tc, u32 window,
 				    u32 start_bucket);
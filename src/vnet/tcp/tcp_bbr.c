@@ -0,0 +1,775 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+/*
+ * BBR congestion control, following the BBRv3 state machine described in
+ * draft-ietf-ccwg-bbr.
+ *
+ * The path model is a windowed max of the delivery rate measured by the
+ * byte tracker (tcp_bt) and a windowed min of the rtt. Data is paced at a
+ * gain times the bandwidth estimate and cwnd caps inflight at a gain times
+ * the estimated bdp. Loss rates above BBR_LOSS_THRESH while probing bound
+ * inflight from above (inflight_hi), loss while not probing lowers the
+ * short term bounds (bw_lo and inflight_lo).
+ *
+ * Not implemented: ack aggregation (extra_acked) compensation and ecn.
+ */
+
+#include <vnet/tcp/tcp.h>
+#include <vnet/tcp/tcp_inlines.h>
+#include <vppinfra/random.h>
+
+#define BBR_STARTUP_PACING_GAIN	   2.77
+#define BBR_STARTUP_CWND_GAIN	   2.0
+#define BBR_DRAIN_PACING_GAIN	   (1 / 2.77)
+#define BBR_CWND_GAIN		   2.0
+#define BBR_PROBE_UP_PACING_GAIN   1.25
+#define BBR_PROBE_UP_CWND_GAIN	   2.25
+#define BBR_PROBE_DOWN_PACING_GAIN 0.9
+#define BBR_PROBE_RTT_CWND_GAIN	   0.5
+#define BBR_PACING_MARGIN	   0.01
+#define BBR_LOSS_THRESH		   0.02
+#define BBR_BETA		   0.7
+#define BBR_HEADROOM		   0.15
+#define BBR_FULL_BW_THRESH	   1.25
+#define BBR_FULL_BW_COUNT	   3
+#define BBR_MIN_PIPE_CWND_SEGS	   4
+#define BBR_MIN_RTT_FILTER_LEN	   10.0 /* seconds */
+#define BBR_PROBE_RTT_INTERVAL	   5.0	/* seconds */
+#define BBR_PROBE_RTT_DURATION	   0.2	/* seconds */
+#define BBR_MAX_SEND_QUANTUM	   (64 << 10)
+#define BBR_RTT_UNKNOWN		   1e9
+#define BBR_UNBOUNDED		   ((u32) ~0)
+#define BBR_BW_UNBOUNDED	   ((u64) ~0)
+
+typedef enum bbr_state_
+{
+  BBR_STARTUP,
+  BBR_DRAIN,
+  BBR_PROBE_BW_DOWN,
+  BBR_PROBE_BW_CRUISE,
+  BBR_PROBE_BW_REFILL,
+  BBR_PROBE_BW_UP,
+  BBR_PROBE_RTT,
+} bbr_state_e;
+
+typedef struct bbr_data_
+{
+  u64 max_bw_filter[2]; /**< Max delivery rate of this and last cycle */
+  u64 max_bw;		/**< Windowed max delivery rate (bytes/s) */
+  u64 bw_lo;		/**< Short term bw bound after loss */
+  u64 bw;		/**< Bandwidth used by the model */
+  u64 bw_latest;	/**< Max delivery rate in current round */
+  u64 full_bw;		/**< Bw at last growth check in startup */
+  u64 pacing_rate;	/**< Pacing rate (bytes/s) */
+  u64 next_round_delivered; /**< Delivered that ends current round */
+  f64 min_rtt;		    /**< Windowed min rtt (s) */
+  f64 min_rtt_stamp;	    /**< Time min_rtt was measured */
+  f64 probe_rtt_min_delay;  /**< Min rtt over last probe rtt interval */
+  f64 probe_rtt_min_stamp;  /**< Time probe_rtt_min_delay was measured */
+  f64 probe_rtt_done_stamp; /**< Time probe rtt may end */
+  f64 cycle_stamp;	    /**< Start of current probe bw phase */
+  f64 bw_probe_wait;	    /**< Time to wait before next bw probe */
+  f64 pacing_gain;
+  f64 cwnd_gain;
+  u32 inflight_hi;	     /**< Long term inflight bound after loss */
+  u32 inflight_lo;	     /**< Short term inflight bound after loss */
+  u32 inflight_latest;	     /**< Max delivered per sample this round */
+  u32 prior_cwnd;	     /**< Cwnd before recovery or probe rtt */
+  u32 rounds_since_bw_probe; /**< Rounds since last bw probe */
+  u32 bw_probe_up_cnt;	     /**< Bytes acked per inflight_hi increment */
+  u32 bw_probe_up_acks;	     /**< Bytes acked since last increment */
+  u32 bw_probe_up_rounds;    /**< Rounds spent raising inflight_hi */
+  u32 seed;		     /**< Random seed for probe wait times */
+  u8 state;		     /**< One of bbr_state_e */
+  u8 cycle_count;	     /**< Probe bw cycles, selects filter slot */
+  u8 full_bw_cnt;	     /**< Rounds without bw growth in startup */
+  u8 filled_pipe;	     /**< Startup found the bottleneck bw */
+  u8 round_start;	     /**< Current ack started a new round */
+  u8 loss_in_round;	     /**< Loss seen in current round */
+  u8 probe_rtt_round_done;   /**< Probe rtt lasted at least a round */
+  u8 probe_rtt_expired;	     /**< Probe rtt min delay is stale */
+  u8 idle_restart;	     /**< Sending restarted after idle */
+  u8 bw_probe_samples;	     /**< Samples may reflect a bw probe */
+} bbr_data_t;
+
+STATIC_ASSERT (sizeof (bbr_data_t *) <= TCP_CC_DATA_SZ, "bbr data len");
+
+static inline bbr_data_t *
+bbr_data (tcp_connection_t *tc)
+{
+  return *(bbr_data_t **) tcp_cc_data (tc);
+}
+
+static inline f64
+bbr_time (clib_thread_index_t thread_index)
+{
+  return tcp_time_now_us (thread_index);
+}
+
+static inline u32
+bbr_min_pipe_cwnd (tcp_connection_t *tc)
+{
+  return BBR_MIN_PIPE_CWND_SEGS * tc->snd_mss;
+}
+
+static inline u8
+bbr_is_probing_bw (bbr_data_t *bd)
+{
+  return (bd->state == BBR_STARTUP || bd->state == BBR_PROBE_BW_REFILL ||
+	  bd->state == BBR_PROBE_BW_UP);
+}
+
+static inline u8
+bbr_in_probe_bw (bbr_data_t *bd)
+{
+  return bd->state >= BBR_PROBE_BW_DOWN && bd->state <= BBR_PROBE_BW_UP;
+}
+
+static u32
+bbr_send_quantum (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  /* what can be sent in a millisecond at the current rate */
+  u64 quantum = bd->pacing_rate / 1000;
+  return clib_clamp (quantum, 2 * tc->snd_mss, BBR_MAX_SEND_QUANTUM);
+}
+
+/** Inflight needed to fill the pipe at rate BW, scaled by GAIN */
+static u32
+bbr_inflight (tcp_connection_t *tc, bbr_data_t *bd, u64 bw, f64 gain)
+{
+  u64 inflight;
+
+  if (bd->min_rtt == BBR_RTT_UNKNOWN)
+    return tcp_initial_cwnd (tc);
+
+  inflight = gain * bw * bd->min_rtt;
+
+  /* budget for tso bursts and delayed or stretched acks */
+  inflight = clib_max (inflight, 3 * bbr_send_quantum (tc, bd));
+  inflight = clib_max (inflight, bbr_min_pipe_cwnd (tc));
+  if (bd->state == BBR_PROBE_BW_UP)
+    inflight += 2 * tc->snd_mss;
+
+  return clib_min (inflight, BBR_UNBOUNDED - 1);
+}
+
+static u32
+bbr_inflight_with_headroom (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  u32 headroom;
+
+  if (bd->inflight_hi == BBR_UNBOUNDED)
+    return BBR_UNBOUNDED;
+
+  headroom = clib_max (tc->snd_mss, BBR_HEADROOM * bd->inflight_hi);
+  if (bd->inflight_hi <= headroom)
+    return bbr_min_pipe_cwnd (tc);
+  return clib_max (bd->inflight_hi - headroom, bbr_min_pipe_cwnd (tc));
+}
+
+static u32
+bbr_probe_rtt_cwnd (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  return clib_max (bbr_inflight (tc, bd, bd->bw, BBR_PROBE_RTT_CWND_GAIN),
+		   bbr_min_pipe_cwnd (tc));
+}
+
+static void
+bbr_save_cwnd (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  if (!tcp_in_cong_recovery (tc) && bd->state != BBR_PROBE_RTT)
+    bd->prior_cwnd = tc->cwnd;
+  else
+    bd->prior_cwnd = clib_max (bd->prior_cwnd, tc->cwnd);
+}
+
+static void
+bbr_reset_lower_bounds (bbr_data_t *bd)
+{
+  bd->bw_lo = BBR_BW_UNBOUNDED;
+  bd->inflight_lo = BBR_UNBOUNDED;
+}
+
+static void
+bbr_start_round (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  bd->next_round_delivered = tc->delivered;
+}
+
+static void
+bbr_enter_startup (bbr_data_t *bd)
+{
+  bd->state = BBR_STARTUP;
+  bd->pacing_gain = BBR_STARTUP_PACING_GAIN;
+  bd->cwnd_gain = BBR_STARTUP_CWND_GAIN;
+}
+
+static void
+bbr_pick_probe_wait (bbr_data_t *bd)
+{
+  /* desynchronize flows sharing a bottleneck: probe again after 2 to 3s,
+   * or earlier if reno would've grown into the headroom by then */
+  bd->rounds_since_bw_probe = random_u32 (&bd->seed) & 1;
+  bd->bw_probe_wait = 2.0 + random_f64 (&bd->seed);
+}
+
+static void
+bbr_start_probe_bw_down (tcp_connection_t *tc, bbr_data_t *bd, f64 now)
+{
+  bd->bw_probe_up_cnt = BBR_UNBOUNDED;
+  bd->bw_probe_samples = 0;
+  bbr_pick_probe_wait (bd);
+  bd->cycle_stamp = now;
+  bbr_start_round (tc, bd);
+
+  /* max bw filter covers this and the previous probe cycle */
+  bd->cycle_count++;
+  bd->max_bw_filter[bd->cycle_count & 1] = 0;
+
+  bd->state = BBR_PROBE_BW_DOWN;
+  bd->pacing_gain = BBR_PROBE_DOWN_PACING_GAIN;
+  bd->cwnd_gain = BBR_CWND_GAIN;
+}
+
+static void
+bbr_start_probe_bw_cruise (bbr_data_t *bd)
+{
+  bd->state = BBR_PROBE_BW_CRUISE;
+  bd->pacing_gain = 1.0;
+  bd->cwnd_gain = BBR_CWND_GAIN;
+}
+
+static void
+bbr_start_probe_bw_refill (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  bbr_reset_lower_bounds (bd);
+  bd->bw_probe_up_rounds = 0;
+  bd->bw_probe_up_acks = 0;
+  bd->bw_probe_samples = 1;
+  bbr_start_round (tc, bd);
+  bd->state = BBR_PROBE_BW_REFILL;
+  bd->pacing_gain = 1.0;
+  bd->cwnd_gain = BBR_CWND_GAIN;
+}
+
+static void
+bbr_raise_inflight_hi_slope (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  /* grow inflight_hi by 1, 2, 4 ... segments per round */
+  u32 growth = 1 << bd->bw_probe_up_rounds;
+
+  bd->bw_probe_up_rounds = clib_min (bd->bw_probe_up_rounds + 1, 30);
+  bd->bw_probe_up_cnt = clib_max (tc->cwnd / growth, tc->snd_mss);
+}
+
+static void
+bbr_start_probe_bw_up (tcp_connection_t *tc, bbr_data_t *bd, f64 now)
+{
+  bd->cycle_stamp = now;
+  bbr_start_round (tc, bd);
+  bbr_raise_inflight_hi_slope (tc, bd);
+  bd->state = BBR_PROBE_BW_UP;
+  bd->pacing_gain = BBR_PROBE_UP_PACING_GAIN;
+  bd->cwnd_gain = BBR_PROBE_UP_CWND_GAIN;
+}
+
+static void
+bbr_probe_inflight_hi_upward (tcp_connection_t *tc, bbr_data_t *bd,
+			      tcp_rate_sample_t *rs)
+{
+  u32 delta;
+
+  /* only grow if actually using what we have */
+  if (bd->inflight_hi == BBR_UNBOUNDED ||
+      tcp_flight_size (tc) + tc->snd_mss < tc->cwnd)
+    return;
+
+  bd->bw_probe_up_acks += rs->acked_and_sacked;
+  if (bd->bw_probe_up_acks >= bd->bw_probe_up_cnt)
+    {
+      delta = bd->bw_probe_up_acks / bd->bw_probe_up_cnt;
+      bd->bw_probe_up_acks -= delta * bd->bw_probe_up_cnt;
+      bd->inflight_hi += delta * tc->snd_mss;
+    }
+  if (bd->round_start)
+    bbr_raise_inflight_hi_slope (tc, bd);
+}
+
+static inline u8
+bbr_is_inflight_too_high (tcp_rate_sample_t *rs)
+{
+  return rs->tx_in_flight && rs->lost > rs->tx_in_flight * BBR_LOSS_THRESH;
+}
+
+static void
+bbr_handle_inflight_too_high (tcp_connection_t *tc, bbr_data_t *bd,
+			      tcp_rate_sample_t *rs, f64 now)
+{
+  bd->bw_probe_samples = 0;
+  if (!(rs->flags & TCP_BTS_IS_APP_LIMITED))
+    bd->inflight_hi =
+      clib_max (rs->tx_in_flight,
+		(u64) (bbr_inflight (tc, bd, bd->bw, 1.0) * BBR_BETA));
+  if (bd->state == BBR_PROBE_BW_UP)
+    bbr_start_probe_bw_down (tc, bd, now);
+}
+
+static void
+bbr_update_round (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  bd->round_start = 0;
+  if (rs->prior_time && rs->prior_delivered >= bd->next_round_delivered)
+    {
+      bbr_start_round (tc, bd);
+      bd->rounds_since_bw_probe++;
+      bd->round_start = 1;
+    }
+}
+
+static void
+bbr_update_bw (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u64 bw;
+  u8 slot;
+
+  /* rates measured over less than an rtt are ack compression artifacts */
+  if (!rs->prior_time || rs->interval_time <= 0 ||
+      (bd->min_rtt != BBR_RTT_UNKNOWN && rs->interval_time < bd->min_rtt))
+    return;
+
+  bw = rs->delivered / rs->interval_time;
+  bd->bw_latest = clib_max (bd->bw_latest, bw);
+  bd->inflight_latest = clib_max (bd->inflight_latest, rs->delivered);
+
+  if (bw < bd->max_bw && (rs->flags & TCP_BTS_IS_APP_LIMITED))
+    return;
+
+  slot = bd->cycle_count & 1;
+  bd->max_bw_filter[slot] = clib_max (bd->max_bw_filter[slot], bw);
+  bd->max_bw = clib_max (bd->max_bw_filter[0], bd->max_bw_filter[1]);
+}
+
+static void
+bbr_update_congestion_signals (tcp_connection_t *tc, bbr_data_t *bd,
+			       tcp_rate_sample_t *rs)
+{
+  if (rs->last_lost)
+    bd->loss_in_round = 1;
+
+  if (!bd->round_start)
+    return;
+
+  /* once per round, cut the short term bounds if the round saw loss while
+   * we were not deliberately probing for more bandwidth */
+  if (bd->loss_in_round && !bbr_is_probing_bw (bd))
+    {
+      if (bd->bw_lo == BBR_BW_UNBOUNDED)
+	bd->bw_lo = bd->max_bw;
+      if (bd->inflight_lo == BBR_UNBOUNDED)
+	bd->inflight_lo = tc->cwnd;
+      bd->bw_lo = clib_max (bd->bw_latest, (u64) (BBR_BETA * bd->bw_lo));
+      bd->inflight_lo =
+	clib_max (bd->inflight_latest, (u32) (BBR_BETA * bd->inflight_lo));
+    }
+
+  bd->loss_in_round = 0;
+}
+
+static void
+bbr_check_startup_done (tcp_connection_t *tc, bbr_data_t *bd,
+			tcp_rate_sample_t *rs)
+{
+  if (bd->filled_pipe || bd->state != BBR_STARTUP)
+    return;
+
+  /* too much loss, the pipe is full and the queue is overflowing */
+  if (bbr_is_inflight_too_high (rs))
+    {
+      bd->inflight_hi = clib_max (bbr_inflight (tc, bd, bd->max_bw, 1.0),
+				  bd->inflight_latest);
+      bd->filled_pipe = 1;
+    }
+  /* bw did not grow by 25% for 3 rounds */
+  else if (bd->round_start && !(rs->flags & TCP_BTS_IS_APP_LIMITED))
+    {
+      if (bd->max_bw >= bd->full_bw * BBR_FULL_BW_THRESH)
+	{
+	  bd->full_bw = bd->max_bw;
+	  bd->full_bw_cnt = 0;
+	}
+      else if (++bd->full_bw_cnt >= BBR_FULL_BW_COUNT)
+	bd->filled_pipe = 1;
+    }
+
+  if (bd->filled_pipe)
+    {
+      bd->state = BBR_DRAIN;
+      bd->pacing_gain = BBR_DRAIN_PACING_GAIN;
+      bd->cwnd_gain = BBR_STARTUP_CWND_GAIN;
+    }
+}
+
+static u8
+bbr_check_time_to_probe_bw (tcp_connection_t *tc, bbr_data_t *bd, f64 now)
+{
+  u32 reno_rounds;
+
+  /* probe at least as often as reno would fill the bdp, up to 63 rounds */
+  reno_rounds = bbr_inflight (tc, bd, bd->bw, 1.0) / tc->snd_mss;
+  reno_rounds = clib_min (reno_rounds, 63);
+
+  if (now - bd->cycle_stamp > bd->bw_probe_wait ||
+      bd->rounds_since_bw_probe >= reno_rounds)
+    {
+      bbr_start_probe_bw_refill (tc, bd);
+      return 1;
+    }
+  return 0;
+}
+
+static void
+bbr_update_probe_bw_phase (tcp_connection_t *tc, bbr_data_t *bd,
+			   tcp_rate_sample_t *rs, f64 now)
+{
+  u32 flight = tcp_flight_size (tc);
+
+  if (bd->state == BBR_DRAIN)
+    {
+      if (flight <= bbr_inflight (tc, bd, bd->bw, 1.0))
+	bbr_start_probe_bw_down (tc, bd, now);
+      return;
+    }
+
+  if (!bd->filled_pipe || !bbr_in_probe_bw (bd))
+    return;
+
+  if (bd->bw_probe_samples && bbr_is_inflight_too_high (rs))
+    {
+      bbr_handle_inflight_too_high (tc, bd, rs, now);
+      return;
+    }
+
+  switch (bd->state)
+    {
+    case BBR_PROBE_BW_DOWN:
+      if (bbr_check_time_to_probe_bw (tc, bd, now))
+	return;
+      if (flight <= bbr_inflight_with_headroom (tc, bd) &&
+	  flight <= bbr_inflight (tc, bd, bd->max_bw, 1.0))
+	bbr_start_probe_bw_cruise (bd);
+      break;
+    case BBR_PROBE_BW_CRUISE:
+      bbr_check_time_to_probe_bw (tc, bd, now);
+      break;
+    case BBR_PROBE_BW_REFILL:
+      /* the round at the refill rate has been acked, start probing */
+      if (bd->round_start)
+	bbr_start_probe_bw_up (tc, bd, now);
+      break;
+    case BBR_PROBE_BW_UP:
+      bbr_probe_inflight_hi_upward (tc, bd, rs);
+      if (now - bd->cycle_stamp > bd->min_rtt &&
+	  flight > bbr_inflight (tc, bd, bd->max_bw, BBR_PROBE_UP_PACING_GAIN))
+	bbr_start_probe_bw_down (tc, bd, now);
+      break;
+    default:
+      break;
+    }
+}
+
+static void
+bbr_update_min_rtt (tcp_connection_t *tc, bbr_data_t *bd,
+		    tcp_rate_sample_t *rs, f64 now)
+{
+  f64 rtt = rs->rtt_time;
+
+  bd->probe_rtt_expired =
+    now > bd->probe_rtt_min_stamp + BBR_PROBE_RTT_INTERVAL;
+  if (rtt > 0 && (rtt < bd->probe_rtt_min_delay || bd->probe_rtt_expired))
+    {
+      bd->probe_rtt_min_delay = rtt;
+      bd->probe_rtt_min_stamp = now;
+    }
+
+  if (bd->probe_rtt_min_delay < bd->min_rtt ||
+      now > bd->min_rtt_stamp + BBR_MIN_RTT_FILTER_LEN)
+    {
+      bd->min_rtt = bd->probe_rtt_min_delay;
+      bd->min_rtt_stamp = bd->probe_rtt_min_stamp;
+    }
+}
+
+static void
+bbr_exit_probe_rtt (tcp_connection_t *tc, bbr_data_t *bd, f64 now)
+{
+  bbr_reset_lower_bounds (bd);
+  if (bd->filled_pipe)
+    {
+      bbr_start_probe_bw_down (tc, bd, now);
+      bbr_start_probe_bw_cruise (bd);
+    }
+  else
+    bbr_enter_startup (bd);
+  tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+}
+
+static void
+bbr_check_probe_rtt (tcp_connection_t *tc, bbr_data_t *bd,
+		     tcp_rate_sample_t *rs, f64 now)
+{
+  if (bd->state != BBR_PROBE_RTT && bd->probe_rtt_expired &&
+      !bd->idle_restart)
+    {
+      bbr_save_cwnd (tc, bd);
+      bd->probe_rtt_done_stamp = 0;
+      bd->state = BBR_PROBE_RTT;
+      bd->pacing_gain = 1.0;
+      bd->cwnd_gain = BBR_PROBE_RTT_CWND_GAIN;
+      bbr_start_round (tc, bd);
+    }
+
+  if (bd->state == BBR_PROBE_RTT)
+    {
+      /* hold inflight low for at least 200ms and one round */
+      if (bd->probe_rtt_done_stamp == 0 &&
+	  tcp_flight_size (tc) <= bbr_probe_rtt_cwnd (tc, bd))
+	{
+	  bd->probe_rtt_done_stamp = now + BBR_PROBE_RTT_DURATION;
+	  bd->probe_rtt_round_done = 0;
+	  bbr_start_round (tc, bd);
+	}
+      else if (bd->probe_rtt_done_stamp != 0)
+	{
+	  if (bd->round_start)
+	    bd->probe_rtt_round_done = 1;
+	  if (bd->probe_rtt_round_done && now > bd->probe_rtt_done_stamp)
+	    {
+	      bd->probe_rtt_min_stamp = now;
+	      bbr_exit_probe_rtt (tc, bd, now);
+	    }
+	}
+    }
+
+  if (rs->delivered > 0)
+    bd->idle_restart = 0;
+}
+
+static void
+bbr_set_pacing_rate (tcp_connection_t *tc, bbr_data_t *bd, f64 gain)
+{
+  u64 rate = gain * bd->bw * (1 - BBR_PACING_MARGIN);
+
+  /* until the pipe is full, never slow down below the initial rate */
+  if (bd->filled_pipe || rate > bd->pacing_rate)
+    bd->pacing_rate = rate;
+}
+
+static void
+bbr_set_cwnd (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u32 max_inflight, cap, cwnd = tc->cwnd;
+
+  max_inflight = bbr_inflight (tc, bd, bd->bw, bd->cwnd_gain);
+
+  if (bd->filled_pipe)
+    cwnd = clib_min ((u64) cwnd + rs->acked_and_sacked, max_inflight);
+  else if (cwnd < max_inflight || tc->delivered < tcp_initial_cwnd (tc))
+    cwnd += rs->acked_and_sacked;
+  cwnd = clib_max (cwnd, bbr_min_pipe_cwnd (tc));
+
+  if (bd->state == BBR_PROBE_RTT)
+    cwnd = clib_min (cwnd, bbr_probe_rtt_cwnd (tc, bd));
+
+  /* bounds learned from loss */
+  cap = BBR_UNBOUNDED;
+  if (bbr_in_probe_bw (bd) && bd->state != BBR_PROBE_BW_CRUISE)
+    cap = bd->inflight_hi;
+  else if (bd->state == BBR_PROBE_RTT || bd->state == BBR_PROBE_BW_CRUISE)
+    cap = bbr_inflight_with_headroom (tc, bd);
+  cap = clib_min (cap, bd->inflight_lo);
+  cap = clib_max (cap, bbr_min_pipe_cwnd (tc));
+
+  tc->cwnd = clib_min (cwnd, cap);
+}
+
+static void
+bbr_update (tcp_connection_t *tc, tcp_rate_sample_t *rs)
+{
+  bbr_data_t *bd = bbr_data (tc);
+  f64 now = bbr_time (tc->c_thread_index);
+
+  bbr_update_round (tc, bd, rs);
+  bbr_update_bw (tc, bd, rs);
+  bbr_update_congestion_signals (tc, bd, rs);
+  bbr_check_startup_done (tc, bd, rs);
+  bbr_update_probe_bw_phase (tc, bd, rs, now);
+  bbr_update_min_rtt (tc, bd, rs, now);
+  bbr_check_probe_rtt (tc, bd, rs, now);
+
+  if (bd->round_start)
+    {
+      bd->bw_latest = 0;
+      bd->inflight_latest = 0;
+    }
+
+  bd->bw = clib_min (bd->max_bw, bd->bw_lo);
+  if (bd->bw)
+    bbr_set_pacing_rate (tc, bd, bd->pacing_gain);
+  bbr_set_cwnd (tc, bd, rs);
+}
+
+static void
+bbr_rcv_ack (tcp_connection_t *tc, tcp_rate_sample_t *rs)
+{
+  bbr_update (tc, rs);
+}
+
+static void
+bbr_rcv_cong_ack (tcp_connection_t *tc, tcp_cc_ack_t ack_type,
+		  tcp_rate_sample_t *rs)
+{
+  bbr_update (tc, rs);
+
+  /* prr paces retransmits towards ssthresh, make that the model's cwnd */
+  if (tcp_in_fastrecovery (tc))
+    tc->ssthresh = tc->cwnd;
+}
+
+static void
+bbr_congestion (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  /* no multiplicative decrease, the model reacts to loss through the
+   * inflight and bw bounds */
+  bbr_save_cwnd (tc, bd);
+  tc->ssthresh = clib_max (tc->cwnd, bbr_min_pipe_cwnd (tc));
+}
+
+static void
+bbr_loss (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bbr_save_cwnd (tc, bd);
+  tc->cwnd = tcp_loss_wnd (tc);
+  bd->loss_in_round = 1;
+}
+
+static void
+bbr_recovered (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+}
+
+static void
+bbr_undo_recovery (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  /* loss was spurious, forget what we learned from it */
+  bbr_reset_lower_bounds (bd);
+}
+
+static void
+bbr_event (tcp_connection_t *tc, tcp_cc_event_t evt)
+{
+  bbr_data_t *bd;
+
+  if (evt != TCP_CC_EVT_START_TX)
+    return;
+
+  /* restarting from idle, don't pace above the estimated bw */
+  bd = bbr_data (tc);
+  bd->idle_restart = 1;
+  if (bbr_in_probe_bw (bd) && bd->bw)
+    bbr_set_pacing_rate (tc, bd, 1.0);
+}
+
+static u64
+bbr_get_pacing_rate (tcp_connection_t *tc)
+{
+  return bbr_data (tc)->pacing_rate;
+}
+
+static void
+bbr_conn_init (tcp_connection_t *tc)
+{
+  bbr_data_t *bd;
+  f64 now, srtt;
+
+  bd = clib_mem_alloc (sizeof (*bd));
+  clib_memset (bd, 0, sizeof (*bd));
+  *(bbr_data_t **) tcp_cc_data (tc) = bd;
+
+  now = bbr_time (tc->c_thread_index);
+  srtt = tc->srtt ? tc->srtt * TCP_TICK : BBR_RTT_UNKNOWN;
+
+  tc->ssthresh = 0x7FFFFFFFU;
+  tc->cwnd = tcp_initial_cwnd (tc);
+
+  bd->seed = clib_cpu_time_now ();
+  bd->min_rtt = srtt;
+  bd->min_rtt_stamp = now;
+  bd->probe_rtt_min_delay = srtt;
+  bd->probe_rtt_min_stamp = now;
+  bd->cycle_stamp = now;
+  bd->inflight_hi = BBR_UNBOUNDED;
+  bbr_reset_lower_bounds (bd);
+  bbr_enter_startup (bd);
+  bd->bw_probe_samples = 1;
+
+  /* start at the rate that sends the initial window in an rtt */
+  bd->pacing_rate = BBR_STARTUP_PACING_GAIN * tc->cwnd /
+		    (tc->srtt ? srtt : 1e-3);
+
+  /* the model is built from delivery rate samples and acted upon through
+   * the pacer */
+  if (!(tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE))
+    {
+      tcp_bt_init (tc);
+      tc->cfg_flags |= TCP_CFG_F_RATE_SAMPLE;
+    }
+  if (!transport_connection_is_tx_paced (&tc->connection))
+    tcp_enable_pacing (tc);
+}
+
+static void
+bbr_conn_cleanup (tcp_connection_t *tc)
+{
+  bbr_data_t **bdp = (bbr_data_t **) tcp_cc_data (tc);
+
+  if (*bdp)
+    clib_mem_free (*bdp);
+  *bdp = 0;
+}
+
+const static tcp_cc_algorithm_t tcp_bbr = {
+  .name = "bbr",
+  .init = bbr_conn_init,
+  .cleanup = bbr_conn_cleanup,
+  .rcv_ack = bbr_rcv_ack,
+  .rcv_cong_ack = bbr_rcv_cong_ack,
+  .congestion = bbr_congestion,
+  .loss = bbr_loss,
+  .recovered = bbr_recovered,
+  .undo_recovery = bbr_undo_recovery,
+  .event = bbr_event,
+  .get_pacing_rate = bbr_get_pacing_rate,
+};
+
+clib_error_t *
+bbr_init (vlib_main_t *vm)
+{
+  clib_error_t *error = 0;
+
+  tcp_cc_algo_register (TCP_CC_BBR, &tcp_bbr);
+
+  return error;
+}
+
+VLIB_INIT_FUNCTION (bbr_init);
@@ -469,6 +469,31 @@ tcp_bt_track_rxt (tcp_connection_t * tc, u32 start, u32 end)
     }
 }
 
+/**
+ * Update most recently delivered segment info as per RFC8985 Sec. 6.2
+ */
+static void
+tcp_bt_rack_update (tcp_connection_t *tc, tcp_bt_sample_t *bts)
+{
+  f64 rtt = tc->delivered_time - bts->tx_time;
+
+  /* Ack is probably for the original transmission. Ignore */
+  if ((bts->flags & TCP_BTS_IS_RXT) && rtt < tc->rack_min_rtt)
+    return;
+
+  tc->rack_rtt = rtt;
+  if (!tc->rack_min_rtt || rtt < tc->rack_min_rtt)
+    tc->rack_min_rtt = rtt;
+
+  if (bts->tx_time > tc->rack_xmit_ts ||
+      (bts->tx_time == tc->rack_xmit_ts &&
+       seq_gt (bts->max_seq, tc->rack_end_seq)))
+    {
+      tc->rack_xmit_ts = bts->tx_time;
+      tc->rack_end_seq = bts->max_seq;
+    }
+}
+
 static void
 tcp_bt_sample_to_rate_sample (tcp_connection_t * tc, tcp_bt_sample_t * bts,
 			      tcp_rate_sample_t * rs)
@@ -476,6 +501,9 @@ tcp_bt_sample_to_rate_sample (tcp_connection_t * tc, tcp_bt_sample_t * bts,
   if (bts->flags & TCP_BTS_IS_SACKED)
     return;
 
+  if (tc->cfg_flags & TCP_CFG_F_RACK_TLP)
+    tcp_bt_rack_update (tc, bts);
+
   if (rs->prior_delivered && rs->prior_delivered >= bts->delivered)
     return;
 
@@ -628,6 +656,15 @@ tcp_bt_sample_delivery_rate (tcp_connection_t * tc, tcp_rate_sample_t * rs)
   rs->lost = tc->lost - rs->tx_lost;
 }
 
+f64
+tcp_bt_seq_tx_time (tcp_connection_t *tc, u32 seq)
+{
+  tcp_bt_sample_t *bts;
+
+  bts = bt_lookup_seq (tc->bt, seq);
+  return bts ? bts->tx_time : 0;
+}
+
 void
 tcp_bt_flush_samples (tcp_connection_t * tc)
 {
@@ -63,6 +63,14 @@ void tcp_bt_track_rxt (tcp_connection_t * tc, u32 start, u32 end);
  */
 void tcp_bt_sample_delivery_rate (tcp_connection_t * tc,
 				  tcp_rate_sample_t * rs);
+/**
+ * Get tx time of last transmission of a sequence number
+ *
+ * @param tc	tcp connection
+ * @param seq	sequence number
+ * @return	tx time or 0 if seq is not tracked
+ */
+f64 tcp_bt_seq_tx_time (tcp_connection_t *tc, u32 seq);
 /**
  * Check if sample to be generated is app limited
  *
@@ -774,6 +774,7 @@ tcp_scoreboard_replay (u8 * s, tcp_connection_t * tc, u8 verbose)
     }
   s =
     format (s, "result: %U", format_tcp_scoreboard, &placeholder_tc->sack_sb);
+  scoreboard_free (&placeholder_tc->sack_sb);
 
   return s;
 }
@@ -855,6 +856,8 @@ format_tcp_cfg (u8 *s, va_list *args)
   s = format (s, "tx pacing: %s\n",
 	      tm_cfg.enable_tx_pacing ? "enabled" : "disabled");
   s = format (s, "tso: %s\n", tm_cfg.allow_tso ? "allowed" : "disallowed");
+  s = format (s, "rack-tlp: %s\n",
+	      tm_cfg.enable_rack_tlp ? "enabled" : "disabled");
   s = format (s, "checksum offload: %s\n",
 	      tm_cfg.csum_offload ? "enabled" : "disabled");
   s = format (s, "congestion control algorithm: %s\n",
@@ -1067,6 +1070,8 @@ tcp_config_fn (vlib_main_t * vm, unformat_input_t * input)
 	tcp_cfg.enable_tx_pacing = 0;
       else if (unformat (input, "tso"))
 	tcp_cfg.allow_tso = 1;
+      else if (unformat (input, "rack-tlp"))
+	tcp_cfg.enable_rack_tlp = 1;
       else if (unformat (input, "no-csum-offload"))
 	tcp_cfg.csum_offload = 0;
       else if (unformat (input, "max-gso-size %u", &max_gso_size))
@@ -255,9 +255,17 @@ tcp_update_time_now (tcp_worker_ctx_t *wrk)
   tcp_set_time_now (wrk, now);
 }
 
+/**
+ * Parse tcp header of buffer and lookup its connection
+ *
+ * Ip4 connections are looked up for the whole frame beforehand, see
+ * @ref tcp4_input_lookup_frame, and @a tc4 and @a result4 are the outcome
+ * of that lookup for this buffer. They are ignored for ip6 and nolookup.
+ */
 always_inline tcp_connection_t *
-tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
-			 u8 is_ip4, u8 is_nolookup)
+tcp_input_lookup_buffer (vlib_buffer_t *b, u8 thread_index, u32 *error,
+			 u8 is_ip4, u8 is_nolookup,
+			 transport_connection_t *tc4, u8 result4)
 {
   u32 fib_index = vnet_buffer (b)->ip.fib_index;
   int n_advance_bytes, n_data_bytes;
@@ -287,11 +295,10 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
 	}
 
       if (!is_nolookup)
-	tc = session_lookup_connection_wt4 (fib_index, &ip4->dst_address,
-					    &ip4->src_address, tcp->dst_port,
-					    tcp->src_port,
-					    TRANSPORT_PROTO_TCP, thread_index,
-					    &result);
+	{
+	  tc = tc4;
+	  result = result4;
+	}
     }
   else
     {
@@ -857,6 +857,40 @@ tcp_cc_handle_event (tcp_connection_t * tc, tcp_rate_sample_t * rs,
     tcp_cc_rcv_cong_ack (tc, TCP_CC_PARTIALACK, rs);
 }
 
+/**
+ * RACK-TLP ack processing as per RFC8985
+ */
+static void
+tcp_rack_tlp_rcv_ack (tcp_connection_t *tc, tcp_rate_sample_t *rs)
+{
+  u32 lost;
+
+  if (!tcp_opts_sack_permitted (&tc->rcv_opts))
+    return;
+
+  lost = tcp_rack_detect_loss (tc);
+  tc->lost += lost;
+  rs->last_lost += lost;
+  rs->lost += lost;
+
+  /* Tail loss probe episode ends once the probe is acked */
+  if (!(tc->flags & TCP_CONN_TLP_SENT) ||
+      seq_lt (tc->snd_una, tc->tlp_high_seq))
+    return;
+
+  /* Without dsack it is not known if the original segment or the probe
+   * was delivered. Assume the probe repaired a loss and react, Sec 7.4.2 */
+  if ((tc->flags & TCP_CONN_TLP_RXT) && !tcp_in_cong_recovery (tc))
+    {
+      tc->prev_ssthresh = tc->ssthresh;
+      tc->prev_cwnd = tc->cwnd;
+      tcp_cc_congestion (tc);
+      tcp_cc_recovered (tc);
+    }
+
+  tc->flags &= ~(TCP_CONN_TLP_SENT | TCP_CONN_TLP_RXT);
+}
+
 static void
 tcp_handle_old_ack (tcp_connection_t * tc, tcp_rate_sample_t * rs)
 {
@@ -962,6 +996,9 @@ tcp_rcv_ack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc, vlib_buffer_t * b,
     rs.delivered = tc->bytes_acked + tc->sack_sb.last_sacked_bytes -
 		   tc->sack_sb.last_bytes_delivered;
 
+  if (tc->cfg_flags & TCP_CFG_F_RACK_TLP)
+    tcp_rack_tlp_rcv_ack (tc, &rs);
+
   if (tc->bytes_acked + tc->sack_sb.last_sacked_bytes)
     {
       tcp_update_rtt (tc, &rs, vnet_buffer (b)->tcp.ack_number);
@@ -1180,10 +1217,12 @@ tcp_buffer_discard_bytes (vlib_buffer_t * b, u32 n_bytes_to_drop)
   if (n_bytes_to_drop > b->current_length)
     {
       if (!(b->flags & VLIB_BUFFER_NEXT_PRESENT) ||
-	  (first + b->total_length_not_including_first_buffer <
+	  (first +
+	     vlib_buffer_cold (b)->total_length_not_including_first_buffer <
 	   n_bytes_to_drop))
 	return -1;
-      b->total_length_not_including_first_buffer -= n_bytes_to_drop - first;
+      vlib_buffer_cold (b)->total_length_not_including_first_buffer -=
+	n_bytes_to_drop - first;
       do
 	{
 	  discard = clib_min (n_bytes_to_drop, b->current_length);
@@ -1397,12 +1436,81 @@ tcp_segment_handle_exception (tcp_connection_t *tc, tcp_header_t *th,
     }
 }
 
+/**
+ * Coalesce the data segments that follow b[0] in the frame, if they belong
+ * to the same connection, continue b[0] in sequence and carry the same ack,
+ * window and options. Their payloads are chained to b[0] so that ack
+ * processing, delayed ack and the rx fifo enqueue run once for the run.
+ *
+ * @return number of segments chained to b[0]
+ */
+static u32
+tcp_established_coalesce (vlib_main_t *vm, tcp_connection_t *tc,
+			  vlib_buffer_t **b, u32 n_left)
+{
+  vnet_buffer_opaque_t *hb = vnet_buffer (b[0]), *fb;
+  tcp_header_t *th = tcp_buffer_hdr (b[0]), *fth;
+  vlib_buffer_t *last = b[0];
+  u32 i, data_len;
+
+  if (tc->state != TCP_STATE_ESTABLISHED || !hb->tcp.data_len ||
+      !tcp_ack (th) || (th->flags & ~(TCP_FLAG_ACK | TCP_FLAG_PSH)) ||
+      (b[0]->flags & VLIB_BUFFER_NEXT_PRESENT))
+    return 0;
+
+  data_len = hb->tcp.data_len;
+  for (i = 1; i < n_left; i++)
+    {
+      fb = vnet_buffer (b[i]);
+      fth = tcp_buffer_hdr (b[i]);
+
+      if (fb->tcp.connection_index != hb->tcp.connection_index ||
+	  fb->tcp.seq_number != hb->tcp.seq_end || !fb->tcp.data_len ||
+	  data_len + fb->tcp.data_len > 0xffff ||
+	  (b[i]->flags & VLIB_BUFFER_NEXT_PRESENT) ||
+	  b[i]->current_length < fb->tcp.data_offset + fb->tcp.data_len)
+	break;
+
+      /* Same flags, ack, window and options, so ack processing of the
+       * head is that of the whole run */
+      if (fth->ack_number != th->ack_number ||
+	  fth->data_offset_and_reserved != th->data_offset_and_reserved ||
+	  fth->flags != th->flags || fth->window != th->window ||
+	  memcmp (fth + 1, th + 1, tcp_header_bytes (th) - sizeof (*th)))
+	break;
+
+      /* Trailing bytes of the head would otherwise not be trimmed */
+      if (last == b[0])
+	b[0]->current_length = hb->tcp.data_offset + hb->tcp.data_len;
+
+      vlib_buffer_advance (b[i], fb->tcp.data_offset);
+      b[i]->current_length = fb->tcp.data_len;
+      last->next_buffer = vlib_get_buffer_index (vm, b[i]);
+      last->flags |= VLIB_BUFFER_NEXT_PRESENT;
+      last = b[i];
+
+      data_len += fb->tcp.data_len;
+      hb->tcp.seq_end = fb->tcp.seq_end;
+    }
+
+  if (last == b[0])
+    return 0;
+
+  vlib_buffer_cold (b[0])->total_length_not_including_first_buffer =
+    data_len - hb->tcp.data_len;
+  b[0]->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+  hb->tcp.data_len = data_len;
+  tc->data_segs_in += i - 1;
+
+  return i - 1;
+}
+
 always_inline uword
 tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 			  vlib_frame_t * frame, int is_ip4)
 {
   clib_thread_index_t thread_index = vm->thread_index;
-  u32 n_left_from, *from;
+  u32 n_left_from, *from, n_heads = 0, n_merged;
   tcp_worker_ctx_t *wrk = tcp_get_worker (thread_index);
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
   u16 err_counters[TCP_N_ERROR] = { 0 };
@@ -1431,6 +1539,10 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       tc = tcp_connection_get (vnet_buffer (b[0])->tcp.connection_index,
 			       thread_index);
       th = tcp_buffer_hdr (b[0]);
+      n_merged = 0;
+
+      /* Buffers chained to a head are freed with it */
+      from[n_heads++] = vlib_get_buffer_index (vm, b[0]);
 
       if (PREDICT_FALSE (tcp_segment_is_exception (tc, th)))
 	{
@@ -1438,6 +1550,13 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  goto done;
 	}
 
+      if (n_left_from > 1)
+	{
+	  n_merged = tcp_established_coalesce (vm, tc, b, n_left_from);
+	  tcp_inc_err_counter (err_counters, TCP_ERROR_SEGS_COALESCED,
+			       n_merged);
+	}
+
       /* TODO header prediction fast path */
 
       /* 1-4: check SEQ, RST, SYN */
@@ -1464,15 +1583,15 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
     done:
       tcp_inc_err_counter (err_counters, error, 1);
 
-      n_left_from -= 1;
-      b += 1;
+      n_left_from -= 1 + n_merged;
+      b += 1 + n_merged;
     }
 
   session_main_flush_enqueue_events (TRANSPORT_PROTO_TCP, thread_index);
   tcp_store_err_counters (established, err_counters);
   tcp_handle_postponed_dequeues (wrk);
   tcp_handle_disconnects (wrk);
-  vlib_buffer_free (vm, from, frame->n_vectors);
+  vlib_buffer_free (vm, from, n_heads);
 
   return frame->n_vectors;
 }
@@ -2812,6 +2931,45 @@ tcp_input_dispatch_buffer (tcp_main_t *tm, tcp_connection_t *tc,
     }
 }
 
+/**
+ * Lookup the connections of a frame of ip4 buffers in one batch
+ *
+ * Headers are not validated here, buffers too short to hold them are
+ * dropped by @ref tcp_input_lookup_buffer whatever their lookup result.
+ */
+static_always_inline void
+tcp4_input_lookup_frame (vlib_buffer_t **b, u32 n_bufs,
+			 clib_thread_index_t thread_index,
+			 transport_connection_t **tcs, u8 *results)
+{
+  session_lookup_key4_t keys[VLIB_FRAME_SIZE], *k = keys;
+  u32 i;
+
+  for (i = 0; i < n_bufs; i++)
+    {
+      ip4_header_t *ip4;
+      tcp_header_t *tcp;
+
+      if (i + 4 < n_bufs)
+	{
+	  vlib_prefetch_buffer_header (b[i + 4], STORE);
+	  CLIB_PREFETCH (b[i + 4]->data, 2 * CLIB_CACHE_LINE_BYTES, LOAD);
+	}
+
+      ip4 = vlib_buffer_get_current (b[i]);
+      tcp = ip4_next_header (ip4);
+      k->lcl.as_u32 = ip4->dst_address.as_u32;
+      k->rmt.as_u32 = ip4->src_address.as_u32;
+      k->lcl_port = tcp->dst_port;
+      k->rmt_port = tcp->src_port;
+      k->fib_index = vnet_buffer (b[i])->ip.fib_index;
+      k++;
+    }
+
+  session_lookup_connection_wt4_batch (keys, TRANSPORT_PROTO_TCP,
+				       thread_index, tcs, results, n_bufs);
+}
+
 always_inline uword
 tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		    vlib_frame_t * frame, int is_ip4, u8 is_nolookup)
@@ -2819,6 +2977,8 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 n_left_from, *from, thread_index = vm->thread_index;
   tcp_main_t *tm = vnet_get_tcp_main ();
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  transport_connection_t *tcs[VLIB_FRAME_SIZE], **tc = tcs;
+  u8 results[VLIB_FRAME_SIZE], *result = results;
   u16 nexts[VLIB_FRAME_SIZE], *next;
   u16 err_counters[TCP_N_ERROR] = { 0 };
 
@@ -2828,6 +2988,9 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   n_left_from = frame->n_vectors;
   vlib_get_buffers (vm, from, bufs, n_left_from);
 
+  if (is_ip4 && !is_nolookup)
+    tcp4_input_lookup_frame (bufs, n_left_from, thread_index, tcs, results);
+
   b = bufs;
   next = nexts;
 
@@ -2845,9 +3008,9 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       }
 
       tc0 = tcp_input_lookup_buffer (b[0], thread_index, &error0, is_ip4,
-				     is_nolookup);
+				     is_nolookup, tc[0], result[0]);
       tc1 = tcp_input_lookup_buffer (b[1], thread_index, &error1, is_ip4,
-				     is_nolookup);
+				     is_nolookup, tc[1], result[1]);
 
       if (PREDICT_TRUE (!tc0 + !tc1 == 0))
 	{
@@ -2891,6 +3054,8 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
       b += 2;
       next += 2;
+      tc += 2;
+      result += 2;
       n_left_from -= 2;
     }
   while (n_left_from > 0)
@@ -2905,7 +3070,7 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	}
 
       tc0 = tcp_input_lookup_buffer (b[0], thread_index, &error0, is_ip4,
-				     is_nolookup);
+				     is_nolookup, tc[0], result[0]);
       if (PREDICT_TRUE (tc0 != 0))
 	{
 	  ASSERT (tcp_lookup_is_valid (tc0, b[0], tcp_buffer_hdr (b[0])));
@@ -2920,6 +3085,8 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
       b += 1;
       next += 1;
+      tc += 1;
+      result += 1;
       n_left_from -= 1;
     }
 
@@ -335,7 +335,7 @@ tcp_init_buffer (vlib_main_t * vm, vlib_buffer_t * b)
 {
   ASSERT ((b->flags & VLIB_BUFFER_NEXT_PRESENT) == 0);
   b->flags |= VNET_BUFFER_F_LOCALLY_ORIGINATED;
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = 0;
   b->current_data = 0;
   vnet_buffer (b)->tcp.flags = 0;
   /* Leave enough space for headers */
@@ -614,7 +614,7 @@ tcp_buffer_make_reset (vlib_main_t *vm, vlib_buffer_t *b, u8 is_ip4)
   /* Make sure new tcp header comes after current ip */
   b->current_data = ((u8 *) th - b->data) + sizeof (tcp_header_t);
   b->current_length = 0;
-  b->total_length_not_including_first_buffer = 0;
+  vlib_buffer_cold (b)->total_length_not_including_first_buffer = 0;
   vnet_buffer (b)->tcp.flags = 0;
 
   /*
@@ -878,7 +878,7 @@ tcp_push_hdr_i (tcp_connection_t * tc, vlib_buffer_t * b, u32 snd_nxt,
 
   data_len = b->current_length;
   if (PREDICT_FALSE (b->flags & VLIB_BUFFER_NEXT_PRESENT))
-    data_len += b->total_length_not_including_first_buffer;
+    data_len += vlib_buffer_cold (b)->total_length_not_including_first_buffer;
 
   vnet_buffer (b)->tcp.flags = 0;
   vnet_buffer (b)->tcp.connection_index = tc->c_c_index;
@@ -935,7 +935,7 @@ tcp_buffer_len (vlib_buffer_t * b)
 {
   u32 data_len = b->current_length;
   if (PREDICT_FALSE (b->flags & VLIB_BUFFER_NEXT_PRESENT))
-    data_len += b->total_length_not_including_first_buffer;
+    data_len += vlib_buffer_cold (b)->total_length_not_including_first_buffer;
   return data_len;
 }
 
@@ -1146,7 +1146,7 @@ tcp_prepare_segment (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 					    TRANSPORT_MAX_HDRS_LEN);
       b[0]->current_length = n_bytes;
       b[0]->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
-      b[0]->total_length_not_including_first_buffer = 0;
+      vlib_buffer_cold (b[0])->total_length_not_including_first_buffer = 0;
       max_deq_bytes -= n_bytes;
 
       chain_b = *b;
@@ -1171,7 +1171,8 @@ tcp_prepare_segment (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 	  prev_b->flags |= VLIB_BUFFER_NEXT_PRESENT;
 
 	  max_deq_bytes -= n_peeked;
-	  b[0]->total_length_not_including_first_buffer += n_peeked;
+	  vlib_buffer_cold (b[0])->total_length_not_including_first_buffer +=
+	    n_peeked;
 	}
 
       tcp_push_hdr_i (tc, *b, tc->snd_una + offset, /* compute opts */ 0,
@@ -1305,6 +1306,69 @@ tcp_check_syn_flood (tcp_connection_t *tc)
   tm->sdl_cb (&args);
 }
 
+/**
+ * Send tail loss probe as per RFC8985 Sec. 7.3
+ *
+ * Probe with new data if available and allowed by the peer's window,
+ * otherwise retransmit the last segment sent.
+ */
+static void
+tcp_send_tail_loss_probe (tcp_worker_ctx_t *wrk, tcp_connection_t *tc)
+{
+  u32 offset, max_deq, n_bytes, bi;
+  vlib_buffer_t *b = 0;
+
+  /* Recovery started after the timer was armed. Wait for the rto */
+  if (tcp_in_cong_recovery (tc))
+    {
+      tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
+      return;
+    }
+
+  offset = tc->snd_nxt - tc->snd_una;
+  max_deq = transport_max_tx_dequeue (&tc->connection);
+
+  if (max_deq > offset && tc->snd_wnd >= offset + tc->snd_mss)
+    {
+      n_bytes = clib_min (tc->snd_mss, max_deq - offset);
+      n_bytes = tcp_prepare_segment (wrk, tc, offset, n_bytes, &b);
+      if (!n_bytes)
+	goto alloc_err;
+      if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
+	{
+	  tcp_bt_check_app_limited (tc);
+	  tcp_bt_track_tx (tc, n_bytes);
+	}
+      tc->snd_nxt += n_bytes;
+    }
+  else
+    {
+      n_bytes = clib_min (tc->snd_mss, offset);
+      n_bytes = tcp_prepare_retransmit_segment (wrk, tc, offset - n_bytes,
+						n_bytes, &b);
+      if (!n_bytes)
+	goto alloc_err;
+      tc->flags |= TCP_CONN_TLP_RXT;
+      tc->rtt_ts = 0;
+    }
+
+  bi = vlib_get_buffer_index (wrk->vm, b);
+  tcp_enqueue_to_output (wrk, b, bi, tc->c_is_ip4);
+  tcp_worker_stats_inc (wrk, tlp_segs, 1);
+
+  /* Only one probe per episode. Timer falls back to rto */
+  tc->tlp_high_seq = tc->snd_nxt;
+  tc->flags |= TCP_CONN_TLP_SENT;
+  tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
+
+  return;
+
+alloc_err:
+  tcp_timer_update (&wrk->timer_wheel, tc, TCP_TIMER_RETRANSMIT,
+		    tcp_cfg.alloc_err_timeout);
+  tc->flags |= TCP_CONN_TLP_PTO;
+}
+
 void
 tcp_timer_retransmit_handler (tcp_connection_t * tc)
 {
@@ -1313,8 +1377,6 @@ tcp_timer_retransmit_handler (tcp_connection_t * tc)
   vlib_buffer_t *b = 0;
   u32 bi, n_bytes;
 
-  tcp_worker_stats_inc (wrk, tr_events, 1);
-
   /* Should be handled by a different handler */
   if (PREDICT_FALSE (tc->state == TCP_STATE_SYN_SENT))
     return;
@@ -1323,6 +1385,12 @@ tcp_timer_retransmit_handler (tcp_connection_t * tc)
   if (tc->state == TCP_STATE_CLOSED)
     return;
 
+  /* Acks pushed out the deadline without updating the timer */
+  if (tcp_retransmit_timer_rearm_early (&wrk->timer_wheel, tc))
+    return;
+
+  tcp_worker_stats_inc (wrk, tr_events, 1);
+
   if (tc->state >= TCP_STATE_ESTABLISHED)
     {
       TCP_EVT (TCP_EVT_CC_EVT, tc, 2);
@@ -1344,6 +1412,15 @@ tcp_timer_retransmit_handler (tcp_connection_t * tc)
 	  return;
 	}
 
+      /* Probe timeout, not an rto */
+      if (tc->flags & TCP_CONN_TLP_PTO)
+	{
+	  tc->flags &= ~TCP_CONN_TLP_PTO;
+	  tcp_send_tail_loss_probe (wrk, tc);
+	  return;
+	}
+      tc->flags &= ~(TCP_CONN_TLP_SENT | TCP_CONN_TLP_RXT);
+
       /* We're not in recovery so make sure rto_boff is 0. Can be non 0 due
        * to persist timer timeout */
       if (!tcp_in_recovery (tc) && tc->rto_boff > 0)
@@ -1633,7 +1710,7 @@ static int
 tcp_transmit_unsent (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 		     u32 burst_size)
 {
-  u32 offset, n_segs = 0, n_written, bi, available_wnd;
+  u32 offset, n_segs = 0, n_written, bi, available_wnd, seg_size, max_deq;
   vlib_main_t *vm = wrk->vm;
   vlib_buffer_t *b = 0;
 
@@ -1644,16 +1721,35 @@ tcp_transmit_unsent (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
   if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
     tcp_bt_check_app_limited (tc);
 
+  /* With tso, build super-segments and let gso segment them. Burst size
+   * is still accounted for in mss sized segments */
+  seg_size = tc->snd_mss;
+  max_deq = ~0;
+  if (tc->cfg_flags & TCP_CFG_F_TSO)
+    {
+      seg_size = tcp_session_cal_goal_size (tc);
+      max_deq = transport_max_tx_dequeue (&tc->connection);
+      max_deq = max_deq > offset ? max_deq - offset : 0;
+    }
+
   while (n_segs < burst_size)
     {
-      n_written = tcp_prepare_segment (wrk, tc, offset, tc->snd_mss, &b);
+      /* Chained buffers must be filled completely, so never ask for more
+       * than what is in the fifo */
+      seg_size = clib_min (seg_size, (burst_size - n_segs) * tc->snd_mss);
+      seg_size = clib_min (seg_size, max_deq);
+      if (!seg_size)
+	goto done;
+
+      n_written = tcp_prepare_segment (wrk, tc, offset, seg_size, &b);
       if (!n_written)
 	goto done;
 
       bi = vlib_get_buffer_index (vm, b);
       tcp_enqueue_to_output (wrk, b, bi, tc->c_is_ip4);
       offset += n_written;
-      n_segs += 1;
+      max_deq -= n_written;
+      n_segs += (n_written + tc->snd_mss - 1) / tc->snd_mss;
 
       if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
 	tcp_bt_track_tx (tc, n_written);
@@ -2145,10 +2241,10 @@ tcp_check_if_gso (tcp_connection_t * tc, vlib_buffer_t * b)
   if (PREDICT_TRUE (!(tc->cfg_flags & TCP_CFG_F_TSO)))
     return;
 
-  u16 data_len = b->current_length - sizeof (tcp_header_t) - tc->snd_opts_len;
+  u32 data_len = b->current_length - sizeof (tcp_header_t) - tc->snd_opts_len;
 
   if (PREDICT_FALSE (b->flags & VLIB_BUFFER_TOTAL_LENGTH_VALID))
-    data_len += b->total_length_not_including_first_buffer;
+    data_len += vlib_buffer_cold (b)->total_length_not_including_first_buffer;
 
   if (PREDICT_TRUE (data_len <= tc->snd_mss))
     return;
@@ -14,6 +14,93 @@
  */
 
 #include <vnet/tcp/tcp_sack.h>
+#include <vnet/tcp/tcp_bt.h>
+#include <vnet/tcp/tcp_inlines.h>
+
+static int
+scoreboard_seq_lt (u32 a, u32 b)
+{
+  return seq_lt (a, b);
+}
+
+/**
+ * Find the hole with the highest start at or below seq
+ *
+ * Holes are indexed by start sequence number in an rbtree, so the lookup
+ * is logarithmic in the number of holes.
+ */
+static sack_scoreboard_hole_t *
+scoreboard_lookup_hole (sack_scoreboard_t *sb, u32 seq)
+{
+  rb_tree_t *rt = &sb->hole_lookup;
+  rb_node_t *cur, *floor = 0;
+
+  cur = rb_node (rt, rt->root);
+  while (!rb_node_is_tnil (rt, cur))
+    {
+      if (seq_lt (seq, cur->key))
+	cur = rb_node_left (rt, cur);
+      else
+	{
+	  floor = cur;
+	  if (seq == cur->key)
+	    break;
+	  cur = rb_node_right (rt, cur);
+	}
+    }
+
+  return floor ? pool_elt_at_index (sb->holes, floor->opaque) : 0;
+}
+
+/**
+ * Find the first hole that ends after seq
+ */
+static sack_scoreboard_hole_t *
+scoreboard_lookup_hole_after (sack_scoreboard_t *sb, u32 seq)
+{
+  sack_scoreboard_hole_t *hole;
+
+  hole = scoreboard_lookup_hole (sb, seq);
+  if (!hole)
+    return scoreboard_first_hole (sb);
+  if (seq_leq (hole->end, seq))
+    return scoreboard_next_hole (sb, hole);
+  return hole;
+}
+
+static void
+scoreboard_hole_set_start (sack_scoreboard_t *sb,
+			   sack_scoreboard_hole_t *hole, u32 start)
+{
+  rb_tree_del_custom (&sb->hole_lookup, hole->start, scoreboard_seq_lt);
+  sb->hole_bytes -= start - hole->start;
+  if (hole->is_lost)
+    sb->lost_bytes -= start - hole->start;
+  hole->start = start;
+  rb_tree_add_custom (&sb->hole_lookup, hole->start,
+		      scoreboard_hole_index (sb, hole), scoreboard_seq_lt);
+}
+
+static void
+scoreboard_hole_set_end (sack_scoreboard_t *sb, sack_scoreboard_hole_t *hole,
+			 u32 end)
+{
+  sb->hole_bytes += end - hole->end;
+  if (hole->is_lost)
+    sb->lost_bytes += end - hole->end;
+  hole->end = end;
+}
+
+static void
+scoreboard_hole_mark_lost (sack_scoreboard_t *sb,
+			   sack_scoreboard_hole_t *hole)
+{
+  if (hole->is_lost)
+    return;
+  hole->is_lost = 1;
+  sb->lost_bytes += scoreboard_hole_bytes (hole);
+  sb->last_lost_bytes += scoreboard_hole_bytes (hole);
+}
 
 static void
 scoreboard_remove_hole (sack_scoreboard_t * sb, sack_scoreboard_hole_t * hole)
@@ -40,8 +127,15 @@ scoreboard_remove_hole (sack_scoreboard_t * sb, sack_scoreboard_hole_t * hole)
       sb->head = hole->next;
     }
 
+  /* Holes before the one being retransmitted were all retransmitted as
+   * well, so the next hole is where retransmits continue */
   if (scoreboard_hole_index (sb, hole) == sb->cur_rxt_hole)
-    sb->cur_rxt_hole = TCP_INVALID_SACK_HOLE_INDEX;
+    sb->cur_rxt_hole = hole->next;
+
+  rb_tree_del_custom (&sb->hole_lookup, hole->start, scoreboard_seq_lt);
+  sb->hole_bytes -= scoreboard_hole_bytes (hole);
+  if (hole->is_lost)
+    sb->lost_bytes -= scoreboard_hole_bytes (hole);
 
   /* Poison the entry */
   if (CLIB_DEBUG > 0)
@@ -63,6 +157,8 @@ scoreboard_insert_hole (sack_scoreboard_t * sb, u32 prev_index,
   hole->start = start;
   hole->end = end;
   hole_index = scoreboard_hole_index (sb, hole);
+  rb_tree_add_custom (&sb->hole_lookup, start, hole_index, scoreboard_seq_lt);
+  sb->hole_bytes += end - start;
 
   prev = scoreboard_get_hole (sb, prev_index);
   if (prev)
@@ -120,23 +216,28 @@ scoreboard_update_bytes (sack_scoreboard_t * sb, u32 ack, u32 snd_mss)
   old_sacked = sb->sacked_bytes;
 
   sb->last_lost_bytes = 0;
-  sb->lost_bytes = 0;
-  sb->sacked_bytes = 0;
 
   right = scoreboard_last_hole (sb);
   if (!right)
     {
+      sb->lost_bytes = 0;
       sb->sacked_bytes = sb->high_sacked - ack;
       sb->last_sacked_bytes = sb->sacked_bytes
 	- (old_sacked - sb->last_bytes_delivered);
       return;
     }
 
+  /* Everything between ack and high_sacked that is not a hole has been
+   * sacked. The last hole may lie beyond high_sacked. */
   if (seq_gt (sb->high_sacked, right->end))
     {
+      sb->sacked_bytes = sb->high_sacked - ack - sb->hole_bytes;
       sacked = sb->high_sacked - right->end;
       blks = 1;
     }
+  else
+    sb->sacked_bytes = right->start - ack
+		       - (sb->hole_bytes - scoreboard_hole_bytes (right));
 
   /* As per RFC 6675 a sequence number is lost if:
    *   DupThresh discontiguous SACKed sequences have arrived above
@@ -147,14 +248,10 @@ scoreboard_update_bytes (sack_scoreboard_t * sb, u32 ack, u32 snd_mss)
    */
   while (sacked <= (sb->reorder - 1) * snd_mss && blks < sb->reorder)
     {
-      if (right->is_lost)
-	sb->lost_bytes += scoreboard_hole_bytes (right);
-
       left = scoreboard_prev_hole (sb, right);
       if (!left)
 	{
 	  ASSERT (right->start == ack || sb->is_reneging);
-	  sacked += right->start - ack;
 	  right = 0;
 	  break;
 	}
@@ -164,25 +261,16 @@ scoreboard_update_bytes (sack_scoreboard_t * sb, u32 ack, u32 snd_mss)
       right = left;
     }
 
-  /* right is first lost */
-  while (right)
+  /* right is first lost. Holes are marked lost from the head onwards, so
+   * stop at the first hole that is already lost */
+  while (right && !right->is_lost)
     {
-      sb->lost_bytes += scoreboard_hole_bytes (right);
-      sb->last_lost_bytes += right->is_lost ? 0 : (right->end - right->start);
-      right->is_lost = 1;
-      left = scoreboard_prev_hole (sb, right);
-      if (!left)
-	{
-	  ASSERT (right->start == ack || sb->is_reneging);
-	  sacked += right->start - ack;
-	  break;
-	}
-      sacked += right->start - left->end;
-      right = left;
+      scoreboard_hole_mark_lost (sb, right);
+      right = scoreboard_prev_hole (sb, right);
     }
 
-  sb->sacked_bytes = sacked;
-  sb->last_sacked_bytes = sacked - (old_sacked - sb->last_bytes_delivered);
+  sb->last_sacked_bytes = sb->sacked_bytes
+			  - (old_sacked - sb->last_bytes_delivered);
 }
 
 /**
@@ -195,9 +283,19 @@ scoreboard_next_rxt_hole (sack_scoreboard_t * sb,
 			  sack_scoreboard_hole_t * start,
 			  u8 have_unsent, u8 * can_rescue, u8 * snd_limited)
 {
-  sack_scoreboard_hole_t *hole = 0;
+  sack_scoreboard_hole_t *hole = 0, *prev;
+
+  if (start)
+    hole = start;
+  else
+    {
+      /* Holes below high_rxt that are lost have been retransmitted. Skip
+       * them with a lookup if all holes before high_rxt are lost */
+      hole = scoreboard_lookup_hole (sb, sb->high_rxt);
+      if (!hole || ((prev = scoreboard_prev_hole (sb, hole)) && !prev->is_lost))
+	hole = scoreboard_first_hole (sb);
+    }
 
-  hole = start ? start : scoreboard_first_hole (sb);
   while (hole && seq_leq (hole->end, sb->high_rxt) && hole->is_lost)
     hole = scoreboard_next_hole (sb, hole);
 
@@ -285,6 +383,55 @@ scoreboard_rxt_mark_lost (sack_scoreboard_t *sb, u32 snd_una, u32 snd_nxt)
   sb->lost_bytes += scoreboard_hole_bytes (hole);
 }
 
+/**
+ * Mark holes lost using RACK, as per RFC8985 Sec. 6.2 step 5
+ *
+ * A hole is lost if it was sent before the most recently delivered segment
+ * and more than rack rtt plus a reordering window ago. Only holes below the
+ * end of that segment are candidates and the walk starts from the first
+ * one that is not lost, so lost holes remain a prefix of the list. The hole
+ * is assumed to have been sent when its first byte was.
+ *
+ * @return number of bytes newly marked as lost
+ */
+u32
+tcp_rack_detect_loss (tcp_connection_t *tc)
+{
+  sack_scoreboard_t *sb = &tc->sack_sb;
+  sack_scoreboard_hole_t *hole, *prev;
+  u32 old_lost = sb->lost_bytes, last_lost = sb->last_lost_bytes;
+  f64 now, reo_wnd, tx_time;
+
+  if (!tc->rack_xmit_ts || sb->is_reneging)
+    return 0;
+
+  hole = scoreboard_lookup_hole (sb, tc->rack_end_seq - 1);
+  if (!hole || hole->is_lost)
+    return 0;
+
+  while ((prev = scoreboard_prev_hole (sb, hole)) && !prev->is_lost)
+    hole = prev;
+
+  now = tcp_time_now_us (tc->c_thread_index);
+  reo_wnd = clib_min (tc->rack_min_rtt / 4, (f64) tc->srtt * TCP_TICK);
+
+  while (hole && seq_lt (hole->start, tc->rack_end_seq))
+    {
+      tx_time = tcp_bt_seq_tx_time (tc, hole->start);
+      if (!tx_time || tx_time > tc->rack_xmit_ts ||
+	  tx_time + tc->rack_rtt + reo_wnd > now)
+	break;
+      scoreboard_hole_mark_lost (sb, hole);
+      hole = scoreboard_next_hole (sb, hole);
+    }
+
+  /* Caller accounts for these, as delivery rate already consumed
+   * last lost bytes for this ack */
+  sb->last_lost_bytes = last_lost;
+
+  return sb->lost_bytes - old_lost;
+}
+
 void
 scoreboard_init (sack_scoreboard_t * sb)
 {
@@ -292,6 +439,14 @@ scoreboard_init (sack_scoreboard_t * sb)
   sb->tail = TCP_INVALID_SACK_HOLE_INDEX;
   sb->cur_rxt_hole = TCP_INVALID_SACK_HOLE_INDEX;
   sb->reorder = TCP_DUPACK_THRESHOLD;
+  rb_tree_init (&sb->hole_lookup);
+}
+
+void
+scoreboard_free (sack_scoreboard_t *sb)
+{
+  pool_free (sb->holes);
+  rb_tree_free_nodes (&sb->hole_lookup);
 }
 
 void
@@ -304,6 +459,7 @@ scoreboard_clear (sack_scoreboard_t * sb)
     }
   ASSERT (sb->head == sb->tail && sb->head == TCP_INVALID_SACK_HOLE_INDEX);
   ASSERT (pool_elts (sb->holes) == 0);
+  ASSERT (sb->hole_bytes == 0 && sb->lost_bytes == 0);
   sb->sacked_bytes = 0;
   sb->last_sacked_bytes = 0;
   sb->last_bytes_delivered = 0;
@@ -322,7 +478,7 @@ scoreboard_clear_reneging (sack_scoreboard_t * sb, u32 start, u32 end)
   scoreboard_clear (sb);
   last_hole = scoreboard_insert_hole (sb, TCP_INVALID_SACK_HOLE_INDEX,
 				      start, end);
-  last_hole->is_lost = 1;
+  scoreboard_hole_mark_lost (sb, last_hole);
   sb->tail = scoreboard_hole_index (sb, last_hole);
   sb->high_sacked = start;
   scoreboard_init_rxt (sb, start);
@@ -446,7 +602,7 @@ tcp_rcv_sacks (tcp_connection_t * tc, u32 ack)
 	{
 	  if (seq_geq (hole->start, sb->high_sacked))
 	    {
-	      hole->end = tc->snd_nxt;
+	      scoreboard_hole_set_end (sb, hole, tc->snd_nxt);
 	    }
 	  /* New hole after high sacked block */
 	  else if (seq_lt (sb->high_sacked, tc->snd_nxt))
@@ -509,7 +665,7 @@ tcp_rcv_sacks (tcp_connection_t * tc, u32 ack)
 		{
 		  scoreboard_update_sacked (sb, hole->start, blk->end,
 					    has_rxt, tc->snd_mss);
-		  hole->start = blk->end;
+		  scoreboard_hole_set_start (sb, hole, blk->end);
 		}
 	      blk_index++;
 	    }
@@ -524,8 +680,12 @@ tcp_rcv_sacks (tcp_connection_t * tc, u32 ack)
 						  hole->end);
 	      /* Pool might've moved */
 	      hole = scoreboard_get_hole (sb, hole_index);
-	      hole->end = blk->start;
-	      next_hole->is_lost = hole->is_lost;
+	      scoreboard_hole_set_end (sb, hole, blk->start);
+	      if (hole->is_lost)
+		{
+		  next_hole->is_lost = 1;
+		  sb->lost_bytes += scoreboard_hole_bytes (next_hole);
+		}
 
 	      scoreboard_update_sacked (sb, blk->start, blk->end,
 					has_rxt, tc->snd_mss);
@@ -537,9 +697,15 @@ tcp_rcv_sacks (tcp_connection_t * tc, u32 ack)
 	    {
 	      scoreboard_update_sacked (sb, blk->start, hole->end,
 					has_rxt, tc->snd_mss);
-	      hole->end = blk->start;
+	      scoreboard_hole_set_end (sb, hole, blk->start);
 	    }
 	  hole = scoreboard_next_hole (sb, hole);
+
+	  /* Jump over holes that sit between the blocks */
+	  if (hole && blk_index < vec_len (rcv_sacks)
+	      && seq_leq (hole->end, rcv_sacks[blk_index].start))
+	    hole = scoreboard_lookup_hole_after (sb,
+						 rcv_sacks[blk_index].start);
 	}
     }
 
@@ -24,6 +24,16 @@ tcp_timer_thread_is_valid (tcp_connection_t *tc)
 	  vlib_thread_is_main_w_barrier ());
 }
 
+always_inline void
+tcp_timer_track_rxt (tcp_timer_wheel_t *tw, tcp_connection_t *tc,
+		     u8 timer_id, u32 interval)
+{
+  if (timer_id != TCP_TIMER_RETRANSMIT)
+    return;
+  tc->rxt_timer_tick = tw->current_tick + interval;
+  tc->rxt_deadline = tc->rxt_timer_tick;
+}
+
 always_inline void
 tcp_timer_set (tcp_timer_wheel_t *tw, tcp_connection_t *tc, u8 timer_id,
 	       u32 interval)
@@ -32,6 +42,7 @@ tcp_timer_set (tcp_timer_wheel_t *tw, tcp_connection_t *tc, u8 timer_id,
   ASSERT (tc->timers[timer_id] == TCP_TIMER_HANDLE_INVALID);
   tc->timers[timer_id] = tw_timer_start_tcp_twsl (tw, tc->c_c_index,
 						  timer_id, interval);
+  tcp_timer_track_rxt (tw, tc, timer_id, interval);
 }
 
 always_inline void
@@ -56,6 +67,7 @@ tcp_timer_update (tcp_timer_wheel_t * tw, tcp_connection_t * tc, u8 timer_id,
   else
     tc->timers[timer_id] = tw_timer_start_tcp_twsl (tw, tc->c_c_index,
 						    timer_id, interval);
+  tcp_timer_track_rxt (tw, tc, timer_id, interval);
 }
 
 always_inline u8
@@ -65,12 +77,41 @@ tcp_timer_is_active (tcp_connection_t *tc, tcp_timers_e timer)
 	 (tc->pending_timers & (1 << timer));
 }
 
+/**
+ * Retransmit timer interval in timer ticks
+ *
+ * When a tail loss probe can be sent, as per RFC8985 Sec. 7.2, this is the
+ * probe timeout and the connection is flagged as such. Otherwise, the rto.
+ */
+always_inline u32
+tcp_retransmit_timer_interval (tcp_connection_t *tc)
+{
+  u32 pto;
+
+  tc->flags &= ~TCP_CONN_TLP_PTO;
+
+  if (!(tc->cfg_flags & TCP_CFG_F_RACK_TLP) || !tc->srtt ||
+      (tc->flags & (TCP_CONN_TLP_SENT | TCP_CONN_RECOVERY |
+		    TCP_CONN_FAST_RECOVERY | TCP_CONN_FINSNT)) ||
+      !tcp_opts_sack_permitted (&tc->rcv_opts))
+    return clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1);
+
+  pto = 2 * tc->srtt;
+  if (tc->snd_nxt - tc->snd_una <= tc->snd_mss)
+    pto += TCP_TLP_MAX_ACK_DELAY;
+  if (pto < tc->rto)
+    tc->flags |= TCP_CONN_TLP_PTO;
+  pto = clib_min (pto, tc->rto);
+
+  return clib_max ((u32) pto * TCP_TO_TIMER_TICK, 1);
+}
+
 always_inline void
 tcp_retransmit_timer_set (tcp_timer_wheel_t * tw, tcp_connection_t * tc)
 {
   ASSERT (tc->snd_una != tc->snd_nxt);
   tcp_timer_set (tw, tc, TCP_TIMER_RETRANSMIT,
-		 clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1));
+		 tcp_retransmit_timer_interval (tc));
 }
 
 always_inline void
@@ -104,8 +145,37 @@ tcp_retransmit_timer_update (tcp_timer_wheel_t * tw, tcp_connection_t * tc)
 	tcp_persist_timer_set (tw, tc);
     }
   else
-    tcp_timer_update (tw, tc, TCP_TIMER_RETRANSMIT,
-		      clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1));
+    {
+      u32 interval = tcp_retransmit_timer_interval (tc);
+
+      /* Timer is re-armed on almost every ack and that only pushes the
+       * expiry further out. Avoid touching the wheel and just record
+       * the new deadline. Handler re-arms the timer if it pops early */
+      if (tc->timers[TCP_TIMER_RETRANSMIT] != TCP_TIMER_HANDLE_INVALID &&
+	  (i32) (tw->current_tick + interval - tc->rxt_timer_tick) >= 0)
+	{
+	  tc->rxt_deadline = tw->current_tick + interval;
+	  return;
+	}
+      tcp_timer_update (tw, tc, TCP_TIMER_RETRANSMIT, interval);
+    }
+}
+
+/**
+ * Re-arm retransmit timer if it popped before its lazily updated deadline
+ *
+ * @return 1 if timer was re-armed and expiration should be ignored
+ */
+always_inline int
+tcp_retransmit_timer_rearm_early (tcp_timer_wheel_t *tw, tcp_connection_t *tc)
+{
+  i32 left = (i32) (tc->rxt_deadline - (u32) tw->current_tick);
+
+  if (left <= 0)
+    return 0;
+
+  tcp_timer_update (tw, tc, TCP_TIMER_RETRANSMIT, left);
+  return 1;
 }
 
 always_inline void
@@ -89,6 +89,7 @@ typedef enum _tcp_timers
 #define TCP_RTO_INIT 1 * THZ	/* Initial retransmit timer */
 #define TCP_RTO_BOFF_MAX 8	/* Max number of retries before reset */
 #define TCP_ESTABLISH_TIME (60 * THZ)	/* Connection establish timeout */
+#define TCP_TLP_MAX_ACK_DELAY 0.2 * THZ	/* Worst case delayed ack (200ms) */
 
 /** Connection configuration flags */
 #define foreach_tcp_cfg_flag 			\
@@ -97,6 +98,7 @@ typedef enum _tcp_timers
   _(NO_TSO, "TSO off")				\
   _(TSO, "TSO")					\
   _(NO_ENDPOINT,"No endpoint")			\
+  _(RACK_TLP, "RACK-TLP")			\
 
 typedef enum tcp_cfg_flag_bits_
 {
@@ -129,6 +131,9 @@ typedef enum tcp_cfg_flag_
   _(PSH_PENDING, "PSH pending")			\
   _(FINRCVD, "FIN received")			\
   _(ZERO_RWND_SENT, "Zero RWND sent")		\
+  _(TLP_PTO, "Probe timeout armed")		\
+  _(TLP_SENT, "Tail loss probe sent")		\
+  _(TLP_RXT, "Tail loss probe rxt")		\
 
 typedef enum tcp_connection_flag_bits_
 {
@@ -172,6 +177,7 @@ typedef struct _sack_scoreboard_hole
 typedef struct _sack_scoreboard
 {
   sack_scoreboard_hole_t *holes;	/**< Pool of holes */
+  rb_tree_t hole_lookup;		/**< Rbtree for hole lookup by start */
   u32 head;				/**< Index of first entry */
   u32 tail;				/**< Index of last entry */
   u32 sacked_bytes;			/**< Number of bytes sacked in sb */
@@ -182,6 +188,7 @@ typedef struct _sack_scoreboard
   u32 high_rxt;				/**< Highest retransmitted sequence */
   u32 rescue_rxt;			/**< Rescue sequence number */
   u32 lost_bytes;			/**< Bytes lost as per RFC6675 */
+  u32 hole_bytes;			/**< Bytes in all holes */
   u32 last_lost_bytes;			/**< Number of bytes last lost */
   u32 cur_rxt_hole;			/**< Retransmitting from this hole */
   u32 reorder;				/**< Estimate of segment reordering */
@@ -247,7 +254,8 @@ typedef enum _tcp_cc_algorithm_type
 {
   TCP_CC_NEWRENO,
   TCP_CC_CUBIC,
-  TCP_CC_LAST = TCP_CC_CUBIC
+  TCP_CC_BBR,
+  TCP_CC_LAST = TCP_CC_BBR
 } tcp_cc_algorithm_type_e;
 
 typedef struct _tcp_cc_algorithm tcp_cc_algorithm_t;
@@ -285,6 +293,8 @@ typedef struct _tcp_connection
   u16 flags;			/**< Connection flags (see tcp_conn_flags_e) */
   u32 timers[TCP_N_TIMERS];	/**< Timer handles into timer wheel */
   u32 pending_timers;		/**< Expired timers not yet handled */
+  u32 rxt_timer_tick;		/**< Wheel tick retransmit timer pops at */
+  u32 rxt_deadline;		/**< Wheel tick retransmit timer is due at */
 
   u64 segs_in;		/** RFC4022/4898 tcpHCInSegs/tcpEStatsPerfSegsIn */
   u64 bytes_in;		/** RFC4898 tcpEStatsPerfHCDataOctetsIn */
@@ -377,6 +387,13 @@ typedef struct _tcp_connection
   u64 lost;			/**< Total bytes lost */
   tcp_byte_tracker_t *bt;	/**< Tx byte tracker */
 
+  /* RACK-TLP RFC8985 */
+  f64 rack_xmit_ts;		/**< Tx time of last delivered segment */
+  f64 rack_rtt;			/**< RTT of last delivered segment */
+  f64 rack_min_rtt;		/**< Min RTT seen by rack */
+  u32 rack_end_seq;		/**< End seq of last delivered segment */
+  u32 tlp_high_seq;		/**< snd_nxt when tail loss probe was sent */
+
   tcp_errors_t errors;	/**< Soft connection errors */
 
   u32 iss;		/**< initial sent sequence */
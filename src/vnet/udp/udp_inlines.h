@@ -31,7 +31,7 @@ vlib_buffer_push_udp (vlib_buffer_t *b, u16 sp, u16 dp)
   udp_header_t *uh;
   u16 udp_len = sizeof (udp_header_t) + b->current_length;
   if (PREDICT_FALSE (b->flags & VLIB_BUFFER_TOTAL_LENGTH_VALID))
-    udp_len += b->total_length_not_including_first_buffer;
+    udp_len += vlib_buffer_cold (b)->total_length_not_including_first_buffer;
 
   uh = vlib_buffer_push_uninit (b, sizeof (udp_header_t));
   uh->src_port = sp;
@@ -249,8 +249,8 @@ udp_parse_and_lookup_buffer (vlib_buffer_t * b, session_dgram_hdr_t * hdr,
   if (PREDICT_TRUE (!(b->flags & VLIB_BUFFER_NEXT_PRESENT)))
     b->current_length = hdr->data_length;
   else
-    b->total_length_not_including_first_buffer = hdr->data_length
-      - b->current_length;
+    vlib_buffer_cold (b)->total_length_not_including_first_buffer =
+      hdr->data_length - b->current_length;
 
   return s;
 }
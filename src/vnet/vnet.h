@@ -45,6 +45,7 @@
 #include <vppinfra/types.h>
 
 #include <vppinfra/pcap.h>
+#include <vppinfra/mpcap.h>
 #include <vnet/error.h>
 #include <vnet/buffer.h>
 #include <vnet/config.h>
@@ -73,6 +74,12 @@ typedef struct
   u32 filter_classify_table_index;
   vlib_is_packet_traced_fn_t *current_filter_function;
   vlib_error_t pcap_error_index;
+  /* Per-worker mmapped capture files, written without locking */
+  u8 pcap_per_worker;
+  u32 pcap_rotate_files;
+  u8 *pcap_file_stem;
+  mpcap_main_t *worker_mpcaps;
+  u32 *worker_file_seq;
 } vnet_pcap_t;
 
 typedef struct vnet_main_t
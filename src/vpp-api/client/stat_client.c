@@ -257,6 +257,16 @@ copy_data (vlib_stats_entry_t *ep, u32 index2, char *name,
 	}
       break;
 
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+      simple_c = stat_segment_adjust (sm, ep->data);
+      result.histogram_vec = stat_vec_dup (sm, simple_c);
+      for (i = 0; i < vec_len (simple_c); i++)
+	{
+	  counter_t *cb = stat_segment_adjust (sm, simple_c[i]);
+	  result.histogram_vec[i] = stat_vec_dup (sm, cb);
+	}
+      break;
+
     case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
       combined_c = stat_segment_adjust (sm, ep->data);
       result.combined_counter_vec = stat_vec_dup (sm, combined_c);
@@ -315,6 +325,11 @@ stat_segment_data_free (stat_segment_data_t * res)
 	    vec_free (res[i].simple_counter_vec[j]);
 	  vec_free (res[i].simple_counter_vec);
 	  break;
+	case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+	  for (j = 0; j < vec_len (res[i].histogram_vec); j++)
+	    vec_free (res[i].histogram_vec[j]);
+	  vec_free (res[i].histogram_vec);
+	  break;
 	case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
 	  for (j = 0; j < vec_len (res[i].combined_counter_vec); j++)
 	    vec_free (res[i].combined_counter_vec[j]);
@@ -470,6 +485,135 @@ stat_segment_string_vector (uint8_t ** string_vector, const char *string)
   return string_vector;
 }
 
+/*
+ * Entries copied per access window by stat_segment_dump_delta_r. The
+ * segment is only locked while the directory changes, so short windows
+ * keep the copy of a large dump from racing a concurrent lock.
+ */
+#define STAT_SEGMENT_DELTA_CHUNK 256
+
+static bool
+stat_vec_equal (void *a, void *b, size_t elt_size)
+{
+  if (vec_len (a) != vec_len (b))
+    return false;
+  return vec_len (a) == 0 || memcmp (a, b, vec_len (a) * elt_size) == 0;
+}
+
+static bool
+stat_segment_data_equal (stat_segment_data_t *a, stat_segment_data_t *b)
+{
+  int i;
+
+  if (a->type != b->type || strcmp (a->name, b->name))
+    return false;
+
+  switch (a->type)
+    {
+    case STAT_DIR_TYPE_SCALAR_INDEX:
+      return a->scalar_value == b->scalar_value;
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+      if (vec_len (a->simple_counter_vec) != vec_len (b->simple_counter_vec))
+	return false;
+      for (i = 0; i < vec_len (a->simple_counter_vec); i++)
+	if (!stat_vec_equal (a->simple_counter_vec[i], b->simple_counter_vec[i],
+			     sizeof (counter_t)))
+	  return false;
+      return true;
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+      if (vec_len (a->combined_counter_vec) !=
+	  vec_len (b->combined_counter_vec))
+	return false;
+      for (i = 0; i < vec_len (a->combined_counter_vec); i++)
+	if (!stat_vec_equal (a->combined_counter_vec[i],
+			     b->combined_counter_vec[i],
+			     sizeof (vlib_counter_t)))
+	  return false;
+      return true;
+
+    case STAT_DIR_TYPE_NAME_VECTOR:
+      if (vec_len (a->name_vector) != vec_len (b->name_vector))
+	return false;
+      for (i = 0; i < vec_len (a->name_vector); i++)
+	if (!stat_vec_equal (a->name_vector[i], b->name_vector[i], 1))
+	  return false;
+      return true;
+
+    default:
+      return true;
+    }
+}
+
+/*
+ * Dump the entries in stats and return the positions in stats of those
+ * that changed since the previous call. *snapshot holds the values read
+ * by the previous call and is replaced by the current ones on success;
+ * a null *snapshot makes every entry changed. Entries are read in short
+ * access windows rather than in one window over the whole dump. Returns
+ * 0 if the directory changed, in which case *snapshot is left as it was
+ * and the caller has to list the entries again.
+ */
+uint32_t *
+stat_segment_dump_delta_r (uint32_t *stats, stat_segment_data_t **snapshot,
+			   stat_client_main_t *sm)
+{
+  stat_segment_data_t *res = 0, *last = *snapshot;
+  stat_segment_access_t sa;
+  uint32_t *changed = 0;
+  vlib_stats_entry_t *ep;
+  int i, j, n;
+
+  /* Has directory been update? */
+  if (sm->shared_header->epoch != sm->current_epoch)
+    return 0;
+
+  vec_alloc (res, vec_len (stats));
+  /* non-null even if nothing changed, as for stat_segment_dump_r */
+  vec_alloc (changed, 1);
+
+  for (i = 0; i < vec_len (stats); i += n)
+    {
+      n = clib_min (vec_len (stats) - i, STAT_SEGMENT_DELTA_CHUNK);
+
+      if (stat_segment_access_start (&sa, sm) ||
+	  sa.epoch != sm->current_epoch)
+	goto failed;
+
+      for (j = 0; j < n; j++)
+	{
+	  ep = vec_elt_at_index (sm->directory_vector, stats[i + j]);
+	  vec_add1 (res, copy_data (ep, ~0, 0, sm, false));
+	}
+
+      if (!stat_segment_access_end (&sa, sm))
+	goto failed;
+    }
+
+  for (i = 0; i < vec_len (res); i++)
+    if (vec_len (last) != vec_len (res) ||
+	!stat_segment_data_equal (&res[i], &last[i]))
+      vec_add1 (changed, i);
+
+  stat_segment_data_free (last);
+  *snapshot = res;
+  return changed;
+
+failed:
+  stat_segment_data_free (res);
+  vec_free (changed);
+  return 0;
+}
+
+uint32_t *
+stat_segment_dump_delta (uint32_t *stats, stat_segment_data_t **snapshot)
+{
+  stat_client_main_t *sm = &stat_client_main;
+  return stat_segment_dump_delta_r (stats, snapshot, sm);
+}
+
 stat_segment_data_t *
 stat_segment_dump_entry_r (uint32_t index, stat_client_main_t * sm)
 {
@@ -500,6 +644,156 @@ stat_segment_dump_entry (uint32_t index)
   return stat_segment_dump_entry_r (index, sm);
 }
 
+void
+stat_segment_view_free (stat_segment_view_t *v)
+{
+  free (v->threads);
+  free (v->raw_threads);
+  memset (v, 0, sizeof (*v));
+}
+
+/*
+ * Resolve a directory index into a zero-copy view. Symlinks are followed
+ * to the counter they point at. Only counter entries (simple, combined
+ * and histograms) have views. Returns 0 on success, -1 if the entry has
+ * no view or the directory changed while resolving.
+ */
+int
+stat_segment_view_resolve_r (uint32_t index, stat_segment_view_t *v,
+			     stat_client_main_t *sm)
+{
+  vlib_stats_entry_t *ep;
+  stat_segment_access_t sa;
+  void **threads;
+  uint32_t i, n;
+
+  memset (v, 0, sizeof (*v));
+
+  if (stat_segment_access_start (&sa, sm))
+    return -1;
+
+  if (index >= vec_len (sm->directory_vector))
+    goto failed;
+
+  v->index = v->entry_index = index;
+  ep = vec_elt_at_index (sm->directory_vector, index);
+
+  if (ep->type == STAT_DIR_TYPE_SYMLINK)
+    {
+      v->entry_index = ep->index1;
+      v->first_elt = ep->index2;
+      v->n_elts = 1;
+      if (v->entry_index >= vec_len (sm->directory_vector))
+	goto failed;
+      ep = vec_elt_at_index (sm->directory_vector, v->entry_index);
+    }
+
+  if (ep->type != STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE &&
+      ep->type != STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED &&
+      ep->type != STAT_DIR_TYPE_HISTOGRAM_LOG2)
+    goto failed;
+
+  v->type = ep->type;
+  v->generation = ep->generation;
+  v->data = ep->data;
+
+  threads = stat_segment_adjust (sm, ep->data);
+  if (!threads)
+    goto failed;
+
+  v->n_threads = vec_len (threads);
+  v->threads = calloc (v->n_threads, sizeof (void *));
+  v->raw_threads = calloc (v->n_threads, sizeof (void *));
+
+  /* all threads are validated to the same length, take the shortest */
+  n = ~0;
+  for (i = 0; i < v->n_threads; i++)
+    {
+      v->raw_threads[i] = threads[i];
+      v->threads[i] = stat_segment_adjust (sm, threads[i]);
+      if (!v->threads[i])
+	goto failed;
+      n = clib_min (n, vec_len (v->threads[i]));
+    }
+
+  if (v->n_elts == 0)
+    v->n_elts = v->n_threads ? n : 0;
+  else if (v->first_elt >= n)
+    goto failed;
+
+  if (!stat_segment_access_end (&sa, sm))
+    goto failed;
+
+  v->epoch = sa.epoch;
+  return 0;
+
+failed:
+  stat_segment_view_free (v);
+  return -1;
+}
+
+int
+stat_segment_view_resolve (uint32_t index, stat_segment_view_t *v)
+{
+  stat_client_main_t *sm = &stat_client_main;
+  return stat_segment_view_resolve_r (index, v, sm);
+}
+
+/*
+ * Check that a view still points at live counters. While the segment
+ * epoch is unchanged this is a single load. After a directory change the
+ * entry's generation and counter vectors are compared with those seen
+ * at resolve time, so unrelated directory changes keep the view.
+ */
+bool
+stat_segment_view_valid_r (stat_segment_view_t *v, stat_client_main_t *sm)
+{
+  vlib_stats_shared_header_t *shared_header = sm->shared_header;
+  vlib_stats_entry_t *ep = 0;
+  stat_segment_access_t sa;
+  void **threads;
+  bool valid;
+  uint32_t i;
+
+  if (!v->threads)
+    return false;
+
+  if (shared_header->epoch == v->epoch && !shared_header->in_progress)
+    return true;
+
+  if (stat_segment_access_start (&sa, sm))
+    return false;
+
+  valid = v->entry_index < vec_len (sm->directory_vector);
+  if (valid)
+    {
+      ep = vec_elt_at_index (sm->directory_vector, v->entry_index);
+      valid = ep->generation == v->generation && ep->type == v->type &&
+	      ep->data == v->data;
+    }
+  if (valid)
+    {
+      threads = stat_segment_adjust (sm, ep->data);
+      valid = threads && vec_len (threads) == v->n_threads;
+      for (i = 0; valid && i < v->n_threads; i++)
+	valid = threads[i] == v->raw_threads[i];
+    }
+
+  if (!stat_segment_access_end (&sa, sm))
+    return false;
+
+  if (valid)
+    v->epoch = sa.epoch;
+  return valid;
+}
+
+bool
+stat_segment_view_valid (stat_segment_view_t *v)
+{
+  stat_client_main_t *sm = &stat_client_main;
+  return stat_segment_view_valid_r (v, sm);
+}
+
 char *
 stat_segment_index_to_name_r (uint32_t index, stat_client_main_t * sm)
 {
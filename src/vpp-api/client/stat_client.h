@@ -42,6 +42,7 @@ typedef struct
     double scalar_value;
     counter_t *error_vector;
     counter_t **simple_counter_vec;
+    counter_t **histogram_vec;
     vlib_counter_t **combined_counter_vec;
     uint8_t **name_vector;
   };
@@ -73,6 +74,11 @@ uint32_t *stat_segment_ls (uint8_t ** pattern);
 stat_segment_data_t *stat_segment_dump_r (uint32_t * stats,
 					  stat_client_main_t * sm);
 stat_segment_data_t *stat_segment_dump (uint32_t * counter_vec);
+uint32_t *stat_segment_dump_delta_r (uint32_t *stats,
+				     stat_segment_data_t **snapshot,
+				     stat_client_main_t *sm);
+uint32_t *stat_segment_dump_delta (uint32_t *stats,
+				   stat_segment_data_t **snapshot);
 stat_segment_data_t *stat_segment_dump_entry_r (uint32_t index,
 						stat_client_main_t * sm);
 stat_segment_data_t *stat_segment_dump_entry (uint32_t index);
@@ -81,6 +87,37 @@ void stat_segment_data_free (stat_segment_data_t * res);
 double stat_segment_heartbeat_r (stat_client_main_t * sm);
 double stat_segment_heartbeat (void);
 
+/*
+ * Zero-copy view of a counter entry. It is resolved once from a directory
+ * index (as returned by stat_segment_ls) and then points straight at the
+ * per-thread counter vectors in the segment, so reading it allocates and
+ * copies nothing. Values read through a view are only good if
+ * stat_segment_view_valid_r() still returns true afterwards; once it
+ * returns false the view has to be resolved again.
+ */
+typedef struct
+{
+  uint32_t index;	/* directory index the view was resolved from */
+  uint32_t entry_index; /* entry holding the counters, differs for symlinks */
+  uint32_t generation;	/* of entry_index when resolved */
+  stat_directory_type_t type; /* of entry_index */
+  uint32_t first_elt;	      /* first counter covered in each thread */
+  uint32_t n_elts;	      /* counters covered in each thread */
+  uint32_t n_threads;
+  uint64_t epoch;  /* segment epoch the view was last validated at */
+  void *data;	   /* entry data when resolved, segment address */
+  void **threads;  /* per-thread counter_t / vlib_counter_t arrays */
+  void **raw_threads; /* same, segment addresses */
+} stat_segment_view_t;
+
+int stat_segment_view_resolve_r (uint32_t index, stat_segment_view_t *v,
+				 stat_client_main_t *sm);
+int stat_segment_view_resolve (uint32_t index, stat_segment_view_t *v);
+bool stat_segment_view_valid_r (stat_segment_view_t *v,
+				stat_client_main_t *sm);
+bool stat_segment_view_valid (stat_segment_view_t *v);
+void stat_segment_view_free (stat_segment_view_t *v);
+
 char *stat_segment_index_to_name_r (uint32_t index, stat_client_main_t * sm);
 char *stat_segment_index_to_name (uint32_t index);
 uint64_t stat_segment_version (void);
@@ -170,6 +207,61 @@ stat_segment_access_end (stat_segment_access_t * sa, stat_client_main_t * sm)
   return true;
 }
 
+/* counters of one thread in a simple counter or histogram view */
+static inline counter_t *
+stat_segment_view_simple (stat_segment_view_t *v, uint32_t thread)
+{
+  return (counter_t *) v->threads[thread] + v->first_elt;
+}
+
+/* counters of one thread in a combined counter view */
+static inline vlib_counter_t *
+stat_segment_view_combined (stat_segment_view_t *v, uint32_t thread)
+{
+  return (vlib_counter_t *) v->threads[thread] + v->first_elt;
+}
+
+/*
+ * Sum a simple counter view over all threads into sum[0 .. n_elts - 1].
+ * The inner loop has no dependencies between elements so the compiler
+ * vectorizes it.
+ */
+static inline void
+stat_segment_view_sum_simple (stat_segment_view_t *v, counter_t *sum)
+{
+  uint32_t t, i;
+
+  for (i = 0; i < v->n_elts; i++)
+    sum[i] = 0;
+
+  for (t = 0; t < v->n_threads; t++)
+    {
+      const counter_t *c = stat_segment_view_simple (v, t);
+      for (i = 0; i < v->n_elts; i++)
+	sum[i] += c[i];
+    }
+}
+
+/* as above, packets and bytes of a combined counter view */
+static inline void
+stat_segment_view_sum_combined (stat_segment_view_t *v, vlib_counter_t *sum)
+{
+  uint32_t t, i;
+
+  for (i = 0; i < v->n_elts; i++)
+    sum[i].packets = sum[i].bytes = 0;
+
+  for (t = 0; t < v->n_threads; t++)
+    {
+      const vlib_counter_t *c = stat_segment_view_combined (v, t);
+      for (i = 0; i < v->n_elts; i++)
+	{
+	  sum[i].packets += c[i].packets;
+	  sum[i].bytes += c[i].bytes;
+	}
+    }
+}
+
 #endif /* included_stat_client_h */
 
 /*
@@ -412,6 +412,8 @@ class StatsEntry:
             self.function = self.name
         elif stattype == 6:
             self.function = self.symlink
+        elif stattype == 7:
+            self.function = self.histogram
         else:
             self.function = self.illegal
 
@@ -439,6 +441,10 @@ class StatsEntry:
             counter.append(clist)
         return counter
 
+    def histogram(self, stats):
+        """Log2 histogram, a list of bucket counts per thread"""
+        return self.simple(stats)
+
     def name(self, stats):
         """Name counter"""
         counter = []
@@ -99,6 +99,9 @@ struct vapi_ctx_s
   bool handle_keepalives;
   pthread_mutex_t requests_mutex;
   bool use_uds;
+  /* messages held back by vapi_cork, sent by vapi_uncork */
+  bool corked;
+  void **corked_msgs;
 
   svm_queue_t *vl_input_queue;
   clib_socket_t client_socket;
@@ -342,6 +345,7 @@ vapi_ctx_free (vapi_ctx_t ctx)
   free (ctx->vapi_msg_id_t_to_vl_msg_id);
   free (ctx->event_cbs);
   free (ctx->vl_msg_id_to_vapi_msg_t);
+  vec_free (ctx->corked_msgs);
   pthread_mutex_destroy (&ctx->requests_mutex);
   free (ctx);
 }
@@ -1460,6 +1464,12 @@ vapi_send (vapi_ctx_t ctx, void *msg)
       goto out;
     }
 
+  if (ctx->corked)
+    {
+      vec_add1 (ctx->corked_msgs, msg);
+      goto out;
+    }
+
   if (ctx->use_uds)
     {
       rv = vapi_sock_send (ctx, msg);
@@ -1505,6 +1515,13 @@ vapi_send2 (vapi_ctx_t ctx, void *msg1, void *msg2)
       goto out;
     }
 
+  if (ctx->corked)
+    {
+      vec_add1 (ctx->corked_msgs, msg1);
+      vec_add1 (ctx->corked_msgs, msg2);
+      goto out;
+    }
+
   if (ctx->use_uds)
     {
       rv = vapi_sock_send2 (ctx, msg1, msg2);
@@ -1519,6 +1536,133 @@ out:
   return rv;
 }
 
+/* messages written per sendmsg call, two iovecs each */
+#define VAPI_SOCK_SEND_N_MAX 256
+
+/* send the first n corked messages, returns the number sent */
+static int
+vapi_sock_send_n (vapi_ctx_t ctx, void **msgs, int n)
+{
+  msgbuf_t msgbufs[VAPI_SOCK_SEND_N_MAX];
+  struct iovec bufs[2 * VAPI_SOCK_SEND_N_MAX], *iov = bufs;
+  struct msghdr hdr;
+  int i, n_sent = 0;
+  ssize_t len;
+
+  while (n_sent < n)
+    {
+      int n_msgs = clib_min (n - n_sent, VAPI_SOCK_SEND_N_MAX);
+      int n_iov = 2 * n_msgs;
+
+      for (i = 0; i < n_msgs; i++)
+	{
+	  u8 *msg = msgs[n_sent + i];
+	  msgbufs[i] = (msgbuf_t){ .data_len = htonl (vec_len (msg)) };
+	  bufs[2 * i] = (struct iovec){ .iov_base = &msgbufs[i],
+					.iov_len = sizeof (msgbufs[i]) };
+	  bufs[2 * i + 1] =
+	    (struct iovec){ .iov_base = msg, .iov_len = vec_len (msg) };
+	}
+
+      /* a partial write must be completed to keep the stream framed */
+      iov = bufs;
+      while (n_iov)
+	{
+	  clib_memset (&hdr, 0, sizeof (hdr));
+	  hdr.msg_iov = iov;
+	  hdr.msg_iovlen = n_iov;
+	  len = sendmsg (ctx->client_socket.fd, &hdr, 0);
+	  if (len < 0)
+	    {
+	      if (errno == EINTR || errno == EAGAIN)
+		continue;
+	      return n_sent;
+	    }
+	  while (n_iov && len >= iov->iov_len)
+	    {
+	      len -= iov->iov_len;
+	      iov++;
+	      n_iov--;
+	    }
+	  if (n_iov)
+	    {
+	      iov->iov_base = (u8 *) iov->iov_base + len;
+	      iov->iov_len -= len;
+	    }
+	}
+
+      for (i = 0; i < n_msgs; i++)
+	vec_free (msgs[n_sent + i]);
+      n_sent += n_msgs;
+    }
+
+  return n_sent;
+}
+
+/* send the first n corked messages, returns the number sent */
+static int
+vapi_shm_send_n (vapi_ctx_t ctx, void **msgs, int n)
+{
+  svm_queue_t *q = vlibapi_get_main ()->shmem_hdr->vl_input_queue;
+  int i;
+
+  svm_queue_lock (q);
+  for (i = 0; i < n && !svm_queue_is_full (q); i++)
+    {
+#if VAPI_DEBUG
+      vapi_debug_log (ctx, msgs[i], "send");
+#endif
+      /* vpp is signalled once, when the queue stops being empty */
+      svm_queue_add_raw (q, (u8 *) &msgs[i]);
+      VL_MSG_API_POISON (msgs[i]);
+    }
+  svm_queue_unlock (q);
+
+  return i;
+}
+
+vapi_error_e
+vapi_cork (vapi_ctx_t ctx)
+{
+  vapi_error_e rv;
+
+  if (!ctx || !ctx->connected || !vapi_is_nonblocking (ctx))
+    return VAPI_EINVAL;
+
+  if (VAPI_OK != (rv = vapi_producer_lock (ctx)))
+    return rv;
+  ctx->corked = true;
+  return vapi_producer_unlock (ctx);
+}
+
+vapi_error_e
+vapi_uncork (vapi_ctx_t ctx)
+{
+  vapi_error_e rv, urv;
+  int n, n_sent;
+
+  if (!ctx || !ctx->connected)
+    return VAPI_EINVAL;
+
+  if (VAPI_OK != (rv = vapi_producer_lock (ctx)))
+    return rv;
+
+  n = vec_len (ctx->corked_msgs);
+  if (ctx->use_uds)
+    n_sent = vapi_sock_send_n (ctx, ctx->corked_msgs, n);
+  else
+    n_sent = vapi_shm_send_n (ctx, ctx->corked_msgs, n);
+
+  vec_delete (ctx->corked_msgs, n_sent, 0);
+  if (n_sent < n)
+    rv = ctx->use_uds ? vapi_sock_get_errno (errno) : VAPI_EAGAIN;
+  else
+    ctx->corked = false;
+
+  urv = vapi_producer_unlock (ctx);
+  return rv != VAPI_OK ? rv : urv;
+}
+
 static vapi_error_e
 vapi_shm_recv (vapi_ctx_t ctx, void **msg, size_t *msg_size,
 	       svm_q_conditional_wait_t cond, u32 time)
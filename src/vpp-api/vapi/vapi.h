@@ -196,6 +196,33 @@ vapi_error_e vapi_send (vapi_ctx_t ctx, void *msg);
  */
 vapi_error_e vapi_send2 (vapi_ctx_t ctx, void *msg1, void *msg2);
 
+/**
+ * @brief hold back the messages sent from now on, in non-blocking mode
+ *
+ * Requests made with the generated api are stored as usual, so many
+ * requests can be built and then handed to vpp at once by vapi_uncork,
+ * taking the queue lock and waking up vpp once rather than per message.
+ *
+ * @param ctx opaque vapi context
+ *
+ * @return VAPI_OK on success, other error code on error
+ */
+vapi_error_e vapi_cork (vapi_ctx_t ctx);
+
+/**
+ * @brief send the messages held back since vapi_cork, in order, and stop
+ * holding messages back
+ *
+ * @note if the shared memory queue fills up, the messages which did not fit
+ * stay held back and VAPI_EAGAIN is returned, call vapi_uncork again after
+ * dispatching some responses
+ *
+ * @param ctx opaque vapi context
+ *
+ * @return VAPI_OK on success, other error code on error
+ */
+vapi_error_e vapi_uncork (vapi_ctx_t ctx);
+
 /**
  * @brief low-level api for reading messages from vpp
  *
@@ -245,6 +245,26 @@ public:
     return vapi_get_fd (vapi_ctx, fd);
   }
 
+  /**
+   * @brief hold back requests sent from now on, until uncork, see vapi_cork
+   *
+   * @return VAPI_OK on success, other error code on error
+   */
+  vapi_error_e cork ()
+  {
+    return vapi_cork (vapi_ctx);
+  }
+
+  /**
+   * @brief send the requests held back since cork, see vapi_uncork
+   *
+   * @return VAPI_OK on success, other error code on error
+   */
+  vapi_error_e uncork ()
+  {
+    return vapi_uncork (vapi_ctx);
+  }
+
   /**
    * @brief wait for responses from vpp and assign them to appropriate objects
    *
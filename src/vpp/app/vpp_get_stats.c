@@ -223,6 +223,26 @@ reconnect:
 			   res[i].name);
 	      break;
 
+	    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+	      for (k = 0; k < vec_len (res[i].histogram_vec); k++)
+		{
+		  counter_t *h = res[i].histogram_vec[k];
+		  u32 n = vec_len (h);
+		  u64 total = 0;
+
+		  for (j = 0; j < n; j++)
+		    total += h[j];
+		  if (total == 0)
+		    continue;
+		  fformat (stdout,
+			   "[@ %d]: %llu samples, p50 %llu p99 %llu "
+			   "p999 %llu %s\n",
+			   k, total, stat_histogram_quantile (h, n, 0.5),
+			   stat_histogram_quantile (h, n, 0.99),
+			   stat_histogram_quantile (h, n, 0.999), res[i].name);
+		}
+	      break;
+
 	    case STAT_DIR_TYPE_SCALAR_INDEX:
 	      fformat (stdout, "%.2f %s\n", res[i].scalar_value, res[i].name);
 	      break;
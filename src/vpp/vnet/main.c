@@ -311,6 +311,16 @@ defaulted:
 				 unformat_log2_page_size,
 				 &default_log2_hugepage_sz))
 		;
+	      else if (unformat (&sub_input, "table-heap-threshold %U",
+				 unformat_memory_size,
+				 &clib_mem_main.table_heap_threshold))
+		;
+	      else if (unformat (&sub_input, "table-heap-page-size %U",
+				 unformat_log2_page_size,
+				 &clib_mem_main.log2_table_heap_page_sz))
+		;
+	      else if (unformat (&sub_input, "table-heap-interleave"))
+		clib_mem_main.table_heap_interleave = 1;
 	      else
 		{
 		  fformat (stderr, "unknown 'memory' config input '%U'\n",
@@ -514,7 +524,9 @@ vlib_app_num_thread_stacks_needed (void)
  * messages!
  */
 
+#include <ctype.h>
 #include <vppinfra/bihash_8_8.h>
+#include <vlib/stats/stats.h>
 
 static clib_error_t *
 show_bihash_command_fn (vlib_main_t * vm,
@@ -543,6 +555,233 @@ VLIB_CLI_COMMAND (show_bihash_command, static) =
   .function = show_bihash_command_fn,
 };
 
+/*
+ * Bihash telemetry and auto-grow. Every BIHASH_MAINT_SCAN_INTERVAL the
+ * occupancy of each table on clib_all_bihashes goes to the stats segment
+ * under /sys/bihash/<name>/, and tables created with auto_grow set get
+ * their bucket array doubled once their occupancy asks for it.
+ */
+
+#define BIHASH_MAINT_SCAN_INTERVAL 10.0
+#define BIHASH_MAINT_GROW_INTERVAL 1e-3
+#define BIHASH_MAINT_GROW_BUDGET   1024
+
+#define foreach_bihash_gauge                                                  \
+  _ (elts, o->n_elts)                                                         \
+  _ (buckets, o->n_buckets)                                                   \
+  _ (buckets_used, o->n_buckets_used)                                         \
+  _ (overflow_buckets, o->n_overflow_buckets)                                 \
+  _ (linear_buckets, o->n_linear_buckets)                                     \
+  _ (pages, o->n_pages)                                                       \
+  _ (load_pct, clib_bihash_occupancy_load_pct (o))                            \
+  _ (probe_depth_pct, o->n_elts ? o->probe_depth_sum * 100 / o->n_elts : 0)
+
+typedef enum
+{
+#define _(n, v) BIHASH_GAUGE_##n,
+  foreach_bihash_gauge
+#undef _
+    BIHASH_N_GAUGES,
+} bihash_gauge_t;
+
+typedef struct
+{
+  void *h;
+  u32 gauges[BIHASH_N_GAUGES];
+  u8 seen;
+  u8 growing;
+} bihash_maint_table_t;
+
+typedef struct
+{
+  bihash_maint_table_t *tables;
+  uword *table_index_by_h;
+} bihash_maint_main_t;
+
+static bihash_maint_main_t bihash_maint_main;
+
+static int
+bihash_maint_table_is_live (void *h)
+{
+  int i;
+
+  for (i = 0; i < vec_len (clib_all_bihashes); i++)
+    if (clib_all_bihashes[i] == h)
+      return 1;
+  return 0;
+}
+
+static void
+bihash_maint_table_add (bihash_maint_main_t *bm, clib_bihash_8_8_t *h)
+{
+  bihash_maint_table_t *t;
+  u8 *name, *dir, *c;
+  u32 suffix = 0;
+
+  name = format (0, "%s", h->name ? (char *) h->name : "unnamed");
+  vec_foreach (c, name)
+    if (!isalnum (*c) && *c != '-' && *c != '_')
+      *c = '_';
+
+  /* names aren't unique, number the duplicates */
+  dir = format (0, "%v", name);
+  while (vlib_stats_find_entry_index ("/sys/bihash/%v/elts", dir) !=
+	 STAT_SEGMENT_INDEX_INVALID)
+    {
+      vec_reset_length (dir);
+      dir = format (dir, "%v-%u", name, ++suffix);
+    }
+
+  pool_get_zero (bm->tables, t);
+  t->h = h;
+  hash_set (bm->table_index_by_h, h, t - bm->tables);
+
+#define _(n, v)                                                               \
+  t->gauges[BIHASH_GAUGE_##n] =                                               \
+    vlib_stats_add_gauge ("/sys/bihash/%v/%s", dir, #n);
+  foreach_bihash_gauge
+#undef _
+
+  vec_free (name);
+  vec_free (dir);
+}
+
+static void
+bihash_maint_table_del (bihash_maint_main_t *bm, bihash_maint_table_t *t)
+{
+  int i;
+
+  for (i = 0; i < BIHASH_N_GAUGES; i++)
+    if (t->gauges[i] != ~0)
+      vlib_stats_remove_entry (t->gauges[i]);
+  hash_unset (bm->table_index_by_h, t->h);
+  pool_put (bm->tables, t);
+}
+
+static void
+bihash_maint_scan (vlib_main_t *vm)
+{
+  bihash_maint_main_t *bm = &bihash_maint_main;
+  bihash_maint_table_t *t;
+  clib_bihash_occupancy_t _o, *o = &_o;
+  clib_bihash_8_8_t *h;
+  uword *p;
+  u32 ti, *to_del = 0;
+  int i;
+
+  pool_foreach (t, bm->tables)
+    t->seen = 0;
+
+  for (i = 0; i < vec_len (clib_all_bihashes); i++)
+    if ((p = hash_get (bm->table_index_by_h, clib_all_bihashes[i])))
+      pool_elt_at_index (bm->tables, p[0])->seen = 1;
+
+  /* tables freed or copied elsewhere since the last scan */
+  pool_foreach (t, bm->tables)
+    if (!t->seen)
+      vec_add1 (to_del, t - bm->tables);
+  vec_foreach_index (i, to_del)
+    bihash_maint_table_del (bm, pool_elt_at_index (bm->tables, to_del[i]));
+  vec_free (to_del);
+
+  for (i = 0; i < vec_len (clib_all_bihashes); i++)
+    {
+      /* only the type independent head of the table is looked at */
+      h = (clib_bihash_8_8_t *) clib_all_bihashes[i];
+      if (h->ops == 0)
+	continue;
+
+      if ((p = hash_get (bm->table_index_by_h, h)) == 0)
+	{
+	  bihash_maint_table_add (bm, h);
+	  p = hash_get (bm->table_index_by_h, h);
+	}
+      ti = p[0];
+      t = pool_elt_at_index (bm->tables, ti);
+
+      h->ops->get_occupancy (h, o);
+
+#define _(n, v)                                                               \
+  if (t->gauges[BIHASH_GAUGE_##n] != ~0)                                      \
+    vlib_stats_set_gauge (t->gauges[BIHASH_GAUGE_##n], v);
+      foreach_bihash_gauge
+#undef _
+
+      if (o->auto_grow && !t->growing && clib_bihash_occupancy_wants_grow (o))
+	{
+	  vlib_worker_thread_barrier_sync (vm);
+	  t->growing = h->ops->grow_start (h) == 0;
+	  vlib_worker_thread_barrier_release (vm);
+	}
+    }
+}
+
+static int
+bihash_maint_grow (vlib_main_t *vm)
+{
+  bihash_maint_main_t *bm = &bihash_maint_main;
+  bihash_maint_table_t *t;
+  clib_bihash_8_8_t *h;
+  int rv, n_growing = 0;
+
+  pool_foreach (t, bm->tables)
+    {
+      if (!t->growing)
+	continue;
+
+      h = t->h;
+      if (!bihash_maint_table_is_live (h))
+	{
+	  t->growing = 0;
+	  continue;
+	}
+
+      rv = h->ops->grow_step (h, BIHASH_MAINT_GROW_BUDGET);
+      if (rv == 1)
+	{
+	  vlib_worker_thread_barrier_sync (vm);
+	  h->ops->grow_commit (h);
+	  vlib_worker_thread_barrier_release (vm);
+	}
+      t->growing = rv >= 0;
+      n_growing += t->growing;
+    }
+
+  return n_growing;
+}
+
+static uword
+bihash_maint_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+		      vlib_frame_t *f)
+{
+  f64 next_scan = 0, now;
+  int n_growing = 0;
+
+  while (1)
+    {
+      vlib_process_wait_for_event_or_clock (
+	vm, n_growing ? BIHASH_MAINT_GROW_INTERVAL : BIHASH_MAINT_SCAN_INTERVAL);
+      vlib_process_get_events (vm, 0);
+
+      now = vlib_time_now (vm);
+      if (now >= next_scan)
+	{
+	  bihash_maint_scan (vm);
+	  next_scan = now + BIHASH_MAINT_SCAN_INTERVAL;
+	}
+
+      n_growing = bihash_maint_grow (vm);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (bihash_maint_process_node) = {
+  .function = bihash_maint_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "bihash-maint-process",
+};
+
 #ifdef CLIB_SANITIZE_ADDR
 /* default options for Address Sanitizer */
 const char *
@@ -41,6 +41,9 @@
 #define clib_atomic_cmp_and_swap_acq_relax(addr, exp, new, weak)              \
   __atomic_compare_exchange ((addr), (exp), (new), (weak), __ATOMIC_ACQUIRE,  \
 			     __ATOMIC_RELAXED)
+#define clib_atomic_cmp_and_swap_acq_rel_n(addr, exp, new, weak)              \
+  __atomic_compare_exchange_n ((addr), (exp), (new), (weak), __ATOMIC_ACQ_REL, \
+			       __ATOMIC_ACQUIRE)
 
 #define clib_atomic_test_and_set(a) __atomic_exchange_n(a, 1, __ATOMIC_ACQUIRE)
 #define clib_atomic_release(a) __atomic_store_n(a, 0, __ATOMIC_RELEASE)
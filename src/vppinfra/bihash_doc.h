@@ -254,6 +254,52 @@ void clib_bihash_prefetch_data (clib_bihash * h, u64 hash);
 int clib_bihash_search_inline_2
   (clib_bihash * h, clib_bihash_kv * search_key, clib_bihash_kv * valuep);
 
+/**
+ * Search a bi-hash table for a batch of keys with precomputed hashes
+ *
+ * @param h - the bi-hash table to search
+ * @param hashes - array of n_keys hash codes
+ * @param search_keys - array of n_keys (key,value) pairs to search for
+ * @param valuep - array of n_keys (key,value) pairs set to search results
+ * @param found_bmp - bitmap of round_pow2 (n_keys, 64) / 64 words, bit i
+ * set if search_keys[i] was found
+ * @param n_keys - number of keys, at most BIHASH_SEARCH_BATCH_MAX_KEYS
+ * @returns number of keys found
+ * @note bucket and (key,value) page prefetches are pipelined internally,
+ * callers should not prefetch
+ */
+u32 clib_bihash_search_batch_with_hash (clib_bihash *h, u64 *hashes,
+					clib_bihash_kv *search_keys,
+					clib_bihash_kv *valuep, u64 *found_bmp,
+					u32 n_keys);
+
+/**
+ * Search a bi-hash table for a batch of keys
+ *
+ * @note same as clib_bihash_search_batch_with_hash, computes the hashes
+ */
+u32 clib_bihash_search_batch (clib_bihash *h, clib_bihash_kv *search_keys,
+			      clib_bihash_kv *valuep, u64 *found_bmp,
+			      u32 n_keys);
+
+/**
+ * Start a new deferred free grace period
+ *
+ * @param h - the bi-hash table
+ * @returns epoch to hand to clib_bihash_reclaim_deferred once every reader
+ * has passed a quiescent point
+ * @note only meaningful for tables created with deferred_free set
+ */
+u64 clib_bihash_grace_period_start (clib_bihash *h);
+
+/**
+ * Reclaim pages retired before a grace period started
+ *
+ * @param h - the bi-hash table
+ * @param epoch - value returned by clib_bihash_grace_period_start
+ */
+void clib_bihash_reclaim_deferred (clib_bihash *h, u64 epoch);
+
 /**
  * Calback function for walking a bihash table
  *
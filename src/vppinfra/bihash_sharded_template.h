@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Sharded bihash: one bihash table per shard (typically per worker
+ * thread), so that writers on different workers never touch the same
+ * bucket locks, bucket cache lines or allocator lock.
+ *
+ * Inserts go to the shard picked by the caller, typically the owning
+ * worker as computed by the feature's handoff function. Lookups from
+ * the owner search only its own shard. Lookups from another thread use
+ * search_any, which consults a small directory - one byte per hash slot,
+ * holding the last shard which added a key hashing to that slot - before
+ * falling back to probing every shard.
+ *
+ * Include after a bihash type header, e.g.
+ *
+ *   #include <vppinfra/bihash_16_8.h>
+ *   #include <vppinfra/bihash_sharded_template.h>
+ *
+ * To instantiate the template multiple times in a single file,
+ * #undef __included_bihash_sharded_template_h__...
+ */
+#ifndef __included_bihash_sharded_template_h__
+#define __included_bihash_sharded_template_h__
+
+#include <vppinfra/bihash_template.h>
+
+/* directory hints are stored as shard index + 1, 0 meaning no hint */
+#define BIHASH_SHARDED_MAX_SHARDS 255
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  BVT (clib_bihash) h;
+} BVT (clib_bihash_shard);
+
+typedef struct
+{
+  /* vector of shards, each on its own cache line(s) */
+  BVT (clib_bihash_shard) * shards;
+
+  /* last shard to add a key hashing to a slot, + 1 */
+  u8 *directory;
+  u32 log2_directory_size;
+
+  u8 *name;
+} BVT (clib_bihash_sharded);
+
+static inline void BV (clib_bihash_sharded_init)
+  (BVT (clib_bihash_sharded) * sh, char *name, u32 n_shards,
+   u32 nbuckets_per_shard, uword memory_size_per_shard,
+   u32 log2_directory_size)
+{
+  BVT (clib_bihash_shard) * s;
+  u32 i = 0;
+
+  ASSERT (n_shards > 0 && n_shards <= BIHASH_SHARDED_MAX_SHARDS);
+  ASSERT (log2_directory_size > 0 && log2_directory_size <= 32);
+
+  sh->name = format (0, "%s%c", name, 0);
+  sh->log2_directory_size = log2_directory_size;
+  sh->shards = 0;
+  vec_validate_aligned (sh->shards, n_shards - 1, CLIB_CACHE_LINE_BYTES);
+  vec_validate_aligned (sh->directory, (1ULL << log2_directory_size) - 1,
+			CLIB_CACHE_LINE_BYTES);
+
+  vec_foreach (s, sh->shards)
+    {
+      BVT (clib_bihash_init2_args) a = {
+	.h = &s->h,
+	.name = (char *) format (0, "%s shard %u%c", name, i++, 0),
+	.nbuckets = nbuckets_per_shard,
+	.memory_size = memory_size_per_shard,
+	/* 'show bihash' walks the shards through the container */
+	.dont_add_to_all_bihash_list = 1,
+      };
+      BV (clib_bihash_init2) (&a);
+    }
+}
+
+static inline void BV (clib_bihash_sharded_free)
+  (BVT (clib_bihash_sharded) * sh)
+{
+  BVT (clib_bihash_shard) * s;
+
+  vec_foreach (s, sh->shards)
+    {
+      u8 *name = s->h.name;
+      BV (clib_bihash_free) (&s->h);
+      vec_free (name);
+    }
+  vec_free (sh->shards);
+  vec_free (sh->directory);
+  vec_free (sh->name);
+}
+
+static inline u32 BV (clib_bihash_sharded_n_shards)
+  (BVT (clib_bihash_sharded) * sh)
+{
+  return vec_len (sh->shards);
+}
+
+static inline BVT (clib_bihash) *
+  BV (clib_bihash_sharded_get_shard) (BVT (clib_bihash_sharded) * sh,
+				      u32 shard_index)
+{
+  return &vec_elt_at_index (sh->shards, shard_index)->h;
+}
+
+static inline u8 *BV (clib_bihash_sharded_directory_slot)
+  (BVT (clib_bihash_sharded) * sh, u64 hash)
+{
+  /* bucket selection uses the low bits of the hash, use the high bits */
+  return sh->directory + (hash >> (64 - sh->log2_directory_size));
+}
+
+static inline int BV (clib_bihash_sharded_add_del)
+  (BVT (clib_bihash_sharded) * sh, u32 shard_index,
+   BVT (clib_bihash_kv) * add_v, int is_add)
+{
+  u64 hash = BV (clib_bihash_hash) (add_v);
+  u8 *slot;
+  int rv;
+
+  rv = BV (clib_bihash_add_del_with_hash)
+    (BV (clib_bihash_sharded_get_shard) (sh, shard_index), add_v, hash,
+     is_add);
+
+  /* only write the shared directory line when the hint changes */
+  slot = BV (clib_bihash_sharded_directory_slot) (sh, hash);
+  if (rv == 0 && is_add && slot[0] != shard_index + 1)
+    slot[0] = shard_index + 1;
+
+  return rv;
+}
+
+/* Search the given shard only, e.g. from the owning worker */
+static inline int BV (clib_bihash_sharded_search)
+  (BVT (clib_bihash_sharded) * sh, u32 shard_index,
+   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
+{
+  return BV (clib_bihash_search_inline_2)
+    (BV (clib_bihash_sharded_get_shard) (sh, shard_index), search_key,
+     valuep);
+}
+
+/*
+ * Search all shards: the local shard first, then the directory hint, then
+ * everybody else. Sets *shard_index to the shard holding the key.
+ */
+static inline int BV (clib_bihash_sharded_search_any)
+  (BVT (clib_bihash_sharded) * sh, u32 local_shard_index,
+   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep,
+   u32 * shard_index)
+{
+  u64 hash = BV (clib_bihash_hash) (search_key);
+  u32 i, hint, n_shards = vec_len (sh->shards);
+
+  if (PREDICT_TRUE (local_shard_index < n_shards) &&
+      BV (clib_bihash_search_inline_2_with_hash)
+	(BV (clib_bihash_sharded_get_shard) (sh, local_shard_index), hash,
+	 search_key, valuep) == 0)
+    {
+      *shard_index = local_shard_index;
+      return 0;
+    }
+
+  hint = BV (clib_bihash_sharded_directory_slot) (sh, hash)[0];
+  if (hint && hint - 1 != local_shard_index &&
+      BV (clib_bihash_search_inline_2_with_hash)
+	(BV (clib_bihash_sharded_get_shard) (sh, hint - 1), hash, search_key,
+	 valuep) == 0)
+    {
+      *shard_index = hint - 1;
+      return 0;
+    }
+
+  for (i = 0; i < n_shards; i++)
+    {
+      if (i == local_shard_index || i + 1 == hint)
+	continue;
+      if (BV (clib_bihash_search_inline_2_with_hash)
+	  (BV (clib_bihash_sharded_get_shard) (sh, i), hash, search_key,
+	   valuep) == 0)
+	{
+	  *shard_index = i;
+	  return 0;
+	}
+    }
+
+  return -1;
+}
+
+static inline void BV (clib_bihash_sharded_foreach_key_value_pair)
+  (BVT (clib_bihash_sharded) * sh,
+   BV (clib_bihash_foreach_key_value_pair_cb) cb, void *arg)
+{
+  BVT (clib_bihash_shard) * s;
+
+  vec_foreach (s, sh->shards)
+    BV (clib_bihash_foreach_key_value_pair) (&s->h, cb, arg);
+}
+
+static inline u8 *BV (format_bihash_sharded) (u8 * s, va_list * args)
+{
+  BVT (clib_bihash_sharded) * sh =
+    va_arg (*args, BVT (clib_bihash_sharded) *);
+  int verbose = va_arg (*args, int);
+  BVT (clib_bihash_shard) * shard;
+
+  s = format (s, "Sharded hash table '%s', %u shards, directory %u slots\n",
+	      sh->name, vec_len (sh->shards), vec_len (sh->directory));
+
+  vec_foreach (shard, sh->shards)
+    s = format (s, "%U", BV (format_bihash), &shard->h, verbose);
+
+  return s;
+}
+
+#endif /* __included_bihash_sharded_template_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -139,44 +139,96 @@ static inline void *BV (alloc_aligned) (BVT (clib_bihash) * h, uword nbytes)
   return (void *) (uword) (rv + alloc_arena (h));
 }
 
-static void BV (clib_bihash_instantiate) (BVT (clib_bihash) * h)
+static const clib_bihash_ops_t BV (clib_bihash_ops);
+
+/* Give back an alloc_aligned () allocation which got a heap chunk of its
+   own, i.e. one at least chunk size big */
+static void
+BV (free_chunk) (BVT (clib_bihash) * h, void *p)
 {
-  uword bucket_size;
+  BVT (clib_bihash_alloc_chunk) * c;
+  void *oldheap;
 
-  if (BIHASH_USE_HEAP)
-    {
-      h->heap = clib_mem_get_heap ();
-      h->chunks = 0;
-      alloc_arena (h) = (uword) clib_mem_get_heap_base (h->heap);
-    }
+  c = (BVT (clib_bihash_alloc_chunk) *) p - 1;
+
+  if (c->prev)
+    c->prev->next = c->next;
   else
+    h->chunks = c->next;
+
+  if (c->next)
+    c->next->prev = c->prev;
+
+  oldheap = clib_mem_set_heap (h->heap);
+  clib_mem_free (c);
+  clib_mem_set_heap (oldheap);
+}
+
+/* Give back any alloc_aligned () allocation. Allocations smaller than a
+   chunk sit in the middle of one or in the arena, where space is never
+   reused, so release their OS pages instead */
+static void
+BV (free_aligned) (BVT (clib_bihash) * h, void *p, uword nbytes)
+{
+  nbytes = round_pow2 (nbytes, CLIB_CACHE_LINE_BYTES);
+
+  if (BIHASH_USE_HEAP &&
+      nbytes >= round_pow2 (sizeof (BVT (clib_bihash_value))
+			      << BIIHASH_MIN_ALLOC_LOG2_PAGES,
+			    CLIB_CACHE_LINE_BYTES))
     {
-      alloc_arena (h) = clib_mem_vm_reserve (0, h->memory_size,
-					     BIHASH_LOG2_HUGEPAGE_SIZE);
-      if (alloc_arena (h) == ~0)
-	os_out_of_memory ();
-      alloc_arena_next (h) = 0;
-      alloc_arena_size (h) = h->memory_size;
-      alloc_arena_mapped (h) = 0;
+      BV (free_chunk) (h, p);
+      return;
     }
 
-  bucket_size = h->nbuckets * sizeof (h->buckets[0]);
+#if BIHASH_32_64_SVM == 0
+  uword page_sz = clib_mem_get_page_size ();
+  uword start = round_pow2 ((uword) p, page_sz);
+  uword end = ((uword) p + nbytes) & ~(page_sz - 1);
+
+  if (end > start)
+    madvise ((void *) start, end - start, MADV_DONTNEED);
+#endif
+}
+
+static inline uword
+BV (buckets_size) (u32 nbuckets)
+{
+  uword bucket_size = nbuckets * sizeof (BVT (clib_bihash_bucket));
 
   if (BIHASH_KVP_AT_BUCKET_LEVEL)
     bucket_size +=
-      h->nbuckets * BIHASH_KVP_PER_PAGE * sizeof (BVT (clib_bihash_kv));
+      nbuckets * BIHASH_KVP_PER_PAGE * sizeof (BVT (clib_bihash_kv));
 
-  h->buckets = BV (alloc_aligned) (h, bucket_size);
-  clib_memset_u8 (h->buckets, 0, bucket_size);
+  return bucket_size;
+}
+
+static inline BVT (clib_bihash_bucket) *
+BV (bucket_at) (BVT (clib_bihash_bucket) * buckets, uword index)
+{
+#if BIHASH_KVP_AT_BUCKET_LEVEL
+  return (void *) ((u8 *) buckets +
+		   index * (sizeof (BVT (clib_bihash_bucket)) +
+			    BIHASH_KVP_PER_PAGE * sizeof (BVT (clib_bihash_kv))));
+#else
+  return buckets + index;
+#endif
+}
+
+static void
+BV (init_buckets) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * buckets,
+		   u32 nbuckets)
+{
+  clib_memset_u8 (buckets, 0, BV (buckets_size) (nbuckets));
 
   if (BIHASH_KVP_AT_BUCKET_LEVEL)
     {
       int i, j;
       BVT (clib_bihash_bucket) * b;
 
-      b = h->buckets;
+      b = buckets;
 
-      for (i = 0; i < h->nbuckets; i++)
+      for (i = 0; i < nbuckets; i++)
 	{
 	  BVT (clib_bihash_kv) * v;
 	  b->offset = BV (clib_bihash_get_offset) (h, (void *) (b + 1));
@@ -194,6 +246,47 @@ static void BV (clib_bihash_instantiate) (BVT (clib_bihash) * h)
 			 sizeof (BVT (clib_bihash_kv))));
 	}
     }
+}
+
+static void BV (clib_bihash_instantiate) (BVT (clib_bihash) * h)
+{
+  if (BIHASH_USE_HEAP)
+    {
+      clib_mem_main_t *mm = &clib_mem_main;
+
+      h->heap = 0;
+      h->own_heap = 0;
+      /*
+       * Large tables get a heap of their own, on hugepages if configured.
+       * Bucket offsets are relative to the heap base, so the heap can't
+       * exceed 64 Gbytes.
+       */
+      if (mm->table_heap_threshold &&
+	  h->memory_size >= mm->table_heap_threshold &&
+	  h->memory_size < (1ULL << BIHASH_BUCKET_OFFSET_BITS))
+	{
+	  h->heap = clib_mem_create_table_heap (h->memory_size,
+						(char *) h->name);
+	  h->own_heap = h->heap != 0;
+	}
+      if (h->heap == 0)
+	h->heap = clib_mem_get_heap ();
+      h->chunks = 0;
+      alloc_arena (h) = (uword) clib_mem_get_heap_base (h->heap);
+    }
+  else
+    {
+      alloc_arena (h) = clib_mem_vm_reserve (0, h->memory_size,
+					     BIHASH_LOG2_HUGEPAGE_SIZE);
+      if (alloc_arena (h) == ~0)
+	os_out_of_memory ();
+      alloc_arena_next (h) = 0;
+      alloc_arena_size (h) = h->memory_size;
+      alloc_arena_mapped (h) = 0;
+    }
+
+  h->buckets = BV (alloc_aligned) (h, BV (buckets_size) (h->nbuckets));
+  BV (init_buckets) (h, h->buckets, h->nbuckets);
   CLIB_MEMORY_STORE_BARRIER ();
   h->instantiated = 1;
 }
@@ -209,22 +302,24 @@ void BV (clib_bihash_init2) (BVT (clib_bihash_init2_args) * a)
   h->name = (u8 *) a->name;
   h->nbuckets = a->nbuckets;
   h->log2_nbuckets = max_log2 (a->nbuckets);
-  h->memory_size = BIHASH_USE_HEAP ? 0 : a->memory_size;
+  h->memory_size = a->memory_size;
   h->instantiated = 0;
   h->dont_add_to_all_bihash_list = a->dont_add_to_all_bihash_list;
+  h->deferred_free = a->deferred_free;
+  h->free_epoch = 0;
+  h->compact_next_bucket = 0;
+  h->compact_released_bytes = 0;
+  h->auto_grow = a->auto_grow;
+  h->grow_lock = 0;
+  h->grow_next_bucket = 0;
+  h->grow_buckets = 0;
+  h->grow_old_buckets = 0;
   h->fmt_fn = BV (format_bihash);
+  h->ops = &BV (clib_bihash_ops);
   h->kvp_fmt_fn = a->kvp_fmt_fn;
 
   alloc_arena (h) = 0;
 
-  /*
-   * Make sure the requested size is rational. The max table
-   * size without playing the alignment card is 64 Gbytes.
-   * If someone starts complaining that's not enough, we can shift
-   * the offset by CLIB_LOG2_CACHE_LINE_BYTES...
-   */
-  if (BIHASH_USE_HEAP)
-    ASSERT (h->memory_size < (1ULL << BIHASH_BUCKET_OFFSET_BITS));
 
   /* Add this hash table to the list */
   if (a->dont_add_to_all_bihash_list == 0)
@@ -344,6 +439,7 @@ void BV (clib_bihash_initiator_init_svm)
   h->freelists = (void *) (freelist_vh->vector_data);
 
   h->fmt_fn = BV (format_bihash);
+  h->ops = &BV (clib_bihash_ops);
   h->kvp_fmt_fn = NULL;
   h->instantiated = 1;
 }
@@ -395,6 +491,7 @@ void BV (clib_bihash_responder_init_svm)
   h->alloc_lock = BV (clib_bihash_get_value) (h, h->sh->alloc_lock_as_u64);
   h->freelists = BV (clib_bihash_get_value) (h, h->sh->freelists_as_u64);
   h->fmt_fn = BV (format_bihash);
+  h->ops = &BV (clib_bihash_ops);
   h->kvp_fmt_fn = NULL;
 }
 #endif /* BIHASH_32_64_SVM */
@@ -432,10 +529,13 @@ void BV (clib_bihash_free) (BVT (clib_bihash) * h)
 	  chunk = next;
 	}
       clib_mem_set_heap (oldheap);
+      if (h->own_heap)
+	clib_mem_destroy_heap (h->heap);
     }
 
   vec_free (h->working_copies);
   vec_free (h->working_copy_lengths);
+  vec_free (h->deferred_frees);
   clib_mem_free ((void *) h->alloc_lock);
 #if BIHASH_32_64_SVM == 0
   vec_free (h->freelists);
@@ -513,21 +613,7 @@ BV (value_free) (BVT (clib_bihash) * h, BVT (clib_bihash_value) * v,
     {
       /* allocations bigger or equal to chunk size always contain single
        * alloc and they can be given back to heap */
-      void *oldheap;
-      BVT (clib_bihash_alloc_chunk) * c;
-      c = (BVT (clib_bihash_alloc_chunk) *) v - 1;
-
-      if (c->prev)
-	c->prev->next = c->next;
-      else
-	h->chunks = c->next;
-
-      if (c->next)
-	c->next->prev = c->prev;
-
-      oldheap = clib_mem_set_heap (h->heap);
-      clib_mem_free (c);
-      clib_mem_set_heap (oldheap);
+      BV (free_chunk) (h, v);
       return;
     }
 
@@ -535,9 +621,70 @@ BV (value_free) (BVT (clib_bihash) * h, BVT (clib_bihash_value) * v,
     clib_memset_u8 (v, 0xFE, sizeof (*v) * (1 << log2_pages));
 
   v->next_free_as_u64 = (u64) h->freelists[log2_pages];
+  v->free_released = 0;
   h->freelists[log2_pages] = (u64) BV (clib_bihash_get_offset) (h, v);
 }
 
+/*
+ * Free a page which readers may still be looking at. In deferred_free
+ * mode the page is parked until the current epoch's grace period is over.
+ */
+static void
+BV (value_free_published) (BVT (clib_bihash) * h,
+			   BVT (clib_bihash_value) * v, u32 log2_pages)
+{
+  BVT (clib_bihash_deferred_free) * df;
+
+  ASSERT (h->alloc_lock[0]);
+
+  if (PREDICT_TRUE (h->deferred_free == 0))
+    {
+      BV (value_free) (h, v, log2_pages);
+      return;
+    }
+
+  vec_add2 (h->deferred_frees, df, 1);
+  df->offset = BV (clib_bihash_get_offset) (h, v);
+  df->epoch = h->free_epoch;
+  df->log2_pages = log2_pages;
+}
+
+u64 BV (clib_bihash_grace_period_start) (BVT (clib_bihash) * h)
+{
+  u64 epoch;
+
+  BV (clib_bihash_alloc_lock) (h);
+  epoch = ++h->free_epoch;
+  BV (clib_bihash_alloc_unlock) (h);
+
+  return epoch;
+}
+
+void BV (clib_bihash_reclaim_deferred) (BVT (clib_bihash) * h, u64 epoch)
+{
+  BVT (clib_bihash_deferred_free) * df;
+  int i, n_left = 0;
+
+  BV (clib_bihash_alloc_lock) (h);
+
+  vec_foreach_index (i, h->deferred_frees)
+    {
+      df = vec_elt_at_index (h->deferred_frees, i);
+
+      /* retired during a grace period which is not over yet */
+      if (df->epoch >= epoch)
+	{
+	  h->deferred_frees[n_left++] = df[0];
+	  continue;
+	}
+      BV (value_free) (h, BV (clib_bihash_get_value) (h, df->offset),
+		       df->log2_pages);
+    }
+  vec_set_len (h->deferred_frees, n_left);
+
+  BV (clib_bihash_alloc_unlock) (h);
+}
+
 static inline void
 BV (make_working_copy) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
 {
@@ -594,7 +741,7 @@ BV (make_working_copy) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
 static
 BVT (clib_bihash_value) *
 BV (split_and_rehash)
-  (BVT (clib_bihash) * h,
+  (BVT (clib_bihash) * h, u32 log2_nbuckets,
    BVT (clib_bihash_value) * old_values, u32 old_log2_pages,
    u32 new_log2_pages)
 {
@@ -616,7 +763,7 @@ BV (split_and_rehash)
 
       /* rehash the item onto its new home-page */
       new_hash = BV (clib_bihash_hash) (&(old_values->kvp[i]));
-      new_hash = extract_bits (new_hash, h->log2_nbuckets, new_log2_pages);
+      new_hash = extract_bits (new_hash, log2_nbuckets, new_log2_pages);
       new_v = &new_values[new_hash];
 
       /* Across the new home-page */
@@ -686,12 +833,170 @@ BV (split_and_rehash_linear)
   return new_values;
 }
 
-static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
-  BVT (clib_bihash) * h, BVT (clib_bihash_kv) * add_v, u64 hash, int is_add,
+/*
+ * Shrink one bucket to the smallest page count which still holds its
+ * entries at no more than half load, so it doesn't split again right
+ * away. Returns the number of bytes freed.
+ */
+static uword
+BV (compact_bucket) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
+{
+  BVT (clib_bihash_bucket) tmp_b;
+  BVT (clib_bihash_value) * v, *new_v = 0;
+  u32 i, n_elts = 0, old_log2_pages, new_log2_pages;
+  u32 min_log2_pages = BIHASH_KVP_AT_BUCKET_LEVEL ? 1 : 0;
+
+  if (BV (clib_bihash_bucket_is_empty) (b) || b->log2_pages <= min_log2_pages)
+    return 0;
+
+  BV (clib_bihash_lock_bucket) (b);
+
+  /*
+   * The bucket lock keeps writers off the live page, so we can rehash
+   * straight from it. Readers either spin on the lock or, in
+   * deferred_free mode, keep using the live page until the new one is
+   * published.
+   */
+  old_log2_pages = b->log2_pages;
+  v = BV (clib_bihash_get_value) (h, b->offset);
+
+  for (i = 0; i < BIHASH_KVP_PER_PAGE << old_log2_pages; i++)
+    if (!BV (clib_bihash_is_free) (&(v->kvp[i])))
+      n_elts++;
+
+  new_log2_pages = min_log2_pages;
+  while (n_elts * 2 > BIHASH_KVP_PER_PAGE << new_log2_pages)
+    new_log2_pages++;
+
+  if (new_log2_pages >= old_log2_pages)
+    {
+      BV (clib_bihash_unlock_bucket) (b);
+      return 0;
+    }
+
+  BV (clib_bihash_alloc_lock) (h);
+
+  /* collisions may still need more pages than the load says */
+  for (; new_log2_pages < old_log2_pages; new_log2_pages++)
+    if ((new_v = BV (split_and_rehash) (h, h->log2_nbuckets, v,
+					old_log2_pages, new_log2_pages)))
+      break;
+
+  if (new_v == 0)
+    {
+      BV (clib_bihash_alloc_unlock) (h);
+      BV (clib_bihash_unlock_bucket) (b);
+      return 0;
+    }
+
+  tmp_b.as_u64 = b->as_u64;
+  tmp_b.offset = BV (clib_bihash_get_offset) (h, new_v);
+  tmp_b.log2_pages = new_log2_pages;
+  tmp_b.linear_search = 0;
+  tmp_b.lock = 0;
+  CLIB_MEMORY_STORE_BARRIER ();
+  b->as_u64 = tmp_b.as_u64; /* unlocks the bucket */
+
+  BV (value_free_published) (h, v, old_log2_pages);
+  BV (clib_bihash_alloc_unlock) (h);
+  BV (clib_bihash_increment_stat) (h, BIHASH_STAT_compact, 1);
+
+  return sizeof (*v) * ((1 << old_log2_pages) - (1 << new_log2_pages));
+}
+
+/*
+ * Give the OS pages inside free elements back with madvise. The first OS
+ * page of each element holds the freelist link and stays. Frees push and
+ * allocations pop at the head of a freelist, so released elements always
+ * form its tail and the walk stops at the first one.
+ */
+static uword
+BV (release_free_pages) (BVT (clib_bihash) * h, u32 budget)
+{
+  uword page_sz = clib_mem_get_page_size ();
+  uword released = 0;
+  int i;
+
+  ASSERT (h->alloc_lock[0]);
+
+#if BIHASH_32_64_SVM
+  /* shared memfd backing, MADV_DONTNEED wouldn't free anything */
+  return 0;
+#endif
+
+  for (i = vec_len (h->freelists) - 1; i >= 0 && budget; i--)
+    {
+      uword sz = sizeof (BVT (clib_bihash_value)) << i;
+      u64 offset = h->freelists[i];
+
+      if (sz < 2 * page_sz)
+	break;
+
+      while (offset && budget)
+	{
+	  BVT (clib_bihash_value) *v = BV (clib_bihash_get_value) (h, offset);
+	  uword start = round_pow2 ((uword) v + 1, page_sz);
+	  uword end = ((uword) v + sz) & ~(page_sz - 1);
+
+	  if (v->free_released)
+	    break;
+
+	  budget--;
+	  if (end > start && madvise ((void *) start, end - start,
+				      MADV_DONTNEED) == 0)
+	    released += end - start;
+	  v->free_released = 1;
+	  offset = v->next_free_as_u64;
+	}
+    }
+
+  return released;
+}
+
+uword BV (clib_bihash_compact) (BVT (clib_bihash) * h, u32 n_buckets)
+{
+  uword freed = 0, released;
+  u32 i;
+
+#if BIHASH_LAZY_INSTANTIATE
+  if (PREDICT_FALSE (h->instantiated == 0))
+    return 0;
+#endif
+
+  /* growth moves pages around on its own */
+  if (h->grow_buckets || h->grow_old_buckets)
+    return 0;
+
+  n_buckets = clib_min (n_buckets, h->nbuckets);
+
+  for (i = 0; i < n_buckets; i++)
+    {
+      u32 bucket_index = h->compact_next_bucket;
+
+      h->compact_next_bucket = (bucket_index + 1) & (h->nbuckets - 1);
+      freed += BV (compact_bucket) (h,
+				    BV (clib_bihash_get_bucket) (h, bucket_index));
+    }
+
+  BV (clib_bihash_alloc_lock) (h);
+  released = BV (release_free_pages) (h, n_buckets);
+  h->compact_released_bytes += released;
+  BV (clib_bihash_alloc_unlock) (h);
+
+  return freed + released;
+}
+
+/*
+ * Add or delete in bucket b of a bucket array with 1 << log2_nbuckets
+ * buckets, i.e. of the table itself or of the one it grows into.
+ */
+static_always_inline int BV (add_del_bucket) (
+  BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b, u32 log2_nbuckets,
+  BVT (clib_bihash_kv) * add_v, u64 hash, int is_add,
   int (*is_stale_cb) (BVT (clib_bihash_kv) *, void *), void *is_stale_arg,
   void (*overwrite_cb) (BVT (clib_bihash_kv) *, void *), void *overwrite_arg)
 {
-  BVT (clib_bihash_bucket) * b, tmp_b;
+  BVT (clib_bihash_bucket) tmp_b;
   BVT (clib_bihash_value) * v, *new_v, *save_new_v, *working_copy;
   int i, limit;
   u64 new_hash;
@@ -705,34 +1010,6 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
     .log2_pages = -1
   };
 
-#if BIHASH_LAZY_INSTANTIATE
-  /*
-   * Create the table (is_add=1,2), or flunk the request now (is_add=0)
-   * Use the alloc_lock to protect the instantiate operation.
-   */
-  if (PREDICT_FALSE (h->instantiated == 0))
-    {
-      if (is_add == 0)
-	return (-1);
-
-      BV (clib_bihash_alloc_lock) (h);
-      if (h->instantiated == 0)
-	BV (clib_bihash_instantiate) (h);
-      BV (clib_bihash_alloc_unlock) (h);
-    }
-#else
-  /* Debug image: make sure the table has been instantiated */
-  ASSERT (h->instantiated != 0);
-#endif
-
-  /*
-   * Debug image: make sure that an item being added doesn't accidentally
-   * look like a free item.
-   */
-  ASSERT ((is_add && BV (clib_bihash_is_free) (add_v)) == 0);
-
-  b = BV (clib_bihash_get_bucket) (h, hash);
-
   BV (clib_bihash_lock_bucket) (b);
 
   /* First elt in the bucket? */
@@ -769,7 +1046,7 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
       if (PREDICT_FALSE (b->linear_search))
 	limit <<= b->log2_pages;
       else
-	v += extract_bits (hash, h->log2_nbuckets, b->log2_pages);
+	v += extract_bits (hash, log2_nbuckets, b->log2_pages);
     }
 
   if (is_add)
@@ -861,15 +1138,16 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
 	      if (PREDICT_TRUE (b->refcnt > 1))
 		{
 		  b->refcnt--;
-		  /* Switch back to the bucket-level kvp array? */
+		  /*
+		   * Switch back to the bucket-level kvp array? Not in
+		   * deferred_free mode: lockless readers may still be
+		   * looking at the bucket-level array from before the split.
+		   */
 		  if (BIHASH_KVP_AT_BUCKET_LEVEL && b->refcnt == 1
-		      && b->log2_pages > 0)
+		      && b->log2_pages > 0 && h->deferred_free == 0)
 		    {
+		      BVT (clib_bihash_bucket) new_b;
 		      tmp_b.as_u64 = b->as_u64;
-		      b->offset = BV (clib_bihash_get_offset)
-			(h, (void *) (b + 1));
-		      b->linear_search = 0;
-		      b->log2_pages = 0;
 		      /* Clean up the bucket-level kvp array */
 		      BVT (clib_bihash_kv) *v = (void *) (b + 1);
 		      int j;
@@ -878,8 +1156,14 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
 			  BV (clib_bihash_mark_free) (v);
 			  v++;
 			}
+		      new_b.as_u64 = b->as_u64;
+		      new_b.offset =
+			BV (clib_bihash_get_offset) (h, (void *) (b + 1));
+		      new_b.linear_search = 0;
+		      new_b.log2_pages = 0;
+		      new_b.lock = 0;
 		      CLIB_MEMORY_STORE_BARRIER ();
-		      BV (clib_bihash_unlock_bucket) (b);
+		      b->as_u64 = new_b.as_u64; /* unlocks the bucket */
 		      BV (clib_bihash_increment_stat) (h, BIHASH_STAT_del, 1);
 		      goto free_backing_store;
 		    }
@@ -902,7 +1186,7 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
 		  BV (clib_bihash_alloc_lock) (h);
 		  /* Note: v currently points into the middle of the bucket */
 		  v = BV (clib_bihash_get_value) (h, tmp_b.offset);
-		  BV (value_free) (h, v, tmp_b.log2_pages);
+		  BV (value_free_published) (h, v, tmp_b.log2_pages);
 		  BV (clib_bihash_alloc_unlock) (h);
 		  BV (clib_bihash_increment_stat) (h, BIHASH_STAT_del_free,
 						   1);
@@ -915,9 +1199,23 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
       return (-3);
     }
 
-  /* Move readers to a (locked) temp copy of the bucket */
   BV (clib_bihash_alloc_lock) (h);
-  BV (make_working_copy) (h, b);
+
+  if (h->deferred_free)
+    {
+      /*
+       * Lockless readers keep using the live page. It can't change under
+       * us, we hold the bucket lock, so split straight from it.
+       */
+      h->saved_bucket.as_u64 = b->as_u64;
+      working_copy = BV (clib_bihash_get_value) (h, b->offset);
+    }
+  else
+    {
+      /* Move readers to a (locked) temp copy of the bucket */
+      BV (make_working_copy) (h, b);
+      working_copy = h->working_copies[thread_index];
+    }
 
   v = BV (clib_bihash_get_value) (h, h->saved_bucket.offset);
 
@@ -927,20 +1225,19 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
   BV (clib_bihash_increment_stat) (h, BIHASH_STAT_split_add, 1);
   BV (clib_bihash_increment_stat) (h, BIHASH_STAT_splits, old_log2_pages);
 
-  working_copy = h->working_copies[thread_index];
   resplit_once = 0;
   BV (clib_bihash_increment_stat) (h, BIHASH_STAT_splits, 1);
 
-  new_v = BV (split_and_rehash) (h, working_copy, old_log2_pages,
-				 new_log2_pages);
+  new_v = BV (split_and_rehash) (h, log2_nbuckets, working_copy,
+				 old_log2_pages, new_log2_pages);
   if (new_v == 0)
     {
     try_resplit:
       resplit_once = 1;
       new_log2_pages++;
       /* Try re-splitting. If that fails, fall back to linear search */
-      new_v = BV (split_and_rehash) (h, working_copy, old_log2_pages,
-				     new_log2_pages);
+      new_v = BV (split_and_rehash) (h, log2_nbuckets, working_copy,
+				     old_log2_pages, new_log2_pages);
       if (new_v == 0)
 	{
 	mark_linear:
@@ -964,7 +1261,7 @@ static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
   if (mark_bucket_linear)
     limit <<= new_log2_pages;
   else
-    new_v += extract_bits (new_hash, h->log2_nbuckets, new_log2_pages);
+    new_v += extract_bits (new_hash, log2_nbuckets, new_log2_pages);
 
   for (i = 0; i < limit; i++)
     {
@@ -1007,7 +1304,7 @@ expand_ok:
 
       /* free the old bucket, except at the bucket level if so configured */
       v = BV (clib_bihash_get_value) (h, h->saved_bucket.offset);
-      BV (value_free) (h, v, h->saved_bucket.log2_pages);
+      BV (value_free_published) (h, v, h->saved_bucket.log2_pages);
 
 #if BIHASH_KVP_AT_BUCKET_LEVEL
     }
@@ -1018,6 +1315,152 @@ expand_ok:
   return (0);
 }
 
+/* Empty bucket b of the bucket array being grown into, no readers there */
+static void
+BV (grow_reset_bucket) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
+{
+  BVT (clib_bihash_kv) * kv;
+  int i;
+
+  if (BIHASH_KVP_AT_BUCKET_LEVEL == 0 && BV (clib_bihash_bucket_is_empty) (b))
+    return;
+
+  if (BIHASH_KVP_AT_BUCKET_LEVEL == 0 || b->log2_pages > 0)
+    {
+      BV (clib_bihash_alloc_lock) (h);
+      BV (value_free) (h, BV (clib_bihash_get_value) (h, b->offset),
+		       b->log2_pages);
+      BV (clib_bihash_alloc_unlock) (h);
+    }
+
+  if (BIHASH_KVP_AT_BUCKET_LEVEL == 0)
+    {
+      b->as_u64 = 0;
+      return;
+    }
+
+  kv = (void *) (b + 1);
+  for (i = 0; i < BIHASH_KVP_PER_PAGE; i++)
+    BV (clib_bihash_mark_free) (kv + i);
+  b->as_u64 = 0;
+  b->offset = BV (clib_bihash_get_offset) (h, kv);
+  b->refcnt = 1;
+}
+
+/*
+ * Copy bucket bucket_index into the two buckets of the grown array its
+ * entries hash to. Also used to bring a migrated bucket up to date after
+ * a write, it's simpler than mirroring is_stale_cb and friends.
+ */
+static void
+BV (grow_migrate_bucket) (BVT (clib_bihash) * h, u32 bucket_index)
+{
+  BVT (clib_bihash_bucket) * b;
+  BVT (clib_bihash_value) * v;
+  u32 i, grow_mask = 2 * h->nbuckets - 1;
+
+  ASSERT (h->grow_lock);
+
+  BV (grow_reset_bucket) (h, BV (bucket_at) (h->grow_buckets, bucket_index));
+  BV (grow_reset_bucket) (h, BV (bucket_at) (h->grow_buckets,
+					     bucket_index + h->nbuckets));
+
+  b = BV (bucket_at) (h->buckets, bucket_index);
+  BV (clib_bihash_lock_bucket) (b);
+
+  if (BIHASH_KVP_AT_BUCKET_LEVEL || !BV (clib_bihash_bucket_is_empty) (b))
+    {
+      v = BV (clib_bihash_get_value) (h, b->offset);
+      for (i = 0; i < BIHASH_KVP_PER_PAGE << b->log2_pages; i++)
+	{
+	  BVT (clib_bihash_kv) *kv = v->kvp + i;
+	  u64 hash;
+
+	  if (BV (clib_bihash_is_free) (kv))
+	    continue;
+
+	  hash = BV (clib_bihash_hash) (kv);
+	  BV (add_del_bucket) (h, BV (bucket_at) (h->grow_buckets,
+						  hash & grow_mask),
+			       h->log2_nbuckets + 1, kv, hash, 1 /* is_add */,
+			       0, 0, 0, 0);
+	}
+    }
+
+  BV (clib_bihash_unlock_bucket) (b);
+}
+
+/*
+ * Writers while growing. They serialize on grow_lock, so migration can
+ * tell which buckets are already copied, and refresh the copy of the
+ * bucket they changed.
+ */
+static int
+BV (grow_add_del) (BVT (clib_bihash) * h, BVT (clib_bihash_kv) * add_v,
+		   u64 hash, int is_add,
+		   int (*is_stale_cb) (BVT (clib_bihash_kv) *, void *),
+		   void *is_stale_arg,
+		   void (*overwrite_cb) (BVT (clib_bihash_kv) *, void *),
+		   void *overwrite_arg)
+{
+  u32 bucket_index = hash & (h->nbuckets - 1);
+  int rv;
+
+  while (__atomic_test_and_set (&h->grow_lock, __ATOMIC_ACQUIRE))
+    CLIB_PAUSE ();
+
+  rv = BV (add_del_bucket) (h, BV (clib_bihash_get_bucket) (h, hash),
+			    h->log2_nbuckets, add_v, hash, is_add, is_stale_cb,
+			    is_stale_arg, overwrite_cb, overwrite_arg);
+
+  if (bucket_index < h->grow_next_bucket)
+    BV (grow_migrate_bucket) (h, bucket_index);
+
+  __atomic_clear (&h->grow_lock, __ATOMIC_RELEASE);
+  return rv;
+}
+
+static_always_inline int BV (clib_bihash_add_del_inline_with_hash) (
+  BVT (clib_bihash) * h, BVT (clib_bihash_kv) * add_v, u64 hash, int is_add,
+  int (*is_stale_cb) (BVT (clib_bihash_kv) *, void *), void *is_stale_arg,
+  void (*overwrite_cb) (BVT (clib_bihash_kv) *, void *), void *overwrite_arg)
+{
+#if BIHASH_LAZY_INSTANTIATE
+  /*
+   * Create the table (is_add=1,2), or flunk the request now (is_add=0)
+   * Use the alloc_lock to protect the instantiate operation.
+   */
+  if (PREDICT_FALSE (h->instantiated == 0))
+    {
+      if (is_add == 0)
+	return (-1);
+
+      BV (clib_bihash_alloc_lock) (h);
+      if (h->instantiated == 0)
+	BV (clib_bihash_instantiate) (h);
+      BV (clib_bihash_alloc_unlock) (h);
+    }
+#else
+  /* Debug image: make sure the table has been instantiated */
+  ASSERT (h->instantiated != 0);
+#endif
+
+  /*
+   * Debug image: make sure that an item being added doesn't accidentally
+   * look like a free item.
+   */
+  ASSERT ((is_add && BV (clib_bihash_is_free) (add_v)) == 0);
+
+  if (PREDICT_FALSE (h->grow_buckets != 0))
+    return BV (grow_add_del) (h, add_v, hash, is_add, is_stale_cb,
+			      is_stale_arg, overwrite_cb, overwrite_arg);
+
+  return BV (add_del_bucket) (h, BV (clib_bihash_get_bucket) (h, hash),
+			      h->log2_nbuckets, add_v, hash, is_add,
+			      is_stale_cb, is_stale_arg, overwrite_cb,
+			      overwrite_arg);
+}
+
 static_always_inline int BV (clib_bihash_add_del_inline)
   (BVT (clib_bihash) * h, BVT (clib_bihash_kv) * add_v, int is_add,
    int (*is_stale_cb) (BVT (clib_bihash_kv) *, void *), void *arg)
@@ -1064,6 +1507,188 @@ int BV (clib_bihash_search)
   return BV (clib_bihash_search_inline_2) (h, search_key, valuep);
 }
 
+void BV (clib_bihash_get_occupancy) (BVT (clib_bihash) * h,
+				     clib_bihash_occupancy_t *o)
+{
+  BVT (clib_bihash_bucket) * b;
+  BVT (clib_bihash_value) * v;
+  u32 i, j, k;
+
+  clib_memset_u8 (o, 0, sizeof (*o));
+  o->n_buckets = h->nbuckets;
+  o->kvp_per_page = BIHASH_KVP_PER_PAGE;
+  o->growing = h->grow_buckets || h->grow_old_buckets;
+  o->auto_grow = h->auto_grow;
+
+#if BIHASH_LAZY_INSTANTIATE
+  if (PREDICT_FALSE (h->instantiated == 0))
+    return;
+#endif
+
+  for (i = 0; i < h->nbuckets; i++)
+    {
+      b = BV (clib_bihash_get_bucket) (h, i);
+      if (BV (clib_bihash_bucket_is_empty) (b))
+	continue;
+
+      o->n_buckets_used++;
+      o->n_pages += 1 << b->log2_pages;
+      if (b->log2_pages)
+	o->n_overflow_buckets++;
+      if (b->linear_search)
+	o->n_linear_buckets++;
+
+      v = BV (clib_bihash_get_value) (h, b->offset);
+      for (j = 0; j < (1 << b->log2_pages); j++)
+	for (k = 0; k < BIHASH_KVP_PER_PAGE; k++)
+	  if (!BV (clib_bihash_is_free) (&v[j].kvp[k]))
+	    {
+	      o->n_elts++;
+	      /* a linear search scans all pages before this one */
+	      o->probe_depth_sum +=
+		1 + k + (b->linear_search ? j * BIHASH_KVP_PER_PAGE : 0);
+	    }
+    }
+}
+
+/*
+ * Growing doubles the bucket array. A new array is populated a few
+ * buckets per grow step while readers keep using the current one, then
+ * the commit switches over. Start and commit must be called with all
+ * readers and writers of the table stopped (e.g. under the worker
+ * barrier), the steps may run concurrently with both.
+ */
+int BV (clib_bihash_grow_start) (BVT (clib_bihash) * h)
+{
+  BVT (clib_bihash_bucket) * buckets;
+  uword bucket_size;
+
+#if BIHASH_32_64_SVM
+  /* the bucket array lives in the shared header, leave it alone */
+  return -1;
+#endif
+
+  if (h->instantiated == 0 || h->grow_buckets || h->grow_old_buckets ||
+      h->log2_nbuckets >= 31)
+    return -1;
+
+  bucket_size = BV (buckets_size) (2 * h->nbuckets);
+
+  if (BIHASH_USE_HEAP == 0 &&
+      alloc_arena_next (h) + bucket_size > alloc_arena_size (h))
+    return -1;
+
+  BV (clib_bihash_alloc_lock) (h);
+  buckets = BV (alloc_aligned) (h, bucket_size);
+  BV (clib_bihash_alloc_unlock) (h);
+  BV (init_buckets) (h, buckets, 2 * h->nbuckets);
+
+  h->grow_next_bucket = 0;
+  CLIB_MEMORY_STORE_BARRIER ();
+  h->grow_buckets = buckets;
+  return 0;
+}
+
+/*
+ * Do up to n_buckets buckets of pending growth work: migrate buckets
+ * into the new array before the commit, free the previous array's pages
+ * after it. Returns 1 when the migration is done and the commit is due,
+ * 0 while there's more to do and -1 when the table isn't growing.
+ */
+int BV (clib_bihash_grow_step) (BVT (clib_bihash) * h, u32 n_buckets)
+{
+  BVT (clib_bihash_bucket) * b;
+  u32 n;
+
+  if (h->grow_old_buckets)
+    {
+      /* nothing looks at the previous array since the commit */
+      BV (clib_bihash_alloc_lock) (h);
+      for (n = 0; n < n_buckets && h->grow_next_bucket < h->grow_old_nbuckets;
+	   n++)
+	{
+	  b = BV (bucket_at) (h->grow_old_buckets, h->grow_next_bucket++);
+	  if (BV (clib_bihash_bucket_is_empty) (b) ||
+	      (BIHASH_KVP_AT_BUCKET_LEVEL && b->log2_pages == 0))
+	    continue;
+	  BV (value_free) (h, BV (clib_bihash_get_value) (h, b->offset),
+			   b->log2_pages);
+	}
+
+      if (h->grow_next_bucket == h->grow_old_nbuckets)
+	{
+	  BV (free_aligned) (h, h->grow_old_buckets,
+			     BV (buckets_size) (h->grow_old_nbuckets));
+	  h->grow_old_buckets = 0;
+	  h->grow_next_bucket = 0;
+	}
+      BV (clib_bihash_alloc_unlock) (h);
+      return 0;
+    }
+
+  if (h->grow_buckets == 0)
+    return -1;
+
+  while (__atomic_test_and_set (&h->grow_lock, __ATOMIC_ACQUIRE))
+    CLIB_PAUSE ();
+
+  for (n = 0; n < n_buckets && h->grow_next_bucket < h->nbuckets; n++)
+    {
+      BV (grow_migrate_bucket) (h, h->grow_next_bucket);
+      h->grow_next_bucket++;
+    }
+
+  __atomic_clear (&h->grow_lock, __ATOMIC_RELEASE);
+
+  return h->grow_next_bucket == h->nbuckets;
+}
+
+void BV (clib_bihash_grow_commit) (BVT (clib_bihash) * h)
+{
+  if (h->grow_buckets == 0 || h->grow_next_bucket != h->nbuckets)
+    return;
+
+  h->grow_old_buckets = h->buckets;
+  h->grow_old_nbuckets = h->nbuckets;
+  h->buckets = h->grow_buckets;
+  h->nbuckets *= 2;
+  h->log2_nbuckets++;
+  h->grow_buckets = 0;
+  h->grow_next_bucket = 0;
+  CLIB_MEMORY_BARRIER ();
+}
+
+static void
+BV (ops_get_occupancy) (void *h, clib_bihash_occupancy_t *o)
+{
+  BV (clib_bihash_get_occupancy) (h, o);
+}
+
+static int
+BV (ops_grow_start) (void *h)
+{
+  return BV (clib_bihash_grow_start) (h);
+}
+
+static int
+BV (ops_grow_step) (void *h, u32 n_buckets)
+{
+  return BV (clib_bihash_grow_step) (h, n_buckets);
+}
+
+static void
+BV (ops_grow_commit) (void *h)
+{
+  BV (clib_bihash_grow_commit) (h);
+}
+
+static const clib_bihash_ops_t BV (clib_bihash_ops) = {
+  .get_occupancy = BV (ops_get_occupancy),
+  .grow_start = BV (ops_grow_start),
+  .grow_step = BV (ops_grow_step),
+  .grow_commit = BV (ops_grow_commit),
+};
+
 u8 *BV (format_bihash) (u8 * s, va_list * args)
 {
   BVT (clib_bihash) * h = va_arg (*args, BVT (clib_bihash) *);
@@ -1159,6 +1784,23 @@ u8 *BV (format_bihash) (u8 * s, va_list * args)
     }
 
   s = format (s, "    %lld linear search buckets\n", linear_buckets);
+  {
+    clib_bihash_occupancy_t o;
+    BV (clib_bihash_get_occupancy) (h, &o);
+    s = format (s, "    %U\n", format_clib_bihash_occupancy, &o);
+  }
+  if (h->grow_buckets)
+    s = format (s, "    growing to %u buckets, %u migrated\n",
+		2 * h->nbuckets, h->grow_next_bucket);
+  else if (h->grow_old_buckets)
+    s = format (s, "    grown, freeing previous %u buckets\n",
+		h->grow_old_nbuckets);
+  if (h->compact_released_bytes)
+    s = format (s, "    compaction: %U released to the OS\n",
+		format_memory_size, h->compact_released_bytes);
+  if (h->deferred_free)
+    s = format (s, "    deferred free: epoch %llu, %u pages pending\n",
+		h->free_epoch, vec_len (h->deferred_frees));
   if (BIHASH_USE_HEAP)
     {
       BVT (clib_bihash_alloc_chunk) * c = h->chunks;
@@ -1176,6 +1818,10 @@ u8 *BV (format_bihash) (u8 * s, va_list * args)
 		  "          bytes: used %U, scrap %U\n", n_chunks,
 		  format_memory_size, total_size,
 		  format_memory_size, bytes_left);
+      if (h->own_heap)
+	s = format (s, "          own heap: %U, %U pages\n", format_memory_size,
+		    h->memory_size, format_log2_page_size,
+		    ((clib_mem_heap_t *) h->heap)->log2_page_sz);
     }
   else
     {
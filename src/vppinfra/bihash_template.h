@@ -48,6 +48,80 @@
 #define BIHASH_LOG2_HUGEPAGE_SIZE 21
 #endif
 
+#ifndef BIHASH_OCCUPANCY_DEFINED
+#define BIHASH_OCCUPANCY_DEFINED 1
+
+/** Table occupancy, see clib_bihash_get_occupancy */
+typedef struct
+{
+  u64 n_elts;
+  u64 n_buckets;
+  u64 n_buckets_used;
+  u64 n_overflow_buckets; /**< buckets split into more than one page */
+  u64 n_linear_buckets;	  /**< buckets degraded to linear search */
+  u64 n_pages;		  /**< pages in use by all buckets */
+  u64 probe_depth_sum;	  /**< slots compared to find each elt, summed */
+  u32 kvp_per_page;
+  u8 growing;
+  u8 auto_grow;
+} clib_bihash_occupancy_t;
+
+/** Type independent entry points, reachable from clib_all_bihashes */
+typedef struct
+{
+  void (*get_occupancy) (void *h, clib_bihash_occupancy_t *o);
+  int (*grow_start) (void *h);
+  int (*grow_step) (void *h, u32 n_buckets);
+  void (*grow_commit) (void *h);
+} clib_bihash_ops_t;
+
+/* grow when elts exceed this percentage of the first page slots... */
+#ifndef BIHASH_GROW_LOAD_PCT
+#define BIHASH_GROW_LOAD_PCT 200
+#endif
+
+/* ...or this percentage of the buckets in use went linear */
+#ifndef BIHASH_GROW_LINEAR_PCT
+#define BIHASH_GROW_LINEAR_PCT 1
+#endif
+
+/** Elts per slot of a bucket's first page, in percent */
+static inline u64
+clib_bihash_occupancy_load_pct (clib_bihash_occupancy_t *o)
+{
+  return o->n_buckets ?
+	   o->n_elts * 100 / (o->n_buckets * o->kvp_per_page) : 0;
+}
+
+/** Would a bigger bucket array help? */
+static inline int
+clib_bihash_occupancy_wants_grow (clib_bihash_occupancy_t *o)
+{
+  if (o->growing || o->n_buckets_used == 0)
+    return 0;
+  if (clib_bihash_occupancy_load_pct (o) > BIHASH_GROW_LOAD_PCT)
+    return 1;
+  return o->n_linear_buckets * 100 >
+	 o->n_buckets_used * BIHASH_GROW_LINEAR_PCT;
+}
+
+static inline u8 *
+format_clib_bihash_occupancy (u8 *s, va_list *args)
+{
+  clib_bihash_occupancy_t *o = va_arg (*args, clib_bihash_occupancy_t *);
+  f64 n_used = o->n_buckets_used ? o->n_buckets_used : 1;
+
+  return format (s,
+		 "load %llu%%, %llu overflow buckets, %llu linear "
+		 "(%.2f%%), %.2f pages per bucket, avg probe depth %.2f",
+		 clib_bihash_occupancy_load_pct (o), o->n_overflow_buckets,
+		 o->n_linear_buckets, 100.0 * o->n_linear_buckets / n_used,
+		 o->n_pages / n_used,
+		 o->n_elts ? (f64) o->probe_depth_sum / o->n_elts : 0.0);
+}
+
+#endif /* BIHASH_OCCUPANCY_DEFINED */
+
 #define _bv(a,b) a##b
 #define __bv(a,b) _bv(a,b)
 #define BV(a) __bv(a,BIHASH_TYPE)
@@ -75,7 +149,12 @@ typedef struct BV (clib_bihash_value)
   union
   {
     BVT (clib_bihash_kv) kvp[BIHASH_KVP_PER_PAGE];
-    u64 next_free_as_u64;
+    struct
+    {
+      u64 next_free_as_u64;
+      /* on a freelist, memory past the first OS page given back */
+      u64 free_released;
+    };
   };
 } BVT (clib_bihash_value);
 
@@ -139,6 +218,14 @@ BVS (clib_bihash_alloc_chunk)
 
 } BVT (clib_bihash_alloc_chunk);
 
+/* A replaced page waiting for readers to move on, see deferred_free */
+typedef struct
+{
+  u64 offset;
+  u64 epoch;
+  u32 log2_pages;
+} BVT (clib_bihash_deferred_free);
+
 typedef
 BVS (clib_bihash)
 {
@@ -154,7 +241,9 @@ BVS (clib_bihash)
   u64 memory_size;
   u8 *name;
   format_function_t *fmt_fn;
+  const clib_bihash_ops_t *ops;
   void *heap;
+  u8 own_heap;
   BVT (clib_bihash_alloc_chunk) * chunks;
 
   u64 *freelists;
@@ -170,6 +259,35 @@ BVS (clib_bihash)
   volatile u8 instantiated;
   u8 dont_add_to_all_bihash_list;
 
+  /**
+    * Lockless reader mode. Bucket splits are built out-of-line from the
+    * live page and published with a single bucket store, so readers never
+    * spin on the bucket lock. Replaced pages are parked on deferred_frees
+    * until the owner declares a grace period over, see
+    * clib_bihash_grace_period_start / clib_bihash_reclaim_deferred.
+    */
+  u8 deferred_free;
+  u64 free_epoch;
+  BVT (clib_bihash_deferred_free) * deferred_frees;
+
+  /** Compaction state, see clib_bihash_compact */
+  u32 compact_next_bucket;
+  u64 compact_released_bytes;
+
+  /**
+    * Bucket array growth, see clib_bihash_grow_start. While growing,
+    * readers keep using buckets; writers serialize on grow_lock and
+    * mirror each change of an already migrated bucket into grow_buckets.
+    * After the commit the previous bucket array and its pages are freed
+    * by later grow steps.
+    */
+  u8 auto_grow;
+  volatile u32 grow_lock;
+  u32 grow_next_bucket;
+  BVT (clib_bihash_bucket) * grow_buckets;
+  BVT (clib_bihash_bucket) * grow_old_buckets;
+  u32 grow_old_nbuckets;
+
   /**
     * A custom format function to print the Key and Value of bihash_key instead of default hexdump
     */
@@ -194,6 +312,8 @@ typedef struct
   format_function_t *kvp_fmt_fn;
   u8 instantiate_immediately;
   u8 dont_add_to_all_bihash_list;
+  u8 deferred_free;
+  u8 auto_grow;
 } BVT (clib_bihash_init2_args);
 
 extern void **clib_all_bihashes;
@@ -236,6 +356,7 @@ _(del_free)                                     \
 _(linear)                                       \
 _(resplit)                                      \
 _(working_copy_lost)                            \
+_(compact)                                      \
 _(splits)			/* must be last */
 
 typedef enum
@@ -371,6 +492,16 @@ int BV (clib_bihash_search) (BVT (clib_bihash) * h,
 
 int BV (clib_bihash_is_initialised) (const BVT (clib_bihash) * h);
 
+u64 BV (clib_bihash_grace_period_start) (BVT (clib_bihash) * h);
+void BV (clib_bihash_reclaim_deferred) (BVT (clib_bihash) * h, u64 epoch);
+uword BV (clib_bihash_compact) (BVT (clib_bihash) * h, u32 n_buckets);
+
+void BV (clib_bihash_get_occupancy) (BVT (clib_bihash) * h,
+				     clib_bihash_occupancy_t *o);
+int BV (clib_bihash_grow_start) (BVT (clib_bihash) * h);
+int BV (clib_bihash_grow_step) (BVT (clib_bihash) * h, u32 n_buckets);
+void BV (clib_bihash_grow_commit) (BVT (clib_bihash) * h);
+
 #define BIHASH_WALK_STOP 0
 #define BIHASH_WALK_CONTINUE 1
 
@@ -408,7 +539,7 @@ static inline int BV (clib_bihash_search_inline_with_hash)
 {
   BVT (clib_bihash_kv) rv;
   BVT (clib_bihash_value) * v;
-  BVT (clib_bihash_bucket) * b;
+  BVT (clib_bihash_bucket) * b, bs;
   int i, limit;
 
   static const BVT (clib_bihash_bucket) mask = {
@@ -422,28 +553,33 @@ static inline int BV (clib_bihash_search_inline_with_hash)
 #endif
 
   b = BV (clib_bihash_get_bucket) (h, hash);
+  bs.as_u64 = clib_atomic_load_acq_n (&b->as_u64);
 
-  if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (b)))
+  if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (&bs)))
     return -1;
 
-  if (PREDICT_FALSE (b->lock))
+  /* Lockless readers use the snapshot, the page it points to stays valid */
+  if (PREDICT_FALSE (bs.lock) && h->deferred_free == 0)
     {
       volatile BVT (clib_bihash_bucket) * bv = b;
       while (bv->lock)
 	CLIB_PAUSE ();
+      bs.as_u64 = clib_atomic_load_acq_n (&b->as_u64);
+      if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (&bs)))
+	return -1;
     }
 
-  v = BV (clib_bihash_get_value) (h, b->offset);
+  v = BV (clib_bihash_get_value) (h, bs.offset);
 
   /* If the bucket has unresolvable collisions, use linear search */
   limit = BIHASH_KVP_PER_PAGE;
 
-  if (PREDICT_FALSE (b->as_u64 & mask.as_u64))
+  if (PREDICT_FALSE (bs.as_u64 & mask.as_u64))
     {
-      if (PREDICT_FALSE (b->linear_search))
-	limit <<= b->log2_pages;
+      if (PREDICT_FALSE (bs.linear_search))
+	limit <<= bs.log2_pages;
       else
-	v += extract_bits (hash, h->log2_nbuckets, b->log2_pages);
+	v += extract_bits (hash, h->log2_nbuckets, bs.log2_pages);
     }
 
   for (i = 0; i < limit; i++)
@@ -509,7 +645,7 @@ static inline int BV (clib_bihash_search_inline_2_with_hash)
 {
   BVT (clib_bihash_kv) rv;
   BVT (clib_bihash_value) * v;
-  BVT (clib_bihash_bucket) * b;
+  BVT (clib_bihash_bucket) * b, bs;
   int i, limit;
 
   static const BVT (clib_bihash_bucket) mask = {
@@ -525,28 +661,33 @@ static inline int BV (clib_bihash_search_inline_2_with_hash)
 #endif
 
   b = BV (clib_bihash_get_bucket) (h, hash);
+  bs.as_u64 = clib_atomic_load_acq_n (&b->as_u64);
 
-  if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (b)))
+  if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (&bs)))
     return -1;
 
-  if (PREDICT_FALSE (b->lock))
+  /* Lockless readers use the snapshot, the page it points to stays valid */
+  if (PREDICT_FALSE (bs.lock) && h->deferred_free == 0)
     {
       volatile BVT (clib_bihash_bucket) * bv = b;
       while (bv->lock)
 	CLIB_PAUSE ();
+      bs.as_u64 = clib_atomic_load_acq_n (&b->as_u64);
+      if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (&bs)))
+	return -1;
     }
 
-  v = BV (clib_bihash_get_value) (h, b->offset);
+  v = BV (clib_bihash_get_value) (h, bs.offset);
 
   /* If the bucket has unresolvable collisions, use linear search */
   limit = BIHASH_KVP_PER_PAGE;
 
-  if (PREDICT_FALSE (b->as_u64 & mask.as_u64))
+  if (PREDICT_FALSE (bs.as_u64 & mask.as_u64))
     {
-      if (PREDICT_FALSE (b->linear_search))
-	limit <<= b->log2_pages;
+      if (PREDICT_FALSE (bs.linear_search))
+	limit <<= bs.log2_pages;
       else
-	v += extract_bits (hash, h->log2_nbuckets, b->log2_pages);
+	v += extract_bits (hash, h->log2_nbuckets, bs.log2_pages);
     }
 
   for (i = 0; i < limit; i++)
@@ -575,6 +716,76 @@ static inline int BV (clib_bihash_search_inline_2)
 						     valuep);
 }
 
+/*
+ * Batched lookup. The search is software pipelined: the bucket for key
+ * i + 2 * BIHASH_SEARCH_BATCH_STRIDE and the (key,value) page for key
+ * i + BIHASH_SEARCH_BATCH_STRIDE are prefetched while key i is compared,
+ * so several DRAM misses are in flight at once.
+ */
+#ifndef BIHASH_SEARCH_BATCH_STRIDE
+#define BIHASH_SEARCH_BATCH_STRIDE 4
+#endif
+
+#ifndef BIHASH_SEARCH_BATCH_MAX_KEYS
+#define BIHASH_SEARCH_BATCH_MAX_KEYS 256
+#endif
+
+static inline u32 BV (clib_bihash_search_batch_with_hash)
+  (BVT (clib_bihash) * h, u64 * hashes, BVT (clib_bihash_kv) * search_keys,
+   BVT (clib_bihash_kv) * valuep, u64 * found_bmp, u32 n_keys)
+{
+  const u32 stride = BIHASH_SEARCH_BATCH_STRIDE;
+  u32 i, j, n_found = 0;
+
+  ASSERT (n_keys <= BIHASH_SEARCH_BATCH_MAX_KEYS);
+
+  clib_memset_u64 (found_bmp, 0, round_pow2 (n_keys, 64) / 64);
+
+#if BIHASH_LAZY_INSTANTIATE
+  if (PREDICT_FALSE (h->instantiated == 0))
+    return 0;
+#endif
+
+  for (i = 0; i < n_keys + 2 * stride; i++)
+    {
+      if (PREDICT_TRUE (i < n_keys))
+	BV (clib_bihash_prefetch_bucket) (h, hashes[i]);
+
+      if (PREDICT_TRUE (i >= stride && i - stride < n_keys))
+	BV (clib_bihash_prefetch_data) (h, hashes[i - stride]);
+
+      if (PREDICT_FALSE (i < 2 * stride || i - 2 * stride >= n_keys))
+	continue;
+
+      j = i - 2 * stride;
+      if (BV (clib_bihash_search_inline_2_with_hash) (h, hashes[j],
+						      search_keys + j,
+						      valuep + j) == 0)
+	{
+	  found_bmp[j / 64] |= 1ULL << (j % 64);
+	  n_found++;
+	}
+    }
+
+  return n_found;
+}
+
+static inline u32 BV (clib_bihash_search_batch)
+  (BVT (clib_bihash) * h, BVT (clib_bihash_kv) * search_keys,
+   BVT (clib_bihash_kv) * valuep, u64 * found_bmp, u32 n_keys)
+{
+  u64 hashes[BIHASH_SEARCH_BATCH_MAX_KEYS];
+  u32 i;
+
+  ASSERT (n_keys <= BIHASH_SEARCH_BATCH_MAX_KEYS);
+
+  for (i = 0; i < n_keys; i++)
+    hashes[i] = BV (clib_bihash_hash) (search_keys + i);
+
+  return BV (clib_bihash_search_batch_with_hash) (h, hashes, search_keys,
+						  valuep, found_bmp, n_keys);
+}
+
 
 #endif /* __included_bihash_template_h__ */
 
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/cpool.h>
+#include <vppinfra/format.h>
+
+/* indices moved between a thread cache and the shared bitmap at once */
+#define CLIB_CPOOL_BATCH (CLIB_CPOOL_CACHE_SIZE / 2)
+
+__clib_export void
+clib_cpool_init (clib_cpool_t *p, u32 elt_size, u32 log2_chunk_elts,
+		 u32 max_elts, u32 n_threads)
+{
+  /* busy bitmaps are walked a word at a time */
+  log2_chunk_elts = clib_max (log2_chunk_elts, min_log2 (uword_bits));
+
+  clib_memset (p, 0, sizeof (clib_cpool_t));
+  p->elt_size = elt_size;
+  p->log2_chunk_elts = log2_chunk_elts;
+  p->max_chunks = round_pow2 (clib_max (max_elts, 1), 1 << log2_chunk_elts) >>
+		  log2_chunk_elts;
+  p->chunks = clib_mem_alloc (p->max_chunks * sizeof (p->chunks[0]));
+  p->busy = clib_mem_alloc (p->max_chunks * sizeof (p->busy[0]));
+  clib_spinlock_init (&p->lock);
+  vec_validate_aligned (p->threads, n_threads - 1, CLIB_CACHE_LINE_BYTES);
+}
+
+__clib_export void
+clib_cpool_free (clib_cpool_t *p)
+{
+  for (u32 i = 0; i < p->n_chunks; i++)
+    {
+      clib_mem_free (p->chunks[i]);
+      clib_mem_free (p->busy[i]);
+    }
+  clib_mem_free (p->chunks);
+  clib_mem_free (p->busy);
+  clib_bitmap_free (p->free_bitmap);
+  vec_free (p->threads);
+  clib_spinlock_free (&p->lock);
+}
+
+/* add a chunk, called with the lock held */
+static int
+clib_cpool_grow (clib_cpool_t *p)
+{
+  u32 n_elts = 1 << p->log2_chunk_elts;
+  u32 chunk = p->n_chunks;
+
+  if (chunk == p->max_chunks)
+    return 0;
+
+  p->chunks[chunk] = clib_mem_alloc_aligned ((uword) n_elts * p->elt_size,
+					     CLIB_CACHE_LINE_BYTES);
+  p->busy[chunk] = clib_mem_alloc (n_elts / 8);
+  clib_memset (p->busy[chunk], 0, n_elts / 8);
+
+  /* elements must be visible before the chunk count says they exist */
+  __atomic_store_n (&p->n_chunks, chunk + 1, __ATOMIC_RELEASE);
+
+  p->free_bitmap = clib_bitmap_set_region (p->free_bitmap, chunk * n_elts, 1,
+					   n_elts);
+  return 1;
+}
+
+__clib_export int
+clib_cpool_refill (clib_cpool_t *p, clib_cpool_thread_t *t)
+{
+  uword i = 0;
+
+  clib_spinlock_lock (&p->lock);
+
+  while (t->n_cached < CLIB_CPOOL_BATCH)
+    {
+      i = clib_bitmap_next_set (p->free_bitmap, i);
+      if (i == ~0)
+	{
+	  if (clib_cpool_grow (p) == 0)
+	    break;
+	  i = 0;
+	  continue;
+	}
+      clib_bitmap_set_no_check (p->free_bitmap, i, 0);
+      t->cached[t->n_cached++] = i;
+    }
+
+  clib_spinlock_unlock (&p->lock);
+
+  /* hand out the lowest indices first */
+  if (t->n_cached > 1)
+    for (u32 a = 0, b = t->n_cached - 1; a < b; a++, b--)
+      {
+	u32 tmp = t->cached[a];
+	t->cached[a] = t->cached[b];
+	t->cached[b] = tmp;
+      }
+
+  return t->n_cached;
+}
+
+__clib_export void
+clib_cpool_drain (clib_cpool_t *p, clib_cpool_thread_t *t)
+{
+  /* the oldest entries go back, the most recently freed stay hot */
+  clib_spinlock_lock (&p->lock);
+  for (u32 i = 0; i < CLIB_CPOOL_BATCH; i++)
+    p->free_bitmap = clib_bitmap_set (p->free_bitmap, t->cached[i], 1);
+  clib_spinlock_unlock (&p->lock);
+
+  t->n_cached -= CLIB_CPOOL_BATCH;
+  clib_memmove (t->cached, t->cached + CLIB_CPOOL_BATCH,
+		t->n_cached * sizeof (t->cached[0]));
+}
+
+__clib_export uword
+clib_cpool_elts (clib_cpool_t *p)
+{
+  u32 n_words = (1 << p->log2_chunk_elts) / uword_bits;
+  u32 n_chunks = __atomic_load_n (&p->n_chunks, __ATOMIC_ACQUIRE);
+  uword n = 0;
+
+  for (u32 c = 0; c < n_chunks; c++)
+    for (u32 w = 0; w < n_words; w++)
+      n += count_set_bits (__atomic_load_n (p->busy[c] + w, __ATOMIC_RELAXED));
+
+  return n;
+}
+
+__clib_export u8 *
+format_clib_cpool (u8 *s, va_list *args)
+{
+  clib_cpool_t *p = va_arg (*args, clib_cpool_t *);
+  clib_cpool_thread_t *t;
+  u32 n_cached = 0;
+  uword n_free;
+
+  vec_foreach (t, p->threads)
+    n_cached += t->n_cached;
+
+  clib_spinlock_lock (&p->lock);
+  n_free = clib_bitmap_count_set_bits (p->free_bitmap);
+  clib_spinlock_unlock (&p->lock);
+
+  s = format (s, "%lu elts in use, %u of %u chunks of %u elts of %u bytes, ",
+	      clib_cpool_elts (p), p->n_chunks, p->max_chunks,
+	      1 << p->log2_chunk_elts, p->elt_size);
+  s = format (s, "%lu free shared, %u free cached by %u threads", n_free,
+	      n_cached, vec_len (p->threads));
+  return s;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * Concurrent pool.
+ *
+ * Like a pool, elements are named by a u32 index, but any thread may get
+ * and put elements at any time, and elements never move. Storage is a
+ * fixed table of chunks of 2^log2_chunk_elts elements, allocated as the
+ * pool grows, so pointers to elements stay valid while other threads
+ * grow the pool.
+ *
+ * Each thread keeps a small cache of free indices. Gets and puts are
+ * served from it without a lock. The shared free bitmap is locked only
+ * to refill an empty cache or to drain a full one, a batch at a time. A
+ * per-chunk busy bitmap, updated with atomics, tells which elements are
+ * in use, for iteration and validation.
+ */
+
+#ifndef included_clib_cpool_h
+#define included_clib_cpool_h
+
+#include <vppinfra/clib.h>
+#include <vppinfra/mem.h>
+#include <vppinfra/bitmap.h>
+#include <vppinfra/lock.h>
+
+#define CLIB_CPOOL_CACHE_SIZE 64
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  u32 n_cached;
+  u32 cached[CLIB_CPOOL_CACHE_SIZE];
+} clib_cpool_thread_t;
+
+typedef struct
+{
+  /* chunk table, allocated once at init, never moves */
+  u8 **chunks;
+  /* per chunk, bit set for each element in use */
+  uword **busy;
+  u32 n_chunks;
+  u32 max_chunks;
+  u32 elt_size;
+  u32 log2_chunk_elts;
+
+  /* free indices not in any thread cache, under lock */
+  clib_spinlock_t lock;
+  uword *free_bitmap;
+
+  clib_cpool_thread_t *threads;
+} clib_cpool_t;
+
+void clib_cpool_init (clib_cpool_t *p, u32 elt_size, u32 log2_chunk_elts,
+		      u32 max_elts, u32 n_threads);
+void clib_cpool_free (clib_cpool_t *p);
+int clib_cpool_refill (clib_cpool_t *p, clib_cpool_thread_t *t);
+void clib_cpool_drain (clib_cpool_t *p, clib_cpool_thread_t *t);
+uword clib_cpool_elts (clib_cpool_t *p);
+u8 *format_clib_cpool (u8 *s, va_list *args);
+
+static_always_inline void *
+clib_cpool_elt_at_index (clib_cpool_t *p, u32 index)
+{
+  u32 chunk = index >> p->log2_chunk_elts;
+  u32 offset = index & pow2_mask (p->log2_chunk_elts);
+
+  ASSERT (chunk < __atomic_load_n (&p->n_chunks, __ATOMIC_ACQUIRE));
+  return p->chunks[chunk] + (uword) offset * p->elt_size;
+}
+
+static_always_inline int
+clib_cpool_is_free_index (clib_cpool_t *p, u32 index)
+{
+  u32 chunk = index >> p->log2_chunk_elts;
+  u32 offset = index & pow2_mask (p->log2_chunk_elts);
+  uword *w;
+
+  if (chunk >= __atomic_load_n (&p->n_chunks, __ATOMIC_ACQUIRE))
+    return 1;
+
+  w = p->busy[chunk] + offset / uword_bits;
+  return (__atomic_load_n (w, __ATOMIC_RELAXED) &
+	  (1ULL << (offset % uword_bits))) == 0;
+}
+
+static_always_inline void
+clib_cpool_set_busy (clib_cpool_t *p, u32 index, int busy)
+{
+  u32 offset = index & pow2_mask (p->log2_chunk_elts);
+  uword *w = p->busy[index >> p->log2_chunk_elts] + offset / uword_bits;
+  uword bit = 1ULL << (offset % uword_bits);
+
+  if (busy)
+    __atomic_fetch_or (w, bit, __ATOMIC_RELAXED);
+  else
+    __atomic_fetch_and (w, ~bit, __ATOMIC_RELAXED);
+}
+
+/** Get a free element on thread THREAD_INDEX. Returns its index, or ~0
+    when the pool has reached its maximum size and no free index is left
+    outside the thread caches. */
+static_always_inline u32
+clib_cpool_get_index (clib_cpool_t *p, u32 thread_index)
+{
+  clib_cpool_thread_t *t = vec_elt_at_index (p->threads, thread_index);
+  u32 index;
+
+  if (PREDICT_FALSE (t->n_cached == 0) && clib_cpool_refill (p, t) == 0)
+    return ~0;
+
+  index = t->cached[--t->n_cached];
+  ASSERT (clib_cpool_is_free_index (p, index));
+  clib_cpool_set_busy (p, index, 1);
+  return index;
+}
+
+/** Get a free element on thread THREAD_INDEX, and store its index in
+    INDEX. Returns 0 when the pool has reached its maximum size. */
+static_always_inline void *
+clib_cpool_get (clib_cpool_t *p, u32 thread_index, u32 *index)
+{
+  u32 i = clib_cpool_get_index (p, thread_index);
+
+  if (PREDICT_FALSE (i == ~0))
+    return 0;
+  *index = i;
+  return clib_cpool_elt_at_index (p, i);
+}
+
+/** Put back element INDEX, which may have been taken by any thread. */
+static_always_inline void
+clib_cpool_put_index (clib_cpool_t *p, u32 thread_index, u32 index)
+{
+  clib_cpool_thread_t *t = vec_elt_at_index (p->threads, thread_index);
+
+  ASSERT (!clib_cpool_is_free_index (p, index));
+  clib_cpool_set_busy (p, index, 0);
+
+  if (PREDICT_FALSE (t->n_cached == CLIB_CPOOL_CACHE_SIZE))
+    clib_cpool_drain (p, t);
+
+  t->cached[t->n_cached++] = index;
+}
+
+/** Iterate over the indices of the elements in use. Elements taken or
+    put back by other threads while iterating may or may not be seen. */
+#define clib_cpool_foreach_index(i, p)                                        \
+  for (u32 _c = 0; _c < __atomic_load_n (&(p)->n_chunks, __ATOMIC_ACQUIRE);   \
+       _c++)                                                                  \
+    for (u32 _w = 0; _w < (1 << (p)->log2_chunk_elts) / uword_bits; _w++)     \
+      for (uword _b = __atomic_load_n ((p)->busy[_c] + _w, __ATOMIC_RELAXED); \
+	   _b && ((i = (_c << (p)->log2_chunk_elts) + _w * uword_bits +       \
+		       count_trailing_zeros (_b)),                            \
+		  1);                                                         \
+	   _b = clear_lowest_set_bit (_b))
+
+#endif /* included_clib_cpool_h */
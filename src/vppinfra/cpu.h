@@ -37,7 +37,9 @@
   _ (qdf24xx, "Qualcomm CentriqTM 2400")                                      \
   _ (cortexa72, "ARM Cortex-A72")                                             \
   _ (neoversen1, "ARM Neoverse N1")                                           \
-  _ (neoversen2, "ARM Neoverse N2")
+  _ (neoversen2, "ARM Neoverse N2")                                           \
+  _ (neoversev1, "ARM Neoverse V1")                                           \
+  _ (neoversev2, "ARM Neoverse V2")
 #else
 #define foreach_march_variant
 #endif
@@ -134,6 +136,7 @@ _CLIB_MARCH_FN_REGISTRATION(fn)
   _ (rdrand, 1, ecx, 30)                                                      \
   _ (avx2, 7, ebx, 5)                                                         \
   _ (bmi2, 7, ebx, 8)                                                         \
+  _ (erms, 7, ebx, 9)                                                         \
   _ (rtm, 7, ebx, 11)                                                         \
   _ (pqm, 7, ebx, 12)                                                         \
   _ (pqe, 7, ebx, 15)                                                         \
@@ -149,9 +152,11 @@ _CLIB_MARCH_FN_REGISTRATION(fn)
   _ (movdiri, 7, ecx, 27)                                                     \
   _ (movdir64b, 7, ecx, 28)                                                   \
   _ (enqcmd, 7, ecx, 29)                                                      \
+  _ (fsrm, 7, edx, 4)                                                         \
   _ (avx512_fp16, 7, edx, 23)                                                 \
   _ (aperfmperf, 0x00000006, ecx, 0)                                          \
   _ (invariant_tsc, 0x80000007, edx, 8)                                       \
+  _ (topoext, 0x80000001, ecx, 22)                                            \
   _ (monitorx, 0x80000001, ecx, 29)
 
 #define foreach_aarch64_flags \
@@ -355,6 +360,8 @@ const clib_cpu_info_t *clib_get_cpu_info ();
 #define AARCH64_CPU_PART_CORTEXA72  0xd08
 #define AARCH64_CPU_PART_NEOVERSEN1 0xd0c
 #define AARCH64_CPU_PART_NEOVERSEN2 0xd49
+#define AARCH64_CPU_PART_NEOVERSEV1 0xd40
+#define AARCH64_CPU_PART_NEOVERSEV2 0xd4f
 
 /*cavium */
 #define AARCH64_CPU_IMPLEMENTER_CAVIUM      0x43
@@ -451,6 +458,34 @@ clib_cpu_march_priority_neoversen2 ()
   return -1;
 }
 
+static inline int
+clib_cpu_march_priority_neoversev1 ()
+{
+  const clib_cpu_info_t *info = clib_get_cpu_info ();
+
+  if (!info || info->aarch64.implementer != AARCH64_CPU_IMPLEMENTER_ARM)
+    return -1;
+
+  if (info->aarch64.part_num == AARCH64_CPU_PART_NEOVERSEV1)
+    return 10;
+
+  return -1;
+}
+
+static inline int
+clib_cpu_march_priority_neoversev2 ()
+{
+  const clib_cpu_info_t *info = clib_get_cpu_info ();
+
+  if (!info || info->aarch64.implementer != AARCH64_CPU_IMPLEMENTER_ARM)
+    return -1;
+
+  if (info->aarch64.part_num == AARCH64_CPU_PART_NEOVERSEV2)
+    return 10;
+
+  return -1;
+}
+
 #ifdef CLIB_MARCH_VARIANT
 #define CLIB_MARCH_FN_PRIORITY() CLIB_MARCH_SFX(clib_cpu_march_priority)()
 #else
@@ -868,6 +868,195 @@ aes_gcm (const u8 *src, u8 *dst, const u8 *aad, u8 *ivp, u8 *tag,
   return 0;
 }
 
+#if N_AES_LANES == 4
+/*
+ * Multi-buffer mode: up to 4 independent short ops are processed together,
+ * one per 128-bit lane, each with its own key, iv, aad and length. Ghash is
+ * done block by block with H in every lane, so it suits ops only a few
+ * blocks long, where the single buffer code can't fill its lanes.
+ */
+
+#define AES_GCM_MB_N_LANES	 4
+#define AES_GCM_MB_MAX_DATA_BYTES 256
+#define AES_GCM_MB_MAX_AAD_BYTES 16
+
+typedef struct
+{
+  const u8 *src;
+  u8 *dst;
+  const u8 *aad;
+  const u8 *iv;
+  u8 *tag;
+  const aes_gcm_key_data_t *kd;
+  u16 data_bytes;
+  u8 aad_bytes;
+  u8 tag_len;
+} aes_gcm_mb_op_t;
+
+typedef union
+{
+  u8x64 x4;
+  u32x16 u32x16;
+  u8x16 lanes[AES_GCM_MB_N_LANES];
+} aes_gcm_mb_data_t;
+
+/* a * b in each lane */
+static_always_inline u8x64
+aes_gcm_mb_ghash_mul (u8x64 a, u8x64 b)
+{
+  ghash_ctx_t _gd, *gd = &_gd;
+
+  ghash4_mul_first (gd, a, b);
+  ghash4_reduce (gd);
+  ghash4_reduce2 (gd);
+  return u8x64_xor3 (gd->hi4, u8x64_word_shift_right (gd->tmp_lo4, 4),
+		     u8x64_word_shift_left (gd->tmp_hi4, 4));
+}
+
+static_always_inline u8x64
+aes_gcm_mb_encrypt (u8x64 r, const aes_expaned_key_t *Ke, int rounds)
+{
+  r ^= Ke[0].x4;
+  for (int i = 1; i < rounds; i++)
+    r = aes_enc_round_x4 (r, Ke[i].x4);
+  return aes_enc_last_round_x4 (r, Ke[rounds].x4);
+}
+
+/**
+ * Encrypt or decrypt n_ops (at most 4) ops, one per 128-bit lane, each
+ * with 1 to AES_GCM_MB_MAX_DATA_BYTES of data and at most
+ * AES_GCM_MB_MAX_AAD_BYTES of aad. Returns a bitmap of the ops whose tag
+ * was stored or verified.
+ */
+static_always_inline u32
+aes_gcm_mb (aes_gcm_mb_op_t *ops, u32 n_ops, int aes_rounds, aes_gcm_op_t op)
+{
+  aes_expaned_key_t _Ke[AES_KEY_ROUNDS (AES_KEY_256) + 1];
+  const aes_expaned_key_t *Ke = ops[0].kd->Ke;
+  aes_gcm_mb_data_t Y, H, A, D, T;
+  u8x64 r, ghash_in, EY0, one;
+  u64 byte_mask, block_mask;
+  u32 i, l, max_blocks = 0, ok = 0;
+  u16 n_left[AES_GCM_MB_N_LANES];
+
+  ASSERT (n_ops && n_ops <= AES_GCM_MB_N_LANES);
+
+  /* per lane keys, unless all ops share one */
+  for (l = 1; l < n_ops; l++)
+    if (ops[l].kd != ops[0].kd)
+      break;
+
+  if (l < n_ops)
+    {
+      for (i = 0; i < aes_rounds + 1; i++)
+	for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+	  _Ke[i].lanes[l] = ops[l < n_ops ? l : 0].kd->Ke[i].lanes[0];
+      Ke = _Ke;
+    }
+
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    {
+      /* unused lanes compute on op 0 but store nothing */
+      aes_gcm_mb_op_t *o = ops + (l < n_ops ? l : 0);
+      u32x4 Y0;
+
+      ASSERT (o->data_bytes && o->data_bytes <= AES_GCM_MB_MAX_DATA_BYTES);
+      ASSERT (o->aad_bytes <= AES_GCM_MB_MAX_AAD_BYTES);
+
+      Y0 = (u32x4) (u64x2){ *(u64u *) o->iv, 0 };
+      Y0[2] = *(u32u *) (o->iv + 8);
+      Y0[3] = 1 << 24;
+      Y.lanes[l] = (u8x16) Y0;
+      H.lanes[l] = o->kd->Hi[NUM_HI - 1];
+      A.lanes[l] = u8x16_load_partial ((u8 *) o->aad, o->aad_bytes);
+      n_left[l] = l < n_ops ? o->data_bytes : 0;
+      max_blocks = clib_max (max_blocks, (n_left[l] + 15) / 16);
+    }
+
+  EY0 = aes_gcm_mb_encrypt (Y.x4, Ke, aes_rounds);
+
+  /* aad fits in one block, zero length aad leaves the hash at zero */
+  T.x4 = aes_gcm_mb_ghash_mul (aes_reflect (A.x4), H.x4);
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    if (!ops[l < n_ops ? l : 0].aad_bytes)
+      T.lanes[l] = u8x16_zero ();
+
+  one = (u8x64) u32x16_splat_u32x4 ((u32x4){ 0, 0, 0, 1 << 24 });
+
+  for (i = 0; i < max_blocks; i++)
+    {
+      /* data blocks start at counter 2 */
+      Y.x4 = (u8x64) ((u32x16) Y.x4 + (u32x16) one);
+      r = aes_gcm_mb_encrypt (Y.x4, Ke, aes_rounds);
+
+      byte_mask = block_mask = 0;
+      for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+	{
+	  u32 n = clib_min (n_left[l], 16);
+	  D.lanes[l] = u8x16_zero ();
+	  if (n)
+	    {
+	      D.lanes[l] = u8x16_load_partial ((u8 *) ops[l].src + i * 16, n);
+	      byte_mask |= pow2_mask (n) << (l * 16);
+	      block_mask |= (u64) 0xffff << (l * 16);
+	    }
+	}
+
+      r = u8x64_mask_blend (u8x64_zero (), D.x4 ^ r, byte_mask);
+      ghash_in = op == AES_GCM_OP_ENCRYPT ? r : D.x4;
+      D.x4 = r;
+
+      for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+	{
+	  u32 n = clib_min (n_left[l], 16);
+	  if (n == 16)
+	    *(u8x16u *) (ops[l].dst + i * 16) = D.lanes[l];
+	  else if (n)
+	    u8x16_store_partial (D.lanes[l], ops[l].dst + i * 16, n);
+	  n_left[l] -= n;
+	}
+
+      /* lanes that are done keep their hash */
+      r = aes_gcm_mb_ghash_mul (aes_reflect (ghash_in) ^ T.x4, H.x4);
+      T.x4 = u8x64_mask_blend (T.x4, r, block_mask);
+    }
+
+  /* lengths block */
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    {
+      aes_gcm_mb_op_t *o = ops + (l < n_ops ? l : 0);
+      D.lanes[l] = (u8x16) ((u64x2){ o->data_bytes, o->aad_bytes } << 3);
+    }
+  T.x4 = aes_gcm_mb_ghash_mul (D.x4 ^ T.x4, H.x4);
+  T.x4 = aes_reflect (T.x4) ^ EY0;
+
+  for (l = 0; l < n_ops; l++)
+    {
+      /* tag_len 16 -> 0 */
+      u8 tag_len = ops[l].tag_len & 0xf;
+
+      if (op == AES_GCM_OP_ENCRYPT)
+	{
+	  if (tag_len)
+	    u8x16_store_partial (T.lanes[l], ops[l].tag, tag_len);
+	  else
+	    ((u8x16u *) ops[l].tag)[0] = T.lanes[l];
+	  ok |= 1 << l;
+	}
+      else
+	{
+	  u16 mask = tag_len ? pow2_mask (tag_len) : 0xffff;
+	  u8x16 expected =
+	    u8x16_load_partial (ops[l].tag, tag_len ? tag_len : 16);
+	  if ((u8x16_msb_mask (expected == T.lanes[l]) & mask) == mask)
+	    ok |= 1 << l;
+	}
+    }
+
+  return ok;
+}
+#endif
+
 static_always_inline void
 clib_aes_gcm_key_expand (aes_gcm_key_data_t *kd, const u8 *key,
 			 aes_key_size_t ks)
@@ -0,0 +1,393 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#ifndef __clib_chacha20_h__
+#define __clib_chacha20_h__
+
+#include <vppinfra/clib.h>
+#include <vppinfra/vector.h>
+#include <vppinfra/string.h>
+#include <vppinfra/crypto/poly1305.h>
+
+/* implementation of DJB's chacha20 and of the chacha20-poly1305 AEAD
+ * construction from RFC 8439.
+ *
+ * Each 128-bit lane of a vector register holds one row of the 4x4 state
+ * of a block, so a row register computes one, two or four blocks side by
+ * side. Lanes are set up independently, so the blocks computed together
+ * may come from different keys and nonces, i.e. from different packets.
+ * Two (four with 128-bit registers) sets of rows are interleaved to hide
+ * the latency of the serial quarter rounds. */
+
+#if defined(CLIB_HAVE_VEC512)
+#define CHACHA20_N_LANES 4
+#define CHACHA20_N_GROUPS 2
+typedef u32x16 chacha20_row_t;
+#define chacha20_row_shuffle(v, a, b, c, d)                                   \
+  u32x16_shuffle (v, a, b, c, d, a + 4, b + 4, c + 4, d + 4, a + 8, b + 8,    \
+		  c + 8, d + 8, a + 12, b + 12, c + 12, d + 12)
+#elif defined(CLIB_HAVE_VEC256)
+#define CHACHA20_N_LANES 2
+#define CHACHA20_N_GROUPS 2
+typedef u32x8 chacha20_row_t;
+#define chacha20_row_shuffle(v, a, b, c, d)                                   \
+  u32x8_shuffle (v, a, b, c, d, a + 4, b + 4, c + 4, d + 4)
+#define chacha20_row_shuffle_bytes(v, a, b, c, d)                             \
+  (u32x8) u8x32_shuffle (v, _chacha20_bytes (a, b, c, d, 0),                  \
+			 _chacha20_bytes (a, b, c, d, 8),                     \
+			 _chacha20_bytes (a, b, c, d, 16),                    \
+			 _chacha20_bytes (a, b, c, d, 24))
+#else
+#define CHACHA20_N_LANES 1
+#define CHACHA20_N_GROUPS 4
+typedef u32x4 chacha20_row_t;
+#define chacha20_row_shuffle(v, a, b, c, d) u32x4_shuffle (v, a, b, c, d)
+#define chacha20_row_shuffle_bytes(v, a, b, c, d)                             \
+  (u32x4) u8x16_shuffle (v, _chacha20_bytes (a, b, c, d, 0),                  \
+			 _chacha20_bytes (a, b, c, d, 8))
+#endif
+
+/* byte indices a, b, c, d within each of the two words at offset o */
+#define _chacha20_bytes(a, b, c, d, o)                                        \
+  a + o, b + o, c + o, d + o, a + o + 4, b + o + 4, c + o + 4, d + o + 4
+
+#define CHACHA20_BLOCK_BYTES 64
+#define CHACHA20_MAX_BLOCKS  (CHACHA20_N_LANES * CHACHA20_N_GROUPS)
+
+typedef union
+{
+  chacha20_row_t row;
+  u32x4 lanes[CHACHA20_N_LANES];
+} chacha20_data_t;
+
+/* one block of keystream to generate */
+typedef struct
+{
+  const u8 *key;   /* 32 bytes */
+  const u8 *nonce; /* 12 bytes */
+  u32 counter;
+} chacha20_block_t;
+
+static_always_inline chacha20_row_t
+chacha20_rotl (chacha20_row_t v, const int n)
+{
+#ifndef CLIB_HAVE_VEC512
+  /* without a vector rotate, byte sized rotations are a byte shuffle */
+  if (n == 16)
+    return chacha20_row_shuffle_bytes (v, 2, 3, 0, 1);
+  if (n == 8)
+    return chacha20_row_shuffle_bytes (v, 3, 0, 1, 2);
+#endif
+  return (v << n) | (v >> (32 - n));
+}
+
+static_always_inline void
+chacha20_quarter_rounds (chacha20_row_t s[][4], const int n_groups)
+{
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][0] += s[g][1];
+      s[g][3] = chacha20_rotl (s[g][3] ^ s[g][0], 16);
+    }
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][2] += s[g][3];
+      s[g][1] = chacha20_rotl (s[g][1] ^ s[g][2], 12);
+    }
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][0] += s[g][1];
+      s[g][3] = chacha20_rotl (s[g][3] ^ s[g][0], 8);
+    }
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][2] += s[g][3];
+      s[g][1] = chacha20_rotl (s[g][1] ^ s[g][2], 7);
+    }
+}
+
+static_always_inline void
+chacha20_double_round (chacha20_row_t s[][4], const int n_groups)
+{
+  /* column round */
+  chacha20_quarter_rounds (s, n_groups);
+
+  /* diagonal round, rotate rows so diagonals line up as columns */
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][1] = chacha20_row_shuffle (s[g][1], 1, 2, 3, 0);
+      s[g][2] = chacha20_row_shuffle (s[g][2], 2, 3, 0, 1);
+      s[g][3] = chacha20_row_shuffle (s[g][3], 3, 0, 1, 2);
+    }
+
+  chacha20_quarter_rounds (s, n_groups);
+
+  for (int g = 0; g < n_groups; g++)
+    {
+      s[g][1] = chacha20_row_shuffle (s[g][1], 3, 0, 1, 2);
+      s[g][2] = chacha20_row_shuffle (s[g][2], 2, 3, 0, 1);
+      s[g][3] = chacha20_row_shuffle (s[g][3], 1, 2, 3, 0);
+    }
+}
+
+static_always_inline void
+chacha20_keystream_inline (const chacha20_block_t *blocks, u32 n_blocks,
+			   u8 *ks, const int n_groups)
+{
+  const u32x4 sigma = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+  chacha20_row_t s[CHACHA20_N_GROUPS][4], x[CHACHA20_N_GROUPS][4];
+  chacha20_data_t d[CHACHA20_N_GROUPS][4];
+  u32x4u *out = (u32x4u *) ks;
+
+  for (int i = 0; i < n_groups * CHACHA20_N_LANES; i++)
+    {
+      /* unused lanes compute block 0 again, and are not stored */
+      const chacha20_block_t *b = blocks + (i < n_blocks ? i : 0);
+      int g = i / CHACHA20_N_LANES, l = i % CHACHA20_N_LANES;
+
+      d[g][0].lanes[l] = sigma;
+      d[g][1].lanes[l] = *(u32x4u *) b->key;
+      d[g][2].lanes[l] = *(u32x4u *) (b->key + 16);
+      d[g][3].lanes[l] = (u32x4){ b->counter, *(u32u *) b->nonce,
+				  *(u32u *) (b->nonce + 4),
+				  *(u32u *) (b->nonce + 8) };
+    }
+
+  for (int g = 0; g < n_groups; g++)
+    for (int r = 0; r < 4; r++)
+      s[g][r] = x[g][r] = d[g][r].row;
+
+  for (int i = 0; i < 10; i++)
+    chacha20_double_round (s, n_groups);
+
+  for (int g = 0; g < n_groups; g++)
+    for (int r = 0; r < 4; r++)
+      d[g][r].row = s[g][r] + x[g][r];
+
+  for (int i = 0; i < n_blocks; i++)
+    {
+      int g = i / CHACHA20_N_LANES, l = i % CHACHA20_N_LANES;
+      for (int r = 0; r < 4; r++)
+	out[i * 4 + r] = d[g][r].lanes[l];
+    }
+}
+
+/**
+ * Generate the keystream of n_blocks (at most CHACHA20_MAX_BLOCKS) blocks
+ * into ks, CHACHA20_BLOCK_BYTES per block.
+ */
+static_always_inline void
+chacha20_keystream (const chacha20_block_t *blocks, u32 n_blocks, u8 *ks)
+{
+  ASSERT (n_blocks && n_blocks <= CHACHA20_MAX_BLOCKS);
+
+  /* only run as many row sets as there are blocks */
+#if CHACHA20_N_GROUPS == 4
+  if (n_blocks > 2 * CHACHA20_N_LANES)
+    chacha20_keystream_inline (blocks, n_blocks, ks, 4);
+  else
+#endif
+    if (n_blocks > CHACHA20_N_LANES)
+    chacha20_keystream_inline (blocks, n_blocks, ks, 2);
+  else
+    chacha20_keystream_inline (blocks, n_blocks, ks, 1);
+}
+
+static_always_inline void
+chacha20_xor (const u8 *src, u8 *dst, const u8 *ks, u32 n_bytes)
+{
+  for (; n_bytes >= 16; n_bytes -= 16, src += 16, dst += 16, ks += 16)
+    *(u8x16u *) dst = *(u8x16u *) src ^ *(u8x16u *) ks;
+
+  for (u32 i = 0; i < n_bytes; i++)
+    dst[i] = src[i] ^ ks[i];
+}
+
+/**
+ * XOR n_bytes of src with the keystream of key and nonce, starting at
+ * block counter, into dst
+ */
+static_always_inline void
+clib_chacha20 (const u8 *key, const u8 *nonce, u32 counter, const u8 *src,
+	       u8 *dst, u32 n_bytes)
+{
+  chacha20_block_t blocks[CHACHA20_MAX_BLOCKS];
+  u8 ks[CHACHA20_MAX_BLOCKS * CHACHA20_BLOCK_BYTES];
+  u32 n_blocks, n;
+
+  while (n_bytes)
+    {
+      n_blocks = round_pow2 (n_bytes, CHACHA20_BLOCK_BYTES) /
+		 CHACHA20_BLOCK_BYTES;
+      n_blocks = clib_min (n_blocks, CHACHA20_MAX_BLOCKS);
+      for (u32 i = 0; i < n_blocks; i++)
+	blocks[i] = (chacha20_block_t){ key, nonce, counter++ };
+
+      chacha20_keystream (blocks, n_blocks, ks);
+      n = clib_min (n_bytes, n_blocks * CHACHA20_BLOCK_BYTES);
+      chacha20_xor (src, dst, ks, n);
+      src += n;
+      dst += n;
+      n_bytes -= n;
+    }
+}
+
+typedef enum
+{
+  CHACHA20_POLY1305_OP_ENCRYPT,
+  CHACHA20_POLY1305_OP_DECRYPT,
+} chacha20_poly1305_op_t;
+
+static_always_inline void
+chacha20_poly1305_pad (clib_poly1305_ctx *ctx, u32 n_bytes)
+{
+  static const u8 zero[16];
+
+  if (n_bytes & 15)
+    clib_poly1305_update (ctx, zero, 16 - (n_bytes & 15));
+}
+
+/* MAC the data and en/decrypt it with the keystream in ks */
+static_always_inline void
+chacha20_poly1305_data (clib_poly1305_ctx *ctx, const u8 *src, u8 *dst,
+			const u8 *ks, u32 n_bytes, chacha20_poly1305_op_t op)
+{
+  /* the MAC is always over the ciphertext, decrypt may be in place */
+  if (op == CHACHA20_POLY1305_OP_DECRYPT)
+    clib_poly1305_update (ctx, src, n_bytes);
+  chacha20_xor (src, dst, ks, n_bytes);
+  if (op == CHACHA20_POLY1305_OP_ENCRYPT)
+    clib_poly1305_update (ctx, dst, n_bytes);
+}
+
+static_always_inline int
+chacha20_poly1305_final (clib_poly1305_ctx *ctx, u32 aad_bytes,
+			 u32 data_bytes, u8 *tag, chacha20_poly1305_op_t op)
+{
+  u64 lengths[2] = { aad_bytes, data_bytes };
+  u8x16 t;
+
+  chacha20_poly1305_pad (ctx, data_bytes);
+  clib_poly1305_update (ctx, (u8 *) lengths, sizeof (lengths));
+  clib_poly1305_final (ctx, (u8 *) &t);
+
+  if (op == CHACHA20_POLY1305_OP_ENCRYPT)
+    {
+      *(u8x16u *) tag = t;
+      return 1;
+    }
+
+  return u8x16_is_equal (t, *(u8x16u *) tag);
+}
+
+/**
+ * chacha20-poly1305 AEAD encrypt or decrypt with a 16 byte tag. Returns 1
+ * unless the tag of a decrypted op does not match.
+ */
+static_always_inline int
+clib_chacha20_poly1305 (const u8 *key, const u8 *nonce, const u8 *aad,
+			u32 aad_bytes, const u8 *src, u8 *dst, u32 data_bytes,
+			u8 *tag, chacha20_poly1305_op_t op)
+{
+  chacha20_block_t blocks[CHACHA20_MAX_BLOCKS];
+  u8 ks[CHACHA20_MAX_BLOCKS * CHACHA20_BLOCK_BYTES];
+  clib_poly1305_ctx ctx;
+  u32 n_blocks, n;
+
+  /* block 0 is the one time poly1305 key, the data starts at block 1, so
+   * compute both together */
+  n_blocks = 1 + round_pow2 (data_bytes, CHACHA20_BLOCK_BYTES) /
+		   CHACHA20_BLOCK_BYTES;
+  n_blocks = clib_min (n_blocks, CHACHA20_MAX_BLOCKS);
+  for (u32 i = 0; i < n_blocks; i++)
+    blocks[i] = (chacha20_block_t){ key, nonce, i };
+  chacha20_keystream (blocks, n_blocks, ks);
+
+  clib_poly1305_init (&ctx, ks);
+  clib_poly1305_update (&ctx, aad, aad_bytes);
+  chacha20_poly1305_pad (&ctx, aad_bytes);
+
+  n = clib_min (data_bytes, (n_blocks - 1) * CHACHA20_BLOCK_BYTES);
+  chacha20_poly1305_data (&ctx, src, dst, ks + CHACHA20_BLOCK_BYTES, n, op);
+
+  if (data_bytes > n)
+    {
+      /* MAC, then de/encrypt the rest in separate passes */
+      if (op == CHACHA20_POLY1305_OP_DECRYPT)
+	clib_poly1305_update (&ctx, src + n, data_bytes - n);
+      clib_chacha20 (key, nonce, n_blocks, src + n, dst + n, data_bytes - n);
+      if (op == CHACHA20_POLY1305_OP_ENCRYPT)
+	clib_poly1305_update (&ctx, dst + n, data_bytes - n);
+    }
+
+  return chacha20_poly1305_final (&ctx, aad_bytes, data_bytes, tag, op);
+}
+
+/* AEAD op of the multi-buffer variant */
+typedef struct
+{
+  const u8 *key;
+  const u8 *nonce;
+  const u8 *aad;
+  const u8 *src;
+  u8 *dst;
+  u8 *tag;
+  u32 data_bytes;
+  u32 aad_bytes;
+} chacha20_poly1305_mb_op_t;
+
+/* number of keystream blocks an op needs, including the poly1305 key */
+static_always_inline u32
+chacha20_poly1305_n_blocks (u32 data_bytes)
+{
+  return 1 + round_pow2 (data_bytes, CHACHA20_BLOCK_BYTES) /
+	       CHACHA20_BLOCK_BYTES;
+}
+
+/**
+ * chacha20-poly1305 for a batch of short ops whose keystreams, poly1305
+ * keys included, fit in CHACHA20_MAX_BLOCKS blocks together, so they are
+ * computed in one pass. Returns a bitmap of the ops that succeeded.
+ */
+static_always_inline u32
+chacha20_poly1305_mb (chacha20_poly1305_mb_op_t *ops, u32 n_ops,
+		      chacha20_poly1305_op_t op)
+{
+  chacha20_block_t blocks[CHACHA20_MAX_BLOCKS];
+  u8 ks[CHACHA20_MAX_BLOCKS * CHACHA20_BLOCK_BYTES];
+  u8 first_block[CHACHA20_MAX_BLOCKS];
+  clib_poly1305_ctx ctx;
+  u32 i, j, n_blocks = 0, ok = 0;
+
+  for (i = 0; i < n_ops; i++)
+    {
+      u32 n = chacha20_poly1305_n_blocks (ops[i].data_bytes);
+
+      ASSERT (n_blocks + n <= CHACHA20_MAX_BLOCKS);
+      first_block[i] = n_blocks;
+      for (j = 0; j < n; j++)
+	blocks[n_blocks++] = (chacha20_block_t){ ops[i].key, ops[i].nonce, j };
+    }
+
+  chacha20_keystream (blocks, n_blocks, ks);
+
+  for (i = 0; i < n_ops; i++)
+    {
+      chacha20_poly1305_mb_op_t *o = ops + i;
+      u8 *k = ks + first_block[i] * CHACHA20_BLOCK_BYTES;
+
+      clib_poly1305_init (&ctx, k);
+      clib_poly1305_update (&ctx, o->aad, o->aad_bytes);
+      chacha20_poly1305_pad (&ctx, o->aad_bytes);
+      chacha20_poly1305_data (&ctx, o->src, o->dst, k + CHACHA20_BLOCK_BYTES,
+			      o->data_bytes, op);
+      if (chacha20_poly1305_final (&ctx, o->aad_bytes, o->data_bytes, o->tag,
+				   op))
+	ok |= 1 << i;
+    }
+
+  return ok;
+}
+
+#endif /* __clib_chacha20_h__ */
@@ -469,3 +469,10 @@ clib_mem_set_default_numa_affinity ()
   /* TODO: Not yet implemented */
   return 0;
 }
+
+__clib_export int
+clib_mem_vm_interleave (void *base, uword size)
+{
+  /* TODO: Not yet implemented */
+  return 0;
+}
@@ -664,6 +664,26 @@ clib_mem_set_default_numa_affinity ()
   return 0;
 }
 
+__clib_export int
+clib_mem_vm_interleave (void *base, uword size)
+{
+  clib_mem_main_t *mm = &clib_mem_main;
+  uword bmp = mm->numa_node_bitmap;
+
+  /* no numa support, or a single node */
+  if (count_set_bits (bmp) < 2)
+    return 0;
+
+  if (syscall (__NR_mbind, (uword) base, size, MPOL_INTERLEAVE, &bmp,
+	       sizeof (bmp) * 8 + 1, 0))
+    {
+      vec_reset_length (mm->error);
+      mm->error = clib_error_return_unix (mm->error, (char *) __func__);
+      return CLIB_MEM_ERROR;
+    }
+  return 0;
+}
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -158,6 +158,15 @@ typedef struct
 
   /* last error */
   clib_error_t *error;
+
+  /* tables (bihash) of at least this many bytes get a heap of their own,
+     0 to allocate them from the caller's heap */
+  uword table_heap_threshold;
+
+  /* page size of table heaps, and whether to interleave them across
+     numa nodes */
+  clib_mem_page_sz_t log2_table_heap_page_sz;
+  u8 table_heap_interleave;
 } clib_mem_main_t;
 
 extern clib_mem_main_t clib_mem_main;
@@ -288,6 +297,7 @@ clib_mem_set_heap (clib_mem_heap_t * heap)
 }
 
 void clib_mem_destroy_heap (clib_mem_heap_t * heap);
+clib_mem_heap_t *clib_mem_create_table_heap (uword size, char *name);
 clib_mem_heap_t *clib_mem_create_heap (void *base, uword size, int is_locked,
 				       char *fmt, ...);
 
@@ -434,6 +444,7 @@ u64 *clib_mem_vm_get_paddr (void *mem, clib_mem_page_sz_t log2_page_size,
 			    int n_pages);
 void clib_mem_destroy (void);
 int clib_mem_set_numa_affinity (u8 numa_node, int force);
+int clib_mem_vm_interleave (void *base, uword size);
 int clib_mem_set_default_numa_affinity ();
 void clib_mem_vm_randomize_va (uword * requested_va,
 			       clib_mem_page_sz_t log2_page_size);
@@ -513,6 +524,18 @@ void *clib_mem_bulk_alloc (clib_mem_bulk_handle_t h);
 void clib_mem_bulk_free (clib_mem_bulk_handle_t h, void *p);
 u8 *format_clib_mem_bulk (u8 *s, va_list *args);
 
+/* slab allocator */
+
+typedef void *clib_mem_slab_handle_t;
+clib_mem_slab_handle_t clib_mem_slab_create (uword size,
+					     clib_mem_page_sz_t log2_page_sz,
+					     char *fmt, ...);
+void clib_mem_slab_destroy (clib_mem_slab_handle_t h);
+void *clib_mem_slab_alloc (clib_mem_slab_handle_t h, uword size);
+void clib_mem_slab_free (clib_mem_slab_handle_t h, void *p);
+clib_mem_slab_handle_t clib_mem_slab_get_next (clib_mem_slab_handle_t h);
+u8 *format_clib_mem_slab (u8 *s, va_list *args);
+
 #include <vppinfra/error.h>	/* clib_panic */
 
 #endif /* _included_clib_mem_h */
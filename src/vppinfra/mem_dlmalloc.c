@@ -212,7 +212,7 @@ clib_mem_create_heap_internal (void *base, uword size,
       log2_page_sz = clib_mem_log2_page_size_validate (log2_page_sz);
       size = round_pow2 (size, clib_mem_page_bytes (log2_page_sz));
       base = clib_mem_vm_map_internal (0, log2_page_sz, size, -1, 0,
-				       "main heap");
+				       name[0] ? name : "main heap");
 
       if (base == CLIB_MEM_VM_MAP_FAILED)
 	return 0;
@@ -597,6 +597,27 @@ clib_mem_create_heap (void *base, uword size, int is_locked, char *fmt, ...)
   return h;
 }
 
+/* Create a locked heap for a large table, on table_heap page size pages
+   and interleaved across numa nodes if so configured. Returns 0 if the
+   pages are not available. */
+__clib_export clib_mem_heap_t *
+clib_mem_create_table_heap (uword size, char *name)
+{
+  clib_mem_main_t *mm = &clib_mem_main;
+  clib_mem_page_sz_t log2_page_sz = mm->log2_table_heap_page_sz;
+  clib_mem_heap_t *h;
+
+  if (log2_page_sz == CLIB_MEM_PAGE_SZ_UNKNOWN)
+    log2_page_sz = CLIB_MEM_PAGE_SZ_DEFAULT_HUGE;
+
+  h = clib_mem_create_heap_internal (0, size, log2_page_sz, 1 /* locked */,
+				     name);
+  if (h && mm->table_heap_interleave)
+    clib_mem_vm_interleave (h->base, h->size);
+
+  return h;
+}
+
 __clib_export void
 clib_mem_destroy_heap (clib_mem_heap_t * h)
 {
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/clib.h>
+#include <vppinfra/mem.h>
+#include <vppinfra/lock.h>
+#include <vppinfra/format.h>
+
+/*
+ * Slab allocator with per-thread size class freelists.
+ *
+ * An allocator owns one virtual memory region, mapped once with the
+ * requested page size, and carved into CLIB_MEM_SLAB_SIZE aligned slabs.
+ * Each slab holds objects of a single size class and belongs to the
+ * thread which took it. Allocation and free by the owner thread touch
+ * only that thread's state, no lock and no atomic. A free from another
+ * thread pushes the object onto a lock-free stack of the owner, which
+ * takes them back the next time it runs out of objects of that class.
+ *
+ * The global slab list is only locked to take a slab or to give back an
+ * empty one. Requests larger than the largest size class go to the heap
+ * which was current when the allocator was created.
+ */
+
+#define CLIB_MEM_SLAB_LOG2_SIZE 16
+#define CLIB_MEM_SLAB_SIZE	(1 << CLIB_MEM_SLAB_LOG2_SIZE)
+
+#define foreach_clib_mem_slab_class                                           \
+  _ (16) _ (32) _ (48) _ (64) _ (96) _ (128) _ (192) _ (256) _ (384) _ (512)  \
+    _ (768) _ (1024) _ (1536) _ (2048) _ (3072) _ (4096)
+
+static const u16 clib_mem_slab_class_sizes[] = {
+#define _(n) n,
+  foreach_clib_mem_slab_class
+#undef _
+};
+
+#define CLIB_MEM_SLAB_N_CLASSES ARRAY_LEN (clib_mem_slab_class_sizes)
+
+typedef struct clib_mem_slab_hdr
+{
+  struct clib_mem_slab_hdr *next, *prev;
+  void *freelist;
+  /* free objects, including the ones never handed out */
+  u32 n_free;
+  /* objects handed out at least once, the others follow */
+  u32 n_carved;
+  u32 n_objs;
+  u16 thread_index;
+  u8 class;
+} clib_mem_slab_hdr_t;
+
+#define CLIB_MEM_SLAB_HDR_SIZE                                                \
+  round_pow2 (sizeof (clib_mem_slab_hdr_t), CLIB_CACHE_LINE_BYTES)
+
+typedef struct
+{
+  /* slabs with free objects */
+  clib_mem_slab_hdr_t *avail;
+  u32 n_slabs;
+  u64 n_allocs;
+  u64 n_frees;
+  u64 n_remote_frees;
+} clib_mem_slab_class_t;
+
+typedef struct
+{
+  clib_mem_slab_class_t classes[CLIB_MEM_SLAB_N_CLASSES];
+
+  /* objects freed by other threads, pushed there without a lock */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  void *remote_frees[CLIB_MEM_SLAB_N_CLASSES];
+} clib_mem_slab_thread_t;
+
+typedef struct clib_mem_slab
+{
+  u8 *name;
+  void *map_base;
+  /* slab aligned region, next never used slab and end */
+  u8 *base, *next_slab, *end;
+  clib_mem_slab_hdr_t *free_slabs;
+  u32 n_free_slabs;
+  u32 lock;
+  clib_mem_page_sz_t log2_page_sz;
+  clib_mem_heap_t *heap;
+  u64 n_large_allocs;
+  u64 n_large_frees;
+  struct clib_mem_slab *next;
+  clib_mem_slab_thread_t *threads[CLIB_MAX_MHEAPS];
+} clib_mem_slab_t;
+
+static clib_mem_slab_t *clib_mem_slabs;
+static u32 clib_mem_slabs_lock;
+
+static_always_inline u32
+clib_mem_slab_class (uword size)
+{
+  for (u32 i = 0; i < CLIB_MEM_SLAB_N_CLASSES; i++)
+    if (size <= clib_mem_slab_class_sizes[i])
+      return i;
+  return ~0;
+}
+
+static_always_inline clib_mem_slab_hdr_t *
+clib_mem_slab_hdr (void *p)
+{
+  return (clib_mem_slab_hdr_t *) ((uword) p & ~(CLIB_MEM_SLAB_SIZE - 1));
+}
+
+static inline void
+clib_mem_slab_list_add (clib_mem_slab_hdr_t **first, clib_mem_slab_hdr_t *s)
+{
+  s->next = *first;
+  s->prev = 0;
+  if (s->next)
+    s->next->prev = s;
+  *first = s;
+}
+
+static inline void
+clib_mem_slab_list_remove (clib_mem_slab_hdr_t **first,
+			   clib_mem_slab_hdr_t *s)
+{
+  if (s->next)
+    s->next->prev = s->prev;
+  if (s->prev)
+    s->prev->next = s->next;
+  else
+    *first = s->next;
+  s->next = s->prev = 0;
+}
+
+__clib_export clib_mem_slab_handle_t
+clib_mem_slab_create (uword size, clib_mem_page_sz_t log2_page_sz, char *fmt,
+		      ...)
+{
+  clib_mem_slab_t *sm;
+  va_list va;
+  u8 *name;
+  void *base;
+
+  va_start (va, fmt);
+  name = va_format (0, fmt, &va);
+  va_end (va);
+  vec_add1 (name, 0);
+
+  size = round_pow2 (size, CLIB_MEM_SLAB_SIZE);
+  base = clib_mem_vm_map (0, size + CLIB_MEM_SLAB_SIZE, log2_page_sz, "%s",
+			  name);
+  if (base == CLIB_MEM_VM_MAP_FAILED)
+    {
+      vec_free (name);
+      return 0;
+    }
+
+  sm = clib_mem_alloc_aligned (sizeof (clib_mem_slab_t), CLIB_CACHE_LINE_BYTES);
+  clib_memset (sm, 0, sizeof (clib_mem_slab_t));
+  sm->name = name;
+  sm->map_base = base;
+  sm->base = (u8 *) round_pow2 ((uword) base, CLIB_MEM_SLAB_SIZE);
+  sm->next_slab = sm->base;
+  sm->end = sm->base + size;
+  sm->log2_page_sz = clib_mem_log2_page_size_validate (log2_page_sz);
+  sm->heap = clib_mem_get_heap ();
+
+  CLIB_SPINLOCK_LOCK (clib_mem_slabs_lock);
+  sm->next = clib_mem_slabs;
+  clib_mem_slabs = sm;
+  CLIB_SPINLOCK_UNLOCK (clib_mem_slabs_lock);
+
+  return sm;
+}
+
+__clib_export void
+clib_mem_slab_destroy (clib_mem_slab_handle_t h)
+{
+  clib_mem_slab_t *sm = h, **p;
+
+  CLIB_SPINLOCK_LOCK (clib_mem_slabs_lock);
+  for (p = &clib_mem_slabs; *p; p = &(*p)->next)
+    if (*p == sm)
+      {
+	*p = sm->next;
+	break;
+      }
+  CLIB_SPINLOCK_UNLOCK (clib_mem_slabs_lock);
+
+  for (int i = 0; i < ARRAY_LEN (sm->threads); i++)
+    if (sm->threads[i])
+      clib_mem_heap_free (sm->heap, sm->threads[i]);
+
+  clib_mem_vm_unmap (sm->map_base);
+  vec_free (sm->name);
+  clib_mem_free (sm);
+}
+
+static clib_mem_slab_hdr_t *
+clib_mem_slab_get (clib_mem_slab_t *sm, u32 class, u16 thread_index)
+{
+  clib_mem_slab_hdr_t *s = 0;
+  u32 size = clib_mem_slab_class_sizes[class];
+
+  CLIB_SPINLOCK_LOCK (sm->lock);
+  if (sm->free_slabs)
+    {
+      s = sm->free_slabs;
+      clib_mem_slab_list_remove (&sm->free_slabs, s);
+      sm->n_free_slabs--;
+    }
+  else if (sm->next_slab < sm->end)
+    {
+      s = (clib_mem_slab_hdr_t *) sm->next_slab;
+      sm->next_slab += CLIB_MEM_SLAB_SIZE;
+    }
+  CLIB_SPINLOCK_UNLOCK (sm->lock);
+
+  if (s == 0)
+    return 0;
+
+  clib_memset (s, 0, sizeof (clib_mem_slab_hdr_t));
+  s->n_objs = (CLIB_MEM_SLAB_SIZE - CLIB_MEM_SLAB_HDR_SIZE) / size;
+  s->n_free = s->n_objs;
+  s->thread_index = thread_index;
+  s->class = class;
+  return s;
+}
+
+static void
+clib_mem_slab_put (clib_mem_slab_t *sm, clib_mem_slab_hdr_t *s)
+{
+  CLIB_SPINLOCK_LOCK (sm->lock);
+  clib_mem_slab_list_add (&sm->free_slabs, s);
+  sm->n_free_slabs++;
+  CLIB_SPINLOCK_UNLOCK (sm->lock);
+}
+
+static_always_inline void
+clib_mem_slab_free_local (clib_mem_slab_t *sm, clib_mem_slab_thread_t *t,
+			  clib_mem_slab_hdr_t *s, void *p)
+{
+  clib_mem_slab_class_t *c = t->classes + s->class;
+
+  *(void **) p = s->freelist;
+  s->freelist = p;
+  s->n_free++;
+
+  if (s->n_free == 1)
+    clib_mem_slab_list_add (&c->avail, s);
+  else if (s->n_free == s->n_objs && (c->avail != s || s->next))
+    {
+      /* empty, and not the last slab of its class on this thread */
+      clib_mem_slab_list_remove (&c->avail, s);
+      c->n_slabs--;
+      clib_mem_slab_put (sm, s);
+    }
+}
+
+static void
+clib_mem_slab_reclaim_remote (clib_mem_slab_t *sm, clib_mem_slab_thread_t *t,
+			      u32 class)
+{
+  void *p, *next;
+
+  p = __atomic_exchange_n (&t->remote_frees[class], 0, __ATOMIC_ACQUIRE);
+
+  while (p)
+    {
+      next = *(void **) p;
+      clib_mem_slab_free_local (sm, t, clib_mem_slab_hdr (p), p);
+      t->classes[class].n_remote_frees++;
+      p = next;
+    }
+}
+
+static clib_mem_slab_thread_t *
+clib_mem_slab_thread_init (clib_mem_slab_t *sm, u32 thread_index)
+{
+  clib_mem_slab_thread_t *t;
+
+  t = clib_mem_heap_alloc_aligned (sm->heap, sizeof (clib_mem_slab_thread_t),
+				   CLIB_CACHE_LINE_BYTES);
+  clib_memset (t, 0, sizeof (clib_mem_slab_thread_t));
+  __atomic_store_n (&sm->threads[thread_index], t, __ATOMIC_RELEASE);
+  return t;
+}
+
+__clib_export void *
+clib_mem_slab_alloc (clib_mem_slab_handle_t h, uword size)
+{
+  clib_mem_slab_t *sm = h;
+  u32 thread_index = os_get_thread_index ();
+  clib_mem_slab_thread_t *t = sm->threads[thread_index];
+  u32 class = clib_mem_slab_class (size);
+  clib_mem_slab_class_t *c;
+  clib_mem_slab_hdr_t *s;
+  void *p;
+
+  if (PREDICT_FALSE (class == ~0))
+    {
+      __atomic_fetch_add (&sm->n_large_allocs, 1, __ATOMIC_RELAXED);
+      return clib_mem_heap_alloc_aligned (sm->heap, size,
+					  CLIB_CACHE_LINE_BYTES);
+    }
+
+  if (PREDICT_FALSE (t == 0))
+    t = clib_mem_slab_thread_init (sm, thread_index);
+
+  c = t->classes + class;
+
+  if (PREDICT_FALSE (c->avail == 0))
+    {
+      clib_mem_slab_reclaim_remote (sm, t, class);
+
+      if (c->avail == 0)
+	{
+	  if ((s = clib_mem_slab_get (sm, class, thread_index)) == 0)
+	    return 0;
+	  clib_mem_slab_list_add (&c->avail, s);
+	  c->n_slabs++;
+	}
+    }
+
+  s = c->avail;
+
+  if (s->freelist)
+    {
+      p = s->freelist;
+      s->freelist = *(void **) p;
+    }
+  else
+    p = (u8 *) s + CLIB_MEM_SLAB_HDR_SIZE +
+	s->n_carved++ * clib_mem_slab_class_sizes[class];
+
+  if (--s->n_free == 0)
+    clib_mem_slab_list_remove (&c->avail, s);
+
+  c->n_allocs++;
+  return p;
+}
+
+__clib_export void
+clib_mem_slab_free (clib_mem_slab_handle_t h, void *p)
+{
+  clib_mem_slab_t *sm = h;
+  clib_mem_slab_hdr_t *s;
+  clib_mem_slab_thread_t *t;
+  void **head, *old;
+
+  if (PREDICT_FALSE ((u8 *) p < sm->base || (u8 *) p >= sm->end))
+    {
+      __atomic_fetch_add (&sm->n_large_frees, 1, __ATOMIC_RELAXED);
+      clib_mem_heap_free (sm->heap, p);
+      return;
+    }
+
+  s = clib_mem_slab_hdr (p);
+  t = sm->threads[s->thread_index];
+
+  if (PREDICT_TRUE (s->thread_index == os_get_thread_index ()))
+    {
+      t->classes[s->class].n_frees++;
+      clib_mem_slab_free_local (sm, t, s, p);
+      return;
+    }
+
+  /* freed by another thread, hand it back to the owner */
+  head = &t->remote_frees[s->class];
+  old = __atomic_load_n (head, __ATOMIC_RELAXED);
+  do
+    *(void **) p = old;
+  while (!__atomic_compare_exchange_n (head, &old, p, /* weak */ 1,
+				       __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+__clib_export clib_mem_slab_handle_t
+clib_mem_slab_get_next (clib_mem_slab_handle_t h)
+{
+  clib_mem_slab_t *sm = h;
+  return sm ? sm->next : clib_mem_slabs;
+}
+
+__clib_export u8 *
+format_clib_mem_slab (u8 *s, va_list *args)
+{
+  clib_mem_slab_t *sm = va_arg (*args, clib_mem_slab_handle_t);
+  int verbose = va_arg (*args, int);
+  u32 indent = format_get_indent (s);
+  uword n_slabs = (sm->end - sm->base) >> CLIB_MEM_SLAB_LOG2_SIZE;
+  uword n_used = ((sm->next_slab - sm->base) >> CLIB_MEM_SLAB_LOG2_SIZE) -
+		 sm->n_free_slabs;
+
+  s = format (s, "%s: %U of %U pages, %lu of %lu %U slabs in use", sm->name,
+	      format_memory_size, sm->end - sm->base, format_log2_page_size,
+	      sm->log2_page_sz, n_used, n_slabs, format_memory_size,
+	      (uword) CLIB_MEM_SLAB_SIZE);
+  s = format (s, "\n%Ularge objects: %lu allocs, %lu frees",
+	      format_white_space, indent + 2, sm->n_large_allocs,
+	      sm->n_large_frees);
+
+  s = format (s, "\n%U%8s%8s%12s%14s%14s%14s", format_white_space,
+	      indent + 2, "Size", "Slabs", "In use", "Allocs", "Frees",
+	      "Remote frees");
+
+  for (u32 i = 0; i < CLIB_MEM_SLAB_N_CLASSES; i++)
+    {
+      clib_mem_slab_class_t sum = {};
+
+      for (u32 ti = 0; ti < ARRAY_LEN (sm->threads); ti++)
+	{
+	  clib_mem_slab_thread_t *t = sm->threads[ti];
+	  clib_mem_slab_class_t *c;
+
+	  if (t == 0)
+	    continue;
+
+	  c = t->classes + i;
+	  sum.n_slabs += c->n_slabs;
+	  sum.n_allocs += c->n_allocs;
+	  sum.n_frees += c->n_frees + c->n_remote_frees;
+	  sum.n_remote_frees += c->n_remote_frees;
+
+	  if (verbose && c->n_allocs)
+	    s = format (s, "\n%U%8u%8u%12lu%14lu%14lu%14lu  thread %u",
+			format_white_space, indent + 2,
+			clib_mem_slab_class_sizes[i], c->n_slabs,
+			c->n_allocs - c->n_frees - c->n_remote_frees,
+			c->n_allocs, c->n_frees + c->n_remote_frees,
+			c->n_remote_frees, ti);
+	}
+
+      if (sum.n_allocs == 0 || verbose)
+	continue;
+
+      s = format (s, "\n%U%8u%8u%12lu%14lu%14lu%14lu", format_white_space,
+		  indent + 2, clib_mem_slab_class_sizes[i], sum.n_slabs,
+		  sum.n_allocs - sum.n_frees, sum.n_allocs, sum.n_frees,
+		  sum.n_remote_frees);
+    }
+
+  return s;
+}
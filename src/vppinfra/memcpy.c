@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vppinfra/clib.h>
+#include <vppinfra/cpu.h>
+#include <vppinfra/memcpy_x86_64.h>
+
+#ifdef __x86_64__
+
+__clib_export clib_memcpy_large_config_t clib_memcpy_large_config = {
+  .nt_threshold = ~0,
+  .rep_movsb_threshold = ~0,
+};
+
+/* share of the last level cache of each thread using it, from the
+   deterministic cache parameters leaf (4 on Intel, 0x8000001d on AMD) */
+static uword
+clib_memcpy_llc_share (void)
+{
+  u32 eax, ebx, ecx, edx, leaf = 4;
+  uword share = 0, level = 0;
+
+  __cpuid (0, eax, ebx, ecx, edx);
+  if (ebx == 0x68747541) /* "Auth"enticAMD */
+    {
+      if (clib_cpu_supports_topoext () == 0)
+	return 0;
+      leaf = 0x8000001d;
+    }
+  else if (eax < 4)
+    return 0;
+
+  for (u32 i = 0; i < 16; i++)
+    {
+      u32 type, l, n_sharing;
+
+      __cpuid_count (leaf, i, eax, ebx, ecx, edx);
+      type = eax & 0x1f;
+      if (type == 0)
+	break;
+
+      /* data or unified */
+      if (type != 1 && type != 3)
+	continue;
+
+      l = (eax >> 5) & 7;
+      if (l < level)
+	continue;
+
+      n_sharing = ((eax >> 14) & 0xfff) + 1;
+      level = l;
+      share = (uword) ((ebx >> 22) + 1) * (((ebx >> 12) & 0x3ff) + 1) *
+	      ((ebx & 0xfff) + 1) * (ecx + 1) / n_sharing;
+    }
+
+  return share;
+}
+
+static void __clib_constructor
+clib_memcpy_large_config_init (void)
+{
+  clib_memcpy_large_config_t *c = &clib_memcpy_large_config;
+
+  c->llc_share = clib_memcpy_llc_share ();
+
+  /* a copy bigger than a good part of our cache share would evict the
+     working set and be evicted itself before anybody reads it */
+  if (c->llc_share)
+    c->nt_threshold = clib_max (c->llc_share * 3 / 4, 64 << 10);
+
+  /* rep movsb has a startup cost, worth paying once the vector loop is
+     no faster; with FSRM that happens earlier */
+  if (clib_cpu_supports_fsrm ())
+    c->rep_movsb_threshold = 2 << 10;
+  else if (clib_cpu_supports_erms ())
+    c->rep_movsb_threshold = 8 << 10;
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <vppinfra/clib.h>
 #include <vppinfra/warnings.h>
 #include <stdio.h>
+#include <x86intrin.h>
 
 /* clang-format off */
 WARN_OFF (stringop-overflow)
@@ -605,6 +606,82 @@ clib_memcpy_x86_64 (void *restrict dst, const void *restrict src, size_t n)
 #endif
 }
 
+typedef struct
+{
+  /* per-thread share of the last level cache, 0 if unknown */
+  uword llc_share;
+  /* copies of at least this many bytes use non-temporal stores */
+  uword nt_threshold;
+  /* copies of at least this many bytes, below nt_threshold, use rep movsb */
+  uword rep_movsb_threshold;
+} clib_memcpy_large_config_t;
+
+extern clib_memcpy_large_config_t clib_memcpy_large_config;
+
+static_always_inline void
+clib_memcpy_x86_64_rep_movsb (void *dst, const void *src, size_t n)
+{
+  __asm__ volatile("rep movsb"
+		   : "+D"(dst), "+S"(src), "+c"(n)
+		   :
+		   : "memory");
+}
+
+/* copy with stores which bypass the cache hierarchy, so a copy much
+   bigger than the cache does not evict the working set of the caller */
+static_always_inline void
+clib_memcpy_x86_64_nt (u8 *d, u8 *s, size_t n)
+{
+  size_t head = clib_min (-(uword) d & 63, n);
+
+  /* align destination to a cache line */
+  clib_memcpy_x86_64 (d, s, head);
+  d += head;
+  s += head;
+  n -= head;
+
+  for (; n >= 64; d += 64, s += 64, n -= 64)
+    {
+#if defined(CLIB_HAVE_VEC512)
+      _mm512_stream_si512 ((__m512i *) d, (__m512i) u8x64_load_unaligned (s));
+#elif defined(CLIB_HAVE_VEC256)
+      _mm256_stream_si256 ((__m256i *) d,
+			   (__m256i) u8x32_load_unaligned (s));
+      _mm256_stream_si256 ((__m256i *) (d + 32),
+			   (__m256i) u8x32_load_unaligned (s + 32));
+#else
+      for (int i = 0; i < 64; i += 16)
+	_mm_stream_si128 ((__m128i *) (d + i),
+			  _mm_loadu_si128 ((__m128i *) (s + i)));
+#endif
+    }
+
+  /* non-temporal stores are weakly ordered */
+  _mm_sfence ();
+
+  clib_memcpy_x86_64 (d, s, n);
+}
+
+/** Copy N bytes, picking the method by size. Small and medium copies use
+    clib_memcpy_x86_64. Larger ones use rep movsb on CPUs with fast short
+    rep movsb (FSRM) or enhanced rep movsb (ERMS), and copies too big to
+    stay in the last level cache use non-temporal stores. Thresholds are
+    set at startup from CPUID, see clib_memcpy_large_config. */
+static_always_inline void *
+clib_memcpy_x86_64_large (void *restrict dst, const void *restrict src,
+			  size_t n)
+{
+  clib_memcpy_large_config_t *c = &clib_memcpy_large_config;
+
+  if (PREDICT_FALSE (n >= c->nt_threshold))
+    clib_memcpy_x86_64_nt ((u8 *) dst, (u8 *) src, n);
+  else if (n >= c->rep_movsb_threshold)
+    clib_memcpy_x86_64_rep_movsb (dst, src, n);
+  else
+    clib_memcpy_x86_64 (dst, src, n);
+  return dst;
+}
+
 /* clang-format off */
 WARN_ON (stringop-overflow)
 /* clang-format on */
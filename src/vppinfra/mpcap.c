@@ -108,8 +108,8 @@ mpcap_init (mpcap_main_t * pm)
     pm->max_file_size = MPCAP_DEFAULT_FILE_SIZE;
 
   /* Round to a multiple of the page size */
-  pm->max_file_size += (u64) clib_mem_get_page_size ();
-  pm->max_file_size &= ~(u64) clib_mem_get_page_size ();
+  pm->max_file_size =
+    round_pow2_u64 (pm->max_file_size, clib_mem_get_page_size ());
 
   /* Set file size. */
   if (lseek (fd, pm->max_file_size - 1, SEEK_SET) == (off_t) - 1)
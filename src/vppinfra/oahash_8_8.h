@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#undef OAHASH_TYPE
+#define OAHASH_TYPE _8_8
+
+#ifndef __included_oahash_8_8_h__
+#define __included_oahash_8_8_h__
+
+#include <vppinfra/clib.h>
+#include <vppinfra/format.h>
+#include <vppinfra/xxhash.h>
+#include <vppinfra/crc32.h>
+
+/** 8 octet key, 8 octet value */
+typedef struct
+{
+  u64 key;   /**< the key */
+  u64 value; /**< the value */
+} clib_oahash_kv_8_8_t;
+
+static_always_inline u64
+clib_oahash_hash_8_8 (clib_oahash_kv_8_8_t *v)
+{
+#ifdef clib_crc32c_uses_intrinsics
+  return clib_crc32c ((u8 *) &v->key, 8);
+#else
+  return clib_xxhash (v->key);
+#endif
+}
+
+static_always_inline int
+clib_oahash_key_compare_8_8 (clib_oahash_kv_8_8_t *a, clib_oahash_kv_8_8_t *b)
+{
+  return a->key == b->key;
+}
+
+static inline u8 *
+format_clib_oahash_kvp_8_8 (u8 *s, va_list *args)
+{
+  clib_oahash_kv_8_8_t *v = va_arg (*args, clib_oahash_kv_8_8_t *);
+
+  return format (s, "key %llu value %llu", v->key, v->value);
+}
+
+#include <vppinfra/oahash_template.h>
+
+#endif /* __included_oahash_8_8_h__ */
@@ -0,0 +1,332 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+/** @file
+ * Open addressing hash table template.
+ *
+ * Key / value pairs are stored inline in a flat slot array, next to an
+ * array of one control byte per slot. A control byte is either EMPTY,
+ * DELETED, or the low 7 bits of the hash of the key in the slot.
+ * Lookups load 16 control bytes at a time and compare them all against
+ * the hash bits of the key in one vector compare, so most lookups touch
+ * one cache line of control bytes and one slot.
+ *
+ * Like bihash, instantiate by defining OAHASH_TYPE and including a type
+ * header, e.g. vppinfra/oahash_8_8.h, which provides the key / value
+ * pair type and hash, compare and format functions for it.
+ *
+ * Not thread safe: callers serialize all access when writers can run.
+ */
+
+#ifndef OAHASH_TYPE
+#error OAHASH_TYPE not defined
+#endif
+
+#include <vppinfra/clib.h>
+#include <vppinfra/mem.h>
+#include <vppinfra/format.h>
+#include <vppinfra/vector.h>
+
+#ifndef __included_oahash_common_h__
+#define __included_oahash_common_h__
+
+#define OAHASH_CTRL_EMPTY   0x80
+#define OAHASH_CTRL_DELETED 0xfe
+#define OAHASH_GROUP_SIZE   16
+
+/* all-empty control bytes, used by tables with nothing allocated yet */
+static u8 oahash_empty_ctrl[2 * OAHASH_GROUP_SIZE] __clib_unused = {
+  [0 ... 2 * OAHASH_GROUP_SIZE - 1] = OAHASH_CTRL_EMPTY,
+};
+
+/* bitmap of the bytes in a group of 16 control bytes equal to b */
+static_always_inline u32
+oahash_group_match (u8 *ctrl, u8 b)
+{
+#ifdef CLIB_HAVE_VEC128
+  u8x16 g = u8x16_load_unaligned (ctrl);
+  return u8x16_msb_mask ((u8x16) (g == u8x16_splat (b)));
+#else
+  u32 mask = 0;
+  for (int i = 0; i < OAHASH_GROUP_SIZE; i++)
+    mask |= (ctrl[i] == b) << i;
+  return mask;
+#endif
+}
+
+/* bitmap of the empty or deleted bytes in a group of 16 control bytes */
+static_always_inline u32
+oahash_group_match_free (u8 *ctrl)
+{
+#ifdef CLIB_HAVE_VEC128
+  return u8x16_msb_mask (u8x16_load_unaligned (ctrl));
+#else
+  u32 mask = 0;
+  for (int i = 0; i < OAHASH_GROUP_SIZE; i++)
+    mask |= (ctrl[i] >> 7) << i;
+  return mask;
+#endif
+}
+
+/* index of the first slot in use at or after i, or n_slots */
+static_always_inline u32
+oahash_next_used (u8 *ctrl, u32 n_slots, u32 i)
+{
+  for (; i < n_slots; i++)
+    if ((ctrl[i] & 0x80) == 0)
+      break;
+  return i;
+}
+
+/** Iterate over the key / value pairs of table H, setting KV to each.
+    Deleting the current pair is allowed, adding pairs is not. */
+#define oahash_foreach_kv(kv, h)                                              \
+  for (u32 _i = oahash_next_used ((h)->ctrl, (h)->n_slots, 0);                \
+       _i < (h)->n_slots && ((kv) = (h)->slots + _i, 1);                      \
+       _i = oahash_next_used ((h)->ctrl, (h)->n_slots, _i + 1))
+
+#endif /* __included_oahash_common_h__ */
+
+#undef _oav
+#undef __oav
+#undef OAV
+#undef _oavt
+#undef __oavt
+#undef OAVT
+
+#define _oav(a, b)  a##b
+#define __oav(a, b) _oav (a, b)
+#define OAV(a)	    __oav (a, OAHASH_TYPE)
+
+#define _oavt(a, b)  a##b##_t
+#define __oavt(a, b) _oavt (a, b)
+#define OAVT(a)	     __oavt (a, OAHASH_TYPE)
+
+typedef struct
+{
+  /* n_slots control bytes, then copies of the first group, so a group
+     load at any slot index does not need to wrap */
+  u8 *ctrl;
+  OAVT (clib_oahash_kv) * slots;
+  u32 n_slots;
+  u32 n_elts;
+  u32 n_deleted;
+  char *name;
+} OAVT (clib_oahash);
+
+static_always_inline void
+OAV (clib_oahash_set_ctrl) (OAVT (clib_oahash) * h, u32 i, u8 c)
+{
+  h->ctrl[i] = c;
+  if (i < OAHASH_GROUP_SIZE)
+    h->ctrl[h->n_slots + i] = c;
+}
+
+static_always_inline int
+OAV (clib_oahash_find) (OAVT (clib_oahash) * h, OAVT (clib_oahash_kv) * kv,
+			u64 hash, u32 *index)
+{
+  u32 mask = h->n_slots - 1;
+  u32 pos = (hash >> 7) & mask;
+  u8 h2 = hash & 0x7f;
+
+  for (u32 step = OAHASH_GROUP_SIZE;; step += OAHASH_GROUP_SIZE)
+    {
+      u8 *g = h->ctrl + pos;
+      u32 m = oahash_group_match (g, h2);
+
+      while (m)
+	{
+	  u32 i = (pos + count_trailing_zeros (m)) & mask;
+	  if (PREDICT_TRUE (OAV (clib_oahash_key_compare) (h->slots + i, kv)))
+	    {
+	      *index = i;
+	      return 1;
+	    }
+	  m = clear_lowest_set_bit (m);
+	}
+
+      /* an empty slot ends every probe sequence which could hold it */
+      if (PREDICT_TRUE (oahash_group_match (g, OAHASH_CTRL_EMPTY)))
+	return 0;
+
+      pos = (pos + step) & mask;
+    }
+}
+
+/** Look up the key in KV_IN. Copies the key / value pair to KV_OUT and
+    returns 0 when found, returns -1 otherwise. */
+static_always_inline int
+OAV (clib_oahash_search) (OAVT (clib_oahash) * h,
+			  OAVT (clib_oahash_kv) * kv_in,
+			  OAVT (clib_oahash_kv) * kv_out)
+{
+  u32 i;
+
+  if (OAV (clib_oahash_find) (h, kv_in, OAV (clib_oahash_hash) (kv_in), &i))
+    {
+      *kv_out = h->slots[i];
+      return 0;
+    }
+  return -1;
+}
+
+/** Look up KV in place, updating its value from the table. */
+static_always_inline int
+OAV (clib_oahash_search_inline) (OAVT (clib_oahash) * h,
+				 OAVT (clib_oahash_kv) * kv)
+{
+  return OAV (clib_oahash_search) (h, kv, kv);
+}
+
+static inline void
+OAV (clib_oahash_init) (OAVT (clib_oahash) * h, char *name, u32 n_elts)
+{
+  clib_memset (h, 0, sizeof (*h));
+  h->name = name;
+  h->ctrl = oahash_empty_ctrl;
+  h->n_slots = OAHASH_GROUP_SIZE;
+
+  if (n_elts)
+    {
+      /* keep the load factor below 7/8 */
+      u32 n = clib_max (max_pow2 (n_elts + n_elts / 7 + 1),
+			OAHASH_GROUP_SIZE);
+      h->n_slots = n;
+      h->ctrl = clib_mem_alloc_aligned (n + OAHASH_GROUP_SIZE,
+					CLIB_CACHE_LINE_BYTES);
+      clib_memset (h->ctrl, OAHASH_CTRL_EMPTY, n + OAHASH_GROUP_SIZE);
+      h->slots = clib_mem_alloc_aligned (n * sizeof (h->slots[0]),
+					 CLIB_CACHE_LINE_BYTES);
+    }
+}
+
+static inline void
+OAV (clib_oahash_free) (OAVT (clib_oahash) * h)
+{
+  if (h->slots)
+    {
+      clib_mem_free (h->ctrl);
+      clib_mem_free (h->slots);
+    }
+  OAV (clib_oahash_init) (h, h->name, 0);
+}
+
+static inline u32
+OAV (clib_oahash_elts) (OAVT (clib_oahash) * h)
+{
+  return h->n_elts;
+}
+
+/* place kv, known not to be in the table, in the first free slot of its
+   probe sequence */
+static_always_inline void
+OAV (clib_oahash_insert) (OAVT (clib_oahash) * h, OAVT (clib_oahash_kv) * kv,
+			  u64 hash)
+{
+  u32 mask = h->n_slots - 1;
+  u32 pos = (hash >> 7) & mask;
+  u32 m, i;
+
+  for (u32 step = OAHASH_GROUP_SIZE;
+       (m = oahash_group_match_free (h->ctrl + pos)) == 0;
+       step += OAHASH_GROUP_SIZE)
+    pos = (pos + step) & mask;
+
+  i = (pos + count_trailing_zeros (m)) & mask;
+  if (h->ctrl[i] == OAHASH_CTRL_DELETED)
+    h->n_deleted--;
+  OAV (clib_oahash_set_ctrl) (h, i, hash & 0x7f);
+  h->slots[i] = *kv;
+  h->n_elts++;
+}
+
+static inline void
+OAV (clib_oahash_resize) (OAVT (clib_oahash) * h, u32 n_slots)
+{
+  OAVT (clib_oahash) old = *h;
+
+  h->n_slots = n_slots;
+  h->n_elts = h->n_deleted = 0;
+  h->ctrl = clib_mem_alloc_aligned (n_slots + OAHASH_GROUP_SIZE,
+				    CLIB_CACHE_LINE_BYTES);
+  clib_memset (h->ctrl, OAHASH_CTRL_EMPTY, n_slots + OAHASH_GROUP_SIZE);
+  h->slots = clib_mem_alloc_aligned (n_slots * sizeof (h->slots[0]),
+				     CLIB_CACHE_LINE_BYTES);
+
+  if (old.slots == 0)
+    return;
+
+  for (u32 i = 0; i < old.n_slots; i++)
+    if ((old.ctrl[i] & 0x80) == 0)
+      OAV (clib_oahash_insert) (h, old.slots + i,
+				OAV (clib_oahash_hash) (old.slots + i));
+
+  clib_mem_free (old.ctrl);
+  clib_mem_free (old.slots);
+}
+
+/** Add (IS_ADD != 0) or delete the key / value pair KV. Adding an
+    existing key replaces its value. Returns -1 when deleting a key which
+    is not in the table, 0 otherwise. */
+static inline int
+OAV (clib_oahash_add_del) (OAVT (clib_oahash) * h,
+			   OAVT (clib_oahash_kv) * kv, int is_add)
+{
+  u64 hash = OAV (clib_oahash_hash) (kv);
+  u32 i;
+
+  if (OAV (clib_oahash_find) (h, kv, hash, &i))
+    {
+      if (is_add)
+	h->slots[i] = *kv;
+      else
+	{
+	  OAV (clib_oahash_set_ctrl) (h, i, OAHASH_CTRL_DELETED);
+	  h->n_elts--;
+	  h->n_deleted++;
+	}
+      return 0;
+    }
+
+  if (!is_add)
+    return -1;
+
+  /* keep at least 1/8 of the slots empty so every probe terminates;
+     grow if the table is really full, rehash in place if it is mostly
+     deleted entries */
+  if (h->slots == 0 || (h->n_elts + h->n_deleted + 1) * 8 > h->n_slots * 7)
+    {
+      u32 n = h->n_slots;
+      if (h->slots == 0)
+	;
+      else if ((h->n_elts + 1) * 16 > h->n_slots * 7)
+	n *= 2;
+      OAV (clib_oahash_resize) (h, n);
+    }
+
+  OAV (clib_oahash_insert) (h, kv, hash);
+  return 0;
+}
+
+static inline u8 *
+OAV (format_clib_oahash) (u8 *s, va_list *args)
+{
+  OAVT (clib_oahash) *h = va_arg (*args, OAVT (clib_oahash) *);
+  int verbose = va_arg (*args, int);
+  u32 indent = format_get_indent (s);
+  OAVT (clib_oahash_kv) * kv;
+
+  s = format (s, "%s: %u elts, %u slots, %u deleted, %U",
+	      h->name ? h->name : "oahash", h->n_elts,
+	      h->slots ? h->n_slots : 0, h->n_deleted, format_memory_size,
+	      h->slots ? (uword) h->n_slots * (sizeof (h->slots[0]) + 1) : 0);
+
+  if (verbose)
+    oahash_foreach_kv (kv, h)
+      s = format (s, "\n%U%U", format_white_space, indent + 2,
+		  OAV (format_clib_oahash_kvp), kv);
+
+  return s;
+}
@@ -345,7 +345,12 @@ pmalloc_map_pages (clib_pmalloc_main_t * pm, clib_pmalloc_arena_t * a,
       goto error;
     }
 
-  clib_memset (va, 0, size);
+  /* fresh mappings are zeroed by the kernel and mlock has already faulted
+     in hugepages, fault in small pages with one store each while the numa
+     mempolicy is still set, rather than clearing the whole range */
+  if (a->log2_subpage_sz == clib_mem_get_log2_page_size ())
+    for (uword off = 0; off < size; off += 1ULL << a->log2_subpage_sz)
+      *(volatile u8 *) ((u8 *) va + off) = 0;
 
   rv = clib_mem_set_default_numa_affinity ();
   if (rv == CLIB_MEM_ERROR && numa_node != 0)
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/segvec.h>
+#include <vppinfra/error.h>
+
+#define CLIB_SEGVEC_DIR_SIZE (1 << CLIB_SEGVEC_LOG2_DIR_SIZE)
+
+__clib_export void
+clib_segvec_init (clib_segvec_t *sv, u32 elt_size, u32 log2_chunk_elts,
+		  u32 align)
+{
+  ASSERT (log2_chunk_elts < 32);
+
+  clib_memset (sv, 0, sizeof (clib_segvec_t));
+  sv->elt_size = elt_size;
+  sv->log2_chunk_elts = log2_chunk_elts;
+  sv->align = clib_max (align, CLIB_CACHE_LINE_BYTES);
+  sv->dir = clib_mem_alloc (CLIB_SEGVEC_DIR_SIZE * sizeof (sv->dir[0]));
+  clib_memset (sv->dir, 0, CLIB_SEGVEC_DIR_SIZE * sizeof (sv->dir[0]));
+}
+
+__clib_export void
+clib_segvec_free (clib_segvec_t *sv)
+{
+  for (u32 c = 0; c < sv->n_chunks; c++)
+    clib_mem_free (sv->dir[c >> CLIB_SEGVEC_LOG2_DIR_SIZE]
+			  [c & pow2_mask (CLIB_SEGVEC_LOG2_DIR_SIZE)]);
+  for (u32 i = 0; i < CLIB_SEGVEC_DIR_SIZE; i++)
+    if (sv->dir[i])
+      clib_mem_free (sv->dir[i]);
+  clib_mem_free (sv->dir);
+  clib_memset (sv, 0, sizeof (clib_segvec_t));
+}
+
+__clib_export void
+clib_segvec_grow (clib_segvec_t *sv, u32 index)
+{
+  uword chunk_bytes = (uword) sv->elt_size << sv->log2_chunk_elts;
+  u32 n_chunks = (index >> sv->log2_chunk_elts) + 1;
+
+  /* the directory holds up to 2^(2 * CLIB_SEGVEC_LOG2_DIR_SIZE) chunks */
+  if (n_chunks > CLIB_SEGVEC_DIR_SIZE * CLIB_SEGVEC_DIR_SIZE)
+    clib_panic ("segmented vector index %u out of range", index);
+
+  while (sv->n_chunks < n_chunks)
+    {
+      u32 c = sv->n_chunks;
+      u8 ***l1 = sv->dir + (c >> CLIB_SEGVEC_LOG2_DIR_SIZE);
+      u8 *chunk;
+
+      if (l1[0] == 0)
+	{
+	  u8 **l2 = clib_mem_alloc (CLIB_SEGVEC_DIR_SIZE * sizeof (l2[0]));
+	  clib_memset (l2, 0, CLIB_SEGVEC_DIR_SIZE * sizeof (l2[0]));
+	  __atomic_store_n (l1, l2, __ATOMIC_RELEASE);
+	}
+
+      chunk = clib_mem_alloc_aligned (chunk_bytes, sv->align);
+      clib_memset (chunk, 0, chunk_bytes);
+      __atomic_store_n (l1[0] + (c & pow2_mask (CLIB_SEGVEC_LOG2_DIR_SIZE)),
+			chunk, __ATOMIC_RELEASE);
+      sv->n_chunks++;
+    }
+
+  /* readers check the length before looking up the directory */
+  __atomic_store_n (&sv->len, index + 1, __ATOMIC_RELEASE);
+}
+
+__clib_export void
+clib_segpool_init (clib_segpool_t *sp, u32 elt_size, u32 log2_chunk_elts,
+		   u32 align)
+{
+  clib_memset (sp, 0, sizeof (clib_segpool_t));
+  clib_segvec_init (&sp->elts, elt_size, log2_chunk_elts, align);
+  clib_segvec_init (&sp->busy, sizeof (uword), 6, 0);
+}
+
+__clib_export void
+clib_segpool_free (clib_segpool_t *sp)
+{
+  clib_segvec_free (&sp->elts);
+  clib_segvec_free (&sp->busy);
+  vec_free (sp->free_indices);
+  sp->n_elts = 0;
+}
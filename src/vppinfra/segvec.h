@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * Segmented vectors and pools.
+ *
+ * A segmented vector stores its elements in chunks of 2^log2_chunk_elts
+ * elements, found through a two-level directory of chunk pointers. It
+ * grows a chunk at a time and never moves an element, so other threads
+ * may keep using element pointers, and looking up indices, while one
+ * thread grows it. Lookup is two dependent loads more than a vec.
+ *
+ * A segmented pool adds pool semantics on top: a free index list, only
+ * touched by the thread which gets and puts elements, and a busy bitmap
+ * kept in a second segmented vector, so clib_segpool_is_free_index is
+ * safe to call from any thread while the pool grows.
+ */
+
+#ifndef included_clib_segvec_h
+#define included_clib_segvec_h
+
+#include <vppinfra/clib.h>
+#include <vppinfra/mem.h>
+#include <vppinfra/vec.h>
+
+/* each directory level has 2^CLIB_SEGVEC_LOG2_DIR_SIZE entries */
+#define CLIB_SEGVEC_LOG2_DIR_SIZE 10
+
+typedef struct
+{
+  /* top level directory, allocated at init and never moved */
+  u8 ***dir;
+  u32 len;
+  u32 n_chunks;
+  u32 elt_size;
+  u32 align;
+  u8 log2_chunk_elts;
+} clib_segvec_t;
+
+void clib_segvec_init (clib_segvec_t *sv, u32 elt_size, u32 log2_chunk_elts,
+		       u32 align);
+void clib_segvec_free (clib_segvec_t *sv);
+void clib_segvec_grow (clib_segvec_t *sv, u32 index);
+
+static_always_inline u32
+clib_segvec_len (clib_segvec_t *sv)
+{
+  return __atomic_load_n (&sv->len, __ATOMIC_ACQUIRE);
+}
+
+static_always_inline void *
+clib_segvec_elt_at_index (clib_segvec_t *sv, u32 index)
+{
+  u32 chunk = index >> sv->log2_chunk_elts;
+  u32 offset = index & pow2_mask (sv->log2_chunk_elts);
+  u8 **l2;
+
+  ASSERT (index < clib_segvec_len (sv));
+  l2 = sv->dir[chunk >> CLIB_SEGVEC_LOG2_DIR_SIZE];
+  return l2[chunk & pow2_mask (CLIB_SEGVEC_LOG2_DIR_SIZE)] +
+	 (uword) offset * sv->elt_size;
+}
+
+/** Make INDEX a valid index. New elements are zeroed, existing ones do
+    not move. Only one thread may grow a given vector at a time. */
+static_always_inline void
+clib_segvec_validate (clib_segvec_t *sv, u32 index)
+{
+  if (PREDICT_FALSE (index >= sv->len))
+    clib_segvec_grow (sv, index);
+}
+
+typedef struct
+{
+  clib_segvec_t elts;
+  /* bit set for each element in use, in uwords */
+  clib_segvec_t busy;
+  /* free indices, only used by the thread which gets and puts */
+  u32 *free_indices;
+  u32 n_elts;
+} clib_segpool_t;
+
+void clib_segpool_init (clib_segpool_t *sp, u32 elt_size,
+			u32 log2_chunk_elts, u32 align);
+void clib_segpool_free (clib_segpool_t *sp);
+
+static_always_inline u32
+clib_segpool_len (clib_segpool_t *sp)
+{
+  return clib_segvec_len (&sp->elts);
+}
+
+static_always_inline u32
+clib_segpool_elts (clib_segpool_t *sp)
+{
+  return sp->n_elts;
+}
+
+static_always_inline uword *
+clib_segpool_busy_word (clib_segpool_t *sp, u32 index)
+{
+  return clib_segvec_elt_at_index (&sp->busy, index / uword_bits);
+}
+
+static_always_inline int
+clib_segpool_is_free_index (clib_segpool_t *sp, u32 index)
+{
+  if (index >= clib_segpool_len (sp))
+    return 1;
+  return (__atomic_load_n (clib_segpool_busy_word (sp, index),
+			   __ATOMIC_RELAXED) &
+	  (1ULL << (index % uword_bits))) == 0;
+}
+
+static_always_inline void *
+clib_segpool_elt_at_index (clib_segpool_t *sp, u32 index)
+{
+  ASSERT (!clib_segpool_is_free_index (sp, index));
+  return clib_segvec_elt_at_index (&sp->elts, index);
+}
+
+/** Get an element, the last one put back first like pool_get. Its contents
+    are whatever was left by the last user, or zero. */
+static_always_inline void *
+clib_segpool_get (clib_segpool_t *sp, u32 *index)
+{
+  u32 i, n_free = vec_len (sp->free_indices);
+
+  if (n_free)
+    {
+      i = sp->free_indices[n_free - 1];
+      vec_set_len (sp->free_indices, n_free - 1);
+    }
+  else
+    {
+      i = sp->elts.len;
+      clib_segvec_validate (&sp->busy, i / uword_bits);
+      clib_segvec_validate (&sp->elts, i);
+    }
+
+  __atomic_fetch_or (clib_segpool_busy_word (sp, i), 1ULL << (i % uword_bits),
+		     __ATOMIC_RELEASE);
+  sp->n_elts++;
+  *index = i;
+  return clib_segvec_elt_at_index (&sp->elts, i);
+}
+
+static_always_inline void
+clib_segpool_put_index (clib_segpool_t *sp, u32 index)
+{
+  ASSERT (!clib_segpool_is_free_index (sp, index));
+  __atomic_fetch_and (clib_segpool_busy_word (sp, index),
+		      ~(1ULL << (index % uword_bits)), __ATOMIC_RELEASE);
+  vec_add1 (sp->free_indices, index);
+  sp->n_elts--;
+}
+
+/** First index in use at or after INDEX, or ~0 */
+static_always_inline u32
+clib_segpool_next_index (clib_segpool_t *sp, u32 index)
+{
+  u32 len = clib_segpool_len (sp);
+
+  while (index < len)
+    {
+      uword w = __atomic_load_n (clib_segpool_busy_word (sp, index),
+				 __ATOMIC_RELAXED);
+
+      w &= ~pow2_mask (index % uword_bits);
+      if (w)
+	{
+	  index = round_down_pow2 (index, uword_bits) +
+		  count_trailing_zeros (w);
+	  return index < len ? index : ~0;
+	}
+      index = round_pow2 (index + 1, uword_bits);
+    }
+
+  return ~0;
+}
+
+#define clib_segpool_foreach_index(i, sp)                                     \
+  for (i = clib_segpool_next_index ((sp), 0); i != ~0;                        \
+       i = clib_segpool_next_index ((sp), i + 1))
+
+#endif /* included_clib_segvec_h */
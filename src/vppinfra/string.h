@@ -87,6 +87,20 @@ clib_memcpy_fast (void *restrict dst, const void *restrict src, size_t n)
 #endif
 }
 
+/** Like clib_memcpy_fast, for copies which may be large, like fifo data or
+    jumbo frames. Picks rep movsb or non-temporal stores above size
+    thresholds where the CPU benefits from them. */
+static_always_inline void *
+clib_memcpy_large (void *restrict dst, const void *restrict src, size_t n)
+{
+#if defined(__SSE4_2__) && !defined(__COVERITY__)
+  ASSERT (dst && src);
+  return clib_memcpy_x86_64_large (dst, src, n);
+#else
+  return clib_memcpy_fast (dst, src, n);
+#endif
+}
+
 static_always_inline void *
 clib_memmove (void *dst, const void *src, size_t n)
 {
@@ -1174,4 +1174,144 @@ REGISTER_TEST (clib_aes256_gmac) = {
   .name = "clib_aes256_gmac",
   .fn = test_clib_aes256_gmac,
 };
+
+#if N_AES_LANES == 4
+void __test_perf_fn
+perftest_aes128_gcm_mb_enc (test_perf_t *tp)
+{
+  u32 i, n = tp->n_ops;
+  aes_gcm_key_data_t *kd = test_mem_alloc (sizeof (*kd));
+  u8 *dst = test_mem_alloc (n * 64);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (n * 64, 0, 0);
+  u8 *tag = test_mem_alloc (n * 16);
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *iv = test_mem_alloc_and_fill_inc_u8 (16, 128, 0);
+  aes_gcm_mb_op_t *ops = test_mem_alloc (n * sizeof (ops[0]));
+
+  clib_aes_gcm_key_expand (kd, key, AES_KEY_128);
+  for (i = 0; i < n; i++)
+    ops[i] = (aes_gcm_mb_op_t){ .src = src + i * 64,
+				.dst = dst + i * 64,
+				.iv = iv,
+				.tag = tag + i * 16,
+				.kd = kd,
+				.data_bytes = 64,
+				.tag_len = 16 };
+
+  test_perf_event_enable (tp);
+  for (i = 0; i < n; i += AES_GCM_MB_N_LANES)
+    aes_gcm_mb (ops + i, AES_GCM_MB_N_LANES, AES_KEY_ROUNDS (AES_KEY_128),
+		AES_GCM_OP_ENCRYPT);
+  test_perf_event_disable (tp);
+}
+
+static clib_error_t *
+test_clib_aes_gcm_mb (clib_error_t *err)
+{
+  aes_gcm_key_data_t kd[AES_GCM_MB_N_LANES];
+  aes_gcm_mb_op_t ops[AES_GCM_MB_N_LANES];
+  u8 pt[AES_GCM_MB_N_LANES][AES_GCM_MB_MAX_DATA_BYTES];
+  u8 ct[AES_GCM_MB_N_LANES][AES_GCM_MB_MAX_DATA_BYTES];
+  u8 ct1[AES_GCM_MB_MAX_DATA_BYTES];
+  u8 tag[AES_GCM_MB_N_LANES][16], tag1[16];
+  u32 i, l, ok;
+
+  /* spec test cases, with short aad, in every lane */
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    {
+      clib_aes_gcm_key_expand (kd + l, l & 1 ? tc3_key128 : tc1_key128,
+			       AES_KEY_128);
+      ops[l] = (aes_gcm_mb_op_t){
+	.src = l & 1 ? tc3_plaintext : tc2_plaintext,
+	.dst = ct[l],
+	.iv = l & 1 ? tc3_iv : tc1_iv,
+	.tag = tag[l],
+	.kd = kd + l,
+	.data_bytes = l & 1 ? sizeof (tc3_plaintext) : sizeof (tc2_plaintext),
+	.tag_len = 16,
+      };
+    }
+
+  ok = aes_gcm_mb (ops, AES_GCM_MB_N_LANES, AES_KEY_ROUNDS (AES_KEY_128),
+		   AES_GCM_OP_ENCRYPT);
+  if (ok != 0xf)
+    return clib_error_return (err, "encrypt: unexpected status 0x%x", ok);
+
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    {
+      if (memcmp (l & 1 ? tc3_ciphertext128 : tc2_ciphertext128, ct[l],
+		  ops[l].data_bytes))
+	return clib_error_return (err, "lane %u: invalid ciphertext", l);
+      if (memcmp (l & 1 ? tc3_tag128 : tc2_tag128, tag[l], 16))
+	return clib_error_return (err, "lane %u: invalid tag", l);
+    }
+
+  /* decrypt back, with a bad tag on lane 2 */
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    {
+      ops[l].src = ct[l];
+      ops[l].dst = pt[l];
+    }
+  tag[2][0] ^= 1;
+
+  ok = aes_gcm_mb (ops, AES_GCM_MB_N_LANES, AES_KEY_ROUNDS (AES_KEY_128),
+		   AES_GCM_OP_DECRYPT);
+  if (ok != 0xb)
+    return clib_error_return (err, "decrypt: unexpected status 0x%x", ok);
+
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    if (memcmp (l & 1 ? tc3_plaintext : tc2_plaintext, pt[l],
+		ops[l].data_bytes))
+      return clib_error_return (err, "lane %u: invalid plaintext", l);
+
+  /* all sizes against the single buffer code, lanes of different sizes */
+  for (i = 0; i < sizeof (pt[0]); i++)
+    pt[0][i] = i;
+
+  for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+    clib_aes_gcm_key_expand (kd + l, l & 1 ? tc3_key256 : tc1_key256,
+			     AES_KEY_256);
+
+  for (i = 1; i <= AES_GCM_MB_MAX_DATA_BYTES; i++)
+    {
+      for (l = 0; l < AES_GCM_MB_N_LANES; l++)
+	ops[l] = (aes_gcm_mb_op_t){
+	  .src = pt[0],
+	  .dst = ct[l],
+	  .aad = pt[0] + l,
+	  .iv = inc_iv,
+	  .tag = tag[l],
+	  .kd = kd + l,
+	  .data_bytes = (i + l * 67) % AES_GCM_MB_MAX_DATA_BYTES + 1,
+	  .aad_bytes = (i + l) % (AES_GCM_MB_MAX_AAD_BYTES + 1),
+	  .tag_len = l == 3 ? 12 : 16,
+	};
+
+      ok = aes_gcm_mb (ops, 1 + i % AES_GCM_MB_N_LANES,
+		       AES_KEY_ROUNDS (AES_KEY_256), AES_GCM_OP_ENCRYPT);
+
+      for (l = 0; l < 1 + i % AES_GCM_MB_N_LANES; l++)
+	{
+	  clib_aes256_gcm_enc (kd + l, ops[l].src, ops[l].data_bytes,
+			       ops[l].aad, ops[l].aad_bytes, ops[l].iv,
+			       ops[l].tag_len, ct1, tag1);
+	  if (!(ok & (1 << l)) ||
+	      memcmp (ct1, ct[l], ops[l].data_bytes) ||
+	      memcmp (tag1, tag[l], ops[l].tag_len))
+	    return clib_error_return (err, "lane %u, %u bytes: mismatch", l,
+				      ops[l].data_bytes);
+	}
+    }
+
+  return err;
+}
+
+REGISTER_TEST (clib_aes_gcm_mb) = {
+  .name = "clib_aes_gcm_mb",
+  .fn = test_clib_aes_gcm_mb,
+  .perf_tests = PERF_TESTS ({ .name = "aes128 64 byte ops",
+			      .n_ops = 256,
+			      .fn = perftest_aes128_gcm_mb_enc }),
+};
+#endif
 #endif
@@ -0,0 +1,227 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#include <vppinfra/format.h>
+#include <vppinfra/test/test.h>
+#include <vppinfra/crypto/chacha20.h>
+
+/* RFC8439 2.8.2 */
+static const u8 tc1_key[32] = {
+  0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b,
+  0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+  0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+
+static const u8 tc1_nonce[12] = {
+  0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+
+static const u8 tc1_aad[12] = {
+  0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7
+};
+
+static const u8 tc1_pt[114] = {
+  0x4c, 0x61, 0x64, 0x69, 0x65, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x47,
+  0x65, 0x6e, 0x74, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x20, 0x6f, 0x66, 0x20,
+  0x74, 0x68, 0x65, 0x20, 0x63, 0x6c, 0x61, 0x73, 0x73, 0x20, 0x6f, 0x66,
+  0x20, 0x27, 0x39, 0x39, 0x3a, 0x20, 0x49, 0x66, 0x20, 0x49, 0x20, 0x63,
+  0x6f, 0x75, 0x6c, 0x64, 0x20, 0x6f, 0x66, 0x66, 0x65, 0x72, 0x20, 0x79,
+  0x6f, 0x75, 0x20, 0x6f, 0x6e, 0x6c, 0x79, 0x20, 0x6f, 0x6e, 0x65, 0x20,
+  0x74, 0x69, 0x70, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20,
+  0x66, 0x75, 0x74, 0x75, 0x72, 0x65, 0x2c, 0x20, 0x73, 0x75, 0x6e, 0x73,
+  0x63, 0x72, 0x65, 0x65, 0x6e, 0x20, 0x77, 0x6f, 0x75, 0x6c, 0x64, 0x20,
+  0x62, 0x65, 0x20, 0x69, 0x74, 0x2e
+};
+
+static const u8 tc1_ct[114] = {
+  0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc,
+  0x53, 0xef, 0x7e, 0xc2, 0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+  0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6, 0x3d, 0xbe, 0xa4, 0x5e,
+  0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+  0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6,
+  0x7e, 0xcd, 0x3b, 0x36, 0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+  0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58, 0xfa, 0xb3, 0x24, 0xe4,
+  0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+  0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65,
+  0x86, 0xce, 0xc6, 0x4b, 0x61, 0x16
+};
+
+static const u8 tc1_tag[16] = {
+  0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb,
+  0xd0, 0x60, 0x06, 0x91
+};
+
+static clib_error_t *
+test_clib_chacha20_poly1305 (clib_error_t *err)
+{
+  u8 data[sizeof (tc1_pt)], tag[16];
+
+  clib_chacha20_poly1305 (tc1_key, tc1_nonce, tc1_aad, sizeof (tc1_aad),
+			  tc1_pt, data, sizeof (tc1_pt), tag,
+			  CHACHA20_POLY1305_OP_ENCRYPT);
+  if (memcmp (data, tc1_ct, sizeof (tc1_ct)))
+    err = clib_error_return (err, "encrypt: ciphertext mismatch\n%U",
+			     format_hexdump, data, sizeof (data));
+  if (memcmp (tag, tc1_tag, sizeof (tc1_tag)))
+    err = clib_error_return (err, "encrypt: tag mismatch %U", format_hexdump,
+			     tag, sizeof (tag));
+
+  if (!clib_chacha20_poly1305 (tc1_key, tc1_nonce, tc1_aad, sizeof (tc1_aad),
+			       tc1_ct, data, sizeof (tc1_ct), (u8 *) tc1_tag,
+			       CHACHA20_POLY1305_OP_DECRYPT))
+    err = clib_error_return (err, "decrypt: tag check failed");
+  if (memcmp (data, tc1_pt, sizeof (tc1_pt)))
+    err = clib_error_return (err, "decrypt: plaintext mismatch\n%U",
+			     format_hexdump, data, sizeof (data));
+
+  clib_memcpy_fast (tag, tc1_tag, sizeof (tag));
+  tag[15] ^= 1;
+  if (clib_chacha20_poly1305 (tc1_key, tc1_nonce, tc1_aad, sizeof (tc1_aad),
+			      tc1_ct, data, sizeof (tc1_ct), tag,
+			      CHACHA20_POLY1305_OP_DECRYPT))
+    err = clib_error_return (err, "decrypt: bad tag accepted");
+
+  return err;
+}
+
+REGISTER_TEST (clib_chacha20_poly1305) = {
+  .name = "clib_chacha20_poly1305",
+  .fn = test_clib_chacha20_poly1305,
+};
+
+/* ops of every size that fits replay the single op results */
+static clib_error_t *
+test_clib_chacha20_poly1305_mb (clib_error_t *err)
+{
+  const u32 max_bytes = (CHACHA20_MAX_BLOCKS / 2 - 1) * CHACHA20_BLOCK_BYTES;
+  chacha20_poly1305_mb_op_t ops[2];
+  u8 pt[1024], ct[2][1024], ref[1024], tag[2][16], ref_tag[16];
+  u32 ok;
+
+  for (int i = 0; i < sizeof (pt); i++)
+    pt[i] = i;
+
+  for (u32 len = 1; len <= max_bytes; len++)
+    {
+      for (int i = 0; i < 2; i++)
+	ops[i] = (chacha20_poly1305_mb_op_t){
+	  .key = tc1_key,
+	  .nonce = tc1_nonce,
+	  .aad = tc1_aad,
+	  .src = pt + i,
+	  .dst = ct[i],
+	  .tag = tag[i],
+	  .data_bytes = len,
+	  .aad_bytes = i ? 8 : 12,
+	};
+
+      ok = chacha20_poly1305_mb (ops, 2, CHACHA20_POLY1305_OP_ENCRYPT);
+      if (ok != 3)
+	return clib_error_return (err, "len %u: encrypt returned 0x%x", len,
+				  ok);
+
+      for (int i = 0; i < 2; i++)
+	{
+	  clib_chacha20_poly1305 (tc1_key, tc1_nonce, tc1_aad, i ? 8 : 12,
+				  pt + i, ref, len, ref_tag,
+				  CHACHA20_POLY1305_OP_ENCRYPT);
+	  if (memcmp (ct[i], ref, len) || memcmp (tag[i], ref_tag, 16))
+	    return clib_error_return (err, "len %u op %u: mismatch", len, i);
+	}
+
+      /* decrypt in place, with a bad tag on the second op */
+      tag[1][0] ^= 1;
+      for (int i = 0; i < 2; i++)
+	{
+	  ops[i].src = ct[i];
+	  ops[i].dst = ct[i];
+	}
+      ok = chacha20_poly1305_mb (ops, 2, CHACHA20_POLY1305_OP_DECRYPT);
+      if (ok != 1)
+	return clib_error_return (err, "len %u: decrypt returned 0x%x", len,
+				  ok);
+      if (memcmp (ct[0], pt, len))
+	return clib_error_return (err, "len %u: decrypt mismatch", len);
+    }
+
+  return err;
+}
+
+void __test_perf_fn
+perftest_1500byte (test_perf_t *tp)
+{
+  u32 n = tp->n_ops;
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *nonce = test_mem_alloc_and_fill_inc_u8 (12, 0, 0);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (1500 * n, 0, 0);
+  u8 *dst = test_mem_alloc (1500 * n);
+  u8 *tag = test_mem_alloc (16 * n);
+
+  test_perf_event_enable (tp);
+  for (int i = 0; i < n; i++)
+    clib_chacha20_poly1305 (key, nonce, 0, 0, src + i * 1500, dst + i * 1500,
+			    1500, tag + i * 16, CHACHA20_POLY1305_OP_ENCRYPT);
+  test_perf_event_disable (tp);
+}
+
+void __test_perf_fn
+perftest_64byte (test_perf_t *tp)
+{
+  u32 n = tp->n_ops;
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *nonce = test_mem_alloc_and_fill_inc_u8 (12, 0, 0);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (64 * n, 0, 0);
+  u8 *dst = test_mem_alloc (64 * n);
+  u8 *tag = test_mem_alloc (16 * n);
+
+  test_perf_event_enable (tp);
+  for (int i = 0; i < n; i++)
+    clib_chacha20_poly1305 (key, nonce, 0, 0, src + i * 64, dst + i * 64, 64,
+			    tag + i * 16, CHACHA20_POLY1305_OP_ENCRYPT);
+  test_perf_event_disable (tp);
+}
+
+void __test_perf_fn
+perftest_64byte_mb (test_perf_t *tp)
+{
+  const u32 n_lanes = CHACHA20_MAX_BLOCKS / 2;
+  u32 n = tp->n_ops;
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *nonce = test_mem_alloc_and_fill_inc_u8 (12, 0, 0);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (64 * n, 0, 0);
+  u8 *dst = test_mem_alloc (64 * n);
+  u8 *tag = test_mem_alloc (16 * n);
+  chacha20_poly1305_mb_op_t ops[CHACHA20_MAX_BLOCKS / 2];
+
+  for (int i = 0; i < n_lanes; i++)
+    ops[i] = (chacha20_poly1305_mb_op_t){
+      .key = key,
+      .nonce = nonce,
+      .data_bytes = 64,
+    };
+
+  test_perf_event_enable (tp);
+  for (int i = 0; i < n; i += n_lanes)
+    {
+      for (int j = 0; j < n_lanes; j++)
+	{
+	  ops[j].src = src + (i + j) * 64;
+	  ops[j].dst = dst + (i + j) * 64;
+	  ops[j].tag = tag + (i + j) * 16;
+	}
+      chacha20_poly1305_mb (ops, n_lanes, CHACHA20_POLY1305_OP_ENCRYPT);
+    }
+  test_perf_event_disable (tp);
+}
+
+REGISTER_TEST (clib_chacha20_poly1305_mb) = {
+  .name = "clib_chacha20_poly1305_mb",
+  .fn = test_clib_chacha20_poly1305_mb,
+  .perf_tests = PERF_TESTS (
+    { .name = "1500 byte ops", .n_ops = 512, .fn = perftest_1500byte },
+    { .name = "64 byte ops", .n_ops = 1024, .fn = perftest_64byte },
+    { .name = "64 byte ops, multi-buffer",
+      .n_ops = 1024,
+      .fn = perftest_64byte_mb }),
+};
@@ -67,7 +67,7 @@ static counst_test_t const_tests[] = {
 #define MAX_LEN 1024
 
 static clib_error_t *
-validate_one (clib_error_t *err, u8 *d, u8 *s, u16 n, u8 off, int is_const)
+validate_one (clib_error_t *err, u8 *d, u8 *s, u32 n, u8 off, int is_const)
 {
   for (int i = 0; i < n; i++)
     if (d[i] != s[i])
@@ -139,4 +139,82 @@ REGISTER_TEST (clib_memcpy_x86_64) = {
   .name = "clib_memcpy_x86_64",
   .fn = test_clib_memcpy_x86_64,
 };
+
+static clib_error_t *
+test_clib_memcpy_x86_64_large (clib_error_t *err)
+{
+  clib_memcpy_large_config_t *c = &clib_memcpy_large_config, saved = *c;
+  u32 sizes[] = { 1, 63, 64, 65, 4095, 4096, 65536 + 17, 1 << 20 };
+  u8 *src = test_mem_alloc_and_fill_inc_u8 ((1 << 20) + 64, 0, 0x7f);
+  u8 *dst = test_mem_alloc ((1 << 20) + 192);
+
+  /* force each path in turn: vector loop, rep movsb, non-temporal */
+  for (int path = 0; path < 3; path++)
+    {
+      c->nt_threshold = path == 2 ? 0 : ~0;
+      c->rep_movsb_threshold = path == 1 ? 0 : ~0;
+
+      for (int j = 0; j < ARRAY_LEN (sizes); j++)
+	for (int off = 0; off < 64; off += 13)
+	  {
+	    u32 n = sizes[j];
+	    u8 *d = dst + 64 + off;
+
+	    clib_memset (dst, 0xfe, 128 + n + off);
+	    clib_memcpy_x86_64_large (d, src + 5, n);
+	    if ((err = validate_one (err, d, src + 5, n, off, 0)))
+	      goto done;
+	  }
+    }
+
+done:
+  *c = saved;
+  return err;
+}
+
+void __test_perf_fn
+perftest_vector_loop (test_perf_t *tp)
+{
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (tp->n_ops, 0, 0);
+  u8 *dst = test_mem_alloc (tp->n_ops);
+
+  clib_memset (dst, 0, tp->n_ops);
+  test_perf_event_enable (tp);
+  clib_memcpy_x86_64 (dst, src, tp->n_ops);
+  test_perf_event_disable (tp);
+}
+
+void __test_perf_fn
+perftest_large (test_perf_t *tp)
+{
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (tp->n_ops, 0, 0);
+  u8 *dst = test_mem_alloc (tp->n_ops);
+
+  clib_memset (dst, 0, tp->n_ops);
+  test_perf_event_enable (tp);
+  clib_memcpy_x86_64_large (dst, src, tp->n_ops);
+  test_perf_event_disable (tp);
+}
+
+REGISTER_TEST (clib_memcpy_x86_64_large) = {
+  .name = "clib_memcpy_x86_64_large",
+  .fn = test_clib_memcpy_x86_64_large,
+  .perf_tests = PERF_TESTS (
+    { .name = "vector loop, 4K (per byte)",
+      .n_ops = 4 << 10,
+      .fn = perftest_vector_loop },
+    { .name = "large, 4K (per byte)", .n_ops = 4 << 10, .fn = perftest_large },
+    { .name = "vector loop, 64K (per byte)",
+      .n_ops = 64 << 10,
+      .fn = perftest_vector_loop },
+    { .name = "large, 64K (per byte)",
+      .n_ops = 64 << 10,
+      .fn = perftest_large },
+    { .name = "vector loop, 16M (per byte)",
+      .n_ops = 16 << 20,
+      .fn = perftest_vector_loop },
+    { .name = "large, 16M (per byte)",
+      .n_ops = 16 << 20,
+      .fn = perftest_large }),
+};
 #endif
@@ -525,6 +525,175 @@ test_bihash (test_main_t * tm)
   return 0;
 }
 
+static clib_error_t *
+test_bihash_compact (test_main_t *tm)
+{
+  BVT (clib_bihash) * h;
+  BVT (clib_bihash_kv) kv;
+  uword freed = 0;
+  u32 i, n_passes = 0;
+
+  h = &tm->hash;
+
+  BV (clib_bihash_init) (h, "test", tm->nbuckets, tm->hash_memory_size);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      kv.value = i + 1;
+      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */);
+    }
+
+  fformat (stdout, "After adds: %U\n", BV (format_bihash), h, 0);
+
+  /* keep one in 16 */
+  for (i = 0; i < tm->nitems; i++)
+    {
+      if ((i & 15) == 0)
+	continue;
+      kv.key = i;
+      if (BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */) < 0)
+	return clib_error_return (0, "delete key %lld not ok but should be",
+				  kv.key);
+    }
+
+  /* small budget, so a sweep takes several passes */
+  do
+    {
+      freed += BV (clib_bihash_compact) (h, 16);
+      n_passes++;
+    }
+  while (h->compact_next_bucket != 0);
+
+  fformat (stdout, "%u passes freed %U\n", n_passes, format_memory_size,
+	   freed);
+  fformat (stdout, "After compaction: %U\n", BV (format_bihash), h, 0);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      if (BV (clib_bihash_search) (h, &kv, &kv) < 0)
+	{
+	  if ((i & 15) == 0)
+	    return clib_error_return (0, "search for key %lld failed", kv.key);
+	  continue;
+	}
+      if ((i & 15) != 0)
+	return clib_error_return (0, "deleted key %lld found", kv.key);
+      if (kv.value != i + 1)
+	return clib_error_return (0, "key %lld value %lld", kv.key, kv.value);
+    }
+
+  /* the compacted table still grows */
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      kv.value = i + 1;
+      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */);
+    }
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      if (BV (clib_bihash_search) (h, &kv, &kv) < 0 || kv.value != i + 1)
+	return clib_error_return (0, "search for key %lld failed", kv.key);
+    }
+
+  BV (clib_bihash_free) (h);
+
+  return 0;
+}
+
+static clib_error_t *
+test_bihash_grow (test_main_t *tm)
+{
+  BVT (clib_bihash) * h;
+  BVT (clib_bihash_kv) kv;
+  clib_bihash_occupancy_t o;
+  u32 i, n_grows = 0, next_add, nbuckets;
+
+  h = &tm->hash;
+
+  BV (clib_bihash_init) (h, "test", tm->nbuckets, tm->hash_memory_size);
+
+  /* half the items first, the rest go in while the table grows */
+  next_add = tm->nitems / 2;
+  for (i = 0; i < next_add; i++)
+    {
+      kv.key = i;
+      kv.value = i + 1;
+      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */);
+    }
+
+  BV (clib_bihash_get_occupancy) (h, &o);
+  fformat (stdout, "Before: %U\n", format_clib_bihash_occupancy, &o);
+
+  while (clib_bihash_occupancy_wants_grow (&o))
+    {
+      nbuckets = h->nbuckets;
+      if (BV (clib_bihash_grow_start) (h) < 0)
+	return clib_error_return (0, "grow start failed");
+
+      while (BV (clib_bihash_grow_step) (h, 4) == 0)
+	{
+	  /* writes to migrated and not yet migrated buckets */
+	  if (next_add < tm->nitems)
+	    {
+	      kv.key = next_add;
+	      kv.value = next_add + 1;
+	      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */);
+	      next_add++;
+	    }
+	  kv.key = (next_add * 7919ULL) % next_add;
+	  if ((kv.key & 3) == 3)
+	    BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */);
+	}
+
+      BV (clib_bihash_grow_commit) (h);
+      if (h->nbuckets != 2 * nbuckets)
+	return clib_error_return (0, "%u buckets after growing from %u",
+				  h->nbuckets, nbuckets);
+
+      /* free what the previous bucket array used */
+      while (h->grow_old_buckets)
+	BV (clib_bihash_grow_step) (h, 4);
+
+      n_grows++;
+      BV (clib_bihash_get_occupancy) (h, &o);
+    }
+
+  for (; next_add < tm->nitems; next_add++)
+    {
+      kv.key = next_add;
+      kv.value = next_add + 1;
+      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */);
+    }
+
+  BV (clib_bihash_get_occupancy) (h, &o);
+  fformat (stdout, "After %u grows to %u buckets: %U\n", n_grows,
+	   h->nbuckets, format_clib_bihash_occupancy, &o);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key = i;
+      if (BV (clib_bihash_search) (h, &kv, &kv) < 0)
+	{
+	  /* deleted while growing? */
+	  if ((i & 3) == 3)
+	    continue;
+	  return clib_error_return (0, "search for key %lld failed", kv.key);
+	}
+      if (kv.value != i + 1)
+	return clib_error_return (0, "key %lld value %lld", kv.key, kv.value);
+    }
+
+  if (tm->verbose)
+    fformat (stdout, "%U", BV (format_bihash), h, 0);
+
+  BV (clib_bihash_free) (h);
+
+  return 0;
+}
+
 clib_error_t *
 test_bihash_main (test_main_t * tm)
 {
@@ -571,6 +740,10 @@ test_bihash_main (test_main_t * tm)
 	which = 4;
       else if (unformat (i, "value-assert"))
 	which = 5;
+      else if (unformat (i, "compact"))
+	which = 6;
+      else if (unformat (i, "grow"))
+	which = 7;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, i);
@@ -607,6 +780,14 @@ test_bihash_main (test_main_t * tm)
       error = test_bihash_value_assert (tm);
       break;
 
+    case 6:
+      error = test_bihash_compact (tm);
+      break;
+
+    case 7:
+      error = test_bihash_grow (tm);
+      break;
+
     default:
       return clib_error_return (0, "no such test?");
     }
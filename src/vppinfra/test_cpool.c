@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/cpool.h>
+#include <vppinfra/format.h>
+#include <vppinfra/error.h>
+#include <pthread.h>
+
+#define N_THREADS 4
+#define N_ELTS	  100000
+
+typedef struct
+{
+  u32 thread_index;
+  u32 value;
+} test_elt_t;
+
+typedef struct
+{
+  clib_cpool_t pool;
+  u32 *indices[N_THREADS];
+  u32 go;
+} cpool_test_main_t;
+
+static cpool_test_main_t cpool_test_main;
+
+typedef struct
+{
+  u32 thread_index;
+  int do_put;
+} cpool_test_thread_args_t;
+
+static void *
+cpool_test_thread (void *arg)
+{
+  cpool_test_main_t *tm = &cpool_test_main;
+  cpool_test_thread_args_t *a = arg;
+  u32 ti = a->thread_index;
+
+  while (!__atomic_load_n (&tm->go, __ATOMIC_ACQUIRE))
+    ;
+
+  if (a->do_put)
+    {
+      /* put back what the next thread got */
+      u32 *indices = tm->indices[(ti + 1) % N_THREADS];
+      for (u32 i = 0; i < vec_len (indices); i++)
+	clib_cpool_put_index (&tm->pool, ti, indices[i]);
+      return 0;
+    }
+
+  for (u32 i = 0; i < N_ELTS; i++)
+    {
+      u32 index;
+      test_elt_t *e = clib_cpool_get (&tm->pool, ti, &index);
+
+      if (e == 0)
+	clib_panic ("pool full after %u gets", i);
+      e->thread_index = ti;
+      e->value = i;
+      tm->indices[ti][i] = index;
+    }
+
+  return 0;
+}
+
+static int
+cpool_test_run (int do_put)
+{
+  cpool_test_main_t *tm = &cpool_test_main;
+  pthread_t threads[N_THREADS];
+  cpool_test_thread_args_t args[N_THREADS];
+
+  tm->go = 0;
+  for (u32 i = 0; i < N_THREADS; i++)
+    {
+      args[i].thread_index = i;
+      args[i].do_put = do_put;
+      if (pthread_create (threads + i, 0, cpool_test_thread, args + i))
+	return 1;
+    }
+
+  __atomic_store_n (&tm->go, 1, __ATOMIC_RELEASE);
+
+  for (u32 i = 0; i < N_THREADS; i++)
+    pthread_join (threads[i], 0);
+
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  cpool_test_main_t *tm = &cpool_test_main;
+  uword *seen = 0;
+  u32 index;
+
+  clib_mem_init (0, 1ULL << 30);
+
+  /* room for what the thread caches may hold on to */
+  clib_cpool_init (&tm->pool, sizeof (test_elt_t), 10,
+		   N_THREADS * (N_ELTS + CLIB_CPOOL_CACHE_SIZE), N_THREADS);
+
+  for (u32 i = 0; i < N_THREADS; i++)
+    vec_validate (tm->indices[i], N_ELTS - 1);
+
+  /* all threads get at once, growing the pool concurrently */
+  if (cpool_test_run (0))
+    clib_panic ("pthread_create failed");
+
+  fformat (stdout, "%U\n", format_clib_cpool, &tm->pool);
+
+  if (clib_cpool_elts (&tm->pool) != N_THREADS * N_ELTS)
+    clib_panic ("%lu elts in use, expected %u", clib_cpool_elts (&tm->pool),
+		N_THREADS * N_ELTS);
+
+  for (u32 t = 0; t < N_THREADS; t++)
+    for (u32 i = 0; i < N_ELTS; i++)
+      {
+	test_elt_t *e = clib_cpool_elt_at_index (&tm->pool, tm->indices[t][i]);
+
+	if (e->thread_index != t || e->value != i)
+	  clib_panic ("element %u of thread %u corrupt", i, t);
+	if (clib_bitmap_get (seen, tm->indices[t][i]))
+	  clib_panic ("index %u handed out twice", tm->indices[t][i]);
+	seen = clib_bitmap_set (seen, tm->indices[t][i], 1);
+      }
+
+  u32 n = 0;
+  clib_cpool_foreach_index (index, &tm->pool)
+    {
+      if (!clib_bitmap_get (seen, index))
+	clib_panic ("index %u busy but never handed out", index);
+      n++;
+    }
+  if (n != N_THREADS * N_ELTS)
+    clib_panic ("iterated over %u elts", n);
+
+  /* every thread puts back what another one got */
+  if (cpool_test_run (1))
+    clib_panic ("pthread_create failed");
+
+  fformat (stdout, "%U\n", format_clib_cpool, &tm->pool);
+
+  if (clib_cpool_elts (&tm->pool) != 0)
+    clib_panic ("%lu elts left in use", clib_cpool_elts (&tm->pool));
+
+  /* the pool is at its maximum size, everything comes from the caches
+     and the shared bitmap now */
+  if (cpool_test_run (0))
+    clib_panic ("pthread_create failed");
+
+  if (clib_cpool_elts (&tm->pool) != N_THREADS * N_ELTS)
+    clib_panic ("%lu elts in use after refill", clib_cpool_elts (&tm->pool));
+
+  fformat (stdout, "%U\n", format_clib_cpool, &tm->pool);
+
+  for (u32 i = 0; i < N_THREADS; i++)
+    vec_free (tm->indices[i]);
+  clib_bitmap_free (seen);
+  clib_cpool_free (&tm->pool);
+  return 0;
+}
@@ -52,6 +52,8 @@
 #include <vppinfra/error.h>
 #include <vppinfra/format.h>
 #include <vppinfra/bitmap.h>
+#include <vppinfra/time.h>
+#include <vppinfra/oahash_8_8.h>
 
 static int verbose;
 #define if_verbose(format,args...) \
@@ -75,6 +77,9 @@ typedef struct
   /* Verbosity level for hash formats. */
   int verbose;
 
+  /* Compare uword hash with the open addressing hash. */
+  int oahash;
+
   /* Random number seed. */
   u32 seed;
 } hash_test_t;
@@ -379,6 +384,111 @@ done:
   return error;
 }
 
+static clib_error_t *
+test_oahash (hash_test_t * ht)
+{
+  clib_oahash_8_8_t _oh, *oh = &_oh;
+  clib_oahash_kv_8_8_t kv, *kvp;
+  uword *h, *p, *is_inserted = 0;
+  u64 *keys = 0, sum = 0, n_found = 0;
+  f64 t0, t1, t2;
+  u32 i, j, n_lookups;
+  clib_time_t clib_time;
+
+  clib_time_init (&clib_time);
+  vec_resize (keys, ht->n_pairs);
+  for (i = 0; i < vec_len (keys); i++)
+    keys[i] = (u64) random_u32 (&ht->seed) << 32 | random_u32 (&ht->seed);
+
+  h = hash_create (0, sizeof (uword));
+  clib_oahash_init_8_8 (oh, "test", 0);
+
+  /* random adds and deletes, both tables must agree */
+  for (i = 0; i < ht->n_iterations; i++)
+    {
+      j = random_u32 (&ht->seed) % vec_len (keys);
+      kv.key = keys[j];
+      kv.value = j;
+      if (clib_bitmap_get (is_inserted, j))
+	{
+	  hash_unset (h, keys[j]);
+	  if (clib_oahash_add_del_8_8 (oh, &kv, 0 /* is_add */ ))
+	    return clib_error_return (0, "oahash delete key %llx failed",
+				      keys[j]);
+	}
+      else
+	{
+	  hash_set (h, keys[j], j);
+	  clib_oahash_add_del_8_8 (oh, &kv, 1 /* is_add */ );
+	}
+      is_inserted = clib_bitmap_xori (is_inserted, j);
+
+      if (hash_elts (h) != clib_oahash_elts_8_8 (oh))
+	return clib_error_return (0, "iter %u: %u elts in hash, %u in oahash",
+				  i, hash_elts (h), clib_oahash_elts_8_8 (oh));
+    }
+
+  for (i = 0; i < vec_len (keys); i++)
+    {
+      int in_hash, in_oahash;
+      kv.key = keys[i];
+      p = hash_get (h, keys[i]);
+      in_hash = p != 0;
+      in_oahash = clib_oahash_search_inline_8_8 (oh, &kv) == 0;
+      if (in_hash != in_oahash || (p && p[0] != kv.value))
+	return clib_error_return (0, "key %llx mismatch", keys[i]);
+    }
+
+  i = 0;
+  oahash_foreach_kv (kvp, oh)
+    {
+      if (kvp->key != keys[kvp->value])
+	return clib_error_return (0, "oahash walk found bad pair %U",
+				  format_clib_oahash_kvp_8_8, kvp);
+      i++;
+    }
+  if (i != hash_elts (h))
+    return clib_error_return (0, "oahash walk found %u of %u elts", i,
+			      hash_elts (h));
+
+  /* lookup benchmark, hits and misses */
+  n_lookups = clib_max (ht->n_iterations, 10 * vec_len (keys));
+  t0 = clib_time_now (&clib_time);
+  for (i = 0; i < n_lookups; i++)
+    {
+      p = hash_get (h, keys[i % vec_len (keys)]);
+      sum += p ? p[0] : 0;
+    }
+  t1 = clib_time_now (&clib_time);
+  for (i = 0; i < n_lookups; i++)
+    {
+      kv.key = keys[i % vec_len (keys)];
+      if (clib_oahash_search_inline_8_8 (oh, &kv) == 0)
+	{
+	  sum -= kv.value;
+	  n_found++;
+	}
+    }
+  t2 = clib_time_now (&clib_time);
+
+  if (sum != 0)
+    return clib_error_return (0, "lookup results differ");
+
+  fformat (stdout, "%u elts, %u lookups, %llu hits\n", hash_elts (h),
+	   n_lookups, n_found);
+  fformat (stdout, "hash_get:      %.2f ns/lookup\n",
+	   (t1 - t0) * 1e9 / n_lookups);
+  fformat (stdout, "oahash search: %.2f ns/lookup\n",
+	   (t2 - t1) * 1e9 / n_lookups);
+  fformat (stdout, "%U\n", format_clib_oahash_8_8, oh, 0 /* verbose */ );
+
+  hash_free (h);
+  clib_oahash_free_8_8 (oh);
+  vec_free (keys);
+  clib_bitmap_free (is_inserted);
+  return 0;
+}
+
 int
 test_hash_main (unformat_input_t * input)
 {
@@ -397,6 +507,7 @@ test_hash_main (unformat_input_t * input)
 	  && 0 == unformat (input, "size %d", &ht->fixed_hash_size)
 	  && 0 == unformat (input, "seed %d", &ht->seed)
 	  && 0 == unformat (input, "verbose %=", &ht->verbose, 1)
+	  && 0 == unformat (input, "oahash %=", &ht->oahash, 1)
 	  && 0 == unformat (input, "valid %d",
 			    &ht->n_iterations_per_validate))
 	{
@@ -410,6 +521,17 @@ test_hash_main (unformat_input_t * input)
 
   if_verbose ("testing %d iterations, seed %d", ht->n_iterations, ht->seed);
 
+  if (ht->oahash)
+    {
+      error = test_oahash (ht);
+      if (error)
+	{
+	  clib_error_report (error);
+	  return 1;
+	}
+      return 0;
+    }
+
   error = test_word_key (ht);
   if (error)
     clib_error_report (error);
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/segvec.h>
+#include <vppinfra/format.h>
+#include <vppinfra/error.h>
+
+#define NELTS 100000
+
+typedef struct
+{
+  u32 value;
+  u8 pad[60];
+} test_elt_t;
+
+int
+main (int argc, char *argv[])
+{
+  clib_segpool_t sp;
+  test_elt_t *e, **ptrs = 0;
+  u32 index, n;
+
+  clib_mem_init (0, 1ULL << 30);
+
+  clib_segpool_init (&sp, sizeof (test_elt_t), 6, CLIB_CACHE_LINE_BYTES);
+
+  for (u32 i = 0; i < NELTS; i++)
+    {
+      e = clib_segpool_get (&sp, &index);
+      if (index != i)
+	clib_panic ("got index %u, expected %u", index, i);
+      if (((uword) e & (CLIB_CACHE_LINE_BYTES - 1)) != 0)
+	clib_panic ("element %u not aligned", i);
+      e->value = i;
+      vec_add1 (ptrs, e);
+    }
+
+  /* growth never moved anything */
+  for (u32 i = 0; i < NELTS; i++)
+    {
+      e = clib_segpool_elt_at_index (&sp, i);
+      if (e != ptrs[i] || e->value != i)
+	clib_panic ("element %u moved or corrupt", i);
+    }
+
+  for (u32 i = 0; i < NELTS; i += 3)
+    clib_segpool_put_index (&sp, i);
+
+  n = 0;
+  clib_segpool_foreach_index (index, &sp)
+    {
+      if (index % 3 == 0)
+	clib_panic ("free index %u iterated", index);
+      n++;
+    }
+  if (n != clib_segpool_elts (&sp))
+    clib_panic ("iterated over %u of %u elts", n, clib_segpool_elts (&sp));
+
+  /* freed indices are reused before the pool grows */
+  e = clib_segpool_get (&sp, &index);
+  if (index % 3 || clib_segpool_len (&sp) != NELTS)
+    clib_panic ("index %u, len %u after reuse", index, clib_segpool_len (&sp));
+
+  fformat (stdout, "%u of %u elts in use\n", clib_segpool_elts (&sp),
+	   clib_segpool_len (&sp));
+
+  vec_free (ptrs);
+  clib_segpool_free (&sp);
+  return 0;
+}
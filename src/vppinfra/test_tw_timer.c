@@ -1318,6 +1318,100 @@ test5_double (tw_timer_test_main_t * tm)
   return 0;
 }
 
+static clib_error_t *
+test6_double_batch (tw_timer_test_main_t * tm)
+{
+  u32 i, j, n_batch = 32;
+  tw_timer_test_elt_t *e;
+  u32 user_ids[32], handles[32];
+  u32 expiration_time;
+  u32 max_expiration_time = 0;
+  u32 adds = 0, deletes = 0;
+  f64 before, after;
+
+  clib_time_init (&tm->clib_time);
+
+  tw_timer_wheel_init_16t_2w_512sl (&tm->double_wheel,
+				    expired_timer_double_callback,
+				    1.0 /* timer interval */ , ~0);
+
+  /* Prime offset */
+  run_double_wheel (&tm->double_wheel, 7567);
+
+  fformat (stdout, "test %d timers in batches of %d, 0x%llx seed\n",
+	   tm->ntimers, n_batch, tm->seed);
+
+  before = clib_time_now (&tm->clib_time);
+
+  for (i = 0; i < tm->ntimers; i += n_batch)
+    {
+      do
+	{
+	  expiration_time = random_u64 (&tm->seed) & ((1 << 17) - 1);
+	}
+      while (expiration_time == 0);
+
+      if (expiration_time > max_expiration_time)
+	max_expiration_time = expiration_time;
+
+      for (j = 0; j < n_batch; j++)
+	{
+	  pool_get (tm->test_elts, e);
+	  clib_memset (e, 0, sizeof (*e));
+	  e->expected_to_expire =
+	    expiration_time + tm->double_wheel.current_tick;
+	  user_ids[j] = e - tm->test_elts;
+	}
+
+      tw_timer_start_batch_16t_2w_512sl (&tm->double_wheel, user_ids,
+					 14 /* timer id */ ,
+					 expiration_time, handles, n_batch);
+      adds += n_batch;
+
+      /* stop every other batch */
+      if ((i / n_batch) & 1)
+	{
+	  tw_timer_stop_batch_16t_2w_512sl (&tm->double_wheel, handles,
+					    n_batch);
+	  for (j = 0; j < n_batch; j++)
+	    pool_put_index (tm->test_elts, user_ids[j]);
+	  deletes += n_batch;
+	}
+      else
+	for (j = 0; j < n_batch; j++)
+	  {
+	    e = pool_elt_at_index (tm->test_elts, user_ids[j]);
+	    e->stop_timer_handle = handles[j];
+	  }
+    }
+
+  run_double_wheel (&tm->double_wheel, max_expiration_time + 1);
+
+  after = clib_time_now (&tm->clib_time);
+
+  fformat (stdout, "%d adds, %d deletes, %d ticks\n", adds, deletes,
+	   tm->double_wheel.current_tick);
+  fformat (stdout, "test ran %.2f seconds, %.2f ops/second\n",
+	   (after - before),
+	   ((f64) adds + (f64) deletes +
+	    (f64) tm->double_wheel.current_tick) / (after - before));
+
+  if (pool_elts (tm->test_elts))
+    fformat (stdout, "Note: %d elements remain in pool\n",
+	     pool_elts (tm->test_elts));
+
+  pool_foreach (e, tm->test_elts)
+   {
+    fformat (stdout, "[%d] expected to expire %d\n",
+             e - tm->test_elts,
+             e->expected_to_expire);
+  }
+
+  pool_free (tm->test_elts);
+  tw_timer_wheel_free_16t_2w_512sl (&tm->double_wheel);
+  return 0;
+}
+
 static clib_error_t *
 timer_test_command_fn (tw_timer_test_main_t * tm, unformat_input_t * input)
 {
@@ -1328,6 +1422,7 @@ timer_test_command_fn (tw_timer_test_main_t * tm, unformat_input_t * input)
   int is_test3 = 0;
   int is_test4 = 0;
   int is_test5 = 0;
+  int is_test6 = 0;
   int overflow = 0;
 
   clib_memset (tm, 0, sizeof (*tm));
@@ -1353,6 +1448,8 @@ timer_test_command_fn (tw_timer_test_main_t * tm, unformat_input_t * input)
 	is_test4 = 1;
       else if (unformat (input, "linear"))
 	is_test5 = 1;
+      else if (unformat (input, "batch"))
+	is_test6 = 1;
       else if (unformat (input, "updates"))
 	is_updates = 1;
       else if (unformat (input, "wheels %d", &num_wheels))
@@ -1367,7 +1464,7 @@ timer_test_command_fn (tw_timer_test_main_t * tm, unformat_input_t * input)
 	break;
     }
 
-  if (is_test1 + is_test2 + is_test3 + is_test4 + is_test5 == 0)
+  if (is_test1 + is_test2 + is_test3 + is_test4 + is_test5 + is_test6 == 0)
     return clib_error_return (0, "No test specified [test1..n]");
 
   if (num_wheels < 1 || num_wheels > 3)
@@ -1409,6 +1506,9 @@ timer_test_command_fn (tw_timer_test_main_t * tm, unformat_input_t * input)
   if (is_test5)
     return test5_double (tm);
 
+  if (is_test6)
+    return test6_double_batch (tm);
+
   /* NOTREACHED */
   return 0;
 }
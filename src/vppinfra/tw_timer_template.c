@@ -157,7 +157,7 @@ timer_remove (TWT (tw_timer) * pool, TWT (tw_timer) * elt)
   elt->prev = elt->next = ~0;
 }
 
-static inline void
+static inline tw_timer_wheel_slot_t *
 timer_add (TWT (tw_timer_wheel) * tw, TWT (tw_timer) * t, u64 interval)
 {
 #if TW_TIMER_WHEELS > 1
@@ -193,7 +193,7 @@ timer_add (TWT (tw_timer_wheel) * tw, TWT (tw_timer) * t, u64 interval)
 #if TW_START_STOP_TRACE_SIZE > 0
       TW (tw_timer_trace) (tw, timer_id, user_id, t - tw->timers);
 #endif
-      return;
+      return ts;
     }
 #endif
 
@@ -246,7 +246,7 @@ timer_add (TWT (tw_timer_wheel) * tw, TWT (tw_timer) * t, u64 interval)
 #if TW_START_STOP_TRACE_SIZE > 0
       TW (tw_timer_trace) (tw, timer_id, user_id, t - tw->timers);
 #endif
-      return;
+      return ts;
     }
 #endif
 
@@ -264,7 +264,7 @@ timer_add (TWT (tw_timer_wheel) * tw, TWT (tw_timer) * t, u64 interval)
 #if TW_START_STOP_TRACE_SIZE > 0
       TW (tw_timer_trace) (tw, timer_id, user_id, t - tw->timers);
 #endif
-      return;
+      return ts;
     }
 #else
   fast_ring_offset %= TW_SLOTS_PER_RING;
@@ -282,6 +282,7 @@ timer_add (TWT (tw_timer_wheel) * tw, TWT (tw_timer) * t, u64 interval)
 #if TW_START_STOP_TRACE_SIZE > 0
   TW (tw_timer_trace) (tw, timer_id, user_id, t - tw->timers);
 #endif
+  return ts;
 }
 
 /**
@@ -309,6 +310,50 @@ TW (tw_timer_start) (TWT (tw_timer_wheel) * tw, u32 user_id, u32 timer_id,
   return t - tw->timers;
 }
 
+/**
+ * @brief Start a batch of tw timers with the same timer id and interval
+ * @param tw_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 * user_ids user defined timer ids, one per timer
+ * @param u32 timer_id app-specific timer ID. 4 bits.
+ * @param u64 interval timer interval in ticks
+ * @param u32 * handles returns the handles needed to cancel the timers
+ * @param u32 n_timers number of timers to start
+ */
+__clib_export void
+TW (tw_timer_start_batch) (TWT (tw_timer_wheel) * tw, u32 * user_ids,
+			   u32 timer_id, u64 interval, u32 * handles,
+			   u32 n_timers)
+{
+  tw_timer_wheel_slot_t *ts;
+  TWT (tw_timer) * t;
+  u32 first;
+
+  ASSERT (interval);
+
+  if (n_timers == 0)
+    return;
+
+  pool_get (tw->timers, t);
+  clib_memset (t, 0xff, sizeof (*t));
+  t->user_handle = TW (make_internal_timer_handle) (user_ids[0], timer_id);
+  ts = timer_add (tw, t, interval);
+  first = handles[0] = t - tw->timers;
+
+  /*
+   * All timers in the batch expire at the same tick, so they go into
+   * the same slot with the same ring offsets as the first one
+   */
+  for (u32 i = 1; i < n_timers; i++)
+    {
+      pool_get (tw->timers, t);
+      *t = tw->timers[first];
+      t->user_handle = TW (make_internal_timer_handle) (user_ids[i],
+							 timer_id);
+      timer_addhead (tw->timers, ts->head_index, t - tw->timers);
+      handles[i] = t - tw->timers;
+    }
+}
+
 #if TW_TIMER_SCAN_FOR_HANDLE > 0
 int TW (scan_for_handle) (TWT (tw_timer_wheel) * tw, u32 handle)
 {
@@ -376,6 +421,40 @@ __clib_export void TW (tw_timer_stop) (TWT (tw_timer_wheel) * tw, u32 handle)
   pool_put_index (tw->timers, handle);
 }
 
+/**
+ * @brief Stop a batch of tw timers
+ * @param tw_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 * handles timer cancellation handles returned by tw_timer_start
+ * @param u32 n_handles number of timers to stop
+ */
+__clib_export void
+TW (tw_timer_stop_batch) (TWT (tw_timer_wheel) * tw, u32 * handles,
+			  u32 n_handles)
+{
+  TWT (tw_timer) * t;
+  u32 i;
+
+  /*
+   * Timers and their list neighbours are all over the pool. Get the
+   * loads going for the whole batch before unlinking anything.
+   */
+  for (i = 0; i < n_handles; i++)
+    clib_prefetch_store (tw->timers + handles[i]);
+
+  for (i = 0; i < n_handles; i++)
+    {
+      if (TW_TIMER_ALLOW_DUPLICATE_STOP &&
+	  pool_is_free_index (tw->timers, handles[i]))
+	continue;
+      t = tw->timers + handles[i];
+      clib_prefetch_store (tw->timers + t->next);
+      clib_prefetch_store (tw->timers + t->prev);
+    }
+
+  for (i = 0; i < n_handles; i++)
+    TW (tw_timer_stop) (tw, handles[i]);
+}
+
 __clib_export int
 TW (tw_timer_handle_is_free) (TWT (tw_timer_wheel) * tw, u32 handle)
 {
@@ -46,6 +46,10 @@
 #define CLIB_HAVE_VEC128
 #endif
 
+#if defined(__aarch64__) && defined(__ARM_FEATURE_SVE)
+#define CLIB_HAVE_SVE
+#endif
+
 #if defined (__SSE4_2__) && __GNUC__ >= 4
 #define CLIB_HAVE_VEC128
 #endif
@@ -242,6 +246,10 @@ foreach_vec
 #include <vppinfra/vector_neon.h>
 #endif
 
+#if defined(CLIB_HAVE_SVE)
+#include <vppinfra/vector_sve.h>
+#endif
+
 /* this macro generate _splat inline functions for each scalar vector type */
 #ifndef CLIB_VEC128_SPLAT_DEFINED
 #define _(t, s, c) \
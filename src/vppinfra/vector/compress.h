@@ -26,6 +26,13 @@ clib_compress_u64_x64 (u64 *dst, u64 *src, u64 mask)
       dst += _popcnt32 (((u8) mask) & 0x0f);
       mask >>= 4;
     }
+#elif defined(CLIB_HAVE_SVE)
+  for (u32 i = 0; i < 64; i += svcntd ())
+    {
+      svbool_t pg = svwhilelt_b64_u32 (i, 64);
+      svbool_t p = u64_sve_bitmap_to_pred (pg, mask, i);
+      dst += u64_sve_compress_store (pg, p, svld1_u64 (pg, src + i), dst);
+    }
 #else
   u32 i;
   foreach_set_bit_index (i, mask)
@@ -57,6 +64,14 @@ clib_compress_u64_x64_masked (u64 *dst, u64 *src, u64 mask)
       dst += _popcnt32 (((u8) mask) & 0x0f);
       mask >>= 4;
     }
+#elif defined(CLIB_HAVE_SVE)
+  for (u32 i = 0; i < 64; i += svcntd ())
+    {
+      svbool_t pg = svwhilelt_b64_u32 (i, 64);
+      svbool_t p = u64_sve_bitmap_to_pred (pg, mask, i);
+      /* inactive lanes are not loaded, so no access past the mask */
+      dst += u64_sve_compress_store (pg, p, svld1_u64 (p, src + i), dst);
+    }
 #else
   u32 i;
   foreach_set_bit_index (i, mask)
@@ -122,6 +137,14 @@ clib_compress_u32_x64 (u32 *dst, u32 *src, u64 mask)
       dst += _popcnt32 ((u8) mask);
       mask >>= 8;
     }
+#elif defined(CLIB_HAVE_SVE)
+  for (u32 h = 0; h < 64; h += 32, src += 32, mask >>= 32)
+    for (u32 i = 0; i < 32; i += svcntw ())
+      {
+	svbool_t pg = svwhilelt_b32_u32 (i, 32);
+	svbool_t p = u32_sve_bitmap_to_pred (pg, mask, i);
+	dst += u32_sve_compress_store (pg, p, svld1_u32 (pg, src + i), dst);
+      }
 #else
   u32 i;
   foreach_set_bit_index (i, mask)
@@ -154,6 +177,14 @@ clib_compress_u32_x64_masked (u32 *dst, u32 *src, u64 mask)
       dst += _popcnt32 ((u8) mask);
       mask >>= 8;
     }
+#elif defined(CLIB_HAVE_SVE)
+  for (u32 h = 0; h < 64; h += 32, src += 32, mask >>= 32)
+    for (u32 i = 0; i < 32; i += svcntw ())
+      {
+	svbool_t pg = svwhilelt_b32_u32 (i, 32);
+	svbool_t p = u32_sve_bitmap_to_pred (pg, mask, i);
+	dst += u32_sve_compress_store (pg, p, svld1_u32 (p, src + i), dst);
+      }
 #else
   u32 i;
   foreach_set_bit_index (i, mask)
@@ -20,7 +20,19 @@ clib_count_equal_u64 (u64 *data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC256)
+#if defined(CLIB_HAVE_SVE)
+  svuint64_t splat = svdup_n_u64 (first);
+  while (count < max_count)
+    {
+      svbool_t pg = svwhilelt_b64_u64 (count, max_count);
+      svbool_t ne = svcmpne_u64 (pg, svld1_u64 (pg, data), splat);
+      if (svptest_any (pg, ne))
+	return count + svcntp_b64 (pg, svbrkb_b_z (pg, ne));
+      data += svcntd ();
+      count += svcntd ();
+    }
+  return max_count;
+#elif defined(CLIB_HAVE_VEC256)
   u64x4 splat = u64x4_splat (first);
   while (count + 3 < max_count)
     {
@@ -67,7 +79,19 @@ clib_count_equal_u32 (u32 *data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC512)
+#if defined(CLIB_HAVE_SVE)
+  svuint32_t splat = svdup_n_u32 (first);
+  while (count < max_count)
+    {
+      svbool_t pg = svwhilelt_b32_u64 (count, max_count);
+      svbool_t ne = svcmpne_u32 (pg, svld1_u32 (pg, data), splat);
+      if (svptest_any (pg, ne))
+	return count + svcntp_b32 (pg, svbrkb_b_z (pg, ne));
+      data += svcntw ();
+      count += svcntw ();
+    }
+  return max_count;
+#elif defined(CLIB_HAVE_VEC512)
   u32x16 splat = u32x16_splat (first);
   while (count + 15 < max_count)
     {
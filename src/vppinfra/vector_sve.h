@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2026 Cisco Systems, Inc.
+ */
+
+#ifndef included_vector_sve_h
+#define included_vector_sve_h
+#include <arm_sve.h>
+
+/* SVE vectors are sized at runtime, so unlike the fixed-width vector types
+ * there is no uNxM typedef here, only predicate helpers used by the
+ * vector/ algorithms. */
+
+/* predicate with lane i active if bit (first + i) of bmp is set */
+static_always_inline svbool_t
+u64_sve_bitmap_to_pred (svbool_t pg, u64 bmp, u64 first)
+{
+  svuint64_t v = svlsr_u64_x (pg, svdup_n_u64 (bmp), svindex_u64 (first, 1));
+  return svcmpne_n_u64 (pg, svand_n_u64_x (pg, v, 1), 0);
+}
+
+static_always_inline svbool_t
+u32_sve_bitmap_to_pred (svbool_t pg, u32 bmp, u32 first)
+{
+  svuint32_t v = svlsr_u32_x (pg, svdup_n_u32 (bmp), svindex_u32 (first, 1));
+  return svcmpne_n_u32 (pg, svand_n_u32_x (pg, v, 1), 0);
+}
+
+/* store the lanes of v selected by p contiguously at dst, returns the
+ * number of elements stored */
+static_always_inline u64
+u64_sve_compress_store (svbool_t pg, svbool_t p, svuint64_t v, u64 *dst)
+{
+  u64 n = svcntp_b64 (pg, p);
+  svst1_u64 (svwhilelt_b64_u64 (0, n), dst, svcompact_u64 (p, v));
+  return n;
+}
+
+static_always_inline u64
+u32_sve_compress_store (svbool_t pg, svbool_t p, svuint32_t v, u32 *dst)
+{
+  u64 n = svcntp_b32 (pg, p);
+  svst1_u32 (svwhilelt_b32_u64 (0, n), dst, svcompact_u32 (p, v));
+  return n;
+}
+
+#endif /* included_vector_sve_h */
@@ -45,6 +45,32 @@ class TestBihash(VppAsfTestCase):
             self.logger.critical(error)
             self.assertNotIn("failed", error)
 
+    def test_bihash_deferred_free(self):
+        """Bihash Deferred Free (lockless reader) Test"""
+
+        error = self.vapi.cli("test bihash careful 0 verbose 0 deferred-free")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+        error = self.vapi.cli(
+            "test bihash threads 2 nbuckets 64000 careful 0 verbose 0 deferred-free"
+        )
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+    def test_bihash_sharded(self):
+        """Bihash Sharded Container Test"""
+
+        error = self.vapi.cli("test bihash sharded threads 4 nitems 10000")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
     def test_bihash_vec64(self):
         """Bihash vec64 Test"""
 
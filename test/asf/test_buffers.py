@@ -27,3 +27,25 @@ class TestBuffers(VppAsfTestCase):
         if error:
             self.logger.critical(error)
             self.assertNotIn("failed", error)
+
+    def test_magazines(self):
+        """Buffer Magazines"""
+        error = self.vapi.cli("test buffer-magazines")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+    def test_chain_builder(self):
+        """Chained Buffer Builder"""
+        error = self.vapi.cli("test chained-buffer-builder")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+
+class TestBuffersLazyInit(TestBuffers):
+    """Buffer C Unit Tests with lazily formatted buffers"""
+
+    extra_vpp_config = ["buffers", "{", "lazy-init", "}"]
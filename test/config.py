@@ -207,6 +207,45 @@ parser.add_argument(
 )
 
 parser.add_argument("--extended", action="store_true", help="run extended tests")
+
+parser.add_argument(
+    "--perf",
+    action="store_true",
+    help="run dataplane performance regression tests",
+)
+
+parser.add_argument(
+    "--perf-baseline",
+    action="store",
+    default=None,
+    help="directory holding per-pipeline baseline results (<pipeline>.json);\n"
+    "pipelines without a baseline are measured but not compared",
+)
+
+default_perf_threshold = 10.0
+parser.add_argument(
+    "--perf-threshold",
+    action="store",
+    type=float,
+    default=default_perf_threshold,
+    help="allowed per-node clocks/packet increase over the baseline, in percent "
+    f"(default: {default_perf_threshold})",
+)
+
+parser.add_argument(
+    "--perf-results-dir",
+    action="store",
+    default=None,
+    help="directory where per-pipeline results are written "
+    "(default: <tmp-dir>/perf)",
+)
+
+parser.add_argument(
+    "--perf-bundle",
+    action="store",
+    default=None,
+    help="perfmon bundle to collect per node alongside the clock counters",
+)
 parser.add_argument(
     "--skip-netns-tests",
     action="store_true",
@@ -474,6 +513,9 @@ if config.venv_dir is None:
 if config.failed_dir is None:
     config.failed_dir = f"{config.tmp_dir}"
 
+if config.perf_results_dir is None:
+    config.perf_results_dir = f"{config.tmp_dir}/perf"
+
 available_cpus = psutil.Process().cpu_affinity()
 num_cpus = len(available_cpus)
 
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Dataplane performance regression test template
+
+Each test case configures one canonical pipeline, pushes a fixed number of
+packet-generator packets through it on the main thread and records, per
+graph node, the calls, vectors and clocks it consumed - the same numbers
+"show runtime" reports - taken as deltas of the stats segment node counters.
+
+Results are written as <perf-results-dir>/<pipeline>.json. When a baseline
+directory is given, the result is compared with <perf-baseline>/<pipeline>.json
+and the test fails if the pipeline, or any node carrying a significant part
+of the traffic, needs more than --perf-threshold percent more clocks per
+packet than the baseline did. Refreshing a baseline is a matter of copying
+the results directory over it.
+"""
+
+import json
+import os
+import time
+import unittest
+
+from config import config
+from framework import VppTestCase
+
+
+@unittest.skipUnless(config.perf, "part of performance tests")
+class TemplatePerf(VppTestCase):
+    """Dataplane performance regression test template"""
+
+    # keep the measurement on a single thread, with a pg-input that does not
+    # compete with workers for the core
+    vpp_worker_count = 0
+
+    # node counters are published by the stats collector process; refresh
+    # them often enough that a snapshot taken after a short sleep is exact
+    stats_update_interval = 0.1
+    extra_vpp_statseg_config = "update-interval %s" % stats_update_interval
+
+    # route and session scale setup goes through single, long running CLIs
+    vapi_response_timeout = 300
+
+    # name of the pipeline, used for the result and baseline file names
+    pipeline = None
+
+    n_packets = 1000000
+    packet_size = 64
+
+    # node whose vector count is the number of packets offered to the
+    # pipeline; the total clocks/packet figure is normalised by it
+    reference_node = "pg-input"
+
+    # nodes whose cost is only compared when they handled at least this
+    # fraction of the reference node's vectors
+    min_vectors_fraction = 0.1
+
+    # nodes that are part of the harness, not of the pipeline under test
+    ignored_nodes = ("pg-input",)
+
+    @classmethod
+    def setUpClass(cls):
+        super(TemplatePerf, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TemplatePerf, cls).tearDownClass()
+
+    def node_counters(self):
+        """Per node calls, vectors and clocks, summed over all threads"""
+        # let the collector publish everything up to now
+        self.sleep(3 * self.stats_update_interval)
+
+        names = self.statistics.get_counter("/sys/node/names")
+        counters = {}
+        for c in ("calls", "vectors", "clocks"):
+            per_thread = self.statistics.get_counter("/sys/node/%s" % c)
+            for i, name in enumerate(names):
+                if not name:
+                    continue
+                node = counters.setdefault(name, {})
+                node[c] = sum(t[i] for t in per_thread if i < len(t))
+        return counters
+
+    def pg_perf_stream(self, name, intf, headers, hdr_len, node="ethernet-input"):
+        """Packet generator stream of n_packets packet_size sized packets:
+        the given header edits padded with an incrementing payload"""
+        data = headers
+        if self.packet_size > hdr_len:
+            data += "    incrementing %u\n" % (self.packet_size - hdr_len)
+        return (
+            "packet-generator new {\n"
+            "  name %s\n"
+            "  limit %u\n"
+            "  size %u-%u\n"
+            "  interface %s\n"
+            "  node %s\n"
+            "  data {\n"
+            "%s"
+            "  }\n"
+            "}\n"
+            % (
+                name,
+                self.n_packets,
+                self.packet_size,
+                self.packet_size,
+                intf.name,
+                node,
+                data,
+            )
+        )
+
+    def pg_perf_run(self, streams):
+        """Add streams, run them to completion and remove them"""
+        names = []
+        for s in streams:
+            self.vapi.cli(s)
+            names.append(s.split("name", 1)[1].split()[0])
+
+        self.vapi.cli("packet-generator enable")
+        deadline = time.time() + 600
+        while self.vapi.cli("show packet-generator").find("Yes") != -1:
+            self.sleep(0.01)
+            if time.time() > deadline:
+                self.fail("packet-generator did not finish in time")
+
+        for n in names:
+            self.vapi.cli("packet-generator delete %s" % n)
+
+    def perf_collect(self, traffic):
+        """Run traffic once to measure node clocks, and once more under the
+        perfmon bundle when one is configured; the bundle's dispatch wrapper
+        perturbs clocks, so the two are never taken from the same run"""
+        before = self.node_counters()
+        traffic()
+        after = self.node_counters()
+
+        nodes = {}
+        for name, a in after.items():
+            b = before.get(name, {})
+            d = {c: a[c] - b.get(c, 0) for c in a}
+            if d["vectors"] == 0:
+                continue
+            d["clocks_per_packet"] = d["clocks"] / d["vectors"]
+            d["vectors_per_call"] = d["vectors"] / d["calls"] if d["calls"] else 0
+            nodes[name] = d
+
+        if self.reference_node not in nodes:
+            self.fail(
+                "%s: no traffic seen by %s, pipeline misconfigured"
+                % (self.pipeline, self.reference_node)
+            )
+        n_packets = nodes[self.reference_node]["vectors"]
+        clocks = sum(
+            d["clocks"] for n, d in nodes.items() if n not in self.ignored_nodes
+        )
+
+        result = {
+            "pipeline": self.pipeline,
+            "version": self.vapi.show_version().version,
+            "timestamp": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+            "packets": n_packets,
+            "packet_size": self.packet_size,
+            "clocks_per_packet": clocks / n_packets,
+            "nodes": nodes,
+        }
+
+        if config.perf_bundle:
+            self.vapi.cli("perfmon start bundle %s type node" % config.perf_bundle)
+            traffic()
+            result["perfmon"] = {
+                "bundle": config.perf_bundle,
+                "statistics": self.vapi.cli("show perfmon statistics"),
+            }
+            self.vapi.cli("perfmon stop")
+
+        self.logger.info(self.vapi.cli("show runtime"))
+        return result
+
+    def perf_write(self, result):
+        os.makedirs(config.perf_results_dir, exist_ok=True)
+        path = os.path.join(config.perf_results_dir, "%s.json" % self.pipeline)
+        with open(path, "w") as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+        self.logger.info("%s: results written to %s" % (self.pipeline, path))
+
+    def perf_compare(self, result):
+        """List of regressions of result against the stored baseline"""
+        if not config.perf_baseline:
+            return []
+        path = os.path.join(config.perf_baseline, "%s.json" % self.pipeline)
+        if not os.path.exists(path):
+            self.logger.info("%s: no baseline at %s" % (self.pipeline, path))
+            return []
+        with open(path) as f:
+            baseline = json.load(f)
+
+        limit = 1 + config.perf_threshold / 100.0
+        regressions = []
+
+        def check(what, cur, base):
+            if base > 0 and cur > base * limit:
+                regressions.append(
+                    "%s: %.1f clocks/packet vs. baseline %.1f (+%.1f%%)"
+                    % (what, cur, base, 100.0 * (cur - base) / base)
+                )
+
+        check(
+            "pipeline %s" % self.pipeline,
+            result["clocks_per_packet"],
+            baseline["clocks_per_packet"],
+        )
+
+        min_vectors = self.min_vectors_fraction * result["packets"]
+        for name, d in sorted(result["nodes"].items()):
+            b = baseline["nodes"].get(name)
+            if name in self.ignored_nodes or not b or d["vectors"] < min_vectors:
+                continue
+            check("node %s" % name, d["clocks_per_packet"], b["clocks_per_packet"])
+
+        return regressions
+
+    def perf_run(self, traffic):
+        """Measure the pipeline, record the result and hold it against the
+        baseline"""
+        result = self.perf_collect(traffic)
+        self.perf_write(result)
+        regressions = self.perf_compare(result)
+        for r in regressions:
+            self.logger.error(r)
+        if regressions:
+            self.fail(
+                "%s regressed beyond %.1f%%:\n%s"
+                % (self.pipeline, config.perf_threshold, "\n".join(regressions))
+            )
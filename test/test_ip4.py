@@ -2596,6 +2596,87 @@ class TestIPLPM(VppTestCase):
         rx = self.send_and_expect(self.pg0, p_24 * NUM_PKTS, self.pg1)
 
 
+class TestIPRouteBatch(VppTestCase):
+    """IPv4 Route Batches"""
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestIPRouteBatch, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestIPRouteBatch, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestIPRouteBatch, self).setUp()
+
+        self.create_pg_interfaces(range(2))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    def tearDown(self):
+        super(TestIPRouteBatch, self).tearDown()
+        for i in self.pg_interfaces:
+            i.admin_down()
+            i.unconfig_ip4()
+
+    def route_batch(self, is_add, routes):
+        return self.vapi.ip_route_add_del_batch(
+            is_add=is_add, is_multipath=0, n_routes=len(routes), routes=routes
+        )
+
+    def test_ip_route_batch(self):
+        """IP route add/del batch"""
+
+        path = VppRoutePath(self.pg1.remote_ip4, self.pg1.sw_if_index)
+        addrs = ["10.%d.%d.0" % (ii >> 8, ii & 0xFF) for ii in range(300)]
+        routes = [
+            {"table_id": 0, "prefix": "%s/24" % addr, "path": path.encode()}
+            for addr in addrs
+        ]
+
+        rv = self.route_batch(1, routes)
+        self.assertEqual(rv.n_done, len(routes))
+        n_batches = self.statistics["/net/route/batch/batches"]
+
+        for addr in addrs[::50]:
+            self.assertTrue(find_route(self, addr, 24))
+
+        p = (
+            Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac)
+            / IP(src=self.pg0.remote_ip4, dst="10.1.2.1")
+            / UDP(sport=1234, dport=1234)
+            / Raw(b"\xa5" * 100)
+        )
+        self.send_and_expect(self.pg0, p * NUM_PKTS, self.pg1)
+
+        rv = self.route_batch(0, routes)
+        self.assertEqual(rv.n_done, len(routes))
+        self.assertEqual(self.statistics["/net/route/batch/batches"], n_batches + 1)
+
+        for addr in addrs[::50]:
+            self.assertFalse(find_route(self, addr, 24))
+
+        #
+        # programming stops at the first route that fails, here one in
+        # a table that does not exist
+        #
+        bad = routes[:2] + [dict(routes[2], table_id=100)] + routes[3:5]
+        with self.vapi.assert_negative_api_retval():
+            self.route_batch(1, bad)
+
+        self.assertTrue(find_route(self, "10.0.1.0", 24))
+        self.assertFalse(find_route(self, "10.0.2.0", 24))
+        self.assertFalse(find_route(self, "10.0.3.0", 24))
+
+        rv = self.route_batch(0, routes[:2])
+        self.assertEqual(rv.n_done, 2)
+        self.assertFalse(find_route(self, "10.0.0.0", 24))
+
+
 @tag_fixme_vpp_workers
 class TestIPv4Frag(VppTestCase):
     """IPv4 fragmentation"""
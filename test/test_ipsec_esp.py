@@ -827,13 +827,122 @@ class TestIpsecEspAsync(TemplateIpsecEsp):
         self.p_async.spd.remove_vpp_config()
         self.p_async.sa.remove_vpp_config()
 
+    def test_adaptive_stream(self):
+        """Sync SAs switched to async by the adaptive offload"""
+        p = self.params[self.p_sync.addr_type]
+
+        # switch on the first vectors
+        self.vapi.cli(
+            "set crypto async adaptive-offload on async-vector-rate 1 "
+            "sync-vector-rate 0 clocks-per-packet 0 hysteresis 1"
+        )
+
+        pkts = [
+            (
+                Ether(src=self.pg1.remote_mac, dst=self.pg1.local_mac)
+                / IP(src=self.pg1.remote_ip4, dst=self.p_sync.remote_tun_if_host)
+                / UDP(sport=4444, dport=4444)
+                / Raw(b"0x0" * 200)
+            ),
+            (
+                Ether(src=self.pg1.remote_mac, dst=self.pg1.local_mac)
+                / IP(src=self.pg1.remote_ip4, dst=p.remote_tun_if_host)
+                / UDP(sport=4444, dport=4444)
+                / Raw(b"0x0" * 200)
+            ),
+        ]
+        pkts *= 1023
+
+        rxs = self.send_and_expect(self.pg1, pkts, self.pg0)
+
+        self.assertEqual(len(rxs), len(pkts))
+
+        for rx in rxs:
+            if rx[ESP].spi == p.vpp_tun_spi:
+                decrypted = p.vpp_tun_sa.decrypt(rx[IP])
+            elif rx[ESP].spi == self.p_sync.vpp_tun_spi:
+                decrypted = self.p_sync.vpp_tun_sa.decrypt(rx[IP])
+            else:
+                rx.show()
+                self.assertTrue(False)
+
+        status = self.vapi.cli("sh crypto async status")
+        self.logger.info(status)
+        self.assertIn("adaptive offload", status)
+        self.assertIn(" async vector-rate", status)
+
+        self.vapi.cli("set crypto async adaptive-offload off")
+        self.p_sync.spd.remove_vpp_config()
+        self.p_sync.sa.remove_vpp_config()
+        self.p_async.spd.remove_vpp_config()
+        self.p_async.sa.remove_vpp_config()
+
 
 class TestIpsecEspHandoff(
     TemplateIpsecEsp, IpsecTun6HandoffTests, IpsecTun4HandoffTests
 ):
     """Ipsec ESP - handoff tests"""
 
-    pass
+    def test_tun_multi_worker_44(self):
+        """ipsec 4o4 tunnel multi-worker encrypt test"""
+        self.vapi.cli("clear errors")
+        self.vapi.cli("clear ipsec sa")
+
+        N_PKTS = 15
+        p = self.params[socket.AF_INET]
+        self.vapi.cli("ipsec sa multi-worker %d" % p.vpp_tun_sa_id)
+
+        # both workers encrypt for the SA, each with sequence numbers from
+        # its own block
+        seqs = {}
+        for worker in [0, 1]:
+            send_pkts = self.gen_pkts(
+                self.pg1,
+                src=self.pg1.remote_ip4,
+                dst=p.remote_tun_if_host,
+                count=N_PKTS,
+            )
+            recv_pkts = self.send_and_expect(
+                self.pg1, send_pkts, self.tun_if, worker=worker
+            )
+            self.verify_encrypted(p, p.vpp_tun_sa, recv_pkts)
+            seqs[worker] = sorted(rx[ESP].seq for rx in recv_pkts)
+            self.assertEqual(
+                seqs[worker], list(range(seqs[worker][0], seqs[worker][0] + N_PKTS))
+            )
+            pkts = p.tun_sa_out.get_stats(worker)["packets"]
+            self.assertEqual(pkts, N_PKTS)
+        self.assertEqual(seqs[1][0] - seqs[0][0], 256)
+
+        self.vapi.cli("ipsec sa multi-worker %d disable" % p.vpp_tun_sa_id)
+
+    def test_tun_multi_worker_decrypt_44(self):
+        """ipsec 4o4 tunnel multi-worker decrypt test"""
+        self.vapi.cli("clear errors")
+        self.vapi.cli("clear ipsec sa")
+
+        N_PKTS = 15
+        p = self.params[socket.AF_INET]
+        self.vapi.cli("ipsec sa multi-worker %d" % p.scapy_tun_sa_id)
+
+        # each worker decrypts what it receives, nothing is handed off
+        for worker in [0, 1]:
+            send_pkts = self.gen_encrypt_pkts(
+                p,
+                p.scapy_tun_sa,
+                self.tun_if,
+                src=p.remote_tun_if_host,
+                dst=self.pg1.remote_ip4,
+                count=N_PKTS,
+            )
+            recv_pkts = self.send_and_expect(
+                self.tun_if, send_pkts, self.pg1, worker=worker
+            )
+            self.verify_decrypted(p, recv_pkts)
+            pkts = p.tun_sa_in.get_stats(worker)["packets"]
+            self.assertEqual(pkts, N_PKTS)
+
+        self.vapi.cli("ipsec sa multi-worker %d disable" % p.scapy_tun_sa_id)
 
 
 class TemplateIpsecEspUdp(ConfigIpsecESP):
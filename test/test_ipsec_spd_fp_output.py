@@ -503,6 +503,109 @@ class IPSec4SpdTestCaseRemove(SpdFastPathOutbound):
         self.verify_policy_match(pkt_count, policy_1)
 
 
+class IPSec4SpdTestCaseRemovePortRange(SpdFastPathOutbound):
+    """ IPSec/IPv4 outbound: Policy mode test case with fast path \
+        (remove unaligned port range rule)"""
+
+    def test_ipsec_spd_outbound_remove(self):
+        # In this test case, packets in IPv4 FWD path are configured
+        # to go through IPSec outbound SPD policy lookup.
+        # 2 SPD rules (1 HIGH and 1 LOW) are added.
+        # High priority rule action is set to BYPASS, with port ranges
+        # that aren't aligned to a power of 2 and so take several hash
+        # entries each.
+        # Low priority rule action is set to DISCARD.
+        # Traffic at the edges of the ranges should match the high priority
+        # rule, traffic just outside them the low priority one.
+        # High priority rule is then removed, and all traffic should match
+        # the low priority rule.
+        self.create_interfaces(2)
+        pkt_count = 5
+        s_port_s = 1001
+        s_port_e = 2022
+        d_port_s = 5001
+        d_port_e = 6022
+        self.spd_create_and_intf_add(1, [self.pg1])
+        policy_0 = self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            local_port_start=s_port_s,
+            local_port_stop=s_port_e,
+            remote_port_start=d_port_s,
+            remote_port_stop=d_port_e,
+        )
+        policy_1 = self.spd_add_rem_policy(  # outbound, priority 5
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=5,
+            policy_type="discard",
+            all_ips=True,
+        )
+
+        # packets at both ends of the ranges are forwarded
+        packets = self.create_stream(
+            self.pg0, self.pg1, pkt_count, s_port_s, d_port_e
+        ) + self.create_stream(self.pg0, self.pg1, pkt_count, s_port_e, d_port_s)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        capture = self.pg1.get_capture(2 * pkt_count)
+        self.pg0.assert_nothing_captured()
+        self.verify_policy_match(2 * pkt_count, policy_0)
+        self.verify_policy_match(0, policy_1)
+
+        # packets just outside of them are dropped
+        packets = self.create_stream(
+            self.pg0, self.pg1, pkt_count, s_port_s - 1, d_port_s
+        ) + self.create_stream(self.pg0, self.pg1, pkt_count, s_port_s, d_port_e + 1)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(2 * pkt_count, policy_0)
+        self.verify_policy_match(2 * pkt_count, policy_1)
+
+        # now remove the bypass rule
+        self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            local_port_start=s_port_s,
+            local_port_stop=s_port_e,
+            remote_port_start=d_port_s,
+            remote_port_stop=d_port_e,
+            remove=True,
+        )
+
+        # all packets will be dropped by SPD rule
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, s_port_s, d_port_e)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(2 * pkt_count, policy_0)
+        self.verify_policy_match(3 * pkt_count, policy_1)
+
+
 class IPSec4SpdTestCaseReadd(SpdFastPathOutbound):
     """ IPSec/IPv4 outbound: Policy mode test case with fast path \
         (add, remove, re-add)"""
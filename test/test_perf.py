@@ -0,0 +1,477 @@
+#!/usr/bin/env python3
+"""Dataplane performance regression tests, see template_perf.py"""
+
+import unittest
+from ipaddress import ip_address, IPv4Network
+
+from config import config
+from asfframework import VppTestRunner
+from template_perf import TemplatePerf
+from util import mac_pton
+from vpp_papi import VppEnum
+from vpp_ip_route import VppIpRoute, VppRoutePath, VppIpTable
+from vpp_acl import AclRule, VppAcl, VppAclInterface
+from vpp_ipsec import VppIpsecSA, VppIpsecTunProtect, VppIpsecInterface
+from vpp_vxlan_tunnel import VppVxlanTunnel
+
+# header lengths of the generated packets, ethernet included
+L2_IP4_UDP_LEN = 14 + 20 + 8
+L2_IP6_UDP_LEN = 14 + 40 + 8
+
+
+class TemplatePerfRouted(TemplatePerf):
+    """Two pg interfaces, traffic enters pg0 and leaves pg1"""
+
+    @classmethod
+    def setUpClass(cls):
+        super(TemplatePerfRouted, cls).setUpClass()
+        cls.create_pg_interfaces(range(2))
+        for i in cls.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.config_ip6()
+            i.resolve_arp()
+            i.resolve_ndp()
+
+    @classmethod
+    def tearDownClass(cls):
+        for i in cls.pg_interfaces:
+            i.unconfig_ip4()
+            i.unconfig_ip6()
+            i.admin_down()
+        super(TemplatePerfRouted, cls).tearDownClass()
+
+    def ip4_udp_stream(self, dst, src=None, sport="1234", dport="4321"):
+        if src is None:
+            src = self.pg0.remote_ip4
+        return self.pg_perf_stream(
+            self.pipeline,
+            self.pg0,
+            "    IP4: %s -> %s\n"
+            "    UDP: %s -> %s\n"
+            "    UDP: %s -> %s\n"
+            % (self.pg0.remote_mac, self.pg0.local_mac, src, dst, sport, dport),
+            L2_IP4_UDP_LEN,
+        )
+
+
+class TestPerfL2Bridge(TemplatePerf):
+    """L2 bridging performance"""
+
+    pipeline = "l2-bridge"
+    bd_id = 1
+    src_mac = "02:00:00:00:00:01"
+    dst_mac = "02:00:00:00:00:02"
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestPerfL2Bridge, cls).setUpClass()
+        cls.create_pg_interfaces(range(2))
+        cls.vapi.bridge_domain_add_del_v2(
+            bd_id=cls.bd_id, is_add=1, uu_flood=0, learn=0, flood=1, forward=1
+        )
+        for i in cls.pg_interfaces:
+            i.admin_up()
+            cls.vapi.sw_interface_set_l2_bridge(
+                rx_sw_if_index=i.sw_if_index, bd_id=cls.bd_id
+            )
+        cls.vapi.l2fib_add_del(
+            mac_pton(cls.dst_mac), cls.bd_id, cls.pg1.sw_if_index, static_mac=1
+        )
+
+    def test_perf_l2_bridge(self):
+        """L2 bridge, static L2FIB entry"""
+        stream = self.pg_perf_stream(
+            self.pipeline,
+            self.pg0,
+            "    IP4: %s -> %s\n"
+            "    UDP: 10.0.0.1 -> 10.0.0.2\n"
+            "    UDP: 1234 -> 4321\n" % (self.src_mac, self.dst_mac),
+            L2_IP4_UDP_LEN,
+        )
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+class TestPerfIp4Routes(TemplatePerfRouted):
+    """IPv4 forwarding performance with a large FIB"""
+
+    pipeline = "ip4-1m-routes"
+    n_routes = 1000000
+    route_base = "172.16.0.0"
+    extra_vpp_config = ["memory", "{", "main-heap-size", "2G", "}"]
+
+    def test_perf_ip4_routes(self):
+        """IPv4 forwarding over 1M /32 routes"""
+        self.vapi.cli(
+            "ip route add count %u %s/32 via %s %s"
+            % (self.n_routes, self.route_base, self.pg1.remote_ip4, self.pg1.name)
+        )
+        last = ip_address(self.route_base) + self.n_routes - 1
+        stream = self.ip4_udp_stream("%s-%s" % (self.route_base, last))
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+class TestPerfIp6Routes(TemplatePerfRouted):
+    """IPv6 forwarding performance with a large FIB"""
+
+    pipeline = "ip6-1m-routes"
+    n_routes = 1000000
+    route_base = "2001:db8:1::"
+    extra_vpp_config = [
+        "memory",
+        "{",
+        "main-heap-size",
+        "2G",
+        "}",
+        "ip6",
+        "{",
+        "heap-size",
+        "512M",
+        "hash-buckets",
+        "1048576",
+        "}",
+    ]
+
+    def test_perf_ip6_routes(self):
+        """IPv6 forwarding over 1M /128 routes"""
+        self.vapi.cli(
+            "ip route add count %u %s/128 via %s %s"
+            % (self.n_routes, self.route_base, self.pg1.remote_ip6, self.pg1.name)
+        )
+        last = ip_address(self.route_base) + self.n_routes - 1
+        stream = self.pg_perf_stream(
+            self.pipeline,
+            self.pg0,
+            "    IP6: %s -> %s\n"
+            "    UDP: %s -> %s-%s\n"
+            "    UDP: 1234 -> 4321\n"
+            % (
+                self.pg0.remote_mac,
+                self.pg0.local_mac,
+                self.pg0.remote_ip6,
+                self.route_base,
+                last,
+            ),
+            L2_IP6_UDP_LEN,
+        )
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+@unittest.skipIf("nat" in config.excluded_plugins, "Exclude NAT plugin tests")
+class TestPerfNat44Ed(TemplatePerfRouted):
+    """NAT44-ED in2out performance"""
+
+    pipeline = "nat44-ed"
+    n_flows = 1024
+    nat_addr = "10.0.0.3"
+
+    def setUp(self):
+        super(TestPerfNat44Ed, self).setUp()
+        flags = VppEnum.vl_api_nat_config_flags_t
+        self.vapi.nat44_ed_plugin_enable_disable(sessions=4 * self.n_flows, enable=1)
+        self.vapi.nat44_add_del_address_range(
+            first_ip_address=self.nat_addr,
+            last_ip_address=self.nat_addr,
+            vrf_id=0xFFFFFFFF,
+            is_add=1,
+            flags=0,
+        )
+        self.vapi.nat44_interface_add_del_feature(
+            flags=flags.NAT_IS_INSIDE, sw_if_index=self.pg0.sw_if_index, is_add=1
+        )
+        self.vapi.nat44_interface_add_del_feature(
+            flags=flags.NAT_IS_OUTSIDE, sw_if_index=self.pg1.sw_if_index, is_add=1
+        )
+
+    def tearDown(self):
+        self.vapi.nat44_ed_plugin_enable_disable(enable=0)
+        super(TestPerfNat44Ed, self).tearDown()
+
+    def test_perf_nat44_ed(self):
+        """NAT44-ED in2out, established UDP sessions"""
+        # the first n_flows packets create the sessions, the rest of the run
+        # translates on established ones
+        stream = self.ip4_udp_stream(
+            self.pg1.remote_ip4, sport="1024-%u" % (1024 + self.n_flows - 1)
+        )
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+class TestPerfIpsecGcm(TemplatePerfRouted):
+    """IPsec ESP AES-GCM-128 tunnel encrypt performance"""
+
+    pipeline = "ipsec-aes-gcm-128"
+    protected_net = "10.10.0.0"
+    packet_size = 128
+
+    def setUp(self):
+        super(TestPerfIpsecGcm, self).setUp()
+        crypto = VppEnum.vl_api_ipsec_crypto_alg_t.IPSEC_API_CRYPTO_ALG_AES_GCM_128
+        integ = VppEnum.vl_api_ipsec_integ_alg_t.IPSEC_API_INTEG_ALG_NONE
+        esp = VppEnum.vl_api_ipsec_proto_t.IPSEC_API_PROTO_ESP
+        key = b"JPjyOWBeVEQiMe7h"
+
+        self.sa_out = VppIpsecSA(
+            self,
+            100,
+            1000,
+            integ,
+            b"",
+            crypto,
+            key,
+            esp,
+            self.pg1.local_ip4,
+            self.pg1.remote_ip4,
+            salt=3333,
+        )
+        self.sa_out.add_vpp_config()
+        self.sa_in = VppIpsecSA(
+            self,
+            200,
+            2000,
+            integ,
+            b"",
+            crypto,
+            key,
+            esp,
+            self.pg1.remote_ip4,
+            self.pg1.local_ip4,
+            salt=3333,
+            flags=VppEnum.vl_api_ipsec_sad_flags_t.IPSEC_API_SAD_FLAG_IS_INBOUND,
+        )
+        self.sa_in.add_vpp_config()
+
+        self.tun_if = VppIpsecInterface(self)
+        self.tun_if.add_vpp_config()
+        self.tun_if.admin_up()
+        self.tun_if.config_ip4()
+        self.tun_protect = VppIpsecTunProtect(
+            self, self.tun_if, self.sa_out, [self.sa_in]
+        )
+        self.tun_protect.add_vpp_config()
+        self.route = VppIpRoute(
+            self,
+            self.protected_net,
+            16,
+            [VppRoutePath(self.tun_if.remote_ip4, 0xFFFFFFFF)],
+        )
+        self.route.add_vpp_config()
+
+    def tearDown(self):
+        self.route.remove_vpp_config()
+        self.tun_protect.remove_vpp_config()
+        self.tun_if.unconfig_ip4()
+        self.tun_if.remove_vpp_config()
+        self.sa_in.remove_vpp_config()
+        self.sa_out.remove_vpp_config()
+        super(TestPerfIpsecGcm, self).tearDown()
+
+    def test_perf_ipsec_gcm(self):
+        """IPsec tunnel interface, ESP AES-GCM-128 encrypt"""
+        last = ip_address(self.protected_net) + 0xFFFF
+        stream = self.ip4_udp_stream("%s-%s" % (self.protected_net, last))
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+@unittest.skipIf("acl" in config.excluded_plugins, "Exclude ACL plugin tests")
+class TestPerfAcl(TemplatePerfRouted):
+    """ACL plugin input filtering performance"""
+
+    pipeline = "acl-10k-rules"
+    n_acls = 10
+    n_rules_per_acl = 1000
+
+    def setUp(self):
+        super(TestPerfAcl, self).setUp()
+        # rules that never match the traffic, with a mix of prefix lengths
+        # and port ranges, followed by the permit the traffic does hit
+        deny_base = ip_address("100.64.0.0")
+        lens = (32, 24, 16)
+        self.acls = []
+        for a in range(self.n_acls):
+            rules = []
+            for r in range(self.n_rules_per_acl):
+                n = a * self.n_rules_per_acl + r
+                rules.append(
+                    AclRule(
+                        is_permit=0,
+                        src_prefix=IPv4Network(
+                            "%s/%u" % (deny_base + (n << 8), lens[n % len(lens)]),
+                            strict=False,
+                        ),
+                        proto=17,
+                        dport_from=n % 1000,
+                        dport_to=n % 1000 + 10,
+                    )
+                )
+            if a == self.n_acls - 1:
+                rules.append(AclRule(is_permit=1))
+            acl = VppAcl(self, rules=rules)
+            acl.add_vpp_config()
+            self.acls.append(acl)
+
+        self.acl_if = VppAclInterface(
+            self,
+            sw_if_index=self.pg0.sw_if_index,
+            n_input=len(self.acls),
+            acls=self.acls,
+        )
+        self.acl_if.add_vpp_config()
+
+    def tearDown(self):
+        self.acl_if.remove_vpp_config()
+        for acl in self.acls:
+            acl.remove_vpp_config()
+        super(TestPerfAcl, self).tearDown()
+
+    def test_perf_acl(self):
+        """Input ACLs, 10K stateless rules, routed traffic"""
+        stream = self.ip4_udp_stream(self.pg1.remote_ip4)
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+@unittest.skipIf("vxlan" in config.excluded_plugins, "Exclude VXLAN plugin tests")
+class TestPerfVxlan(TemplatePerfRouted):
+    """VXLAN encapsulation performance"""
+
+    pipeline = "vxlan-encap"
+    bd_id = 1
+    vni = 10
+    inner_src_mac = "02:00:00:00:00:01"
+    inner_dst_mac = "02:00:00:00:00:02"
+
+    def setUp(self):
+        super(TestPerfVxlan, self).setUp()
+        self.tunnel = VppVxlanTunnel(
+            self, src=self.pg1.local_ip4, dst=self.pg1.remote_ip4, vni=self.vni
+        )
+        self.tunnel.add_vpp_config()
+        self.tunnel.admin_up()
+        self.vapi.bridge_domain_add_del_v2(
+            bd_id=self.bd_id, is_add=1, uu_flood=0, learn=0, flood=1, forward=1
+        )
+        for sw_if_index in (self.pg0.sw_if_index, self.tunnel.sw_if_index):
+            self.vapi.sw_interface_set_l2_bridge(
+                rx_sw_if_index=sw_if_index, bd_id=self.bd_id
+            )
+        self.vapi.l2fib_add_del(
+            mac_pton(self.inner_dst_mac),
+            self.bd_id,
+            self.tunnel.sw_if_index,
+            static_mac=1,
+        )
+
+    def tearDown(self):
+        self.vapi.l2fib_add_del(
+            mac_pton(self.inner_dst_mac), self.bd_id, self.tunnel.sw_if_index, is_add=0
+        )
+        for sw_if_index in (self.pg0.sw_if_index, self.tunnel.sw_if_index):
+            self.vapi.sw_interface_set_l2_bridge(
+                rx_sw_if_index=sw_if_index, bd_id=self.bd_id, enable=0
+            )
+        self.vapi.bridge_domain_add_del_v2(bd_id=self.bd_id, is_add=0)
+        self.tunnel.remove_vpp_config()
+        super(TestPerfVxlan, self).tearDown()
+
+    def test_perf_vxlan(self):
+        """L2 bridge into a VXLAN tunnel, IPv4 underlay"""
+        stream = self.pg_perf_stream(
+            self.pipeline,
+            self.pg0,
+            "    IP4: %s -> %s\n"
+            "    UDP: 10.0.0.1 -> 10.0.0.2\n"
+            "    UDP: 1234 -> 4321\n" % (self.inner_src_mac, self.inner_dst_mac),
+            L2_IP4_UDP_LEN,
+        )
+        self.perf_run(lambda: self.pg_perf_run([stream]))
+
+
+@unittest.skipIf(
+    "hs_apps" in config.excluded_plugins, "Exclude tests requiring hs_apps plugin"
+)
+class TestPerfTcp(TemplatePerf):
+    """Host stack TCP performance"""
+
+    pipeline = "tcp-echo"
+    transfer = "1g"
+
+    # there is no pg traffic: normalise by the segments TCP sends, data
+    # and acks alike
+    reference_node = "tcp4-output"
+    ignored_nodes = ()
+    packet_size = 0
+
+    def setUp(self):
+        super(TestPerfTcp, self).setUp()
+        self.vapi.session_enable_disable(is_enable=1)
+        self.create_loopback_interfaces(2)
+
+        self.tables = []
+        for table_id, i in enumerate(self.lo_interfaces):
+            i.admin_up()
+            if table_id != 0:
+                tbl = VppIpTable(self, table_id)
+                tbl.add_vpp_config()
+                self.tables.append(tbl)
+            i.set_table_ip4(table_id)
+            i.config_ip4()
+            self.vapi.app_namespace_add_del_v4(
+                namespace_id=str(table_id), sw_if_index=i.sw_if_index
+            )
+
+        self.routes = [
+            VppIpRoute(
+                self,
+                self.loop1.local_ip4,
+                32,
+                [VppRoutePath("0.0.0.0", 0xFFFFFFFF, nh_table_id=1)],
+            ),
+            VppIpRoute(
+                self,
+                self.loop0.local_ip4,
+                32,
+                [VppRoutePath("0.0.0.0", 0xFFFFFFFF, nh_table_id=0)],
+                table_id=1,
+            ),
+        ]
+        for r in self.routes:
+            r.add_vpp_config()
+
+    def tearDown(self):
+        for r in self.routes:
+            r.remove_vpp_config()
+        for table_id, i in enumerate(self.lo_interfaces):
+            self.vapi.app_namespace_add_del_v4(
+                is_add=0, namespace_id=str(table_id), sw_if_index=i.sw_if_index
+            )
+            i.unconfig_ip4()
+            i.set_table_ip4(0)
+            i.admin_down()
+        for tbl in self.tables:
+            tbl.remove_vpp_config()
+        self.vapi.session_enable_disable(is_enable=0)
+        super(TestPerfTcp, self).tearDown()
+
+    def echo_transfer(self):
+        error = self.vapi.cli(
+            "test echo client bytes %s appns 1 fifo-size 64k syn-timeout 2 uri %s"
+            % (self.transfer, self.uri)
+        )
+        if error:
+            self.logger.info(error)
+            self.assertNotIn("failed", error)
+
+    def test_perf_tcp(self):
+        """TCP echo client/server bulk transfer over loopbacks"""
+        self.uri = "tcp://%s/1234" % self.loop0.local_ip4
+        error = self.vapi.cli(
+            "test echo server appns 0 fifo-size 64k uri %s" % self.uri
+        )
+        if error:
+            self.logger.info(error)
+            self.assertNotIn("failed", error)
+        self.perf_run(self.echo_transfer)
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
@@ -134,6 +134,35 @@ class StatsClientTestCase(VppTestCase):
         self.assertEqual(rx_packets, 5)
         self.assertEqual(vectors[0], rx[0]["packets"])
 
+    def test_clocks_histogram(self):
+        """Test node clocks histogram"""
+        self.create_pg_interfaces(range(2))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+        self.vapi.cli("set node clocks-histogram ip4-lookup")
+
+        p = [
+            Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac)
+            / IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+            for i in range(5)
+        ]
+        self.send_and_expect(self.pg0, p, self.pg1)
+
+        h = self.statistics.get_counter("/nodes/ip4-lookup/clocks-histogram")
+        self.assertEqual(len(h), 1 + self.vpp_worker_count)
+        self.assertEqual(len(h[0]), 252)
+        self.assertGreaterEqual(sum(sum(t) for t in h), 1)
+
+        self.vapi.cli("set node clocks-histogram ip4-lookup disable")
+        self.assertNotIn(
+            "/nodes/ip4-lookup/clocks-histogram",
+            self.statistics.ls(["/nodes/ip4-lookup/"]),
+        )
+
     def test_index_consistency(self):
         """Test index consistency despite changes in the stats"""
         d = self.statistics.ls(["/if/names"])
@@ -161,6 +161,7 @@ class TestVlib(VppTestCase):
             "test heap-validate",
             "memory-trace main-heap disable",
             "show buffers",
+            "test buffer layout buffers 256 rounds 2",
             "show eve",
             "show help",
             "show ip ",
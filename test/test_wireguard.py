@@ -2905,6 +2905,85 @@ class WireguardHandoffTests(TestWg):
         peer_1.remove_vpp_config()
         wg0.remove_vpp_config()
 
+    def test_wg_multi_worker(self):
+        """Multi-worker peer"""
+
+        port = 12383
+
+        self.vapi.cli("set wireguard multi-worker mode on")
+
+        wg0 = VppWgInterface(self, self.pg1.local_ip4, port).add_vpp_config()
+        wg0.admin_up()
+        wg0.config_ip4()
+
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+        peer_1 = VppWgPeer(
+            self, wg0, self.pg1.remote_ip4, port + 1, ["10.11.3.0/24"]
+        ).add_vpp_config()
+
+        r1 = VppIpRoute(
+            self, "10.11.3.0", 24, [VppRoutePath("10.11.3.1", wg0.sw_if_index)]
+        ).add_vpp_config()
+
+        # skip the first automatic handshake
+        self.pg1.get_capture(1, timeout=HANDSHAKE_JITTER)
+
+        p = peer_1.mk_handshake(self.pg1)
+        rx = self.send_and_expect(self.pg1, [p], self.pg1)
+        peer_1.consume_response(rx[0])
+
+        def mk_data(counters):
+            return [
+                (
+                    peer_1.mk_tunnel_header(self.pg1)
+                    / Wireguard(message_type=4, reserved_zero=0)
+                    / WireguardTransport(
+                        receiver_index=peer_1.sender,
+                        counter=ii,
+                        encrypted_encapsulated_packet=peer_1.encrypt_transport(
+                            (
+                                IP(src="10.11.3.1", dst=self.pg0.remote_ip4, ttl=20)
+                                / UDP(sport=222, dport=223)
+                                / Raw()
+                            )
+                        ),
+                    )
+                )
+                for ii in counters
+            ]
+
+        # both workers decrypt for the peer, no handoff
+        rxs = self.send_and_expect(self.pg1, mk_data([0]), self.pg0, worker=0)
+        p = mk_data(range(1, 128))
+        rxs = self.send_and_expect(self.pg1, p, self.pg0, worker=1)
+        for rx in rxs:
+            self.assertEqual(rx[IP].ttl, 19)
+
+        # a replay on the other worker is still caught
+        self.send_and_assert_no_replies(self.pg1, p[:16])
+
+        # and both encrypt, with distinct nonces
+        pe = (
+            Ether(dst=self.pg0.local_mac, src=self.pg0.remote_mac)
+            / IP(src=self.pg0.remote_ip4, dst="10.11.3.2")
+            / UDP(sport=555, dport=556)
+            / Raw(b"\x00" * 80)
+        )
+        counters = []
+        for worker in [0, 1]:
+            rxs = self.send_and_expect(self.pg0, pe * 64, self.pg1, worker=worker)
+            peer_1.validate_encapped(rxs, pe)
+            counters += [rx[WireguardTransport].counter for rx in rxs]
+        self.assertEqual(len(set(counters)), len(counters))
+
+        r1.remove_vpp_config()
+        peer_1.remove_vpp_config()
+        wg0.remove_vpp_config()
+
+        self.vapi.cli("set wireguard multi-worker mode off")
+
     @unittest.skip("test disabled")
     def test_wg_multi_interface(self):
         """Multi-tunnel on the same port"""